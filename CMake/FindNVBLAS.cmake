@@ -0,0 +1,20 @@
+# - Find NVBLAS
+# Find NVBLAS, the library of the CUDA toolkit that intercepts the calls to the
+# level 3 BLAS routines and runs the large ones on NVIDIA GPUs.
+#
+# This module sets the following variables:
+#  NVBLAS_FOUND - set to true if the library is found
+#  NVBLAS_LIBRARY - the library to be linked
+
+find_library(NVBLAS_LIBRARY
+    NAMES nvblas
+    HINTS ENV CUDA_PATH ENV CUDA_HOME
+    PATHS /usr/local/cuda
+    PATH_SUFFIXES lib64 lib lib/x64)
+
+# Checks 'REQUIRED'.
+include(FindPackageHandleStandardArgs)
+find_package_handle_standard_args(NVBLAS
+    REQUIRED_VARS NVBLAS_LIBRARY)
+
+mark_as_advanced(NVBLAS_LIBRARY)
@@ -0,0 +1,32 @@
+# - Find Apache Parquet and Apache Arrow
+# Find the Parquet C++ library and the Arrow C++ library it depends on, which
+# are used to load Parquet files.
+#
+# This module sets the following variables:
+#  PARQUET_FOUND - set to true if the libraries are found
+#  PARQUET_INCLUDE_DIRS - list of required include directories
+#  PARQUET_LIBRARIES - list of libraries to be linked
+
+find_path(ARROW_INCLUDE_DIR
+    NAMES arrow/api.h)
+find_path(PARQUET_INCLUDE_DIR
+    NAMES parquet/arrow/reader.h)
+
+find_library(ARROW_LIBRARY
+    NAMES arrow)
+find_library(PARQUET_LIBRARY
+    NAMES parquet)
+
+# Checks 'REQUIRED'.
+include(FindPackageHandleStandardArgs)
+find_package_handle_standard_args(Parquet
+    REQUIRED_VARS PARQUET_LIBRARY PARQUET_INCLUDE_DIR ARROW_LIBRARY
+        ARROW_INCLUDE_DIR)
+
+if (PARQUET_FOUND)
+  set(PARQUET_INCLUDE_DIRS ${PARQUET_INCLUDE_DIR} ${ARROW_INCLUDE_DIR})
+  set(PARQUET_LIBRARIES ${PARQUET_LIBRARY} ${ARROW_LIBRARY})
+endif ()
+
+mark_as_advanced(ARROW_INCLUDE_DIR PARQUET_INCLUDE_DIR ARROW_LIBRARY
+    PARQUET_LIBRARY)
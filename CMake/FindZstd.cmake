@@ -0,0 +1,19 @@
+# - Find zstd
+# Find the Zstandard compression library (version 1.4.0 or newer is needed).
+#
+# This module sets the following variables:
+#  ZSTD_FOUND - set to true if the library is found
+#  ZSTD_INCLUDE_DIR - list of required include directories
+#  ZSTD_LIBRARY - the library to be linked
+
+find_path(ZSTD_INCLUDE_DIR
+    NAMES zstd.h)
+find_library(ZSTD_LIBRARY
+    NAMES zstd)
+
+# Checks 'REQUIRED'.
+include(FindPackageHandleStandardArgs)
+find_package_handle_standard_args(Zstd
+    REQUIRED_VARS ZSTD_LIBRARY ZSTD_INCLUDE_DIR)
+
+mark_as_advanced(ZSTD_INCLUDE_DIR ZSTD_LIBRARY)
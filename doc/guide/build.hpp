@@ -186,6 +186,8 @@ The full list of options mlpack allows:
        of CXXFLAGS (default OFF)
  - USE_OPENMP=(ON/OFF): if ON, then use OpenMP if the compiler supports it; if
        OFF, OpenMP support is manually disabled (default ON)
+ - USE_NVBLAS=(ON/OFF): if ON, link with NVBLAS from the CUDA toolkit ahead of
+       the BLAS library (see @ref build_nvblas) (default OFF)
 
 Each option can be specified to CMake with the '-D' flag.  Other tools can also
 be used to configure CMake, but those are not documented here.
@@ -202,6 +204,29 @@ and libraries. These also use the '-D' flag.
  - STB_IMAGE_INCLUDE_DIR=(/path/to/stb/include): path to include directory for
       STB image library
  - MATHJAX_ROOT=(/path/to/mathjax): path to root of MathJax installation
+ - NVBLAS_LIBRARY=(/path/to/cuda/lib64/libnvblas.so): location of the NVBLAS
+       library
+
+@subsection build_nvblas Optional NVBLAS linking
+
+With \c USE_NVBLAS=ON, mlpack is linked with NVBLAS, which intercepts the level
+3 BLAS calls of Armadillo (the matrix products) and runs the ones that are large
+enough on the GPU, passing the others to the CPU BLAS library.  This is not a
+GPU backend: all data stays in host memory, the operands of each offloaded
+product are copied to the GPU and the result is copied back, and everything
+other than level 3 BLAS calls (element-wise operations, activation functions,
+loss functions, and so on) runs on the CPU.  So only programs dominated by large
+matrix products, such as neural networks with large \c Linear layers trained
+with large batches, can expect a speedup.
+
+NVBLAS reads its configuration from the file given by the \c NVBLAS_CONFIG_FILE
+environment variable (by default, \c nvblas.conf in the current directory),
+which must at least give the CPU BLAS library:
+
+@code
+NVBLAS_CPU_BLAS_LIB /usr/lib/x86_64-linux-gnu/libopenblas.so
+NVBLAS_GPU_LIST ALL
+@endcode
 
 @section build_build Building mlpack
 
@@ -182,6 +182,46 @@ Dr. Strangelove or: How I Learned to Stop Worrying and Love the Bomb (1964)
 Schindler's List (1993)
 @endcode
 
+@section cli_quickstart_serve Running many queries with one model
+
+Each run of an mlpack program loads its input model from file, which can take
+longer than the query itself when the model is large (a tree for @c mlpack_knn,
+for instance).  When many queries are run with the same model, the program can
+instead be started in server mode with @c --serve: it then reads requests from
+standard input, one per line, each written as the options of a normal command
+line.  Models are loaded from file only once, and later requests that use the
+same file (unchanged on disk) use the model in memory.  After the output of
+each request, the program prints a line that is either @c ok or starts with
+@c error:.
+
+@code{.sh}
+mlpack_knn --reference_file ref.csv -k 5 --output_model_file knn.bin
+mlpack_knn --serve <<EOF
+--input_model_file knn.bin --query_file q1.csv -k 5 --neighbors_file n1.csv
+--input_model_file knn.bin --query_file q2.csv -k 5 --neighbors_file n2.csv
+EOF
+@endcode
+
+Requests may not use @c --help, @c --info or @c --version.
+
+@section cli_quickstart_stream Predicting on very large datasets
+
+Programs that handle each test point on its own (@c mlpack_random_forest,
+@c mlpack_logistic_regression, @c mlpack_softmax_regression, @c mlpack_knn and
+@c mlpack_gmm_probability) can also be run in streaming mode, by giving them
+@c --stream_chunk_size: the test points are then read in chunks of the given
+number of points, and the results of each chunk are appended to the output
+files before the next chunk is read.  So the memory used depends on the chunk
+size, not on the size of the dataset.  The streamed input and the output
+matrices must be @c .csv, @c .tsv or @c .txt files, and output models can't be
+saved; so a model should be trained first, and then given to the streaming
+run.
+
+@code{.sh}
+mlpack_random_forest --input_model_file rf.bin --test_file huge.csv \
+    --predictions_file predictions.csv --stream_chunk_size 100000
+@endcode
+
 @section cli_quickstart_nextsteps Next steps with mlpack
 
 Now that you have done some simple work with mlpack, you have seen how it can
@@ -134,11 +134,28 @@ class KernelTraits<ExampleKernel>
 };
 @endcode
 
-At this time, there is only one kernel trait that is used in mlpack code:
+At this time, these kernel traits are used in mlpack code:
 
  - \c IsNormalized (defaults to \c false): if \f$ K(x, x) = 1 \; \forall x \f$,
    then the kernel is normalized and this should be set to true.
 
+ - \c HasBatchEvaluate (defaults to \c false): if the kernel provides a
+   function
+
+@code
+template<typename MatTypeA, typename MatTypeB>
+void BatchEvaluate(const MatTypeA& a,
+                   const MatTypeB& b,
+                   arma::mat& kernelMatrix) const;
+@endcode
+
+   that fills \c kernelMatrix(i, j) with \f$ K(a_i, b_j) \f$ for every pair of
+   columns of \c a and \c b at once, this should be set to true.
+   mlpack::kernel::KernelMatrix() and mlpack::kernel::KernelVector() then use
+   it instead of calling \c Evaluate() on each pair of points.  The linear,
+   polynomial, hyperbolic tangent, Gaussian, Laplacian, Epanechnikov, Cauchy and
+   cosine kernels compute their batches from a single matrix product.
+
 @section kernellist List of kernels and classes that use a \c KernelType
 
 mlpack comes with a number of pre-written kernels that satisfy the \c KernelType
@@ -0,0 +1,248 @@
+/**
+ * @file benchmarks/ann_benchmark.cpp
+ *
+ * Benchmarks of the neural network code: the forward and backward passes of
+ * single layers, the forward pass of recurrent layers over sequences, the
+ * overhead of calling layers through the visitors, and training epochs of a
+ * whole FFN.  Every benchmark reports its throughput in samples per second.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/ann/convolution_rules/fft_convolution.hpp>
+#include <mlpack/methods/ann/convolution_rules/naive_convolution.hpp>
+#include <mlpack/methods/ann/ffn.hpp>
+#include <mlpack/methods/ann/init_rules/random_init.hpp>
+#include <mlpack/methods/ann/layer/layer.hpp>
+#include <mlpack/methods/ann/layer/layer_types.hpp>
+#include <mlpack/methods/ann/loss_functions/mean_squared_error.hpp>
+#include <mlpack/methods/ann/loss_functions/negative_log_likelihood.hpp>
+#include <mlpack/methods/ann/rnn.hpp>
+#include <mlpack/methods/ann/visitor/delete_visitor.hpp>
+#include <mlpack/methods/ann/visitor/forward_visitor.hpp>
+
+#include <ensmallen.hpp>
+
+#include "benchmark_tools.hpp"
+
+using namespace mlpack;
+using namespace mlpack::ann;
+using namespace mlpack::benchmarks;
+
+//! The size of the input of the dense layers (that of MNIST).
+static const size_t denseInputSize = 784;
+//! The size of the output of the dense layers.
+static const size_t denseOutputSize = 256;
+//! The width and height of the images of the convolutional and pooling layers.
+static const size_t imageSize = 28;
+//! The number of channels of the images of the convolutional layers.
+static const size_t imageChannels = 8;
+//! The length of the sequences of the recurrent layers.
+static const size_t sequenceLength = 20;
+
+/**
+ * Time one forward and one backward pass of the given layer on a batch of the
+ * given input.  The layer must already be initialized.
+ */
+template<typename LayerType>
+static void ForwardBackward(benchmark::State& state,
+                            LayerType& layer,
+                            const arma::mat& input)
+{
+  arma::mat output, error, delta;
+  layer.Forward(input, output);
+  error.randu(output.n_rows, output.n_cols);
+
+  for (auto _ : state)
+  {
+    layer.Forward(input, output);
+    layer.Backward(output, error, delta);
+    benchmark::DoNotOptimize(delta.memptr());
+  }
+
+  state.SetItemsProcessed(state.iterations() * input.n_cols);
+}
+
+//! Benchmark a Linear layer from the MNIST input size.
+static void LinearLayer(benchmark::State& state)
+{
+  Linear<> layer(denseInputSize, denseOutputSize);
+  layer.Parameters().randu();
+  layer.Reset();
+
+  ForwardBackward(state, layer, Dataset(state.range(0), denseInputSize));
+}
+
+/**
+ * Benchmark a 3x3 Convolution layer with the given convolution rule (naive or
+ * FFT) on 28x28 images.
+ */
+template<typename ForwardRule, typename BackwardRule, typename GradientRule>
+static void ConvolutionLayer(benchmark::State& state)
+{
+  Convolution<ForwardRule, BackwardRule, GradientRule> layer(imageChannels,
+      imageChannels, 3, 3, 1, 1, 0, 0, imageSize, imageSize);
+  layer.Reset();
+  layer.Parameters().randu();
+
+  ForwardBackward(state, layer, Dataset(state.range(0),
+      imageSize * imageSize * imageChannels));
+}
+
+//! Benchmark a 2x2 MaxPooling layer with stride 2 on 28x28 images.
+static void MaxPoolingLayer(benchmark::State& state)
+{
+  MaxPooling<> layer(2, 2, 2, 2);
+  layer.InputWidth() = imageSize;
+  layer.InputHeight() = imageSize;
+
+  ForwardBackward(state, layer, Dataset(state.range(0),
+      imageSize * imageSize * imageChannels));
+}
+
+//! Benchmark a BatchNorm layer (in training mode) on dense batches.
+static void BatchNormLayer(benchmark::State& state)
+{
+  BatchNorm<> layer(denseOutputSize);
+  layer.Reset();
+
+  ForwardBackward(state, layer, Dataset(state.range(0), denseOutputSize));
+}
+
+//! Benchmark the given activation layer on dense batches.
+template<typename LayerType>
+static void ActivationLayer(benchmark::State& state)
+{
+  LayerType layer;
+  ForwardBackward(state, layer, Dataset(state.range(0), denseOutputSize));
+}
+
+/**
+ * Benchmark the forward pass of the given recurrent layer over a batch of
+ * sequences.  The layer is wrapped in an RNN, which feeds the sequences step by
+ * step and resets the state of the layer before each batch.
+ */
+template<typename LayerType>
+static void RecurrentLayer(benchmark::State& state)
+{
+  const size_t batchSize = state.range(0);
+  RNN<MeanSquaredError<>, RandomInitialization> model(sequenceLength);
+  model.Add<IdentityLayer<>>();
+  model.Add<LayerType>(denseOutputSize, denseOutputSize, sequenceLength);
+
+  const arma::mat& data = Dataset(batchSize * sequenceLength,
+      denseOutputSize);
+  const arma::cube input(const_cast<double*>(data.memptr()), denseOutputSize,
+      batchSize, sequenceLength);
+  arma::cube output;
+  for (auto _ : state)
+  {
+    model.Predict(input, output, batchSize);
+    benchmark::DoNotOptimize(output.memptr());
+  }
+
+  state.SetItemsProcessed(state.iterations() * batchSize);
+}
+
+/**
+ * Benchmark the overhead of calling a layer through the visitors: the forward
+ * pass of a small Linear layer, called directly or through ForwardVisitor on a
+ * LayerTypes<>, as FFN does.
+ */
+template<bool UseVisitor>
+static void VisitorDispatch(benchmark::State& state)
+{
+  Linear<>* linear = new Linear<>(10, 10);
+  linear->Parameters().randu();
+  linear->Reset();
+  LayerTypes<> layer = linear;
+
+  const arma::mat& input = Dataset(state.range(0), 10);
+  arma::mat output;
+  for (auto _ : state)
+  {
+    if (UseVisitor)
+      boost::apply_visitor(ForwardVisitor(input, output), layer);
+    else
+      linear->Forward(input, output);
+    benchmark::DoNotOptimize(output.memptr());
+  }
+
+  boost::apply_visitor(DeleteVisitor(), layer);
+  state.SetItemsProcessed(state.iterations() * input.n_cols);
+}
+
+/**
+ * Benchmark one epoch of FFN::Train() with Adam on an MNIST-sized synthetic
+ * dataset (784 dimensions, 10 classes) with a 784-256-10 network.  The batch
+ * size is the argument of the benchmark.
+ */
+static void FFNTrainEpoch(benchmark::State& state)
+{
+  const size_t points = 10000;
+  const size_t batchSize = state.range(0);
+  const arma::mat& data = Dataset(points, denseInputSize);
+  // The classes match the clusters of the dataset.
+  arma::mat labels(1, points);
+  for (size_t i = 0; i < points; ++i)
+    labels[i] = (i % 10) + 1;
+
+  FFN<NegativeLogLikelihood<>, RandomInitialization> model;
+  model.Add<Linear<>>(denseInputSize, denseOutputSize);
+  model.Add<ReLULayer<>>();
+  model.Add<Linear<>>(denseOutputSize, 10);
+  model.Add<LogSoftMax<>>();
+
+  ens::Adam optimizer(0.001, batchSize, 0.9, 0.999, 1e-8, points, -1, true,
+      false);
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(model.Train(data, labels, optimizer));
+  }
+
+  state.SetItemsProcessed(state.iterations() * points);
+}
+
+//! Add the batch sizes the layer benchmarks are run with.
+static void BatchArguments(benchmark::internal::Benchmark* b)
+{
+  for (const int batchSize : { 32, 256 })
+    b->Arg(batchSize);
+}
+
+BENCHMARK(LinearLayer)->Apply(BatchArguments);
+BENCHMARK_TEMPLATE(ConvolutionLayer, NaiveConvolution<ValidConvolution>,
+    NaiveConvolution<FullConvolution>, NaiveConvolution<ValidConvolution>)
+    ->Apply(BatchArguments)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(ConvolutionLayer, FFTConvolution<ValidConvolution>,
+    FFTConvolution<FullConvolution>, FFTConvolution<ValidConvolution>)
+    ->Apply(BatchArguments)->Unit(benchmark::kMillisecond);
+BENCHMARK(MaxPoolingLayer)->Apply(BatchArguments);
+BENCHMARK(BatchNormLayer)->Apply(BatchArguments);
+
+// Activation layers.
+BENCHMARK_TEMPLATE(ActivationLayer, SigmoidLayer<>)->Apply(BatchArguments);
+BENCHMARK_TEMPLATE(ActivationLayer, TanHLayer<>)->Apply(BatchArguments);
+BENCHMARK_TEMPLATE(ActivationLayer, ReLULayer<>)->Apply(BatchArguments);
+BENCHMARK_TEMPLATE(ActivationLayer, SoftPlusLayer<>)->Apply(BatchArguments);
+BENCHMARK_TEMPLATE(ActivationLayer, LeakyReLU<>)->Apply(BatchArguments);
+BENCHMARK_TEMPLATE(ActivationLayer, ELU<>)->Apply(BatchArguments);
+BENCHMARK_TEMPLATE(ActivationLayer, HardTanH<>)->Apply(BatchArguments);
+BENCHMARK_TEMPLATE(ActivationLayer, PReLU<>)->Apply(BatchArguments);
+BENCHMARK_TEMPLATE(ActivationLayer, LogSoftMax<>)->Apply(BatchArguments);
+
+// Recurrent layers.
+BENCHMARK_TEMPLATE(RecurrentLayer, LSTM<>)
+    ->Apply(BatchArguments)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(RecurrentLayer, GRU<>)
+    ->Apply(BatchArguments)->Unit(benchmark::kMillisecond);
+
+// Visitor overhead.
+BENCHMARK_TEMPLATE(VisitorDispatch, false)->Arg(1)->Arg(32);
+BENCHMARK_TEMPLATE(VisitorDispatch, true)->Arg(1)->Arg(32);
+
+// End-to-end training.
+BENCHMARK(FFNTrainEpoch)->Arg(32)->Arg(256)->Unit(benchmark::kMillisecond);
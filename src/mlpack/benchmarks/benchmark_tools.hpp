@@ -0,0 +1,102 @@
+/**
+ * @file benchmarks/benchmark_tools.hpp
+ *
+ * Tools shared by the benchmarks: synthetic datasets and the grids of
+ * arguments the benchmarks are run with.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_BENCHMARKS_BENCHMARK_TOOLS_HPP
+#define MLPACK_BENCHMARKS_BENCHMARK_TOOLS_HPP
+
+#include <mlpack/core.hpp>
+#include <mlpack/core/tree/traversal_statistics.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <map>
+#include <tuple>
+
+namespace mlpack {
+namespace benchmarks {
+
+/**
+ * Get a synthetic dataset of n points in d dimensions, drawn from a mixture of
+ * ten Gaussians with random centers in the unit cube (so that the data has
+ * the cluster structure real data usually has, instead of being uniform).  The
+ * dataset only depends on n, d and the seed, so every run of a benchmark (and
+ * every version of mlpack) works on the same data.  Datasets are generated
+ * once and cached.
+ *
+ * @param n Number of points.
+ * @param d Number of dimensions.
+ * @param seed Seed of the dataset, to get several different datasets of the
+ *     same size.
+ */
+inline const arma::mat& Dataset(const size_t n,
+                                const size_t d,
+                                const size_t seed = 0)
+{
+  static std::map<std::tuple<size_t, size_t, size_t>, arma::mat> datasets;
+
+  const std::tuple<size_t, size_t, size_t> key(n, d, seed);
+  std::map<std::tuple<size_t, size_t, size_t>, arma::mat>::iterator it =
+      datasets.find(key);
+  if (it != datasets.end())
+    return it->second;
+
+  arma::arma_rng::set_seed(1000 * seed + 42);
+  const size_t numCenters = 10;
+  const arma::mat centers(d, numCenters, arma::fill::randu);
+  arma::mat& dataset = datasets[key];
+  dataset.randn(d, n);
+  dataset *= 0.05;
+  for (size_t i = 0; i < n; ++i)
+    dataset.col(i) += centers.col(i % numCenters);
+
+  return dataset;
+}
+
+/**
+ * Add the arguments {n, d, leaf size} of the tree benchmarks.
+ */
+inline void TreeArguments(benchmark::internal::Benchmark* b)
+{
+  for (const int n : { 10000, 100000 })
+    for (const int d : { 3, 10 })
+      for (const int leafSize : { 10, 40 })
+        b->Args({ n, d, leafSize });
+}
+
+/**
+ * Add the arguments {n, d, leaf size} of the search benchmarks, which are
+ * smaller than those of the tree benchmarks since each search also builds its
+ * trees.
+ */
+inline void SearchArguments(benchmark::internal::Benchmark* b)
+{
+  for (const int n : { 5000, 50000 })
+    for (const int d : { 3, 10 })
+      for (const int leafSize : { 10, 40 })
+        b->Args({ n, d, leafSize });
+}
+
+/**
+ * Report the given traversal statistics as counters of the benchmark, so that
+ * the output shows how the work done changes along with the time.
+ */
+inline void ReportStatistics(benchmark::State& state,
+                             const tree::TraversalStatistics& statistics)
+{
+  state.counters["base_cases"] = statistics.baseCases;
+  state.counters["scores"] = statistics.scores;
+  state.counters["prunes"] = statistics.prunes;
+}
+
+} // namespace benchmarks
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,59 @@
+/**
+ * @file benchmarks/emst_benchmark.cpp
+ *
+ * Benchmarks of the computation of Euclidean minimum spanning trees with the
+ * dual-tree Boruvka algorithm.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/emst/dtb.hpp>
+
+#include "benchmark_tools.hpp"
+
+using namespace mlpack;
+using namespace mlpack::benchmarks;
+using namespace mlpack::emst;
+
+/**
+ * Compute the minimum spanning tree of the dataset with a kd-tree of the given
+ * leaf size (1 is the leaf size emst uses by default).  The tree keeps the
+ * state of the computation, so a new tree is built (untimed) for each
+ * iteration.
+ */
+static void EMST(benchmark::State& state)
+{
+  const arma::mat& dataset = Dataset(state.range(0), state.range(1));
+  const size_t leafSize = state.range(2);
+
+  arma::mat results;
+  tree::TraversalStatistics statistics;
+  for (auto _ : state)
+  {
+    state.PauseTiming();
+    DualTreeBoruvka<>::Tree tree(dataset, leafSize);
+    DualTreeBoruvka<> dtb(&tree);
+    state.ResumeTiming();
+
+    dtb.ComputeMST(results);
+    benchmark::DoNotOptimize(results.memptr());
+    statistics = dtb.Statistics();
+  }
+
+  ReportStatistics(state, statistics);
+  state.SetItemsProcessed(state.iterations() * dataset.n_cols);
+}
+
+//! Add the arguments {n, d, leaf size} of the EMST benchmarks.
+static void EMSTArguments(benchmark::internal::Benchmark* b)
+{
+  for (const int n : { 5000, 50000 })
+    for (const int d : { 3, 10 })
+      for (const int leafSize : { 1, 10, 40 })
+        b->Args({ n, d, leafSize });
+}
+
+BENCHMARK(EMST)->Apply(EMSTArguments)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,74 @@
+/**
+ * @file benchmarks/kmeans_benchmark.cpp
+ *
+ * Benchmarks of each type of Lloyd step of k-means.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/kmeans/kmeans.hpp>
+#include <mlpack/methods/kmeans/dual_tree_kmeans.hpp>
+#include <mlpack/methods/kmeans/elkan_kmeans.hpp>
+#include <mlpack/methods/kmeans/hamerly_kmeans.hpp>
+#include <mlpack/methods/kmeans/naive_kmeans.hpp>
+#include <mlpack/methods/kmeans/pelleg_moore_kmeans.hpp>
+
+#include "benchmark_tools.hpp"
+
+using namespace mlpack;
+using namespace mlpack::benchmarks;
+using namespace mlpack::kmeans;
+using namespace mlpack::metric;
+
+//! The number of iterations of k-means to run.
+static const size_t benchmarkIterations = 5;
+
+/**
+ * Run a fixed number of iterations of k-means with the given type of Lloyd
+ * step on the dataset, starting from the first k points of the dataset (so
+ * that every step type does the same iterations and finds the same
+ * clusters).
+ */
+template<template<typename, typename> class LloydStepType>
+static void KMeansStep(benchmark::State& state)
+{
+  const arma::mat& dataset = Dataset(state.range(0), state.range(1));
+  const size_t clusters = state.range(2);
+
+  KMeans<EuclideanDistance, SampleInitialization, MaxVarianceNewCluster,
+      LloydStepType> kmeans(benchmarkIterations);
+
+  arma::mat centroids;
+  for (auto _ : state)
+  {
+    centroids = dataset.cols(0, clusters - 1);
+    kmeans.Cluster(dataset, clusters, centroids, true);
+    benchmark::DoNotOptimize(centroids.memptr());
+  }
+
+  state.SetItemsProcessed(state.iterations() * benchmarkIterations *
+      dataset.n_cols);
+}
+
+//! Add the arguments {n, d, number of clusters} of the k-means benchmarks.
+static void KMeansArguments(benchmark::internal::Benchmark* b)
+{
+  for (const int n : { 10000, 100000 })
+    for (const int d : { 3, 10 })
+      for (const int clusters : { 10, 100 })
+        b->Args({ n, d, clusters });
+}
+
+BENCHMARK_TEMPLATE(KMeansStep, NaiveKMeans)
+    ->Apply(KMeansArguments)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(KMeansStep, ElkanKMeans)
+    ->Apply(KMeansArguments)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(KMeansStep, HamerlyKMeans)
+    ->Apply(KMeansArguments)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(KMeansStep, PellegMooreKMeans)
+    ->Apply(KMeansArguments)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(KMeansStep, DefaultDualTreeKMeans)
+    ->Apply(KMeansArguments)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,211 @@
+/**
+ * @file benchmarks/search_benchmark.cpp
+ *
+ * Benchmarks of the tree-based searches: k-nearest-neighbor search, range
+ * search, kernel density estimation and max-kernel search, in each of their
+ * modes.  Only the searches are timed; the trees are built beforehand.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/fastmks/fastmks.hpp>
+#include <mlpack/methods/kde/kde.hpp>
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
+#include <mlpack/methods/range_search/range_search.hpp>
+
+#include "benchmark_tools.hpp"
+
+using namespace mlpack;
+using namespace mlpack::benchmarks;
+using namespace mlpack::fastmks;
+using namespace mlpack::kernel;
+using namespace mlpack::metric;
+using namespace mlpack::neighbor;
+using namespace mlpack::range;
+using namespace mlpack::tree;
+
+//! The number of neighbors to search for.
+static const size_t benchmarkK = 10;
+
+/**
+ * Search for the k nearest neighbors of every point of the dataset with the
+ * given NeighborSearch type and mode.  The tree is built with the leaf size of
+ * the benchmark; naive and brute-force search build no tree.
+ */
+template<typename NSType, NeighborSearchMode Mode>
+static void KNNSearch(benchmark::State& state)
+{
+  const arma::mat& dataset = Dataset(state.range(0), state.range(1));
+  const size_t leafSize = state.range(2);
+
+  NSType knn = (Mode == NAIVE_MODE || Mode == BRUTE_FORCE_MODE) ?
+      NSType(dataset, Mode) :
+      NSType(typename NSType::Tree(dataset, leafSize), Mode);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  for (auto _ : state)
+  {
+    knn.Search(benchmarkK, neighbors, distances);
+    benchmark::DoNotOptimize(distances.memptr());
+  }
+
+  ReportStatistics(state, knn.Statistics());
+  state.SetItemsProcessed(state.iterations() * dataset.n_cols);
+}
+
+/**
+ * Search for the k nearest neighbors of every point of the dataset with cover
+ * trees.  Cover trees have no leaf size, so the third argument is ignored.
+ */
+template<NeighborSearchMode Mode>
+static void KNNCoverTreeSearch(benchmark::State& state)
+{
+  const arma::mat& dataset = Dataset(state.range(0), state.range(1));
+
+  NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::mat,
+      StandardCoverTree> knn(dataset, Mode);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  for (auto _ : state)
+  {
+    knn.Search(benchmarkK, neighbors, distances);
+    benchmark::DoNotOptimize(distances.memptr());
+  }
+
+  ReportStatistics(state, knn.Statistics());
+  state.SetItemsProcessed(state.iterations() * dataset.n_cols);
+}
+
+/**
+ * Find every pair of points of the dataset closer than the mean distance of
+ * the points to their k-th nearest neighbor, so that each point has about k
+ * neighbors in range whatever the size of the dataset.
+ */
+template<bool SingleMode>
+static void RangeSearchBenchmark(benchmark::State& state)
+{
+  const arma::mat& dataset = Dataset(state.range(0), state.range(1));
+  const size_t leafSize = state.range(2);
+
+  arma::Mat<size_t> knnNeighbors;
+  arma::mat knnDistances;
+  KNN(dataset).Search(benchmarkK, knnNeighbors, knnDistances);
+  const math::Range range(0.0, arma::mean(knnDistances.row(benchmarkK - 1)));
+
+  typedef RangeSearch<EuclideanDistance, arma::mat, KDTree> RSType;
+  typename RSType::Tree tree(dataset, leafSize);
+  RSType rs(&tree, SingleMode);
+
+  std::vector<std::vector<size_t>> neighbors;
+  std::vector<std::vector<double>> distances;
+  for (auto _ : state)
+  {
+    rs.Search(range, neighbors, distances);
+    benchmark::DoNotOptimize(neighbors.data());
+  }
+
+  ReportStatistics(state, rs.Statistics());
+  state.SetItemsProcessed(state.iterations() * dataset.n_cols);
+}
+
+/**
+ * Estimate the density of every point of the dataset with a Gaussian kernel
+ * and the given mode.
+ */
+template<kde::KDEMode Mode>
+static void KDEBenchmark(benchmark::State& state)
+{
+  const arma::mat& dataset = Dataset(state.range(0), state.range(1));
+  const size_t leafSize = state.range(2);
+
+  typedef kde::KDE<GaussianKernel, EuclideanDistance, arma::mat, KDTree>
+      KDEType;
+  std::vector<size_t> oldFromNew;
+  typename KDEType::Tree tree(dataset, oldFromNew, leafSize);
+  KDEType kde(0.05, 0.0, GaussianKernel(0.1), Mode);
+  kde.Train(&tree, &oldFromNew);
+
+  arma::vec estimations;
+  for (auto _ : state)
+  {
+    kde.Evaluate(estimations);
+    benchmark::DoNotOptimize(estimations.memptr());
+  }
+
+  ReportStatistics(state, kde.Statistics());
+  state.SetItemsProcessed(state.iterations() * dataset.n_cols);
+}
+
+/**
+ * Search for the k points of the dataset with the largest inner product with
+ * every point of the dataset (FastMKS uses cover trees, so the leaf size is
+ * ignored).
+ */
+template<bool SingleMode, bool Naive>
+static void FastMKSBenchmark(benchmark::State& state)
+{
+  const arma::mat& dataset = Dataset(state.range(0), state.range(1));
+
+  FastMKS<LinearKernel> fastmks(dataset, SingleMode, Naive);
+
+  arma::Mat<size_t> indices;
+  arma::mat products;
+  for (auto _ : state)
+  {
+    fastmks.Search(benchmarkK, indices, products);
+    benchmark::DoNotOptimize(products.memptr());
+  }
+
+  ReportStatistics(state, fastmks.Statistics());
+  state.SetItemsProcessed(state.iterations() * dataset.n_cols);
+}
+
+// k-nearest-neighbor search with kd-trees, in every mode.
+BENCHMARK_TEMPLATE(KNNSearch, KNN, NAIVE_MODE)
+    ->Apply(SearchArguments)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(KNNSearch, KNN, BRUTE_FORCE_MODE)
+    ->Apply(SearchArguments)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(KNNSearch, KNN, SINGLE_TREE_MODE)
+    ->Apply(SearchArguments)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(KNNSearch, KNN, DUAL_TREE_MODE)
+    ->Apply(SearchArguments)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(KNNSearch, KNN, GREEDY_SINGLE_TREE_MODE)
+    ->Apply(SearchArguments)->Unit(benchmark::kMillisecond);
+
+// Dual-tree k-nearest-neighbor search with other trees.
+BENCHMARK_TEMPLATE(KNNSearch, NeighborSearch<NearestNeighborSort,
+    EuclideanDistance, arma::mat, BallTree>, DUAL_TREE_MODE)
+    ->Apply(SearchArguments)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(KNNSearch, NeighborSearch<NearestNeighborSort,
+    EuclideanDistance, arma::mat, RStarTree>, DUAL_TREE_MODE)
+    ->Apply(SearchArguments)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(KNNSearch, NeighborSearch<NearestNeighborSort,
+    EuclideanDistance, arma::mat, Octree>, DUAL_TREE_MODE)
+    ->Apply(SearchArguments)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(KNNCoverTreeSearch, DUAL_TREE_MODE)
+    ->Apply(SearchArguments)->Unit(benchmark::kMillisecond);
+
+// Range search.
+BENCHMARK_TEMPLATE(RangeSearchBenchmark, true)
+    ->Apply(SearchArguments)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(RangeSearchBenchmark, false)
+    ->Apply(SearchArguments)->Unit(benchmark::kMillisecond);
+
+// Kernel density estimation.
+BENCHMARK_TEMPLATE(KDEBenchmark, kde::KDEMode::SINGLE_TREE_MODE)
+    ->Apply(SearchArguments)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(KDEBenchmark, kde::KDEMode::DUAL_TREE_MODE)
+    ->Apply(SearchArguments)->Unit(benchmark::kMillisecond);
+
+// Max-kernel search: naive, single-tree and dual-tree.
+BENCHMARK_TEMPLATE(FastMKSBenchmark, false, true)
+    ->Apply(SearchArguments)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(FastMKSBenchmark, true, false)
+    ->Apply(SearchArguments)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(FastMKSBenchmark, false, false)
+    ->Apply(SearchArguments)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,133 @@
+/**
+ * @file benchmarks/tree_benchmark.cpp
+ *
+ * Benchmarks of the construction of each type of tree.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/core/tree/binary_space_tree.hpp>
+#include <mlpack/core/tree/cover_tree.hpp>
+#include <mlpack/core/tree/octree.hpp>
+#include <mlpack/core/tree/rectangle_tree.hpp>
+#include <mlpack/core/tree/spill_tree.hpp>
+
+#include "benchmark_tools.hpp"
+
+using namespace mlpack;
+using namespace mlpack::benchmarks;
+using namespace mlpack::metric;
+using namespace mlpack::tree;
+
+/**
+ * Build a tree of the given type with the given leaf size on the dataset of
+ * the benchmark.  This works for every tree whose constructor takes the
+ * dataset and the leaf size.
+ */
+template<typename TreeType>
+static void BuildTree(benchmark::State& state)
+{
+  const arma::mat& dataset = Dataset(state.range(0), state.range(1));
+  const size_t leafSize = state.range(2);
+
+  for (auto _ : state)
+  {
+    TreeType tree(dataset, leafSize);
+    benchmark::DoNotOptimize(tree.NumDescendants());
+  }
+
+  state.SetItemsProcessed(state.iterations() * dataset.n_cols);
+}
+
+/**
+ * Build a spill tree (with no overlap) with the given leaf size on the dataset
+ * of the benchmark.
+ */
+template<typename TreeType>
+static void BuildSpillTree(benchmark::State& state)
+{
+  const arma::mat& dataset = Dataset(state.range(0), state.range(1));
+  const size_t leafSize = state.range(2);
+
+  for (auto _ : state)
+  {
+    TreeType tree(dataset, 0.0, leafSize);
+    benchmark::DoNotOptimize(tree.NumDescendants());
+  }
+
+  state.SetItemsProcessed(state.iterations() * dataset.n_cols);
+}
+
+/**
+ * Build a cover tree on the dataset of the benchmark.  Cover trees have no
+ * leaf size, so the third argument is ignored.
+ */
+static void BuildCoverTree(benchmark::State& state)
+{
+  const arma::mat& dataset = Dataset(state.range(0), state.range(1));
+
+  for (auto _ : state)
+  {
+    StandardCoverTree<EuclideanDistance, EmptyStatistic, arma::mat>
+        tree(dataset);
+    benchmark::DoNotOptimize(tree.NumDescendants());
+  }
+
+  state.SetItemsProcessed(state.iterations() * dataset.n_cols);
+}
+
+// Binary space trees.
+BENCHMARK_TEMPLATE(BuildTree,
+    KDTree<EuclideanDistance, EmptyStatistic, arma::mat>)
+    ->Apply(TreeArguments)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BuildTree,
+    MeanSplitKDTree<EuclideanDistance, EmptyStatistic, arma::mat>)
+    ->Apply(TreeArguments)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BuildTree,
+    BallTree<EuclideanDistance, EmptyStatistic, arma::mat>)
+    ->Apply(TreeArguments)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BuildTree,
+    VPTree<EuclideanDistance, EmptyStatistic, arma::mat>)
+    ->Apply(TreeArguments)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BuildTree,
+    RPTree<EuclideanDistance, EmptyStatistic, arma::mat>)
+    ->Apply(TreeArguments)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BuildTree,
+    MaxRPTree<EuclideanDistance, EmptyStatistic, arma::mat>)
+    ->Apply(TreeArguments)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BuildTree,
+    UBTree<EuclideanDistance, EmptyStatistic, arma::mat>)
+    ->Apply(TreeArguments)->Unit(benchmark::kMillisecond);
+
+// Rectangle trees.
+BENCHMARK_TEMPLATE(BuildTree,
+    RTree<EuclideanDistance, EmptyStatistic, arma::mat>)
+    ->Apply(TreeArguments)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BuildTree,
+    RStarTree<EuclideanDistance, EmptyStatistic, arma::mat>)
+    ->Apply(TreeArguments)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BuildTree,
+    XTree<EuclideanDistance, EmptyStatistic, arma::mat>)
+    ->Apply(TreeArguments)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BuildTree,
+    HilbertRTree<EuclideanDistance, EmptyStatistic, arma::mat>)
+    ->Apply(TreeArguments)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BuildTree,
+    RPlusTree<EuclideanDistance, EmptyStatistic, arma::mat>)
+    ->Apply(TreeArguments)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BuildTree,
+    RPlusPlusTree<EuclideanDistance, EmptyStatistic, arma::mat>)
+    ->Apply(TreeArguments)->Unit(benchmark::kMillisecond);
+
+// Other trees.
+BENCHMARK_TEMPLATE(BuildTree,
+    Octree<EuclideanDistance, EmptyStatistic, arma::mat>)
+    ->Apply(TreeArguments)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BuildSpillTree,
+    SPTree<EuclideanDistance, EmptyStatistic, arma::mat>)
+    ->Apply(TreeArguments)->Unit(benchmark::kMillisecond);
+BENCHMARK(BuildCoverTree)
+    ->Apply(TreeArguments)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,133 @@
+/**
+ * @file bindings/cli/append_param.hpp
+ *
+ * Append the value of a matrix output parameter to its file, for the streaming
+ * mode of the command-line programs.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_BINDINGS_CLI_APPEND_PARAM_HPP
+#define MLPACK_BINDINGS_CLI_APPEND_PARAM_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/data/extension.hpp>
+#include <fstream>
+
+namespace mlpack {
+namespace bindings {
+namespace cli {
+
+/**
+ * Return the character that separates the values of a line in a text file
+ * that can be streamed, based on its extension: a comma for .csv files, a tab
+ * for .tsv files and a space for .txt files.  A std::invalid_argument is
+ * thrown for any other file type.
+ *
+ * @param filename Name of the file.
+ */
+inline char StreamSeparator(const std::string& filename)
+{
+  const std::string extension = data::Extension(filename);
+  if (extension == "csv")
+    return ',';
+  else if (extension == "tsv")
+    return '\t';
+  else if (extension == "txt")
+    return ' ';
+
+  throw std::invalid_argument("cannot stream file '" + filename + "': only "
+      ".csv, .tsv and .txt files can be streamed");
+}
+
+/**
+ * This overload is called for parameters that are not matrices; they can't be
+ * appended to a file, so there is nothing to do.
+ */
+template<typename T>
+void AppendParamImpl(
+    const util::ParamData& /* data */,
+    const bool /* truncate */,
+    const typename boost::disable_if<arma::is_arma_type<T>>::type* = 0)
+{
+  // Nothing to do.
+}
+
+/**
+ * Append a matrix output parameter to its file, one line per point (or per
+ * element, for vectors), and then clear the matrix, so that it holds only the
+ * results of the next chunk.
+ */
+template<typename T>
+void AppendParamImpl(
+    const util::ParamData& data,
+    const bool truncate,
+    const typename boost::enable_if<arma::is_arma_type<T>>::type* = 0)
+{
+  typedef std::tuple<T, std::string> TupleType;
+  TupleType& tuple = const_cast<TupleType&>(
+      *boost::any_cast<TupleType>(&data.value));
+  T& output = std::get<0>(tuple);
+  const std::string& filename = std::get<1>(tuple);
+  if (filename == "")
+    return;
+
+  const bool isVector = (arma::is_Row<T>::value || arma::is_Col<T>::value);
+  if (!isVector && data.noTranspose)
+  {
+    throw std::invalid_argument("output parameter '" + data.name + "' is not "
+        "transposed, so it cannot be streamed");
+  }
+
+  const char separator = StreamSeparator(filename);
+  std::ofstream stream(filename.c_str(),
+      truncate ? std::ios::trunc : std::ios::app);
+  if (!stream.is_open())
+    throw std::runtime_error("cannot open file '" + filename + "' to write");
+  stream.precision(std::numeric_limits<double>::max_digits10);
+
+  // Each column is a point, so it is a line of the file.
+  const size_t lines = isVector ? output.n_elem : output.n_cols;
+  const size_t values = isVector ? 1 : output.n_rows;
+  for (size_t i = 0; i < lines; ++i)
+  {
+    for (size_t j = 0; j < values; ++j)
+    {
+      if (j > 0)
+        stream << separator;
+      stream << output[i * values + j];
+    }
+    stream << '\n';
+  }
+
+  if (!stream.good())
+    throw std::runtime_error("error while writing file '" + filename + "'");
+
+  output.clear();
+}
+
+/**
+ * Append a matrix output parameter to its file; other parameters are ignored.
+ * This is the function that will be called by the streaming mode.
+ *
+ * @param d Parameter information.
+ * @param input Pointer to a bool that is true if the file should be truncated
+ *     first (for the first chunk).
+ * @param * (output) Unused parameter.
+ */
+template<typename T>
+void AppendParam(const util::ParamData& d,
+                 const void* input,
+                 void* /* output */)
+{
+  AppendParamImpl<typename std::remove_pointer<T>::type>(d,
+      *((const bool*) input));
+}
+
+} // namespace cli
+} // namespace bindings
+} // namespace mlpack
+
+#endif
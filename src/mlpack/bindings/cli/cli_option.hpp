@@ -18,6 +18,7 @@
 #include <mlpack/core/util/cli.hpp>
 #include "parameter_type.hpp"
 #include "add_to_po.hpp"
+#include "append_param.hpp"
 #include "default_param.hpp"
 #include "output_param.hpp"
 #include "get_printable_param.hpp"
@@ -162,6 +163,7 @@ class CLIOption
     CLI::GetSingleton().functionMap[tname]["DeleteAllocatedMemory"] =
         &DeleteAllocatedMemory<N>;
     CLI::GetSingleton().functionMap[tname]["InPlaceCopy"] = &InPlaceCopy<N>;
+    CLI::GetSingleton().functionMap[tname]["AppendParam"] = &AppendParam<N>;
   }
 };
 
@@ -14,11 +14,54 @@
 #define MLPACK_BINDINGS_CLI_END_PROGRAM_HPP
 
 #include <mlpack/core/util/cli.hpp>
+#include "model_cache.hpp"
 
 namespace mlpack {
 namespace bindings {
 namespace cli {
 
+/**
+ * Delete the memory held by the parameters of the program (that is, the
+ * models).  This is called by EndProgram(), and by Serve() when a request
+ * fails.
+ */
+inline void DeleteAllocatedParameters()
+{
+  // If we are holding any pointers, then we "own" them (unless they belong to
+  // the model cache of server mode).  But we may hold the same pointer twice,
+  // so we have to be careful to not delete it multiple times.
+  const std::map<std::string, util::ParamData>& parameters = CLI::Parameters();
+  std::unordered_map<void*, const util::ParamData*> memoryAddresses;
+  std::map<std::string, util::ParamData>::const_iterator it =
+      parameters.begin();
+  while (it != parameters.end())
+  {
+    const util::ParamData& data = it->second;
+
+    void* result;
+    CLI::GetSingleton().functionMap[data.tname]["GetAllocatedMemory"](data,
+        NULL, (void*) &result);
+    if (result != NULL && memoryAddresses.count(result) == 0 &&
+        !ModelCache::GetSingleton().Owns(result))
+      memoryAddresses[result] = &data;
+
+    ++it;
+  }
+
+  // Now we have all the unique addresses that need to be deleted.
+  std::unordered_map<void*, const util::ParamData*>::const_iterator it2;
+  it2 = memoryAddresses.begin();
+  while (it2 != memoryAddresses.end())
+  {
+    const util::ParamData& data = *(it2->second);
+
+    CLI::GetSingleton().functionMap[data.tname]["DeleteAllocatedMemory"](data,
+        NULL, NULL);
+
+    ++it2;
+  }
+}
+
 /**
  * Handle command-line program termination.  If --help or --info was passed, we
  * won't make it here, so we don't have to write any contingencies for that.
@@ -73,36 +116,8 @@ inline void EndProgram()
     }
   }
 
-  // Lastly clean up any memory.  If we are holding any pointers, then we "own"
-  // them.  But we may hold the same pointer twice, so we have to be careful to
-  // not delete it multiple times.
-  std::unordered_map<void*, const util::ParamData*> memoryAddresses;
-  it = parameters.begin();
-  while (it != parameters.end())
-  {
-    const util::ParamData& data = it->second;
-
-    void* result;
-    CLI::GetSingleton().functionMap[data.tname]["GetAllocatedMemory"](data,
-        NULL, (void*) &result);
-    if (result != NULL && memoryAddresses.count(result) == 0)
-      memoryAddresses[result] = &data;
-
-    ++it;
-  }
-
-  // Now we have all the unique addresses that need to be deleted.
-  std::unordered_map<void*, const util::ParamData*>::const_iterator it2;
-  it2 = memoryAddresses.begin();
-  while (it2 != memoryAddresses.end())
-  {
-    const util::ParamData& data = *(it2->second);
-
-    CLI::GetSingleton().functionMap[data.tname]["DeleteAllocatedMemory"](data,
-        NULL, NULL);
-
-    ++it2;
-  }
+  // Lastly clean up any memory.
+  DeleteAllocatedParameters();
 }
 
 } // namespace cli
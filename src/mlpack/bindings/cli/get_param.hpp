@@ -13,6 +13,7 @@
 #define MLPACK_BINDINGS_CLI_GET_PARAM_HPP
 
 #include <mlpack/prereqs.hpp>
+#include "model_cache.hpp"
 #include "parameter_type.hpp"
 
 namespace mlpack {
@@ -112,8 +113,17 @@ T*& GetParam(
   const std::string& value = std::get<1>(*tuple);
   if (d.input && !d.loaded)
   {
-    T* model = new T();
-    data::Load(value, "model", *model, true);
+    // In server mode, the model may already have been loaded by an earlier
+    // request.
+    ModelCache& cache = ModelCache::GetSingleton();
+    T* model = cache.Enabled() ? cache.Get<T>(value) : NULL;
+    if (model == NULL)
+    {
+      model = new T();
+      data::Load(value, "model", *model, true);
+      if (cache.Enabled())
+        cache.Insert(value, model);
+    }
     d.loaded = true;
     std::get<0>(*tuple) = model;
   }
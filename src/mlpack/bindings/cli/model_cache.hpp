@@ -0,0 +1,172 @@
+/**
+ * @file bindings/cli/model_cache.hpp
+ *
+ * Definition of ModelCache, which holds the models loaded from file by a
+ * command-line program running in server mode, so that later requests that
+ * use the same model file do not load it again.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_BINDINGS_CLI_MODEL_CACHE_HPP
+#define MLPACK_BINDINGS_CLI_MODEL_CACHE_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <sys/stat.h>
+
+namespace mlpack {
+namespace bindings {
+namespace cli {
+
+/**
+ * A cache of the models used by a command-line program, indexed by the name
+ * of their file.  A cached model is reused as long as its file has the same
+ * size and modification time as when the model was loaded (or saved), so
+ * changing the file on disk is enough to make the program load it again.
+ *
+ * The cache owns its models: the pointers returned by Get() must not be
+ * deleted, and EndProgram() skips them when it cleans up the parameters.  As
+ * with the Python and Julia bindings, where models are passed by handle, a
+ * program that modifies its input model modifies the cached model too.
+ *
+ * The cache is only used when Enabled() is true, which is the case when the
+ * program runs in server mode (see Serve()).
+ */
+class ModelCache
+{
+ public:
+  //! Get the cache of the program.
+  static ModelCache& GetSingleton()
+  {
+    static ModelCache cache;
+    return cache;
+  }
+
+  /**
+   * Get the model of type T cached for the given file, or NULL if there is no
+   * such model or the file changed since the model was cached.
+   *
+   * @param filename Name of the file of the model.
+   */
+  template<typename T>
+  T* Get(const std::string& filename)
+  {
+    std::map<std::string, Entry>::const_iterator it = entries.find(filename);
+    if (it == entries.end())
+      return NULL;
+
+    const Entry& entry = it->second;
+    time_t modified;
+    off_t size;
+    if (entry.type != typeid(T).name() ||
+        !FileInfo(filename, modified, size) ||
+        modified != entry.modified || size != entry.size)
+    {
+      entries.erase(filename);
+      return NULL;
+    }
+
+    return static_cast<T*>(entry.model.get());
+  }
+
+  /**
+   * Cache the given model for the given file, which must exist, and take
+   * ownership of the model.  Any model previously cached for the file is
+   * deleted, unless it is also cached for another file.
+   *
+   * @param filename Name of the file the model was loaded from or saved to.
+   * @param model Model to cache.
+   */
+  template<typename T>
+  void Insert(const std::string& filename, T* model)
+  {
+    Entry entry;
+    entry.type = typeid(T).name();
+    if (!FileInfo(filename, entry.modified, entry.size))
+      return;
+
+    // The same model may be cached for several files (for instance, when a
+    // program saves its input model to another file), and must then only be
+    // deleted once.
+    for (std::map<std::string, Entry>::const_iterator it = entries.begin();
+         it != entries.end(); ++it)
+    {
+      if (it->second.model.get() == (void*) model)
+        entry.model = it->second.model;
+    }
+    if (!entry.model)
+      entry.model = std::shared_ptr<void>(model, [](void* p)
+          { delete static_cast<T*>(p); });
+
+    entries[filename] = entry;
+  }
+
+  //! Return whether the given model is owned by the cache.
+  bool Owns(const void* model) const
+  {
+    for (std::map<std::string, Entry>::const_iterator it = entries.begin();
+         it != entries.end(); ++it)
+    {
+      if (it->second.model.get() == model)
+        return true;
+    }
+
+    return false;
+  }
+
+  //! Delete every cached model.
+  void Clear() { entries.clear(); }
+
+  //! Get the number of cached files.
+  size_t Size() const { return entries.size(); }
+
+  //! Get whether the cache is used.
+  bool Enabled() const { return enabled; }
+  //! Modify whether the cache is used.
+  bool& Enabled() { return enabled; }
+
+ private:
+  //! Create an empty, disabled cache.
+  ModelCache() : enabled(false) { }
+
+  //! A cached model and the state of its file when it was cached.
+  struct Entry
+  {
+    //! The model.
+    std::shared_ptr<void> model;
+    //! The name of the type of the model.
+    std::string type;
+    //! The modification time of the file.
+    time_t modified;
+    //! The size of the file.
+    off_t size;
+  };
+
+  //! Get the modification time and size of the given file, returning false
+  //! if the file does not exist.
+  static bool FileInfo(const std::string& filename,
+                       time_t& modified,
+                       off_t& size)
+  {
+    struct stat info;
+    if (stat(filename.c_str(), &info) != 0)
+      return false;
+
+    modified = info.st_mtime;
+    size = info.st_size;
+    return true;
+  }
+
+  //! The cached models, indexed by file name.
+  std::map<std::string, Entry> entries;
+  //! Whether the cache is used.
+  bool enabled;
+};
+
+} // namespace cli
+} // namespace bindings
+} // namespace mlpack
+
+#endif
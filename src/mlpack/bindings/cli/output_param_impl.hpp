@@ -13,6 +13,7 @@
 #define MLPACK_CORE_UTIL_OUTPUT_PARAM_IMPL_HPP
 
 #include "output_param.hpp"
+#include "model_cache.hpp"
 #include <mlpack/core/data/save.hpp>
 #include <iostream>
 
@@ -84,7 +85,15 @@ void OutputParamImpl(
       std::get<1>(*boost::any_cast<TupleType>(&data.value));
 
   if (filename != "")
+  {
     data::Save(filename, "model", *output);
+
+    // In server mode, later requests can use the saved model without loading
+    // it.
+    ModelCache& cache = ModelCache::GetSingleton();
+    if (cache.Enabled())
+      cache.Insert(filename, output);
+  }
 }
 
 //! Output a mapped dataset.
@@ -0,0 +1,177 @@
+/**
+ * @file bindings/cli/serve.hpp
+ *
+ * Server mode of the command-line programs: the program reads requests (each
+ * one a command line) from standard input and runs them one after another,
+ * keeping the models it loads in memory between requests.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_BINDINGS_CLI_SERVE_HPP
+#define MLPACK_BINDINGS_CLI_SERVE_HPP
+
+#include <mlpack/core.hpp>
+#include "end_program.hpp"
+#include "model_cache.hpp"
+
+namespace mlpack {
+namespace bindings {
+namespace cli {
+
+// Defined in parse_command_line.hpp, which is included by the program itself.
+void ParseCommandLine(int argc, char** argv);
+
+/**
+ * Return whether the program was started in server mode, that is whether
+ * --serve is one of its arguments.
+ */
+inline bool ServeRequested(int argc, char** argv)
+{
+  for (int i = 1; i < argc; ++i)
+    if (std::string(argv[i]) == "--serve")
+      return true;
+
+  return false;
+}
+
+/**
+ * Split a request into its arguments, as a shell would for a command line:
+ * arguments are separated by whitespace, and can be quoted with double quotes
+ * to contain whitespace.
+ *
+ * @param request Request to split.
+ * @return The arguments of the request.
+ */
+inline std::vector<std::string> SplitRequest(const std::string& request)
+{
+  std::vector<std::string> arguments;
+  std::string argument;
+  bool inArgument = false;
+  bool quoted = false;
+  for (size_t i = 0; i < request.size(); ++i)
+  {
+    const char c = request[i];
+    if (c == '"')
+    {
+      quoted = !quoted;
+      inArgument = true;
+    }
+    else if (!quoted && std::isspace((unsigned char) c))
+    {
+      if (inArgument)
+        arguments.push_back(argument);
+      argument.clear();
+      inArgument = false;
+    }
+    else
+    {
+      argument += c;
+      inArgument = true;
+    }
+  }
+
+  if (quoted)
+    throw std::invalid_argument("unterminated quote in request");
+  if (inArgument)
+    arguments.push_back(argument);
+
+  return arguments;
+}
+
+/**
+ * Run the program in server mode: read requests from the given stream, one per
+ * line, and run each one as if it were the command line of the program.  Each
+ * request starts from the default values of the parameters, so it must be
+ * complete; the answer to a request is whatever the program prints, followed by
+ * a line that is either "ok" or "error: " and a description of the error (the
+ * messages of Log::Fatal go to standard error, as usual).  Empty lines are
+ * ignored, and the server stops at the end of the stream or at a "quit"
+ * request.
+ *
+ * Models loaded from files (the --input_model_file parameters) are kept in a
+ * ModelCache, so later requests with the same file use the model in memory
+ * instead of loading it again, as long as the file does not change.  Models
+ * the program saves are cached too.
+ *
+ * @param mlpackMain The mlpackMain() function of the program.
+ * @param input Stream to read the requests from.
+ * @param output Stream to write the status of the requests to.
+ */
+inline void Serve(void (*mlpackMain)(),
+                  std::istream& input = std::cin,
+                  std::ostream& output = std::cout)
+{
+  // Keep the default values of the parameters, to start each request from
+  // them.
+  const std::string programName = CLI::ProgramName();
+  CLI::StoreSettings("serve");
+  ModelCache::GetSingleton().Enabled() = true;
+
+  std::string request;
+  while (std::getline(input, request))
+  {
+    std::vector<std::string> arguments;
+    try
+    {
+      arguments = SplitRequest(request);
+    }
+    catch (std::exception& e)
+    {
+      output << "error: " << e.what() << std::endl;
+      continue;
+    }
+
+    if (arguments.empty())
+      continue;
+    if (arguments.size() == 1 && arguments[0] == "quit")
+      break;
+
+    CLI::RestoreSettings("serve");
+    Timer::ResetAll();
+    Log::Info.ignoreInput = true;
+    try
+    {
+      // These options would print their output and exit.
+      for (size_t i = 0; i < arguments.size(); ++i)
+      {
+        if (arguments[i] == "--help" || arguments[i] == "-h" ||
+            arguments[i] == "--info" || arguments[i] == "--version" ||
+            arguments[i] == "-V" || arguments[i] == "--serve")
+        {
+          throw std::invalid_argument("option " + arguments[i] + " is not "
+              "available in server mode");
+        }
+      }
+
+      std::vector<char*> argv(1, const_cast<char*>(programName.c_str()));
+      for (size_t i = 0; i < arguments.size(); ++i)
+        argv.push_back(&arguments[i][0]);
+
+      ParseCommandLine(argv.size(), argv.data());
+      Timer::EnableTiming();
+      Timer::Start("total_time");
+
+      mlpackMain();
+      EndProgram();
+      output << "ok" << std::endl;
+    }
+    catch (std::exception& e)
+    {
+      DeleteAllocatedParameters();
+      output << "error: " << e.what() << std::endl;
+    }
+  }
+
+  CLI::ClearSettings();
+  ModelCache::GetSingleton().Clear();
+  ModelCache::GetSingleton().Enabled() = false;
+}
+
+} // namespace cli
+} // namespace bindings
+} // namespace mlpack
+
+#endif
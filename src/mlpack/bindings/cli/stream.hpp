@@ -0,0 +1,339 @@
+/**
+ * @file bindings/cli/stream.hpp
+ *
+ * Streaming mode of the command-line programs: the input dataset is read in
+ * chunks of points, the program is run on each chunk, and the matrix outputs
+ * of each chunk are appended to the output files, so that datasets larger
+ * than the memory can be processed.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_BINDINGS_CLI_STREAM_HPP
+#define MLPACK_BINDINGS_CLI_STREAM_HPP
+
+#include <mlpack/core.hpp>
+#include "append_param.hpp"
+#include "end_program.hpp"
+#include "print_doc_functions.hpp"
+
+namespace mlpack {
+namespace bindings {
+namespace cli {
+
+// Defined in parse_command_line.hpp, which is included by the program itself.
+void ParseCommandLine(int argc, char** argv);
+
+/**
+ * Return the name of the input parameter that the program can stream, or an
+ * empty string if the program can't be run in streaming mode.
+ */
+inline std::string& StreamingInputName()
+{
+  static std::string name;
+  return name;
+}
+
+/**
+ * A static object whose constructor marks a matrix input parameter as the one
+ * that can be streamed.  Use the BINDING_STREAMING_INPUT() macro to declare
+ * it.
+ */
+class StreamingInput
+{
+ public:
+  //! Mark the given input parameter as the one to stream.
+  StreamingInput(const std::string& name) { StreamingInputName() = name; }
+};
+
+/**
+ * Find the --stream_chunk_size option in the arguments of the program, and
+ * remove it from them.  If the option isn't given, 0 is returned.
+ *
+ * @param argc Number of arguments; it is modified if the option is removed.
+ * @param argv Arguments of the program.
+ * @return The number of points of each chunk, or 0 if the option isn't given.
+ */
+inline size_t StreamChunkSize(int& argc, char** argv)
+{
+  const std::string option = "--stream_chunk_size";
+  for (int i = 1; i < argc; ++i)
+  {
+    const std::string argument(argv[i]);
+    std::string value;
+    int used = 1;
+    if (argument == option && i + 1 < argc)
+    {
+      value = argv[i + 1];
+      used = 2;
+    }
+    else if (argument.compare(0, option.size() + 1, option + "=") == 0)
+    {
+      value = argument.substr(option.size() + 1);
+    }
+    else if (argument == option)
+    {
+      throw std::invalid_argument("option " + option + " requires a value");
+    }
+    else
+    {
+      continue;
+    }
+
+    char* end;
+    const long long chunkSize = std::strtoll(value.c_str(), &end, 10);
+    if (value.empty() || *end != '\0' || chunkSize <= 0)
+    {
+      throw std::invalid_argument("invalid value '" + value + "' for " +
+          option + "; it must be a positive integer");
+    }
+
+    for (int j = i + used; j < argc; ++j)
+      argv[j - used] = argv[j];
+    argc -= used;
+
+    return (size_t) chunkSize;
+  }
+
+  return 0;
+}
+
+/**
+ * Read the next chunk of points from a text file, one point per line (empty
+ * lines are skipped).  The points are stored as the columns of the given
+ * matrix; if the end of the stream is reached before any point is read, the
+ * matrix is empty.
+ *
+ * @param stream Stream to read the points from.
+ * @param separator Character that separates the values of a line; for a space,
+ *     any whitespace separates values.
+ * @param chunkSize Maximum number of points to read.
+ * @param chunk Matrix to store the points in.
+ * @param line Number of lines read from the stream so far; it is updated.
+ */
+inline void ReadChunk(std::istream& stream,
+                      const char separator,
+                      const size_t chunkSize,
+                      arma::mat& chunk,
+                      size_t& line)
+{
+  std::vector<double> values;
+  size_t dimensionality = 0;
+  size_t points = 0;
+  std::string text;
+  while (points < chunkSize && std::getline(stream, text))
+  {
+    ++line;
+    if (!text.empty() && text[text.size() - 1] == '\r')
+      text.erase(text.size() - 1);
+    if (text.find_first_not_of(" \t") == std::string::npos)
+      continue;
+
+    size_t lineValues = 0;
+    const char* position = text.c_str();
+    while (true)
+    {
+      char* end;
+      const double value = std::strtod(position, &end);
+      if (end == position)
+      {
+        std::ostringstream oss;
+        oss << "line " << line << ": cannot parse '" << position << "'";
+        throw std::runtime_error(oss.str());
+      }
+      values.push_back(value);
+      ++lineValues;
+
+      position = end;
+      while (*position == ' ' || *position == '\t')
+        ++position;
+      if (*position == '\0')
+        break;
+      if (separator != ' ')
+      {
+        if (*position != separator)
+        {
+          std::ostringstream oss;
+          oss << "line " << line << ": expected '" << separator << "' before '"
+              << position << "'";
+          throw std::runtime_error(oss.str());
+        }
+        ++position;
+      }
+    }
+
+    if (points == 0)
+    {
+      dimensionality = lineValues;
+    }
+    else if (lineValues != dimensionality)
+    {
+      std::ostringstream oss;
+      oss << "line " << line << " has " << lineValues << " values, but "
+          << "previous lines have " << dimensionality;
+      throw std::runtime_error(oss.str());
+    }
+    ++points;
+  }
+
+  chunk = arma::mat(values.data(), dimensionality, points);
+}
+
+/**
+ * Run the program in streaming mode: the input parameter given by
+ * BINDING_STREAMING_INPUT() is read in chunks of chunkSize points, the program
+ * is run on each chunk, and after each chunk its matrix outputs are appended
+ * to their files.  Only the chunk and the outputs of the chunk are held in
+ * memory.  Models and the other input parameters are loaded once, except for
+ * matrices, which are loaded again for each chunk, since the program may take
+ * them over.  The streamed input and the matrix outputs must be .csv, .tsv or
+ * .txt files, and output models can't be saved: a model should be trained
+ * first, and then given to the streaming run.
+ *
+ * @param mlpackMain The mlpackMain() function of the program.
+ * @param chunkSize Number of points of each chunk.
+ * @param argc Number of arguments of the program (without the
+ *     --stream_chunk_size option).
+ * @param argv Arguments of the program.
+ */
+inline void Stream(void (*mlpackMain)(),
+                   const size_t chunkSize,
+                   int argc,
+                   char** argv)
+{
+  ParseCommandLine(argc, argv);
+  Timer::EnableTiming();
+  Timer::Start("total_time");
+
+  const std::string& name = StreamingInputName();
+  std::map<std::string, util::ParamData>& parameters = CLI::Parameters();
+  if (name.empty() || parameters.count(name) == 0)
+    Log::Fatal << "This program can't be run in streaming mode." << std::endl;
+
+  util::ParamData& input = parameters[name];
+  if (input.cppType != "arma::mat" || input.noTranspose)
+  {
+    Log::Fatal << "Input " << ParamString(name) << " can't be streamed."
+        << std::endl;
+  }
+  if (!CLI::HasParam(name))
+  {
+    Log::Fatal << "Streaming mode requires " << ParamString(name) << "."
+        << std::endl;
+  }
+
+  // Check that the outputs can be streamed.
+  std::vector<util::ParamData*> outputs;
+  for (auto& it : parameters)
+  {
+    util::ParamData& d = it.second;
+    if (d.input || !CLI::HasParam(d.name))
+      continue;
+
+    if (d.cppType.compare(0, 6, "arma::") == 0)
+    {
+      outputs.push_back(&d);
+    }
+    else
+    {
+      std::string boostName;
+      CLI::GetSingleton().functionMap[d.tname]["MapParameterName"](d, NULL,
+          (void*) &boostName);
+      if (boostName.size() > 5 &&
+          boostName.compare(boostName.size() - 5, 5, "_file") == 0)
+      {
+        Log::Fatal << "Output " << ParamString(d.name) << " can't be saved in "
+            << "streaming mode." << std::endl;
+      }
+    }
+  }
+
+  const std::string filename =
+      std::get<1>(*boost::any_cast<std::tuple<arma::mat, std::string>>(
+      &input.value));
+  std::ifstream stream(filename.c_str());
+  if (!stream.is_open())
+    Log::Fatal << "Cannot open file '" << filename << "'." << std::endl;
+
+  char separator = ',';
+  try
+  {
+    separator = StreamSeparator(filename);
+  }
+  catch (std::invalid_argument& e)
+  {
+    Log::Fatal << e.what() << "." << std::endl;
+  }
+
+  size_t line = 0, points = 0, dimensionality = 0;
+  for (size_t c = 0; ; ++c)
+  {
+    arma::mat& chunk = CLI::GetRawParam<arma::mat>(name);
+    try
+    {
+      ReadChunk(stream, separator, chunkSize, chunk, line);
+    }
+    catch (std::runtime_error& e)
+    {
+      Log::Fatal << "Error while reading '" << filename << "': " << e.what()
+          << "." << std::endl;
+    }
+
+    if (chunk.n_cols == 0)
+      break;
+    if (c == 0)
+    {
+      dimensionality = chunk.n_rows;
+    }
+    else if (chunk.n_rows != dimensionality)
+    {
+      Log::Fatal << "Error while reading '" << filename << "': line " << line
+          << " has " << chunk.n_rows << " values, but previous lines have "
+          << dimensionality << "." << std::endl;
+    }
+    input.loaded = true;
+    points += chunk.n_cols;
+
+    // The program may have taken over the other input matrices.
+    for (auto& it : parameters)
+    {
+      util::ParamData& d = it.second;
+      if (d.input && d.name != name && d.cppType.compare(0, 6, "arma::") == 0)
+        d.loaded = false;
+    }
+
+    mlpackMain();
+
+    const bool truncate = (c == 0);
+    for (size_t i = 0; i < outputs.size(); ++i)
+    {
+      try
+      {
+        CLI::GetSingleton().functionMap[outputs[i]->tname]["AppendParam"](
+            *outputs[i], (const void*) &truncate, NULL);
+      }
+      catch (std::exception& e)
+      {
+        Log::Fatal << "Cannot save " << ParamString(outputs[i]->name) << ": "
+            << e.what() << "." << std::endl;
+      }
+    }
+
+    Log::Info << "Processed " << points << " points." << std::endl;
+  }
+
+  if (points == 0)
+    Log::Warn << "No points in '" << filename << "'." << std::endl;
+
+  // The matrix outputs are empty now, so this only prints the other outputs
+  // (of the last chunk) and cleans up.
+  EndProgram();
+}
+
+} // namespace cli
+} // namespace bindings
+} // namespace mlpack
+
+#endif
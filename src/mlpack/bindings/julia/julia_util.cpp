@@ -556,7 +556,7 @@ double* CLI_GetParamMatWithInfoPtr(const char* paramName)
  */
 void CLI_EnableVerbose()
 {
-  Log::Info.ignoreInput = false;
+  Log::Info.SetIgnoreInput(false);
 }
 
 /**
@@ -564,7 +564,7 @@ void CLI_EnableVerbose()
  */
 void CLI_DisableVerbose()
 {
-  Log::Info.ignoreInput = true;
+  Log::Info.SetIgnoreInput(true);
 }
 
 /**
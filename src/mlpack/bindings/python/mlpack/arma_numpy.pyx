@@ -4,10 +4,14 @@ arma_numpy.pyx: Armadillo/numpy interface functionality.
 
 This file defines a number of functions useful for converting between Armadillo
 and numpy objects without actually copying memory.  Note that if a numpy matrix
-is converted to an Armadillo object, then the Armadillo object will "own" the
-matrix and free the memory upon destruction (and the numpy object will no longer
-"own" the matrix).  Similarly, if an Armadillo object is converted to a numpy
-object, then the numpy object will "own" the matrix.
+is converted to an Armadillo object with takeOwnership set, then the Armadillo
+object will "own" the matrix and free the memory upon destruction (and the numpy
+object will no longer "own" the matrix).  Otherwise, the Armadillo object uses
+the memory of the numpy array (which may be a view) directly, and the numpy
+array must be kept alive as long as the Armadillo object is used.  Similarly, if
+an Armadillo object that owns its memory is converted to a numpy object, then
+the numpy object will "own" the matrix; if it does not own its memory, the numpy
+object gets a copy.
 
 Thus, know that if you convert a matrix type, remember that the resulting type
 is what "owns" the allocated memory.
@@ -48,18 +52,29 @@ cdef arma.Mat[double]* numpy_to_mat_d(numpy.ndarray[numpy.double_t, ndim=2] X, \
   """
   Convert a numpy ndarray to a matrix.  The memory will still be owned by numpy.
   """
-  if not X.flags.c_contiguous or (not X.flags.owndata and not isWin):
-    # If needed, make a copy where we own the memory.
+  if not X.flags.c_contiguous:
+    # This only happens if to_matrix() was not used; make a copy with the
+    # layout Armadillo expects.
     X = X.copy(order="C")
     takeOwnership = True
 
-  cdef arma.Mat[double]* m = new arma.Mat[double](<double*> X.data, X.shape[1],\
-      X.shape[0], isWin, False)
-
-  # Take ownership of the memory, if we need to and we are not on Windows.
-  if takeOwnership and not isWin:
+  cdef arma.Mat[double]* m
+  if takeOwnership and X.flags.owndata and not isWin:
+    # Give the memory to Armadillo.  (On Windows, numpy and Armadillo may use
+    # different allocators, so this can't be done there.)
+    m = new arma.Mat[double](<double*> X.data, X.shape[1],
+        X.shape[0], False, False)
     PyArray_CLEARFLAGS(X, numpy.NPY_OWNDATA)
     SetMemState[arma.Mat[double]](m[0], 0)
+  elif takeOwnership:
+    # Nothing keeps X alive after we return, so Armadillo needs its own copy.
+    m = new arma.Mat[double](<double*> X.data, X.shape[1],
+        X.shape[0], True, False)
+  else:
+    # Use the memory of X directly, even if X is a view; the caller keeps X
+    # alive while Armadillo uses it.
+    m = new arma.Mat[double](<double*> X.data, X.shape[1],
+        X.shape[0], False, False)
 
   return m
 
@@ -68,19 +83,29 @@ cdef arma.Mat[size_t]* numpy_to_mat_s(numpy.ndarray[numpy.npy_intp, ndim=2] X, \
   """
   Convert a numpy ndarray to a matrix.  The memory will still be owned by numpy.
   """
-  if not X.flags.c_contiguous or (not X.flags.owndata and not isWin):
-    # If needed, make a copy where we own the memory, except on Windows where
-    # we never copy.
+  if not X.flags.c_contiguous:
+    # This only happens if to_matrix() was not used; make a copy with the
+    # layout Armadillo expects.
     X = X.copy(order="C")
     takeOwnership = True
 
-  cdef arma.Mat[size_t]* m = new arma.Mat[size_t](<size_t*> X.data, X.shape[1],
-      X.shape[0], isWin, False)
-
-  # Take ownership of the memory, if we need to.
-  if takeOwnership and not isWin:
+  cdef arma.Mat[size_t]* m
+  if takeOwnership and X.flags.owndata and not isWin:
+    # Give the memory to Armadillo.  (On Windows, numpy and Armadillo may use
+    # different allocators, so this can't be done there.)
+    m = new arma.Mat[size_t](<size_t*> X.data, X.shape[1],
+        X.shape[0], False, False)
     PyArray_CLEARFLAGS(X, numpy.NPY_OWNDATA)
     SetMemState[arma.Mat[size_t]](m[0], 0)
+  elif takeOwnership:
+    # Nothing keeps X alive after we return, so Armadillo needs its own copy.
+    m = new arma.Mat[size_t](<size_t*> X.data, X.shape[1],
+        X.shape[0], True, False)
+  else:
+    # Use the memory of X directly, even if X is a view; the caller keeps X
+    # alive while Armadillo uses it.
+    m = new arma.Mat[size_t](<size_t*> X.data, X.shape[1],
+        X.shape[0], False, False)
 
   return m
 
@@ -95,11 +120,12 @@ cdef numpy.ndarray[numpy.double_t, ndim=2] mat_to_numpy_d(arma.Mat[double]& X) \
   dims[1] = <numpy.npy_intp> X.n_rows
   cdef numpy.ndarray[numpy.double_t, ndim=2] output = \
       numpy.PyArray_SimpleNewFromData(2, &dims[0], numpy.NPY_DOUBLE, GetMemory(X))
-  if isWin:
+  if isWin or GetMemState[arma.Mat[double]](X) != 0:
+    # The memory can't be given to numpy (it may even belong to an input
+    # array), so numpy gets a copy.
     output = output.copy(order="C")
-
-  # Transfer memory ownership, if needed.
-  if GetMemState[arma.Mat[double]](X) == 0 and not isWin:
+  else:
+    # Transfer memory ownership.
     SetMemState[arma.Mat[double]](X, 1)
     PyArray_ENABLEFLAGS(output, numpy.NPY_OWNDATA)
 
@@ -116,11 +142,12 @@ cdef numpy.ndarray[numpy.npy_intp, ndim=2] mat_to_numpy_s(arma.Mat[size_t]& X) \
   dims[1] = <numpy.npy_intp> X.n_rows
   cdef numpy.ndarray[numpy.npy_intp, ndim=2] output = \
       numpy.PyArray_SimpleNewFromData(2, &dims[0], numpy.NPY_INTP, GetMemory(X))
-  if isWin:
+  if isWin or GetMemState[arma.Mat[size_t]](X) != 0:
+    # The memory can't be given to numpy (it may even belong to an input
+    # array), so numpy gets a copy.
     output = output.copy(order="C")
-
-  # Transfer memory ownership, if needed.
-  if GetMemState[arma.Mat[size_t]](X) == 0 and not isWin:
+  else:
+    # Transfer memory ownership.
     SetMemState[arma.Mat[size_t]](X, 1)
     PyArray_ENABLEFLAGS(output, numpy.NPY_OWNDATA)
 
@@ -132,19 +159,26 @@ cdef arma.Row[double]* numpy_to_row_d(numpy.ndarray[numpy.double_t, ndim=1] X, \
   Convert a numpy one-dimensional ndarray to a row.  The memory will still be
   owned by numpy.
   """
-  if not X.flags.c_contiguous or (not X.flags.owndata and not isWin):
-    # If needed, make a copy where we own the memory, except on Windows where
-    # we never copy.
+  if not X.flags.c_contiguous:
+    # This only happens if to_matrix() was not used; make a copy with the
+    # layout Armadillo expects.
     X = X.copy(order="C")
     takeOwnership = True
 
-  cdef arma.Row[double]* m = new arma.Row[double](<double*> X.data, X.shape[0],
-      isWin, False)
-
-  # Transfer memory ownership, if needed.
-  if takeOwnership and not isWin:
+  cdef arma.Row[double]* m
+  if takeOwnership and X.flags.owndata and not isWin:
+    # Give the memory to Armadillo.  (On Windows, numpy and Armadillo may use
+    # different allocators, so this can't be done there.)
+    m = new arma.Row[double](<double*> X.data, X.shape[0], False, False)
     PyArray_CLEARFLAGS(X, numpy.NPY_OWNDATA)
     SetMemState[arma.Row[double]](m[0], 0)
+  elif takeOwnership:
+    # Nothing keeps X alive after we return, so Armadillo needs its own copy.
+    m = new arma.Row[double](<double*> X.data, X.shape[0], True, False)
+  else:
+    # Use the memory of X directly, even if X is a view; the caller keeps X
+    # alive while Armadillo uses it.
+    m = new arma.Row[double](<double*> X.data, X.shape[0], False, False)
 
   return m
 
@@ -154,19 +188,26 @@ cdef arma.Row[size_t]* numpy_to_row_s(numpy.ndarray[numpy.npy_intp, ndim=1] X, \
   Convert a numpy one-dimensional ndarray to a row.  The memory will still be
   owned by numpy.
   """
-  if not X.flags.c_contiguous or (not X.flags.owndata and not isWin):
-    # If needed, make a copy where we own the memory, except on Windows where
-    # we never copy.
+  if not X.flags.c_contiguous:
+    # This only happens if to_matrix() was not used; make a copy with the
+    # layout Armadillo expects.
     X = X.copy(order="C")
     takeOwnership = True
 
-  cdef arma.Row[size_t]* m = new arma.Row[size_t](<size_t*> X.data, X.shape[0],
-      isWin, False)
-
-  # Transfer memory ownership, if needed.
-  if takeOwnership and not isWin:
+  cdef arma.Row[size_t]* m
+  if takeOwnership and X.flags.owndata and not isWin:
+    # Give the memory to Armadillo.  (On Windows, numpy and Armadillo may use
+    # different allocators, so this can't be done there.)
+    m = new arma.Row[size_t](<size_t*> X.data, X.shape[0], False, False)
     PyArray_CLEARFLAGS(X, numpy.NPY_OWNDATA)
     SetMemState[arma.Row[size_t]](m[0], 0)
+  elif takeOwnership:
+    # Nothing keeps X alive after we return, so Armadillo needs its own copy.
+    m = new arma.Row[size_t](<size_t*> X.data, X.shape[0], True, False)
+  else:
+    # Use the memory of X directly, even if X is a view; the caller keeps X
+    # alive while Armadillo uses it.
+    m = new arma.Row[size_t](<size_t*> X.data, X.shape[0], False, False)
 
   return m
 
@@ -179,11 +220,12 @@ cdef numpy.ndarray[numpy.double_t, ndim=1] row_to_numpy_d(arma.Row[double]& X) \
   cdef numpy.npy_intp dim = <numpy.npy_intp> X.n_elem
   cdef numpy.ndarray[numpy.double_t, ndim=1] output = \
       numpy.PyArray_SimpleNewFromData(1, &dim, numpy.NPY_DOUBLE, GetMemory(X))
-  if isWin:
+  if isWin or GetMemState[arma.Row[double]](X) != 0:
+    # The memory can't be given to numpy (it may even belong to an input
+    # array), so numpy gets a copy.
     output = output.copy(order="C")
-
-  # Transfer memory ownership, if needed.
-  if GetMemState[arma.Row[double]](X) == 0 and not isWin:
+  else:
+    # Transfer memory ownership.
     SetMemState[arma.Row[double]](X, 1)
     PyArray_ENABLEFLAGS(output, numpy.NPY_OWNDATA)
 
@@ -199,11 +241,12 @@ cdef numpy.ndarray[numpy.npy_intp, ndim=1] row_to_numpy_s(arma.Row[size_t]& X) \
   cdef numpy.npy_intp dim = <numpy.npy_intp> X.n_elem
   cdef numpy.ndarray[numpy.npy_intp, ndim=1] output = \
       numpy.PyArray_SimpleNewFromData(1, &dim, numpy.NPY_INTP, GetMemory(X))
-  if isWin:
+  if isWin or GetMemState[arma.Row[size_t]](X) != 0:
+    # The memory can't be given to numpy (it may even belong to an input
+    # array), so numpy gets a copy.
     output = output.copy(order="C")
-
-  # Transfer memory ownership, if needed.
-  if GetMemState[arma.Row[size_t]](X) == 0 and not isWin:
+  else:
+    # Transfer memory ownership.
     SetMemState[arma.Row[size_t]](X, 1)
     PyArray_ENABLEFLAGS(output, numpy.NPY_OWNDATA)
 
@@ -215,19 +258,26 @@ cdef arma.Col[double]* numpy_to_col_d(numpy.ndarray[numpy.double_t, ndim=1] X, \
   Convert a numpy one-dimensional ndarray to a column vector.  The memory will
   still be owned by numpy.
   """
-  if not X.flags.c_contiguous or (not X.flags.owndata and not isWin):
-    # If needed, make a copy where we own the memory, except on Windows where
-    # we never copy.
+  if not X.flags.c_contiguous:
+    # This only happens if to_matrix() was not used; make a copy with the
+    # layout Armadillo expects.
     X = X.copy(order="C")
     takeOwnership = True
 
-  cdef arma.Col[double]* m = new arma.Col[double](<double*> X.data, X.shape[0],
-      isWin, False)
-
-  # Transfer memory ownership, if needed.
-  if takeOwnership and not isWin:
+  cdef arma.Col[double]* m
+  if takeOwnership and X.flags.owndata and not isWin:
+    # Give the memory to Armadillo.  (On Windows, numpy and Armadillo may use
+    # different allocators, so this can't be done there.)
+    m = new arma.Col[double](<double*> X.data, X.shape[0], False, False)
     PyArray_CLEARFLAGS(X, numpy.NPY_OWNDATA)
     SetMemState[arma.Col[double]](m[0], 0)
+  elif takeOwnership:
+    # Nothing keeps X alive after we return, so Armadillo needs its own copy.
+    m = new arma.Col[double](<double*> X.data, X.shape[0], True, False)
+  else:
+    # Use the memory of X directly, even if X is a view; the caller keeps X
+    # alive while Armadillo uses it.
+    m = new arma.Col[double](<double*> X.data, X.shape[0], False, False)
 
   return m
 
@@ -237,19 +287,26 @@ cdef arma.Col[size_t]* numpy_to_col_s(numpy.ndarray[numpy.npy_intp, ndim=1] X, \
   Convert a numpy one-dimensional ndarray to a column vector.  The memory will
   still be owned by numpy.
   """
-  if not X.flags.c_contiguous or (not X.flags.owndata and not isWin):
-    # If needed, make a copy where we own the memory, except on Windows where
-    # we never copy.
+  if not X.flags.c_contiguous:
+    # This only happens if to_matrix() was not used; make a copy with the
+    # layout Armadillo expects.
     X = X.copy(order="C")
     takeOwnership = True
 
-  cdef arma.Col[size_t]* m = new arma.Col[size_t](<size_t*> X.data, X.shape[0],
-      isWin, False)
-
-  # Transfer memory ownership, if needed.
-  if takeOwnership and not isWin:
+  cdef arma.Col[size_t]* m
+  if takeOwnership and X.flags.owndata and not isWin:
+    # Give the memory to Armadillo.  (On Windows, numpy and Armadillo may use
+    # different allocators, so this can't be done there.)
+    m = new arma.Col[size_t](<size_t*> X.data, X.shape[0], False, False)
     PyArray_CLEARFLAGS(X, numpy.NPY_OWNDATA)
     SetMemState[arma.Col[size_t]](m[0], 0)
+  elif takeOwnership:
+    # Nothing keeps X alive after we return, so Armadillo needs its own copy.
+    m = new arma.Col[size_t](<size_t*> X.data, X.shape[0], True, False)
+  else:
+    # Use the memory of X directly, even if X is a view; the caller keeps X
+    # alive while Armadillo uses it.
+    m = new arma.Col[size_t](<size_t*> X.data, X.shape[0], False, False)
 
   return m
 
@@ -262,11 +319,12 @@ cdef numpy.ndarray[numpy.double_t, ndim=1] col_to_numpy_d(arma.Col[double]& X) \
   cdef numpy.npy_intp dim = <numpy.npy_intp> X.n_elem
   cdef numpy.ndarray[numpy.double_t, ndim=1] output = \
       numpy.PyArray_SimpleNewFromData(1, &dim, numpy.NPY_DOUBLE, GetMemory(X))
-  if isWin:
+  if isWin or GetMemState[arma.Col[double]](X) != 0:
+    # The memory can't be given to numpy (it may even belong to an input
+    # array), so numpy gets a copy.
     output = output.copy(order="C")
-
-  # Transfer memory ownership, if needed.
-  if GetMemState[arma.Col[double]](X) == 0 and not isWin:
+  else:
+    # Transfer memory ownership.
     SetMemState[arma.Col[double]](X, 1)
     PyArray_ENABLEFLAGS(output, numpy.NPY_OWNDATA)
 
@@ -281,11 +339,12 @@ cdef numpy.ndarray[numpy.npy_intp, ndim=1] col_to_numpy_s(arma.Col[size_t]& X) \
   cdef numpy.npy_intp dim = <numpy.npy_intp> X.n_elem
   cdef numpy.ndarray[numpy.npy_intp, ndim=1] output = \
       numpy.PyArray_SimpleNewFromData(1, &dim, numpy.NPY_INTP, GetMemory(X))
-  if isWin:
+  if isWin or GetMemState[arma.Col[size_t]](X) != 0:
+    # The memory can't be given to numpy (it may even belong to an input
+    # array), so numpy gets a copy.
     output = output.copy(order="C")
-
-  # Transfer memory ownership, if needed.
-  if GetMemState[arma.Col[size_t]](X) == 0 and not isWin:
+  else:
+    # Transfer memory ownership.
     SetMemState[arma.Col[size_t]](X, 1)
     PyArray_ENABLEFLAGS(output, numpy.NPY_OWNDATA)
 
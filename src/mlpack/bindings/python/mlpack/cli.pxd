@@ -40,6 +40,9 @@ cdef extern from "<mlpack/core/util/cli.hpp>" namespace "mlpack" nogil:
 
 cdef extern from "<mlpack/bindings/python/mlpack/cli_util.hpp>" \
     namespace "mlpack::util" nogil:
+  cdef cppclass CLIContext:
+    CLIContext() nogil except +
+
   void SetParam[T](string, T&) nogil except +
   void SetParamPtr[T](string, T*, bool) nogil except +
   void SetParamWithInfo[T](string, T&, const bool*) nogil except +
@@ -19,6 +19,12 @@
 namespace mlpack {
 namespace util {
 
+/**
+ * The context that holds the parameters of one call of a binding.  This
+ * typedef exists because Cython can't declare nested classes.
+ */
+typedef CLI::ScopedContext CLIContext;
+
 /**
  * Set the parameter to the given value.
  *
@@ -123,19 +129,21 @@ T& GetParamWithInfo(const std::string& paramName)
 }
 
 /**
- * Turn verbose output on.
+ * Turn verbose output on.  While a CLI::ScopedContext is active, this only
+ * affects the calling thread.
  */
 inline void EnableVerbose()
 {
-  Log::Info.ignoreInput = false;
+  Log::Info.SetIgnoreInput(false);
 }
 
 /**
- * Turn verbose output off.
+ * Turn verbose output off.  While a CLI::ScopedContext is active, this only
+ * affects the calling thread.
  */
 inline void DisableVerbose()
 {
-  Log::Info.ignoreInput = true;
+  Log::Info.SetIgnoreInput(true);
 }
 
 /**
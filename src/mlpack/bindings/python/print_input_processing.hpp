@@ -97,15 +97,15 @@ void PrintInputProcessing(
 
     if (GetPrintableType<T>(d) == "bool")
     {
-      std::cout << "  else:" << std::endl;
-      std::cout << "    raise TypeError(" <<"\"'"<< name
+      std::cout << prefix << "else:" << std::endl;
+      std::cout << prefix << "  raise TypeError(" <<"\"'"<< name
           << "' must have type \'" << GetPrintableType<T>(d)
           << "'!\")" << std::endl;
     }
     else
     {
-      std::cout << "    else:" << std::endl;
-      std::cout << "      raise TypeError(" <<"\"'"<< name
+      std::cout << prefix << "  else:" << std::endl;
+      std::cout << prefix << "    raise TypeError(" <<"\"'"<< name
           << "' must have type \'" << GetPrintableType<T>(d)
           << "'!\")" << std::endl;
     }
@@ -141,15 +141,15 @@ void PrintInputProcessing(
 
     if (GetPrintableType<T>(d) == "bool")
     {
-      std::cout << "  else:" << std::endl;
-      std::cout << "    raise TypeError(" <<"\"'"<< name
+      std::cout << prefix << "else:" << std::endl;
+      std::cout << prefix << "  raise TypeError(" <<"\"'"<< name
           << "' must have type \'" << GetPrintableType<T>(d)
           << "'!\")" << std::endl;
     }
     else
     {
-      std::cout << "    else:" << std::endl;
-      std::cout << "      raise TypeError(" <<"\"'"<< name
+      std::cout << prefix << "  else:" << std::endl;
+      std::cout << prefix << "    raise TypeError(" <<"\"'"<< name
           << "' must have type \'" << GetPrintableType<T>(d)
           << "'!\")" << std::endl;
     }
@@ -75,7 +75,7 @@ void PrintPYX(const ProgramDoc& programInfo,
   // Now import all the necessary packages.
   cout << "cimport arma" << endl;
   cout << "cimport arma_numpy" << endl;
-  cout << "from cli cimport CLI" << endl;
+  cout << "from cli cimport CLI, CLIContext" << endl;
   cout << "from cli cimport SetParam, SetParamPtr, SetParamWithInfo, "
       << "GetParamPtr" << endl;
   cout << "from cli cimport EnableVerbose, DisableVerbose, DisableBacktrace, "
@@ -177,24 +177,29 @@ void PrintPYX(const ProgramDoc& programInfo,
       << "returned." << endl;
   cout << "  \"\"\"" << endl;
 
+  // Hold the parameters of this call in a context of its own, so that
+  // other threads can call mlpack functions at the same time.
+  cout << "  cdef CLIContext* context = new CLIContext()" << endl;
+  cout << "  try:" << endl;
+
   // Reset any timers and disable backtraces.
-  cout << "  ResetTimers()" << endl;
-  cout << "  EnableTimers()" << endl;
-  cout << "  DisableBacktrace()" << endl;
-  cout << "  DisableVerbose()" << endl;
+  cout << "    ResetTimers()" << endl;
+  cout << "    EnableTimers()" << endl;
+  cout << "    DisableBacktrace()" << endl;
+  cout << "    DisableVerbose()" << endl;
 
   // Restore the parameters.
-  cout << "  CLI.RestoreSettings(\"" << programInfo.programName << "\")"
+  cout << "    CLI.RestoreSettings(\"" << programInfo.programName << "\")"
       << endl;
 
   // Determine whether or not we need to copy parameters.
-  cout << "  if isinstance(copy_all_inputs, bool):" << endl;
-  cout << "    if copy_all_inputs:" << endl;
-  cout << "      SetParam[cbool](<const string> 'copy_all_inputs', "
+  cout << "    if isinstance(copy_all_inputs, bool):" << endl;
+  cout << "      if copy_all_inputs:" << endl;
+  cout << "        SetParam[cbool](<const string> 'copy_all_inputs', "
       << "copy_all_inputs)" << endl;
-  cout << "      CLI.SetPassed(<const string> 'copy_all_inputs')" << endl;
-  cout << "  else:" << endl;
-  cout << "    raise TypeError(" <<"\"'copy_all_inputs\' must have type "
+  cout << "        CLI.SetPassed(<const string> 'copy_all_inputs')" << endl;
+  cout << "    else:" << endl;
+  cout << "      raise TypeError(" <<"\"'copy_all_inputs\' must have type "
       << "\'bool'!\")" << endl;
   cout << endl;
 
@@ -203,43 +208,46 @@ void PrintPYX(const ProgramDoc& programInfo,
   {
     const util::ParamData& d = parameters.at(inputOptions[i]);
 
-    size_t indent = 2;
+    size_t indent = 4;
     CLI::GetSingleton().functionMap[d.tname]["PrintInputProcessing"](d,
         (void*) &indent, NULL);
   }
 
   // Set all output options as passed.
-  cout << "  # Mark all output options as passed." << endl;
+  cout << "    # Mark all output options as passed." << endl;
   for (size_t i = 0; i < outputOptions.size(); ++i)
   {
     const util::ParamData& d = parameters.at(outputOptions[i]);
-    cout << "  CLI.SetPassed(<const string> '" << d.name << "')" << endl;
+    cout << "    CLI.SetPassed(<const string> '" << d.name << "')" << endl;
   }
 
   // Call the method.
-  cout << "  # Call the mlpack program." << endl;
-  cout << "  mlpackMain()" << endl;
+  cout << "    # Call the mlpack program." << endl;
+  cout << "    with nogil:" << endl;
+  cout << "      mlpackMain()" << endl;
 
   // Do any output processing and return.
-  cout << "  # Initialize result dictionary." << endl;
-  cout << "  result = {}" << endl;
+  cout << "    # Initialize result dictionary." << endl;
+  cout << "    result = {}" << endl;
   cout << endl;
 
   for (size_t i = 0; i < outputOptions.size(); ++i)
   {
     const util::ParamData& d = parameters.at(outputOptions[i]);
 
-    std::tuple<size_t, bool> t = std::make_tuple(2, false);
+    std::tuple<size_t, bool> t = std::make_tuple(4, false);
     CLI::GetSingleton().functionMap[d.tname]["PrintOutputProcessing"](d,
         (void*) &t, NULL);
   }
 
   // Clear the parameters.
   cout << endl;
-  cout << "  CLI.ClearSettings()" << endl;
+  cout << "    CLI.ClearSettings()" << endl;
   cout << endl;
 
-  cout << "  return result" << endl;
+  cout << "    return result" << endl;
+  cout << "  finally:" << endl;
+  cout << "    del context" << endl;
 }
 
 } // namespace python
@@ -0,0 +1,65 @@
+#!/usr/bin/env python
+"""
+kmeans_test.py
+
+Test that seeded calls to the kmeans() binding give the same results when they
+are run from several threads at once.
+
+mlpack is free software; you may redistribute it and/or modify it under the
+terms of the 3-clause BSD license.  You should have received a copy of the
+3-clause BSD license along with mlpack.  If not, see
+http://www.opensource.org/licenses/BSD-3-Clause for more information.
+"""
+import unittest
+import numpy as np
+import copy
+import threading
+
+from mlpack.kmeans import kmeans
+
+class TestKMeansThreads(unittest.TestCase):
+  """
+  This class checks that the random seed and the verbosity of a call are local
+  to the thread that makes it.
+  """
+
+  def run_kmeans(self, x, seed, verbose=False):
+    """
+    Run kmeans() on a copy of x with the given seed.  Few iterations are done,
+    so the result depends on the initial centroids.
+    """
+    return kmeans(input=copy.deepcopy(x),
+                  clusters=10,
+                  max_iterations=2,
+                  seed=seed,
+                  verbose=verbose)
+
+  def testConcurrentSeededCalls(self):
+    """
+    Calls with the same seed should give the results of a call made alone, even
+    while other calls (seeded differently, or verbose) run at the same time.
+    """
+    x = np.random.RandomState(0).rand(500, 3)
+    expected = self.run_kmeans(x, 42)
+
+    results = [None] * 8
+    def run(i):
+      if i % 2 == 0:
+        results[i] = self.run_kmeans(x, 42)
+      else:
+        results[i] = self.run_kmeans(x, 100 + i, verbose=(i == 1))
+
+    threads = [threading.Thread(target=run, args=(i,)) for i in range(8)]
+    for t in threads:
+      t.start()
+    for t in threads:
+      t.join()
+
+    for i in range(0, 8, 2):
+      self.assertTrue(np.array_equal(results[i]['output'],
+                                     expected['output']))
+      self.assertTrue(np.array_equal(results[i]['centroid'],
+                                     expected['centroid']))
+
+if __name__ == '__main__':
+  unittest.main()
@@ -13,6 +13,7 @@ import unittest
 import pandas as pd
 import numpy as np
 import copy
+import threading
 
 from mlpack.test_python_binding import test_python_binding
 
@@ -157,6 +158,34 @@ class TestPythonBinding(unittest.TestCase):
       self.assertEqual(2 * x[j, 2], output['matrix_out'][j, 2])
 
 
+  def testNumpyMatrixView(self):
+    """
+    A C-contiguous view of a larger matrix should be used without copying, and
+    the matrix we get back should not share memory with it.
+    """
+    x = np.random.rand(200, 5)
+    z = copy.deepcopy(x)
+    view = z[50:150]
+    self.assertFalse(view.flags.owndata)
+
+    output = test_python_binding(string_in='hello',
+                                 int_in=12,
+                                 double_in=4.0,
+                                 mat_req_in=[[1.0]],
+                                 col_req_in=[1.0],
+                                 matrix_in=view)
+
+    self.assertEqual(output['matrix_out'].shape[0], 100)
+    self.assertEqual(output['matrix_out'].shape[1], 4)
+    self.assertEqual(output['matrix_out'].dtype, np.double)
+    self.assertFalse(np.shares_memory(output['matrix_out'], z))
+    for i in [0, 1, 3]:
+      for j in range(100):
+        self.assertEqual(x[j + 50, i], output['matrix_out'][j, i])
+
+    for j in range(100):
+      self.assertEqual(2 * x[j + 50, 2], output['matrix_out'][j, 2])
+
   def testNumpyFContiguousMatrix(self):
     """
     The matrix with F_CONTIGUOUS set we pass in, we should get back with the third
@@ -1336,5 +1365,33 @@ class TestPythonBinding(unittest.TestCase):
     self.assertEqual(output2['model_bw_out'], 20.0)
     self.assertEqual(output3['model_bw_out'], 20.0)
 
+  def testConcurrentCalls(self):
+    """
+    Calls from several threads at once should each get their own results.
+    """
+    results = [None] * 8
+    def run(i):
+      x = np.random.rand(100, 5) + i
+      output = test_python_binding(string_in='hello',
+                                   int_in=12,
+                                   double_in=4.0,
+                                   mat_req_in=[[1.0]],
+                                   col_req_in=[1.0],
+                                   matrix_in=copy.deepcopy(x))
+      results[i] = (x, output['matrix_out'])
+
+    threads = [threading.Thread(target=run, args=(i,)) for i in range(8)]
+    for t in threads:
+      t.start()
+    for t in threads:
+      t.join()
+
+    for x, out in results:
+      self.assertEqual(out.shape[0], 100)
+      self.assertEqual(out.shape[1], 4)
+      for j in range(100):
+        self.assertEqual(x[j, 0], out[j, 0])
+        self.assertEqual(2 * x[j, 2], out[j, 2])
+
 if __name__ == '__main__':
   unittest.main()
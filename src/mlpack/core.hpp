@@ -70,19 +70,26 @@
 #include <mlpack/core/util/arma_traits.hpp>
 #include <mlpack/core/util/log.hpp>
 #include <mlpack/core/util/cli.hpp>
+#include <mlpack/core/util/profiler.hpp>
 #include <mlpack/core/util/deprecated.hpp>
 #include <mlpack/core/data/load.hpp>
 #include <mlpack/core/data/save.hpp>
+#include <mlpack/core/data/chunk_loader.hpp>
 #include <mlpack/core/data/normalize_labels.hpp>
 #include <mlpack/core/math/clamp.hpp>
+#include <mlpack/core/math/first_touch.hpp>
+#include <mlpack/core/math/half_precision.hpp>
 #include <mlpack/core/math/random.hpp>
+#include <mlpack/core/math/random_stream.hpp>
 #include <mlpack/core/math/random_basis.hpp>
 #include <mlpack/core/math/lin_alg.hpp>
 #include <mlpack/core/math/range.hpp>
 #include <mlpack/core/math/round.hpp>
 #include <mlpack/core/math/shuffle_data.hpp>
 #include <mlpack/core/math/ccov.hpp>
+#include <mlpack/core/math/running_covariance.hpp>
 #include <mlpack/core/math/make_alias.hpp>
+#include <mlpack/core/math/product.hpp>
 #include <mlpack/core/dists/discrete_distribution.hpp>
 #include <mlpack/core/dists/gaussian_distribution.hpp>
 #include <mlpack/core/dists/laplace_distribution.hpp>
@@ -109,6 +116,7 @@
 #include <mlpack/core/kernels/spherical_kernel.hpp>
 #include <mlpack/core/kernels/triangular_kernel.hpp>
 #include <mlpack/core/kernels/cauchy_kernel.hpp>
+#include <mlpack/core/kernels/kernel_matrix.hpp>
 
 // Use OpenMP if compiled with -DHAS_OPENMP.
 #ifdef HAS_OPENMP
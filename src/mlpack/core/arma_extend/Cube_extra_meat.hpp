@@ -1,7 +1,7 @@
 // Add a serialization operator.
 template<typename eT>
 template<typename Archive>
-void Cube<eT>::serialize(Archive& ar, const unsigned int /* version */)
+void Cube<eT>::serialize(Archive& ar, const unsigned int version)
 {
   using boost::serialization::make_nvp;
   using boost::serialization::make_array;
@@ -34,5 +34,9 @@ void Cube<eT>::serialize(Archive& ar, const unsigned int /* version */)
     init_cold();
   }
 
-  ar & make_array(access::rwp(mem), n_elem);
+  // Since version 1, binary archives hold the elements as one raw block.
+  if (version >= 1 && mlpack::arma_extend::IsBinaryArchive<Archive>::value)
+    mlpack::arma_extend::SerializeRawBlock(ar, access::rwp(mem), n_elem);
+  else
+    ar & make_array(access::rwp(mem), n_elem);
 }
@@ -11,7 +11,7 @@
 // Add a serialization operator.
 template<typename eT>
 template<typename Archive>
-void Mat<eT>::serialize(Archive& ar, const unsigned int /* version */)
+void Mat<eT>::serialize(Archive& ar, const unsigned int version)
 {
   using boost::serialization::make_nvp;
   using boost::serialization::make_array;
@@ -40,5 +40,9 @@ void Mat<eT>::serialize(Archive& ar, const unsigned int /* version */)
     init_cold();
   }
 
-  ar & make_array(access::rwp(mem), n_elem);
+  // Since version 1, binary archives hold the elements as one raw block.
+  if (version >= 1 && mlpack::arma_extend::IsBinaryArchive<Archive>::value)
+    mlpack::arma_extend::SerializeRawBlock(ar, access::rwp(mem), n_elem);
+  else
+    ar & make_array(access::rwp(mem), n_elem);
 }
\ No newline at end of file
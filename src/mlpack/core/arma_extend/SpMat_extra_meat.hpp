@@ -14,7 +14,7 @@
  */
 template<typename eT>
 template<typename Archive>
-void SpMat<eT>::serialize(Archive& ar, const unsigned int /* version */)
+void SpMat<eT>::serialize(Archive& ar, const unsigned int version)
 {
   using boost::serialization::make_nvp;
   using boost::serialization::make_array;
@@ -38,7 +38,18 @@ void SpMat<eT>::serialize(Archive& ar, const unsigned int /* version */)
     // column pointers, if necessary, so we don't need to worry about them.
   }
 
-  ar & make_array(access::rwp(values), n_nonzero);
-  ar & make_array(access::rwp(row_indices), n_nonzero);
-  ar & make_array(access::rwp(col_ptrs), n_cols + 1);
+  // Since version 1, binary archives hold each array as one raw block.
+  if (version >= 1 && mlpack::arma_extend::IsBinaryArchive<Archive>::value)
+  {
+    using mlpack::arma_extend::SerializeRawBlock;
+    SerializeRawBlock(ar, access::rwp(values), n_nonzero);
+    SerializeRawBlock(ar, access::rwp(row_indices), n_nonzero);
+    SerializeRawBlock(ar, access::rwp(col_ptrs), n_cols + 1);
+  }
+  else
+  {
+    ar & make_array(access::rwp(values), n_nonzero);
+    ar & make_array(access::rwp(row_indices), n_nonzero);
+    ar & make_array(access::rwp(col_ptrs), n_cols + 1);
+  }
 }
\ No newline at end of file
@@ -46,7 +46,21 @@
 #include <boost/serialization/serialization.hpp>
 #include <boost/serialization/nvp.hpp>
 #include <boost/serialization/array.hpp>
+#include <boost/serialization/version.hpp>
+#include <mlpack/core/data/serialization_template_version.hpp>
+#include "serialize_raw_block.hpp"
 
 #include <armadillo>
 
+// Version 1 of the Armadillo objects stores their elements as raw blocks in
+// binary archives.  Col and Row use the serialize() function of Mat, but have
+// versions of their own.
+BOOST_TEMPLATE_CLASS_VERSION(template<typename eT>, arma::Mat<eT>, 1);
+BOOST_TEMPLATE_CLASS_VERSION(template<typename eT>, arma::Col<eT>, 1);
+BOOST_TEMPLATE_CLASS_VERSION(template<typename eT>, arma::Row<eT>, 1);
+BOOST_TEMPLATE_CLASS_VERSION(template<typename eT>, arma::Cube<eT>, 1);
+BOOST_TEMPLATE_CLASS_VERSION(template<typename eT>, arma::SpMat<eT>, 1);
+BOOST_TEMPLATE_CLASS_VERSION(template<typename eT>, arma::SpCol<eT>, 1);
+BOOST_TEMPLATE_CLASS_VERSION(template<typename eT>, arma::SpRow<eT>, 1);
+
 #endif
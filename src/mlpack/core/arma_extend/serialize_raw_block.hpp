@@ -0,0 +1,103 @@
+/**
+ * @file core/arma_extend/serialize_raw_block.hpp
+ *
+ * Serialize the elements of an Armadillo object as one raw block of memory in
+ * binary archives.  This is used by the serialize() functions of Mat, Cube,
+ * and SpMat.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_ARMA_EXTEND_SERIALIZE_RAW_BLOCK_HPP
+#define MLPACK_CORE_ARMA_EXTEND_SERIALIZE_RAW_BLOCK_HPP
+
+#include <boost/archive/archive_exception.hpp>
+#include <boost/serialization/binary_object.hpp>
+#include <complex>
+#include <type_traits>
+
+namespace boost {
+namespace archive {
+
+class binary_iarchive;
+class binary_oarchive;
+
+} // namespace archive
+} // namespace boost
+
+namespace mlpack {
+namespace arma_extend {
+
+/**
+ * Whether the given archive is a binary archive.  Elements are written to
+ * binary archives as raw memory, so the element type must be checked on load.
+ */
+template<typename Archive>
+struct IsBinaryArchive
+{
+  static const bool value =
+      std::is_same<Archive, boost::archive::binary_iarchive>::value ||
+      std::is_same<Archive, boost::archive::binary_oarchive>::value;
+};
+
+//! Return the kind of the given element type, as stored in the archive.
+template<typename eT>
+unsigned char RawElemKind()
+{
+  if (std::is_floating_point<eT>::value)
+    return 0;
+  else if (std::is_signed<eT>::value)
+    return 1;
+  else
+    return 2;
+}
+
+//! Complex elements are of their own kind.
+template<>
+inline unsigned char RawElemKind<std::complex<float>>() { return 3; }
+
+//! Complex elements are of their own kind.
+template<>
+inline unsigned char RawElemKind<std::complex<double>>() { return 3; }
+
+/**
+ * Serialize the given number of elements as one raw block of memory, after the
+ * kind and size of their type, so that they are written and read with a single
+ * call.  On load, the memory must already be allocated, and
+ * boost::archive::archive_exception is thrown if the archive holds elements of
+ * a different type.  This is only meant for binary archives, which are not
+ * portable between machines anyway.
+ *
+ * @param ar Archive to serialize with.
+ * @param mem Memory of the elements.
+ * @param nElem Number of elements.
+ */
+template<typename Archive, typename eT>
+void SerializeRawBlock(Archive& ar, eT* mem, const size_t nElem)
+{
+  unsigned char elemKind = RawElemKind<eT>();
+  unsigned char elemSize = (unsigned char) sizeof(eT);
+  ar & boost::serialization::make_nvp("elem_kind", elemKind);
+  ar & boost::serialization::make_nvp("elem_size", elemSize);
+
+  if (Archive::is_loading::value &&
+      (elemKind != RawElemKind<eT>() || elemSize != sizeof(eT)))
+  {
+    throw boost::archive::archive_exception(
+        boost::archive::archive_exception::incompatible_native_format,
+        "element type of Armadillo object does not match");
+  }
+
+  if (nElem > 0)
+  {
+    boost::serialization::binary_object block(mem, nElem * sizeof(eT));
+    ar & boost::serialization::make_nvp("elements", block);
+  }
+}
+
+} // namespace arma_extend
+} // namespace mlpack
+
+#endif
@@ -14,6 +14,7 @@
 
 #include <mlpack/core/cv/meta_info_extractor.hpp>
 #include <mlpack/core/cv/cv_base.hpp>
+#include <mlpack/core/math/random_stream.hpp>
 
 namespace mlpack {
 namespace cv {
@@ -44,6 +45,19 @@ namespace cv {
  * the @c Shuffle() function.  Shuffling is performed at construction time if
  * the parameter @c shuffle is set to @c true in the constructor.
  *
+ * The training subsets are not copied: they are views of a single buffer that
+ * holds the dataset followed by all but its last fold, so the training points
+ * of every fold are contiguous.
+ *
+ * By default the folds are trained and evaluated one after the other.  If
+ * @c Parallel() is set to @c true and OpenMP is available, @c Evaluate() trains
+ * and evaluates them in parallel, each with its own model, so MLAlgorithm must
+ * be safe to train concurrently on different data.  Each fold then draws its
+ * random numbers from its own generators (see math::ThreadRandomScope), seeded
+ * from the seed given to math::RandomSeed(), so the results are reproducible
+ * but differ from those of a serial run.  The output of the models to the logs
+ * may be interleaved.
+ *
  * @tparam MLAlgorithm A machine learning algorithm.
  * @tparam Metric A metric to assess the quality of a trained model.
  * @tparam MatType The type of data.
@@ -180,6 +194,11 @@ class KFoldCV
   //! Access and modify a model from the last run of k-fold cross-validation.
   MLAlgorithm& Model();
 
+  //! Get whether the folds are trained and evaluated in parallel.
+  bool Parallel() const { return parallel; }
+  //! Modify whether the folds are trained and evaluated in parallel.
+  bool& Parallel() { return parallel; }
+
  private:
   //! A short alias for CVBase.
   using Base = CVBase<MLAlgorithm, MatType, PredictionsType, WeightsType>;
@@ -209,6 +228,9 @@ class KFoldCV
   //! The number of bins in the dataset.
   const size_t k;
 
+  //! Whether the folds are trained and evaluated in parallel.
+  bool parallel;
+
   //! The extended (by repeating the first k - 2 bins) data points.
   MatType xs;
   //! The extended (by repeating the first k - 2 bins) predictions.
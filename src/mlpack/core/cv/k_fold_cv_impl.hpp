@@ -12,6 +12,8 @@
 #ifndef MLPACK_CORE_CV_K_FOLD_CV_IMPL_HPP
 #define MLPACK_CORE_CV_K_FOLD_CV_IMPL_HPP
 
+#include <exception>
+
 namespace mlpack {
 namespace cv {
 
@@ -135,7 +137,8 @@ KFoldCV<MLAlgorithm,
                               const PredictionsType& ys,
                               const bool shuffle) :
     base(std::move(base)),
-    k(k)
+    k(k),
+    parallel(false)
 {
   if (k < 2)
     throw std::invalid_argument("KFoldCV: k should not be less than 2");
@@ -166,7 +169,8 @@ KFoldCV<MLAlgorithm,
                               const WeightsType& weights,
                               const bool shuffle) :
     base(std::move(base)),
-    k(k)
+    k(k),
+    parallel(false)
 {
   Base::AssertWeightsConsistency(xs, weights);
 
@@ -245,17 +249,40 @@ double KFoldCV<MLAlgorithm,
                 WeightsType>::TrainAndEvaluate(const MLAlgorithmArgs&... args)
 {
   arma::vec evaluations(k);
+  std::exception_ptr exception;
 
-  for (size_t i = 0; i < k; ++i)
+  // The folds may be trained and evaluated in parallel, each with its own
+  // model.  The training subsets are aliases of the rotated dataset, so nothing
+  // is copied.
+  #pragma omp parallel for schedule(dynamic) if(parallel)
+  for (omp_size_t fold = 0; fold < (omp_size_t) k; ++fold)
   {
-    MLAlgorithm&& model  = base.Train(GetTrainingSubset(xs, i),
-        GetTrainingSubset(ys, i), args...);
-    evaluations(i) = Metric::Evaluate(model, GetValidationSubset(xs, i),
-        GetValidationSubset(ys, i));
-    if (i == k - 1)
-      modelPtr.reset(new MLAlgorithm(std::move(model)));
+    const size_t i = (size_t) fold;
+    try
+    {
+      // In parallel, the folds can't share the global generator.
+      std::unique_ptr<math::ThreadRandomScope> randomScope;
+      if (parallel)
+        randomScope.reset(new math::ThreadRandomScope(i));
+
+      MLAlgorithm&& model  = base.Train(GetTrainingSubset(xs, i),
+          GetTrainingSubset(ys, i), args...);
+      evaluations(i) = Metric::Evaluate(model, GetValidationSubset(xs, i),
+          GetValidationSubset(ys, i));
+      if (i == k - 1)
+        modelPtr.reset(new MLAlgorithm(std::move(model)));
+    }
+    catch (...)
+    {
+      // An exception can't leave the parallel region; rethrow it after.
+      #pragma omp critical
+      exception = std::current_exception();
+    }
   }
 
+  if (exception)
+    std::rethrow_exception(exception);
+
   return arma::mean(evaluations);
 }
 
@@ -272,20 +299,43 @@ double KFoldCV<MLAlgorithm,
                 WeightsType>::TrainAndEvaluate(const MLAlgorithmArgs&... args)
 {
   arma::vec evaluations(k);
+  std::exception_ptr exception;
 
-  for (size_t i = 0; i < k; ++i)
+  // The folds may be trained and evaluated in parallel, each with its own
+  // model.  The training subsets are aliases of the rotated dataset, so nothing
+  // is copied.
+  #pragma omp parallel for schedule(dynamic) if(parallel)
+  for (omp_size_t fold = 0; fold < (omp_size_t) k; ++fold)
   {
-    MLAlgorithm&& model = (weights.n_elem > 0) ?
-        base.Train(GetTrainingSubset(xs, i), GetTrainingSubset(ys, i),
-            GetTrainingSubset(weights, i), args...) :
-        base.Train(GetTrainingSubset(xs, i), GetTrainingSubset(ys, i),
-            args...);
-    evaluations(i) = Metric::Evaluate(model, GetValidationSubset(xs, i),
-        GetValidationSubset(ys, i));
-    if (i == k - 1)
-      modelPtr.reset(new MLAlgorithm(std::move(model)));
+    const size_t i = (size_t) fold;
+    try
+    {
+      // In parallel, the folds can't share the global generator.
+      std::unique_ptr<math::ThreadRandomScope> randomScope;
+      if (parallel)
+        randomScope.reset(new math::ThreadRandomScope(i));
+
+      MLAlgorithm&& model = (weights.n_elem > 0) ?
+          base.Train(GetTrainingSubset(xs, i), GetTrainingSubset(ys, i),
+              GetTrainingSubset(weights, i), args...) :
+          base.Train(GetTrainingSubset(xs, i), GetTrainingSubset(ys, i),
+              args...);
+      evaluations(i) = Metric::Evaluate(model, GetValidationSubset(xs, i),
+          GetValidationSubset(ys, i));
+      if (i == k - 1)
+        modelPtr.reset(new MLAlgorithm(std::move(model)));
+    }
+    catch (...)
+    {
+      // An exception can't leave the parallel region; rethrow it after.
+      #pragma omp critical
+      exception = std::current_exception();
+    }
   }
 
+  if (exception)
+    std::rethrow_exception(exception);
+
   return arma::mean(evaluations);
 }
 
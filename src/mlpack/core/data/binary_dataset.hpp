@@ -0,0 +1,175 @@
+/**
+ * @file core/data/binary_dataset.hpp
+ *
+ * Functions to save and load matrices in the mlpack binary dataset format
+ * (.mlb), and the MappedDataset class, which gives a matrix that refers to a
+ * memory-mapped dataset file.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_BINARY_DATASET_HPP
+#define MLPACK_CORE_DATA_BINARY_DATASET_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <cstdint>
+
+#include "dataset_mapper.hpp"
+
+namespace mlpack {
+namespace data {
+
+/**
+ * The header of a file in the mlpack binary dataset format.  The file starts
+ * with the header, and the elements of the matrix follow at dataOffset (which
+ * is aligned to 64 bytes) in column-major order, that is, in the same layout
+ * as an arma::Mat in memory: one column per point.  If a DatasetMapper was
+ * saved with the matrix, it follows the elements, serialized with a
+ * boost::archive::text_oarchive.  The values are stored in the byte order of
+ * the machine that saved the file, which is checked when loading.
+ */
+struct BinaryDatasetHeader
+{
+  //! The string "MLPACK_DATASET", padded with zeros.
+  char magic[16];
+  //! 0x01020304, to check the byte order.
+  std::uint32_t byteOrder;
+  //! Version of the format.
+  std::uint32_t version;
+  //! Kind of the elements: 0 for floating point, 1 for signed integers, and 2
+  //! for unsigned integers.
+  std::uint64_t elemKind;
+  //! Size of each element in bytes.
+  std::uint64_t elemSize;
+  //! Number of rows (dimensions).
+  std::uint64_t nRows;
+  //! Number of columns (points).
+  std::uint64_t nCols;
+  //! Offset of the elements in the file.
+  std::uint64_t dataOffset;
+  //! Offset of the serialized DatasetMapper in the file (0 if there is none).
+  std::uint64_t infoOffset;
+  //! Size of the serialized DatasetMapper in bytes.
+  std::uint64_t infoSize;
+};
+
+/**
+ * Save the given matrix in the mlpack binary dataset format.  The matrix is
+ * stored as it is in memory, so it is not transposed.  Throws
+ * std::runtime_error on failure.
+ *
+ * @param filename Name of file to save to.
+ * @param matrix Matrix to save.
+ */
+template<typename eT>
+void SaveBinaryDataset(const std::string& filename,
+                       const arma::Mat<eT>& matrix);
+
+/**
+ * Save the given matrix and the dimension types and mappings of the given
+ * DatasetMapper in the mlpack binary dataset format.  Throws
+ * std::invalid_argument if the dimensionality of the DatasetMapper does not
+ * match the number of rows of the matrix, and std::runtime_error on failure.
+ *
+ * @param filename Name of file to save to.
+ * @param matrix Matrix to save.
+ * @param info DatasetMapper to save with the matrix.
+ */
+template<typename eT, typename PolicyType>
+void SaveBinaryDataset(const std::string& filename,
+                       const arma::Mat<eT>& matrix,
+                       const DatasetMapper<PolicyType>& info);
+
+/**
+ * Load a matrix from a file in the mlpack binary dataset format.  The elements
+ * are read directly into the matrix; if they were saved with a different type,
+ * they are converted.  Throws std::runtime_error on failure.
+ *
+ * @param filename Name of file to load.
+ * @param matrix Matrix to load into.
+ */
+template<typename eT>
+void LoadBinaryDataset(const std::string& filename, arma::Mat<eT>& matrix);
+
+/**
+ * Load a matrix and its DatasetMapper from a file in the mlpack binary dataset
+ * format.  If no DatasetMapper was saved with the matrix, every dimension of
+ * the given DatasetMapper is set to numeric.  Throws std::runtime_error on
+ * failure.
+ *
+ * @param filename Name of file to load.
+ * @param matrix Matrix to load into.
+ * @param info DatasetMapper to load into.
+ */
+template<typename eT, typename PolicyType>
+void LoadBinaryDataset(const std::string& filename,
+                       arma::Mat<eT>& matrix,
+                       DatasetMapper<PolicyType>& info);
+
+/**
+ * MappedDataset memory-maps a file in the mlpack binary dataset format, and
+ * gives a matrix that refers to the mapped memory, so the elements are not
+ * copied or read until they are used.  The mapping is private: changes to the
+ * matrix are not written to the file.  The element type of the file must be
+ * eT.
+ *
+ * @code
+ * data::MappedDataset<double> dataset("dataset.mlb");
+ * const arma::mat& data = dataset.Matrix();
+ * @endcode
+ *
+ * The matrix is only valid while the MappedDataset object exists, and it
+ * cannot be resized.
+ *
+ * @tparam eT Type of the elements.
+ * @tparam PolicyType Mapping policy of the DatasetMapper saved with the file.
+ */
+template<typename eT, typename PolicyType = IncrementPolicy>
+class MappedDataset
+{
+ public:
+  /**
+   * Map the given file.  Throws std::runtime_error if the file is not a valid
+   * dataset with elements of type eT, and
+   * boost::interprocess::interprocess_exception if it cannot be mapped.
+   *
+   * @param filename Name of the file to map.
+   */
+  MappedDataset(const std::string& filename);
+
+  //! The matrix refers to the mapping, so the object cannot be copied.
+  MappedDataset(const MappedDataset& other) = delete;
+  //! The matrix refers to the mapping, so the object cannot be copied.
+  MappedDataset& operator=(const MappedDataset& other) = delete;
+
+  //! Get the matrix, which refers to the mapped file.
+  const arma::Mat<eT>& Matrix() const { return matrix; }
+  //! Modify the matrix (the file is not changed).
+  arma::Mat<eT>& Matrix() { return matrix; }
+
+  //! Get the DatasetMapper saved with the file (if there was none, every
+  //! dimension is numeric).
+  const DatasetMapper<PolicyType>& Info() const { return info; }
+
+ private:
+  //! The mapping of the file.
+  boost::interprocess::file_mapping file;
+  //! The mapped region (the whole file).
+  boost::interprocess::mapped_region region;
+  //! The matrix, which refers to the mapped region.
+  arma::Mat<eT> matrix;
+  //! The DatasetMapper saved with the file.
+  DatasetMapper<PolicyType> info;
+};
+
+} // namespace data
+} // namespace mlpack
+
+// Include implementation.
+#include "binary_dataset_impl.hpp"
+
+#endif
@@ -0,0 +1,334 @@
+/**
+ * @file core/data/binary_dataset_impl.hpp
+ *
+ * Implementation of the functions to save and load the mlpack binary dataset
+ * format, and of the MappedDataset class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_BINARY_DATASET_IMPL_HPP
+#define MLPACK_CORE_DATA_BINARY_DATASET_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "binary_dataset.hpp"
+
+#include <mlpack/core/math/make_alias.hpp>
+#include <boost/archive/text_iarchive.hpp>
+#include <boost/archive/text_oarchive.hpp>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+namespace mlpack {
+namespace data {
+
+namespace details {
+
+//! The version of the binary dataset format.
+static const std::uint32_t binaryDatasetVersion = 1;
+//! The offset of the elements in the file.
+static const std::uint64_t binaryDatasetDataOffset = 128;
+
+static_assert(sizeof(BinaryDatasetHeader) <= binaryDatasetDataOffset,
+    "The header of the binary dataset format is too large.");
+
+//! Return the kind of the given element type, as stored in the header.
+template<typename eT>
+std::uint64_t BinaryDatasetElemKind()
+{
+  if (std::is_floating_point<eT>::value)
+    return 0;
+  else if (std::is_signed<eT>::value)
+    return 1;
+  else
+    return 2;
+}
+
+//! Return true if the elements of the file have type eT.
+template<typename eT>
+bool HasElemType(const BinaryDatasetHeader& header)
+{
+  return header.elemKind == BinaryDatasetElemKind<eT>() &&
+      header.elemSize == sizeof(eT);
+}
+
+/**
+ * Check the given header of a file with the given size; throw
+ * std::runtime_error if it is not valid.
+ */
+inline void CheckBinaryDatasetHeader(const BinaryDatasetHeader& header,
+                                     const std::uint64_t fileSize,
+                                     const std::string& filename)
+{
+  if (std::strncmp(header.magic, "MLPACK_DATASET", 16) != 0)
+  {
+    throw std::runtime_error("'" + filename + "' is not an mlpack binary "
+        "dataset!");
+  }
+
+  if (header.byteOrder != 0x01020304)
+  {
+    throw std::runtime_error("'" + filename + "' was saved on a machine "
+        "with a different byte order!");
+  }
+
+  if (header.version > binaryDatasetVersion)
+  {
+    throw std::runtime_error("'" + filename + "' was saved with a newer "
+        "version of mlpack!");
+  }
+
+  const std::uint64_t numElements = header.nRows * header.nCols;
+  if (header.elemSize == 0 || (header.nRows != 0 &&
+      numElements / header.nRows != header.nCols) ||
+      header.dataOffset > fileSize ||
+      numElements > (fileSize - header.dataOffset) / header.elemSize ||
+      header.infoOffset > fileSize ||
+      header.infoSize > fileSize - header.infoOffset)
+  {
+    throw std::runtime_error("'" + filename + "' is truncated or corrupt!");
+  }
+}
+
+//! Read the header of the given stream and check it.
+inline BinaryDatasetHeader ReadBinaryDatasetHeader(std::istream& stream,
+                                                   const std::string& filename)
+{
+  stream.seekg(0, std::ios::end);
+  const std::uint64_t fileSize = (std::uint64_t) stream.tellg();
+  stream.seekg(0, std::ios::beg);
+
+  BinaryDatasetHeader header;
+  if (fileSize < sizeof(BinaryDatasetHeader) ||
+      !stream.read((char*) &header, sizeof(BinaryDatasetHeader)))
+  {
+    throw std::runtime_error("'" + filename + "' is not an mlpack binary "
+        "dataset!");
+  }
+
+  CheckBinaryDatasetHeader(header, fileSize, filename);
+  return header;
+}
+
+//! Read the elements of the given type from the stream and convert them.
+template<typename StoredType, typename eT>
+void ReadConvertedElements(std::istream& stream,
+                           const BinaryDatasetHeader& header,
+                           arma::Mat<eT>& matrix)
+{
+  arma::Mat<StoredType> stored(header.nRows, header.nCols);
+  stream.read((char*) stored.memptr(), stored.n_elem * sizeof(StoredType));
+  matrix = arma::conv_to<arma::Mat<eT>>::from(stored);
+}
+
+//! Read the elements from the stream into the matrix.
+template<typename eT>
+void ReadElements(std::istream& stream,
+                  const BinaryDatasetHeader& header,
+                  arma::Mat<eT>& matrix,
+                  const std::string& filename)
+{
+  stream.seekg(header.dataOffset, std::ios::beg);
+
+  if (HasElemType<eT>(header))
+  {
+    matrix.set_size(header.nRows, header.nCols);
+    stream.read((char*) matrix.memptr(), matrix.n_elem * sizeof(eT));
+  }
+  else if (HasElemType<float>(header))
+    ReadConvertedElements<float>(stream, header, matrix);
+  else if (HasElemType<double>(header))
+    ReadConvertedElements<double>(stream, header, matrix);
+  else if (HasElemType<arma::s32>(header))
+    ReadConvertedElements<arma::s32>(stream, header, matrix);
+  else if (HasElemType<arma::s64>(header))
+    ReadConvertedElements<arma::s64>(stream, header, matrix);
+  else if (HasElemType<arma::u8>(header))
+    ReadConvertedElements<arma::u8>(stream, header, matrix);
+  else if (HasElemType<arma::u32>(header))
+    ReadConvertedElements<arma::u32>(stream, header, matrix);
+  else if (HasElemType<arma::u64>(header))
+    ReadConvertedElements<arma::u64>(stream, header, matrix);
+  else
+  {
+    throw std::runtime_error("'" + filename + "' has an unsupported element "
+        "type!");
+  }
+
+  if (!stream)
+    throw std::runtime_error("Reading from '" + filename + "' failed!");
+}
+
+//! Deserialize the given DatasetMapper from the given bytes.
+template<typename PolicyType>
+void ReadDatasetInfo(const char* bytes,
+                     const size_t size,
+                     DatasetMapper<PolicyType>& info)
+{
+  std::istringstream stream(std::string(bytes, size));
+  boost::archive::text_iarchive ar(stream);
+  ar >> boost::serialization::make_nvp("info", info);
+}
+
+//! Save the matrix and the serialized DatasetMapper (if any).
+template<typename eT>
+void SaveBinaryDataset(const std::string& filename,
+                       const arma::Mat<eT>& matrix,
+                       const std::string& info)
+{
+  std::ofstream stream(filename, std::ios::out | std::ios::binary);
+  if (!stream.is_open())
+  {
+    throw std::runtime_error("Cannot open file '" + filename + "' for "
+        "writing!");
+  }
+
+  BinaryDatasetHeader header;
+  std::memset(&header, 0, sizeof(BinaryDatasetHeader));
+  std::strncpy(header.magic, "MLPACK_DATASET", 16);
+  header.byteOrder = 0x01020304;
+  header.version = binaryDatasetVersion;
+  header.elemKind = BinaryDatasetElemKind<eT>();
+  header.elemSize = sizeof(eT);
+  header.nRows = matrix.n_rows;
+  header.nCols = matrix.n_cols;
+  header.dataOffset = binaryDatasetDataOffset;
+  header.infoOffset = info.empty() ? 0 :
+      binaryDatasetDataOffset + matrix.n_elem * sizeof(eT);
+  header.infoSize = info.size();
+
+  const std::string padding(binaryDatasetDataOffset -
+      sizeof(BinaryDatasetHeader), '\0');
+  stream.write((const char*) &header, sizeof(BinaryDatasetHeader));
+  stream.write(padding.data(), padding.size());
+  stream.write((const char*) matrix.memptr(), matrix.n_elem * sizeof(eT));
+  stream.write(info.data(), info.size());
+
+  if (!stream)
+    throw std::runtime_error("Writing to '" + filename + "' failed!");
+}
+
+} // namespace details
+
+template<typename eT>
+void SaveBinaryDataset(const std::string& filename,
+                       const arma::Mat<eT>& matrix)
+{
+  details::SaveBinaryDataset(filename, matrix, std::string());
+}
+
+template<typename eT, typename PolicyType>
+void SaveBinaryDataset(const std::string& filename,
+                       const arma::Mat<eT>& matrix,
+                       const DatasetMapper<PolicyType>& info)
+{
+  if (info.Dimensionality() != matrix.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "SaveBinaryDataset(): the dimensionality of the DatasetMapper ("
+        << info.Dimensionality() << ") does not match the number of rows of "
+        << "the matrix (" << matrix.n_rows << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  std::ostringstream stream;
+  {
+    boost::archive::text_oarchive ar(stream);
+    ar << boost::serialization::make_nvp("info", info);
+  }
+
+  details::SaveBinaryDataset(filename, matrix, stream.str());
+}
+
+template<typename eT>
+void LoadBinaryDataset(const std::string& filename, arma::Mat<eT>& matrix)
+{
+  std::ifstream stream(filename, std::ios::in | std::ios::binary);
+  if (!stream.is_open())
+    throw std::runtime_error("Cannot open file '" + filename + "'!");
+
+  const BinaryDatasetHeader header =
+      details::ReadBinaryDatasetHeader(stream, filename);
+  details::ReadElements(stream, header, matrix, filename);
+}
+
+template<typename eT, typename PolicyType>
+void LoadBinaryDataset(const std::string& filename,
+                       arma::Mat<eT>& matrix,
+                       DatasetMapper<PolicyType>& info)
+{
+  std::ifstream stream(filename, std::ios::in | std::ios::binary);
+  if (!stream.is_open())
+    throw std::runtime_error("Cannot open file '" + filename + "'!");
+
+  const BinaryDatasetHeader header =
+      details::ReadBinaryDatasetHeader(stream, filename);
+  details::ReadElements(stream, header, matrix, filename);
+
+  if (header.infoSize == 0)
+  {
+    // Every dimension is numeric.
+    info.SetDimensionality(header.nRows);
+    return;
+  }
+
+  std::string bytes(header.infoSize, '\0');
+  stream.seekg(header.infoOffset, std::ios::beg);
+  if (!stream.read(&bytes[0], bytes.size()))
+    throw std::runtime_error("Reading from '" + filename + "' failed!");
+
+  details::ReadDatasetInfo(bytes.data(), bytes.size(), info);
+}
+
+template<typename eT, typename PolicyType>
+MappedDataset<eT, PolicyType>::MappedDataset(const std::string& filename) :
+    file(filename.c_str(), boost::interprocess::read_only),
+    region(file, boost::interprocess::copy_on_write)
+{
+  const char* bytes = static_cast<const char*>(region.get_address());
+
+  BinaryDatasetHeader header;
+  if (region.get_size() < sizeof(BinaryDatasetHeader))
+  {
+    throw std::runtime_error("'" + filename + "' is not an mlpack binary "
+        "dataset!");
+  }
+  std::memcpy(&header, bytes, sizeof(BinaryDatasetHeader));
+  details::CheckBinaryDatasetHeader(header, region.get_size(), filename);
+
+  if (!details::HasElemType<eT>(header))
+  {
+    throw std::runtime_error("MappedDataset::MappedDataset(): the element "
+        "type of '" + filename + "' does not match!");
+  }
+
+  // The mapping starts at a page boundary, so the elements are aligned.
+  if (header.nRows * header.nCols > 0)
+  {
+    eT* elements = reinterpret_cast<eT*>(static_cast<char*>(
+        region.get_address()) + header.dataOffset);
+    math::MakeAlias(matrix, elements, header.nRows, header.nCols);
+  }
+  else
+  {
+    matrix.set_size(header.nRows, header.nCols);
+  }
+
+  if (header.infoSize > 0)
+  {
+    details::ReadDatasetInfo(bytes + header.infoOffset, header.infoSize,
+        info);
+  }
+  else
+  {
+    info.SetDimensionality(header.nRows);
+  }
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
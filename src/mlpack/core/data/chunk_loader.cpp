@@ -0,0 +1,176 @@
+/**
+ * @file core/data/chunk_loader.cpp
+ *
+ * Implementation of the ChunkLoader class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "chunk_loader.hpp"
+#include "load.hpp"
+
+namespace mlpack {
+namespace data {
+
+ChunkLoader::ChunkLoader(const std::vector<std::string>& files,
+                         const size_t responseRows,
+                         const bool shuffle,
+                         const bool transpose) :
+    files(files),
+    responseRows(responseRows),
+    shuffle(shuffle),
+    transpose(transpose),
+    chunkSize(0),
+    position(0)
+{
+  if (files.empty())
+    throw std::invalid_argument("ChunkLoader: no chunk files given.");
+
+  Reset();
+}
+
+ChunkLoader::ChunkLoader(const std::vector<std::string>& imageFiles,
+                         const arma::mat& responses,
+                         const size_t chunkSize,
+                         const ImageInfo& info,
+                         const bool shuffle) :
+    responseRows(responses.n_rows),
+    shuffle(shuffle),
+    transpose(false),
+    imageFiles(imageFiles),
+    imageResponses(responses),
+    chunkSize(chunkSize),
+    imageInfo(info),
+    position(0)
+{
+  if (imageFiles.empty())
+    throw std::invalid_argument("ChunkLoader: no image files given.");
+
+  if (responses.n_cols != imageFiles.size())
+  {
+    std::ostringstream oss;
+    oss << "ChunkLoader: " << imageFiles.size() << " image files given, but "
+        << "the responses have " << responses.n_cols << " columns.";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (chunkSize == 0)
+    throw std::invalid_argument("ChunkLoader: chunkSize must be positive.");
+
+  if (info.Width() == 0 || info.Height() == 0)
+  {
+    throw std::invalid_argument("ChunkLoader: the width and the height of the "
+        "images must be given.");
+  }
+
+  Reset();
+}
+
+bool ChunkLoader::Next(arma::mat& predictors, arma::mat& responses)
+{
+  if (position >= NumChunks())
+  {
+    Reset();
+    return false;
+  }
+
+  // This waits until the chunk is loaded, and rethrows any error.
+  arma::mat chunk = next.get();
+  ++position;
+  Prefetch();
+
+  // Unlabeled chunks (for instance for density estimation) have no responses.
+  if (responseRows == 0)
+  {
+    responses.set_size(0, chunk.n_cols);
+  }
+  else
+  {
+    responses = chunk.rows(chunk.n_rows - responseRows, chunk.n_rows - 1);
+    chunk.shed_rows(chunk.n_rows - responseRows, chunk.n_rows - 1);
+  }
+  predictors = std::move(chunk);
+
+  return true;
+}
+
+void ChunkLoader::Reset()
+{
+  // Wait for the chunk that is being loaded, if any, and ignore it.
+  if (next.valid())
+    next.wait();
+
+  if (shuffle)
+    order = arma::randperm<arma::uvec>(NumChunks());
+  else
+    order = arma::linspace<arma::uvec>(0, NumChunks() - 1, NumChunks());
+
+  position = 0;
+  Prefetch();
+}
+
+void ChunkLoader::Prefetch()
+{
+  if (position >= NumChunks())
+    return;
+
+  if (imageFiles.empty())
+  {
+    next = std::async(std::launch::async, &ChunkLoader::LoadChunk,
+        files[order[position]], responseRows, transpose);
+  }
+  else
+  {
+    const size_t begin = order[position] * chunkSize;
+    const size_t end = std::min(begin + chunkSize, imageFiles.size());
+    next = std::async(std::launch::async, &ChunkLoader::LoadImageChunk,
+        std::vector<std::string>(imageFiles.begin() + begin,
+            imageFiles.begin() + end),
+        arma::mat(imageResponses.cols(begin, end - 1)), imageInfo);
+  }
+}
+
+arma::mat ChunkLoader::LoadChunk(const std::string& filename,
+                                 const size_t responseRows,
+                                 const bool transpose)
+{
+  arma::mat chunk;
+  if (!chunk.load(filename))
+  {
+    throw std::runtime_error("ChunkLoader: cannot load chunk '" + filename +
+        "'.");
+  }
+
+  if (transpose)
+    arma::inplace_trans(chunk);
+
+  if (chunk.n_rows <= responseRows)
+  {
+    std::ostringstream oss;
+    oss << "ChunkLoader: chunk '" << filename << "' has " << chunk.n_rows
+        << " rows, but " << responseRows << " response rows are needed in "
+        << "addition to the predictors.";
+    throw std::runtime_error(oss.str());
+  }
+
+  return chunk;
+}
+
+arma::mat ChunkLoader::LoadImageChunk(
+    const std::vector<std::string>& imageFiles,
+    const arma::mat& responses,
+    ImageInfo info)
+{
+  // The images are decoded in parallel; any error is thrown, and rethrown by
+  // Next().
+  arma::mat chunk;
+  Load(imageFiles, chunk, info, info.Width(), info.Height(), true);
+  chunk.insert_rows(chunk.n_rows, responses);
+
+  return chunk;
+}
+
+} // namespace data
+} // namespace mlpack
@@ -0,0 +1,188 @@
+/**
+ * @file core/data/chunk_loader.hpp
+ *
+ * Definition of the ChunkLoader class, which streams a dataset that is split
+ * into several files (or a dataset of images), loading the next chunk in the
+ * background.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_CHUNK_LOADER_HPP
+#define MLPACK_CORE_DATA_CHUNK_LOADER_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <future>
+
+#include "image_info.hpp"
+
+namespace mlpack {
+namespace data {
+
+/**
+ * ChunkLoader gives access to a dataset that is too large to be held in
+ * memory at once, because it is stored in several files (chunks).  Each chunk
+ * is a matrix that can be loaded by Armadillo (for instance one saved with
+ * data::Save() in the arma_binary format), where the last rows of each point
+ * are its responses.  A dataset of images can also be streamed: then each chunk
+ * holds a fixed number of the images, decoded in parallel and resized to the
+ * same size, with their responses.
+ *
+ * Next() returns the chunks one after the other; while the caller works on one
+ * chunk, the next one is already loaded on a separate thread.  When all chunks
+ * of an epoch have been returned, Next() returns false once and starts the
+ * next epoch.  If shuffling is enabled, the chunks are visited in a different
+ * random order in each epoch; the points inside a chunk can be shuffled by the
+ * optimizer (see FFN::Train()).
+ *
+ * @code
+ * data::ChunkLoader loader(files, 1);
+ * arma::mat predictors, responses;
+ * while (loader.Next(predictors, responses))
+ * {
+ *   // Use the chunk.
+ * }
+ * @endcode
+ */
+class ChunkLoader
+{
+ public:
+  /**
+   * Create the ChunkLoader object for the given files, and start loading the
+   * first chunk.  At least one file must be given.
+   *
+   * @param files Names of the files that hold the chunks.
+   * @param responseRows Number of rows at the end of each point that hold its
+   *     responses (this may be 0 for unlabeled data).
+   * @param shuffle Whether to visit the chunks in random order.
+   * @param transpose Whether the chunks are stored with one point per row, as
+   *     data::Save() does by default, and have to be transposed.
+   */
+  ChunkLoader(const std::vector<std::string>& files,
+              const size_t responseRows,
+              const bool shuffle = true,
+              const bool transpose = true);
+
+  /**
+   * Create the ChunkLoader object for a dataset of images, and start loading
+   * the first chunk.  Each chunk holds chunkSize consecutive images (the last
+   * chunk may hold fewer), one per column, resized to the width and the height
+   * given by info, followed by their responses.  At least one image must be
+   * given.
+   *
+   * @param imageFiles Names of the image files.
+   * @param responses Responses of the images, one column per image (this may
+   *     have no rows, for unlabeled data).
+   * @param chunkSize Number of images in each chunk.
+   * @param info Width, height, and number of channels of the images.
+   * @param shuffle Whether to visit the chunks in random order.
+   */
+  ChunkLoader(const std::vector<std::string>& imageFiles,
+              const arma::mat& responses,
+              const size_t chunkSize,
+              const ImageInfo& info,
+              const bool shuffle = true);
+
+  /**
+   * Get the next chunk of the current epoch.  If all chunks of the epoch have
+   * been returned, nothing is changed, the next epoch is started, and false is
+   * returned.  A std::runtime_error is thrown if a chunk cannot be loaded.
+   *
+   * @param predictors Matrix to store the predictors of the chunk into.
+   * @param responses Matrix to store the responses of the chunk into.
+   * @return false at the end of an epoch, true otherwise.
+   */
+  bool Next(arma::mat& predictors, arma::mat& responses);
+
+  /**
+   * Start a new epoch at the first chunk, with a new random order of the
+   * chunks if shuffling is enabled.  Any chunk that is being loaded is
+   * discarded.
+   */
+  void Reset();
+
+  //! Get the number of chunks.
+  size_t NumChunks() const
+  {
+    return imageFiles.empty() ? files.size() :
+        (imageFiles.size() + chunkSize - 1) / chunkSize;
+  }
+
+  //! Get the number of rows that hold the responses.
+  size_t ResponseRows() const { return responseRows; }
+
+  //! Get whether the chunks are visited in random order.
+  bool Shuffle() const { return shuffle; }
+  //! Modify whether the chunks are visited in random order (this takes effect
+  //! at the next epoch).
+  bool& Shuffle() { return shuffle; }
+
+ private:
+  //! Start loading the chunk at the current position, if there is one.
+  void Prefetch();
+
+  /**
+   * Load the given chunk; this is run on the prefetch thread, so it does not
+   * use any member.
+   *
+   * @param filename Name of the file to load.
+   * @param responseRows Number of rows that hold the responses.
+   * @param transpose Whether the matrix has to be transposed.
+   */
+  static arma::mat LoadChunk(const std::string& filename,
+                             const size_t responseRows,
+                             const bool transpose);
+
+  /**
+   * Load the given images and append their responses; this is run on the
+   * prefetch thread, so it does not use any member.
+   *
+   * @param imageFiles Names of the image files of the chunk.
+   * @param responses Responses of the images.
+   * @param info Size of the images.
+   */
+  static arma::mat LoadImageChunk(const std::vector<std::string>& imageFiles,
+                                  const arma::mat& responses,
+                                  ImageInfo info);
+
+  //! The names of the files of the chunks.
+  std::vector<std::string> files;
+
+  //! The number of rows that hold the responses.
+  size_t responseRows;
+
+  //! Whether the chunks are visited in random order.
+  bool shuffle;
+
+  //! Whether the chunks have to be transposed after loading.
+  bool transpose;
+
+  //! The names of the image files, for a dataset of images.
+  std::vector<std::string> imageFiles;
+
+  //! The responses of the images.
+  arma::mat imageResponses;
+
+  //! The number of images in each chunk.
+  size_t chunkSize;
+
+  //! The size of the images.
+  ImageInfo imageInfo;
+
+  //! The order of the chunks in the current epoch.
+  arma::uvec order;
+
+  //! The position of the next chunk in the order.
+  size_t position;
+
+  //! The chunk that is being loaded.
+  std::future<arma::mat> next;
+};
+
+} // namespace data
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,506 @@
+/**
+ * @file core/data/compressed_stream.cpp
+ *
+ * Implementation of the streams that read and write compressed files, with
+ * zlib for gzip and libzstd for zstd.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "compressed_stream.hpp"
+
+#include <mlpack/core/util/log.hpp>
+
+#include <cstdio>
+#include <vector>
+
+#ifdef HAS_ZLIB
+  #include <zlib.h>
+#endif
+
+#ifdef HAS_ZSTD
+  #include <zstd.h>
+#endif
+
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
+namespace mlpack {
+namespace data {
+
+namespace details {
+
+//! Size of the buffers of the gzip streams.
+static const size_t gzipBufferSize = 1 << 16;
+
+/**
+ * The base class of the buffers that compress into a file.  Close() finishes
+ * the compressed stream and reports whether everything was written.
+ */
+class CompressedOutputBuffer : public std::streambuf
+{
+ public:
+  virtual ~CompressedOutputBuffer() { }
+
+  //! Finish the compressed stream and close the file; return false on
+  //! failure.
+  virtual bool Close() = 0;
+
+ protected:
+  //! Compress the contents of the put area.
+  virtual bool Write() = 0;
+
+  //! Compress the full put area, and then add the given character to it.
+  int_type overflow(int_type c)
+  {
+    if (!Write())
+      return traits_type::eof();
+
+    if (!traits_type::eq_int_type(c, traits_type::eof()))
+    {
+      *pptr() = traits_type::to_char_type(c);
+      pbump(1);
+    }
+
+    return traits_type::not_eof(c);
+  }
+
+  //! Pass the put area to the compressor.  The compressor is not flushed,
+  //! since that would make the compression worse.
+  int sync() { return Write() ? 0 : -1; }
+};
+
+#ifdef HAS_ZLIB
+
+//! A buffer that decompresses a gzip file with zlib.
+class GzipInputBuffer : public std::streambuf
+{
+ public:
+  GzipInputBuffer(gzFile file) : file(file), buffer(gzipBufferSize) { }
+
+  ~GzipInputBuffer() { gzclose(file); }
+
+ protected:
+  int_type underflow()
+  {
+    if (gptr() < egptr())
+      return traits_type::to_int_type(*gptr());
+
+    // At the end of a truncated file, gzread() returns 0 and the error is
+    // Z_BUF_ERROR.
+    const int size = gzread(file, buffer.data(), (unsigned) buffer.size());
+    int error = Z_OK;
+    const char* message = gzerror(file, &error);
+    if (size < 0 || (size == 0 && error != Z_OK))
+    {
+      throw std::runtime_error(std::string("gzip decompression failed: ") +
+          message);
+    }
+    else if (size == 0)
+    {
+      return traits_type::eof();
+    }
+
+    setg(buffer.data(), buffer.data(), buffer.data() + size);
+    return traits_type::to_int_type(*gptr());
+  }
+
+ private:
+  //! The file.
+  gzFile file;
+  //! The decompressed data.
+  std::vector<char> buffer;
+};
+
+//! A buffer that compresses into a gzip file with zlib.
+class GzipOutputBuffer : public CompressedOutputBuffer
+{
+ public:
+  GzipOutputBuffer(gzFile file) : file(file), buffer(gzipBufferSize)
+  {
+    setp(buffer.data(), buffer.data() + buffer.size());
+  }
+
+  ~GzipOutputBuffer() { Close(); }
+
+  bool Close()
+  {
+    if (file == NULL)
+      return true;
+
+    const bool success = Write();
+    const bool closed = (gzclose(file) == Z_OK);
+    file = NULL;
+    return success && closed;
+  }
+
+ protected:
+  bool Write()
+  {
+    const int size = (int) (pptr() - pbase());
+    if (size > 0 && gzwrite(file, pbase(), (unsigned) size) != size)
+      return false;
+
+    setp(buffer.data(), buffer.data() + buffer.size());
+    return true;
+  }
+
+ private:
+  //! The file.
+  gzFile file;
+  //! The data to compress.
+  std::vector<char> buffer;
+};
+
+#endif // HAS_ZLIB.
+
+#ifdef HAS_ZSTD
+
+//! A buffer that decompresses a zstd file with libzstd.
+class ZstdInputBuffer : public std::streambuf
+{
+ public:
+  ZstdInputBuffer(FILE* file) :
+      file(file),
+      context(ZSTD_createDCtx()),
+      inputBuffer(ZSTD_DStreamInSize()),
+      outputBuffer(ZSTD_DStreamOutSize()),
+      pending(false),
+      lastResult(0)
+  {
+    input.src = inputBuffer.data();
+    input.size = 0;
+    input.pos = 0;
+  }
+
+  ~ZstdInputBuffer()
+  {
+    ZSTD_freeDCtx(context);
+    fclose(file);
+  }
+
+ protected:
+  int_type underflow()
+  {
+    if (gptr() < egptr())
+      return traits_type::to_int_type(*gptr());
+
+    ZSTD_outBuffer output = { outputBuffer.data(), outputBuffer.size(), 0 };
+    while (output.pos == 0)
+    {
+      // If the last call filled the output, the decompressor may hold more
+      // output, even if all of the input was used.
+      if (input.pos == input.size && !pending)
+      {
+        input.size = fread(inputBuffer.data(), 1, inputBuffer.size(), file);
+        input.pos = 0;
+        if (input.size == 0)
+        {
+          // A nonzero result means that the last frame is not finished.
+          if (ferror(file) || lastResult != 0)
+            throw std::runtime_error("zstd decompression failed: the file is "
+                "truncated");
+
+          return traits_type::eof();
+        }
+      }
+
+      lastResult = ZSTD_decompressStream(context, &output, &input);
+      if (ZSTD_isError(lastResult))
+      {
+        throw std::runtime_error(std::string("zstd decompression failed: ") +
+            ZSTD_getErrorName(lastResult));
+      }
+      pending = (output.pos == output.size);
+    }
+
+    setg(outputBuffer.data(), outputBuffer.data(),
+        outputBuffer.data() + output.pos);
+    return traits_type::to_int_type(*gptr());
+  }
+
+ private:
+  //! The file.
+  FILE* file;
+  //! The decompression context.
+  ZSTD_DCtx* context;
+  //! The compressed data read from the file.
+  std::vector<char> inputBuffer;
+  //! The part of inputBuffer that was not decompressed yet.
+  ZSTD_inBuffer input;
+  //! The decompressed data.
+  std::vector<char> outputBuffer;
+  //! Whether the last call to the decompressor filled the output.
+  bool pending;
+  //! The result of the last call to the decompressor.
+  size_t lastResult;
+};
+
+//! A buffer that compresses into a zstd file with libzstd.
+class ZstdOutputBuffer : public CompressedOutputBuffer
+{
+ public:
+  ZstdOutputBuffer(FILE* file) :
+      file(file),
+      context(ZSTD_createCCtx()),
+      inputBuffer(ZSTD_CStreamInSize()),
+      outputBuffer(ZSTD_CStreamOutSize())
+  {
+    ZSTD_CCtx_setParameter(context, ZSTD_c_compressionLevel,
+        ZSTD_CLEVEL_DEFAULT);
+#ifdef HAS_OPENMP
+    // This fails (and the compression uses one thread) if libzstd was built
+    // without multithreading support.
+    ZSTD_CCtx_setParameter(context, ZSTD_c_nbWorkers, omp_get_max_threads());
+#endif
+
+    setp(inputBuffer.data(), inputBuffer.data() + inputBuffer.size());
+  }
+
+  ~ZstdOutputBuffer()
+  {
+    Close();
+    ZSTD_freeCCtx(context);
+  }
+
+  bool Close()
+  {
+    if (file == NULL)
+      return true;
+
+    const bool success = Compress(ZSTD_e_end);
+    const bool closed = (fclose(file) == 0);
+    file = NULL;
+    return success && closed;
+  }
+
+ protected:
+  bool Write() { return Compress(ZSTD_e_continue); }
+
+ private:
+  //! Compress the put area, and finish the frame if mode is ZSTD_e_end.
+  bool Compress(const ZSTD_EndDirective mode)
+  {
+    ZSTD_inBuffer input = { pbase(), (size_t) (pptr() - pbase()), 0 };
+    bool done = false;
+    while (!done)
+    {
+      ZSTD_outBuffer output = { outputBuffer.data(), outputBuffer.size(), 0 };
+      const size_t remaining = ZSTD_compressStream2(context, &output, &input,
+          mode);
+      if (ZSTD_isError(remaining))
+        return false;
+
+      if (fwrite(outputBuffer.data(), 1, output.pos, file) != output.pos)
+        return false;
+
+      done = (mode == ZSTD_e_end) ? (remaining == 0) :
+          (input.pos == input.size);
+    }
+
+    setp(inputBuffer.data(), inputBuffer.data() + inputBuffer.size());
+    return true;
+  }
+
+  //! The file.
+  FILE* file;
+  //! The compression context.
+  ZSTD_CCtx* context;
+  //! The data to compress.
+  std::vector<char> inputBuffer;
+  //! The compressed data.
+  std::vector<char> outputBuffer;
+};
+
+#endif // HAS_ZSTD.
+
+} // namespace details
+
+bool CompressionAvailable(const Compression compression)
+{
+  switch (compression)
+  {
+    case Compression::none:
+      return true;
+    case Compression::gzip:
+#ifdef HAS_ZLIB
+      return true;
+#else
+      return false;
+#endif
+    case Compression::zstd:
+#ifdef HAS_ZSTD
+      return true;
+#else
+      return false;
+#endif
+  }
+
+  return false;
+}
+
+bool CheckCompression(const std::string& filename,
+                      const Compression compression,
+                      const bool streamFormat,
+                      const bool fatal)
+{
+  if (compression == Compression::none)
+    return true;
+
+  const std::string name = (compression == Compression::gzip) ? "gzip" :
+      "zstd";
+  if (!CompressionAvailable(compression))
+  {
+    if (fatal)
+      Log::Fatal << "'" << filename << "' is compressed with " << name
+          << ", but mlpack was compiled without " << name << " support."
+          << std::endl;
+    else
+      Log::Warn << "'" << filename << "' is compressed with " << name
+          << ", but mlpack was compiled without " << name << " support."
+          << std::endl;
+
+    return false;
+  }
+
+  if (!streamFormat)
+  {
+    if (fatal)
+      Log::Fatal << "The format of '" << filename << "' cannot be compressed "
+          << "with " << name << "." << std::endl;
+    else
+      Log::Warn << "The format of '" << filename << "' cannot be compressed "
+          << "with " << name << "." << std::endl;
+
+    return false;
+  }
+
+  return true;
+}
+
+CompressedInputStream::CompressedInputStream(const std::string& filename,
+                                             const Compression compression,
+                                             const std::ios::openmode mode) :
+    std::istream(NULL),
+    open(false)
+{
+  if (compression == Compression::none)
+  {
+    open = (fileBuffer.open(filename, mode | std::ios::in) != NULL);
+    rdbuf(&fileBuffer);
+  }
+#ifdef HAS_ZLIB
+  else if (compression == Compression::gzip)
+  {
+    gzFile file = gzopen(filename.c_str(), "rb");
+    if (file != NULL)
+    {
+      compressedBuffer.reset(new details::GzipInputBuffer(file));
+      open = true;
+    }
+  }
+#endif
+#ifdef HAS_ZSTD
+  else if (compression == Compression::zstd)
+  {
+    FILE* file = fopen(filename.c_str(), "rb");
+    if (file != NULL)
+    {
+      compressedBuffer.reset(new details::ZstdInputBuffer(file));
+      open = true;
+    }
+  }
+#endif
+
+  if (compressedBuffer)
+    rdbuf(compressedBuffer.get());
+  if (!open)
+    setstate(std::ios::failbit);
+}
+
+CompressedInputStream::~CompressedInputStream()
+{
+  // The buffers close the files when they are destroyed.
+}
+
+CompressedOutputStream::CompressedOutputStream(const std::string& filename,
+                                               const Compression compression,
+                                               const std::ios::openmode mode) :
+    std::ostream(NULL),
+    open(false)
+{
+  if (compression == Compression::none)
+  {
+    open = (fileBuffer.open(filename, mode | std::ios::out) != NULL);
+    rdbuf(&fileBuffer);
+  }
+#ifdef HAS_ZLIB
+  else if (compression == Compression::gzip)
+  {
+    gzFile file = gzopen(filename.c_str(), "wb");
+    if (file != NULL)
+    {
+      compressedBuffer.reset(new details::GzipOutputBuffer(file));
+      open = true;
+    }
+  }
+#endif
+#ifdef HAS_ZSTD
+  else if (compression == Compression::zstd)
+  {
+    FILE* file = fopen(filename.c_str(), "wb");
+    if (file != NULL)
+    {
+      compressedBuffer.reset(new details::ZstdOutputBuffer(file));
+      open = true;
+    }
+  }
+#endif
+
+  if (compressedBuffer)
+    rdbuf(compressedBuffer.get());
+  if (!open)
+    setstate(std::ios::failbit);
+}
+
+CompressedOutputStream::~CompressedOutputStream()
+{
+  close();
+}
+
+void CompressedOutputStream::close()
+{
+  if (!open)
+    return;
+
+  bool success;
+  if (compressedBuffer)
+    success = compressedBuffer->Close();
+  else
+    success = (fileBuffer.close() != NULL);
+
+  open = false;
+  if (!success)
+    setstate(std::ios::failbit);
+}
+
+bool DecompressFile(const std::string& filename,
+                    const Compression compression,
+                    std::ostream& stream)
+{
+  CompressedInputStream input(filename, compression, std::ios::binary);
+  if (!input.is_open())
+    return false;
+
+  std::vector<char> buffer(1 << 16);
+  while (input.read(buffer.data(), buffer.size()) || input.gcount() > 0)
+    stream.write(buffer.data(), input.gcount());
+
+  return !input.bad() && (bool) stream;
+}
+
+} // namespace data
+} // namespace mlpack
@@ -0,0 +1,198 @@
+/**
+ * @file core/data/compressed_stream.hpp
+ *
+ * Streams that read and write files compressed with gzip or zstd, so that
+ * data::Load() and data::Save() can handle compressed files transparently.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_COMPRESSED_STREAM_HPP
+#define MLPACK_CORE_DATA_COMPRESSED_STREAM_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <fstream>
+#include <memory>
+
+#include "extension.hpp"
+
+namespace mlpack {
+namespace data {
+
+/**
+ * The compression of a file.
+ */
+enum class Compression
+{
+  none,
+  gzip,
+  zstd
+};
+
+/**
+ * Return the compression of the given file, detected by its extension: .gz
+ * for gzip and .zst for zstd.
+ *
+ * @param filename Name of the file.
+ */
+inline Compression FileCompression(const std::string& filename)
+{
+  const std::string extension = Extension(filename);
+  if (extension == "gz")
+    return Compression::gzip;
+  else if (extension == "zst")
+    return Compression::zstd;
+  else
+    return Compression::none;
+}
+
+/**
+ * Return the given filename without the extension of its compression, if it
+ * has one; so the type of "dataset.csv.gz" is given by the extension of
+ * "dataset.csv".
+ *
+ * @param filename Name of the file.
+ */
+inline std::string UncompressedName(const std::string& filename)
+{
+  if (FileCompression(filename) == Compression::none)
+    return filename;
+  else
+    return filename.substr(0, filename.rfind('.'));
+}
+
+/**
+ * Return true if mlpack was compiled with support for the given compression
+ * (zlib for gzip and libzstd for zstd).
+ *
+ * @param compression The compression.
+ */
+bool CompressionAvailable(const Compression compression);
+
+/**
+ * Return true if the given file can be read or written with its compression;
+ * otherwise, report an error (with Log::Fatal if fatal is true, and with
+ * Log::Warn otherwise) and return false.  A compressed file needs mlpack to be
+ * compiled with support for its compression, and a format that is read or
+ * written as a stream.
+ *
+ * @param filename Name of the file.
+ * @param compression Compression of the file.
+ * @param streamFormat Whether the format of the file is read or written as a
+ *     stream.
+ * @param fatal If an error should be reported as fatal.
+ */
+bool CheckCompression(const std::string& filename,
+                      const Compression compression,
+                      const bool streamFormat,
+                      const bool fatal);
+
+namespace details {
+
+// Defined in compressed_stream.cpp.
+class CompressedOutputBuffer;
+
+} // namespace details
+
+/**
+ * An input stream that decompresses the given file while it is read.  If the
+ * compression is Compression::none, this is the same as a std::ifstream.
+ * Decompression errors (such as a truncated file) set the badbit of the
+ * stream.  The stream cannot seek.
+ */
+class CompressedInputStream : public std::istream
+{
+ public:
+  /**
+   * Open the given file.  If it cannot be opened, or if mlpack was compiled
+   * without support for the compression, is_open() returns false.
+   *
+   * @param filename Name of the file to read.
+   * @param compression Compression of the file.
+   * @param mode Mode to open an uncompressed file with (compressed files are
+   *     always read in binary mode).
+   */
+  CompressedInputStream(const std::string& filename,
+                        const Compression compression,
+                        const std::ios::openmode mode = std::ios::in);
+
+  //! Close the file.
+  ~CompressedInputStream();
+
+  //! Return true if the file was opened.
+  bool is_open() const { return open; }
+
+ private:
+  //! The buffer of an uncompressed file.
+  std::filebuf fileBuffer;
+  //! The buffer that decompresses a compressed file.
+  std::unique_ptr<std::streambuf> compressedBuffer;
+  //! Whether the file was opened.
+  bool open;
+};
+
+/**
+ * An output stream that compresses what is written to it into the given file.
+ * If the compression is Compression::none, this is the same as a
+ * std::ofstream.  When mlpack is compiled with OpenMP, zstd compresses with as
+ * many threads as OpenMP uses (if libzstd supports multithreading).  What is
+ * written is compressed as a single stream, so flushing the stream does not
+ * make the compression worse; the compressed stream is finished when close()
+ * is called or the object is destroyed.
+ */
+class CompressedOutputStream : public std::ostream
+{
+ public:
+  /**
+   * Open the given file.  If it cannot be opened, or if mlpack was compiled
+   * without support for the compression, is_open() returns false.
+   *
+   * @param filename Name of the file to write.
+   * @param compression Compression of the file.
+   * @param mode Mode to open an uncompressed file with (compressed files are
+   *     always written in binary mode).
+   */
+  CompressedOutputStream(const std::string& filename,
+                         const Compression compression,
+                         const std::ios::openmode mode = std::ios::out);
+
+  //! Finish the compressed stream (if it is open) and close the file.
+  ~CompressedOutputStream();
+
+  //! Return true if the file is open.
+  bool is_open() const { return open; }
+
+  /**
+   * Finish the compressed stream and close the file.  The failbit of the
+   * stream is set if this fails.
+   */
+  void close();
+
+ private:
+  //! The buffer of an uncompressed file.
+  std::filebuf fileBuffer;
+  //! The buffer that compresses into a compressed file.
+  std::unique_ptr<details::CompressedOutputBuffer> compressedBuffer;
+  //! Whether the file is open.
+  bool open;
+};
+
+/**
+ * Decompress the whole given file into the given stream, for the formats that
+ * have to seek while they are read.  Return false if the file cannot be opened
+ * or decompressed.
+ *
+ * @param filename Name of the file to read.
+ * @param compression Compression of the file.
+ * @param stream Stream to write the decompressed contents to.
+ */
+bool DecompressFile(const std::string& filename,
+                    const Compression compression,
+                    std::ostream& stream);
+
+} // namespace data
+} // namespace mlpack
+
+#endif
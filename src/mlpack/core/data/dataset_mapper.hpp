@@ -147,6 +147,17 @@ class DatasetMapper
    */
   size_t Dimensionality() const;
 
+  /**
+   * Replace the type and the mappings of the given dimension with the ones of
+   * the other DatasetMapper, which are removed from it.  This can be used to
+   * merge the mappings of DatasetMapper objects that each mapped different
+   * dimensions (for instance, in parallel).
+   *
+   * @param other DatasetMapper to take the dimension from.
+   * @param dimension Dimension to take.
+   */
+  void TakeDimension(DatasetMapper& other, const size_t dimension);
+
   /**
    * Serialize the dataset information.
    */
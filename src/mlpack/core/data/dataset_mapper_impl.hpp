@@ -230,6 +230,25 @@ inline size_t DatasetMapper<PolicyType, InputType>::Dimensionality() const
   return types.size();
 }
 
+template<typename PolicyType, typename InputType>
+inline void DatasetMapper<PolicyType, InputType>::TakeDimension(
+    DatasetMapper& other,
+    const size_t dimension)
+{
+  Type(dimension) = other.Type(dimension);
+
+  typename MapType::iterator it = other.maps.find(dimension);
+  if (it == other.maps.end())
+  {
+    maps.erase(dimension);
+  }
+  else
+  {
+    maps[dimension] = std::move(it->second);
+    other.maps.erase(it);
+  }
+}
+
 template<typename PolicyType, typename InputType>
 inline const PolicyType& DatasetMapper<PolicyType, InputType>::Policy() const
 {
@@ -0,0 +1,190 @@
+/**
+ * @file core/data/hashing_dictionary.hpp
+ *
+ * Definition of the HashingDictionary class, which maps tokens to labels with
+ * the hashing trick instead of storing them.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_HASHING_DICTIONARY_HPP
+#define MLPACK_CORE_DATA_HASHING_DICTIONARY_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/boost_backport/boost_backport_string_view.hpp>
+#include <cstdint>
+
+namespace mlpack {
+namespace data {
+
+/**
+ * This class provides the dictionary interface of StringEncoding, but it does
+ * not store any tokens: the label of a token is its hash modulo the number of
+ * features, plus one (labels start from one, as in StringEncodingDictionary).
+ * This is known as the hashing trick (or feature hashing); see the following
+ * paper:
+ *
+ * @code
+ * @inproceedings{weinberger2009feature,
+ *   title={Feature Hashing for Large Scale Multitask Learning},
+ *   author={Weinberger, Kilian and Dasgupta, Anirban and Langford, John and
+ *       Smola, Alex and Attenberg, Josh},
+ *   booktitle={Proceedings of the 26th Annual International Conference on
+ *       Machine Learning},
+ *   pages={1113--1120},
+ *   year={2009}
+ * }
+ * @endcode
+ *
+ * So the memory used by the dictionary does not depend on the number of
+ * distinct tokens, and since the labels do not depend on the tokens seen
+ * before, a corpus may be encoded in chunks, each of which gives the same
+ * features as if the whole corpus were encoded at once (with
+ * BagOfWordsEncodingPolicy).  Any encoding policy can be used; for instance,
+ *
+ * @code
+ * HashingBagOfWordsEncoding<boost::string_view> encoder;
+ * encoder.Dictionary() = HashingDictionary<boost::string_view>(1 << 18);
+ * arma::sp_mat output;
+ * encoder.Encode(input, output, SplitByAnyOf(" .,"));
+ * @endcode
+ *
+ * gives a sparse matrix with 2^18 rows.  Different tokens may have the same
+ * label; the probability of that decreases with the number of features.  The
+ * hash function is FNV-1a, so the labels are the same on every platform.
+ *
+ * @tparam Token Type of the tokens.
+ */
+template<typename Token>
+class HashingDictionary
+{
+ public:
+  //! The type of the token that the dictionary maps.
+  using TokenType = Token;
+
+  /**
+   * Create the dictionary.
+   *
+   * @param numFeatures Number of distinct labels (the size of the
+   *     dictionary).
+   * @param seed Seed of the hash function; different seeds give different
+   *     collisions.
+   */
+  HashingDictionary(const size_t numFeatures = 1 << 20,
+                    const size_t seed = 0) :
+      numFeatures(numFeatures),
+      seed(seed)
+  {
+    if (numFeatures == 0)
+    {
+      throw std::invalid_argument("HashingDictionary::HashingDictionary(): "
+          "the number of features must be positive!");
+    }
+  }
+
+  /**
+   * The function returns true, since every token has a label.
+   *
+   * @param * (token) The given token.
+   */
+  bool HasToken(const Token& /* token */) const { return true; }
+
+  /**
+   * Nothing is stored, so the function only returns the label of the given
+   * token.
+   *
+   * @param token The given token.
+   */
+  template<typename T>
+  size_t AddToken(T&& token)
+  {
+    return Value(token);
+  }
+
+  /**
+   * The function returns the label of the given token, which belongs to
+   * [1, numFeatures].
+   *
+   * @param token The given token.
+   */
+  size_t Value(const Token& token) const
+  {
+    std::uint64_t hash = 14695981039346656037ull;
+    HashInteger(hash, seed);
+    Hash(hash, token);
+    return (size_t) (hash % numFeatures) + 1;
+  }
+
+  //! Get the size of the dictionary (the number of features).
+  size_t Size() const { return numFeatures; }
+
+  //! Clear the dictionary; there is nothing to clear.
+  void Clear() { }
+
+  //! Get the number of features.
+  size_t NumFeatures() const { return numFeatures; }
+  //! Modify the number of features.
+  size_t& NumFeatures() { return numFeatures; }
+
+  //! Get the seed of the hash function.
+  size_t Seed() const { return seed; }
+  //! Modify the seed of the hash function.
+  size_t& Seed() { return seed; }
+
+  /**
+   * Serialize the class to the given archive.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(numFeatures);
+    ar & BOOST_SERIALIZATION_NVP(seed);
+  }
+
+ private:
+  //! Add the given byte to the FNV-1a hash.
+  static void HashByte(std::uint64_t& hash, const unsigned char byte)
+  {
+    hash ^= byte;
+    hash *= 1099511628211ull;
+  }
+
+  //! Add the bytes of the given integer to the hash, from the least
+  //! significant one, so that the hash does not depend on the endianness.
+  template<typename T>
+  static void HashInteger(std::uint64_t& hash, const T value)
+  {
+    const std::uint64_t bits = (std::uint64_t) value;
+    for (size_t i = 0; i < sizeof(T); ++i)
+      HashByte(hash, (unsigned char) ((bits >> (8 * i)) & 0xff));
+  }
+
+  //! Add the characters of the given string token to the hash.
+  static void Hash(std::uint64_t& hash, const boost::string_view token)
+  {
+    for (const char c : token)
+      HashByte(hash, (unsigned char) c);
+  }
+
+  //! Add the given integer token (e.g. a character) to the hash.
+  template<typename T>
+  static void Hash(std::uint64_t& hash,
+                   const T token,
+                   const typename std::enable_if_t<
+                       std::is_integral<T>::value>* = 0)
+  {
+    HashInteger(hash, token);
+  }
+
+  //! Number of features.
+  size_t numFeatures;
+  //! Seed of the hash function.
+  size_t seed;
+};
+
+} // namespace data
+} // namespace mlpack
+
+#endif
@@ -13,6 +13,7 @@
 #define MLPACK_CORE_DATA_IMPUTE_STRATEGIES_CUSTOM_IMPUTATION_HPP
 
 #include <mlpack/prereqs.hpp>
+#include "replace_missing.hpp"
 
 namespace mlpack {
 namespace data {
@@ -71,6 +72,26 @@ class CustomImputation
     }
   }
 
+  /**
+   * Impute function that replaces the mapped values of every given dimension
+   * with the custom value, in a single parallel pass over the matrix.
+   *
+   * @param input Matrix that contains the mapped values.
+   * @param mappedValues Value that the user wants to get rid of in each of the
+   *     given dimensions.
+   * @param dimensions Indices of the dimensions to impute.
+   * @param columnMajor State of whether the input matrix is columnMajor or not.
+   */
+  void Impute(arma::Mat<T>& input,
+              const std::vector<T>& mappedValues,
+              const std::vector<size_t>& dimensions,
+              const bool columnMajor = true)
+  {
+    const std::vector<T> replacements(dimensions.size(), customValue);
+    details::ReplaceMissing(input, mappedValues, dimensions, replacements,
+        columnMajor);
+  }
+
  private:
   //! A user-defined value that the user wants to replace missing values with.
   T customValue;
@@ -13,6 +13,7 @@
 #define MLPACK_CORE_DATA_IMPUTE_STRATEGIES_LISTWISE_DELETION_HPP
 
 #include <mlpack/prereqs.hpp>
+#include "replace_missing.hpp"
 
 namespace mlpack {
 namespace data {
@@ -66,6 +67,51 @@ class ListwiseDeletion
       input = input.rows(arma::uvec(colsToKeep));
     }
   }
+
+  /**
+   * Impute function that removes every point (column if columnMajor, row
+   * otherwise) in which any of the given dimensions holds its mapped value.
+   * The points are checked in a single parallel pass.
+   *
+   * @param input Matrix that contains the mapped values.
+   * @param mappedValues Value that the user wants to get rid of in each of the
+   *     given dimensions.
+   * @param dimensions Indices of the dimensions to impute.
+   * @param columnMajor State of whether the input matrix is columnMajor or not.
+   */
+  void Impute(arma::Mat<T>& input,
+              const std::vector<T>& mappedValues,
+              const std::vector<size_t>& dimensions,
+              const bool columnMajor = true)
+  {
+    const size_t nPoints = columnMajor ? input.n_cols : input.n_rows;
+    std::vector<char> keep(nPoints, 1);
+
+    #pragma omp parallel for
+    for (omp_size_t i = 0; i < (omp_size_t) nPoints; ++i)
+    {
+      for (size_t d = 0; d < dimensions.size(); ++d)
+      {
+        const T value = columnMajor ? input(dimensions[d], i) :
+            input(i, dimensions[d]);
+        if (details::IsMissing(value, mappedValues[d]))
+        {
+          keep[i] = 0;
+          break;
+        }
+      }
+    }
+
+    std::vector<arma::uword> pointsToKeep;
+    for (size_t i = 0; i < nPoints; ++i)
+      if (keep[i])
+        pointsToKeep.push_back(i);
+
+    if (columnMajor)
+      input = input.cols(arma::uvec(pointsToKeep));
+    else
+      input = input.rows(arma::uvec(pointsToKeep));
+  }
 }; // class ListwiseDeletion
 
 } // namespace data
@@ -13,6 +13,7 @@
 #define MLPACK_CORE_DATA_IMPUTE_STRATEGIES_MEAN_IMPUTATION_HPP
 
 #include <mlpack/prereqs.hpp>
+#include "replace_missing.hpp"
 
 namespace mlpack {
 namespace data {
@@ -96,6 +97,87 @@ class MeanImputation
       input(target.first, target.second) = mean;
     }
   }
+
+  /**
+   * Impute function that replaces the mapped values of every given dimension
+   * with the mean of that dimension.  The means of all the dimensions are
+   * computed in a single sweep over the matrix, in parallel, and then the
+   * missing values are replaced in a second parallel pass.
+   *
+   * @param input Matrix that contains the mapped values.
+   * @param mappedValues Value that the user wants to get rid of in each of the
+   *     given dimensions.
+   * @param dimensions Indices of the dimensions to impute.
+   * @param columnMajor State of whether the input matrix is columnMajor or not.
+   */
+  void Impute(arma::Mat<T>& input,
+              const std::vector<T>& mappedValues,
+              const std::vector<size_t>& dimensions,
+              const bool columnMajor = true)
+  {
+    const size_t nDims = dimensions.size();
+    arma::vec sums(nDims, arma::fill::zeros);
+    arma::vec elems(nDims, arma::fill::zeros);
+
+    if (columnMajor)
+    {
+      // Each thread sums a part of the points, for every dimension at once.
+      #pragma omp parallel
+      {
+        arma::vec threadSums(nDims, arma::fill::zeros);
+        arma::vec threadElems(nDims, arma::fill::zeros);
+
+        #pragma omp for
+        for (omp_size_t i = 0; i < (omp_size_t) input.n_cols; ++i)
+        {
+          for (size_t d = 0; d < nDims; ++d)
+          {
+            const T value = input(dimensions[d], i);
+            if (!details::IsMissing(value, mappedValues[d]))
+            {
+              threadSums[d] += value;
+              ++threadElems[d];
+            }
+          }
+        }
+
+        #pragma omp critical
+        {
+          sums += threadSums;
+          elems += threadElems;
+        }
+      }
+    }
+    else
+    {
+      #pragma omp parallel for
+      for (omp_size_t d = 0; d < (omp_size_t) nDims; ++d)
+      {
+        for (size_t i = 0; i < input.n_rows; ++i)
+        {
+          const T value = input(i, dimensions[d]);
+          if (!details::IsMissing(value, mappedValues[d]))
+          {
+            sums[d] += value;
+            ++elems[d];
+          }
+        }
+      }
+    }
+
+    std::vector<double> means(nDims);
+    for (size_t d = 0; d < nDims; ++d)
+    {
+      if (elems[d] == 0)
+        Log::Fatal << "it is impossible to calculate mean; no valid elements "
+            << "in dimension " << dimensions[d] << std::endl;
+
+      means[d] = sums[d] / elems[d];
+    }
+
+    details::ReplaceMissing(input, mappedValues, dimensions, means,
+        columnMajor);
+  }
 }; // class MeanImputation
 
 } // namespace data
@@ -13,6 +13,8 @@
 #define MLPACK_CORE_DATA_IMPUTE_STRATEGIES_MEDIAN_IMPUTATION_HPP
 
 #include <mlpack/prereqs.hpp>
+#include "replace_missing.hpp"
+#include <algorithm>
 
 namespace mlpack {
 namespace data {
@@ -85,6 +87,106 @@ class MedianImputation
        input(target.first, target.second) = median;
     }
   }
+
+  /**
+   * Impute function that replaces the mapped values of every given dimension
+   * with the median of that dimension.  The valid elements of all the
+   * dimensions are collected in a single sweep over the matrix, the medians are
+   * selected in parallel over the dimensions, and then the missing values are
+   * replaced in a parallel pass.
+   *
+   * @param input Matrix that contains the mapped values.
+   * @param mappedValues Value that the user wants to get rid of in each of the
+   *     given dimensions.
+   * @param dimensions Indices of the dimensions to impute.
+   * @param columnMajor State of whether the input matrix is columnMajor or not.
+   */
+  void Impute(arma::Mat<T>& input,
+              const std::vector<T>& mappedValues,
+              const std::vector<size_t>& dimensions,
+              const bool columnMajor = true)
+  {
+    const size_t nDims = dimensions.size();
+    // The valid elements of each dimension.
+    std::vector<std::vector<T>> elemsToKeep(nDims);
+
+    if (columnMajor)
+    {
+      // Each thread collects the elements of a part of the points.
+      #pragma omp parallel
+      {
+        std::vector<std::vector<T>> threadElems(nDims);
+
+        #pragma omp for
+        for (omp_size_t i = 0; i < (omp_size_t) input.n_cols; ++i)
+        {
+          for (size_t d = 0; d < nDims; ++d)
+          {
+            const T value = input(dimensions[d], i);
+            if (!details::IsMissing(value, mappedValues[d]))
+              threadElems[d].push_back(value);
+          }
+        }
+
+        #pragma omp critical
+        {
+          for (size_t d = 0; d < nDims; ++d)
+          {
+            elemsToKeep[d].insert(elemsToKeep[d].end(),
+                threadElems[d].begin(), threadElems[d].end());
+          }
+        }
+      }
+    }
+    else
+    {
+      #pragma omp parallel for
+      for (omp_size_t d = 0; d < (omp_size_t) nDims; ++d)
+      {
+        for (size_t i = 0; i < input.n_rows; ++i)
+        {
+          const T value = input(i, dimensions[d]);
+          if (!details::IsMissing(value, mappedValues[d]))
+            elemsToKeep[d].push_back(value);
+        }
+      }
+    }
+
+    for (size_t d = 0; d < nDims; ++d)
+    {
+      if (elemsToKeep[d].empty())
+        Log::Fatal << "it is impossible to calculate median; no valid elements "
+            << "in dimension " << dimensions[d] << std::endl;
+    }
+
+    std::vector<double> medians(nDims);
+    #pragma omp parallel for
+    for (omp_size_t d = 0; d < (omp_size_t) nDims; ++d)
+      medians[d] = Median(elemsToKeep[d]);
+
+    details::ReplaceMissing(input, mappedValues, dimensions, medians,
+        columnMajor);
+  }
+
+ private:
+  /**
+   * Return the median of the given elements (the average of the two middle
+   * elements if there is an even number of them), using selection instead of
+   * sorting.  The elements are reordered.
+   */
+  static double Median(std::vector<T>& elems)
+  {
+    const size_t half = elems.size() / 2;
+    std::nth_element(elems.begin(), elems.begin() + half, elems.end());
+    const double upper = elems[half];
+    if (elems.size() % 2 == 1)
+      return upper;
+
+    // The lower middle element is the largest of the lower half.
+    const double lower = *std::max_element(elems.begin(),
+        elems.begin() + half);
+    return (lower + upper) / 2.0;
+  }
 }; // class MedianImputation
 
 } // namespace data
@@ -0,0 +1,79 @@
+/**
+ * @file core/data/imputation_methods/replace_missing.hpp
+ *
+ * Utilities shared by the imputation strategies to impute many dimensions of a
+ * dataset at once.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_IMPUTE_STRATEGIES_REPLACE_MISSING_HPP
+#define MLPACK_CORE_DATA_IMPUTE_STRATEGIES_REPLACE_MISSING_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace data {
+namespace details {
+
+//! Return true if the given value is the mapped value or NaN.
+template<typename T>
+inline bool IsMissing(const T value, const T mappedValue)
+{
+  return value == mappedValue || std::isnan(value);
+}
+
+/**
+ * Replace every missing value of each of the given dimensions with the
+ * replacement of that dimension.  A value of dimensions[d] is missing if it is
+ * mappedValues[d] or NaN.  In column-major mode, the points are swept once in
+ * parallel, and every dimension of a point is replaced at once; otherwise, the
+ * dimensions (which are columns of the matrix) are replaced in parallel.
+ *
+ * @param input Matrix to replace the missing values of.
+ * @param mappedValues Value that is missing in each dimension.
+ * @param dimensions Indices of the dimensions to replace.
+ * @param replacements Value to replace the missing values of each dimension
+ *     with.
+ * @param columnMajor State of whether the input matrix is columnMajor or not.
+ */
+template<typename T, typename ReplacementType>
+void ReplaceMissing(arma::Mat<T>& input,
+                    const std::vector<T>& mappedValues,
+                    const std::vector<size_t>& dimensions,
+                    const std::vector<ReplacementType>& replacements,
+                    const bool columnMajor)
+{
+  if (columnMajor)
+  {
+    #pragma omp parallel for
+    for (omp_size_t i = 0; i < (omp_size_t) input.n_cols; ++i)
+    {
+      for (size_t d = 0; d < dimensions.size(); ++d)
+      {
+        if (IsMissing(input(dimensions[d], i), mappedValues[d]))
+          input(dimensions[d], i) = replacements[d];
+      }
+    }
+  }
+  else
+  {
+    #pragma omp parallel for
+    for (omp_size_t d = 0; d < (omp_size_t) dimensions.size(); ++d)
+    {
+      for (size_t i = 0; i < input.n_rows; ++i)
+      {
+        if (IsMissing(input(i, dimensions[d]), mappedValues[d]))
+          input(i, dimensions[d]) = replacements[d];
+      }
+    }
+  }
+}
+
+} // namespace details
+} // namespace data
+} // namespace mlpack
+
+#endif
@@ -65,6 +65,43 @@ class Imputer
     strategy.Impute(input, mappedValue, dimension, columnMajor);
   }
 
+  /**
+  * Given an input dataset, replace missing values of every dimension in which
+  * the missing value was mapped with the given imputation strategy.  All of the
+  * dimensions are imputed at once, so this is much faster than imputing each
+  * dimension separately.  This function does not produce output matrix, but
+  * overwrites the result into the input matrix.
+  *
+  * @param input Input dataset to apply imputation.
+  * @param missingValue User defined missing value; it can be anything.
+  */
+  void Impute(arma::Mat<T>& input, const std::string& missingValue)
+  {
+    std::vector<size_t> dimensions;
+    std::vector<T> mappedValues;
+    const size_t nDims = std::min<size_t>(mapper.Dimensionality(),
+        columnMajor ? input.n_rows : input.n_cols);
+    for (size_t d = 0; d < nDims; ++d)
+    {
+      if (mapper.NumMappings(d) == 0)
+        continue;
+
+      try
+      {
+        mappedValues.push_back(static_cast<T>(mapper.UnmapValue(missingValue,
+            d)));
+        dimensions.push_back(d);
+      }
+      catch (std::invalid_argument& /* e */)
+      {
+        // The missing value was not mapped in this dimension.
+      }
+    }
+
+    if (!dimensions.empty())
+      strategy.Impute(input, mappedValues, dimensions, columnMajor);
+  }
+
   //! Get the strategy.
   const StrategyType& Strategy() const { return strategy; }
 
@@ -41,11 +41,20 @@ namespace data /** Functions to load and save matrices and models. */ {
  *  - Raw binary (raw_binary), denoted by .bin
  *  - Armadillo binary (arma_binary), denoted by .bin
  *  - HDF5, denoted by .hdf, .hdf5, .h5, or .he5
+ *  - mlpack binary dataset (see SaveBinaryDataset()), denoted by .mlb
+ *  - Parquet, denoted by .parquet, if mlpack was compiled with Parquet support
+ *    (only numeric columns)
  *
  * If the file extension is not one of those types, an error will be given.
  * This is preferable to Armadillo's default behavior of loading an unknown
  * filetype as raw_binary, which can have very confusing effects.
  *
+ * A file compressed with gzip (.gz) or zstd (.zst), such as "data.csv.gz", is
+ * decompressed while it is loaded, if mlpack was compiled with zlib or zstd
+ * support; its type is given by the extension before the extension of the
+ * compression.  Formats that are not read as a stream (HDF5, ARFF, Parquet,
+ * and the mlpack binary dataset format) cannot be compressed.
+ *
  * If the parameter 'fatal' is set to true, a std::runtime_error exception will
  * be thrown if the matrix does not load successfully.  The parameter
  * 'transpose' controls whether or not the matrix is transposed after loading.
@@ -70,17 +79,25 @@ bool Load(const std::string& filename,
  * will transpose the matrix at load time (unless the transpose parameter is set
  * to false).  If the filetype cannot be determined, an error will be given.
  *
- * The supported types of files are the same as found in Armadillo:
+ * The supported types of files are the same as found in Armadillo, and ARFF:
  *
  *  - TSV (coord_ascii), denoted by .tsv or .txt
  *  - TXT (coord_ascii), denoted by .txt
  *  - Raw binary (raw_binary), denoted by .bin
  *  - Armadillo binary (arma_binary), denoted by .bin
+ *  - ARFF, denoted by .arff; sparse lines are supported, and the mappings of
+ *    categorical values are not kept (use LoadARFF() to get them)
  *
  * If the file extension is not one of those types, an error will be given.
  * This is preferable to Armadillo's default behavior of loading an unknown
  * filetype as raw_binary, which can have very confusing effects.
  *
+ * A file compressed with gzip (.gz) or zstd (.zst), such as "data.csv.gz", is
+ * decompressed while it is loaded, if mlpack was compiled with zlib or zstd
+ * support; its type is given by the extension before the extension of the
+ * compression.  Formats that are not read as a stream (HDF5, ARFF, Parquet,
+ * and the mlpack binary dataset format) cannot be compressed.
+ *
  * If the parameter 'fatal' is set to true, a std::runtime_error exception will
  * be thrown if the matrix does not load successfully.  The parameter
  * 'transpose' controls whether or not the matrix is transposed after loading.
@@ -186,11 +203,20 @@ extern template bool Load<double>(const std::string&,
  *  - Raw binary (raw_binary), denoted by .bin
  *  - Armadillo binary (arma_binary), denoted by .bin
  *  - HDF5, denoted by .hdf, .hdf5, .h5, or .he5
+ *  - mlpack binary dataset (see SaveBinaryDataset()), denoted by .mlb
+ *  - Parquet, denoted by .parquet, if mlpack was compiled with Parquet support
+ *    (only numeric columns)
  *
  * If the file extension is not one of those types, an error will be given.
  * This is preferable to Armadillo's default behavior of loading an unknown
  * filetype as raw_binary, which can have very confusing effects.
  *
+ * A file compressed with gzip (.gz) or zstd (.zst), such as "data.csv.gz", is
+ * decompressed while it is loaded, if mlpack was compiled with zlib or zstd
+ * support; its type is given by the extension before the extension of the
+ * compression.  Formats that are not read as a stream (HDF5, ARFF, Parquet,
+ * and the mlpack binary dataset format) cannot be compressed.
+ *
  * If the parameter 'fatal' is set to true, a std::runtime_error exception will
  * be thrown if the matrix does not load successfully.
  *
@@ -218,11 +244,20 @@ bool Load(const std::string& filename,
  *  - Raw binary (raw_binary), denoted by .bin
  *  - Armadillo binary (arma_binary), denoted by .bin
  *  - HDF5, denoted by .hdf, .hdf5, .h5, or .he5
+ *  - mlpack binary dataset (see SaveBinaryDataset()), denoted by .mlb
+ *  - Parquet, denoted by .parquet, if mlpack was compiled with Parquet support
+ *    (only numeric columns)
  *
  * If the file extension is not one of those types, an error will be given.
  * This is preferable to Armadillo's default behavior of loading an unknown
  * filetype as raw_binary, which can have very confusing effects.
  *
+ * A file compressed with gzip (.gz) or zstd (.zst), such as "data.csv.gz", is
+ * decompressed while it is loaded, if mlpack was compiled with zlib or zstd
+ * support; its type is given by the extension before the extension of the
+ * compression.  Formats that are not read as a stream (HDF5, ARFF, Parquet,
+ * and the mlpack binary dataset format) cannot be compressed.
+ *
  * If the parameter 'fatal' is set to true, a std::runtime_error exception will
  * be thrown if the matrix does not load successfully.
  *
@@ -241,16 +276,28 @@ bool Load(const std::string& filename,
  * mapping categorical features with a DatasetMapper object.  This will
  * transpose the matrix (unless the transpose parameter is set to false).
  * This particular overload of Load() can only load text-based formats, such as
- * those given below:
+ * those given below, the mlpack binary dataset format, and Parquet:
  *
  * - CSV (csv_ascii), denoted by .csv, or optionally .txt
  * - TSV (raw_ascii), denoted by .tsv, .csv, or .txt
  * - ASCII (raw_ascii), denoted by .txt
+ * - ARFF, denoted by .arff
+ * - mlpack binary dataset, denoted by .mlb; the mappings and data types saved
+ *   with SaveBinaryDataset() are loaded into the DatasetMapper
+ * - Parquet, denoted by .parquet, if mlpack was compiled with Parquet support;
+ *   string columns are categorical (use LoadParquet() to load only some of
+ *   the columns)
  *
  * If the file extension is not one of those types, an error will be given.
  * This is preferable to Armadillo's default behavior of loading an unknown
  * filetype as raw_binary, which can have very confusing effects.
  *
+ * A file compressed with gzip (.gz) or zstd (.zst), such as "data.csv.gz", is
+ * decompressed while it is loaded, if mlpack was compiled with zlib or zstd
+ * support; its type is given by the extension before the extension of the
+ * compression.  Formats that are not read as a stream (HDF5, ARFF, Parquet,
+ * and the mlpack binary dataset format) cannot be compressed.
+ *
  * If the parameter 'fatal' is set to true, a std::runtime_error exception will
  * be thrown if the matrix does not load successfully.  The parameter
  * 'transpose' controls whether or not the matrix is transposed after loading.
@@ -338,6 +385,11 @@ extern template bool Load<double, IncrementPolicy>(
  * The autodetect functionality operates on the file extension (so, "file.txt"
  * would be autodetected as text).
  *
+ * A file compressed with gzip (.gz) or zstd (.zst), such as "model.bin.zst", is
+ * decompressed while it is loaded, if mlpack was compiled with zlib or zstd
+ * support; then the extension before the extension of the compression is used
+ * to autodetect the format.
+ *
  * The name parameter should be specified to indicate the name of the structure
  * to be loaded.  This should be the same as the name that was used to save the
  * structure (otherwise, the loading procedure will fail).
@@ -373,11 +425,34 @@ bool Load(const std::string& filename,
           const bool fatal = false);
 
 /**
- * Load the image file into the given matrix.
+ * Load the image files into the given matrix, one image per column.  The
+ * images are decoded in parallel (when OpenMP is available), and must all have
+ * the size of the first one.
+ *
+ * @param files A vector consisting of filenames.
+ * @param matrix Matrix to save the image from.
+ * @param info An object of ImageInfo class.
+ * @param fatal If an error should be reported as fatal (default false).
+ * @return Boolean value indicating success or failure of load.
+ */
+template<typename eT>
+bool Load(const std::vector<std::string>& files,
+          arma::Mat<eT>& matrix,
+          ImageInfo& info,
+          const bool fatal = false);
+
+/**
+ * Load the image files into the given matrix, one image per column, resizing
+ * each image that doesn't have the given size with bilinear interpolation.
+ * The images are decoded in parallel (when OpenMP is available).  If the width
+ * or the height is 0, the images are not resized, and must all have the size
+ * of the first one.
  *
  * @param files A vector consisting of filenames.
  * @param matrix Matrix to save the image from.
  * @param info An object of ImageInfo class.
+ * @param width Width to resize the images to.
+ * @param height Height to resize the images to.
  * @param fatal If an error should be reported as fatal (default false).
  * @return Boolean value indicating success or failure of load.
  */
@@ -385,6 +460,8 @@ template<typename eT>
 bool Load(const std::vector<std::string>& files,
           arma::Mat<eT>& matrix,
           ImageInfo& info,
+          const size_t width,
+          const size_t height,
           const bool fatal = false);
 
 // Implementation found in load_image.cpp.
@@ -393,6 +470,14 @@ bool LoadImage(const std::string& filename,
                ImageInfo& info,
                const bool fatal = false);
 
+// Implementation found in load_image.cpp.
+bool LoadImages(const std::vector<std::string>& files,
+                arma::Mat<unsigned char>& matrix,
+                ImageInfo& info,
+                const size_t width,
+                const size_t height,
+                const bool fatal = false);
+
 } // namespace data
 } // namespace mlpack
 
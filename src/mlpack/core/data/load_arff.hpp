@@ -44,6 +44,11 @@ void LoadARFF(const std::string& filename, arma::Mat<eT>& matrix);
  * loading the training set is not used, then the test set may be loaded with
  * different mappings---which can cause horrible problems!
  *
+ * The file is read in a single pass, and blocks of lines are parsed in parallel
+ * (when OpenMP is available); the categorical values are still mapped in the
+ * order of the file.  Sparse lines ({index value, index value, ...}) are
+ * supported, and the values they don't give are 0.
+ *
  * @param filename Name of ARFF file to load.
  * @param matrix Matrix to load data into.
  * @param info DatasetInfo object; can be default-constructed or pre-existing
@@ -54,6 +59,22 @@ void LoadARFF(const std::string& filename,
               arma::Mat<eT>& matrix,
               DatasetMapper<PolicyType>& info);
 
+/**
+ * A utility function to load an ARFF dataset into a sparse matrix, using the
+ * DatasetInfo structure for mapping, in the same way as the overload for dense
+ * matrices.  Both sparse and dense lines are supported; only the nonzero values
+ * are stored.  An exception will be thrown upon failure.
+ *
+ * @param filename Name of ARFF file to load.
+ * @param matrix Sparse matrix to load data into.
+ * @param info DatasetInfo object; can be default-constructed or pre-existing
+ *     from another call to LoadARFF().
+ */
+template<typename eT, typename PolicyType>
+void LoadARFF(const std::string& filename,
+              arma::SpMat<eT>& matrix,
+              DatasetMapper<PolicyType>& info);
+
 } // namespace data
 } // namespace mlpack
 
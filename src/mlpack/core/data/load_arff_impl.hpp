@@ -16,39 +16,59 @@
 #include "load_arff.hpp"
 
 #include <boost/algorithm/string/trim.hpp>
+#include <cctype>
+#include <cstdlib>
 #include "is_naninf.hpp"
 
 namespace mlpack {
 namespace data {
+namespace details {
 
-template<typename eT, typename PolicyType>
-void LoadARFF(const std::string& filename,
-              arma::Mat<eT>& matrix,
-              DatasetMapper<PolicyType>& info)
+/**
+ * The values of one line of the @data section of an ARFF file.
+ */
+template<typename eT>
+struct ARFFRow
 {
-  // First, open the file.
-  std::ifstream ifs;
-  ifs.open(filename, std::ios::in | std::ios::binary);
-
-  // if file is not open throw an error (file not found).
-  if (!ifs.is_open())
-  {
-    Log::Fatal << "Cannot open file '" << filename << "'. " << std::endl;
-  }
+  //! Whether the line holds no data (it is empty or a comment).
+  bool empty;
+  //! The dimension of each value.
+  std::vector<size_t> dimensions;
+  //! Each value, as a string.
+  std::vector<std::string> tokens;
+  //! Each value; categorical values are only mapped once the whole block is
+  //! parsed, so that they are mapped in the order of the file.
+  std::vector<eT> values;
+  //! The error found in the line, if any.
+  std::string error;
+};
 
+/**
+ * Parse the header of an ARFF file, up to and including the @data line, and
+ * set up the DatasetMapper with the type of each dimension.
+ *
+ * @param ifs Stream of the file.
+ * @param info DatasetMapper to set up.
+ * @param lines Will hold the number of lines of the header.
+ */
+template<typename PolicyType>
+void ReadARFFHeader(std::istream& ifs,
+                    DatasetMapper<PolicyType>& info,
+                    size_t& lines)
+{
   std::string line;
   size_t dimensionality = 0;
   std::vector<bool> types;
-  size_t headerLines = 0;
+  lines = 0;
   while (ifs.good())
   {
     // Read the next line, then strip whitespace from either side.
     std::getline(ifs, line, '\n');
     boost::trim(line);
-    ++headerLines;
+    ++lines;
 
     // Is the first character a comment, or is the line empty?
-    if (line[0] == '%' || line.empty())
+    if (line.empty() || line[0] == '%')
       continue; // Ignore this line.
 
     // If the first character is @, we are looking at @relation, @attribute, or
@@ -130,105 +150,394 @@ void LoadARFF(const std::string& filename,
     else
       info.Type(i) = Datatype::numeric;
   }
+}
 
-  // We need to find out how many lines of data are in the file.
-  std::streampos pos = ifs.tellg();
-  size_t row = 0;
-  while (ifs.good())
-  {
-    std::getline(ifs, line, '\n');
-    ++row;
-  }
-  // Uncount the EOF row.
-  --row;
+/**
+ * Parse a numeric value of an ARFF file.  This is much faster than extracting
+ * it from a stringstream.
+ *
+ * @param token The value to parse.
+ * @param val Will hold the value.
+ * @return Whether the token is a number.
+ */
+template<typename eT>
+inline bool ParseARFFNumber(const std::string& token, eT& val)
+{
+  if (IsNaNInf(val, token))
+    return true;
 
-  // Since we've hit the EOF, we have to call clear() so we can seek again.
-  ifs.clear();
-  ifs.seekg(pos);
+  const char* begin = token.c_str();
+  char* end;
+  const double d = std::strtod(begin, &end);
+  if (end == begin || *end != '\0' || !std::isfinite(d))
+    return false;
 
-  // Now, set the size of the matrix.
-  matrix.set_size(dimensionality, row);
+  val = eT(d);
+  return true;
+}
 
-  // Now we are looking at the @data section.
-  row = 0;
-  while (ifs.good())
+/**
+ * Split one line of the @data section of an ARFF file into its values and
+ * parse the numeric ones.  The values are separated by commas; a value may be
+ * quoted ('value' or "value", where a backslash escapes the next character),
+ * whitespace around the values is removed, and a '%' outside of quotes starts
+ * a comment.  A sparse line ({index value, index value, ...}) only holds the
+ * nonzero values.
+ *
+ * @param line The line to parse.
+ * @param lineNumber Number of the line in the file, for errors.
+ * @param categorical Whether each dimension is categorical.
+ * @param row Will hold the values of the line.
+ */
+template<typename eT>
+void ParseARFFLine(const std::string& line,
+                   const size_t lineNumber,
+                   const std::vector<bool>& categorical,
+                   ARFFRow<eT>& row)
+{
+  row.dimensions.clear();
+  row.tokens.clear();
+  row.values.clear();
+  row.error.clear();
+
+  size_t pos = 0;
+  while (pos < line.size() && std::isspace((unsigned char) line[pos]))
+    ++pos;
+
+  row.empty = (pos == line.size() || line[pos] == '%');
+  if (row.empty)
+    return;
+
+  const bool sparse = (line[pos] == '{');
+  if (sparse)
+    ++pos;
+
+  std::ostringstream error;
+  std::string token;
+  bool closed = !sparse;
+  bool last = false;
+  while (!last)
   {
-    std::getline(ifs, line, '\n');
-    boost::trim(line);
-    // Each line of the @data section must be a CSV (except sparse data, which
-    // we will handle later).  So now we can tokenize the
-    // CSV and parse it.  The '?' representing a missing value is not allowed,
-    // so if that occurs we throw an exception.  We also throw an exception if
-    // any piece of data does not match its type (categorical or numeric).
-
-    // If the first character is {, it is sparse data, and we can just say this
-    // is not handled for now...
-    if (line[0] == '{')
-      throw std::runtime_error("cannot yet parse sparse ARFF data");
-
-    // Tokenize the line.
-    typedef boost::tokenizer<boost::escaped_list_separator<char>> Tokenizer;
-    boost::escaped_list_separator<char> sep("\\", ",", "\"");
-    Tokenizer tok(line, sep);
-
-    size_t col = 0;
-    std::stringstream token;
-    for (Tokenizer::iterator it = tok.begin(); it != tok.end(); ++it)
+    // Skip the whitespace before the value.
+    while (pos < line.size() && std::isspace((unsigned char) line[pos]))
+      ++pos;
+
+    // A sparse line may have no values.
+    if (sparse && row.tokens.empty() && pos < line.size() && line[pos] == '}')
     {
-      // Check that we are not too many columns in.
-      if (col >= matrix.n_rows)
+      closed = true;
+      break;
+    }
+
+    // The value of a sparse line is preceded by its dimension.
+    size_t dimension = row.tokens.size();
+    if (sparse)
+    {
+      const size_t begin = pos;
+      dimension = 0;
+      while (pos < line.size() && std::isdigit((unsigned char) line[pos]))
+        dimension = 10 * dimension + (line[pos++] - '0');
+
+      if (pos == begin || pos == line.size() ||
+          !std::isspace((unsigned char) line[pos]))
       {
-        std::stringstream error;
-        error << "Too many columns in line " << (headerLines + row) << ".";
-        throw std::runtime_error(error.str());
+        error << "Parse error at line " << lineNumber << ": sparse values "
+            << "must be given as '{index value, ...}'.";
+        row.error = error.str();
+        return;
       }
 
-      // What should this token be?
-      if (info.Type(col) == Datatype::categorical)
+      while (pos < line.size() && std::isspace((unsigned char) line[pos]))
+        ++pos;
+    }
+
+    // Read the value up to the next separator, removing the quotes; end only
+    // keeps track of the whitespace after the value.
+    token.clear();
+    size_t end = 0;
+    bool separator = false;
+    while (pos < line.size())
+    {
+      const char c = line[pos];
+      if (c == '"' || c == '\'')
       {
-        // Strip spaces before mapping.
-        std::string token = *it;
-        boost::trim(token);
-        // We load transposed.
-        matrix(col, row) = info.template MapString<eT>(token, col);
+        for (++pos; pos < line.size() && line[pos] != c; ++pos)
+        {
+          if (line[pos] == '\\' && pos + 1 < line.size())
+            ++pos;
+          token += line[pos];
+        }
+
+        if (pos == line.size())
+        {
+          error << "Parse error at line " << lineNumber << ": unterminated "
+              << "quote.";
+          row.error = error.str();
+          return;
+        }
+
+        ++pos;
+        end = token.size();
+        continue;
       }
-      else if (info.Type(col) == Datatype::numeric)
+
+      if (c == ',')
       {
-        // Attempt to read as numeric.
-        token.clear();
-        token.str(*it);
+        ++pos;
+        separator = true;
+        break;
+      }
 
-        eT val = eT(0);
-        token >> val;
+      if (c == '%' || (sparse && c == '}'))
+      {
+        closed = closed || (c == '}');
+        last = true;
+        break;
+      }
 
-        if (token.fail())
-        {
-          // Check for NaN or inf.
-          if (!IsNaNInf(val, token.str()))
-          {
-            // Okay, it's not NaN or inf.  If it's '?', we issue a specific
-            // error, otherwise we issue a general error.
-            std::stringstream error;
-            std::string tokenStr = token.str();
-            boost::trim(tokenStr);
-            if (tokenStr == "?")
-              error << "Missing values ('?') not supported, ";
-            else
-              error << "Parse error ";
-            error << "at line " << (headerLines + row) << " token " << col
-                << ": \"" << tokenStr << "\".";
-            throw std::runtime_error(error.str());
-          }
-        }
+      token += c;
+      if (!std::isspace((unsigned char) c))
+        end = token.size();
+      ++pos;
+    }
+    token.resize(end);
+    last = last || (!separator && pos == line.size());
 
-        // If we made it to here, we have a value.
-        matrix(col, row) = val; // We load transposed.
+    if (dimension >= categorical.size())
+    {
+      if (sparse)
+      {
+        error << "Dimension " << dimension << " out of range in line "
+            << lineNumber << ".";
+      }
+      else
+      {
+        error << "Too many columns in line " << lineNumber << ".";
+      }
+      row.error = error.str();
+      return;
+    }
+
+    // Categorical values are mapped later.
+    eT val = eT(0);
+    if (!categorical[dimension] && !ParseARFFNumber(token, val))
+    {
+      // If it's '?', we issue a specific error, otherwise we issue a general
+      // error.
+      if (token == "?")
+        error << "Missing values ('?') not supported, ";
+      else
+        error << "Parse error ";
+      error << "at line " << lineNumber << " token " << row.tokens.size()
+          << ": \"" << token << "\".";
+      row.error = error.str();
+      return;
+    }
+
+    row.dimensions.push_back(dimension);
+    row.tokens.push_back(token);
+    row.values.push_back(val);
+  }
+
+  if (!closed)
+  {
+    error << "Parse error at line " << lineNumber << ": sparse line is not "
+        << "closed with '}'.";
+    row.error = error.str();
+  }
+  else if (!sparse && row.tokens.size() != categorical.size())
+  {
+    error << "Too few columns in line " << lineNumber << ".";
+    row.error = error.str();
+  }
+}
+
+/**
+ * Read the next block of lines of the @data section of an ARFF file and parse
+ * them in parallel (when OpenMP is available).  Then, the categorical values
+ * are mapped in the order of the file, and the first error found, if any, is
+ * thrown.
+ *
+ * @param ifs Stream of the file.
+ * @param lineNumber Number of lines of the file read so far; this will be
+ *     updated.
+ * @param categorical Whether each dimension is categorical.
+ * @param info DatasetMapper to map the categorical values with.
+ * @param lines Buffer for the lines.
+ * @param rows Will hold the values of each line.
+ * @return The number of lines read.
+ */
+template<typename eT, typename PolicyType>
+size_t ReadARFFBlock(std::istream& ifs,
+                     size_t& lineNumber,
+                     const std::vector<bool>& categorical,
+                     DatasetMapper<PolicyType>& info,
+                     std::vector<std::string>& lines,
+                     std::vector<ARFFRow<eT>>& rows)
+{
+  // Number of lines parsed at once.
+  const size_t blockLines = 1 << 14;
+
+  if (lines.size() < blockLines)
+    lines.resize(blockLines);
+  size_t numLines = 0;
+  while (numLines < blockLines && std::getline(ifs, lines[numLines], '\n'))
+    ++numLines;
+
+  if (rows.size() < numLines)
+    rows.resize(numLines);
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) numLines; ++i)
+    ParseARFFLine(lines[i], lineNumber + i + 1, categorical, rows[i]);
+
+  for (size_t i = 0; i < numLines; ++i)
+  {
+    ARFFRow<eT>& row = rows[i];
+    if (!row.error.empty())
+      throw std::runtime_error(row.error);
+
+    for (size_t j = 0; j < row.tokens.size(); ++j)
+    {
+      if (categorical[row.dimensions[j]])
+      {
+        row.values[j] = info.template MapString<eT>(row.tokens[j],
+            row.dimensions[j]);
+      }
+    }
+  }
+
+  lineNumber += numLines;
+  return numLines;
+}
+
+//! Whether each dimension of the DatasetMapper is categorical.
+template<typename PolicyType>
+std::vector<bool> CategoricalDimensions(const DatasetMapper<PolicyType>& info)
+{
+  std::vector<bool> categorical(info.Dimensionality());
+  for (size_t i = 0; i < categorical.size(); ++i)
+    categorical[i] = (info.Type(i) == Datatype::categorical);
+
+  return categorical;
+}
+
+} // namespace details
+
+template<typename eT, typename PolicyType>
+void LoadARFF(const std::string& filename,
+              arma::Mat<eT>& matrix,
+              DatasetMapper<PolicyType>& info)
+{
+  // First, open the file.
+  std::ifstream ifs;
+  ifs.open(filename, std::ios::in | std::ios::binary);
+
+  // if file is not open throw an error (file not found).
+  if (!ifs.is_open())
+  {
+    Log::Fatal << "Cannot open file '" << filename << "'. " << std::endl;
+  }
+
+  size_t lineNumber;
+  details::ReadARFFHeader(ifs, info, lineNumber);
+  const std::vector<bool> categorical = details::CategoricalDimensions(info);
+
+  // The data is read in a single pass, so the matrix grows as it is filled; we
+  // load transposed.
+  matrix.set_size(categorical.size(), 1024);
+  size_t col = 0;
+
+  std::vector<std::string> lines;
+  std::vector<details::ARFFRow<eT>> rows;
+  size_t numLines;
+  while ((numLines = details::ReadARFFBlock(ifs, lineNumber, categorical,
+      info, lines, rows)) > 0)
+  {
+    for (size_t i = 0; i < numLines; ++i)
+    {
+      const details::ARFFRow<eT>& row = rows[i];
+      if (row.empty)
+        continue;
+
+      if (col == matrix.n_cols)
+        matrix.resize(matrix.n_rows, 2 * matrix.n_cols);
+
+      // Values that a sparse line doesn't give are zero.
+      if (row.tokens.size() != matrix.n_rows)
+        matrix.col(col).zeros();
+      for (size_t j = 0; j < row.values.size(); ++j)
+        matrix(row.dimensions[j], col) = row.values[j];
+
+      ++col;
+    }
+  }
+
+  matrix.resize(matrix.n_rows, col);
+}
+
+template<typename eT, typename PolicyType>
+void LoadARFF(const std::string& filename,
+              arma::SpMat<eT>& matrix,
+              DatasetMapper<PolicyType>& info)
+{
+  // First, open the file.
+  std::ifstream ifs;
+  ifs.open(filename, std::ios::in | std::ios::binary);
+
+  // if file is not open throw an error (file not found).
+  if (!ifs.is_open())
+  {
+    Log::Fatal << "Cannot open file '" << filename << "'. " << std::endl;
+  }
+
+  size_t lineNumber;
+  details::ReadARFFHeader(ifs, info, lineNumber);
+  const std::vector<bool> categorical = details::CategoricalDimensions(info);
+
+  // Collect the nonzero values in the order of the file, which is sorted by
+  // column; we load transposed.
+  std::vector<arma::uword> locations;
+  std::vector<eT> values;
+  size_t col = 0;
+
+  std::vector<std::string> lines;
+  std::vector<details::ARFFRow<eT>> rows;
+  size_t numLines;
+  while ((numLines = details::ReadARFFBlock(ifs, lineNumber, categorical,
+      info, lines, rows)) > 0)
+  {
+    for (size_t i = 0; i < numLines; ++i)
+    {
+      const details::ARFFRow<eT>& row = rows[i];
+      if (row.empty)
+        continue;
+
+      for (size_t j = 0; j < row.values.size(); ++j)
+      {
+        if (row.values[j] == eT(0))
+          continue;
+
+        locations.push_back(row.dimensions[j]);
+        locations.push_back(col);
+        values.push_back(row.values[j]);
       }
 
       ++col;
     }
-    ++row;
   }
+
+  if (values.empty())
+  {
+    matrix.zeros(categorical.size(), col);
+    return;
+  }
+
+  const arma::umat locationMatrix(locations.data(), 2, values.size(), false,
+      true);
+  const arma::Col<eT> valueVector(values.data(), values.size(), false, true);
+  matrix = arma::SpMat<eT>(locationMatrix, valueVector, categorical.size(),
+      col);
 }
 
 } // namespace data
@@ -3,7 +3,7 @@
  * @author Tham Ngap Wei
  * @author Mehul Kumar Nirala
  *
- * A CSV reader that uses boost::spirit.
+ * A multithreaded CSV reader.
  *
  * mlpack is free software; you may redistribute it and/or modify it under the
  * terms of the 3-clause BSD license.  You should have received a copy of the
@@ -12,75 +12,210 @@
  */
 #include "load_csv.hpp"
 
-using namespace boost::spirit;
+#include <cctype>
 
 namespace mlpack {
 namespace data {
 
+//! Size of the blocks the file is read in.
+static const size_t blockSize = 1 << 24;
+
+//! Remove whitespace from either side of the given string.
+static boost::string_view Trim(boost::string_view str)
+{
+  while (!str.empty() && std::isspace((unsigned char) str.front()))
+    str.remove_prefix(1);
+  while (!str.empty() && std::isspace((unsigned char) str.back()))
+    str.remove_suffix(1);
+
+  return str;
+}
+
 LoadCSV::LoadCSV(const std::string& file) :
-  extension(Extension(file)),
+  compression(FileCompression(file)),
+  extension(Extension(UncompressedName(file))),
   filename(file),
-  inFile(file)
+  inFile(new CompressedInputStream(file, compression)),
+  bufferStart(0)
 {
   // Attempt to open stream.
   CheckOpen();
 
-  //! Spirit rule for parsing quoted string.
-  boost::spirit::qi::rule<std::string::iterator, iter_type()> quotedRule;
-  // Match quoted strings as: "string" or 'string'
-  quotedRule = qi::raw[(qi::char_("'") >> *((qi::char_ - "'") |
-                               "'" >> qi::char_("'")) >> "'") |
-                       (qi::char_('"') >> *((qi::char_ - '"') |
-                               '"' >> qi::char_('"')) >> '"') ];
-
-  // Set rules.
+  // Set the delimiters.
   if (extension == "csv")
   {
-    // Match all characters that are not ',', '\r', or '\n'.
-    stringRule = quotedRule.copy() | qi::raw[*~qi::char_(",\r\n")];
+    // Fields are separated by a single comma, possibly with whitespace on
+    // either side.
+    fieldEnd = ",\r\n";
+    delimiter = ',';
   }
   else if (extension == "txt")
   {
-    // Match all characters that are not ' ', ',', '\r', or '\n'.
-    stringRule = quotedRule.copy() | qi::raw[*~qi::char_(" ,\r\n")];
+    // Fields are separated by any number of spaces more than one.
+    fieldEnd = " ,\r\n";
+    delimiter = ' ';
   }
   else // TSV.
   {
-    // Match all characters that are not '\t', '\r', or '\n'.
-    stringRule = quotedRule.copy() | qi::raw[*~qi::char_("\t\r\n")];
+    // Fields are separated by a tab character, possibly with whitespace on
+    // either side.
+    fieldEnd = "\t\r\n";
+    delimiter = '\t';
   }
+}
 
-  if (extension == "csv")
+void LoadCSV::CheckOpen()
+{
+  if (!inFile->is_open())
   {
-    // Extract a single comma as the delimiter, catching whitespace on either
-    // side.
-    delimiterRule = qi::raw[(*qi::char_(" ") >> qi::char_(",") >>
-        *qi::char_(" "))];
+    std::ostringstream oss;
+    oss << "Cannot open file '" << filename << "'. " << std::endl;
+    throw std::runtime_error(oss.str());
   }
-  else if (extension == "txt")
+
+  inFile->unsetf(std::ios::skipws);
+}
+
+void LoadCSV::Rewind()
+{
+  if (compression == Compression::none)
   {
-    // This one is a little more difficult, we need to catch any number of
-    // spaces more than one.
-    delimiterRule = qi::raw[+qi::char_(" ")];
+    inFile->clear();
+    inFile->seekg(0, std::ios::beg);
   }
-  else // TSV.
+  else
   {
-    // Catch a tab character, possibly with whitespace on either side.
-    delimiterRule = qi::raw[(*qi::char_(" ") >> qi::char_("\t") >>
-        *qi::char_(" "))];
+    inFile.reset(new CompressedInputStream(filename, compression));
+    CheckOpen();
   }
+  buffer.clear();
+  bufferStart = 0;
 }
 
-void LoadCSV::CheckOpen()
+bool LoadCSV::ReadLines(std::vector<boost::string_view>& lines)
 {
-  if (!inFile.is_open())
+  lines.clear();
+
+  // Drop the lines that were already returned, and read until the buffer holds
+  // at least one whole line (or the end of the file is reached).
+  buffer.erase(0, bufferStart);
+  size_t end = 0;
+  while (true)
   {
-    std::ostringstream oss;
-    oss << "Cannot open file '" << filename << "'. " << std::endl;
-    throw std::runtime_error(oss.str());
+    const size_t oldSize = buffer.size();
+    buffer.resize(oldSize + blockSize);
+    inFile->read(&buffer[oldSize], blockSize);
+    buffer.resize(oldSize + inFile->gcount());
+
+    const size_t lastNewline = buffer.rfind('\n');
+    if (lastNewline != std::string::npos)
+    {
+      end = lastNewline + 1;
+      break;
+    }
+    else if (inFile->bad())
+    {
+      throw std::runtime_error("Cannot read file '" + filename + "'; the file "
+          "may be truncated or corrupt.");
+    }
+    else if (!*inFile)
+    {
+      // The last line may not end with a newline.
+      end = buffer.size();
+      break;
+    }
+  }
+
+  size_t begin = 0;
+  while (begin < end)
+  {
+    size_t newline = buffer.find('\n', begin);
+    if (newline == std::string::npos || newline > end)
+      newline = end;
+
+    lines.emplace_back(buffer.data() + begin, newline - begin);
+    begin = newline + 1;
   }
 
-  inFile.unsetf(std::ios::skipws);
+  bufferStart = end;
+  return !lines.empty();
+}
+
+void LoadCSV::SplitLine(boost::string_view line,
+                        std::vector<boost::string_view>& fields) const
+{
+  fields.clear();
+  line = Trim(line);
+
+  size_t pos = 0;
+  while (true)
+  {
+    // A field is a quoted string, if the quotes are closed; otherwise it is
+    // every character up to the end of the field.
+    const size_t begin = pos;
+    bool quoted = false;
+    if (pos < line.size() && (line[pos] == '"' || line[pos] == '\''))
+    {
+      const char quote = line[pos];
+      for (size_t i = pos + 1; i < line.size(); ++i)
+      {
+        if (line[i] != quote)
+          continue;
+
+        // A doubled quote stands for a quote.
+        if (i + 1 < line.size() && line[i + 1] == quote)
+        {
+          ++i;
+          continue;
+        }
+
+        pos = i + 1;
+        quoted = true;
+        break;
+      }
+    }
+
+    if (!quoted)
+    {
+      while (pos < line.size() && fieldEnd.find(line[pos]) == std::string::npos)
+        ++pos;
+    }
+
+    fields.push_back(Trim(line.substr(begin, pos - begin)));
+
+    // The field must be followed by a delimiter; anything else ends the line.
+    size_t next = pos;
+    while (next < line.size() && line[next] == ' ')
+      ++next;
+
+    if (delimiter != ' ')
+    {
+      if (next == line.size() || line[next] != delimiter)
+        break;
+
+      ++next;
+      while (next < line.size() && line[next] == ' ')
+        ++next;
+    }
+    else if (next == pos)
+    {
+      break;
+    }
+
+    pos = next;
+  }
+}
+
+void LoadCSV::SplitLines(
+    const std::vector<boost::string_view>& lines,
+    std::vector<std::vector<boost::string_view>>& fields) const
+{
+  if (fields.size() < lines.size())
+    fields.resize(lines.size());
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) lines.size(); ++i)
+    SplitLine(lines[i], fields[i]);
 }
 
 } // namespace data
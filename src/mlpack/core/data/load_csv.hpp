@@ -12,16 +12,15 @@
 #ifndef MLPACK_CORE_DATA_LOAD_CSV_HPP
 #define MLPACK_CORE_DATA_LOAD_CSV_HPP
 
-#include <boost/spirit/include/qi.hpp>
-#include <boost/algorithm/string/trim.hpp>
-
 #include <mlpack/core.hpp>
 #include <mlpack/core/util/log.hpp>
+#include <mlpack/core/boost_backport/boost_backport_string_view.hpp>
 
 #include <set>
 #include <string>
 
 #include "extension.hpp"
+#include "compressed_stream.hpp"
 #include "format.hpp"
 #include "dataset_mapper.hpp"
 
@@ -29,16 +28,25 @@ namespace mlpack {
 namespace data {
 
 /**
- *Load the csv file.This class use boost::spirit
- *to implement the parser, please refer to following link
- *http://theboostcpplibraries.com/boost.spirit for quick review.
+ * Load the csv file.  The file is read in large blocks which end on line
+ * boundaries, and the lines of each block are split into fields in parallel
+ * (when OpenMP is available).  A field is either a quoted string ("string" or
+ * 'string', where a doubled quote stands for a quote), or a sequence of any
+ * characters other than the delimiter; whitespace around the fields is
+ * removed.  The dimensions are split into one group per thread, and each group
+ * is mapped by its own copy of the DatasetMapper, which sees the fields of its
+ * dimensions in the order of the file; so the mappings are the same no matter
+ * how many threads are used.
  */
 class LoadCSV
 {
  public:
   /**
-   * Construct the LoadCSV object on the given file.  This will construct the
-   * rules necessary for loading and attempt to open the file.
+   * Construct the LoadCSV object on the given file.  This will set the
+   * delimiters for the type of the file and attempt to open the file.  If the
+   * file is compressed (see FileCompression()), the type is given by the
+   * extension before the extension of the compression, and the file is
+   * decompressed while it is read.
    */
   LoadCSV(const std::string& file);
 
@@ -77,63 +85,46 @@ class LoadCSV
   template<typename T, typename MapPolicy>
   void GetMatrixSize(size_t& rows, size_t& cols, DatasetMapper<MapPolicy>& info)
   {
-    using namespace boost::spirit;
-
     // Take a pass through the file.  If the DatasetMapper policy requires it,
     // we will pass everything string through MapString().  This might be useful
     // if, e.g., the MapPolicy needs to find which dimensions are numeric or
     // categorical.
 
-    // Reset to the start of the file.
-    inFile.clear();
-    inFile.seekg(0, std::ios::beg);
+    // First, count the number of rows in the file (this is the dimensionality),
+    // and extract the number of columns from the first line.
+    Rewind();
     rows = 0;
     cols = 0;
 
-    // First, count the number of rows in the file (this is the dimensionality).
-    std::string line;
-    while (std::getline(inFile, line))
+    std::vector<boost::string_view> lines;
+    std::vector<boost::string_view> fields;
+    while (ReadLines(lines))
     {
-      ++rows;
+      if (rows == 0)
+      {
+        SplitLine(lines[0], fields);
+        cols = fields.size();
+      }
+
+      rows += lines.size();
     }
     info = DatasetMapper<MapPolicy>(rows);
 
-    // Now, jump back to the beginning of the file.
-    inFile.clear();
-    inFile.seekg(0, std::ios::beg);
-    rows = 0;
-
-    while (std::getline(inFile, line))
+    // Each line is a dimension, so the first pass can only start once the
+    // number of lines is known.
+    if (MapPolicy::NeedsFirstPass)
     {
-      ++rows;
-      // Remove whitespace from either side.
-      boost::trim(line);
+      std::vector<DatasetMapper<MapPolicy>> threadInfo(NumThreads(), info);
 
-      if (rows == 1)
+      Rewind();
+      size_t line = 0;
+      while (ReadLines(lines))
       {
-        // Extract the number of columns.
-        auto findColSize = [&cols](iter_type) { ++cols; };
-        qi::parse(line.begin(), line.end(),
-            stringRule[findColSize] % delimiterRule);
+        FirstPass<T>(lines, line, false, threadInfo);
+        line += lines.size();
       }
 
-      // I guess this is technically a second pass, but that's ok... still the
-      // same idea...
-      if (MapPolicy::NeedsFirstPass)
-      {
-        // In this case we must pass everything we parse to the MapPolicy.
-        auto firstPassMap = [&](const iter_type& iter)
-        {
-          std::string str(iter.begin(), iter.end());
-          boost::trim(str);
-
-          info.template MapFirstPass<T>(std::move(str), rows - 1);
-        };
-
-        // Now parse the line.
-        qi::parse(line.begin(), line.end(),
-            stringRule[firstPassMap] % delimiterRule);
-      }
+      MergeFirstPass(info, threadInfo);
     }
   }
 
@@ -152,66 +143,241 @@ class LoadCSV
                               size_t& cols,
                               DatasetMapper<MapPolicy>& info)
   {
-    using namespace boost::spirit;
-
     // Take a pass through the file.  If the DatasetMapper policy requires it,
     // we will pass everything string through MapString().  This might be useful
     // if, e.g., the MapPolicy needs to find which dimensions are numeric or
     // categorical.
-
-    // Reset to the start of the file.
-    inFile.clear();
-    inFile.seekg(0, std::ios::beg);
+    Rewind();
     rows = 0;
     cols = 0;
 
-    std::string line;
-    while (std::getline(inFile, line))
+    std::vector<boost::string_view> lines;
+    std::vector<boost::string_view> fields;
+    std::vector<DatasetMapper<MapPolicy>> threadInfo;
+    while (ReadLines(lines))
     {
-      ++cols;
-      // Remove whitespace from either side.
-      boost::trim(line);
-
-      if (cols == 1)
+      if (cols == 0)
       {
         // Extract the number of dimensions.
-        auto findRowSize = [&rows](iter_type) { ++rows; };
-        qi::parse(line.begin(), line.end(),
-            stringRule[findRowSize] % delimiterRule);
+        SplitLine(lines[0], fields);
+        rows = fields.size();
 
         // Now that we know the dimensionality, initialize the DatasetMapper.
         info.SetDimensionality(rows);
+        if (MapPolicy::NeedsFirstPass)
+          threadInfo.assign(NumThreads(), info);
       }
 
       // If we need to do a first pass for the DatasetMapper, do it.
       if (MapPolicy::NeedsFirstPass)
+        FirstPass<T>(lines, cols, true, threadInfo);
+
+      cols += lines.size();
+    }
+
+    if (MapPolicy::NeedsFirstPass && !threadInfo.empty())
+      MergeFirstPass(info, threadInfo);
+  }
+
+ private:
+  /**
+   * Check whether or not the file has successfully opened; throw an exception
+   * if not.
+   */
+  void CheckOpen();
+
+  //! Go back to the start of the file (a compressed file is opened again, since
+  //! it cannot seek).
+  void Rewind();
+
+  /**
+   * Read the next block of the file and split it into lines.  The views refer
+   * to the internal buffer, so they are valid until the next call.  Returns
+   * false if there are no more lines.
+   *
+   * @param lines Vector to store the lines in.
+   */
+  bool ReadLines(std::vector<boost::string_view>& lines);
+
+  /**
+   * Split the given line into fields, without the surrounding whitespace.
+   *
+   * @param line The line to split.
+   * @param fields Vector to store the fields in.
+   */
+  void SplitLine(boost::string_view line,
+                 std::vector<boost::string_view>& fields) const;
+
+  /**
+   * Split each of the given lines into fields, in parallel.  The size of the
+   * fields vector may be larger than the number of lines.
+   *
+   * @param lines The lines to split.
+   * @param fields Vector to store the fields of each line in.
+   */
+  void SplitLines(const std::vector<boost::string_view>& lines,
+                  std::vector<std::vector<boost::string_view>>& fields) const;
+
+  //! Get the number of threads that may be used for parsing.
+  static size_t NumThreads()
+  {
+    #ifdef HAS_OPENMP
+      return omp_get_max_threads();
+    #else
+      return 1;
+    #endif
+  }
+
+  /**
+   * Pass the fields of the given lines to the DatasetMapper of each thread for
+   * the first pass.
+   *
+   * @param lines The lines to pass.
+   * @param firstLine Index of the first of the lines in the file.
+   * @param transpose If true, each line is a point; otherwise, each line is a
+   *     dimension.
+   * @param threadInfo DatasetMapper objects of the threads.
+   */
+  template<typename T, typename MapPolicy>
+  void FirstPass(const std::vector<boost::string_view>& lines,
+                 const size_t firstLine,
+                 const bool transpose,
+                 std::vector<DatasetMapper<MapPolicy>>& threadInfo) const
+  {
+    #pragma omp parallel
+    {
+      size_t thread = 0;
+      #ifdef HAS_OPENMP
+        thread = omp_get_thread_num();
+      #endif
+      DatasetMapper<MapPolicy>& info = threadInfo[thread];
+      std::vector<boost::string_view> fields;
+
+      #pragma omp for schedule(static)
+      for (omp_size_t i = 0; i < (omp_size_t) lines.size(); ++i)
       {
-        size_t dim = 0;
+        SplitLine(lines[i], fields);
 
-        // In this case we must pass everything we parse to the MapPolicy.
-        auto firstPassMap = [&](const iter_type& iter)
+        // Lines with too many fields are reported while parsing.
+        const size_t numFields = transpose ?
+            std::min(fields.size(), info.Dimensionality()) : fields.size();
+        for (size_t j = 0; j < numFields; ++j)
         {
-          std::string str(iter.begin(), iter.end());
-          boost::trim(str);
-
-          info.template MapFirstPass<T>(std::move(str), dim++);
-        };
+          info.template MapFirstPass<T>(fields[j].to_string(),
+              transpose ? j : firstLine + i);
+        }
+      }
+    }
+  }
 
-        // Now parse the line.
-        qi::parse(line.begin(), line.end(),
-            stringRule[firstPassMap] % delimiterRule);
+  /**
+   * Set the dimensions that any of the threads found to be categorical in the
+   * first pass to categorical.
+   *
+   * @param info DatasetMapper to store the result in.
+   * @param threadInfo DatasetMapper objects of the threads.
+   */
+  template<typename MapPolicy>
+  static void MergeFirstPass(
+      DatasetMapper<MapPolicy>& info,
+      const std::vector<DatasetMapper<MapPolicy>>& threadInfo)
+  {
+    for (size_t d = 0; d < info.Dimensionality(); ++d)
+    {
+      for (size_t t = 0; t < threadInfo.size(); ++t)
+      {
+        if (threadInfo[t].Type(d) == Datatype::categorical)
+          info.Type(d) = Datatype::categorical;
       }
     }
   }
 
- private:
-  using iter_type = boost::iterator_range<std::string::iterator>;
+  /**
+   * Create the DatasetMapper objects of the groups of dimensions that are
+   * mapped in parallel: dimension d belongs to group (d % groupInfo.size()).
+   *
+   * @param info DatasetMapper to copy.
+   * @param groupInfo Vector to store the DatasetMapper of each group in.
+   */
+  template<typename MapPolicy>
+  static void InitGroups(const DatasetMapper<MapPolicy>& info,
+                         std::vector<DatasetMapper<MapPolicy>>& groupInfo)
+  {
+    const size_t groups = std::max(std::min(NumThreads(),
+        info.Dimensionality()), (size_t) 1);
+    groupInfo.assign(groups, info);
+  }
 
   /**
-   * Check whether or not the file has successfully opened; throw an exception
-   * if not.
+   * Map the fields of the given lines into the matrix.  The groups of
+   * dimensions are mapped in parallel, each with its own DatasetMapper, and
+   * each group maps its fields in the order of the file.
+   *
+   * @param fields The fields of each line.
+   * @param numLines Number of lines to map.
+   * @param firstLine Index of the first of the lines in the file.
+   * @param transpose If true, each line is a point; otherwise, each line is a
+   *     dimension.
+   * @param groupInfo DatasetMapper objects of the groups.
+   * @param inout Matrix to load into.
    */
-  void CheckOpen();
+  template<typename T, typename MapPolicy>
+  static void MapFields(
+      const std::vector<std::vector<boost::string_view>>& fields,
+      const size_t numLines,
+      const size_t firstLine,
+      const bool transpose,
+      std::vector<DatasetMapper<MapPolicy>>& groupInfo,
+      arma::Mat<T>& inout)
+  {
+    const size_t groups = groupInfo.size();
+
+    #pragma omp parallel for schedule(dynamic)
+    for (omp_size_t g = 0; g < (omp_size_t) groups; ++g)
+    {
+      DatasetMapper<MapPolicy>& info = groupInfo[g];
+      if (transpose)
+      {
+        for (size_t i = 0; i < numLines; ++i)
+        {
+          for (size_t row = g; row < inout.n_rows; row += groups)
+          {
+            inout(row, firstLine + i) = info.template MapString<T>(
+                fields[i][row].to_string(), row);
+          }
+        }
+      }
+      else
+      {
+        // Find the first line whose dimension belongs to this group.
+        const size_t start = (g + groups - firstLine % groups) % groups;
+        for (size_t i = start; i < numLines; i += groups)
+        {
+          const size_t row = firstLine + i;
+          for (size_t col = 0; col < inout.n_cols; ++col)
+          {
+            inout(row, col) = info.template MapString<T>(
+                fields[i][col].to_string(), row);
+          }
+        }
+      }
+    }
+  }
+
+  /**
+   * Take the type and the mappings of each dimension from the DatasetMapper of
+   * its group.
+   *
+   * @param info DatasetMapper to store the result in.
+   * @param groupInfo DatasetMapper objects of the groups.
+   */
+  template<typename MapPolicy>
+  static void MergeGroups(DatasetMapper<MapPolicy>& info,
+                          std::vector<DatasetMapper<MapPolicy>>& groupInfo)
+  {
+    for (size_t d = 0; d < info.Dimensionality(); ++d)
+      info.TakeDimension(groupInfo[d % groupInfo.size()], d);
+  }
 
   /**
    * Parse a non-transposed matrix.
@@ -223,8 +389,6 @@ class LoadCSV
   void NonTransposeParse(arma::Mat<T>& inout,
                          DatasetMapper<PolicyType>& infoSet)
   {
-    using namespace boost::spirit;
-
     // Get the size of the matrix.
     size_t rows, cols;
     GetMatrixSize<T>(rows, cols, infoSet);
@@ -232,55 +396,38 @@ class LoadCSV
     // Set up output matrix.
     inout.set_size(rows, cols);
     size_t row = 0;
-    size_t col = 0;
 
     // Reset file position.
-    std::string line;
-    inFile.clear();
-    inFile.seekg(0, std::ios::beg);
-
-    auto setCharClass = [&](iter_type const &iter)
-    {
-      std::string str(iter.begin(), iter.end());
-      if (str == "\t")
-      {
-        str.clear();
-      }
-      boost::trim(str);
+    Rewind();
 
-      inout(row, col++) = infoSet.template MapString<T>(std::move(str), row);
-    };
+    std::vector<DatasetMapper<PolicyType>> groupInfo;
+    InitGroups(infoSet, groupInfo);
 
-    while (std::getline(inFile, line))
+    std::vector<boost::string_view> lines;
+    std::vector<std::vector<boost::string_view>> fields;
+    while (ReadLines(lines))
     {
-      // Remove whitespace from either side.
-      boost::trim(line);
-
-      // Parse the numbers from a line (ex: 1,2,3,4); if the parser finds a
-      // number it will execute the setNum function.
-      const bool canParse = qi::parse(line.begin(), line.end(),
-          stringRule[setCharClass] % delimiterRule);
+      // Split the lines in parallel.
+      SplitLines(lines, fields);
 
-      // Make sure we got the right number of rows.
-      if (col != cols)
+      // Make sure we got the right number of columns.
+      for (size_t i = 0; i < lines.size(); ++i)
       {
-        std::ostringstream oss;
-        oss << "LoadCSV::NonTransposeParse(): wrong number of dimensions ("
-            << col << ") on line " << row << "; should be " << cols
-            << " dimensions.";
-        throw std::runtime_error(oss.str());
-      }
-
-      if (!canParse)
-      {
-        std::ostringstream oss;
-        oss << "LoadCSV::NonTransposeParse(): parsing error on line " << col
-            << "!";
-        throw std::runtime_error(oss.str());
+        if (fields[i].size() != cols)
+        {
+          std::ostringstream oss;
+          oss << "LoadCSV::NonTransposeParse(): wrong number of dimensions ("
+              << fields[i].size() << ") on line " << (row + i) << "; should be "
+              << cols << " dimensions.";
+          throw std::runtime_error(oss.str());
+        }
       }
 
-      ++row; col = 0;
+      MapFields(fields, lines.size(), row, false, groupInfo, inout);
+      row += lines.size();
     }
+
+    MergeGroups(infoSet, groupInfo);
   }
 
   /**
@@ -292,8 +439,6 @@ class LoadCSV
   template<typename T, typename PolicyType>
   void TransposeParse(arma::Mat<T>& inout, DatasetMapper<PolicyType>& infoSet)
   {
-    using namespace boost::spirit;
-
     // Get matrix size.  This also initializes infoSet correctly.
     size_t rows, cols;
     GetTransposeMatrixSize<T>(rows, cols, infoSet);
@@ -302,72 +447,59 @@ class LoadCSV
     inout.set_size(rows, cols);
 
     // Initialize auxiliary variables.
-    size_t row = 0;
     size_t col = 0;
-    std::string line;
-    inFile.clear();
-    inFile.seekg(0, std::ios::beg);
-
-    /**
-     * This is the parse rule for strings.  When we get a string we have to pass
-     * it to the DatasetMapper.
-     */
-    auto parseString = [&](iter_type const &iter)
-    {
-      // All parsed values must be mapped.
-      std::string str(iter.begin(), iter.end());
-      boost::trim(str);
+    Rewind();
 
-      inout(row, col) = infoSet.template MapString<T>(std::move(str), row);
-      ++row;
-    };
+    std::vector<DatasetMapper<PolicyType>> groupInfo;
+    InitGroups(infoSet, groupInfo);
 
-    while (std::getline(inFile, line))
+    std::vector<boost::string_view> lines;
+    std::vector<std::vector<boost::string_view>> fields;
+    while (ReadLines(lines))
     {
-      // Remove whitespace from either side.
-      boost::trim(line);
-
-      // Reset the row we are looking at.  (Remember this is transposed.)
-      row = 0;
-
-      // Now use boost::spirit to parse the characters of the line;
-      // parseString() will be called when a token is detected.
-      const bool canParse = qi::parse(line.begin(), line.end(),
-          stringRule[parseString] % delimiterRule);
+      // Split the lines in parallel.
+      SplitLines(lines, fields);
 
       // Make sure we got the right number of rows.
-      if (row != rows)
+      for (size_t i = 0; i < lines.size(); ++i)
       {
-        std::ostringstream oss;
-        oss << "LoadCSV::TransposeParse(): wrong number of dimensions (" << row
-            << ") on line " << col << "; should be " << rows << " dimensions.";
-        throw std::runtime_error(oss.str());
-      }
-
-      if (!canParse)
-      {
-        std::ostringstream oss;
-        oss << "LoadCSV::TransposeParse(): parsing error on line " << col
-            << "!";
-        throw std::runtime_error(oss.str());
+        if (fields[i].size() != rows)
+        {
+          std::ostringstream oss;
+          oss << "LoadCSV::TransposeParse(): wrong number of dimensions ("
+              << fields[i].size() << ") on line " << (col + i) << "; should be "
+              << rows << " dimensions.";
+          throw std::runtime_error(oss.str());
+        }
       }
 
-      // Increment the column index.
-      ++col;
+      // All parsed values must be mapped.
+      MapFields(fields, lines.size(), col, true, groupInfo, inout);
+      col += lines.size();
     }
+
+    MergeGroups(infoSet, groupInfo);
   }
 
-  //! Spirit rule for parsing.
-  boost::spirit::qi::rule<std::string::iterator, iter_type()> stringRule;
-  //! Spirit rule for delimiters (i.e. ',' for CSVs).
-  boost::spirit::qi::rule<std::string::iterator, iter_type()> delimiterRule;
+  //! Characters which end an unquoted field.
+  std::string fieldEnd;
+  //! The delimiter between fields; it may be surrounded by spaces (for text
+  //! files, the delimiter is one or more spaces).
+  char delimiter;
 
+  //! Compression of file.
+  Compression compression;
   //! Extension (type) of file.
   std::string extension;
   //! Name of file.
   std::string filename;
-  //! Opened stream for reading.
-  std::ifstream inFile;
+  //! Opened stream for reading; the file may be compressed.
+  std::unique_ptr<CompressedInputStream> inFile;
+
+  //! The block of the file being parsed.
+  std::string buffer;
+  //! Start of the lines in the buffer which have not been returned yet.
+  size_t bufferStart;
 };
 
 } // namespace data
@@ -85,7 +85,8 @@ bool LoadImage(const std::string& filename,
 
   info.Width() = tempWidth;
   info.Height() = tempHeight;
-  info.Channels() = tempChannels;
+  // The image was converted to the channels we asked for.
+  info.Channels() = (info.Channels() == 1) ? 1 : 3;
 
   // Copy image into armadillo Mat.
   matrix = arma::Mat<unsigned char>(image, info.Width() * info.Height() *
@@ -96,6 +97,161 @@ bool LoadImage(const std::string& filename,
   return true;
 }
 
+/**
+ * Resize an image with bilinear interpolation.  The pixels are stored row by
+ * row, with the channels of each pixel next to each other (as STB does).
+ */
+static void ResizeImage(const unsigned char* image,
+                        const size_t width,
+                        const size_t height,
+                        const size_t channels,
+                        unsigned char* output,
+                        const size_t newWidth,
+                        const size_t newHeight)
+{
+  // The centers of the corner pixels of both images are aligned.
+  const double xScale = double(width) / newWidth;
+  const double yScale = double(height) / newHeight;
+  for (size_t y = 0; y < newHeight; ++y)
+  {
+    const double sy = std::min(std::max((y + 0.5) * yScale - 0.5, 0.0),
+        double(height - 1));
+    const size_t y0 = (size_t) sy;
+    const size_t y1 = std::min(y0 + 1, height - 1);
+    const double fy = sy - y0;
+
+    for (size_t x = 0; x < newWidth; ++x)
+    {
+      const double sx = std::min(std::max((x + 0.5) * xScale - 0.5, 0.0),
+          double(width - 1));
+      const size_t x0 = (size_t) sx;
+      const size_t x1 = std::min(x0 + 1, width - 1);
+      const double fx = sx - x0;
+
+      for (size_t c = 0; c < channels; ++c)
+      {
+        const double top = (1 - fx) * image[(y0 * width + x0) * channels + c] +
+            fx * image[(y0 * width + x1) * channels + c];
+        const double bottom = (1 - fx) *
+            image[(y1 * width + x0) * channels + c] +
+            fx * image[(y1 * width + x1) * channels + c];
+        output[(y * newWidth + x) * channels + c] =
+            (unsigned char) std::lround((1 - fy) * top + fy * bottom);
+      }
+    }
+  }
+}
+
+bool LoadImages(const std::vector<std::string>& files,
+                arma::Mat<unsigned char>& matrix,
+                ImageInfo& info,
+                const size_t width,
+                const size_t height,
+                const bool fatal)
+{
+  std::ostringstream oss;
+  if (files.size() == 0)
+    oss << "Load(): vector of image files is empty." << std::endl;
+
+  for (size_t i = 0; i < files.size() && oss.str().empty(); ++i)
+  {
+    if (!ImageFormatSupported(files[i]))
+    {
+      oss << "Load(): file type " << Extension(files[i]) << " not supported. ";
+      oss << "Currently it supports: ";
+      for (auto extension : loadFileTypes)
+        oss << " " << extension;
+      oss << "." << std::endl;
+    }
+  }
+
+  // Unless the images are resized, the size of the first image (read from its
+  // header) is the size of all of them.
+  const bool resize = (width != 0 && height != 0);
+  size_t imageWidth = width, imageHeight = height;
+  if (oss.str().empty() && !resize)
+  {
+    int tempWidth, tempHeight, tempChannels;
+    if (stbi_info(files[0].c_str(), &tempWidth, &tempHeight, &tempChannels))
+    {
+      imageWidth = tempWidth;
+      imageHeight = tempHeight;
+    }
+    else
+    {
+      oss << "Load(): failed to load image '" << files[0] << "': "
+          << stbi_failure_reason() << std::endl;
+    }
+  }
+
+  if (!oss.str().empty())
+  {
+    if (fatal)
+      Log::Fatal << oss.str();
+    else
+      Log::Warn << oss.str();
+
+    return false;
+  }
+
+  // Decode the images in parallel, straight into their columns.
+  const size_t channels = (info.Channels() == 1) ? 1 : 3;
+  matrix.set_size(imageWidth * imageHeight * channels, files.size());
+  std::vector<std::string> errors(files.size());
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) files.size(); ++i)
+  {
+    int tempWidth, tempHeight, tempChannels;
+    unsigned char* image = stbi_load(files[i].c_str(), &tempWidth,
+        &tempHeight, &tempChannels, (channels == 1) ? STBI_grey : STBI_rgb);
+    if (!image)
+    {
+      errors[i] = "Load(): failed to load image '" + files[i] + "': " +
+          stbi_failure_reason();
+      continue;
+    }
+
+    if ((size_t) tempWidth == imageWidth && (size_t) tempHeight == imageHeight)
+    {
+      std::copy(image, image + matrix.n_rows, matrix.colptr(i));
+    }
+    else if (resize)
+    {
+      ResizeImage(image, tempWidth, tempHeight, channels, matrix.colptr(i),
+          imageWidth, imageHeight);
+    }
+    else
+    {
+      std::ostringstream error;
+      error << "Load(): image '" << files[i] << "' has size " << tempWidth
+          << " x " << tempHeight << ", but image '" << files[0] << "' has "
+          << "size " << imageWidth << " x " << imageHeight << ".";
+      errors[i] = error.str();
+    }
+
+    free(image);
+  }
+
+  for (size_t i = 0; i < errors.size(); ++i)
+  {
+    if (!errors[i].empty())
+    {
+      if (fatal)
+        Log::Fatal << errors[i] << std::endl;
+      else
+        Log::Warn << errors[i] << std::endl;
+
+      return false;
+    }
+  }
+
+  info.Width() = imageWidth;
+  info.Height() = imageHeight;
+  info.Channels() = channels;
+  return true;
+}
+
 } // namespace data
 } // namespace mlpack
 
@@ -123,6 +279,27 @@ bool LoadImage(const std::string& /* filename */,
   return false;
 }
 
+bool LoadImages(const std::vector<std::string>& /* files */,
+                arma::Mat<unsigned char>& /* matrix */,
+                ImageInfo& /* info */,
+                const size_t /* width */,
+                const size_t /* height */,
+                const bool fatal)
+{
+  if (fatal)
+  {
+    Log::Fatal << "Load(): mlpack was not compiled with STB support, so images "
+        << "cannot be loaded!" << std::endl;
+  }
+  else
+  {
+    Log::Warn << "Load(): mlpack was not compiled with STB support, so images "
+        << "cannot be loaded!" << std::endl;
+  }
+
+  return false;
+}
+
 } // namespace data
 } // namespace mlpack
 
@@ -15,18 +15,22 @@
 // In case it hasn't already been included.
 
 #include <exception>
+#include <sstream>
 #include <algorithm>
 #include <mlpack/core/util/timers.hpp>
 
 #include "load_csv.hpp"
 #include "load.hpp"
 #include "extension.hpp"
+#include "binary_dataset.hpp"
+#include "compressed_stream.hpp"
 
 #include <boost/algorithm/string/trim.hpp>
 #include <boost/tokenizer.hpp>
 #include <boost/algorithm/string.hpp>
 
 #include "load_arff.hpp"
+#include "load_parquet.hpp"
 
 namespace mlpack {
 namespace data {
@@ -92,17 +96,42 @@ bool Load(const std::string& filename,
 {
   Timer::Start("loading_data");
 
-  // Get the extension.
-  std::string extension = Extension(filename);
+  // Get the extension; the type of a compressed file is given by the
+  // extension before the extension of the compression.
+  const Compression compression = FileCompression(filename);
+  std::string extension = Extension(UncompressedName(filename));
 
-  // Catch nonexistent files by opening the stream ourselves.
-  std::fstream stream;
+  // Only the formats that Armadillo reads from a stream can be compressed.
+  if (!CheckCompression(filename, compression, extension != "mlb" &&
+      extension != "parquet" && extension != "h5" && extension != "hdf5" &&
+      extension != "hdf" && extension != "he5", fatal))
+  {
+    Timer::Stop("loading_data");
+    return false;
+  }
+
+  // Catch nonexistent files by opening the stream ourselves.  Armadillo seeks
+  // in the stream, so a compressed file is decompressed into memory.
+  std::fstream fileStream;
+  std::stringstream memoryStream;
+  bool opened;
+  if (compression == Compression::none)
+  {
 #ifdef  _WIN32 // Always open in binary mode on Windows.
-  stream.open(filename.c_str(), std::fstream::in | std::fstream::binary);
+    fileStream.open(filename.c_str(), std::fstream::in | std::fstream::binary);
 #else
-  stream.open(filename.c_str(), std::fstream::in);
+    fileStream.open(filename.c_str(), std::fstream::in);
 #endif
-  if (!stream.is_open())
+    opened = fileStream.is_open();
+  }
+  else
+  {
+    opened = DecompressFile(filename, compression, memoryStream);
+  }
+  std::iostream& stream = (compression == Compression::none) ?
+      static_cast<std::iostream&>(fileStream) : memoryStream;
+
+  if (!opened)
   {
     Timer::Stop("loading_data");
     if (fatal)
@@ -114,6 +143,85 @@ bool Load(const std::string& filename,
     return false;
   }
 
+  // The mlpack binary dataset format is read without Armadillo, directly
+  // into the matrix.
+  if (extension == "mlb")
+  {
+    Log::Info << "Loading '" << filename << "' as mlpack binary dataset.  "
+        << std::flush;
+    try
+    {
+      LoadBinaryDataset(filename, matrix);
+    }
+    catch (std::exception& e)
+    {
+      Log::Info << std::endl;
+      Timer::Stop("loading_data");
+      if (fatal)
+        Log::Fatal << e.what() << std::endl;
+      else
+        Log::Warn << e.what() << std::endl;
+
+      return false;
+    }
+
+    // The matrix is stored with one column per point, so it only has to be
+    // transposed if transposition was not requested.
+    bool success = true;
+    if (!transpose)
+      success = inplace_transpose(matrix, fatal);
+
+    Log::Info << "Size is " << (transpose ? matrix.n_cols : matrix.n_rows)
+        << " x " << (transpose ? matrix.n_rows : matrix.n_cols) << ".\n";
+
+    Timer::Stop("loading_data");
+    return success;
+  }
+
+  // Parquet files are read with the Parquet library.  Only numeric columns can
+  // be loaded without a DatasetInfo.
+  if (extension == "parquet")
+  {
+    Log::Info << "Loading '" << filename << "' as Parquet data.  "
+        << std::flush;
+    try
+    {
+      DatasetInfo info;
+      LoadParquet(filename, matrix, info);
+      for (size_t i = 0; i < info.Dimensionality(); ++i)
+      {
+        if (info.Type(i) == Datatype::categorical)
+        {
+          throw std::runtime_error("'" + filename + "' has categorical "
+              "columns; load it with a DatasetInfo!");
+        }
+      }
+    }
+    catch (std::exception& e)
+    {
+      Log::Info << std::endl;
+      Timer::Stop("loading_data");
+      if (fatal)
+        Log::Fatal << e.what() << std::endl;
+      else
+        Log::Warn << e.what() << std::endl;
+
+      return false;
+    }
+
+    // Like the mlpack binary dataset format, the matrix has one column per
+    // point.
+    bool success = true;
+    if (!transpose)
+      success = inplace_transpose(matrix, fatal);
+
+    Log::Info << "Size is " << (transpose ? matrix.n_cols : matrix.n_rows)
+        << " x " << (transpose ? matrix.n_rows : matrix.n_cols) << ".\n";
+
+    Timer::Stop("loading_data");
+    return success;
+  }
+
   bool unknownType = false;
   arma::file_type loadType;
   std::string stringType;
@@ -317,12 +425,21 @@ bool Load(const std::string& filename,
   // Get the extension and load as necessary.
   Timer::Start("loading_data");
 
-  // Get the extension.
-  std::string extension = Extension(filename);
+  // Get the extension; the type of a compressed file is given by the
+  // extension before the extension of the compression.
+  const Compression compression = FileCompression(filename);
+  std::string extension = Extension(UncompressedName(filename));
+
+  // Only CSV files are read as a stream.
+  if (!CheckCompression(filename, compression, extension == "csv" ||
+      extension == "tsv" || extension == "txt", fatal))
+  {
+    Timer::Stop("loading_data");
+    return false;
+  }
 
   // Catch nonexistent files by opening the stream ourselves.
-  std::fstream stream;
-  stream.open(filename.c_str(), std::fstream::in);
+  CompressedInputStream stream(filename, compression);
 
   if (!stream.is_open())
   {
@@ -355,6 +472,64 @@ bool Load(const std::string& filename,
       return false;
     }
   }
+  else if (extension == "mlb")
+  {
+    Log::Info << "Loading '" << filename << "' as mlpack binary dataset.  "
+        << std::flush;
+    try
+    {
+      LoadBinaryDataset(filename, matrix, info);
+
+      // The matrix is stored with one column per point.
+      if (!transpose)
+      {
+        if (!inplace_transpose(matrix, fatal))
+        {
+          Timer::Stop("loading_data");
+          return false;
+        }
+      }
+    }
+    catch (std::exception& e)
+    {
+      Timer::Stop("loading_data");
+      if (fatal)
+        Log::Fatal << e.what() << std::endl;
+      else
+        Log::Warn << e.what() << std::endl;
+
+      return false;
+    }
+  }
+  else if (extension == "parquet")
+  {
+    Log::Info << "Loading '" << filename << "' as Parquet data.  "
+        << std::flush;
+    try
+    {
+      LoadParquet(filename, matrix, info);
+
+      // The matrix has one column per point.
+      if (!transpose)
+      {
+        if (!inplace_transpose(matrix, fatal))
+        {
+          Timer::Stop("loading_data");
+          return false;
+        }
+      }
+    }
+    catch (std::exception& e)
+    {
+      Timer::Stop("loading_data");
+      if (fatal)
+        Log::Fatal << e.what() << std::endl;
+      else
+        Log::Warn << e.what() << std::endl;
+
+      return false;
+    }
+  }
   else if (extension == "arff")
   {
     Log::Info << "Loading '" << filename << "' as ARFF dataset.  "
@@ -411,17 +586,71 @@ bool Load(const std::string& filename,
 {
   Timer::Start("loading_data");
 
-  // Get the extension.
-  std::string extension = Extension(filename);
+  // Get the extension; the type of a compressed file is given by the
+  // extension before the extension of the compression.
+  const Compression compression = FileCompression(filename);
+  std::string extension = Extension(UncompressedName(filename));
 
-  // Catch nonexistent files by opening the stream ourselves.
-  std::fstream stream;
+  if (!CheckCompression(filename, compression, extension != "arff", fatal))
+  {
+    Timer::Stop("loading_data");
+    return false;
+  }
+
+  // ARFF files are parsed by our own loader, which loads transposed.
+  if (extension == "arff")
+  {
+    Log::Info << "Loading '" << filename << "' as ARFF dataset.  "
+        << std::flush;
+    try
+    {
+      DatasetInfo info;
+      LoadARFF(filename, matrix, info);
+    }
+    catch (std::exception& e)
+    {
+      Timer::Stop("loading_data");
+      if (fatal)
+        Log::Fatal << e.what() << std::endl;
+      else
+        Log::Warn << e.what() << std::endl;
+
+      return false;
+    }
+
+    Log::Info << "Size is " << (transpose ? matrix.n_cols : matrix.n_rows)
+        << " x " << (transpose ? matrix.n_rows : matrix.n_cols) << ".\n";
+
+    bool success = true;
+    if (!transpose)
+      success = inplace_transpose(matrix, fatal);
+
+    Timer::Stop("loading_data");
+    return success;
+  }
+
+  // Catch nonexistent files by opening the stream ourselves.  Armadillo seeks
+  // in the stream, so a compressed file is decompressed into memory.
+  std::fstream fileStream;
+  std::stringstream memoryStream;
+  bool opened;
+  if (compression == Compression::none)
+  {
 #ifdef  _WIN32 // Always open in binary mode on Windows.
-  stream.open(filename.c_str(), std::fstream::in | std::fstream::binary);
+    fileStream.open(filename.c_str(), std::fstream::in | std::fstream::binary);
 #else
-  stream.open(filename.c_str(), std::fstream::in);
+    fileStream.open(filename.c_str(), std::fstream::in);
 #endif
-  if (!stream.is_open())
+    opened = fileStream.is_open();
+  }
+  else
+  {
+    opened = DecompressFile(filename, compression, memoryStream);
+  }
+  std::iostream& stream = (compression == Compression::none) ?
+      static_cast<std::iostream&>(fileStream) : memoryStream;
+
+  if (!opened)
   {
     Timer::Stop("loading_data");
     if (fatal)
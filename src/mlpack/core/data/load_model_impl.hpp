@@ -19,6 +19,7 @@
 #include <mlpack/core/util/timers.hpp>
 
 #include "extension.hpp"
+#include "compressed_stream.hpp"
 
 #include <boost/serialization/serialization.hpp>
 #include <boost/algorithm/string/trim.hpp>
@@ -39,9 +40,15 @@ bool Load(const std::string& filename,
           const bool fatal,
           format f)
 {
+  // The file is compressed if its extension is .gz or .zst; then the format is
+  // given by the extension before that.
+  const Compression compression = FileCompression(filename);
+  if (!CheckCompression(filename, compression, true, fatal))
+    return false;
+
   if (f == format::autodetect)
   {
-    std::string extension = Extension(filename);
+    std::string extension = Extension(UncompressedName(filename));
 
     if (extension == "xml")
       f = format::xml;
@@ -63,14 +70,11 @@ bool Load(const std::string& filename,
   }
 
   // Now load the given format.
-  std::ifstream ifs;
 #ifdef _WIN32 // Open non-text in binary mode on Windows.
-  if (f == format::binary)
-    ifs.open(filename, std::ifstream::in | std::ifstream::binary);
-  else
-    ifs.open(filename, std::ifstream::in);
+  CompressedInputStream ifs(filename, compression, (f == format::binary) ?
+      std::ifstream::in | std::ifstream::binary : std::ifstream::in);
 #else
-  ifs.open(filename, std::ifstream::in);
+  CompressedInputStream ifs(filename, compression, std::ifstream::in);
 #endif
 
   if (!ifs.is_open())
@@ -0,0 +1,66 @@
+/**
+ * @file core/data/load_parquet.hpp
+ *
+ * Load a dataset from a Parquet file.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_LOAD_PARQUET_HPP
+#define MLPACK_CORE_DATA_LOAD_PARQUET_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "dataset_mapper.hpp"
+
+namespace mlpack {
+namespace data {
+
+/**
+ * Load the given columns of a Parquet file as numeric and categorical
+ * features, using the DatasetInfo structure for mapping.  Each row of the file
+ * becomes a column (a point) of the matrix, and each of the given columns of
+ * the file becomes a dimension, in the given order; if no columns are given,
+ * every column of the file is loaded.  Only the given columns are read from the
+ * file, and the row groups of the file are decoded in parallel when OpenMP is
+ * available.
+ *
+ * Columns of floating-point, integer, or boolean type are numeric dimensions;
+ * their missing values are loaded as NaN (or 0, if eT is an integer type).
+ * Columns of string type (including dictionary-encoded strings) are
+ * categorical dimensions: every value is mapped with info.MapString(), in the
+ * order of the rows of the file, and missing values are mapped as empty
+ * strings.  Columns of any other type cannot be loaded.
+ *
+ * As with LoadARFF(), a pre-existing DatasetInfo object can be passed in, so
+ * that a test set is loaded with the same mappings as the training set; if its
+ * dimensionality does not match the number of loaded columns, a
+ * std::invalid_argument exception is thrown.  An empty DatasetInfo object is
+ * set to the right dimensionality.
+ *
+ * This is only available if mlpack was compiled with Apache Parquet support
+ * (that is, if HAS_PARQUET is defined); otherwise, std::runtime_error is
+ * always thrown.  std::runtime_error is also thrown if the file cannot be read
+ * or if one of the given columns does not exist.
+ *
+ * @param filename Name of Parquet file to load.
+ * @param matrix Matrix to load data into.
+ * @param info DatasetInfo object; can be default-constructed or pre-existing
+ *     from another call to LoadParquet().
+ * @param columns Names of the columns to load (default: all of the columns).
+ */
+template<typename eT, typename PolicyType>
+void LoadParquet(const std::string& filename,
+                 arma::Mat<eT>& matrix,
+                 DatasetMapper<PolicyType>& info,
+                 const std::vector<std::string>& columns =
+                     std::vector<std::string>());
+
+} // namespace data
+} // namespace mlpack
+
+// Include implementation.
+#include "load_parquet_impl.hpp"
+
+#endif
@@ -0,0 +1,389 @@
+/**
+ * @file core/data/load_parquet_impl.hpp
+ *
+ * Implementation of the LoadParquet() function.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_LOAD_PARQUET_IMPL_HPP
+#define MLPACK_CORE_DATA_LOAD_PARQUET_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "load_parquet.hpp"
+
+#ifdef HAS_PARQUET
+
+#include <arrow/api.h>
+#include <arrow/io/file.h>
+#include <parquet/arrow/reader.h>
+#include <parquet/exception.h>
+#include <algorithm>
+#include <limits>
+
+namespace mlpack {
+namespace data {
+
+namespace details {
+
+//! Return true if a column of the given type is loaded as a categorical
+//! dimension.
+inline bool IsParquetCategorical(const arrow::DataType& type)
+{
+  switch (type.id())
+  {
+    case arrow::Type::STRING:
+    case arrow::Type::BINARY:
+    case arrow::Type::LARGE_STRING:
+    case arrow::Type::LARGE_BINARY:
+      return true;
+    case arrow::Type::DICTIONARY:
+      return IsParquetCategorical(*static_cast<const arrow::DictionaryType&>(
+          type).value_type());
+    default:
+      return false;
+  }
+}
+
+//! Return true if a column of the given type is loaded as a numeric dimension.
+inline bool IsParquetNumeric(const arrow::DataType& type)
+{
+  switch (type.id())
+  {
+    case arrow::Type::BOOL:
+    case arrow::Type::INT8:
+    case arrow::Type::INT16:
+    case arrow::Type::INT32:
+    case arrow::Type::INT64:
+    case arrow::Type::UINT8:
+    case arrow::Type::UINT16:
+    case arrow::Type::UINT32:
+    case arrow::Type::UINT64:
+    case arrow::Type::FLOAT:
+    case arrow::Type::DOUBLE:
+      return true;
+    default:
+      return false;
+  }
+}
+
+//! Open the given Parquet file; throw std::runtime_error on failure.
+inline std::unique_ptr<parquet::arrow::FileReader> OpenParquetFile(
+    const std::string& filename)
+{
+  std::unique_ptr<parquet::arrow::FileReader> reader;
+  try
+  {
+    std::shared_ptr<arrow::io::ReadableFile> file;
+    PARQUET_ASSIGN_OR_THROW(file, arrow::io::ReadableFile::Open(filename));
+    PARQUET_THROW_NOT_OK(parquet::arrow::OpenFile(file,
+        arrow::default_memory_pool(), &reader));
+  }
+  catch (parquet::ParquetException& e)
+  {
+    throw std::runtime_error("Cannot open file '" + filename + "': " +
+        e.what());
+  }
+
+  return reader;
+}
+
+//! Copy the values of the given chunk of a numeric column into the given
+//! dimension of the matrix, starting at the given point.
+template<typename ArrayType, typename eT>
+void CopyParquetValues(const arrow::Array& chunk,
+                       arma::Mat<eT>& matrix,
+                       const size_t dimension,
+                       const size_t offset)
+{
+  const ArrayType& array = static_cast<const ArrayType&>(chunk);
+  for (int64_t i = 0; i < array.length(); ++i)
+  {
+    matrix(dimension, offset + i) = array.IsNull(i) ?
+        std::numeric_limits<eT>::quiet_NaN() : (eT) array.Value(i);
+  }
+}
+
+//! Copy the values of the given chunk of a numeric column of any type into
+//! the given dimension of the matrix, starting at the given point.
+template<typename eT>
+void CopyParquetChunk(const arrow::Array& chunk,
+                      arma::Mat<eT>& matrix,
+                      const size_t dimension,
+                      const size_t offset)
+{
+  switch (chunk.type_id())
+  {
+    case arrow::Type::BOOL:
+      CopyParquetValues<arrow::BooleanArray>(chunk, matrix, dimension, offset);
+      break;
+    case arrow::Type::INT8:
+      CopyParquetValues<arrow::Int8Array>(chunk, matrix, dimension, offset);
+      break;
+    case arrow::Type::INT16:
+      CopyParquetValues<arrow::Int16Array>(chunk, matrix, dimension, offset);
+      break;
+    case arrow::Type::INT32:
+      CopyParquetValues<arrow::Int32Array>(chunk, matrix, dimension, offset);
+      break;
+    case arrow::Type::INT64:
+      CopyParquetValues<arrow::Int64Array>(chunk, matrix, dimension, offset);
+      break;
+    case arrow::Type::UINT8:
+      CopyParquetValues<arrow::UInt8Array>(chunk, matrix, dimension, offset);
+      break;
+    case arrow::Type::UINT16:
+      CopyParquetValues<arrow::UInt16Array>(chunk, matrix, dimension, offset);
+      break;
+    case arrow::Type::UINT32:
+      CopyParquetValues<arrow::UInt32Array>(chunk, matrix, dimension, offset);
+      break;
+    case arrow::Type::UINT64:
+      CopyParquetValues<arrow::UInt64Array>(chunk, matrix, dimension, offset);
+      break;
+    case arrow::Type::FLOAT:
+      CopyParquetValues<arrow::FloatArray>(chunk, matrix, dimension, offset);
+      break;
+    case arrow::Type::DOUBLE:
+      CopyParquetValues<arrow::DoubleArray>(chunk, matrix, dimension, offset);
+      break;
+    default:
+      throw std::runtime_error("unsupported column type " +
+          chunk.type()->ToString());
+  }
+}
+
+//! Return the given value of a chunk of a categorical column as a string
+//! (missing values are empty strings).
+inline std::string ParquetString(const arrow::Array& chunk, const int64_t i)
+{
+  if (chunk.IsNull(i))
+    return std::string();
+
+  switch (chunk.type_id())
+  {
+    case arrow::Type::STRING:
+    case arrow::Type::BINARY:
+      return static_cast<const arrow::BinaryArray&>(chunk).GetString(i);
+    case arrow::Type::LARGE_STRING:
+    case arrow::Type::LARGE_BINARY:
+      return static_cast<const arrow::LargeBinaryArray&>(chunk).GetString(i);
+    case arrow::Type::DICTIONARY:
+    {
+      const arrow::DictionaryArray& array =
+          static_cast<const arrow::DictionaryArray&>(chunk);
+      return ParquetString(*array.dictionary(), array.GetValueIndex(i));
+    }
+    default:
+      throw std::runtime_error("unsupported column type " +
+          chunk.type()->ToString());
+  }
+}
+
+} // namespace details
+
+template<typename eT, typename PolicyType>
+void LoadParquet(const std::string& filename,
+                 arma::Mat<eT>& matrix,
+                 DatasetMapper<PolicyType>& info,
+                 const std::vector<std::string>& columns)
+{
+  std::unique_ptr<parquet::arrow::FileReader> reader =
+      details::OpenParquetFile(filename);
+
+  std::shared_ptr<arrow::Schema> schema;
+  const arrow::Status status = reader->GetSchema(&schema);
+  if (!status.ok())
+  {
+    throw std::runtime_error("LoadParquet(): cannot read the schema of '" +
+        filename + "': " + status.ToString());
+  }
+
+  // The reader selects columns by their index among the leaves of the schema,
+  // which is only the index of the field if no field is nested.
+  const std::shared_ptr<parquet::FileMetaData> metadata =
+      reader->parquet_reader()->metadata();
+  if (metadata->num_columns() != schema->num_fields())
+  {
+    throw std::runtime_error("LoadParquet(): '" + filename + "' has nested "
+        "columns, which cannot be loaded!");
+  }
+
+  // Find the fields of the columns to load.
+  std::vector<int> fields;
+  if (columns.empty())
+  {
+    for (int i = 0; i < schema->num_fields(); ++i)
+      fields.push_back(i);
+  }
+  else
+  {
+    for (const std::string& column : columns)
+    {
+      const int field = schema->GetFieldIndex(column);
+      if (field < 0)
+      {
+        throw std::runtime_error("LoadParquet(): '" + filename + "' has no "
+            "column named '" + column + "' (or more than one)!");
+      }
+      fields.push_back(field);
+    }
+  }
+
+  // The columns of the tables given by the reader are in the order of the
+  // schema, so find the position of each dimension among them.
+  std::vector<int> indices(fields);
+  std::sort(indices.begin(), indices.end());
+  indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+  std::vector<int> positions(fields.size());
+  std::vector<bool> categorical(fields.size());
+  bool hasCategorical = false;
+  for (size_t d = 0; d < fields.size(); ++d)
+  {
+    positions[d] = std::lower_bound(indices.begin(), indices.end(),
+        fields[d]) - indices.begin();
+
+    const arrow::Field& field = *schema->field(fields[d]);
+    categorical[d] = details::IsParquetCategorical(*field.type());
+    hasCategorical |= categorical[d];
+    if (!categorical[d] && !details::IsParquetNumeric(*field.type()))
+    {
+      throw std::runtime_error("LoadParquet(): column '" + field.name() +
+          "' of '" + filename + "' has unsupported type " +
+          field.type()->ToString() + "!");
+    }
+  }
+
+  // Reset the DatasetInfo object, if needed.
+  if (info.Dimensionality() == 0)
+  {
+    info = DatasetMapper<PolicyType>(fields.size());
+  }
+  else if (info.Dimensionality() != fields.size())
+  {
+    std::ostringstream oss;
+    oss << "data::LoadParquet(): given DatasetInfo has dimensionality "
+        << info.Dimensionality() << ", but data has dimensionality "
+        << fields.size();
+    throw std::invalid_argument(oss.str());
+  }
+
+  for (size_t d = 0; d < fields.size(); ++d)
+  {
+    info.Type(d) = categorical[d] ? Datatype::categorical :
+        Datatype::numeric;
+  }
+
+  // Find the first point of each row group.
+  const int numRowGroups = reader->num_row_groups();
+  std::vector<size_t> offsets(numRowGroups + 1, 0);
+  for (int g = 0; g < numRowGroups; ++g)
+    offsets[g + 1] = offsets[g] + metadata->RowGroup(g)->num_rows();
+
+  matrix.set_size(fields.size(), offsets[numRowGroups]);
+
+  // Each thread decodes row groups with its own reader (a reader cannot be
+  // used by several threads at once), and copies their numeric columns into
+  // the matrix.  The mapping of the categorical columns depends on the order
+  // of the points, so the tables are kept to map them afterwards.
+  std::vector<std::shared_ptr<arrow::Table>> tables(numRowGroups);
+  std::string error;
+  #pragma omp parallel
+  {
+    std::unique_ptr<parquet::arrow::FileReader> threadReader;
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t g = 0; g < (omp_size_t) numRowGroups; ++g)
+    {
+      try
+      {
+        if (!threadReader)
+          threadReader = details::OpenParquetFile(filename);
+
+        const arrow::Status readStatus = threadReader->ReadRowGroup((int) g,
+            indices, &tables[g]);
+        if (!readStatus.ok())
+          throw std::runtime_error(readStatus.ToString());
+
+        for (size_t d = 0; d < fields.size(); ++d)
+        {
+          if (categorical[d])
+            continue;
+
+          const arrow::ChunkedArray& column = *tables[g]->column(positions[d]);
+          size_t offset = offsets[g];
+          for (int c = 0; c < column.num_chunks(); ++c)
+          {
+            details::CopyParquetChunk(*column.chunk(c), matrix, d, offset);
+            offset += column.chunk(c)->length();
+          }
+        }
+
+        if (!hasCategorical)
+          tables[g].reset();
+      }
+      catch (std::exception& e)
+      {
+        #pragma omp critical
+        if (error.empty())
+          error = e.what();
+      }
+    }
+  }
+
+  if (!error.empty())
+  {
+    throw std::runtime_error("LoadParquet(): error reading '" + filename +
+        "': " + error + "!");
+  }
+
+  // Now map the categorical columns, in the order of the points.
+  for (size_t d = 0; d < fields.size(); ++d)
+  {
+    if (!categorical[d])
+      continue;
+
+    for (int g = 0; g < numRowGroups; ++g)
+    {
+      const arrow::ChunkedArray& column = *tables[g]->column(positions[d]);
+      size_t offset = offsets[g];
+      for (int c = 0; c < column.num_chunks(); ++c)
+      {
+        const arrow::Array& chunk = *column.chunk(c);
+        for (int64_t i = 0; i < chunk.length(); ++i)
+        {
+          matrix(d, offset + i) = info.template MapString<eT>(
+              details::ParquetString(chunk, i), d);
+        }
+        offset += chunk.length();
+      }
+    }
+  }
+}
+
+} // namespace data
+} // namespace mlpack
+
+#else
+
+namespace mlpack {
+namespace data {
+
+template<typename eT, typename PolicyType>
+void LoadParquet(const std::string& filename,
+                 arma::Mat<eT>& /* matrix */,
+                 DatasetMapper<PolicyType>& /* info */,
+                 const std::vector<std::string>& /* columns */)
+{
+  throw std::runtime_error("mlpack was not compiled with Parquet support, so "
+      "'" + filename + "' cannot be loaded!");
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif // HAS_PARQUET.
+
+#endif
@@ -14,6 +14,7 @@
 #define MLPACK_CORE_DATA_ONE_HOT_ENCODING_HPP
 
 #include <mlpack/prereqs.hpp>
+#include "dataset_mapper.hpp"
 
 namespace mlpack {
 namespace data {
@@ -32,6 +33,37 @@ template<typename eT, typename RowType>
 void OneHotEncoding(const RowType& labelsIn,
                     arma::Mat<eT>& output);
 
+/**
+ * Given a set of labels of a particular datatype, convert them to binary
+ * vectors, like the overload for dense matrices, but store the result in a
+ * sparse matrix, which only holds the ones.  This is what should be used when
+ * there are many distinct labels.
+ *
+ * @param labelsIn Input labels of arbitrary datatype.
+ * @param output Sparse binary matrix (one row per label, and one column per
+ *     distinct label).
+ */
+template<typename eT, typename RowType>
+void OneHotEncoding(const RowType& labelsIn,
+                    arma::SpMat<eT>& output);
+
+/**
+ * One-hot encode the categorical dimensions of a dataset, as given by the
+ * DatasetInfo used to load it, and store the result in a sparse matrix.  Each
+ * categorical dimension d, whose values must be mapped values (from 0 to
+ * info.NumMappings(d) - 1), is replaced by info.NumMappings(d) binary
+ * dimensions; the numeric dimensions are kept as they are.  The columns of the
+ * output are filled in parallel (when OpenMP is available).
+ *
+ * @param input Dataset to encode (one column per point).
+ * @param info DatasetInfo giving the type of each dimension of the dataset.
+ * @param output Sparse matrix to store the encoded dataset into.
+ */
+template<typename eT, typename PolicyType>
+void OneHotEncoding(const arma::Mat<eT>& input,
+                    const DatasetMapper<PolicyType>& info,
+                    arma::SpMat<eT>& output);
+
 } // namespace data
 } // namespace mlpack
 
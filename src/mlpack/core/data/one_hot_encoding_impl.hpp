@@ -64,6 +64,130 @@ void OneHotEncoding(const RowType& labelsIn,
   }
   labelMap.clear();
 }
+
+template<typename eT, typename RowType>
+void OneHotEncoding(const RowType& labelsIn,
+                    arma::SpMat<eT>& output)
+{
+  // Map the labels in the order in which they first appear.
+  arma::uvec labels(labelsIn.n_elem);
+  std::unordered_map<eT, size_t> labelMap;
+  for (size_t i = 0; i < labelsIn.n_elem; ++i)
+  {
+    const auto it = labelMap.insert(std::make_pair(eT(labelsIn[i]),
+        labelMap.size())).first;
+    labels[i] = it->second;
+  }
+  const size_t numLabels = labelMap.size();
+  labelMap.clear();
+
+  // Column j holds a one for each point with the label j, so the compressed
+  // sparse column structure is built with a counting sort of the points.
+  arma::uvec colPtrs(numLabels + 1, arma::fill::zeros);
+  for (size_t i = 0; i < labels.n_elem; ++i)
+    ++colPtrs[labels[i] + 1];
+  colPtrs = arma::cumsum(colPtrs);
+
+  arma::uvec rowIndices(labels.n_elem);
+  arma::uvec next = colPtrs.head(numLabels);
+  for (size_t i = 0; i < labels.n_elem; ++i)
+    rowIndices[next[labels[i]]++] = i;
+
+  output = arma::SpMat<eT>(rowIndices, colPtrs,
+      arma::ones<arma::Col<eT>>(labels.n_elem), labels.n_elem, numLabels);
+}
+
+template<typename eT, typename PolicyType>
+void OneHotEncoding(const arma::Mat<eT>& input,
+                    const DatasetMapper<PolicyType>& info,
+                    arma::SpMat<eT>& output)
+{
+  if (input.n_rows != info.Dimensionality())
+  {
+    std::ostringstream oss;
+    oss << "OneHotEncoding(): dataset has " << input.n_rows << " dimensions, "
+        << "but DatasetInfo has " << info.Dimensionality() << " dimensions";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // Find the first row of each dimension in the output, and check that the
+  // categorical values are mapped values.
+  std::vector<bool> categorical(input.n_rows);
+  std::vector<size_t> firstRow(input.n_rows);
+  size_t outputRows = 0, categoricalDims = 0;
+  for (size_t d = 0; d < input.n_rows; ++d)
+  {
+    categorical[d] = (info.Type(d) == Datatype::categorical);
+    firstRow[d] = outputRows;
+    if (!categorical[d])
+    {
+      ++outputRows;
+      continue;
+    }
+
+    const size_t numMappings = info.NumMappings(d);
+    for (size_t i = 0; i < input.n_cols; ++i)
+    {
+      const eT value = input(d, i);
+      if (!(value >= 0 && value < eT(numMappings) &&
+          value == eT(size_t(value))))
+      {
+        std::ostringstream oss;
+        oss << "OneHotEncoding(): value " << value << " of point " << i
+            << " is not a mapped value of categorical dimension " << d
+            << ", which has " << numMappings << " mappings";
+        throw std::invalid_argument(oss.str());
+      }
+    }
+
+    outputRows += numMappings;
+    ++categoricalDims;
+  }
+
+  // Count the nonzero values of each column: one for each categorical
+  // dimension, and the nonzero numeric values.
+  arma::uvec colPtrs(input.n_cols + 1);
+  colPtrs[0] = 0;
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) input.n_cols; ++i)
+  {
+    size_t nonzeros = categoricalDims;
+    for (size_t d = 0; d < input.n_rows; ++d)
+    {
+      if (!categorical[d] && input(d, i) != eT(0))
+        ++nonzeros;
+    }
+    colPtrs[i + 1] = nonzeros;
+  }
+  colPtrs = arma::cumsum(colPtrs);
+
+  // Now fill each column; the rows of a column are sorted since the dimensions
+  // are visited in order.
+  arma::uvec rowIndices(colPtrs[input.n_cols]);
+  arma::Col<eT> values(colPtrs[input.n_cols]);
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) input.n_cols; ++i)
+  {
+    size_t position = colPtrs[i];
+    for (size_t d = 0; d < input.n_rows; ++d)
+    {
+      if (categorical[d])
+      {
+        rowIndices[position] = firstRow[d] + size_t(input(d, i));
+        values[position++] = eT(1);
+      }
+      else if (input(d, i) != eT(0))
+      {
+        rowIndices[position] = firstRow[d];
+        values[position++] = input(d, i);
+      }
+    }
+  }
+
+  output = arma::SpMat<eT>(rowIndices, colPtrs, values, outputRows,
+      input.n_cols);
+}
+
 } // namespace data
 } // namespace mlpack
 
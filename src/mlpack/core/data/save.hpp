@@ -39,6 +39,7 @@ namespace data /** Functions to load and save matrices. */ {
  *  - Raw binary (raw_binary), denoted by .bin
  *  - Armadillo binary (arma_binary), denoted by .bin
  *  - HDF5 (hdf5_binary), denoted by .hdf5, .hdf, .h5, or .he5
+ *  - mlpack binary dataset (see SaveBinaryDataset()), denoted by .mlb
  *
  * If the file extension is not one of those types, an error will be given.  If
  * the 'fatal' parameter is set to true, a std::runtime_error exception will be
@@ -47,6 +48,13 @@ namespace data /** Functions to load and save matrices. */ {
  * in a column-major format and most datasets are stored on disk as row-major,
  * this parameter should be left at its default value of 'true'.
  *
+ * If the extension of the file is .gz or .zst, such as "data.csv.gz", the file
+ * is compressed with gzip or zstd (if mlpack was compiled with zlib or zstd
+ * support), and its type is given by the extension before the extension of
+ * the compression.  HDF5 files and the mlpack binary dataset format cannot be
+ * compressed.  zstd compression uses multiple threads when OpenMP is
+ * available.
+ *
  * @param filename Name of file to save to.
  * @param matrix Matrix to save into file.
  * @param fatal If an error should be reported as fatal (default false).
@@ -78,6 +86,13 @@ bool Save(const std::string& filename,
  * in a column-major format and most datasets are stored on disk as row-major,
  * this parameter should be left at its default value of 'true'.
  *
+ * If the extension of the file is .gz or .zst, such as "data.csv.gz", the file
+ * is compressed with gzip or zstd (if mlpack was compiled with zlib or zstd
+ * support), and its type is given by the extension before the extension of
+ * the compression.  HDF5 files and the mlpack binary dataset format cannot be
+ * compressed.  zstd compression uses multiple threads when OpenMP is
+ * available.
+ *
  * @param filename Name of file to save to.
  * @param matrix Sparse matrix to save into file.
  * @param fatal If an error should be reported as fatal (default false).
@@ -107,6 +122,11 @@ bool Save(const std::string& filename,
  * The autodetect functionality operates on the file extension (so, "file.txt"
  * would be autodetected as text).
  *
+ * If the extension of the file is .gz or .zst, such as "model.bin.zst", the
+ * file is compressed with gzip or zstd (if mlpack was compiled with zlib or
+ * zstd support); then the extension before the extension of the compression is
+ * used to autodetect the format.
+ *
  * The name parameter should be specified to indicate the name of the structure
  * to be saved.  If Load() is later called on the generated file, the name used
  * to load should be the same as the name used for this call to Save().
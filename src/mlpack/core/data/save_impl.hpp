@@ -15,6 +15,8 @@
 // In case it hasn't already been included.
 #include "save.hpp"
 #include "extension.hpp"
+#include "binary_dataset.hpp"
+#include "compressed_stream.hpp"
 
 #include <boost/serialization/serialization.hpp>
 #include <boost/archive/xml_oarchive.hpp>
@@ -49,8 +51,11 @@ bool Save(const std::string& filename,
 {
   Timer::Start("saving_data");
 
-  // First we will try to discriminate by file extension.
-  std::string extension = Extension(filename);
+  // First we will try to discriminate by file extension; the type of a
+  // compressed file is given by the extension before the extension of the
+  // compression.
+  const Compression compression = FileCompression(filename);
+  std::string extension = Extension(UncompressedName(filename));
   if (extension == "")
   {
     Timer::Stop("saving_data");
@@ -64,12 +69,49 @@ bool Save(const std::string& filename,
     return false;
   }
 
+  // Only the formats that Armadillo writes to a stream can be compressed.
+  if (!CheckCompression(filename, compression, extension != "mlb" &&
+      extension != "h5" && extension != "hdf5" && extension != "hdf" &&
+      extension != "he5", fatal))
+  {
+    Timer::Stop("saving_data");
+    return false;
+  }
+
+  // The mlpack binary dataset format stores the matrix as it is in memory, so
+  // it is saved without Armadillo.
+  if (extension == "mlb")
+  {
+    Log::Info << "Saving mlpack binary dataset to '" << filename << "'."
+        << std::endl;
+    try
+    {
+      if (transpose)
+        SaveBinaryDataset(filename, matrix);
+      else
+        SaveBinaryDataset(filename, arma::Mat<eT>(matrix.t()));
+    }
+    catch (std::exception& e)
+    {
+      Timer::Stop("saving_data");
+      if (fatal)
+        Log::Fatal << e.what() << std::endl;
+      else
+        Log::Warn << e.what() << std::endl;
+
+      return false;
+    }
+
+    Timer::Stop("saving_data");
+    return true;
+  }
+
   // Catch errors opening the file.
-  std::fstream stream;
 #ifdef  _WIN32 // Always open in binary mode on Windows.
-  stream.open(filename.c_str(), std::fstream::out | std::fstream::binary);
+  CompressedOutputStream stream(filename, compression,
+      std::fstream::out | std::fstream::binary);
 #else
-  stream.open(filename.c_str(), std::fstream::out);
+  CompressedOutputStream stream(filename, compression, std::fstream::out);
 #endif
   if (!stream.is_open())
   {
@@ -191,6 +233,19 @@ bool Save(const std::string& filename,
     }
   }
 
+  // Finish the compressed stream, if the file is compressed.
+  stream.close();
+  if (stream.fail())
+  {
+    Timer::Stop("saving_data");
+    if (fatal)
+      Log::Fatal << "Save to '" << filename << "' failed." << std::endl;
+    else
+      Log::Warn << "Save to '" << filename << "' failed." << std::endl;
+
+    return false;
+  }
+
   Timer::Stop("saving_data");
 
   // Finally return success.
@@ -206,8 +261,11 @@ bool Save(const std::string& filename,
 {
   Timer::Start("saving_data");
 
-  // First we will try to discriminate by file extension.
-  std::string extension = Extension(filename);
+  // First we will try to discriminate by file extension; the type of a
+  // compressed file is given by the extension before the extension of the
+  // compression.
+  const Compression compression = FileCompression(filename);
+  std::string extension = Extension(UncompressedName(filename));
   if (extension == "")
   {
     Timer::Stop("saving_data");
@@ -221,12 +279,18 @@ bool Save(const std::string& filename,
     return false;
   }
 
+  if (!CheckCompression(filename, compression, true, fatal))
+  {
+    Timer::Stop("saving_data");
+    return false;
+  }
+
   // Catch errors opening the file.
-  std::fstream stream;
 #ifdef  _WIN32 // Always open in binary mode on Windows.
-  stream.open(filename.c_str(), std::fstream::out | std::fstream::binary);
+  CompressedOutputStream stream(filename, compression,
+      std::fstream::out | std::fstream::binary);
 #else
-  stream.open(filename.c_str(), std::fstream::out);
+  CompressedOutputStream stream(filename, compression, std::fstream::out);
 #endif
   if (!stream.is_open())
   {
@@ -300,6 +364,19 @@ bool Save(const std::string& filename,
     return false;
   }
 
+  // Finish the compressed stream, if the file is compressed.
+  stream.close();
+  if (stream.fail())
+  {
+    Timer::Stop("saving_data");
+    if (fatal)
+      Log::Fatal << "Save to '" << filename << "' failed." << std::endl;
+    else
+      Log::Warn << "Save to '" << filename << "' failed." << std::endl;
+
+    return false;
+  }
+
   Timer::Stop("saving_data");
 
   // Finally return success.
@@ -314,9 +391,15 @@ bool Save(const std::string& filename,
           const bool fatal,
           format f)
 {
+  // The file is compressed if its extension is .gz or .zst; then the format is
+  // given by the extension before that.
+  const Compression compression = FileCompression(filename);
+  if (!CheckCompression(filename, compression, true, fatal))
+    return false;
+
   if (f == format::autodetect)
   {
-    std::string extension = Extension(filename);
+    std::string extension = Extension(UncompressedName(filename));
 
     if (extension == "xml")
       f = format::xml;
@@ -339,14 +422,12 @@ bool Save(const std::string& filename,
   }
 
   // Open the file to save to.
-  std::ofstream ofs;
 #ifdef _WIN32
-  if (f == format::binary) // Open non-text types in binary mode on Windows.
-    ofs.open(filename, std::ofstream::out | std::ofstream::binary);
-  else
-    ofs.open(filename, std::ofstream::out);
+  // Open non-text types in binary mode on Windows.
+  CompressedOutputStream ofs(filename, compression, (f == format::binary) ?
+      std::ofstream::out | std::ofstream::binary : std::ofstream::out);
 #else
-  ofs.open(filename, std::ofstream::out);
+  CompressedOutputStream ofs(filename, compression, std::ofstream::out);
 #endif
 
   if (!ofs.is_open())
@@ -379,6 +460,20 @@ bool Save(const std::string& filename,
       ar << boost::serialization::make_nvp(name.c_str(), t);
     }
 
+    // Finish the compressed stream, if the file is compressed.
+    ofs.close();
+    if (ofs.fail())
+    {
+      if (fatal)
+        Log::Fatal << "Unable to save object '" << name << "' to file '"
+            << filename << "'." << std::endl;
+      else
+        Log::Warn << "Unable to save object '" << name << "' to file '"
+            << filename << "'." << std::endl;
+
+      return false;
+    }
+
     return true;
   }
   catch (boost::archive::archive_exception& e)
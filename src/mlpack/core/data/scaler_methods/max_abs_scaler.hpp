@@ -42,6 +42,9 @@ namespace data {
  * // Retransform the input.
  * scale.InverseTransform(output, input);
  * @endcode
+ *
+ * A dataset that does not fit in memory can be fit in chunks with
+ * PartialFit(), and transformed in place chunk by chunk.
  */
 class MaxAbsScaler
 {
@@ -54,8 +57,40 @@ class MaxAbsScaler
   template<typename MatType>
   void Fit(const MatType& input)
   {
-    itemMin = arma::min(input, 1);
-    itemMax = arma::max(input, 1);
+    itemMin.reset();
+    itemMax.reset();
+    PartialFit(input);
+  }
+
+  /**
+   * Update the minimum and maximum of each feature with another chunk of the
+   * dataset.  Fitting every chunk of a dataset with PartialFit() gives the
+   * same scaling as fitting the whole dataset with Fit().
+   *
+   * @param input Chunk of the dataset to fit.
+   */
+  template<typename MatType>
+  void PartialFit(const MatType& input)
+  {
+    if (input.n_cols == 0)
+      return;
+
+    if (itemMin.is_empty())
+    {
+      itemMin = arma::min(input, 1);
+      itemMax = arma::max(input, 1);
+    }
+    else if (input.n_rows != itemMin.n_elem)
+    {
+      throw std::invalid_argument("MaxAbsScaler::PartialFit(): "
+          "dimensionality of the input does not match the fitted data");
+    }
+    else
+    {
+      itemMin = arma::min(itemMin, arma::vec(arma::min(input, 1)));
+      itemMax = arma::max(itemMax, arma::vec(arma::max(input, 1)));
+    }
+
     scale = arma::max(arma::abs(itemMin), arma::abs(itemMax));
     // Handling zeros in scale vector.
     scale.for_each([](arma::vec::elem_type& val) { val =
@@ -80,6 +115,26 @@ class MaxAbsScaler
     output = input.each_col() / scale;
   }
 
+  /**
+   * Function to scale features in place, without allocating an output matrix.
+   * The points are scaled in parallel when OpenMP is available.
+   *
+   * @param input Dataset to scale features of.
+   */
+  template<typename MatType>
+  void Transform(MatType& input)
+  {
+    if (scale.is_empty())
+    {
+      throw std::runtime_error("Call Fit() before Transform(), please"
+        " refer to the documentation.");
+    }
+
+    #pragma omp parallel for
+    for (omp_size_t i = 0; i < (omp_size_t) input.n_cols; ++i)
+      input.col(i) /= scale;
+  }
+
   /**
    * Function to retrieve original dataset.
    *
@@ -93,6 +148,19 @@ class MaxAbsScaler
     output = input.each_col() % scale;
   }
 
+  /**
+   * Function to retrieve the original dataset in place.
+   *
+   * @param input Scaled dataset.
+   */
+  template<typename MatType>
+  void InverseTransform(MatType& input)
+  {
+    #pragma omp parallel for
+    for (omp_size_t i = 0; i < (omp_size_t) input.n_cols; ++i)
+      input.col(i) %= scale;
+  }
+
   //! Get the Min row vector.
   const arma::vec& ItemMin() const { return itemMin; }
   //! Get the Max row vector.
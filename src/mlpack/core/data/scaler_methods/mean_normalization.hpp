@@ -42,10 +42,16 @@ namespace data {
  * // Retransform the input.
  * scale.InverseTransform(output, input);
  * @endcode
+ *
+ * A dataset that does not fit in memory can be fit in chunks with
+ * PartialFit(), and transformed in place chunk by chunk.
  */
 class MeanNormalization
 {
  public:
+  //! Create the scaler; Fit() or PartialFit() must be called before use.
+  MeanNormalization() : itemCount(0) { }
+
   /**
    * Function to fit features, to find out the min max and scale.
    *
@@ -54,9 +60,45 @@ class MeanNormalization
   template<typename MatType>
   void Fit(const MatType& input)
   {
-    itemMean = arma::mean(input, 1);
-    itemMin = arma::min(input, 1);
-    itemMax = arma::max(input, 1);
+    itemCount = 0;
+    PartialFit(input);
+  }
+
+  /**
+   * Update the mean, minimum and maximum of each feature with another chunk of
+   * the dataset.  Fitting every chunk of a dataset with PartialFit() gives the
+   * same scaling as fitting the whole dataset with Fit() (up to floating-point
+   * error).
+   *
+   * @param input Chunk of the dataset to fit.
+   */
+  template<typename MatType>
+  void PartialFit(const MatType& input)
+  {
+    if (input.n_cols == 0)
+      return;
+
+    if (itemCount == 0)
+    {
+      itemMean = arma::mean(input, 1);
+      itemMin = arma::min(input, 1);
+      itemMax = arma::max(input, 1);
+    }
+    else if (input.n_rows != itemMean.n_elem)
+    {
+      throw std::invalid_argument("MeanNormalization::PartialFit(): "
+          "dimensionality of the input does not match the fitted data");
+    }
+    else
+    {
+      const double totalCount = itemCount + input.n_cols;
+      itemMean += (arma::mean(input, 1) - itemMean) *
+          (input.n_cols / totalCount);
+      itemMin = arma::min(itemMin, arma::vec(arma::min(input, 1)));
+      itemMax = arma::max(itemMax, arma::vec(arma::max(input, 1)));
+    }
+    itemCount += input.n_cols;
+
     scale = itemMax - itemMin;
     // Handling zeros in scale vector.
     scale.for_each([](arma::vec::elem_type& val) { val =
@@ -81,6 +123,26 @@ class MeanNormalization
     output = (input.each_col() - itemMean).each_col() / scale;
   }
 
+  /**
+   * Function to scale features in place, without allocating an output matrix.
+   * The points are scaled in parallel when OpenMP is available.
+   *
+   * @param input Dataset to scale features of.
+   */
+  template<typename MatType>
+  void Transform(MatType& input)
+  {
+    if (itemMean.is_empty() || scale.is_empty())
+    {
+      throw std::runtime_error("Call Fit() before Transform(), please"
+        " refer to the documentation.");
+    }
+
+    #pragma omp parallel for
+    for (omp_size_t i = 0; i < (omp_size_t) input.n_cols; ++i)
+      input.col(i) = (input.col(i) - itemMean) / scale;
+  }
+
   /**
    * Function to retrieve original dataset.
    *
@@ -94,6 +156,19 @@ class MeanNormalization
     output = (input.each_col() % scale).each_col() + itemMean;
   }
 
+  /**
+   * Function to retrieve the original dataset in place.
+   *
+   * @param input Scaled dataset.
+   */
+  template<typename MatType>
+  void InverseTransform(MatType& input)
+  {
+    #pragma omp parallel for
+    for (omp_size_t i = 0; i < (omp_size_t) input.n_cols; ++i)
+      input.col(i) = input.col(i) % scale + itemMean;
+  }
+
   //! Get the Mean row vector.
   const arma::vec& ItemMean() const { return itemMean; }
   //! Get the Min row vector.
@@ -102,14 +177,23 @@ class MeanNormalization
   const arma::vec& ItemMax() const { return itemMax; }
   //! Get the Scale row vector.
   const arma::vec& Scale() const { return scale; }
+  //! Get the number of points that have been fit.
+  size_t ItemCount() const { return itemCount; }
 
   template<typename Archive>
-  void serialize(Archive& ar, const unsigned int /* version */)
+  void serialize(Archive& ar, const unsigned int version)
   {
     ar & BOOST_SERIALIZATION_NVP(itemMin);
     ar & BOOST_SERIALIZATION_NVP(itemMax);
     ar & BOOST_SERIALIZATION_NVP(scale);
     ar & BOOST_SERIALIZATION_NVP(itemMean);
+
+    // Older models can't be updated with PartialFit(), which will fit them
+    // again from scratch.
+    if (version > 0)
+      ar & BOOST_SERIALIZATION_NVP(itemCount);
+    else if (Archive::is_loading::value)
+      itemCount = 0;
   }
 
  private:
@@ -121,9 +205,13 @@ class MeanNormalization
   arma::vec itemMax;
   // Vector which is used to scale up each feature.
   arma::vec scale;
+  // Number of points that have been fit.
+  size_t itemCount;
 }; // class MeanNormalization
 
 } // namespace data
 } // namespace mlpack
 
+BOOST_CLASS_VERSION(mlpack::data::MeanNormalization, 1);
+
 #endif
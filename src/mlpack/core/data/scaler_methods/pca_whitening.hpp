@@ -14,6 +14,7 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/math/lin_alg.hpp>
+#include <mlpack/core/math/running_covariance.hpp>
 
 namespace mlpack {
 namespace data {
@@ -69,10 +70,14 @@ class PCAWhitening
   template<typename MatType>
   void Fit(const MatType& input)
   {
-    itemMean = arma::mean(input, 1);
+    // Compute the mean and covariance in one pass, without centering a copy
+    // of the input.
+    math::RunningCovariance<> statistics(input.n_rows);
+    statistics.Update(input);
+    itemMean = statistics.Mean();
+
     // Get eigenvectors and eigenvalues of covariance of input matrix.
-    eig_sym(eigenValues, eigenVectors, mlpack::math::ColumnCovariance(
-        input.each_col() - itemMean));
+    eig_sym(eigenValues, eigenVectors, statistics.Covariance());
     eigenValues += epsilon;
   }
 
@@ -43,20 +43,68 @@ namespace data {
  * // Retransform the input.
  * scale.InverseTransform(output, input);
  * @endcode
+ *
+ * A dataset that does not fit in memory can be fit in chunks with
+ * PartialFit(), and transformed in place chunk by chunk.
  */
 class StandardScaler
 {
  public:
+  //! Create the scaler; Fit() or PartialFit() must be called before use.
+  StandardScaler() : itemCount(0) { }
+
   /**
-   * Function to fit features, to find out the min max and scale.
+   * Function to fit features, to find out the mean and standard deviation.
    *
    * @param input Dataset to fit.
    */
   template<typename MatType>
   void Fit(const MatType& input)
   {
-    itemMean = arma::mean(input, 1);
-    itemStdDev = arma::stddev(input, 1, 1);
+    itemCount = 0;
+    PartialFit(input);
+  }
+
+  /**
+   * Update the mean and standard deviation with another chunk of the dataset.
+   * Fitting every chunk of a dataset with PartialFit() gives the same scaling
+   * as fitting the whole dataset with Fit() (up to floating-point error).  The
+   * statistics of the chunks are merged with the parallel algorithm of Chan et
+   * al.
+   *
+   * @param input Chunk of the dataset to fit.
+   */
+  template<typename MatType>
+  void PartialFit(const MatType& input)
+  {
+    if (input.n_cols == 0)
+      return;
+
+    if (itemCount > 0 && input.n_rows != itemMean.n_elem)
+    {
+      throw std::invalid_argument("StandardScaler::PartialFit(): "
+          "dimensionality of the input does not match the fitted data");
+    }
+
+    const double batchCount = input.n_cols;
+    const arma::vec batchMean = arma::mean(input, 1);
+    const arma::vec batchM2 = arma::var(input, 1, 1) * batchCount;
+    if (itemCount == 0)
+    {
+      itemMean = batchMean;
+      itemM2 = batchM2;
+    }
+    else
+    {
+      const arma::vec delta = batchMean - itemMean;
+      const double totalCount = itemCount + batchCount;
+      itemMean += delta * (batchCount / totalCount);
+      itemM2 += batchM2 + arma::square(delta) *
+          (itemCount * batchCount / totalCount);
+    }
+    itemCount += input.n_cols;
+
+    itemStdDev = arma::sqrt(itemM2 / itemCount);
     // Handle zeros in scale vector.
     itemStdDev.for_each([](arma::vec::elem_type& val) { val =
         (val == 0) ? 1 : val; });
@@ -80,6 +128,26 @@ class StandardScaler
     output = (input.each_col() - itemMean).each_col() / itemStdDev;
   }
 
+  /**
+   * Function to scale features in place, without allocating an output matrix.
+   * The points are scaled in parallel when OpenMP is available.
+   *
+   * @param input Dataset to scale features of.
+   */
+  template<typename MatType>
+  void Transform(MatType& input)
+  {
+    if (itemMean.is_empty() || itemStdDev.is_empty())
+    {
+      throw std::runtime_error("Call Fit() before Transform(), please"
+        " refer to the documentation.");
+    }
+
+    #pragma omp parallel for
+    for (omp_size_t i = 0; i < (omp_size_t) input.n_cols; ++i)
+      input.col(i) = (input.col(i) - itemMean) / itemStdDev;
+  }
+
   /**
    * Function to retrieve original dataset.
    *
@@ -93,16 +161,44 @@ class StandardScaler
     output = (input.each_col() % itemStdDev).each_col() + itemMean;
   }
 
+  /**
+   * Function to retrieve the original dataset in place.
+   *
+   * @param input Scaled dataset.
+   */
+  template<typename MatType>
+  void InverseTransform(MatType& input)
+  {
+    #pragma omp parallel for
+    for (omp_size_t i = 0; i < (omp_size_t) input.n_cols; ++i)
+      input.col(i) = input.col(i) % itemStdDev + itemMean;
+  }
+
   //! Get the mean row vector.
   const arma::vec& ItemMean() const { return itemMean; }
   //! Get the standard deviation row vector.
   const arma::vec& ItemStdDev() const { return itemStdDev; }
+  //! Get the number of points that have been fit.
+  size_t ItemCount() const { return itemCount; }
 
   template<typename Archive>
-  void serialize(Archive& ar, const unsigned int /* version */)
+  void serialize(Archive& ar, const unsigned int version)
   {
     ar & BOOST_SERIALIZATION_NVP(itemMean);
     ar & BOOST_SERIALIZATION_NVP(itemStdDev);
+
+    // Older models can't be updated with PartialFit(), which will fit them
+    // again from scratch.
+    if (version > 0)
+    {
+      ar & BOOST_SERIALIZATION_NVP(itemCount);
+      ar & BOOST_SERIALIZATION_NVP(itemM2);
+    }
+    else if (Archive::is_loading::value)
+    {
+      itemCount = 0;
+      itemM2.clear();
+    }
   }
 
  private:
@@ -110,9 +206,16 @@ class StandardScaler
   arma::vec itemMean;
   // Vector which holds standard devation of each feature.
   arma::vec itemStdDev;
+  // Number of points that have been fit.
+  size_t itemCount;
+  // Vector which holds the sum of squared deviations from the mean of each
+  // feature.
+  arma::vec itemM2;
 }; // class StandardScaler
 
 } // namespace data
 } // namespace mlpack
 
+BOOST_CLASS_VERSION(mlpack::data::StandardScaler, 1);
+
 #endif
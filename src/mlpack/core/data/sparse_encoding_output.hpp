@@ -0,0 +1,157 @@
+/**
+ * @file core/data/sparse_encoding_output.hpp
+ *
+ * Definition of the SparseEncodingOutput class, which collects the values
+ * written by a string encoding policy and builds a sparse matrix from them.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_SPARSE_ENCODING_OUTPUT_HPP
+#define MLPACK_CORE_DATA_SPARSE_ENCODING_OUTPUT_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <unordered_map>
+
+namespace mlpack {
+namespace data {
+
+/**
+ * StringEncoding uses this class in place of an arma::SpMat while the encoding
+ * policy writes the output.  Inserting elements into an arma::SpMat one at a
+ * time may take time linear in the number of nonzero elements for each
+ * insertion, so instead the elements of the current column are kept in a hash
+ * map, and the finished columns are appended to the compressed sparse column
+ * arrays.  The policy must write the columns in increasing order, which is how
+ * StringEncoding encodes the lines of the input.
+ *
+ * @tparam ElemType Type of the output values.
+ */
+template<typename ElemType>
+class SparseEncodingOutput
+{
+ public:
+  //! The type of the elements, as for Armadillo matrices.
+  typedef ElemType elem_type;
+
+  //! Create an empty output.
+  SparseEncodingOutput() : n_rows(0), n_cols(0), column(0) { }
+
+  /**
+   * Set the size of the output; all of the elements are zero.
+   *
+   * @param rows Number of rows.
+   * @param cols Number of columns.
+   */
+  void zeros(const size_t rows, const size_t cols)
+  {
+    n_rows = rows;
+    n_cols = cols;
+    column = 0;
+    columnValues.clear();
+    rowIndices.clear();
+    values.clear();
+    columnPointers.assign(1, 0);
+  }
+
+  /**
+   * Access the given element.  The column must not be less than the column of
+   * any element accessed before.
+   *
+   * @param row Row of the element.
+   * @param col Column of the element.
+   */
+  ElemType& operator()(const size_t row, const size_t col)
+  {
+    if (col != column)
+    {
+      FinishColumn();
+      column = col;
+    }
+
+    return columnValues[row];
+  }
+
+  /**
+   * Build the sparse matrix from the written elements.
+   *
+   * @param output Matrix to store the result in.
+   */
+  void Finish(arma::SpMat<ElemType>& output)
+  {
+    FinishColumn();
+    column = n_cols;
+    FinishColumn();
+
+    output = arma::SpMat<ElemType>(
+        arma::conv_to<arma::uvec>::from(rowIndices),
+        arma::conv_to<arma::uvec>::from(columnPointers),
+        arma::conv_to<arma::Col<ElemType>>::from(values),
+        n_rows, n_cols);
+  }
+
+  //! Number of rows.
+  size_t n_rows;
+  //! Number of columns.
+  size_t n_cols;
+
+ private:
+  //! Append the elements of the current column to the compressed arrays, and
+  //! the column pointers of any columns before it that had no elements.
+  void FinishColumn()
+  {
+    while (columnPointers.size() < column + 1)
+      columnPointers.push_back(rowIndices.size());
+
+    std::vector<std::pair<size_t, ElemType>> elements(columnValues.begin(),
+        columnValues.end());
+    std::sort(elements.begin(), elements.end());
+    for (const std::pair<size_t, ElemType>& element : elements)
+    {
+      if (element.second == ElemType(0))
+        continue;
+
+      rowIndices.push_back(element.first);
+      values.push_back(element.second);
+    }
+
+    columnValues.clear();
+    if (column < n_cols)
+      columnPointers.push_back(rowIndices.size());
+  }
+
+  //! The column being written.
+  size_t column;
+  //! The elements of the column being written.
+  std::unordered_map<size_t, ElemType> columnValues;
+  //! Row indices of the finished columns.
+  std::vector<arma::uword> rowIndices;
+  //! Values of the finished columns.
+  std::vector<ElemType> values;
+  //! Column pointers of the finished columns.
+  std::vector<arma::uword> columnPointers;
+};
+
+/**
+ * This is a template struct that indicates whether the given output type is a
+ * SparseEncodingOutput, whose columns have to be written in order.
+ */
+template<typename MatType>
+struct IsSparseEncodingOutput
+{
+  static const bool value = false;
+};
+
+//! The specialization for SparseEncodingOutput.
+template<typename ElemType>
+struct IsSparseEncodingOutput<SparseEncodingOutput<ElemType>>
+{
+  static const bool value = true;
+};
+
+} // namespace data
+} // namespace mlpack
+
+#endif
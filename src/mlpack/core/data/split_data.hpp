@@ -14,9 +14,70 @@
 #define MLPACK_CORE_DATA_SPLIT_DATA_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/shuffle_data.hpp>
 
 namespace mlpack {
 namespace data {
+
+/**
+ * Compute the indices of the points of the training set and of the test set
+ * of a dataset with the given number of points, without touching the dataset.
+ * This is the split that the Split() overloads below perform.  The indices can
+ * be used with GatherColumns(), or to train on a subset of the dataset without
+ * copying it at all.
+ *
+ * @code
+ * arma::uvec trainIndices, testIndices;
+ * SplitIndices(input.n_cols, trainIndices, testIndices, 0.3);
+ * @endcode
+ *
+ * @param numPoints Number of points in the dataset.
+ * @param trainIndices Vector to store the indices of the training points into.
+ * @param testIndices Vector to store the indices of the test points into.
+ * @param testRatio Percentage of dataset to use for test set (between 0 and 1).
+ * @param shuffleData If true, the sample order is shuffled; otherwise, each
+ *       sample is visited in linear order. (Default true.)
+ */
+inline void SplitIndices(const size_t numPoints,
+                         arma::uvec& trainIndices,
+                         arma::uvec& testIndices,
+                         const double testRatio,
+                         const bool shuffleData = true)
+{
+  const size_t testSize = static_cast<size_t>(numPoints * testRatio);
+  const size_t trainSize = numPoints - testSize;
+
+  arma::uvec order = arma::linspace<arma::uvec>(0, numPoints - 1, numPoints);
+  if (shuffleData)
+    order = arma::shuffle(order);
+
+  trainIndices = order.head(trainSize);
+  testIndices = order.tail(testSize);
+}
+
+/**
+ * Copy the given columns of the input into the output, in parallel when
+ * OpenMP is available.  The output must be a different object than the input.
+ *
+ * @param input Matrix (or row) to copy the columns of.
+ * @param indices Indices of the columns to copy.
+ * @param output Matrix (or row) to store the columns into.
+ */
+template<typename MatType>
+void GatherColumns(const MatType& input,
+                   const arma::uvec& indices,
+                   MatType& output)
+{
+  output.set_size(input.n_rows, indices.n_elem);
+
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) indices.n_elem; ++i)
+  {
+    const typename MatType::elem_type* column = input.colptr(indices[i]);
+    std::copy(column, column + input.n_rows, output.colptr(i));
+  }
+}
+
 /**
  * Given an input dataset and labels, split into a training set and test set.
  * Example usage below.  This overload places the split dataset into the four
@@ -66,18 +127,13 @@ void Split(const arma::Mat<T>& input,
 
   if (shuffleData)
   {
-    arma::uvec order = arma::shuffle(arma::linspace<arma::uvec>(
-        0, input.n_cols - 1, input.n_cols));
-    if (trainSize > 0)
-    {
-      trainData = input.cols(order.subvec(0, trainSize - 1));
-      trainLabel = inputLabel.cols(order.subvec(0, trainSize - 1));
-    }
-    if (trainSize < input.n_cols)
-    {
-    testData = input.cols(order.subvec(trainSize, input.n_cols - 1));
-    testLabel = inputLabel.cols(order.subvec(trainSize, input.n_cols - 1));
-    }
+    arma::uvec trainIndices, testIndices;
+    SplitIndices(input.n_cols, trainIndices, testIndices, testRatio);
+
+    GatherColumns(input, trainIndices, trainData);
+    GatherColumns(inputLabel, trainIndices, trainLabel);
+    GatherColumns(input, testIndices, testData);
+    GatherColumns(inputLabel, testIndices, testLabel);
   }
   else
   {
@@ -131,14 +187,11 @@ void Split(const arma::Mat<T>& input,
 
   if (shuffleData)
   {
-    arma::uvec order = arma::shuffle(arma::linspace<arma::uvec>(
-        0, input.n_cols - 1, input.n_cols));
+    arma::uvec trainIndices, testIndices;
+    SplitIndices(input.n_cols, trainIndices, testIndices, testRatio);
 
-    if (trainSize > 0)
-      trainData = input.cols(order.subvec(0, trainSize - 1));
-
-    if (trainSize < input.n_cols)
-      testData = input.cols(order.subvec(trainSize, input.n_cols - 1));
+    GatherColumns(input, trainIndices, trainData);
+    GatherColumns(input, testIndices, testData);
   }
   else
   {
@@ -224,6 +277,72 @@ Split(const arma::Mat<T>& input,
                          std::move(testData));
 }
 
+/**
+ * Given an input dataset and labels, split them into a training set and a test
+ * set in place: the columns are shuffled (if requested) inside the given
+ * objects, so that the training set is made of the first columns and the test
+ * set of the last ones.  No copy of the dataset is made; the two sets can be
+ * used as subviews, or as matrices that alias the memory of the input.
+ *
+ * @code
+ * arma::mat input = loadData();
+ * arma::Row<size_t> label = loadLabel();
+ * const size_t trainSize = SplitInPlace(input, label, 0.3);
+ *
+ * // Matrices that use the memory of input, without copying it.
+ * arma::mat trainData(input.memptr(), input.n_rows, trainSize, false, true);
+ * arma::mat testData(input.colptr(trainSize), input.n_rows,
+ *     input.n_cols - trainSize, false, true);
+ * @endcode
+ *
+ * @param input Input dataset to split.
+ * @param inputLabel Input labels to split.
+ * @param testRatio Percentage of dataset to use for test set (between 0 and 1).
+ * @param shuffleData If true, the sample order is shuffled; otherwise, each
+ *       sample is visited in linear order. (Default true).
+ * @return Number of points in the training set.
+ */
+template<typename T, typename U>
+size_t SplitInPlace(arma::Mat<T>& input,
+                    arma::Row<U>& inputLabel,
+                    const double testRatio,
+                    const bool shuffleData = true)
+{
+  if (shuffleData)
+    math::ShuffleDataInPlace(input, inputLabel);
+
+  return input.n_cols - static_cast<size_t>(input.n_cols * testRatio);
+}
+
+/**
+ * Given an input dataset, split it into a training set and a test set in
+ * place: the columns are shuffled (if requested) inside the given matrix, so
+ * that the training set is made of the first columns and the test set of the
+ * last ones.  No copy of the dataset is made.
+ *
+ * @code
+ * arma::mat input = loadData();
+ * const size_t trainSize = SplitInPlace(input, 0.3);
+ * // The training set is input.head_cols(trainSize).
+ * @endcode
+ *
+ * @param input Input dataset to split.
+ * @param testRatio Percentage of dataset to use for test set (between 0 and 1).
+ * @param shuffleData If true, the sample order is shuffled; otherwise, each
+ *       sample is visited in linear order. (Default true).
+ * @return Number of points in the training set.
+ */
+template<typename T>
+size_t SplitInPlace(arma::Mat<T>& input,
+                    const double testRatio,
+                    const bool shuffleData = true)
+{
+  if (shuffleData)
+    math::ShuffleDataInPlace(input);
+
+  return input.n_cols - static_cast<size_t>(input.n_cols * testRatio);
+}
+
 } // namespace data
 } // namespace mlpack
 
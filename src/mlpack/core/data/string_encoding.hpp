@@ -16,6 +16,8 @@
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/boost_backport/boost_backport_string_view.hpp>
 #include <mlpack/core/data/string_encoding_dictionary.hpp>
+#include <mlpack/core/data/hashing_dictionary.hpp>
+#include <mlpack/core/data/sparse_encoding_output.hpp>
 #include <mlpack/core/data/string_encoding_policies/policy_traits.hpp>
 #include <vector>
 
@@ -99,6 +101,12 @@ class StringEncoding
    * writes it in the column-major order. If the output type is 2D std::vector
    * then the function writes it in the row major order.
    *
+   * When OpenMP is available, the lines are tokenized in parallel (unless the
+   * policy encodes a std::vector output in one pass), and the new tokens are
+   * added to the dictionary in the order of their first occurrence, so the
+   * result is the same as with one thread.  The tokenizer and the dictionary
+   * lookups must therefore be safe to call concurrently.
+   *
    * @tparam OutputType Type of the output container. The function supports
    *                    the following types: arma::mat, arma::sp_mat,
    *                    std::vector<std::vector<>>.
@@ -202,6 +210,28 @@ class StringEncoding
                     typename std::enable_if<StringEncodingPolicyTraits<
                         PolicyType>::onePassEncoding>::type* = 0);
 
+  /**
+   * A helper function to encode the given text and write the result to
+   * the given sparse matrix. The policy writes the result to a
+   * SparseEncodingOutput, from which the sparse matrix is built at once, so
+   * that the elements are not inserted into the sparse matrix one at a time.
+   *
+   * @tparam TokenizerType Type of the tokenizer.
+   * @tparam PolicyType The type of the encoding policy. It has to be
+   *                    equal to EncodingPolicyType.
+   * @tparam ElemType Type of the output values.
+   *
+   * @param input Corpus of text to encode.
+   * @param output Output sparse matrix to store the result.
+   * @param tokenizer The tokenizer object.
+   * @param policy The policy object.
+   */
+  template<typename TokenizerType, typename PolicyType, typename ElemType>
+  void EncodeHelper(const std::vector<std::string>& input,
+                    arma::SpMat<ElemType>& output,
+                    const TokenizerType& tokenizer,
+                    PolicyType& policy);
+
  private:
   //! The encoding policy object.
   EncodingPolicyType encodingPolicy;
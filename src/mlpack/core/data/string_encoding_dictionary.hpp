@@ -106,12 +106,18 @@ class StringEncodingDictionary
 
 /*
  * Specialization of the StringEncodingDictionary class for boost::string_view.
+ *
+ * Each distinct token is stored once: the characters of all of the tokens are
+ * kept contiguously in one string in the order of their labels, and the tokens
+ * are found with an open addressing hash table that holds only the labels.  So
+ * the dictionary needs much less memory than a map of std::string objects, and
+ * the views returned by Token() stay valid until the dictionary is modified.
  */
 template<>
 class StringEncodingDictionary<boost::string_view>
 {
  public:
-  //! A convenient alias for the internal type of the map.
+  //! A convenient alias for the type of the map returned by Mapping().
   using MapType = std::unordered_map<
       boost::string_view,
       size_t,
@@ -120,36 +126,6 @@ class StringEncodingDictionary<boost::string_view>
   //! The type of the token that the dictionary stores.
   using TokenType = boost::string_view;
 
-  //! Construct the default class.
-  StringEncodingDictionary() = default;
-
-  //! Copy the class from the given object.
-  StringEncodingDictionary(const StringEncodingDictionary& other) :
-      tokens(other.tokens)
-  {
-    for (const std::string& token : tokens)
-      mapping[token] = other.mapping.at(token);
-  }
-
-  //! Standard move constructor.
-  StringEncodingDictionary(StringEncodingDictionary&& other) = default;
-
-  //! Copy the class from the given object.
-  StringEncodingDictionary& operator=(const StringEncodingDictionary& other)
-  {
-    tokens = other.tokens;
-    mapping.clear();
-
-    for (const std::string& token : tokens)
-      mapping[token] = other.mapping.at(token);
-
-    return *this;
-  }
-
-  //! Standard move assignment operator.
-  StringEncodingDictionary& operator=(
-      StringEncodingDictionary&& other) = default;
-
   /**
    * The function returns true if the dictionary contains the given token.
    *
@@ -157,25 +133,32 @@ class StringEncodingDictionary<boost::string_view>
    */
   bool HasToken(const boost::string_view token) const
   {
-    return mapping.find(token) != mapping.end();
+    return !table.empty() && table[FindSlot(token)] != 0;
   }
 
   /**
    * The function adds the given token to the dictionary and assigns a label
    * to the token. The label is equal to the resulting size of the dictionary.
-   * The function returns the assigned label.
+   * The function returns the assigned label.  If the dictionary already
+   * contains the token, its label is returned.
    *
    * @param token The given token.
    */
   size_t AddToken(const boost::string_view token)
   {
-    tokens.emplace_back(token);
+    // Keep the load factor of the table at most one half.
+    if (2 * (Size() + 1) > table.size())
+      Rehash(std::max<size_t>(16, 2 * table.size()));
 
-    size_t size = mapping.size();
+    const size_t slot = FindSlot(token);
+    if (table[slot] != 0)
+      return table[slot];
 
-    mapping[tokens.back()] = ++size;
+    characters.append(token.data(), token.size());
+    tokenEnds.push_back(characters.size());
+    table[slot] = Size();
 
-    return size;
+    return Size();
   }
 
   /**
@@ -186,28 +169,70 @@ class StringEncodingDictionary<boost::string_view>
    */
   size_t Value(const boost::string_view token) const
   {
-    return mapping.at(token);
+    const size_t label = table.empty() ? 0 : table[FindSlot(token)];
+    if (label == 0)
+    {
+      throw std::out_of_range("StringEncodingDictionary::Value(): the token "
+          "is not in the dictionary!");
+    }
+
+    return label;
+  }
+
+  /**
+   * The function returns the token with the given label, which must belong to
+   * [1, Size()].
+   *
+   * @param label The label of the token.
+   */
+  boost::string_view Token(const size_t label) const
+  {
+    const size_t begin = (label == 1) ? 0 : tokenEnds[label - 2];
+    return boost::string_view(characters.data() + begin,
+        tokenEnds[label - 1] - begin);
   }
 
   //! Get the size of the dictionary.
-  size_t Size() const { return mapping.size(); }
+  size_t Size() const { return tokenEnds.size(); }
 
   //! Clear the dictionary.
   void Clear()
   {
-    mapping.clear();
-    tokens.clear();
+    characters.clear();
+    tokenEnds.clear();
+    table.clear();
   }
 
-  //! Get the tokens.
-  const std::deque<std::string>& Tokens() const { return tokens; }
-  //! Modify the tokens.
-  std::deque<std::string>& Tokens() { return tokens; }
+  /**
+   * Get the mapping from the tokens to their labels.  The map is built on each
+   * call, and its keys refer to the tokens stored in the dictionary.
+   */
+  MapType Mapping() const
+  {
+    MapType mapping;
+    for (size_t label = 1; label <= Size(); ++label)
+      mapping[Token(label)] = label;
 
-  //! Get the mapping.
-  const MapType& Mapping() const { return mapping; }
-  //! Modify the mapping.
-  MapType& Mapping() { return mapping; }
+    return mapping;
+  }
+
+  /**
+   * Get a copy of the tokens, in the order of their labels.  The tokens are no
+   * longer stored as separate strings, so this copies all of them; modifying
+   * the returned tokens doesn't modify the dictionary.
+   *
+   * @note
+   * This method has been deprecated and will be removed in mlpack 4.0.0.  Use
+   * Token() instead.
+   */
+  mlpack_deprecated std::deque<std::string> Tokens() const
+  {
+    std::deque<std::string> tokens;
+    for (size_t label = 1; label <= Size(); ++label)
+      tokens.emplace_back(Token(label).to_string());
+
+    return tokens;
+  }
 
   /**
    * Serialize the class to the given archive.
@@ -215,41 +240,82 @@ class StringEncodingDictionary<boost::string_view>
   template<typename Archive>
   void serialize(Archive& ar, const unsigned int /* version */)
   {
-    size_t numTokens = tokens.size();
+    size_t numTokens = Size();
 
     ar & BOOST_SERIALIZATION_NVP(numTokens);
 
     if (Archive::is_loading::value)
     {
-      tokens.resize(numTokens);
+      std::vector<std::string> tokens(numTokens);
 
-      for (std::string& token : tokens)
+      for (size_t i = 0; i < numTokens; ++i)
       {
+        std::string token;
         ar & BOOST_SERIALIZATION_NVP(token);
 
         size_t tokenValue = 0;
         ar & BOOST_SERIALIZATION_NVP(tokenValue);
-        mapping[token] = tokenValue;
+        if (tokenValue == 0 || tokenValue > numTokens)
+        {
+          throw std::runtime_error("StringEncodingDictionary::serialize(): "
+              "invalid token label!");
+        }
+
+        tokens[tokenValue - 1] = std::move(token);
       }
+
+      Clear();
+      for (const std::string& token : tokens)
+        AddToken(token);
     }
     if (Archive::is_saving::value)
     {
-      for (std::string& token : tokens)
+      for (size_t label = 1; label <= numTokens; ++label)
       {
+        std::string token = Token(label).to_string();
         ar & BOOST_SERIALIZATION_NVP(token);
 
-        size_t tokenValue = mapping.at(token);
+        size_t tokenValue = label;
         ar & BOOST_SERIALIZATION_NVP(tokenValue);
       }
     }
   }
 
  private:
-  //! The tokens that the dictionary stores.
-  std::deque<std::string> tokens;
+  /**
+   * Find the slot of the table that holds the label of the given token, or
+   * the empty slot where the label should be stored.  The table must not be
+   * empty.
+   *
+   * @param token The given token.
+   */
+  size_t FindSlot(const boost::string_view token) const
+  {
+    const size_t mask = table.size() - 1;
+    size_t slot = boost::hash<boost::string_view>()(token) & mask;
+    while (table[slot] != 0 && Token(table[slot]) != token)
+      slot = (slot + 1) & mask;
 
-  //! The mapping itself.
-  MapType mapping;
+    return slot;
+  }
+
+  //! Rebuild the table with the given number of slots (a power of two).
+  void Rehash(const size_t numSlots)
+  {
+    table.assign(numSlots, 0);
+    for (size_t label = 1; label <= Size(); ++label)
+      table[FindSlot(Token(label))] = label;
+  }
+
+  //! The characters of all of the tokens, in the order of their labels.
+  std::string characters;
+
+  //! The end of each token in the characters; the token with label i ends at
+  //! tokenEnds[i - 1].
+  std::vector<size_t> tokenEnds;
+
+  //! The hash table of the labels (zero marks an empty slot).
+  std::vector<size_t> table;
 };
 
 template<>
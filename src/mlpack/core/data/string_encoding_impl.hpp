@@ -16,6 +16,7 @@
 // In case it hasn't been included yet.
 #include "string_encoding.hpp"
 #include <type_traits>
+#include <algorithm>
 
 namespace mlpack {
 namespace data {
@@ -105,53 +106,107 @@ EncodeHelper(const std::vector<std::string>& input,
              const TokenizerType& tokenizer,
              PolicyType& policy)
 {
-  size_t numColumns = 0;
+  typedef typename std::remove_reference<typename DictionaryType::TokenType>::
+      type TokenType;
 
   policy.Reset();
 
-  // The first pass adds the extracted tokens to the dictionary.
-  for (size_t i = 0; i < input.size(); i++)
+  // The first pass finds the tokens which are not in the dictionary yet.  Each
+  // thread tokenizes a contiguous shard of the input and keeps the new tokens
+  // in the order of their first occurrence, so merging the shards in order
+  // labels the tokens exactly as a serial pass would.
+  size_t numShards = 1;
+  #ifdef HAS_OPENMP
+    numShards = omp_get_max_threads();
+  #endif
+  numShards = std::max<size_t>(1, std::min(numShards, input.size()));
+
+  std::vector<std::vector<TokenType>> newTokens(numShards);
+  std::vector<size_t> numTokens(input.size());
+
+  #pragma omp parallel for schedule(static, 1)
+  for (omp_size_t shard = 0; shard < (omp_size_t) numShards; ++shard)
   {
-    boost::string_view strView(input[i]);
-    auto token = tokenizer(strView);
+    const size_t begin = shard * input.size() / numShards;
+    const size_t end = (shard + 1) * input.size() / numShards;
+    DictionaryType shardDictionary;
 
-    static_assert(
-        std::is_same<typename std::remove_reference<decltype(token)>::type,
-                     typename std::remove_reference<typename DictionaryType::
-                        TokenType>::type>::value,
-        "The dictionary token type doesn't match the return value type "
-        "of the tokenizer.");
-
-    size_t numTokens = 0;
+    for (size_t i = begin; i < end; i++)
+    {
+      boost::string_view strView(input[i]);
+      auto token = tokenizer(strView);
+
+      static_assert(
+          std::is_same<typename std::remove_reference<decltype(token)>::type,
+                       TokenType>::value,
+          "The dictionary token type doesn't match the return value type "
+          "of the tokenizer.");
+
+      while (!tokenizer.IsTokenEmpty(token))
+      {
+        if (!dictionary.HasToken(token) && !shardDictionary.HasToken(token))
+        {
+          newTokens[shard].push_back(token);
+          shardDictionary.AddToken(std::move(token));
+        }
+
+        token = tokenizer(strView);
+        numTokens[i]++;
+      }
+    }
+  }
 
-    while (!tokenizer.IsTokenEmpty(token))
+  for (size_t shard = 0; shard < numShards; ++shard)
+  {
+    for (TokenType& token : newTokens[shard])
     {
       if (!dictionary.HasToken(token))
         dictionary.AddToken(std::move(token));
-
-      policy.PreprocessToken(i, numTokens, dictionary.Value(token));
-
-      token = tokenizer(strView);
-      numTokens++;
     }
+  }
+  newTokens.clear();
 
-    numColumns = std::max(numColumns, numTokens);
+  // The statistics of the policy are not thread-safe, so the tokens are
+  // preprocessed serially, and only if the policy needs that.
+  if (StringEncodingPolicyTraits<PolicyType>::preprocessTokens)
+  {
+    for (size_t i = 0; i < input.size(); i++)
+    {
+      boost::string_view strView(input[i]);
+      auto token = tokenizer(strView);
+      size_t index = 0;
+
+      while (!tokenizer.IsTokenEmpty(token))
+      {
+        policy.PreprocessToken(i, index, dictionary.Value(token));
+        token = tokenizer(strView);
+        index++;
+      }
+    }
   }
 
+  const size_t numColumns = numTokens.empty() ? 0 :
+      *std::max_element(numTokens.begin(), numTokens.end());
   policy.InitMatrix(output, input.size(), numColumns, dictionary.Size());
 
-  // The second pass writes the encoded values to the output.
-  for (size_t i = 0; i < input.size(); i++)
+  // The second pass writes the encoded values to the output.  Each line is
+  // written to its own column (or row) of the output, so the lines may be
+  // encoded in parallel, except for a sparse output, which has to be written
+  // in order.
+  const bool parallelEncoding = !IsSparseEncodingOutput<MatType>::value;
+
+  #pragma omp parallel for schedule(dynamic, 16) if (parallelEncoding)
+  for (omp_size_t i = 0; i < (omp_size_t) input.size(); i++)
   {
     boost::string_view strView(input[i]);
     auto token = tokenizer(strView);
-    size_t numTokens = 0;
+    size_t index = 0;
 
     while (!tokenizer.IsTokenEmpty(token))
     {
-      policy.Encode(output, dictionary.Value(token), i, numTokens);
+      policy.Encode(output, dictionary.Value(token), i, index);
       token = tokenizer(strView);
-      numTokens++;
+      index++;
     }
   }
 }
@@ -196,6 +251,19 @@ EncodeHelper(const std::vector<std::string>& input,
   }
 }
 
+template<typename EncodingPolicyType, typename DictionaryType>
+template<typename TokenizerType, typename PolicyType, typename ElemType>
+void StringEncoding<EncodingPolicyType, DictionaryType>::
+EncodeHelper(const std::vector<std::string>& input,
+             arma::SpMat<ElemType>& output,
+             const TokenizerType& tokenizer,
+             PolicyType& policy)
+{
+  SparseEncodingOutput<ElemType> sparseOutput;
+  EncodeHelper(input, sparseOutput, tokenizer, policy);
+  sparseOutput.Finish(output);
+}
+
 template<typename EncodingPolicyType, typename DictionaryType>
 template<typename Archive>
 void StringEncoding<EncodingPolicyType, DictionaryType>::serialize(
@@ -156,6 +156,26 @@ class BagOfWordsEncodingPolicy
   }
 };
 
+/**
+ * The specialization provides some information about the bag of words encoding
+ * policy.
+ */
+template<>
+struct StringEncodingPolicyTraits<BagOfWordsEncodingPolicy>
+{
+  /**
+   * Indicates if the policy is able to encode the token at once without
+   * any information about other tokens as well as the total tokens count.
+   */
+  static const bool onePassEncoding = false;
+
+  /**
+   * Indicates if the policy has to see every token in the first pass through
+   * the dataset (via PreprocessToken()) before encoding.
+   */
+  static const bool preprocessTokens = false;
+};
+
 /**
  * A convenient alias for the StringEncoding class with BagOfWordsEncodingPolicy
  * and the default dictionary for the given token type.
@@ -165,6 +185,17 @@ class BagOfWordsEncodingPolicy
 template<typename TokenType>
 using BagOfWordsEncoding = StringEncoding<BagOfWordsEncodingPolicy,
                                           StringEncodingDictionary<TokenType>>;
+
+/**
+ * A convenient alias for the StringEncoding class with BagOfWordsEncodingPolicy
+ * and the hashing dictionary for the given token type, which does not store
+ * the tokens (see HashingDictionary).
+ *
+ * @tparam TokenType Type of the tokens.
+ */
+template<typename TokenType>
+using HashingBagOfWordsEncoding = StringEncoding<BagOfWordsEncodingPolicy,
+                                                 HashingDictionary<TokenType>>;
 } // namespace data
 } // namespace mlpack
 
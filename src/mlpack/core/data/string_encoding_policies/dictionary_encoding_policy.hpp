@@ -133,6 +133,12 @@ struct StringEncodingPolicyTraits<DictionaryEncodingPolicy>
    * any information about other tokens as well as the total tokens count.
    */
   static const bool onePassEncoding = true;
+
+  /**
+   * Indicates if the policy has to see every token in the first pass through
+   * the dataset (via PreprocessToken()) before encoding.
+   */
+  static const bool preprocessTokens = false;
 };
 
 /**
@@ -31,6 +31,12 @@ struct StringEncodingPolicyTraits
    * any information about other tokens as well as the total tokens count.
    */
   static const bool onePassEncoding = false;
+
+  /**
+   * Indicates if the policy has to see every token in the first pass through
+   * the dataset (via PreprocessToken()) before encoding.
+   */
+  static const bool preprocessTokens = true;
 };
 
 } // namespace data
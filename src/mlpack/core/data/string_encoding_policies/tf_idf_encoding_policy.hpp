@@ -152,11 +152,11 @@ class TfIdfEncodingPolicy
   {
     const typename MatType::elem_type tf =
         TermFrequency<typename MatType::elem_type>(
-            tokensFrequences[line][value], linesSizes[line]);
+            tokensFrequences[line].at(value), linesSizes[line]);
 
     const typename MatType::elem_type idf =
         InverseDocumentFrequency<typename MatType::elem_type>(
-            output.n_cols, numContainingStrings[value]);
+            output.n_cols, numContainingStrings.at(value));
 
     output(value - 1, line) =  tf * idf;
   }
@@ -183,10 +183,10 @@ class TfIdfEncodingPolicy
               const size_t /* index */)
   {
     const ElemType tf = TermFrequency<ElemType>(
-        tokensFrequences[line][value], linesSizes[line]);
+        tokensFrequences[line].at(value), linesSizes[line]);
 
     const ElemType idf = InverseDocumentFrequency<ElemType>(
-        output.size(), numContainingStrings[value]);
+        output.size(), numContainingStrings.at(value));
 
     output[line][value - 1] =  tf * idf;
   }
@@ -343,6 +343,17 @@ class TfIdfEncodingPolicy
 template<typename TokenType>
 using TfIdfEncoding = StringEncoding<TfIdfEncodingPolicy,
                                      StringEncodingDictionary<TokenType>>;
+
+/**
+ * A convenient alias for the StringEncoding class with TfIdfEncodingPolicy and
+ * the hashing dictionary for the given token type, which does not store the
+ * tokens (see HashingDictionary).
+ *
+ * @tparam TokenType Type of the tokens.
+ */
+template<typename TokenType>
+using HashingTfIdfEncoding = StringEncoding<TfIdfEncodingPolicy,
+                                            HashingDictionary<TokenType>>;
 } // namespace data
 } // namespace mlpack
 
@@ -50,6 +50,50 @@ arma::vec DiscreteDistribution::Random() const
   return result;
 }
 
+/**
+ * Return a set of randomly generated observations according to the probability
+ * distribution defined by this object.
+ */
+arma::mat DiscreteDistribution::Random(const size_t samples) const
+{
+  const size_t dimension = probabilities.size();
+
+  // Random() takes the last observation of a dimension whose probabilities sum
+  // to more than one; otherwise, the first one whose cumulative probability
+  // reaches the random number.
+  std::vector<arma::vec> cumulative(dimension);
+  std::vector<bool> useLast(dimension);
+  for (size_t d = 0; d < dimension; d++)
+  {
+    cumulative[d] = arma::cumsum(probabilities[d]);
+    useLast[d] = (cumulative[d].n_elem > 0 &&
+        cumulative[d][cumulative[d].n_elem - 1] > 1.0);
+  }
+
+  // Draw the random numbers in the same order as repeated calls to Random().
+  arma::mat result(dimension, samples);
+  for (size_t i = 0; i < samples; i++)
+  {
+    for (size_t d = 0; d < dimension; d++)
+    {
+      const double randObs = math::Random();
+      const size_t last = probabilities[d].n_elem - 1;
+      if (useLast[d])
+      {
+        result(d, i) = last;
+        continue;
+      }
+
+      const double* begin = cumulative[d].memptr();
+      const size_t obs = std::lower_bound(begin, begin + cumulative[d].n_elem,
+          randObs) - begin;
+      result(d, i) = std::min(obs, last);
+    }
+  }
+
+  return result;
+}
+
 /**
  * Estimate the probability distribution directly from the given observations.
  */
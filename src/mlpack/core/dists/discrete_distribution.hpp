@@ -207,6 +207,17 @@ class DiscreteDistribution
    */
   arma::vec Random() const;
 
+  /**
+   * Return the given number of randomly generated observations (one per
+   * column) according to the probability distribution defined by this object.
+   * The result is the same as that of the given number of calls to Random(),
+   * but each observation is found with a binary search.
+   *
+   * @param samples Number of observations to generate.
+   * @return Random observations.
+   */
+  arma::mat Random(const size_t samples) const;
+
   /**
    * Estimate the probability distribution directly from the given
    * observations. If any of the observations is greater than numObservations,
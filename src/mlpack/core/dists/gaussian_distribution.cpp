@@ -12,6 +12,7 @@
  */
 #include "gaussian_distribution.hpp"
 #include <mlpack/methods/gmm/positive_definite_constraint.hpp>
+#include <mlpack/core/math/running_covariance.hpp>
 
 using namespace mlpack;
 using namespace mlpack::distribution;
@@ -88,12 +89,7 @@ arma::vec GaussianDistribution::Random() const
  */
 void GaussianDistribution::Train(const arma::mat& observations)
 {
-  if (observations.n_cols > 0)
-  {
-    mean.zeros(observations.n_rows);
-    covariance.zeros(observations.n_rows, observations.n_rows);
-  }
-  else // This will end up just being empty.
+  if (observations.n_cols == 0) // This will end up just being empty.
   {
     // TODO(stephentu): why do we allow this case? why not throw an error?
     mean.zeros(0);
@@ -101,23 +97,14 @@ void GaussianDistribution::Train(const arma::mat& observations)
     return;
   }
 
-  // Calculate the mean.
-  for (size_t i = 0; i < observations.n_cols; i++)
-    mean += observations.col(i);
-
-  // Normalize the mean.
-  mean /= observations.n_cols;
-
-  // Now calculate the covariance.
-  for (size_t i = 0; i < observations.n_cols; i++)
-  {
-    arma::vec obsNoMean = observations.col(i) - mean;
-    covariance += obsNoMean * trans(obsNoMean);
-  }
+  // Calculate the mean and the covariance in one pass.
+  math::RunningCovariance<> statistics(observations.n_rows);
+  statistics.Update(observations);
+  mean = statistics.Mean();
 
   // Finish estimating the covariance by normalizing, with the (1 / (n - 1)) so
   // that it is the unbiased estimator.
-  covariance /= (observations.n_cols - 1);
+  covariance = statistics.Covariance(0);
 
   // Ensure that the covariance is positive definite.
   gmm::PositiveDefiniteConstraint::ApplyConstraint(covariance);
@@ -133,12 +120,7 @@ void GaussianDistribution::Train(const arma::mat& observations)
 void GaussianDistribution::Train(const arma::mat& observations,
                                  const arma::vec& probabilities)
 {
-  if (observations.n_cols > 0)
-  {
-    mean.zeros(observations.n_rows);
-    covariance.zeros(observations.n_rows, observations.n_rows);
-  }
-  else // This will end up just being empty.
+  if (observations.n_cols == 0) // This will end up just being empty.
   {
     // TODO(stephentu): same as above
     mean.zeros(0);
@@ -146,39 +128,25 @@ void GaussianDistribution::Train(const arma::mat& observations,
     return;
   }
 
-  double sumProb = 0;
-
-  // First calculate the mean, and save the sum of all the probabilities for
-  // later normalization.
-  for (size_t i = 0; i < observations.n_cols; i++)
-  {
-    mean += probabilities[i] * observations.col(i);
-    sumProb += probabilities[i];
-  }
+  // Calculate the weighted mean and covariance in one pass.
+  math::RunningCovariance<> statistics(observations.n_rows);
+  statistics.Update(observations, probabilities);
 
-  if (sumProb == 0)
+  if (statistics.Weight() == 0)
   {
     // Nothing in this Gaussian!  At least set the covariance so that it's
     // invertible.
+    mean.zeros(observations.n_rows);
+    covariance.zeros(observations.n_rows, observations.n_rows);
     covariance.diag() += 1e-50;
     FactorCovariance();
     return;
   }
 
-  // Normalize.
-  if (sumProb > 0)
-    mean /= sumProb;
-
-  // Now find the covariance.
-  for (size_t i = 0; i < observations.n_cols; i++)
-  {
-    arma::vec obsNoMean = observations.col(i) - mean;
-    covariance += probabilities[i] * (obsNoMean * trans(obsNoMean));
-  }
+  mean = statistics.Mean();
 
   // This is probably biased, but I don't know how to unbias it.
-  if (sumProb > 0)
-    covariance /= sumProb;
+  covariance = statistics.Covariance(1);
 
   // Ensure that the covariance is positive definite.
   gmm::PositiveDefiniteConstraint::ApplyConstraint(covariance);
@@ -90,16 +90,27 @@ class GaussianDistribution
    */
   void Probability(const arma::mat& x, arma::vec& probabilities) const
   {
-    probabilities.set_size(x.n_cols);
-    for (size_t i = 0; i < x.n_cols; i++)
-    {
-      probabilities(i) = Probability(x.unsafe_col(i));
-    }
+    LogProbability(x, probabilities);
+    probabilities = arma::exp(probabilities);
+  }
+
+  /**
+   * Calculates the multivariate Gaussian probability density function for each
+   * data point (column) in the given single-precision matrix.
+   *
+   * @param x List of observations.
+   * @param probabilities Output probabilities for each input observation.
+   */
+  void Probability(const arma::fmat& x, arma::fvec& probabilities) const
+  {
+    LogProbability(x, probabilities);
+    probabilities = arma::exp(probabilities);
   }
 
   /**
    * Returns the Log probability of the given matrix. These values are stored
-   * in logProbabilities.
+   * in logProbabilities.  All of the observations are handled at once with a
+   * triangular solve against the Cholesky factor of the covariance.
    *
    * @param x List of observations.
    * @param logProbabilities Output log probabilities for each input
@@ -107,20 +118,20 @@ class GaussianDistribution
    */
   void LogProbability(const arma::mat& x, arma::vec& logProbabilities) const
   {
-    // Column i of 'diffs' is the difference between x.col(i) and the mean.
-    arma::mat diffs = x;
-    diffs.each_col() -= mean;
-    // Now, we only want to calculate the diagonal elements of (diffs' * cov^-1
-    // * diffs).  We just don't need any of the other elements.  We can
-    // calculate the right hand part of the equation (instead of the left side)
-    // so that later we are referencing columns, not rows -- that is faster.
-    const arma::mat rhs = -0.5 * invCov * diffs;
-    arma::vec logExponents(diffs.n_cols); // We will now fill this.
-    for (size_t i = 0; i < diffs.n_cols; i++)
-      logExponents(i) = accu(diffs.unsafe_col(i) % rhs.unsafe_col(i));
-
-    logProbabilities = -0.5 * x.n_rows * log2pi - 0.5 * logDetCov +
-      logExponents;
+    BatchLogProbability(x, logProbabilities);
+  }
+
+  /**
+   * Returns the log probability of each observation of the given
+   * single-precision matrix; the computation is done in single precision.
+   *
+   * @param x List of observations.
+   * @param logProbabilities Output log probabilities for each input
+   *     observation.
+   */
+  void LogProbability(const arma::fmat& x, arma::fvec& logProbabilities) const
+  {
+    BatchLogProbability(x, logProbabilities);
   }
 
   /**
@@ -195,6 +206,35 @@ class GaussianDistribution
    * a std::runtime_error will be thrown.
    */
   void FactorCovariance();
+
+  /**
+   * Compute the log probability of each column of x.  If cov = L L^T, the
+   * Mahalanobis distance of a point is the squared norm of L^-1 (x - mean), so
+   * all the points are solved for with one triangular solve (a level 3 BLAS
+   * operation) instead of one matrix-vector product each.
+   */
+  template<typename eT>
+  void BatchLogProbability(const arma::Mat<eT>& x,
+                           arma::Col<eT>& logProbabilities) const
+  {
+    if (x.n_cols == 0)
+    {
+      logProbabilities.set_size(0);
+      return;
+    }
+
+    // Column i of 'diffs' is the difference between x.col(i) and the mean.
+    arma::Mat<eT> diffs = x;
+    diffs.each_col() -= arma::conv_to<arma::Col<eT>>::from(mean);
+
+    const arma::Mat<eT> lower = arma::conv_to<arma::Mat<eT>>::from(covLower);
+    const arma::Mat<eT> whitened = arma::solve(arma::trimatl(lower), diffs,
+        arma::solve_opts::fast);
+
+    const eT logNormalizer = (eT) (-0.5 * x.n_rows * log2pi - 0.5 * logDetCov);
+    logProbabilities = logNormalizer - (eT) 0.5 *
+        arma::sum(arma::square(whitened), 0).t();
+  }
 };
 
 } // namespace distribution
@@ -14,6 +14,8 @@
 
 #include <mlpack/core/cv/meta_info_extractor.hpp>
 #include <mlpack/core/hpt/deduce_hp_types.hpp>
+#include <mlpack/core/hpt/random_search.hpp>
+#include <mlpack/core/hpt/tpe_search.hpp>
 #include <ensmallen.hpp>
 
 namespace mlpack {
@@ -71,8 +73,8 @@ namespace hpt {
  * @tparam Metric A metric to assess the quality of a trained model.
  * @tparam CV A cross-validation strategy used to assess a set of
  *     hyper-parameters.
- * @tparam OptimizerType An optimization strategy (GridSearch and
- *     GradientDescent are supported).
+ * @tparam OptimizerType An optimization strategy (GridSearch,
+ *     GradientDescent, RandomSearch and TPESearch are supported).
  * @tparam MatType The type of data.
  * @tparam PredictionsType The type of predictions (should be passed when the
  *     predictions type is a template parameter in Train methods of the given
@@ -154,10 +156,12 @@ class HyperParameterTuner
   /**
    * Find the best hyper-parameters by using the given Optimizer. For each
    * hyper-parameter one of the following should be passed as an argument.
-   * 1. A set of values to choose from (when using GridSearch as an optimizer).
+   * 1. A set of values to choose from (when using GridSearch, RandomSearch or
+   *   TPESearch as an optimizer).
    *   The set of values should be an STL-compatible container (it should
    *   provide begin() and end() methods returning iterators).
-   * 2. A starting value (when using any other optimizer than GridSearch).
+   * 2. A starting value (when using any other optimizer than GridSearch,
+   *   RandomSearch or TPESearch).
    * 3. A value fixed by using the function mlpack::hpt::Fixed. In this case the
    *   hyper-parameter will not be optimized.
    *
@@ -0,0 +1,180 @@
+/**
+ * @file core/hpt/random_search.hpp
+ *
+ * Random search over the sets of values of hyper-parameters.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_HPT_RANDOM_SEARCH_HPP
+#define MLPACK_CORE_HPT_RANDOM_SEARCH_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <chrono>
+#include <set>
+
+namespace mlpack {
+namespace hpt {
+
+/**
+ * RandomSearch is an optimizer for HyperParameterTuner that evaluates
+ * configurations drawn at random from the grid given by the sets of values of
+ * the hyper-parameters, rather than every configuration of the grid as
+ * ens::GridSearch does.  No configuration is evaluated twice, and the search
+ * stops when the budget (a number of evaluations, a time limit, or both) is
+ * spent, or when every configuration has been evaluated.  Random search often
+ * finds a good configuration with a small fraction of the evaluations of a
+ * grid search, since only a few of the hyper-parameters usually matter.
+ *
+ * @code
+ * HyperParameterTuner<LARS, MSE, SimpleCV, RandomSearch> hpt(validationSize,
+ *     data, responses);
+ * hpt.Optimizer().MaxEvaluations() = 30;
+ *
+ * double bestLambda1, bestLambda2;
+ * std::tie(bestLambda1, bestLambda2) = hpt.Optimize(Fixed(true), Fixed(false),
+ *     lambda1Set, lambda2Set);
+ * @endcode
+ *
+ * Numeric (non-categorical) hyper-parameters keep their starting values; only
+ * hyper-parameters given as sets of values are searched.  The random numbers
+ * are drawn with mlpack::math::RandInt(), so the search can be reproduced with
+ * mlpack::math::RandomSeed().
+ */
+class RandomSearch
+{
+ public:
+  /**
+   * Create the search with the given budget.
+   *
+   * @param maxEvaluations Maximum number of configurations to evaluate.
+   * @param maxTime Maximum time to search for, in seconds (0 means no limit).
+   *     At least one configuration is always evaluated.
+   */
+  RandomSearch(const size_t maxEvaluations = 50, const double maxTime = 0.0) :
+      maxEvaluations(maxEvaluations),
+      maxTime(maxTime)
+  { /* Nothing to do. */ }
+
+  /**
+   * Find the configuration that minimizes the given function.  The function
+   * must provide double Evaluate(const arma::mat& parameters).
+   *
+   * @param function Function to minimize.
+   * @param bestParameters Starting values of the parameters; overwritten with
+   *     the best configuration found.
+   * @param categoricalDimensions Whether each parameter is categorical.
+   * @param numCategories Number of values of each categorical parameter.
+   * @return The objective of the best configuration.
+   */
+  template<typename FunctionType>
+  double Optimize(FunctionType& function,
+                  arma::mat& bestParameters,
+                  const std::vector<bool>& categoricalDimensions,
+                  const arma::Row<size_t>& numCategories);
+
+  //! Get the maximum number of evaluations.
+  size_t MaxEvaluations() const { return maxEvaluations; }
+  //! Modify the maximum number of evaluations.
+  size_t& MaxEvaluations() { return maxEvaluations; }
+
+  //! Get the time limit in seconds (0 means no limit).
+  double MaxTime() const { return maxTime; }
+  //! Modify the time limit in seconds (0 means no limit).
+  double& MaxTime() { return maxTime; }
+
+ private:
+  //! The maximum number of evaluations.
+  size_t maxEvaluations;
+  //! The time limit in seconds.
+  double maxTime;
+};
+
+namespace details {
+
+/**
+ * Keep track of the budget of a search and of the configurations that have
+ * been evaluated, so that no configuration is evaluated twice.
+ */
+class SearchState
+{
+ public:
+  /**
+   * Start a search over the given parameters, with the given budget.
+   */
+  SearchState(const std::vector<bool>& categoricalDimensions,
+              const arma::Row<size_t>& numCategories,
+              const arma::mat& startingParameters,
+              const size_t maxEvaluations,
+              const double maxTime);
+
+  //! Return true if the budget allows another evaluation.
+  bool CanEvaluate() const;
+
+  //! Return true if the given configuration has already been evaluated.
+  bool Evaluated(const arma::mat& parameters) const;
+
+  /**
+   * Draw a configuration that hasn't been evaluated yet uniformly at random.
+   * The search must not be exhausted.
+   */
+  void RandomConfiguration(arma::mat& parameters) const;
+
+  /**
+   * Evaluate the given configuration with the function, and update the best
+   * configuration if needed.
+   */
+  template<typename FunctionType>
+  double Evaluate(FunctionType& function, const arma::mat& parameters);
+
+  //! Get the best configuration.
+  const arma::mat& BestParameters() const { return bestParameters; }
+  //! Get the objective of the best configuration.
+  double BestObjective() const { return bestObjective; }
+
+  //! Get the evaluated configurations, one per column.
+  const arma::mat& Configurations() const { return configurations; }
+  //! Get the objectives of the evaluated configurations.
+  const std::vector<double>& Objectives() const { return objectives; }
+
+  //! Get whether each parameter is categorical.
+  const std::vector<bool>& CategoricalDimensions() const
+  { return categoricalDimensions; }
+  //! Get the number of values of each categorical parameter.
+  const arma::Row<size_t>& NumCategories() const { return numCategories; }
+
+ private:
+  //! Whether each parameter is categorical.
+  const std::vector<bool>& categoricalDimensions;
+  //! The number of values of each categorical parameter.
+  const arma::Row<size_t>& numCategories;
+  //! The number of distinct configurations (as a double to avoid overflow).
+  double numConfigurations;
+  //! The maximum number of evaluations.
+  size_t maxEvaluations;
+  //! The time limit in seconds.
+  double maxTime;
+  //! The time the search started.
+  std::chrono::steady_clock::time_point start;
+  //! The evaluated configurations.
+  std::set<std::vector<double>> evaluated;
+  //! The evaluated configurations, one per column.
+  arma::mat configurations;
+  //! The objectives of the evaluated configurations.
+  std::vector<double> objectives;
+  //! The best configuration.
+  arma::mat bestParameters;
+  //! The objective of the best configuration.
+  double bestObjective;
+};
+
+} // namespace details
+} // namespace hpt
+} // namespace mlpack
+
+// Include implementation.
+#include "random_search_impl.hpp"
+
+#endif
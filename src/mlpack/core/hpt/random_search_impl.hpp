@@ -0,0 +1,146 @@
+/**
+ * @file core/hpt/random_search_impl.hpp
+ *
+ * Implementation of random search over the sets of values of hyper-parameters.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_HPT_RANDOM_SEARCH_IMPL_HPP
+#define MLPACK_CORE_HPT_RANDOM_SEARCH_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "random_search.hpp"
+
+#include <mlpack/core/math/random.hpp>
+
+namespace mlpack {
+namespace hpt {
+namespace details {
+
+inline SearchState::SearchState(const std::vector<bool>& categoricalDimensions,
+                                const arma::Row<size_t>& numCategories,
+                                const arma::mat& startingParameters,
+                                const size_t maxEvaluations,
+                                const double maxTime) :
+    categoricalDimensions(categoricalDimensions),
+    numCategories(numCategories),
+    numConfigurations(1.0),
+    maxEvaluations(maxEvaluations),
+    maxTime(maxTime),
+    start(std::chrono::steady_clock::now()),
+    configurations(startingParameters.n_elem, 0),
+    bestParameters(startingParameters),
+    bestObjective(std::numeric_limits<double>::max())
+{
+  if (maxEvaluations == 0)
+    throw std::invalid_argument("the maximum number of evaluations must be "
+        "positive");
+
+  if (categoricalDimensions.size() != startingParameters.n_elem ||
+      numCategories.n_elem != startingParameters.n_elem)
+  {
+    throw std::invalid_argument("the number of categorical dimensions and "
+        "categories must match the number of parameters");
+  }
+
+  for (size_t d = 0; d < categoricalDimensions.size(); ++d)
+  {
+    if (categoricalDimensions[d])
+    {
+      if (numCategories[d] == 0)
+      {
+        throw std::invalid_argument("categorical dimension " +
+            std::to_string(d) + " has no categories");
+      }
+
+      numConfigurations *= numCategories[d];
+    }
+  }
+}
+
+inline bool SearchState::CanEvaluate() const
+{
+  if (objectives.size() >= maxEvaluations ||
+      (double) objectives.size() >= numConfigurations)
+    return false;
+
+  // At least one configuration is evaluated regardless of the time limit.
+  if (maxTime > 0.0 && !objectives.empty())
+  {
+    const std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    if (elapsed.count() >= maxTime)
+      return false;
+  }
+
+  return true;
+}
+
+inline bool SearchState::Evaluated(const arma::mat& parameters) const
+{
+  return evaluated.count(std::vector<double>(parameters.begin(),
+      parameters.end())) > 0;
+}
+
+inline void SearchState::RandomConfiguration(arma::mat& parameters) const
+{
+  parameters = bestParameters;
+  do
+  {
+    for (size_t d = 0; d < categoricalDimensions.size(); ++d)
+    {
+      if (categoricalDimensions[d])
+        parameters(d) = math::RandInt(numCategories[d]);
+    }
+  } while (Evaluated(parameters));
+}
+
+template<typename FunctionType>
+double SearchState::Evaluate(FunctionType& function,
+                             const arma::mat& parameters)
+{
+  const double objective = function.Evaluate(parameters);
+
+  evaluated.insert(std::vector<double>(parameters.begin(), parameters.end()));
+  configurations.insert_cols(configurations.n_cols, arma::vectorise(
+      parameters));
+  objectives.push_back(objective);
+
+  if (objective < bestObjective || objectives.size() == 1)
+  {
+    bestObjective = objective;
+    bestParameters = parameters;
+  }
+
+  return objective;
+}
+
+} // namespace details
+
+template<typename FunctionType>
+double RandomSearch::Optimize(FunctionType& function,
+                              arma::mat& bestParameters,
+                              const std::vector<bool>& categoricalDimensions,
+                              const arma::Row<size_t>& numCategories)
+{
+  details::SearchState state(categoricalDimensions, numCategories,
+      bestParameters, maxEvaluations, maxTime);
+
+  arma::mat parameters;
+  while (state.CanEvaluate())
+  {
+    state.RandomConfiguration(parameters);
+    state.Evaluate(function, parameters);
+  }
+
+  bestParameters = state.BestParameters();
+  return state.BestObjective();
+}
+
+} // namespace hpt
+} // namespace mlpack
+
+#endif
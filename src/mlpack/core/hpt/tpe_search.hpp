@@ -0,0 +1,161 @@
+/**
+ * @file core/hpt/tpe_search.hpp
+ *
+ * Sequential model-based search over the sets of values of hyper-parameters
+ * with a tree-structured Parzen estimator.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_HPT_TPE_SEARCH_HPP
+#define MLPACK_CORE_HPT_TPE_SEARCH_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/hpt/random_search.hpp>
+
+namespace mlpack {
+namespace hpt {
+
+/**
+ * TPESearch is an optimizer for HyperParameterTuner that uses the results of
+ * the configurations evaluated so far to choose the next configuration, in the
+ * manner of the tree-structured Parzen estimator (TPE) of Bergstra et al.  The
+ * grid is given by the sets of values of the hyper-parameters, as for
+ * ens::GridSearch.
+ *
+ * The first configurations are drawn at random.  After that, the evaluated
+ * configurations are split into the best ones (a fraction gamma of them) and
+ * the others, and for each hyper-parameter the frequencies of its values in
+ * both groups give two distributions l(x) and g(x).  Candidates are drawn from
+ * l(x), and the one that maximizes l(x) / g(x) (and hasn't been evaluated
+ * yet) is evaluated next.  As for RandomSearch, the search stops when the
+ * budget is spent or when every configuration has been evaluated.
+ *
+ * @code
+ * HyperParameterTuner<LARS, MSE, SimpleCV, TPESearch> hpt(validationSize,
+ *     data, responses);
+ * hpt.Optimizer().MaxEvaluations() = 30;
+ *
+ * double bestLambda1, bestLambda2;
+ * std::tie(bestLambda1, bestLambda2) = hpt.Optimize(Fixed(true), Fixed(false),
+ *     lambda1Set, lambda2Set);
+ * @endcode
+ *
+ * For more information, see the following paper:
+ *
+ * @code
+ * @inproceedings{bergstra2011algorithms,
+ *   title={Algorithms for Hyper-Parameter Optimization},
+ *   author={Bergstra, James and Bardenet, R{\'e}mi and Bengio, Yoshua and
+ *       K{\'e}gl, Bal{\'a}zs},
+ *   booktitle={Advances in Neural Information Processing Systems 24},
+ *   pages={2546--2554},
+ *   year={2011}
+ * }
+ * @endcode
+ *
+ * Numeric (non-categorical) hyper-parameters keep their starting values; only
+ * hyper-parameters given as sets of values are searched.
+ */
+class TPESearch
+{
+ public:
+  /**
+   * Create the search with the given budget and parameters.
+   *
+   * @param maxEvaluations Maximum number of configurations to evaluate.
+   * @param numStartup Number of configurations drawn at random before the
+   *     model is used.
+   * @param gamma Fraction of the evaluated configurations that are considered
+   *     good (in (0, 1]).
+   * @param numCandidates Number of candidates drawn from the model to choose
+   *     each configuration from.
+   * @param maxTime Maximum time to search for, in seconds (0 means no limit).
+   *     At least one configuration is always evaluated.
+   */
+  TPESearch(const size_t maxEvaluations = 50,
+            const size_t numStartup = 10,
+            const double gamma = 0.25,
+            const size_t numCandidates = 24,
+            const double maxTime = 0.0) :
+      maxEvaluations(maxEvaluations),
+      numStartup(numStartup),
+      gamma(gamma),
+      numCandidates(numCandidates),
+      maxTime(maxTime)
+  { /* Nothing to do. */ }
+
+  /**
+   * Find the configuration that minimizes the given function.  The function
+   * must provide double Evaluate(const arma::mat& parameters).
+   *
+   * @param function Function to minimize.
+   * @param bestParameters Starting values of the parameters; overwritten with
+   *     the best configuration found.
+   * @param categoricalDimensions Whether each parameter is categorical.
+   * @param numCategories Number of values of each categorical parameter.
+   * @return The objective of the best configuration.
+   */
+  template<typename FunctionType>
+  double Optimize(FunctionType& function,
+                  arma::mat& bestParameters,
+                  const std::vector<bool>& categoricalDimensions,
+                  const arma::Row<size_t>& numCategories);
+
+  //! Get the maximum number of evaluations.
+  size_t MaxEvaluations() const { return maxEvaluations; }
+  //! Modify the maximum number of evaluations.
+  size_t& MaxEvaluations() { return maxEvaluations; }
+
+  //! Get the number of random configurations evaluated first.
+  size_t NumStartup() const { return numStartup; }
+  //! Modify the number of random configurations evaluated first.
+  size_t& NumStartup() { return numStartup; }
+
+  //! Get the fraction of the configurations that are considered good.
+  double Gamma() const { return gamma; }
+  //! Modify the fraction of the configurations that are considered good.
+  double& Gamma() { return gamma; }
+
+  //! Get the number of candidates drawn for each configuration.
+  size_t NumCandidates() const { return numCandidates; }
+  //! Modify the number of candidates drawn for each configuration.
+  size_t& NumCandidates() { return numCandidates; }
+
+  //! Get the time limit in seconds (0 means no limit).
+  double MaxTime() const { return maxTime; }
+  //! Modify the time limit in seconds (0 means no limit).
+  double& MaxTime() { return maxTime; }
+
+ private:
+  /**
+   * Choose the next configuration to evaluate with the model built from the
+   * configurations evaluated so far.
+   */
+  void SuggestConfiguration(const details::SearchState& state,
+                            arma::mat& parameters) const;
+
+  //! Draw a category with the given probabilities.
+  static size_t SampleCategory(const arma::vec& probabilities);
+
+  //! The maximum number of evaluations.
+  size_t maxEvaluations;
+  //! The number of random configurations evaluated first.
+  size_t numStartup;
+  //! The fraction of the configurations that are considered good.
+  double gamma;
+  //! The number of candidates drawn for each configuration.
+  size_t numCandidates;
+  //! The time limit in seconds.
+  double maxTime;
+};
+
+} // namespace hpt
+} // namespace mlpack
+
+// Include implementation.
+#include "tpe_search_impl.hpp"
+
+#endif
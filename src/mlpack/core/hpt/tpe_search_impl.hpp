@@ -0,0 +1,137 @@
+/**
+ * @file core/hpt/tpe_search_impl.hpp
+ *
+ * Implementation of sequential model-based search over the sets of values of
+ * hyper-parameters with a tree-structured Parzen estimator.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_HPT_TPE_SEARCH_IMPL_HPP
+#define MLPACK_CORE_HPT_TPE_SEARCH_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "tpe_search.hpp"
+
+#include <mlpack/core/math/random.hpp>
+
+namespace mlpack {
+namespace hpt {
+
+template<typename FunctionType>
+double TPESearch::Optimize(FunctionType& function,
+                           arma::mat& bestParameters,
+                           const std::vector<bool>& categoricalDimensions,
+                           const arma::Row<size_t>& numCategories)
+{
+  if (gamma <= 0.0 || gamma > 1.0)
+    throw std::invalid_argument("gamma must be in (0, 1]");
+
+  details::SearchState state(categoricalDimensions, numCategories,
+      bestParameters, maxEvaluations, maxTime);
+
+  arma::mat parameters;
+  while (state.CanEvaluate())
+  {
+    if (state.Objectives().size() < std::max(numStartup, (size_t) 1))
+      state.RandomConfiguration(parameters);
+    else
+      SuggestConfiguration(state, parameters);
+
+    state.Evaluate(function, parameters);
+  }
+
+  bestParameters = state.BestParameters();
+  return state.BestObjective();
+}
+
+inline void TPESearch::SuggestConfiguration(const details::SearchState& state,
+                                            arma::mat& parameters) const
+{
+  const std::vector<bool>& categoricalDimensions =
+      state.CategoricalDimensions();
+  const arma::Row<size_t>& numCategories = state.NumCategories();
+  const arma::mat& configurations = state.Configurations();
+
+  // Split the evaluated configurations into the good and the bad ones.
+  const arma::uvec order = arma::sort_index(
+      arma::conv_to<arma::vec>::from(state.Objectives()));
+  const size_t numGood = std::max((size_t) 1,
+      (size_t) std::ceil(gamma * order.n_elem));
+
+  // Estimate the distribution of each categorical parameter in both groups,
+  // with one prior observation of every category.
+  std::vector<arma::vec> good(categoricalDimensions.size());
+  std::vector<arma::vec> bad(categoricalDimensions.size());
+  for (size_t d = 0; d < categoricalDimensions.size(); ++d)
+  {
+    if (!categoricalDimensions[d])
+      continue;
+
+    good[d].ones(numCategories[d]);
+    bad[d].ones(numCategories[d]);
+    for (size_t i = 0; i < order.n_elem; ++i)
+    {
+      const size_t category = (size_t) configurations(d, order[i]);
+      if (i < numGood)
+        good[d][category] += 1.0;
+      else
+        bad[d][category] += 1.0;
+    }
+
+    good[d] /= arma::accu(good[d]);
+    bad[d] /= arma::accu(bad[d]);
+  }
+
+  // Draw candidates from the distribution of the good configurations, and keep
+  // the new one with the best ratio of the likelihoods.
+  bool found = false;
+  double bestScore = -std::numeric_limits<double>::max();
+  arma::mat candidate = state.BestParameters();
+  for (size_t c = 0; c < numCandidates; ++c)
+  {
+    double score = 0.0;
+    for (size_t d = 0; d < categoricalDimensions.size(); ++d)
+    {
+      if (!categoricalDimensions[d])
+        continue;
+
+      const size_t category = SampleCategory(good[d]);
+      candidate(d) = category;
+      score += std::log(good[d][category]) - std::log(bad[d][category]);
+    }
+
+    if ((!found || score > bestScore) && !state.Evaluated(candidate))
+    {
+      found = true;
+      bestScore = score;
+      parameters = candidate;
+    }
+  }
+
+  // If every candidate has already been evaluated, fall back to a random
+  // configuration.
+  if (!found)
+    state.RandomConfiguration(parameters);
+}
+
+inline size_t TPESearch::SampleCategory(const arma::vec& probabilities)
+{
+  const double r = math::Random();
+  double cumulative = 0.0;
+  for (size_t i = 0; i + 1 < probabilities.n_elem; ++i)
+  {
+    cumulative += probabilities[i];
+    if (r < cumulative)
+      return i;
+  }
+
+  return probabilities.n_elem - 1;
+}
+
+} // namespace hpt
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,76 @@
+/**
+ * @file core/kernels/batch_evaluate.hpp
+ *
+ * Utilities shared by the BatchEvaluate() functions of the kernels, which
+ * evaluate a kernel between every pair of points of two sets at once.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_KERNELS_BATCH_EVALUATE_HPP
+#define MLPACK_CORE_KERNELS_BATCH_EVALUATE_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace kernel {
+namespace details {
+
+/**
+ * Apply the given function to every element of the matrix, in parallel.
+ *
+ * @param values Matrix to transform.
+ * @param function Function taking and returning a double.
+ */
+template<typename FunctionType>
+void TransformElements(arma::mat& values, const FunctionType& function)
+{
+  double* mem = values.memptr();
+
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) values.n_elem; ++i)
+    mem[i] = function(mem[i]);
+}
+
+/**
+ * Compute the dot products between every pair of points (columns) of two sets
+ * with a single matrix product: products(i, j) = a_i^T b_j.
+ */
+template<typename MatTypeA, typename MatTypeB>
+void DotProducts(const MatTypeA& a, const MatTypeB& b, arma::mat& products)
+{
+  products = a.t() * b;
+}
+
+/**
+ * Compute the squared Euclidean distances between every pair of points
+ * (columns) of two sets, as ||a_i||^2 + ||b_j||^2 - 2 a_i^T b_j, so that most
+ * of the work is a single matrix product.  Rounding can make the distances of
+ * close points slightly negative, so they are clamped to zero.
+ */
+template<typename MatTypeA, typename MatTypeB>
+void SquaredDistances(const MatTypeA& a,
+                      const MatTypeB& b,
+                      arma::mat& distances)
+{
+  const arma::vec normsA(arma::sum(arma::square(a), 0).t());
+  const arma::vec normsB(arma::sum(arma::square(b), 0).t());
+
+  distances = a.t() * b;
+
+  #pragma omp parallel for
+  for (omp_size_t j = 0; j < (omp_size_t) distances.n_cols; ++j)
+  {
+    double* column = distances.colptr(j);
+    for (size_t i = 0; i < distances.n_rows; ++i)
+      column[i] = std::max(normsA[i] + normsB[j] - 2 * column[i], 0.0);
+  }
+}
+
+} // namespace details
+} // namespace kernel
+} // namespace mlpack
+
+#endif
@@ -15,6 +15,7 @@
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/metrics/lmetric.hpp>
 #include <mlpack/core/kernels/kernel_traits.hpp>
+#include <mlpack/core/kernels/batch_evaluate.hpp>
 
 namespace mlpack {
 namespace kernel {
@@ -68,6 +69,27 @@ class CauchyKernel
         std::pow(metric::EuclideanDistance::Evaluate(a, b) / bandwidth, 2)));
   }
 
+  /**
+   * Evaluate the kernel between every pair of points (columns) of two sets at
+   * once, from the squared distances of the points, which are mostly
+   * computed with a single matrix product.
+   *
+   * @param a First set of points.
+   * @param b Second set of points.
+   * @param kernelMatrix Matrix to store K(a_i, b_j) in (a.n_cols x b.n_cols).
+   */
+  template<typename MatTypeA, typename MatTypeB>
+  void BatchEvaluate(const MatTypeA& a,
+                     const MatTypeB& b,
+                     arma::mat& kernelMatrix) const
+  {
+    details::SquaredDistances(a, b, kernelMatrix);
+
+    const double bandwidthSquared = bandwidth * bandwidth;
+    details::TransformElements(kernelMatrix, [bandwidthSquared](const double d)
+        { return 1 / (1 + d / bandwidthSquared); });
+  }
+
   /**
    * Serialize the kernel.
    */
@@ -89,6 +111,10 @@ class KernelTraits<CauchyKernel>
  public:
   //! The Cauchy kernel is normalized: K(x, x) = 1 for all x.
   static const bool IsNormalized = true;
+  //! The Cauchy kernel doesn't include a squared distance.
+  static const bool UsesSquaredDistance = false;
+  //! The Cauchy kernel provides BatchEvaluate().
+  static const bool HasBatchEvaluate = true;
 };
 
 } // namespace kernel
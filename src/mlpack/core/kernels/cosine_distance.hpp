@@ -15,6 +15,7 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/kernels/kernel_traits.hpp>
+#include <mlpack/core/kernels/batch_evaluate.hpp>
 
 namespace mlpack {
 namespace kernel {
@@ -41,6 +42,19 @@ class CosineDistance
   template<typename VecTypeA, typename VecTypeB>
   static double Evaluate(const VecTypeA& a, const VecTypeB& b);
 
+  /**
+   * Evaluate the kernel between every pair of points (columns) of two sets at
+   * once, from a single matrix product.
+   *
+   * @param a First set of points.
+   * @param b Second set of points.
+   * @param kernelMatrix Matrix to store K(a_i, b_j) in (a.n_cols x b.n_cols).
+   */
+  template<typename MatTypeA, typename MatTypeB>
+  static void BatchEvaluate(const MatTypeA& a,
+                            const MatTypeB& b,
+                            arma::mat& kernelMatrix);
+
   //! Serialize the class (there's nothing to save).
   template<typename Archive>
   void serialize(Archive& /* ar */, const unsigned int /* version */) { }
@@ -56,6 +70,9 @@ class KernelTraits<CosineDistance>
 
   //! The cosine kernel doesn't include a squared distance.
   static const bool UsesSquaredDistance = false;
+
+  //! The cosine kernel provides BatchEvaluate().
+  static const bool HasBatchEvaluate = true;
 };
 
 } // namespace kernel
@@ -32,6 +32,29 @@ double CosineDistance::Evaluate(const VecTypeA& a, const VecTypeB& b)
     return dot(a, b) / denominator;
 }
 
+template<typename MatTypeA, typename MatTypeB>
+void CosineDistance::BatchEvaluate(const MatTypeA& a,
+                                   const MatTypeB& b,
+                                   arma::mat& kernelMatrix)
+{
+  const arma::vec normsA(arma::sqrt(arma::sum(arma::square(a), 0).t()));
+  const arma::vec normsB(arma::sqrt(arma::sum(arma::square(b), 0).t()));
+
+  details::DotProducts(a, b, kernelMatrix);
+
+  // As in Evaluate(), the cosine similarity is zero if either point is zero.
+  #pragma omp parallel for
+  for (omp_size_t j = 0; j < (omp_size_t) kernelMatrix.n_cols; ++j)
+  {
+    for (size_t i = 0; i < kernelMatrix.n_rows; ++i)
+    {
+      const double denominator = normsA[i] * normsB[j];
+      kernelMatrix(i, j) = (denominator == 0.0) ? 0.0 :
+          kernelMatrix(i, j) / denominator;
+    }
+  }
+}
+
 } // namespace kernel
 } // namespace mlpack
 
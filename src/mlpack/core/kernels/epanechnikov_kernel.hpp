@@ -14,6 +14,7 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/kernels/kernel_traits.hpp>
+#include <mlpack/core/kernels/batch_evaluate.hpp>
 
 namespace mlpack {
 namespace kernel {
@@ -51,6 +52,20 @@ class EpanechnikovKernel
   template<typename VecTypeA, typename VecTypeB>
   double Evaluate(const VecTypeA& a, const VecTypeB& b) const;
 
+  /**
+   * Evaluate the kernel between every pair of points (columns) of two sets at
+   * once, from the squared distances of the points, which are mostly
+   * computed with a single matrix product.
+   *
+   * @param a First set of points.
+   * @param b Second set of points.
+   * @param kernelMatrix Matrix to store K(a_i, b_j) in (a.n_cols x b.n_cols).
+   */
+  template<typename MatTypeA, typename MatTypeB>
+  void BatchEvaluate(const MatTypeA& a,
+                     const MatTypeB& b,
+                     arma::mat& kernelMatrix) const;
+
   /**
    * Evaluate the Epanechnikov kernel given that the distance between the two
    * input points is known.
@@ -111,6 +126,8 @@ class KernelTraits<EpanechnikovKernel>
   static const bool IsNormalized = true;
   //! The Epanechnikov kernel includes a squared distance.
   static const bool UsesSquaredDistance = true;
+  //! The Epanechnikov kernel provides BatchEvaluate().
+  static const bool HasBatchEvaluate = true;
 };
 
 } // namespace kernel
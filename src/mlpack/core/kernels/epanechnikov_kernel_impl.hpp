@@ -29,6 +29,19 @@ inline double EpanechnikovKernel::Evaluate(const VecTypeA& a, const VecTypeB& b)
       * inverseBandwidthSquared);
 }
 
+template<typename MatTypeA, typename MatTypeB>
+inline void EpanechnikovKernel::BatchEvaluate(const MatTypeA& a,
+                                              const MatTypeB& b,
+                                              arma::mat& kernelMatrix) const
+{
+  details::SquaredDistances(a, b, kernelMatrix);
+
+  const double inverseBandwidthSquared = this->inverseBandwidthSquared;
+  details::TransformElements(kernelMatrix,
+      [inverseBandwidthSquared](const double d)
+      { return std::max(0.0, 1.0 - d * inverseBandwidthSquared); });
+}
+
 /**
  * Obtains the convolution integral [integral of K(||x-a||) K(||b-x||) dx]
  * for the two vectors.
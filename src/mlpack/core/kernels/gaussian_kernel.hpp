@@ -17,6 +17,7 @@
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/metrics/lmetric.hpp>
 #include <mlpack/core/kernels/kernel_traits.hpp>
+#include <mlpack/core/kernels/batch_evaluate.hpp>
 
 namespace mlpack {
 namespace kernel {
@@ -68,6 +69,27 @@ class GaussianKernel
     return exp(gamma * metric::SquaredEuclideanDistance::Evaluate(a, b));
   }
 
+  /**
+   * Evaluate the kernel between every pair of points (columns) of two sets at
+   * once, from the squared distances of the points, which are mostly
+   * computed with a single matrix product.
+   *
+   * @param a First set of points.
+   * @param b Second set of points.
+   * @param kernelMatrix Matrix to store K(a_i, b_j) in (a.n_cols x b.n_cols).
+   */
+  template<typename MatTypeA, typename MatTypeB>
+  void BatchEvaluate(const MatTypeA& a,
+                     const MatTypeB& b,
+                     arma::mat& kernelMatrix) const
+  {
+    details::SquaredDistances(a, b, kernelMatrix);
+
+    const double gamma = this->gamma;
+    details::TransformElements(kernelMatrix, [gamma](const double d)
+        { return std::exp(gamma * d); });
+  }
+
   /**
    * Evaluation of the Gaussian kernel given the distance between two points.
    *
@@ -171,6 +193,8 @@ class KernelTraits<GaussianKernel>
   static const bool IsNormalized = true;
   //! The Gaussian kernel includes a squared distance.
   static const bool UsesSquaredDistance = true;
+  //! The Gaussian kernel provides BatchEvaluate().
+  static const bool HasBatchEvaluate = true;
 };
 
 } // namespace kernel
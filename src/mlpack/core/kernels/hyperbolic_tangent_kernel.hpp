@@ -13,6 +13,8 @@
 #define MLPACK_CORE_KERNELS_HYPERBOLIC_TANGENT_KERNEL_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/kernels/kernel_traits.hpp>
+#include <mlpack/core/kernels/batch_evaluate.hpp>
 
 namespace mlpack {
 namespace kernel {
@@ -62,6 +64,26 @@ class HyperbolicTangentKernel
     return tanh(scale * arma::dot(a, b) + offset);
   }
 
+  /**
+   * Evaluate the kernel between every pair of points (columns) of two sets at
+   * once, from a single matrix product.
+   *
+   * @param a First set of points.
+   * @param b Second set of points.
+   * @param kernelMatrix Matrix to store K(a_i, b_j) in (a.n_cols x b.n_cols).
+   */
+  template<typename MatTypeA, typename MatTypeB>
+  void BatchEvaluate(const MatTypeA& a,
+                     const MatTypeB& b,
+                     arma::mat& kernelMatrix) const
+  {
+    details::DotProducts(a, b, kernelMatrix);
+
+    const double scale = this->scale, offset = this->offset;
+    details::TransformElements(kernelMatrix, [scale, offset](const double p)
+        { return std::tanh(scale * p + offset); });
+  }
+
   //! Get scale factor.
   double Scale() const { return scale; }
   //! Modify scale factor.
@@ -85,6 +107,19 @@ class HyperbolicTangentKernel
   double offset;
 };
 
+//! Kernel traits for the hyperbolic tangent kernel.
+template<>
+class KernelTraits<HyperbolicTangentKernel>
+{
+ public:
+  //! The hyperbolic tangent kernel is not normalized.
+  static const bool IsNormalized = false;
+  //! The hyperbolic tangent kernel doesn't include a squared distance.
+  static const bool UsesSquaredDistance = false;
+  //! The hyperbolic tangent kernel provides BatchEvaluate().
+  static const bool HasBatchEvaluate = true;
+};
+
 } // namespace kernel
 } // namespace mlpack
 
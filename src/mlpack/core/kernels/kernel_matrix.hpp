@@ -0,0 +1,145 @@
+/**
+ * @file core/kernels/kernel_matrix.hpp
+ *
+ * Evaluate a kernel between every pair of points of two sets at once.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_KERNELS_KERNEL_MATRIX_HPP
+#define MLPACK_CORE_KERNELS_KERNEL_MATRIX_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/kernels/kernel_traits.hpp>
+
+namespace mlpack {
+namespace kernel {
+
+/**
+ * Compute the kernel matrix between the points (columns) of two sets, so that
+ * kernelMatrix(i, j) = K(a.col(i), b.col(j)).  If the kernel provides
+ * BatchEvaluate() (as KernelTraits<KernelType>::HasBatchEvaluate says), the
+ * whole block is computed with it, usually from the matrix product a^T b,
+ * which is much faster than evaluating the kernel on each pair of points.
+ * Otherwise, the pairs are evaluated in parallel with OpenMP, so the kernel's
+ * Evaluate() must be safe to call from several threads at once.
+ *
+ * @param kernel Kernel to evaluate.
+ * @param a First set of points.
+ * @param b Second set of points.
+ * @param kernelMatrix Matrix to store the kernel values in (a.n_cols x
+ *     b.n_cols).
+ */
+template<typename KernelType, typename MatTypeA, typename MatTypeB>
+void KernelMatrix(KernelType& kernel,
+                  const MatTypeA& a,
+                  const MatTypeB& b,
+                  arma::mat& kernelMatrix);
+
+/**
+ * Compute the symmetric kernel matrix of the points (columns) of a set, so that
+ * kernelMatrix(i, j) = K(data.col(i), data.col(j)).  Only half of the kernel
+ * evaluations are needed when the kernel is evaluated pair by pair.
+ *
+ * @param kernel Kernel to evaluate.
+ * @param data Set of points.
+ * @param kernelMatrix Matrix to store the kernel values in (data.n_cols x
+ *     data.n_cols).
+ */
+template<typename KernelType, typename MatType>
+void KernelMatrix(KernelType& kernel,
+                  const MatType& data,
+                  arma::mat& kernelMatrix);
+
+/**
+ * Evaluate the kernel between one point and every point (column) of a set, so
+ * that values(j) = K(point, set.col(j)).  This uses BatchEvaluate() when the
+ * kernel provides it, like KernelMatrix().
+ *
+ * @param kernel Kernel to evaluate.
+ * @param point Point to evaluate the kernel with.
+ * @param set Set of points.
+ * @param values Vector to store the kernel values in (set.n_cols elements).
+ */
+template<typename KernelType, typename VecType, typename MatType>
+void KernelVector(KernelType& kernel,
+                  const VecType& point,
+                  const MatType& set,
+                  arma::vec& values);
+
+namespace details {
+
+/**
+ * Whether the kernel provides BatchEvaluate().  This is false if the
+ * KernelTraits of the kernel don't have HasBatchEvaluate at all, so that
+ * KernelTraits specializations written before it existed can still be used.
+ */
+template<typename KernelType, typename = void>
+struct UsesBatchEvaluate
+{
+  static const bool value = false;
+};
+
+template<typename KernelType>
+struct UsesBatchEvaluate<KernelType, typename std::enable_if<
+    KernelTraits<KernelType>::HasBatchEvaluate>::type>
+{
+  static const bool value = true;
+};
+
+/**
+ * Compute kernel matrices by evaluating the kernel on each pair of points.
+ */
+template<typename KernelType, bool BatchEvaluate>
+struct KernelMatrixComputer
+{
+  template<typename MatTypeA, typename MatTypeB>
+  static void Compute(KernelType& kernel,
+                      const MatTypeA& a,
+                      const MatTypeB& b,
+                      arma::mat& kernelMatrix);
+
+  template<typename MatType>
+  static void Compute(KernelType& kernel,
+                      const MatType& data,
+                      arma::mat& kernelMatrix);
+
+  template<typename VecType, typename MatType>
+  static void ComputeVector(KernelType& kernel,
+                            const VecType& point,
+                            const MatType& set,
+                            arma::vec& values);
+};
+
+//! Compute kernel matrices with the kernel's BatchEvaluate().
+template<typename KernelType>
+struct KernelMatrixComputer<KernelType, true>
+{
+  template<typename MatTypeA, typename MatTypeB>
+  static void Compute(KernelType& kernel,
+                      const MatTypeA& a,
+                      const MatTypeB& b,
+                      arma::mat& kernelMatrix);
+
+  template<typename MatType>
+  static void Compute(KernelType& kernel,
+                      const MatType& data,
+                      arma::mat& kernelMatrix);
+
+  template<typename VecType, typename MatType>
+  static void ComputeVector(KernelType& kernel,
+                            const VecType& point,
+                            const MatType& set,
+                            arma::vec& values);
+};
+
+} // namespace details
+} // namespace kernel
+} // namespace mlpack
+
+// Include implementation.
+#include "kernel_matrix_impl.hpp"
+
+#endif
@@ -0,0 +1,169 @@
+/**
+ * @file core/kernels/kernel_matrix_impl.hpp
+ *
+ * Implementation of the computation of kernel matrices.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_KERNELS_KERNEL_MATRIX_IMPL_HPP
+#define MLPACK_CORE_KERNELS_KERNEL_MATRIX_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "kernel_matrix.hpp"
+
+namespace mlpack {
+namespace kernel {
+
+template<typename KernelType, typename MatTypeA, typename MatTypeB>
+void KernelMatrix(KernelType& kernel,
+                  const MatTypeA& a,
+                  const MatTypeB& b,
+                  arma::mat& kernelMatrix)
+{
+  if (a.n_rows != b.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "KernelMatrix(): the two sets of points must have the same "
+        << "dimensionality (" << a.n_rows << " != " << b.n_rows << ")";
+    throw std::invalid_argument(oss.str());
+  }
+
+  details::KernelMatrixComputer<KernelType,
+      details::UsesBatchEvaluate<KernelType>::value>::Compute(kernel, a, b,
+      kernelMatrix);
+}
+
+template<typename KernelType, typename MatType>
+void KernelMatrix(KernelType& kernel,
+                  const MatType& data,
+                  arma::mat& kernelMatrix)
+{
+  details::KernelMatrixComputer<KernelType,
+      details::UsesBatchEvaluate<KernelType>::value>::Compute(kernel, data,
+      kernelMatrix);
+}
+
+template<typename KernelType, typename VecType, typename MatType>
+void KernelVector(KernelType& kernel,
+                  const VecType& point,
+                  const MatType& set,
+                  arma::vec& values)
+{
+  if (point.n_elem != set.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "KernelVector(): the point and the set of points must have the "
+        << "same dimensionality (" << point.n_elem << " != " << set.n_rows
+        << ")";
+    throw std::invalid_argument(oss.str());
+  }
+
+  details::KernelMatrixComputer<KernelType,
+      details::UsesBatchEvaluate<KernelType>::value>::ComputeVector(kernel,
+      point, set, values);
+}
+
+namespace details {
+
+template<typename KernelType, bool BatchEvaluate>
+template<typename MatTypeA, typename MatTypeB>
+void KernelMatrixComputer<KernelType, BatchEvaluate>::Compute(
+    KernelType& kernel,
+    const MatTypeA& a,
+    const MatTypeB& b,
+    arma::mat& kernelMatrix)
+{
+  kernelMatrix.set_size(a.n_cols, b.n_cols);
+
+  #pragma omp parallel for
+  for (omp_size_t j = 0; j < (omp_size_t) b.n_cols; ++j)
+  {
+    for (size_t i = 0; i < a.n_cols; ++i)
+      kernelMatrix(i, j) = kernel.Evaluate(a.col(i), b.col(j));
+  }
+}
+
+template<typename KernelType, bool BatchEvaluate>
+template<typename MatType>
+void KernelMatrixComputer<KernelType, BatchEvaluate>::Compute(
+    KernelType& kernel,
+    const MatType& data,
+    arma::mat& kernelMatrix)
+{
+  kernelMatrix.set_size(data.n_cols, data.n_cols);
+
+  // Only the upper triangular part of the kernel matrix is computed, since it
+  // is symmetric.  The columns hold different numbers of evaluations, so they
+  // are scheduled dynamically.
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t j = 0; j < (omp_size_t) data.n_cols; ++j)
+  {
+    for (size_t i = 0; i <= (size_t) j; ++i)
+      kernelMatrix(i, j) = kernel.Evaluate(data.col(i), data.col(j));
+  }
+
+  kernelMatrix = arma::symmatu(kernelMatrix);
+}
+
+template<typename KernelType, bool BatchEvaluate>
+template<typename VecType, typename MatType>
+void KernelMatrixComputer<KernelType, BatchEvaluate>::ComputeVector(
+    KernelType& kernel,
+    const VecType& point,
+    const MatType& set,
+    arma::vec& values)
+{
+  values.set_size(set.n_cols);
+
+  #pragma omp parallel for
+  for (omp_size_t j = 0; j < (omp_size_t) set.n_cols; ++j)
+    values[j] = kernel.Evaluate(point, set.col(j));
+}
+
+template<typename KernelType>
+template<typename MatTypeA, typename MatTypeB>
+void KernelMatrixComputer<KernelType, true>::Compute(
+    KernelType& kernel,
+    const MatTypeA& a,
+    const MatTypeB& b,
+    arma::mat& kernelMatrix)
+{
+  kernel.BatchEvaluate(a, b, kernelMatrix);
+}
+
+template<typename KernelType>
+template<typename MatType>
+void KernelMatrixComputer<KernelType, true>::Compute(
+    KernelType& kernel,
+    const MatType& data,
+    arma::mat& kernelMatrix)
+{
+  kernel.BatchEvaluate(data, data, kernelMatrix);
+
+  // Rounding may have made the two halves differ slightly.
+  kernelMatrix = arma::symmatu(kernelMatrix);
+}
+
+template<typename KernelType>
+template<typename VecType, typename MatType>
+void KernelMatrixComputer<KernelType, true>::ComputeVector(
+    KernelType& kernel,
+    const VecType& point,
+    const MatType& set,
+    arma::vec& values)
+{
+  // The kernel values of the point form a 1 x set.n_cols kernel matrix, which
+  // has the same memory layout as a vector.
+  arma::mat kernelMatrix;
+  kernel.BatchEvaluate(point, set, kernelMatrix);
+  values = arma::vectorise(kernelMatrix);
+}
+
+} // namespace details
+} // namespace kernel
+} // namespace mlpack
+
+#endif
@@ -36,6 +36,14 @@ class KernelTraits
    * If true, then the kernel include a squared distance, ||x - y||^2 .
    */
   static const bool UsesSquaredDistance = false;
+
+  /**
+   * If true, then the kernel provides
+   * BatchEvaluate(const MatTypeA& a, const MatTypeB& b, arma::mat& k), which
+   * evaluates the kernel between every pair of points of two sets at once
+   * (usually with a matrix product).
+   */
+  static const bool HasBatchEvaluate = false;
 };
 
 } // namespace kernel
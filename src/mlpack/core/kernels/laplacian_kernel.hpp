@@ -13,6 +13,8 @@
 #define MLPACK_CORE_KERNELS_LAPLACIAN_KERNEL_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/kernels/kernel_traits.hpp>
+#include <mlpack/core/kernels/batch_evaluate.hpp>
 
 namespace mlpack {
 namespace kernel {
@@ -64,6 +66,27 @@ class LaplacianKernel
     return exp(-metric::EuclideanDistance::Evaluate(a, b) / bandwidth);
   }
 
+  /**
+   * Evaluate the kernel between every pair of points (columns) of two sets at
+   * once, from the squared distances of the points, which are mostly
+   * computed with a single matrix product.
+   *
+   * @param a First set of points.
+   * @param b Second set of points.
+   * @param kernelMatrix Matrix to store K(a_i, b_j) in (a.n_cols x b.n_cols).
+   */
+  template<typename MatTypeA, typename MatTypeB>
+  void BatchEvaluate(const MatTypeA& a,
+                     const MatTypeB& b,
+                     arma::mat& kernelMatrix) const
+  {
+    details::SquaredDistances(a, b, kernelMatrix);
+
+    const double bandwidth = this->bandwidth;
+    details::TransformElements(kernelMatrix, [bandwidth](const double d)
+        { return std::exp(-std::sqrt(d) / bandwidth); });
+  }
+
   /**
    * Evaluation of the Laplacian kernel given the distance between two points.
    *
@@ -117,6 +140,8 @@ class KernelTraits<LaplacianKernel>
   static const bool IsNormalized = true;
   //! The Laplacian kernel doesn't include a squared distance.
   static const bool UsesSquaredDistance = false;
+  //! The Laplacian kernel provides BatchEvaluate().
+  static const bool HasBatchEvaluate = true;
 };
 
 } // namespace kernel
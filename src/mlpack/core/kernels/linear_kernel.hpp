@@ -15,6 +15,8 @@
 #define MLPACK_CORE_KERNELS_LINEAR_KERNEL_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/kernels/kernel_traits.hpp>
+#include <mlpack/core/kernels/batch_evaluate.hpp>
 
 namespace mlpack {
 namespace kernel {
@@ -55,11 +57,40 @@ class LinearKernel
     return arma::dot(a, b);
   }
 
+  /**
+   * Evaluate the kernel between every pair of points (columns) of two sets at
+   * once, with a single matrix product.
+   *
+   * @param a First set of points.
+   * @param b Second set of points.
+   * @param kernelMatrix Matrix to store K(a_i, b_j) in (a.n_cols x b.n_cols).
+   */
+  template<typename MatTypeA, typename MatTypeB>
+  static void BatchEvaluate(const MatTypeA& a,
+                            const MatTypeB& b,
+                            arma::mat& kernelMatrix)
+  {
+    details::DotProducts(a, b, kernelMatrix);
+  }
+
   //! Serialize the kernel (it has no members... do nothing).
   template<typename Archive>
   void serialize(Archive& /* ar */, const unsigned int /* version */) { }
 };
 
+//! Kernel traits for the linear kernel.
+template<>
+class KernelTraits<LinearKernel>
+{
+ public:
+  //! The linear kernel is not normalized.
+  static const bool IsNormalized = false;
+  //! The linear kernel doesn't include a squared distance.
+  static const bool UsesSquaredDistance = false;
+  //! The linear kernel provides BatchEvaluate().
+  static const bool HasBatchEvaluate = true;
+};
+
 } // namespace kernel
 } // namespace mlpack
 
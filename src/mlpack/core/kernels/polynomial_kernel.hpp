@@ -13,6 +13,8 @@
 #define MLPACK_CORE_KERNELS_POLYNOMIAL_KERNEL_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/kernels/kernel_traits.hpp>
+#include <mlpack/core/kernels/batch_evaluate.hpp>
 
 namespace mlpack {
 namespace kernel {
@@ -57,6 +59,26 @@ class PolynomialKernel
     return pow((arma::dot(a, b) + offset), degree);
   }
 
+  /**
+   * Evaluate the kernel between every pair of points (columns) of two sets at
+   * once, from a single matrix product.
+   *
+   * @param a First set of points.
+   * @param b Second set of points.
+   * @param kernelMatrix Matrix to store K(a_i, b_j) in (a.n_cols x b.n_cols).
+   */
+  template<typename MatTypeA, typename MatTypeB>
+  void BatchEvaluate(const MatTypeA& a,
+                     const MatTypeB& b,
+                     arma::mat& kernelMatrix) const
+  {
+    details::DotProducts(a, b, kernelMatrix);
+
+    const double offset = this->offset, degree = this->degree;
+    details::TransformElements(kernelMatrix, [offset, degree](const double p)
+        { return std::pow(p + offset, degree); });
+  }
+
   //! Get the degree of the polynomial.
   const double& Degree() const { return degree; }
   //! Modify the degree of the polynomial.
@@ -82,6 +104,19 @@ class PolynomialKernel
   double offset;
 };
 
+//! Kernel traits for the polynomial kernel.
+template<>
+class KernelTraits<PolynomialKernel>
+{
+ public:
+  //! The polynomial kernel is not normalized.
+  static const bool IsNormalized = false;
+  //! The polynomial kernel doesn't include a squared distance.
+  static const bool UsesSquaredDistance = false;
+  //! The polynomial kernel provides BatchEvaluate().
+  static const bool HasBatchEvaluate = true;
+};
+
 } // namespace kernel
 } // namespace mlpack
 
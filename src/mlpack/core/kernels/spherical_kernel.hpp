@@ -127,6 +127,8 @@ class KernelTraits<SphericalKernel>
   static const bool IsNormalized = true;
   //! The spherical kernel doesn't include a squared distance.
   static const bool UsesSquaredDistance = false;
+  //! The spherical kernel doesn't provide BatchEvaluate().
+  static const bool HasBatchEvaluate = false;
 };
 
 } // namespace kernel
@@ -112,6 +112,8 @@ class KernelTraits<TriangularKernel>
   static const bool IsNormalized = true;
   //! The triangular kernel doesn't include a squared distance.
   static const bool UsesSquaredDistance = false;
+  //! The triangular kernel doesn't provide BatchEvaluate().
+  static const bool HasBatchEvaluate = false;
 };
 
 } // namespace kernel
@@ -15,6 +15,7 @@
 #define MLPACK_CORE_MATH_CCOV_HPP
 
 #include <mlpack/prereqs.hpp>
+#include "running_covariance.hpp"
 
 namespace mlpack {
 namespace math /** Miscellaneous math routines. */ {
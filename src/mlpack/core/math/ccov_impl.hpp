@@ -37,13 +37,11 @@ inline arma::Mat<eT> ColumnCovariance(const arma::Mat<eT>& x,
         arma::Mat<eT>(const_cast<eT*>(x.memptr()), x.n_rows, x.n_cols, false,
             false);
 
-    const size_t n = xAlias.n_cols;
-    const eT normVal = (normType == 0) ? ((n > 1) ? eT(n - 1) : eT(1)) : eT(n);
-
-    const arma::Mat<eT> tmp = xAlias.each_col() - arma::mean(xAlias, 1);
-
-    out = tmp * tmp.t();
-    out /= normVal;
+    // The covariance is computed block by block, so no centered copy of the
+    // whole matrix is needed.
+    RunningCovariance<eT> covariance(xAlias.n_rows);
+    covariance.Update(xAlias);
+    out = covariance.Covariance(normType);
   }
 
   return out;
@@ -0,0 +1,75 @@
+/**
+ * @file core/math/first_touch.hpp
+ *
+ * Copy a matrix with the threads that will read it, so that on NUMA machines
+ * its memory is spread over the nodes of those threads.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_MATH_FIRST_TOUCH_HPP
+#define MLPACK_CORE_MATH_FIRST_TOUCH_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace math {
+
+/**
+ * Copy a dense matrix, writing its columns in parallel with a static schedule.
+ * Operating systems place a page of memory on the NUMA node of the thread that
+ * writes it first, so a matrix loaded or copied by one thread lives on one
+ * node, and the threads on the other nodes read it remotely.  After this copy,
+ * the block of columns that thread t of a static `omp parallel for` loop over
+ * the columns works on is on the node of thread t, and the pages of matrices
+ * that are read at random are spread evenly over the nodes.
+ *
+ * The placement only helps if the threads stay on their cores, so the threads
+ * should be pinned, for instance with the environment variables
+ * OMP_PROC_BIND=spread and OMP_PLACES=cores.  Without OpenMP, or with one
+ * thread, this is an ordinary copy.
+ *
+ * @param input Matrix to copy.
+ * @param output Matrix to copy into.
+ */
+template<typename eT>
+void FirstTouchCopy(const arma::Mat<eT>& input, arma::Mat<eT>& output)
+{
+  // The memory of the new matrix is not written (and so not placed) yet.
+  output.set_size(input.n_rows, input.n_cols);
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) input.n_cols; ++i)
+    std::copy(input.colptr(i), input.colptr(i) + input.n_rows,
+        output.colptr(i));
+}
+
+/**
+ * Re-place a dense matrix in memory with FirstTouchCopy(), so that it is
+ * spread over the NUMA nodes of the threads that read it.  This makes a
+ * temporary copy of the matrix, so it should be done once, before the matrix
+ * is read many times.  Nothing is done without OpenMP or with one thread.
+ *
+ * @param matrix Matrix to place.
+ */
+template<typename eT>
+void FirstTouch(arma::Mat<eT>& matrix)
+{
+#ifdef HAS_OPENMP
+  if (omp_get_max_threads() == 1 || matrix.n_elem == 0)
+    return;
+
+  arma::Mat<eT> placed;
+  FirstTouchCopy(matrix, placed);
+  matrix.steal_mem(placed);
+#else
+  (void) matrix;
+#endif
+}
+
+} // namespace math
+} // namespace mlpack
+
+#endif
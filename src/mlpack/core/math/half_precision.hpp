@@ -0,0 +1,143 @@
+/**
+ * @file core/math/half_precision.hpp
+ *
+ * Conversions between single precision and the 16-bit floating-point formats
+ * bfloat16 and IEEE 754 half precision, for storing data in half the memory
+ * of single precision.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_MATH_HALF_PRECISION_HPP
+#define MLPACK_CORE_MATH_HALF_PRECISION_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace math {
+
+/**
+ * The bfloat16 format: the sign, the 8 exponent bits and the 7 highest
+ * mantissa bits of a single-precision number.  It has the range of single
+ * precision with about 3 significant decimal digits, and converting to single
+ * precision is a shift.  Encoding rounds to the nearest representable value
+ * (ties to even).
+ */
+class BFloat16
+{
+ public:
+  //! Encode a single-precision number.
+  static uint16_t Encode(const float value)
+  {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(float));
+
+    // Keep NaNs NaNs (rounding could turn them into infinities).
+    if ((bits & 0x7FFFFFFF) > 0x7F800000)
+      return (uint16_t) ((bits >> 16) | 0x0040);
+
+    bits += 0x7FFF + ((bits >> 16) & 1);
+    return (uint16_t) (bits >> 16);
+  }
+
+  //! Decode a number to single precision.
+  static float Decode(const uint16_t code)
+  {
+    const uint32_t bits = ((uint32_t) code) << 16;
+    float value;
+    std::memcpy(&value, &bits, sizeof(float));
+    return value;
+  }
+};
+
+/**
+ * The IEEE 754 half-precision format (binary16): a sign, 5 exponent bits and
+ * 10 mantissa bits.  It has about 3 significant decimal digits and a range of
+ * about 6e-8 to 65504; larger numbers are encoded as infinities.  Encoding
+ * rounds to the nearest representable value (ties to even).
+ */
+class Float16
+{
+ public:
+  //! Encode a single-precision number.
+  static uint16_t Encode(const float value)
+  {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(float));
+    const uint16_t sign = (uint16_t) ((bits >> 16) & 0x8000);
+    bits &= 0x7FFFFFFF;
+
+    // Infinities and NaNs.
+    if (bits >= 0x7F800000)
+      return sign | 0x7C00 | ((bits > 0x7F800000) ? 0x0200 : 0);
+
+    // Numbers that round to 65520 or more overflow.
+    if (bits >= 0x477FF000)
+      return sign | 0x7C00;
+
+    // Numbers smaller than the smallest normal half-precision number.
+    if (bits < 0x38800000)
+    {
+      // Numbers smaller than half of the smallest subnormal round to zero.
+      if (bits < 0x33000000)
+        return sign;
+
+      // The subnormal mantissa is the full mantissa shifted by 126 minus the
+      // exponent.
+      const uint32_t shift = 126 - (bits >> 23);
+      const uint32_t mantissa = (bits & 0x007FFFFF) | 0x00800000;
+      uint32_t code = mantissa >> shift;
+      const uint32_t remainder = mantissa & ((1u << shift) - 1);
+      const uint32_t half = 1u << (shift - 1);
+      if (remainder > half || (remainder == half && (code & 1)))
+        ++code;
+
+      return sign | (uint16_t) code;
+    }
+
+    // Normal numbers: rebias the exponent and round away 13 mantissa bits (a
+    // carry into the exponent is the right result).
+    bits -= 0x38000000;
+    uint32_t code = bits >> 13;
+    const uint32_t remainder = bits & 0x1FFF;
+    if (remainder > 0x1000 || (remainder == 0x1000 && (code & 1)))
+      ++code;
+
+    return sign | (uint16_t) code;
+  }
+
+  //! Decode a number to single precision.
+  static float Decode(const uint16_t code)
+  {
+    const uint32_t sign = ((uint32_t) (code & 0x8000)) << 16;
+    const uint32_t exponent = (code >> 10) & 0x1F;
+    const uint32_t mantissa = code & 0x03FF;
+
+    uint32_t bits;
+    if (exponent == 0x1F)
+    {
+      bits = sign | 0x7F800000 | (mantissa << 13);
+    }
+    else if (exponent == 0)
+    {
+      // Zeros and subnormal numbers (mantissa * 2^-24).
+      const float value = (float) mantissa * (1.0f / 16777216.0f);
+      return sign ? -value : value;
+    }
+    else
+    {
+      bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+    }
+
+    float value;
+    std::memcpy(&value, &bits, sizeof(float));
+    return value;
+  }
+};
+
+} // namespace math
+} // namespace mlpack
+
+#endif
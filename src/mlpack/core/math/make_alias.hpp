@@ -42,6 +42,23 @@ arma::Mat<ElemType> MakeAlias(arma::Mat<ElemType>& input,
       strict);
 }
 
+/**
+ * Reinitialize a dense matrix as an alias of the given memory, with the given
+ * size.  The copy and move assignment operators of Armadillo copy the memory
+ * of an alias instead of pointing at it, so placement new is used instead.  If
+ * strict is true, then the alias cannot be resized or pointed at new memory.
+ */
+template<typename ElemType>
+void MakeAlias(arma::Mat<ElemType>& m,
+               ElemType* newMem,
+               const size_t numRows,
+               const size_t numCols,
+               const bool strict = true)
+{
+  m.~Mat();
+  new (&m) arma::Mat<ElemType>(newMem, numRows, numCols, false, strict);
+}
+
 /**
  * Make an alias of a dense row.  If strict is true, then the alias cannot be
  * resized or pointed at new memory.
@@ -0,0 +1,109 @@
+/**
+ * @file core/math/product.hpp
+ *
+ * Products of dense or sparse matrices with dense matrices.  The sparse
+ * products are computed in parallel when OpenMP is available.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_MATH_PRODUCT_HPP
+#define MLPACK_CORE_MATH_PRODUCT_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace math {
+
+/**
+ * Compute the product a * b of two dense matrices.  This is the same as the
+ * Armadillo expression, and is only provided so that algorithms can be
+ * written once for dense and sparse matrices.
+ */
+template<typename eT>
+arma::Mat<eT> Product(const arma::Mat<eT>& a, const arma::Mat<eT>& b)
+{
+  return a * b;
+}
+
+/**
+ * Compute the product a * b of a sparse matrix with a dense matrix.  The
+ * columns of the result are computed in parallel when OpenMP is available.
+ */
+template<typename eT>
+arma::Mat<eT> Product(const arma::SpMat<eT>& a, const arma::Mat<eT>& b)
+{
+  if (a.n_cols != b.n_rows)
+    throw std::invalid_argument("Product(): incompatible matrix dimensions");
+
+  a.sync();
+  arma::Mat<eT> result(a.n_rows, b.n_cols, arma::fill::zeros);
+
+  #pragma omp parallel for
+  for (omp_size_t j = 0; j < (omp_size_t) b.n_cols; ++j)
+  {
+    eT* out = result.colptr(j);
+    for (size_t c = 0; c < a.n_cols; ++c)
+    {
+      const eT factor = b(c, j);
+      if (factor == eT(0))
+        continue;
+
+      for (size_t i = a.col_ptrs[c]; i < a.col_ptrs[c + 1]; ++i)
+        out[a.row_indices[i]] += a.values[i] * factor;
+    }
+  }
+
+  return result;
+}
+
+/**
+ * Compute the product a^T * b of the transpose of a dense matrix with a dense
+ * matrix.  This is the same as the Armadillo expression.
+ */
+template<typename eT>
+arma::Mat<eT> TransProduct(const arma::Mat<eT>& a, const arma::Mat<eT>& b)
+{
+  return a.t() * b;
+}
+
+/**
+ * Compute the product a^T * b of the transpose of a sparse matrix with a dense
+ * matrix, without forming the transpose.  The rows of the result are computed
+ * in parallel when OpenMP is available.
+ */
+template<typename eT>
+arma::Mat<eT> TransProduct(const arma::SpMat<eT>& a, const arma::Mat<eT>& b)
+{
+  if (a.n_rows != b.n_rows)
+  {
+    throw std::invalid_argument("TransProduct(): incompatible matrix "
+        "dimensions");
+  }
+
+  a.sync();
+  arma::Mat<eT> result(a.n_cols, b.n_cols);
+
+  #pragma omp parallel for
+  for (omp_size_t c = 0; c < (omp_size_t) a.n_cols; ++c)
+  {
+    for (size_t j = 0; j < b.n_cols; ++j)
+    {
+      const eT* column = b.colptr(j);
+      eT sum = eT(0);
+      for (size_t i = a.col_ptrs[c]; i < a.col_ptrs[c + 1]; ++i)
+        sum += a.values[i] * column[a.row_indices[i]];
+
+      result(c, j) = sum;
+    }
+  }
+
+  return result;
+}
+
+} // namespace math
+} // namespace mlpack
+
+#endif
@@ -29,19 +29,75 @@ extern MLPACK_EXPORT std::mt19937 randGen;
 extern MLPACK_EXPORT std::uniform_real_distribution<> randUniformDist;
 // Global normal distribution.
 extern MLPACK_EXPORT std::normal_distribution<> randNormalDist;
+// Seed of the random streams given by TaskRandomStream().
+extern MLPACK_EXPORT uint64_t randStreamSeed;
+
+/**
+ * A generator and normal distribution that replace the global ones in one
+ * thread, while a ThreadRandomScope or a CLI::ScopedContext exists.
+ */
+struct ThreadRandomState
+{
+  //! The generator of the thread.
+  std::mt19937 generator;
+  //! The normal distribution of the thread (it caches numbers, so it can't be
+  //! shared between threads).
+  std::normal_distribution<> normalDist;
+  //! The seed of the random streams given by TaskRandomStream() in the thread.
+  uint64_t streamSeed = 0;
+};
+
+/**
+ * Get the random state that replaces the global generator in the calling
+ * thread, or NULL if the thread uses the global generator.
+ */
+inline ThreadRandomState*& CurrentThreadRandomState()
+{
+  static thread_local ThreadRandomState* state = NULL;
+  return state;
+}
+
+/**
+ * Get the generator used by the random functions below in the calling thread:
+ * the global generator randGen, unless a ThreadRandomScope or a
+ * CLI::ScopedContext replaces it.
+ */
+inline std::mt19937& RandGen()
+{
+  ThreadRandomState* state = CurrentThreadRandomState();
+  return (state == NULL) ? randGen : state->generator;
+}
 
 /**
  * Set the random seed used by the random functions (Random() and RandInt()).
  * The seed is casted to a 32-bit integer before being given to the random
  * number generator, but a size_t is taken as a parameter for API consistency.
+ * The seed is also used by the random streams given by TaskRandomStream().
+ *
+ * If the global generator is replaced in the calling thread (by a
+ * ThreadRandomScope or a CLI::ScopedContext), only the generators of the thread
+ * are seeded, so that other threads are not affected; srand() is then not
+ * called.
  *
  * @param seed Seed for the random number generator.
  */
 inline void RandomSeed(const size_t seed)
 {
   #if (!defined(BINDING_TYPE) || BINDING_TYPE != BINDING_TYPE_TEST)
-    randGen.seed((uint32_t) seed);
-    srand((unsigned int) seed);
+    ThreadRandomState* state = CurrentThreadRandomState();
+    if (state != NULL)
+    {
+      state->generator.seed((uint32_t) seed);
+      state->normalDist.reset();
+      state->streamSeed = seed;
+    }
+    else
+    {
+      randGen.seed((uint32_t) seed);
+      randStreamSeed = seed;
+      srand((unsigned int) seed);
+    }
+    // The Armadillo generator is already local to the thread.
     arma::arma_rng::set_seed(seed);
   #else
     (void) seed;
@@ -60,6 +116,7 @@ inline void FixedRandomSeed()
 {
   const static size_t seed = rand();
   randGen.seed((uint32_t) seed);
+  randStreamSeed = seed;
   srand((unsigned int) seed);
   arma::arma_rng::set_seed(seed);
 }
@@ -67,6 +124,7 @@ inline void FixedRandomSeed()
 inline void CustomRandomSeed(const size_t seed)
 {
   randGen.seed((uint32_t) seed);
+  randStreamSeed = seed;
   srand((unsigned int) seed);
   arma::arma_rng::set_seed(seed);
 }
@@ -77,7 +135,7 @@ inline void CustomRandomSeed(const size_t seed)
  */
 inline double Random()
 {
-  return randUniformDist(randGen);
+  return randUniformDist(RandGen());
 }
 
 /**
@@ -85,7 +143,7 @@ inline double Random()
  */
 inline double Random(const double lo, const double hi)
 {
-  return lo + (hi - lo) * randUniformDist(randGen);
+  return lo + (hi - lo) * randUniformDist(RandGen());
 }
 
 /**
@@ -104,7 +162,7 @@ inline double RandBernoulli(const double input)
  */
 inline int RandInt(const int hiExclusive)
 {
-  return (int) std::floor((double) hiExclusive * randUniformDist(randGen));
+  return (int) std::floor((double) hiExclusive * randUniformDist(RandGen()));
 }
 
 /**
@@ -113,7 +171,7 @@ inline int RandInt(const int hiExclusive)
 inline int RandInt(const int lo, const int hiExclusive)
 {
   return lo + (int) std::floor((double) (hiExclusive - lo)
-                               * randUniformDist(randGen));
+                               * randUniformDist(RandGen()));
 }
 
 /**
@@ -121,7 +179,9 @@ inline int RandInt(const int lo, const int hiExclusive)
  */
 inline double RandNormal()
 {
-  return randNormalDist(randGen);
+  ThreadRandomState* state = CurrentThreadRandomState();
+  return (state == NULL) ? randNormalDist(randGen) :
+      state->normalDist(state->generator);
 }
 
 /**
@@ -133,7 +193,7 @@ inline double RandNormal()
  */
 inline double RandNormal(const double mean, const double variance)
 {
-  return variance * randNormalDist(randGen) + mean;
+  return variance * RandNormal() + mean;
 }
 
 /**
@@ -0,0 +1,295 @@
+/**
+ * @file core/math/random_stream.hpp
+ *
+ * Counter-based random number streams, which can be used independently by
+ * each thread or task of a parallel algorithm.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_MATH_RANDOM_STREAM_HPP
+#define MLPACK_CORE_MATH_RANDOM_STREAM_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/random.hpp>
+
+namespace mlpack {
+namespace math {
+
+/**
+ * The Philox4x32-10 counter-based random number generator of Salmon et al.
+ * The output is a function of a key (the seed), a stream identifier and a
+ * counter, so that any number of generators with the same seed and different
+ * streams produce independent sequences, and any block of a sequence can be
+ * computed directly without generating the blocks before it.  The class
+ * satisfies the requirements of a uniform random bit generator, so it can be
+ * used with the distributions of the standard library.
+ *
+ * For more information, see the following paper:
+ *
+ * @code
+ * @inproceedings{salmon2011parallel,
+ *   title={Parallel Random Numbers: As Easy as 1, 2, 3},
+ *   author={Salmon, John K. and Moraes, Mark A. and Dror, Ron O. and Shaw,
+ *       David E.},
+ *   booktitle={Proceedings of the International Conference for High
+ *       Performance Computing, Networking, Storage and Analysis (SC '11)},
+ *   year={2011}
+ * }
+ * @endcode
+ */
+class Philox4x32
+{
+ public:
+  //! The type of the generated numbers.
+  typedef uint32_t result_type;
+
+  /**
+   * Create the generator for the given seed and stream.
+   *
+   * @param seed Seed (key) of the generator.
+   * @param stream Identifier of the stream.
+   */
+  Philox4x32(const uint64_t seed = 0, const uint64_t stream = 0);
+
+  //! Get the smallest number that can be generated.
+  static constexpr result_type min() { return 0; }
+  //! Get the largest number that can be generated.
+  static constexpr result_type max() { return 0xFFFFFFFF; }
+
+  //! Generate the next number of the stream.
+  result_type operator()();
+
+  /**
+   * Compute the four numbers of the given block of the stream, without
+   * changing the state of the generator.
+   *
+   * @param block Index of the block.
+   * @param output Array to store the four numbers into.
+   */
+  void Block(const uint64_t block, uint32_t output[4]) const;
+
+  /**
+   * Compute the numbers of the given number of consecutive blocks, without
+   * changing the state of the generator.  The rounds are computed for several
+   * blocks at once, so that the compiler can vectorize them; the numbers are
+   * the same as those given by Block().
+   *
+   * @param first Index of the first block.
+   * @param numBlocks Number of blocks to compute.
+   * @param output Array to store the 4 * numBlocks numbers into.
+   */
+  void Blocks(const uint64_t first,
+              const size_t numBlocks,
+              uint32_t* output) const;
+
+  //! Get the index of the next block that hasn't been used yet.
+  uint64_t NextBlock() const { return counter; }
+
+  /**
+   * Discard the rest of the current block and skip the given number of blocks,
+   * for instance after they have been computed with Block().
+   */
+  void Skip(const uint64_t numBlocks);
+
+ private:
+  //! The key, given by the seed.
+  uint32_t key[2];
+  //! The identifier of the stream.
+  uint32_t stream[2];
+  //! The index of the next block.
+  uint64_t counter;
+  //! The numbers of the current block.
+  uint32_t buffer[4];
+  //! The position of the next number in the current block.
+  size_t position;
+};
+
+/**
+ * A stream of random numbers, with the same interface as the global random
+ * functions of mlpack::math (Random(), RandInt(), RandNormal(), ...), that
+ * doesn't share any state with other streams.  Unlike the global functions,
+ * the streams can be used in parallel without synchronization, and the numbers
+ * they produce only depend on their seed and stream identifier, not on the
+ * number of threads or on how the work is scheduled.
+ *
+ * The usual way to use streams is to give each task of a parallel loop its
+ * own stream, keyed by the index of the task:
+ *
+ * @code
+ * #pragma omp parallel for
+ * for (omp_size_t i = 0; i < (omp_size_t) numTrees; ++i)
+ * {
+ *   RandomStream rng = TaskRandomStream(i);
+ *   ... // Use rng.RandInt(), rng.Random(), ...
+ * }
+ * @endcode
+ *
+ * The numbers are generated with the Philox4x32 generator.  Normal numbers are
+ * generated with the Box-Muller transform, so the same seed gives the same
+ * numbers on every platform.
+ */
+class RandomStream
+{
+ public:
+  /**
+   * Create the stream with the given seed and identifier.
+   *
+   * @param seed Seed of the stream.
+   * @param stream Identifier of the stream.
+   */
+  RandomStream(const uint64_t seed = 0, const uint64_t stream = 0) :
+      engine(seed, stream),
+      hasNormal(false),
+      normal(0.0)
+  { /* Nothing to do. */ }
+
+  //! Generate a uniform random number between 0 and 1.
+  double Random();
+
+  //! Generate a uniform random number in the specified range.
+  double Random(const double lo, const double hi)
+  { return lo + (hi - lo) * Random(); }
+
+  //! Generate a 0/1 specified by the input.
+  double RandBernoulli(const double input) { return Random() < input ? 1 : 0; }
+
+  //! Generate a uniform random integer in [0, hiExclusive).
+  int RandInt(const int hiExclusive)
+  { return (int) std::floor((double) hiExclusive * Random()); }
+
+  //! Generate a uniform random integer in [lo, hiExclusive).
+  int RandInt(const int lo, const int hiExclusive)
+  { return lo + (int) std::floor((double) (hiExclusive - lo) * Random()); }
+
+  //! Generate a normally distributed random number with mean 0 and variance 1.
+  double RandNormal();
+
+  //! Generate a normally distributed random number with the specified mean and
+  //! variance (which, as for math::RandNormal(), scales the number).
+  double RandNormal(const double mean, const double variance)
+  { return variance * RandNormal() + mean; }
+
+  /**
+   * Fill the given object (a matrix, vector or cube) with uniform random
+   * numbers between 0 and 1.  The numbers are generated in parallel when
+   * OpenMP is available, and don't depend on the number of threads.
+   */
+  template<typename MatType>
+  void Randu(MatType& x);
+
+  /**
+   * Fill the given object (a matrix, vector or cube) with normally distributed
+   * random numbers with mean 0 and variance 1.  The numbers are generated in
+   * parallel when OpenMP is available, and don't depend on the number of
+   * threads.
+   */
+  template<typename MatType>
+  void Randn(MatType& x);
+
+  /**
+   * Obtain no more than maxNumSamples distinct samples in [loInclusive,
+   * hiExclusive), like math::ObtainDistinctSamples(), but with the numbers of
+   * this stream.
+   *
+   * @param loInclusive The lower bound (inclusive).
+   * @param hiExclusive The high bound (exclusive).
+   * @param maxNumSamples The maximum number of samples to obtain.
+   * @param distinctSamples The samples that will be obtained.
+   */
+  void ObtainDistinctSamples(const size_t loInclusive,
+                             const size_t hiExclusive,
+                             const size_t maxNumSamples,
+                             arma::uvec& distinctSamples);
+
+  //! Get the underlying generator, to use with standard distributions.
+  Philox4x32& Engine() { return engine; }
+
+ private:
+  //! Convert two random 32-bit numbers to a double in [0, 1).
+  static double ToDouble(const uint32_t a, const uint32_t b)
+  {
+    return ((a >> 5) * 67108864.0 + (b >> 6)) * (1.0 / 9007199254740992.0);
+  }
+
+  //! Convert two uniform numbers in [0, 1) to two normal numbers.
+  static void BoxMuller(const double u1, const double u2, double& z1,
+                        double& z2);
+
+  //! The generator.
+  Philox4x32 engine;
+  //! Whether a normal number is left from the last Box-Muller transform.
+  bool hasNormal;
+  //! The normal number left from the last Box-Muller transform.
+  double normal;
+};
+
+/**
+ * Get the random stream of the task with the given identifier.  The seed of
+ * the stream is the one given to mlpack::math::RandomSeed(), so parallel
+ * algorithms that use one stream per task can be reproduced in the same way as
+ * sequential ones.
+ *
+ * @param task Identifier of the task (for instance, the index of the
+ *     iteration of a parallel loop).
+ */
+inline RandomStream TaskRandomStream(const uint64_t task)
+{
+  ThreadRandomState* state = CurrentThreadRandomState();
+  return RandomStream((state == NULL) ? randStreamSeed : state->streamSeed,
+      task);
+}
+
+/**
+ * While an object of this class exists, the global random functions of
+ * mlpack::math (Random(), RandInt(), RandNormal(), ...) called by the thread
+ * that created it draw from a generator of its own instead of from the shared
+ * global generator, and the Armadillo generator of the thread (used by
+ * arma::randu(), arma::shuffle(), ...) is reseeded.  Both are seeded from
+ * TaskRandomStream(task), so a task gets the same numbers whichever thread runs
+ * it, and tasks can run code that draws random numbers at the same time.  Code
+ * that uses math::randGen directly still uses the global generator.
+ *
+ * @code
+ * #pragma omp parallel for
+ * for (omp_size_t i = 0; i < (omp_size_t) numModels; ++i)
+ * {
+ *   ThreadRandomScope scope(i);
+ *   models[i].Train(data); // Calls math::Random(), arma::randu(), ...
+ * }
+ * @endcode
+ */
+class ThreadRandomScope
+{
+ public:
+  /**
+   * Replace the generators of the calling thread with ones seeded for the
+   * given task.
+   *
+   * @param task Identifier of the task.
+   */
+  ThreadRandomScope(const uint64_t task);
+
+  //! Restore the generator that the calling thread used before.
+  ~ThreadRandomScope();
+
+  //! The scope can't be copied, since it is tied to the thread.
+  ThreadRandomScope(const ThreadRandomScope&) = delete;
+  ThreadRandomScope& operator=(const ThreadRandomScope&) = delete;
+
+ private:
+  //! The generators of the thread while the scope exists.
+  ThreadRandomState state;
+  //! The state that the thread used before (NULL for the global generator).
+  ThreadRandomState* previous;
+};
+
+} // namespace math
+} // namespace mlpack
+
+// Include implementation.
+#include "random_stream_impl.hpp"
+
+#endif
@@ -0,0 +1,257 @@
+/**
+ * @file core/math/random_stream_impl.hpp
+ *
+ * Implementation of counter-based random number streams.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_MATH_RANDOM_STREAM_IMPL_HPP
+#define MLPACK_CORE_MATH_RANDOM_STREAM_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "random_stream.hpp"
+
+namespace mlpack {
+namespace math {
+
+inline Philox4x32::Philox4x32(const uint64_t seed, const uint64_t stream) :
+    counter(0),
+    position(4)
+{
+  key[0] = (uint32_t) seed;
+  key[1] = (uint32_t) (seed >> 32);
+  this->stream[0] = (uint32_t) stream;
+  this->stream[1] = (uint32_t) (stream >> 32);
+}
+
+inline Philox4x32::result_type Philox4x32::operator()()
+{
+  if (position == 4)
+  {
+    Block(counter++, buffer);
+    position = 0;
+  }
+
+  return buffer[position++];
+}
+
+inline void Philox4x32::Block(const uint64_t block, uint32_t output[4]) const
+{
+  uint32_t c[4] = { (uint32_t) block, (uint32_t) (block >> 32), stream[0],
+      stream[1] };
+  uint32_t k[2] = { key[0], key[1] };
+
+  // Ten rounds of the Philox bijection, bumping the key between rounds.
+  for (size_t round = 0; round < 10; ++round)
+  {
+    const uint64_t p0 = (uint64_t) 0xD2511F53 * c[0];
+    const uint64_t p1 = (uint64_t) 0xCD9E8D57 * c[2];
+    c[0] = (uint32_t) (p1 >> 32) ^ c[1] ^ k[0];
+    c[1] = (uint32_t) p1;
+    c[2] = (uint32_t) (p0 >> 32) ^ c[3] ^ k[1];
+    c[3] = (uint32_t) p0;
+
+    k[0] += 0x9E3779B9;
+    k[1] += 0xBB67AE85;
+  }
+
+  for (size_t i = 0; i < 4; ++i)
+    output[i] = c[i];
+}
+
+inline void Philox4x32::Blocks(const uint64_t first,
+                               const size_t numBlocks,
+                               uint32_t* output) const
+{
+  // The blocks are computed in groups of eight lanes, one lane per block.
+  const size_t lanes = 8;
+  for (size_t start = 0; start < numBlocks; start += lanes)
+  {
+    uint32_t c0[lanes], c1[lanes], c2[lanes], c3[lanes];
+    for (size_t l = 0; l < lanes; ++l)
+    {
+      const uint64_t block = first + start + l;
+      c0[l] = (uint32_t) block;
+      c1[l] = (uint32_t) (block >> 32);
+      c2[l] = stream[0];
+      c3[l] = stream[1];
+    }
+
+    uint32_t k0 = key[0], k1 = key[1];
+    for (size_t round = 0; round < 10; ++round)
+    {
+      #pragma omp simd
+      for (size_t l = 0; l < lanes; ++l)
+      {
+        const uint64_t p0 = (uint64_t) 0xD2511F53 * c0[l];
+        const uint64_t p1 = (uint64_t) 0xCD9E8D57 * c2[l];
+        c0[l] = (uint32_t) (p1 >> 32) ^ c1[l] ^ k0;
+        c1[l] = (uint32_t) p1;
+        c2[l] = (uint32_t) (p0 >> 32) ^ c3[l] ^ k1;
+        c3[l] = (uint32_t) p0;
+      }
+
+      k0 += 0x9E3779B9;
+      k1 += 0xBB67AE85;
+    }
+
+    const size_t count = std::min(lanes, numBlocks - start);
+    for (size_t l = 0; l < count; ++l)
+    {
+      uint32_t* out = output + 4 * (start + l);
+      out[0] = c0[l];
+      out[1] = c1[l];
+      out[2] = c2[l];
+      out[3] = c3[l];
+    }
+  }
+}
+
+inline void Philox4x32::Skip(const uint64_t numBlocks)
+{
+  counter += numBlocks;
+  position = 4;
+}
+
+inline double RandomStream::Random()
+{
+  const uint32_t a = engine();
+  const uint32_t b = engine();
+  return ToDouble(a, b);
+}
+
+inline double RandomStream::RandNormal()
+{
+  if (hasNormal)
+  {
+    hasNormal = false;
+    return normal;
+  }
+
+  const double u1 = Random();
+  const double u2 = Random();
+  double z;
+  BoxMuller(u1, u2, z, normal);
+  hasNormal = true;
+  return z;
+}
+
+inline void RandomStream::BoxMuller(const double u1,
+                                    const double u2,
+                                    double& z1,
+                                    double& z2)
+{
+  // 1 - u1 is in (0, 1], so the logarithm is finite.
+  const double r = std::sqrt(-2.0 * std::log(1.0 - u1));
+  z1 = r * std::cos(2.0 * M_PI * u2);
+  z2 = r * std::sin(2.0 * M_PI * u2);
+}
+
+template<typename MatType>
+void RandomStream::Randu(MatType& x)
+{
+  typedef typename MatType::elem_type ElemType;
+
+  // Each block gives two numbers; the blocks are computed independently.
+  const uint64_t first = engine.NextBlock();
+  const size_t numBlocks = (x.n_elem + 1) / 2;
+  ElemType* mem = x.memptr();
+
+  #pragma omp parallel for
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const size_t i = 2 * (size_t) b;
+    uint32_t output[4];
+    engine.Block(first + b, output);
+
+    mem[i] = (ElemType) ToDouble(output[0], output[1]);
+    if (i + 1 < x.n_elem)
+      mem[i + 1] = (ElemType) ToDouble(output[2], output[3]);
+  }
+
+  engine.Skip(numBlocks);
+}
+
+template<typename MatType>
+void RandomStream::Randn(MatType& x)
+{
+  typedef typename MatType::elem_type ElemType;
+
+  // Each block gives two uniform numbers, and so two normal numbers.
+  const uint64_t first = engine.NextBlock();
+  const size_t numBlocks = (x.n_elem + 1) / 2;
+  ElemType* mem = x.memptr();
+
+  #pragma omp parallel for
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const size_t i = 2 * (size_t) b;
+    uint32_t output[4];
+    engine.Block(first + b, output);
+
+    double z1, z2;
+    BoxMuller(ToDouble(output[0], output[1]), ToDouble(output[2], output[3]),
+        z1, z2);
+
+    mem[i] = (ElemType) z1;
+    if (i + 1 < x.n_elem)
+      mem[i + 1] = (ElemType) z2;
+  }
+
+  engine.Skip(numBlocks);
+}
+
+inline void RandomStream::ObtainDistinctSamples(const size_t loInclusive,
+                                                const size_t hiExclusive,
+                                                const size_t maxNumSamples,
+                                                arma::uvec& distinctSamples)
+{
+  const size_t samplesRangeSize = hiExclusive - loInclusive;
+
+  if (samplesRangeSize > maxNumSamples)
+  {
+    arma::Col<size_t> samples;
+    samples.zeros(samplesRangeSize);
+
+    for (size_t i = 0; i < maxNumSamples; i++)
+      samples[(size_t) RandInt(samplesRangeSize)]++;
+
+    distinctSamples = arma::find(samples > 0);
+
+    if (loInclusive > 0)
+      distinctSamples += loInclusive;
+  }
+  else
+  {
+    distinctSamples.set_size(samplesRangeSize);
+    for (size_t i = 0; i < samplesRangeSize; i++)
+      distinctSamples[i] = loInclusive + i;
+  }
+}
+
+inline ThreadRandomScope::ThreadRandomScope(const uint64_t task) :
+    previous(CurrentThreadRandomState())
+{
+  Philox4x32 engine = TaskRandomStream(task).Engine();
+  const uint32_t low = engine();
+  const uint32_t high = engine();
+
+  state.generator.seed(low);
+  state.streamSeed = (previous == NULL) ? randStreamSeed : previous->streamSeed;
+  arma::arma_rng::set_seed((arma::arma_rng::seed_type)
+      (((uint64_t) high << 32) | low));
+  CurrentThreadRandomState() = &state;
+}
+
+inline ThreadRandomScope::~ThreadRandomScope()
+{
+  CurrentThreadRandomState() = previous;
+}
+
+} // namespace math
+} // namespace mlpack
+
+#endif
@@ -57,6 +57,16 @@ class RangeType
    */
   inline RangeType(const T lo, const T hi);
 
+  /**
+   * Initialize to the same range as a range with a different element type
+   * (for instance, to compare the float ranges of a tree built on float data
+   * with a double range).
+   *
+   * @param other Range to copy the bounds of.
+   */
+  template<typename U>
+  inline RangeType(const RangeType<U>& other);
+
   //! Get the lower bound.
   inline T Lo() const { return lo; }
   //! Modify the lower bound.
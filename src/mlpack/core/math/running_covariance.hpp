@@ -0,0 +1,127 @@
+/**
+ * @file core/math/running_covariance.hpp
+ *
+ * Declaration of RunningCovariance, which computes the mean and covariance of
+ * points in one pass, block by block.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_MATH_RUNNING_COVARIANCE_HPP
+#define MLPACK_CORE_MATH_RUNNING_COVARIANCE_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace math {
+
+/**
+ * Keep the (weighted) mean and covariance of a set of points, which can be
+ * given in any number of chunks.  Each chunk is split into blocks of columns;
+ * the mean and scatter matrix of each block are computed with a copy of the
+ * block only, and merged into the statistics with the pairwise update of Chan,
+ * Golub and LeVeque, which is numerically stable.  So the covariance of a
+ * dataset is computed in one pass, without a centered copy of the whole
+ * dataset, and the blocks are processed in parallel when OpenMP is available.
+ * The statistics of two sets of points can be merged too.
+ *
+ * @code
+ * RunningCovariance<> covariance;
+ * covariance.Update(chunk1);
+ * covariance.Update(chunk2);
+ * arma::vec mean = covariance.Mean();
+ * arma::mat cov = covariance.Covariance();
+ * @endcode
+ *
+ * @tparam ElemType Type of element of the points.
+ */
+template<typename ElemType = double>
+class RunningCovariance
+{
+ public:
+  /**
+   * Create the statistics of an empty set of points.  If the dimensionality is
+   * 0, it is taken from the first points given.
+   *
+   * @param dimensionality Dimensionality of the points.
+   * @param blockSize Number of points of each block.
+   */
+  RunningCovariance(const size_t dimensionality = 0,
+                    const size_t blockSize = 256);
+
+  /**
+   * Add the given points (one per column) to the statistics.
+   *
+   * @param points Points to add.
+   */
+  void Update(const arma::Mat<ElemType>& points);
+
+  /**
+   * Add the given points (one per column) to the statistics, each with the
+   * given weight.
+   *
+   * @param points Points to add.
+   * @param weights Weight of each point.
+   */
+  void Update(const arma::Mat<ElemType>& points,
+              const arma::Col<ElemType>& weights);
+
+  /**
+   * Add the statistics of another set of points to these statistics.
+   *
+   * @param other Statistics to merge.
+   */
+  void Merge(const RunningCovariance& other);
+
+  /**
+   * Return the covariance of the points.  With normType 0, the scatter matrix
+   * is divided by the total weight minus one (the unbiased estimator, for
+   * unweighted points), or by one if the total weight is at most one; with
+   * normType 1, it is divided by the total weight.
+   *
+   * @param normType Normalization to use (0 or 1).
+   */
+  arma::Mat<ElemType> Covariance(const size_t normType = 0) const;
+
+  //! Get the total weight of the points (their number, if unweighted).
+  ElemType Weight() const { return weight; }
+  //! Get the mean of the points.
+  const arma::Col<ElemType>& Mean() const { return mean; }
+  //! Get the scatter matrix of the points (the sum of the weighted outer
+  //! products of the centered points).
+  const arma::Mat<ElemType>& Scatter() const { return scatter; }
+
+  //! Get the number of points of each block.
+  size_t BlockSize() const { return blockSize; }
+  //! Modify the number of points of each block.
+  size_t& BlockSize() { return blockSize; }
+
+ private:
+  //! Add the given points, weighted if weights is not NULL.
+  void Accumulate(const arma::Mat<ElemType>& points,
+                  const arma::Col<ElemType>* weights);
+
+  //! Merge the given statistics into these statistics.
+  void Merge(const ElemType otherWeight,
+             const arma::Col<ElemType>& otherMean,
+             const arma::Mat<ElemType>& otherScatter);
+
+  //! The total weight of the points.
+  ElemType weight;
+  //! The mean of the points.
+  arma::Col<ElemType> mean;
+  //! The scatter matrix of the points.
+  arma::Mat<ElemType> scatter;
+  //! The number of points of each block.
+  size_t blockSize;
+};
+
+} // namespace math
+} // namespace mlpack
+
+// Include implementation.
+#include "running_covariance_impl.hpp"
+
+#endif
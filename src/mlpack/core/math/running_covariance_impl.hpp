@@ -0,0 +1,201 @@
+/**
+ * @file core/math/running_covariance_impl.hpp
+ *
+ * Implementation of RunningCovariance.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_MATH_RUNNING_COVARIANCE_IMPL_HPP
+#define MLPACK_CORE_MATH_RUNNING_COVARIANCE_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "running_covariance.hpp"
+
+namespace mlpack {
+namespace math {
+
+template<typename ElemType>
+RunningCovariance<ElemType>::RunningCovariance(const size_t dimensionality,
+                                               const size_t blockSize) :
+    weight(0),
+    mean(dimensionality, arma::fill::zeros),
+    scatter(dimensionality, dimensionality, arma::fill::zeros),
+    blockSize(blockSize)
+{
+  if (blockSize == 0)
+  {
+    throw std::invalid_argument("RunningCovariance: block size must be "
+        "positive");
+  }
+}
+
+template<typename ElemType>
+void RunningCovariance<ElemType>::Update(const arma::Mat<ElemType>& points)
+{
+  Accumulate(points, NULL);
+}
+
+template<typename ElemType>
+void RunningCovariance<ElemType>::Update(const arma::Mat<ElemType>& points,
+                                         const arma::Col<ElemType>& weights)
+{
+  if (weights.n_elem != points.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "RunningCovariance::Update(): " << weights.n_elem << " weights "
+        << "given for " << points.n_cols << " points";
+    throw std::invalid_argument(oss.str());
+  }
+
+  Accumulate(points, &weights);
+}
+
+template<typename ElemType>
+void RunningCovariance<ElemType>::Merge(const RunningCovariance& other)
+{
+  if (other.weight == 0)
+    return;
+
+  if (weight == 0 && mean.n_elem == 0)
+  {
+    mean.zeros(other.mean.n_elem);
+    scatter.zeros(other.mean.n_elem, other.mean.n_elem);
+  }
+  else if (other.mean.n_elem != mean.n_elem)
+  {
+    std::ostringstream oss;
+    oss << "RunningCovariance::Merge(): statistics have dimensionality "
+        << other.mean.n_elem << ", but expected " << mean.n_elem;
+    throw std::invalid_argument(oss.str());
+  }
+
+  Merge(other.weight, other.mean, other.scatter);
+}
+
+template<typename ElemType>
+arma::Mat<ElemType> RunningCovariance<ElemType>::Covariance(
+    const size_t normType) const
+{
+  if (normType > 1)
+  {
+    throw std::invalid_argument("RunningCovariance::Covariance(): normType "
+        "must be 0 or 1");
+  }
+
+  ElemType norm = weight;
+  if (normType == 0)
+    norm = (weight > 1) ? weight - 1 : ElemType(1);
+  else if (weight == 0)
+    norm = ElemType(1);
+
+  return scatter / norm;
+}
+
+template<typename ElemType>
+void RunningCovariance<ElemType>::Accumulate(
+    const arma::Mat<ElemType>& points,
+    const arma::Col<ElemType>* weights)
+{
+  if (points.n_cols == 0)
+    return;
+
+  const size_t dimensionality = points.n_rows;
+  if (weight == 0 && mean.n_elem == 0)
+  {
+    mean.zeros(dimensionality);
+    scatter.zeros(dimensionality, dimensionality);
+  }
+  else if (dimensionality != mean.n_elem)
+  {
+    std::ostringstream oss;
+    oss << "RunningCovariance::Update(): points have dimensionality "
+        << dimensionality << ", but expected " << mean.n_elem;
+    throw std::invalid_argument(oss.str());
+  }
+
+  // Each thread takes a contiguous range of blocks, so the order of the merges
+  // (and so the result) only depends on the number of threads.
+  const size_t blocks = (points.n_cols + blockSize - 1) / blockSize;
+  #ifdef HAS_OPENMP
+    const size_t threads = std::min((size_t) omp_get_max_threads(), blocks);
+  #else
+    const size_t threads = 1;
+  #endif
+
+  std::vector<RunningCovariance> partial(threads,
+      RunningCovariance(dimensionality, blockSize));
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t t = 0; t < (omp_size_t) threads; ++t)
+  {
+    const size_t firstBlock = t * blocks / threads;
+    const size_t lastBlock = (t + 1) * blocks / threads;
+    for (size_t b = firstBlock; b < lastBlock; ++b)
+    {
+      const size_t begin = b * blockSize;
+      const size_t end = std::min(begin + blockSize, (size_t) points.n_cols);
+
+      // Alias the block, to only copy it once it is centered.
+      const arma::Mat<ElemType> block(const_cast<ElemType*>(
+          points.colptr(begin)), dimensionality, end - begin, false, true);
+
+      ElemType blockWeight;
+      arma::Col<ElemType> blockMean;
+      arma::Mat<ElemType> blockScatter;
+      if (weights == NULL)
+      {
+        blockWeight = ElemType(end - begin);
+        blockMean = arma::mean(block, 1);
+        const arma::Mat<ElemType> centered = block.each_col() - blockMean;
+        blockScatter = centered * centered.t();
+      }
+      else
+      {
+        const arma::Col<ElemType> w = weights->subvec(begin, end - 1);
+        blockWeight = arma::accu(w);
+        if (blockWeight == 0)
+          continue;
+
+        blockMean = block * w / blockWeight;
+        const arma::Mat<ElemType> centered = block.each_col() - blockMean;
+        blockScatter = centered * (centered.each_row() % w.t()).t();
+      }
+
+      partial[t].Merge(blockWeight, blockMean, blockScatter);
+    }
+  }
+
+  for (size_t t = 0; t < threads; ++t)
+    Merge(partial[t].weight, partial[t].mean, partial[t].scatter);
+}
+
+template<typename ElemType>
+void RunningCovariance<ElemType>::Merge(
+    const ElemType otherWeight,
+    const arma::Col<ElemType>& otherMean,
+    const arma::Mat<ElemType>& otherScatter)
+{
+  if (otherWeight == 0)
+    return;
+
+  if (weight == 0)
+  {
+    weight = otherWeight;
+    mean = otherMean;
+    scatter = otherScatter;
+    return;
+  }
+
+  const ElemType total = weight + otherWeight;
+  const arma::Col<ElemType> delta = otherMean - mean;
+  mean += delta * (otherWeight / total);
+  scatter += otherScatter + (delta * delta.t()) * (weight * otherWeight / total);
+  weight = total;
+}
+
+} // namespace math
+} // namespace mlpack
+
+#endif
@@ -13,6 +13,7 @@
 #define MLPACK_CORE_MATH_SHUFFLE_DATA_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/random.hpp>
 
 namespace mlpack {
 namespace math {
@@ -237,6 +238,57 @@ void ShuffleData(const MatType& inputPoints,
   }
 }
 
+namespace details {
+
+//! Nothing is left to swap.
+inline void SwapColumns(const size_t /* i */, const size_t /* j */) { }
+
+//! Swap the two given columns of each of the given matrices.
+template<typename MatType, typename... OthersType>
+void SwapColumns(const size_t i,
+                 const size_t j,
+                 MatType& matrix,
+                 OthersType&... others)
+{
+  matrix.swap_cols(i, j);
+  SwapColumns(i, j, others...);
+}
+
+} // namespace details
+
+/**
+ * Shuffle a dense dataset in place, along with any number of associated
+ * objects with the same number of columns (labels, responses, weights, ...).
+ * Columns are swapped with a Fisher-Yates shuffle, so no copy of the dataset
+ * is made, unlike ShuffleData().  The random numbers are drawn with
+ * mlpack::math::Random(), so the shuffle can be reproduced with
+ * mlpack::math::RandomSeed().
+ *
+ * @code
+ * arma::mat data = loadData();
+ * arma::Row<size_t> labels = loadLabels();
+ * ShuffleDataInPlace(data, labels);
+ * @endcode
+ *
+ * @param points Dataset to shuffle.
+ * @param others Objects to shuffle along with the dataset.
+ */
+template<typename MatType, typename... OthersType>
+void ShuffleDataInPlace(MatType& points, OthersType&... others)
+{
+  static_assert(!arma::is_SpMat<MatType>::value &&
+      !arma::is_Cube<MatType>::value,
+      "ShuffleDataInPlace() only supports dense matrices");
+
+  for (size_t i = points.n_cols; i > 1; --i)
+  {
+    // Choose the column to place at position i - 1 among the first i ones.
+    const size_t j = std::min((size_t) (i * Random()), i - 1);
+    if (j != i - 1)
+      details::SwapColumns(i - 1, j, points, others...);
+  }
+}
+
 } // namespace math
 } // namespace mlpack
 
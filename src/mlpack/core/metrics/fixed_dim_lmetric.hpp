@@ -0,0 +1,84 @@
+/**
+ * @file core/metrics/fixed_dim_lmetric.hpp
+ *
+ * An L-metric for points whose dimensionality is known at compile time.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_METRICS_FIXED_DIM_LMETRIC_HPP
+#define MLPACK_CORE_METRICS_FIXED_DIM_LMETRIC_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "lmetric.hpp"
+
+namespace mlpack {
+namespace metric {
+
+/**
+ * The L-metric LMetric<TPower, TTakeRoot>, for points with exactly Dim
+ * dimensions.  Since the number of dimensions is a compile-time constant, the
+ * loop of Evaluate() over the dimensions can be fully unrolled by the compiler,
+ * and no temporary vector is created, which matters for low-dimensional data
+ * (for instance 2-D or 3-D coordinates), where the overhead of the Armadillo
+ * expressions of LMetric is large compared to the computation itself.
+ *
+ * HRectBound also uses the dimensionality of this metric, so that a KDTree (or
+ * any other tree with HRectBound) built with this metric computes its bound
+ * distances with loops of fixed length.  For example, for range search on 3-D
+ * points:
+ *
+ * @code
+ * typedef FixedDimLMetric<3, 2, true> EuclideanDistance3D;
+ * RangeSearch<EuclideanDistance3D, arma::mat, KDTree> rs(dataset);
+ * @endcode
+ *
+ * All the points given to the metric must have Dim dimensions.
+ *
+ * @tparam Dim Number of dimensions of the points.
+ * @tparam TPower Power of the metric.
+ * @tparam TTakeRoot Whether or not the root should be taken (see LMetric).
+ */
+template<size_t Dim, int TPower, bool TTakeRoot = true>
+class FixedDimLMetric : public LMetric<TPower, TTakeRoot>
+{
+ public:
+  /**
+   * Computes the distance between two points with Dim dimensions.
+   *
+   * @tparam VecTypeA Type of first vector (generally arma::vec or a column of
+   *      a matrix).
+   * @tparam VecTypeB Type of second vector.
+   * @param a First vector.
+   * @param b Second vector.
+   * @return Distance between vectors a and b.
+   */
+  template<typename VecTypeA, typename VecTypeB>
+  static typename VecTypeA::elem_type Evaluate(const VecTypeA& a,
+                                               const VecTypeB& b);
+
+  //! The number of dimensions of the points.
+  static const size_t Dimensionality = Dim;
+};
+
+//! The Euclidean distance for points with Dim dimensions.
+template<size_t Dim>
+using FixedDimEuclideanDistance = FixedDimLMetric<Dim, 2, true>;
+
+//! The squared Euclidean distance for points with Dim dimensions.
+template<size_t Dim>
+using FixedDimSquaredEuclideanDistance = FixedDimLMetric<Dim, 2, false>;
+
+//! The Manhattan distance for points with Dim dimensions.
+template<size_t Dim>
+using FixedDimManhattanDistance = FixedDimLMetric<Dim, 1, false>;
+
+} // namespace metric
+} // namespace mlpack
+
+// Include implementation.
+#include "fixed_dim_lmetric_impl.hpp"
+
+#endif
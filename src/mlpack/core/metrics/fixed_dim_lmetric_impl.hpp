@@ -0,0 +1,56 @@
+/**
+ * @file core/metrics/fixed_dim_lmetric_impl.hpp
+ *
+ * Implementation of the FixedDimLMetric class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_METRICS_FIXED_DIM_LMETRIC_IMPL_HPP
+#define MLPACK_CORE_METRICS_FIXED_DIM_LMETRIC_IMPL_HPP
+
+// In case it hasn't been included.
+#include "fixed_dim_lmetric.hpp"
+
+namespace mlpack {
+namespace metric {
+
+// The power and the dimensionality are known at compile time, so only one
+// branch is kept and the loop can be unrolled.
+template<size_t Dim, int TPower, bool TTakeRoot>
+template<typename VecTypeA, typename VecTypeB>
+typename VecTypeA::elem_type FixedDimLMetric<Dim, TPower, TTakeRoot>::Evaluate(
+    const VecTypeA& a,
+    const VecTypeB& b)
+{
+  typedef typename VecTypeA::elem_type ElemType;
+
+  ElemType sum = 0;
+  for (size_t i = 0; i < Dim; ++i)
+  {
+    const ElemType diff = a[i] - b[i];
+    if (TPower == 1)
+      sum += std::abs(diff);
+    else if (TPower == 2)
+      sum += diff * diff;
+    else if (TPower == INT_MAX)
+      sum = std::max(sum, (ElemType) std::abs(diff));
+    else
+      sum += std::pow(std::abs(diff), (ElemType) TPower);
+  }
+
+  // The root of the L1 and L-infinity distances doesn't matter.
+  if (!TTakeRoot || TPower == 1 || TPower == INT_MAX)
+    return sum;
+  else if (TPower == 2)
+    return std::sqrt(sum);
+  else
+    return std::pow(sum, (ElemType) (1.0 / TPower));
+}
+
+} // namespace metric
+} // namespace mlpack
+
+#endif
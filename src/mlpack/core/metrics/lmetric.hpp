@@ -83,6 +83,27 @@ class LMetric
   static typename VecTypeA::elem_type Evaluate(const VecTypeA& a,
                                                const VecTypeB& b);
 
+  /**
+   * Computes the distances between one point and every column of a matrix.
+   * For the L1, L2 and L-infinity metrics this is done with whole-matrix
+   * operations rather than one call to Evaluate() per column, which lets the
+   * compiler vectorize the computation; this is useful when evaluating all the
+   * points held in a leaf of a tree.  The matrix must be dense.
+   *
+   * @tparam VecType Type of the point (generally arma::vec or a column of a
+   *      matrix).
+   * @tparam MatType Type of the matrix (generally arma::mat or a subview of a
+   *      matrix).
+   * @param a Point.
+   * @param b Matrix whose columns are the other points.
+   * @param distances Vector to store the distances from a to each column of b
+   *      in.
+   */
+  template<typename VecType, typename MatType>
+  static void BatchEvaluate(const VecType& a,
+                            const MatType& b,
+                            arma::Col<typename MatType::elem_type>& distances);
+
   //! Serialize the metric (nothing to do).
   template<typename Archive>
   void serialize(Archive& /* ar */, const unsigned int /* version */) { }
@@ -106,6 +106,36 @@ typename VecTypeA::elem_type LMetric<INT_MAX, false>::Evaluate(
   return arma::as_scalar(arma::max(arma::abs(a - b)));
 }
 
+// The power is known at compile time, so only one branch is kept.
+template<int Power, bool TakeRoot>
+template<typename VecType, typename MatType>
+void LMetric<Power, TakeRoot>::BatchEvaluate(
+    const VecType& a,
+    const MatType& b,
+    arma::Col<typename MatType::elem_type>& distances)
+{
+  if (Power == 1)
+  {
+    distances = arma::sum(arma::abs(b.each_col() - a), 0).t();
+  }
+  else if (Power == 2)
+  {
+    distances = arma::sum(arma::square(b.each_col() - a), 0).t();
+    if (TakeRoot)
+      distances = arma::sqrt(distances);
+  }
+  else if (Power == INT_MAX)
+  {
+    distances = arma::max(arma::abs(b.each_col() - a), 0).t();
+  }
+  else
+  {
+    distances.set_size(b.n_cols);
+    for (size_t i = 0; i < b.n_cols; ++i)
+      distances[i] = Evaluate(a, b.col(i));
+  }
+}
+
 } // namespace metric
 } // namespace mlpack
 
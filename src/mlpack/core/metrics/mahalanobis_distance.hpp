@@ -38,9 +38,11 @@ namespace metric {
  * If you wish to use the KNN class or other tree-based algorithms with this
  * distance, it is recommended to instead stretch the dataset first, by
  * decomposing Q = L^T L (perhaps via a Cholesky decomposition), and then
- * multiply the data by L.  If you still wish to use the KNN class with a custom
- * distance anyway, you will need to use a different tree type than the default
- * KDTree, which only works with the LMetric class.
+ * multiply the data by L.  Transformation() computes such an L, and
+ * MahalanobisSearch does this for a NeighborSearch or RangeSearch object.  If
+ * you still wish to use the KNN class with a custom distance anyway, you will
+ * need to use a different tree type than the default KDTree, which only works
+ * with the LMetric class.
  *
  * Similar to the LMetric class, this offers a template parameter TakeRoot
  * which, when set to false, will instead evaluate the distance
@@ -110,6 +112,19 @@ class MahalanobisDistance
    */
   arma::mat& Covariance() { return covariance; }
 
+  /**
+   * Compute a matrix L such that L^T L = Q, so that the Mahalanobis distance
+   * between x and y is the Euclidean distance between L x and L y.  This is the
+   * upper Cholesky factor of Q when Q is positive definite; otherwise (for
+   * instance, when Q = M^T M was learned with a rank-deficient M) it is built
+   * from the eigendecomposition of Q, with negative eigenvalues taken as zero.
+   * If the covariance matrix has not been set, the empty matrix is returned,
+   * since Evaluate() then uses the identity.
+   *
+   * @return The transformation L.
+   */
+  arma::mat Transformation() const;
+
   //! Serialize the Mahalanobis distance.
   template<typename Archive>
   void serialize(Archive& ar, const unsigned int version);
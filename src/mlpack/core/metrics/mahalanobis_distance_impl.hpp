@@ -47,6 +47,37 @@ double MahalanobisDistance<true>::Evaluate(const VecTypeA& a,
   return sqrt(out[0]);
 }
 
+template<bool TakeRoot>
+arma::mat MahalanobisDistance<TakeRoot>::Transformation() const
+{
+  arma::mat transformation;
+  if (covariance.n_elem == 0)
+    return transformation;
+
+  if (covariance.n_rows != covariance.n_cols)
+  {
+    throw std::invalid_argument("MahalanobisDistance::Transformation(): the "
+        "covariance matrix must be square");
+  }
+
+  // This returns false instead of throwing when Q is not positive definite;
+  // that case is handled below.
+  if (arma::chol(transformation, covariance))
+    return transformation;
+
+  arma::vec eigenvalues;
+  arma::mat eigenvectors;
+  if (!arma::eig_sym(eigenvalues, eigenvectors, covariance))
+  {
+    throw std::runtime_error("MahalanobisDistance::Transformation(): "
+        "eigendecomposition of the covariance matrix failed");
+  }
+
+  eigenvalues = arma::sqrt(arma::clamp(eigenvalues, 0.0, arma::datum::inf));
+  transformation = arma::diagmat(eigenvalues) * eigenvectors.t();
+  return transformation;
+}
+
 // Serialize the Mahalanobis distance.
 template<bool TakeRoot>
 template<typename Archive>
@@ -0,0 +1,138 @@
+/**
+ * @file core/metrics/mahalanobis_search.hpp
+ *
+ * A wrapper that runs a Euclidean search (such as KNN or RangeSearch) under a
+ * Mahalanobis distance by transforming the data once.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_METRICS_MAHALANOBIS_SEARCH_HPP
+#define MLPACK_CORE_METRICS_MAHALANOBIS_SEARCH_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "mahalanobis_distance.hpp"
+
+namespace mlpack {
+namespace metric {
+
+/**
+ * Run a search under the Mahalanobis distance d(x, y) = sqrt((x - y)^T Q (x -
+ * y)) by building a search object with the Euclidean distance on the
+ * transformed points L x, where L^T L = Q (see
+ * MahalanobisDistance::Transformation()).  The reference set is transformed
+ * once, when the object is built, and each query set is transformed when it is
+ * searched; each distance evaluation then costs O(d) instead of the O(d^2) of
+ * MahalanobisDistance::Evaluate(), and the search can use any tree, including
+ * the kd-tree.  The results are the same as the results of the search with the
+ * Mahalanobis distance.
+ *
+ * This is meant for the distances learned by LMNN or NCA: if the learned
+ * transformation is already known, it can be given directly.
+ *
+ * @code
+ * arma::mat transformation;
+ * LMNN<> lmnn(data, labels, 3);
+ * lmnn.LearnDistance(transformation);
+ *
+ * MahalanobisSearch<KNN> search(data, transformation);
+ * search.Search(queries, 3, neighbors, distances);
+ * @endcode
+ *
+ * Searches that don't take a query set (such as the monochromatic search of
+ * NeighborSearch) can be run on the wrapped object directly, with Searcher().
+ *
+ * @tparam SearchType Type of the search to run; it must use the Euclidean
+ *     distance and take the reference set as the first argument of its
+ *     constructor and the query set as the first argument of Search() (like
+ *     NeighborSearch and RangeSearch).
+ */
+template<typename SearchType>
+class MahalanobisSearch
+{
+ public:
+  /**
+   * Build the search object on the given reference set, transformed for the
+   * given Mahalanobis distance.
+   *
+   * @param referenceSet Set of reference points.
+   * @param metric Mahalanobis distance to search with.
+   */
+  MahalanobisSearch(const arma::mat& referenceSet,
+                    const MahalanobisDistance<true>& metric) :
+      transformation(metric.Transformation()),
+      searcher(Transform(referenceSet))
+  { /* Nothing to do. */ }
+
+  /**
+   * Build the search object on the given reference set, transformed by the
+   * given matrix L; this searches with the Mahalanobis distance of covariance
+   * L^T L.
+   *
+   * @param referenceSet Set of reference points.
+   * @param transformation Transformation L to apply to the points.
+   */
+  MahalanobisSearch(const arma::mat& referenceSet,
+                    arma::mat transformation) :
+      transformation(std::move(transformation)),
+      searcher(Transform(referenceSet))
+  { /* Nothing to do. */ }
+
+  /**
+   * Transform the given query set and search for it with the wrapped search
+   * object; the remaining arguments are given to SearchType::Search().
+   *
+   * @param querySet Set of query points.
+   * @param args Other arguments of SearchType::Search().
+   */
+  template<typename... Args>
+  void Search(const arma::mat& querySet, Args&&... args)
+  {
+    searcher.Search(Transform(querySet), std::forward<Args>(args)...);
+  }
+
+  /**
+   * Transform the given points (the columns of the matrix) into the space where
+   * the Euclidean distance is the Mahalanobis distance.
+   *
+   * @param points Points to transform.
+   * @return The transformed points.
+   */
+  arma::mat Transform(const arma::mat& points) const
+  {
+    if (transformation.is_empty())
+      return points;
+
+    if (transformation.n_cols != points.n_rows)
+    {
+      std::ostringstream oss;
+      oss << "MahalanobisSearch::Transform(): the transformation has "
+          << transformation.n_cols << " columns, but the points have "
+          << points.n_rows << " dimensions";
+      throw std::invalid_argument(oss.str());
+    }
+
+    return transformation * points;
+  }
+
+  //! Get the transformation L (empty if it is the identity).
+  const arma::mat& Transformation() const { return transformation; }
+
+  //! Get the wrapped search object.
+  const SearchType& Searcher() const { return searcher; }
+  //! Modify the wrapped search object.
+  SearchType& Searcher() { return searcher; }
+
+ private:
+  //! The transformation L, with L^T L = Q.
+  arma::mat transformation;
+  //! The search object, built on the transformed reference set.
+  SearchType searcher;
+};
+
+} // namespace metric
+} // namespace mlpack
+
+#endif
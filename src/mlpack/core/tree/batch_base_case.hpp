@@ -0,0 +1,72 @@
+/**
+ * @file core/tree/batch_base_case.hpp
+ *
+ * A utility function that lets a traverser evaluate the base cases between one
+ * query point and a contiguous block of reference points at once, if the rules
+ * support it.  Rules that do not implement BatchBaseCase() get one BaseCase()
+ * call per reference point, as usual.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_BATCH_BASE_CASE_HPP
+#define MLPACK_CORE_TREE_BATCH_BASE_CASE_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/sfinae_utility.hpp>
+
+namespace mlpack {
+namespace tree {
+
+HAS_MEM_FUNC(BatchBaseCase, HasBatchBaseCaseCheck);
+
+/**
+ * 'value' is true if the RuleType class has a member
+ * BatchBaseCase(const size_t queryIndex, const size_t referenceBegin,
+ *               const size_t referenceCount).
+ */
+template<typename RuleType>
+struct HasBatchBaseCase
+{
+  static const bool value = HasBatchBaseCaseCheck<RuleType,
+      void(RuleType::*)(const size_t, const size_t, const size_t)>::value;
+};
+
+/**
+ * Evaluate the base cases between the given query point and the reference
+ * points referenceBegin, ..., referenceBegin + referenceCount - 1, with a
+ * single call to the rules.
+ */
+template<typename RuleType>
+inline typename std::enable_if_t<HasBatchBaseCase<RuleType>::value>
+BatchBaseCase(RuleType& rule,
+              const size_t queryIndex,
+              const size_t referenceBegin,
+              const size_t referenceCount)
+{
+  rule.BatchBaseCase(queryIndex, referenceBegin, referenceCount);
+}
+
+/**
+ * Evaluate the base cases between the given query point and the reference
+ * points referenceBegin, ..., referenceBegin + referenceCount - 1, one at a
+ * time, since the rules do not support batches.
+ */
+template<typename RuleType>
+inline typename std::enable_if_t<!HasBatchBaseCase<RuleType>::value>
+BatchBaseCase(RuleType& rule,
+              const size_t queryIndex,
+              const size_t referenceBegin,
+              const size_t referenceCount)
+{
+  const size_t referenceEnd = referenceBegin + referenceCount;
+  for (size_t i = referenceBegin; i < referenceEnd; ++i)
+    rule.BaseCase(queryIndex, i);
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
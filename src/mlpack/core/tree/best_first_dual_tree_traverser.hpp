@@ -0,0 +1,142 @@
+/**
+ * @file core/tree/best_first_dual_tree_traverser.hpp
+ *
+ * A dual-tree traverser that visits the pairs of query and reference nodes in
+ * order of their score (best first), using a priority queue, instead of
+ * depth-first.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_BEST_FIRST_DUAL_TREE_TRAVERSER_HPP
+#define MLPACK_CORE_TREE_BEST_FIRST_DUAL_TREE_TRAVERSER_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/tree/tree_traits.hpp>
+#include <queue>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * A dual-tree traverser that keeps the pairs of query and reference nodes that
+ * have not been pruned in a priority queue, and always visits the pair with the
+ * lowest score next, at whatever depth it is in either tree.  The pairs that
+ * are most likely to give good candidates are thus visited first, which
+ * tightens the bounds of the query nodes early and lets more of the remaining
+ * pairs be pruned.  Each pair is rescored with Rescore() when it is taken from
+ * the queue, and the traversal information that was current when the pair was
+ * scored is restored before its children are scored.
+ *
+ * The queue may hold many more pairs than the recursion stack of the
+ * depth-first traverser, so this uses more memory.
+ *
+ * This works with any tree type whose points are only held by its leaves, and
+ * in which each point is held by only one leaf (so, not with cover trees or
+ * spill trees).
+ *
+ * @tparam TreeType Type of the trees to traverse.
+ * @tparam RuleType Type of the rules to traverse the trees with.
+ */
+template<typename TreeType, typename RuleType>
+class BestFirstDualTreeTraverser
+{
+  static_assert(!TreeTraits<TreeType>::HasSelfChildren &&
+      !TreeTraits<TreeType>::HasDuplicatedPoints,
+      "BestFirstDualTreeTraverser can't be used with trees where a point can "
+      "be held by more than one node");
+
+ public:
+  /**
+   * Instantiate the traverser with the given rule set.
+   */
+  BestFirstDualTreeTraverser(RuleType& rule);
+
+  /**
+   * Traverse the two trees.  This does not reset the number of prunes.
+   *
+   * @param queryNode The query node to be traversed.
+   * @param referenceNode The reference node to be traversed.
+   */
+  void Traverse(TreeType& queryNode, TreeType& referenceNode);
+
+  //! Get the number of prunes.
+  size_t NumPrunes() const { return numPrunes; }
+  //! Modify the number of prunes.
+  size_t& NumPrunes() { return numPrunes; }
+
+  //! Get the number of visited combinations.
+  size_t NumVisited() const { return numVisited; }
+  //! Modify the number of visited combinations.
+  size_t& NumVisited() { return numVisited; }
+
+  //! Get the number of times a node combination was scored.
+  size_t NumScores() const { return numScores; }
+  //! Modify the number of times a node combination was scored.
+  size_t& NumScores() { return numScores; }
+
+  //! Get the number of times a base case was calculated.
+  size_t NumBaseCases() const { return numBaseCases; }
+  //! Modify the number of times a base case was calculated.
+  size_t& NumBaseCases() { return numBaseCases; }
+
+ private:
+  //! A pair of nodes waiting to be visited.
+  struct QueueFrame
+  {
+    //! The score of the pair.
+    double score;
+    //! The query node.
+    TreeType* queryNode;
+    //! The reference node.
+    TreeType* referenceNode;
+    //! The traversal information right after the pair was scored.
+    typename RuleType::TraversalInfoType traversalInfo;
+  };
+
+  //! Order the frames so that the lowest score is at the top of the queue.
+  struct QueueFrameCompare
+  {
+    bool operator()(const QueueFrame& a, const QueueFrame& b) const
+    {
+      return a.score > b.score;
+    }
+  };
+
+  /**
+   * Score the given pair of nodes, starting from the traversal information of
+   * its parent pair, and push it onto the queue if it is not pruned.
+   */
+  void ScoreAndPush(TreeType& queryNode,
+                    TreeType& referenceNode,
+                    const typename RuleType::TraversalInfoType& parentInfo);
+
+  //! Reference to the rules with which the trees will be traversed.
+  RuleType& rule;
+
+  //! The number of prunes.
+  size_t numPrunes;
+
+  //! The number of node combinations that have been visited during traversal.
+  size_t numVisited;
+
+  //! The number of times a node combination was scored.
+  size_t numScores;
+
+  //! The number of times a base case was calculated.
+  size_t numBaseCases;
+
+  //! The queue, held in the class so that it isn't continually reallocated.
+  std::priority_queue<QueueFrame, std::vector<QueueFrame>, QueueFrameCompare>
+      queue;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "best_first_dual_tree_traverser_impl.hpp"
+
+#endif
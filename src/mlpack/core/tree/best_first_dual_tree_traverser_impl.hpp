@@ -0,0 +1,112 @@
+/**
+ * @file core/tree/best_first_dual_tree_traverser_impl.hpp
+ *
+ * Implementation of the best-first dual-tree traverser.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_BEST_FIRST_DUAL_TREE_TRAVERSER_IMPL_HPP
+#define MLPACK_CORE_TREE_BEST_FIRST_DUAL_TREE_TRAVERSER_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "best_first_dual_tree_traverser.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template<typename TreeType, typename RuleType>
+BestFirstDualTreeTraverser<TreeType, RuleType>::BestFirstDualTreeTraverser(
+    RuleType& rule) :
+    rule(rule),
+    numPrunes(0),
+    numVisited(0),
+    numScores(0),
+    numBaseCases(0)
+{ /* Nothing to do. */ }
+
+template<typename TreeType, typename RuleType>
+void BestFirstDualTreeTraverser<TreeType, RuleType>::ScoreAndPush(
+    TreeType& queryNode,
+    TreeType& referenceNode,
+    const typename RuleType::TraversalInfoType& parentInfo)
+{
+  rule.TraversalInfo() = parentInfo;
+  const double score = rule.Score(queryNode, referenceNode);
+  ++numScores;
+
+  if (score == DBL_MAX)
+  {
+    ++numPrunes;
+    return;
+  }
+
+  QueueFrame frame;
+  frame.score = score;
+  frame.queryNode = &queryNode;
+  frame.referenceNode = &referenceNode;
+  frame.traversalInfo = rule.TraversalInfo();
+  queue.push(frame);
+}
+
+template<typename TreeType, typename RuleType>
+void BestFirstDualTreeTraverser<TreeType, RuleType>::Traverse(
+    TreeType& queryRoot,
+    TreeType& referenceRoot)
+{
+  ScoreAndPush(queryRoot, referenceRoot, rule.TraversalInfo());
+
+  while (!queue.empty())
+  {
+    const QueueFrame frame = queue.top();
+    queue.pop();
+
+    TreeType& queryNode = *frame.queryNode;
+    TreeType& referenceNode = *frame.referenceNode;
+    ++numVisited;
+
+    // The bounds may have improved since the pair was scored.
+    rule.TraversalInfo() = frame.traversalInfo;
+    if (rule.Rescore(queryNode, referenceNode, frame.score) == DBL_MAX)
+    {
+      ++numPrunes;
+      continue;
+    }
+
+    if (queryNode.IsLeaf() && referenceNode.IsLeaf())
+    {
+      // Loop through each of the points in each node.
+      for (size_t i = 0; i < queryNode.NumPoints(); ++i)
+        for (size_t j = 0; j < referenceNode.NumPoints(); ++j)
+          rule.BaseCase(queryNode.Point(i), referenceNode.Point(j));
+
+      numBaseCases += queryNode.NumPoints() * referenceNode.NumPoints();
+    }
+    else if (referenceNode.IsLeaf())
+    {
+      for (size_t i = 0; i < queryNode.NumChildren(); ++i)
+        ScoreAndPush(queryNode.Child(i), referenceNode, frame.traversalInfo);
+    }
+    else if (queryNode.IsLeaf())
+    {
+      for (size_t j = 0; j < referenceNode.NumChildren(); ++j)
+        ScoreAndPush(queryNode, referenceNode.Child(j), frame.traversalInfo);
+    }
+    else
+    {
+      for (size_t i = 0; i < queryNode.NumChildren(); ++i)
+        for (size_t j = 0; j < referenceNode.NumChildren(); ++j)
+        {
+          ScoreAndPush(queryNode.Child(i), referenceNode.Child(j),
+              frame.traversalInfo);
+        }
+    }
+  }
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,96 @@
+/**
+ * @file core/tree/best_first_single_tree_traverser.hpp
+ *
+ * A single-tree traverser that visits the reference nodes in order of their
+ * score (best first), using a priority queue, instead of depth-first.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_BEST_FIRST_SINGLE_TREE_TRAVERSER_HPP
+#define MLPACK_CORE_TREE_BEST_FIRST_SINGLE_TREE_TRAVERSER_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/tree/tree_traits.hpp>
+#include <queue>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * A single-tree traverser that keeps the reference nodes that have not been
+ * pruned in a priority queue, and always visits the one with the lowest score
+ * next, whatever its depth.  For searches like k-nearest-neighbor search, this
+ * finds good candidates sooner than a depth-first traversal, so the bounds
+ * tighten earlier and more nodes are pruned.  Each node is rescored with
+ * Rescore() when it is taken from the queue, since the bounds may have
+ * improved since it was scored.
+ *
+ * This works with any tree type whose points are only held by its leaves, and
+ * in which each point is held by only one leaf (so, not with cover trees or
+ * spill trees).
+ *
+ * @tparam TreeType Type of the tree to traverse.
+ * @tparam RuleType Type of the rules to traverse the tree with.
+ */
+template<typename TreeType, typename RuleType>
+class BestFirstSingleTreeTraverser
+{
+  static_assert(!TreeTraits<TreeType>::HasSelfChildren &&
+      !TreeTraits<TreeType>::HasDuplicatedPoints,
+      "BestFirstSingleTreeTraverser can't be used with trees where a point "
+      "can be held by more than one node");
+
+ public:
+  /**
+   * Instantiate the traverser with the given rule set.
+   */
+  BestFirstSingleTreeTraverser(RuleType& rule);
+
+  /**
+   * Traverse the tree with the given point.
+   *
+   * @param queryIndex The index of the point in the query set which is being
+   *     used as the query point.
+   * @param referenceNode The tree node to be traversed.
+   */
+  void Traverse(const size_t queryIndex, TreeType& referenceNode);
+
+  //! Get the number of prunes.
+  size_t NumPrunes() const { return numPrunes; }
+  //! Modify the number of prunes.
+  size_t& NumPrunes() { return numPrunes; }
+
+ private:
+  //! A node waiting to be visited, with its score.
+  typedef std::pair<double, TreeType*> QueueEntry;
+
+  //! Order the entries so that the lowest score is at the top of the queue.
+  struct QueueEntryCompare
+  {
+    bool operator()(const QueueEntry& a, const QueueEntry& b) const
+    {
+      return a.first > b.first;
+    }
+  };
+
+  //! Reference to the rules with which the tree will be traversed.
+  RuleType& rule;
+
+  //! The number of nodes which have been pruned during traversal.
+  size_t numPrunes;
+
+  //! The queue, held in the class so that it isn't continually reallocated.
+  std::priority_queue<QueueEntry, std::vector<QueueEntry>, QueueEntryCompare>
+      queue;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "best_first_single_tree_traverser_impl.hpp"
+
+#endif
@@ -0,0 +1,74 @@
+/**
+ * @file core/tree/best_first_single_tree_traverser_impl.hpp
+ *
+ * Implementation of the best-first single-tree traverser.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_BEST_FIRST_SINGLE_TREE_TRAVERSER_IMPL_HPP
+#define MLPACK_CORE_TREE_BEST_FIRST_SINGLE_TREE_TRAVERSER_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "best_first_single_tree_traverser.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template<typename TreeType, typename RuleType>
+BestFirstSingleTreeTraverser<TreeType, RuleType>::BestFirstSingleTreeTraverser(
+    RuleType& rule) :
+    rule(rule),
+    numPrunes(0)
+{ /* Nothing to do. */ }
+
+template<typename TreeType, typename RuleType>
+void BestFirstSingleTreeTraverser<TreeType, RuleType>::Traverse(
+    const size_t queryIndex,
+    TreeType& referenceNode)
+{
+  const double rootScore = rule.Score(queryIndex, referenceNode);
+  if (rootScore == DBL_MAX)
+  {
+    ++numPrunes;
+    return;
+  }
+
+  queue.push(QueueEntry(rootScore, &referenceNode));
+  while (!queue.empty())
+  {
+    const QueueEntry entry = queue.top();
+    queue.pop();
+    TreeType& node = *entry.second;
+
+    // The bounds may have improved since the node was scored.
+    if (rule.Rescore(queryIndex, node, entry.first) == DBL_MAX)
+    {
+      ++numPrunes;
+      continue;
+    }
+
+    if (node.IsLeaf())
+    {
+      for (size_t i = 0; i < node.NumPoints(); ++i)
+        rule.BaseCase(queryIndex, node.Point(i));
+      continue;
+    }
+
+    for (size_t i = 0; i < node.NumChildren(); ++i)
+    {
+      const double childScore = rule.Score(queryIndex, node.Child(i));
+      if (childScore == DBL_MAX)
+        ++numPrunes;
+      else
+        queue.push(QueueEntry(childScore, &node.Child(i)));
+    }
+  }
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -15,6 +15,11 @@
 
 #include "../statistic.hpp"
 #include "midpoint_split.hpp"
+#include "flat_file.hpp"
+#include "node_layout.hpp"
+#include "../node_arena.hpp"
+#include "../best_first_single_tree_traverser.hpp"
+#include "../best_first_dual_tree_traverser.hpp"
 
 namespace mlpack {
 namespace tree /** Trees and tree-building procedures. */ {
@@ -88,6 +93,32 @@ class BinarySpaceTree
   //! The dataset.  If we are the root of the tree, we own the dataset and must
   //! delete it.
   MatType* dataset;
+  //! If the tree was loaded with LoadFlat(), the root holds the region of
+  //! memory the file was mapped to, which holds the memory of the dataset.
+  char* mappedRegion = NULL;
+  //! The length of mappedRegion.
+  size_t mappedLength = 0;
+  //! If the tree was compacted with Compact(), the root holds the block of
+  //! memory that all the other nodes of the tree are stored in.
+  BinarySpaceTree* nodePool = NULL;
+  //! The number of nodes in nodePool.
+  size_t nodePoolSize = 0;
+  //! If the tree was built with an arena, the root holds the arena that all
+  //! the other nodes of the tree were created in.
+  NodeArena<BinarySpaceTree>* nodeArena = NULL;
+  //! Whether this node is stored in the node pool or the node arena of the
+  //! root.
+  bool pooled = false;
+
+  //! Trees with other types of statistics are converted from each other, so
+  //! they need access to each other's nodes.
+  template<typename OtherMetricType,
+           typename OtherStatisticType,
+           typename OtherMatType,
+           template<typename BoundMetricType, typename...> class OtherBoundType,
+           template<typename SplitBoundType, typename SplitMatType>
+               class OtherSplitType>
+  friend class BinarySpaceTree;
 
  public:
   //! A single-tree traverser for binary space trees; see
@@ -102,6 +133,18 @@ class BinarySpaceTree
   template<typename RuleType>
   class BreadthFirstDualTreeTraverser;
 
+  //! A single-tree traverser that visits the nodes in order of their score;
+  //! see best_first_single_tree_traverser.hpp.
+  template<typename RuleType>
+  using BestFirstSingleTreeTraverser =
+      tree::BestFirstSingleTreeTraverser<BinarySpaceTree, RuleType>;
+
+  //! A dual-tree traverser that visits the node combinations in order of their
+  //! score; see best_first_dual_tree_traverser.hpp.
+  template<typename RuleType>
+  using BestFirstDualTreeTraverser =
+      tree::BestFirstDualTreeTraverser<BinarySpaceTree, RuleType>;
+
   /**
    * Construct this as the root node of a binary space tree using the given
    * dataset.  This will copy the input matrix; if you don't want this, consider
@@ -109,8 +152,11 @@ class BinarySpaceTree
    *
    * @param data Dataset to create tree from.  This will be copied!
    * @param maxLeafSize Size of each leaf in the tree.
+   * @param useArena Whether to create the other nodes in a NodeArena held by
+   *     the root (see UsesArena()).
    */
-  BinarySpaceTree(const MatType& data, const size_t maxLeafSize = 20);
+  BinarySpaceTree(const MatType& data, const size_t maxLeafSize = 20,
+                  const bool useArena = false);
 
   /**
    * Construct this as the root node of a binary space tree using the given
@@ -123,10 +169,13 @@ class BinarySpaceTree
    * @param oldFromNew Vector which will be filled with the old positions for
    *     each new point.
    * @param maxLeafSize Size of each leaf in the tree.
+   * @param useArena Whether to create the other nodes in a NodeArena held by
+   *     the root (see UsesArena()).
    */
   BinarySpaceTree(const MatType& data,
                   std::vector<size_t>& oldFromNew,
-                  const size_t maxLeafSize = 20);
+                  const size_t maxLeafSize = 20,
+                  const bool useArena = false);
 
   /**
    * Construct this as the root node of a binary space tree using the given
@@ -142,11 +191,14 @@ class BinarySpaceTree
    * @param newFromOld Vector which will be filled with the new positions for
    *     each old point.
    * @param maxLeafSize Size of each leaf in the tree.
+   * @param useArena Whether to create the other nodes in a NodeArena held by
+   *     the root (see UsesArena()).
    */
   BinarySpaceTree(const MatType& data,
                   std::vector<size_t>& oldFromNew,
                   std::vector<size_t>& newFromOld,
-                  const size_t maxLeafSize = 20);
+                  const size_t maxLeafSize = 20,
+                  const bool useArena = false);
 
   /**
    * Construct this as the root node of a binary space tree using the given
@@ -156,9 +208,12 @@ class BinarySpaceTree
    *
    * @param data Dataset to create tree from.
    * @param maxLeafSize Size of each leaf in the tree.
+   * @param useArena Whether to create the other nodes in a NodeArena held by
+   *     the root (see UsesArena()).
    */
   BinarySpaceTree(MatType&& data,
-                  const size_t maxLeafSize = 20);
+                  const size_t maxLeafSize = 20,
+                  const bool useArena = false);
 
   /**
    * Construct this as the root node of a binary space tree using the given
@@ -171,10 +226,13 @@ class BinarySpaceTree
    * @param oldFromNew Vector which will be filled with the old positions for
    *     each new point.
    * @param maxLeafSize Size of each leaf in the tree.
+   * @param useArena Whether to create the other nodes in a NodeArena held by
+   *     the root (see UsesArena()).
    */
   BinarySpaceTree(MatType&& data,
                   std::vector<size_t>& oldFromNew,
-                  const size_t maxLeafSize = 20);
+                  const size_t maxLeafSize = 20,
+                  const bool useArena = false);
 
   /**
    * Construct this as the root node of a binary space tree using the given
@@ -190,11 +248,14 @@ class BinarySpaceTree
    * @param newFromOld Vector which will be filled with the new positions for
    *     each old point.
    * @param maxLeafSize Size of each leaf in the tree.
+   * @param useArena Whether to create the other nodes in a NodeArena held by
+   *     the root (see UsesArena()).
    */
   BinarySpaceTree(MatType&& data,
                   std::vector<size_t>& oldFromNew,
                   std::vector<size_t>& newFromOld,
-                  const size_t maxLeafSize = 20);
+                  const size_t maxLeafSize = 20,
+                  const bool useArena = false);
 
   /**
    * Construct this node as a child of the given parent, starting at column
@@ -284,6 +345,33 @@ class BinarySpaceTree
    */
   BinarySpaceTree(BinarySpaceTree&& other);
 
+  /**
+   * Create a binary space tree with the same nodes and dataset as a tree with
+   * another type of statistic, without building the tree again: only the
+   * statistics are computed.  The dataset keeps the order of the other tree,
+   * so the mappings of the other tree (oldFromNew and newFromOld) are still
+   * valid.  This is useful to run several tree-based methods (such as
+   * NeighborSearch and KDE) on the same reference tree.
+   *
+   * @param other Tree to take the nodes and dataset of.  The dataset is
+   *     copied.
+   */
+  template<typename OtherStatisticType>
+  explicit BinarySpaceTree(const BinarySpaceTree<MetricType,
+      OtherStatisticType, MatType, BoundType, SplitType>& other);
+
+  /**
+   * Create a binary space tree with the same nodes as a tree with another type
+   * of statistic, like the constructor above, but take ownership of the
+   * dataset of the other tree instead of copying it.  The other tree is left
+   * empty.  It must be the root of its tree.
+   *
+   * @param other Tree to take the nodes and dataset of.
+   */
+  template<typename OtherStatisticType>
+  explicit BinarySpaceTree(BinarySpaceTree<MetricType, OtherStatisticType,
+      MatType, BoundType, SplitType>&& other);
+
   /**
    * Copy the given BinarySaceTree.
    *
@@ -315,6 +403,71 @@ class BinarySpaceTree
    */
   ~BinarySpaceTree();
 
+  /**
+   * Save the tree to the given file in a flat, pointer-free binary layout (see
+   * flat_file.hpp): an array of nodes that refer to their children by index,
+   * followed by the oldFromNew mapping and the dataset.  A tree saved this way
+   * can be loaded with LoadFlat() without any deserialization.  This is only
+   * available for trees that use HRectBound or BallBound and a dense MatType.
+   * Statistics are not saved; they are rebuilt when the tree is loaded.  This
+   * must be called on the root of the tree.
+   *
+   * @param filename File to save the tree to.
+   * @param oldFromNew Mapping from new point indices to old point indices, as
+   *     filled by the tree constructor (this may be empty).
+   */
+  void SaveFlat(const std::string& filename,
+                const std::vector<size_t>& oldFromNew =
+                    std::vector<size_t>()) const;
+
+  /**
+   * Load a tree that was saved with SaveFlat().  The file is memory-mapped,
+   * copy-on-write, and the dataset of the tree points directly into the mapped
+   * region, so the dataset is neither read nor copied at load time and
+   * processes that load the same file share its pages in memory.  Only the
+   * nodes are allocated.  On platforms without mmap(), the file is read into
+   * memory instead.
+   *
+   * @param filename File to load the tree from.
+   * @param oldFromNew Vector to store the mapping from new point indices to old
+   *     point indices in (this will be empty if no mapping was saved).
+   * @return The root of the loaded tree; the caller must delete it.
+   */
+  static BinarySpaceTree* LoadFlat(const std::string& filename,
+                                   std::vector<size_t>& oldFromNew);
+
+  /**
+   * Move every node of the tree except the root into one contiguous block of
+   * memory, in the given layout, so that traversals that descend the tree
+   * touch fewer cache lines and pages than when each node is allocated
+   * separately.  The structure of the tree and the dataset are not changed,
+   * but any pointers or references to nodes other than the root are
+   * invalidated.  This must be called on the root of the tree, once the tree
+   * is built.
+   *
+   * @param layout Order to store the nodes in.
+   */
+  void Compact(const NodeLayout layout = VAN_EMDE_BOAS_LAYOUT);
+
+  //! Return whether the tree has been compacted with Compact().
+  bool IsCompact() const { return nodePool != NULL; }
+
+  //! Return whether the nodes of the tree are stored in a NodeArena, which
+  //! allocates them in a few large blocks and frees them all at once when the
+  //! root is destroyed.  Compact() moves the nodes out of the arena.
+  bool UsesArena() const { return nodeArena != NULL; }
+
+  /**
+   * Recompute the bounds of this node and its descendants, and the cached
+   * distances that depend on them, from the current points of the dataset,
+   * keeping the structure of the tree.  This can be used instead of building
+   * a new tree when the points were moved in place (through Dataset()) by a
+   * small amount; the tree stays valid, but it may be less tight than a new
+   * one.  The statistics are not recomputed.  The bound type must have a
+   * Clear() method (as HRectBound).
+   */
+  void RefitBounds();
+
   //! Return the bound object for this node.
   const BoundType<MetricType>& Bound() const { return bound; }
   //! Return the bound object for this node.
@@ -529,6 +682,64 @@ class BinarySpaceTree
                  const size_t maxLeafSize,
                  SplitType<BoundType<MetricType>, MatType>& splitter);
 
+  /**
+   * Build the children of this node, given the column that separates the points
+   * of the left child from the points of the right child.  If OpenMP tasks are
+   * available and the split type is deterministic (see SplitTraits), the left
+   * and right subtrees of large nodes are built in parallel.  The resulting
+   * tree is identical to the one built serially.
+   *
+   * @param splitCol First column that belongs to the right child.
+   * @param oldFromNew Vector holding permuted indices, or NULL if the indices
+   *     do not need to be tracked.
+   * @param maxLeafSize Maximum number of points held in a leaf.
+   * @param splitter Instantiated SplitType object.
+   */
+  void BuildChildren(const size_t splitCol,
+                     std::vector<size_t>* oldFromNew,
+                     const size_t maxLeafSize,
+                     SplitType<BoundType<MetricType>, MatType>& splitter);
+
+  /**
+   * Create this node as a child of the given parent, with the same bound and
+   * descendants as the given node of a tree with another type of statistic.
+   * This is used by the constructors that convert trees.
+   *
+   * @param parent Parent of this node.
+   * @param other Node to take the bound and descendants of.
+   */
+  template<typename OtherStatisticType>
+  BinarySpaceTree(BinarySpaceTree* parent,
+                  const BinarySpaceTree<MetricType, OtherStatisticType,
+                      MatType, BoundType, SplitType>& other);
+
+  /**
+   * Create and build a child of this node, in the arena of the root if the
+   * tree has one.
+   *
+   * @param childBegin Index of the first point of the child.
+   * @param childCount Number of points of the child.
+   * @param oldFromNew Vector holding permuted indices, or NULL if the indices
+   *     do not need to be tracked.
+   * @param maxLeafSize Maximum number of points held in a leaf.
+   * @param splitter Instantiated SplitType object.
+   */
+  BinarySpaceTree* NewChild(const size_t childBegin,
+                            const size_t childCount,
+                            std::vector<size_t>* oldFromNew,
+                            const size_t maxLeafSize,
+                            SplitType<BoundType<MetricType>, MatType>&
+                                splitter);
+
+  //! If the dataset is held in a region mapped by LoadFlat(), release that
+  //! region.  This must be called after the dataset is deleted.
+  void ReleaseMappedRegion();
+
+  //! Delete the children of this node, and the node pool and node arena if
+  //! this node holds them.  Nodes that are stored in the node pool or the node
+  //! arena are only destroyed with the pool or the arena.
+  void DeleteChildren();
+
   /**
    * Update the bound of the current node. This method does not take into
    * account bound-specific properties.
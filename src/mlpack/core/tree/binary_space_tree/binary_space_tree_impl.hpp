@@ -17,6 +17,12 @@
 #include <mlpack/core/util/cli.hpp>
 #include <mlpack/core/util/log.hpp>
 #include <queue>
+#include <stack>
+#include <unordered_map>
+
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
 
 namespace mlpack {
 namespace tree {
@@ -32,7 +38,8 @@ template<typename MetricType,
 BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
 BinarySpaceTree(
     const MatType& data,
-    const size_t maxLeafSize) :
+    const size_t maxLeafSize,
+    const bool useArena) :
     left(NULL),
     right(NULL),
     parent(NULL),
@@ -42,6 +49,10 @@ BinarySpaceTree(
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
     dataset(new MatType(data)) // Copies the dataset.
 {
+  // Create the arena that the other nodes will be stored in, if requested.
+  if (useArena)
+    nodeArena = new NodeArena<BinarySpaceTree>();
+
   // Do the actual splitting of this node.
   SplitType<BoundType<MetricType>, MatType> splitter;
   SplitNode(maxLeafSize, splitter);
@@ -60,7 +71,8 @@ BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
 BinarySpaceTree(
     const MatType& data,
     std::vector<size_t>& oldFromNew,
-    const size_t maxLeafSize) :
+    const size_t maxLeafSize,
+    const bool useArena) :
     left(NULL),
     right(NULL),
     parent(NULL),
@@ -75,6 +87,10 @@ BinarySpaceTree(
   for (size_t i = 0; i < data.n_cols; i++)
     oldFromNew[i] = i; // Fill with unharmed indices.
 
+  // Create the arena that the other nodes will be stored in, if requested.
+  if (useArena)
+    nodeArena = new NodeArena<BinarySpaceTree>();
+
   // Now do the actual splitting.
   SplitType<BoundType<MetricType>, MatType> splitter;
   SplitNode(oldFromNew, maxLeafSize, splitter);
@@ -94,7 +110,8 @@ BinarySpaceTree(
     const MatType& data,
     std::vector<size_t>& oldFromNew,
     std::vector<size_t>& newFromOld,
-    const size_t maxLeafSize) :
+    const size_t maxLeafSize,
+    const bool useArena) :
     left(NULL),
     right(NULL),
     parent(NULL),
@@ -109,6 +126,10 @@ BinarySpaceTree(
   for (size_t i = 0; i < data.n_cols; i++)
     oldFromNew[i] = i; // Fill with unharmed indices.
 
+  // Create the arena that the other nodes will be stored in, if requested.
+  if (useArena)
+    nodeArena = new NodeArena<BinarySpaceTree>();
+
   // Now do the actual splitting.
   SplitType<BoundType<MetricType>, MatType> splitter;
   SplitNode(oldFromNew, maxLeafSize, splitter);
@@ -129,7 +150,10 @@ template<typename MetricType,
          template<typename SplitBoundType, typename SplitMatType>
              class SplitType>
 BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
-BinarySpaceTree(MatType&& data, const size_t maxLeafSize) :
+BinarySpaceTree(
+    MatType&& data,
+    const size_t maxLeafSize,
+    const bool useArena) :
     left(NULL),
     right(NULL),
     parent(NULL),
@@ -139,6 +163,10 @@ BinarySpaceTree(MatType&& data, const size_t maxLeafSize) :
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
     dataset(new MatType(std::move(data)))
 {
+  // Create the arena that the other nodes will be stored in, if requested.
+  if (useArena)
+    nodeArena = new NodeArena<BinarySpaceTree>();
+
   // Do the actual splitting of this node.
   SplitType<BoundType<MetricType>, MatType> splitter;
   SplitNode(maxLeafSize, splitter);
@@ -157,7 +185,8 @@ BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
 BinarySpaceTree(
     MatType&& data,
     std::vector<size_t>& oldFromNew,
-    const size_t maxLeafSize) :
+    const size_t maxLeafSize,
+    const bool useArena) :
     left(NULL),
     right(NULL),
     parent(NULL),
@@ -172,6 +201,10 @@ BinarySpaceTree(
   for (size_t i = 0; i < dataset->n_cols; i++)
     oldFromNew[i] = i; // Fill with unharmed indices.
 
+  // Create the arena that the other nodes will be stored in, if requested.
+  if (useArena)
+    nodeArena = new NodeArena<BinarySpaceTree>();
+
   // Now do the actual splitting.
   SplitType<BoundType<MetricType>, MatType> splitter;
   SplitNode(oldFromNew, maxLeafSize, splitter);
@@ -191,7 +224,8 @@ BinarySpaceTree(
     MatType&& data,
     std::vector<size_t>& oldFromNew,
     std::vector<size_t>& newFromOld,
-    const size_t maxLeafSize) :
+    const size_t maxLeafSize,
+    const bool useArena) :
     left(NULL),
     right(NULL),
     parent(NULL),
@@ -206,6 +240,10 @@ BinarySpaceTree(
   for (size_t i = 0; i < dataset->n_cols; i++)
     oldFromNew[i] = i; // Fill with unharmed indices.
 
+  // Create the arena that the other nodes will be stored in, if requested.
+  if (useArena)
+    nodeArena = new NodeArena<BinarySpaceTree>();
+
   // Now do the actual splitting.
   SplitType<BoundType<MetricType>, MatType> splitter;
   SplitNode(oldFromNew, maxLeafSize, splitter);
@@ -399,8 +437,8 @@ operator=(const BinarySpaceTree& other)
 
   // Freeing memory that will not be used anymore.
   delete dataset;
-  delete left;
-  delete right;
+  ReleaseMappedRegion();
+  DeleteChildren();
 
   left = NULL;
   right = NULL;
@@ -471,8 +509,8 @@ operator=(BinarySpaceTree&& other)
 
   // Freeing memory that will not be used anymore.
   delete dataset;
-  delete left;
-  delete right;
+  ReleaseMappedRegion();
+  DeleteChildren();
 
   parent = other.Parent();
   left = other.Left();
@@ -485,6 +523,11 @@ operator=(BinarySpaceTree&& other)
   furthestDescendantDistance = other.FurthestDescendantDistance();
   minimumBoundDistance = other.MinimumBoundDistance();
   dataset = other.dataset;
+  mappedRegion = other.mappedRegion;
+  mappedLength = other.mappedLength;
+  nodePool = other.nodePool;
+  nodePoolSize = other.nodePoolSize;
+  nodeArena = other.nodeArena;
 
   other.left = NULL;
   other.right = NULL;
@@ -495,6 +538,11 @@ operator=(BinarySpaceTree&& other)
   other.furthestDescendantDistance = 0.0;
   other.minimumBoundDistance = 0.0;
   other.dataset = NULL;
+  other.mappedRegion = NULL;
+  other.mappedLength = 0;
+  other.nodePool = NULL;
+  other.nodePoolSize = 0;
+  other.nodeArena = NULL;
 
   return *this;
 }
@@ -521,7 +569,12 @@ BinarySpaceTree(BinarySpaceTree&& other) :
     parentDistance(other.parentDistance),
     furthestDescendantDistance(other.furthestDescendantDistance),
     minimumBoundDistance(other.minimumBoundDistance),
-    dataset(other.dataset)
+    dataset(other.dataset),
+    mappedRegion(other.mappedRegion),
+    mappedLength(other.mappedLength),
+    nodePool(other.nodePool),
+    nodePoolSize(other.nodePoolSize),
+    nodeArena(other.nodeArena)
 {
   // Now we are a clone of the other tree.  But we must also clear the other
   // tree's contents, so it doesn't delete anything when it is destructed.
@@ -534,6 +587,11 @@ BinarySpaceTree(BinarySpaceTree&& other) :
   other.furthestDescendantDistance = 0.0;
   other.minimumBoundDistance = 0.0;
   other.dataset = NULL;
+  other.mappedRegion = NULL;
+  other.mappedLength = 0;
+  other.nodePool = NULL;
+  other.nodePoolSize = 0;
+  other.nodeArena = NULL;
 
   // Set new parent.
   if (left)
@@ -542,6 +600,130 @@ BinarySpaceTree(BinarySpaceTree&& other) :
     right->parent = this;
 }
 
+/**
+ * Create a binary space tree with the nodes of a tree with another type of
+ * statistic, copying its dataset.
+ */
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+template<typename OtherStatisticType>
+BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+BinarySpaceTree(
+    const BinarySpaceTree<MetricType, OtherStatisticType, MatType, BoundType,
+        SplitType>& other) :
+    left(NULL),
+    right(NULL),
+    parent(NULL),
+    begin(other.begin),
+    count(other.count),
+    bound(other.bound),
+    parentDistance(other.parentDistance),
+    furthestDescendantDistance(other.furthestDescendantDistance),
+    minimumBoundDistance(other.minimumBoundDistance),
+    dataset(new MatType(*other.dataset))
+{
+  if (other.left)
+    left = new BinarySpaceTree(this, *other.left);
+  if (other.right)
+    right = new BinarySpaceTree(this, *other.right);
+
+  // The statistics of the children have been computed, so ours can be too.
+  stat = StatisticType(*this);
+}
+
+/**
+ * Create a binary space tree with the nodes of a tree with another type of
+ * statistic, taking ownership of its dataset.
+ */
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+template<typename OtherStatisticType>
+BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+BinarySpaceTree(
+    BinarySpaceTree<MetricType, OtherStatisticType, MatType, BoundType,
+        SplitType>&& other) :
+    left(NULL),
+    right(NULL),
+    parent(NULL),
+    begin(other.begin),
+    count(other.count),
+    bound(other.bound),
+    parentDistance(other.parentDistance),
+    furthestDescendantDistance(other.furthestDescendantDistance),
+    minimumBoundDistance(other.minimumBoundDistance),
+    dataset(other.dataset),
+    mappedRegion(other.mappedRegion),
+    mappedLength(other.mappedLength)
+{
+  if (other.parent != NULL)
+  {
+    throw std::invalid_argument("BinarySpaceTree: can only take the dataset "
+        "of the root of a tree");
+  }
+
+  if (other.left)
+    left = new BinarySpaceTree(this, *other.left);
+  if (other.right)
+    right = new BinarySpaceTree(this, *other.right);
+
+  // The statistics of the children have been computed, so ours can be too.
+  stat = StatisticType(*this);
+
+  // The dataset is ours now, so the other tree must not delete it.
+  other.DeleteChildren();
+  other.begin = 0;
+  other.count = 0;
+  other.parentDistance = 0.0;
+  other.furthestDescendantDistance = 0.0;
+  other.minimumBoundDistance = 0.0;
+  other.dataset = NULL;
+  other.mappedRegion = NULL;
+  other.mappedLength = 0;
+}
+
+/**
+ * Create a child node with the bound and descendants of a node of a tree with
+ * another type of statistic.
+ */
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+template<typename OtherStatisticType>
+BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+BinarySpaceTree(
+    BinarySpaceTree* parent,
+    const BinarySpaceTree<MetricType, OtherStatisticType, MatType, BoundType,
+        SplitType>& other) :
+    left(NULL),
+    right(NULL),
+    parent(parent),
+    begin(other.begin),
+    count(other.count),
+    bound(other.bound),
+    parentDistance(other.parentDistance),
+    furthestDescendantDistance(other.furthestDescendantDistance),
+    minimumBoundDistance(other.minimumBoundDistance),
+    dataset(parent->dataset)
+{
+  if (other.left)
+    left = new BinarySpaceTree(this, *other.left);
+  if (other.right)
+    right = new BinarySpaceTree(this, *other.right);
+
+  stat = StatisticType(*this);
+}
+
 /**
  * Initialize the tree from an archive.
  */
@@ -577,12 +759,433 @@ template<typename MetricType,
 BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
     ~BinarySpaceTree()
 {
-  delete left;
-  delete right;
+  DeleteChildren();
 
   // If we're the root, delete the matrix.
   if (!parent)
+  {
     delete dataset;
+    ReleaseMappedRegion();
+  }
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+    ReleaseMappedRegion()
+{
+  if (mappedRegion)
+  {
+    flat::UnmapFile(mappedRegion, mappedLength);
+    mappedRegion = NULL;
+    mappedLength = 0;
+  }
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+    DeleteChildren()
+{
+  // Nodes in the pool are destroyed below, by whichever node holds the pool.
+  if (left && !left->pooled)
+    delete left;
+  if (right && !right->pooled)
+    delete right;
+
+  left = NULL;
+  right = NULL;
+
+  if (nodePool)
+  {
+    for (size_t i = 0; i < nodePoolSize; ++i)
+      nodePool[i].~BinarySpaceTree();
+    ::operator delete(nodePool);
+
+    nodePool = NULL;
+    nodePoolSize = 0;
+  }
+
+  // This destroys all of the nodes of the arena, in the order they were
+  // created.
+  delete nodeArena;
+  nodeArena = NULL;
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+    Compact(const NodeLayout layout)
+{
+  if (parent != NULL)
+  {
+    throw std::invalid_argument("BinarySpaceTree::Compact(): can only be "
+        "called on the root of a tree");
+  }
+
+  // The root itself is never moved: it may live anywhere (e.g., on the stack or
+  // inside a NeighborSearch object), so it is skipped here.
+  std::vector<BinarySpaceTree*> order;
+  NodeLayoutOrder(*this, layout, order);
+
+  const size_t newPoolSize = order.size() - 1;
+  if (newPoolSize == 0)
+    return;
+
+  BinarySpaceTree* newPool = static_cast<BinarySpaceTree*>(
+      ::operator new(newPoolSize * sizeof(BinarySpaceTree)));
+
+  // Every node comes after its parent in the order, so by the time a node is
+  // moved, its parent is already in its final place and only needs its child
+  // pointer to be updated.  The move constructor takes care of pointing the
+  // children of the node back at its new location.
+  for (size_t i = 0; i < newPoolSize; ++i)
+  {
+    BinarySpaceTree* oldNode = order[i + 1];
+    BinarySpaceTree* oldParent = oldNode->parent;
+    BinarySpaceTree* newNode = new (newPool + i)
+        BinarySpaceTree(std::move(*oldNode));
+    newNode->pooled = true;
+
+    if (oldParent->left == oldNode)
+      oldParent->left = newNode;
+    else
+      oldParent->right = newNode;
+
+    if (oldNode->pooled)
+      oldNode->~BinarySpaceTree();
+    else
+      delete oldNode;
+  }
+
+  // If the tree was already compacted (or was built in an arena), all of the
+  // nodes in the old pool (or arena) have been destroyed, so only the memory is
+  // left to free.
+  if (nodePool)
+    ::operator delete(nodePool);
+  if (nodeArena)
+  {
+    nodeArena->Release();
+    delete nodeArena;
+    nodeArena = NULL;
+  }
+
+  nodePool = newPool;
+  nodePoolSize = newPoolSize;
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+    SaveFlat(const std::string& filename,
+             const std::vector<size_t>& oldFromNew) const
+{
+  if (parent != NULL)
+  {
+    throw std::invalid_argument("BinarySpaceTree::SaveFlat(): can only be "
+        "called on the root of a tree");
+  }
+
+  if (!oldFromNew.empty() && oldFromNew.size() != dataset->n_cols)
+  {
+    throw std::invalid_argument("BinarySpaceTree::SaveFlat(): size of "
+        "oldFromNew does not match the number of points in the tree");
+  }
+
+  std::ofstream out(filename, std::ios::binary);
+  if (!out.is_open())
+  {
+    throw std::runtime_error("BinarySpaceTree::SaveFlat(): cannot open '" +
+        filename + "' for writing");
+  }
+
+  // Number the nodes in depth-first order, so that the children of a node are
+  // always stored after it.
+  std::vector<const BinarySpaceTree*> nodes;
+  std::stack<const BinarySpaceTree*> stack;
+  stack.push(this);
+  while (!stack.empty())
+  {
+    const BinarySpaceTree* node = stack.top();
+    stack.pop();
+    nodes.push_back(node);
+
+    if (node->right)
+      stack.push(node->right);
+    if (node->left)
+      stack.push(node->left);
+  }
+
+  const size_t boundSize = flat::FlatBoundSize(bound, dataset->n_rows);
+
+  flat::FlatFileHeader header;
+  std::memcpy(header.magic, flat::FlatFileMagic, sizeof(header.magic));
+  header.elemSize = sizeof(ElemType);
+  header.nodeSize = sizeof(flat::FlatFileNode) + boundSize;
+  header.nRows = dataset->n_rows;
+  header.nCols = dataset->n_cols;
+  header.numNodes = nodes.size();
+  header.mappingSize = oldFromNew.size();
+
+  const size_t mappingOffset = sizeof(header) + nodes.size() * header.nodeSize;
+  const size_t mappingEnd = mappingOffset + sizeof(uint64_t) *
+      oldFromNew.size();
+  header.dataOffset = flat::FlatFileAlignment * ((mappingEnd +
+      flat::FlatFileAlignment - 1) / flat::FlatFileAlignment);
+
+  flat::WriteValue(out, header);
+
+  // Since the nodes are in depth-first order, the left child of a node (if
+  // any) comes right after it, and the right child comes after all of the
+  // descendants of the left child.  Using a map is simpler, though.
+  std::unordered_map<const BinarySpaceTree*, uint64_t> indices;
+  for (size_t i = 0; i < nodes.size(); ++i)
+    indices[nodes[i]] = i;
+
+  for (size_t i = 0; i < nodes.size(); ++i)
+  {
+    const BinarySpaceTree* node = nodes[i];
+
+    flat::FlatFileNode record;
+    record.begin = node->begin;
+    record.count = node->count;
+    record.left = node->left ? indices[node->left] : flat::FlatFileNoChild;
+    record.right = node->right ? indices[node->right] : flat::FlatFileNoChild;
+    record.parentDistance = node->parentDistance;
+    record.furthestDescendantDistance = node->furthestDescendantDistance;
+
+    flat::WriteValue(out, record);
+    flat::WriteFlatBound(out, node->bound);
+  }
+
+  for (size_t i = 0; i < oldFromNew.size(); ++i)
+    flat::WriteValue(out, (uint64_t) oldFromNew[i]);
+
+  for (size_t i = mappingEnd; i < header.dataOffset; ++i)
+    out.put(0);
+
+  out.write(reinterpret_cast<const char*>(dataset->memptr()),
+      sizeof(ElemType) * dataset->n_elem);
+
+  if (!out.good())
+  {
+    throw std::runtime_error("BinarySpaceTree::SaveFlat(): error writing to '"
+        + filename + "'");
+  }
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>*
+BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+    LoadFlat(const std::string& filename, std::vector<size_t>& oldFromNew)
+{
+  size_t length;
+  char* region = flat::MapFile(filename, length);
+
+  // Make sure the file is what we expect before we touch anything else: every
+  // size and index is checked, so that a truncated or corrupt file can't make
+  // us read or write out of bounds.
+  auto fail = [&](const std::string& reason)
+  {
+    flat::UnmapFile(region, length);
+    throw std::runtime_error("BinarySpaceTree::LoadFlat(): '" + filename +
+        "' " + reason);
+  };
+
+  flat::FlatFileHeader header;
+  if (length < sizeof(header))
+    fail("is too short to be a flat tree file");
+
+  std::memcpy(&header, region, sizeof(header));
+  if (std::memcmp(header.magic, flat::FlatFileMagic,
+      sizeof(header.magic)) != 0)
+    fail("is not a flat tree file");
+
+  // The node table holds one bound of nRows dimensions per node, so nRows is
+  // bounded by the length of the file once the node table is known to fit.
+  if (header.elemSize != sizeof(ElemType) || header.nRows > length ||
+      header.nodeSize != sizeof(flat::FlatFileNode) +
+          flat::FlatBoundSize(BoundType<MetricType>(), header.nRows))
+    fail("is not a flat tree file of this tree type");
+
+  uint64_t nodesEnd, mappingEnd, dataSize, dataEnd;
+  if (header.numNodes == 0 ||
+      !flat::CheckedMultiply(header.numNodes, header.nodeSize, nodesEnd) ||
+      !flat::CheckedAdd(nodesEnd, sizeof(header), nodesEnd) ||
+      !flat::CheckedMultiply(header.mappingSize, sizeof(uint64_t),
+          mappingEnd) ||
+      !flat::CheckedAdd(mappingEnd, nodesEnd, mappingEnd) ||
+      mappingEnd > header.dataOffset ||
+      header.dataOffset % flat::FlatFileAlignment != 0 ||
+      !flat::CheckedMultiply(header.nRows, header.nCols, dataSize) ||
+      !flat::CheckedMultiply(dataSize, sizeof(ElemType), dataSize) ||
+      !flat::CheckedAdd(header.dataOffset, dataSize, dataEnd) ||
+      dataEnd > length)
+    fail("is truncated or has a corrupt header");
+
+  if (header.mappingSize != 0 && header.mappingSize != header.nCols)
+    fail("has a mapping of the wrong size");
+
+  // Check the records of the nodes.  Children must be stored after their
+  // parents and have a single parent, so that the nodes form a tree.
+  std::vector<flat::FlatFileNode> records(header.numNodes);
+  std::vector<bool> isChild(header.numNodes, false);
+  const char* cursor = region + sizeof(header);
+  for (size_t i = 0; i < records.size(); ++i)
+  {
+    flat::FlatFileNode& record = records[i];
+    std::memcpy(&record, cursor, sizeof(record));
+    cursor += header.nodeSize;
+
+    if (record.begin > header.nCols ||
+        record.count > header.nCols - record.begin)
+      fail("has a node with points out of the dataset");
+
+    if ((record.left == flat::FlatFileNoChild) !=
+        (record.right == flat::FlatFileNoChild))
+      fail("has a node with only one child");
+
+    if (record.left == flat::FlatFileNoChild)
+      continue;
+
+    const uint64_t children[2] = { record.left, record.right };
+    for (size_t c = 0; c < 2; ++c)
+    {
+      if (children[c] <= i || children[c] >= header.numNodes ||
+          isChild[children[c]])
+        fail("has a node with an invalid child");
+      isChild[children[c]] = true;
+    }
+  }
+
+  for (size_t i = 1; i < records.size(); ++i)
+  {
+    if (!isChild[i])
+      fail("has a node that is not in the tree");
+  }
+
+  const char* mappingCursor = region + nodesEnd;
+  for (size_t i = 0; i < header.mappingSize; ++i)
+  {
+    uint64_t index;
+    flat::ReadValue(mappingCursor, index);
+    if (index >= header.nCols)
+      fail("has a mapping with an invalid index");
+  }
+
+  // The dataset uses the mapped memory directly.
+  MatType* dataset = new MatType(reinterpret_cast<ElemType*>(region +
+      header.dataOffset), header.nRows, header.nCols, false, true);
+
+  // Allocate all of the nodes first, so that children can be linked.
+  std::vector<BinarySpaceTree*> nodes(header.numNodes);
+  for (size_t i = 0; i < nodes.size(); ++i)
+    nodes[i] = new BinarySpaceTree();
+
+  cursor = region + sizeof(header);
+  for (size_t i = 0; i < nodes.size(); ++i)
+  {
+    BinarySpaceTree* node = nodes[i];
+    const flat::FlatFileNode& record = records[i];
+    cursor += sizeof(flat::FlatFileNode);
+
+    node->begin = record.begin;
+    node->count = record.count;
+    node->parentDistance = record.parentDistance;
+    node->furthestDescendantDistance = record.furthestDescendantDistance;
+    node->dataset = dataset;
+
+    if (record.left != flat::FlatFileNoChild)
+    {
+      node->left = nodes[record.left];
+      node->left->parent = node;
+      node->right = nodes[record.right];
+      node->right->parent = node;
+    }
+
+    node->bound = BoundType<MetricType>(header.nRows);
+    flat::ReadFlatBound(cursor, node->bound);
+    node->minimumBoundDistance = node->bound.MinWidth() / 2.0;
+  }
+
+  oldFromNew.resize(header.mappingSize);
+  for (size_t i = 0; i < oldFromNew.size(); ++i)
+  {
+    uint64_t index;
+    flat::ReadValue(cursor, index);
+    oldFromNew[i] = index;
+  }
+
+  // Children are stored after their parents, so building the statistics in
+  // reverse order means that the statistics of the children of a node are
+  // always built before the statistic of the node itself.
+  for (size_t i = nodes.size(); i > 0; --i)
+    nodes[i - 1]->stat = StatisticType(*nodes[i - 1]);
+
+  BinarySpaceTree* root = nodes[0];
+  root->mappedRegion = region;
+  root->mappedLength = length;
+
+  return root;
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+RefitBounds()
+{
+  // The bound of a leaf holds its points; the bound of any other node is the
+  // union of the bounds of its children.
+  bound.Clear();
+  if (!left)
+  {
+    UpdateBound(bound);
+  }
+  else
+  {
+    left->RefitBounds();
+    right->RefitBounds();
+    bound |= left->bound;
+    bound |= right->bound;
+  }
+
+  furthestDescendantDistance = 0.5 * bound.Diameter();
+
+  if (left)
+  {
+    arma::vec center, leftCenter, rightCenter;
+    Center(center);
+    left->Center(leftCenter);
+    right->Center(rightCenter);
+
+    left->parentDistance = bound.Metric().Evaluate(center, leftCenter);
+    right->parentDistance = bound.Metric().Evaluate(center, rightCenter);
+  }
 }
 
 template<typename MetricType,
@@ -905,10 +1508,7 @@ void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
 
   // Now that we know the split column, we will recursively split the children
   // by calling their constructors (which perform this splitting process).
-  left = new BinarySpaceTree(this, begin, splitCol - begin, splitter,
-      maxLeafSize);
-  right = new BinarySpaceTree(this, splitCol, begin + count - splitCol,
-      splitter, maxLeafSize);
+  BuildChildren(splitCol, NULL, maxLeafSize, splitter);
 
   // Calculate parent distances for those two nodes.
   arma::vec center, leftCenter, rightCenter;
@@ -973,10 +1573,7 @@ SplitNode(std::vector<size_t>& oldFromNew,
 
   // Now that we know the split column, we will recursively split the children
   // by calling their constructors (which perform this splitting process).
-  left = new BinarySpaceTree(this, begin, splitCol - begin, oldFromNew,
-      splitter, maxLeafSize);
-  right = new BinarySpaceTree(this, splitCol, begin + count - splitCol,
-      oldFromNew, splitter, maxLeafSize);
+  BuildChildren(splitCol, &oldFromNew, maxLeafSize, splitter);
 
   // Calculate parent distances for those two nodes.
   arma::vec center, leftCenter, rightCenter;
@@ -993,6 +1590,99 @@ SplitNode(std::vector<size_t>& oldFromNew,
   right->ParentDistance() = rightParentDistance;
 }
 
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+BuildChildren(const size_t splitCol,
+              std::vector<size_t>* oldFromNew,
+              const size_t maxLeafSize,
+              SplitType<BoundType<MetricType>, MatType>& splitter)
+{
+#if defined(HAS_OPENMP) && (_OPENMP >= 200805)
+  // Building the children of small nodes is too cheap to be worth a task.
+  // Nodes that use a HollowBallBound need their left sibling to be built before
+  // their own bound can be computed, so those trees are always built serially.
+  const size_t minParallelSize = 4096;
+  if (SplitTraits<Split>::IsDeterministic &&
+      !std::is_same<BoundType<MetricType>,
+                    bound::HollowBallBound<MetricType>>::value &&
+      count >= minParallelSize)
+  {
+    // omp_in_parallel() can't be used here: it stays false in an inactive
+    // region (one thread, or nested parallelism disabled), and every large
+    // node would open a new region.
+    if (omp_get_level() == 0)
+    {
+      // Start the threads that will build the rest of the tree.  The tasks are
+      // created by a single thread and picked up by all of the others.
+      #pragma omp parallel
+      {
+        #pragma omp single
+        BuildChildren(splitCol, oldFromNew, maxLeafSize, splitter);
+      }
+      return;
+    }
+
+    // The two children hold disjoint ranges of the dataset (and of oldFromNew),
+    // so they can be built at the same time.
+    #pragma omp task default(shared)
+    left = NewChild(begin, splitCol - begin, oldFromNew, maxLeafSize,
+        splitter);
+
+    right = NewChild(splitCol, begin + count - splitCol, oldFromNew,
+        maxLeafSize, splitter);
+
+    #pragma omp taskwait
+    return;
+  }
+#endif
+
+  left = NewChild(begin, splitCol - begin, oldFromNew, maxLeafSize, splitter);
+  right = NewChild(splitCol, begin + count - splitCol, oldFromNew, maxLeafSize,
+      splitter);
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>*
+BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+NewChild(const size_t childBegin,
+         const size_t childCount,
+         std::vector<size_t>* oldFromNew,
+         const size_t maxLeafSize,
+         SplitType<BoundType<MetricType>, MatType>& splitter)
+{
+  // Only the root holds the arena.
+  const BinarySpaceTree* root = this;
+  while (root->parent)
+    root = root->parent;
+
+  if (!root->nodeArena)
+  {
+    return (oldFromNew == NULL) ?
+        new BinarySpaceTree(this, childBegin, childCount, splitter,
+            maxLeafSize) :
+        new BinarySpaceTree(this, childBegin, childCount, *oldFromNew,
+            splitter, maxLeafSize);
+  }
+
+  BinarySpaceTree* child = (oldFromNew == NULL) ?
+      root->nodeArena->Create(this, childBegin, childCount, splitter,
+          maxLeafSize) :
+      root->nodeArena->Create(this, childBegin, childCount, *oldFromNew,
+          splitter, maxLeafSize);
+  child->pooled = true;
+  return child;
+}
+
 template<typename MetricType,
          typename StatisticType,
          typename MatType,
@@ -1071,12 +1761,12 @@ void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
   // If we're loading, and we have children, they need to be deleted.
   if (Archive::is_loading::value)
   {
-    if (left)
-      delete left;
-    if (right)
-      delete right;
+    DeleteChildren();
     if (!parent)
+    {
       delete dataset;
+      ReleaseMappedRegion();
+    }
 
     parent = NULL;
     left = NULL;
@@ -0,0 +1,274 @@
+/**
+ * @file core/tree/binary_space_tree/flat_file.hpp
+ *
+ * Helper types and functions for the flat, pointer-free file layout that
+ * BinarySpaceTree::SaveFlat() writes and BinarySpaceTree::LoadFlat() reads.
+ *
+ * The layout of a file is:
+ *
+ *  - a FlatFileHeader,
+ *  - one record for each node of the tree, in depth-first order: a
+ *    FlatFileNode followed by the bound of the node,
+ *  - the oldFromNew mapping (if any), as 64-bit unsigned integers,
+ *  - padding up to the next multiple of FlatFileAlignment bytes,
+ *  - the dataset, in column-major order.
+ *
+ * All values are stored in the native byte order of the machine that saved the
+ * file; the header holds enough information to detect a mismatch.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_BINARY_SPACE_TREE_FLAT_FILE_HPP
+#define MLPACK_CORE_TREE_BINARY_SPACE_TREE_FLAT_FILE_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/tree/hrectbound.hpp>
+#include <mlpack/core/tree/ballbound.hpp>
+
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+#ifndef _WIN32
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+namespace mlpack {
+namespace tree {
+namespace flat {
+
+//! The magic string at the start of every flat tree file.
+static const char FlatFileMagic[8] = { 'M', 'L', 'P', 'K', 'B', 'S', 'T', '1' };
+
+//! The dataset is stored at an offset that is a multiple of this.
+static const size_t FlatFileAlignment = 64;
+
+//! Marks a node that has no child.
+static const uint64_t FlatFileNoChild = uint64_t(-1);
+
+//! The header of a flat tree file.
+struct FlatFileHeader
+{
+  //! Must be equal to FlatFileMagic.
+  char magic[8];
+  //! Size of a dataset element, in bytes.
+  uint64_t elemSize;
+  //! Size of one node record (including its bound), in bytes.
+  uint64_t nodeSize;
+  //! Number of rows (dimensions) of the dataset.
+  uint64_t nRows;
+  //! Number of columns (points) of the dataset.
+  uint64_t nCols;
+  //! Number of nodes in the tree.
+  uint64_t numNodes;
+  //! Number of elements of the oldFromNew mapping (either 0 or nCols).
+  uint64_t mappingSize;
+  //! Offset of the dataset from the start of the file, in bytes.
+  uint64_t dataOffset;
+};
+
+//! The fixed-size part of the record of a node.
+struct FlatFileNode
+{
+  //! Index of the first point held by the node.
+  uint64_t begin;
+  //! Number of points held by the node.
+  uint64_t count;
+  //! Index of the left child, or FlatFileNoChild.
+  uint64_t left;
+  //! Index of the right child, or FlatFileNoChild.
+  uint64_t right;
+  //! Distance from the center of the node to the center of its parent.
+  double parentDistance;
+  //! Furthest descendant distance of the node.
+  double furthestDescendantDistance;
+};
+
+//! Set result to a * b; return false instead if the product overflows.
+inline bool CheckedMultiply(const uint64_t a,
+                            const uint64_t b,
+                            uint64_t& result)
+{
+  if (a != 0 && b > std::numeric_limits<uint64_t>::max() / a)
+    return false;
+
+  result = a * b;
+  return true;
+}
+
+//! Set result to a + b; return false instead if the sum overflows.
+inline bool CheckedAdd(const uint64_t a, const uint64_t b, uint64_t& result)
+{
+  if (b > std::numeric_limits<uint64_t>::max() - a)
+    return false;
+
+  result = a + b;
+  return true;
+}
+
+//! Write a single value to the given stream.
+template<typename T>
+inline void WriteValue(std::ostream& out, const T& value)
+{
+  out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+//! Read a single value from the given position in memory, and advance it.
+template<typename T>
+inline void ReadValue(const char*& cursor, T& value)
+{
+  std::memcpy(&value, cursor, sizeof(T));
+  cursor += sizeof(T);
+}
+
+//! Return the size of the record of an HRectBound with the given
+//! dimensionality.
+template<typename MetricType, typename ElemType>
+inline size_t FlatBoundSize(const bound::HRectBound<MetricType, ElemType>&,
+                            const size_t dim)
+{
+  return (2 * dim + 1) * sizeof(ElemType);
+}
+
+//! Write an HRectBound: the lower and upper bound of each dimension, then the
+//! minimum width.
+template<typename MetricType, typename ElemType>
+inline void WriteFlatBound(std::ostream& out,
+                           const bound::HRectBound<MetricType, ElemType>& b)
+{
+  for (size_t d = 0; d < b.Dim(); ++d)
+  {
+    WriteValue(out, b[d].Lo());
+    WriteValue(out, b[d].Hi());
+  }
+  WriteValue(out, b.MinWidth());
+}
+
+//! Read an HRectBound that has already been given the right dimensionality.
+template<typename MetricType, typename ElemType>
+inline void ReadFlatBound(const char*& cursor,
+                          bound::HRectBound<MetricType, ElemType>& b)
+{
+  for (size_t d = 0; d < b.Dim(); ++d)
+  {
+    ReadValue(cursor, b[d].Lo());
+    ReadValue(cursor, b[d].Hi());
+  }
+  ReadValue(cursor, b.MinWidth());
+}
+
+//! Return the size of the record of a BallBound with the given dimensionality.
+template<typename MetricType, typename VecType>
+inline size_t FlatBoundSize(const bound::BallBound<MetricType, VecType>&,
+                            const size_t dim)
+{
+  return (dim + 1) * sizeof(typename VecType::elem_type);
+}
+
+//! Write a BallBound: the center, then the radius.
+template<typename MetricType, typename VecType>
+inline void WriteFlatBound(std::ostream& out,
+                           const bound::BallBound<MetricType, VecType>& b)
+{
+  for (size_t d = 0; d < b.Dim(); ++d)
+    WriteValue(out, b.Center()[d]);
+  WriteValue(out, b.Radius());
+}
+
+//! Read a BallBound that has already been given the right dimensionality.
+template<typename MetricType, typename VecType>
+inline void ReadFlatBound(const char*& cursor,
+                          bound::BallBound<MetricType, VecType>& b)
+{
+  for (size_t d = 0; d < b.Dim(); ++d)
+    ReadValue(cursor, b.Center()[d]);
+  ReadValue(cursor, b.Radius());
+}
+
+/**
+ * Map the given file into memory, copy-on-write.  Pages of the file are shared
+ * between all processes that map it, until they are written to.  On platforms
+ * without mmap(), the file is read into memory instead.  The returned region
+ * must be released with UnmapFile().
+ *
+ * @param filename File to map.
+ * @param length Will be set to the length of the file.
+ * @return Start of the mapped region.
+ */
+inline char* MapFile(const std::string& filename, size_t& length)
+{
+#ifndef _WIN32
+  const int fd = open(filename.c_str(), O_RDONLY);
+  if (fd == -1)
+  {
+    throw std::runtime_error("cannot open flat tree file '" + filename +
+        "'");
+  }
+
+  struct stat fileStat;
+  if (fstat(fd, &fileStat) == -1)
+  {
+    close(fd);
+    throw std::runtime_error("cannot get the size of flat tree file '" +
+        filename + "'");
+  }
+
+  length = (size_t) fileStat.st_size;
+  void* region = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  close(fd);
+
+  if (region == MAP_FAILED)
+  {
+    throw std::runtime_error("cannot map flat tree file '" + filename + "'");
+  }
+
+  return static_cast<char*>(region);
+#else
+  std::ifstream in(filename, std::ios::binary | std::ios::ate);
+  if (!in.is_open())
+  {
+    throw std::runtime_error("cannot open flat tree file '" + filename +
+        "'");
+  }
+
+  length = (size_t) in.tellg();
+  in.seekg(0);
+
+  char* region = new char[length];
+  if (!in.read(region, length))
+  {
+    delete[] region;
+    throw std::runtime_error("cannot read flat tree file '" + filename + "'");
+  }
+
+  return region;
+#endif
+}
+
+/**
+ * Release a region returned by MapFile().
+ *
+ * @param region Start of the region.
+ * @param length Length of the region.
+ */
+inline void UnmapFile(char* region, const size_t length)
+{
+#ifndef _WIN32
+  munmap(region, length);
+#else
+  (void) length;
+  delete[] region;
+#endif
+}
+
+} // namespace flat
+} // namespace tree
+} // namespace mlpack
+
+#endif
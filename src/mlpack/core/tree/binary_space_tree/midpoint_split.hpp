@@ -17,6 +17,7 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/tree/perform_split.hpp>
+#include "split_traits.hpp"
 
 namespace mlpack {
 namespace tree /** Trees and tree-building procedures. */ {
@@ -117,6 +118,17 @@ class MidpointSplit
   }
 };
 
+/**
+ * The MidpointSplit only depends on the points held in the node being split, so
+ * different nodes can be split in parallel.
+ */
+template<typename BoundType, typename MatType>
+class SplitTraits<MidpointSplit<BoundType, MatType>>
+{
+ public:
+  static const bool IsDeterministic = true;
+};
+
 } // namespace tree
 } // namespace mlpack
 
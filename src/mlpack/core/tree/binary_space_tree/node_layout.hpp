@@ -0,0 +1,127 @@
+/**
+ * @file core/tree/binary_space_tree/node_layout.hpp
+ *
+ * Orderings in which the nodes of a tree can be stored in memory.  These are
+ * used by BinarySpaceTree::Compact() to place the nodes of a tree in one
+ * contiguous block, so that descending the tree touches fewer cache lines and
+ * pages.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_BINARY_SPACE_TREE_NODE_LAYOUT_HPP
+#define MLPACK_CORE_TREE_BINARY_SPACE_TREE_NODE_LAYOUT_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <queue>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The order in which the nodes of a tree are stored.  In every layout, a node
+ * is stored before all of its descendants.
+ */
+enum NodeLayout
+{
+  //! Nodes are stored level by level.  The first few levels of the tree, which
+  //! are visited by every traversal, are packed together.
+  BREADTH_FIRST_LAYOUT,
+  //! Nodes are stored in the van Emde Boas layout: the tree is cut at half of
+  //! its height, the top part is stored first, and then each of the bottom
+  //! subtrees is stored, each laid out recursively in the same way.  Any
+  //! root-to-leaf path of length h then touches only O(h / log B) blocks of
+  //! size B, whatever B is.
+  VAN_EMDE_BOAS_LAYOUT
+};
+
+//! Return the height of the tree rooted at the given node (a leaf has height
+//! 1).
+template<typename TreeType>
+size_t NodeLayoutHeight(const TreeType& node)
+{
+  size_t height = 0;
+  for (size_t i = 0; i < node.NumChildren(); ++i)
+    height = std::max(height, NodeLayoutHeight(node.Child(i)));
+
+  return height + 1;
+}
+
+//! Collect the descendants of the given node at the given depth below it.
+template<typename TreeType>
+void NodeLayoutLevel(TreeType& node,
+                     const size_t depth,
+                     std::vector<TreeType*>& nodes)
+{
+  if (depth == 0)
+  {
+    nodes.push_back(&node);
+    return;
+  }
+
+  for (size_t i = 0; i < node.NumChildren(); ++i)
+    NodeLayoutLevel(node.Child(i), depth - 1, nodes);
+}
+
+//! Append the nodes in the top `height` levels of the given subtree to the
+//! given vector, in van Emde Boas order.
+template<typename TreeType>
+void VanEmdeBoasOrder(TreeType& node,
+                      const size_t height,
+                      std::vector<TreeType*>& order)
+{
+  if (height == 1)
+  {
+    order.push_back(&node);
+    return;
+  }
+
+  const size_t topHeight = height / 2;
+  VanEmdeBoasOrder(node, topHeight, order);
+
+  std::vector<TreeType*> bottom;
+  NodeLayoutLevel(node, topHeight, bottom);
+  for (size_t i = 0; i < bottom.size(); ++i)
+    VanEmdeBoasOrder(*bottom[i], height - topHeight, order);
+}
+
+/**
+ * Compute the order in which the nodes of the given tree should be stored for
+ * the given layout.  The root is always the first node of the order.
+ *
+ * @param root Root of the tree.
+ * @param layout Layout to use.
+ * @param order Vector to store all the nodes of the tree in, in order.
+ */
+template<typename TreeType>
+void NodeLayoutOrder(TreeType& root,
+                     const NodeLayout layout,
+                     std::vector<TreeType*>& order)
+{
+  order.clear();
+
+  if (layout == VAN_EMDE_BOAS_LAYOUT)
+  {
+    VanEmdeBoasOrder(root, NodeLayoutHeight(root), order);
+    return;
+  }
+
+  std::queue<TreeType*> queue;
+  queue.push(&root);
+  while (!queue.empty())
+  {
+    TreeType* node = queue.front();
+    queue.pop();
+    order.push_back(node);
+
+    for (size_t i = 0; i < node->NumChildren(); ++i)
+      queue.push(&node->Child(i));
+  }
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -16,6 +16,7 @@
 
 // In case it hasn't been included yet.
 #include "single_tree_traverser.hpp"
+#include "../batch_base_case.hpp"
 
 #include <stack>
 
@@ -51,9 +52,8 @@ SingleTreeTraverser<RuleType>::Traverse(
   // If we are a leaf, run the base case as necessary.
   if (referenceNode.IsLeaf())
   {
-    const size_t refEnd = referenceNode.Begin() + referenceNode.Count();
-    for (size_t i = referenceNode.Begin(); i < refEnd; ++i)
-      rule.BaseCase(queryIndex, i);
+    BatchBaseCase(rule, queryIndex, referenceNode.Begin(),
+        referenceNode.Count());
   }
   else
   {
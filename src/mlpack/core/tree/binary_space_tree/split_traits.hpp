@@ -0,0 +1,42 @@
+/**
+ * @file core/tree/binary_space_tree/split_traits.hpp
+ *
+ * This file defines the SplitTraits class, which holds information about the
+ * split types that can be used with the BinarySpaceTree.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_BINARY_SPACE_TREE_SPLIT_TRAITS_HPP
+#define MLPACK_CORE_TREE_BINARY_SPACE_TREE_SPLIT_TRAITS_HPP
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The SplitTraits class provides compile-time information on the behavior of a
+ * given split type.  By default the traits are conservative; a split type
+ * should specialize this class if it can offer stronger guarantees.
+ *
+ * @tparam SplitType The split type to get information about.
+ */
+template<typename SplitType>
+class SplitTraits
+{
+ public:
+  /**
+   * This is true if the split of a node depends only on the points held in
+   * that node: the splitter holds no state between calls and does not use
+   * random numbers.  In that case, different nodes of a tree may be split at
+   * the same time by different threads, and the resulting tree is identical to
+   * the one built serially.
+   */
+  static const bool IsDeterministic = false;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -14,6 +14,10 @@
 
 #include <boost/math/distributions/normal.hpp>
 
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
 namespace mlpack {
 namespace tree {
 
@@ -30,7 +34,8 @@ CosineTree::CosineTree(const arma::mat& dataset) :
   l2NormsSquared.zeros(numColumns);
 
   // Set indices and calculate squared norms of the columns.
-  for (size_t i = 0; i < numColumns; i++)
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) numColumns; i++)
   {
     indices[i] = i;
     double l2Norm = arma::norm(dataset.col(i), 2);
@@ -372,28 +377,44 @@ void CosineTree::ModifiedGramSchmidt(CosineNodeQueue& treeQueue,
                                      arma::vec& newBasisVector,
                                      arma::vec* addBasisVector)
 {
-  // Set new basis vector to centroid.
-  newBasisVector = centroid;
-
-  // Variables for iterating throught the priority queue.
-  CosineTree *currentNode;
+  // Collect the vectors of the current basis, and the additional basis vector
+  // if it is passed.
+  std::vector<const arma::vec*> basisVectors;
+  basisVectors.reserve(treeQueue.size() + 1);
   CosineNodeQueue::const_iterator i = treeQueue.begin();
-
-  // For every vector in the current basis, remove its projection from the
-  // centroid.
   for ( ; i != treeQueue.end(); i++)
-  {
-    currentNode = *i;
+    basisVectors.push_back(&(*i)->BasisVector());
+  if (addBasisVector)
+    basisVectors.push_back(addBasisVector);
 
-    double projection = arma::dot(currentNode->BasisVector(), centroid);
-    newBasisVector -= projection * currentNode->BasisVector();
-  }
+  // The projections are all taken with respect to the centroid, so they are
+  // independent of each other.
+  arma::vec projections(basisVectors.size());
+  #pragma omp parallel for
+  for (omp_size_t k = 0; k < (omp_size_t) basisVectors.size(); ++k)
+    projections[k] = arma::dot(*basisVectors[k], centroid);
 
-  // If additional basis vector is passed, take it into account.
-  if (addBasisVector)
+  // For every vector in the basis, remove its projection from the centroid.
+  // Each thread handles a block of the elements of the new basis vector.
+  newBasisVector = centroid;
+  #pragma omp parallel
   {
-    double projection = arma::dot(*addBasisVector, centroid);
-    newBasisVector -= *addBasisVector * projection;
+    size_t begin = 0, end = newBasisVector.n_elem;
+    #ifdef HAS_OPENMP
+    const size_t numThreads = omp_get_num_threads();
+    const size_t thread = omp_get_thread_num();
+    const size_t blockSize = (newBasisVector.n_elem + numThreads - 1) /
+        numThreads;
+    begin = std::min(thread * blockSize, (size_t) newBasisVector.n_elem);
+    end = std::min(begin + blockSize, (size_t) newBasisVector.n_elem);
+    #endif
+
+    for (size_t k = 0; k < basisVectors.size(); ++k)
+    {
+      const double* basis = basisVectors[k]->memptr();
+      for (size_t r = begin; r < end; ++r)
+        newBasisVector[r] -= projections[k] * basis[r];
+    }
   }
 
   // Normalize the modified centroid vector.
@@ -429,24 +450,28 @@ double CosineTree::MonteCarloError(CosineTree* node,
   else
     projectionSize = treeQueue.size();
 
+  // Collect the vectors of the current basis, so that the samples can be
+  // processed in parallel.
+  std::vector<const arma::vec*> basisVectors;
+  basisVectors.reserve(treeQueue.size());
+  CosineNodeQueue::const_iterator j = treeQueue.begin();
+  for ( ; j != treeQueue.end(); j++)
+    basisVectors.push_back(&(*j)->BasisVector());
+
   // For each sample, calculate the weighted projection onto the current basis.
-  for (size_t i = 0; i < numSamples; i++)
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) numSamples; i++)
   {
     // Initialize projection as a vector of zeros.
     arma::vec projection;
     projection.zeros(projectionSize);
 
-    CosineTree *currentNode;
-    CosineNodeQueue::const_iterator j = treeQueue.begin();
-
     size_t k = 0;
     // Compute the projection of the sampled vector onto the existing subspace.
-    for ( ; j != treeQueue.end(); j++, k++)
+    for ( ; k < basisVectors.size(); k++)
     {
-      currentNode = *j;
-
       projection(k) = arma::dot(dataset.col(sampledIndices[i]),
-                                currentNode->BasisVector());
+                                *basisVectors[k]);
     }
     // If two additional vectors are passed, take their projections.
     if (addBasisVector1 && addBasisVector2)
@@ -633,19 +658,27 @@ void CosineTree::CalculateCosines(arma::vec& cosines)
   // Initialize cosine vector as a vector of zeros.
   cosines.zeros(numColumns);
 
-  for (size_t i = 0; i < numColumns; i++)
+  // The norms of the columns are already known, so only the dot products have
+  // to be computed.
+  const arma::vec splitColumn(const_cast<double*>(
+      dataset->colptr(indices[splitPointIndex])), dataset->n_rows, false,
+      true);
+  const double splitNorm = std::sqrt(l2NormsSquared(splitPointIndex));
+
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) numColumns; i++)
   {
     // If norm is zero, store cosine value as zero. Else, calculate cosine value
     // between two vectors.
-    if (l2NormsSquared(i) == 0)
+    if (l2NormsSquared(i) == 0 || splitNorm == 0)
     {
       cosines(i) = 0;
     }
     else
     {
-      cosines(i) =
-          std::abs(arma::norm_dot(dataset->col(indices[splitPointIndex]),
-                                  dataset->col(indices[i])));
+      cosines(i) = std::abs(arma::dot(splitColumn,
+          dataset->col(indices[i]))) / (splitNorm *
+          std::sqrt(l2NormsSquared(i)));
     }
   }
 }
@@ -655,10 +688,18 @@ void CosineTree::CalculateCentroid()
   // Initialize centroid as vector of zeros.
   centroid.zeros(dataset->n_rows);
 
-  // Calculate centroid of columns in the node.
-  for (size_t i = 0; i < numColumns; i++)
+  // Calculate centroid of columns in the node.  Each thread sums its own
+  // columns, and the sums are merged at the end.
+  #pragma omp parallel
   {
-    centroid += dataset->col(indices[i]);
+    arma::vec threadSum(dataset->n_rows, arma::fill::zeros);
+
+    #pragma omp for
+    for (omp_size_t i = 0; i < (omp_size_t) numColumns; i++)
+      threadSum += dataset->col(indices[i]);
+
+    #pragma omp critical
+    centroid += threadSum;
   }
   centroid /= numColumns;
 }
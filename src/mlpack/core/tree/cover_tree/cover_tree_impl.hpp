@@ -15,11 +15,60 @@
 // In case it hasn't already been included.
 #include "cover_tree.hpp"
 
+#include <mlpack/core/metrics/lmetric.hpp>
 #include <queue>
 #include <string>
 
 namespace mlpack {
 namespace tree {
+namespace details {
+
+/**
+ * Compute the distances between the given point and the points with the given
+ * indices in [begin, end), with one call to Evaluate() per point.
+ */
+template<typename MetricType, typename MatType>
+void CoverTreeDistances(MetricType& metric,
+                        const MatType& dataset,
+                        const size_t pointIndex,
+                        const arma::Col<size_t>& indices,
+                        arma::vec& distances,
+                        const size_t begin,
+                        const size_t end)
+{
+  for (size_t i = begin; i < end; ++i)
+    distances[i] = metric.Evaluate(dataset.col(pointIndex),
+        dataset.col(indices[i]));
+}
+
+/**
+ * Compute the distances between the given point and the points with the given
+ * indices in [begin, end) for an LMetric on dense data: the points are gathered
+ * into a contiguous block, so that LMetric::BatchEvaluate() can compute all the
+ * distances with vectorized whole-matrix operations.
+ */
+template<int Power, bool TakeRoot, typename eT>
+void CoverTreeDistances(metric::LMetric<Power, TakeRoot>& /* metric */,
+                        const arma::Mat<eT>& dataset,
+                        const size_t pointIndex,
+                        const arma::Col<size_t>& indices,
+                        arma::vec& distances,
+                        const size_t begin,
+                        const size_t end)
+{
+  if (begin == end)
+    return;
+
+  const arma::Mat<eT> block = dataset.cols(arma::conv_to<arma::uvec>::from(
+      indices.subvec(begin, end - 1)));
+  arma::Col<eT> blockDistances;
+  metric::LMetric<Power, TakeRoot>::BatchEvaluate(dataset.col(pointIndex),
+      block, blockDistances);
+  distances.subvec(begin, end - 1) =
+      arma::conv_to<arma::vec>::from(blockDistances);
+}
+
+} // namespace details
 
 // Build the statistics, bottom-up.
 template<typename TreeType, typename StatisticType>
@@ -1392,12 +1441,19 @@ void CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::
                      const size_t pointSetSize)
 {
   // For each point, rebuild the distances.  The indices do not need to be
-  // modified.
+  // modified.  The points are split into fixed blocks, so the distances do not
+  // depend on the number of threads, and the blocks are computed in parallel
+  // when there are enough of them to be worth it.
   distanceComps += pointSetSize;
-  for (size_t i = 0; i < pointSetSize; ++i)
+  const size_t blockSize = 1024;
+  const size_t numBlocks = (pointSetSize + blockSize - 1) / blockSize;
+  #pragma omp parallel for if(numBlocks >= 4)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
   {
-    distances[i] = metric->Evaluate(dataset->col(pointIndex),
-        dataset->col(indices[i]));
+    const size_t begin = b * blockSize;
+    const size_t end = std::min(begin + blockSize, pointSetSize);
+    details::CoverTreeDistances(*metric, *dataset, pointIndex, indices,
+        distances, begin, end);
   }
 }
 
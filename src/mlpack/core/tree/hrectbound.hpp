@@ -17,6 +17,7 @@
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/math/range.hpp>
 #include <mlpack/core/metrics/lmetric.hpp>
+#include <mlpack/core/metrics/fixed_dim_lmetric.hpp>
 #include "bound_traits.hpp"
 
 namespace mlpack {
@@ -39,6 +40,29 @@ struct IsLMetric<metric::LMetric<Power, TakeRoot>>
   static const bool Value = true;
 };
 
+//! Specialization for IsLMetric when the argument is of type FixedDimLMetric.
+template<size_t Dim, int Power, bool TakeRoot>
+struct IsLMetric<metric::FixedDimLMetric<Dim, Power, TakeRoot>>
+{
+  static const bool Value = true;
+};
+
+//! Utility struct where Value is the number of dimensions of the points of the
+//! metric if it is known at compile time, and 0 otherwise.
+template<typename MetricType>
+struct FixedDimensionality
+{
+  static const size_t Value = 0;
+};
+
+//! Specialization for FixedDimensionality when the argument is of type
+//! FixedDimLMetric.
+template<size_t Dim, int Power, bool TakeRoot>
+struct FixedDimensionality<metric::FixedDimLMetric<Dim, Power, TakeRoot>>
+{
+  static const size_t Value = Dim;
+};
+
 } // namespace meta
 
 /**
@@ -46,7 +70,12 @@ struct IsLMetric<metric::LMetric<Power, TakeRoot>>
  * with the LMetric class.  Be sure to use the same template parameters for
  * LMetric as you do for HRectBound -- otherwise odd results may occur.
  *
- * @tparam MetricType Type of metric to use; must be of type LMetric.
+ * If the metric is a FixedDimLMetric, the bound must have the dimensionality of
+ * the metric, and the distance computations loop over a fixed number of
+ * dimensions, so that the compiler can unroll them.
+ *
+ * @tparam MetricType Type of metric to use; must be of type LMetric (or
+ *     FixedDimLMetric).
  * @tparam ElemType Element type (double/float/int/etc.).
  */
 template<typename MetricType = metric::LMetric<2, true>,
@@ -232,6 +261,14 @@ class HRectBound
   void serialize(Archive& ar, const unsigned int version);
 
  private:
+  //! Get the number of dimensions the distance computations loop over; this
+  //! is a compile-time constant if the metric has a fixed dimensionality.
+  size_t LoopDim() const
+  {
+    return (meta::FixedDimensionality<MetricType>::Value == 0) ? dim :
+        meta::FixedDimensionality<MetricType>::Value;
+  }
+
   //! The dimensionality of the bound.
   size_t dim;
   //! The bounds for each dimension.
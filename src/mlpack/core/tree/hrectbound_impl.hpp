@@ -39,7 +39,18 @@ inline HRectBound<MetricType, ElemType>::HRectBound(const size_t dimension) :
     dim(dimension),
     bounds(new math::RangeType<ElemType>[dim]),
     minWidth(0)
-{ /* Nothing to do. */ }
+{
+  const size_t fixedDim = meta::FixedDimensionality<MetricType>::Value;
+  if (fixedDim != 0 && dim != fixedDim)
+  {
+    delete[] bounds;
+    std::ostringstream oss;
+    oss << "HRectBound::HRectBound(): the metric is for points with "
+        << fixedDim << " dimensions, but the bound has " << dim
+        << " dimensions!";
+    throw std::invalid_argument(oss.str());
+  }
+}
 
 /**
  * Copy constructor necessary to prevent memory leaks.
@@ -171,11 +182,14 @@ inline ElemType HRectBound<MetricType, ElemType>::MinDistance(
 
   ElemType sum = 0;
 
-  ElemType lower, higher;
-  for (size_t d = 0; d < dim; d++)
+  // The loop has no branches (the ones on the power are resolved at compile
+  // time), so it can be vectorized.
+  const size_t loopDim = LoopDim();
+  #pragma omp simd reduction(+:sum)
+  for (size_t d = 0; d < loopDim; d++)
   {
-    lower = bounds[d].Lo() - point[d];
-    higher = point[d] - bounds[d].Hi();
+    const ElemType lower = bounds[d].Lo() - point[d];
+    const ElemType higher = point[d] - bounds[d].Hi();
 
     // Since only one of 'lower' or 'higher' is negative, if we add each's
     // absolute value to itself and then sum those two, our result is the
@@ -230,11 +244,12 @@ ElemType HRectBound<MetricType, ElemType>::MinDistance(const HRectBound& other)
   const math::RangeType<ElemType>* mbound = bounds;
   const math::RangeType<ElemType>* obound = other.bounds;
 
-  ElemType lower, higher;
-  for (size_t d = 0; d < dim; d++)
+  const size_t loopDim = LoopDim();
+  #pragma omp simd reduction(+:sum)
+  for (size_t d = 0; d < loopDim; d++)
   {
-    lower = obound->Lo() - mbound->Hi();
-    higher = mbound->Lo() - obound->Hi();
+    const ElemType lower = obound[d].Lo() - mbound[d].Hi();
+    const ElemType higher = mbound[d].Lo() - obound[d].Hi();
     // We invoke the following:
     //   x + fabs(x) = max(x * 2, 0)
     //   (x * 2)^2 / 4 = x^2
@@ -252,10 +267,6 @@ ElemType HRectBound<MetricType, ElemType>::MinDistance(const HRectBound& other)
       sum += pow((lower + fabs(lower)) + (higher + fabs(higher)),
           (ElemType) MetricType::Power);
     }
-
-    // Move bound pointers.
-    mbound++;
-    obound++;
   }
 
   // The compiler should optimize out this if statement entirely.
@@ -291,10 +302,12 @@ inline ElemType HRectBound<MetricType, ElemType>::MaxDistance(
 
   Log::Assert(point.n_elem == dim);
 
-  for (size_t d = 0; d < dim; d++)
+  const size_t loopDim = LoopDim();
+  #pragma omp simd reduction(+:sum)
+  for (size_t d = 0; d < loopDim; d++)
   {
-    ElemType v = std::max(fabs(point[d] - bounds[d].Lo()),
-        fabs(bounds[d].Hi() - point[d]));
+    const ElemType v = std::max(std::fabs(point[d] - bounds[d].Lo()),
+        std::fabs(bounds[d].Hi() - point[d]));
 
     // The compiler should optimize out this if statement entirely.
     if (MetricType::Power == 1)
@@ -331,11 +344,12 @@ inline ElemType HRectBound<MetricType, ElemType>::MaxDistance(
 
   Log::Assert(dim == other.dim);
 
-  ElemType v;
-  for (size_t d = 0; d < dim; d++)
+  const size_t loopDim = LoopDim();
+  #pragma omp simd reduction(+:sum)
+  for (size_t d = 0; d < loopDim; d++)
   {
-    v = std::max(fabs(other.bounds[d].Hi() - bounds[d].Lo()),
-        fabs(bounds[d].Hi() - other.bounds[d].Lo()));
+    const ElemType v = std::max(std::fabs(other.bounds[d].Hi() -
+        bounds[d].Lo()), std::fabs(bounds[d].Hi() - other.bounds[d].Lo()));
 
     // The compiler should optimize out this if statement entirely.
     if (MetricType::Power == 1)
@@ -373,22 +387,18 @@ HRectBound<MetricType, ElemType>::RangeDistance(
 
   Log::Assert(dim == other.dim);
 
-  ElemType v1, v2, vLo, vHi;
-  for (size_t d = 0; d < dim; d++)
+  // The minimum and maximum distances are computed in the same pass, without
+  // branches, so that the loop can be vectorized.
+  const size_t loopDim = LoopDim();
+  #pragma omp simd reduction(+:loSum, hiSum)
+  for (size_t d = 0; d < loopDim; d++)
   {
-    v1 = other.bounds[d].Lo() - bounds[d].Hi();
-    v2 = bounds[d].Lo() - other.bounds[d].Hi();
-    // One of v1 or v2 is negative.
-    if (v1 >= v2)
-    {
-      vHi = -v2; // Make it nonnegative.
-      vLo = (v1 > 0) ? v1 : 0; // Force to be 0 if negative.
-    }
-    else
-    {
-      vHi = -v1; // Make it nonnegative.
-      vLo = (v2 > 0) ? v2 : 0; // Force to be 0 if negative.
-    }
+    const ElemType v1 = other.bounds[d].Lo() - bounds[d].Hi();
+    const ElemType v2 = bounds[d].Lo() - other.bounds[d].Hi();
+    // One of v1 or v2 is negative; the larger one (if positive) is the gap
+    // between the bounds, and the negated smaller one is their extent.
+    const ElemType vLo = std::max(std::max(v1, v2), (ElemType) 0);
+    const ElemType vHi = -std::min(v1, v2);
 
     // The compiler should optimize out this if statement entirely.
     if (MetricType::Power == 1)
@@ -441,30 +451,16 @@ HRectBound<MetricType, ElemType>::RangeDistance(
 
   Log::Assert(point.n_elem == dim);
 
-  ElemType v1, v2, vLo, vHi;
-  for (size_t d = 0; d < dim; d++)
+  const size_t loopDim = LoopDim();
+  #pragma omp simd reduction(+:loSum, hiSum)
+  for (size_t d = 0; d < loopDim; d++)
   {
-    v1 = bounds[d].Lo() - point[d]; // Negative if point[d] > lo.
-    v2 = point[d] - bounds[d].Hi(); // Negative if point[d] < hi.
-    // One of v1 or v2 (or both) is negative.
-    if (v1 >= 0) // point[d] <= bounds_[d].Lo().
-    {
-      vHi = -v2; // v2 will be larger but must be negated.
-      vLo = v1;
-    }
-    else // point[d] is between lo and hi, or greater than hi.
-    {
-      if (v2 >= 0)
-      {
-        vHi = -v1; // v1 will be larger, but must be negated.
-        vLo = v2;
-      }
-      else
-      {
-        vHi = -std::min(v1, v2); // Both are negative, but we need the larger.
-        vLo = 0;
-      }
-    }
+    const ElemType v1 = bounds[d].Lo() - point[d]; // Negative if point[d] > lo.
+    const ElemType v2 = point[d] - bounds[d].Hi(); // Negative if point[d] < hi.
+    // At most one of v1 or v2 is positive, and that is the distance to the
+    // bound; the distance to the far side is the negated smaller one.
+    const ElemType vLo = std::max(std::max(v1, v2), (ElemType) 0);
+    const ElemType vHi = -std::min(v1, v2);
 
     // The compiler should optimize out this if statement entirely.
     if (MetricType::Power == 1)
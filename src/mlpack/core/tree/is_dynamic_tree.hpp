@@ -0,0 +1,41 @@
+/**
+ * @file core/tree/is_dynamic_tree.hpp
+ *
+ * Definition of IsDynamicTree, which tells whether points can be inserted into
+ * and deleted from a tree after it has been built.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_IS_DYNAMIC_TREE_HPP
+#define MLPACK_CORE_TREE_IS_DYNAMIC_TREE_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/sfinae_utility.hpp>
+
+namespace mlpack {
+namespace tree /** Trees and tree-building procedures. */ {
+
+HAS_MEM_FUNC(InsertPoint, HasInsertPointCheck);
+HAS_MEM_FUNC(DeletePoint, HasDeletePointCheck);
+
+/**
+ * 'value' is true if the TreeType class has the members
+ * void InsertPoint(const size_t point) and bool DeletePoint(const size_t point),
+ * which insert a column of the dataset into the tree and remove it from the
+ * tree (like RectangleTree).
+ */
+template<typename TreeType>
+struct IsDynamicTree
+{
+  static const bool value =
+      HasInsertPointCheck<TreeType, void(TreeType::*)(const size_t)>::value &&
+      HasDeletePointCheck<TreeType, bool(TreeType::*)(const size_t)>::value;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,151 @@
+/**
+ * @file core/tree/node_arena.hpp
+ *
+ * Definition of the NodeArena class, which allocates the nodes of a tree in a
+ * few large blocks of memory.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_NODE_ARENA_HPP
+#define MLPACK_CORE_TREE_NODE_ARENA_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * An arena that creates objects of one type (usually the nodes of a tree) in a
+ * few large blocks of memory, instead of allocating each of them separately.
+ * Each block is twice as large as the previous one (up to a maximum), so a
+ * tree of n nodes takes O(log n) allocations to build and O(log n)
+ * deallocations to free.  Objects can't be freed one by one: all of them are
+ * destroyed, in the order they were created, when the arena is cleared or
+ * destroyed.
+ *
+ * Objects may be created by several threads at once (for instance, by the
+ * OpenMP tasks that build the subtrees of a tree); only taking the memory for
+ * an object is serialized, not its construction.
+ *
+ * @tparam T Type of the objects to create.
+ */
+template<typename T>
+class NodeArena
+{
+ public:
+  /**
+   * Create an empty arena.  No memory is allocated until the first object is
+   * created.
+   *
+   * @param firstBlockSize Number of objects the first block can hold.
+   * @param maxBlockSize Maximum number of objects that a block can hold.
+   */
+  NodeArena(const size_t firstBlockSize = 64,
+            const size_t maxBlockSize = 65536) :
+      nextBlockSize(std::max(firstBlockSize, (size_t) 1)),
+      maxBlockSize(std::max(maxBlockSize, (size_t) 1)),
+      size(0)
+  { /* Nothing to do. */ }
+
+  //! The arena owns its objects, so it can't be copied.
+  NodeArena(const NodeArena& other) = delete;
+  //! The arena owns its objects, so it can't be copied.
+  NodeArena& operator=(const NodeArena& other) = delete;
+
+  //! Destroy all of the objects of the arena and free its memory.
+  ~NodeArena() { Clear(); }
+
+  /**
+   * Create an object in the arena with the given constructor arguments.  The
+   * object must not be deleted; it is destroyed by Clear().
+   *
+   * @param args Arguments to pass to the constructor of the object.
+   * @return The new object.
+   */
+  template<typename... Args>
+  T* Create(Args&&... args)
+  {
+    T* memory;
+    #pragma omp critical(NodeArenaCreate)
+    {
+      if (blocks.empty() || blocks.back().used == blocks.back().capacity)
+      {
+        Block block;
+        block.memory = static_cast<T*>(::operator new(nextBlockSize *
+            sizeof(T)));
+        block.used = 0;
+        block.capacity = nextBlockSize;
+        blocks.push_back(block);
+
+        nextBlockSize = std::min(2 * nextBlockSize, maxBlockSize);
+      }
+
+      memory = blocks.back().memory + blocks.back().used;
+      ++blocks.back().used;
+      ++size;
+    }
+
+    return new (memory) T(std::forward<Args>(args)...);
+  }
+
+  /**
+   * Destroy all of the objects of the arena, in the order they were created,
+   * and free its memory.
+   */
+  void Clear()
+  {
+    for (size_t i = 0; i < blocks.size(); ++i)
+      for (size_t j = 0; j < blocks[i].used; ++j)
+        blocks[i].memory[j].~T();
+
+    Release();
+  }
+
+  /**
+   * Free the memory of the arena without destroying its objects.  This is only
+   * meant for when all of the objects have already been destroyed by hand (for
+   * instance, after they were moved somewhere else).
+   */
+  void Release()
+  {
+    for (size_t i = 0; i < blocks.size(); ++i)
+      ::operator delete(blocks[i].memory);
+
+    blocks.clear();
+    size = 0;
+  }
+
+  //! Get the number of objects created in the arena.
+  size_t Size() const { return size; }
+  //! Get the number of blocks of memory the arena holds.
+  size_t NumBlocks() const { return blocks.size(); }
+
+ private:
+  //! A block of memory for several objects.
+  struct Block
+  {
+    //! The memory.
+    T* memory;
+    //! The number of objects created in the block.
+    size_t used;
+    //! The number of objects the block can hold.
+    size_t capacity;
+  };
+
+  //! The blocks, in the order they were allocated.
+  std::vector<Block> blocks;
+  //! The number of objects the next block will hold.
+  size_t nextBlockSize;
+  //! The maximum number of objects that a block can hold.
+  size_t maxBlockSize;
+  //! The number of objects created in the arena.
+  size_t size;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
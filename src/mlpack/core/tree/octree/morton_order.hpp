@@ -0,0 +1,65 @@
+/**
+ * @file core/tree/octree/morton_order.hpp
+ *
+ * Definitions of the functions that compute the Morton (Z-order) codes used to
+ * build an Octree without recursively reordering the dataset.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_OCTREE_MORTON_ORDER_HPP
+#define MLPACK_CORE_TREE_OCTREE_MORTON_ORDER_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * Compute the Morton code of each point (column) of the given matrix with
+ * respect to the cells of an octree whose root has the given center and width.
+ * The code of a point holds, from the most significant digit down, the index
+ * of the child that contains the point at each level of the tree, with d bits
+ * per level (bit i is set if the point is not to the left of the center of the
+ * cell in dimension i).  The centers of the cells are computed exactly like
+ * Octree computes the centers of its children, so that the codes agree with
+ * the recursive build.  The codes are computed in parallel with OpenMP.
+ *
+ * @param points Matrix whose columns are the points.
+ * @param center Center of the root cell.
+ * @param width Width of the root cell.
+ * @param levels Number of levels to encode; the product of the number of
+ *     dimensions and this must not be greater than 64.
+ * @param codes Vector to store the Morton code of each point in.
+ */
+template<typename MatType>
+void MortonCodes(const MatType& points,
+                 const arma::vec& center,
+                 const double width,
+                 const size_t levels,
+                 std::vector<uint64_t>& codes);
+
+/**
+ * Sort the given keys with a stable least-significant-digit radix sort, eight
+ * bits at a time, and store the original position of each sorted key.  Each
+ * thread counts and scatters its own block of the keys, so the result does not
+ * depend on the number of threads.
+ *
+ * @param keys Keys to sort.  These are sorted in place.
+ * @param order Vector to store the original position of each sorted key in.
+ * @param bits Number of low bits of the keys to sort by; the higher bits must
+ *     be zero.
+ */
+inline void RadixSort(std::vector<uint64_t>& keys,
+                      std::vector<size_t>& order,
+                      const size_t bits);
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "morton_order_impl.hpp"
+
+#endif
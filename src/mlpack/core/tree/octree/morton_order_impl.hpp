@@ -0,0 +1,137 @@
+/**
+ * @file core/tree/octree/morton_order_impl.hpp
+ *
+ * Implementation of the functions that compute the Morton codes used to build
+ * an Octree.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_OCTREE_MORTON_ORDER_IMPL_HPP
+#define MLPACK_CORE_TREE_OCTREE_MORTON_ORDER_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "morton_order.hpp"
+
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
+namespace mlpack {
+namespace tree {
+
+template<typename MatType>
+void MortonCodes(const MatType& points,
+                 const arma::vec& center,
+                 const double width,
+                 const size_t levels,
+                 std::vector<uint64_t>& codes)
+{
+  const size_t dims = points.n_rows;
+  codes.resize(points.n_cols);
+
+  #pragma omp parallel
+  {
+    arma::vec cellCenter(dims);
+
+    #pragma omp for
+    for (omp_size_t i = 0; i < (omp_size_t) points.n_cols; ++i)
+    {
+      cellCenter = center;
+      double cellWidth = width;
+      uint64_t code = 0;
+      for (size_t l = 0; l < levels; ++l)
+      {
+        uint64_t child = 0;
+        for (size_t d = 0; d < dims; ++d)
+          if (!(points(d, i) < cellCenter[d]))
+            child |= ((uint64_t) 1 << d);
+        code = (code << dims) | child;
+
+        // Descend into the child, like Octree::SplitNode() does.
+        const double childWidth = cellWidth / 2.0;
+        for (size_t d = 0; d < dims; ++d)
+        {
+          if (((child >> d) & 1) == 0)
+            cellCenter[d] = cellCenter[d] - childWidth;
+          else
+            cellCenter[d] = cellCenter[d] + childWidth;
+        }
+        cellWidth = childWidth;
+      }
+
+      codes[i] = code;
+    }
+  }
+}
+
+inline void RadixSort(std::vector<uint64_t>& keys,
+                      std::vector<size_t>& order,
+                      const size_t bits)
+{
+  const size_t n = keys.size();
+  order.resize(n);
+  for (size_t i = 0; i < n; ++i)
+    order[i] = i;
+
+#ifdef HAS_OPENMP
+  const size_t numBlocks = std::max(1, omp_get_max_threads());
+#else
+  const size_t numBlocks = 1;
+#endif
+  const size_t radix = 256;
+
+  std::vector<uint64_t> sortedKeys(n);
+  std::vector<size_t> sortedOrder(n);
+  std::vector<size_t> offsets(numBlocks * radix);
+  for (size_t shift = 0; shift < bits; shift += 8)
+  {
+    // Count the digits of each block.
+    std::fill(offsets.begin(), offsets.end(), 0);
+    #pragma omp parallel for
+    for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+    {
+      const size_t blockBegin = (b * n) / numBlocks;
+      const size_t blockEnd = ((b + 1) * n) / numBlocks;
+      for (size_t i = blockBegin; i < blockEnd; ++i)
+        ++offsets[b * radix + ((keys[i] >> shift) & (radix - 1))];
+    }
+
+    // Turn the counts into the position of the first key of each digit of each
+    // block; the keys of earlier blocks go first, so the sort is stable.
+    size_t position = 0;
+    for (size_t digit = 0; digit < radix; ++digit)
+    {
+      for (size_t b = 0; b < numBlocks; ++b)
+      {
+        const size_t blockCount = offsets[b * radix + digit];
+        offsets[b * radix + digit] = position;
+        position += blockCount;
+      }
+    }
+
+    #pragma omp parallel for
+    for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+    {
+      const size_t blockBegin = (b * n) / numBlocks;
+      const size_t blockEnd = ((b + 1) * n) / numBlocks;
+      for (size_t i = blockBegin; i < blockEnd; ++i)
+      {
+        const size_t digit = (keys[i] >> shift) & (radix - 1);
+        const size_t j = offsets[b * radix + digit]++;
+        sortedKeys[j] = keys[i];
+        sortedOrder[j] = order[i];
+      }
+    }
+
+    keys.swap(sortedKeys);
+    order.swap(sortedOrder);
+  }
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
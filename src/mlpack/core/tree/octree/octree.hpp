@@ -15,10 +15,32 @@
 #include <mlpack/prereqs.hpp>
 #include "../hrectbound.hpp"
 #include "../statistic.hpp"
+#include "morton_order.hpp"
 
 namespace mlpack {
 namespace tree {
 
+/**
+ * The ways to build an Octree.  Both give the same nodes; only the order of
+ * the points inside each leaf may differ.
+ *
+ *  - Recursive: each node reorders its points into its children, one dimension
+ *    at a time, and then builds each child in turn.
+ *  - MortonOrder: the Morton code of each point (the index of the child that
+ *    holds it at each level) is computed in parallel, the points are sorted by
+ *    their codes with a parallel radix sort, and each node finds the ranges of
+ *    its children in the sorted codes with binary searches, so the dataset is
+ *    reordered once instead of once per level.  The children are built in
+ *    parallel with OpenMP tasks.  Nodes deeper than the 64 bits of the codes
+ *    can hold are finished recursively.  This is meant for large
+ *    low-dimensional datasets.
+ */
+enum class OctreeBuildMethod
+{
+  Recursive,
+  MortonOrder
+};
+
 template<typename MetricType = metric::EuclideanDistance,
          typename StatisticType = EmptyStatistic,
          typename MatType = arma::mat>
@@ -72,8 +94,10 @@ class Octree
    *
    * @param data Dataset to create tree from.  This will be copied!
    * @param maxLeafSize Maximum number of points in a leaf node.
+   * @param build Method to build the tree with (see OctreeBuildMethod).
    */
-  Octree(const MatType& data, const size_t maxLeafSize = 20);
+  Octree(const MatType& data, const size_t maxLeafSize = 20,
+         const OctreeBuildMethod build = OctreeBuildMethod::Recursive);
 
   /**
    * Construct this as the root node of an octree on the given dataset.  This
@@ -86,10 +110,12 @@ class Octree
    * @param oldFromNew Vector which will be filled with the old positions for
    *      each new point.
    * @param maxLeafSize Maximum number of points in a leaf node.
+   * @param build Method to build the tree with (see OctreeBuildMethod).
    */
   Octree(const MatType& data,
          std::vector<size_t>& oldFromNew,
-         const size_t maxLeafSize = 20);
+         const size_t maxLeafSize = 20,
+         const OctreeBuildMethod build = OctreeBuildMethod::Recursive);
 
   /**
    * Construct this as the root node of an octree on the given dataset.  This
@@ -105,11 +131,13 @@ class Octree
    * @param newFromOld Vector which will be filled with the new positions for
    *      each old point.
    * @param maxLeafSize Maximum number of points in a leaf node.
+   * @param build Method to build the tree with (see OctreeBuildMethod).
    */
   Octree(const MatType& data,
          std::vector<size_t>& oldFromNew,
          std::vector<size_t>& newFromOld,
-         const size_t maxLeafSize = 20);
+         const size_t maxLeafSize = 20,
+         const OctreeBuildMethod build = OctreeBuildMethod::Recursive);
 
   /**
    * Construct this as the root node of an octree on the given dataset.  This
@@ -118,8 +146,10 @@ class Octree
    *
    * @param data Dataset to create tree from.  This will be copied!
    * @param maxLeafSize Maximum number of points in a leaf node.
+   * @param build Method to build the tree with (see OctreeBuildMethod).
    */
-  Octree(MatType&& data, const size_t maxLeafSize = 20);
+  Octree(MatType&& data, const size_t maxLeafSize = 20,
+         const OctreeBuildMethod build = OctreeBuildMethod::Recursive);
 
   /**
    * Construct this as the root node of an octree on the given dataset. This
@@ -132,10 +162,12 @@ class Octree
    * @param oldFromNew Vector which will be filled with the old positions for
    *      each new point.
    * @param maxLeafSize Maximum number of points in a leaf node.
+   * @param build Method to build the tree with (see OctreeBuildMethod).
    */
   Octree(MatType&& data,
          std::vector<size_t>& oldFromNew,
-         const size_t maxLeafSize = 20);
+         const size_t maxLeafSize = 20,
+         const OctreeBuildMethod build = OctreeBuildMethod::Recursive);
 
   /**
    * Construct this as the root node of an octree on the given dataset.  This
@@ -151,11 +183,13 @@ class Octree
    * @param newFromOld Vector which will be filled with the new positions for
    *      each old point.
    * @param maxLeafSize Maximum number of points in a leaf node.
+   * @param build Method to build the tree with (see OctreeBuildMethod).
    */
   Octree(MatType&& data,
          std::vector<size_t>& oldFromNew,
          std::vector<size_t>& newFromOld,
-         const size_t maxLeafSize = 20);
+         const size_t maxLeafSize = 20,
+         const OctreeBuildMethod build = OctreeBuildMethod::Recursive);
 
   /**
    * Construct this node as a child of the given parent, starting at column
@@ -439,6 +473,65 @@ class Octree
                  std::vector<size_t>& oldFromNew,
                  const size_t maxLeafSize);
 
+  /**
+   * Construct this node as a child of the given parent, starting at column
+   * begin and using count points, without building it.  This is used by
+   * MortonSplitNode(), which builds the node afterwards.
+   *
+   * @param parent Parent of this node.
+   * @param begin Index of the first point of the node.
+   * @param count Number of points of the node.
+   */
+  Octree(Octree* parent, const size_t begin, const size_t count);
+
+  /**
+   * Build the tree below this root node with OctreeBuildMethod::MortonOrder:
+   * sort the points by their Morton codes, reorder the dataset (and the
+   * mappings, if given) once, and derive the nodes from the sorted codes.
+   *
+   * @param center Center of the node.
+   * @param width Width of the node.
+   * @param oldFromNew Mappings from old to new, or NULL if they aren't needed.
+   * @param maxLeafSize Maximum number of points allowed in a leaf.
+   */
+  void MortonBuild(const arma::vec& center,
+                   const double width,
+                   std::vector<size_t>* oldFromNew,
+                   const size_t maxLeafSize);
+
+  /**
+   * Create the children of this node from the sorted Morton codes of its
+   * points, and compute the bound of the node (from the bounds of its
+   * children, if it has any).  A node at the last level of the codes is split
+   * with SplitNode() instead.  The parent distances and statistics of the
+   * children are set afterwards by FinishMortonChildren().
+   *
+   * @param codes Sorted Morton codes of the points of the dataset.
+   * @param level Level of this node (0 for the root).
+   * @param levels Number of levels the codes hold.
+   * @param center Center of the node.
+   * @param width Width of the node.
+   * @param oldFromNew Mappings from old to new, or NULL if they aren't needed.
+   * @param maxLeafSize Maximum number of points allowed in a leaf.
+   */
+  void MortonSplitNode(const std::vector<uint64_t>& codes,
+                       const size_t level,
+                       const size_t levels,
+                       const arma::vec& center,
+                       const double width,
+                       std::vector<size_t>* oldFromNew,
+                       const size_t maxLeafSize);
+
+  /**
+   * Set the parent distances and statistics of the descendants of this node
+   * built by MortonSplitNode(), children before parents, like the recursive
+   * build does.
+   *
+   * @param level Level of this node (0 for the root).
+   * @param levels Number of levels the Morton codes hold.
+   */
+  void FinishMortonChildren(const size_t level, const size_t levels);
+
   /**
    * This is used for sorting points while splitting.
    */
@@ -16,13 +16,19 @@
 #include <mlpack/core/tree/perform_split.hpp>
 #include <stack>
 
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
 namespace mlpack {
 namespace tree {
 
 //! Construct the tree.
 template<typename MetricType, typename StatisticType, typename MatType>
-Octree<MetricType, StatisticType, MatType>::Octree(const MatType& dataset,
-                                                   const size_t maxLeafSize) :
+Octree<MetricType, StatisticType, MatType>::Octree(
+    const MatType& dataset,
+    const size_t maxLeafSize,
+    const OctreeBuildMethod build) :
     begin(0),
     count(dataset.n_cols),
     bound(dataset.n_rows),
@@ -42,7 +48,10 @@ Octree<MetricType, StatisticType, MatType>::Octree(const MatType& dataset,
       if (bound[i].Hi() - bound[i].Lo() > maxWidth)
         maxWidth = bound[i].Hi() - bound[i].Lo();
 
-    SplitNode(center, maxWidth, maxLeafSize);
+    if (build == OctreeBuildMethod::MortonOrder)
+      MortonBuild(center, maxWidth, NULL, maxLeafSize);
+    else
+      SplitNode(center, maxWidth, maxLeafSize);
 
     furthestDescendantDistance = 0.5 * bound.Diameter();
   }
@@ -60,7 +69,8 @@ template<typename MetricType, typename StatisticType, typename MatType>
 Octree<MetricType, StatisticType, MatType>::Octree(
     const MatType& dataset,
     std::vector<size_t>& oldFromNew,
-    const size_t maxLeafSize) :
+    const size_t maxLeafSize,
+    const OctreeBuildMethod build) :
     begin(0),
     count(dataset.n_cols),
     bound(dataset.n_rows),
@@ -84,7 +94,10 @@ Octree<MetricType, StatisticType, MatType>::Octree(
       if (bound[i].Hi() - bound[i].Lo() > maxWidth)
         maxWidth = bound[i].Hi() - bound[i].Lo();
 
-    SplitNode(center, maxWidth, oldFromNew, maxLeafSize);
+    if (build == OctreeBuildMethod::MortonOrder)
+      MortonBuild(center, maxWidth, &oldFromNew, maxLeafSize);
+    else
+      SplitNode(center, maxWidth, oldFromNew, maxLeafSize);
 
     furthestDescendantDistance = 0.5 * bound.Diameter();
   }
@@ -103,7 +116,8 @@ Octree<MetricType, StatisticType, MatType>::Octree(
     const MatType& dataset,
     std::vector<size_t>& oldFromNew,
     std::vector<size_t>& newFromOld,
-    const size_t maxLeafSize) :
+    const size_t maxLeafSize,
+    const OctreeBuildMethod build) :
     begin(0),
     count(dataset.n_cols),
     bound(dataset.n_rows),
@@ -127,7 +141,10 @@ Octree<MetricType, StatisticType, MatType>::Octree(
       if (bound[i].Hi() - bound[i].Lo() > maxWidth)
         maxWidth = bound[i].Hi() - bound[i].Lo();
 
-    SplitNode(center, maxWidth, oldFromNew, maxLeafSize);
+    if (build == OctreeBuildMethod::MortonOrder)
+      MortonBuild(center, maxWidth, &oldFromNew, maxLeafSize);
+    else
+      SplitNode(center, maxWidth, oldFromNew, maxLeafSize);
 
     furthestDescendantDistance = 0.5 * bound.Diameter();
   }
@@ -147,8 +164,10 @@ Octree<MetricType, StatisticType, MatType>::Octree(
 
 //! Construct the tree.
 template<typename MetricType, typename StatisticType, typename MatType>
-Octree<MetricType, StatisticType, MatType>::Octree(MatType&& dataset,
-                                                   const size_t maxLeafSize) :
+Octree<MetricType, StatisticType, MatType>::Octree(
+    MatType&& dataset,
+    const size_t maxLeafSize,
+    const OctreeBuildMethod build) :
     begin(0),
     count(dataset.n_cols),
     bound(dataset.n_rows),
@@ -168,7 +187,10 @@ Octree<MetricType, StatisticType, MatType>::Octree(MatType&& dataset,
       if (bound[i].Hi() - bound[i].Lo() > maxWidth)
         maxWidth = bound[i].Hi() - bound[i].Lo();
 
-    SplitNode(center, maxWidth, maxLeafSize);
+    if (build == OctreeBuildMethod::MortonOrder)
+      MortonBuild(center, maxWidth, NULL, maxLeafSize);
+    else
+      SplitNode(center, maxWidth, maxLeafSize);
 
     furthestDescendantDistance = 0.5 * bound.Diameter();
   }
@@ -186,7 +208,8 @@ template<typename MetricType, typename StatisticType, typename MatType>
 Octree<MetricType, StatisticType, MatType>::Octree(
     MatType&& dataset,
     std::vector<size_t>& oldFromNew,
-    const size_t maxLeafSize) :
+    const size_t maxLeafSize,
+    const OctreeBuildMethod build) :
     begin(0),
     count(dataset.n_cols),
     bound(dataset.n_rows),
@@ -210,7 +233,10 @@ Octree<MetricType, StatisticType, MatType>::Octree(
       if (bound[i].Hi() - bound[i].Lo() > maxWidth)
         maxWidth = bound[i].Hi() - bound[i].Lo();
 
-    SplitNode(center, maxWidth, oldFromNew, maxLeafSize);
+    if (build == OctreeBuildMethod::MortonOrder)
+      MortonBuild(center, maxWidth, &oldFromNew, maxLeafSize);
+    else
+      SplitNode(center, maxWidth, oldFromNew, maxLeafSize);
 
     furthestDescendantDistance = 0.5 * bound.Diameter();
   }
@@ -229,7 +255,8 @@ Octree<MetricType, StatisticType, MatType>::Octree(
     MatType&& dataset,
     std::vector<size_t>& oldFromNew,
     std::vector<size_t>& newFromOld,
-    const size_t maxLeafSize) :
+    const size_t maxLeafSize,
+    const OctreeBuildMethod build) :
     begin(0),
     count(dataset.n_cols),
     bound(dataset.n_rows),
@@ -253,7 +280,10 @@ Octree<MetricType, StatisticType, MatType>::Octree(
       if (bound[i].Hi() - bound[i].Lo() > maxWidth)
         maxWidth = bound[i].Hi() - bound[i].Lo();
 
-    SplitNode(center, maxWidth, oldFromNew, maxLeafSize);
+    if (build == OctreeBuildMethod::MortonOrder)
+      MortonBuild(center, maxWidth, &oldFromNew, maxLeafSize);
+    else
+      SplitNode(center, maxWidth, oldFromNew, maxLeafSize);
 
     furthestDescendantDistance = 0.5 * bound.Diameter();
   }
@@ -340,6 +370,22 @@ Octree<MetricType, StatisticType, MatType>::Octree(
   stat = StatisticType(*this);
 }
 
+//! Construct a child node, to be built by MortonSplitNode().
+template<typename MetricType, typename StatisticType, typename MatType>
+Octree<MetricType, StatisticType, MatType>::Octree(Octree* parent,
+                                                   const size_t begin,
+                                                   const size_t count) :
+    begin(begin),
+    count(count),
+    bound(parent->dataset->n_rows),
+    dataset(parent->dataset),
+    parent(parent),
+    parentDistance(0.0),
+    furthestDescendantDistance(0.0)
+{
+  // Nothing to do.
+}
+
 //! Copy the given tree.
 template<typename MetricType, typename StatisticType, typename MatType>
 Octree<MetricType, StatisticType, MatType>::Octree(const Octree& other) :
@@ -946,6 +992,179 @@ void Octree<MetricType, StatisticType, MatType>::SplitNode(
   }
 }
 
+//! Build the tree from the Morton codes of the points.
+template<typename MetricType, typename StatisticType, typename MatType>
+void Octree<MetricType, StatisticType, MatType>::MortonBuild(
+    const arma::vec& center,
+    const double width,
+    std::vector<size_t>* oldFromNew,
+    const size_t maxLeafSize)
+{
+  // No need to split if we have fewer than the maximum number of points in this
+  // node.
+  if (count <= maxLeafSize || dataset->n_rows == 0)
+    return;
+
+  // Each level of the codes takes one bit per dimension.
+  const size_t levels = std::max((size_t) 1, 64 / dataset->n_rows);
+  std::vector<uint64_t> codes;
+  MortonCodes(*dataset, center, width, levels, codes);
+
+  std::vector<size_t> order;
+  RadixSort(codes, order, levels * dataset->n_rows);
+
+  // Now reorder the dataset (and the mappings) once, so that the points of each
+  // node are contiguous.
+  MatType sortedDataset(dataset->n_rows, dataset->n_cols);
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) count; ++i)
+    sortedDataset.col(i) = dataset->col(order[i]);
+  *dataset = std::move(sortedDataset);
+
+  if (oldFromNew)
+  {
+    std::vector<size_t> sortedOldFromNew(count);
+    for (size_t i = 0; i < count; ++i)
+      sortedOldFromNew[i] = (*oldFromNew)[order[i]];
+    oldFromNew->swap(sortedOldFromNew);
+  }
+
+#ifdef HAS_OPENMP
+  if (omp_get_level() == 0)
+  {
+    #pragma omp parallel
+    {
+      #pragma omp single
+      MortonSplitNode(codes, 0, levels, center, width, oldFromNew,
+          maxLeafSize);
+    }
+  }
+  else
+  {
+    MortonSplitNode(codes, 0, levels, center, width, oldFromNew, maxLeafSize);
+  }
+#else
+  MortonSplitNode(codes, 0, levels, center, width, oldFromNew, maxLeafSize);
+#endif
+
+  FinishMortonChildren(0, levels);
+}
+
+//! Create the children of the node from the sorted Morton codes.
+template<typename MetricType, typename StatisticType, typename MatType>
+void Octree<MetricType, StatisticType, MatType>::MortonSplitNode(
+    const std::vector<uint64_t>& codes,
+    const size_t level,
+    const size_t levels,
+    const arma::vec& center,
+    const double width,
+    std::vector<size_t>* oldFromNew,
+    const size_t maxLeafSize)
+{
+  // The codes can't tell the children of the nodes at the last level apart, so
+  // those are split recursively.
+  if (count <= maxLeafSize || level == levels)
+  {
+    bound |= dataset->cols(begin, begin + count - 1);
+    if (level == levels)
+    {
+      if (oldFromNew)
+        SplitNode(center, width, *oldFromNew, maxLeafSize);
+      else
+        SplitNode(center, width, maxLeafSize);
+    }
+
+    furthestDescendantDistance = 0.5 * bound.Diameter();
+    return;
+  }
+
+  // The codes of the points of this node only differ below this level, so the
+  // points of each child are a contiguous range of the sorted codes.
+  const size_t dims = dataset->n_rows;
+  const size_t shift = (levels - 1 - level) * dims;
+  const uint64_t mask = (~((uint64_t) 0)) >> (64 - dims);
+  auto childBefore = [shift, mask](const uint64_t code, const size_t child)
+  {
+    return ((code >> shift) & mask) < child;
+  };
+
+  const size_t numChildren = ((size_t) 1 << dims);
+  std::vector<size_t> childBegins(numChildren + 1);
+  childBegins[0] = begin;
+  childBegins[numChildren] = begin + count;
+  for (size_t i = 1; i < numChildren; ++i)
+  {
+    childBegins[i] = std::lower_bound(codes.begin() + childBegins[i - 1],
+        codes.begin() + begin + count, i, childBefore) - codes.begin();
+  }
+
+  // Create the children that have points, with the same centers as
+  // SplitNode() would give them.
+  std::vector<arma::vec> childCenters;
+  const double childWidth = width / 2.0;
+  for (size_t i = 0; i < numChildren; ++i)
+  {
+    if (childBegins[i + 1] - childBegins[i] == 0)
+      continue;
+
+    arma::vec childCenter(center.n_elem);
+    for (size_t d = 0; d < center.n_elem; ++d)
+    {
+      // Is the dimension "right" (1) or "left" (0)?
+      if (((i >> d) & 1) == 0)
+        childCenter[d] = center[d] - childWidth;
+      else
+        childCenter[d] = center[d] + childWidth;
+    }
+
+    children.push_back(new Octree(this, childBegins[i],
+        childBegins[i + 1] - childBegins[i]));
+    childCenters.push_back(std::move(childCenter));
+  }
+
+  // The children hold disjoint ranges of the dataset, so the large ones are
+  // built by separate tasks.
+  const size_t minParallelSize = 4096;
+  for (size_t i = 0; i < children.size(); ++i)
+  {
+    const bool spawn = (children[i]->count >= minParallelSize);
+    #pragma omp task default(shared) firstprivate(i) if(spawn)
+    children[i]->MortonSplitNode(codes, level + 1, levels, childCenters[i],
+        childWidth, oldFromNew, maxLeafSize);
+  }
+  #pragma omp taskwait
+
+  for (size_t i = 0; i < children.size(); ++i)
+    bound |= children[i]->bound;
+  furthestDescendantDistance = 0.5 * bound.Diameter();
+}
+
+//! Set the parent distances and statistics of the nodes built from the codes.
+template<typename MetricType, typename StatisticType, typename MatType>
+void Octree<MetricType, StatisticType, MatType>::FinishMortonChildren(
+    const size_t level,
+    const size_t levels)
+{
+  arma::vec center, childCenter;
+  bound.Center(center);
+  for (size_t i = 0; i < children.size(); ++i)
+  {
+    // Calculate the distance from the empirical center of the child to the
+    // empirical center of this node.
+    children[i]->bound.Center(childCenter);
+    children[i]->parentDistance = children[i]->metric.Evaluate(childCenter,
+        center);
+
+    // The children of the nodes at the last level were built by SplitNode(),
+    // which already set their parent distances and statistics.
+    if (level + 1 < levels)
+      children[i]->FinishMortonChildren(level + 1, levels);
+
+    // Initialize the statistic.
+    children[i]->stat = StatisticType(*children[i]);
+  }
+}
+
 } // namespace tree
 } // namespace mlpack
 
@@ -25,6 +25,7 @@
 #include "rectangle_tree/r_tree_split.hpp"
 #include "rectangle_tree/r_star_tree_split.hpp"
 #include "rectangle_tree/no_auxiliary_information.hpp"
+#include "rectangle_tree/bulk_load.hpp"
 #include "rectangle_tree/r_tree_descent_heuristic.hpp"
 #include "rectangle_tree/r_star_tree_descent_heuristic.hpp"
 #include "rectangle_tree/x_tree_split.hpp"
@@ -0,0 +1,142 @@
+/**
+ * @file core/tree/rectangle_tree/bulk_load.hpp
+ *
+ * Definitions of the orderings used to bulk-load rectangle trees: the points
+ * (or nodes) of each level are divided into groups that become the nodes of the
+ * next level, instead of being inserted one at a time.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_RECTANGLE_TREE_BULK_LOAD_HPP
+#define MLPACK_CORE_TREE_RECTANGLE_TREE_BULK_LOAD_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The ways to divide the points of a rectangle tree into nodes when the tree is
+ * bulk-loaded.
+ *
+ *  - SortTileRecursive: the items of each level are cut into slabs along the
+ *    first dimension, each slab is cut into slabs along the second dimension,
+ *    and so on (Leutenegger et al., 1997).
+ *  - HilbertPacking: the points are ordered along the Hilbert curve (see
+ *    DiscreteHilbertValue) and consecutive points and nodes are packed together
+ *    (Kamel and Faloutsos, 1993).
+ *
+ * @code
+ * @inproceedings{leutenegger1997str,
+ *   title={STR: A simple and efficient algorithm for R-tree packing},
+ *   author={Leutenegger, S.T. and Lopez, M.A. and Edgington, J.},
+ *   booktitle={Proceedings of the 13th International Conference on Data
+ *       Engineering},
+ *   pages={497--506},
+ *   year={1997},
+ *   organization={IEEE}
+ * }
+ * @endcode
+ */
+enum class BulkLoadMethod
+{
+  SortTileRecursive,
+  HilbertPacking
+};
+
+// Forward declarations of the splits of the trees that can be bulk-loaded.
+class RTreeSplit;
+class RStarTreeSplit;
+class XTreeSplit;
+
+/**
+ * Whether rectangle trees with the given split type can be bulk-loaded.  This
+ * is false for the trees whose nodes hold more than their points and children
+ * (such as the Hilbert values of the Hilbert R tree) or whose nodes must not
+ * overlap (such as the R+ tree), since bulk loading does not maintain that
+ * information.
+ */
+template<typename SplitType>
+struct IsBulkLoadable
+{
+  static const bool value = false;
+};
+
+template<>
+struct IsBulkLoadable<RTreeSplit>
+{
+  static const bool value = true;
+};
+
+template<>
+struct IsBulkLoadable<RStarTreeSplit>
+{
+  static const bool value = true;
+};
+
+template<>
+struct IsBulkLoadable<XTreeSplit>
+{
+  static const bool value = true;
+};
+
+/**
+ * Compute the boundaries of the given number of groups of consecutive items,
+ * whose sizes differ by at most one.
+ *
+ * @param numItems Number of items.
+ * @param numGroups Number of groups.
+ * @param groupBegins Vector to store the index of the first item of each group
+ *     in, followed by numItems.
+ */
+inline void EvenGroups(const size_t numItems,
+                       const size_t numGroups,
+                       std::vector<size_t>& groupBegins);
+
+/**
+ * Order the items (columns) of the given matrix by the Sort-Tile-Recursive
+ * algorithm, and divide them into the given number of groups, whose sizes
+ * differ by at most one.  Each group is a consecutive range of the order.  The
+ * items are only partitioned (with std::nth_element()) and never fully sorted,
+ * and the slabs are partitioned in parallel with OpenMP tasks.
+ *
+ * @param coordinates Matrix whose columns are the locations of the items.
+ * @param order Vector to store the order of the items in.
+ * @param numGroups Number of groups to divide the items into.
+ * @param groupBegins Vector to store the index in the order of the first item
+ *     of each group in, followed by the number of items.
+ */
+template<typename MatType>
+void SortTileRecursive(const MatType& coordinates,
+                       std::vector<size_t>& order,
+                       const size_t numGroups,
+                       std::vector<size_t>& groupBegins);
+
+/**
+ * Order the points (columns) of the given matrix along the Hilbert curve given
+ * by DiscreteHilbertValue, and divide them into the given number of groups
+ * like SortTileRecursive().  The Hilbert values are computed in parallel, and
+ * the groups are partitioned in parallel.
+ *
+ * @param points Matrix whose columns are the points.
+ * @param order Vector to store the order of the points in.
+ * @param numGroups Number of groups to divide the points into.
+ * @param groupBegins Vector to store the index in the order of the first point
+ *     of each group in, followed by the number of points.
+ */
+template<typename MatType>
+void HilbertOrder(const MatType& points,
+                  std::vector<size_t>& order,
+                  const size_t numGroups,
+                  std::vector<size_t>& groupBegins);
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "bulk_load_impl.hpp"
+
+#endif
@@ -0,0 +1,192 @@
+/**
+ * @file core/tree/rectangle_tree/bulk_load_impl.hpp
+ *
+ * Implementation of the orderings used to bulk-load rectangle trees.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_RECTANGLE_TREE_BULK_LOAD_IMPL_HPP
+#define MLPACK_CORE_TREE_RECTANGLE_TREE_BULK_LOAD_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "bulk_load.hpp"
+
+#include "discrete_hilbert_value.hpp"
+
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
+namespace mlpack {
+namespace tree {
+
+inline void EvenGroups(const size_t numItems,
+                       const size_t numGroups,
+                       std::vector<size_t>& groupBegins)
+{
+  groupBegins.resize(numGroups + 1);
+  for (size_t i = 0; i <= numGroups; ++i)
+    groupBegins[i] = (i * numItems) / numGroups;
+}
+
+namespace details {
+
+//! Ranges of the order with fewer items than this are partitioned serially.
+const size_t bulkLoadTaskSize = 10000;
+
+/**
+ * Partition the given range of groups of the order, so that no item of a group
+ * is greater than an item of a later group.  The range is bisected at the
+ * middle group with std::nth_element(), and the two halves are partitioned by
+ * separate tasks.
+ */
+template<typename CompareType>
+void PartitionGroups(std::vector<size_t>& order,
+                     const std::vector<size_t>& groupBegins,
+                     const size_t firstGroup,
+                     const size_t lastGroup,
+                     const CompareType& compare)
+{
+  if (lastGroup - firstGroup < 2)
+    return;
+
+  const size_t middleGroup = (firstGroup + lastGroup) / 2;
+  std::nth_element(order.begin() + groupBegins[firstGroup],
+                   order.begin() + groupBegins[middleGroup],
+                   order.begin() + groupBegins[lastGroup],
+                   compare);
+
+  const bool spawn = (groupBegins[lastGroup] - groupBegins[firstGroup] >=
+      bulkLoadTaskSize);
+  #pragma omp task default(shared) if(spawn)
+  PartitionGroups(order, groupBegins, firstGroup, middleGroup, compare);
+  PartitionGroups(order, groupBegins, middleGroup, lastGroup, compare);
+  #pragma omp taskwait
+}
+
+/**
+ * Divide the items of the given range of groups into slabs along the given
+ * dimension, and tile each slab along the next dimensions.  Each slab holds a
+ * whole number of groups, and there are about numGroups^(1 / d) slabs, where d
+ * is the number of dimensions left.
+ */
+template<typename MatType>
+void TileSlabs(const MatType& coordinates,
+               std::vector<size_t>& order,
+               const std::vector<size_t>& groupBegins,
+               const size_t firstGroup,
+               const size_t lastGroup,
+               const size_t dim)
+{
+  auto compare = [&coordinates, dim](const size_t a, const size_t b)
+  {
+    return coordinates(dim, a) < coordinates(dim, b);
+  };
+
+  const size_t numGroups = lastGroup - firstGroup;
+  if (dim + 1 >= coordinates.n_rows || numGroups < 2)
+  {
+    PartitionGroups(order, groupBegins, firstGroup, lastGroup, compare);
+    return;
+  }
+
+  // The epsilon keeps exact roots (such as 8^(1 / 3)) from rounding up.
+  const size_t dimsLeft = coordinates.n_rows - dim;
+  const size_t numSlabs = std::min(numGroups, (size_t) std::ceil(
+      std::pow((double) numGroups, 1.0 / dimsLeft) - 1e-9));
+
+  std::vector<size_t> slabGroups(numSlabs + 1);
+  std::vector<size_t> slabBegins(numSlabs + 1);
+  for (size_t i = 0; i <= numSlabs; ++i)
+  {
+    slabGroups[i] = firstGroup + (i * numGroups) / numSlabs;
+    slabBegins[i] = groupBegins[slabGroups[i]];
+  }
+  PartitionGroups(order, slabBegins, 0, numSlabs, compare);
+
+  for (size_t i = 0; i < numSlabs; ++i)
+  {
+    const bool spawn = (slabBegins[i + 1] - slabBegins[i] >= bulkLoadTaskSize);
+    #pragma omp task default(shared) firstprivate(i) if(spawn)
+    TileSlabs(coordinates, order, groupBegins, slabGroups[i],
+        slabGroups[i + 1], dim + 1);
+  }
+  #pragma omp taskwait
+}
+
+} // namespace details
+
+template<typename MatType>
+void SortTileRecursive(const MatType& coordinates,
+                       std::vector<size_t>& order,
+                       const size_t numGroups,
+                       std::vector<size_t>& groupBegins)
+{
+  order.resize(coordinates.n_cols);
+  for (size_t i = 0; i < order.size(); ++i)
+    order[i] = i;
+  EvenGroups(coordinates.n_cols, numGroups, groupBegins);
+
+#ifdef HAS_OPENMP
+  if (omp_get_level() == 0)
+  {
+    #pragma omp parallel
+    {
+      #pragma omp single
+      details::TileSlabs(coordinates, order, groupBegins, 0, numGroups, 0);
+    }
+    return;
+  }
+#endif
+
+  details::TileSlabs(coordinates, order, groupBegins, 0, numGroups, 0);
+}
+
+template<typename MatType>
+void HilbertOrder(const MatType& points,
+                  std::vector<size_t>& order,
+                  const size_t numGroups,
+                  std::vector<size_t>& groupBegins)
+{
+  typedef DiscreteHilbertValue<typename MatType::elem_type> HilbertValueType;
+  typedef typename HilbertValueType::HilbertElemType HilbertElemType;
+
+  // Each Hilbert value is computed once, instead of once per comparison.
+  arma::Mat<HilbertElemType> values(points.n_rows, points.n_cols);
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) points.n_cols; ++i)
+    values.col(i) = HilbertValueType::CalculateValue(points.col(i));
+
+  order.resize(points.n_cols);
+  for (size_t i = 0; i < order.size(); ++i)
+    order[i] = i;
+  EvenGroups(points.n_cols, numGroups, groupBegins);
+
+  auto compare = [&values](const size_t a, const size_t b)
+  {
+    return HilbertValueType::CompareValues(values.unsafe_col(a),
+        values.unsafe_col(b)) < 0;
+  };
+
+#ifdef HAS_OPENMP
+  if (omp_get_level() == 0)
+  {
+    #pragma omp parallel
+    {
+      #pragma omp single
+      details::PartitionGroups(order, groupBegins, 0, numGroups, compare);
+    }
+    return;
+  }
+#endif
+
+  details::PartitionGroups(order, groupBegins, 0, numGroups, compare);
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
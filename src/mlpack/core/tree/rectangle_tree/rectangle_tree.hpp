@@ -20,6 +20,7 @@
 #include "r_tree_split.hpp"
 #include "r_tree_descent_heuristic.hpp"
 #include "no_auxiliary_information.hpp"
+#include "bulk_load.hpp"
 
 namespace mlpack {
 namespace tree /** Trees and tree-building procedures. */ {
@@ -156,6 +157,54 @@ class RectangleTree
                 const size_t minNumChildren = 2,
                 const size_t firstDataIndex = 0);
 
+  /**
+   * Construct this as the root node of a rectangle type tree by bulk-loading
+   * the given dataset: the points are divided into full leaves with the given
+   * method, and the leaves are grouped into full nodes a level at a time,
+   * instead of inserting the points one by one.  This is much faster than
+   * inserting the points, and the nodes usually overlap less.  The dataset is
+   * not modified, and points may still be inserted and deleted afterwards.
+   *
+   * Only the trees whose nodes hold nothing but their points and children (the
+   * R tree, the R* tree and the X tree) can be bulk-loaded; see
+   * IsBulkLoadable.
+   *
+   * @param data Dataset from which to create the tree.
+   * @param method Method to divide the points and the nodes into groups with.
+   * @param maxLeafSize Maximum size of each leaf in the tree.
+   * @param minLeafSize Minimum size of each leaf in the tree.
+   * @param maxNumChildren The maximum number of child nodes a non-leaf node may
+   *      have.
+   * @param minNumChildren The minimum number of child nodes a non-leaf node may
+   *      have.
+   */
+  RectangleTree(const MatType& data,
+                const BulkLoadMethod method,
+                const size_t maxLeafSize = 20,
+                const size_t minLeafSize = 8,
+                const size_t maxNumChildren = 5,
+                const size_t minNumChildren = 2);
+
+  /**
+   * Construct this as the root node of a rectangle type tree by bulk-loading
+   * the given dataset, and taking ownership of the given dataset.
+   *
+   * @param data Dataset from which to create the tree.
+   * @param method Method to divide the points and the nodes into groups with.
+   * @param maxLeafSize Maximum size of each leaf in the tree.
+   * @param minLeafSize Minimum size of each leaf in the tree.
+   * @param maxNumChildren The maximum number of child nodes a non-leaf node may
+   *      have.
+   * @param minNumChildren The minimum number of child nodes a non-leaf node may
+   *      have.
+   */
+  RectangleTree(MatType&& data,
+                const BulkLoadMethod method,
+                const size_t maxLeafSize = 20,
+                const size_t minLeafSize = 8,
+                const size_t maxNumChildren = 5,
+                const size_t minNumChildren = 2);
+
   /**
    * Construct this as an empty node with the specified parent.  Copying the
    * parameters (maxLeafSize, minLeafSize, maxNumChildren, minNumChildren,
@@ -564,6 +613,14 @@ class RectangleTree
    */
   void BuildStatistics(RectangleTree* node);
 
+  /**
+   * Bulk-load the dataset into this empty root node.  The leaves are filled
+   * in parallel, and each level of the tree is built from the one below it.
+   *
+   * @param method Method to divide the points and the nodes into groups with.
+   */
+  void BulkLoad(const BulkLoadMethod method);
+
  protected:
   /**
    * A default constructor.  This is meant to only be used with
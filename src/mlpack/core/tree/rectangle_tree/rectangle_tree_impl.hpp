@@ -40,6 +40,115 @@ BuildStatistics(RectangleTree* node)
   node->Stat() = StatisticType(*node);
 }
 
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType,
+         typename DescentType,
+         template<typename> class AuxiliaryInformationType>
+void RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType,
+              AuxiliaryInformationType>::
+BulkLoad(const BulkLoadMethod method)
+{
+  static_assert(IsBulkLoadable<SplitType>::value, "RectangleTree: only trees "
+      "whose nodes hold nothing but their points and children (RTree, "
+      "RStarTree and XTree) can be bulk-loaded");
+
+  const size_t numPoints = dataset->n_cols;
+  if (numPoints <= maxLeafSize)
+  {
+    for (size_t i = 0; i < numPoints; ++i)
+      points[count++] = i;
+    numDescendants = numPoints;
+    if (numPoints > 0)
+      bound |= *dataset;
+
+    BuildStatistics(this);
+    return;
+  }
+
+  // Divide the points into as few leaves as possible.  The nodes are created
+  // with this node as their parent, so that they copy its parameters, and they
+  // get their real parent when the next level is built.
+  std::vector<size_t> order;
+  std::vector<size_t> groupBegins;
+  const size_t numLeaves = (numPoints + maxLeafSize - 1) / maxLeafSize;
+  if (method == BulkLoadMethod::SortTileRecursive)
+    SortTileRecursive(*dataset, order, numLeaves, groupBegins);
+  else
+    HilbertOrder(*dataset, order, numLeaves, groupBegins);
+
+  std::vector<RectangleTree*> level(numLeaves);
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) numLeaves; ++i)
+  {
+    RectangleTree* leaf = new RectangleTree(this);
+    for (size_t j = groupBegins[i]; j < groupBegins[i + 1]; ++j)
+    {
+      leaf->points[leaf->count++] = order[j];
+      leaf->bound |= dataset->col(order[j]);
+    }
+    leaf->numDescendants = leaf->count;
+    level[i] = leaf;
+  }
+
+  // Group each level into as few nodes as possible, until it fits in the root.
+  // The nodes of a level are tiled by the centers of their bounds; with Hilbert
+  // packing, consecutive nodes already hold consecutive points on the curve.
+  while (level.size() > maxNumChildren)
+  {
+    const size_t numNodes = (level.size() + maxNumChildren - 1) /
+        maxNumChildren;
+    if (method == BulkLoadMethod::SortTileRecursive)
+    {
+      arma::Mat<ElemType> centers(dataset->n_rows, level.size());
+      #pragma omp parallel for
+      for (omp_size_t i = 0; i < (omp_size_t) level.size(); ++i)
+      {
+        arma::Col<ElemType> center;
+        level[i]->bound.Center(center);
+        centers.col(i) = center;
+      }
+      SortTileRecursive(centers, order, numNodes, groupBegins);
+    }
+    else
+    {
+      order.resize(level.size());
+      for (size_t i = 0; i < order.size(); ++i)
+        order[i] = i;
+      EvenGroups(level.size(), numNodes, groupBegins);
+    }
+
+    std::vector<RectangleTree*> nodes(numNodes);
+    #pragma omp parallel for
+    for (omp_size_t i = 0; i < (omp_size_t) numNodes; ++i)
+    {
+      RectangleTree* node = new RectangleTree(this);
+      for (size_t j = groupBegins[i]; j < groupBegins[i + 1]; ++j)
+      {
+        RectangleTree* child = level[order[j]];
+        node->children[node->numChildren++] = child;
+        child->parent = node;
+        node->bound |= child->bound;
+        node->numDescendants += child->numDescendants;
+      }
+      nodes[i] = node;
+    }
+    level.swap(nodes);
+  }
+
+  for (size_t i = 0; i < level.size(); ++i)
+  {
+    children[numChildren++] = level[i];
+    level[i]->parent = this;
+    bound |= level[i]->bound;
+    numDescendants += level[i]->numDescendants;
+  }
+
+  // Initialize statistic recursively after tree construction is complete.
+  BuildStatistics(this);
+}
+
 template<typename MetricType,
          typename StatisticType,
          typename MatType,
@@ -122,6 +231,74 @@ RectangleTree(MatType&& data,
   BuildStatistics(this);
 }
 
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType,
+         typename DescentType,
+         template<typename> class AuxiliaryInformationType>
+RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType,
+              AuxiliaryInformationType>::
+RectangleTree(const MatType& data,
+              const BulkLoadMethod method,
+              const size_t maxLeafSize,
+              const size_t minLeafSize,
+              const size_t maxNumChildren,
+              const size_t minNumChildren) :
+    maxNumChildren(maxNumChildren),
+    minNumChildren(minNumChildren),
+    numChildren(0),
+    children(maxNumChildren + 1), // Add one to make splitting the node simpler.
+    parent(NULL),
+    begin(0),
+    count(0),
+    numDescendants(0),
+    maxLeafSize(maxLeafSize),
+    minLeafSize(minLeafSize),
+    bound(data.n_rows),
+    parentDistance(0),
+    dataset(new MatType(data)),
+    ownsDataset(true),
+    points(maxLeafSize + 1), // Add one to make splitting the node simpler.
+    auxiliaryInfo(this)
+{
+  BulkLoad(method);
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType,
+         typename DescentType,
+         template<typename> class AuxiliaryInformationType>
+RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType,
+              AuxiliaryInformationType>::
+RectangleTree(MatType&& data,
+              const BulkLoadMethod method,
+              const size_t maxLeafSize,
+              const size_t minLeafSize,
+              const size_t maxNumChildren,
+              const size_t minNumChildren) :
+    maxNumChildren(maxNumChildren),
+    minNumChildren(minNumChildren),
+    numChildren(0),
+    children(maxNumChildren + 1), // Add one to make splitting the node simpler.
+    parent(NULL),
+    begin(0),
+    count(0),
+    numDescendants(0),
+    maxLeafSize(maxLeafSize),
+    minLeafSize(minLeafSize),
+    bound(data.n_rows),
+    parentDistance(0),
+    dataset(new MatType(std::move(data))),
+    ownsDataset(true),
+    points(maxLeafSize + 1), // Add one to make splitting the node simpler.
+    auxiliaryInfo(this)
+{
+  BulkLoad(method);
+}
+
 template<typename MetricType,
          typename StatisticType,
          typename MatType,
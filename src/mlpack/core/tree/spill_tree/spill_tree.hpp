@@ -90,8 +90,11 @@ class SpillTree
   //! The number of points of the dataset contained in this node (and its
   //! children).
   size_t count;
-  //! The list of indexes of points contained in this node (non-null for
-  //! leaf nodes).
+  //! The index of the first point of this node in pointsIndex.
+  size_t begin;
+  //! The indexes of the points of all the leaves, shared by every node of the
+  //! tree and owned by the root.  The leaves are stored in depth-first order,
+  //! so the descendants of each node are contiguous.
   arma::Col<size_t>* pointsIndex;
   //! Flag to distinguish overlapping nodes from non-overlapping nodes.
   bool overlappingNode;
@@ -150,15 +153,23 @@ class SpillTree
    * dataset.  The dataset will not be modified during the building procedure
    * (unlike BinarySpaceTree).
    *
+   * The overlapping buffers duplicate the indexes of the points they hold, so
+   * the memory used by the tree can be bounded with overlapBudget: once the
+   * buffers of a subtree would duplicate more indexes than its share of the
+   * budget, its nodes are split without overlapping buffers.
+   *
    * @param data Dataset to create tree from.
    * @param tau Overlapping size.
    * @param maxLeafSize Size of each leaf in the tree.
    * @param rho Balance threshold.
+   * @param overlapBudget Maximum number of point indexes that the overlapping
+   *     buffers of the tree may duplicate (by default, there is no limit).
    */
   SpillTree(const MatType& data,
             const double tau = 0,
             const size_t maxLeafSize = 20,
-            const double rho = 0.7);
+            const double rho = 0.7,
+            const size_t overlapBudget = std::numeric_limits<size_t>::max());
 
   /**
    * Construct this as the root node of a hybrid spill tree using the given
@@ -170,28 +181,35 @@ class SpillTree
    * @param tau Overlapping size.
    * @param maxLeafSize Size of each leaf in the tree.
    * @param rho Balance threshold.
+   * @param overlapBudget Maximum number of point indexes that the overlapping
+   *     buffers of the tree may duplicate (by default, there is no limit).
    */
   SpillTree(MatType&& data,
             const double tau = 0,
             const size_t maxLeafSize = 20,
-            const double rho = 0.7);
+            const double rho = 0.7,
+            const size_t overlapBudget = std::numeric_limits<size_t>::max());
 
   /**
    * Construct this node as a child of the given parent, including the given
    * list of points.  This is used for recursive tree-building by the other
-   * constructors which don't specify point indices.
+   * constructors which don't specify point indices; the root builds the shared
+   * buffer of point indexes and the statistics once the whole tree is built.
    *
    * @param parent Parent of this node.
    * @param points Vector of indexes of points to be included in this node.
    * @param tau Overlapping size.
    * @param maxLeafSize Size of each leaf in the tree.
    * @param rho Balance threshold.
+   * @param overlapBudget Maximum number of point indexes that the overlapping
+   *     buffers of this subtree may duplicate.
    */
   SpillTree(SpillTree* parent,
             arma::Col<size_t>& points,
             const double tau = 0,
             const size_t maxLeafSize = 20,
-            const double rho = 0.7);
+            const double rho = 0.7,
+            const size_t overlapBudget = std::numeric_limits<size_t>::max());
 
   /**
    * Create a hybrid spill tree by copying the other tree.  Be careful!  This
@@ -445,17 +463,22 @@ class SpillTree
    * @param maxLeafSize Maximum number of points held in a leaf.
    * @param tau Overlapping size.
    * @param rho Balance threshold.
+   * @param overlapBudget Maximum number of point indexes that the overlapping
+   *     buffers of this subtree may duplicate.
    */
   void SplitNode(arma::Col<size_t>& points,
                  const size_t maxLeafSize,
                  const double tau,
-                 const double rho);
+                 const double rho,
+                 const size_t overlapBudget);
 
   /**
    * Split the list of points.
    *
    * @param tau Overlapping size.
    * @param rho Balance threshold.
+   * @param overlapBudget Maximum number of point indexes that the overlapping
+   *     buffer may duplicate.
    * @param points Vector of indexes of points to be included.
    * @param leftPoints Indexes of points to be included in left child.
    * @param rightPoints Indexes of points to be included in right child.
@@ -463,9 +486,54 @@ class SpillTree
    */
   bool SplitPoints(const double tau,
                    const double rho,
+                   const size_t overlapBudget,
                    const arma::Col<size_t>& points,
                    arma::Col<size_t>& leftPoints,
                    arma::Col<size_t>& rightPoints);
+
+  /**
+   * Build the two children of this node.  The children of large nodes are
+   * built in parallel with OpenMP tasks, unless the splitting hyperplanes are
+   * chosen at random (as with ProjVector), since the trees could then differ
+   * from one run to the next.
+   *
+   * @param leftPoints Indexes of points to be included in left child.
+   * @param rightPoints Indexes of points to be included in right child.
+   * @param maxLeafSize Maximum number of points held in a leaf.
+   * @param tau Overlapping size.
+   * @param rho Balance threshold.
+   * @param leftBudget Overlap budget of the left child.
+   * @param rightBudget Overlap budget of the right child.
+   */
+  void BuildChildren(arma::Col<size_t>& leftPoints,
+                     arma::Col<size_t>& rightPoints,
+                     const size_t maxLeafSize,
+                     const double tau,
+                     const double rho,
+                     const size_t leftBudget,
+                     const size_t rightBudget);
+
+  /**
+   * Move the indexes of the points of every leaf (which each leaf holds on its
+   * own while the tree is built) into one buffer owned by this root node, and
+   * set the offset of every node into it.
+   *
+   * @param buildStatistics Whether to build the statistics of the nodes too.
+   */
+  void PackPoints(const bool buildStatistics);
+
+  /**
+   * Move the indexes of the points of the leaves of this subtree into the
+   * given buffer, starting at the given offset.
+   *
+   * @param buffer Buffer of point indexes shared by the whole tree.
+   * @param offset Offset of the next leaf's points in the buffer; this is
+   *     advanced past the points of this subtree.
+   * @param buildStatistics Whether to build the statistics of the nodes too.
+   */
+  void PackPoints(arma::Col<size_t>& buffer,
+                  size_t& offset,
+                  const bool buildStatistics);
  protected:
   /**
    * A default constructor.  This is meant to only be used with
@@ -489,6 +557,32 @@ class SpillTree
 } // namespace tree
 } // namespace mlpack
 
+//! Set the serialization version of the SpillTree class.  (This can't use
+//! BOOST_TEMPLATE_CLASS_VERSION, since SpillTree has more than one template
+//! parameter.)  Version 0 trees stored the point indexes of each leaf
+//! separately.
+namespace boost {
+namespace serialization {
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename HyperplaneMetricType> class HyperplaneType,
+         template<typename SplitMetricType, typename SplitMatType>
+             class SplitType>
+struct version<mlpack::tree::SpillTree<MetricType, StatisticType, MatType,
+    HyperplaneType, SplitType>>
+{
+  typedef mpl::int_<1> type;
+  typedef mpl::integral_c_tag tag;
+  BOOST_STATIC_CONSTANT(int, value = version::type::value);
+  BOOST_MPL_ASSERT((boost::mpl::less<boost::mpl::int_<1>,
+                    boost::mpl::int_<256>>));
+};
+
+} // namespace serialization
+} // namespace boost
+
 // Include implementation.
 #include "spill_tree_impl.hpp"
 
@@ -16,6 +16,10 @@
 
 #include <queue>
 
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
 namespace mlpack {
 namespace tree {
 
@@ -30,11 +34,13 @@ SpillTree(
     const MatType& data,
     const double tau,
     const size_t maxLeafSize,
-    const double rho) :
+    const double rho,
+    const size_t overlapBudget) :
     left(NULL),
     right(NULL),
     parent(NULL),
     count(0),
+    begin(0),
     pointsIndex(NULL),
     overlappingNode(false),
     hyperplane(),
@@ -50,10 +56,10 @@ SpillTree(
         dataset->n_cols);
 
   // Do the actual splitting of this node.
-  SplitNode(points, maxLeafSize, tau, rho);
+  SplitNode(points, maxLeafSize, tau, rho, overlapBudget);
 
-  // Create the statistic depending on if we are a leaf or not.
-  stat = StatisticType(*this);
+  // Gather the points of the leaves and create the statistics.
+  PackPoints(true);
 }
 
 template<typename MetricType,
@@ -67,11 +73,13 @@ SpillTree(
     MatType&& data,
     const double tau,
     const size_t maxLeafSize,
-    const double rho) :
+    const double rho,
+    const size_t overlapBudget) :
     left(NULL),
     right(NULL),
     parent(NULL),
     count(0),
+    begin(0),
     pointsIndex(NULL),
     overlappingNode(false),
     hyperplane(),
@@ -87,10 +95,10 @@ SpillTree(
         dataset->n_cols);
 
   // Do the actual splitting of this node.
-  SplitNode(points, maxLeafSize, tau, rho);
+  SplitNode(points, maxLeafSize, tau, rho, overlapBudget);
 
-  // Create the statistic depending on if we are a leaf or not.
-  stat = StatisticType(*this);
+  // Gather the points of the leaves and create the statistics.
+  PackPoints(true);
 }
 
 template<typename MetricType,
@@ -105,11 +113,13 @@ SpillTree(
     arma::Col<size_t>& points,
     const double tau,
     const size_t maxLeafSize,
-    const double rho) :
+    const double rho,
+    const size_t overlapBudget) :
     left(NULL),
     right(NULL),
     parent(parent),
     count(0),
+    begin(0),
     pointsIndex(NULL),
     overlappingNode(false),
     hyperplane(),
@@ -117,11 +127,9 @@ SpillTree(
     dataset(&parent->Dataset()), // Point to the parent's dataset.
     localDataset(false)
 {
-  // Perform the actual splitting.
-  SplitNode(points, maxLeafSize, tau, rho);
-
-  // Create the statistic depending on if we are a leaf or not.
-  stat = StatisticType(*this);
+  // Perform the actual splitting.  The statistic is created by the root, once
+  // the points of the leaves have been gathered.
+  SplitNode(points, maxLeafSize, tau, rho, overlapBudget);
 }
 
 /**
@@ -140,6 +148,7 @@ SpillTree(const SpillTree& other) :
     right(NULL),
     parent(other.parent),
     count(other.count),
+    begin(other.begin),
     pointsIndex(NULL),
     overlappingNode(other.overlappingNode),
     hyperplane(other.hyperplane),
@@ -166,12 +175,14 @@ SpillTree(const SpillTree& other) :
     right->Parent() = this; // Set parent to this, not other tree.
   }
 
-  // If vector of indexes, copy it.
-  if (other.pointsIndex)
+  // The root copies the buffer of point indexes; other nodes share it.
+  if (other.parent == NULL && other.pointsIndex)
     pointsIndex = new arma::Col<size_t>(*other.pointsIndex);
+  else
+    pointsIndex = other.pointsIndex;
 
-  // Propagate matrix, but only if we are the root.
-  if (parent == NULL && localDataset)
+  // Propagate matrix and indexes, but only if we are the root.
+  if (parent == NULL)
   {
     std::queue<SpillTree*> queue;
     if (left)
@@ -183,7 +194,9 @@ SpillTree(const SpillTree& other) :
       SpillTree* node = queue.front();
       queue.pop();
 
-      node->dataset = dataset;
+      node->pointsIndex = pointsIndex;
+      if (localDataset)
+        node->dataset = dataset;
       if (node->left)
         queue.push(node->left);
       if (node->right)
@@ -212,7 +225,8 @@ operator=(const SpillTree& other)
   if (localDataset)
     delete dataset;
 
-  delete pointsIndex;
+  if (!parent)
+    delete pointsIndex;
   delete left;
   delete right;
 
@@ -220,6 +234,7 @@ operator=(const SpillTree& other)
   right = NULL;
   parent = other.parent;
   count = other.count;
+  begin = other.begin;
   pointsIndex = NULL;
   overlappingNode = other.overlappingNode;
   hyperplane = other.hyperplane;
@@ -247,12 +262,14 @@ operator=(const SpillTree& other)
     right->Parent() = this; // Set parent to this, not other tree.
   }
 
-  // If vector of indexes, copy it.
-  if (other.pointsIndex)
+  // The root copies the buffer of point indexes; other nodes share it.
+  if (other.parent == NULL && other.pointsIndex)
     pointsIndex = new arma::Col<size_t>(*other.pointsIndex);
+  else
+    pointsIndex = other.pointsIndex;
 
-  // Propagate matrix, but only if we are the root.
-  if (parent == NULL && localDataset)
+  // Propagate matrix and indexes, but only if we are the root.
+  if (parent == NULL)
   {
     std::queue<SpillTree*> queue;
     if (left)
@@ -264,7 +281,9 @@ operator=(const SpillTree& other)
       SpillTree* node = queue.front();
       queue.pop();
 
-      node->dataset = dataset;
+      node->pointsIndex = pointsIndex;
+      if (localDataset)
+        node->dataset = dataset;
       if (node->left)
         queue.push(node->left);
       if (node->right)
@@ -289,6 +308,7 @@ SpillTree(SpillTree&& other) :
     right(other.right),
     parent(other.parent),
     count(other.count),
+    begin(other.begin),
     pointsIndex(other.pointsIndex),
     overlappingNode(other.overlappingNode),
     hyperplane(other.hyperplane),
@@ -305,6 +325,7 @@ SpillTree(SpillTree&& other) :
   other.left = NULL;
   other.right = NULL;
   other.count = 0;
+  other.begin = 0;
   other.pointsIndex = NULL;
   other.parentDistance = 0.0;
   other.furthestDescendantDistance = 0.0;
@@ -339,7 +360,8 @@ operator=(SpillTree&& other)
   if (localDataset)
     delete dataset;
 
-  delete pointsIndex;
+  if (!parent)
+    delete pointsIndex;
   delete left;
   delete right;
 
@@ -347,6 +369,7 @@ operator=(SpillTree&& other)
   right = other.right;
   parent = other.parent;
   count = other.count;
+  begin = other.begin;
   pointsIndex = other.pointsIndex;
   overlappingNode = other.overlappingNode;
   hyperplane = other.hyperplane;
@@ -363,6 +386,7 @@ operator=(SpillTree&& other)
   other.left = NULL;
   other.right = NULL;
   other.count = 0;
+  other.begin = 0;
   other.pointsIndex = NULL;
   other.parentDistance = 0.0;
   other.furthestDescendantDistance = 0.0;
@@ -416,9 +440,11 @@ SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
 {
   delete left;
   delete right;
-  delete pointsIndex;
 
-  // If we're the root and we own the dataset, delete it.
+  // If we're the root, we own the buffer of point indexes, and maybe the
+  // dataset.
+  if (!parent)
+    delete pointsIndex;
   if (!parent && localDataset)
     delete dataset;
 }
@@ -680,15 +706,8 @@ template<typename MetricType,
 inline size_t SpillTree<MetricType, StatisticType, MatType, HyperplaneType,
     SplitType>::Descendant(const size_t index) const
 {
-  if (IsLeaf())
-    return (*pointsIndex)[index];
-  size_t num = left->NumDescendants();
-  if (index < num)
-    return left->Descendant(index);
-  if (right)
-    return right->Descendant(index - num);
-  // This should never happen.
-  return (size_t() - 1);
+  // The descendants of every node are contiguous in the buffer.
+  return (*pointsIndex)[begin + index];
 }
 
 /**
@@ -704,7 +723,7 @@ inline size_t SpillTree<MetricType, StatisticType, MatType, HyperplaneType,
     SplitType>::Point(const size_t index) const
 {
   if (IsLeaf())
-    return (*pointsIndex)[index];
+    return (*pointsIndex)[begin + index];
   // This should never happen.
   return (size_t() - 1);
 }
@@ -719,7 +738,8 @@ void SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
     SplitNode(arma::Col<size_t>& points,
               const size_t maxLeafSize,
               const double tau,
-              const double rho)
+              const double rho,
+              const size_t overlapBudget)
 {
   // We need to expand the bounds of this node properly.
   for (size_t i = 0; i < points.n_elem; i++)
@@ -728,7 +748,8 @@ void SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
   // Calculate the furthest descendant distance.
   furthestDescendantDistance = 0.5 * bound.Diameter();
 
-  // Now, check if we need to split at all.
+  // Now, check if we need to split at all.  Until the root gathers the points
+  // of all the leaves, each leaf holds its own points.
   if (points.n_elem <= maxLeafSize)
   {
     pointsIndex = new arma::Col<size_t>();
@@ -751,15 +772,30 @@ void SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
 
   arma::Col<size_t> leftPoints, rightPoints;
   // Split the node.
-  overlappingNode = SplitPoints(tau, rho, points, leftPoints, rightPoints);
+  overlappingNode = SplitPoints(tau, rho, overlapBudget, points, leftPoints,
+      rightPoints);
 
   // We don't need the information in points, so lets clean it.
+  const size_t numPoints = points.n_elem;
   arma::Col<size_t>().swap(points);
 
+  // The rest of the budget is shared by the children in proportion to their
+  // sizes, so that it does not depend on the order the children are built in.
+  size_t leftBudget = overlapBudget;
+  size_t rightBudget = overlapBudget;
+  if (overlapBudget != std::numeric_limits<size_t>::max())
+  {
+    const size_t rest = overlapBudget -
+        (leftPoints.n_elem + rightPoints.n_elem - numPoints);
+    leftBudget = (size_t) ((double) rest * leftPoints.n_elem /
+        (leftPoints.n_elem + rightPoints.n_elem));
+    rightBudget = rest - leftBudget;
+  }
+
   // Now we will recursively split the children by calling their constructors
   // (which perform this splitting process).
-  left = new SpillTree(this, leftPoints, tau, maxLeafSize, rho);
-  right = new SpillTree(this, rightPoints, tau, maxLeafSize, rho);
+  BuildChildren(leftPoints, rightPoints, maxLeafSize, tau, rho, leftBudget,
+      rightBudget);
 
   // Update count number, to represent the number of descendant points.
   count = left->NumDescendants() + right->NumDescendants();
@@ -787,6 +823,7 @@ template<typename MetricType,
 bool SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
     SplitPoints(const double tau,
                 const double rho,
+                const size_t overlapBudget,
                 const arma::Col<size_t>& points,
                 arma::Col<size_t>& leftPoints,
                 arma::Col<size_t>& rightPoints)
@@ -816,8 +853,11 @@ bool SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
   const double p1 = (double) (left + rightFrontier) / points.n_elem;
   const double p2 = (double) (right + leftFrontier) / points.n_elem;
 
+  // The points of the overlapping buffer are held by both children, so the
+  // buffer is only used if the budget allows for them.
   if ((p1 <= rho || rightFrontier == 0) &&
-      (p2 <= rho || leftFrontier == 0))
+      (p2 <= rho || leftFrontier == 0) &&
+      leftFrontier + rightFrontier <= overlapBudget)
   {
     // Perform the actual splitting considering the overlapping buffer.  Points
     // with projection value in the range (-tau, tau) are included in both,
@@ -852,6 +892,113 @@ bool SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
   return false;
 }
 
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename HyperplaneMetricType> class HyperplaneType,
+         template<typename SplitMetricType, typename SplitMatType>
+             class SplitType>
+void SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
+    BuildChildren(arma::Col<size_t>& leftPoints,
+                  arma::Col<size_t>& rightPoints,
+                  const size_t maxLeafSize,
+                  const double tau,
+                  const double rho,
+                  const size_t leftBudget,
+                  const size_t rightBudget)
+{
+#if defined(HAS_OPENMP) && (_OPENMP >= 200805)
+  // Building the children of small nodes is too cheap to be worth a task.
+  // ProjVector hyperplanes are chosen with rand(), so those trees are always
+  // built serially.
+  const size_t minParallelSize = 4096;
+  if (std::is_same<typename HyperplaneType<MetricType>::ProjVectorType,
+                   AxisParallelProjVector>::value &&
+      leftPoints.n_elem + rightPoints.n_elem >= minParallelSize)
+  {
+    // omp_in_parallel() can't be used here: it stays false in an inactive
+    // region (one thread, or nested parallelism disabled), and every large
+    // node would open a new region.
+    if (omp_get_level() == 0)
+    {
+      // Start the threads that will build the rest of the tree.  The tasks are
+      // created by a single thread and picked up by all of the others.
+      #pragma omp parallel
+      {
+        #pragma omp single
+        BuildChildren(leftPoints, rightPoints, maxLeafSize, tau, rho,
+            leftBudget, rightBudget);
+      }
+      return;
+    }
+
+    // The children only read the dataset, and each leaf holds its own points
+    // until the tree is finished, so the children can be built at the same
+    // time.
+    #pragma omp task default(shared)
+    left = new SpillTree(this, leftPoints, tau, maxLeafSize, rho, leftBudget);
+
+    right = new SpillTree(this, rightPoints, tau, maxLeafSize, rho,
+        rightBudget);
+
+    #pragma omp taskwait
+    return;
+  }
+#endif
+
+  left = new SpillTree(this, leftPoints, tau, maxLeafSize, rho, leftBudget);
+  right = new SpillTree(this, rightPoints, tau, maxLeafSize, rho, rightBudget);
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename HyperplaneMetricType> class HyperplaneType,
+         template<typename SplitMetricType, typename SplitMatType>
+             class SplitType>
+void SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
+    PackPoints(const bool buildStatistics)
+{
+  // The number of descendants of the root counts every point once per leaf
+  // that holds it.
+  arma::Col<size_t>* buffer = new arma::Col<size_t>(count);
+  size_t offset = 0;
+  PackPoints(*buffer, offset, buildStatistics);
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename HyperplaneMetricType> class HyperplaneType,
+         template<typename SplitMetricType, typename SplitMatType>
+             class SplitType>
+void SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
+    PackPoints(arma::Col<size_t>& buffer,
+               size_t& offset,
+               const bool buildStatistics)
+{
+  begin = offset;
+  if (IsLeaf())
+  {
+    // Move the points of the leaf to the buffer and free its own copy.
+    if (count > 0)
+      buffer.subvec(offset, offset + count - 1) = *pointsIndex;
+    offset += count;
+    delete pointsIndex;
+  }
+  else
+  {
+    left->PackPoints(buffer, offset, buildStatistics);
+    right->PackPoints(buffer, offset, buildStatistics);
+  }
+
+  pointsIndex = &buffer;
+
+  // Create the statistic depending on if we are a leaf or not.
+  if (buildStatistics)
+    stat = StatisticType(*this);
+}
+
 // Default constructor (private), for boost::serialization.
 template<typename MetricType,
          typename StatisticType,
@@ -865,6 +1012,7 @@ SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
     right(NULL),
     parent(NULL),
     count(0),
+    begin(0),
     pointsIndex(NULL),
     overlappingNode(false),
     stat(*this),
@@ -887,7 +1035,7 @@ template<typename MetricType,
              class SplitType>
 template<typename Archive>
 void SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
-    serialize(Archive& ar, const unsigned int /* version */)
+    serialize(Archive& ar, const unsigned int version)
 {
   // If we're loading, and we have children, they need to be deleted.
   if (Archive::is_loading::value)
@@ -896,16 +1044,26 @@ void SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
       delete left;
     if (right)
       delete right;
+    if (!parent)
+      delete pointsIndex;
     if (!parent && localDataset)
       delete dataset;
 
     parent = NULL;
     left = NULL;
     right = NULL;
+    pointsIndex = NULL;
   }
 
+  // Every node points to the buffer of point indexes of the root, so it is
+  // only stored once.  Before version 1, each leaf stored its own points and
+  // the other nodes stored NULL.
   ar & BOOST_SERIALIZATION_NVP(count);
   ar & BOOST_SERIALIZATION_NVP(pointsIndex);
+  if (version > 0)
+    ar & BOOST_SERIALIZATION_NVP(begin);
+  else
+    begin = 0;
   ar & BOOST_SERIALIZATION_NVP(overlappingNode);
   ar & BOOST_SERIALIZATION_NVP(hyperplane);
   ar & BOOST_SERIALIZATION_NVP(bound);
@@ -942,6 +1100,10 @@ void SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
       right->parent = this;
       right->localDataset = false;
     }
+
+    // Gather the points of the leaves of old trees into one buffer.
+    if (version == 0 && parent == NULL)
+      PackPoints(false);
   }
 }
 
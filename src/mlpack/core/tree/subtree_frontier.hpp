@@ -0,0 +1,73 @@
+/**
+ * @file core/tree/subtree_frontier.hpp
+ *
+ * A utility function that splits a tree into a set of disjoint subtrees, which
+ * is useful for parallelizing traversals over independent parts of a tree.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_SUBTREE_FRONTIER_HPP
+#define MLPACK_CORE_TREE_SUBTREE_FRONTIER_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace tree /** Trees and tree-building procedures. */ {
+
+/**
+ * Split the tree rooted at the given node into a set of disjoint subtrees.  The
+ * largest non-leaf node in the frontier (by number of descendants) is replaced
+ * by its children until the frontier holds at least minSubtrees nodes or only
+ * leaves remain.  Because the descendant points of the children of a node
+ * partition the descendant points of that node, every point in the tree is a
+ * descendant of exactly one node in the resulting frontier, and so each of
+ * these subtrees can be handled independently (e.g., by different threads).
+ *
+ * This requires that a node does not hold any point that is not also held by
+ * one of its children; this is true for every tree type in mlpack except for
+ * spill trees with overlapping nodes.
+ *
+ * @param root Root of the tree to split.
+ * @param minSubtrees Minimum number of subtrees to split the tree into.
+ * @param frontier Vector to store the roots of the subtrees in.
+ */
+template<typename TreeType>
+void SubtreeFrontier(TreeType& root,
+                     const size_t minSubtrees,
+                     std::vector<TreeType*>& frontier)
+{
+  frontier.clear();
+  frontier.push_back(&root);
+
+  while (frontier.size() < minSubtrees)
+  {
+    // Find the largest node that can still be split.
+    size_t largest = frontier.size();
+    for (size_t i = 0; i < frontier.size(); ++i)
+    {
+      if (frontier[i]->NumChildren() == 0)
+        continue;
+
+      if (largest == frontier.size() ||
+          frontier[i]->NumDescendants() > frontier[largest]->NumDescendants())
+        largest = i;
+    }
+
+    // Only leaves are left, so we can't split any further.
+    if (largest == frontier.size())
+      break;
+
+    TreeType* node = frontier[largest];
+    frontier[largest] = &node->Child(0);
+    for (size_t i = 1; i < node->NumChildren(); ++i)
+      frontier.push_back(&node->Child(i));
+  }
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
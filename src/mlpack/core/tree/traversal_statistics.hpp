@@ -0,0 +1,238 @@
+/**
+ * @file core/tree/traversal_statistics.hpp
+ *
+ * Definition of TraversalStatistics, which holds the counts of the work done by
+ * a tree traversal, and of CountingRules, which wraps the rules of any
+ * tree-based method to collect them.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_TRAVERSAL_STATISTICS_HPP
+#define MLPACK_CORE_TREE_TRAVERSAL_STATISTICS_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "batch_base_case.hpp"
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The work done by one or more tree traversals: the number of base cases and
+ * scores computed, the number of node combinations that were pruned (split by
+ * the depth of the reference node), and the number of reference leaves whose
+ * points were visited.  These are the numbers to look at when tuning the leaf
+ * size and the type of tree for a dataset.
+ */
+struct TraversalStatistics
+{
+  //! Create empty statistics.
+  TraversalStatistics() : baseCases(0), scores(0), prunes(0), leafVisits(0)
+  { /* Nothing to do. */ }
+
+  //! Add the counts of the given statistics to these.
+  TraversalStatistics& operator+=(const TraversalStatistics& other)
+  {
+    baseCases += other.baseCases;
+    scores += other.scores;
+    prunes += other.prunes;
+    leafVisits += other.leafVisits;
+
+    if (prunesPerDepth.size() < other.prunesPerDepth.size())
+      prunesPerDepth.resize(other.prunesPerDepth.size(), 0);
+    for (size_t i = 0; i < other.prunesPerDepth.size(); ++i)
+      prunesPerDepth[i] += other.prunesPerDepth[i];
+
+    return *this;
+  }
+
+  //! Reset every count to zero.
+  void Reset() { *this = TraversalStatistics(); }
+
+  /**
+   * Print the statistics on one line, such as "Traversal statistics: 120 base
+   * cases, 45 scores, 12 prunes (by reference depth: 2: 5, 3: 7), 9 reference
+   * leaf visits."
+   *
+   * @param stream Stream to print to (usually Log::Info).
+   */
+  template<typename StreamType>
+  void Print(StreamType& stream) const
+  {
+    stream << "Traversal statistics: " << baseCases << " base cases, "
+        << scores << " scores, " << prunes << " prunes";
+    bool first = true;
+    for (size_t i = 0; i < prunesPerDepth.size(); ++i)
+    {
+      if (prunesPerDepth[i] == 0)
+        continue;
+
+      stream << (first ? " (by reference depth: " : ", ") << i << ": "
+          << prunesPerDepth[i];
+      first = false;
+    }
+    stream << (first ? "" : ")") << ", " << leafVisits
+        << " reference leaf visits." << std::endl;
+  }
+
+  //! The number of base cases.
+  size_t baseCases;
+  //! The number of calls to Score().
+  size_t scores;
+  //! The number of calls to Score() or Rescore() that pruned.
+  size_t prunes;
+  //! The number of prunes by the depth (distance from the root) of the
+  //! reference node.
+  std::vector<size_t> prunesPerDepth;
+  //! The number of calls to Score() with a reference leaf that did not prune.
+  size_t leafVisits;
+};
+
+/**
+ * A wrapper around the rules of a tree-based method that collects
+ * TraversalStatistics.  The wrapper forwards every call of the traverser to
+ * the wrapped rules and counts it, so any traverser can be used with it, and
+ * the wrapped rules still hold the results of the traversal afterwards.
+ *
+ * @code
+ * RuleType rules(...);
+ * TraversalStatistics statistics;
+ * CountingRules<RuleType> countingRules(rules, statistics);
+ * typename TreeType::template DualTreeTraverser<CountingRules<RuleType>>
+ *     traverser(countingRules);
+ * traverser.Traverse(queryTree, referenceTree);
+ * @endcode
+ *
+ * @tparam RuleType Type of the rules to wrap.
+ */
+template<typename RuleType>
+class CountingRules
+{
+ public:
+  //! The traversal information of the wrapped rules.
+  typedef typename RuleType::TraversalInfoType TraversalInfoType;
+
+  /**
+   * Wrap the given rules.  Both the rules and the statistics must outlive the
+   * wrapper, and the counts are added to the statistics.
+   *
+   * @param rules Rules to wrap.
+   * @param statistics Statistics to add the counts to.
+   */
+  CountingRules(RuleType& rules, TraversalStatistics& statistics) :
+      rules(rules),
+      statistics(statistics)
+  { /* Nothing to do. */ }
+
+  //! Compute the base case between the given query and reference points.
+  double BaseCase(const size_t queryIndex, const size_t referenceIndex)
+  {
+    ++statistics.baseCases;
+    return rules.BaseCase(queryIndex, referenceIndex);
+  }
+
+  //! Compute the base cases between the given query point and the reference
+  //! points referenceBegin, ..., referenceBegin + referenceCount - 1.
+  void BatchBaseCase(const size_t queryIndex,
+                     const size_t referenceBegin,
+                     const size_t referenceCount)
+  {
+    statistics.baseCases += referenceCount;
+    tree::BatchBaseCase(rules, queryIndex, referenceBegin, referenceCount);
+  }
+
+  //! Score the given query point and reference node.
+  template<typename TreeType>
+  double Score(const size_t queryIndex, TreeType& referenceNode)
+  {
+    return Count(rules.Score(queryIndex, referenceNode), referenceNode);
+  }
+
+  //! Score the given query node and reference node.
+  template<typename TreeType>
+  double Score(TreeType& queryNode, TreeType& referenceNode)
+  {
+    return Count(rules.Score(queryNode, referenceNode), referenceNode);
+  }
+
+  //! Rescore the given query point and reference node.
+  template<typename TreeType>
+  double Rescore(const size_t queryIndex,
+                 TreeType& referenceNode,
+                 const double oldScore)
+  {
+    return CountPrune(rules.Rescore(queryIndex, referenceNode, oldScore),
+        referenceNode);
+  }
+
+  //! Rescore the given query node and reference node.
+  template<typename TreeType>
+  double Rescore(TreeType& queryNode,
+                 TreeType& referenceNode,
+                 const double oldScore)
+  {
+    return CountPrune(rules.Rescore(queryNode, referenceNode, oldScore),
+        referenceNode);
+  }
+
+  //! Get the best child to descend into (for defeatist traversals).
+  template<typename... Args>
+  size_t GetBestChild(Args&&... args)
+  {
+    return rules.GetBestChild(std::forward<Args>(args)...);
+  }
+
+  //! Get the traversal information of the wrapped rules.
+  const TraversalInfoType& TraversalInfo() const
+  { return rules.TraversalInfo(); }
+  //! Modify the traversal information of the wrapped rules.
+  TraversalInfoType& TraversalInfo() { return rules.TraversalInfo(); }
+
+  //! Get the wrapped rules.
+  const RuleType& Rules() const { return rules; }
+  //! Modify the wrapped rules.
+  RuleType& Rules() { return rules; }
+
+ private:
+  //! Count a call to Score() with the given result.
+  template<typename TreeType>
+  double Count(const double score, const TreeType& referenceNode)
+  {
+    ++statistics.scores;
+    if (score != DBL_MAX && referenceNode.IsLeaf())
+      ++statistics.leafVisits;
+    return CountPrune(score, referenceNode);
+  }
+
+  //! Count a prune, if the given score is one.
+  template<typename TreeType>
+  double CountPrune(const double score, const TreeType& referenceNode)
+  {
+    if (score != DBL_MAX)
+      return score;
+
+    size_t depth = 0;
+    for (const TreeType* node = referenceNode.Parent(); node != NULL;
+         node = node->Parent())
+      ++depth;
+
+    ++statistics.prunes;
+    if (statistics.prunesPerDepth.size() <= depth)
+      statistics.prunesPerDepth.resize(depth + 1, 0);
+    ++statistics.prunesPerDepth[depth];
+
+    return score;
+  }
+
+  //! The wrapped rules.
+  RuleType& rules;
+  //! The statistics to add the counts to.
+  TraversalStatistics& statistics;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,127 @@
+/**
+ * @file core/util/async_log_sink.cpp
+ *
+ * Implementation of the AsyncLogSink class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "async_log_sink.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+using namespace mlpack;
+using namespace mlpack::util;
+
+AsyncLogSink::AsyncLogSink(const size_t capacity) :
+    enqueuePosition(0),
+    written(0),
+    stopping(false)
+{
+  size_t size = 2;
+  while (size < capacity)
+    size *= 2;
+
+  slots.reset(new Slot[size]);
+  mask = size - 1;
+  for (size_t i = 0; i < size; ++i)
+    slots[i].sequence.store(i, std::memory_order_relaxed);
+
+  writer = std::thread(&AsyncLogSink::Write, this);
+}
+
+AsyncLogSink::~AsyncLogSink()
+{
+  stopping.store(true, std::memory_order_release);
+  writer.join();
+}
+
+void AsyncLogSink::Push(std::ostream& destination, std::string&& text)
+{
+  // Claim the slot at the next position.  If it is still full, the queue is
+  // full, and we have to wait for the writer thread.
+  size_t position = enqueuePosition.load(std::memory_order_relaxed);
+  Slot* slot;
+  while (true)
+  {
+    slot = &slots[position & mask];
+    const size_t sequence = slot->sequence.load(std::memory_order_acquire);
+    if (sequence == position)
+    {
+      if (enqueuePosition.compare_exchange_weak(position, position + 1,
+          std::memory_order_relaxed))
+        break;
+    }
+    else
+    {
+      if (sequence < position)
+        std::this_thread::yield();
+      position = enqueuePosition.load(std::memory_order_relaxed);
+    }
+  }
+
+  slot->destination = &destination;
+  slot->text = std::move(text);
+  slot->sequence.store(position + 1, std::memory_order_release);
+}
+
+void AsyncLogSink::Flush()
+{
+  const size_t target = enqueuePosition.load(std::memory_order_acquire);
+  while (written.load(std::memory_order_acquire) < target)
+    std::this_thread::yield();
+}
+
+void AsyncLogSink::Write()
+{
+  size_t position = 0;
+  size_t idle = 0;
+  std::vector<std::ostream*> destinations;
+  while (true)
+  {
+    Slot& slot = slots[position & mask];
+    if (slot.sequence.load(std::memory_order_acquire) == position + 1)
+    {
+      slot.destination->write(slot.text.data(), slot.text.size());
+      if (std::find(destinations.begin(), destinations.end(),
+          slot.destination) == destinations.end())
+        destinations.push_back(slot.destination);
+
+      // Free the slot for the push that will be one lap later.
+      slot.text.clear();
+      slot.sequence.store(position + mask + 1, std::memory_order_release);
+      ++position;
+      idle = 0;
+      continue;
+    }
+
+    // The queue is empty: flush what was written, and only then report it as
+    // written, so that Flush() returns once the output is visible.
+    if (!destinations.empty())
+    {
+      for (size_t i = 0; i < destinations.size(); ++i)
+        destinations[i]->flush();
+      destinations.clear();
+      written.store(position, std::memory_order_release);
+    }
+
+    if (stopping.load(std::memory_order_acquire))
+    {
+      // Text may have been pushed just before stopping was set.
+      if (slots[position & mask].sequence.load(std::memory_order_acquire) ==
+          position + 1)
+        continue;
+      break;
+    }
+
+    // Spin for a while before sleeping, since log output tends to come in
+    // bursts.
+    if (++idle < 64)
+      std::this_thread::yield();
+    else
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+}
@@ -0,0 +1,102 @@
+/**
+ * @file core/util/async_log_sink.hpp
+ *
+ * Declaration of the AsyncLogSink class, which writes log output from a
+ * background thread.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_UTIL_ASYNC_LOG_SINK_HPP
+#define MLPACK_CORE_UTIL_ASYNC_LOG_SINK_HPP
+
+#include <atomic>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace mlpack {
+namespace util {
+
+/**
+ * An AsyncLogSink takes text to be written to an ostream and writes it from a
+ * background thread, so that the threads that log don't wait for the output
+ * (and don't contend for the ostream).  The text is passed through a bounded
+ * lock-free queue: Push() only has to claim a slot of the queue, unless the
+ * queue is full, in which case it waits for the writer thread.  The text of
+ * all the calls to Push() is written in the order in which the slots were
+ * claimed, and the ostreams are flushed whenever the queue is empty.
+ *
+ * A PrefixedOutStream whose sink is set sends its output to the sink; this is
+ * what Log::EnableAsync() does for the Log streams.
+ */
+class AsyncLogSink
+{
+ public:
+  /**
+   * Start the writer thread.
+   *
+   * @param capacity Number of pieces of text the queue can hold (rounded up to
+   *     a power of two).
+   */
+  AsyncLogSink(const size_t capacity = 4096);
+
+  //! Write all the text that was pushed, and stop the writer thread.
+  ~AsyncLogSink();
+
+  /**
+   * Queue the given text to be written to the given ostream.  This can be
+   * called from any number of threads at the same time.
+   *
+   * @param destination Stream to write the text to.
+   * @param text Text to write.
+   */
+  void Push(std::ostream& destination, std::string&& text);
+
+  /**
+   * Wait until all the text that was pushed before the call is written and the
+   * ostreams are flushed.
+   */
+  void Flush();
+
+  //! Get the number of pieces of text the queue can hold.
+  size_t Capacity() const { return mask + 1; }
+
+ private:
+  //! A slot of the queue.
+  struct Slot
+  {
+    //! Position of the queue the slot is ready for: it is free for the push at
+    //! this position, and holds text when it is one more than the position.
+    std::atomic<size_t> sequence;
+    //! Stream to write the text to.
+    std::ostream* destination;
+    //! Text to write.
+    std::string text;
+  };
+
+  //! The function run by the writer thread.
+  void Write();
+
+  //! The slots of the queue.
+  std::unique_ptr<Slot[]> slots;
+  //! Capacity of the queue minus one (the capacity is a power of two).
+  size_t mask;
+  //! Position of the next push.
+  std::atomic<size_t> enqueuePosition;
+  //! Number of pieces of text written (and flushed).
+  std::atomic<size_t> written;
+  //! Set to stop the writer thread.
+  std::atomic<bool> stopping;
+  //! The writer thread.
+  std::thread writer;
+};
+
+} // namespace util
+} // namespace mlpack
+
+#endif
@@ -13,6 +13,7 @@
 #include <boost/program_options.hpp>
 #include <boost/scoped_ptr.hpp>
 #include <iostream>
+#include <mutex>
 
 #include "cli.hpp"
 #include "log.hpp"
@@ -30,6 +31,12 @@ using namespace mlpack::util;
 static ProgramDoc emptyProgramDoc = ProgramDoc("", "", []() { return ""; },
     {});
 
+// The CLI object of the active context of this thread, if any.
+static thread_local CLI* currentContext = NULL;
+
+// Protects the stored settings, which are shared by all contexts.
+static std::mutex storageMutex;
+
 /* Constructors, Destructors, Copy */
 /* Make the constructor private, to preclude unauthorized instances */
 CLI::CLI() : didParse(false), doc(&emptyProgramDoc)
@@ -156,13 +163,47 @@ void CLI::MakeInPlaceCopy(const std::string& outputParamName,
   }
 }
 
-// Returns the sole instance of this class.
+// Returns the instance of this class for the current thread.
 CLI& CLI::GetSingleton()
+{
+  return (currentContext != NULL) ? *currentContext : GlobalSingleton();
+}
+
+// Returns the instance of this class that is used outside of contexts.
+CLI& CLI::GlobalSingleton()
 {
   static CLI singleton;
   return singleton;
 }
 
+CLI::ScopedContext::ScopedContext() :
+    context(new CLI()),
+    previous(currentContext),
+    infoSettings(Log::Info),
+    previousRandomState(math::CurrentThreadRandomState())
+{
+  context->doc = GlobalSingleton().doc;
+  context->programName = GlobalSingleton().programName;
+  currentContext = context;
+
+  {
+    // Other threads may be creating contexts too.
+    static std::mutex seedMutex;
+    std::lock_guard<std::mutex> lock(seedMutex);
+    randomState.generator.seed(math::RandGen()());
+    randomState.streamSeed = (previousRandomState == NULL) ?
+        math::randStreamSeed : previousRandomState->streamSeed;
+  }
+  math::CurrentThreadRandomState() = &randomState;
+}
+
+CLI::ScopedContext::~ScopedContext()
+{
+  math::CurrentThreadRandomState() = previousRandomState;
+  currentContext = previous;
+  delete context;
+}
+
 /**
  * Registers a ProgramDoc object, which contains documentation about the
  * program.
@@ -213,9 +254,15 @@ void CLI::StoreSettings(const std::string& name)
 {
   // Take all of the parameters and put them in the map.  Clear anything old
   // first.
-  std::get<0>(GetSingleton().storageMap[name]) = GetSingleton().parameters;
-  std::get<1>(GetSingleton().storageMap[name]) = GetSingleton().aliases;
-  std::get<2>(GetSingleton().storageMap[name]) = GetSingleton().functionMap;
+  {
+    std::lock_guard<std::mutex> lock(storageMutex);
+    std::map<std::string, std::tuple<std::map<std::string, util::ParamData>,
+        std::map<char, std::string>, FunctionMapType>>& storageMap =
+        GlobalSingleton().storageMap;
+    std::get<0>(storageMap[name]) = GetSingleton().parameters;
+    std::get<1>(storageMap[name]) = GetSingleton().aliases;
+    std::get<2>(storageMap[name]) = GetSingleton().functionMap;
+  }
 
   ClearSettings();
 }
@@ -223,21 +270,26 @@ void CLI::StoreSettings(const std::string& name)
 // Restore settings.
 void CLI::RestoreSettings(const std::string& name, const bool fatal)
 {
-  if (GetSingleton().storageMap.count(name) == 0 && fatal)
+  std::unique_lock<std::mutex> lock(storageMutex);
+  std::map<std::string, std::tuple<std::map<std::string, util::ParamData>,
+      std::map<char, std::string>, FunctionMapType>>& storageMap =
+      GlobalSingleton().storageMap;
+  if (storageMap.count(name) == 0 && fatal)
   {
     throw std::invalid_argument("no settings stored under the name '" + name
         + "'");
   }
-  else if (GetSingleton().storageMap.count(name) == 0 && !fatal)
+  else if (storageMap.count(name) == 0 && !fatal)
   {
     // Nothing to do, just clear what's there.
+    lock.unlock();
     ClearSettings();
   }
   else
   {
-    GetSingleton().parameters = std::get<0>(GetSingleton().storageMap[name]);
-    GetSingleton().aliases = std::get<1>(GetSingleton().storageMap[name]);
-    GetSingleton().functionMap = std::get<2>(GetSingleton().storageMap[name]);
+    GetSingleton().parameters = std::get<0>(storageMap[name]);
+    GetSingleton().aliases = std::get<1>(storageMap[name]);
+    GetSingleton().functionMap = std::get<2>(storageMap[name]);
   }
 }
 
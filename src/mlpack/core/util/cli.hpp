@@ -22,6 +22,7 @@
 #include <boost/any.hpp>
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/random.hpp>
 
 #include "timers.hpp"
 #include "program_doc.hpp"
@@ -234,7 +235,9 @@ class CLI
    * as there is no point in defining static methods only to have users call
    * private instance methods.
    *
-   * @return The singleton instance for use in the static methods.
+   * @return The singleton instance for use in the static methods.  If a
+   *     ScopedContext is active on the calling thread, this is the CLI object
+   *     of that context.
    */
   static CLI& GetSingleton();
 
@@ -288,6 +291,48 @@ class CLI
    */
   static void ClearSettings();
 
+  /**
+   * While a ScopedContext exists, the parameters, function mappings and timers
+   * of the thread that created it are held in a CLI object of its own instead
+   * of in the singleton, so that several bindings can be run at once by
+   * different threads (as long as each thread has its own context).  Settings
+   * stored with StoreSettings() are shared by all contexts, so the usual
+   * sequence is to create a context, restore the settings of a program with
+   * RestoreSettings(), set the parameters, and run the program.  Contexts must
+   * be destroyed in the reverse order they were created in, by the same thread.
+   *
+   * The verbosity of Log::Info (see PrefixedOutStream::SetIgnoreInput()) and
+   * the random generators of mlpack::math (see math::RandomSeed()) are also
+   * local to the thread while the context exists, so a program that is run in
+   * a context can be seeded without affecting programs run by other threads.
+   * The generator of a new context is seeded from the global generator.
+   */
+  class ScopedContext
+  {
+   public:
+    //! Make a new, empty context the current one of this thread.
+    ScopedContext();
+    //! Destroy the context, and make the previous one current again.
+    ~ScopedContext();
+
+    //! A context belongs to one scope, so it can't be copied.
+    ScopedContext(const ScopedContext& other) = delete;
+    //! A context belongs to one scope, so it can't be copied.
+    ScopedContext& operator=(const ScopedContext& other) = delete;
+
+   private:
+    //! The CLI object that holds the state of this context.
+    CLI* context;
+    //! The CLI object that was current before this context was created.
+    CLI* previous;
+    //! The verbosity of Log::Info in the thread while the context exists.
+    util::PrefixedOutStream::ThreadSettings infoSettings;
+    //! The random generators of the thread while the context exists.
+    math::ThreadRandomState randomState;
+    //! The random state that the thread used before this context was created.
+    math::ThreadRandomState* previousRandomState;
+  };
+
  private:
   //! Convenience map from alias values to names.
   std::map<char, std::string> aliases;
@@ -324,6 +369,10 @@ class CLI
   util::ProgramDoc* doc;
 
  private:
+  //! Get the CLI object that is used when no context is active; it also holds
+  //! the stored settings of all contexts.
+  static CLI& GlobalSingleton();
+
   /**
    * Make the constructor private, to preclude unauthorized instances.
    */
@@ -18,6 +18,57 @@
 using namespace mlpack;
 using namespace mlpack::util;
 
+namespace {
+
+// The sink of the Log streams, if their output is asynchronous.
+AsyncLogSink* logSink = NULL;
+
+// Set the sink of all the Log streams.
+void SetLogSink(AsyncLogSink* sink)
+{
+#ifdef DEBUG
+  Log::Debug.sink = sink;
+#endif
+  Log::Info.sink = sink;
+  Log::Warn.sink = sink;
+  Log::Fatal.sink = sink;
+}
+
+// Make sure the queued output is written at the end of the program.
+void DisableAsyncAtExit()
+{
+  Log::DisableAsync();
+}
+
+} // anonymous namespace
+
+void Log::EnableAsync(const size_t capacity)
+{
+  if (logSink != NULL)
+    return;
+
+  static bool registered = false;
+  if (!registered)
+  {
+    std::atexit(&DisableAsyncAtExit);
+    registered = true;
+  }
+
+  logSink = new AsyncLogSink(capacity);
+  SetLogSink(logSink);
+}
+
+void Log::DisableAsync()
+{
+  if (logSink == NULL)
+    return;
+
+  // The destructor of the sink writes the queued output.
+  SetLogSink(NULL);
+  delete logSink;
+  logSink = NULL;
+}
+
 // Only do anything for Assert() if in debugging mode.
 #ifdef DEBUG
 void Log::Assert(bool condition, const std::string& message)
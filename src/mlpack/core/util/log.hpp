@@ -49,7 +49,11 @@ namespace mlpack {
  *
  * Any messages sent to Log::Debug will not be shown when compiling in non-debug
  * mode.  Messages to Log::Info will only be shown when the --verbose flag is
- * given to the program (or rather, the CLI class).
+ * given to the program (or rather, the CLI class).  Output to a stream that is
+ * not shown is not even formatted.
+ *
+ * When much output is logged (from many threads, for instance), it can be
+ * written from a background thread instead, by calling Log::EnableAsync().
  *
  * @see PrefixedOutStream, NullOutStream, CLI
  */
@@ -64,6 +68,25 @@ class Log
   static void Assert(bool condition,
                      const std::string& message = "Assert Failed.");
 
+  /**
+   * Write the output of Log::Debug, Log::Info and Log::Warn from a background
+   * thread, through an AsyncLogSink, until DisableAsync() is called (or the
+   * program ends).  The output of Log::Fatal is still written immediately,
+   * after all the output that was queued.  Note that a single Log stream
+   * should still not be written to from several threads at once.
+   *
+   * @param capacity Number of outputs that can be queued before writing to a
+   *     Log stream waits for the background thread.
+   */
+  static void EnableAsync(const size_t capacity = 4096);
+
+  /**
+   * Write all the queued output, stop the background thread and go back to
+   * writing output immediately.  This does nothing if EnableAsync() was not
+   * called.
+   */
+  static void DisableAsync();
+
   /**
    * MLPACK_EXPORT is required for global variables, so that they are properly
    * exported by the Windows compiler.
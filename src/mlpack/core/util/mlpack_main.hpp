@@ -89,11 +89,41 @@ static const std::string testName = "";
 #include <mlpack/core/util/param.hpp>
 #include <mlpack/bindings/cli/parse_command_line.hpp>
 #include <mlpack/bindings/cli/end_program.hpp>
+#include <mlpack/bindings/cli/serve.hpp>
+#include <mlpack/bindings/cli/stream.hpp>
+
+#undef BINDING_STREAMING_INPUT
+#define BINDING_STREAMING_INPUT(ID) \
+    static mlpack::bindings::cli::StreamingInput \
+    cli_streaming_input_dummy_object(ID)
 
 static void mlpackMain(); // This is typically defined after this include.
 
 int main(int argc, char** argv)
 {
+  // In server mode, the program runs the requests it reads from stdin.
+  if (mlpack::bindings::cli::ServeRequested(argc, argv))
+  {
+    mlpack::bindings::cli::Serve(mlpackMain);
+    return 0;
+  }
+
+  // In streaming mode, the program runs on chunks of its streamed input.
+  size_t chunkSize = 0;
+  try
+  {
+    chunkSize = mlpack::bindings::cli::StreamChunkSize(argc, argv);
+  }
+  catch (std::invalid_argument& e)
+  {
+    mlpack::Log::Fatal << e.what() << "." << std::endl;
+  }
+  if (chunkSize > 0)
+  {
+    mlpack::bindings::cli::Stream(mlpackMain, chunkSize, argc, argv);
+    return 0;
+  }
+
   // Parse the command-line options; put them into CLI.
   mlpack::bindings::cli::ParseCommandLine(argc, argv);
   // Enable timing.
@@ -73,6 +73,17 @@ using DatasetInfo = DatasetMapper<IncrementPolicy, std::string>;
     cli_programdoc_dummy_object = mlpack::util::ProgramDoc(NAME, SHORT_DESC, \
     []() { return DESC; }, { __VA_ARGS__ } )
 
+/**
+ * Declare that the given matrix input parameter can be streamed: the program
+ * handles each point of it independently, so it can be run on chunks of the
+ * points, one after another.  Only the command-line programs use this (with
+ * the --stream_chunk_size option); for other bindings it does nothing.  At
+ * most one instance of this macro should be present in a program.
+ *
+ * @param ID Name of the matrix input parameter.
+ */
+#define BINDING_STREAMING_INPUT(ID) static_assert(true, ID)
+
 /**
  * Define a flag parameter.
  *
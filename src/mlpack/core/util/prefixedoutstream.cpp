@@ -14,8 +14,51 @@
 
 #include "prefixedoutstream.hpp"
 
+#ifdef HAS_BFD_DL
+  #include "backtrace.hpp"
+#endif
+
 using namespace mlpack::util;
 
+// The innermost ThreadSettings object of this thread, if any.
+static thread_local PrefixedOutStream::ThreadSettings* currentSettings = NULL;
+
+PrefixedOutStream::ThreadSettings::ThreadSettings(PrefixedOutStream& stream) :
+    stream(stream),
+    ignoreInput(stream.IgnoreInput()),
+    previous(currentSettings)
+{
+  currentSettings = this;
+}
+
+PrefixedOutStream::ThreadSettings::~ThreadSettings()
+{
+  currentSettings = previous;
+}
+
+bool PrefixedOutStream::IgnoreInput() const
+{
+  for (const ThreadSettings* s = currentSettings; s != NULL; s = s->previous)
+    if (&s->stream == this)
+      return s->ignoreInput;
+
+  return ignoreInput;
+}
+
+void PrefixedOutStream::SetIgnoreInput(const bool ignore)
+{
+  for (ThreadSettings* s = currentSettings; s != NULL; s = s->previous)
+  {
+    if (&s->stream == this)
+    {
+      s->ignoreInput = ignore;
+      return;
+    }
+  }
+
+  ignoreInput = ignore;
+}
+
 /**
  * These are all necessary because gcc's template mechanism does not seem smart
  * enough to figure out what I want to pass into operator<< without these.  That
@@ -125,3 +168,68 @@ PrefixedOutStream& PrefixedOutStream::operator<<(
   BaseLogic<std::ios_base& (*)(std::ios_base&)>(pf);
   return *this;
 }
+
+bool PrefixedOutStream::AppendLines(const std::string& line,
+                                    std::string& output)
+{
+  bool newlined = false;
+  size_t nl;
+  size_t pos = 0;
+  while ((nl = line.find('\n', pos)) != std::string::npos)
+  {
+    PrefixIfNeeded(output);
+    output.append(line, pos, nl - pos + 1);
+
+    newlined = true; // Ensure this is set for the fatal exception if needed.
+    carriageReturned = true; // Regardless of whether or not we display it.
+
+    pos = nl + 1;
+  }
+
+  if (pos != line.length()) // We need to display the rest.
+  {
+    PrefixIfNeeded(output);
+    output.append(line, pos, std::string::npos);
+  }
+
+  return newlined;
+}
+
+void PrefixedOutStream::Emit(std::string& output, const bool newlined)
+{
+  // If we displayed a newline and we need to throw afterwards, add a blank line
+  // and a backtrace (if we can).
+  if (fatal && newlined)
+  {
+    output += '\n';
+
+#ifdef HAS_BFD_DL
+    if (backtrace)
+    {
+      Backtrace bt;
+      AppendLines(bt.ToString(), output);
+    }
+#endif
+  }
+
+  if (!IgnoreInput() && !output.empty())
+  {
+    if (sink != NULL && !fatal)
+    {
+      sink->Push(destination, std::move(output));
+    }
+    else
+    {
+      // Anything that was queued before must be written first.
+      if (sink != NULL)
+        sink->Flush();
+
+      destination << output;
+      if (newlined)
+        destination.flush();
+    }
+  }
+
+  if (fatal && newlined)
+    throw std::runtime_error("fatal error; see Log::Fatal output");
+}
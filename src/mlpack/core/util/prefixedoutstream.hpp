@@ -14,6 +14,7 @@
 #define MLPACK_CORE_UTIL_PREFIXEDOUTSTREAM_HPP
 
 #include <mlpack/prereqs.hpp>
+#include "async_log_sink.hpp"
 
 namespace mlpack {
 namespace util {
@@ -42,6 +43,12 @@ namespace util {
  *
  * These objects are used for the mlpack::Log levels (DEBUG, INFO, WARN, and
  * FATAL).
+ *
+ * The output of each call to operator<< is formatted and written at once.  When
+ * ignoreInput is set, nothing is formatted at all.  If a sink is given, the
+ * output is passed to its writer thread instead of being written to the
+ * destination directly (except for fatal streams, which only wait for the
+ * sink to write its output first).
  */
 class PrefixedOutStream
 {
@@ -65,6 +72,7 @@ class PrefixedOutStream
       destination(destination),
       ignoreInput(ignoreInput),
       backtrace(backtrace),
+      sink(NULL),
       prefix(prefix),
       // We want the first call to operator<< to prefix the prefix so we set
       // carriageReturned to true.
@@ -111,16 +119,60 @@ class PrefixedOutStream
   template<typename T>
   PrefixedOutStream& operator<<(const T& s);
 
+  /**
+   * While an object of this class exists, the thread that created it has its
+   * own value of ignoreInput for the given stream, so that a thread can mute or
+   * unmute the stream (with SetIgnoreInput()) without affecting the others.
+   * The value starts as the ignoreInput value of the stream.  Objects must be
+   * destroyed in the reverse order they were created in, by the same thread.
+   */
+  class ThreadSettings
+  {
+   public:
+    //! Give the calling thread its own value of ignoreInput for the stream.
+    ThreadSettings(PrefixedOutStream& stream);
+    //! Make the calling thread use the previous value again.
+    ~ThreadSettings();
+
+    //! The settings are tied to the thread, so they can't be copied.
+    ThreadSettings(const ThreadSettings& other) = delete;
+    //! The settings are tied to the thread, so they can't be copied.
+    ThreadSettings& operator=(const ThreadSettings& other) = delete;
+
+   private:
+    friend class PrefixedOutStream;
+
+    //! The stream these settings apply to.
+    const PrefixedOutStream& stream;
+    //! Whether the stream discards the input of the thread.
+    bool ignoreInput;
+    //! The settings that were innermost in the thread before these.
+    ThreadSettings* previous;
+  };
+
+  //! Return whether the stream discards input written by the calling thread.
+  bool IgnoreInput() const;
+  //! Set whether the stream discards input: for the calling thread only, if a
+  //! ThreadSettings object for the stream exists in it, and otherwise for all
+  //! threads.
+  void SetIgnoreInput(const bool ignore);
+
   //! The output stream that all data is to be sent to; example: std::cout.
   std::ostream& destination;
 
-  //! Discards input, prints nothing if true.
+  //! Discards input, prints nothing if true.  While a ThreadSettings object
+  //! for this stream exists in a thread, that thread uses its own value
+  //! instead (see IgnoreInput() and SetIgnoreInput()).
   bool ignoreInput;
 
   //! If true, on a fatal error, a backtrace will be printed if HAS_BFD_DL is
   //! defined.
   bool backtrace;
 
+  //! If not NULL, output is written asynchronously by this sink (which is not
+  //! owned by the stream).
+  AsyncLogSink* sink;
+
  private:
   /**
    * Conducts the base logic required in all the operator << overloads.  Mostly
@@ -151,9 +203,32 @@ class PrefixedOutStream
   BaseLogic(const T& val);
 
   /**
-   * Output the prefix, but only if we need to and if we are allowed to.
+   * Append the prefix to the output, but only if we need to and if we are
+   * allowed to.
+   *
+   * @param output Output of the current call.
+   */
+  inline void PrefixIfNeeded(std::string& output);
+
+  /**
+   * Append the given text to the output, prefixing each of its lines as
+   * necessary.
+   *
+   * @param line Text to append.
+   * @param output Output of the current call.
+   * @return Whether the text contains a newline.
+   */
+  bool AppendLines(const std::string& line, std::string& output);
+
+  /**
+   * Write the output of the current call (to the sink or to the destination),
+   * and, for a fatal stream that displayed a newline, print a backtrace and
+   * throw.
+   *
+   * @param output Output of the current call.
+   * @param newlined Whether the output contains a newline.
    */
-  inline void PrefixIfNeeded();
+  void Emit(std::string& output, const bool newlined);
 
   //! Contains the prefix we must prepend to each line.
   std::string prefix;
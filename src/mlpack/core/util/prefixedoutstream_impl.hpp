@@ -16,10 +16,6 @@
 // Just in case it hasn't been included.
 #include "prefixedoutstream.hpp"
 
-#ifdef HAS_BFD_DL
-  #include "backtrace.hpp"
-#endif
-
 #include <iostream>
 #include <sstream>
 
@@ -38,13 +34,20 @@ template<typename T>
 typename std::enable_if<!arma::is_arma_type<T>::value>::type
 PrefixedOutStream::BaseLogic(const T& val)
 {
+  // If the stream is muted, there is no need to format anything (but a fatal
+  // stream must still terminate).
+  if (IgnoreInput() && !fatal)
+    return;
+
   // We will use this to track whether or not we need to terminate at the end of
   // this call (only for streams which terminate after a newline).
   bool newlined = false;
-  std::string line;
+
+  // All the output of this call is collected, and written at once.
+  std::string output;
 
   // If we need to, output the prefix.
-  PrefixIfNeeded();
+  PrefixIfNeeded(output);
 
   std::ostringstream convert;
   // Sync flags and precision with destination stream
@@ -54,91 +57,40 @@ PrefixedOutStream::BaseLogic(const T& val)
 
   if (convert.fail())
   {
-    PrefixIfNeeded();
-    if (!ignoreInput)
+    if (!IgnoreInput())
     {
-      destination << "Failed type conversion to string for output; output not "
-          "shown." << std::endl;
+      output += "Failed type conversion to string for output; output not "
+          "shown.\n";
       newlined = true;
     }
   }
   else
   {
-    line = convert.str();
+    const std::string line = convert.str();
 
     // If the length of the casted thing was 0, it may have been a stream
     // manipulator, so send it directly to the stream and don't ask questions.
     if (line.length() == 0)
     {
+      Emit(output, false);
+
       // The prefix cannot be necessary at this point.
-      if (!ignoreInput) // Only if the user wants it.
+      if (!IgnoreInput()) // Only if the user wants it.
+      {
+        // The writer thread of the sink must not be using the stream.
+        if (sink != NULL)
+          sink->Flush();
         destination << val;
+      }
 
       return;
     }
 
     // Now, we need to check for newlines in the output and print it.
-    size_t nl;
-    size_t pos = 0;
-    while ((nl = line.find('\n', pos)) != std::string::npos)
-    {
-      PrefixIfNeeded();
-
-      // Only output if the user wants it.
-      if (!ignoreInput)
-      {
-        destination << line.substr(pos, nl - pos);
-        destination << std::endl;
-      }
-
-      newlined = true; // Ensure this is set for the fatal exception if needed.
-      carriageReturned = true; // Regardless of whether or not we display it.
-
-      pos = nl + 1;
-    }
-
-    if (pos != line.length()) // We need to display the rest.
-    {
-      PrefixIfNeeded();
-      if (!ignoreInput)
-        destination << line.substr(pos);
-    }
+    newlined = AppendLines(line, output);
   }
 
-  // If we displayed a newline and we need to throw afterwards, do that.
-  if (fatal && newlined)
-  {
-    if (!ignoreInput)
-      destination << std::endl;
-
-    // Print a backtrace, if we can.
-#ifdef HAS_BFD_DL
-    if (fatal && !ignoreInput && backtrace)
-    {
-      size_t nl;
-      size_t pos = 0;
-
-      Backtrace bt;
-      std::string btLine = bt.ToString();
-      while ((nl = btLine.find('\n', pos)) != std::string::npos)
-      {
-        PrefixIfNeeded();
-
-        if (!ignoreInput)
-        {
-          destination << btLine.substr(pos, nl - pos);
-          destination << std::endl;
-        }
-
-        carriageReturned = true; // Regardless of whether or not we display it.
-
-        pos = nl + 1;
-      }
-    }
-#endif
-
-    throw std::runtime_error("fatal error; see Log::Fatal output");
-  }
+  Emit(output, newlined);
 }
 
 // For Armadillo types.
@@ -146,16 +98,23 @@ template<typename T>
 typename std::enable_if<arma::is_arma_type<T>::value>::type
 PrefixedOutStream::BaseLogic(const T& val)
 {
+  // If the stream is muted, there is no need to format anything (but a fatal
+  // stream must still terminate).
+  if (IgnoreInput() && !fatal)
+    return;
+
   // Extract printable object from the input.
   const arma::Mat<typename T::elem_type>& printVal(val);
 
   // We will use this to track whether or not we need to terminate at the end of
   // this call (only for streams which terminate after a newline).
   bool newlined = false;
-  std::string line;
+
+  // All the output of this call is collected, and written at once.
+  std::string output;
 
   // If we need to, output the prefix.
-  PrefixIfNeeded();
+  PrefixIfNeeded(output);
 
   std::ostringstream convert;
 
@@ -187,101 +146,50 @@ PrefixedOutStream::BaseLogic(const T& val)
 
   if (convert.fail())
   {
-    PrefixIfNeeded();
-    if (!ignoreInput)
+    if (!IgnoreInput())
     {
-      destination << "Failed type conversion to string for output; output not "
-          "shown." << std::endl;
+      output += "Failed type conversion to string for output; output not "
+          "shown.\n";
       newlined = true;
     }
   }
   else
   {
-    line = convert.str();
+    const std::string line = convert.str();
 
     // If the length of the casted thing was 0, it may have been a stream
     // manipulator, so send it directly to the stream and don't ask questions.
     if (line.length() == 0)
     {
+      Emit(output, false);
+
       // The prefix cannot be necessary at this point.
-      if (!ignoreInput) // Only if the user wants it.
+      if (!IgnoreInput()) // Only if the user wants it.
+      {
+        // The writer thread of the sink must not be using the stream.
+        if (sink != NULL)
+          sink->Flush();
         destination << val;
+      }
 
       return;
     }
 
     // Now, we need to check for newlines in the output and print it.
-    size_t nl;
-    size_t pos = 0;
-    while ((nl = line.find('\n', pos)) != std::string::npos)
-    {
-      PrefixIfNeeded();
-
-      // Only output if the user wants it.
-      if (!ignoreInput)
-      {
-        destination << line.substr(pos, nl - pos);
-        destination << std::endl;
-      }
-
-      newlined = true; // Ensure this is set for the fatal exception if needed.
-      carriageReturned = true; // Regardless of whether or not we display it.
-
-      pos = nl + 1;
-    }
-
-    if (pos != line.length()) // We need to display the rest.
-    {
-      PrefixIfNeeded();
-      if (!ignoreInput)
-        destination << line.substr(pos);
-    }
+    newlined = AppendLines(line, output);
   }
 
-  // If we displayed a newline and we need to throw afterwards, do that.
-  if (fatal && newlined)
-  {
-    if (!ignoreInput)
-      destination << std::endl;
-
-    // Print a backtrace, if we can.
-#ifdef HAS_BFD_DL
-    if (fatal && !ignoreInput)
-    {
-      size_t nl;
-      size_t pos = 0;
-
-      Backtrace bt;
-      std::string btLine = bt.ToString();
-      while ((nl = btLine.find('\n', pos)) != std::string::npos)
-      {
-        PrefixIfNeeded();
-
-        if (!ignoreInput)
-        {
-          destination << btLine.substr(pos, nl - pos);
-          destination << std::endl;
-        }
-
-        carriageReturned = true; // Regardless of whether or not we display it.
-
-        pos = nl + 1;
-      }
-    }
-#endif
-
-    throw std::runtime_error("fatal error; see Log::Fatal output");
-  }
+  Emit(output, newlined);
 }
 
 // This is an inline function (that is why it is here and not in .cc).
-void PrefixedOutStream::PrefixIfNeeded()
+void PrefixedOutStream::PrefixIfNeeded(std::string& output)
 {
   // If we need to, output a prefix.
   if (carriageReturned)
   {
-    if (!ignoreInput) // But only if we are allowed to.
-      destination << prefix;
+    if (!IgnoreInput()) // But only if we are allowed to.
+      output += prefix;
 
     carriageReturned = false; // Denote that the prefix has been displayed.
   }
@@ -0,0 +1,287 @@
+/**
+ * @file core/util/profiler.cpp
+ *
+ * Implementation of the Profiler.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "profiler.hpp"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+using namespace mlpack;
+using namespace std;
+using namespace chrono;
+
+namespace {
+
+//! A span that was closed, for the Chrome trace.
+struct ProfileEvent
+{
+  //! The full name of the span.
+  string name;
+  //! The time the span was opened at, since the epoch of the profiler.
+  microseconds start;
+  //! The time the span was open for.
+  microseconds duration;
+};
+
+//! Everything that one thread records.  Only that thread modifies it.
+struct ThreadProfile
+{
+  //! Index of the thread, in the order the threads started profiling.
+  size_t id;
+  //! The full names and starting times of the open spans.
+  vector<pair<string, steady_clock::time_point>> stack;
+  //! The summary of each span name.
+  unordered_map<string, ProfileStat> spans;
+  //! The value of each counter.
+  unordered_map<string, uint64_t> counters;
+  //! Every span that was closed, if events are recorded.
+  vector<ProfileEvent> events;
+};
+
+//! The state shared by all threads.
+struct ProfilerState
+{
+  ProfilerState() : enabled(false), recordEvents(false),
+      epoch(steady_clock::now()) { }
+
+  //! Whether profiling is enabled.
+  atomic<bool> enabled;
+  //! Whether each span is recorded for the Chrome trace.
+  atomic<bool> recordEvents;
+  //! The time that the events are relative to.
+  steady_clock::time_point epoch;
+  //! A mutex for adding threads to the profiles.
+  mutex profilesMutex;
+  //! The profile of every thread that has recorded anything.  The profiles are
+  //! shared with the threads, so that they outlive the threads.
+  vector<shared_ptr<ThreadProfile>> profiles;
+};
+
+ProfilerState& State()
+{
+  static ProfilerState state;
+  return state;
+}
+
+//! Get the profile of the current thread, registering it on the first call.
+ThreadProfile& LocalProfile()
+{
+  static thread_local shared_ptr<ThreadProfile> profile;
+  if (!profile)
+  {
+    profile = make_shared<ThreadProfile>();
+
+    ProfilerState& state = State();
+    lock_guard<mutex> lock(state.profilesMutex);
+    profile->id = state.profiles.size();
+    state.profiles.push_back(profile);
+  }
+
+  return *profile;
+}
+
+//! Get the full name of a span or counter opened in the given profile.
+string FullName(const ThreadProfile& profile, const string& name)
+{
+  if (profile.stack.empty())
+    return name;
+  return profile.stack.back().first + "/" + name;
+}
+
+//! Write the given string as a JSON string.
+void WriteJSONString(ostream& stream, const string& str)
+{
+  stream << '"';
+  for (const char c : str)
+  {
+    if (c == '"' || c == '\\')
+      stream << '\\' << c;
+    else if (c == '\n')
+      stream << "\\n";
+    else if (c == '\t')
+      stream << "\\t";
+    else if ((unsigned char) c < 0x20)
+      stream << ' ';
+    else
+      stream << c;
+  }
+  stream << '"';
+}
+
+} // anonymous namespace
+
+void Profiler::Enable(const bool recordEvents)
+{
+  State().recordEvents = recordEvents;
+  State().enabled = true;
+}
+
+void Profiler::Disable()
+{
+  State().enabled = false;
+}
+
+bool Profiler::Enabled()
+{
+  return State().enabled.load(memory_order_relaxed);
+}
+
+void Profiler::Reset()
+{
+  // The profiles themselves are kept, since the threads still point to them;
+  // so are the open spans, so that they can still be closed.
+  ProfilerState& state = State();
+  lock_guard<mutex> lock(state.profilesMutex);
+  for (shared_ptr<ThreadProfile>& profile : state.profiles)
+  {
+    profile->spans.clear();
+    profile->counters.clear();
+    profile->events.clear();
+  }
+  state.epoch = steady_clock::now();
+}
+
+void Profiler::AddCount(const string& name, const uint64_t count)
+{
+  if (!Enabled())
+    return;
+
+  ThreadProfile& profile = LocalProfile();
+  profile.counters[FullName(profile, name)] += count;
+}
+
+map<string, ProfileStat> Profiler::Spans()
+{
+  ProfilerState& state = State();
+  lock_guard<mutex> lock(state.profilesMutex);
+
+  map<string, ProfileStat> spans;
+  for (const shared_ptr<ThreadProfile>& profile : state.profiles)
+  {
+    for (const auto& span : profile->spans)
+    {
+      ProfileStat& stat = spans.insert(make_pair(span.first,
+          ProfileStat { 0, microseconds(0) })).first->second;
+      stat.calls += span.second.calls;
+      stat.total += span.second.total;
+    }
+  }
+
+  return spans;
+}
+
+map<string, uint64_t> Profiler::Counters()
+{
+  ProfilerState& state = State();
+  lock_guard<mutex> lock(state.profilesMutex);
+
+  map<string, uint64_t> counters;
+  for (const shared_ptr<ThreadProfile>& profile : state.profiles)
+    for (const auto& counter : profile->counters)
+      counters[counter.first] += counter.second;
+
+  return counters;
+}
+
+void Profiler::ExportJSON(ostream& stream)
+{
+  const map<string, ProfileStat> spans = Spans();
+  const map<string, uint64_t> counters = Counters();
+
+  stream << "{\n  \"spans\": {";
+  for (auto it = spans.begin(); it != spans.end(); ++it)
+  {
+    stream << (it == spans.begin() ? "\n    " : ",\n    ");
+    WriteJSONString(stream, it->first);
+    stream << ": { \"calls\": " << it->second.calls << ", \"total_us\": "
+        << it->second.total.count() << " }";
+  }
+  stream << "\n  },\n  \"counters\": {";
+  for (auto it = counters.begin(); it != counters.end(); ++it)
+  {
+    stream << (it == counters.begin() ? "\n    " : ",\n    ");
+    WriteJSONString(stream, it->first);
+    stream << ": " << it->second;
+  }
+  stream << "\n  }\n}\n";
+}
+
+void Profiler::ExportChromeTrace(ostream& stream)
+{
+  const map<string, uint64_t> counters = Counters();
+
+  ProfilerState& state = State();
+  lock_guard<mutex> lock(state.profilesMutex);
+
+  const microseconds end = duration_cast<microseconds>(steady_clock::now() -
+      state.epoch);
+
+  bool first = true;
+  stream << "{ \"traceEvents\": [";
+  for (const shared_ptr<ThreadProfile>& profile : state.profiles)
+  {
+    for (const ProfileEvent& event : profile->events)
+    {
+      stream << (first ? "\n  " : ",\n  ") << "{ \"name\": ";
+      WriteJSONString(stream, event.name);
+      stream << ", \"ph\": \"X\", \"ts\": " << event.start.count()
+          << ", \"dur\": " << event.duration.count() << ", \"pid\": 0, "
+          << "\"tid\": " << profile->id << " }";
+      first = false;
+    }
+  }
+
+  for (const auto& counter : counters)
+  {
+    stream << (first ? "\n  " : ",\n  ") << "{ \"name\": ";
+    WriteJSONString(stream, counter.first);
+    stream << ", \"ph\": \"C\", \"ts\": " << end.count() << ", \"pid\": 0, "
+        << "\"args\": { \"value\": " << counter.second << " } }";
+    first = false;
+  }
+  stream << "\n], \"displayTimeUnit\": \"ms\" }\n";
+}
+
+void Profiler::Open(const string& name)
+{
+  ThreadProfile& profile = LocalProfile();
+  string fullName = FullName(profile, name);
+  profile.stack.push_back(make_pair(std::move(fullName), steady_clock::now()));
+}
+
+void Profiler::Close()
+{
+  const steady_clock::time_point now = steady_clock::now();
+
+  ThreadProfile& profile = LocalProfile();
+  if (profile.stack.empty())
+    return;
+
+  const pair<string, steady_clock::time_point>& span = profile.stack.back();
+  const microseconds duration = duration_cast<microseconds>(now -
+      span.second);
+
+  ProfileStat& stat = profile.spans.insert(make_pair(span.first,
+      ProfileStat { 0, microseconds(0) })).first->second;
+  ++stat.calls;
+  stat.total += duration;
+
+  if (State().recordEvents)
+  {
+    const microseconds start = duration_cast<microseconds>(span.second -
+        State().epoch);
+    profile.events.push_back(ProfileEvent { span.first, start, duration });
+  }
+
+  profile.stack.pop_back();
+}
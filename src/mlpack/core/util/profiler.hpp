@@ -0,0 +1,169 @@
+/**
+ * @file core/util/profiler.hpp
+ *
+ * A hierarchical, thread-aware profiler for mlpack: scoped spans with nested
+ * names and named counters, which can be exported as JSON or in the Chrome
+ * trace format.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_UTILITIES_PROFILER_HPP
+#define MLPACK_CORE_UTILITIES_PROFILER_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <string>
+
+namespace mlpack {
+
+/**
+ * The summary of all the spans with the same name.
+ */
+struct ProfileStat
+{
+  //! The number of times a span with this name was closed.
+  size_t calls;
+  //! The total time spent in the spans with this name.
+  std::chrono::microseconds total;
+};
+
+/**
+ * The Profiler records where the time of a program goes, at a finer grain than
+ * Timer.  Time is recorded with ProfileSpan objects, which time the scope they
+ * live in; a span opened while another span of the same thread is open gets
+ * the name of its parent as a prefix, so opening "traversal" inside "knn" gives
+ * the span "knn/traversal".  Counters (such as the number of base cases
+ * computed by a traversal) are added with AddCount().
+ *
+ * Each thread records its spans and counters in its own buffers, so no lock is
+ * taken while profiling (except once, the first time a thread records
+ * anything).  The buffers of all threads are merged when they are reported,
+ * which must not be done while other threads are still profiling.
+ *
+ * The profiler is disabled by default, and a disabled profiler only costs a
+ * check of a flag per span or counter.
+ *
+ * @code
+ * Profiler::Enable();
+ * {
+ *   ProfileSpan span("knn");
+ *   ... // Work that will be recorded as "knn".
+ * }
+ * Profiler::ExportChromeTrace(stream);
+ * @endcode
+ */
+class Profiler
+{
+ public:
+  /**
+   * Enable profiling.  Spans and counters are recorded until Disable() is
+   * called.
+   *
+   * @param recordEvents Whether to record every span (with the time it started
+   *     at and its thread) for ExportChromeTrace(), in addition to the
+   *     summary of each name.  This takes memory for every span that is
+   *     closed.
+   */
+  static void Enable(const bool recordEvents = true);
+
+  //! Disable profiling.  What has been recorded so far is kept.
+  static void Disable();
+
+  //! Get whether profiling is enabled.
+  static bool Enabled();
+
+  /**
+   * Remove all the recorded spans and counters of all threads.  This must not
+   * be called while other threads are profiling.
+   */
+  static void Reset();
+
+  /**
+   * Add to the given counter of the current thread.  The counter is prefixed
+   * with the name of the innermost open span of the thread, like the name of
+   * a span.
+   *
+   * @param name Name of the counter.
+   * @param count Value to add to the counter.
+   */
+  static void AddCount(const std::string& name, const uint64_t count = 1);
+
+  //! Get the summary of each span name, merged over all threads.
+  static std::map<std::string, ProfileStat> Spans();
+
+  //! Get the value of each counter, summed over all threads.
+  static std::map<std::string, uint64_t> Counters();
+
+  /**
+   * Write the summary of the spans and the counters, merged over all threads,
+   * as a JSON object with the members "spans" and "counters".
+   *
+   * @param stream Stream to write to.
+   */
+  static void ExportJSON(std::ostream& stream);
+
+  /**
+   * Write every recorded span as a complete event of the Chrome trace format,
+   * so that it can be opened with chrome://tracing or a compatible viewer.
+   * Each thread that recorded spans gets its own track, and the counters are
+   * written as counter events at the end of the trace.  Spans are only
+   * recorded individually when Enable() is called with recordEvents = true.
+   *
+   * @param stream Stream to write to.
+   */
+  static void ExportChromeTrace(std::ostream& stream);
+
+ private:
+  friend class ProfileSpan;
+
+  //! Open a span with the given name on the current thread.
+  static void Open(const std::string& name);
+  //! Close the innermost open span of the current thread.
+  static void Close();
+};
+
+/**
+ * A span of the Profiler: the time between the construction and the
+ * destruction of the object is recorded under the given name (prefixed with
+ * the names of the open spans of the same thread).  Nothing is recorded if the
+ * profiler is disabled when the span is created.
+ */
+class ProfileSpan
+{
+ public:
+  /**
+   * Open the span.
+   *
+   * @param name Name of the span.
+   */
+  explicit ProfileSpan(const std::string& name) : open(Profiler::Enabled())
+  {
+    if (open)
+      Profiler::Open(name);
+  }
+
+  //! Close the span.
+  ~ProfileSpan()
+  {
+    if (open)
+      Profiler::Close();
+  }
+
+  //! A span times a scope, so it can't be copied.
+  ProfileSpan(const ProfileSpan& other) = delete;
+  //! A span times a scope, so it can't be copied.
+  ProfileSpan& operator=(const ProfileSpan& other) = delete;
+
+ private:
+  //! Whether the span was opened (that is, the profiler was enabled).
+  bool open;
+};
+
+} // namespace mlpack
+
+#endif // MLPACK_CORE_UTILITIES_PROFILER_HPP
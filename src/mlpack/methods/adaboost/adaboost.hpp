@@ -71,7 +71,12 @@ namespace adaboost {
  * @endcode
  *
  * For more information on and examples of weak learners, see
- * perceptron::Perceptron<> and decision_stump::DecisionStump<>.
+ * perceptron::Perceptron<>, tree::ID3DecisionStump, and tree::DecisionTree<>
+ * (whose numeric splits use the instance weights).
+ *
+ * With OpenMP, the weight updates of each boosting round and the voting in
+ * Classify() are done in parallel over the points, as is prediction with the
+ * weak learners above.
  *
  * @tparam MatType Data matrix type (i.e. arma::mat or arma::sp_mat).
  * @tparam WeakLearnerType Type of weak learner to use.
@@ -28,9 +28,45 @@
 
 #include "adaboost.hpp"
 
+#include <mlpack/core/util/sfinae_utility.hpp>
+
 namespace mlpack {
 namespace adaboost {
 
+HAS_MEM_FUNC(Presort, HasPresortCheck);
+
+/**
+ * 'value' is true if the WeakLearnerType class has a member
+ * void Presort(const MatType& data), which prepares it to be trained on the
+ * same data in every boosting round.
+ */
+template<typename WeakLearnerType, typename MatType>
+struct HasPresort
+{
+  static const bool value = HasPresortCheck<WeakLearnerType,
+      void(WeakLearnerType::*)(const MatType&)>::value;
+};
+
+//! Prepare the weak learner for the boosting rounds on the given data.
+template<typename WeakLearnerType, typename MatType>
+void Presort(WeakLearnerType& weakLearner,
+             const MatType& data,
+             const typename std::enable_if_t<
+                 HasPresort<WeakLearnerType, MatType>::value>* = 0)
+{
+  weakLearner.Presort(data);
+}
+
+//! Do nothing, since the weak learner has nothing to prepare.
+template<typename WeakLearnerType, typename MatType>
+void Presort(WeakLearnerType& /* weakLearner */,
+             const MatType& /* data */,
+             const typename std::enable_if_t<
+                 !HasPresort<WeakLearnerType, MatType>::value>* = 0)
+{
+  // Nothing to do.
+}
+
 /**
  * Constructor. Currently runs the AdaBoost.MH algorithm.
  *
@@ -87,9 +123,6 @@ double AdaBoost<WeakLearnerType, MatType>::Train(
   // To be used for prediction by the weak learner.
   arma::Row<size_t> predictedLabels(labels.n_cols);
 
-  // Use tempData to modify input data for incorporating weights.
-  MatType tempData(data);
-
   // This matrix is a helper matrix used to calculate the final hypothesis.
   arma::mat sumFinalH = arma::zeros<arma::mat>(numClasses,
       predictedLabels.n_cols);
@@ -105,6 +138,11 @@ double AdaBoost<WeakLearnerType, MatType>::Train(
   // This is the final hypothesis.
   arma::Row<size_t> finalH(predictedLabels.n_cols);
 
+  // Every round trains on the same data, so weak learners that can (like
+  // DecisionStump) sort it once here.
+  WeakLearnerType learner(other);
+  Presort(learner, data);
+
   // Now, start the boosting rounds.
   for (size_t i = 0; i < iterations; i++)
   {
@@ -120,19 +158,21 @@ double AdaBoost<WeakLearnerType, MatType>::Train(
     weights = arma::sum(D);
 
     // Use the existing weak learner to train a new one with new weights.
-    WeakLearnerType w(other, tempData, labels, numClasses, weights);
-    w.Classify(tempData, predictedLabels);
+    WeakLearnerType w(learner, data, labels, numClasses, weights);
+    w.Classify(data, predictedLabels);
 
     // Now from predictedLabels, build ht, the weak hypothesis
-    // buildClassificationMatrix(ht, predictedLabels);
+    // buildClassificationMatrix(ht, predictedLabels).  The column sums of D
+    // are already in weights.
 
     // Now, calculate alpha(t) using ht.
-    for (size_t j = 0; j < D.n_cols; j++) // instead of D, ht
+    #pragma omp parallel for reduction(+:rt)
+    for (omp_size_t j = 0; j < (omp_size_t) D.n_cols; j++) // instead of D, ht
     {
       if (predictedLabels(j) == labels(j))
-        rt += arma::accu(D.col(j));
+        rt += weights(j);
       else
-        rt -= arma::accu(D.col(j));
+        rt -= weights(j);
     }
 
     if ((i > 0) && (std::abs(rt - crt) < tolerance))
@@ -156,10 +196,12 @@ double AdaBoost<WeakLearnerType, MatType>::Train(
     alpha.push_back(alphat);
     wl.push_back(w);
 
-    // Now start modifying the weights.
-    for (size_t j = 0; j < D.n_cols; j++)
+    // Now start modifying the weights; each point is independent of the
+    // others.
+    const double expo = exp(alphat);
+    #pragma omp parallel for reduction(+:zt)
+    for (omp_size_t j = 0; j < (omp_size_t) D.n_cols; j++)
     {
-      const double expo = exp(alphat);
       if (predictedLabels(j) == labels(j))
       {
         for (size_t k = 0; k < D.n_rows; k++)
@@ -234,18 +276,18 @@ void AdaBoost<WeakLearnerType, MatType>::Classify(
   {
     wl[i].Classify(test, tempPredictedLabels);
 
-    for (size_t j = 0; j < tempPredictedLabels.n_cols; j++)
+    #pragma omp parallel for
+    for (omp_size_t j = 0; j < (omp_size_t) tempPredictedLabels.n_cols; j++)
       probabilities(tempPredictedLabels(j), j) += alpha[i];
   }
 
-  arma::colvec pRow;
-  arma::uword maxIndex = 0;
-
-  for (size_t i = 0; i < predictedLabels.n_cols; i++)
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) predictedLabels.n_cols; i++)
   {
     probabilities.col(i) /= arma::accu(probabilities.col(i));
-    pRow = probabilities.unsafe_col(i);
-    pRow.max(maxIndex);
+
+    arma::uword maxIndex = 0;
+    probabilities.unsafe_col(i).max(maxIndex);
     predictedLabels(i) = maxIndex;
   }
 }
@@ -25,6 +25,7 @@
 #include <mlpack/methods/amf/update_rules/svd_batch_learning.hpp>
 #include <mlpack/methods/amf/update_rules/svd_incomplete_incremental_learning.hpp>
 #include <mlpack/methods/amf/update_rules/svd_complete_incremental_learning.hpp>
+#include <mlpack/methods/amf/update_rules/weighted_als.hpp>
 
 #include <mlpack/methods/amf/init_rules/random_init.hpp>
 #include <mlpack/methods/amf/init_rules/random_acol_init.hpp>
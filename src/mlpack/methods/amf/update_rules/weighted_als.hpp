@@ -0,0 +1,238 @@
+/**
+ * @file methods/amf/update_rules/weighted_als.hpp
+ *
+ * Weighted alternating least squares update rule for sparse rating matrices,
+ * for use in AMF (Alternating Matrix Factorization).
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_AMF_UPDATE_RULES_WEIGHTED_ALS_HPP
+#define MLPACK_METHODS_AMF_UPDATE_RULES_WEIGHTED_ALS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace amf {
+
+/**
+ * This class implements weighted alternating least squares for sparse rating
+ * matrices.  Unlike NMFALSUpdate, which fits every entry of V (including the
+ * zeros of a sparse matrix), each column of H and each row of W is the
+ * solution of its own small regularized least squares problem, and these
+ * problems are solved in parallel with OpenMP.
+ *
+ * With explicit feedback, only the nonzero entries of V are fit, and the
+ * regularization of each row or column is weighted by its number of ratings,
+ * as in the following paper:
+ *
+ * @code
+ * @inproceedings{zhou2008large,
+ *   title={Large-scale Parallel Collaborative Filtering for the Netflix
+ *       Prize},
+ *   author={Zhou, Yunhong and Wilkinson, Dennis and Schreiber, Robert and
+ *       Pan, Rong},
+ *   booktitle={Algorithmic Aspects in Information and Management},
+ *   pages={337--348},
+ *   year={2008}
+ * }
+ * @endcode
+ *
+ * \f[
+ * h_u = (W_u^T W_u + \lambda n_u I)^{-1} W_u^T v_u,
+ * \f]
+ *
+ * where \f$ W_u \f$ holds the rows of W of the items rated by user u.  With
+ * implicit feedback, every entry is fit to a preference of 1 (nonzero) or 0
+ * (zero), with confidence \f$ 1 + \alpha v_{iu} \f$, as in the following
+ * paper:
+ *
+ * @code
+ * @inproceedings{hu2008collaborative,
+ *   title={Collaborative Filtering for Implicit Feedback Datasets},
+ *   author={Hu, Yifan and Koren, Yehuda and Volinsky, Chris},
+ *   booktitle={2008 Eighth IEEE International Conference on Data Mining},
+ *   pages={263--272},
+ *   year={2008}
+ * }
+ * @endcode
+ *
+ * The cost of an update is still linear in the number of nonzero entries,
+ * since \f$ W^T W \f$ is computed once per update.  The update rule keeps a
+ * transposed copy of V, so that the rows of V can be visited quickly.
+ */
+class WeightedALSUpdate
+{
+ public:
+  /**
+   * Create the update rule with the given parameters.
+   *
+   * @param lambda Regularization parameter.
+   * @param implicit Whether the entries of V are implicit feedback.
+   * @param alpha Confidence of the nonzero entries, for implicit feedback.
+   */
+  WeightedALSUpdate(const double lambda = 0.1,
+                    const bool implicit = false,
+                    const double alpha = 40.0) :
+      lambda(lambda),
+      implicit(implicit),
+      alpha(alpha)
+  {
+    // Nothing to do.
+  }
+
+  /**
+   * Keep the transpose of the given dataset, whose rows are then the columns
+   * of the transpose.
+   *
+   * @param dataset Input matrix to be factorized.
+   * @param * (rank) Rank of the factorization.
+   */
+  template<typename MatType>
+  void Initialize(const MatType& dataset, const size_t /* rank */)
+  {
+    vt = arma::sp_mat(dataset).t();
+  }
+
+  /**
+   * Update each row of the basis matrix W while holding H constant.
+   *
+   * @param * (V) Input matrix to be factorized; its transpose is used.
+   * @param W Basis matrix to be updated.
+   * @param H Encoding matrix.
+   */
+  template<typename MatType>
+  inline void WUpdate(const MatType& /* V */,
+                      arma::mat& W,
+                      const arma::mat& H)
+  {
+    // Solving for the rows of W is solving for the columns of W^T with the
+    // roles of W and H exchanged.
+    arma::mat wt = W.t();
+    Solve(vt, H.t(), wt);
+    W = wt.t();
+  }
+
+  /**
+   * Update each column of the encoding matrix H while holding W constant.
+   *
+   * @param V Input matrix to be factorized.
+   * @param W Basis matrix.
+   * @param H Encoding matrix to be updated.
+   */
+  inline void HUpdate(const arma::sp_mat& V,
+                      const arma::mat& W,
+                      arma::mat& H)
+  {
+    Solve(V, W, H);
+  }
+
+  /**
+   * Update each column of the encoding matrix H while holding W constant; a
+   * dense V is converted to a sparse matrix first.
+   *
+   * @param V Input matrix to be factorized.
+   * @param W Basis matrix.
+   * @param H Encoding matrix to be updated.
+   */
+  template<typename MatType>
+  inline void HUpdate(const MatType& V,
+                      const arma::mat& W,
+                      arma::mat& H)
+  {
+    Solve(arma::sp_mat(V), W, H);
+  }
+
+  //! Get the regularization parameter.
+  double Lambda() const { return lambda; }
+  //! Modify the regularization parameter.
+  double& Lambda() { return lambda; }
+
+  //! Get whether the entries are implicit feedback.
+  bool Implicit() const { return implicit; }
+  //! Modify whether the entries are implicit feedback.
+  bool& Implicit() { return implicit; }
+
+  //! Get the confidence of nonzero entries for implicit feedback.
+  double Alpha() const { return alpha; }
+  //! Modify the confidence of nonzero entries for implicit feedback.
+  double& Alpha() { return alpha; }
+
+  //! Serialize the object.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(lambda);
+    ar & BOOST_SERIALIZATION_NVP(implicit);
+    ar & BOOST_SERIALIZATION_NVP(alpha);
+  }
+
+  /**
+   * Solve for each column of H, so that V is approximated by W * H.  With W
+   * fixed, this also gives the factors of columns that were not part of the
+   * factorization (for instance, to fold new users into a model).
+   *
+   * @param V Input matrix.
+   * @param W Basis matrix.
+   * @param H Encoding matrix to be set.
+   */
+  void Solve(const arma::sp_mat& V, const arma::mat& W, arma::mat& H) const
+  {
+    const size_t rank = W.n_cols;
+    const arma::mat gram = implicit ? arma::mat(W.t() * W) : arma::mat();
+
+    H.set_size(rank, V.n_cols);
+    #pragma omp parallel for schedule(dynamic, 64)
+    for (omp_size_t u = 0; u < (omp_size_t) V.n_cols; ++u)
+    {
+      arma::mat a = implicit ? gram : arma::mat(rank, rank, arma::fill::zeros);
+      arma::vec b(rank, arma::fill::zeros);
+      size_t count = 0;
+      for (arma::sp_mat::const_iterator it = V.begin_col(u);
+           it != V.end_col(u); ++it)
+      {
+        const arma::rowvec w = W.row(it.row());
+        if (implicit)
+        {
+          // The confidence is 1 + alpha * v, and the preference is 1.
+          const double confidence = 1.0 + alpha * (*it);
+          a += (confidence - 1.0) * (w.t() * w);
+          b += confidence * w.t();
+        }
+        else
+        {
+          a += w.t() * w;
+          b += (*it) * w.t();
+        }
+        ++count;
+      }
+
+      if (count == 0 && !implicit)
+      {
+        // Nothing is known about this column.
+        H.col(u).zeros();
+        continue;
+      }
+
+      a.diag() += implicit ? lambda : lambda * count;
+      H.col(u) = arma::solve(a, b);
+    }
+  }
+
+ private:
+  //! Regularization parameter.
+  double lambda;
+  //! Whether the entries are implicit feedback.
+  bool implicit;
+  //! Confidence of nonzero entries for implicit feedback.
+  double alpha;
+  //! The transpose of the matrix being factorized.
+  arma::sp_mat vt;
+}; // class WeightedALSUpdate
+
+} // namespace amf
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,309 @@
+/**
+ * @file methods/ann/activation_functions/fast_activation_functions.hpp
+ *
+ * Definition of the fast versions of the logistic, tanh, softplus, swish, mish
+ * and GELU functions, which are evaluated with the approximations of
+ * fast_math.hpp in one vectorizable pass, without temporaries.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_ACTIVATION_FUNCTIONS_FAST_ACTIVATION_FUNCTIONS_HPP
+#define MLPACK_METHODS_ANN_ACTIVATION_FUNCTIONS_FAST_ACTIVATION_FUNCTIONS_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "fast_math.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * The fast activation functions compute the same functions (and derivatives)
+ * as LogisticFunction, TanhFunction, SoftplusFunction, SwishFunction,
+ * MishFunction and GELUFunction, and can be used in their place, for instance
+ * as BaseLayer<FastLogisticFunction>.  They are opt-in: the results differ from
+ * the exact ones by a relative error of about 1e-14 (see FastExp(), FastTanh()
+ * and FastLog1p()), and the matrix versions of Fn() and Deriv() only take
+ * dense matrices (or vectors), which are processed elementwise in place; the
+ * output may be the same matrix as the input.
+ */
+
+/**
+ * Fast version of LogisticFunction.
+ */
+class FastLogisticFunction
+{
+ public:
+  //! Compute the logistic function.
+  static double Fn(const double x) { return FastLogistic(x); }
+
+  //! Compute the logistic function of each element of x.
+  template<typename eT>
+  static void Fn(const arma::Mat<eT>& x, arma::Mat<eT>& y)
+  {
+    y.set_size(x.n_rows, x.n_cols);
+    const eT* in = x.memptr();
+    eT* out = y.memptr();
+
+    #pragma omp simd
+    for (size_t i = 0; i < x.n_elem; ++i)
+      out[i] = (eT) FastLogistic(in[i]);
+  }
+
+  //! Compute the first derivative, given the function value y.
+  static double Deriv(const double y) { return y * (1.0 - y); }
+
+  //! Compute the first derivative of each element, given the values y.
+  template<typename eT>
+  static void Deriv(const arma::Mat<eT>& y, arma::Mat<eT>& x)
+  {
+    x.set_size(y.n_rows, y.n_cols);
+    const eT* in = y.memptr();
+    eT* out = x.memptr();
+
+    #pragma omp simd
+    for (size_t i = 0; i < y.n_elem; ++i)
+      out[i] = in[i] * (1 - in[i]);
+  }
+}; // class FastLogisticFunction
+
+/**
+ * Fast version of TanhFunction.
+ */
+class FastTanhFunction
+{
+ public:
+  //! Compute the hyperbolic tangent.
+  static double Fn(const double x) { return FastTanh(x); }
+
+  //! Compute the hyperbolic tangent of each element of x.
+  template<typename eT>
+  static void Fn(const arma::Mat<eT>& x, arma::Mat<eT>& y)
+  {
+    y.set_size(x.n_rows, x.n_cols);
+    const eT* in = x.memptr();
+    eT* out = y.memptr();
+
+    #pragma omp simd
+    for (size_t i = 0; i < x.n_elem; ++i)
+      out[i] = (eT) FastTanh(in[i]);
+  }
+
+  //! Compute the first derivative, given the function value y.
+  static double Deriv(const double y) { return 1.0 - y * y; }
+
+  //! Compute the first derivative of each element, given the values y.
+  template<typename eT>
+  static void Deriv(const arma::Mat<eT>& y, arma::Mat<eT>& x)
+  {
+    x.set_size(y.n_rows, y.n_cols);
+    const eT* in = y.memptr();
+    eT* out = x.memptr();
+
+    #pragma omp simd
+    for (size_t i = 0; i < y.n_elem; ++i)
+      out[i] = 1 - in[i] * in[i];
+  }
+}; // class FastTanhFunction
+
+/**
+ * Fast version of SoftplusFunction, computing log(1 + e^x) as
+ * max(x, 0) + log(1 + e^{-|x|}), which doesn't overflow.
+ */
+class FastSoftplusFunction
+{
+ public:
+  //! Compute the softplus function.
+  static double Fn(const double x)
+  {
+    return std::max(x, 0.0) + FastLog1p(FastExp(-std::abs(x)));
+  }
+
+  //! Compute the softplus function of each element of x.
+  template<typename eT>
+  static void Fn(const arma::Mat<eT>& x, arma::Mat<eT>& y)
+  {
+    y.set_size(x.n_rows, x.n_cols);
+    const eT* in = x.memptr();
+    eT* out = y.memptr();
+
+    #pragma omp simd
+    for (size_t i = 0; i < x.n_elem; ++i)
+      out[i] = (eT) Fn((double) in[i]);
+  }
+
+  //! Compute the first derivative, as SoftplusFunction::Deriv() does.
+  static double Deriv(const double y) { return FastLogistic(y); }
+
+  //! Compute the first derivative of each element of y.
+  template<typename eT>
+  static void Deriv(const arma::Mat<eT>& y, arma::Mat<eT>& x)
+  {
+    x.set_size(y.n_rows, y.n_cols);
+    const eT* in = y.memptr();
+    eT* out = x.memptr();
+
+    #pragma omp simd
+    for (size_t i = 0; i < y.n_elem; ++i)
+      out[i] = (eT) FastLogistic(in[i]);
+  }
+}; // class FastSoftplusFunction
+
+/**
+ * Fast version of SwishFunction.
+ */
+class FastSwishFunction
+{
+ public:
+  //! Compute the swish function.
+  static double Fn(const double x) { return x * FastLogistic(x); }
+
+  //! Compute the swish function of each element of x.
+  template<typename eT>
+  static void Fn(const arma::Mat<eT>& x, arma::Mat<eT>& y)
+  {
+    y.set_size(x.n_rows, x.n_cols);
+    const eT* in = x.memptr();
+    eT* out = y.memptr();
+
+    #pragma omp simd
+    for (size_t i = 0; i < x.n_elem; ++i)
+      out[i] = (eT) Fn((double) in[i]);
+  }
+
+  //! Compute the first derivative, as SwishFunction::Deriv() does.
+  static double Deriv(const double y)
+  {
+    const double s = FastLogistic(y);
+    return y * s + (1.0 - y * s) * s;
+  }
+
+  //! Compute the first derivative of each element of y.
+  template<typename eT>
+  static void Deriv(const arma::Mat<eT>& y, arma::Mat<eT>& x)
+  {
+    x.set_size(y.n_rows, y.n_cols);
+    const eT* in = y.memptr();
+    eT* out = x.memptr();
+
+    #pragma omp simd
+    for (size_t i = 0; i < y.n_elem; ++i)
+      out[i] = (eT) Deriv((double) in[i]);
+  }
+}; // class FastSwishFunction
+
+/**
+ * Fast version of MishFunction.  The function and its derivative are computed
+ * with e^x for x <= 0 and with e^{-x} for x > 0, so that they don't overflow
+ * for large inputs.
+ */
+class FastMishFunction
+{
+ public:
+  //! Compute the mish function.
+  static double Fn(const double x)
+  {
+    // tanh(softplus(x)) = (e^2x + 2e^x) / (e^2x + 2e^x + 2).
+    const double e = FastExp(-std::abs(x));
+    const double positive = (1.0 + 2.0 * e) / (1.0 + 2.0 * e + 2.0 * e * e);
+    const double n = e * (e + 2.0);
+    const double negative = n / (n + 2.0);
+    return x * ((x > 0.0) ? positive : negative);
+  }
+
+  //! Compute the mish function of each element of x.
+  template<typename eT>
+  static void Fn(const arma::Mat<eT>& x, arma::Mat<eT>& y)
+  {
+    y.set_size(x.n_rows, x.n_cols);
+    const eT* in = x.memptr();
+    eT* out = y.memptr();
+
+    #pragma omp simd
+    for (size_t i = 0; i < x.n_elem; ++i)
+      out[i] = (eT) Fn((double) in[i]);
+  }
+
+  //! Compute the first derivative, as MishFunction::Deriv() does.
+  static double Deriv(const double y)
+  {
+    // For y > 0, the numerator and denominator are divided by e^4y.
+    const double e = FastExp(-std::abs(y));
+    const double e2 = e * e;
+    const double d1 = 1.0 + 2.0 * e + 2.0 * e2;
+    const double positive = (e2 * e * 4.0 * (y + 1.0) + e2 * (4.0 * y + 6.0) +
+        4.0 * e + 1.0) / (d1 * d1);
+    const double d2 = e2 + 2.0 * e + 2.0;
+    const double negative = e * (4.0 * (y + 1.0) + e * (4.0 * y + 6.0) +
+        4.0 * e2 + e2 * e) / (d2 * d2);
+    return (y > 0.0) ? positive : negative;
+  }
+
+  //! Compute the first derivative of each element of y.
+  template<typename eT>
+  static void Deriv(const arma::Mat<eT>& y, arma::Mat<eT>& x)
+  {
+    x.set_size(y.n_rows, y.n_cols);
+    const eT* in = y.memptr();
+    eT* out = x.memptr();
+
+    #pragma omp simd
+    for (size_t i = 0; i < y.n_elem; ++i)
+      out[i] = (eT) Deriv((double) in[i]);
+  }
+}; // class FastMishFunction
+
+/**
+ * Fast version of GELUFunction, using 0.5 (1 + tanh(z)) = 1 / (1 + e^{-2z}).
+ */
+class FastGELUFunction
+{
+ public:
+  //! Compute the GELU function.
+  static double Fn(const double x)
+  {
+    const double z = std::sqrt(2 / M_PI) * (x + 0.044715 * x * x * x);
+    return x / (1.0 + FastExp(-2.0 * z));
+  }
+
+  //! Compute the GELU function of each element of x.
+  template<typename eT>
+  static void Fn(const arma::Mat<eT>& x, arma::Mat<eT>& y)
+  {
+    y.set_size(x.n_rows, x.n_cols);
+    const eT* in = x.memptr();
+    eT* out = y.memptr();
+
+    #pragma omp simd
+    for (size_t i = 0; i < x.n_elem; ++i)
+      out[i] = (eT) Fn((double) in[i]);
+  }
+
+  //! Compute the first derivative, as GELUFunction::Deriv() does.
+  static double Deriv(const double y)
+  {
+    const double y3 = y * y * y;
+    const double t = FastTanh(0.0356774 * y3 + 0.797885 * y);
+    return 0.5 * t + (0.0535161 * y3 + 0.398942 * y) * (1.0 - t * t) + 0.5;
+  }
+
+  //! Compute the first derivative of each element of y.
+  template<typename eT>
+  static void Deriv(const arma::Mat<eT>& y, arma::Mat<eT>& x)
+  {
+    x.set_size(y.n_rows, y.n_cols);
+    const eT* in = y.memptr();
+    eT* out = x.memptr();
+
+    #pragma omp simd
+    for (size_t i = 0; i < y.n_elem; ++i)
+      out[i] = (eT) Deriv((double) in[i]);
+  }
+}; // class FastGELUFunction
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
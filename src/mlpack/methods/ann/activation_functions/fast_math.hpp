@@ -0,0 +1,134 @@
+/**
+ * @file methods/ann/activation_functions/fast_math.hpp
+ *
+ * Branch-free approximations of exp(), tanh() and log1p(), used by the fast
+ * activation functions.  They are written so that loops calling them can be
+ * vectorized by the compiler.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_ACTIVATION_FUNCTIONS_FAST_MATH_HPP
+#define MLPACK_METHODS_ANN_ACTIVATION_FUNCTIONS_FAST_MATH_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * Compute an approximation of exp(x).  The argument is reduced to
+ * x = n log(2) + r with |r| <= log(2) / 2, e^r is evaluated with a polynomial
+ * of degree 11, and 2^n is put into the exponent bits.  The relative error is
+ * below 1e-14 for x in [-708, 709]; outside of that range the result saturates
+ * at exp(-708) or exp(709) instead of underflowing or overflowing.  NaN is
+ * passed through.
+ *
+ * @param x Input value.
+ * @return An approximation of exp(x).
+ */
+inline double FastExp(const double x)
+{
+  const double xc = std::min(std::max(x, -708.0), 709.0);
+
+  // Round x / log(2) to the nearest integer by adding 1.5 * 2^52.  (This
+  // relies on IEEE semantics, so -ffast-math must not reassociate it.)
+  const double shift = 6755399441055744.0;
+  const double n = (xc * 1.4426950408889634 + shift) - shift;
+
+  // Cody-Waite reduction with log(2) split into a high and a low part.
+  const double r = (xc - n * 6.93145751953125e-1) - n * 1.42860682030941723e-6;
+
+  double p = 2.505210838544172e-08;       // 1 / 11!
+  p = p * r + 2.755731922398589e-07;      // 1 / 10!
+  p = p * r + 2.755731922398589e-06;      // 1 / 9!
+  p = p * r + 2.48015873015873e-05;       // 1 / 8!
+  p = p * r + 1.984126984126984e-04;      // 1 / 7!
+  p = p * r + 1.388888888888889e-03;      // 1 / 6!
+  p = p * r + 8.333333333333333e-03;      // 1 / 5!
+  p = p * r + 4.166666666666667e-02;      // 1 / 4!
+  p = p * r + 1.666666666666667e-01;      // 1 / 3!
+  p = p * r + 0.5;
+  p = p * r + 1.0;
+  p = p * r + 1.0;
+
+  // Build 2^n from its exponent bits; n is in [-1021, 1023].
+  const uint64_t bits = (uint64_t) ((int64_t) n + 1023) << 52;
+  double scale;
+  std::memcpy(&scale, &bits, sizeof(double));
+
+  return (x == x) ? p * scale : x;
+}
+
+/**
+ * Compute an approximation of tanh(x), as 1 - 2 / (exp(2x) + 1) with
+ * FastExp(), or with its Taylor polynomial for |x| < 1/16, where the first
+ * form would lose relative accuracy.  The absolute error is below 1e-14.
+ *
+ * @param x Input value.
+ * @return An approximation of tanh(x).
+ */
+inline double FastTanh(const double x)
+{
+  const double x2 = x * x;
+  double p = 62.0 / 2835.0;
+  p = p * x2 - 17.0 / 315.0;
+  p = p * x2 + 2.0 / 15.0;
+  p = p * x2 - 1.0 / 3.0;
+  const double small = x + x * x2 * p;
+
+  const double large = 1.0 - 2.0 / (FastExp(2.0 * x) + 1.0);
+
+  return (std::abs(x) < 0.0625) ? small : large;
+}
+
+/**
+ * Compute an approximation of log(1 + u) for u in [0, 1], as
+ * 2 atanh(s) with s = u / (2 + u), whose odd power series is evaluated up to
+ * s^27.  Since s <= 1/3, the relative error is below 1e-14.  This is the range
+ * needed by log(1 + exp(-|x|)).
+ *
+ * @param u Input value, in [0, 1].
+ * @return An approximation of log(1 + u).
+ */
+inline double FastLog1p(const double u)
+{
+  const double s = u / (2.0 + u);
+  const double s2 = s * s;
+
+  double p = 1.0 / 27.0;
+  p = p * s2 + 1.0 / 25.0;
+  p = p * s2 + 1.0 / 23.0;
+  p = p * s2 + 1.0 / 21.0;
+  p = p * s2 + 1.0 / 19.0;
+  p = p * s2 + 1.0 / 17.0;
+  p = p * s2 + 1.0 / 15.0;
+  p = p * s2 + 1.0 / 13.0;
+  p = p * s2 + 1.0 / 11.0;
+  p = p * s2 + 1.0 / 9.0;
+  p = p * s2 + 1.0 / 7.0;
+  p = p * s2 + 1.0 / 5.0;
+  p = p * s2 + 1.0 / 3.0;
+  p = p * s2 + 1.0;
+
+  return 2.0 * s * p;
+}
+
+/**
+ * Compute an approximation of the logistic function 1 / (1 + exp(-x)) with
+ * FastExp().
+ *
+ * @param x Input value.
+ * @return An approximation of 1 / (1 + exp(-x)).
+ */
+inline double FastLogistic(const double x)
+{
+  return 1.0 / (1.0 + FastExp(-x));
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
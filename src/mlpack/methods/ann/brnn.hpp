@@ -35,6 +35,10 @@ namespace ann /** Artificial Neural Network. */ {
 /**
  * Implementation of a standard bidirectional recurrent neural network container.
  *
+ * The forward and the backward RNN only meet at the merge layer, so when
+ * mlpack is built with OpenMP, the forward pass and the backpropagation through
+ * time of the two directions run at the same time on two threads.
+ *
  * @tparam OutputLayerType The output layer type used to evaluate the network.
  * @tparam InitializationRuleType Rule used to initialize the weight matrix.
  */
@@ -326,6 +330,29 @@ class BRNN
    */
   void ResetDeterministic();
 
+  /**
+   * Run the forward RNN and the backward RNN over all the time steps of the
+   * given batch, and save the output of the last layer of each of them at each
+   * time step.  The two directions are independent until the merge layer, so
+   * with OpenMP they run at the same time on two threads, each with its own
+   * layers and outputs.
+   *
+   * @param data The input sequences.
+   * @param begin Index of the first sequence of the batch.
+   * @param batchSize Number of sequences in the batch.
+   * @param forwardResults The outputs of the forward RNN, in time order.
+   * @param backwardResults The outputs of the backward RNN, in reverse time
+   *     order.
+   * @param saveOutputs Whether to also save the outputs of all the layers,
+   *     for backpropagation through time.
+   */
+  void ForwardDirections(arma::cube& data,
+                         const size_t begin,
+                         const size_t batchSize,
+                         std::vector<arma::mat>& forwardResults,
+                         std::vector<arma::mat>& backwardResults,
+                         const bool saveOutputs);
+
   //! Number of steps to backpropagate through time (BPTT).
   size_t rho;
 
@@ -405,9 +432,6 @@ class BRNN
   //! The current gradient for the gradient pass for backward RNN.
   arma::mat backwardGradient;
 
-  //! The total gradient from each gradient pass.
-  arma::mat totalGradient;
-
   //! Forward RNN
   RNN<OutputLayerType, InitializationRuleType, CustomLayers...> forwardRNN;
 
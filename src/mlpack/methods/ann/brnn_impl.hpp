@@ -223,20 +223,8 @@ void BRNN<OutputLayerType, MergeLayerType, MergeOutputType,
   {
     const size_t effectiveBatchSize = std::min(batchSize,
         size_t(predictors.n_cols - begin));
-    for (size_t seqNum = 0; seqNum < rho; ++seqNum)
-    {
-      forwardRNN.Forward(arma::mat(
-          predictors.slice(seqNum).colptr(begin),
-          predictors.n_rows, effectiveBatchSize, false, true));
-      backwardRNN.Forward(std::move(arma::mat(
-          predictors.slice(rho - seqNum - 1).colptr(begin),
-          predictors.n_rows, effectiveBatchSize, false, true)));
-
-      boost::apply_visitor(SaveOutputParameterVisitor(results1),
-          forwardRNN.network.back());
-      boost::apply_visitor(SaveOutputParameterVisitor(results2),
-          backwardRNN.network.back());
-    }
+    ForwardDirections(predictors, begin, effectiveBatchSize, results1,
+        results2, false);
     reverse(results1.begin(), results1.end());
 
     // Forward outputs from both RNN's through merge layer for each time step.
@@ -300,20 +288,7 @@ double BRNN<OutputLayerType, MergeLayerType, MergeOutputType,
   size_t responseSeq = 0;
 
   std::vector<arma::mat> results1, results2;
-  for (size_t seqNum = 0; seqNum < rho; ++seqNum)
-  {
-    forwardRNN.Forward(arma::mat(
-        predictors.slice(seqNum).colptr(begin),
-        predictors.n_rows, batchSize, false, true));
-    backwardRNN.Forward(arma::mat(
-        predictors.slice(rho - seqNum - 1).colptr(begin),
-        predictors.n_rows, batchSize, false, true));
-
-    boost::apply_visitor(SaveOutputParameterVisitor(results1),
-        forwardRNN.network.back());
-    boost::apply_visitor(SaveOutputParameterVisitor(results2),
-        backwardRNN.network.back());
-  }
+  ForwardDirections(predictors, begin, batchSize, results1, results2, false);
   if (outputSize == 0)
   {
     outputSize = boost::apply_visitor(outputParameterVisitor,
@@ -418,27 +393,7 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
 
   // Forward propogation from both directions.
   std::vector<arma::mat> results1, results2;
-  for (size_t seqNum = 0; seqNum < rho; ++seqNum)
-  {
-    forwardRNN.Forward(arma::mat(
-        predictors.slice(seqNum).colptr(begin),
-        predictors.n_rows, batchSize, false, true));
-    backwardRNN.Forward(arma::mat(
-        predictors.slice(rho - seqNum - 1).colptr(begin),
-        predictors.n_rows, batchSize, false, true));
-
-    for (size_t l = 0; l < networkSize; ++l)
-    {
-      boost::apply_visitor(SaveOutputParameterVisitor(
-          forwardRNNOutputParameter), forwardRNN.network[l]);
-      boost::apply_visitor(SaveOutputParameterVisitor(
-          backwardRNNOutputParameter), backwardRNN.network[l]);
-    }
-    boost::apply_visitor(SaveOutputParameterVisitor(results1),
-        forwardRNN.network.back());
-    boost::apply_visitor(SaveOutputParameterVisitor(results2),
-        backwardRNN.network.back());
-  }
+  ForwardDirections(predictors, begin, batchSize, results1, results2, true);
   if (outputSize == 0)
   {
     outputSize = boost::apply_visitor(outputParameterVisitor,
@@ -511,87 +466,62 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
     allDelta.push_back(arma::mat(delta));
   }
 
-  // BPTT ForwardRNN from t = T to 1.
-  totalGradient = arma::mat(gradient.memptr(),
-      parameter.n_elem / 2, 1, false, false);
-
   forwardGradient.zeros();
   forwardRNN.ResetGradients(forwardGradient);
   backwardGradient.zeros();
   backwardRNN.ResetGradients(backwardGradient);
 
-  for (size_t seqNum = 0; seqNum < rho; ++seqNum)
+  // BPTT of the forward RNN from t = T to 1, and of the backward RNN from
+  // t = 1 to T.  Like the forward pass, the two directions run at the same
+  // time; each one only uses its own RNN, its own half of the gradient and its
+  // own input of the merge layer.
+  #pragma omp parallel for num_threads(2) schedule(static, 1)
+  for (omp_size_t d = 0; d < 2; ++d)
   {
-    forwardGradient.zeros();
-    for (size_t l = 0; l < networkSize; ++l)
-    {
-      boost::apply_visitor(LoadOutputParameterVisitor(
-          forwardRNNOutputParameter),
-          forwardRNN.network[networkSize - 1 - l]);
-    }
-    boost::apply_visitor(BackwardVisitor(boost::apply_visitor(
-        outputParameterVisitor, forwardRNN.network.back()),
-        allDelta[rho - seqNum - 1], delta, 0),
-        mergeLayer);
+    RNN<OutputLayerType, InitializationRuleType, CustomLayers...>& rnn =
+        (d == 0) ? forwardRNN : backwardRNN;
+    std::vector<arma::mat>& outputs = (d == 0) ? forwardRNNOutputParameter :
+        backwardRNNOutputParameter;
+    arma::mat& rnnGradient = (d == 0) ? forwardGradient : backwardGradient;
+    arma::mat totalGradient(gradient.memptr() + d * (parameter.n_elem / 2),
+        parameter.n_elem / 2, 1, false, false);
+    arma::mat mergeDelta;
 
-    for (size_t i = 2; i < networkSize; ++i)
+    for (size_t seqNum = 0; seqNum < rho; ++seqNum)
     {
-      boost::apply_visitor(BackwardVisitor(
+      const size_t step = (d == 0) ? rho - seqNum - 1 : seqNum;
+
+      rnnGradient.zeros();
+      for (size_t l = 0; l < networkSize; ++l)
+      {
+        boost::apply_visitor(LoadOutputParameterVisitor(outputs),
+            rnn.network[networkSize - 1 - l]);
+      }
+      boost::apply_visitor(BackwardVisitor(boost::apply_visitor(
+          outputParameterVisitor, rnn.network.back()), allDelta[step],
+          mergeDelta, d), mergeLayer);
+
+      for (size_t i = 2; i < networkSize; ++i)
+      {
+        boost::apply_visitor(BackwardVisitor(
+            boost::apply_visitor(outputParameterVisitor,
+            rnn.network[networkSize - i]),
+            boost::apply_visitor(deltaVisitor,
+            rnn.network[networkSize - i + 1]),
+            boost::apply_visitor(deltaVisitor,
+            rnn.network[networkSize - i])),
+            rnn.network[networkSize - i]);
+      }
+
+      rnn.Gradient(arma::mat(predictors.slice(step).colptr(begin),
+          predictors.n_rows, batchSize, false, true));
+      boost::apply_visitor(GradientVisitor(
           boost::apply_visitor(outputParameterVisitor,
-          forwardRNN.network[networkSize - i]),
-          boost::apply_visitor(deltaVisitor,
-          forwardRNN.network[networkSize - i + 1]),
-          boost::apply_visitor(deltaVisitor,
-          forwardRNN.network[networkSize - i])),
-          forwardRNN.network[networkSize - i]);
+          rnn.network[networkSize - 2]), allDelta[step], d), mergeLayer);
+      totalGradient += rnnGradient;
     }
-    forwardRNN.Gradient(
-        arma::mat(predictors.slice(rho - seqNum - 1).colptr(begin),
-        predictors.n_rows, batchSize, false, true));
-    boost::apply_visitor(GradientVisitor(
-        boost::apply_visitor(outputParameterVisitor,
-        forwardRNN.network[networkSize - 2]),
-        allDelta[rho - seqNum - 1], 0), mergeLayer);
-    totalGradient += forwardGradient;
   }
 
-  // BPTT BackwardRNN from t = 1 to T.
-  totalGradient = arma::mat(gradient.memptr() + parameter.n_elem/2,
-      parameter.n_elem/2, 1, false, false);
-
-  for (size_t seqNum = 0; seqNum < rho; ++seqNum)
-  {
-    backwardGradient.zeros();
-    for (size_t l = 0; l < networkSize; ++l)
-    {
-      boost::apply_visitor(LoadOutputParameterVisitor(
-          backwardRNNOutputParameter),
-          backwardRNN.network[networkSize - 1 - l]);
-    }
-    boost::apply_visitor(BackwardVisitor(
-        boost::apply_visitor(outputParameterVisitor,
-        backwardRNN.network.back()),
-        allDelta[seqNum], delta, 1), mergeLayer);
-    for (size_t i = 2; i < networkSize; ++i)
-    {
-      boost::apply_visitor(BackwardVisitor(
-        boost::apply_visitor(outputParameterVisitor,
-        backwardRNN.network[networkSize - i]), boost::apply_visitor(
-        deltaVisitor, backwardRNN.network[networkSize - i + 1]),
-        boost::apply_visitor(deltaVisitor,
-        backwardRNN.network[networkSize - i])),
-        backwardRNN.network[networkSize - i]);
-    }
-
-    backwardRNN.Gradient(
-        arma::mat(predictors.slice(seqNum).colptr(begin),
-        predictors.n_rows, batchSize, false, true));
-    boost::apply_visitor(GradientVisitor(
-        std::move(boost::apply_visitor(outputParameterVisitor,
-        backwardRNN.network[networkSize - 2])),
-        allDelta[seqNum], 1), mergeLayer);
-    totalGradient += backwardGradient;
-  }
   return performance;
 }
 
@@ -715,6 +645,50 @@ void BRNN<OutputLayerType, MergeLayerType, MergeOutputType,
   backwardRNN.ResetDeterministic();
 }
 
+template<typename OutputLayerType, typename MergeLayerType,
+         typename MergeOutputType, typename InitializationRuleType,
+         typename... CustomLayers>
+void BRNN<OutputLayerType, MergeLayerType, MergeOutputType,
+    InitializationRuleType, CustomLayers...>::ForwardDirections(
+    arma::cube& data,
+    const size_t begin,
+    const size_t batchSize,
+    std::vector<arma::mat>& forwardResults,
+    std::vector<arma::mat>& backwardResults,
+    const bool saveOutputs)
+{
+  #pragma omp parallel for num_threads(2) schedule(static, 1)
+  for (omp_size_t d = 0; d < 2; ++d)
+  {
+    RNN<OutputLayerType, InitializationRuleType, CustomLayers...>& rnn =
+        (d == 0) ? forwardRNN : backwardRNN;
+    std::vector<arma::mat>& results = (d == 0) ? forwardResults :
+        backwardResults;
+    std::vector<arma::mat>& outputs = (d == 0) ? forwardRNNOutputParameter :
+        backwardRNNOutputParameter;
+
+    for (size_t seqNum = 0; seqNum < rho; ++seqNum)
+    {
+      // Wrap a matrix around our data to avoid a copy.
+      const size_t step = (d == 0) ? seqNum : rho - seqNum - 1;
+      rnn.Forward(arma::mat(data.slice(step).colptr(begin), data.n_rows,
+          batchSize, false, true));
+
+      if (saveOutputs)
+      {
+        for (size_t l = 0; l < rnn.network.size(); ++l)
+        {
+          boost::apply_visitor(SaveOutputParameterVisitor(outputs),
+              rnn.network[l]);
+        }
+      }
+
+      boost::apply_visitor(SaveOutputParameterVisitor(results),
+          rnn.network.back());
+    }
+  }
+}
+
 template<typename OutputLayerType, typename MergeLayerType,
          typename MergeOutputType, typename InitializationRuleType,
          typename... CustomLayers>
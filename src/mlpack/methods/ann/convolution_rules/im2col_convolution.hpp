@@ -0,0 +1,373 @@
+/**
+ * @file methods/ann/convolution_rules/im2col_convolution.hpp
+ *
+ * Implementation of the convolution as a matrix multiplication.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_CONVOLUTION_RULES_IM2COL_CONVOLUTION_HPP
+#define MLPACK_METHODS_ANN_CONVOLUTION_RULES_IM2COL_CONVOLUTION_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "border_modes.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * Computes the two-dimensional convolution by unrolling every patch of the
+ * input that the filter is applied to into one column of a matrix ("im2col"),
+ * so that the convolution becomes a single matrix product that is done by
+ * BLAS.  The results are the same as with NaiveConvolution (for equal strides
+ * and dilations in both directions).
+ *
+ * The Im2Col() and Col2Im() functions work on any number of maps at once.  When
+ * this class is used as the convolution rule of the Convolution layer, the
+ * layer uses them to convolve all the input maps of a point with all the
+ * filters in one matrix product, for the forward pass, the backward pass and
+ * the gradient.
+ *
+ * Note that the unrolled matrix has (filter size * number of maps) times more
+ * elements than the output positions, so this needs more memory than
+ * NaiveConvolution.
+ *
+ * @tparam BorderMode Type of the border mode (FullConvolution or
+ * ValidConvolution).
+ */
+template<typename BorderMode = FullConvolution>
+class Im2ColConvolution
+{
+ public:
+  /*
+   * Unroll the patches of the given maps into the columns of a matrix.  The
+   * patch of output position (i, j) is stored in column (i + j * outputRows),
+   * with the elements of each map in column-major order and the maps one after
+   * another.  The first dimension of the maps uses dW and dilationW, and the
+   * second dimension dH and dilationH.
+   *
+   * @param input Memory of the maps, stored one after another.
+   * @param rows Number of rows of each map.
+   * @param cols Number of columns of each map.
+   * @param maps Number of maps.
+   * @param filterRows Number of rows of the filter.
+   * @param filterCols Number of columns of the filter.
+   * @param columns Matrix to store the unrolled patches into.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT>
+  static void Im2Col(const eT* input,
+                     const size_t rows,
+                     const size_t cols,
+                     const size_t maps,
+                     const size_t filterRows,
+                     const size_t filterCols,
+                     arma::Mat<eT>& columns,
+                     const size_t dW = 1,
+                     const size_t dH = 1,
+                     const size_t dilationW = 1,
+                     const size_t dilationH = 1)
+  {
+    const size_t outputRows = (rows - (filterRows - 1) * dilationW - 1) / dW
+        + 1;
+    const size_t outputCols = (cols - (filterCols - 1) * dilationH - 1) / dH
+        + 1;
+
+    columns.set_size(filterRows * filterCols * maps, outputRows * outputCols);
+    for (size_t j = 0; j < outputCols; ++j)
+    {
+      for (size_t i = 0; i < outputRows; ++i)
+      {
+        eT* columnPtr = columns.colptr(i + j * outputRows);
+        for (size_t m = 0; m < maps; ++m)
+        {
+          const eT* mapPtr = input + m * rows * cols + i * dW;
+          for (size_t kj = 0; kj < filterCols; ++kj)
+          {
+            const eT* inputPtr = mapPtr + (j * dH + kj * dilationH) * rows;
+            for (size_t ki = 0; ki < filterRows; ++ki, ++columnPtr)
+              *columnPtr = inputPtr[ki * dilationW];
+          }
+        }
+      }
+    }
+  }
+
+  /*
+   * Add the patches stored in the columns of a matrix (as created by Im2Col())
+   * back onto the given maps.  Elements that belong to more than one patch get
+   * the sum of the corresponding entries.
+   *
+   * @param columns Matrix of unrolled patches.
+   * @param rows Number of rows of each map.
+   * @param cols Number of columns of each map.
+   * @param maps Number of maps.
+   * @param filterRows Number of rows of the filter.
+   * @param filterCols Number of columns of the filter.
+   * @param output Memory of the maps to add the patches to, stored one after
+   *     another.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT>
+  static void Col2Im(const arma::Mat<eT>& columns,
+                     const size_t rows,
+                     const size_t cols,
+                     const size_t maps,
+                     const size_t filterRows,
+                     const size_t filterCols,
+                     eT* output,
+                     const size_t dW = 1,
+                     const size_t dH = 1,
+                     const size_t dilationW = 1,
+                     const size_t dilationH = 1)
+  {
+    const size_t outputRows = (rows - (filterRows - 1) * dilationW - 1) / dW
+        + 1;
+    const size_t outputCols = (cols - (filterCols - 1) * dilationH - 1) / dH
+        + 1;
+
+    for (size_t j = 0; j < outputCols; ++j)
+    {
+      for (size_t i = 0; i < outputRows; ++i)
+      {
+        const eT* columnPtr = columns.colptr(i + j * outputRows);
+        for (size_t m = 0; m < maps; ++m)
+        {
+          eT* mapPtr = output + m * rows * cols + i * dW;
+          for (size_t kj = 0; kj < filterCols; ++kj)
+          {
+            eT* outputPtr = mapPtr + (j * dH + kj * dilationH) * rows;
+            for (size_t ki = 0; ki < filterRows; ++ki, ++columnPtr)
+              outputPtr[ki * dilationW] += *columnPtr;
+          }
+        }
+      }
+    }
+  }
+
+  /*
+   * Perform a convolution (valid mode).
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT, typename Border = BorderMode>
+  static typename std::enable_if<
+      std::is_same<Border, ValidConvolution>::value, void>::type
+  Convolution(const arma::Mat<eT>& input,
+              const arma::Mat<eT>& filter,
+              arma::Mat<eT>& output,
+              const size_t dW = 1,
+              const size_t dH = 1,
+              const size_t dilationW = 1,
+              const size_t dilationH = 1)
+  {
+    arma::Mat<eT> columns;
+    Im2Col(input.memptr(), input.n_rows, input.n_cols, 1, filter.n_rows,
+        filter.n_cols, columns, dW, dH, dilationW, dilationH);
+
+    output.set_size((input.n_rows - (filter.n_rows - 1) * dilationW - 1) / dW
+        + 1, (input.n_cols - (filter.n_cols - 1) * dilationH - 1) / dH + 1);
+    arma::Row<eT> outputRow(output.memptr(), output.n_elem, false, true);
+    outputRow = arma::vectorise(filter).t() * columns;
+  }
+
+  /*
+   * Perform a convolution (full mode).
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT, typename Border = BorderMode>
+  static typename std::enable_if<
+      std::is_same<Border, FullConvolution>::value, void>::type
+  Convolution(const arma::Mat<eT>& input,
+              const arma::Mat<eT>& filter,
+              arma::Mat<eT>& output,
+              const size_t dW = 1,
+              const size_t dH = 1,
+              const size_t dilationW = 1,
+              const size_t dilationH = 1)
+  {
+    // Use the same working output shape as NaiveConvolution.
+    size_t outputRows = (input.n_rows - 1) * dW + 2 * (filter.n_rows - 1)
+        * dilationW + 1;
+    size_t outputCols = (input.n_cols - 1) * dH + 2 * (filter.n_cols - 1)
+        * dilationH + 1;
+
+    for (size_t i = 0; i < dW; i++)
+    {
+      if (((((i + outputRows - 2 * (filter.n_rows - 1) * dilationW - 1) % dW)
+          + dW) % dW) == i)
+      {
+        outputRows += i;
+        break;
+      }
+    }
+    for (size_t i = 0; i < dH; i++)
+    {
+      if (((((i + outputCols - 2 * (filter.n_cols - 1) * dilationH - 1) % dH)
+          + dH) % dH) == i)
+      {
+        outputCols += i;
+        break;
+      }
+    }
+
+    // Pad the input to the working output shape.
+    arma::Mat<eT> inputPadded = arma::zeros<arma::Mat<eT> >(outputRows,
+        outputCols);
+    inputPadded.submat((filter.n_rows - 1) * dilationW, (filter.n_cols - 1)
+        * dilationH, (filter.n_rows - 1) * dilationW + input.n_rows - 1,
+        (filter.n_cols - 1) * dilationH + input.n_cols - 1) = input;
+
+    Im2ColConvolution<ValidConvolution>::Convolution(inputPadded, filter,
+        output, 1, 1, dilationW, dilationH);
+  }
+
+  /*
+   * Perform a convolution using 3rd order tensors.
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT>
+  static void Convolution(const arma::Cube<eT>& input,
+                          const arma::Cube<eT>& filter,
+                          arma::Cube<eT>& output,
+                          const size_t dW = 1,
+                          const size_t dH = 1,
+                          const size_t dilationW = 1,
+                          const size_t dilationH = 1)
+  {
+    arma::Mat<eT> convOutput;
+    Im2ColConvolution<BorderMode>::Convolution(input.slice(0), filter.slice(0),
+        convOutput, dW, dH, dilationW, dilationH);
+
+    output = arma::Cube<eT>(convOutput.n_rows, convOutput.n_cols,
+        input.n_slices);
+    output.slice(0) = convOutput;
+
+    for (size_t i = 1; i < input.n_slices; i++)
+    {
+      Im2ColConvolution<BorderMode>::Convolution(input.slice(i),
+          filter.slice(i), output.slice(i), dW, dH, dilationW, dilationH);
+    }
+  }
+
+  /*
+   * Perform a convolution using dense matrix as input and a 3rd order tensors
+   * as filter and output.
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT>
+  static void Convolution(const arma::Mat<eT>& input,
+                          const arma::Cube<eT>& filter,
+                          arma::Cube<eT>& output,
+                          const size_t dW = 1,
+                          const size_t dH = 1,
+                          const size_t dilationW = 1,
+                          const size_t dilationH = 1)
+  {
+    arma::Mat<eT> convOutput;
+    Im2ColConvolution<BorderMode>::Convolution(input, filter.slice(0),
+        convOutput, dW, dH, dilationW, dilationH);
+
+    output = arma::Cube<eT>(convOutput.n_rows, convOutput.n_cols,
+        filter.n_slices);
+    output.slice(0) = convOutput;
+
+    for (size_t i = 1; i < filter.n_slices; i++)
+    {
+      Im2ColConvolution<BorderMode>::Convolution(input, filter.slice(i),
+          output.slice(i), dW, dH, dilationW, dilationH);
+    }
+  }
+
+  /*
+   * Perform a convolution using a 3rd order tensors as input and output and a
+   * dense matrix as filter.
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT>
+  static void Convolution(const arma::Cube<eT>& input,
+                          const arma::Mat<eT>& filter,
+                          arma::Cube<eT>& output,
+                          const size_t dW = 1,
+                          const size_t dH = 1,
+                          const size_t dilationW = 1,
+                          const size_t dilationH = 1)
+  {
+    arma::Mat<eT> convOutput;
+    Im2ColConvolution<BorderMode>::Convolution(input.slice(0), filter,
+        convOutput, dW, dH, dilationW, dilationH);
+
+    output = arma::Cube<eT>(convOutput.n_rows, convOutput.n_cols,
+        input.n_slices);
+    output.slice(0) = convOutput;
+
+    for (size_t i = 1; i < input.n_slices; i++)
+    {
+      Im2ColConvolution<BorderMode>::Convolution(input.slice(i), filter,
+          output.slice(i), dW, dH, dilationW, dilationH);
+    }
+  }
+};  // class Im2ColConvolution
+
+/**
+ * Whether the given convolution rule is an Im2ColConvolution, and so supports
+ * convolving many maps at once.
+ */
+template<typename ConvolutionRule>
+struct IsIm2ColConvolution
+{
+  static const bool value = false;
+};
+
+template<typename BorderMode>
+struct IsIm2ColConvolution<Im2ColConvolution<BorderMode>>
+{
+  static const bool value = true;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -14,6 +14,8 @@
 #define MLPACK_METHODS_ANN_FFN_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/data/chunk_loader.hpp>
+#include <mlpack/core/math/random.hpp>
 
 #include "visitor/delete_visitor.hpp"
 #include "visitor/delta_visitor.hpp"
@@ -21,11 +23,13 @@
 #include "visitor/output_parameter_visitor.hpp"
 #include "visitor/output_width_visitor.hpp"
 #include "visitor/reset_visitor.hpp"
+#include "visitor/step_visitor.hpp"
 #include "visitor/weight_size_visitor.hpp"
 #include "visitor/copy_visitor.hpp"
 #include "visitor/loss_visitor.hpp"
 
 #include "init_rules/network_init.hpp"
+#include "sparse_update/sparse_update_callback.hpp"
 
 #include <mlpack/methods/ann/layer/layer_types.hpp>
 #include <mlpack/methods/ann/layer/layer.hpp>
@@ -39,6 +43,11 @@ namespace ann /** Artificial Neural Network. */ {
 /**
  * Implementation of a standard feed forward network.
  *
+ * The network, its layers and its parameters are double precision (arma::mat):
+ * the LayerTypes variant and the visitors only hold layers instantiated with
+ * arma::mat.  Some layers (such as Linear) can be instantiated with arma::fmat,
+ * but only for use outside of a network.
+ *
  * @tparam OutputLayerType The output layer type used to evaluate the network.
  * @tparam InitializationRuleType Rule used to initialize the weight matrix.
  * @tparam CustomLayers Any set of custom layers that could be a part of the
@@ -129,6 +138,7 @@ class FFN
    * @param responses Outputs results from input training variables.
    * @param optimizer Instantiated optimizer used to train the model.
    * @param callbacks Callback function for ensmallen optimizer `OptimizerType`.
+   *     A SparseUpdateCallback is always added.
    *      See https://www.ensmallen.org/docs.html#callback-documentation.
    * @return The final objective of the trained model (NaN or Inf on error).
    */
@@ -155,6 +165,7 @@ class FFN
    * @tparam CallbackTypes Types of Callback Functions.
    * @param responses Outputs results from input training variables.
    * @param callbacks Callback function for ensmallen optimizer `OptimizerType`.
+   *     A SparseUpdateCallback is always added.
    *      See https://www.ensmallen.org/docs.html#callback-documentation.
    * @return The final objective of the trained model (NaN or Inf on error).
    */
@@ -163,18 +174,58 @@ class FFN
                arma::mat responses,
                CallbackTypes&&... callbacks);
 
+  /**
+   * Train the feedforward network on a dataset that is stored in several
+   * files, for one pass over all files.  The chunks are loaded one after the
+   * other by the given loader (which loads the next chunk in the background),
+   * and the optimizer is run on each of them in turn, starting from the
+   * current parameters.  The optimizer should therefore be set to a single
+   * pass over a chunk (with MaxIterations() set to the number of points in a
+   * chunk), and to keep its state between calls (for instance with
+   * ResetPolicy() set to false, if it has that option).
+   *
+   * Call this function once for each epoch; the loader starts the next epoch
+   * automatically.
+   *
+   * @tparam OptimizerType Type of optimizer to use to train the model.
+   * @tparam CallbackTypes Types of Callback Functions.
+   * @param loader Loader that returns the chunks of the dataset.
+   * @param optimizer Instantiated optimizer used to train the model.
+   * @param callbacks Callback function for ensmallen optimizer `OptimizerType`.
+   *     A SparseUpdateCallback is always added.
+   *      See https://www.ensmallen.org/docs.html#callback-documentation.
+   * @return The sum of the final objectives of all chunks (NaN or Inf on
+   *      error).
+   */
+  template<typename OptimizerType, typename... CallbackTypes>
+  double Train(data::ChunkLoader& loader,
+               OptimizerType& optimizer,
+               CallbackTypes&&... callbacks);
+
   /**
    * Predict the responses to a given set of predictors. The responses will
    * reflect the output of the given output layer as returned by the
    * output layer function.
    *
+   * The predictors are passed through the network in batches of the given
+   * size.  After the first batch, the outputs of all layers are placed in one
+   * contiguous workspace, so that the remaining batches of the same size do not
+   * allocate any memory for the layer outputs.
+   *
+   * If Threads() is not 1, the remaining batches are spread over that many
+   * threads, each of which uses its own copy of the network that shares the
+   * parameters.
+   *
    * If you want to pass in a parameter and discard the original parameter
    * object, be sure to use std::move to avoid unnecessary copy.
    *
    * @param predictors Input predictors.
    * @param results Matrix to put output predictions of responses into.
+   * @param batchSize Number of points to pass through the network at once.
    */
-  void Predict(arma::mat predictors, arma::mat& results);
+  void Predict(arma::mat predictors,
+               arma::mat& results,
+               const size_t batchSize = 128);
 
   /**
    * Evaluate the feedforward network with the given predictors and responses.
@@ -306,6 +357,11 @@ class FFN
   //! to call ResetParameters() afterwards.
   std::vector<LayerTypes<CustomLayers...> >& Model() { return network; }
 
+  //! Get the output layer.
+  const OutputLayerType& OutputLayer() const { return outputLayer; }
+  //! Modify the output layer.
+  OutputLayerType& OutputLayer() { return outputLayer; }
+
   //! Return the number of separable functions (the number of predictor points).
   size_t NumFunctions() const { return numFunctions; }
 
@@ -324,11 +380,102 @@ class FFN
   //! Modify the matrix of data points (predictors).
   arma::mat& Predictors() { return predictors; }
 
+  //! Get the number of threads used for data-parallel training and
+  //! prediction.
+  size_t Threads() const { return threads; }
+  /**
+   * Modify the number of threads used for data-parallel training and
+   * prediction.  If this is more than 1, EvaluateWithGradient() splits each
+   * batch into that many parts, and computes the gradient of each part at the
+   * same time with a copy of the network that shares the parameters; the
+   * results are then added up.  Predict() likewise spreads its batches over
+   * the copies.  0 means that as many threads as OpenMP provides are used.
+   * The default is 1 (no data parallelism).
+   *
+   * The output layer is always evaluated on the whole batch, so the objective
+   * and the gradient are the same as without data parallelism, unless the
+   * network has layers whose results depend on the other points of the batch
+   * (like BatchNorm), or layers that have a regularizer (its gradient is then
+   * added once for each part).
+   */
+  size_t& Threads() { return threads; }
+
+  //! Get the number of layers in each segment for gradient checkpointing.
+  size_t CheckpointInterval() const { return checkpointInterval; }
+  /**
+   * Modify the number of layers in each segment for gradient checkpointing.
+   * If this is k > 0, the layers are split into segments of k layers, and the
+   * forward pass of training keeps only the output of the last layer of each
+   * segment (and all the outputs of the last segment).  The backward pass then
+   * handles one segment at a time, from the last one: it computes the outputs
+   * of the segment again from the kept output before it, goes backward through
+   * the segment, computes its gradient, and releases the outputs and deltas of
+   * the segment.  So only the outputs of about n / k + k of the n layers are
+   * in memory at the same time, at the cost of a second forward pass through
+   * most layers; k = sqrt(n) is the usual choice.  0 (the default) keeps all
+   * the outputs.
+   *
+   * The numbers that the layers of a segment draw from math::randGen (like
+   * the masks of Dropout) are drawn again the same way, but the other side
+   * effects of the forward pass happen twice; for instance BatchNorm updates
+   * its running statistics again.  When this is enabled, EvaluateWithGradient()
+   * doesn't split the batches over threads (see Threads()), and the outputs of
+   * the layers are not all available after a forward pass in training mode.
+   */
+  size_t& CheckpointInterval() { return checkpointInterval; }
+
   /**
    * Reset the module infomration (weights/parameters).
    */
   void ResetParameters();
 
+  /**
+   * Update the weights that the layers and the output layer train themselves
+   * (like the table of SparseEmbedding) with the gradient they accumulated
+   * since the last step, and discard that gradient.  Train() does this after
+   * each step of the optimizer (see SparseUpdateCallback); it only has to be
+   * called when the gradient is computed in another way, for instance with
+   * Backward().
+   */
+  void Step();
+
+  /**
+   * Turn the network into a compact model that can only be used for
+   * prediction.  Every BatchNorm layer that directly follows a Linear layer is
+   * folded into the weights and the bias of that layer, using the mean and the
+   * variance over the training data, and Dropout and AlphaDropout layers are
+   * removed, since they do nothing in deterministic mode.  The weights of the
+   * removed layers are dropped from Parameters(), and the intermediate results
+   * of all layers and of the training are released.
+   *
+   * The network gives the same predictions as before, but it should not be
+   * trained anymore: a BatchNorm layer behaves differently in training mode.
+   * A BatchNorm layer that cannot be folded (because it follows another kind
+   * of layer, or it has not seen any training data) is kept as it is.
+   */
+  void PrepareForInference();
+
+  /**
+   * Turn the network into a compact model that computes its Linear,
+   * LinearNoBias and Convolution layers with 8-bit integer arithmetic
+   * (post-training quantization).  The network is first prepared with
+   * PrepareForInference(); then the given calibration data is propagated
+   * through the network to find the range of the inputs of each of these
+   * layers, and each of them is replaced by a QuantizedLinear or
+   * QuantizedConvolution layer, whose weights are quantized per output unit
+   * (or output map) and whose input is quantized with a scale that covers the
+   * calibration range.
+   *
+   * The calibration data should be representative of the data that will be
+   * predicted, since larger inputs are clamped.  The predictions are close to
+   * the ones of the original network, but not identical; the network should
+   * not be trained anymore.
+   *
+   * @param calibrationData Input data used to find the ranges of the inputs
+   *     of the layers.
+   */
+  void Quantize(const arma::mat& calibrationData);
+
   //! Serialize the model.
   template<typename Archive>
   void serialize(Archive& ar, const unsigned int /* version */);
@@ -415,6 +562,27 @@ class FFN
   template<typename InputType>
   void Gradient(const InputType& input);
 
+  /**
+   * Run the backward pass and compute the gradient of the layers for the
+   * given input, once the error of the output layer is known.  With gradient
+   * checkpointing (see CheckpointInterval()), this is done one segment of
+   * layers at a time, recomputing the outputs that the forward pass released.
+   *
+   * @param input The input of the network.
+   */
+  template<typename InputType>
+  void BackwardGradient(const InputType& input);
+
+  /**
+   * Check whether the forward pass of training releases the output of the
+   * given layer, which the backward pass then computes again.
+   */
+  bool Released(const size_t i) const
+  {
+    return checkpointInterval > 0 && (i + 1) % checkpointInterval != 0 &&
+        i / checkpointInterval < (network.size() - 1) / checkpointInterval;
+  }
+
   /**
    * Reset the module status by setting the current deterministic parameter
    * for all modules that implement the Deterministic function.
@@ -426,6 +594,98 @@ class FFN
    */
   void ResetGradients(arma::mat& gradient);
 
+  /**
+   * Make the output of every layer an alias of one slice of a single
+   * contiguous workspace, keeping the current sizes of the outputs.  As long as
+   * the sizes do not change, the layers then write their outputs into the
+   * workspace without allocating memory; a layer whose output size changes
+   * simply gets its own memory again.  Nothing is done if the outputs already
+   * point into the workspace.
+   */
+  void ResetWorkspace();
+
+  /**
+   * Compute the objective and the gradient of the given batch in parallel, with
+   * one copy of the network for each of the given number of parts of the
+   * batch.  This is called by EvaluateWithGradient().
+   *
+   * @param begin Index of the first point of the batch.
+   * @param gradient Matrix to store the gradient into; it must have the size of
+   *     the parameters.
+   * @param batchSize Number of points in the batch.
+   * @param parts Number of parts to split the batch into.
+   */
+  template<typename GradType>
+  double ParallelEvaluateWithGradient(const size_t begin,
+                                      GradType& gradient,
+                                      const size_t batchSize,
+                                      const size_t parts);
+
+  /**
+   * Make sure that there are the given number of replicas of the network, whose
+   * layers use the current parameters of this network.  If the number is 0 all
+   * replicas are deleted.
+   *
+   * @param numReplicas Number of replicas needed.
+   */
+  void ResetReplicas(const size_t numReplicas);
+
+  /**
+   * Update the weights that the layers and the output layer train themselves
+   * with their accumulated gradient if apply is true, and otherwise discard
+   * that gradient.
+   */
+  void StepLayers(const bool apply);
+
+  //! Update the weights that the output layer trains itself, or discard their
+  //! gradient.
+  template<typename T = OutputLayerType>
+  typename std::enable_if<
+      HasStepCheck<T, void(T::*)()>::value, void>::type
+  StepOutputLayer(const bool apply);
+
+  //! Do nothing, since the output layer doesn't train weights itself.
+  template<typename T = OutputLayerType>
+  typename std::enable_if<
+      !HasStepCheck<T, void(T::*)()>::value, void>::type
+  StepOutputLayer(const bool apply);
+
+  //! Initialize the weights that the output layer trains itself with the
+  //! initialization rule of the network.
+  template<typename T = OutputLayerType>
+  typename std::enable_if<
+      HasStepCheck<T, void(T::*)()>::value, void>::type
+  InitializeOutputLayer();
+
+  //! Do nothing, since the output layer doesn't train weights itself.
+  template<typename T = OutputLayerType>
+  typename std::enable_if<
+      !HasStepCheck<T, void(T::*)()>::value, void>::type
+  InitializeOutputLayer();
+
+  /**
+   * Fold the given BatchNorm layer into the weights and the bias of the given
+   * Linear layer, which precedes it.
+   *
+   * @param linear The Linear layer.
+   * @param batchNorm The BatchNorm layer that follows the Linear layer.
+   * @return false if the layers do not fit together, or the BatchNorm layer
+   *     has no training statistics, in which case nothing is changed.
+   */
+  static bool FoldBatchNorm(Linear<>& linear, BatchNorm<>& batchNorm);
+
+  /**
+   * Use the given layers as the network, and release everything that is only
+   * needed for training.  The parameters are rebuilt from the weights of the
+   * new layers, which are taken from the current parameters.
+   *
+   * @param newNetwork The layers of the new network; its content is moved.
+   * @param weightOffsets The offset in the current parameters of the weights
+   *     of each of the new layers (ignored for layers without weights).
+   */
+  void ReplaceNetwork(std::vector<LayerTypes<CustomLayers...> >& newNetwork,
+                      const std::vector<size_t>& weightOffsets);
+
   /**
    * Swap the content of this network with given network.
    *
@@ -506,6 +766,24 @@ class FFN
   //! Locally-stored gradient parameter.
   arma::mat gradient;
 
+  //! Contiguous memory that the layer outputs are aliases of (see
+  //! ResetWorkspace()).
+  arma::vec workspace;
+
+  //! The number of threads used for data-parallel training.
+  size_t threads;
+
+  //! The number of layers in each segment for gradient checkpointing.
+  size_t checkpointInterval;
+
+  //! The state of the random number generator at the start of each segment
+  //! during the last forward pass of training with gradient checkpointing.
+  std::vector<std::mt19937> checkpointRandGen;
+
+  //! Copies of the network used for data-parallel training; their layers use
+  //! the parameters of this network.
+  std::vector<FFN*> replicas;
+
   //! Locally-stored copy visitor
   CopyVisitor<CustomLayers...> copyVisitor;
 
@@ -533,7 +811,7 @@ template<typename OutputLayerType,
 struct version<
     mlpack::ann::FFN<OutputLayerType, InitializationRuleType, CustomLayer...>>
 {
-  BOOST_STATIC_CONSTANT(int, value = 2);
+  BOOST_STATIC_CONSTANT(int, value = 3);
 };
 
 } // namespace serialization
@@ -39,7 +39,9 @@ FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::FFN(
     height(0),
     reset(false),
     numFunctions(0),
-    deterministic(true)
+    deterministic(true),
+    threads(1),
+    checkpointInterval(0)
 {
   /* Nothing to do here. */
 }
@@ -50,6 +52,7 @@ FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::~FFN()
 {
   std::for_each(network.begin(), network.end(),
       boost::apply_visitor(deleteVisitor));
+  ResetReplicas(0);
 }
 
 template<typename OutputLayerType, typename InitializationRuleType,
@@ -117,7 +120,8 @@ double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Train(
 
   // Train the model.
   Timer::Start("ffn_optimization");
-  const double out = optimizer.Optimize(*this, parameter, callbacks...);
+  const double out = optimizer.Optimize(*this, parameter,
+      SparseUpdateCallback(), callbacks...);
   Timer::Stop("ffn_optimization");
 
   Log::Info << "FFN::FFN(): final objective of trained model is " << out
@@ -141,7 +145,34 @@ double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Train(
 
   // Train the model.
   Timer::Start("ffn_optimization");
-  const double out = optimizer.Optimize(*this, parameter, callbacks...);
+  const double out = optimizer.Optimize(*this, parameter,
+      SparseUpdateCallback(), callbacks...);
+  Timer::Stop("ffn_optimization");
+
+  Log::Info << "FFN::FFN(): final objective of trained model is " << out
+      << "." << std::endl;
+  return out;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+template<typename OptimizerType, typename... CallbackTypes>
+double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Train(
+    data::ChunkLoader& loader,
+    OptimizerType& optimizer,
+    CallbackTypes&&... callbacks)
+{
+  double out = 0.0;
+  arma::mat chunkPredictors, chunkResponses;
+
+  // The loader loads the next chunk while the optimizer works on this one.
+  Timer::Start("ffn_optimization");
+  while (loader.Next(chunkPredictors, chunkResponses))
+  {
+    ResetData(std::move(chunkPredictors), std::move(chunkResponses));
+    out += optimizer.Optimize(*this, parameter, SparseUpdateCallback(),
+        callbacks...);
+  }
   Timer::Stop("ffn_optimization");
 
   Log::Info << "FFN::FFN(): final objective of trained model is " << out
@@ -200,6 +231,9 @@ double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Backward(
     const TargetsType& targets,
     GradientsType& gradients)
 {
+  // Start a new sparse gradient for the layers that train weights themselves.
+  StepLayers(false);
+
   double res = outputLayer.Forward(boost::apply_visitor(
       outputParameterVisitor, network.back()), targets);
 
@@ -213,9 +247,8 @@ double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Backward(
 
   gradients = arma::zeros<arma::mat>(parameter.n_rows, parameter.n_cols);
 
-  Backward();
   ResetGradients(gradients);
-  Gradient(inputs);
+  BackwardGradient(inputs);
 
   return res;
 }
@@ -223,7 +256,7 @@ double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Backward(
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Predict(
-    arma::mat predictors, arma::mat& results)
+    arma::mat predictors, arma::mat& results, const size_t batchSize)
 {
   if (parameter.is_empty())
     ResetParameters();
@@ -234,21 +267,59 @@ void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Predict(
     ResetDeterministic();
   }
 
-  arma::mat resultsTemp;
-  Forward(arma::mat(predictors.colptr(0), predictors.n_rows, 1, false, true));
-  resultsTemp = boost::apply_visitor(outputParameterVisitor,
-      network.back()).col(0);
-
-  results = arma::mat(resultsTemp.n_elem, predictors.n_cols);
-  results.col(0) = resultsTemp.col(0);
+  const size_t effectiveBatchSize = std::min(std::max(batchSize, (size_t) 1),
+      (size_t) predictors.n_cols);
+
+  Forward(arma::mat(predictors.colptr(0), predictors.n_rows,
+      effectiveBatchSize, false, true));
+  const arma::mat& output = boost::apply_visitor(outputParameterVisitor,
+      network.back());
+  results.set_size(output.n_rows, predictors.n_cols);
+  results.cols(0, effectiveBatchSize - 1) = output;
+
+  // Now that the sizes of the layer outputs for a full batch are known, put
+  // them all in one workspace, so that the other batches reuse the same memory.
+  ResetWorkspace();
+
+  const size_t batches = (predictors.n_cols + effectiveBatchSize - 1) /
+      effectiveBatchSize;
+
+  // Spread the remaining batches over the requested number of threads, if any;
+  // each thread uses its own copy of the network (sharing the parameters), so
+  // that the layer outputs do not get in the way of each other.  There may be
+  // no remaining batches, but num_threads() must still be given at least one.
+#ifdef HAS_OPENMP
+  const size_t parts = std::max<size_t>(std::min((threads == 0) ?
+      (size_t) omp_get_max_threads() : threads, batches - 1), 1);
+#else
+  const size_t parts = 1;
+#endif
+  std::vector<FFN*> networks(1, this);
+  if (parts > 1)
+  {
+    ResetReplicas(parts - 1);
+    networks.insert(networks.end(), replicas.begin(), replicas.end());
+  }
 
-  for (size_t i = 1; i < predictors.n_cols; i++)
+  #pragma omp parallel num_threads(parts) if(parts > 1)
   {
-    Forward(arma::mat(predictors.colptr(i), predictors.n_rows, 1, false, true));
+#ifdef HAS_OPENMP
+    FFN& net = *networks[omp_get_thread_num()];
+#else
+    FFN& net = *this;
+#endif
 
-    resultsTemp = boost::apply_visitor(outputParameterVisitor,
-        network.back());
-    results.col(i) = resultsTemp.col(0);
+    #pragma omp for schedule(static)
+    for (omp_size_t b = 1; b < (omp_size_t) batches; ++b)
+    {
+      const size_t begin = b * effectiveBatchSize;
+      const size_t end = std::min(begin + effectiveBatchSize,
+          (size_t) predictors.n_cols) - 1;
+      net.Forward(arma::mat(predictors.colptr(begin), predictors.n_rows,
+          end - begin + 1, false, true));
+      results.cols(begin, end) = boost::apply_visitor(
+          net.outputParameterVisitor, net.network.back());
+    }
   }
 }
 
@@ -352,6 +423,10 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
                      GradType& gradient,
                      const size_t batchSize)
 {
+  // Start a new sparse gradient for the layers that train weights themselves,
+  // so that evaluating the gradient again doesn't count it twice.
+  StepLayers(false);
+
   if (gradient.is_empty())
   {
     if (parameter.is_empty())
@@ -370,6 +445,17 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
     ResetDeterministic();
   }
 
+  // Split the batch over the requested number of threads, if any; gradient
+  // checkpointing keeps the whole batch in this network.
+#ifdef HAS_OPENMP
+  const size_t parts = (checkpointInterval > 0) ? 1 : std::min((threads == 0) ?
+      (size_t) omp_get_max_threads() : threads, batchSize);
+#else
+  const size_t parts = 1;
+#endif
+  if (parts > 1)
+    return ParallelEvaluateWithGradient(begin, gradient, batchSize, parts);
+
   Forward(predictors.cols(begin, begin + batchSize - 1));
   double res = outputLayer.Forward(
       boost::apply_visitor(outputParameterVisitor, network.back()),
@@ -385,9 +471,81 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
       responses.cols(begin, begin + batchSize - 1),
       error);
 
-  Backward();
   ResetGradients(gradient);
-  Gradient(predictors.cols(begin, begin + batchSize - 1));
+  BackwardGradient(predictors.cols(begin, begin + batchSize - 1));
+
+  return res;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+template<typename GradType>
+double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::
+ParallelEvaluateWithGradient(const size_t begin,
+                             GradType& gradient,
+                             const size_t batchSize,
+                             const size_t parts)
+{
+  ResetReplicas(parts - 1);
+
+  // The i-th network handles the points in [bounds[i], bounds[i + 1]); this
+  // network is the first one.
+  std::vector<size_t> bounds(parts + 1);
+  for (size_t i = 0; i <= parts; ++i)
+    bounds[i] = begin + i * batchSize / parts;
+
+  std::vector<FFN*> networks(1, this);
+  networks.insert(networks.end(), replicas.begin(), replicas.end());
+
+  #pragma omp parallel for schedule(static, 1)
+  for (omp_size_t i = 0; i < (omp_size_t) parts; ++i)
+    networks[i]->Forward(predictors.cols(bounds[i], bounds[i + 1] - 1));
+
+  // Evaluate the output layer on the outputs of the whole batch.
+  arma::mat output(boost::apply_visitor(outputParameterVisitor,
+      network.back()).n_rows, batchSize);
+  for (size_t i = 0; i < parts; ++i)
+  {
+    output.cols(bounds[i] - begin, bounds[i + 1] - begin - 1) =
+        boost::apply_visitor(outputParameterVisitor,
+        networks[i]->network.back());
+  }
+
+  double res = outputLayer.Forward(output,
+      responses.cols(begin, begin + batchSize - 1));
+
+  for (size_t i = 0; i < parts; ++i)
+  {
+    for (size_t j = 0; j < network.size(); ++j)
+      res += boost::apply_visitor(lossVisitor, networks[i]->network[j]);
+  }
+
+  outputLayer.Backward(output, responses.cols(begin, begin + batchSize - 1),
+      error);
+
+  // Give each network the error of its points.  This network comes last, since
+  // that overwrites the error of the whole batch.
+  for (size_t i = 1; i < parts; ++i)
+  {
+    networks[i]->error = error.cols(bounds[i] - begin,
+        bounds[i + 1] - begin - 1);
+  }
+  error = error.cols(0, bounds[1] - begin - 1);
+
+  #pragma omp parallel for schedule(static, 1)
+  for (omp_size_t i = 0; i < (omp_size_t) parts; ++i)
+  {
+    FFN& net = *networks[i];
+    if (i != 0)
+      net.gradient.zeros(parameter.n_rows, parameter.n_cols);
+
+    net.Backward();
+    net.ResetGradients((i == 0) ? gradient : net.gradient);
+    net.Gradient(predictors.cols(bounds[i], bounds[i + 1] - 1));
+  }
+
+  for (size_t i = 1; i < parts; ++i)
+    gradient += networks[i]->gradient;
 
   return res;
 }
@@ -416,11 +574,296 @@ void FFN<OutputLayerType, InitializationRuleType,
          CustomLayers...>::ResetParameters()
 {
   ResetDeterministic();
+  ResetReplicas(0);
 
   // Reset the network parameter with the given initialization rule.
   NetworkInitialization<InitializationRuleType,
                         CustomLayers...> networkInit(initializeRule);
   networkInit.Initialize(network, parameter);
+  InitializeOutputLayer();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Step()
+{
+  StepLayers(true);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::StepLayers(const bool apply)
+{
+  // The replicas share these weights and their gradient with this network.
+  for (size_t i = 0; i < network.size(); ++i)
+    boost::apply_visitor(StepVisitor(apply), network[i]);
+
+  StepOutputLayer(apply);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+template<typename T>
+typename std::enable_if<
+    HasStepCheck<T, void(T::*)()>::value, void>::type
+FFN<OutputLayerType, InitializationRuleType,
+    CustomLayers...>::StepOutputLayer(const bool apply)
+{
+  if (apply)
+    outputLayer.Step();
+  else
+    outputLayer.ResetSparseGradient();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+template<typename T>
+typename std::enable_if<
+    !HasStepCheck<T, void(T::*)()>::value, void>::type
+FFN<OutputLayerType, InitializationRuleType,
+    CustomLayers...>::StepOutputLayer(const bool /* apply */)
+{
+  // Nothing to do here.
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+template<typename T>
+typename std::enable_if<
+    HasStepCheck<T, void(T::*)()>::value, void>::type
+FFN<OutputLayerType, InitializationRuleType,
+    CustomLayers...>::InitializeOutputLayer()
+{
+  outputLayer.InitializeWeights(initializeRule);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+template<typename T>
+typename std::enable_if<
+    !HasStepCheck<T, void(T::*)()>::value, void>::type
+FFN<OutputLayerType, InitializationRuleType,
+    CustomLayers...>::InitializeOutputLayer()
+{
+  // Nothing to do here.
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::PrepareForInference()
+{
+  if (parameter.is_empty())
+    ResetParameters();
+
+  ResetReplicas(0);
+
+  // The weights of the i-th layer are parameter.rows(offsets[i],
+  // offsets[i + 1] - 1).
+  std::vector<size_t> offsets(network.size() + 1, 0);
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    offsets[i + 1] = offsets[i] + boost::apply_visitor(weightSizeVisitor,
+        network[i]);
+  }
+
+  std::vector<LayerTypes<CustomLayers...> > inferenceNetwork;
+  std::vector<size_t> keptOffsets;
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    bool remove = (boost::get<Dropout<>*>(&network[i]) != NULL) ||
+        (boost::get<AlphaDropout<>*>(&network[i]) != NULL);
+
+    // The weights of the Linear layer are aliases of the parameters, so folding
+    // changes the parameters directly.
+    BatchNorm<>** batchNorm = boost::get<BatchNorm<>*>(&network[i]);
+    Linear<>** linear = inferenceNetwork.empty() ? NULL :
+        boost::get<Linear<>*>(&inferenceNetwork.back());
+    if (batchNorm != NULL && linear != NULL)
+      remove = FoldBatchNorm(**linear, **batchNorm);
+
+    if (remove)
+    {
+      boost::apply_visitor(deleteVisitor, network[i]);
+    }
+    else
+    {
+      inferenceNetwork.push_back(network[i]);
+      keptOffsets.push_back(offsets[i]);
+    }
+  }
+
+  ReplaceNetwork(inferenceNetwork, keptOffsets);
+
+  deterministic = true;
+  ResetDeterministic();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::Quantize(const arma::mat& calibrationData)
+{
+  PrepareForInference();
+
+  // Compute the inputs of all layers for the calibration data.
+  Forward(calibrationData);
+
+  std::vector<size_t> offsets(network.size() + 1, 0);
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    offsets[i + 1] = offsets[i] + boost::apply_visitor(weightSizeVisitor,
+        network[i]);
+  }
+
+  std::vector<LayerTypes<CustomLayers...> > quantizedNetwork;
+  std::vector<LayerTypes<CustomLayers...> > replaced;
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    const arma::mat& input = (i == 0) ? calibrationData :
+        boost::apply_visitor(outputParameterVisitor, network[i - 1]);
+    const double range = input.is_empty() ? 0.0 : arma::abs(input).max();
+
+    // The weights and (if there is one) the bias follow each other in the
+    // parameters of the layer.
+    if (Linear<>** linear = boost::get<Linear<>*>(&network[i]))
+    {
+      arma::mat& weights = (*linear)->Parameters();
+      const size_t outSize = (*linear)->OutputSize();
+      const size_t inSize = (*linear)->InputSize();
+      quantizedNetwork.push_back(new QuantizedLinear<>(
+          arma::mat(weights.memptr(), outSize, inSize, false, true),
+          arma::mat(weights.memptr() + outSize * inSize, outSize, 1, false,
+          true), range));
+    }
+    else if (LinearNoBias<>** linearNoBias =
+        boost::get<LinearNoBias<>*>(&network[i]))
+    {
+      arma::mat& weights = (*linearNoBias)->Parameters();
+      quantizedNetwork.push_back(new QuantizedLinear<>(arma::mat(
+          weights.memptr(), (*linearNoBias)->OutputSize(),
+          (*linearNoBias)->InputSize(), false, true), arma::mat(), range));
+    }
+    else if (Convolution<>** convolution =
+        boost::get<Convolution<>*>(&network[i]))
+    {
+      Convolution<>& layer = **convolution;
+      arma::mat& weights = layer.Parameters();
+      const size_t filters = layer.InputSize() * layer.OutputSize();
+      const size_t filterSize = layer.KernelWidth() * layer.KernelHeight();
+      quantizedNetwork.push_back(new QuantizedConvolution<>(
+          arma::cube(weights.memptr(), layer.KernelWidth(),
+          layer.KernelHeight(), filters, false, true),
+          arma::mat(weights.memptr() + filters * filterSize,
+          layer.OutputSize(), 1, false, true), range, layer.InputWidth(),
+          layer.InputHeight(), layer.StrideWidth(), layer.StrideHeight(),
+          std::make_tuple(layer.PadWLeft(), layer.PadWRight()),
+          std::make_tuple(layer.PadHTop(), layer.PadHBottom())));
+    }
+    else
+    {
+      quantizedNetwork.push_back(network[i]);
+      continue;
+    }
+
+    replaced.push_back(network[i]);
+  }
+
+  // The replaced layers are not needed anymore.
+  for (size_t i = 0; i < replaced.size(); ++i)
+    boost::apply_visitor(deleteVisitor, replaced[i]);
+
+  ReplaceNetwork(quantizedNetwork, std::vector<size_t>(offsets.begin(),
+      offsets.end() - 1));
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::ReplaceNetwork(
+    std::vector<LayerTypes<CustomLayers...> >& newNetwork,
+    const std::vector<size_t>& weightOffsets)
+{
+  // Collect the weights of the new layers.
+  std::vector<size_t> sizes(newNetwork.size());
+  size_t weights = 0;
+  for (size_t i = 0; i < newNetwork.size(); ++i)
+  {
+    sizes[i] = boost::apply_visitor(weightSizeVisitor, newNetwork[i]);
+    weights += sizes[i];
+  }
+
+  arma::mat newParameter(weights, 1);
+  for (size_t i = 0, offset = 0; i < newNetwork.size(); ++i)
+  {
+    if (sizes[i] > 0)
+    {
+      newParameter.rows(offset, offset + sizes[i] - 1) =
+          parameter.rows(weightOffsets[i], weightOffsets[i] + sizes[i] - 1);
+    }
+    offset += sizes[i];
+  }
+
+  // Point the layers to the new parameters.  Reset() may overwrite the weights
+  // of some layers (like BatchNorm), so the weights are copied afterwards; the
+  // assignment keeps the memory, since the size does not change.
+  network = std::move(newNetwork);
+  parameter.set_size(weights, 1);
+  for (size_t i = 0, offset = 0; i < network.size(); ++i)
+  {
+    offset += boost::apply_visitor(WeightSetVisitor(parameter, offset),
+        network[i]);
+    boost::apply_visitor(resetVisitor, network[i]);
+  }
+  parameter = newParameter;
+
+  // Release everything that is only needed for training or by earlier passes.
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    boost::apply_visitor(outputParameterVisitor, network[i]).reset();
+    boost::apply_visitor(deltaVisitor, network[i]).reset();
+  }
+  workspace.reset();
+  predictors.reset();
+  responses.reset();
+  numFunctions = 0;
+  error.reset();
+  delta.reset();
+  inputParameter.reset();
+  outputParameter.reset();
+  gradient.reset();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+bool FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::FoldBatchNorm(Linear<>& linear,
+                                         BatchNorm<>& batchNorm)
+{
+  // In deterministic mode, BatchNorm computes
+  //   gamma % (x - mean) / sqrt(variance + eps) + beta,
+  // which is an affine function of the output x = W * input + b of the Linear
+  // layer.
+  const size_t size = batchNorm.InputSize();
+  const arma::mat variance = batchNorm.TrainingVariance();
+  if (size != linear.OutputSize() || !variance.is_finite())
+    return false;
+
+  const arma::mat& batchNormWeights = batchNorm.Parameters();
+  const arma::vec scale = batchNormWeights.rows(0, size - 1) /
+      arma::sqrt(variance + batchNorm.Epsilon());
+
+  arma::mat& linearWeights = linear.Parameters();
+  arma::mat weight(linearWeights.memptr(), size, linear.InputSize(), false,
+      true);
+  arma::mat bias(linearWeights.memptr() + weight.n_elem, size, 1, false, true);
+
+  weight.each_col() %= scale;
+  bias = scale % (bias - batchNorm.TrainingMean()) +
+      batchNormWeights.rows(size, 2 * size - 1);
+
+  return true;
 }
 
 template<typename OutputLayerType, typename InitializationRuleType,
@@ -452,6 +895,14 @@ template<typename InputType>
 void FFN<OutputLayerType, InitializationRuleType,
          CustomLayers...>::Forward(const InputType& input)
 {
+  // With gradient checkpointing, remember the state of the random number
+  // generator at the start of each segment, so that the backward pass can
+  // compute the released outputs again the same way.
+  const bool checkpoint = (checkpointInterval > 0) && !deterministic;
+  checkpointRandGen.clear();
+  if (checkpoint)
+    checkpointRandGen.push_back(math::randGen);
+
   boost::apply_visitor(ForwardVisitor(input,
       boost::apply_visitor(outputParameterVisitor, network.front())),
       network.front());
@@ -480,10 +931,16 @@ void FFN<OutputLayerType, InitializationRuleType,
       boost::apply_visitor(SetInputHeightVisitor(height), network[i]);
     }
 
+    if (checkpoint && i % checkpointInterval == 0)
+      checkpointRandGen.push_back(math::randGen);
+
     boost::apply_visitor(ForwardVisitor(boost::apply_visitor(
         outputParameterVisitor, network[i - 1]),
         boost::apply_visitor(outputParameterVisitor, network[i])), network[i]);
 
+    if (checkpoint && Released(i - 1))
+      boost::apply_visitor(outputParameterVisitor, network[i - 1]).reset();
+
     if (!reset)
     {
       // Get the output width.
@@ -543,6 +1000,94 @@ void FFN<OutputLayerType, InitializationRuleType,
       network[network.size() - 1]);
 }
 
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+template<typename InputType>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::BackwardGradient(const InputType& input)
+{
+  if (checkpointInterval == 0 || network.size() <= checkpointInterval)
+  {
+    Backward();
+    Gradient(input);
+    return;
+  }
+
+  const size_t n = network.size();
+  const size_t segments = (n + checkpointInterval - 1) / checkpointInterval;
+
+  // The outputs were only released if the last forward pass was in training
+  // mode.
+  const bool released = (checkpointRandGen.size() == segments);
+
+  for (size_t s = segments; s > 0; --s)
+  {
+    const size_t first = (s - 1) * checkpointInterval;
+    const size_t last = std::min(s * checkpointInterval, n) - 1;
+
+    // Compute the released outputs of the segment again, with the random
+    // numbers of the first time.
+    if (released && s < segments)
+    {
+      const std::mt19937 randGen = math::randGen;
+      math::randGen = checkpointRandGen[s - 1];
+
+      for (size_t i = first; i < last; ++i)
+      {
+        arma::mat& output = boost::apply_visitor(outputParameterVisitor,
+            network[i]);
+        if (i == 0)
+        {
+          boost::apply_visitor(ForwardVisitor(input, output), network[i]);
+        }
+        else
+        {
+          boost::apply_visitor(ForwardVisitor(boost::apply_visitor(
+              outputParameterVisitor, network[i - 1]), output), network[i]);
+        }
+      }
+
+      math::randGen = randGen;
+    }
+
+    // The first layer doesn't need a delta.
+    for (size_t i = last; i >= first && i > 0; --i)
+    {
+      const arma::mat& gy = (i == n - 1) ? error :
+          boost::apply_visitor(deltaVisitor, network[i + 1]);
+      boost::apply_visitor(BackwardVisitor(boost::apply_visitor(
+          outputParameterVisitor, network[i]), gy,
+          boost::apply_visitor(deltaVisitor, network[i])), network[i]);
+    }
+
+    for (size_t i = first; i <= last; ++i)
+    {
+      const arma::mat& gy = (i == n - 1) ? error :
+          boost::apply_visitor(deltaVisitor, network[i + 1]);
+      if (i == 0)
+      {
+        boost::apply_visitor(GradientVisitor(input, gy), network[i]);
+      }
+      else
+      {
+        boost::apply_visitor(GradientVisitor(boost::apply_visitor(
+            outputParameterVisitor, network[i - 1]), gy), network[i]);
+      }
+    }
+
+    for (size_t i = first; i < last; ++i)
+    {
+      if (released && Released(i))
+        boost::apply_visitor(outputParameterVisitor, network[i]).reset();
+    }
+
+    // Only the delta of the first layer of the segment is needed by the
+    // segment before it.
+    for (size_t i = first + 1; i <= std::min(last + 1, n - 1); ++i)
+      boost::apply_visitor(deltaVisitor, network[i]).reset();
+  }
+}
+
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 template<typename Archive>
@@ -573,10 +1118,16 @@ void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::serialize(
     std::for_each(network.begin(), network.end(),
         boost::apply_visitor(deleteVisitor));
     network.clear();
+    ResetReplicas(0);
   }
 
   ar & BOOST_SERIALIZATION_NVP(network);
 
+  // Earlier versions of the FFN code did not serialize the output layer, which
+  // may have weights of its own.
+  if (version > 2)
+    ar & BOOST_SERIALIZATION_NVP(outputLayer);
+
   // If we are loading, we need to initialize the weights.
   if (Archive::is_loading::value)
   {
@@ -599,6 +1150,107 @@ void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::serialize(
   }
 }
 
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::ResetWorkspace()
+{
+  // Check whether the outputs already point into the workspace.
+  size_t size = 0;
+  bool aliased = true;
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    const arma::mat& output = boost::apply_visitor(outputParameterVisitor,
+        network[i]);
+    if (output.mem_state != 1 || size + output.n_elem > workspace.n_elem ||
+        output.memptr() != workspace.memptr() + size)
+    {
+      aliased = false;
+    }
+
+    size += output.n_elem;
+  }
+
+  // Very small workspaces would be stored inside the matrix object, and then
+  // moving the network would invalidate the aliases.
+  if (aliased || size <= arma::arma_config::mat_prealloc)
+    return;
+
+  if (workspace.n_elem != size)
+    workspace.set_size(size);
+
+  size_t offset = 0;
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    arma::mat& output = boost::apply_visitor(outputParameterVisitor,
+        network[i]);
+    const size_t rows = output.n_rows;
+    const size_t cols = output.n_cols;
+    math::MakeAlias(output, workspace.memptr() + offset, rows, cols, false);
+    offset += rows * cols;
+  }
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::ResetReplicas(const size_t numReplicas)
+{
+  // Remove the replicas that are not needed; if the structure of the network
+  // changed, all of them have to be built again.
+  bool changed = false;
+  for (size_t i = 0; i < replicas.size(); ++i)
+  {
+    if (replicas[i]->network.size() != network.size())
+      changed = true;
+  }
+
+  while (replicas.size() > (changed ? 0 : numReplicas))
+  {
+    delete replicas.back();
+    replicas.pop_back();
+  }
+
+  while (replicas.size() < numReplicas)
+  {
+    FFN* replica = new FFN(outputLayer, initializeRule);
+    for (size_t i = 0; i < network.size(); ++i)
+      replica->network.push_back(boost::apply_visitor(copyVisitor, network[i]));
+
+    replica->width = width;
+    replica->height = height;
+    replica->reset = reset;
+    replicas.push_back(replica);
+  }
+
+  for (size_t r = 0; r < replicas.size(); ++r)
+  {
+    FFN& replica = *replicas[r];
+
+    // Point the weights of the layers to the parameters of this network.
+    if (replica.parameter.memptr() != parameter.memptr() ||
+        replica.parameter.n_elem != parameter.n_elem)
+    {
+      math::MakeAlias(replica.parameter, parameter.memptr(), parameter.n_rows,
+          parameter.n_cols, false);
+
+      size_t offset = 0;
+      for (size_t i = 0; i < replica.network.size(); ++i)
+      {
+        offset += boost::apply_visitor(WeightSetVisitor(replica.parameter,
+            offset), replica.network[i]);
+        boost::apply_visitor(resetVisitor, replica.network[i]);
+      }
+    }
+
+    if (replica.deterministic != deterministic)
+    {
+      replica.deterministic = deterministic;
+      replica.ResetDeterministic();
+    }
+  }
+}
+
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 void FFN<OutputLayerType, InitializationRuleType,
@@ -620,6 +1272,10 @@ void FFN<OutputLayerType, InitializationRuleType,
   std::swap(inputParameter, network.inputParameter);
   std::swap(outputParameter, network.outputParameter);
   std::swap(gradient, network.gradient);
+  std::swap(workspace, network.workspace);
+  std::swap(threads, network.threads);
+  std::swap(checkpointInterval, network.checkpointInterval);
+  std::swap(replicas, network.replicas);
 };
 
 template<typename OutputLayerType, typename InitializationRuleType,
@@ -640,7 +1296,9 @@ FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::FFN(
     delta(network.delta),
     inputParameter(network.inputParameter),
     outputParameter(network.outputParameter),
-    gradient(network.gradient)
+    gradient(network.gradient),
+    threads(network.threads),
+    checkpointInterval(network.checkpointInterval)
 {
   // Build new layers according to source network
   for (size_t i = 0; i < network.network.size(); ++i)
@@ -668,7 +1326,11 @@ FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::FFN(
     delta(std::move(network.delta)),
     inputParameter(std::move(network.inputParameter)),
     outputParameter(std::move(network.outputParameter)),
-    gradient(std::move(network.gradient))
+    gradient(std::move(network.gradient)),
+    workspace(std::move(network.workspace)),
+    threads(network.threads),
+    checkpointInterval(network.checkpointInterval),
+    replicas(std::move(network.replicas))
 {
   this->network = std::move(network.network);
 };
@@ -35,6 +35,11 @@ namespace ann /** Artificial Neural Network. **/ {
  * GANs have been used in Text-to-Image Synthesis, Medical Drug Discovery,
  * High Resolution Imagery Generation, Neural Machine Translation and so on.
  *
+ * At every step, the generator makes the batch of fake data while the
+ * discriminator evaluates the batch of real data.  The two networks don't
+ * share any layers or parameters, so with OpenMP these run at the same time
+ * on two threads.
+ *
  * For more information, see the following paper:
  *
  * @code
@@ -337,6 +342,18 @@ class GAN
   */
   void ResetDeterministic();
 
+  /**
+   * Draw new noise into the noise matrix and run the generator on it, while
+   * the given function runs the discriminator on the real data.  With OpenMP,
+   * the generator and the discriminator run at the same time on two threads.
+   * The noise is drawn before, since the noise function may use the shared
+   * random number generator.
+   *
+   * @param discriminatorFunction Function that runs the discriminator.
+   */
+  template<typename DiscriminatorFunctionType>
+  void GenerateWhile(DiscriminatorFunctionType&& discriminatorFunction);
+
   //! Locally stored parameter for training data + noise data.
   arma::mat predictors;
   //! Locally stored parameters of the network.
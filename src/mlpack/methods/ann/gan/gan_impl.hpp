@@ -258,14 +258,15 @@ GAN<Model, InitializationRuleType, Noise, PolicyType>::Evaluate(
   currentTarget = arma::mat(responses.memptr() + i, 1, batchSize, false,
       false);
 
-  discriminator.Forward(currentInput);
-  double res = discriminator.outputLayer.Forward(
-      boost::apply_visitor(
-      outputParameterVisitor,
-      discriminator.network.back()), currentTarget);
-
-  noise.imbue( [&]() { return noiseFunction();} );
-  generator.Forward(noise);
+  double res = 0;
+  GenerateWhile([&]()
+  {
+    discriminator.Forward(currentInput);
+    res = discriminator.outputLayer.Forward(
+        boost::apply_visitor(
+        outputParameterVisitor,
+        discriminator.network.back()), currentTarget);
+  });
 
   predictors.cols(numFunctions, numFunctions + batchSize - 1) =
       boost::apply_visitor(outputParameterVisitor, generator.network.back());
@@ -335,12 +336,14 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
       gradientGenerator.n_elem,
       discriminator.Parameters().n_elem, 1, false, false);
 
-  // Get the gradients of the Discriminator.
-  double res = discriminator.EvaluateWithGradient(discriminator.parameter,
-      i, gradientDiscriminator, batchSize);
-
-  noise.imbue( [&]() { return noiseFunction();} );
-  generator.Forward(noise);
+  // Get the gradients of the Discriminator, while the Generator makes the fake
+  // data.
+  double res = 0;
+  GenerateWhile([&]()
+  {
+    res = discriminator.EvaluateWithGradient(discriminator.parameter, i,
+        gradientDiscriminator, batchSize);
+  });
   predictors.cols(numFunctions, numFunctions + batchSize - 1) =
       boost::apply_visitor(outputParameterVisitor, generator.network.back());
   responses.cols(numFunctions, numFunctions + batchSize - 1) =
@@ -479,6 +482,29 @@ ResetDeterministic()
   this->generator.ResetDeterministic();
 }
 
+template<
+  typename Model,
+  typename InitializationRuleType,
+  typename Noise,
+  typename PolicyType
+>
+template<typename DiscriminatorFunctionType>
+void GAN<Model, InitializationRuleType, Noise, PolicyType>::GenerateWhile(
+    DiscriminatorFunctionType&& discriminatorFunction)
+{
+  // The noise matrix is allocated once, in ResetData().
+  noise.imbue( [&]() { return noiseFunction();} );
+
+  #pragma omp parallel for num_threads(2) schedule(static, 1)
+  for (omp_size_t t = 0; t < 2; ++t)
+  {
+    if (t == 0)
+      discriminatorFunction();
+    else
+      generator.Forward(noise);
+  }
+}
+
 template<
   typename Model,
   typename InitializationRuleType,
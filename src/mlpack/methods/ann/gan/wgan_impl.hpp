@@ -50,14 +50,15 @@ GAN<Model, InitializationRuleType, Noise, PolicyType>::Evaluate(
   currentTarget = arma::mat(responses.memptr() + i, 1, batchSize, false,
       false);
 
-  discriminator.Forward(currentInput);
-  double res = discriminator.outputLayer.Forward(
-      boost::apply_visitor(
-      outputParameterVisitor,
-      discriminator.network.back()), currentTarget);
-
-  noise.imbue( [&]() { return noiseFunction();} );
-  generator.Forward(noise);
+  double res = 0;
+  GenerateWhile([&]()
+  {
+    discriminator.Forward(currentInput);
+    res = discriminator.outputLayer.Forward(
+        boost::apply_visitor(
+        outputParameterVisitor,
+        discriminator.network.back()), currentTarget);
+  });
 
   predictors.cols(numFunctions, numFunctions + batchSize - 1) =
       boost::apply_visitor(outputParameterVisitor, generator.network.back());
@@ -127,12 +128,14 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
       gradientGenerator.n_elem,
       discriminator.Parameters().n_elem, 1, false, false);
 
-  // Get the gradients of the Discriminator.
-  double res = discriminator.EvaluateWithGradient(discriminator.parameter,
-      i, gradientDiscriminator, batchSize);
-
-  noise.imbue( [&]() { return noiseFunction();} );
-  generator.Forward(noise);
+  // Get the gradients of the Discriminator, while the Generator makes the fake
+  // data.
+  double res = 0;
+  GenerateWhile([&]()
+  {
+    res = discriminator.EvaluateWithGradient(discriminator.parameter, i,
+        gradientDiscriminator, batchSize);
+  });
   predictors.cols(numFunctions, numFunctions + batchSize - 1) =
       boost::apply_visitor(outputParameterVisitor, generator.network.back());
   responses.cols(numFunctions, numFunctions + batchSize - 1) =
@@ -51,14 +51,15 @@ GAN<Model, InitializationRuleType, Noise, PolicyType>::Evaluate(
   currentTarget = arma::mat(responses.memptr() + i, 1, batchSize, false,
       false);
 
-  discriminator.Forward(std::move(currentInput));
-  double res = discriminator.outputLayer.Forward(
-      std::move(boost::apply_visitor(
-      outputParameterVisitor,
-      discriminator.network.back())), std::move(currentTarget));
-
-  noise.imbue( [&]() { return noiseFunction();} );
-  generator.Forward(std::move(noise));
+  double res = 0;
+  GenerateWhile([&]()
+  {
+    discriminator.Forward(std::move(currentInput));
+    res = discriminator.outputLayer.Forward(
+        std::move(boost::apply_visitor(
+        outputParameterVisitor,
+        discriminator.network.back())), std::move(currentTarget));
+  });
 
   arma::mat generatedData = boost::apply_visitor(outputParameterVisitor,
       generator.network.back());
@@ -144,12 +145,14 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
   currentInput = arma::mat(predictors.memptr() + (i * predictors.n_rows),
       predictors.n_rows, batchSize, false, false);
 
-  // Get the gradients of the Discriminator.
-  double res = discriminator.EvaluateWithGradient(discriminator.parameter,
-      i, gradientDiscriminator, batchSize);
-
-  noise.imbue( [&]() { return noiseFunction();} );
-  generator.Forward(std::move(noise));
+  // Get the gradients of the Discriminator, while the Generator makes the fake
+  // data.
+  double res = 0;
+  GenerateWhile([&]()
+  {
+    res = discriminator.EvaluateWithGradient(discriminator.parameter, i,
+        gradientDiscriminator, batchSize);
+  });
   arma::mat generatedData = boost::apply_visitor(outputParameterVisitor,
       generator.network.back());
 
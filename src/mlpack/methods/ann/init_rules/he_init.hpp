@@ -61,7 +61,8 @@ class HeInitialization
    * @param rows Number of rows.
    * @param cols Number of columns.
    */
-  void Initialize(arma::mat& W, const size_t rows, const size_t cols)
+  template<typename eT>
+  void Initialize(arma::Mat<eT>& W, const size_t rows, const size_t cols)
   {
     // He initialization rule says to initialize weights with random
     // values taken from a gaussian distribution with mean = 0 and
@@ -87,7 +88,8 @@ class HeInitialization
    * @param cols Number of columns.
    * @param slices Number of slices.
    */
-  void Initialize(arma::cube & W,
+  template<typename eT>
+  void Initialize(arma::Cube<eT>& W,
                   const size_t rows,
                   const size_t cols,
                   const size_t slices)
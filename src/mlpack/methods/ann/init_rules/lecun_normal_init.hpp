@@ -65,7 +65,8 @@ class LecunNormalInitialization
    * @param rows Number of rows.
    * @param cols Number of columns.
    */
-  void Initialize(arma::mat& W,
+  template<typename eT>
+  void Initialize(arma::Mat<eT>& W,
                   const size_t rows,
                   const size_t cols)
   {
@@ -93,7 +94,8 @@ class LecunNormalInitialization
    * @param cols Number of columns.
    * @param slices Number of slices.
    */
-  void Initialize(arma::cube & W,
+  template<typename eT>
+  void Initialize(arma::Cube<eT>& W,
                   const size_t rows,
                   const size_t cols,
                   const size_t slices)
@@ -17,6 +17,7 @@
 
 #include "../visitor/reset_visitor.hpp"
 #include "../visitor/weight_size_visitor.hpp"
+#include "../visitor/weight_init_visitor.hpp"
 #include "../visitor/weight_set_visitor.hpp"
 #include "init_rules_traits.hpp"
 
@@ -97,6 +98,11 @@ class NetworkInitialization
           network[i]);
 
       boost::apply_visitor(resetVisitor, network[i]);
+
+      // The layers that train some weights themselves (like SparseEmbedding)
+      // don't keep them in the parameter.
+      boost::apply_visitor(WeightInitVisitor<InitializationRuleType>(
+          initializeRule), network[i]);
     }
   }
 
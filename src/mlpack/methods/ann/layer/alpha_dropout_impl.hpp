@@ -49,9 +49,13 @@ void AlphaDropout<InputDataType, OutputDataType>::Forward(
     // Set values to alphaDash with probability ratio.  Then apply affine
     // transformation so as to keep mean and variance of outputs to their
     // original values.
-    mask = arma::randu< arma::Mat<eT> >(input.n_rows, input.n_cols);
-    mask.transform( [&](double val) { return (val > ratio); } );
-    output = (input % mask + alphaDash * (1 - mask)) * a + b;
+    mask.Generate(input.n_rows, input.n_cols, ratio);
+    output.set_size(input.n_rows, input.n_cols);
+
+    const eT alphaDashT = (eT) alphaDash, aT = (eT) a, bT = (eT) b;
+    mask.Transform(input.memptr(), output.memptr(),
+        [alphaDashT, aT, bT](const eT x, const eT m)
+        { return (x * m + alphaDashT * (1 - m)) * aT + bT; });
   }
 }
 
@@ -60,7 +64,11 @@ template<typename eT>
 void AlphaDropout<InputDataType, OutputDataType>::Backward(
     const arma::Mat<eT>& /* input */, const arma::Mat<eT>& gy, arma::Mat<eT>& g)
 {
-  g = gy % mask * a;
+  g.set_size(gy.n_rows, gy.n_cols);
+
+  const eT aT = (eT) a;
+  mask.Transform(gy.memptr(), g.memptr(),
+      [aT](const eT x, const eT m) { return x * m * aT; });
 }
 
 template<typename InputDataType, typename OutputDataType>
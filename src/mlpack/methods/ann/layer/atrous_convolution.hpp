@@ -19,6 +19,7 @@
 #include <mlpack/methods/ann/convolution_rules/naive_convolution.hpp>
 #include <mlpack/methods/ann/convolution_rules/fft_convolution.hpp>
 #include <mlpack/methods/ann/convolution_rules/svd_convolution.hpp>
+#include <mlpack/methods/ann/convolution_rules/im2col_convolution.hpp>
 #include <mlpack/core/util/to_lower.hpp>
 
 #include "layer_types.hpp"
@@ -34,6 +35,11 @@ namespace ann /** Artificial Neural Network. */ {
  * spaces included between the kernel cells, in order to capture a larger
  * field of reception, without having to increase dicrete kernel sizes.
  *
+ * If Im2ColConvolution is used as a convolution rule, the corresponding pass
+ * unrolls the dilated patches of all the input maps of each point and
+ * convolves them with all the filters in one matrix product, without dilating
+ * the filters.  This is much faster than the default NaiveConvolution.
+ *
  * @tparam ForwardConvolutionRule Atrous Convolution to perform forward process.
  * @tparam BackwardConvolutionRule Atrous Convolution to perform backward process.
  * @tparam GradientConvolutionRule Atrous Convolution to calculate gradient.
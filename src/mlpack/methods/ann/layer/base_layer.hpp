@@ -26,6 +26,7 @@
 #include <mlpack/methods/ann/activation_functions/gelu_function.hpp>
 #include <mlpack/methods/ann/activation_functions/elliot_function.hpp>
 #include <mlpack/methods/ann/activation_functions/elish_function.hpp>
+#include <mlpack/methods/ann/activation_functions/fast_activation_functions.hpp>
 
 namespace mlpack {
 namespace ann /** Artificial Neural Network. */ {
@@ -202,8 +202,8 @@ class BatchNorm
   //! Locally-stored normalized input.
   OutputDataType normalized;
 
-  //! Locally-stored zero mean input.
-  OutputDataType inputMean;
+  //! Locally-stored inverse standard deviation of the batch.
+  OutputDataType stdInv;
 }; // class BatchNorm
 
 } // namespace ann
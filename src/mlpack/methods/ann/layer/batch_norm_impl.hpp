@@ -65,66 +65,98 @@ template<typename eT>
 void BatchNorm<InputDataType, OutputDataType>::Forward(
     const arma::Mat<eT>& input, arma::Mat<eT>& output)
 {
+  output.set_size(input.n_rows, input.n_cols);
+
   // Mean and variance over the entire training set will be used to compute
   // the forward pass when deterministic is set to true.
   if (deterministic)
   {
-    // Normalize the input and scale and shift the output.
-    output = input.each_col() - runningMean;
-    output.each_col() %= gamma / arma::sqrt(runningVariance / count + eps);
-    output.each_col() += beta;
+    // Normalize the input and scale and shift the output in one pass.
+    const OutputDataType scale = gamma /
+        arma::sqrt(runningVariance / count + eps);
+    const OutputDataType shift = beta - runningMean % scale;
+    for (size_t i = 0; i < input.n_cols; ++i)
+      for (size_t j = 0; j < input.n_rows; ++j)
+        output(j, i) = input(j, i) * scale[j] + shift[j];
+
+    return;
   }
-  else
-  {
-    mean = arma::mean(input, 1);
-    variance = arma::var(input, 1, 1);
 
-    // Normalize the input.
-    output = input.each_col() - mean;
-    inputMean = output;
-    output.each_col() /= arma::sqrt(variance + eps);
-
-    // Use Welford method to compute the sample variance and mean.
-    for (size_t i = 0; i < input.n_cols; i++)
+  // Use Welford method to compute the mean and the sum of squared deviations
+  // of the batch in one pass over the input.
+  mean.zeros(input.n_rows, 1);
+  variance.zeros(input.n_rows, 1);
+  for (size_t i = 0; i < input.n_cols; ++i)
+  {
+    const double invCount = 1.0 / (i + 1);
+    for (size_t j = 0; j < input.n_rows; ++j)
     {
-      count += 1;
-
-      OutputDataType diff = input.col(i) - runningMean;
-      runningMean = runningMean + diff / count;
-      runningVariance += diff % (input.col(i) - runningMean);
+      const double diff = input(j, i) - mean[j];
+      mean[j] += diff * invCount;
+      variance[j] += diff * (input(j, i) - mean[j]);
     }
+  }
 
-    // Reused in the backward and gradient step.
-    normalized = output;
+  // Merge the batch into the mean and variance of the training set; this is
+  // the same as continuing the Welford method over the batch.
+  const size_t total = count + input.n_cols;
+  for (size_t j = 0; j < input.n_rows; ++j)
+  {
+    const double diff = mean[j] - runningMean[j];
+    runningMean[j] += diff * input.n_cols / total;
+    runningVariance[j] += variance[j] +
+        diff * diff * ((double) count * input.n_cols / total);
+  }
+  count = total;
 
-    // Scale and shift the output.
-    output.each_col() %= gamma;
-    output.each_col() += beta;
+  variance /= input.n_cols;
+  stdInv = 1.0 / arma::sqrt(variance + eps);
+
+  // Normalize the input, and scale and shift the output, in a second pass.
+  // The normalized input is reused in the backward and gradient step.
+  normalized.set_size(input.n_rows, input.n_cols);
+  for (size_t i = 0; i < input.n_cols; ++i)
+  {
+    for (size_t j = 0; j < input.n_rows; ++j)
+    {
+      normalized(j, i) = (input(j, i) - mean[j]) * stdInv[j];
+      output(j, i) = normalized(j, i) * gamma[j] + beta[j];
+    }
   }
 }
 
 template<typename InputDataType, typename OutputDataType>
 template<typename eT>
 void BatchNorm<InputDataType, OutputDataType>::Backward(
-    const arma::Mat<eT>& input, const arma::Mat<eT>& gy, arma::Mat<eT>& g)
+    const arma::Mat<eT>& /* input */, const arma::Mat<eT>& gy, arma::Mat<eT>& g)
 {
-  const arma::mat stdInv = 1.0 / arma::sqrt(variance + eps);
-
-  // Step 1: dl / dxhat.
-  const arma::mat norm = gy.each_col() % gamma;
-
-  // Step 2: sum dl / dxhat * (x - mu) * -0.5 * stdInv^3.
-  const arma::mat var = arma::sum(norm % inputMean, 1) %
-      arma::pow(stdInv, 3.0) * -0.5;
-
-  // Step 4: dl / dxhat * 1 / stdInv + variance * 2 * (x - mu) / m +
-  // dl / dmu * 1 / m.
-  g = (norm.each_col() % stdInv) + (inputMean.each_col() %
-      var * 2 / input.n_cols);
+  // With dl / dxhat = dl / dy * gamma, the error is
+  // stdInv * (dl / dxhat - mean(dl / dxhat) - xhat * mean(dl / dxhat * xhat)),
+  // where the means are over the batch.  The means are computed in a first
+  // pass, and the error in a second one.
+  arma::vec normMean(gy.n_rows, arma::fill::zeros);
+  arma::vec normInputMean(gy.n_rows, arma::fill::zeros);
+  for (size_t i = 0; i < gy.n_cols; ++i)
+  {
+    for (size_t j = 0; j < gy.n_rows; ++j)
+    {
+      const double norm = gy(j, i) * gamma[j];
+      normMean[j] += norm;
+      normInputMean[j] += norm * normalized(j, i);
+    }
+  }
+  normMean /= gy.n_cols;
+  normInputMean /= gy.n_cols;
 
-  // Step 3: sum (dl / dxhat * -1 / stdInv) + variance *
-  // (sum -2 * (x - mu)) / m.
-  g.each_col() += arma::sum(norm.each_col() % -stdInv, 1) / input.n_cols;
+  g.set_size(gy.n_rows, gy.n_cols);
+  for (size_t i = 0; i < gy.n_cols; ++i)
+  {
+    for (size_t j = 0; j < gy.n_rows; ++j)
+    {
+      g(j, i) = stdInv[j] * (gy(j, i) * gamma[j] - normMean[j] -
+          normalized(j, i) * normInputMean[j]);
+    }
+  }
 }
 
 template<typename InputDataType, typename OutputDataType>
@@ -134,14 +166,16 @@ void BatchNorm<InputDataType, OutputDataType>::Gradient(
     const arma::Mat<eT>& error,
     arma::Mat<eT>& gradient)
 {
-  gradient.set_size(size + size, 1);
-
-  // Step 5: dl / dy * xhat.
-  gradient.submat(0, 0, gamma.n_elem - 1, 0) = arma::sum(normalized % error, 1);
-
-  // Step 6: dl / dy.
-  gradient.submat(gamma.n_elem, 0, gradient.n_elem - 1, 0) =
-      arma::sum(error, 1);
+  // dl / dgamma = sum dl / dy * xhat and dl / dbeta = sum dl / dy, in one pass.
+  gradient.zeros(size + size, 1);
+  for (size_t i = 0; i < error.n_cols; ++i)
+  {
+    for (size_t j = 0; j < error.n_rows; ++j)
+    {
+      gradient[j] += normalized(j, i) * error(j, i);
+      gradient[size + j] += error(j, i);
+    }
+  }
 }
 
 template<typename InputDataType, typename OutputDataType>
@@ -18,6 +18,7 @@
 #include <mlpack/methods/ann/convolution_rules/naive_convolution.hpp>
 #include <mlpack/methods/ann/convolution_rules/fft_convolution.hpp>
 #include <mlpack/methods/ann/convolution_rules/svd_convolution.hpp>
+#include <mlpack/methods/ann/convolution_rules/im2col_convolution.hpp>
 #include <mlpack/core/util/to_lower.hpp>
 
 #include "layer_types.hpp"
@@ -30,6 +31,11 @@ namespace ann /** Artificial Neural Network. */ {
  * Implementation of the Convolution class. The Convolution class represents a
  * single layer of a neural network.
  *
+ * If Im2ColConvolution is used as a convolution rule, the corresponding pass
+ * convolves all the input maps of each point with all the filters in one
+ * matrix product, which is much faster than the default NaiveConvolution for
+ * anything but tiny inputs.
+ *
  * @tparam ForwardConvolutionRule Convolution to perform forward process.
  * @tparam BackwardConvolutionRule Convolution to perform backward process.
  * @tparam GradientConvolutionRule Convolution to calculate gradient.
@@ -201,6 +201,33 @@ void Convolution<
       outSize * batchSize, false, false);
   outputTemp.zeros();
 
+  if (IsIm2ColConvolution<ForwardConvolutionRule>::value)
+  {
+    // Convolve all the input maps of each point with all the filters at once.
+    const bool padded = (padWLeft != 0 || padWRight != 0 || padHTop != 0 ||
+        padHBottom != 0);
+    const arma::cube& mappedInput = padded ? inputPaddedTemp : inputTemp;
+    const arma::mat weightMat(weight.memptr(), weight.n_rows * weight.n_cols *
+        inSize, outSize, false, true);
+
+    arma::mat columns;
+    for (size_t b = 0; b < batchSize; ++b)
+    {
+      Im2ColConvolution<>::Im2Col(mappedInput.slice_memptr(b * inSize),
+          mappedInput.n_rows, mappedInput.n_cols, inSize, kernelWidth,
+          kernelHeight, columns, strideWidth, strideHeight);
+
+      arma::Mat<eT> outputPoint(output.colptr(b), wConv * hConv, outSize,
+          false, true);
+      outputPoint = columns.t() * weightMat;
+      outputPoint.each_row() += bias.t();
+    }
+
+    outputWidth = outputTemp.n_rows;
+    outputHeight = outputTemp.n_cols;
+    return;
+  }
+
   for (size_t outMap = 0, outMapIdx = 0, batchCount = 0; outMap <
       outSize * batchSize; outMap++)
   {
@@ -262,6 +289,49 @@ void Convolution<
       inSize * batchSize, false, false);
   gTemp.zeros();
 
+  if (IsIm2ColConvolution<BackwardConvolutionRule>::value)
+  {
+    // Compute the error of all the unrolled input patches of each point at
+    // once, and add them back onto the (padded) input maps.
+    const bool padded = (padWLeft != 0 || padWRight != 0 || padHTop != 0 ||
+        padHBottom != 0);
+    const arma::mat weightMat(weight.memptr(), weight.n_rows * weight.n_cols *
+        inSize, outSize, false, true);
+
+    arma::mat columns;
+    arma::cube gPadded;
+    for (size_t b = 0; b < batchSize; ++b)
+    {
+      const arma::Mat<eT> errorPoint(mappedError.slice_memptr(b * outSize),
+          outputWidth * outputHeight, outSize, false, true);
+      columns = weightMat * errorPoint.t();
+
+      if (padded)
+      {
+        gPadded.zeros(inputWidth + padWLeft + padWRight,
+            inputHeight + padHTop + padHBottom, inSize);
+        Im2ColConvolution<>::Col2Im(columns, gPadded.n_rows, gPadded.n_cols,
+            inSize, kernelWidth, kernelHeight, gPadded.memptr(), strideWidth,
+            strideHeight);
+
+        for (size_t inMap = 0; inMap < inSize; ++inMap)
+        {
+          gTemp.slice(inMap + b * inSize) = gPadded.slice(inMap).submat(
+              padWLeft, padHTop, padWLeft + inputWidth - 1,
+              padHTop + inputHeight - 1);
+        }
+      }
+      else
+      {
+        Im2ColConvolution<>::Col2Im(columns, inputWidth, inputHeight, inSize,
+            kernelWidth, kernelHeight, gTemp.slice_memptr(b * inSize),
+            strideWidth, strideHeight);
+      }
+    }
+
+    return;
+  }
+
   for (size_t outMap = 0, outMapIdx = 0, batchCount = 0; outMap <
       outSize * batchSize; outMap++)
   {
@@ -321,6 +391,35 @@ void Convolution<
       weight.n_cols, weight.n_slices, false, false);
   gradientTemp.zeros();
 
+  if (IsIm2ColConvolution<GradientConvolutionRule>::value)
+  {
+    // Correlate the unrolled input patches of each point with the errors of
+    // all the output maps at once.
+    const bool padded = (padWLeft != 0 || padWRight != 0 || padHTop != 0 ||
+        padHBottom != 0);
+    const arma::cube& mappedInput = padded ? inputPaddedTemp : inputTemp;
+    arma::Mat<eT> weightGradient(gradient.memptr(), weight.n_rows *
+        weight.n_cols * inSize, outSize, false, true);
+    arma::Col<eT> biasGradient(gradient.memptr() + weight.n_elem, outSize,
+        false, true);
+    biasGradient.zeros();
+
+    arma::mat columns;
+    for (size_t b = 0; b < batchSize; ++b)
+    {
+      Im2ColConvolution<>::Im2Col(mappedInput.slice_memptr(b * inSize),
+          mappedInput.n_rows, mappedInput.n_cols, inSize, kernelWidth,
+          kernelHeight, columns, strideWidth, strideHeight);
+
+      const arma::Mat<eT> errorPoint(mappedError.slice_memptr(b * outSize),
+          outputWidth * outputHeight, outSize, false, true);
+      weightGradient += columns * errorPoint;
+      biasGradient += arma::sum(errorPoint, 0).t();
+    }
+
+    return;
+  }
+
   for (size_t outMap = 0, outMapIdx = 0, batchCount = 0; outMap <
       outSize * batchSize; outMap++)
   {
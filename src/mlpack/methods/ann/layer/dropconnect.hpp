@@ -20,6 +20,7 @@
 #include "add_merge.hpp"
 #include "linear.hpp"
 #include "sequential.hpp"
+#include "dropout_mask.hpp"
 
 namespace mlpack {
 namespace ann /** Artificial Neural Network. */ {
@@ -175,8 +176,8 @@ class DropConnect
   //! Locally-stored output parameter object.
   OutputDataType outputParameter;
 
-  //! Locally-stored mask object.
-  OutputDataType mask;
+  //! Locally-stored mask of the weights, one bit per weight.
+  DropoutMask mask;
 
   //! If true dropout and scaling is disabled, see notes above.
   bool deterministic;
@@ -45,9 +45,12 @@ void Dropout<InputDataType, OutputDataType>::Forward(
   {
     // Scale with input / (1 - ratio) and set values to zero with probability
     // 'ratio'.
-    mask = arma::randu<arma::Mat<eT> >(input.n_rows, input.n_cols);
-    mask.transform([&](double val) { return (val > ratio); });
-    output = input % mask * scale;
+    mask.Generate(input.n_rows, input.n_cols, ratio);
+    output.set_size(input.n_rows, input.n_cols);
+
+    const eT s = (eT) scale;
+    mask.Transform(input.memptr(), output.memptr(),
+        [s](const eT x, const eT m) { return x * m * s; });
   }
 }
 
@@ -58,7 +61,11 @@ void Dropout<InputDataType, OutputDataType>::Backward(
     const arma::Mat<eT>& gy,
     arma::Mat<eT>& g)
 {
-  g = gy % mask * scale;
+  g.set_size(gy.n_rows, gy.n_cols);
+
+  const eT s = (eT) scale;
+  mask.Transform(gy.memptr(), g.memptr(),
+      [s](const eT x, const eT m) { return x * m * s; });
 }
 
 template<typename InputDataType, typename OutputDataType>
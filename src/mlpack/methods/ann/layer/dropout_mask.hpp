@@ -0,0 +1,133 @@
+/**
+ * @file methods/ann/layer/dropout_mask.hpp
+ *
+ * Definition of the DropoutMask class, the packed random bitmask shared by the
+ * dropout layers.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_DROPOUT_MASK_HPP
+#define MLPACK_METHODS_ANN_LAYER_DROPOUT_MASK_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/random_stream.hpp>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * A random mask of the elements of a matrix, where each element is kept with
+ * probability 1 - ratio.  The mask is stored as packed bits, one bit per
+ * element, in a buffer that is reused from one call of Generate() to the next.
+ * The bits are drawn from the counter-based Philox4x32 generator, whose rounds
+ * are computed for several blocks at once; each 32-bit number it gives is
+ * compared against a fixed threshold, so no floating-point numbers are
+ * generated.  The key of the generator is drawn from the global mlpack random
+ * generator on every call of Generate(), so the masks follow
+ * math::RandomSeed().
+ */
+class DropoutMask
+{
+ public:
+  //! Create an empty mask.
+  DropoutMask() : rows(0), cols(0) { /* Nothing to do. */ }
+
+  /**
+   * Draw a new mask for a matrix of the given size.
+   *
+   * @param nRows Number of rows of the masked matrix.
+   * @param nCols Number of columns of the masked matrix.
+   * @param ratio The probability of dropping an element.
+   */
+  void Generate(const size_t nRows, const size_t nCols, const double ratio)
+  {
+    rows = nRows;
+    cols = nCols;
+
+    const size_t n = nRows * nCols;
+    const size_t numWords = (n + 31) / 32;
+    bits.resize(numWords);
+
+    // An element is kept if its number is at least ratio * 2^32.
+    const double scaled = std::ceil(std::min(std::max(ratio, 0.0), 1.0) *
+        4294967296.0);
+    const uint64_t threshold = (uint64_t) scaled;
+
+    // Networks may run at the same time (like the two directions of a BRNN),
+    // so only one of them draws from the shared generator at a time.
+    uint64_t seed;
+    #pragma omp critical(dropoutMaskSeed)
+    seed = ((uint64_t) math::randGen() << 32) | (uint64_t) math::randGen();
+    const math::Philox4x32 engine(seed);
+
+    // Each word of 32 bits takes the numbers of eight blocks.
+    #pragma omp parallel for if (numWords > 4096)
+    for (omp_size_t w = 0; w < (omp_size_t) numWords; ++w)
+    {
+      uint32_t numbers[32];
+      engine.Blocks(8 * (uint64_t) w, 8, numbers);
+
+      uint32_t word = 0;
+      for (size_t k = 0; k < 32; ++k)
+        word |= (uint32_t) ((uint64_t) numbers[k] >= threshold) << k;
+      bits[w] = word;
+    }
+  }
+
+  /**
+   * Compute out[i] = f(in[i], m[i]) for each element of the masked matrix,
+   * where m[i] is 1 if the element is kept and 0 otherwise.  The input and
+   * output may be the same memory.
+   *
+   * @param in The input values.
+   * @param out Memory to store the output values into.
+   * @param f The function to apply, taking the value and its mask.
+   */
+  template<typename eT, typename FunctionType>
+  void Transform(const eT* in, eT* out, FunctionType f) const
+  {
+    const size_t n = rows * cols;
+    for (size_t start = 0, w = 0; start < n; start += 32, ++w)
+    {
+      const uint32_t word = bits[w];
+      const size_t count = std::min((size_t) 32, n - start);
+      for (size_t k = 0; k < count; ++k)
+        out[start + k] = f(in[start + k], (eT) ((word >> k) & 1));
+    }
+  }
+
+  //! Get whether the element with the given (linear) index is kept.
+  bool operator[](const size_t i) const
+  { return (bits[i / 32] >> (i % 32)) & 1; }
+
+  //! Expand the mask to a matrix of ones and zeros.
+  template<typename MatType>
+  MatType ToMatrix() const
+  {
+    MatType m(rows, cols);
+    for (size_t i = 0; i < m.n_elem; ++i)
+      m[i] = (*this)[i];
+    return m;
+  }
+
+  //! Get the number of rows of the masked matrix.
+  size_t Rows() const { return rows; }
+  //! Get the number of columns of the masked matrix.
+  size_t Cols() const { return cols; }
+
+ private:
+  //! The packed bits of the mask, 32 elements per word.
+  std::vector<uint32_t> bits;
+  //! The number of rows of the masked matrix.
+  size_t rows;
+  //! The number of columns of the masked matrix.
+  size_t cols;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
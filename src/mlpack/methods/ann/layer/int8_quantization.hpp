@@ -0,0 +1,111 @@
+/**
+ * @file methods/ann/layer/int8_quantization.hpp
+ *
+ * Functions shared by the quantized layers, which store their weights as 8-bit
+ * integers and compute their matrix products with 32-bit integer accumulators.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_INT8_QUANTIZATION_HPP
+#define MLPACK_METHODS_ANN_LAYER_INT8_QUANTIZATION_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * Get the scale of the symmetric 8-bit quantization of values in the range
+ * [-range, range]; a value x is stored as round(x / scale), in [-127, 127].
+ *
+ * @param range The largest absolute value to represent.
+ * @return The quantization scale.
+ */
+inline double Int8Scale(const double range)
+{
+  return (range > 0.0 && std::isfinite(range)) ? range / 127.0 : 1.0;
+}
+
+/**
+ * Quantize the given values with the given scale; values outside of the range
+ * of the scale are clamped.
+ *
+ * @param input The values to quantize.
+ * @param n The number of values.
+ * @param scale The quantization scale (see Int8Scale()).
+ * @param output Memory to store the n quantized values into.
+ */
+template<typename eT>
+inline void QuantizeInt8(const eT* input,
+                         const size_t n,
+                         const double scale,
+                         arma::s8* output)
+{
+  const double inverseScale = 1.0 / scale;
+  for (size_t i = 0; i < n; ++i)
+  {
+    const double q = std::round(input[i] * inverseScale);
+    output[i] = (arma::s8) std::min(127.0, std::max(-127.0, q));
+  }
+}
+
+/**
+ * Quantize each column of the given weight matrix with its own scale, so that
+ * the largest absolute value of each column is stored as 127.
+ *
+ * @param weight The weights, with one column per output channel.
+ * @param quantized Matrix to store the quantized weights into.
+ * @param scales Vector to store the scale of each column into.
+ */
+inline void QuantizeInt8Columns(const arma::mat& weight,
+                                arma::Mat<arma::s8>& quantized,
+                                arma::vec& scales)
+{
+  quantized.set_size(weight.n_rows, weight.n_cols);
+  scales.set_size(weight.n_cols);
+  for (size_t i = 0; i < weight.n_cols; ++i)
+  {
+    scales(i) = Int8Scale(arma::abs(weight.col(i)).max());
+    QuantizeInt8(weight.colptr(i), weight.n_rows, scales(i),
+        quantized.colptr(i));
+  }
+}
+
+/**
+ * Compute the products of the columns of two quantized matrices, that is
+ * output = a.t() * b, accumulated in 32-bit integers.  Since both operands
+ * are in [-127, 127], the columns may have up to 133000 rows without
+ * overflow.
+ *
+ * @param a The first matrix.
+ * @param b The second matrix, with as many rows as the first.
+ * @param output Matrix to store the a.n_cols x b.n_cols products into.
+ */
+inline void Int8TransposedProduct(const arma::Mat<arma::s8>& a,
+                                  const arma::Mat<arma::s8>& b,
+                                  arma::Mat<arma::s32>& output)
+{
+  output.set_size(a.n_cols, b.n_cols);
+  const size_t n = a.n_rows;
+  for (size_t j = 0; j < b.n_cols; ++j)
+  {
+    const arma::s8* bColumn = b.colptr(j);
+    arma::s32* outputColumn = output.colptr(j);
+    for (size_t i = 0; i < a.n_cols; ++i)
+    {
+      const arma::s8* aColumn = a.colptr(i);
+      arma::s32 sum = 0;
+      for (size_t k = 0; k < n; ++k)
+        sum += (arma::s32) aColumn[k] * (arma::s32) bColumn[k];
+      outputColumn[i] = sum;
+    }
+  }
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
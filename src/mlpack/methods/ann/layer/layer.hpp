@@ -50,10 +50,13 @@
 #include "max_pooling.hpp"
 #include "mean_pooling.hpp"
 #include "minibatch_discrimination.hpp"
+#include "multihead_attention.hpp"
 #include "multiply_constant.hpp"
 #include "multiply_merge.hpp"
 #include "padding.hpp"
 #include "parametric_relu.hpp"
+#include "quantized_convolution.hpp"
+#include "quantized_linear.hpp"
 #include "recurrent_attention.hpp"
 #include "recurrent.hpp"
 #include "reinforce_normal.hpp"
@@ -62,7 +65,9 @@
 #include "sequential.hpp"
 #include "softshrink.hpp"
 #include "softmax.hpp"
+#include "sparse_embedding.hpp"
 #include "subview.hpp"
+#include "transformer_encoder.hpp"
 #include "transposed_convolution.hpp"
 #include "virtual_batch_norm.hpp"
 #include "vr_class_reward.hpp"
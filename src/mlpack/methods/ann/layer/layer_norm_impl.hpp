@@ -59,44 +59,66 @@ template<typename eT>
 void LayerNorm<InputDataType, OutputDataType>::Forward(
     const arma::Mat<eT>& input, arma::Mat<eT>& output)
 {
-  mean = arma::mean(input, 0);
-  variance = arma::var(input, 1, 0);
-
-  // Normalize the input.
-  output = input.each_row() - mean;
-  inputMean = output;
-  output.each_row() /= arma::sqrt(variance + eps);
-
-  // Reused in the backward and gradient step.
-  normalized = output;
-
-  // Scale and shift the output.
-  output.each_col() %= gamma;
-  output.each_col() += beta;
+  mean.set_size(1, input.n_cols);
+  variance.set_size(1, input.n_cols);
+  stdInv.set_size(1, input.n_cols);
+  normalized.set_size(input.n_rows, input.n_cols);
+  output.set_size(input.n_rows, input.n_cols);
+
+  // Each column is normalized on its own, while it is in the cache.
+  for (size_t i = 0; i < input.n_cols; ++i)
+  {
+    // Use Welford method to compute the mean and the variance in one pass.
+    double colMean = 0.0, colVariance = 0.0;
+    for (size_t j = 0; j < input.n_rows; ++j)
+    {
+      const double diff = input(j, i) - colMean;
+      colMean += diff / (j + 1);
+      colVariance += diff * (input(j, i) - colMean);
+    }
+    colVariance /= input.n_rows;
+
+    mean[i] = colMean;
+    variance[i] = colVariance;
+    stdInv[i] = 1.0 / std::sqrt(colVariance + eps);
+
+    // Normalize the input, and scale and shift the output, in a second pass.
+    // The normalized input is reused in the backward and gradient step.
+    for (size_t j = 0; j < input.n_rows; ++j)
+    {
+      normalized(j, i) = (input(j, i) - colMean) * stdInv[i];
+      output(j, i) = normalized(j, i) * gamma[j] + beta[j];
+    }
+  }
 }
 
 template<typename InputDataType, typename OutputDataType>
 template<typename eT>
 void LayerNorm<InputDataType, OutputDataType>::Backward(
-    const arma::Mat<eT>& input, const arma::Mat<eT>& gy, arma::Mat<eT>& g)
+    const arma::Mat<eT>& /* input */, const arma::Mat<eT>& gy, arma::Mat<eT>& g)
 {
-  const arma::mat stdInv = 1.0 / arma::sqrt(variance + eps);
-
-  // dl / dxhat.
-  const arma::mat norm = gy.each_col() % gamma;
-
-  // sum dl / dxhat * (x - mu) * -0.5 * stdInv^3.
-  const arma::mat var = arma::sum(norm % inputMean, 0) %
-      arma::pow(stdInv, 3.0) * -0.5;
-
-  // dl / dxhat * 1 / stdInv + variance * 2 * (x - mu) / m +
-  // dl / dmu * 1 / m.
-  g = (norm.each_row() % stdInv) + (inputMean.each_row() %
-      var * 2 / input.n_rows);
-
-  // sum (dl / dxhat * -1 / stdInv) + variance *
-  // (sum -2 * (x - mu)) / m.
-  g.each_row() += arma::sum(norm.each_row() % -stdInv, 0) / input.n_rows;
+  g.set_size(gy.n_rows, gy.n_cols);
+  for (size_t i = 0; i < gy.n_cols; ++i)
+  {
+    // With dl / dxhat = dl / dy * gamma, the error is stdInv *
+    // (dl / dxhat - mean(dl / dxhat) - xhat * mean(dl / dxhat * xhat)), where
+    // the means are over the column.
+    double normMean = 0.0, normInputMean = 0.0;
+    for (size_t j = 0; j < gy.n_rows; ++j)
+    {
+      const double norm = gy(j, i) * gamma[j];
+      normMean += norm;
+      normInputMean += norm * normalized(j, i);
+    }
+    normMean /= gy.n_rows;
+    normInputMean /= gy.n_rows;
+
+    for (size_t j = 0; j < gy.n_rows; ++j)
+    {
+      g(j, i) = stdInv[i] * (gy(j, i) * gamma[j] - normMean -
+          normalized(j, i) * normInputMean);
+    }
+  }
 }
 
 template<typename InputDataType, typename OutputDataType>
@@ -106,14 +128,16 @@ void LayerNorm<InputDataType, OutputDataType>::Gradient(
     const arma::Mat<eT>& error,
     arma::Mat<eT>& gradient)
 {
-  gradient.set_size(size + size, 1);
-
-  // Step 5: dl / dy * xhat.
-  gradient.submat(0, 0, gamma.n_elem - 1, 0) = arma::sum(normalized % error, 1);
-
-  // Step 6: dl / dy.
-  gradient.submat(gamma.n_elem, 0, gradient.n_elem - 1, 0) =
-      arma::sum(error, 1);
+  // dl / dgamma = sum dl / dy * xhat and dl / dbeta = sum dl / dy, in one pass.
+  gradient.zeros(size + size, 1);
+  for (size_t i = 0; i < error.n_cols; ++i)
+  {
+    for (size_t j = 0; j < error.n_rows; ++j)
+    {
+      gradient[j] += normalized(j, i) * error(j, i);
+      gradient[size + j] += error(j, i);
+    }
+  }
 }
 
 template<typename InputDataType, typename OutputDataType>
@@ -88,6 +88,12 @@ HAS_MEM_FUNC(Reset, HasResetCheck);
 // we can use with SFINAE to catch when a type has a ResetCell() function.
 HAS_MEM_FUNC(ResetCell, HasResetCellCheck);
 
+// This gives us a HasStepCheck<T, U> type (where U is a function pointer) we
+// can use with SFINAE to catch when a type has a Step() function.  Such a type
+// trains some weights itself, outside of the parameters of the network (see
+// SparseEmbedding), and also has ResetSparseGradient() and InitializeWeights().
+HAS_MEM_FUNC(Step, HasStepCheck);
+
 // This gives us a HasRewardCheck<T, U> type (where U is a function pointer) we
 // can use with SFINAE to catch when a type has a Reward() function.
 HAS_MEM_FUNC(Reward, HasRewardCheck);
@@ -104,6 +110,10 @@ HAS_MEM_FUNC(InputHeight, HasInputHeight);
 // can use with SFINAE to catch when a type has a Rho() function.
 HAS_MEM_FUNC(Rho, HasRho);
 
+// This gives us a HasRhoCheck<T> type we can use with SFINAE to catch when a
+// type has a function named Rho, whatever its signature.
+HAS_ANY_METHOD_FORM(Rho, HasRhoCheck);
+
 // This gives us a HasLoss<T, U> type (where U is a function pointer) we
 // can use with SFINAE to catch when a type has a Loss() function.
 HAS_MEM_FUNC(Loss, HasLoss);
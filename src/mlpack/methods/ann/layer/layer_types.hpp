@@ -57,6 +57,9 @@
 // Regularizers.
 #include <mlpack/methods/ann/regularizer/no_regularizer.hpp>
 
+// Sparse update rules.
+#include <mlpack/methods/ann/sparse_update/lazy_sgd_update.hpp>
+
 // Loss function modules.
 #include <mlpack/methods/ann/loss_functions/negative_log_likelihood.hpp>
 
@@ -73,6 +76,10 @@ template<typename InputDataType, typename OutputDataType> class FastLSTM;
 template<typename InputDataType, typename OutputDataType> class VRClassReward;
 template<typename InputDataType, typename OutputDataType> class Concatenate;
 template<typename InputDataType, typename OutputDataType> class Padding;
+template<typename InputDataType, typename OutputDataType>
+class MultiheadAttention;
+template<typename InputDataType, typename OutputDataType>
+class TransformerEncoder;
 
 template<typename InputDataType,
          typename OutputDataType,
@@ -84,6 +91,11 @@ template<typename InputDataType,
          typename RegularizerType>
 class LinearNoBias;
 
+template<typename InputDataType,
+         typename OutputDataType,
+         typename UpdateRuleType>
+class SparseEmbedding;
+
 template<typename InputDataType,
          typename OutputDataType
 >
@@ -94,6 +106,16 @@ template<typename InputDataType,
 >
 class MiniBatchDiscrimination;
 
+template<typename InputDataType,
+         typename OutputDataType
+>
+class QuantizedConvolution;
+
+template<typename InputDataType,
+         typename OutputDataType
+>
+class QuantizedLinear;
+
 template<typename InputDataType,
          typename OutputDataType
 >
@@ -193,6 +215,9 @@ template <typename InputDataType,
 class AdaptiveMeanPooling;
 
 using MoreTypes = boost::variant<
+        MultiheadAttention<arma::mat, arma::mat>*,
+        QuantizedConvolution<arma::mat, arma::mat>*,
+        QuantizedLinear<arma::mat, arma::mat>*,
         Recurrent<arma::mat, arma::mat>*,
         RecurrentAttention<arma::mat, arma::mat>*,
         ReinforceNormal<arma::mat, arma::mat>*,
@@ -200,7 +225,9 @@ using MoreTypes = boost::variant<
         Select<arma::mat, arma::mat>*,
         Sequential<arma::mat, arma::mat, false>*,
         Sequential<arma::mat, arma::mat, true>*,
+        SparseEmbedding<arma::mat, arma::mat, LazySGDUpdate>*,
         Subview<arma::mat, arma::mat>*,
+        TransformerEncoder<arma::mat, arma::mat>*,
         VRClassReward<arma::mat, arma::mat>*,
         VirtualBatchNorm<arma::mat, arma::mat>*
 >;
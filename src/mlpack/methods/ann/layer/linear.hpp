@@ -125,7 +125,7 @@ class Linear
   OutputDataType& Gradient() { return gradient; }
 
   //! Modify the bias weights of the layer.
-  arma::mat& Bias() { return bias; }
+  OutputDataType& Bias() { return bias; }
 
   /**
    * Serialize the layer
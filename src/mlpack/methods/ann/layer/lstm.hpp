@@ -178,6 +178,9 @@ class LSTM
   void serialize(Archive& ar, const unsigned int /* version */);
 
  private:
+  //! Stack the weights of the four gates into the packed weight matrices.
+  void PackWeights();
+
   //! Locally-stored number of input units.
   size_t inSize;
 
@@ -320,6 +323,21 @@ class LSTM
   //! Locally-stored hidden layer error.
   OutputDataType hiddenError;
 
+  //! Input weights of the input, forget, hidden and output gates, stacked.
+  OutputDataType input2GatePackedWeight;
+
+  //! Biases of the input, forget, hidden and output gates, stacked.
+  OutputDataType input2GatePackedBias;
+
+  //! Recurrent weights of the input, forget, hidden and output gates, stacked.
+  OutputDataType output2GatePackedWeight;
+
+  //! Locally-stored pre-activations of all four gates for the current step.
+  OutputDataType gates;
+
+  //! Locally-stored errors of all four gates for the current step.
+  OutputDataType gateError;
+
   //! Locally-stored current rho size.
   size_t rhoSize;
 
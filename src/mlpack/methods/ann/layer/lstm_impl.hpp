@@ -157,6 +157,41 @@ void LSTM<InputDataType, OutputDataType>::Reset()
   // Set the weight parameter for the cell - input gate multiplication.
   cell2GateInputWeight = OutputDataType(weights.memptr() +
       offset, outSize, 1, false, false);
+
+  // The packed gate weights have to be rebuilt from the new parameters.
+  input2GatePackedWeight.reset();
+}
+
+template<typename InputDataType, typename OutputDataType>
+void LSTM<InputDataType, OutputDataType>::PackWeights()
+{
+  // Stack the weights of the input gate, the forget gate, the hidden layer and
+  // the output gate, so that all four can be computed with a single matrix
+  // multiplication.
+  input2GatePackedWeight.set_size(4 * outSize, inSize);
+  input2GatePackedWeight.rows(0, outSize - 1) = input2GateInputWeight;
+  input2GatePackedWeight.rows(outSize, 2 * outSize - 1) =
+      input2GateForgetWeight;
+  input2GatePackedWeight.rows(2 * outSize, 3 * outSize - 1) =
+      input2HiddenWeight;
+  input2GatePackedWeight.rows(3 * outSize, 4 * outSize - 1) =
+      input2GateOutputWeight;
+
+  input2GatePackedBias.set_size(4 * outSize, 1);
+  input2GatePackedBias.rows(0, outSize - 1) = input2GateInputBias;
+  input2GatePackedBias.rows(outSize, 2 * outSize - 1) = input2GateForgetBias;
+  input2GatePackedBias.rows(2 * outSize, 3 * outSize - 1) = input2HiddenBias;
+  input2GatePackedBias.rows(3 * outSize, 4 * outSize - 1) =
+      input2GateOutputBias;
+
+  output2GatePackedWeight.set_size(4 * outSize, outSize);
+  output2GatePackedWeight.rows(0, outSize - 1) = output2GateInputWeight;
+  output2GatePackedWeight.rows(outSize, 2 * outSize - 1) =
+      output2GateForgetWeight;
+  output2GatePackedWeight.rows(2 * outSize, 3 * outSize - 1) =
+      output2HiddenWeight;
+  output2GatePackedWeight.rows(3 * outSize, 4 * outSize - 1) =
+      output2GateOutputWeight;
 }
 
 // Forward when cellState is not needed.
@@ -187,17 +222,23 @@ void LSTM<InputDataType, OutputDataType>::Forward(const InputType& input,
     ResetCell(rhoSize);
   }
 
-  inputGate.cols(forwardStep, forwardStep + batchStep) = input2GateInputWeight *
-      input + output2GateInputWeight * outParameter.cols(forwardStep,
+  // The weights can only change between sequences, so the packed weights are
+  // rebuilt at the start of each one.
+  if (forwardStep == 0 || input2GatePackedWeight.is_empty())
+    PackWeights();
+
+  // Compute the input and recurrent part of all four gates at once.
+  gates = input2GatePackedWeight * input;
+  gates += output2GatePackedWeight * outParameter.cols(forwardStep,
       forwardStep + batchStep);
-  inputGate.cols(forwardStep, forwardStep + batchStep).each_col() +=
-      input2GateInputBias;
+  gates.each_col() += input2GatePackedBias;
 
-  forgetGate.cols(forwardStep, forwardStep + batchStep) = input2GateForgetWeight
-      * input + output2GateForgetWeight * outParameter.cols(
-      forwardStep, forwardStep + batchStep);
-  forgetGate.cols(forwardStep, forwardStep + batchStep).each_col() +=
-      input2GateForgetBias;
+  inputGate.cols(forwardStep, forwardStep + batchStep) =
+      gates.rows(0, outSize - 1);
+  forgetGate.cols(forwardStep, forwardStep + batchStep) =
+      gates.rows(outSize, 2 * outSize - 1);
+  hiddenLayer.cols(forwardStep, forwardStep + batchStep) =
+      gates.rows(2 * outSize, 3 * outSize - 1);
 
   if (forwardStep > 0)
   {
@@ -228,13 +269,6 @@ void LSTM<InputDataType, OutputDataType>::Forward(const InputType& input,
   forgetGateActivation.cols(forwardStep, forwardStep + batchStep) = 1.0 /
       (1 + arma::exp(-forgetGate.cols(forwardStep, forwardStep + batchStep)));
 
-  hiddenLayer.cols(forwardStep, forwardStep + batchStep) = input2HiddenWeight *
-      input + output2HiddenWeight * outParameter.cols(
-      forwardStep, forwardStep + batchStep);
-
-  hiddenLayer.cols(forwardStep, forwardStep + batchStep).each_col() +=
-      input2HiddenBias;
-
   hiddenLayerActivation.cols(forwardStep, forwardStep + batchStep) =
       arma::tanh(hiddenLayer.cols(forwardStep, forwardStep + batchStep));
 
@@ -253,14 +287,10 @@ void LSTM<InputDataType, OutputDataType>::Forward(const InputType& input,
         hiddenLayerActivation.cols(forwardStep, forwardStep + batchStep);
   }
 
-  outputGate.cols(forwardStep, forwardStep + batchStep) = input2GateOutputWeight
-      * input + output2GateOutputWeight * outParameter.cols(
-      forwardStep, forwardStep + batchStep) + cell.cols(forwardStep,
+  outputGate.cols(forwardStep, forwardStep + batchStep) =
+      gates.rows(3 * outSize, 4 * outSize - 1) + cell.cols(forwardStep,
       forwardStep + batchStep).each_col() % cell2GateOutputWeight;
 
-  outputGate.cols(forwardStep, forwardStep + batchStep).each_col() +=
-      input2GateOutputBias;
-
   outputGateActivation.cols(forwardStep, forwardStep + batchStep) = 1.0 /
       (1 + arma::exp(-outputGate.cols(forwardStep, forwardStep + batchStep)));
 
@@ -344,15 +374,15 @@ void LSTM<InputDataType, OutputDataType>::Backward(
       backwardStep) % cellError + forgetGateError.each_col() %
       cell2GateForgetWeight + inputGateError.each_col() % cell2GateInputWeight;
 
-  g = input2GateInputWeight.t() * inputGateError +
-      input2HiddenWeight.t() * hiddenError +
-      input2GateForgetWeight.t() * forgetGateError +
-      input2GateOutputWeight.t() * outputGateError;
+  // Stack the gate errors in the same order as the packed weights.
+  gateError.set_size(4 * outSize, batchSize);
+  gateError.rows(0, outSize - 1) = inputGateError;
+  gateError.rows(outSize, 2 * outSize - 1) = forgetGateError;
+  gateError.rows(2 * outSize, 3 * outSize - 1) = hiddenError;
+  gateError.rows(3 * outSize, 4 * outSize - 1) = outputGateError;
 
-  prevError = output2GateOutputWeight.t() * outputGateError +
-      output2GateForgetWeight.t() * forgetGateError +
-      output2GateInputWeight.t() * inputGateError +
-      output2HiddenWeight.t() * hiddenError;
+  g = input2GatePackedWeight.t() * gateError;
+  prevError = output2GatePackedWeight.t() * gateError;
 
   backwardStep -= batchSize;
   gradientStepIdx++;
@@ -370,61 +400,37 @@ void LSTM<InputDataType, OutputDataType>::Gradient(
     const ErrorType& /* error */,
     GradientType& gradient)
 {
-  // Input2GateOutputWeight and input2GateOutputBias gradients.
-  gradient.submat(0, 0, input2GateOutputWeight.n_elem - 1, 0) =
-      arma::vectorise(outputGateError * input.t());
-  gradient.submat(input2GateOutputWeight.n_elem, 0,
-      input2GateOutputWeight.n_elem + input2GateOutputBias.n_elem - 1, 0) =
-      arma::sum(outputGateError, 1);
-  size_t offset = input2GateOutputWeight.n_elem + input2GateOutputBias.n_elem;
-
-  // Input2GateForgetWeight and input2GateForgetBias gradients.
-  gradient.submat(offset, 0, offset + input2GateForgetWeight.n_elem - 1, 0) =
-      arma::vectorise(forgetGateError * input.t());
-  gradient.submat(offset + input2GateForgetWeight.n_elem, 0,
-      offset + input2GateForgetWeight.n_elem +
-      input2GateForgetBias.n_elem - 1, 0) = arma::sum(forgetGateError, 1);
-  offset += input2GateForgetWeight.n_elem + input2GateForgetBias.n_elem;
-
-  // Input2GateInputWeight and input2GateInputBias gradients.
-  gradient.submat(offset, 0, offset + input2GateInputWeight.n_elem - 1, 0) =
-      arma::vectorise(inputGateError * input.t());
-  gradient.submat(offset + input2GateInputWeight.n_elem, 0,
-      offset + input2GateInputWeight.n_elem +
-      input2GateInputBias.n_elem - 1, 0) = arma::sum(inputGateError, 1);
-  offset += input2GateInputWeight.n_elem + input2GateInputBias.n_elem;
-
-  // Input2HiddenWeight and input2HiddenBias gradients.
-  gradient.submat(offset, 0, offset + input2HiddenWeight.n_elem - 1, 0) =
-      arma::vectorise(hiddenError * input.t());
-  gradient.submat(offset + input2HiddenWeight.n_elem, 0,
-      offset + input2HiddenWeight.n_elem + input2HiddenBias.n_elem - 1, 0) =
-      arma::sum(hiddenError, 1);
-  offset += input2HiddenWeight.n_elem + input2HiddenBias.n_elem;
-
-  // Output2GateOutputWeight gradients.
-  gradient.submat(offset, 0, offset + output2GateOutputWeight.n_elem - 1, 0) =
-      arma::vectorise(outputGateError *
-      outParameter.cols(gradientStep - batchStep, gradientStep).t());
-  offset += output2GateOutputWeight.n_elem;
-
-  // Output2GateForgetWeight gradients.
-  gradient.submat(offset, 0, offset + output2GateForgetWeight.n_elem - 1, 0) =
-      arma::vectorise(forgetGateError *
-      outParameter.cols(gradientStep - batchStep, gradientStep).t());
-  offset += output2GateForgetWeight.n_elem;
-
-  // Output2GateInputWeight gradients.
-  gradient.submat(offset, 0, offset + output2GateInputWeight.n_elem - 1, 0) =
-      arma::vectorise(inputGateError *
-      outParameter.cols(gradientStep - batchStep, gradientStep).t());
-  offset += output2GateInputWeight.n_elem;
+  // Compute the weight gradients of all four gates at once.
+  const OutputDataType inputGradient = gateError * input.t();
+  const OutputDataType outputGradient = gateError *
+      outParameter.cols(gradientStep - batchStep, gradientStep).t();
+
+  // The parameters store the output gate, the forget gate, the input gate and
+  // the hidden layer in that order; these are their rows in gateError.
+  const size_t gateRows[] = { 3 * outSize, outSize, 0, 2 * outSize };
+
+  // Input2Gate weight and bias gradients.
+  size_t offset = 0;
+  for (size_t i = 0; i < 4; ++i)
+  {
+    const size_t row = gateRows[i];
+    gradient.submat(offset, 0, offset + outSize * inSize - 1, 0) =
+        arma::vectorise(inputGradient.rows(row, row + outSize - 1));
+    offset += outSize * inSize;
+
+    gradient.submat(offset, 0, offset + outSize - 1, 0) =
+        arma::sum(gateError.rows(row, row + outSize - 1), 1);
+    offset += outSize;
+  }
 
-  // Output2HiddenWeight gradients.
-  gradient.submat(offset, 0, offset + output2HiddenWeight.n_elem - 1, 0) =
-      arma::vectorise(hiddenError *
-      outParameter.cols(gradientStep - batchStep, gradientStep).t());
-  offset += output2HiddenWeight.n_elem;
+  // Output2Gate weight gradients.
+  for (size_t i = 0; i < 4; ++i)
+  {
+    const size_t row = gateRows[i];
+    gradient.submat(offset, 0, offset + outSize * outSize - 1, 0) =
+        arma::vectorise(outputGradient.rows(row, row + outSize - 1));
+    offset += outSize * outSize;
+  }
 
   // Cell2GateOutputWeight gradients.
   gradient.submat(offset, 0, offset + cell2GateOutputWeight.n_elem - 1, 0) =
@@ -167,60 +167,14 @@ class MaxPooling
   void serialize(Archive& ar, const unsigned int /* version */);
 
  private:
- /**
-   * Apply pooling to the input and store the results.
-   *
-   * @param input The input to be apply the pooling rule.
-   * @param output The pooled result.
-   * @param poolingIndices The pooled indices.
-   */
-  template<typename eT>
-  void PoolingOperation(const arma::Mat<eT>& input,
-                        arma::Mat<eT>& output,
-                        arma::Mat<eT>& poolingIndices)
-  {
-    for (size_t j = 0, colidx = 0; j < output.n_cols;
-        ++j, colidx += strideHeight)
-    {
-      for (size_t i = 0, rowidx = 0; i < output.n_rows;
-          ++i, rowidx += strideWidth)
-      {
-        arma::mat subInput = input(
-            arma::span(rowidx, rowidx + kernelWidth - 1 - offset),
-            arma::span(colidx, colidx + kernelHeight - 1 - offset));
-
-        const size_t idx = pooling.Pooling(subInput);
-        output(i, j) = subInput(idx);
-
-        if (!deterministic)
-        {
-          arma::Mat<size_t> subIndices = indices(arma::span(rowidx,
-              rowidx + kernelWidth - 1 - offset),
-              arma::span(colidx, colidx + kernelHeight - 1 - offset));
-
-          poolingIndices(i, j) = subIndices(idx);
-        }
-      }
-    }
-  }
-
   /**
-   * Apply unpooling to the input and store the results.
-   *
-   * @param error The backward error.
-   * @param output The pooled result.
-   * @param poolingIndices The pooled indices.
+   * Compute the window index map for the current input size, kernel size and
+   * stride, unless it was already computed for them.  Column p of the map holds
+   * the indices (within one input slice) of the elements of the pooling window
+   * of output element p, in column-major order; windows that extend past the
+   * input are clamped to its border.
    */
-  template<typename eT>
-  void Unpooling(const arma::Mat<eT>& error,
-                 arma::Mat<eT>& output,
-                 arma::Mat<eT>& poolingIndices)
-  {
-    for (size_t i = 0; i < poolingIndices.n_elem; ++i)
-    {
-      output(poolingIndices(i)) += error(i);
-    }
-  }
+  void ComputeWindowIndices();
 
   //! Locally-stored width of the pooling window.
   size_t kernelWidth;
@@ -243,9 +197,6 @@ class MaxPooling
   //! Locally-stored number of output channels.
   size_t outSize;
 
-  //! Locally-stored reset parameter used to initialize the module once.
-  bool reset;
-
   //! Locally-stored input width.
   size_t inputWidth;
 
@@ -267,18 +218,6 @@ class MaxPooling
   //! Locally-stored number of input units.
   size_t batchSize;
 
-  //! Locally-stored output parameter.
-  arma::cube outputTemp;
-
-  //! Locally-stored transformed input parameter.
-  arma::cube inputTemp;
-
-  //! Locally-stored transformed output parameter.
-  arma::cube gTemp;
-
-  //! Locally-stored pooling strategy.
-  MaxPoolingRule pooling;
-
   //! Locally-stored delta object.
   OutputDataType delta;
 
@@ -288,14 +227,17 @@ class MaxPooling
   //! Locally-stored output parameter object.
   OutputDataType outputParameter;
 
-  //! Locally-stored indices matrix parameter.
-  arma::Mat<size_t> indices;
+  //! Locally-stored window index map (see ComputeWindowIndices()).
+  arma::Mat<size_t> windowIndices;
 
-  //! Locally-stored indices column parameter.
-  arma::Col<size_t> indicesCol;
+  //! Locally-stored input width, input height, kernel width, kernel height,
+  //! stride width, stride height and offset the window index map is for.
+  std::vector<size_t> windowGeometry;
 
-  //! Locally-stored pooling indicies.
-  std::vector<arma::cube> poolingIndices;
+  //! Locally-stored indices (within the input batch) of the maximum of each
+  //! output element, one set per forward pass not yet matched by a backward
+  //! pass.
+  std::vector<arma::Col<size_t>> poolingIndices;
 }; // class MaxPooling
 
 } // namespace ann
@@ -39,7 +39,6 @@ MaxPooling<InputDataType, OutputDataType>::MaxPooling(
     floor(floor),
     inSize(0),
     outSize(0),
-    reset(false),
     inputWidth(0),
     inputHeight(0),
     outputWidth(0),
@@ -58,8 +57,6 @@ void MaxPooling<InputDataType, OutputDataType>::Forward(
 {
   batchSize = input.n_cols;
   inSize = input.n_elem / (inputWidth * inputHeight * batchSize);
-  inputTemp = arma::cube(const_cast<arma::Mat<eT>&>(input).memptr(),
-      inputWidth, inputHeight, batchSize * inSize, false, false);
 
   if (floor)
   {
@@ -78,44 +75,37 @@ void MaxPooling<InputDataType, OutputDataType>::Forward(
     offset = 1;
   }
 
-  outputTemp = arma::zeros<arma::Cube<eT> >(outputWidth, outputHeight,
-      batchSize * inSize);
+  ComputeWindowIndices();
 
+  // Pool every slice of the batch through the window index map, keeping the
+  // first maximum of each window.
+  const size_t inputSliceSize = inputWidth * inputHeight;
+  const size_t outputSliceSize = outputWidth * outputHeight;
+  const size_t windowSize = windowIndices.n_rows;
+  output.set_size(outputSliceSize * inSize, batchSize);
   if (!deterministic)
-  {
-    poolingIndices.push_back(outputTemp);
-  }
+    poolingIndices.push_back(arma::Col<size_t>(output.n_elem));
 
-  if (!reset)
+  for (size_t s = 0; s < batchSize * inSize; ++s)
   {
-    size_t elements = inputWidth * inputHeight;
-    indicesCol = arma::linspace<arma::Col<size_t> >(0, (elements - 1),
-        elements);
-
-    indices = arma::Mat<size_t>(indicesCol.memptr(), inputWidth, inputHeight);
-
-    reset = true;
-  }
-
-  for (size_t s = 0; s < inputTemp.n_slices; s++)
-  {
-    if (!deterministic)
-    {
-      PoolingOperation(inputTemp.slice(s), outputTemp.slice(s),
-        poolingIndices.back().slice(s));
-    }
-    else
+    const eT* slice = input.memptr() + s * inputSliceSize;
+    for (size_t p = 0; p < outputSliceSize; ++p)
     {
-      PoolingOperation(inputTemp.slice(s), outputTemp.slice(s),
-          inputTemp.slice(s));
+      const size_t* window = windowIndices.colptr(p);
+      size_t maxIndex = window[0];
+      for (size_t k = 1; k < windowSize; ++k)
+      {
+        if (slice[window[k]] > slice[maxIndex])
+          maxIndex = window[k];
+      }
+
+      output[s * outputSliceSize + p] = slice[maxIndex];
+      if (!deterministic)
+        poolingIndices.back()[s * outputSliceSize + p] =
+            s * inputSliceSize + maxIndex;
     }
   }
 
-  output = arma::Mat<eT>(outputTemp.memptr(), outputTemp.n_elem / batchSize,
-      batchSize);
-
-  outputWidth = outputTemp.n_rows;
-  outputHeight = outputTemp.n_cols;
   outSize = batchSize * inSize;
 }
 
@@ -124,21 +114,47 @@ template<typename eT>
 void MaxPooling<InputDataType, OutputDataType>::Backward(
     const arma::Mat<eT>& /* input */, const arma::Mat<eT>& gy, arma::Mat<eT>& g)
 {
-  arma::cube mappedError = arma::cube(((arma::Mat<eT>&) gy).memptr(),
-      outputWidth, outputHeight, outSize, false, false);
+  // Each error goes to the maximum of its window.
+  const arma::Col<size_t>& maxIndices = poolingIndices.back();
+  g.zeros(inputWidth * inputHeight * inSize, batchSize);
+  for (size_t i = 0; i < maxIndices.n_elem; ++i)
+    g[maxIndices[i]] += gy[i];
 
-  gTemp = arma::zeros<arma::cube>(inputTemp.n_rows,
-      inputTemp.n_cols, inputTemp.n_slices);
+  poolingIndices.pop_back();
+}
 
-  for (size_t s = 0; s < mappedError.n_slices; s++)
+template<typename InputDataType, typename OutputDataType>
+void MaxPooling<InputDataType, OutputDataType>::ComputeWindowIndices()
+{
+  std::vector<size_t> geometry = { inputWidth, inputHeight, kernelWidth,
+      kernelHeight, strideWidth, strideHeight, offset };
+  if (geometry == windowGeometry)
+    return;
+
+  // The window of output element (i, j) starts at row i * strideWidth and
+  // column j * strideHeight of the input.
+  const size_t windowWidth = kernelWidth - offset;
+  const size_t windowHeight = kernelHeight - offset;
+  windowIndices.set_size(windowWidth * windowHeight,
+      outputWidth * outputHeight);
+  for (size_t j = 0; j < outputHeight; ++j)
   {
-    Unpooling(mappedError.slice(s), gTemp.slice(s),
-        poolingIndices.back().slice(s));
+    for (size_t i = 0; i < outputWidth; ++i)
+    {
+      size_t* window = windowIndices.colptr(i + j * outputWidth);
+      for (size_t b = 0; b < windowHeight; ++b)
+      {
+        const size_t col = std::min(j * strideHeight + b, inputHeight - 1);
+        for (size_t a = 0; a < windowWidth; ++a)
+        {
+          const size_t row = std::min(i * strideWidth + a, inputWidth - 1);
+          window[a + b * windowWidth] = row + col * inputWidth;
+        }
+      }
+    }
   }
 
-  poolingIndices.pop_back();
-
-  g = arma::mat(gTemp.memptr(), gTemp.n_elem / batchSize, batchSize);
+  windowGeometry = geometry;
 }
 
 template<typename InputDataType, typename OutputDataType>
@@ -0,0 +1,222 @@
+/**
+ * @file methods/ann/layer/multihead_attention.hpp
+ *
+ * Definition of the MultiheadAttention class, the multi-head scaled
+ * dot-product self-attention layer of the Transformer.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_MULTIHEAD_ATTENTION_HPP
+#define MLPACK_METHODS_ANN_LAYER_MULTIHEAD_ATTENTION_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * Multi-head scaled dot-product self-attention, as introduced in the
+ * following paper:
+ *
+ * @code
+ * @inproceedings{Vaswani2017,
+ *   author    = {Ashish Vaswani and Noam Shazeer and Niki Parmar and Jakob
+ *                Uszkoreit and Llion Jones and Aidan N. Gomez and Lukasz Kaiser
+ *                and Illia Polosukhin},
+ *   title     = {Attention is All you Need},
+ *   booktitle = {Advances in Neural Information Processing Systems 30},
+ *   year      = {2017}
+ * }
+ * @endcode
+ *
+ * Each column of the input is one sequence, stored as the embedDim x seqLength
+ * matrix of its tokens (so the input has embedDim * seqLength rows, and the
+ * sequence length is deduced from it).  The queries, keys and values of every
+ * token of the batch are computed with one matrix product, the attention of
+ * each head is computed on its slice of them, and the outputs of the heads are
+ * projected with one more matrix product; the output has the shape of the
+ * input.
+ *
+ * An additive attention mask (seqLength x seqLength, where element (i, j) is
+ * added to the score of key i for query j) can be set with AttentionMask(),
+ * for instance to -DBL_MAX above the diagonal to forbid attending to later
+ * tokens.
+ *
+ * @tparam InputDataType Type of the input data (arma::colvec, arma::mat,
+ *         arma::sp_mat or arma::cube).
+ * @tparam OutputDataType Type of the output data (arma::colvec, arma::mat,
+ *         arma::sp_mat or arma::cube).
+ */
+template <
+    typename InputDataType = arma::mat,
+    typename OutputDataType = arma::mat
+>
+class MultiheadAttention
+{
+ public:
+  //! Create the MultiheadAttention object.
+  MultiheadAttention();
+
+  /**
+   * Create the MultiheadAttention object.
+   *
+   * @param embedDim The size of the embedding of each token.
+   * @param numHeads The number of attention heads; it must divide embedDim.
+   */
+  MultiheadAttention(const size_t embedDim, const size_t numHeads);
+
+  /*
+   * Reset the layer parameter.
+   */
+  void Reset();
+
+  /**
+   * Ordinary feed forward pass of a neural network, evaluating the function
+   * f(x) by propagating the activity forward through f.
+   *
+   * @param input Input data used for evaluating the specified function.
+   * @param output Resulting output activation.
+   */
+  template<typename eT>
+  void Forward(const arma::Mat<eT>& input, arma::Mat<eT>& output);
+
+  /**
+   * Ordinary feed backward pass of a neural network, calculating the function
+   * f(x) by propagating x backwards trough f. Using the results from the feed
+   * forward pass.
+   *
+   * @param * (input) The propagated input activation.
+   * @param gy The backpropagated error.
+   * @param g The calculated gradient.
+   */
+  template<typename eT>
+  void Backward(const arma::Mat<eT>& /* input */,
+                const arma::Mat<eT>& gy,
+                arma::Mat<eT>& g);
+
+  /*
+   * Calculate the gradient using the output delta and the input activation.
+   *
+   * @param input The input parameter used for calculating the gradient.
+   * @param error The calculated error.
+   * @param gradient The calculated gradient.
+   */
+  template<typename eT>
+  void Gradient(const arma::Mat<eT>& input,
+                const arma::Mat<eT>& error,
+                arma::Mat<eT>& gradient);
+
+  //! Get the parameters.
+  OutputDataType const& Parameters() const { return weights; }
+  //! Modify the parameters.
+  OutputDataType& Parameters() { return weights; }
+
+  //! Get the input parameter.
+  InputDataType const& InputParameter() const { return inputParameter; }
+  //! Modify the input parameter.
+  InputDataType& InputParameter() { return inputParameter; }
+
+  //! Get the output parameter.
+  OutputDataType const& OutputParameter() const { return outputParameter; }
+  //! Modify the output parameter.
+  OutputDataType& OutputParameter() { return outputParameter; }
+
+  //! Get the delta.
+  OutputDataType const& Delta() const { return delta; }
+  //! Modify the delta.
+  OutputDataType& Delta() { return delta; }
+
+  //! Get the gradient.
+  OutputDataType const& Gradient() const { return gradient; }
+  //! Modify the gradient.
+  OutputDataType& Gradient() { return gradient; }
+
+  //! Get the size of the embedding of each token.
+  size_t EmbedDim() const { return embedDim; }
+
+  //! Get the number of attention heads.
+  size_t NumHeads() const { return numHeads; }
+
+  //! Get the attention mask.
+  OutputDataType const& AttentionMask() const { return attentionMask; }
+  //! Modify the attention mask (empty for no mask).
+  OutputDataType& AttentionMask() { return attentionMask; }
+
+  //! Get the attention weights of the last forward pass (seqLength x
+  //! (seqLength * numHeads * batchSize); the block of point b and head h
+  //! starts at column (b * numHeads + h) * seqLength).
+  OutputDataType const& AttentionWeights() const { return attention; }
+
+  /**
+   * Serialize the layer.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  //! Locally-stored size of the embedding of each token.
+  size_t embedDim;
+
+  //! Locally-stored number of attention heads.
+  size_t numHeads;
+
+  //! Locally-stored size of the queries, keys and values of each head.
+  size_t headDim;
+
+  //! Locally-stored length of the sequences of the last forward pass.
+  size_t seqLength;
+
+  //! Locally-stored weight object.
+  OutputDataType weights;
+
+  //! Locally-stored weights of the queries, keys and values (3 * embedDim x
+  //! embedDim).
+  OutputDataType qkvWeight;
+
+  //! Locally-stored biases of the queries, keys and values.
+  OutputDataType qkvBias;
+
+  //! Locally-stored weights of the output projection.
+  OutputDataType outWeight;
+
+  //! Locally-stored bias of the output projection.
+  OutputDataType outBias;
+
+  //! Locally-stored attention mask.
+  OutputDataType attentionMask;
+
+  //! Locally-stored queries, keys and values of every token of the batch.
+  OutputDataType qkv;
+
+  //! Locally-stored attention weights of every head and point of the batch.
+  OutputDataType attention;
+
+  //! Locally-stored outputs of the heads, before the output projection.
+  OutputDataType heads;
+
+  //! Locally-stored error of the queries, keys and values.
+  OutputDataType qkvDelta;
+
+  //! Locally-stored delta object.
+  OutputDataType delta;
+
+  //! Locally-stored gradient object.
+  OutputDataType gradient;
+
+  //! Locally-stored input parameter object.
+  InputDataType inputParameter;
+
+  //! Locally-stored output parameter object.
+  OutputDataType outputParameter;
+}; // class MultiheadAttention
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "multihead_attention_impl.hpp"
+
+#endif
@@ -0,0 +1,218 @@
+/**
+ * @file methods/ann/layer/multihead_attention_impl.hpp
+ *
+ * Implementation of the MultiheadAttention class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_MULTIHEAD_ATTENTION_IMPL_HPP
+#define MLPACK_METHODS_ANN_LAYER_MULTIHEAD_ATTENTION_IMPL_HPP
+
+// In case it hasn't yet been included.
+#include "multihead_attention.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+template<typename InputDataType, typename OutputDataType>
+MultiheadAttention<InputDataType, OutputDataType>::MultiheadAttention() :
+    embedDim(0),
+    numHeads(0),
+    headDim(0),
+    seqLength(0)
+{
+  // Nothing to do here.
+}
+
+template<typename InputDataType, typename OutputDataType>
+MultiheadAttention<InputDataType, OutputDataType>::MultiheadAttention(
+    const size_t embedDim,
+    const size_t numHeads) :
+    embedDim(embedDim),
+    numHeads(numHeads),
+    headDim(embedDim / numHeads),
+    seqLength(0)
+{
+  if (numHeads == 0 || embedDim % numHeads != 0)
+  {
+    Log::Fatal << "MultiheadAttention: the number of heads (" << numHeads
+        << ") must divide the embedding size (" << embedDim << ")."
+        << std::endl;
+  }
+
+  weights.set_size(4 * embedDim * embedDim + 4 * embedDim, 1);
+}
+
+template<typename InputDataType, typename OutputDataType>
+void MultiheadAttention<InputDataType, OutputDataType>::Reset()
+{
+  typename OutputDataType::elem_type* memory = weights.memptr();
+  qkvWeight = OutputDataType(memory, 3 * embedDim, embedDim, false, false);
+  memory += qkvWeight.n_elem;
+  qkvBias = OutputDataType(memory, 3 * embedDim, 1, false, false);
+  memory += qkvBias.n_elem;
+  outWeight = OutputDataType(memory, embedDim, embedDim, false, false);
+  memory += outWeight.n_elem;
+  outBias = OutputDataType(memory, embedDim, 1, false, false);
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+void MultiheadAttention<InputDataType, OutputDataType>::Forward(
+    const arma::Mat<eT>& input, arma::Mat<eT>& output)
+{
+  seqLength = input.n_rows / embedDim;
+  const size_t tokens = seqLength * input.n_cols;
+  const size_t blocks = numHeads * input.n_cols;
+  if (!attentionMask.is_empty() && (attentionMask.n_rows != seqLength ||
+      attentionMask.n_cols != seqLength))
+  {
+    Log::Fatal << "MultiheadAttention::Forward(): the attention mask is "
+        << attentionMask.n_rows << " x " << attentionMask.n_cols << " but the "
+        << "sequences have " << seqLength << " tokens." << std::endl;
+  }
+
+  // Compute the queries, keys and values of every token of the batch at once.
+  const arma::Mat<eT> inputTokens(const_cast<eT*>(input.memptr()), embedDim,
+      tokens, false, true);
+  qkv = qkvWeight * inputTokens;
+  qkv.each_col() += qkvBias;
+
+  // Compute the attention of each head of each point, one block of the
+  // attention weights at a time: the scores are computed in place and turned
+  // into probabilities column by column.
+  const double scale = 1.0 / std::sqrt((double) headDim);
+  attention.set_size(seqLength, seqLength * blocks);
+  heads.set_size(embedDim, tokens);
+  for (size_t block = 0; block < blocks; ++block)
+  {
+    const size_t first = (block / numHeads) * seqLength;
+    const size_t last = first + seqLength - 1;
+    const size_t row = (block % numHeads) * headDim;
+
+    arma::Mat<eT> probabilities(attention.colptr(block * seqLength),
+        seqLength, seqLength, false, true);
+    probabilities = scale * (qkv.submat(embedDim + row, first,
+        embedDim + row + headDim - 1, last).t() *
+        qkv.submat(row, first, row + headDim - 1, last));
+    if (!attentionMask.is_empty())
+      probabilities += attentionMask;
+
+    probabilities.each_row() -= arma::max(probabilities, 0);
+    probabilities = arma::exp(probabilities);
+    probabilities.each_row() /= arma::sum(probabilities, 0);
+
+    heads.submat(row, first, row + headDim - 1, last) = qkv.submat(
+        2 * embedDim + row, first, 2 * embedDim + row + headDim - 1, last) *
+        probabilities;
+  }
+
+  // Project the outputs of the heads.
+  output.set_size(input.n_rows, input.n_cols);
+  arma::Mat<eT> outputTokens(output.memptr(), embedDim, tokens, false, true);
+  outputTokens = outWeight * heads;
+  outputTokens.each_col() += outBias;
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+void MultiheadAttention<InputDataType, OutputDataType>::Backward(
+    const arma::Mat<eT>& /* input */, const arma::Mat<eT>& gy, arma::Mat<eT>& g)
+{
+  const size_t tokens = seqLength * gy.n_cols;
+  const size_t blocks = numHeads * gy.n_cols;
+  const double scale = 1.0 / std::sqrt((double) headDim);
+
+  const arma::Mat<eT> errorTokens(const_cast<eT*>(gy.memptr()), embedDim,
+      tokens, false, true);
+  const arma::Mat<eT> headsError = outWeight.t() * errorTokens;
+
+  qkvDelta.set_size(3 * embedDim, tokens);
+  for (size_t block = 0; block < blocks; ++block)
+  {
+    const size_t first = (block / numHeads) * seqLength;
+    const size_t last = first + seqLength - 1;
+    const size_t row = (block % numHeads) * headDim;
+
+    const arma::Mat<eT> probabilities(attention.colptr(block * seqLength),
+        seqLength, seqLength, false, true);
+    const arma::Mat<eT> headError = headsError.submat(row, first,
+        row + headDim - 1, last);
+
+    // The output of the head is values * probabilities.
+    qkvDelta.submat(2 * embedDim + row, first,
+        2 * embedDim + row + headDim - 1, last) =
+        headError * probabilities.t();
+    arma::Mat<eT> scoresError = qkv.submat(2 * embedDim + row, first,
+        2 * embedDim + row + headDim - 1, last).t() * headError;
+
+    // Backward pass of the softmax over each column.
+    scoresError = probabilities % (scoresError.each_row() -
+        arma::sum(scoresError % probabilities, 0));
+    scoresError *= scale;
+
+    // The scores are keys^T * queries.
+    qkvDelta.submat(row, first, row + headDim - 1, last) = qkv.submat(
+        embedDim + row, first, embedDim + row + headDim - 1, last) *
+        scoresError;
+    qkvDelta.submat(embedDim + row, first, embedDim + row + headDim - 1,
+        last) = qkv.submat(row, first, row + headDim - 1, last) *
+        scoresError.t();
+  }
+
+  g.set_size(gy.n_rows, gy.n_cols);
+  arma::Mat<eT> inputError(g.memptr(), embedDim, tokens, false, true);
+  inputError = qkvWeight.t() * qkvDelta;
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+void MultiheadAttention<InputDataType, OutputDataType>::Gradient(
+    const arma::Mat<eT>& input,
+    const arma::Mat<eT>& error,
+    arma::Mat<eT>& gradient)
+{
+  const size_t tokens = seqLength * input.n_cols;
+  const arma::Mat<eT> inputTokens(const_cast<eT*>(input.memptr()), embedDim,
+      tokens, false, true);
+  const arma::Mat<eT> errorTokens(const_cast<eT*>(error.memptr()), embedDim,
+      tokens, false, true);
+
+  size_t offset = 0;
+  gradient.rows(offset, offset + qkvWeight.n_elem - 1) =
+      arma::vectorise(qkvDelta * inputTokens.t());
+  offset += qkvWeight.n_elem;
+  gradient.rows(offset, offset + qkvBias.n_elem - 1) = arma::sum(qkvDelta, 1);
+  offset += qkvBias.n_elem;
+  gradient.rows(offset, offset + outWeight.n_elem - 1) =
+      arma::vectorise(errorTokens * heads.t());
+  offset += outWeight.n_elem;
+  gradient.rows(offset, offset + outBias.n_elem - 1) =
+      arma::sum(errorTokens, 1);
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename Archive>
+void MultiheadAttention<InputDataType, OutputDataType>::serialize(
+    Archive& ar, const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(embedDim);
+  ar & BOOST_SERIALIZATION_NVP(numHeads);
+  ar & BOOST_SERIALIZATION_NVP(attentionMask);
+
+  // This is inefficient, but we have to allocate this memory so that
+  // WeightSetVisitor gets the right size.
+  if (Archive::is_loading::value)
+  {
+    headDim = (numHeads == 0) ? 0 : embedDim / numHeads;
+    weights.set_size(4 * embedDim * embedDim + 4 * embedDim, 1);
+  }
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
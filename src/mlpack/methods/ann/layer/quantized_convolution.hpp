@@ -0,0 +1,271 @@
+/**
+ * @file methods/ann/layer/quantized_convolution.hpp
+ *
+ * Definition of the QuantizedConvolution class, an inference version of the
+ * Convolution layer with 8-bit integer weights.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_QUANTIZED_CONVOLUTION_HPP
+#define MLPACK_METHODS_ANN_LAYER_QUANTIZED_CONVOLUTION_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/methods/ann/convolution_rules/im2col_convolution.hpp>
+
+#include "layer_types.hpp"
+#include "int8_quantization.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * The QuantizedConvolution layer computes the convolution of a trained
+ * Convolution layer with 8-bit integer arithmetic.  The filters of each output
+ * map are quantized with their own scale, and the input is quantized with a
+ * single scale that is chosen from the range of the inputs seen during
+ * calibration.  The (zero-)padded, quantized input maps of each point are
+ * unrolled with Im2ColConvolution::Im2Col(), so that all output maps are
+ * computed in one integer matrix product with 32-bit accumulators, which is
+ * then scaled back; the bias is added in floating point.
+ *
+ * The layer has no trainable parameters; it is usually created by
+ * FFN::Quantize().  The backward pass uses the dequantized filters, so the
+ * error can still be propagated through the layer.
+ *
+ * @tparam InputDataType Type of the input data (arma::colvec, arma::mat,
+ *         arma::sp_mat or arma::cube).
+ * @tparam OutputDataType Type of the output data (arma::colvec, arma::mat,
+ *         arma::sp_mat or arma::cube).
+ */
+template <
+    typename InputDataType = arma::mat,
+    typename OutputDataType = arma::mat
+>
+class QuantizedConvolution
+{
+ public:
+  //! Create the QuantizedConvolution object.
+  QuantizedConvolution();
+
+  /**
+   * Create the QuantizedConvolution object from the filters of a trained
+   * layer.
+   *
+   * @param weight The filters, one slice for each pair of input and output
+   *     maps, stored in the order of the Convolution layer (all the input maps
+   *     of the first output map, then those of the second one, and so on).
+   * @param bias The bias of each output map.
+   * @param inputRange The largest absolute input value that is expected (for
+   *     instance the largest one of the calibration data); larger inputs are
+   *     clamped.
+   * @param inputWidth The width of the input maps.
+   * @param inputHeight The height of the input maps.
+   * @param strideWidth Stride of filter application in the x direction.
+   * @param strideHeight Stride of filter application in the y direction.
+   * @param padW A two-value tuple with the padding width at the left and at
+   *     the right side.
+   * @param padH A two-value tuple with the padding height at the top and at
+   *     the bottom.
+   */
+  QuantizedConvolution(const arma::cube& weight,
+                       const arma::mat& bias,
+                       const double inputRange,
+                       const size_t inputWidth,
+                       const size_t inputHeight,
+                       const size_t strideWidth = 1,
+                       const size_t strideHeight = 1,
+                       const std::tuple<size_t, size_t>& padW =
+                           std::tuple<size_t, size_t>(0, 0),
+                       const std::tuple<size_t, size_t>& padH =
+                           std::tuple<size_t, size_t>(0, 0));
+
+  /**
+   * Ordinary feed forward pass of a neural network, evaluating the function
+   * f(x) by propagating the activity forward through f.
+   *
+   * @param input Input data used for evaluating the specified function.
+   * @param output Resulting output activation.
+   */
+  template<typename eT>
+  void Forward(const arma::Mat<eT>& input, arma::Mat<eT>& output);
+
+  /**
+   * Ordinary feed backward pass of a neural network, calculating the function
+   * f(x) by propagating x backwards trough f, using the dequantized filters.
+   *
+   * @param * (input) The propagated input activation.
+   * @param gy The backpropagated error.
+   * @param g The calculated gradient.
+   */
+  template<typename eT>
+  void Backward(const arma::Mat<eT>& /* input */,
+                const arma::Mat<eT>& gy,
+                arma::Mat<eT>& g);
+
+  //! Get the input parameter.
+  const InputDataType& InputParameter() const { return inputParameter; }
+  //! Modify the input parameter.
+  InputDataType& InputParameter() { return inputParameter; }
+
+  //! Get the output parameter.
+  const OutputDataType& OutputParameter() const { return outputParameter; }
+  //! Modify the output parameter.
+  OutputDataType& OutputParameter() { return outputParameter; }
+
+  //! Get the delta.
+  const OutputDataType& Delta() const { return delta; }
+  //! Modify the delta.
+  OutputDataType& Delta() { return delta; }
+
+  //! Get the input width.
+  const size_t& InputWidth() const { return inputWidth; }
+  //! Modify input the width.
+  size_t& InputWidth() { return inputWidth; }
+
+  //! Get the input height.
+  const size_t& InputHeight() const { return inputHeight; }
+  //! Modify the input height.
+  size_t& InputHeight() { return inputHeight; }
+
+  //! Get the output width.
+  const size_t& OutputWidth() const { return outputWidth; }
+  //! Modify the output width.
+  size_t& OutputWidth() { return outputWidth; }
+
+  //! Get the output height.
+  const size_t& OutputHeight() const { return outputHeight; }
+  //! Modify the output height.
+  size_t& OutputHeight() { return outputHeight; }
+
+  //! Get the number of input maps.
+  size_t InputSize() const { return inSize; }
+
+  //! Get the number of output maps.
+  size_t OutputSize() const { return outSize; }
+
+  //! Get the kernel width.
+  size_t KernelWidth() const { return kernelWidth; }
+
+  //! Get the kernel height.
+  size_t KernelHeight() const { return kernelHeight; }
+
+  //! Get the stride width.
+  size_t StrideWidth() const { return strideWidth; }
+
+  //! Get the stride height.
+  size_t StrideHeight() const { return strideHeight; }
+
+  //! Get the top padding height.
+  size_t PadHTop() const { return padHTop; }
+
+  //! Get the bottom padding height.
+  size_t PadHBottom() const { return padHBottom; }
+
+  //! Get the left padding width.
+  size_t PadWLeft() const { return padWLeft; }
+
+  //! Get the right padding width.
+  size_t PadWRight() const { return padWRight; }
+
+  //! Get the quantized filters (one column per output map).
+  const arma::Mat<arma::s8>& Weight() const { return weight; }
+
+  //! Get the quantization scale of the filters of each output map.
+  const arma::vec& Scales() const { return scales; }
+
+  //! Get the quantization scale of the input.
+  double InputScale() const { return inputScale; }
+
+  //! Get the bias.
+  const arma::mat& Bias() const { return bias; }
+
+  /**
+   * Serialize the layer.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  //! Locally-stored number of input maps.
+  size_t inSize;
+
+  //! Locally-stored number of output maps.
+  size_t outSize;
+
+  //! Locally-stored filter width.
+  size_t kernelWidth;
+
+  //! Locally-stored filter height.
+  size_t kernelHeight;
+
+  //! Locally-stored stride of the filter in x-direction.
+  size_t strideWidth;
+
+  //! Locally-stored stride of the filter in y-direction.
+  size_t strideHeight;
+
+  //! Locally-stored left-side padding width.
+  size_t padWLeft;
+
+  //! Locally-stored right-side padding width.
+  size_t padWRight;
+
+  //! Locally-stored bottom padding height.
+  size_t padHBottom;
+
+  //! Locally-stored top padding height.
+  size_t padHTop;
+
+  //! Locally-stored quantized filters (filter size * inSize x outSize).
+  arma::Mat<arma::s8> weight;
+
+  //! Locally-stored quantization scale of each output map.
+  arma::vec scales;
+
+  //! Locally-stored bias.
+  arma::mat bias;
+
+  //! Locally-stored quantization scale of the input.
+  double inputScale;
+
+  //! Locally-stored input width.
+  size_t inputWidth;
+
+  //! Locally-stored input height.
+  size_t inputHeight;
+
+  //! Locally-stored output width.
+  size_t outputWidth;
+
+  //! Locally-stored output height.
+  size_t outputHeight;
+
+  //! Locally-stored padded and quantized input maps of a point.
+  arma::Cube<arma::s8> paddedInput;
+
+  //! Locally-stored unrolled input patches of a point.
+  arma::Mat<arma::s8> columns;
+
+  //! Locally-stored integer products.
+  arma::Mat<arma::s32> products;
+
+  //! Locally-stored delta object.
+  OutputDataType delta;
+
+  //! Locally-stored input parameter object.
+  InputDataType inputParameter;
+
+  //! Locally-stored output parameter object.
+  OutputDataType outputParameter;
+}; // class QuantizedConvolution
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "quantized_convolution_impl.hpp"
+
+#endif
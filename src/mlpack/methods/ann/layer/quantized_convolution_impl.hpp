@@ -0,0 +1,193 @@
+/**
+ * @file methods/ann/layer/quantized_convolution_impl.hpp
+ *
+ * Implementation of the QuantizedConvolution class, an inference version of
+ * the Convolution layer with 8-bit integer weights.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_QUANTIZED_CONVOLUTION_IMPL_HPP
+#define MLPACK_METHODS_ANN_LAYER_QUANTIZED_CONVOLUTION_IMPL_HPP
+
+// In case it hasn't yet been included.
+#include "quantized_convolution.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+template<typename InputDataType, typename OutputDataType>
+QuantizedConvolution<InputDataType, OutputDataType>::QuantizedConvolution() :
+    inSize(0),
+    outSize(0),
+    kernelWidth(0),
+    kernelHeight(0),
+    strideWidth(1),
+    strideHeight(1),
+    padWLeft(0),
+    padWRight(0),
+    padHBottom(0),
+    padHTop(0),
+    inputScale(1.0),
+    inputWidth(0),
+    inputHeight(0),
+    outputWidth(0),
+    outputHeight(0)
+{
+  // Nothing to do here.
+}
+
+template<typename InputDataType, typename OutputDataType>
+QuantizedConvolution<InputDataType, OutputDataType>::QuantizedConvolution(
+    const arma::cube& weight,
+    const arma::mat& bias,
+    const double inputRange,
+    const size_t inputWidth,
+    const size_t inputHeight,
+    const size_t strideWidth,
+    const size_t strideHeight,
+    const std::tuple<size_t, size_t>& padW,
+    const std::tuple<size_t, size_t>& padH) :
+    outSize(bias.n_elem),
+    kernelWidth(weight.n_rows),
+    kernelHeight(weight.n_cols),
+    strideWidth(strideWidth),
+    strideHeight(strideHeight),
+    padWLeft(std::get<0>(padW)),
+    padWRight(std::get<1>(padW)),
+    padHBottom(std::get<1>(padH)),
+    padHTop(std::get<0>(padH)),
+    bias(bias),
+    inputScale(Int8Scale(inputRange)),
+    inputWidth(inputWidth),
+    inputHeight(inputHeight),
+    outputWidth(0),
+    outputHeight(0)
+{
+  if (outSize == 0 || weight.n_slices % outSize != 0)
+  {
+    std::ostringstream oss;
+    oss << "QuantizedConvolution::QuantizedConvolution(): " << weight.n_slices
+        << " filters cannot be split into " << outSize << " output maps.";
+    throw std::invalid_argument(oss.str());
+  }
+  inSize = weight.n_slices / outSize;
+
+  // The filters of each output map are contiguous, so they form one column in
+  // the unrolled form that Im2Col() uses.
+  const arma::mat weightMat(const_cast<arma::cube&>(weight).memptr(),
+      kernelWidth * kernelHeight * inSize, outSize, false, true);
+  QuantizeInt8Columns(weightMat, this->weight, scales);
+  this->bias.reshape(outSize, 1);
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+void QuantizedConvolution<InputDataType, OutputDataType>::Forward(
+    const arma::Mat<eT>& input, arma::Mat<eT>& output)
+{
+  const size_t paddedWidth = inputWidth + padWLeft + padWRight;
+  const size_t paddedHeight = inputHeight + padHTop + padHBottom;
+  outputWidth = (paddedWidth - kernelWidth) / strideWidth + 1;
+  outputHeight = (paddedHeight - kernelHeight) / strideHeight + 1;
+
+  const arma::Row<eT> outputScales = arma::conv_to<arma::Row<eT> >::from(
+      scales.t() * inputScale);
+  const arma::Row<eT> outputBias = arma::conv_to<arma::Row<eT> >::from(
+      bias.t());
+
+  // The padding is zero, which is also zero after the quantization, so only
+  // the inside of the padded maps has to be written for each point.
+  paddedInput.zeros(paddedWidth, paddedHeight, inSize);
+  output.set_size(outputWidth * outputHeight * outSize, input.n_cols);
+  for (size_t b = 0; b < input.n_cols; ++b)
+  {
+    const eT* point = input.colptr(b);
+    for (size_t m = 0; m < inSize; ++m)
+    {
+      for (size_t j = 0; j < inputHeight; ++j)
+      {
+        QuantizeInt8(point + (m * inputHeight + j) * inputWidth, inputWidth,
+            inputScale, paddedInput.slice_colptr(m, j + padHTop) + padWLeft);
+      }
+    }
+
+    Im2ColConvolution<>::Im2Col(paddedInput.memptr(), paddedWidth,
+        paddedHeight, inSize, kernelWidth, kernelHeight, columns, strideWidth,
+        strideHeight);
+    Int8TransposedProduct(columns, weight, products);
+
+    arma::Mat<eT> outputPoint(output.colptr(b), outputWidth * outputHeight,
+        outSize, false, true);
+    outputPoint = arma::conv_to<arma::Mat<eT> >::from(products);
+    outputPoint.each_row() %= outputScales;
+    outputPoint.each_row() += outputBias;
+  }
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+void QuantizedConvolution<InputDataType, OutputDataType>::Backward(
+    const arma::Mat<eT>& /* input */, const arma::Mat<eT>& gy, arma::Mat<eT>& g)
+{
+  arma::Mat<eT> dequantized = arma::conv_to<arma::Mat<eT> >::from(weight);
+  dequantized.each_row() %= arma::conv_to<arma::Row<eT> >::from(scales.t());
+
+  const size_t paddedWidth = inputWidth + padWLeft + padWRight;
+  const size_t paddedHeight = inputHeight + padHTop + padHBottom;
+
+  g.set_size(inputWidth * inputHeight * inSize, gy.n_cols);
+  arma::Mat<eT> errorColumns;
+  arma::Cube<eT> gPadded;
+  for (size_t b = 0; b < gy.n_cols; ++b)
+  {
+    const arma::Mat<eT> errorPoint(const_cast<arma::Mat<eT>&>(gy).colptr(b),
+        outputWidth * outputHeight, outSize, false, true);
+    errorColumns = dequantized * errorPoint.t();
+
+    gPadded.zeros(paddedWidth, paddedHeight, inSize);
+    Im2ColConvolution<>::Col2Im(errorColumns, paddedWidth, paddedHeight,
+        inSize, kernelWidth, kernelHeight, gPadded.memptr(), strideWidth,
+        strideHeight);
+
+    arma::Cube<eT> gPoint(g.colptr(b), inputWidth, inputHeight, inSize, false,
+        true);
+    for (size_t m = 0; m < inSize; ++m)
+    {
+      gPoint.slice(m) = gPadded.slice(m).submat(padWLeft, padHTop,
+          padWLeft + inputWidth - 1, padHTop + inputHeight - 1);
+    }
+  }
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename Archive>
+void QuantizedConvolution<InputDataType, OutputDataType>::serialize(
+    Archive& ar, const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(inSize);
+  ar & BOOST_SERIALIZATION_NVP(outSize);
+  ar & BOOST_SERIALIZATION_NVP(kernelWidth);
+  ar & BOOST_SERIALIZATION_NVP(kernelHeight);
+  ar & BOOST_SERIALIZATION_NVP(strideWidth);
+  ar & BOOST_SERIALIZATION_NVP(strideHeight);
+  ar & BOOST_SERIALIZATION_NVP(padWLeft);
+  ar & BOOST_SERIALIZATION_NVP(padWRight);
+  ar & BOOST_SERIALIZATION_NVP(padHBottom);
+  ar & BOOST_SERIALIZATION_NVP(padHTop);
+  ar & BOOST_SERIALIZATION_NVP(weight);
+  ar & BOOST_SERIALIZATION_NVP(scales);
+  ar & BOOST_SERIALIZATION_NVP(bias);
+  ar & BOOST_SERIALIZATION_NVP(inputScale);
+  ar & BOOST_SERIALIZATION_NVP(inputWidth);
+  ar & BOOST_SERIALIZATION_NVP(inputHeight);
+  ar & BOOST_SERIALIZATION_NVP(outputWidth);
+  ar & BOOST_SERIALIZATION_NVP(outputHeight);
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
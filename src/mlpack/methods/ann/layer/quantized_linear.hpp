@@ -0,0 +1,166 @@
+/**
+ * @file methods/ann/layer/quantized_linear.hpp
+ *
+ * Definition of the QuantizedLinear class, an inference version of the Linear
+ * and LinearNoBias layers with 8-bit integer weights.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_QUANTIZED_LINEAR_HPP
+#define MLPACK_METHODS_ANN_LAYER_QUANTIZED_LINEAR_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "layer_types.hpp"
+#include "int8_quantization.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * The QuantizedLinear layer computes the affine transformation of a trained
+ * Linear or LinearNoBias layer with 8-bit integer arithmetic.  Each row of the
+ * weight matrix (each output unit) is quantized with its own scale, and the
+ * input is quantized with a single scale that is chosen from the range of the
+ * inputs seen during calibration; the products are accumulated in 32-bit
+ * integers and then scaled back, and the bias is added in floating point.
+ *
+ * The layer has no trainable parameters; it is usually created by
+ * FFN::Quantize().  The backward pass uses the dequantized weights, so the
+ * error can still be propagated through the layer.
+ *
+ * @tparam InputDataType Type of the input data (arma::colvec, arma::mat,
+ *         arma::sp_mat or arma::cube).
+ * @tparam OutputDataType Type of the output data (arma::colvec, arma::mat,
+ *         arma::sp_mat or arma::cube).
+ */
+template <
+    typename InputDataType = arma::mat,
+    typename OutputDataType = arma::mat
+>
+class QuantizedLinear
+{
+ public:
+  //! Create the QuantizedLinear object.
+  QuantizedLinear();
+
+  /**
+   * Create the QuantizedLinear object from the weights of a trained layer.
+   *
+   * @param weight The outSize x inSize weight matrix.
+   * @param bias The bias of each output unit; an empty matrix means no bias.
+   * @param inputRange The largest absolute input value that is expected (for
+   *     instance the largest one of the calibration data); larger inputs are
+   *     clamped.
+   */
+  QuantizedLinear(const arma::mat& weight,
+                  const arma::mat& bias,
+                  const double inputRange);
+
+  /**
+   * Ordinary feed forward pass of a neural network, evaluating the function
+   * f(x) by propagating the activity forward through f.
+   *
+   * @param input Input data used for evaluating the specified function.
+   * @param output Resulting output activation.
+   */
+  template<typename eT>
+  void Forward(const arma::Mat<eT>& input, arma::Mat<eT>& output);
+
+  /**
+   * Ordinary feed backward pass of a neural network, calculating the function
+   * f(x) by propagating x backwards trough f, using the dequantized weights.
+   *
+   * @param * (input) The propagated input activation.
+   * @param gy The backpropagated error.
+   * @param g The calculated gradient.
+   */
+  template<typename eT>
+  void Backward(const arma::Mat<eT>& /* input */,
+                const arma::Mat<eT>& gy,
+                arma::Mat<eT>& g);
+
+  //! Get the input parameter.
+  InputDataType const& InputParameter() const { return inputParameter; }
+  //! Modify the input parameter.
+  InputDataType& InputParameter() { return inputParameter; }
+
+  //! Get the output parameter.
+  OutputDataType const& OutputParameter() const { return outputParameter; }
+  //! Modify the output parameter.
+  OutputDataType& OutputParameter() { return outputParameter; }
+
+  //! Get the delta.
+  OutputDataType const& Delta() const { return delta; }
+  //! Modify the delta.
+  OutputDataType& Delta() { return delta; }
+
+  //! Get the input size.
+  size_t InputSize() const { return inSize; }
+
+  //! Get the output size.
+  size_t OutputSize() const { return outSize; }
+
+  //! Get the quantized weights (stored transposed, one column per output unit).
+  const arma::Mat<arma::s8>& Weight() const { return weight; }
+
+  //! Get the quantization scale of the weights of each output unit.
+  const arma::vec& Scales() const { return scales; }
+
+  //! Get the quantization scale of the input.
+  double InputScale() const { return inputScale; }
+
+  //! Get the bias (empty if the layer has no bias).
+  const arma::mat& Bias() const { return bias; }
+
+  /**
+   * Serialize the layer.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  //! Locally-stored number of input units.
+  size_t inSize;
+
+  //! Locally-stored number of output units.
+  size_t outSize;
+
+  //! Locally-stored quantized weights (inSize x outSize).
+  arma::Mat<arma::s8> weight;
+
+  //! Locally-stored quantization scale of each output unit.
+  arma::vec scales;
+
+  //! Locally-stored bias.
+  arma::mat bias;
+
+  //! Locally-stored quantization scale of the input.
+  double inputScale;
+
+  //! Locally-stored quantized input.
+  arma::Mat<arma::s8> quantizedInput;
+
+  //! Locally-stored integer products.
+  arma::Mat<arma::s32> products;
+
+  //! Locally-stored delta object.
+  OutputDataType delta;
+
+  //! Locally-stored input parameter object.
+  InputDataType inputParameter;
+
+  //! Locally-stored output parameter object.
+  OutputDataType outputParameter;
+}; // class QuantizedLinear
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "quantized_linear_impl.hpp"
+
+#endif
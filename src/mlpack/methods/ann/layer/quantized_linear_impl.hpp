@@ -0,0 +1,98 @@
+/**
+ * @file methods/ann/layer/quantized_linear_impl.hpp
+ *
+ * Implementation of the QuantizedLinear class, an inference version of the
+ * Linear and LinearNoBias layers with 8-bit integer weights.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_QUANTIZED_LINEAR_IMPL_HPP
+#define MLPACK_METHODS_ANN_LAYER_QUANTIZED_LINEAR_IMPL_HPP
+
+// In case it hasn't yet been included.
+#include "quantized_linear.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+template<typename InputDataType, typename OutputDataType>
+QuantizedLinear<InputDataType, OutputDataType>::QuantizedLinear() :
+    inSize(0),
+    outSize(0),
+    inputScale(1.0)
+{
+  // Nothing to do here.
+}
+
+template<typename InputDataType, typename OutputDataType>
+QuantizedLinear<InputDataType, OutputDataType>::QuantizedLinear(
+    const arma::mat& weight,
+    const arma::mat& bias,
+    const double inputRange) :
+    inSize(weight.n_cols),
+    outSize(weight.n_rows),
+    bias(bias),
+    inputScale(Int8Scale(inputRange))
+{
+  if (!bias.is_empty() && bias.n_elem != outSize)
+  {
+    std::ostringstream oss;
+    oss << "QuantizedLinear::QuantizedLinear(): the bias has " << bias.n_elem
+        << " elements, but there are " << outSize << " output units.";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // Each output unit is a column of the transposed weights, so that the
+  // products use contiguous memory.
+  QuantizeInt8Columns(arma::mat(weight.t()), this->weight, scales);
+  this->bias.reshape(bias.n_elem, 1);
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+void QuantizedLinear<InputDataType, OutputDataType>::Forward(
+    const arma::Mat<eT>& input, arma::Mat<eT>& output)
+{
+  quantizedInput.set_size(input.n_rows, input.n_cols);
+  QuantizeInt8(input.memptr(), input.n_elem, inputScale,
+      quantizedInput.memptr());
+
+  Int8TransposedProduct(weight, quantizedInput, products);
+  output = arma::conv_to<arma::Mat<eT> >::from(products);
+  output.each_col() %= arma::conv_to<arma::Col<eT> >::from(
+      scales * inputScale);
+
+  if (!bias.is_empty())
+    output.each_col() += arma::conv_to<arma::Col<eT> >::from(bias);
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+void QuantizedLinear<InputDataType, OutputDataType>::Backward(
+    const arma::Mat<eT>& /* input */, const arma::Mat<eT>& gy, arma::Mat<eT>& g)
+{
+  arma::Mat<eT> dequantized = arma::conv_to<arma::Mat<eT> >::from(weight);
+  dequantized.each_row() %= arma::conv_to<arma::Row<eT> >::from(scales.t());
+  g = dequantized * gy;
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename Archive>
+void QuantizedLinear<InputDataType, OutputDataType>::serialize(
+    Archive& ar, const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(inSize);
+  ar & BOOST_SERIALIZATION_NVP(outSize);
+  ar & BOOST_SERIALIZATION_NVP(weight);
+  ar & BOOST_SERIALIZATION_NVP(scales);
+  ar & BOOST_SERIALIZATION_NVP(bias);
+  ar & BOOST_SERIALIZATION_NVP(inputScale);
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
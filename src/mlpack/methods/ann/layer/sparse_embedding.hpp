@@ -0,0 +1,234 @@
+/**
+ * @file methods/ann/layer/sparse_embedding.hpp
+ *
+ * Definition of the SparseEmbedding class, an embedding layer that updates
+ * only the embeddings used by each batch.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_SPARSE_EMBEDDING_HPP
+#define MLPACK_METHODS_ANN_LAYER_SPARSE_EMBEDDING_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/methods/ann/init_rules/gaussian_init.hpp>
+#include <mlpack/methods/ann/sparse_update/lazy_adagrad_update.hpp>
+#include <mlpack/methods/ann/sparse_update/lazy_adam_update.hpp>
+#include <mlpack/methods/ann/sparse_update/lazy_sgd_update.hpp>
+#include <mlpack/methods/ann/sparse_update/sparse_gradient.hpp>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * An embedding layer for large vocabularies.  Like Lookup, it maps indices
+ * (starting at 1) to columns of an embedding table, but the gradient of the
+ * table is sparse: only the columns used by the batch have one.  So instead of
+ * keeping the table in the parameters of the network (where the optimizer
+ * would update all of it at every step), the layer keeps the table itself and
+ * updates the used columns with its UpdateRuleType (LazySGDUpdate,
+ * LazyAdaGradUpdate or LazyAdamUpdate).  The cost of a step then depends on
+ * the size of the batch and not on the size of the vocabulary; the rest of the
+ * network is trained by the optimizer as usual.
+ *
+ * Each column of the input holds the indices of one sequence of seqLength
+ * tokens, and the corresponding column of the output holds their embeddings,
+ * one after the other (embeddingSize * seqLength rows), which is the input
+ * expected by MultiheadAttention and TransformerEncoder.
+ *
+ * Gradient() doesn't change the table: it adds the row-sparse gradient of the
+ * batch to the gradient accumulated since the last step, which is available
+ * through SparseIndices() (the distinct columns of the table with a gradient)
+ * and SparseGradient() (their gradients).  Step() updates the table with the
+ * accumulated gradient and discards it, so calling it again without a new
+ * gradient does nothing.  FFN and RNN discard the accumulated gradient when
+ * they start to compute a new gradient, and call Step() after each step of the
+ * optimizer (see SparseUpdateCallback); code that calls Gradient() itself has
+ * to call Step().
+ *
+ * Note that the step size of the update is the one of the UpdateRuleType, and
+ * not the step size of the optimizer, which never sees the table.
+ *
+ * The table is initialized by the initialization rule of the network, when
+ * the network initializes its parameters (see InitializeWeights()).  Copies
+ * of the layer share the table, the state of the update rule and the
+ * accumulated gradient, so the copies FFN uses to compute the gradient with
+ * several threads add up their gradients, and one step updates the table.
+ *
+ * @tparam InputDataType Type of the input data (arma::colvec, arma::mat,
+ *         arma::sp_mat or arma::cube).
+ * @tparam OutputDataType Type of the output data (arma::colvec, arma::mat,
+ *         arma::sp_mat or arma::cube).
+ * @tparam UpdateRuleType Rule used to update the used columns of the table.
+ */
+template <
+    typename InputDataType = arma::mat,
+    typename OutputDataType = arma::mat,
+    typename UpdateRuleType = LazySGDUpdate
+>
+class SparseEmbedding
+{
+ public:
+  //! Create the SparseEmbedding object.
+  SparseEmbedding();
+
+  /**
+   * Create the SparseEmbedding object, with an embedding table drawn from the
+   * standard normal distribution, until a network initializes it with its own
+   * rule.
+   *
+   * @param vocabSize The number of embeddings in the table.
+   * @param embeddingSize The size of each embedding.
+   * @param updateRule The rule used to update the used embeddings.
+   */
+  SparseEmbedding(const size_t vocabSize,
+                  const size_t embeddingSize,
+                  const UpdateRuleType& updateRule = UpdateRuleType());
+
+  /**
+   * Ordinary feed forward pass of a neural network, evaluating the function
+   * f(x) by propagating the activity forward through f.
+   *
+   * @param input Input data used for evaluating the specified function.
+   * @param output Resulting output activation.
+   */
+  template<typename eT>
+  void Forward(const arma::Mat<eT>& input, arma::Mat<eT>& output);
+
+  /**
+   * Ordinary feed backward pass of a neural network; the indices have no
+   * gradient, so the result is zero.
+   *
+   * @param * (input) The propagated input activation.
+   * @param gy The backpropagated error.
+   * @param g The calculated gradient.
+   */
+  template<typename eT>
+  void Backward(const arma::Mat<eT>& /* input */,
+                const arma::Mat<eT>& gy,
+                arma::Mat<eT>& g);
+
+  /*
+   * Calculate the sparse gradient of the embedding table using the output
+   * delta and the input indices, and add it to the accumulated gradient.  The
+   * table doesn't change until Step() is called.
+   *
+   * @param input The input parameter used for calculating the gradient.
+   * @param error The calculated error.
+   * @param * (gradient) The calculated gradient (empty, since the table is not
+   *     part of the parameters of the network).
+   */
+  template<typename eT>
+  void Gradient(const arma::Mat<eT>& input,
+                const arma::Mat<eT>& error,
+                arma::Mat<eT>& /* gradient */);
+
+  /**
+   * Update the used embeddings with the accumulated gradient, using the update
+   * rule, and discard the gradient.  This does nothing if no gradient was
+   * accumulated since the last step.
+   */
+  void Step();
+
+  //! Discard the accumulated gradient without updating the table.
+  void ResetSparseGradient();
+
+  /**
+   * Initialize the embedding table with the given rule.
+   *
+   * @param initializeRule The rule used to initialize the table.
+   */
+  template<typename InitializationRuleType>
+  void InitializeWeights(InitializationRuleType& initializeRule);
+
+  //! Get the parameters (empty; see Embedding()).
+  OutputDataType const& Parameters() const { return weights; }
+  //! Modify the parameters (empty; see Embedding()).
+  OutputDataType& Parameters() { return weights; }
+
+  //! Get the output parameter.
+  OutputDataType const& OutputParameter() const { return outputParameter; }
+  //! Modify the output parameter.
+  OutputDataType& OutputParameter() { return outputParameter; }
+
+  //! Get the delta.
+  OutputDataType const& Delta() const { return delta; }
+  //! Modify the delta.
+  OutputDataType& Delta() { return delta; }
+
+  //! Get the gradient (empty; see SparseGradient()).
+  OutputDataType const& Gradient() const { return gradient; }
+  //! Modify the gradient (empty; see SparseGradient()).
+  OutputDataType& Gradient() { return gradient; }
+
+  //! Get the embedding table (embeddingSize x vocabSize).
+  OutputDataType const& Embedding() const { return *embedding; }
+  //! Modify the embedding table (embeddingSize x vocabSize).
+  OutputDataType& Embedding() { return *embedding; }
+
+  //! Get the update rule.
+  UpdateRuleType const& UpdateRule() const { return *updateRule; }
+  //! Modify the update rule.
+  UpdateRuleType& UpdateRule() { return *updateRule; }
+
+  //! Get the columns of the table with an accumulated gradient.
+  arma::uvec const& SparseIndices() const { return *sparseIndices; }
+
+  //! Get the accumulated gradient of the columns of SparseIndices().
+  OutputDataType const& SparseGradient() const { return *sparseGradient; }
+
+  //! Get the number of embeddings in the table.
+  size_t VocabSize() const { return vocabSize; }
+
+  //! Get the size of each embedding.
+  size_t EmbeddingSize() const { return embeddingSize; }
+
+  /**
+   * Serialize the layer.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  //! Locally-stored number of embeddings in the table.
+  size_t vocabSize;
+
+  //! Locally-stored size of each embedding.
+  size_t embeddingSize;
+
+  //! Locally-stored embedding table, shared by the copies of the layer.
+  std::shared_ptr<OutputDataType> embedding;
+
+  //! Locally-stored update rule, shared by the copies of the layer.
+  std::shared_ptr<UpdateRuleType> updateRule;
+
+  //! Locally-stored columns of the table with an accumulated gradient,
+  //! shared by the copies of the layer.
+  std::shared_ptr<arma::uvec> sparseIndices;
+
+  //! Locally-stored accumulated gradient of those columns, shared by the
+  //! copies of the layer.
+  std::shared_ptr<OutputDataType> sparseGradient;
+
+  //! Locally-stored (empty) weight object.
+  OutputDataType weights;
+
+  //! Locally-stored delta object.
+  OutputDataType delta;
+
+  //! Locally-stored (empty) gradient object.
+  OutputDataType gradient;
+
+  //! Locally-stored output parameter object.
+  OutputDataType outputParameter;
+}; // class SparseEmbedding
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "sparse_embedding_impl.hpp"
+
+#endif
@@ -0,0 +1,159 @@
+/**
+ * @file methods/ann/layer/sparse_embedding_impl.hpp
+ *
+ * Implementation of the SparseEmbedding class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_SPARSE_EMBEDDING_IMPL_HPP
+#define MLPACK_METHODS_ANN_LAYER_SPARSE_EMBEDDING_IMPL_HPP
+
+// In case it hasn't yet been included.
+#include "sparse_embedding.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+template<typename InputDataType, typename OutputDataType,
+         typename UpdateRuleType>
+SparseEmbedding<InputDataType, OutputDataType, UpdateRuleType>::
+SparseEmbedding() :
+    vocabSize(0),
+    embeddingSize(0),
+    embedding(new OutputDataType()),
+    updateRule(new UpdateRuleType()),
+    sparseIndices(new arma::uvec()),
+    sparseGradient(new OutputDataType())
+{
+  // Nothing to do here.
+}
+
+template<typename InputDataType, typename OutputDataType,
+         typename UpdateRuleType>
+SparseEmbedding<InputDataType, OutputDataType, UpdateRuleType>::
+SparseEmbedding(const size_t vocabSize,
+                const size_t embeddingSize,
+                const UpdateRuleType& updateRule) :
+    vocabSize(vocabSize),
+    embeddingSize(embeddingSize),
+    embedding(new OutputDataType()),
+    updateRule(new UpdateRuleType(updateRule)),
+    sparseIndices(new arma::uvec()),
+    sparseGradient(new OutputDataType())
+{
+  GaussianInitialization initializeRule;
+  InitializeWeights(initializeRule);
+}
+
+template<typename InputDataType, typename OutputDataType,
+         typename UpdateRuleType>
+template<typename eT>
+void SparseEmbedding<InputDataType, OutputDataType, UpdateRuleType>::Forward(
+    const arma::Mat<eT>& input, arma::Mat<eT>& output)
+{
+  const arma::uvec indices = arma::conv_to<arma::uvec>::from(
+      arma::vectorise(input));
+  if (!indices.is_empty() && (indices.min() == 0 || indices.max() > vocabSize))
+  {
+    Log::Fatal << "SparseEmbedding::Forward(): the indices must be between 1 "
+        << "and " << vocabSize << "." << std::endl;
+  }
+
+  output.set_size(embeddingSize * input.n_rows, input.n_cols);
+  arma::Mat<eT> tokens(output.memptr(), embeddingSize, indices.n_elem, false,
+      true);
+  tokens = embedding->cols(indices - 1);
+}
+
+template<typename InputDataType, typename OutputDataType,
+         typename UpdateRuleType>
+template<typename eT>
+void SparseEmbedding<InputDataType, OutputDataType, UpdateRuleType>::Backward(
+    const arma::Mat<eT>& /* input */,
+    const arma::Mat<eT>& gy,
+    arma::Mat<eT>& g)
+{
+  g.zeros(gy.n_rows / embeddingSize, gy.n_cols);
+}
+
+template<typename InputDataType, typename OutputDataType,
+         typename UpdateRuleType>
+template<typename eT>
+void SparseEmbedding<InputDataType, OutputDataType, UpdateRuleType>::Gradient(
+    const arma::Mat<eT>& input,
+    const arma::Mat<eT>& error,
+    arma::Mat<eT>& /* gradient */)
+{
+  // Sum the errors of the tokens with the same index.
+  const arma::uvec indices = arma::conv_to<arma::uvec>::from(
+      arma::vectorise(input)) - 1;
+  const arma::Mat<eT> errorTokens(const_cast<eT*>(error.memptr()),
+      embeddingSize, indices.n_elem, false, true);
+
+  // The copies of the layer share the accumulated gradient and may compute
+  // their gradients at the same time.
+  #pragma omp critical(sparse_embedding_gradient)
+  AccumulateSparseGradient(indices, errorTokens, *sparseIndices,
+      *sparseGradient);
+}
+
+template<typename InputDataType, typename OutputDataType,
+         typename UpdateRuleType>
+void SparseEmbedding<InputDataType, OutputDataType, UpdateRuleType>::Step()
+{
+  if (sparseIndices->is_empty())
+    return;
+
+  updateRule->Update(*embedding, *sparseIndices, *sparseGradient);
+  ResetSparseGradient();
+}
+
+template<typename InputDataType, typename OutputDataType,
+         typename UpdateRuleType>
+void SparseEmbedding<InputDataType, OutputDataType, UpdateRuleType>::
+ResetSparseGradient()
+{
+  sparseIndices->reset();
+  sparseGradient->reset();
+}
+
+template<typename InputDataType, typename OutputDataType,
+         typename UpdateRuleType>
+template<typename InitializationRuleType>
+void SparseEmbedding<InputDataType, OutputDataType, UpdateRuleType>::
+InitializeWeights(InitializationRuleType& initializeRule)
+{
+  embedding->set_size(embeddingSize, vocabSize);
+  initializeRule.Initialize(*embedding, embeddingSize, vocabSize);
+  ResetSparseGradient();
+}
+
+template<typename InputDataType, typename OutputDataType,
+         typename UpdateRuleType>
+template<typename Archive>
+void SparseEmbedding<InputDataType, OutputDataType, UpdateRuleType>::serialize(
+    Archive& ar, const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(vocabSize);
+  ar & BOOST_SERIALIZATION_NVP(embeddingSize);
+
+  // A loaded layer does not share its table with the copies of the old one.
+  if (Archive::is_loading::value)
+  {
+    embedding.reset(new OutputDataType());
+    updateRule.reset(new UpdateRuleType());
+    sparseIndices.reset(new arma::uvec());
+    sparseGradient.reset(new OutputDataType());
+  }
+
+  ar & boost::serialization::make_nvp("embedding", *embedding);
+  ar & boost::serialization::make_nvp("updateRule", *updateRule);
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
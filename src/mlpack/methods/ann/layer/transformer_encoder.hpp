@@ -0,0 +1,256 @@
+/**
+ * @file methods/ann/layer/transformer_encoder.hpp
+ *
+ * Definition of the TransformerEncoder class, one encoder block of the
+ * Transformer.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_TRANSFORMER_ENCODER_HPP
+#define MLPACK_METHODS_ANN_LAYER_TRANSFORMER_ENCODER_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "base_layer.hpp"
+#include "dropout.hpp"
+#include "layer_norm.hpp"
+#include "linear.hpp"
+#include "multihead_attention.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * One encoder block of the Transformer (Vaswani et al., 2017; see
+ * MultiheadAttention): multi-head self-attention followed by a two-layer
+ * feed-forward network applied to each token, each with dropout, a residual
+ * connection and layer normalization:
+ *
+ * @code
+ * y = LayerNorm(x + Dropout(MultiheadAttention(x)))
+ * output = LayerNorm(y + Dropout(Linear(ReLU(Linear(y)))))
+ * @endcode
+ *
+ * Like MultiheadAttention, each column of the input is one sequence stored as
+ * the embedDim x seqLength matrix of its tokens, and the output has the shape
+ * of the input.  The layer normalization and the feed-forward network work on
+ * each token, so the block runs its MultiheadAttention, LayerNorm, Linear,
+ * ReLULayer and Dropout layers on the embedDim x (seqLength * batchSize)
+ * matrix of all the tokens of the batch.  The parameters of the block are
+ * those of its layers, one after the other.
+ *
+ * @tparam InputDataType Type of the input data (arma::colvec, arma::mat,
+ *         arma::sp_mat or arma::cube).
+ * @tparam OutputDataType Type of the output data (arma::colvec, arma::mat,
+ *         arma::sp_mat or arma::cube).
+ */
+template <
+    typename InputDataType = arma::mat,
+    typename OutputDataType = arma::mat
+>
+class TransformerEncoder
+{
+ public:
+  //! Create the TransformerEncoder object.
+  TransformerEncoder();
+
+  /**
+   * Create the TransformerEncoder object.
+   *
+   * @param embedDim The size of the embedding of each token.
+   * @param numHeads The number of attention heads; it must divide embedDim.
+   * @param feedForwardSize The size of the hidden layer of the feed-forward
+   *     network.
+   * @param dropout The dropout ratio after the attention and the feed-forward
+   *     network.
+   */
+  TransformerEncoder(const size_t embedDim,
+                     const size_t numHeads,
+                     const size_t feedForwardSize,
+                     const double dropout = 0.1);
+
+  /*
+   * Reset the layer parameter.
+   */
+  void Reset();
+
+  /**
+   * Ordinary feed forward pass of a neural network, evaluating the function
+   * f(x) by propagating the activity forward through f.
+   *
+   * @param input Input data used for evaluating the specified function.
+   * @param output Resulting output activation.
+   */
+  template<typename eT>
+  void Forward(const arma::Mat<eT>& input, arma::Mat<eT>& output);
+
+  /**
+   * Ordinary feed backward pass of a neural network, calculating the function
+   * f(x) by propagating x backwards trough f. Using the results from the feed
+   * forward pass.
+   *
+   * @param input The propagated input activation.
+   * @param gy The backpropagated error.
+   * @param g The calculated gradient.
+   */
+  template<typename eT>
+  void Backward(const arma::Mat<eT>& input,
+                const arma::Mat<eT>& gy,
+                arma::Mat<eT>& g);
+
+  /*
+   * Calculate the gradient using the output delta and the input activation.
+   *
+   * @param input The input parameter used for calculating the gradient.
+   * @param * (error) The calculated error (the errors of the inner layers
+   *     are kept from Backward()).
+   * @param gradient The calculated gradient.
+   */
+  template<typename eT>
+  void Gradient(const arma::Mat<eT>& input,
+                const arma::Mat<eT>& /* error */,
+                arma::Mat<eT>& gradient);
+
+  //! Get the parameters.
+  OutputDataType const& Parameters() const { return weights; }
+  //! Modify the parameters.
+  OutputDataType& Parameters() { return weights; }
+
+  //! Get the input parameter.
+  InputDataType const& InputParameter() const { return inputParameter; }
+  //! Modify the input parameter.
+  InputDataType& InputParameter() { return inputParameter; }
+
+  //! Get the output parameter.
+  OutputDataType const& OutputParameter() const { return outputParameter; }
+  //! Modify the output parameter.
+  OutputDataType& OutputParameter() { return outputParameter; }
+
+  //! Get the delta.
+  OutputDataType const& Delta() const { return delta; }
+  //! Modify the delta.
+  OutputDataType& Delta() { return delta; }
+
+  //! Get the gradient.
+  OutputDataType const& Gradient() const { return gradient; }
+  //! Modify the gradient.
+  OutputDataType& Gradient() { return gradient; }
+
+  //! Get the value of the deterministic parameter.
+  bool Deterministic() const { return deterministic; }
+  //! Modify the value of the deterministic parameter.
+  bool& Deterministic() { return deterministic; }
+
+  //! Get the attention layer.
+  MultiheadAttention<InputDataType, OutputDataType> const& Attention() const
+  { return attention; }
+  //! Modify the attention layer (for instance, to set its attention mask).
+  MultiheadAttention<InputDataType, OutputDataType>& Attention()
+  { return attention; }
+
+  /**
+   * Serialize the layer.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  //! Set the parameters and gradients of the inner layers to point into the
+  //! given matrix, in the order of the parameters of the block.
+  template<typename eT>
+  void SetInnerParameters(arma::Mat<eT>& parameters, const bool gradients);
+
+  //! Locally-stored size of the embedding of each token.
+  size_t embedDim;
+
+  //! Locally-stored attention layer.
+  MultiheadAttention<InputDataType, OutputDataType> attention;
+
+  //! Locally-stored dropout after the attention.
+  Dropout<InputDataType, OutputDataType> attentionDropout;
+
+  //! Locally-stored layer normalization after the attention.
+  LayerNorm<InputDataType, OutputDataType> attentionNorm;
+
+  //! Locally-stored first layer of the feed-forward network.
+  Linear<InputDataType, OutputDataType> feedForward1;
+
+  //! Locally-stored activation of the feed-forward network.
+  BaseLayer<RectifierFunction, InputDataType, OutputDataType>
+      feedForwardActivation;
+
+  //! Locally-stored second layer of the feed-forward network.
+  Linear<InputDataType, OutputDataType> feedForward2;
+
+  //! Locally-stored dropout after the feed-forward network.
+  Dropout<InputDataType, OutputDataType> feedForwardDropout;
+
+  //! Locally-stored layer normalization after the feed-forward network.
+  LayerNorm<InputDataType, OutputDataType> feedForwardNorm;
+
+  //! If true dropout is disabled.
+  bool deterministic;
+
+  //! Locally-stored output of the attention.
+  OutputDataType attentionOutput;
+
+  //! Locally-stored input of the first layer normalization.
+  OutputDataType attentionResidual;
+
+  //! Locally-stored output of the first layer normalization.
+  OutputDataType attentionNormOutput;
+
+  //! Locally-stored output of the first layer of the feed-forward network.
+  OutputDataType hidden;
+
+  //! Locally-stored output of the activation of the feed-forward network.
+  OutputDataType activation;
+
+  //! Locally-stored output of the feed-forward network.
+  OutputDataType feedForwardOutput;
+
+  //! Locally-stored input of the second layer normalization.
+  OutputDataType feedForwardResidual;
+
+  //! Locally-stored error of the output of the attention.
+  OutputDataType attentionError;
+
+  //! Locally-stored error of the output of the first layer normalization.
+  OutputDataType attentionNormError;
+
+  //! Locally-stored error of the output of the first layer of the
+  //! feed-forward network.
+  OutputDataType hiddenError;
+
+  //! Locally-stored error of the output of the feed-forward network.
+  OutputDataType feedForwardError;
+
+  //! Locally-stored error of the output of the block, as a token matrix.
+  OutputDataType outputError;
+
+  //! Locally-stored weight object.
+  OutputDataType weights;
+
+  //! Locally-stored delta object.
+  OutputDataType delta;
+
+  //! Locally-stored gradient object.
+  OutputDataType gradient;
+
+  //! Locally-stored input parameter object.
+  InputDataType inputParameter;
+
+  //! Locally-stored output parameter object.
+  OutputDataType outputParameter;
+}; // class TransformerEncoder
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "transformer_encoder_impl.hpp"
+
+#endif
@@ -0,0 +1,187 @@
+/**
+ * @file methods/ann/layer/transformer_encoder_impl.hpp
+ *
+ * Implementation of the TransformerEncoder class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_TRANSFORMER_ENCODER_IMPL_HPP
+#define MLPACK_METHODS_ANN_LAYER_TRANSFORMER_ENCODER_IMPL_HPP
+
+// In case it hasn't yet been included.
+#include "transformer_encoder.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+template<typename InputDataType, typename OutputDataType>
+TransformerEncoder<InputDataType, OutputDataType>::TransformerEncoder() :
+    embedDim(0),
+    deterministic(false)
+{
+  // Nothing to do here.
+}
+
+template<typename InputDataType, typename OutputDataType>
+TransformerEncoder<InputDataType, OutputDataType>::TransformerEncoder(
+    const size_t embedDim,
+    const size_t numHeads,
+    const size_t feedForwardSize,
+    const double dropout) :
+    embedDim(embedDim),
+    attention(embedDim, numHeads),
+    attentionDropout(dropout),
+    attentionNorm(embedDim),
+    feedForward1(embedDim, feedForwardSize),
+    feedForward2(feedForwardSize, embedDim),
+    feedForwardDropout(dropout),
+    feedForwardNorm(embedDim),
+    deterministic(false)
+{
+  weights.set_size(attention.Parameters().n_elem +
+      attentionNorm.Parameters().n_elem + feedForward1.Parameters().n_elem +
+      feedForward2.Parameters().n_elem + feedForwardNorm.Parameters().n_elem,
+      1);
+}
+
+template<typename InputDataType, typename OutputDataType>
+void TransformerEncoder<InputDataType, OutputDataType>::Reset()
+{
+  SetInnerParameters(weights, false);
+
+  attention.Reset();
+  attentionNorm.Reset();
+  feedForward1.Reset();
+  feedForward2.Reset();
+  feedForwardNorm.Reset();
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+void TransformerEncoder<InputDataType, OutputDataType>::Forward(
+    const arma::Mat<eT>& input, arma::Mat<eT>& output)
+{
+  const size_t tokens = input.n_elem / embedDim;
+  attentionDropout.Deterministic() = deterministic;
+  feedForwardDropout.Deterministic() = deterministic;
+
+  // The attention works on whole sequences.
+  attention.Forward(input, attentionOutput);
+  attentionDropout.Forward(OutputDataType(attentionOutput), attentionOutput);
+  attentionResidual = input + attentionOutput;
+
+  // Everything else works on each token.
+  attentionResidual.reshape(embedDim, tokens);
+  attentionNorm.Forward(attentionResidual, attentionNormOutput);
+  feedForward1.Forward(attentionNormOutput, hidden);
+  feedForwardActivation.Forward(hidden, activation);
+  feedForward2.Forward(activation, feedForwardOutput);
+  feedForwardDropout.Forward(OutputDataType(feedForwardOutput),
+      feedForwardOutput);
+  feedForwardResidual = attentionNormOutput + feedForwardOutput;
+
+  output.set_size(input.n_rows, input.n_cols);
+  arma::Mat<eT> outputTokens(output.memptr(), embedDim, tokens, false, true);
+  feedForwardNorm.Forward(feedForwardResidual, outputTokens);
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+void TransformerEncoder<InputDataType, OutputDataType>::Backward(
+    const arma::Mat<eT>& input, const arma::Mat<eT>& gy, arma::Mat<eT>& g)
+{
+  const size_t tokens = gy.n_elem / embedDim;
+  outputError = arma::Mat<eT>(const_cast<eT*>(gy.memptr()), embedDim, tokens,
+      false, true);
+
+  // The error of the residual goes both to the feed-forward network and to
+  // its input.
+  arma::Mat<eT> residualError, error;
+  feedForwardNorm.Backward(feedForwardResidual, outputError, residualError);
+  feedForwardDropout.Backward(feedForwardOutput, residualError,
+      feedForwardError);
+  feedForward2.Backward(activation, feedForwardError, error);
+  feedForwardActivation.Backward(activation, error, hiddenError);
+  feedForward1.Backward(attentionNormOutput, hiddenError, attentionNormError);
+  attentionNormError += residualError;
+
+  attentionNorm.Backward(attentionResidual, attentionNormError, residualError);
+  residualError.reshape(gy.n_rows, gy.n_cols);
+  attentionDropout.Backward(attentionOutput, residualError, attentionError);
+  attention.Backward(input, attentionError, g);
+  g += residualError;
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+void TransformerEncoder<InputDataType, OutputDataType>::Gradient(
+    const arma::Mat<eT>& input,
+    const arma::Mat<eT>& /* error */,
+    arma::Mat<eT>& gradient)
+{
+  SetInnerParameters(gradient, true);
+
+  attention.Gradient(input, attentionError, attention.Gradient());
+  attentionNorm.Gradient(attentionResidual, attentionNormError,
+      attentionNorm.Gradient());
+  feedForward1.Gradient(attentionNormOutput, hiddenError,
+      feedForward1.Gradient());
+  feedForward2.Gradient(activation, feedForwardError, feedForward2.Gradient());
+  feedForwardNorm.Gradient(feedForwardResidual, outputError,
+      feedForwardNorm.Gradient());
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+void TransformerEncoder<InputDataType, OutputDataType>::SetInnerParameters(
+    arma::Mat<eT>& parameters, const bool gradients)
+{
+  size_t offset = 0;
+  auto set = [&](OutputDataType& layerWeights, OutputDataType& layerGradient)
+  {
+    const size_t size = layerWeights.n_elem;
+    OutputDataType& target = gradients ? layerGradient : layerWeights;
+    target = OutputDataType(parameters.memptr() + offset, size, 1, false,
+        false);
+    offset += size;
+  };
+
+  set(attention.Parameters(), attention.Gradient());
+  set(attentionNorm.Parameters(), attentionNorm.Gradient());
+  set(feedForward1.Parameters(), feedForward1.Gradient());
+  set(feedForward2.Parameters(), feedForward2.Gradient());
+  set(feedForwardNorm.Parameters(), feedForwardNorm.Gradient());
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename Archive>
+void TransformerEncoder<InputDataType, OutputDataType>::serialize(
+    Archive& ar, const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(embedDim);
+  ar & BOOST_SERIALIZATION_NVP(attention);
+  ar & BOOST_SERIALIZATION_NVP(attentionDropout);
+  ar & BOOST_SERIALIZATION_NVP(attentionNorm);
+  ar & BOOST_SERIALIZATION_NVP(feedForward1);
+  ar & BOOST_SERIALIZATION_NVP(feedForward2);
+  ar & BOOST_SERIALIZATION_NVP(feedForwardDropout);
+  ar & BOOST_SERIALIZATION_NVP(feedForwardNorm);
+
+  // This is inefficient, but we have to allocate this memory so that
+  // WeightSetVisitor gets the right size.
+  if (Archive::is_loading::value)
+  {
+    weights.set_size(attention.Parameters().n_elem +
+        attentionNorm.Parameters().n_elem + feedForward1.Parameters().n_elem +
+        feedForward2.Parameters().n_elem + feedForwardNorm.Parameters().n_elem,
+        1);
+  }
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
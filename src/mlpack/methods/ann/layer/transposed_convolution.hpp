@@ -19,6 +19,7 @@
 #include <mlpack/methods/ann/convolution_rules/naive_convolution.hpp>
 #include <mlpack/methods/ann/convolution_rules/fft_convolution.hpp>
 #include <mlpack/methods/ann/convolution_rules/svd_convolution.hpp>
+#include <mlpack/methods/ann/convolution_rules/im2col_convolution.hpp>
 #include <mlpack/core/util/to_lower.hpp>
 
 #include "layer_types.hpp"
@@ -31,6 +32,14 @@ namespace ann /** Artificial Neural Network. */ {
  * Implementation of the Transposed Convolution class. The Transposed
  * Convolution class represents a single layer of a neural network.
  *
+ * If Im2ColConvolution is used as a convolution rule, the corresponding pass
+ * works on all the maps of each point with one matrix product, without
+ * inserting zeros between the input elements: the forward pass multiplies
+ * every input element with all the filters and adds the products onto the
+ * output maps ("col2im"), and the backward pass and the gradient unroll the
+ * patches of the error ("im2col").  This is much faster than the default
+ * NaiveConvolution, especially with strides larger than one.
+ *
  * @tparam ForwardConvolutionRule Convolution to perform forward process.
  * @tparam BackwardConvolutionRule Convolution to perform backward process.
  * @tparam GradientConvolutionRule Convolution to calculate gradient.
@@ -295,6 +304,62 @@ class TransposedConvolution
    */
   void InitializeSamePadding();
 
+  /*
+   * Insert zeros between the elements of the input and pad it, for the
+   * convolution rules that work on single maps.
+   *
+   * @param inputTemp The input maps.
+   */
+  template<typename eT>
+  void ExpandInput(const arma::Cube<eT>& inputTemp);
+
+  /*
+   * Arrange the filters for the im2col passes: the filters of output map o are
+   * the rows o * kernelWidth * kernelHeight to
+   * (o + 1) * kernelWidth * kernelHeight - 1, with one column per input map.
+   *
+   * @param filters The arranged filters.
+   */
+  void FilterMatrix(arma::mat& filters) const
+  {
+    const size_t kernelSize = kernelWidth * kernelHeight;
+    filters.set_size(kernelSize * outSize, inSize);
+    for (size_t outMap = 0; outMap < outSize; ++outMap)
+    {
+      filters.rows(outMap * kernelSize, (outMap + 1) * kernelSize - 1) =
+          arma::mat(weight.slice_memptr(outMap * inSize), kernelSize, inSize);
+    }
+  }
+
+  /*
+   * Copy the error of the given point onto the full output maps, with zeros
+   * for the cropped padding, for the im2col passes.
+   *
+   * @param mappedError The error of all the output maps.
+   * @param b The index of the point.
+   * @param errorFull The full output maps to fill.
+   */
+  template<typename eT>
+  void FullError(const arma::Cube<eT>& mappedError,
+                 const size_t b,
+                 arma::Cube<eT>& errorFull) const;
+
+  /*
+   * Get the size of the output maps before cropping the padding, for the
+   * im2col passes.  Every element of the input adds a filter onto these maps,
+   * at a stride of strideWidth and strideHeight.
+   *
+   * @param fullWidth The width of the full output maps.
+   * @param fullHeight The height of the full output maps.
+   */
+  void FullOutputSize(size_t& fullWidth, size_t& fullHeight) const
+  {
+    fullWidth = std::max(strideWidth * (inputWidth - 1) + kernelWidth,
+        padWLeft + outputWidth);
+    fullHeight = std::max(strideHeight * (inputHeight - 1) + kernelHeight,
+        padHTop + outputHeight);
+  }
+
   /*
    * Rotates a dense matrix counterclockwise by 180 degrees.
    *
@@ -212,51 +212,50 @@ void TransposedConvolution<
   arma::cube inputTemp(const_cast<arma::Mat<eT>&>(input).memptr(),
       inputWidth, inputHeight, inSize * batchSize, false, false);
 
-  if (strideWidth > 1 || strideHeight > 1)
-  {
-    InsertZeros(inputTemp, strideWidth, strideHeight, inputExpandedTemp);
+  output.set_size(outputWidth * outputHeight * outSize, batchSize);
+  outputTemp = arma::Cube<eT>(output.memptr(), outputWidth, outputHeight,
+      outSize * batchSize, false, false);
+  outputTemp.zeros();
 
-    if (paddingForward.PadWLeft() != 0 || paddingForward.PadWRight() != 0 ||
-        paddingForward.PadHTop() != 0 || paddingForward.PadHBottom() != 0)
+  if (IsIm2ColConvolution<ForwardConvolutionRule>::value)
+  {
+    // Multiply every input element of each point with all the filters at once,
+    // and add the products onto the full output maps, instead of convolving
+    // the input with zeros inserted between its elements.
+    arma::mat filters;
+    FilterMatrix(filters);
+    size_t fullWidth, fullHeight;
+    FullOutputSize(fullWidth, fullHeight);
+
+    arma::Mat<eT> columns;
+    arma::Cube<eT> outputFull(fullWidth, fullHeight, outSize);
+    for (size_t b = 0; b < batchSize; ++b)
     {
-      inputPaddedTemp.set_size(inputExpandedTemp.n_rows +
-          paddingForward.PadWLeft() + paddingForward.PadWRight(),
-          inputExpandedTemp.n_cols + paddingForward.PadHTop() +
-          paddingForward.PadHBottom(), inputExpandedTemp.n_slices);
+      const arma::Mat<eT> inputPoint(inputTemp.slice_memptr(b * inSize),
+          inputWidth * inputHeight, inSize, false, true);
+      columns = filters * inputPoint.t();
 
-      for (size_t i = 0; i < inputExpandedTemp.n_slices; ++i)
+      outputFull.zeros();
+      Im2ColConvolution<>::Col2Im(columns, fullWidth, fullHeight, outSize,
+          kernelWidth, kernelHeight, outputFull.memptr(), strideWidth,
+          strideHeight);
+
+      for (size_t outMap = 0; outMap < outSize; ++outMap)
       {
-        paddingForward.Forward(inputExpandedTemp.slice(i),
-            inputPaddedTemp.slice(i));
+        outputTemp.slice(outMap + b * outSize) = outputFull.slice(
+            outMap).submat(padWLeft, padHTop, padWLeft + outputWidth - 1,
+            padHTop + outputHeight - 1) + bias(outMap);
       }
     }
-    else
-    {
-      inputPaddedTemp = arma::Cube<eT>(inputExpandedTemp.memptr(),
-          inputExpandedTemp.n_rows, inputExpandedTemp.n_cols,
-          inputExpandedTemp.n_slices, false, false);;
-    }
-  }
-  else if (paddingForward.PadWLeft() != 0 ||
-           paddingForward.PadWRight() != 0 ||
-           paddingForward.PadHTop() != 0 ||
-           paddingForward.PadHBottom() != 0)
-  {
-    inputPaddedTemp.set_size(inputTemp.n_rows + paddingForward.PadWLeft() +
-        paddingForward.PadWRight(), inputTemp.n_cols +
-        paddingForward.PadHTop() + paddingForward.PadHBottom(),
-        inputTemp.n_slices);
 
-    for (size_t i = 0; i < inputTemp.n_slices; ++i)
-    {
-      paddingForward.Forward(inputTemp.slice(i), inputPaddedTemp.slice(i));
-    }
+    // The other convolution rules need the expanded input for the gradient.
+    if (!IsIm2ColConvolution<GradientConvolutionRule>::value)
+      ExpandInput(inputTemp);
+
+    return;
   }
 
-  output.set_size(outputWidth * outputHeight * outSize, batchSize);
-  outputTemp = arma::Cube<eT>(output.memptr(), outputWidth, outputHeight,
-      outSize * batchSize, false, false);
-  outputTemp.zeros();
+  ExpandInput(inputTemp);
 
   for (size_t outMap = 0, outMapIdx = 0, batchCount = 0; outMap <
       outSize * batchSize; outMap++)
@@ -314,6 +313,38 @@ void TransposedConvolution<
 {
   arma::Cube<eT> mappedError(((arma::Mat<eT>&) gy).memptr(), outputWidth,
       outputHeight, outSize * batchSize, false, false);
+  g.set_size(inputWidth * inputHeight * inSize, batchSize);
+  gTemp = arma::Cube<eT>(g.memptr(), inputWidth, inputHeight, inSize *
+      batchSize, false, false);
+
+  gTemp.zeros();
+
+  if (IsIm2ColConvolution<BackwardConvolutionRule>::value)
+  {
+    // Unroll the patches of the error that each input element contributed to,
+    // and multiply them with all the filters at once.
+    arma::mat filters;
+    FilterMatrix(filters);
+    size_t fullWidth, fullHeight;
+    FullOutputSize(fullWidth, fullHeight);
+
+    arma::Mat<eT> columns;
+    arma::Cube<eT> errorFull(fullWidth, fullHeight, outSize);
+    for (size_t b = 0; b < batchSize; ++b)
+    {
+      FullError(mappedError, b, errorFull);
+      Im2ColConvolution<>::Im2Col(errorFull.memptr(), fullWidth, fullHeight,
+          outSize, kernelWidth, kernelHeight, columns, strideWidth,
+          strideHeight);
+
+      arma::Mat<eT> gPoint(gTemp.slice_memptr(b * inSize),
+          inputWidth * inputHeight, inSize, false, true);
+      gPoint = columns.t() * filters;
+    }
+
+    return;
+  }
+
   arma::Cube<eT> mappedErrorPadded;
   if (paddingBackward.PadWLeft() != 0 || paddingBackward.PadWRight() != 0 ||
       paddingBackward.PadHTop() != 0 || paddingBackward.PadHBottom() != 0)
@@ -329,11 +360,6 @@ void TransposedConvolution<
           mappedErrorPadded.slice(i));
     }
   }
-  g.set_size(inputWidth * inputHeight * inSize, batchSize);
-  gTemp = arma::Cube<eT>(g.memptr(), inputWidth, inputHeight, inSize *
-      batchSize, false, false);
-
-  gTemp.zeros();
 
   for (size_t outMap = 0, outMapIdx = 0, batchCount = 0; outMap <
       outSize * batchSize; outMap++)
@@ -394,6 +420,49 @@ void TransposedConvolution<
       weight.n_cols, weight.n_slices, false, false);
   gradientTemp.zeros();
 
+  if (IsIm2ColConvolution<GradientConvolutionRule>::value)
+  {
+    // Correlate the unrolled patches of the error of each point with all the
+    // input maps at once.
+    size_t fullWidth, fullHeight;
+    FullOutputSize(fullWidth, fullHeight);
+    const size_t kernelSize = kernelWidth * kernelHeight;
+    arma::Mat<eT> filterGradient(kernelSize * outSize, inSize,
+        arma::fill::zeros);
+    arma::Col<eT> biasGradient(gradient.memptr() + weight.n_elem, outSize,
+        false, true);
+    biasGradient.zeros();
+
+    arma::Mat<eT> columns;
+    arma::Cube<eT> errorFull(fullWidth, fullHeight, outSize);
+    for (size_t b = 0; b < batchSize; ++b)
+    {
+      FullError(mappedError, b, errorFull);
+      Im2ColConvolution<>::Im2Col(errorFull.memptr(), fullWidth, fullHeight,
+          outSize, kernelWidth, kernelHeight, columns, strideWidth,
+          strideHeight);
+
+      const arma::Mat<eT> inputPoint(inputTemp.slice_memptr(b * inSize),
+          inputWidth * inputHeight, inSize, false, true);
+      filterGradient += columns * inputPoint;
+
+      const arma::Mat<eT> errorPoint(mappedError.slice_memptr(b * outSize),
+          outputWidth * outputHeight, outSize, false, true);
+      biasGradient += arma::sum(errorPoint, 0).t();
+    }
+
+    // Put the rows of each output map back in the order of the weights.
+    for (size_t outMap = 0; outMap < outSize; ++outMap)
+    {
+      arma::Mat<eT> weightGradient(gradientTemp.slice_memptr(outMap * inSize),
+          kernelSize, inSize, false, true);
+      weightGradient = filterGradient.rows(outMap * kernelSize,
+          (outMap + 1) * kernelSize - 1);
+    }
+
+    return;
+  }
+
   arma::Mat<eT> inputSlice, output, deltaSlice, rotatedOutput;
 
   for (size_t outMap = 0, outMapIdx = 0, batchCount = 0; outMap <
@@ -434,6 +503,92 @@ void TransposedConvolution<
   }
 }
 
+template<
+    typename ForwardConvolutionRule,
+    typename BackwardConvolutionRule,
+    typename GradientConvolutionRule,
+    typename InputDataType,
+    typename OutputDataType
+>
+template<typename eT>
+void TransposedConvolution<
+    ForwardConvolutionRule,
+    BackwardConvolutionRule,
+    GradientConvolutionRule,
+    InputDataType,
+    OutputDataType
+>::ExpandInput(const arma::Cube<eT>& inputTemp)
+{
+  if (strideWidth > 1 || strideHeight > 1)
+  {
+    InsertZeros(inputTemp, strideWidth, strideHeight, inputExpandedTemp);
+
+    if (paddingForward.PadWLeft() != 0 || paddingForward.PadWRight() != 0 ||
+        paddingForward.PadHTop() != 0 || paddingForward.PadHBottom() != 0)
+    {
+      inputPaddedTemp.set_size(inputExpandedTemp.n_rows +
+          paddingForward.PadWLeft() + paddingForward.PadWRight(),
+          inputExpandedTemp.n_cols + paddingForward.PadHTop() +
+          paddingForward.PadHBottom(), inputExpandedTemp.n_slices);
+
+      for (size_t i = 0; i < inputExpandedTemp.n_slices; ++i)
+      {
+        paddingForward.Forward(inputExpandedTemp.slice(i),
+            inputPaddedTemp.slice(i));
+      }
+    }
+    else
+    {
+      inputPaddedTemp = arma::Cube<eT>(inputExpandedTemp.memptr(),
+          inputExpandedTemp.n_rows, inputExpandedTemp.n_cols,
+          inputExpandedTemp.n_slices, false, false);;
+    }
+  }
+  else if (paddingForward.PadWLeft() != 0 ||
+           paddingForward.PadWRight() != 0 ||
+           paddingForward.PadHTop() != 0 ||
+           paddingForward.PadHBottom() != 0)
+  {
+    inputPaddedTemp.set_size(inputTemp.n_rows + paddingForward.PadWLeft() +
+        paddingForward.PadWRight(), inputTemp.n_cols +
+        paddingForward.PadHTop() + paddingForward.PadHBottom(),
+        inputTemp.n_slices);
+
+    for (size_t i = 0; i < inputTemp.n_slices; ++i)
+    {
+      paddingForward.Forward(inputTemp.slice(i), inputPaddedTemp.slice(i));
+    }
+  }
+}
+
+template<
+    typename ForwardConvolutionRule,
+    typename BackwardConvolutionRule,
+    typename GradientConvolutionRule,
+    typename InputDataType,
+    typename OutputDataType
+>
+template<typename eT>
+void TransposedConvolution<
+    ForwardConvolutionRule,
+    BackwardConvolutionRule,
+    GradientConvolutionRule,
+    InputDataType,
+    OutputDataType
+>::FullError(const arma::Cube<eT>& mappedError,
+             const size_t b,
+             arma::Cube<eT>& errorFull) const
+{
+  // The cropped padding of the full output maps gets no error.
+  errorFull.zeros();
+  for (size_t outMap = 0; outMap < outSize; ++outMap)
+  {
+    errorFull.slice(outMap).submat(padWLeft, padHTop,
+        padWLeft + outputWidth - 1, padHTop + outputHeight - 1) =
+        mappedError.slice(outMap + b * outSize);
+  }
+}
+
 template<
     typename ForwardConvolutionRule,
     typename BackwardConvolutionRule,
@@ -173,6 +173,29 @@ class LayerNameVisitor : public boost::static_visitor<std::string>
     return "linearnobias";
   }
 
+  /**
+   * Return the name of the given layer of type QuantizedConvolution as a
+   * string.
+   *
+   * @param * Given layer of type QuantizedConvolution.
+   * @return The string representation of the layer.
+   */
+  std::string LayerString(QuantizedConvolution<>* /*layer*/) const
+  {
+    return "quantizedconvolution";
+  }
+
+  /**
+   * Return the name of the given layer of type QuantizedLinear as a string.
+   *
+   * @param * Given layer of type QuantizedLinear.
+   * @return The string representation of the layer.
+   */
+  std::string LayerString(QuantizedLinear<>* /*layer*/) const
+  {
+    return "quantizedlinear";
+  }
+
   /**
    * Return the name of the given layer of type MaxPooling as a string.
    *
@@ -195,6 +218,17 @@ class LayerNameVisitor : public boost::static_visitor<std::string>
     return "meanpooling";
   }
 
+  /**
+   * Return the name of the given layer of type MultiheadAttention as a string.
+   *
+   * @param * Given layer of type MultiheadAttention.
+   * @return The string representation of the layer.
+   */
+  std::string LayerString(MultiheadAttention<>* /*layer*/) const
+  {
+    return "multiheadattention";
+  }
+
   /**
    * Return the name of the given layer of type MultiplyConstant as a string.
    *
@@ -217,6 +251,28 @@ class LayerNameVisitor : public boost::static_visitor<std::string>
     return "relu";
   }
 
+  /**
+   * Return the name of the given layer of type SparseEmbedding as a string.
+   *
+   * @param * Given layer of type SparseEmbedding.
+   * @return The string representation of the layer.
+   */
+  std::string LayerString(SparseEmbedding<>* /*layer*/) const
+  {
+    return "sparseembedding";
+  }
+
+  /**
+   * Return the name of the given layer of type TransformerEncoder as a string.
+   *
+   * @param * Given layer of type TransformerEncoder.
+   * @return The string representation of the layer.
+   */
+  std::string LayerString(TransformerEncoder<>* /*layer*/) const
+  {
+    return "transformerencoder";
+  }
+
   /**
    * Return the name of the given layer of type TransposedConvolution as a
    * string.
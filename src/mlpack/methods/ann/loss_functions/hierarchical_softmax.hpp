@@ -0,0 +1,300 @@
+/**
+ * @file methods/ann/loss_functions/hierarchical_softmax.hpp
+ *
+ * Definition of the HierarchicalSoftmax class, an output layer for a large
+ * number of classes that factorizes the softmax into a softmax over clusters
+ * of classes and a softmax over the classes of each cluster.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LOSS_FUNCTIONS_HIERARCHICAL_SOFTMAX_HPP
+#define MLPACK_METHODS_ANN_LOSS_FUNCTIONS_HIERARCHICAL_SOFTMAX_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/methods/ann/init_rules/gaussian_init.hpp>
+#include <mlpack/methods/ann/sparse_update/lazy_adagrad_update.hpp>
+#include <mlpack/methods/ann/sparse_update/lazy_adam_update.hpp>
+#include <mlpack/methods/ann/sparse_update/lazy_sgd_update.hpp>
+#include <mlpack/methods/ann/sparse_update/sparse_gradient.hpp>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * The hierarchical softmax is an output layer for problems with a large number
+ * of classes.  The classes are split into clusters of consecutive classes (by
+ * default, about sqrt(numClasses) clusters of about sqrt(numClasses) classes),
+ * and the probability of a class is the probability of its cluster times the
+ * probability of the class within its cluster:
+ *
+ * @f{eqnarray*}{
+ * P(c | h) &=& P(k(c) | h) P(c | k(c), h)
+ * @f}
+ *
+ * where both factors are softmax functions of linear scores of the hidden
+ * representation h.  So the loss and gradient of a point only need the scores
+ * of the clusters and of the classes of its cluster, about 2 sqrt(numClasses)
+ * scores instead of numClasses.  The model is a proper distribution over all
+ * the classes, which Predict() computes exactly.  Sorting the classes by
+ * frequency (so that the frequent classes share clusters) works well.  See the
+ * following paper:
+ *
+ * @code
+ * @inproceedings{goodman2001classes,
+ *   title={Classes for Fast Maximum Entropy Training},
+ *   author={Goodman, Joshua},
+ *   booktitle={Proceedings of the IEEE International Conference on Acoustics,
+ *       Speech, and Signal Processing (ICASSP)},
+ *   year={2001}
+ * }
+ * @endcode
+ *
+ * As SampledSoftmax, the layer holds the weights of the clusters and of the
+ * classes itself (one column per cluster or class, with the bias in the last
+ * row), so the last layer of the network gives the hidden representation of
+ * each point.  The layer updates the weights of the clusters and of the
+ * classes of the clusters of the batch itself with the UpdateRuleType
+ * (LazySGDUpdate, LazyAdaGradUpdate or LazyAdamUpdate), and the optimizer
+ * trains the rest of the network.  Backward() doesn't change the weights: it
+ * adds their gradient to the gradient accumulated since the last step (see
+ * ClusterGradient(), ClassIndices() and ClassGradient()), which Step() applies
+ * and discards.  FFN::Train() and RNN::Train() call Step() after each step of
+ * the optimizer (see SparseUpdateCallback).  The step size of the update is
+ * the one of the UpdateRuleType, and not the step size of the optimizer:
+ *
+ * @code
+ * FFN<HierarchicalSoftmax<>> model(HierarchicalSoftmax<>(hiddenSize,
+ *     numClasses));
+ * model.Add<Linear<>>(inputSize, hiddenSize);
+ * model.Add<ReLULayer<>>();
+ * ...
+ * model.Train(data, labels, optimizer);
+ *
+ * arma::mat hidden, probabilities;
+ * model.Predict(data, hidden);
+ * model.OutputLayer().Predict(hidden, probabilities);
+ * @endcode
+ *
+ * The target of each column is the class index, in the range between 1 and
+ * the number of classes, as for NegativeLogLikelihood.
+ *
+ * @tparam InputDataType Type of the input data (arma::colvec, arma::mat,
+ *         arma::sp_mat or arma::cube).
+ * @tparam OutputDataType Type of the output data (arma::colvec, arma::mat,
+ *         arma::sp_mat or arma::cube).
+ * @tparam UpdateRuleType Rule used to update the columns of the weights.
+ */
+template <
+    typename InputDataType = arma::mat,
+    typename OutputDataType = arma::mat,
+    typename UpdateRuleType = LazySGDUpdate
+>
+class HierarchicalSoftmax
+{
+ public:
+  //! Create the HierarchicalSoftmax object.
+  HierarchicalSoftmax();
+
+  /**
+   * Create the HierarchicalSoftmax object, with weights drawn from a normal
+   * distribution with standard deviation 1 / sqrt(inSize) and zero biases,
+   * until a network initializes them with its own rule.
+   *
+   * @param inSize The size of the hidden representation.
+   * @param numClasses The number of classes.
+   * @param numClusters The number of clusters (0 for ceil(sqrt(numClasses))).
+   * @param updateRule The rule used to update the weights.
+   */
+  HierarchicalSoftmax(const size_t inSize,
+                      const size_t numClasses,
+                      const size_t numClusters = 0,
+                      const UpdateRuleType& updateRule = UpdateRuleType());
+
+  /**
+   * Compute the negative log-likelihood of the targets, summed over the
+   * columns.
+   *
+   * @param input The hidden representation of each point.
+   * @param target The target vector, that contains the class index in the range
+   *        between 1 and the number of classes.
+   */
+  template<typename InputType, typename TargetType>
+  typename InputType::elem_type Forward(const InputType& input,
+                                        const TargetType& target);
+
+  /**
+   * Compute the gradient of the negative log-likelihood with respect to the
+   * hidden representation, and add the gradient of the weights of the clusters
+   * and of the classes of the clusters of the targets to the accumulated
+   * gradient.  The weights don't change until Step() is called.
+   *
+   * @param input The hidden representation of each point.
+   * @param target The target vector, that contains the class index in the range
+   *        between 1 and the number of classes.
+   * @param output The calculated error.
+   */
+  template<typename InputType, typename TargetType, typename OutputType>
+  void Backward(const InputType& input,
+                const TargetType& target,
+                OutputType& output);
+
+  /**
+   * Compute the probabilities of all the classes for each column of the input.
+   *
+   * @param input The hidden representation of each point.
+   * @param output The probabilities, one row per class.
+   */
+  template<typename InputType, typename OutputType>
+  void Predict(const InputType& input, OutputType& output) const;
+
+  /**
+   * Update the weights of the clusters and of the classes with an accumulated
+   * gradient, using the update rules, and discard the gradient.  This does
+   * nothing if no gradient was accumulated since the last step.
+   */
+  void Step();
+
+  //! Discard the accumulated gradient without updating the weights.
+  void ResetSparseGradient();
+
+  /**
+   * Initialize the weights of the clusters and of the classes with the given
+   * rule, and set the biases to zero.
+   *
+   * @param initializeRule The rule used to initialize the weights.
+   */
+  template<typename InitializationRuleType>
+  void InitializeWeights(InitializationRuleType& initializeRule);
+
+  //! Get the weights of the clusters (one column per cluster, with the bias in
+  //! the last row).
+  OutputDataType const& ClusterWeights() const { return clusterWeights; }
+  //! Modify the weights of the clusters.
+  OutputDataType& ClusterWeights() { return clusterWeights; }
+
+  //! Get the weights of the classes (one column per class, with the bias in
+  //! the last row).
+  OutputDataType const& ClassWeights() const { return classWeights; }
+  //! Modify the weights of the classes.
+  OutputDataType& ClassWeights() { return classWeights; }
+
+  //! Get the accumulated gradient of the weights of the clusters (empty if
+  //! there is none).
+  OutputDataType const& ClusterGradient() const { return clusterGradient; }
+
+  //! Get the classes with an accumulated gradient (starting at 0).
+  arma::uvec const& ClassIndices() const { return classIndices; }
+  //! Get the accumulated gradient of the weights of ClassIndices().
+  OutputDataType const& ClassGradient() const { return classGradient; }
+
+  //! Get the size of the hidden representation.
+  size_t InSize() const { return inSize; }
+  //! Get the number of classes.
+  size_t NumClasses() const { return numClasses; }
+  //! Get the number of clusters.
+  size_t NumClusters() const { return numClusters; }
+
+  //! Get the cluster of the given class (starting at 0).
+  size_t Cluster(const size_t c) const { return c / clusterSize; }
+
+  //! Get the input parameter.
+  InputDataType& InputParameter() const { return inputParameter; }
+  //! Modify the input parameter.
+  InputDataType& InputParameter() { return inputParameter; }
+
+  //! Get the output parameter.
+  OutputDataType& OutputParameter() const { return outputParameter; }
+  //! Modify the output parameter.
+  OutputDataType& OutputParameter() { return outputParameter; }
+
+  //! Get the delta.
+  OutputDataType& Delta() const { return delta; }
+  //! Modify the delta.
+  OutputDataType& Delta() { return delta; }
+
+  /**
+   * Serialize the layer.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  //! Get the first class of the given cluster.
+  size_t First(const size_t k) const { return k * clusterSize; }
+  //! Get the last class of the given cluster.
+  size_t Last(const size_t k) const
+  { return std::min((k + 1) * clusterSize, numClasses) - 1; }
+
+  /**
+   * Compute the scores of the clusters of each column, and the targets.
+   */
+  template<typename InputType, typename TargetType>
+  void ClusterScores(const InputType& input,
+                     const TargetType& target,
+                     arma::uvec& targets,
+                     arma::mat& scores) const;
+
+  /**
+   * Compute the scores of the classes of the given cluster for the given
+   * hidden representation.
+   */
+  template<typename VecType>
+  arma::vec ClassScores(const size_t k, const VecType& h) const;
+
+  //! Turn the given scores into probabilities, in place, and return the log of
+  //! their normalizer.
+  static double Softmax(arma::vec& scores);
+
+  //! The size of the hidden representation.
+  size_t inSize;
+
+  //! The number of classes.
+  size_t numClasses;
+
+  //! The number of clusters.
+  size_t numClusters;
+
+  //! The number of classes of each cluster (but the last one).
+  size_t clusterSize;
+
+  //! The weights of the clusters, with the bias in the last row.
+  OutputDataType clusterWeights;
+
+  //! The weights of the classes, with the bias in the last row.
+  OutputDataType classWeights;
+
+  //! The rule used to update the weights of the clusters.
+  UpdateRuleType clusterUpdateRule;
+
+  //! The rule used to update the weights of the classes.
+  UpdateRuleType classUpdateRule;
+
+  //! The accumulated gradient of the weights of the clusters.
+  OutputDataType clusterGradient;
+
+  //! The classes with an accumulated gradient.
+  arma::uvec classIndices;
+
+  //! The accumulated gradient of the weights of those classes.
+  OutputDataType classGradient;
+
+  //! Locally-stored delta object.
+  OutputDataType delta;
+
+  //! Locally-stored input parameter object.
+  InputDataType inputParameter;
+
+  //! Locally-stored output parameter object.
+  OutputDataType outputParameter;
+}; // class HierarchicalSoftmax
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "hierarchical_softmax_impl.hpp"
+
+#endif
@@ -0,0 +1,293 @@
+/**
+ * @file methods/ann/loss_functions/hierarchical_softmax_impl.hpp
+ *
+ * Implementation of the HierarchicalSoftmax class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LOSS_FUNCTIONS_HIERARCHICAL_SOFTMAX_IMPL_HPP
+#define MLPACK_METHODS_ANN_LOSS_FUNCTIONS_HIERARCHICAL_SOFTMAX_IMPL_HPP
+
+// In case it hasn't yet been included.
+#include "hierarchical_softmax.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+template<typename InputDataType, typename OutputDataType,
+         typename UpdateRuleType>
+HierarchicalSoftmax<InputDataType, OutputDataType, UpdateRuleType>::
+HierarchicalSoftmax() :
+    inSize(0),
+    numClasses(0),
+    numClusters(0),
+    clusterSize(1)
+{
+  // Nothing to do here.
+}
+
+template<typename InputDataType, typename OutputDataType,
+         typename UpdateRuleType>
+HierarchicalSoftmax<InputDataType, OutputDataType, UpdateRuleType>::
+HierarchicalSoftmax(const size_t inSize,
+                    const size_t numClasses,
+                    const size_t numClusters,
+                    const UpdateRuleType& updateRule) :
+    inSize(inSize),
+    numClasses(numClasses),
+    clusterUpdateRule(updateRule),
+    classUpdateRule(updateRule)
+{
+  const size_t clusters = (numClusters == 0) ?
+      (size_t) std::ceil(std::sqrt((double) numClasses)) : numClusters;
+  clusterSize = std::max((size_t) 1, (numClasses + clusters - 1) / clusters);
+
+  // Don't keep empty clusters.
+  this->numClusters = (numClasses + clusterSize - 1) / clusterSize;
+
+  GaussianInitialization initializeRule(0, 1.0 / std::sqrt((double) inSize));
+  InitializeWeights(initializeRule);
+}
+
+template<typename InputDataType, typename OutputDataType,
+         typename UpdateRuleType>
+double HierarchicalSoftmax<InputDataType, OutputDataType, UpdateRuleType>::
+Softmax(arma::vec& scores)
+{
+  const double maxScore = scores.max();
+  scores = arma::exp(scores - maxScore);
+  const double sum = arma::accu(scores);
+  scores /= sum;
+  return maxScore + std::log(sum);
+}
+
+template<typename InputDataType, typename OutputDataType,
+         typename UpdateRuleType>
+template<typename InputType, typename TargetType>
+void HierarchicalSoftmax<InputDataType, OutputDataType, UpdateRuleType>::
+ClusterScores(const InputType& input,
+              const TargetType& target,
+              arma::uvec& targets,
+              arma::mat& scores) const
+{
+  targets.set_size(input.n_cols);
+  for (size_t i = 0; i < input.n_cols; ++i)
+  {
+    targets[i] = target(i) - 1;
+    Log::Assert(targets[i] < numClasses, "Target class out of range.");
+  }
+
+  scores = clusterWeights.head_rows(inSize).t() * input;
+  scores.each_col() += clusterWeights.row(inSize).t();
+}
+
+template<typename InputDataType, typename OutputDataType,
+         typename UpdateRuleType>
+template<typename VecType>
+arma::vec HierarchicalSoftmax<InputDataType, OutputDataType, UpdateRuleType>::
+ClassScores(const size_t k, const VecType& h) const
+{
+  const size_t first = First(k), last = Last(k);
+  return classWeights.submat(0, first, inSize - 1, last).t() * h +
+      classWeights.submat(inSize, first, inSize, last).t();
+}
+
+template<typename InputDataType, typename OutputDataType,
+         typename UpdateRuleType>
+template<typename InputType, typename TargetType>
+typename InputType::elem_type
+HierarchicalSoftmax<InputDataType, OutputDataType, UpdateRuleType>::Forward(
+    const InputType& input,
+    const TargetType& target)
+{
+  arma::uvec targets;
+  arma::mat scores;
+  ClusterScores(input, target, targets, scores);
+
+  double output = 0;
+  for (size_t i = 0; i < input.n_cols; ++i)
+  {
+    const size_t t = targets[i];
+    const size_t k = Cluster(t);
+
+    arma::vec clusterScores = scores.col(i);
+    output += Softmax(clusterScores) - scores(k, i);
+
+    arma::vec classScores = ClassScores(k, input.col(i));
+    const double targetScore = classScores[t - First(k)];
+    output += Softmax(classScores) - targetScore;
+  }
+
+  return output;
+}
+
+template<typename InputDataType, typename OutputDataType,
+         typename UpdateRuleType>
+template<typename InputType, typename TargetType, typename OutputType>
+void HierarchicalSoftmax<InputDataType, OutputDataType, UpdateRuleType>::
+Backward(const InputType& input,
+         const TargetType& target,
+         OutputType& output)
+{
+  arma::uvec targets;
+  arma::mat scores;
+  ClusterScores(input, target, targets, scores);
+
+  // The gradients with respect to the cluster scores: the probabilities, minus
+  // one for the cluster of the target.
+  size_t numClassCols = 0;
+  for (size_t i = 0; i < input.n_cols; ++i)
+  {
+    const size_t k = Cluster(targets[i]);
+    arma::vec clusterScores = scores.col(i);
+    Softmax(clusterScores);
+    clusterScores[k] -= 1;
+    scores.col(i) = clusterScores;
+
+    numClassCols += Last(k) - First(k) + 1;
+  }
+
+  output = clusterWeights.head_rows(inSize) * scores;
+
+  arma::mat batchClusterGradient(inSize + 1, numClusters);
+  batchClusterGradient.head_rows(inSize) = input * scores.t();
+  batchClusterGradient.row(inSize) = arma::sum(scores, 1).t();
+  if (clusterGradient.is_empty())
+    clusterGradient = batchClusterGradient;
+  else
+    clusterGradient += batchClusterGradient;
+
+  // The gradients of the classes of the cluster of each target.
+  arma::uvec batchClassIndices(numClassCols);
+  arma::mat batchClassGradient(inSize + 1, numClassCols);
+  size_t offset = 0;
+  for (size_t i = 0; i < input.n_cols; ++i)
+  {
+    const size_t t = targets[i];
+    const size_t k = Cluster(t);
+    const size_t first = First(k), last = Last(k);
+    const size_t n = last - first + 1;
+
+    arma::vec classScores = ClassScores(k, input.col(i));
+    Softmax(classScores);
+    classScores[t - first] -= 1;
+
+    output.col(i) += classWeights.submat(0, first, inSize - 1, last) *
+        classScores;
+
+    batchClassIndices.subvec(offset, offset + n - 1) =
+        arma::regspace<arma::uvec>(first, last);
+    batchClassGradient.submat(0, offset, inSize - 1, offset + n - 1) =
+        input.col(i) * classScores.t();
+    batchClassGradient.submat(inSize, offset, inSize, offset + n - 1) =
+        classScores.t();
+    offset += n;
+  }
+
+  AccumulateSparseGradient(batchClassIndices, batchClassGradient,
+      classIndices, classGradient);
+}
+
+template<typename InputDataType, typename OutputDataType,
+         typename UpdateRuleType>
+void HierarchicalSoftmax<InputDataType, OutputDataType, UpdateRuleType>::
+Step()
+{
+  if (!clusterGradient.is_empty())
+  {
+    clusterUpdateRule.Update(clusterWeights,
+        arma::regspace<arma::uvec>(0, numClusters - 1), clusterGradient);
+  }
+
+  if (!classIndices.is_empty())
+    classUpdateRule.Update(classWeights, classIndices, classGradient);
+
+  ResetSparseGradient();
+}
+
+template<typename InputDataType, typename OutputDataType,
+         typename UpdateRuleType>
+void HierarchicalSoftmax<InputDataType, OutputDataType, UpdateRuleType>::
+ResetSparseGradient()
+{
+  clusterGradient.reset();
+  classIndices.reset();
+  classGradient.reset();
+}
+
+template<typename InputDataType, typename OutputDataType,
+         typename UpdateRuleType>
+template<typename InitializationRuleType>
+void HierarchicalSoftmax<InputDataType, OutputDataType, UpdateRuleType>::
+InitializeWeights(InitializationRuleType& initializeRule)
+{
+  clusterWeights.set_size(inSize + 1, numClusters);
+  initializeRule.Initialize(clusterWeights, inSize + 1, numClusters);
+  clusterWeights.row(inSize).zeros();
+
+  classWeights.set_size(inSize + 1, numClasses);
+  initializeRule.Initialize(classWeights, inSize + 1, numClasses);
+  classWeights.row(inSize).zeros();
+
+  ResetSparseGradient();
+}
+
+template<typename InputDataType, typename OutputDataType,
+         typename UpdateRuleType>
+template<typename InputType, typename OutputType>
+void HierarchicalSoftmax<InputDataType, OutputDataType, UpdateRuleType>::
+Predict(const InputType& input, OutputType& output) const
+{
+  arma::mat clusterProbs = clusterWeights.head_rows(inSize).t() * input;
+  clusterProbs.each_col() += clusterWeights.row(inSize).t();
+  for (size_t i = 0; i < clusterProbs.n_cols; ++i)
+  {
+    arma::vec p = clusterProbs.col(i);
+    Softmax(p);
+    clusterProbs.col(i) = p;
+  }
+
+  output.set_size(numClasses, input.n_cols);
+  for (size_t k = 0; k < numClusters; ++k)
+  {
+    const size_t first = First(k), last = Last(k);
+    arma::mat classProbs = classWeights.submat(0, first, inSize - 1,
+        last).t() * input;
+    classProbs.each_col() += classWeights.submat(inSize, first, inSize,
+        last).t();
+
+    for (size_t i = 0; i < classProbs.n_cols; ++i)
+    {
+      arma::vec p = classProbs.col(i);
+      Softmax(p);
+      output.submat(first, i, last, i) = p * clusterProbs(k, i);
+    }
+  }
+}
+
+template<typename InputDataType, typename OutputDataType,
+         typename UpdateRuleType>
+template<typename Archive>
+void HierarchicalSoftmax<InputDataType, OutputDataType, UpdateRuleType>::
+serialize(Archive& ar, const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(inSize);
+  ar & BOOST_SERIALIZATION_NVP(numClasses);
+  ar & BOOST_SERIALIZATION_NVP(numClusters);
+  ar & BOOST_SERIALIZATION_NVP(clusterSize);
+  ar & BOOST_SERIALIZATION_NVP(clusterWeights);
+  ar & BOOST_SERIALIZATION_NVP(classWeights);
+  ar & BOOST_SERIALIZATION_NVP(clusterUpdateRule);
+  ar & BOOST_SERIALIZATION_NVP(classUpdateRule);
+
+  if (Archive::is_loading::value)
+    ResetSparseGradient();
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
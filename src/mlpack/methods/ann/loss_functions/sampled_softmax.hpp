@@ -0,0 +1,276 @@
+/**
+ * @file methods/ann/loss_functions/sampled_softmax.hpp
+ *
+ * Definition of the SampledSoftmax class, an output layer for a large number of
+ * classes that approximates the softmax cross entropy with sampled negative
+ * classes during training.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LOSS_FUNCTIONS_SAMPLED_SOFTMAX_HPP
+#define MLPACK_METHODS_ANN_LOSS_FUNCTIONS_SAMPLED_SOFTMAX_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/random.hpp>
+#include <mlpack/methods/ann/init_rules/gaussian_init.hpp>
+#include <mlpack/methods/ann/sparse_update/lazy_adagrad_update.hpp>
+#include <mlpack/methods/ann/sparse_update/lazy_adam_update.hpp>
+#include <mlpack/methods/ann/sparse_update/lazy_sgd_update.hpp>
+#include <mlpack/methods/ann/sparse_update/sparse_gradient.hpp>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * The sampled softmax is an output layer for problems with so many classes
+ * that the scores of all of them can't be computed at every training step.
+ * It holds the weights and biases of the classes itself (one column of
+ * Weights() per class, with the bias in the last row), so the last layer of
+ * the network gives the hidden representation of each point instead of the
+ * class scores:
+ *
+ * @code
+ * FFN<SampledSoftmax<>> model(SampledSoftmax<>(hiddenSize, numClasses, 64));
+ * model.Add<Linear<>>(inputSize, hiddenSize);
+ * model.Add<ReLULayer<>>();
+ * ...
+ * model.Train(data, labels, optimizer);
+ *
+ * arma::mat hidden, probabilities;
+ * model.Predict(data, hidden);
+ * model.OutputLayer().Predict(hidden, probabilities);
+ * @endcode
+ *
+ * At every call of Forward(), numSampled negative classes are drawn (with
+ * replacement, shared by the whole batch) from the log-uniform distribution
+ * P(c) = log((c + 2) / (c + 1)) / log(numClasses + 1), which suits classes
+ * sorted by decreasing frequency.  The loss of each point is the softmax cross
+ * entropy over its target class and the sampled classes, with the scores
+ * corrected by the log of their expected counts so that the gradient is an
+ * estimate of the gradient of the full softmax, and with sampled classes equal
+ * to the target removed.  See the following paper:
+ *
+ * @code
+ * @inproceedings{jean2015using,
+ *   title={On Using Very Large Target Vocabulary for Neural Machine
+ *       Translation},
+ *   author={Jean, S{\'e}bastien and Cho, Kyunghyun and Memisevic, Roland and
+ *       Bengio, Yoshua},
+ *   booktitle={Proceedings of the 53rd Annual Meeting of the Association for
+ *       Computational Linguistics},
+ *   pages={1--10},
+ *   year={2015}
+ * }
+ * @endcode
+ *
+ * Only the columns of the target and sampled classes have a gradient, so, as
+ * for SparseEmbedding, the weights are not part of the parameters of the
+ * network: the layer updates those columns itself with the UpdateRuleType
+ * (LazySGDUpdate, LazyAdaGradUpdate or LazyAdamUpdate), and the optimizer
+ * trains the rest of the network.  Backward() uses the classes drawn by the
+ * last call of Forward(), and doesn't change the weights: it adds their
+ * row-sparse gradient to the gradient accumulated since the last step (see
+ * SparseIndices() and SparseGradient()), which Step() applies and discards.
+ * FFN::Train() and RNN::Train() call Step() after each step of the optimizer
+ * (see SparseUpdateCallback).  The step size of the update is the one of the
+ * UpdateRuleType, and not the step size of the optimizer.
+ *
+ * Predict() computes the exact softmax over all the classes, for inference.
+ *
+ * The target of each column is the class index, in the range between 1 and
+ * the number of classes, as for NegativeLogLikelihood.
+ *
+ * @tparam InputDataType Type of the input data (arma::colvec, arma::mat,
+ *         arma::sp_mat or arma::cube).
+ * @tparam OutputDataType Type of the output data (arma::colvec, arma::mat,
+ *         arma::sp_mat or arma::cube).
+ * @tparam UpdateRuleType Rule used to update the columns of the weights.
+ */
+template <
+    typename InputDataType = arma::mat,
+    typename OutputDataType = arma::mat,
+    typename UpdateRuleType = LazySGDUpdate
+>
+class SampledSoftmax
+{
+ public:
+  //! Create the SampledSoftmax object.
+  SampledSoftmax();
+
+  /**
+   * Create the SampledSoftmax object, with weights drawn from a normal
+   * distribution with standard deviation 1 / sqrt(inSize) and zero biases,
+   * until a network initializes them with its own rule.
+   *
+   * @param inSize The size of the hidden representation.
+   * @param numClasses The number of classes.
+   * @param numSampled The number of negative classes drawn at each step.
+   * @param updateRule The rule used to update the weights.
+   */
+  SampledSoftmax(const size_t inSize,
+                 const size_t numClasses,
+                 const size_t numSampled,
+                 const UpdateRuleType& updateRule = UpdateRuleType());
+
+  /**
+   * Draw the negative classes and compute the sampled softmax cross entropy,
+   * summed over the columns.
+   *
+   * @param input The hidden representation of each point.
+   * @param target The target vector, that contains the class index in the range
+   *        between 1 and the number of classes.
+   */
+  template<typename InputType, typename TargetType>
+  typename InputType::elem_type Forward(const InputType& input,
+                                        const TargetType& target);
+
+  /**
+   * Compute the gradient of the sampled softmax cross entropy with respect to
+   * the hidden representation, and add the gradient of the weights of the
+   * target and sampled classes to the accumulated gradient.  The weights don't
+   * change until Step() is called.
+   *
+   * @param input The hidden representation of each point.
+   * @param target The target vector, that contains the class index in the range
+   *        between 1 and the number of classes.
+   * @param output The calculated error.
+   */
+  template<typename InputType, typename TargetType, typename OutputType>
+  void Backward(const InputType& input,
+                const TargetType& target,
+                OutputType& output);
+
+  /**
+   * Compute the probabilities of all the classes (the exact softmax of their
+   * scores) for each column of the input.
+   *
+   * @param input The hidden representation of each point.
+   * @param output The probabilities, one row per class.
+   */
+  template<typename InputType, typename OutputType>
+  void Predict(const InputType& input, OutputType& output) const;
+
+  /**
+   * Update the weights of the classes with an accumulated gradient, using the
+   * update rule, and discard the gradient.  This does nothing if no gradient
+   * was accumulated since the last step.
+   */
+  void Step();
+
+  //! Discard the accumulated gradient without updating the weights.
+  void ResetSparseGradient();
+
+  /**
+   * Initialize the weights with the given rule, and set the biases to zero.
+   *
+   * @param initializeRule The rule used to initialize the weights.
+   */
+  template<typename InitializationRuleType>
+  void InitializeWeights(InitializationRuleType& initializeRule);
+
+  //! Get the weights (one column per class, with the bias in the last row).
+  OutputDataType const& Weights() const { return weights; }
+  //! Modify the weights (one column per class, with the bias in the last row).
+  OutputDataType& Weights() { return weights; }
+
+  //! Get the classes drawn by the last call of Forward() (starting at 0).
+  arma::uvec const& Sampled() const { return sampled; }
+
+  //! Get the classes with an accumulated gradient (starting at 0).
+  arma::uvec const& SparseIndices() const { return sparseIndices; }
+  //! Get the accumulated gradient of the weights of SparseIndices().
+  OutputDataType const& SparseGradient() const { return sparseGradient; }
+
+  //! Get the update rule.
+  UpdateRuleType const& UpdateRule() const { return updateRule; }
+  //! Modify the update rule.
+  UpdateRuleType& UpdateRule() { return updateRule; }
+
+  //! Get the size of the hidden representation.
+  size_t InSize() const { return inSize; }
+  //! Get the number of classes.
+  size_t NumClasses() const { return numClasses; }
+  //! Get the number of negative classes drawn at each step.
+  size_t NumSampled() const { return numSampled; }
+
+  //! Get the input parameter.
+  InputDataType& InputParameter() const { return inputParameter; }
+  //! Modify the input parameter.
+  InputDataType& InputParameter() { return inputParameter; }
+
+  //! Get the output parameter.
+  OutputDataType& OutputParameter() const { return outputParameter; }
+  //! Modify the output parameter.
+  OutputDataType& OutputParameter() { return outputParameter; }
+
+  //! Get the delta.
+  OutputDataType& Delta() const { return delta; }
+  //! Modify the delta.
+  OutputDataType& Delta() { return delta; }
+
+  /**
+   * Serialize the layer.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  //! Get the log of the expected count of the given class in the sample.
+  double LogExpectedCount(const size_t c) const;
+
+  /**
+   * Compute the corrected scores of the target class (trueScores) and of the
+   * sampled classes (scores, one row per sampled class) of each column, with
+   * the sampled classes equal to the target set to -infinity.
+   */
+  template<typename InputType, typename TargetType>
+  void Scores(const InputType& input,
+              const TargetType& target,
+              arma::uvec& targets,
+              arma::rowvec& trueScores,
+              arma::mat& scores) const;
+
+  //! The size of the hidden representation.
+  size_t inSize;
+
+  //! The number of classes.
+  size_t numClasses;
+
+  //! The number of negative classes drawn at each step.
+  size_t numSampled;
+
+  //! The weights, one column per class, with the bias in the last row.
+  OutputDataType weights;
+
+  //! The rule used to update the weights.
+  UpdateRuleType updateRule;
+
+  //! The classes drawn by the last call of Forward().
+  arma::uvec sampled;
+
+  //! The classes with an accumulated gradient.
+  arma::uvec sparseIndices;
+
+  //! The accumulated gradient of the weights of those classes.
+  OutputDataType sparseGradient;
+
+  //! Locally-stored delta object.
+  OutputDataType delta;
+
+  //! Locally-stored input parameter object.
+  InputDataType inputParameter;
+
+  //! Locally-stored output parameter object.
+  OutputDataType outputParameter;
+}; // class SampledSoftmax
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "sampled_softmax_impl.hpp"
+
+#endif
@@ -0,0 +1,269 @@
+/**
+ * @file methods/ann/loss_functions/sampled_softmax_impl.hpp
+ *
+ * Implementation of the SampledSoftmax class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LOSS_FUNCTIONS_SAMPLED_SOFTMAX_IMPL_HPP
+#define MLPACK_METHODS_ANN_LOSS_FUNCTIONS_SAMPLED_SOFTMAX_IMPL_HPP
+
+// In case it hasn't yet been included.
+#include "sampled_softmax.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+template<typename InputDataType, typename OutputDataType,
+         typename UpdateRuleType>
+SampledSoftmax<InputDataType, OutputDataType, UpdateRuleType>::
+SampledSoftmax() :
+    inSize(0),
+    numClasses(0),
+    numSampled(0)
+{
+  // Nothing to do here.
+}
+
+template<typename InputDataType, typename OutputDataType,
+         typename UpdateRuleType>
+SampledSoftmax<InputDataType, OutputDataType, UpdateRuleType>::
+SampledSoftmax(const size_t inSize,
+               const size_t numClasses,
+               const size_t numSampled,
+               const UpdateRuleType& updateRule) :
+    inSize(inSize),
+    numClasses(numClasses),
+    numSampled(numSampled),
+    updateRule(updateRule)
+{
+  GaussianInitialization initializeRule(0, 1.0 / std::sqrt((double) inSize));
+  InitializeWeights(initializeRule);
+}
+
+template<typename InputDataType, typename OutputDataType,
+         typename UpdateRuleType>
+double SampledSoftmax<InputDataType, OutputDataType, UpdateRuleType>::
+LogExpectedCount(const size_t c) const
+{
+  return std::log(numSampled * std::log((c + 2.0) / (c + 1.0)) /
+      std::log(numClasses + 1.0));
+}
+
+template<typename InputDataType, typename OutputDataType,
+         typename UpdateRuleType>
+template<typename InputType, typename TargetType>
+void SampledSoftmax<InputDataType, OutputDataType, UpdateRuleType>::Scores(
+    const InputType& input,
+    const TargetType& target,
+    arma::uvec& targets,
+    arma::rowvec& trueScores,
+    arma::mat& scores) const
+{
+  targets.set_size(input.n_cols);
+  for (size_t i = 0; i < input.n_cols; ++i)
+  {
+    targets[i] = target(i) - 1;
+    Log::Assert(targets[i] < numClasses, "Target class out of range.");
+  }
+
+  const arma::mat sampledWeights = weights.cols(sampled);
+  scores = sampledWeights.head_rows(inSize).t() * input;
+  for (size_t j = 0; j < sampled.n_elem; ++j)
+  {
+    scores.row(j) += sampledWeights(inSize, j) -
+        LogExpectedCount(sampled[j]);
+  }
+
+  trueScores.set_size(input.n_cols);
+  for (size_t i = 0; i < input.n_cols; ++i)
+  {
+    const size_t t = targets[i];
+    trueScores[i] = arma::dot(weights.submat(0, t, inSize - 1, t),
+        input.col(i)) + weights(inSize, t) - LogExpectedCount(t);
+
+    // Remove the sampled classes that are the target.
+    for (size_t j = 0; j < sampled.n_elem; ++j)
+    {
+      if (sampled[j] == t)
+        scores(j, i) = -std::numeric_limits<double>::infinity();
+    }
+  }
+}
+
+template<typename InputDataType, typename OutputDataType,
+         typename UpdateRuleType>
+template<typename InputType, typename TargetType>
+typename InputType::elem_type
+SampledSoftmax<InputDataType, OutputDataType, UpdateRuleType>::Forward(
+    const InputType& input,
+    const TargetType& target)
+{
+  // Draw the classes from the log-uniform distribution.
+  const double logRange = std::log(numClasses + 1.0);
+  sampled.set_size(numSampled);
+  for (size_t j = 0; j < numSampled; ++j)
+  {
+    const size_t c = (size_t) std::exp(math::Random() * logRange) - 1;
+    sampled[j] = std::min(c, numClasses - 1);
+  }
+
+  arma::uvec targets;
+  arma::rowvec trueScores;
+  arma::mat scores;
+  Scores(input, target, targets, trueScores, scores);
+
+  double output = 0;
+  for (size_t i = 0; i < input.n_cols; ++i)
+  {
+    double maxScore = trueScores[i];
+    for (size_t j = 0; j < scores.n_rows; ++j)
+      maxScore = std::max(maxScore, scores(j, i));
+
+    double sum = std::exp(trueScores[i] - maxScore);
+    for (size_t j = 0; j < scores.n_rows; ++j)
+      sum += std::exp(scores(j, i) - maxScore);
+
+    output += maxScore + std::log(sum) - trueScores[i];
+  }
+
+  return output;
+}
+
+template<typename InputDataType, typename OutputDataType,
+         typename UpdateRuleType>
+template<typename InputType, typename TargetType, typename OutputType>
+void SampledSoftmax<InputDataType, OutputDataType, UpdateRuleType>::Backward(
+    const InputType& input,
+    const TargetType& target,
+    OutputType& output)
+{
+  arma::uvec targets;
+  arma::rowvec trueScores;
+  arma::mat scores;
+  Scores(input, target, targets, trueScores, scores);
+
+  // Turn the scores into the gradients with respect to the scores: the
+  // probabilities, minus one for the target class.
+  arma::rowvec trueGradient(input.n_cols);
+  for (size_t i = 0; i < input.n_cols; ++i)
+  {
+    double maxScore = trueScores[i];
+    for (size_t j = 0; j < scores.n_rows; ++j)
+      maxScore = std::max(maxScore, scores(j, i));
+
+    double sum = std::exp(trueScores[i] - maxScore);
+    for (size_t j = 0; j < scores.n_rows; ++j)
+    {
+      scores(j, i) = std::exp(scores(j, i) - maxScore);
+      sum += scores(j, i);
+    }
+
+    scores.col(i) /= sum;
+    trueGradient[i] = std::exp(trueScores[i] - maxScore) / sum - 1;
+  }
+
+  // The gradient with respect to the input.
+  const arma::mat sampledWeights = weights.cols(sampled);
+  output = sampledWeights.head_rows(inSize) * scores;
+  for (size_t i = 0; i < input.n_cols; ++i)
+  {
+    output.col(i) += trueGradient[i] *
+        weights.submat(0, targets[i], inSize - 1, targets[i]);
+  }
+
+  // The gradient of the weights of the sampled classes, followed by the
+  // gradient of the weights of the target of each column.
+  const size_t numSampledCols = sampled.n_elem;
+  arma::mat gradient(inSize + 1, numSampledCols + input.n_cols);
+  if (numSampledCols > 0)
+  {
+    gradient.submat(0, 0, inSize - 1, numSampledCols - 1) = input * scores.t();
+    gradient.submat(inSize, 0, inSize, numSampledCols - 1) =
+        arma::sum(scores, 1).t();
+  }
+
+  for (size_t i = 0; i < input.n_cols; ++i)
+  {
+    gradient.submat(0, numSampledCols + i, inSize - 1, numSampledCols + i) =
+        trueGradient[i] * input.col(i);
+    gradient(inSize, numSampledCols + i) = trueGradient[i];
+  }
+
+  AccumulateSparseGradient(arma::uvec(arma::join_cols(sampled, targets)),
+      gradient, sparseIndices, sparseGradient);
+}
+
+template<typename InputDataType, typename OutputDataType,
+         typename UpdateRuleType>
+void SampledSoftmax<InputDataType, OutputDataType, UpdateRuleType>::Step()
+{
+  if (sparseIndices.is_empty())
+    return;
+
+  updateRule.Update(weights, sparseIndices, sparseGradient);
+  ResetSparseGradient();
+}
+
+template<typename InputDataType, typename OutputDataType,
+         typename UpdateRuleType>
+void SampledSoftmax<InputDataType, OutputDataType, UpdateRuleType>::
+ResetSparseGradient()
+{
+  sparseIndices.reset();
+  sparseGradient.reset();
+}
+
+template<typename InputDataType, typename OutputDataType,
+         typename UpdateRuleType>
+template<typename InitializationRuleType>
+void SampledSoftmax<InputDataType, OutputDataType, UpdateRuleType>::
+InitializeWeights(InitializationRuleType& initializeRule)
+{
+  weights.set_size(inSize + 1, numClasses);
+  initializeRule.Initialize(weights, inSize + 1, numClasses);
+  weights.row(inSize).zeros();
+  ResetSparseGradient();
+}
+
+template<typename InputDataType, typename OutputDataType,
+         typename UpdateRuleType>
+template<typename InputType, typename OutputType>
+void SampledSoftmax<InputDataType, OutputDataType, UpdateRuleType>::Predict(
+    const InputType& input,
+    OutputType& output) const
+{
+  output = weights.head_rows(inSize).t() * input;
+  output.each_col() += weights.row(inSize).t();
+
+  for (size_t i = 0; i < output.n_cols; ++i)
+  {
+    output.col(i) = arma::exp(output.col(i) - output.col(i).max());
+    output.col(i) /= arma::accu(output.col(i));
+  }
+}
+
+template<typename InputDataType, typename OutputDataType,
+         typename UpdateRuleType>
+template<typename Archive>
+void SampledSoftmax<InputDataType, OutputDataType, UpdateRuleType>::serialize(
+    Archive& ar,
+    const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(inSize);
+  ar & BOOST_SERIALIZATION_NVP(numClasses);
+  ar & BOOST_SERIALIZATION_NVP(numSampled);
+  ar & BOOST_SERIALIZATION_NVP(weights);
+  ar & BOOST_SERIALIZATION_NVP(updateRule);
+
+  if (Archive::is_loading::value)
+    ResetSparseGradient();
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,141 @@
+/**
+ * @file methods/ann/loss_functions/softmax_cross_entropy.hpp
+ *
+ * Definition of the SoftmaxCrossEntropy class, which fuses a log-softmax layer
+ * and the negative log likelihood into one output layer.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LOSS_FUNCTIONS_SOFTMAX_CROSS_ENTROPY_HPP
+#define MLPACK_METHODS_ANN_LOSS_FUNCTIONS_SOFTMAX_CROSS_ENTROPY_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * The softmax cross entropy takes the unnormalized scores (logits) of each
+ * class and computes the same loss and gradient as a LogSoftMax layer followed
+ * by the NegativeLogLikelihood output layer, so that
+ *
+ * @code
+ * FFN<NegativeLogLikelihood<>> model;
+ * ...
+ * model.Add<Linear<>>(hiddenSize, numClasses);
+ * model.Add<LogSoftMax<>>();
+ * @endcode
+ *
+ * can be replaced by
+ *
+ * @code
+ * FFN<SoftmaxCrossEntropy<>> model;
+ * ...
+ * model.Add<Linear<>>(hiddenSize, numClasses);
+ * @endcode
+ *
+ * The log-probabilities are never stored: the loss of each column is
+ * log(sum_j exp(x_j)) - x_target, computed with the numerically stable
+ * log-sum-exp, and the gradient softmax(x) - e_target is written directly,
+ * instead of the one-hot style gradient of the negative log likelihood being
+ * backpropagated through the log-softmax layer.  Note that the predictions of
+ * the network are then the scores instead of the log-probabilities; both have
+ * the same largest class.
+ *
+ * The target of each column is the class index, in the range between 1 and
+ * the number of classes, as for NegativeLogLikelihood.
+ *
+ * @tparam InputDataType Type of the input data (arma::colvec, arma::mat,
+ *         arma::sp_mat or arma::cube).
+ * @tparam OutputDataType Type of the output data (arma::colvec, arma::mat,
+ *         arma::sp_mat or arma::cube).
+ */
+template <
+    typename InputDataType = arma::mat,
+    typename OutputDataType = arma::mat
+>
+class SoftmaxCrossEntropy
+{
+ public:
+  /**
+   * Create the SoftmaxCrossEntropy object.
+   */
+  SoftmaxCrossEntropy();
+
+  /**
+   * Computes the softmax cross entropy of the given scores, summed over the
+   * columns.
+   *
+   * @param input The scores of each class, one column per point.
+   * @param target The target vector, that contains the class index in the range
+   *        between 1 and the number of classes.
+   */
+  template<typename InputType, typename TargetType>
+  typename InputType::elem_type Forward(const InputType& input,
+                                        const TargetType& target);
+
+  /**
+   * Ordinary feed backward pass of a neural network, computing the gradient
+   * of the softmax cross entropy with respect to the scores, which is the
+   * softmax of the scores minus one for the target class.
+   *
+   * @param input The scores of each class, one column per point.
+   * @param target The target vector, that contains the class index in the range
+   *        between 1 and the number of classes.
+   * @param output The calculated error.
+   */
+  template<typename InputType, typename TargetType, typename OutputType>
+  void Backward(const InputType& input,
+                const TargetType& target,
+                OutputType& output);
+
+  //! Get the input parameter.
+  InputDataType& InputParameter() const { return inputParameter; }
+  //! Modify the input parameter.
+  InputDataType& InputParameter() { return inputParameter; }
+
+  //! Get the output parameter.
+  OutputDataType& OutputParameter() const { return outputParameter; }
+  //! Modify the output parameter.
+  OutputDataType& OutputParameter() { return outputParameter; }
+
+  //! Get the delta.
+  OutputDataType& Delta() const { return delta; }
+  //! Modify the delta.
+  OutputDataType& Delta() { return delta; }
+
+  /**
+   * Serialize the layer.
+   */
+  template<typename Archive>
+  void serialize(Archive& /* ar */, const unsigned int /* version */);
+
+ private:
+  /**
+   * Get the target class of the given column, checking that it is in range.
+   */
+  template<typename TargetType>
+  static size_t Target(const TargetType& target,
+                       const size_t col,
+                       const size_t numClasses);
+
+  //! Locally-stored delta object.
+  OutputDataType delta;
+
+  //! Locally-stored input parameter object.
+  InputDataType inputParameter;
+
+  //! Locally-stored output parameter object.
+  OutputDataType outputParameter;
+}; // class SoftmaxCrossEntropy
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "softmax_cross_entropy_impl.hpp"
+
+#endif
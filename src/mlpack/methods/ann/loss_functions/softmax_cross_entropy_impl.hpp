@@ -0,0 +1,124 @@
+/**
+ * @file methods/ann/loss_functions/softmax_cross_entropy_impl.hpp
+ *
+ * Implementation of the SoftmaxCrossEntropy class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LOSS_FUNCTIONS_SOFTMAX_CROSS_ENTROPY_IMPL_HPP
+#define MLPACK_METHODS_ANN_LOSS_FUNCTIONS_SOFTMAX_CROSS_ENTROPY_IMPL_HPP
+
+// In case it hasn't yet been included.
+#include "softmax_cross_entropy.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+template<typename InputDataType, typename OutputDataType>
+SoftmaxCrossEntropy<InputDataType, OutputDataType>::SoftmaxCrossEntropy()
+{
+  // Nothing to do here.
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename TargetType>
+size_t SoftmaxCrossEntropy<InputDataType, OutputDataType>::Target(
+    const TargetType& target,
+    const size_t col,
+    const size_t numClasses)
+{
+  const size_t currentTarget = target(col) - 1;
+  Log::Assert(currentTarget < numClasses, "Target class out of range.");
+  return currentTarget;
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename InputType, typename TargetType>
+typename InputType::elem_type
+SoftmaxCrossEntropy<InputDataType, OutputDataType>::Forward(
+    const InputType& input,
+    const TargetType& target)
+{
+  typedef typename InputType::elem_type ElemType;
+
+  // Check the targets before the parallel loop, which can't throw.
+  for (size_t i = 0; i < input.n_cols; ++i)
+    Target(target, i, input.n_rows);
+
+  ElemType output = 0;
+  #pragma omp parallel for reduction(+:output)
+  for (omp_size_t i = 0; i < (omp_size_t) input.n_cols; ++i)
+  {
+    const ElemType* x = input.colptr(i);
+
+    ElemType maxScore = x[0];
+    for (size_t j = 1; j < input.n_rows; ++j)
+      maxScore = std::max(maxScore, x[j]);
+
+    ElemType sum = 0;
+    for (size_t j = 0; j < input.n_rows; ++j)
+      sum += std::exp(x[j] - maxScore);
+
+    output += maxScore + std::log(sum) - x[Target(target, i, input.n_rows)];
+  }
+
+  return output;
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename InputType, typename TargetType, typename OutputType>
+void SoftmaxCrossEntropy<InputDataType, OutputDataType>::Backward(
+    const InputType& input,
+    const TargetType& target,
+    OutputType& output)
+{
+  typedef typename InputType::elem_type ElemType;
+
+  for (size_t i = 0; i < input.n_cols; ++i)
+    Target(target, i, input.n_rows);
+
+  output.set_size(input.n_rows, input.n_cols);
+
+  // Store the exponentials while summing them, then normalize them in place
+  // and subtract one for the target class.
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) input.n_cols; ++i)
+  {
+    const ElemType* x = input.colptr(i);
+    ElemType* g = output.colptr(i);
+
+    ElemType maxScore = x[0];
+    for (size_t j = 1; j < input.n_rows; ++j)
+      maxScore = std::max(maxScore, x[j]);
+
+    ElemType sum = 0;
+    for (size_t j = 0; j < input.n_rows; ++j)
+    {
+      g[j] = std::exp(x[j] - maxScore);
+      sum += g[j];
+    }
+
+    const ElemType invSum = 1 / sum;
+    for (size_t j = 0; j < input.n_rows; ++j)
+      g[j] *= invSum;
+
+    g[Target(target, i, input.n_rows)] -= 1;
+  }
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename Archive>
+void SoftmaxCrossEntropy<InputDataType, OutputDataType>::serialize(
+    Archive& /* ar */,
+    const unsigned int /* version */)
+{
+  // Nothing to do here.
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
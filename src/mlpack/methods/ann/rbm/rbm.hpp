@@ -380,6 +380,15 @@ class RBM
   void serialize(Archive& ar, const unsigned int /* version */);
 
  private:
+  /**
+   * Replace each element of the given matrix, a probability, with a sample of
+   * a Bernoulli distribution with that mean.  The uniform random numbers are
+   * drawn all at once into a buffer that is kept between calls.
+   *
+   * @param x The probabilities, and then the samples.
+   */
+  void SampleBernoulli(arma::Mat<ElemType>& x);
+
   //! Locally stored parameters of the network.
   arma::Mat<ElemType> parameter;
   //! The matrix of data points (predictors).
@@ -442,6 +451,8 @@ class RBM
   arma::Mat<ElemType> positiveGradient;
   //! Locally-stored temporary output of Gibbs chain.
   arma::Mat<ElemType> gibbsTemporary;
+  //! Locally-stored random numbers used for sampling.
+  arma::Mat<ElemType> randomTemporary;
   //! Locally-stored persistent CD-k boolean flag.
   bool persistence;
   //! Locally-stored reset variable.
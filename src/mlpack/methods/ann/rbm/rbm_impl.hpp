@@ -136,8 +136,15 @@ RBM<InitializationRuleType, DataType, PolicyType>::Phase(
   DataType hiddenBiasGrad = DataType(gradient.memptr() + weightGrad.n_elem,
       hiddenSize, 1, false, false);
 
-  HiddenMean(std::move(input), std::move(hiddenBiasGrad));
-  weightGrad.slice(0) = hiddenBiasGrad * input.t();
+  DataType visibleBiasGrad = DataType(gradient.memptr() + weightGrad.n_elem +
+      hiddenBiasGrad.n_elem, visibleSize, 1, false, false);
+
+  // Compute the hidden means of all the samples at once; the gradients are
+  // summed over the samples.
+  HiddenMean(std::move(input), std::move(hiddenReconstruction));
+  weightGrad.slice(0) = hiddenReconstruction * input.t();
+  hiddenBiasGrad = arma::sum(hiddenReconstruction, 1);
+  visibleBiasGrad = arma::sum(input, 1);
 }
 
 template<
@@ -168,11 +175,7 @@ RBM<InitializationRuleType, DataType, PolicyType>::SampleHidden(
     arma::Mat<ElemType>&& output)
 {
   HiddenMean(std::move(input), std::move(output));
-
-  for (size_t i = 0; i < output.n_elem; i++)
-  {
-    output(i) = math::RandBernoulli(output(i));
-  }
+  SampleBernoulli(output);
 }
 
 template<
@@ -187,11 +190,7 @@ RBM<InitializationRuleType, DataType, PolicyType>::SampleVisible(
     arma::Mat<ElemType>&& output)
 {
   VisibleMean(std::move(input), std::move(output));
-
-  for (size_t i = 0; i < output.n_elem; i++)
-  {
-    output(i) = math::RandBernoulli(output(i));
-  }
+  SampleBernoulli(output);
 }
 
 template<
@@ -275,18 +274,44 @@ void RBM<InitializationRuleType, DataType, PolicyType>::Gradient(
   Phase(std::move(predictors.cols(i, i + batchSize - 1)),
       std::move(positiveGradient));
 
-  for (size_t i = 0; i < negSteps; i++)
+  if (std::is_same<PolicyType, BinaryRBM>::value && !persistence &&
+      negSteps > 1)
   {
-    Gibbs(std::move(predictors.cols(i, i + batchSize - 1)),
+    // The chains of the negative samples are independent and the gradient of
+    // the binary RBM is a sum over the samples, so run all the chains at once
+    // as one wide batch.
+    Gibbs(arma::repmat(predictors.cols(i, i + batchSize - 1), 1, negSteps),
         std::move(negativeSamples));
-    Phase(std::move(negativeSamples), std::move(tempNegativeGradient));
-
-    negativeGradient += tempNegativeGradient;
+    Phase(std::move(negativeSamples), std::move(negativeGradient));
+  }
+  else
+  {
+    for (size_t j = 0; j < negSteps; j++)
+    {
+      Gibbs(std::move(predictors.cols(i, i + batchSize - 1)),
+          std::move(negativeSamples));
+      Phase(std::move(negativeSamples), std::move(tempNegativeGradient));
+
+      negativeGradient += tempNegativeGradient;
+    }
   }
 
   gradient = ((negativeGradient / negSteps) - positiveGradient);
 }
 
+template<
+  typename InitializationRuleType,
+  typename DataType,
+  typename PolicyType
+>
+void RBM<InitializationRuleType, DataType, PolicyType>::SampleBernoulli(
+    arma::Mat<ElemType>& x)
+{
+  randomTemporary.randu(x.n_rows, x.n_cols);
+  for (size_t i = 0; i < x.n_elem; i++)
+    x[i] = (randomTemporary[i] < x[i]) ? 1 : 0;
+}
+
 template<
   typename InitializationRuleType,
   typename DataType,
@@ -75,10 +75,15 @@ RBM<InitializationRuleType, DataType, PolicyType>::FreeEnergy(
   freeEnergy -= 0.5 * hiddenSize * poolSize *
       std::log((2.0 * M_PI) / slabPenalty);
 
+  // Project the input on the weights of all the hidden units at once.
+  const arma::Mat<ElemType> weightMat(weight.memptr(), visibleSize,
+      poolSize * hiddenSize, false, true);
+  const arma::Mat<ElemType> sums = arma::reshape(arma::sum(arma::square(
+      input.t() * weightMat), 0), poolSize, hiddenSize);
+
   for (size_t i = 0; i < hiddenSize; i++)
   {
-    ElemType sum = arma::accu(arma::square(input.t() * weight.slice(i))) /
-        (2.0 * slabPenalty);
+    ElemType sum = arma::accu(sums.col(i)) / (2.0 * slabPenalty);
     freeEnergy -= SoftplusFunction::Fn(spikeBias(i) - sum);
   }
 
@@ -109,11 +114,12 @@ RBM<InitializationRuleType, DataType, PolicyType>::Phase(
   SampleSpike(std::move(spikeMean), std::move(spikeSamples));
   SlabMean(std::move(input), std::move(spikeSamples), std::move(slabMean));
 
-  for (size_t i = 0 ; i < hiddenSize; i++)
-  {
-    weightGrad.slice(i) = input * arma::repmat(slabMean.col(i).t(),
-        input.n_cols, 1) * spikeMean(i);
-  }
+  // The gradient of the weights of hidden unit i is the outer product of the
+  // sum of the inputs with the slab mean of unit i, times its spike mean.
+  arma::Mat<ElemType> weightGradMat(weightGrad.memptr(), visibleSize,
+      poolSize * hiddenSize, false, true);
+  weightGradMat = arma::sum(input, 1) *
+      arma::vectorise(slabMean.each_row() % spikeMean.t()).t();
 
   spikeBiasGrad = spikeMean;
 
@@ -163,10 +169,8 @@ RBM<InitializationRuleType, DataType, PolicyType>::SampleVisible(
 
   for (k = 0; k < numMaxTrials; k++)
   {
-    for (size_t i = 0; i < visibleSize; i++)
-    {
-      output(i) = math::RandNormal(visibleMean(i), 1.0 / visiblePenalty(0));
-    }
+    output.randn();
+    output = visibleMean + output / visiblePenalty(0);
     if (arma::norm(output, 2) < radius)
     {
       break;
@@ -193,17 +197,14 @@ RBM<InitializationRuleType, DataType, PolicyType>::VisibleMean(
     DataType&& input,
     DataType&& output)
 {
-  output.zeros(visibleSize, 1);
-
   DataType spike(input.memptr(), hiddenSize, 1, false, false);
   DataType slab(input.memptr() + hiddenSize, poolSize, hiddenSize, false,
       false);
 
-  for (size_t i = 0; i < hiddenSize; i++)
-  {
-    output += weight.slice(i) * slab.col(i) * spike(i);
-  }
-
+  // Sum the contributions of all the hidden units in one product.
+  const arma::Mat<ElemType> weightMat(weight.memptr(), visibleSize,
+      poolSize * hiddenSize, false, true);
+  output = weightMat * arma::vectorise(slab.each_row() % spike.t());
   output = ((1.0 / visiblePenalty(0)) * output);
 }
 
@@ -240,12 +241,17 @@ RBM<InitializationRuleType, DataType, PolicyType>::SpikeMean(
     DataType&& visible,
     DataType&& spikeMean)
 {
-  for (size_t i = 0; i < hiddenSize; i++)
-  {
-    spikeMean(i) = LogisticFunction::Fn(0.5 * (1.0 / slabPenalty) * arma::accu(
-        visible.t() * (weight.slice(i) * weight.slice(i).t()) * visible)
-        / std::pow(visible.n_cols, 2) + spikeBias(i));
-  }
+  // The sum of v_a^T W_i W_i^T v_b over all the pairs of samples is the
+  // squared norm of W_i^T times the sum of the samples, so the visible-sized
+  // matrices W_i W_i^T are never formed.
+  const arma::Mat<ElemType> weightMat(weight.memptr(), visibleSize,
+      poolSize * hiddenSize, false, true);
+  const arma::Mat<ElemType> projection = arma::reshape(weightMat.t() *
+      arma::sum(visible, 1), poolSize, hiddenSize);
+
+  spikeMean = 0.5 * (1.0 / slabPenalty) * arma::sum(arma::square(projection),
+      0).t() / std::pow(visible.n_cols, 2) + spikeBias;
+  LogisticFunction::Fn(spikeMean, spikeMean);
 }
 
 template<
@@ -259,10 +265,8 @@ RBM<InitializationRuleType, DataType, PolicyType>::SampleSpike(
     DataType&& spikeMean,
     DataType&& spike)
 {
-  for (size_t i = 0; i < hiddenSize; i++)
-  {
-    spike(i) = math::RandBernoulli(spikeMean(i));
-  }
+  spike = spikeMean;
+  SampleBernoulli(spike);
 }
 
 template<
@@ -277,11 +281,12 @@ RBM<InitializationRuleType, DataType, PolicyType>::SlabMean(
     DataType&& spike,
     DataType&& slabMean)
 {
-  for (size_t i = 0; i < hiddenSize; i++)
-  {
-    slabMean.col(i) = arma::mean((1.0 / slabPenalty) * spike(i) *
-        weight.slice(i).t() * visible, 1);
-  }
+  // The mean over the samples of W_i^T v is W_i^T times the mean sample.
+  const arma::Mat<ElemType> weightMat(weight.memptr(), visibleSize,
+      poolSize * hiddenSize, false, true);
+  slabMean = arma::reshape(weightMat.t() * arma::mean(visible, 1), poolSize,
+      hiddenSize);
+  slabMean.each_row() %= (1.0 / slabPenalty) * spike.t();
 }
 
 template<
@@ -295,13 +300,8 @@ RBM<InitializationRuleType, DataType, PolicyType>::SampleSlab(
     DataType&& slabMean,
     DataType&& slab)
 {
-  for (size_t i = 0; i < hiddenSize; i++)
-  {
-    for (size_t j = 0; j < poolSize; j++)
-    {
-      slab(j, i) = math::RandNormal(slabMean(j, i), 1.0 / slabPenalty);
-    }
-  }
+  randomTemporary.randn(poolSize, hiddenSize);
+  slab = slabMean + randomTemporary / slabPenalty;
 }
 
 } // namespace ann
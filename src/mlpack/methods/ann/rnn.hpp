@@ -13,13 +13,16 @@
 #define MLPACK_METHODS_ANN_RNN_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/random.hpp>
 
 #include "visitor/delete_visitor.hpp"
 #include "visitor/delta_visitor.hpp"
 #include "visitor/output_parameter_visitor.hpp"
 #include "visitor/reset_visitor.hpp"
+#include "visitor/step_visitor.hpp"
 
 #include "init_rules/network_init.hpp"
+#include "sparse_update/sparse_update_callback.hpp"
 
 #include <mlpack/methods/ann/layer/layer_types.hpp>
 #include <mlpack/methods/ann/layer/layer.hpp>
@@ -34,6 +37,8 @@ namespace ann /** Artificial Neural Network. */ {
 /**
  * Implementation of a standard recurrent neural network container.
  *
+ * Like FFN, the network and its parameters are double precision (arma::mat).
+ *
  * @tparam OutputLayerType The output layer type used to evaluate the network.
  * @tparam InitializationRuleType Rule used to initialize the weight matrix.
  */
@@ -126,6 +131,7 @@ class RNN
    * @param responses Outputs results from input training variables.
    * @param optimizer Instantiated optimizer used to train the model.
    * @param callbacks Callback function for ensmallen optimizer `OptimizerType`.
+   *     A SparseUpdateCallback is always added.
    *      See https://www.ensmallen.org/docs.html#callback-documentation.
    * @return The final objective of the trained model (NaN or Inf on error).
    */
@@ -159,6 +165,7 @@ class RNN
    * @param predictors Input training variables.
    * @param responses Outputs results from input training variables.
    * @param callbacks Callback function for ensmallen optimizer `OptimizerType`.
+   *     A SparseUpdateCallback is always added.
    *      See https://www.ensmallen.org/docs.html#callback-documentation.
    * @return The final objective of the trained model (NaN or Inf on error).
    */
@@ -296,11 +303,34 @@ class RNN
   //! Modify the matrix of responses to the input data points.
   arma::cube& Responses() { return responses; }
 
+  //! Get the output layer.
+  const OutputLayerType& OutputLayer() const { return outputLayer; }
+  //! Modify the output layer.
+  OutputLayerType& OutputLayer() { return outputLayer; }
+
   //! Get the matrix of data points (predictors).
   const arma::cube& Predictors() const { return predictors; }
   //! Modify the matrix of data points (predictors).
   arma::cube& Predictors() { return predictors; }
 
+  //! Get the number of layers in each segment for gradient checkpointing.
+  size_t CheckpointInterval() const { return checkpointInterval; }
+  /**
+   * Modify the number of layers in each segment for gradient checkpointing.
+   * If this is k > 0, the forward pass of training only keeps the outputs of
+   * every k-th layer, of the last layer and of the recurrent layers (and of
+   * the layers that hold recurrent layers) for each time step, and the
+   * backward pass computes the outputs of the other layers of each time step
+   * again from the kept ones.  So less memory is needed for long sequences,
+   * at the cost of a second forward pass through these layers.  0 (the
+   * default) keeps the outputs of all the layers.
+   *
+   * The numbers that the layers draw from math::randGen (like the masks of
+   * Dropout) are drawn again the same way, but the other side effects of the
+   * forward pass happen twice.
+   */
+  size_t& CheckpointInterval() { return checkpointInterval; }
+
   /**
    * Reset the state of the network.  This ensures that all internally-held
    * gradients are set to 0, all memory cells are reset, and the parameters
@@ -313,6 +343,15 @@ class RNN
    */
   void ResetParameters();
 
+  /**
+   * Update the weights that the layers and the output layer train themselves
+   * (like the table of SparseEmbedding) with the gradient they accumulated
+   * over the time steps since the last step, and discard that gradient.
+   * Train() does this after each step of the optimizer (see
+   * SparseUpdateCallback).
+   */
+  void Step();
+
   //! Serialize the model.
   template<typename Archive>
   void serialize(Archive& ar, const unsigned int /* version */);
@@ -357,6 +396,39 @@ class RNN
    */
   void ResetGradients(arma::mat& gradient);
 
+  /**
+   * Update the weights that the layers and the output layer train themselves
+   * with their accumulated gradient if apply is true, and otherwise discard
+   * that gradient.
+   */
+  void StepLayers(const bool apply);
+
+  //! Update the weights that the output layer trains itself, or discard their
+  //! gradient.
+  template<typename T = OutputLayerType>
+  typename std::enable_if<
+      HasStepCheck<T, void(T::*)()>::value, void>::type
+  StepOutputLayer(const bool apply);
+
+  //! Do nothing, since the output layer doesn't train weights itself.
+  template<typename T = OutputLayerType>
+  typename std::enable_if<
+      !HasStepCheck<T, void(T::*)()>::value, void>::type
+  StepOutputLayer(const bool apply);
+
+  //! Initialize the weights that the output layer trains itself with the
+  //! initialization rule of the network.
+  template<typename T = OutputLayerType>
+  typename std::enable_if<
+      HasStepCheck<T, void(T::*)()>::value, void>::type
+  InitializeOutputLayer();
+
+  //! Do nothing, since the output layer doesn't train weights itself.
+  template<typename T = OutputLayerType>
+  typename std::enable_if<
+      !HasStepCheck<T, void(T::*)()>::value, void>::type
+  InitializeOutputLayer();
+
   //! Number of steps to backpropagate through time (BPTT).
   size_t rho;
 
@@ -424,6 +496,17 @@ class RNN
   //! The current gradient for the gradient pass.
   arma::mat currentGradient;
 
+  //! The number of layers in each segment for gradient checkpointing.
+  size_t checkpointInterval;
+
+  //! Whether the output of each layer is computed again by the backward pass,
+  //! during training with gradient checkpointing.
+  std::vector<bool> recomputed;
+
+  //! The state of the random number generator at the start of each run of
+  //! recomputed layers of each time step, during the forward pass.
+  std::vector<std::mt19937> checkpointRandGen;
+
   // The BRN class should have access to internal members.
   template<
     typename OutputLayerType1,
@@ -449,7 +532,7 @@ template<typename OutputLayerType,
 struct version<
     mlpack::ann::RNN<OutputLayerType, InitializationRuleType, CustomLayer...>>
 {
-  BOOST_STATIC_CONSTANT(int, value = 1);
+  BOOST_STATIC_CONSTANT(int, value = 2);
 };
 
 } // namespace serialization
@@ -19,6 +19,7 @@
 #include "visitor/save_output_parameter_visitor.hpp"
 #include "visitor/forward_visitor.hpp"
 #include "visitor/backward_visitor.hpp"
+#include "visitor/recurrent_visitor.hpp"
 #include "visitor/reset_cell_visitor.hpp"
 #include "visitor/deterministic_set_visitor.hpp"
 #include "visitor/gradient_set_visitor.hpp"
@@ -46,7 +47,8 @@ RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::RNN(
     reset(false),
     single(single),
     numFunctions(0),
-    deterministic(true)
+    deterministic(true),
+    checkpointInterval(0)
 {
   /* Nothing to do here */
 }
@@ -121,7 +123,8 @@ double RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Train(
 
   // Train the model.
   Timer::Start("rnn_optimization");
-  const double out = optimizer.Optimize(*this, parameter, callbacks...);
+  const double out = optimizer.Optimize(*this, parameter,
+      SparseUpdateCallback(), callbacks...);
   Timer::Stop("rnn_optimization");
 
   Log::Info << "RNN::RNN(): final objective of trained model is " << out
@@ -167,7 +170,8 @@ double RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Train(
 
   // Train the model.
   Timer::Start("rnn_optimization");
-  const double out = optimizer.Optimize(*this, parameter, callbacks...);
+  const double out = optimizer.Optimize(*this, parameter,
+      SparseUpdateCallback(), callbacks...);
   Timer::Stop("rnn_optimization");
 
   Log::Info << "RNN::RNN(): final objective of trained model is " << out
@@ -302,6 +306,10 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
                      GradType& gradient,
                      const size_t batchSize)
 {
+  // Start a new sparse gradient for the layers that train weights themselves,
+  // so that evaluating the gradient again doesn't count it twice.
+  StepLayers(false);
+
   // Initialize passed gradient.
   if (gradient.is_empty())
   {
@@ -335,6 +343,23 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
 
   ResetCells();
 
+  // With gradient checkpointing, the outputs of the layers that are not kept
+  // are computed again for each time step of the backward pass, starting from
+  // the kept output before them; a run of such layers starts with the same
+  // random numbers both times.
+  size_t runs = 0;
+  if (checkpointInterval > 0)
+  {
+    recomputed.assign(network.size(), false);
+    for (size_t l = 0; l + 1 < network.size(); ++l)
+    {
+      recomputed[l] = ((l + 1) % checkpointInterval != 0) &&
+          !boost::apply_visitor(RecurrentVisitor(), network[l]);
+      if (recomputed[l] && (l == 0 || !recomputed[l - 1]))
+        ++runs;
+    }
+  }
+
   double performance = 0;
   size_t responseSeq = 0;
   const size_t effectiveRho = std::min(rho, size_t(responses.size()));
@@ -352,8 +377,11 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
 
     for (size_t l = 0; l < network.size(); ++l)
     {
-      boost::apply_visitor(SaveOutputParameterVisitor(moduleOutputParameter),
-          network[l]);
+      if (recomputed.empty() || !recomputed[l])
+      {
+        boost::apply_visitor(SaveOutputParameterVisitor(
+            moduleOutputParameter), network[l]);
+      }
     }
 
     performance += outputLayer.Forward(boost::apply_visitor(
@@ -379,11 +407,46 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
 
   for (size_t seqNum = 0; seqNum < effectiveRho; ++seqNum)
   {
+    const size_t step = effectiveRho - seqNum - 1;
+    arma::mat stepData(predictors.slice(step).colptr(begin),
+        predictors.n_rows, batchSize, false, true);
+
     currentGradient.zeros();
     for (size_t l = 0; l < network.size(); ++l)
     {
-      boost::apply_visitor(LoadOutputParameterVisitor(moduleOutputParameter),
-          network[network.size() - 1 - l]);
+      if (recomputed.empty() || !recomputed[network.size() - 1 - l])
+      {
+        boost::apply_visitor(LoadOutputParameterVisitor(
+            moduleOutputParameter), network[network.size() - 1 - l]);
+      }
+    }
+
+    if (!recomputed.empty())
+    {
+      const std::mt19937 randGen = math::randGen;
+      size_t run = step * runs;
+      for (size_t l = 0; l < network.size(); ++l)
+      {
+        if (!recomputed[l])
+          continue;
+
+        if (l == 0 || !recomputed[l - 1])
+          math::randGen = checkpointRandGen[run++];
+
+        arma::mat& output = boost::apply_visitor(outputParameterVisitor,
+            network[l]);
+        if (l == 0)
+        {
+          boost::apply_visitor(ForwardVisitor(stepData, output), network[l]);
+        }
+        else
+        {
+          boost::apply_visitor(ForwardVisitor(boost::apply_visitor(
+              outputParameterVisitor, network[l - 1]), output), network[l]);
+        }
+      }
+
+      math::randGen = randGen;
     }
 
     if (single && seqNum > 0)
@@ -406,12 +469,13 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
     }
 
     Backward();
-    Gradient(
-        arma::mat(predictors.slice(effectiveRho - seqNum - 1).colptr(begin),
-        predictors.n_rows, batchSize, false, true));
+    Gradient(stepData);
     gradient += currentGradient;
   }
 
+  recomputed.clear();
+  checkpointRandGen.clear();
+
   return performance;
 }
 
@@ -448,10 +512,76 @@ void RNN<OutputLayerType, InitializationRuleType,
   NetworkInitialization<InitializationRuleType,
                         CustomLayers...> networkInit(initializeRule);
   networkInit.Initialize(network, parameter);
+  InitializeOutputLayer();
 
   reset = true;
 }
 
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Step()
+{
+  StepLayers(true);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void RNN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::StepLayers(const bool apply)
+{
+  for (size_t i = 0; i < network.size(); ++i)
+    boost::apply_visitor(StepVisitor(apply), network[i]);
+
+  StepOutputLayer(apply);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+template<typename T>
+typename std::enable_if<
+    HasStepCheck<T, void(T::*)()>::value, void>::type
+RNN<OutputLayerType, InitializationRuleType,
+    CustomLayers...>::StepOutputLayer(const bool apply)
+{
+  if (apply)
+    outputLayer.Step();
+  else
+    outputLayer.ResetSparseGradient();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+template<typename T>
+typename std::enable_if<
+    !HasStepCheck<T, void(T::*)()>::value, void>::type
+RNN<OutputLayerType, InitializationRuleType,
+    CustomLayers...>::StepOutputLayer(const bool /* apply */)
+{
+  // Nothing to do here.
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+template<typename T>
+typename std::enable_if<
+    HasStepCheck<T, void(T::*)()>::value, void>::type
+RNN<OutputLayerType, InitializationRuleType,
+    CustomLayers...>::InitializeOutputLayer()
+{
+  outputLayer.InitializeWeights(initializeRule);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+template<typename T>
+typename std::enable_if<
+    !HasStepCheck<T, void(T::*)()>::value, void>::type
+RNN<OutputLayerType, InitializationRuleType,
+    CustomLayers...>::InitializeOutputLayer()
+{
+  // Nothing to do here.
+}
+
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 void RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Reset()
@@ -491,12 +621,22 @@ template<typename InputType>
 void RNN<OutputLayerType, InitializationRuleType,
          CustomLayers...>::Forward(const InputType& input)
 {
+  // With gradient checkpointing, remember the state of the random number
+  // generator at the start of each run of layers that the backward pass
+  // computes again.
+  const bool checkpoint = !deterministic && !recomputed.empty();
+  if (checkpoint && recomputed[0])
+    checkpointRandGen.push_back(math::randGen);
+
   boost::apply_visitor(ForwardVisitor(input,
       boost::apply_visitor(outputParameterVisitor, network.front())),
       network.front());
 
   for (size_t i = 1; i < network.size(); ++i)
   {
+    if (checkpoint && recomputed[i] && !recomputed[i - 1])
+      checkpointRandGen.push_back(math::randGen);
+
     boost::apply_visitor(ForwardVisitor(
         boost::apply_visitor(outputParameterVisitor, network[i - 1]),
         boost::apply_visitor(outputParameterVisitor, network[i])),
@@ -570,6 +710,11 @@ void RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::serialize(
 
   ar & BOOST_SERIALIZATION_NVP(network);
 
+  // Earlier versions of the RNN code did not serialize the output layer, which
+  // may have weights of its own.
+  if (version > 1)
+    ar & BOOST_SERIALIZATION_NVP(outputLayer);
+
   // If we are loading, we need to initialize the weights.
   if (Archive::is_loading::value)
   {
@@ -0,0 +1,107 @@
+/**
+ * @file methods/ann/sparse_update/lazy_adagrad_update.hpp
+ *
+ * Definition of the LazyAdaGradUpdate class, which applies an AdaGrad step to
+ * the columns of an embedding table that have a gradient.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_SPARSE_UPDATE_LAZY_ADAGRAD_UPDATE_HPP
+#define MLPACK_METHODS_ANN_SPARSE_UPDATE_LAZY_ADAGRAD_UPDATE_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace ann {
+
+/**
+ * AdaGrad for sparse gradients: the sum of the squared gradients is kept for
+ * every element of the embedding, but only the given columns of the embedding
+ * and of the sum are updated at each step.  Since a column without a gradient
+ * adds nothing to the sum, this is the same as AdaGrad on the dense gradient.
+ *
+ * @code
+ * squaredGradient.cols(indices) += gradient % gradient
+ * embedding.cols(indices) -= stepSize * gradient /
+ *     (sqrt(squaredGradient.cols(indices)) + epsilon)
+ * @endcode
+ */
+class LazyAdaGradUpdate
+{
+ public:
+  /**
+   * Create the update rule.
+   *
+   * @param stepSize Step size of each update.
+   * @param epsilon Value used to initialise the squared gradient parameter.
+   */
+  LazyAdaGradUpdate(const double stepSize = 0.01,
+                    const double epsilon = 1e-8) :
+      stepSize(stepSize),
+      epsilon(epsilon)
+  {
+    // Nothing to do here.
+  }
+
+  /**
+   * Update the given columns of the embedding.
+   *
+   * @tparam MatType Type of the embedding.
+   * @param embedding The embedding to update.
+   * @param indices The (distinct) columns of the embedding that have a
+   *     gradient.
+   * @param gradient The gradient of each of those columns, in the same order.
+   */
+  template<typename MatType>
+  void Update(MatType& embedding,
+              const arma::uvec& indices,
+              const MatType& gradient)
+  {
+    if (squaredGradient.n_rows != embedding.n_rows ||
+        squaredGradient.n_cols != embedding.n_cols)
+      squaredGradient.zeros(embedding.n_rows, embedding.n_cols);
+
+    squaredGradient.cols(indices) += arma::square(gradient);
+    embedding.cols(indices) -= stepSize * gradient /
+        (arma::sqrt(squaredGradient.cols(indices)) + epsilon);
+  }
+
+  //! Get the step size.
+  double StepSize() const { return stepSize; }
+  //! Modify the step size.
+  double& StepSize() { return stepSize; }
+
+  //! Get the value used to initialise the squared gradient parameter.
+  double Epsilon() const { return epsilon; }
+  //! Modify the value used to initialise the squared gradient parameter.
+  double& Epsilon() { return epsilon; }
+
+  /**
+   * Serialize the update rule.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(stepSize);
+    ar & BOOST_SERIALIZATION_NVP(epsilon);
+    ar & BOOST_SERIALIZATION_NVP(squaredGradient);
+  }
+
+ private:
+  //! Locally-stored step size.
+  double stepSize;
+
+  //! Locally-stored epsilon.
+  double epsilon;
+
+  //! Locally-stored sum of the squared gradients.
+  arma::mat squaredGradient;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,155 @@
+/**
+ * @file methods/ann/sparse_update/lazy_adam_update.hpp
+ *
+ * Definition of the LazyAdamUpdate class, which applies an Adam step to the
+ * columns of an embedding table that have a gradient.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_SPARSE_UPDATE_LAZY_ADAM_UPDATE_HPP
+#define MLPACK_METHODS_ANN_SPARSE_UPDATE_LAZY_ADAM_UPDATE_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace ann {
+
+/**
+ * Lazy Adam for sparse gradients: the moment estimates of a column of the
+ * embedding are only updated (and so only decay) at the steps where the column
+ * has a gradient, and only those columns of the embedding are updated.  The
+ * bias correction uses the number of steps taken so far.  Unlike AdaGrad this
+ * differs from Adam on the dense gradient, where the moments of every column
+ * decay at every step; it is the usual way to train large embeddings with Adam.
+ *
+ * @code
+ * m.cols(indices) = beta1 * m.cols(indices) + (1 - beta1) * gradient
+ * v.cols(indices) = beta2 * v.cols(indices) + (1 - beta2) * gradient^2
+ * embedding.cols(indices) -= stepSize * sqrt(1 - beta2^t) / (1 - beta1^t) *
+ *     m.cols(indices) / (sqrt(v.cols(indices)) + epsilon)
+ * @endcode
+ */
+class LazyAdamUpdate
+{
+ public:
+  /**
+   * Create the update rule.
+   *
+   * @param stepSize Step size of each update.
+   * @param beta1 Exponential decay rate for the first moment estimates.
+   * @param beta2 Exponential decay rate for the weighted infinity norm
+   *     estimates.
+   * @param epsilon Value used to initialise the mean squared gradient
+   *     parameter.
+   */
+  LazyAdamUpdate(const double stepSize = 0.001,
+                 const double beta1 = 0.9,
+                 const double beta2 = 0.999,
+                 const double epsilon = 1e-8) :
+      stepSize(stepSize),
+      beta1(beta1),
+      beta2(beta2),
+      epsilon(epsilon),
+      iteration(0)
+  {
+    // Nothing to do here.
+  }
+
+  /**
+   * Update the given columns of the embedding.
+   *
+   * @tparam MatType Type of the embedding.
+   * @param embedding The embedding to update.
+   * @param indices The (distinct) columns of the embedding that have a
+   *     gradient.
+   * @param gradient The gradient of each of those columns, in the same order.
+   */
+  template<typename MatType>
+  void Update(MatType& embedding,
+              const arma::uvec& indices,
+              const MatType& gradient)
+  {
+    if (m.n_rows != embedding.n_rows || m.n_cols != embedding.n_cols)
+    {
+      m.zeros(embedding.n_rows, embedding.n_cols);
+      v.zeros(embedding.n_rows, embedding.n_cols);
+      iteration = 0;
+    }
+
+    ++iteration;
+    m.cols(indices) = beta1 * m.cols(indices) + (1 - beta1) * gradient;
+    v.cols(indices) = beta2 * v.cols(indices) + (1 - beta2) *
+        arma::square(gradient);
+
+    const double biasCorrection1 = 1.0 - std::pow(beta1, iteration);
+    const double biasCorrection2 = 1.0 - std::pow(beta2, iteration);
+    embedding.cols(indices) -= (stepSize * std::sqrt(biasCorrection2) /
+        biasCorrection1) * m.cols(indices) /
+        (arma::sqrt(v.cols(indices)) + epsilon);
+  }
+
+  //! Get the step size.
+  double StepSize() const { return stepSize; }
+  //! Modify the step size.
+  double& StepSize() { return stepSize; }
+
+  //! Get the decay rate of the first moment estimates.
+  double Beta1() const { return beta1; }
+  //! Modify the decay rate of the first moment estimates.
+  double& Beta1() { return beta1; }
+
+  //! Get the decay rate of the second moment estimates.
+  double Beta2() const { return beta2; }
+  //! Modify the decay rate of the second moment estimates.
+  double& Beta2() { return beta2; }
+
+  //! Get the value used to initialise the mean squared gradient parameter.
+  double Epsilon() const { return epsilon; }
+  //! Modify the value used to initialise the mean squared gradient parameter.
+  double& Epsilon() { return epsilon; }
+
+  /**
+   * Serialize the update rule.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(stepSize);
+    ar & BOOST_SERIALIZATION_NVP(beta1);
+    ar & BOOST_SERIALIZATION_NVP(beta2);
+    ar & BOOST_SERIALIZATION_NVP(epsilon);
+    ar & BOOST_SERIALIZATION_NVP(iteration);
+    ar & BOOST_SERIALIZATION_NVP(m);
+    ar & BOOST_SERIALIZATION_NVP(v);
+  }
+
+ private:
+  //! Locally-stored step size.
+  double stepSize;
+
+  //! Locally-stored decay rate of the first moment estimates.
+  double beta1;
+
+  //! Locally-stored decay rate of the second moment estimates.
+  double beta2;
+
+  //! Locally-stored epsilon.
+  double epsilon;
+
+  //! Locally-stored number of steps taken.
+  size_t iteration;
+
+  //! Locally-stored first moment estimates.
+  arma::mat m;
+
+  //! Locally-stored second moment estimates.
+  arma::mat v;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,81 @@
+/**
+ * @file methods/ann/sparse_update/lazy_sgd_update.hpp
+ *
+ * Definition of the LazySGDUpdate class, which applies a stochastic gradient
+ * descent step to the columns of an embedding table that have a gradient.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_SPARSE_UPDATE_LAZY_SGD_UPDATE_HPP
+#define MLPACK_METHODS_ANN_SPARSE_UPDATE_LAZY_SGD_UPDATE_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace ann {
+
+/**
+ * Stochastic gradient descent for sparse gradients: only the given columns of
+ * the embedding are updated, so the cost of a step depends on the number of
+ * columns in the batch and not on the size of the embedding.
+ *
+ * @code
+ * embedding.cols(indices) -= stepSize * gradient
+ * @endcode
+ */
+class LazySGDUpdate
+{
+ public:
+  /**
+   * Create the update rule.
+   *
+   * @param stepSize Step size of each update.
+   */
+  LazySGDUpdate(const double stepSize = 0.01) : stepSize(stepSize)
+  {
+    // Nothing to do here.
+  }
+
+  /**
+   * Update the given columns of the embedding.
+   *
+   * @tparam MatType Type of the embedding.
+   * @param embedding The embedding to update.
+   * @param indices The (distinct) columns of the embedding that have a
+   *     gradient.
+   * @param gradient The gradient of each of those columns, in the same order.
+   */
+  template<typename MatType>
+  void Update(MatType& embedding,
+              const arma::uvec& indices,
+              const MatType& gradient)
+  {
+    embedding.cols(indices) -= stepSize * gradient;
+  }
+
+  //! Get the step size.
+  double StepSize() const { return stepSize; }
+  //! Modify the step size.
+  double& StepSize() { return stepSize; }
+
+  /**
+   * Serialize the update rule.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(stepSize);
+  }
+
+ private:
+  //! Locally-stored step size.
+  double stepSize;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
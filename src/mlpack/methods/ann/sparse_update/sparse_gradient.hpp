@@ -0,0 +1,91 @@
+/**
+ * @file methods/ann/sparse_update/sparse_gradient.hpp
+ *
+ * Definition of SumSparseGradient(), which combines the gradients of repeated
+ * columns of a row-sparse gradient, before it is given to a lazy update rule,
+ * and of AccumulateSparseGradient(), which adds up row-sparse gradients.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_SPARSE_UPDATE_SPARSE_GRADIENT_HPP
+#define MLPACK_METHODS_ANN_SPARSE_UPDATE_SPARSE_GRADIENT_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace ann {
+
+/**
+ * Sum the gradients of the columns with the same index, so that each column
+ * appears once, as the update rules (LazySGDUpdate, LazyAdaGradUpdate,
+ * LazyAdamUpdate) expect.  The distinct indices are given in increasing order.
+ *
+ * @param indices The column of each gradient (possibly repeated).
+ * @param gradient The gradients, one column per index.
+ * @param sparseIndices The distinct indices.
+ * @param sparseGradient The summed gradient of each distinct index.
+ */
+template<typename MatType, typename OutputMatType>
+void SumSparseGradient(const arma::uvec& indices,
+                       const MatType& gradient,
+                       arma::uvec& sparseIndices,
+                       OutputMatType& sparseGradient)
+{
+  // Visit the gradients in the order of their indices.
+  const arma::uvec order = arma::sort_index(indices);
+
+  sparseIndices.set_size(indices.n_elem);
+  sparseGradient.set_size(gradient.n_rows, indices.n_elem);
+  size_t distinct = 0;
+  for (size_t i = 0; i < order.n_elem; ++i)
+  {
+    if (i > 0 && indices[order[i]] == sparseIndices[distinct - 1])
+    {
+      sparseGradient.col(distinct - 1) += gradient.col(order[i]);
+    }
+    else
+    {
+      sparseIndices[distinct] = indices[order[i]];
+      sparseGradient.col(distinct) = gradient.col(order[i]);
+      ++distinct;
+    }
+  }
+
+  sparseIndices.resize(distinct);
+  sparseGradient.resize(gradient.n_rows, distinct);
+}
+
+/**
+ * Add a row-sparse gradient to the gradient accumulated so far, which is also
+ * row-sparse, with distinct indices in increasing order.
+ *
+ * @param indices The column of each gradient to add (possibly repeated).
+ * @param gradient The gradients to add, one column per index.
+ * @param sparseIndices The distinct indices of the accumulated gradient.
+ * @param sparseGradient The accumulated gradient of each distinct index.
+ */
+template<typename MatType, typename OutputMatType>
+void AccumulateSparseGradient(const arma::uvec& indices,
+                              const MatType& gradient,
+                              arma::uvec& sparseIndices,
+                              OutputMatType& sparseGradient)
+{
+  if (sparseIndices.is_empty())
+  {
+    SumSparseGradient(indices, gradient, sparseIndices, sparseGradient);
+    return;
+  }
+
+  const arma::uvec allIndices = arma::join_cols(sparseIndices, indices);
+  const OutputMatType allGradients = arma::join_rows(sparseGradient,
+      OutputMatType(gradient));
+  SumSparseGradient(allIndices, allGradients, sparseIndices, sparseGradient);
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
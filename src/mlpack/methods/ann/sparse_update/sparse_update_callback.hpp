@@ -0,0 +1,58 @@
+/**
+ * @file methods/ann/sparse_update/sparse_update_callback.hpp
+ *
+ * Definition of the SparseUpdateCallback class, an ensmallen callback that
+ * updates the weights that the layers of a network train themselves after
+ * each step of the optimizer.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_SPARSE_UPDATE_SPARSE_UPDATE_CALLBACK_HPP
+#define MLPACK_METHODS_ANN_SPARSE_UPDATE_SPARSE_UPDATE_CALLBACK_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace ann {
+
+/**
+ * Some layers (SparseEmbedding, SampledSoftmax, HierarchicalSoftmax) train
+ * their weights themselves, with a lazy update rule, since only a few columns
+ * of these weights have a gradient at each step.  Computing the gradient
+ * doesn't change these weights; the network applies the accumulated gradient
+ * in its Step() function, which this callback calls after each step of the
+ * optimizer.  FFN::Train() and RNN::Train() add it to the callbacks they are
+ * given, so it is only needed when an optimizer is run on the network
+ * directly:
+ *
+ * @code
+ * ens::Adam optimizer;
+ * optimizer.Optimize(model, model.Parameters(), SparseUpdateCallback());
+ * @endcode
+ */
+class SparseUpdateCallback
+{
+ public:
+  /**
+   * Update the weights that the layers of the network train themselves.
+   *
+   * @param optimizer The optimizer used to update the function.
+   * @param function The network being optimized.
+   * @param coordinates The current parameters of the network.
+   */
+  template<typename OptimizerType, typename FunctionType, typename MatType>
+  void StepTaken(OptimizerType& /* optimizer */,
+                 FunctionType& function,
+                 MatType& /* coordinates */)
+  {
+    function.Step();
+  }
+};
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,528 @@
+/**
+ * @file methods/ann/static_ffn.hpp
+ *
+ * Definition of the StaticFFN class, a feed forward neural network whose layers
+ * are fixed at compile time.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_STATIC_FFN_HPP
+#define MLPACK_METHODS_ANN_STATIC_FFN_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <mlpack/methods/ann/layer/layer.hpp>
+#include <mlpack/methods/ann/init_rules/random_init.hpp>
+#include <mlpack/methods/ann/init_rules/network_init.hpp>
+#include <mlpack/methods/ann/layer/layer_traits.hpp>
+#include <ensmallen.hpp>
+
+#include <tuple>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * Whether the activation layer NextLayerType can be applied in place to the
+ * output of the layer LayerType.  This is the case for a BaseLayer that follows
+ * a Linear or LinearNoBias layer: the backward pass of those layers does not
+ * use their own output, and the derivatives of the activation functions are
+ * computed from the activated values anyway.
+ */
+template<typename LayerType, typename NextLayerType>
+struct FusedActivation
+{
+  static const bool value = false;
+};
+
+template<typename InputDataType, typename OutputDataType,
+         typename RegularizerType, typename ActivationFunction>
+struct FusedActivation<Linear<InputDataType, OutputDataType, RegularizerType>,
+    BaseLayer<ActivationFunction, InputDataType, OutputDataType>>
+{
+  static const bool value = true;
+
+  //! The activation function to apply in place.
+  typedef ActivationFunction ActivationType;
+};
+
+template<typename InputDataType, typename OutputDataType,
+         typename RegularizerType, typename ActivationFunction>
+struct FusedActivation<
+    LinearNoBias<InputDataType, OutputDataType, RegularizerType>,
+    BaseLayer<ActivationFunction, InputDataType, OutputDataType>>
+{
+  static const bool value = true;
+
+  //! The activation function to apply in place.
+  typedef ActivationFunction ActivationType;
+};
+
+/**
+ * Whether the layer with index I of the given std::tuple of layers is applied
+ * in place to the output of the previous layer.
+ */
+template<typename NetworkType, size_t I>
+struct IsFusedLayer
+{
+  static const bool value = FusedActivation<
+      typename std::tuple_element<I - 1, NetworkType>::type,
+      typename std::tuple_element<I, NetworkType>::type>::value;
+};
+
+template<typename NetworkType>
+struct IsFusedLayer<NetworkType, 0>
+{
+  static const bool value = false;
+};
+
+/**
+ * Implementation of a feed forward network whose layers are given as template
+ * parameters instead of being added at runtime.  The layers are held in a
+ * std::tuple, and every call to a layer is resolved at compile time, so there
+ * is no variant dispatch at all and the compiler can inline the layers into
+ * each other.  An activation layer (BaseLayer) that directly follows a Linear
+ * or LinearNoBias layer is applied in place to the output of that layer.
+ *
+ * This is useful for small networks, where the cost of the dispatch in FFN is
+ * comparable to the cost of the layers themselves.  The network can be
+ * trained with any ensmallen optimizer, exactly like FFN.
+ *
+ * @code
+ * StaticFFN<MeanSquaredError<>, RandomInitialization,
+ *     Linear<>, ReLULayer<>, Linear<>> model(
+ *     Linear<>(10, 32), ReLULayer<>(), Linear<>(32, 1));
+ * model.Train(predictors, responses, optimizer);
+ * @endcode
+ *
+ * @tparam OutputLayerType The output layer type used to evaluate the network.
+ * @tparam InitializationRuleType Rule used to initialize the weight matrix.
+ * @tparam LayerTypes The types of the layers of the network, in order.
+ */
+template<
+  typename OutputLayerType,
+  typename InitializationRuleType,
+  typename... LayerTypes
+>
+class StaticFFN
+{
+ public:
+  //! The type of the tuple that holds the layers.
+  typedef std::tuple<LayerTypes...> NetworkType;
+
+  //! The number of layers.
+  static const size_t NumLayers = sizeof...(LayerTypes);
+
+  static_assert(NumLayers > 0, "StaticFFN needs at least one layer.");
+
+  /**
+   * Create the StaticFFN object from the given layers, using a default
+   * constructed output layer and initialization rule.
+   *
+   * @param layers The layers of the network.
+   */
+  explicit StaticFFN(LayerTypes... layers);
+
+  /**
+   * Create the StaticFFN object from the given layers, output layer and
+   * initialization rule.
+   *
+   * @param network The layers of the network.
+   * @param outputLayer Output layer used to evaluate the network.
+   * @param initializeRule Instantiated InitializationRule object for
+   *        initializing the network parameter.
+   */
+  StaticFFN(NetworkType network,
+            OutputLayerType outputLayer,
+            InitializationRuleType initializeRule = InitializationRuleType());
+
+  //! Copy constructor.
+  StaticFFN(const StaticFFN&);
+
+  //! Move constructor.
+  StaticFFN(StaticFFN&&);
+
+  //! Copy assignment operator.
+  StaticFFN& operator=(const StaticFFN&);
+
+  //! Move assignment operator.
+  StaticFFN& operator=(StaticFFN&&);
+
+  /**
+   * Train the network on the given input data using the given optimizer.
+   *
+   * This will use the existing model parameters as a starting point for the
+   * optimization. If this is not what you want, then you should access the
+   * parameters vector directly with Parameters() and modify it as desired.
+   *
+   * @tparam OptimizerType Type of optimizer to use to train the model.
+   * @tparam CallbackTypes Types of Callback Functions.
+   * @param predictors Input training variables.
+   * @param responses Outputs results from input training variables.
+   * @param optimizer Instantiated optimizer used to train the model.
+   * @param callbacks Callback function for ensmallen optimizer `OptimizerType`.
+   *      See https://www.ensmallen.org/docs.html#callback-documentation.
+   * @return The final objective of the trained model (NaN or Inf on error).
+   */
+  template<typename OptimizerType, typename... CallbackTypes>
+  double Train(arma::mat predictors,
+               arma::mat responses,
+               OptimizerType& optimizer,
+               CallbackTypes&&... callbacks);
+
+  /**
+   * Train the network on the given input data.  By default, the RMSProp
+   * optimization algorithm is used, but others can be specified (such as
+   * ens::SGD).
+   *
+   * @tparam OptimizerType Type of optimizer to use to train the model.
+   * @tparam CallbackTypes Types of Callback Functions.
+   * @param predictors Input training variables.
+   * @param responses Outputs results from input training variables.
+   * @param callbacks Callback function for ensmallen optimizer `OptimizerType`.
+   *      See https://www.ensmallen.org/docs.html#callback-documentation.
+   * @return The final objective of the trained model (NaN or Inf on error).
+   */
+  template<typename OptimizerType = ens::RMSProp, typename... CallbackTypes>
+  double Train(arma::mat predictors,
+               arma::mat responses,
+               CallbackTypes&&... callbacks);
+
+  /**
+   * Predict the responses to a given set of predictors.  The predictors are
+   * passed through the network in batches of the given size.
+   *
+   * @param predictors Input predictors.
+   * @param results Matrix to put output predictions of responses into.
+   * @param batchSize Number of points to pass through the network at once.
+   */
+  void Predict(const arma::mat& predictors,
+               arma::mat& results,
+               const size_t batchSize = 128);
+
+  /**
+   * Evaluate the network with the given predictors and responses.
+   *
+   * @param predictors Input variables.
+   * @param responses Target outputs for input variables.
+   */
+  double Evaluate(const arma::mat& predictors, const arma::mat& responses);
+
+  /**
+   * Evaluate the network with the given parameters.  This function is usually
+   * called by the optimizer to train the model.
+   *
+   * @param parameters Matrix model parameters.
+   */
+  double Evaluate(const arma::mat& parameters);
+
+  /**
+   * Evaluate the network with the given parameters, but using only a number
+   * of data points.
+   *
+   * @param parameters Matrix model parameters.
+   * @param begin Index of the starting point to use for objective function
+   *        evaluation.
+   * @param batchSize Number of points to be passed at a time to use for
+   *        objective function evaluation.
+   * @param deterministic Whether or not to train or test the model. Note some
+   *        layer act differently in training or testing mode.
+   */
+  double Evaluate(const arma::mat& parameters,
+                  const size_t begin,
+                  const size_t batchSize,
+                  const bool deterministic);
+
+  /**
+   * Evaluate the network with the given parameters, but using only a number
+   * of data points.  This just calls the overload of Evaluate() with
+   * deterministic = true.
+   *
+   * @param parameters Matrix model parameters.
+   * @param begin Index of the starting point to use for objective function
+   *        evaluation.
+   * @param batchSize Number of points to be passed at a time to use for
+   *        objective function evaluation.
+   */
+  double Evaluate(const arma::mat& parameters,
+                  const size_t begin,
+                  const size_t batchSize);
+
+  /**
+   * Evaluate the network and its gradient with the given parameters.  This
+   * just calls the other overload of EvaluateWithGradient() for each point.
+   *
+   * @param parameters Matrix model parameters.
+   * @param gradient Matrix to output gradient into.
+   */
+  double EvaluateWithGradient(const arma::mat& parameters,
+                              arma::mat& gradient);
+
+  /**
+   * Evaluate the network and its gradient with the given parameters, but
+   * using only a number of data points.
+   *
+   * @param parameters Matrix model parameters.
+   * @param begin Index of the starting point to use for objective function
+   *        evaluation.
+   * @param gradient Matrix to output gradient into.
+   * @param batchSize Number of points to be passed at a time to use for
+   *        objective function evaluation.
+   */
+  double EvaluateWithGradient(const arma::mat& parameters,
+                              const size_t begin,
+                              arma::mat& gradient,
+                              const size_t batchSize);
+
+  /**
+   * Evaluate the gradient of the network with the given parameters, and with
+   * respect to only a number of points in the dataset.
+   *
+   * @param parameters Matrix of the model parameters to be optimized.
+   * @param begin Index of the starting point to use for objective function
+   *        gradient evaluation.
+   * @param gradient Matrix to output gradient into.
+   * @param batchSize Number of points to be processed as a batch for objective
+   *        function gradient evaluation.
+   */
+  void Gradient(const arma::mat& parameters,
+                const size_t begin,
+                arma::mat& gradient,
+                const size_t batchSize);
+
+  /**
+   * Shuffle the order of function visitation. This may be called by the
+   * optimizer.
+   */
+  void Shuffle();
+
+  //! Get the layers of the network.
+  const NetworkType& Model() const { return network; }
+  //! Modify the layers of the network.  Be careful!  If you change the
+  //! parameters of the layers, be sure to call ResetParameters() afterwards.
+  NetworkType& Model() { return network; }
+
+  //! Return the number of separable functions (the number of predictor points).
+  size_t NumFunctions() const { return numFunctions; }
+
+  //! Return the initial point for the optimization.
+  const arma::mat& Parameters() const { return parameter; }
+  //! Modify the initial point for the optimization.
+  arma::mat& Parameters() { return parameter; }
+
+  //! Get the matrix of responses to the input data points.
+  const arma::mat& Responses() const { return responses; }
+  //! Modify the matrix of responses to the input data points.
+  arma::mat& Responses() { return responses; }
+
+  //! Get the matrix of data points (predictors).
+  const arma::mat& Predictors() const { return predictors; }
+  //! Modify the matrix of data points (predictors).
+  arma::mat& Predictors() { return predictors; }
+
+  /**
+   * Reset the module information (weights/parameters).
+   */
+  void ResetParameters();
+
+  //! Serialize the model.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+  /**
+   * Perform the forward pass of the given data.
+   *
+   * @param inputs The input data.
+   * @param results The predicted results.
+   */
+  void Forward(const arma::mat& inputs, arma::mat& results);
+
+ private:
+  /**
+   * Prepare the network for the given input data.
+   *
+   * @param predictors Input data variables.
+   * @param responses Outputs results from input data variables.
+   */
+  void ResetData(arma::mat predictors, arma::mat responses);
+
+  //! Pass the deterministic flag to all layers.
+  void ResetDeterministic();
+
+  //! Make the weights of all layers aliases of the parameter matrix.
+  void ResetWeights();
+
+  //! Make the gradients of all layers aliases of the given gradient matrix.
+  void ResetGradients(arma::mat& gradient);
+
+  //! The forward pass through all layers.
+  void Forward(const arma::mat& input);
+
+  //! The backward pass through all layers.
+  void Backward();
+
+  //! Compute the gradients of all layers.
+  void Gradient(const arma::mat& input);
+
+  //! Run the forward pass of layer I and all the following ones.
+  template<size_t I>
+  typename std::enable_if<(I < sizeof...(LayerTypes)), void>::type
+  ForwardLayers(const arma::mat& input);
+
+  template<size_t I>
+  typename std::enable_if<(I == sizeof...(LayerTypes)), void>::type
+  ForwardLayers(const arma::mat& /* input */) { }
+
+  //! Run the forward pass of a layer that is not fused.
+  template<size_t I>
+  typename std::enable_if<!IsFusedLayer<std::tuple<LayerTypes...>,
+      I>::value, void>::type
+  LayerForward(const arma::mat& input);
+
+  //! Apply a fused activation layer in place to the previous output.
+  template<size_t I>
+  typename std::enable_if<IsFusedLayer<std::tuple<LayerTypes...>,
+      I>::value, void>::type
+  LayerForward(const arma::mat& input);
+
+  //! Run the backward pass of layer I and all the previous ones, except the
+  //! first layer, whose delta is never needed.
+  template<size_t I>
+  typename std::enable_if<(I > 0), void>::type BackwardLayers();
+
+  template<size_t I>
+  typename std::enable_if<(I == 0), void>::type BackwardLayers() { }
+
+  //! Compute the gradient of layer I and all the following ones.
+  template<size_t I>
+  typename std::enable_if<(I < sizeof...(LayerTypes)), void>::type
+  GradientLayers(const arma::mat& input);
+
+  template<size_t I>
+  typename std::enable_if<(I == sizeof...(LayerTypes)), void>::type
+  GradientLayers(const arma::mat& /* input */) { }
+
+  //! Get the error that is backpropagated into layer I.
+  template<size_t I>
+  typename std::enable_if<(I + 1 < sizeof...(LayerTypes)),
+      const arma::mat&>::type
+  LayerError() const { return std::get<I + 1>(network).Delta(); }
+
+  template<size_t I>
+  typename std::enable_if<(I + 1 == sizeof...(LayerTypes)),
+      const arma::mat&>::type
+  LayerError() const { return error; }
+
+  //! Get the number of weights of layer I and all the following ones.
+  template<size_t I>
+  typename std::enable_if<(I < sizeof...(LayerTypes)), size_t>::type
+  WeightSize();
+
+  template<size_t I>
+  typename std::enable_if<(I == sizeof...(LayerTypes)), size_t>::type
+  WeightSize()
+  {
+    return 0;
+  }
+
+  //! Initialize the weights of layer I and all the following ones separately.
+  template<size_t I>
+  typename std::enable_if<(I < sizeof...(LayerTypes)), void>::type
+  InitializeLayers(const size_t offset);
+
+  template<size_t I>
+  typename std::enable_if<(I == sizeof...(LayerTypes)), void>::type
+  InitializeLayers(const size_t /* offset */) { }
+
+  //! Set the weights of layer I and all the following ones.
+  template<size_t I>
+  typename std::enable_if<(I < sizeof...(LayerTypes)), void>::type
+  ResetWeights(const size_t offset);
+
+  template<size_t I>
+  typename std::enable_if<(I == sizeof...(LayerTypes)), void>::type
+  ResetWeights(const size_t /* offset */) { }
+
+  //! Set the gradients of layer I and all the following ones.
+  template<size_t I>
+  typename std::enable_if<(I < sizeof...(LayerTypes)), void>::type
+  ResetGradients(arma::mat& gradient, const size_t offset);
+
+  template<size_t I>
+  typename std::enable_if<(I == sizeof...(LayerTypes)), void>::type
+  ResetGradients(arma::mat& /* gradient */, const size_t /* offset */) { }
+
+  //! Call the given visitor on layer I and all the following ones.
+  template<size_t I, typename VisitorType>
+  typename std::enable_if<(I < sizeof...(LayerTypes)), void>::type
+  VisitLayers(const VisitorType& visitor);
+
+  template<size_t I, typename VisitorType>
+  typename std::enable_if<(I == sizeof...(LayerTypes)), void>::type
+  VisitLayers(const VisitorType& /* visitor */) { }
+
+  //! Sum the losses of layer I and all the following ones.
+  template<size_t I>
+  typename std::enable_if<(I < sizeof...(LayerTypes)), double>::type Loss();
+
+  template<size_t I>
+  typename std::enable_if<(I == sizeof...(LayerTypes)), double>::type
+  Loss() { return 0; }
+
+  //! Serialize layer I and all the following ones.
+  template<size_t I, typename Archive>
+  typename std::enable_if<(I < sizeof...(LayerTypes)), void>::type
+  SerializeLayers(Archive& ar);
+
+  template<size_t I, typename Archive>
+  typename std::enable_if<(I == sizeof...(LayerTypes)), void>::type
+  SerializeLayers(Archive& /* ar */) { }
+
+  //! Instantiated output layer used to evaluate the network.
+  OutputLayerType outputLayer;
+
+  //! Instantiated InitializationRule object for initializing the network
+  //! parameter.
+  InitializationRuleType initializeRule;
+
+  //! The layers of the network.
+  NetworkType network;
+
+  //! The input width.
+  size_t width;
+
+  //! The input height.
+  size_t height;
+
+  //! Indicator if we already trained the model.
+  bool reset;
+
+  //! The matrix of data points (predictors).
+  arma::mat predictors;
+
+  //! The matrix of responses to the input data points.
+  arma::mat responses;
+
+  //! Matrix of (trained) parameters.
+  arma::mat parameter;
+
+  //! The number of separable functions (the number of predictor points).
+  size_t numFunctions;
+
+  //! The current error for the backward pass.
+  arma::mat error;
+
+  //! The current evaluation mode (training or testing).
+  bool deterministic;
+}; // class StaticFFN
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "static_ffn_impl.hpp"
+
+#endif
@@ -0,0 +1,676 @@
+/**
+ * @file methods/ann/static_ffn_impl.hpp
+ *
+ * Implementation of the StaticFFN class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_STATIC_FFN_IMPL_HPP
+#define MLPACK_METHODS_ANN_STATIC_FFN_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "static_ffn.hpp"
+
+#include <mlpack/core/math/make_alias.hpp>
+
+#include "visitor/backward_visitor.hpp"
+#include "visitor/deterministic_set_visitor.hpp"
+#include "visitor/gradient_set_visitor.hpp"
+#include "visitor/gradient_visitor.hpp"
+#include "visitor/loss_visitor.hpp"
+#include "visitor/output_height_visitor.hpp"
+#include "visitor/output_width_visitor.hpp"
+#include "visitor/reset_visitor.hpp"
+#include "visitor/set_input_height_visitor.hpp"
+#include "visitor/set_input_width_visitor.hpp"
+#include "visitor/weight_set_visitor.hpp"
+#include "visitor/weight_size_visitor.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... LayerTypes>
+StaticFFN<OutputLayerType, InitializationRuleType, LayerTypes...>::StaticFFN(
+    LayerTypes... layers) :
+    network(std::move(layers)...),
+    width(0),
+    height(0),
+    reset(false),
+    numFunctions(0),
+    deterministic(true)
+{
+  /* Nothing to do here. */
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... LayerTypes>
+StaticFFN<OutputLayerType, InitializationRuleType, LayerTypes...>::StaticFFN(
+    NetworkType network,
+    OutputLayerType outputLayer,
+    InitializationRuleType initializeRule) :
+    outputLayer(std::move(outputLayer)),
+    initializeRule(std::move(initializeRule)),
+    network(std::move(network)),
+    width(0),
+    height(0),
+    reset(false),
+    numFunctions(0),
+    deterministic(true)
+{
+  /* Nothing to do here. */
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... LayerTypes>
+StaticFFN<OutputLayerType, InitializationRuleType, LayerTypes...>::StaticFFN(
+    const StaticFFN& other) :
+    outputLayer(other.outputLayer),
+    initializeRule(other.initializeRule),
+    network(other.network),
+    width(other.width),
+    height(other.height),
+    reset(other.reset),
+    predictors(other.predictors),
+    responses(other.responses),
+    parameter(other.parameter),
+    numFunctions(other.numFunctions),
+    deterministic(other.deterministic)
+{
+  // The copied layers own their weights now; point them to our parameters.
+  if (!parameter.is_empty())
+    ResetWeights();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... LayerTypes>
+StaticFFN<OutputLayerType, InitializationRuleType, LayerTypes...>::StaticFFN(
+    StaticFFN&& other) :
+    outputLayer(std::move(other.outputLayer)),
+    initializeRule(std::move(other.initializeRule)),
+    network(std::move(other.network)),
+    width(other.width),
+    height(other.height),
+    reset(other.reset),
+    predictors(std::move(other.predictors)),
+    responses(std::move(other.responses)),
+    parameter(std::move(other.parameter)),
+    numFunctions(other.numFunctions),
+    deterministic(other.deterministic)
+{
+  // Small parameter matrices are copied and not moved, so the weights of the
+  // layers have to be set again.
+  if (!parameter.is_empty())
+    ResetWeights();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... LayerTypes>
+StaticFFN<OutputLayerType, InitializationRuleType, LayerTypes...>&
+StaticFFN<OutputLayerType, InitializationRuleType, LayerTypes...>::operator=(
+    const StaticFFN& other)
+{
+  if (this != &other)
+  {
+    outputLayer = other.outputLayer;
+    initializeRule = other.initializeRule;
+    network = other.network;
+    width = other.width;
+    height = other.height;
+    reset = other.reset;
+    predictors = other.predictors;
+    responses = other.responses;
+    parameter = other.parameter;
+    numFunctions = other.numFunctions;
+    deterministic = other.deterministic;
+
+    if (!parameter.is_empty())
+      ResetWeights();
+  }
+
+  return *this;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... LayerTypes>
+StaticFFN<OutputLayerType, InitializationRuleType, LayerTypes...>&
+StaticFFN<OutputLayerType, InitializationRuleType, LayerTypes...>::operator=(
+    StaticFFN&& other)
+{
+  if (this != &other)
+  {
+    outputLayer = std::move(other.outputLayer);
+    initializeRule = std::move(other.initializeRule);
+    network = std::move(other.network);
+    width = other.width;
+    height = other.height;
+    reset = other.reset;
+    predictors = std::move(other.predictors);
+    responses = std::move(other.responses);
+    parameter = std::move(other.parameter);
+    numFunctions = other.numFunctions;
+    deterministic = other.deterministic;
+
+    if (!parameter.is_empty())
+      ResetWeights();
+  }
+
+  return *this;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... LayerTypes>
+void StaticFFN<OutputLayerType, InitializationRuleType, LayerTypes...>::
+ResetData(arma::mat predictors, arma::mat responses)
+{
+  numFunctions = responses.n_cols;
+  this->predictors = std::move(predictors);
+  this->responses = std::move(responses);
+  this->deterministic = true;
+  ResetDeterministic();
+
+  if (!reset)
+    ResetParameters();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... LayerTypes>
+template<typename OptimizerType, typename... CallbackTypes>
+double StaticFFN<OutputLayerType, InitializationRuleType, LayerTypes...>::
+Train(arma::mat predictors,
+      arma::mat responses,
+      OptimizerType& optimizer,
+      CallbackTypes&&... callbacks)
+{
+  ResetData(std::move(predictors), std::move(responses));
+
+  // Train the model.
+  Timer::Start("static_ffn_optimization");
+  const double out = optimizer.Optimize(*this, parameter, callbacks...);
+  Timer::Stop("static_ffn_optimization");
+
+  Log::Info << "StaticFFN::Train(): final objective of trained model is "
+      << out << "." << std::endl;
+  return out;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... LayerTypes>
+template<typename OptimizerType, typename... CallbackTypes>
+double StaticFFN<OutputLayerType, InitializationRuleType, LayerTypes...>::
+Train(arma::mat predictors,
+      arma::mat responses,
+      CallbackTypes&&... callbacks)
+{
+  OptimizerType optimizer;
+  return Train(std::move(predictors), std::move(responses), optimizer,
+      callbacks...);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... LayerTypes>
+void StaticFFN<OutputLayerType, InitializationRuleType, LayerTypes...>::
+Forward(const arma::mat& inputs, arma::mat& results)
+{
+  if (parameter.is_empty())
+    ResetParameters();
+
+  if (!deterministic)
+  {
+    deterministic = true;
+    ResetDeterministic();
+  }
+
+  Forward(inputs);
+  results = std::get<NumLayers - 1>(network).OutputParameter();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... LayerTypes>
+void StaticFFN<OutputLayerType, InitializationRuleType, LayerTypes...>::
+Predict(const arma::mat& predictors,
+        arma::mat& results,
+        const size_t batchSize)
+{
+  if (parameter.is_empty())
+    ResetParameters();
+
+  if (!deterministic)
+  {
+    deterministic = true;
+    ResetDeterministic();
+  }
+
+  const size_t effectiveBatchSize = std::max(batchSize, (size_t) 1);
+  for (size_t i = 0; i < predictors.n_cols; i += effectiveBatchSize)
+  {
+    const size_t end = std::min(i + effectiveBatchSize,
+        (size_t) predictors.n_cols) - 1;
+
+    // Use an alias of the batch, so that it does not have to be copied.
+    Forward(arma::mat((double*) predictors.colptr(i), predictors.n_rows,
+        end - i + 1, false, true));
+
+    const arma::mat& output =
+        std::get<NumLayers - 1>(network).OutputParameter();
+    if (i == 0)
+      results.set_size(output.n_rows, predictors.n_cols);
+    results.cols(i, end) = output;
+  }
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... LayerTypes>
+double StaticFFN<OutputLayerType, InitializationRuleType, LayerTypes...>::
+Evaluate(const arma::mat& predictors, const arma::mat& responses)
+{
+  if (parameter.is_empty())
+    ResetParameters();
+
+  if (!deterministic)
+  {
+    deterministic = true;
+    ResetDeterministic();
+  }
+
+  Forward(predictors);
+  return outputLayer.Forward(std::get<NumLayers - 1>(network).OutputParameter(),
+      responses) + Loss<0>();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... LayerTypes>
+double StaticFFN<OutputLayerType, InitializationRuleType, LayerTypes...>::
+Evaluate(const arma::mat& parameters)
+{
+  double res = 0;
+  for (size_t i = 0; i < predictors.n_cols; ++i)
+    res += Evaluate(parameters, i, 1, true);
+
+  return res;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... LayerTypes>
+double StaticFFN<OutputLayerType, InitializationRuleType, LayerTypes...>::
+Evaluate(const arma::mat& /* parameters */,
+         const size_t begin,
+         const size_t batchSize,
+         const bool deterministic)
+{
+  if (parameter.is_empty())
+    ResetParameters();
+
+  if (deterministic != this->deterministic)
+  {
+    this->deterministic = deterministic;
+    ResetDeterministic();
+  }
+
+  Forward(arma::mat(predictors.colptr(begin), predictors.n_rows, batchSize,
+      false, true));
+  return outputLayer.Forward(std::get<NumLayers - 1>(network).OutputParameter(),
+      responses.cols(begin, begin + batchSize - 1)) + Loss<0>();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... LayerTypes>
+double StaticFFN<OutputLayerType, InitializationRuleType, LayerTypes...>::
+Evaluate(const arma::mat& parameters,
+         const size_t begin,
+         const size_t batchSize)
+{
+  return Evaluate(parameters, begin, batchSize, true);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... LayerTypes>
+double StaticFFN<OutputLayerType, InitializationRuleType, LayerTypes...>::
+EvaluateWithGradient(const arma::mat& parameters, arma::mat& gradient)
+{
+  double res = 0;
+  for (size_t i = 0; i < predictors.n_cols; ++i)
+    res += EvaluateWithGradient(parameters, i, gradient, 1);
+
+  return res;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... LayerTypes>
+double StaticFFN<OutputLayerType, InitializationRuleType, LayerTypes...>::
+EvaluateWithGradient(const arma::mat& /* parameters */,
+                     const size_t begin,
+                     arma::mat& gradient,
+                     const size_t batchSize)
+{
+  if (gradient.is_empty())
+  {
+    if (parameter.is_empty())
+      ResetParameters();
+
+    gradient = arma::zeros<arma::mat>(parameter.n_rows, parameter.n_cols);
+  }
+  else
+  {
+    gradient.zeros();
+  }
+
+  if (this->deterministic)
+  {
+    this->deterministic = false;
+    ResetDeterministic();
+  }
+
+  const arma::mat input(predictors.colptr(begin), predictors.n_rows,
+      batchSize, false, true);
+  Forward(input);
+
+  const arma::mat& output = std::get<NumLayers - 1>(network).OutputParameter();
+  const double res = outputLayer.Forward(output,
+      responses.cols(begin, begin + batchSize - 1)) + Loss<0>();
+  outputLayer.Backward(output, responses.cols(begin, begin + batchSize - 1),
+      error);
+
+  Backward();
+  ResetGradients(gradient);
+  Gradient(input);
+
+  return res;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... LayerTypes>
+void StaticFFN<OutputLayerType, InitializationRuleType, LayerTypes...>::
+Gradient(const arma::mat& parameters,
+         const size_t begin,
+         arma::mat& gradient,
+         const size_t batchSize)
+{
+  this->EvaluateWithGradient(parameters, begin, gradient, batchSize);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... LayerTypes>
+void StaticFFN<OutputLayerType, InitializationRuleType, LayerTypes...>::
+Shuffle()
+{
+  math::ShuffleData(predictors, responses, predictors, responses);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... LayerTypes>
+void StaticFFN<OutputLayerType, InitializationRuleType, LayerTypes...>::
+ResetParameters()
+{
+  ResetDeterministic();
+
+  // Reset the network parameter with the given initialization rule, in the
+  // same way as NetworkInitialization does it for FFN.
+  if (parameter.is_empty())
+    parameter.set_size(WeightSize<0>(), 1);
+
+  if (ann::InitTraits<InitializationRuleType>::UseLayer)
+    InitializeLayers<0>(0);
+  else
+    initializeRule.Initialize(parameter, parameter.n_elem, 1);
+
+  ResetWeights();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... LayerTypes>
+void StaticFFN<OutputLayerType, InitializationRuleType, LayerTypes...>::
+ResetDeterministic()
+{
+  VisitLayers<0>(DeterministicSetVisitor(deterministic));
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... LayerTypes>
+void StaticFFN<OutputLayerType, InitializationRuleType, LayerTypes...>::
+ResetWeights()
+{
+  ResetWeights<0>(0);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... LayerTypes>
+void StaticFFN<OutputLayerType, InitializationRuleType, LayerTypes...>::
+ResetGradients(arma::mat& gradient)
+{
+  ResetGradients<0>(gradient, 0);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... LayerTypes>
+void StaticFFN<OutputLayerType, InitializationRuleType, LayerTypes...>::
+Forward(const arma::mat& input)
+{
+  ForwardLayers<0>(input);
+
+  if (!reset)
+    reset = true;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... LayerTypes>
+void StaticFFN<OutputLayerType, InitializationRuleType, LayerTypes...>::
+Backward()
+{
+  BackwardLayers<NumLayers - 1>();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... LayerTypes>
+void StaticFFN<OutputLayerType, InitializationRuleType, LayerTypes...>::
+Gradient(const arma::mat& input)
+{
+  GradientLayers<0>(input);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... LayerTypes>
+template<size_t I>
+typename std::enable_if<(I < sizeof...(LayerTypes)), void>::type
+StaticFFN<OutputLayerType, InitializationRuleType, LayerTypes...>::
+ForwardLayers(const arma::mat& input)
+{
+  auto& layer = std::get<I>(network);
+
+  // The dimensions of the data are only propagated through the network once.
+  // The first layer keeps the dimensions it was given.
+  if (!reset && I > 0)
+  {
+    SetInputWidthVisitor(width)(&layer);
+    SetInputHeightVisitor(height)(&layer);
+  }
+
+  LayerForward<I>(input);
+
+  if (!reset)
+  {
+    if (OutputWidthVisitor()(&layer) != 0)
+      width = OutputWidthVisitor()(&layer);
+
+    if (OutputHeightVisitor()(&layer) != 0)
+      height = OutputHeightVisitor()(&layer);
+  }
+
+  ForwardLayers<I + 1>(layer.OutputParameter());
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... LayerTypes>
+template<size_t I>
+typename std::enable_if<!IsFusedLayer<std::tuple<LayerTypes...>,
+    I>::value, void>::type
+StaticFFN<OutputLayerType, InitializationRuleType, LayerTypes...>::
+LayerForward(const arma::mat& input)
+{
+  auto& layer = std::get<I>(network);
+  layer.Forward(input, layer.OutputParameter());
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... LayerTypes>
+template<size_t I>
+typename std::enable_if<IsFusedLayer<std::tuple<LayerTypes...>,
+    I>::value, void>::type
+StaticFFN<OutputLayerType, InitializationRuleType, LayerTypes...>::
+LayerForward(const arma::mat& input)
+{
+  typedef typename FusedActivation<
+      typename std::tuple_element<I - 1, NetworkType>::type,
+      typename std::tuple_element<I, NetworkType>::type>::ActivationType
+      ActivationType;
+
+  // The input is the output of the previous layer, which is not needed
+  // anymore, so the activation is applied to it directly.
+  arma::mat& activation = std::get<I - 1>(network).OutputParameter();
+  ActivationType::Fn(input, activation);
+
+  math::MakeAlias(std::get<I>(network).OutputParameter(), activation.memptr(),
+      activation.n_rows, activation.n_cols, false);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... LayerTypes>
+template<size_t I>
+typename std::enable_if<(I > 0), void>::type
+StaticFFN<OutputLayerType, InitializationRuleType, LayerTypes...>::
+BackwardLayers()
+{
+  auto& layer = std::get<I>(network);
+  BackwardVisitor(layer.OutputParameter(), LayerError<I>(), layer.Delta())(
+      &layer);
+
+  BackwardLayers<I - 1>();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... LayerTypes>
+template<size_t I>
+typename std::enable_if<(I < sizeof...(LayerTypes)), void>::type
+StaticFFN<OutputLayerType, InitializationRuleType, LayerTypes...>::
+GradientLayers(const arma::mat& input)
+{
+  auto& layer = std::get<I>(network);
+  GradientVisitor(input, LayerError<I>())(&layer);
+
+  GradientLayers<I + 1>(layer.OutputParameter());
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... LayerTypes>
+template<size_t I>
+typename std::enable_if<(I < sizeof...(LayerTypes)), size_t>::type
+StaticFFN<OutputLayerType, InitializationRuleType, LayerTypes...>::
+WeightSize()
+{
+  return WeightSizeVisitor()(&std::get<I>(network)) + WeightSize<I + 1>();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... LayerTypes>
+template<size_t I>
+typename std::enable_if<(I < sizeof...(LayerTypes)), void>::type
+StaticFFN<OutputLayerType, InitializationRuleType, LayerTypes...>::
+InitializeLayers(const size_t offset)
+{
+  const size_t weight = WeightSizeVisitor()(&std::get<I>(network));
+  arma::mat tmp = arma::mat(parameter.memptr() + offset, weight, 1, false,
+      false);
+  initializeRule.Initialize(tmp, tmp.n_elem, 1);
+
+  InitializeLayers<I + 1>(offset + weight);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... LayerTypes>
+template<size_t I>
+typename std::enable_if<(I < sizeof...(LayerTypes)), void>::type
+StaticFFN<OutputLayerType, InitializationRuleType, LayerTypes...>::
+ResetWeights(const size_t offset)
+{
+  auto& layer = std::get<I>(network);
+  const size_t weight = WeightSetVisitor(parameter, offset)(&layer);
+  ResetVisitor()(&layer);
+
+  ResetWeights<I + 1>(offset + weight);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... LayerTypes>
+template<size_t I>
+typename std::enable_if<(I < sizeof...(LayerTypes)), void>::type
+StaticFFN<OutputLayerType, InitializationRuleType, LayerTypes...>::
+ResetGradients(arma::mat& gradient, const size_t offset)
+{
+  const size_t weight = GradientSetVisitor(gradient, offset)(
+      &std::get<I>(network));
+
+  ResetGradients<I + 1>(gradient, offset + weight);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... LayerTypes>
+template<size_t I, typename VisitorType>
+typename std::enable_if<(I < sizeof...(LayerTypes)), void>::type
+StaticFFN<OutputLayerType, InitializationRuleType, LayerTypes...>::
+VisitLayers(const VisitorType& visitor)
+{
+  visitor(&std::get<I>(network));
+  VisitLayers<I + 1>(visitor);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... LayerTypes>
+template<size_t I>
+typename std::enable_if<(I < sizeof...(LayerTypes)), double>::type
+StaticFFN<OutputLayerType, InitializationRuleType, LayerTypes...>::
+Loss()
+{
+  return LossVisitor()(&std::get<I>(network)) + Loss<I + 1>();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... LayerTypes>
+template<size_t I, typename Archive>
+typename std::enable_if<(I < sizeof...(LayerTypes)), void>::type
+StaticFFN<OutputLayerType, InitializationRuleType, LayerTypes...>::
+SerializeLayers(Archive& ar)
+{
+  ar & boost::serialization::make_nvp("layer", std::get<I>(network));
+  SerializeLayers<I + 1>(ar);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... LayerTypes>
+template<typename Archive>
+void StaticFFN<OutputLayerType, InitializationRuleType, LayerTypes...>::
+serialize(Archive& ar, const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(parameter);
+  ar & BOOST_SERIALIZATION_NVP(width);
+  ar & BOOST_SERIALIZATION_NVP(height);
+  ar & BOOST_SERIALIZATION_NVP(reset);
+
+  SerializeLayers<0>(ar);
+
+  // If we are loading, we need to initialize the weights.
+  if (Archive::is_loading::value)
+  {
+    ResetWeights();
+
+    deterministic = true;
+    ResetDeterministic();
+  }
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
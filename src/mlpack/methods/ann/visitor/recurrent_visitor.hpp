@@ -0,0 +1,66 @@
+/**
+ * @file methods/ann/visitor/recurrent_visitor.hpp
+ *
+ * This file provides an abstraction to check whether a layer keeps a state
+ * between the time steps of a recurrent network.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_VISITOR_RECURRENT_VISITOR_HPP
+#define MLPACK_METHODS_ANN_VISITOR_RECURRENT_VISITOR_HPP
+
+#include <mlpack/methods/ann/layer/layer_traits.hpp>
+#include <mlpack/methods/ann/layer/layer_types.hpp>
+
+#include <boost/variant.hpp>
+
+namespace mlpack {
+namespace ann {
+
+/**
+ * RecurrentVisitor returns whether the given module keeps a state between the
+ * time steps (it implements the Rho() function, like LSTM or GRU), or holds
+ * such a module.  The output of the other modules only depends on their input,
+ * so it can be computed again.
+ */
+class RecurrentVisitor : public boost::static_visitor<bool>
+{
+ public:
+  //! Return whether the module keeps a state between the time steps.
+  template<typename LayerType>
+  bool operator()(LayerType* layer) const;
+
+  bool operator()(MoreTypes layer) const;
+
+ private:
+  //! Return true if the module implements the Rho() function.
+  template<typename T>
+  typename std::enable_if<
+      HasRhoCheck<T>::value, bool>::type
+  LayerRecurrent(T* layer) const;
+
+  //! Check the modules held by a module that implements the Model() function
+  //! but not the Rho() function.
+  template<typename T>
+  typename std::enable_if<
+      !HasRhoCheck<T>::value && HasModelCheck<T>::value, bool>::type
+  LayerRecurrent(T* layer) const;
+
+  //! Return false if the module implements neither the Rho() nor the Model()
+  //! function.
+  template<typename T>
+  typename std::enable_if<
+      !HasRhoCheck<T>::value && !HasModelCheck<T>::value, bool>::type
+  LayerRecurrent(T* layer) const;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "recurrent_visitor_impl.hpp"
+
+#endif
@@ -0,0 +1,65 @@
+/**
+ * @file methods/ann/visitor/recurrent_visitor_impl.hpp
+ *
+ * Implementation of the RecurrentVisitor class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_VISITOR_RECURRENT_VISITOR_IMPL_HPP
+#define MLPACK_METHODS_ANN_VISITOR_RECURRENT_VISITOR_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "recurrent_visitor.hpp"
+
+namespace mlpack {
+namespace ann {
+
+//! RecurrentVisitor visitor class.
+template<typename LayerType>
+inline bool RecurrentVisitor::operator()(LayerType* layer) const
+{
+  return LayerRecurrent(layer);
+}
+
+inline bool RecurrentVisitor::operator()(MoreTypes layer) const
+{
+  return layer.apply_visitor(*this);
+}
+
+template<typename T>
+inline typename std::enable_if<
+    HasRhoCheck<T>::value, bool>::type
+RecurrentVisitor::LayerRecurrent(T* /* layer */) const
+{
+  return true;
+}
+
+template<typename T>
+inline typename std::enable_if<
+    !HasRhoCheck<T>::value && HasModelCheck<T>::value, bool>::type
+RecurrentVisitor::LayerRecurrent(T* layer) const
+{
+  for (size_t i = 0; i < layer->Model().size(); ++i)
+  {
+    if (boost::apply_visitor(RecurrentVisitor(), layer->Model()[i]))
+      return true;
+  }
+
+  return false;
+}
+
+template<typename T>
+inline typename std::enable_if<
+    !HasRhoCheck<T>::value && !HasModelCheck<T>::value, bool>::type
+RecurrentVisitor::LayerRecurrent(T* /* layer */) const
+{
+  return false;
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,75 @@
+/**
+ * @file methods/ann/visitor/step_visitor.hpp
+ *
+ * This file provides an abstraction for the Step() function of the layers that
+ * train some weights themselves, and automatically directs any parameter to the
+ * right layer type.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_VISITOR_STEP_VISITOR_HPP
+#define MLPACK_METHODS_ANN_VISITOR_STEP_VISITOR_HPP
+
+#include <mlpack/methods/ann/layer/layer_traits.hpp>
+
+#include <boost/variant.hpp>
+
+namespace mlpack {
+namespace ann {
+
+/**
+ * StepVisitor updates the weights that a module trains itself, outside of the
+ * parameters of the network (like the table of SparseEmbedding), with the
+ * gradient the module accumulated since its last step, by calling its Step()
+ * function.  It can instead discard that gradient, with ResetSparseGradient().
+ */
+class StepVisitor : public boost::static_visitor<void>
+{
+ public:
+  //! Update the weights of the module if apply is true, and otherwise discard
+  //! the accumulated gradient.
+  StepVisitor(const bool apply = true);
+
+  //! Update the weights or discard the accumulated gradient.
+  template<typename LayerType>
+  void operator()(LayerType* layer) const;
+
+  void operator()(MoreTypes layer) const;
+
+ private:
+  //! Whether to update the weights or to discard the gradient.
+  const bool apply;
+
+  //! Update the weights or discard the gradient if the module implements the
+  //! Step() function.
+  template<typename T>
+  typename std::enable_if<
+      HasStepCheck<T, void(T::*)()>::value, void>::type
+  LayerStep(T* layer) const;
+
+  //! Visit the modules of a module which implements the Model() function.
+  template<typename T>
+  typename std::enable_if<
+      !HasStepCheck<T, void(T::*)()>::value &&
+      HasModelCheck<T>::value, void>::type
+  LayerStep(T* layer) const;
+
+  //! Do nothing if the module doesn't implement the Step() or Model()
+  //! function.
+  template<typename T>
+  typename std::enable_if<
+      !HasStepCheck<T, void(T::*)()>::value &&
+      !HasModelCheck<T>::value, void>::type
+  LayerStep(T* layer) const;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "step_visitor_impl.hpp"
+
+#endif
@@ -0,0 +1,71 @@
+/**
+ * @file methods/ann/visitor/step_visitor_impl.hpp
+ *
+ * Implementation of the Step() function of the layers that train some weights
+ * themselves.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_VISITOR_STEP_VISITOR_IMPL_HPP
+#define MLPACK_METHODS_ANN_VISITOR_STEP_VISITOR_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "step_visitor.hpp"
+
+namespace mlpack {
+namespace ann {
+
+//! StepVisitor visitor class.
+inline StepVisitor::StepVisitor(const bool apply) : apply(apply)
+{
+  /* Nothing to do here. */
+}
+
+template<typename LayerType>
+inline void StepVisitor::operator()(LayerType* layer) const
+{
+  LayerStep(layer);
+}
+
+inline void StepVisitor::operator()(MoreTypes layer) const
+{
+  layer.apply_visitor(*this);
+}
+
+template<typename T>
+inline typename std::enable_if<
+    HasStepCheck<T, void(T::*)()>::value, void>::type
+StepVisitor::LayerStep(T* layer) const
+{
+  if (apply)
+    layer->Step();
+  else
+    layer->ResetSparseGradient();
+}
+
+template<typename T>
+inline typename std::enable_if<
+    !HasStepCheck<T, void(T::*)()>::value &&
+    HasModelCheck<T>::value, void>::type
+StepVisitor::LayerStep(T* layer) const
+{
+  for (size_t i = 0; i < layer->Model().size(); ++i)
+    boost::apply_visitor(StepVisitor(apply), layer->Model()[i]);
+}
+
+template<typename T>
+inline typename std::enable_if<
+    !HasStepCheck<T, void(T::*)()>::value &&
+    !HasModelCheck<T>::value, void>::type
+StepVisitor::LayerStep(T* /* layer */) const
+{
+  /* Nothing to do here. */
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,76 @@
+/**
+ * @file methods/ann/visitor/weight_init_visitor.hpp
+ *
+ * This file provides an abstraction for the InitializeWeights() function of the
+ * layers that train some weights themselves, and automatically directs any
+ * parameter to the right layer type.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_VISITOR_WEIGHT_INIT_VISITOR_HPP
+#define MLPACK_METHODS_ANN_VISITOR_WEIGHT_INIT_VISITOR_HPP
+
+#include <mlpack/methods/ann/layer/layer_traits.hpp>
+
+#include <boost/variant.hpp>
+
+namespace mlpack {
+namespace ann {
+
+/**
+ * WeightInitVisitor initializes the weights that a module trains itself,
+ * outside of the parameters of the network (like the table of
+ * SparseEmbedding), with the given initialization rule.  The modules that
+ * implement the Step() function have such weights.
+ *
+ * @tparam InitializationRuleType Rule used to initialize the weights.
+ */
+template<typename InitializationRuleType>
+class WeightInitVisitor : public boost::static_visitor<void>
+{
+ public:
+  //! Initialize the weights with the given rule.
+  WeightInitVisitor(InitializationRuleType& initializeRule);
+
+  //! Initialize the weights.
+  template<typename LayerType>
+  void operator()(LayerType* layer) const;
+
+  void operator()(MoreTypes layer) const;
+
+ private:
+  //! The rule used to initialize the weights.
+  InitializationRuleType& initializeRule;
+
+  //! Initialize the weights if the module implements the Step() function.
+  template<typename T>
+  typename std::enable_if<
+      HasStepCheck<T, void(T::*)()>::value, void>::type
+  LayerWeights(T* layer) const;
+
+  //! Visit the modules of a module which implements the Model() function.
+  template<typename T>
+  typename std::enable_if<
+      !HasStepCheck<T, void(T::*)()>::value &&
+      HasModelCheck<T>::value, void>::type
+  LayerWeights(T* layer) const;
+
+  //! Do nothing if the module doesn't implement the Step() or Model()
+  //! function.
+  template<typename T>
+  typename std::enable_if<
+      !HasStepCheck<T, void(T::*)()>::value &&
+      !HasModelCheck<T>::value, void>::type
+  LayerWeights(T* layer) const;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "weight_init_visitor_impl.hpp"
+
+#endif
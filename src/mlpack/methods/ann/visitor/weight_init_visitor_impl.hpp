@@ -0,0 +1,77 @@
+/**
+ * @file methods/ann/visitor/weight_init_visitor_impl.hpp
+ *
+ * Implementation of the InitializeWeights() function of the layers that train
+ * some weights themselves.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_VISITOR_WEIGHT_INIT_VISITOR_IMPL_HPP
+#define MLPACK_METHODS_ANN_VISITOR_WEIGHT_INIT_VISITOR_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "weight_init_visitor.hpp"
+
+namespace mlpack {
+namespace ann {
+
+//! WeightInitVisitor visitor class.
+template<typename InitializationRuleType>
+inline WeightInitVisitor<InitializationRuleType>::WeightInitVisitor(
+    InitializationRuleType& initializeRule) : initializeRule(initializeRule)
+{
+  /* Nothing to do here. */
+}
+
+template<typename InitializationRuleType>
+template<typename LayerType>
+inline void WeightInitVisitor<InitializationRuleType>::operator()(
+    LayerType* layer) const
+{
+  LayerWeights(layer);
+}
+
+template<typename InitializationRuleType>
+inline void WeightInitVisitor<InitializationRuleType>::operator()(
+    MoreTypes layer) const
+{
+  layer.apply_visitor(*this);
+}
+
+template<typename InitializationRuleType>
+template<typename T>
+inline typename std::enable_if<
+    HasStepCheck<T, void(T::*)()>::value, void>::type
+WeightInitVisitor<InitializationRuleType>::LayerWeights(T* layer) const
+{
+  layer->InitializeWeights(initializeRule);
+}
+
+template<typename InitializationRuleType>
+template<typename T>
+inline typename std::enable_if<
+    !HasStepCheck<T, void(T::*)()>::value &&
+    HasModelCheck<T>::value, void>::type
+WeightInitVisitor<InitializationRuleType>::LayerWeights(T* layer) const
+{
+  for (size_t i = 0; i < layer->Model().size(); ++i)
+    boost::apply_visitor(*this, layer->Model()[i]);
+}
+
+template<typename InitializationRuleType>
+template<typename T>
+inline typename std::enable_if<
+    !HasStepCheck<T, void(T::*)()>::value &&
+    !HasModelCheck<T>::value, void>::type
+WeightInitVisitor<InitializationRuleType>::LayerWeights(T* /* layer */) const
+{
+  /* Nothing to do here. */
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
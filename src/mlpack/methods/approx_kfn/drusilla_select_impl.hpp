@@ -16,9 +16,7 @@
 #include "drusilla_select.hpp"
 
 #include <queue>
-#include <mlpack/methods/neighbor_search/neighbor_search_rules.hpp>
-#include <mlpack/methods/neighbor_search/sort_policies/furthest_neighbor_sort.hpp>
-#include <mlpack/core/tree/binary_space_tree.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
 #include <algorithm>
 
 namespace mlpack {
@@ -179,23 +177,44 @@ void DrusillaSelect<MatType>::Search(const MatType& querySet,
     throw std::invalid_argument("DrusillaSelect::Search(): requested k is "
         "greater than number of points in candidate set!  Increase l or m.");
 
-  // We'll use the NeighborSearchRules class to perform our brute-force search.
-  // Note that we aren't using trees for our search, so we can use 'int' as a
-  // TreeType.
-  metric::EuclideanDistance metric;
-  NeighborSearchRules<FurthestNeighborSort, metric::EuclideanDistance,
-      tree::KDTree<metric::EuclideanDistance, tree::EmptyStatistic, MatType>>
-      rules(candidateSet, querySet, k, metric, 0, false);
+  neighbors.set_size(k, querySet.n_cols);
+  distances.set_size(k, querySet.n_cols);
 
-  for (size_t q = 0; q < querySet.n_cols; ++q)
-    for (size_t r = 0; r < candidateSet.n_cols; ++r)
-      rules.BaseCase(q, r);
+  // Every query is compared with the whole (small) candidate set, so the
+  // queries are independent and searched in parallel.  The distances to all
+  // the candidates are computed in one pass over the contiguous candidate set,
+  // and then the k furthest candidates are selected at once.
+  typedef std::pair<double, size_t> Candidate;
+  #pragma omp parallel
+  {
+    std::vector<Candidate> candidates(candidateSet.n_cols);
 
-  rules.GetResults(neighbors, distances);
+    #pragma omp for schedule(static)
+    for (omp_size_t q = 0; q < (omp_size_t) querySet.n_cols; ++q)
+    {
+      for (size_t r = 0; r < candidateSet.n_cols; ++r)
+      {
+        candidates[r] = std::make_pair(metric::EuclideanDistance::Evaluate(
+            querySet.col(q), candidateSet.col(r)), r);
+      }
 
-  // Map the neighbors back to their original indices in the reference set.
-  for (size_t i = 0; i < neighbors.n_elem; ++i)
-    neighbors[i] = candidateIndices[neighbors[i]];
+      // Sort the furthest candidates first; ties go to the earlier candidate.
+      std::partial_sort(candidates.begin(), candidates.begin() + k,
+          candidates.end(), [](const Candidate& c1, const Candidate& c2)
+          {
+            return (c1.first > c2.first) ||
+                (c1.first == c2.first && c1.second < c2.second);
+          });
+
+      // Map the neighbors back to their original indices in the reference
+      // set.
+      for (size_t j = 0; j < k; ++j)
+      {
+        neighbors(j, q) = candidateIndices[candidates[j].second];
+        distances(j, q) = candidates[j].first;
+      }
+    }
+  }
 }
 
 //! Serialize the model.
@@ -104,8 +104,13 @@ void QDAFN<MatType>::Search(const MatType& querySet,
   neighbors.fill(size_t() - 1);
   distances.zeros(k, querySet.n_cols);
 
-  // Search for each point.
-  for (size_t q = 0; q < querySet.n_cols; ++q)
+  // Project every query point onto every line with one matrix product; column
+  // q holds the projections of query point q.
+  const arma::mat queryProjections = lines.t() * querySet;
+
+  // The queries are independent, so they are searched in parallel.
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t q = 0; q < (omp_size_t) querySet.n_cols; ++q)
   {
     // Initialize a priority queue.
     // The size_t represents the index of the table, and the double represents
@@ -113,8 +118,7 @@ void QDAFN<MatType>::Search(const MatType& querySet,
     std::priority_queue<std::pair<double, size_t>> queue;
     for (size_t i = 0; i < l; ++i)
     {
-      const double val = sValues(0, i) - arma::dot(querySet.col(q),
-          lines.col(i));
+      const double val = sValues(0, i) - queryProjections(i, q);
       queue.push(std::make_pair(val, i));
     }
 
@@ -122,29 +126,20 @@ void QDAFN<MatType>::Search(const MatType& querySet,
     // in each table (they start at 0).
     arma::Col<size_t> tableLocations = arma::zeros<arma::Col<size_t>>(l);
 
-    // Now that the queue is initialized, iterate over m elements.
-    std::vector<std::pair<double, size_t>> v(k, std::make_pair(-1.0,
-        size_t(-1)));
-    std::priority_queue<std::pair<double, size_t>>
-        resultsQueue(std::less<std::pair<double, size_t>>(), std::move(v));
+    // The order in which the m candidates are visited only depends on the
+    // projections, so first find all of them, and then compute all of their
+    // distances in one pass.
+    arma::Col<size_t> visitedTables(m);
+    arma::Col<size_t> visitedLocations(m);
     for (size_t i = 0; i < m; ++i)
     {
-      std::pair<size_t, double> p = queue.top();
+      std::pair<double, size_t> p = queue.top();
       queue.pop();
 
       // Get index of reference point to look at.
       const size_t tableIndex = tableLocations[p.second];
-
-      // Calculate distance from query point.
-      const double dist = mlpack::metric::EuclideanDistance::Evaluate(
-          querySet.col(q), candidateSet[p.second].col(tableIndex));
-
-      // Is this neighbor good enough to insert into the results?
-      if (dist > resultsQueue.top().first)
-      {
-        resultsQueue.pop();
-        resultsQueue.push(std::make_pair(dist, sIndices(tableIndex, p.second)));
-      }
+      visitedTables[i] = p.second;
+      visitedLocations[i] = tableIndex;
 
       // Now (line 14) get the next element and insert into the queue.  Do this
       // by adjusting the previous value.  Don't insert anything if we are at
@@ -159,6 +154,29 @@ void QDAFN<MatType>::Search(const MatType& querySet,
       }
     }
 
+    arma::vec candidateDistances(m);
+    for (size_t i = 0; i < m; ++i)
+    {
+      candidateDistances[i] = mlpack::metric::EuclideanDistance::Evaluate(
+          querySet.col(q),
+          candidateSet[visitedTables[i]].col(visitedLocations[i]));
+    }
+
+    std::vector<std::pair<double, size_t>> v(k, std::make_pair(-1.0,
+        size_t(-1)));
+    std::priority_queue<std::pair<double, size_t>>
+        resultsQueue(std::less<std::pair<double, size_t>>(), std::move(v));
+    for (size_t i = 0; i < m; ++i)
+    {
+      // Is this neighbor good enough to insert into the results?
+      if (candidateDistances[i] > resultsQueue.top().first)
+      {
+        resultsQueue.pop();
+        resultsQueue.push(std::make_pair(candidateDistances[i],
+            sIndices(visitedLocations[i], visitedTables[i])));
+      }
+    }
+
     // Extract the results.
     for (size_t j = 1; j <= k; ++j)
     {
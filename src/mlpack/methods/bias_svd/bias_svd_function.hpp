@@ -155,6 +155,8 @@ namespace ens {
       mlpack::svd::BiasSVDFunction<arma::mat>& function,
       arma::mat& parameters);
 
+  // Hogwild! parallel SGD: blocks of threadShareSize shuffled ratings are
+  // handed out to the threads, which update the parameters without locks.
   template <>
   template <>
   inline double ParallelSGD<ExponentialBackoff>::Optimize(
@@ -271,7 +271,7 @@ inline double ParallelSGD<ExponentialBackoff>::Optimize(
   arma::Col<size_t> visitationOrder = arma::linspace<arma::Col<size_t>>(0,
       (function.NumFunctions() - 1), function.NumFunctions());
 
-  const arma::mat data = function.Dataset();
+  const arma::mat& data = function.Dataset();
   const size_t numUsers = function.NumUsers();
   const double lambda = function.Lambda();
 
@@ -319,55 +319,45 @@ inline double ParallelSGD<ExponentialBackoff>::Optimize(
       std::shuffle(visitationOrder.begin(), visitationOrder.end(),
           mlpack::math::randGen);
 
-    #pragma omp parallel
+    // Hogwild!: the shuffled ratings are split into blocks of threadShareSize
+    // ratings, and the threads take blocks until every rating of the epoch has
+    // been visited.  Each update touches only a few parameter columns, so the
+    // updates are written without any locking.
+    const size_t blockSize = std::max(threadShareSize, (size_t) 1);
+    const size_t numBlocks = (visitationOrder.n_elem + blockSize - 1) /
+        blockSize;
+    #pragma omp parallel for schedule(dynamic)
+    for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
     {
-      // Each processor gets a subset of the instances.
-      // Each subset is of size threadShareSize.
-      size_t threadId = 0;
-      #ifdef HAS_OPENMP
-        threadId = omp_get_thread_num();
-      #endif
-
-      for (size_t j = threadId * threadShareSize;
-          j < (threadId + 1) * threadShareSize && j < visitationOrder.n_elem;
-          ++j)
+      const size_t end = std::min(((size_t) b + 1) * blockSize,
+          (size_t) visitationOrder.n_elem);
+      for (size_t j = (size_t) b * blockSize; j < end; ++j)
       {
-        // Indices for accessing the the correct parameter columns.
-        const size_t user = data(0, visitationOrder[j]);
-        const size_t item = data(1, visitationOrder[j]) + numUsers;
+        // Indices for accessing the the correct parameter columns.  The bias
+        // is the last element of each column.
+        double* userVec = iterate.colptr(data(0, visitationOrder[j]));
+        double* itemVec = iterate.colptr(data(1, visitationOrder[j]) +
+            numUsers);
 
         // Prediction error for the example.
-        const double rating = data(2, visitationOrder[j]);
-        const double userBias = iterate(rank, user);
-        const double itemBias = iterate(rank, item);
-        double ratingError = rating - userBias - itemBias -
-            arma::dot(iterate.col(user).subvec(0, rank - 1),
-                      iterate.col(item).subvec(0, rank - 1));
-
-        arma::mat userVecUpdate = stepSize * 2 * (
-            lambda * iterate.col(user).subvec(0, rank - 1) -
-            ratingError * iterate.col(item).subvec(0, rank - 1));
-        arma::mat itemVecUpdate = stepSize * 2 * (
-            lambda * iterate.col(item).subvec(0, rank - 1) -
-            ratingError * iterate.col(user).subvec(0, rank - 1));
-        double userBiasUpdate = stepSize * 2 * (
-            lambda * iterate(rank, user) - ratingError);
-        double itemBiasUpdate = stepSize * 2 * (
-            lambda * iterate(rank, item) - ratingError);
+        double ratingError = data(2, visitationOrder[j]) - userVec[rank] -
+            itemVec[rank];
+        for (size_t k = 0; k < rank; ++k)
+          ratingError -= userVec[k] * itemVec[k];
 
         // Gradient is non-zero only for the parameter columns corresponding to
         // the example.
-        for (size_t i = 0; i < rank; ++i)
+        for (size_t k = 0; k < rank; ++k)
         {
-          #pragma omp atomic
-          iterate(i, user) -= userVecUpdate(i);
-          #pragma omp atomic
-          iterate(i, item) -= itemVecUpdate(i);
+          const double userValue = userVec[k];
+          const double itemValue = itemVec[k];
+          userVec[k] -= stepSize * 2 * (lambda * userValue -
+              ratingError * itemValue);
+          itemVec[k] -= stepSize * 2 * (lambda * itemValue -
+              ratingError * userValue);
         }
-        #pragma omp atomic
-        iterate(rank, user) -= userBiasUpdate;
-        #pragma omp atomic
-        iterate(rank, item) -= itemBiasUpdate;
+        userVec[rank] -= stepSize * 2 * (lambda * userVec[rank] - ratingError);
+        itemVec[rank] -= stepSize * 2 * (lambda * itemVec[rank] - ratingError);
       }
     }
   }
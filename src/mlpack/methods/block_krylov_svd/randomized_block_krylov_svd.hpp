@@ -14,6 +14,7 @@
 #define MLPACK_METHODS_BLOCK_KRYLOV_SVD_RANDOMIZED_BLOCK_KRYLOV_SVD_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/product.hpp>
 
 namespace mlpack {
 namespace svd {
@@ -54,6 +55,11 @@ namespace svd {
  * // Use the Apply() method to get a factorization.
  * bSVD.Apply(data, u, s, v, rank);
  * @endcode
+ *
+ * Dense and sparse matrices of single or double precision are supported
+ * (arma::mat, arma::fmat, arma::sp_mat and arma::sp_fmat).  The products of
+ * sparse matrices with dense matrices are computed in parallel when OpenMP is
+ * available.
  */
 class RandomizedBlockKrylovSVD
 {
@@ -92,16 +98,17 @@ class RandomizedBlockKrylovSVD
    * Apply Principal Component Analysis to the provided data set using the
    * randomized block krylov SVD.
    *
-   * @param data Data matrix.
+   * @param data Data matrix (dense or sparse).
    * @param u First unitary matrix.
    * @param v Second unitary matrix.
    * @param s Diagonal matrix of singular values.
    * @param rank Rank of the approximation.
    */
-  void Apply(const arma::mat& data,
-             arma::mat& u,
-             arma::vec& s,
-             arma::mat& v,
+  template<typename MatType>
+  void Apply(const MatType& data,
+             arma::Mat<typename MatType::elem_type>& u,
+             arma::Col<typename MatType::elem_type>& s,
+             arma::Mat<typename MatType::elem_type>& v,
              const size_t rank);
 
   //! Get the number of iterations for the power method.
@@ -125,4 +132,7 @@ class RandomizedBlockKrylovSVD
 } // namespace svd
 } // namespace mlpack
 
+// Include implementation.
+#include "randomized_block_krylov_svd_impl.hpp"
+
 #endif
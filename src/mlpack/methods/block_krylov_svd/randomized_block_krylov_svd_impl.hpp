@@ -0,0 +1,78 @@
+/**
+ * @file methods/block_krylov_svd/randomized_block_krylov_svd_impl.hpp
+ *
+ * Implementation of the randomized block krylov SVD method for dense and
+ * sparse matrices.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_BLOCK_KRYLOV_SVD_RANDOMIZED_BLOCK_KRYLOV_SVD_IMPL_HPP
+#define MLPACK_METHODS_BLOCK_KRYLOV_SVD_RANDOMIZED_BLOCK_KRYLOV_SVD_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "randomized_block_krylov_svd.hpp"
+
+namespace mlpack {
+namespace svd {
+
+template<typename MatType>
+void RandomizedBlockKrylovSVD::Apply(
+    const MatType& data,
+    arma::Mat<typename MatType::elem_type>& u,
+    arma::Col<typename MatType::elem_type>& s,
+    arma::Mat<typename MatType::elem_type>& v,
+    const size_t rank)
+{
+  typedef arma::Mat<typename MatType::elem_type> DenseMatType;
+
+  DenseMatType Q, R, block, blockIteration;
+
+  if (blockSize == 0)
+  {
+    blockSize = rank + 10;
+  }
+
+  // Random block initialization.
+  DenseMatType G = arma::randn<DenseMatType>(data.n_cols, blockSize);
+
+  // Construct and orthonormalize Krylov subspace.
+  DenseMatType K(data.n_rows, blockSize * (maxIterations + 1));
+
+  // Create a working matrix using data from writable auxiliary memory
+  // (K matrix). Doing so avoids an uncessary copy in upcoming step.
+  block = DenseMatType(K.memptr(), data.n_rows, blockSize, false, false);
+  arma::qr_econ(block, R, math::Product(data, G));
+
+  for (size_t blockOffset = block.n_elem; blockOffset < K.n_elem;
+      blockOffset += block.n_elem)
+  {
+    // Temporary working matrix to store the result in the correct place.
+    blockIteration = DenseMatType(K.memptr() + blockOffset, block.n_rows,
+        block.n_cols, false, false);
+
+    arma::qr_econ(blockIteration, R, math::Product(data,
+        math::TransProduct(data, block)));
+
+    // Update working matrix for the next iteration.
+    block = DenseMatType(K.memptr() + blockOffset, block.n_rows, block.n_cols,
+        false, false);
+  }
+
+  arma::qr_econ(Q, R, K);
+
+  // Approximate eigenvalues and eigenvectors using Rayleigh–Ritz method.
+  arma::svd_econ(u, s, v, arma::trans(math::TransProduct(data, Q)));
+
+  // Do economical singular value decomposition and compute only the
+  // approximations of the left singular vectors by using the centered data
+  // applied to Q.
+  u = Q * u;
+}
+
+} // namespace svd
+} // namespace mlpack
+
+#endif
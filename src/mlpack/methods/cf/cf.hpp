@@ -18,6 +18,8 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/methods/neighbor_search/neighbor_search.hpp>
+#include <mlpack/methods/fastmks/fastmks.hpp>
+#include <mlpack/core/kernels/linear_kernel.hpp>
 #include <mlpack/methods/amf/amf.hpp>
 #include <mlpack/methods/amf/update_rules/nmf_als.hpp>
 #include <mlpack/methods/amf/termination_policies/simple_residue_termination.hpp>
@@ -25,6 +27,7 @@
 #include <mlpack/methods/cf/decomposition_policies/nmf_method.hpp>
 #include <mlpack/methods/cf/neighbor_search_policies/lmetric_search.hpp>
 #include <mlpack/methods/cf/interpolation_policies/average_interpolation.hpp>
+#include <mlpack/methods/cf/neighbor_search_cache.hpp>
 #include <set>
 #include <map>
 #include <iostream>
@@ -51,6 +54,10 @@ namespace cf /** Collaborative filtering. **/ {
  * // Generate 10 recommendations for specified users.
  * cf.GetRecommendations(10, recommendations, users);
  *
+ * // Generate 10 recommendations for specified users, scoring only the 40 items
+ * // with the largest inner product with each user.
+ * cf.GetApproximateRecommendations(10, recommendations, users, 4.0);
+ *
  * @endcode
  *
  * The data matrix is a (user, item, rating) table.  Each column in the matrix
@@ -143,6 +150,23 @@ class CFType
              const double minResidue = 1e-5,
              const bool mit = false);
 
+  /**
+   * Fold the given users into the model without refactorizing the rating
+   * matrix: the ratings of each user are normalized with the statistics of the
+   * training data, and the factors of the users are computed against the
+   * fixed item factors.  Users that are already part of the model have their
+   * ratings and factors replaced; users beyond the current number of users
+   * are added, so that recommendations can be generated for them right away.
+   *
+   * The DecompositionPolicy must implement FoldIn() (as WeightedALSPolicy
+   * does), and so must the NormalizationType.
+   *
+   * @param ratings All the ratings of the users, one row per item and one
+   *     column per user.
+   * @param users User ID of each column of the ratings.
+   */
+  void FoldIn(const arma::sp_mat& ratings, const arma::Col<size_t>& users);
+
   //! Sets number of users for calculating similarity.
   void NumUsersForSimilarity(const size_t num)
   {
@@ -216,6 +240,40 @@ class CFType
                           arma::Mat<size_t>& recommendations,
                           const arma::Col<size_t>& users);
 
+  /**
+   * Generates the given number of recommendations for the specified users,
+   * without scoring every item.  The neighborhood of each user is combined
+   * into a single vector of user factors, and FastMKS with the linear kernel
+   * finds the ceil(candidateRatio * numRecs) items whose factors (the rows of
+   * W) have the largest inner product with it.  Only those items are scored
+   * with the full model, so the CF search cost is sublinear in the number
+   * of items.
+   *
+   * Users for which fewer than numRecs unrated candidates are found fall back
+   * to GetRecommendations().  So for decompositions whose ratings are W * H
+   * and normalizations that keep the order of the ratings of a user, the
+   * result is the same as that of GetRecommendations().  Otherwise (for
+   * instance with item biases or item mean normalization) the result is
+   * approximate, and a larger candidateRatio improves the recall.
+   *
+   * @tparam NeighborSearchPolicy The policy used to search neighbors of
+   *     query set in referece set.
+   * @tparam InterpolationPolicy The policy used to calculate interpolation
+   *     weights.
+   *
+   * @param numRecs Number of Recommendations.
+   * @param recommendations Matrix to save recommendations.
+   * @param users Users for which recommendations are to be generated.
+   * @param candidateRatio Number of candidate items for each recommendation
+   *     (at least 1).
+   */
+  template<typename NeighborSearchPolicy = EuclideanSearch,
+           typename InterpolationPolicy = AverageInterpolation>
+  void GetApproximateRecommendations(const size_t numRecs,
+                                     arma::Mat<size_t>& recommendations,
+                                     const arma::Col<size_t>& users,
+                                     const double candidateRatio = 2.0);
+
   //! Converts the User, Item, Value Matrix to User-Item Table.
   static void CleanData(const arma::mat& data, arma::sp_mat& cleanedData);
 
@@ -273,6 +331,8 @@ class CFType
   arma::sp_mat cleanedData;
   //! Data normalization object.
   NormalizationType normalization;
+  //! The neighbor search of the last query, kept until the model changes.
+  mutable NeighborSearchCache neighborSearchCache;
 
   //! Candidate represents a possible recommendation (value, item).
   typedef std::pair<double, size_t> Candidate;
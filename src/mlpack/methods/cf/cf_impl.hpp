@@ -84,6 +84,7 @@ Train(const arma::mat& data,
       const bool mit)
 {
   this->decomposition = decomposition;
+  neighborSearchCache.Reset();
 
   // Make a copy of data before performing normalization.
   arma::mat normalizedData(data);
@@ -125,6 +126,7 @@ Train(const arma::sp_mat& data,
       const bool mit)
 {
   this->decomposition = decomposition;
+  neighborSearchCache.Reset();
 
   // data is not used in the following decomposition.Apply() method, so we only
   // need to Normalize cleanedData.
@@ -154,6 +156,83 @@ Train(const arma::sp_mat& data,
   Timer::Stop("cf_factorization");
 }
 
+template<typename DecompositionPolicy,
+         typename NormalizationType>
+void CFType<DecompositionPolicy,
+            NormalizationType>::
+FoldIn(const arma::sp_mat& ratings, const arma::Col<size_t>& users)
+{
+  if (ratings.n_rows != cleanedData.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "CFType::FoldIn(): the ratings have " << ratings.n_rows
+        << " items, but the model has " << cleanedData.n_rows << " items!";
+    throw std::invalid_argument(oss.str());
+  }
+  if (ratings.n_cols != users.n_elem)
+  {
+    throw std::invalid_argument("CFType::FoldIn(): the number of columns of "
+        "the ratings must be the number of users!");
+  }
+  if (users.n_elem == 0)
+    return;
+
+  const size_t numUsers = std::max((size_t) cleanedData.n_cols,
+      (size_t) users.max() + 1);
+  std::vector<char> replaced(numUsers, false);
+  for (size_t i = 0; i < users.n_elem; ++i)
+  {
+    if (replaced[users[i]])
+    {
+      throw std::invalid_argument("CFType::FoldIn(): each user must be given "
+          "only once!");
+    }
+    replaced[users[i]] = true;
+  }
+
+  arma::sp_mat normalizedRatings(ratings);
+  normalization.FoldIn(normalizedRatings, users);
+
+  Timer::Start("cf_fold_in");
+  decomposition.FoldIn(normalizedRatings, users);
+  Timer::Stop("cf_fold_in");
+  neighborSearchCache.Reset();
+
+  // Replace the columns of the given users in the cleaned data, which the
+  // interpolation and the filtering of rated items use.  The matrix is built
+  // again in a single pass over its nonzero elements.
+  size_t numRatings = normalizedRatings.n_nonzero;
+  for (arma::sp_mat::const_iterator it = cleanedData.begin();
+       it != cleanedData.end(); ++it)
+  {
+    if (!replaced[it.col()])
+      ++numRatings;
+  }
+
+  arma::umat locations(2, numRatings);
+  arma::vec values(numRatings);
+  size_t index = 0;
+  for (arma::sp_mat::const_iterator it = cleanedData.begin();
+       it != cleanedData.end(); ++it)
+  {
+    if (replaced[it.col()])
+      continue;
+
+    locations(0, index) = it.row();
+    locations(1, index) = it.col();
+    values[index++] = *it;
+  }
+  for (arma::sp_mat::const_iterator it = normalizedRatings.begin();
+       it != normalizedRatings.end(); ++it)
+  {
+    locations(0, index) = it.row();
+    locations(1, index) = users[it.col()];
+    values[index++] = *it;
+  }
+
+  cleanedData = arma::sp_mat(locations, values, cleanedData.n_rows, numUsers);
+}
+
 template<typename DecompositionPolicy,
          typename NormalizationType>
 template<typename NeighborSearchPolicy,
@@ -195,8 +274,9 @@ GetRecommendations(const size_t numRecs,
   // weighted sum of both the query user and the local neighborhood of the
   // query user.
   // Calculate the neighborhood of the queried users.
-  decomposition.template GetNeighborhood<NeighborSearchPolicy>(
-      users, numUsersForSimilarity, neighborhood, similarities);
+  neighborSearchCache.template GetNeighborhood<NeighborSearchPolicy>(
+      decomposition, users, numUsersForSimilarity, neighborhood,
+      similarities);
 
   // Generate recommendations for each query user by finding the maximum numRecs
   // elements in the ratings vector.
@@ -210,27 +290,42 @@ GetRecommendations(const size_t numRecs,
   // time and we don't want to repeat the initialization process in each loop.
   InterpolationPolicy interpolation(cleanedData);
 
+  // Calculate interpolation weights.  This is done serially, since an
+  // interpolation policy may cache values between calls.
+  arma::mat weights(numUsersForSimilarity, users.n_elem);
   for (size_t i = 0; i < users.n_elem; i++)
   {
-    // First, calculate the weighted sum of neighborhood values.
-    arma::vec ratings;
-    ratings.zeros(cleanedData.n_rows);
-
-    // Calculate interpolation weights.
-    arma::vec weights(numUsersForSimilarity);
-    interpolation.GetWeights(weights, decomposition, users(i),
+    interpolation.GetWeights(weights.col(i), decomposition, users(i),
         neighborhood.col(i), similarities.col(i), cleanedData);
+  }
 
+  // The recommendations of each user are independent of those of the others.
+  const arma::sp_mat& ratedItems = cleanedData;
+  #pragma omp parallel for schedule(dynamic, 16)
+  for (omp_size_t i = 0; i < (omp_size_t) users.n_elem; i++)
+  {
+    // First, calculate the weighted sum of neighborhood values.
+    arma::vec ratings;
+    ratings.zeros(ratedItems.n_rows);
+    arma::vec neighborRatings;
     for (size_t j = 0; j < neighborhood.n_rows; ++j)
     {
-      arma::vec neighborRatings;
       decomposition.GetRatingOfUser(neighborhood(j, i), neighborRatings);
-      ratings += weights(j) * neighborRatings;
+      ratings += weights(j, i) * neighborRatings;
     }
 
+    // Ensure that the user hasn't already rated the item.  The algorithm omits
+    // rating of zero. Thus, when normalizing original ratings in Normalize(),
+    // if normalized rating equals zero, it is set to the smallest positive
+    // double value.  Only the nonzero ratings of the user are visited.
+    std::vector<bool> rated(ratedItems.n_rows, false);
+    for (arma::sp_mat::const_iterator it = ratedItems.begin_col(users(i));
+         it != ratedItems.end_col(users(i)); ++it)
+      rated[it.row()] = true;
+
     // Let's build the list of candidate recomendations for the given user.
     // Default candidate: the smallest possible value and invalid item number.
-    const Candidate def = std::make_pair(-DBL_MAX, cleanedData.n_rows);
+    const Candidate def = std::make_pair(-DBL_MAX, ratedItems.n_rows);
     std::vector<Candidate> vect(numRecs, def);
     typedef std::priority_queue<Candidate, std::vector<Candidate>, CandidateCmp>
         CandidateList;
@@ -239,11 +334,7 @@ GetRecommendations(const size_t numRecs,
     // Look through the ratings column corresponding to the current user.
     for (size_t j = 0; j < ratings.n_rows; ++j)
     {
-      // Ensure that the user hasn't already rated the item.
-      // The algorithm omits rating of zero. Thus, when normalizing original
-      // ratings in Normalize(), if normalized rating equals zero, it is set
-      // to the smallest positive double value.
-      if (cleanedData(j, users(i)) != 0.0)
+      if (rated[j])
         continue; // The user already rated the item.
 
       // Is the estimated value better than the worst candidate?
@@ -263,16 +354,148 @@ GetRecommendations(const size_t numRecs,
       values(numRecs - p, i) = pqueue.top().first;
       pqueue.pop();
     }
+  }
 
-    // If we were not able to come up with enough recommendations, issue a
-    // warning.
-    if (recommendations(numRecs - 1, i) == def.second)
+  // If we were not able to come up with enough recommendations for a user,
+  // issue a warning.
+  for (size_t i = 0; i < users.n_elem; i++)
+  {
+    if (recommendations(numRecs - 1, i) == cleanedData.n_rows)
       Log::Warn << "Could not provide " << numRecs << " recommendations "
           << "for user " << users(i) << " (not enough un-rated items)!"
           << std::endl;
   }
 }
 
+template<typename DecompositionPolicy,
+         typename NormalizationType>
+template<typename NeighborSearchPolicy,
+         typename InterpolationPolicy>
+void CFType<DecompositionPolicy,
+            NormalizationType>::
+GetApproximateRecommendations(const size_t numRecs,
+                              arma::Mat<size_t>& recommendations,
+                              const arma::Col<size_t>& users,
+                              const double candidateRatio)
+{
+  if (candidateRatio < 1.0)
+  {
+    throw std::invalid_argument("CFType::GetApproximateRecommendations(): "
+        "candidateRatio must be at least 1!");
+  }
+
+  // Temporary storage for neighborhood of the queried users.
+  arma::Mat<size_t> neighborhood;
+  // Resulting similarities.
+  arma::mat similarities;
+
+  // Calculate the neighborhood of the queried users, as in
+  // GetRecommendations().
+  neighborSearchCache.template GetNeighborhood<NeighborSearchPolicy>(
+      decomposition, users, numUsersForSimilarity, neighborhood,
+      similarities);
+
+  // Calculate interpolation weights.  This is done serially, since an
+  // interpolation policy may cache values between calls.
+  InterpolationPolicy interpolation(cleanedData);
+  arma::mat weights(numUsersForSimilarity, users.n_elem);
+  for (size_t i = 0; i < users.n_elem; i++)
+  {
+    interpolation.GetWeights(weights.col(i), decomposition, users(i),
+        neighborhood.col(i), similarities.col(i), cleanedData);
+  }
+
+  // The weighted sum of the ratings of the neighbors is W times the weighted
+  // sum of their factors.
+  const arma::mat& w = decomposition.W();
+  const arma::mat& h = decomposition.H();
+  arma::mat queries(h.n_rows, users.n_elem, arma::fill::zeros);
+  for (size_t i = 0; i < users.n_elem; i++)
+  {
+    for (size_t j = 0; j < neighborhood.n_rows; ++j)
+      queries.col(i) += weights(j, i) * h.col(neighborhood(j, i));
+  }
+
+  // Find the candidates with the largest inner products.
+  const size_t numItems = cleanedData.n_rows;
+  const size_t numCandidates = std::min(numItems,
+      (size_t) std::ceil(candidateRatio * numRecs));
+  arma::Mat<size_t> candidates;
+  arma::mat products;
+  fastmks::FastMKS<kernel::LinearKernel> mips(arma::mat(w.t()));
+  mips.Search(queries, numCandidates, candidates, products);
+
+  recommendations.set_size(numRecs, users.n_elem);
+  std::vector<char> fallback(users.n_elem, 0);
+
+  // Score the candidates of each user with the full model.
+  const arma::sp_mat& ratedItems = cleanedData;
+  #pragma omp parallel for schedule(dynamic, 16)
+  for (omp_size_t i = 0; i < (omp_size_t) users.n_elem; i++)
+  {
+    const Candidate def = std::make_pair(-DBL_MAX, numItems);
+    std::vector<Candidate> vect(numRecs, def);
+    typedef std::priority_queue<Candidate, std::vector<Candidate>, CandidateCmp>
+        CandidateList;
+    CandidateList pqueue(CandidateCmp(), std::move(vect));
+
+    for (size_t c = 0; c < candidates.n_rows; ++c)
+    {
+      const size_t item = candidates(c, i);
+      if (item >= numItems || ratedItems(item, users(i)) != 0.0)
+        continue; // The user already rated the item.
+
+      double rating = 0.0;
+      for (size_t j = 0; j < neighborhood.n_rows; ++j)
+      {
+        rating += weights(j, i) *
+            decomposition.GetRating(neighborhood(j, i), item);
+      }
+
+      const double realRating = normalization.Denormalize(users(i), item,
+          rating);
+      if (realRating > pqueue.top().first)
+      {
+        pqueue.pop();
+        pqueue.push(std::make_pair(realRating, item));
+      }
+    }
+
+    for (size_t p = 1; p <= numRecs; p++)
+    {
+      recommendations(numRecs - p, i) = pqueue.top().second;
+      pqueue.pop();
+    }
+
+    if (recommendations(numRecs - 1, i) == numItems)
+      fallback[i] = 1;
+  }
+
+  // Score all items for the users that had too few unrated candidates.
+  arma::uvec fallbackIndices(std::count(fallback.begin(), fallback.end(), 1));
+  for (size_t i = 0, f = 0; i < users.n_elem; i++)
+  {
+    if (fallback[i])
+      fallbackIndices[f++] = i;
+  }
+
+  if (fallbackIndices.n_elem > 0)
+  {
+    arma::Col<size_t> fallbackUsers(fallbackIndices.n_elem);
+    for (size_t f = 0; f < fallbackIndices.n_elem; ++f)
+      fallbackUsers[f] = users(fallbackIndices[f]);
+
+    arma::Mat<size_t> fallbackRecommendations;
+    GetRecommendations<NeighborSearchPolicy, InterpolationPolicy>(numRecs,
+        fallbackRecommendations, fallbackUsers);
+    for (size_t f = 0; f < fallbackIndices.n_elem; ++f)
+    {
+      recommendations.col(fallbackIndices[f]) =
+          fallbackRecommendations.col(f);
+    }
+  }
+}
+
 // Predict the rating for a single user/item combination.
 template<typename DecompositionPolicy,
          typename NormalizationType>
@@ -297,8 +520,9 @@ Predict(const size_t user, const size_t item) const
   // Calculate the neighborhood of the queried users.
   arma::Col<size_t> users(1);
   users(0) = user;
-  decomposition.template GetNeighborhood<NeighborSearchPolicy>(
-      users, numUsersForSimilarity, neighborhood, similarities);
+  neighborSearchCache.template GetNeighborhood<NeighborSearchPolicy>(
+      decomposition, users, numUsersForSimilarity, neighborhood,
+      similarities);
 
   arma::vec weights(numUsersForSimilarity);
 
@@ -348,8 +572,9 @@ Predict(const arma::Mat<size_t>& combinations,
   // weighted sum of both the query user and the local neighborhood of the
   // query user.
   // Calculate the neighborhood of the queried users.
-  decomposition.template GetNeighborhood<NeighborSearchPolicy>(
-      users, numUsersForSimilarity, neighborhood, similarities);
+  neighborSearchCache.template GetNeighborhood<NeighborSearchPolicy>(
+      decomposition, users, numUsersForSimilarity, neighborhood,
+      similarities);
 
   arma::mat weights(numUsersForSimilarity, users.n_elem);
 
@@ -436,6 +661,9 @@ serialize(Archive& ar, const unsigned int /* version */)
   ar & BOOST_SERIALIZATION_NVP(decomposition);
   ar & BOOST_SERIALIZATION_NVP(cleanedData);
   ar & BOOST_SERIALIZATION_NVP(normalization);
+
+  if (Archive::is_loading::value)
+    neighborSearchCache.Reset();
 }
 
 } // namespace cf
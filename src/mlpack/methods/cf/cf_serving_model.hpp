@@ -0,0 +1,220 @@
+/**
+ * @file methods/cf/cf_serving_model.hpp
+ *
+ * Definition of CFServingModel, a compact form of a trained CFType model that
+ * only keeps what is needed to predict ratings.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_CF_CF_SERVING_MODEL_HPP
+#define MLPACK_METHODS_CF_CF_SERVING_MODEL_HPP
+
+#include <mlpack/core.hpp>
+#include "cf.hpp"
+#include "decomposition_policies/bias_svd_method.hpp"
+#include "decomposition_policies/svdplusplus_method.hpp"
+
+namespace mlpack {
+namespace cf {
+
+/**
+ * CFServingModel holds a trained CFType model in a form that is meant for
+ * serving predictions: the neighborhood of each user, the interpolation
+ * weights, the biases of the decomposition and the normalization are all
+ * folded into two dense matrices, so that the predicted rating of user u for
+ * item i is simply
+ *
+ * \f[
+ * r_{ui} = \mathrm{items}_i^T \mathrm{users}_u,
+ * \f]
+ *
+ * and it is the same rating that CFType::Predict() gives with the same
+ * neighbor search and interpolation policies.  Neither the training ratings
+ * nor the neighbor search structures are kept.  The normalization is assumed
+ * to denormalize a rating r as a * r + b(user) + c(item), which is the case
+ * for all of the normalization policies in mlpack (and any combination of
+ * them).
+ *
+ * Save() writes the model as a set of Armadillo binary (.bin) files: a small
+ * header followed by the matrix in column-major order, so each file can be
+ * memory-mapped.  The user factors may be split into shards of consecutive
+ * users, and a replica may Load() only the shard that it serves.
+ *
+ * @code
+ * CFType<RegSVDPolicy> cf(data, RegSVDPolicy(), 5, 10);
+ * CFServingModel model(cf);
+ * model.Save("model", 100000);
+ *
+ * CFServingModel shard;
+ * shard.Load("model", 2); // Users 200000 to 299999.
+ * const double rating = shard.Predict(200010, 17);
+ * @endcode
+ */
+class CFServingModel
+{
+ public:
+  //! Create an empty model; Load() or Build() must be called before use.
+  CFServingModel();
+
+  /**
+   * Build the model from the given CF model, with the default neighbor search
+   * and interpolation policies of CFType.
+   *
+   * @param cf Trained CF model.
+   */
+  template<typename DecompositionPolicy, typename NormalizationType>
+  CFServingModel(const CFType<DecompositionPolicy, NormalizationType>& cf);
+
+  /**
+   * Build the model from the given CF model.  The neighborhood of every user
+   * is found once here, so the ratings predicted by the model are the ones
+   * that CFType::Predict() would give with the same policies.
+   *
+   * @tparam NeighborSearchPolicy The policy used to find the neighbors of each
+   *     user.
+   * @tparam InterpolationPolicy The policy used to calculate the
+   *     interpolation weights.
+   * @param cf Trained CF model.
+   */
+  template<typename NeighborSearchPolicy = EuclideanSearch,
+           typename InterpolationPolicy = AverageInterpolation,
+           typename DecompositionPolicy,
+           typename NormalizationType>
+  void Build(const CFType<DecompositionPolicy, NormalizationType>& cf);
+
+  /**
+   * Predict the rating of the given user for the given item.  The user must
+   * be in the loaded shard.
+   *
+   * @param user User ID.
+   * @param item Item ID.
+   */
+  double Predict(const size_t user, const size_t item) const;
+
+  /**
+   * Predict the ratings of the given user/item combinations, one per column.
+   *
+   * @param combinations User/item combinations to predict.
+   * @param predictions Vector to store the predicted ratings in.
+   */
+  void Predict(const arma::Mat<size_t>& combinations,
+               arma::vec& predictions) const;
+
+  /**
+   * Find the items with the highest predicted ratings for each of the given
+   * users.  Since the training ratings are not kept, items that a user has
+   * already rated may be recommended.
+   *
+   * @param numRecs Number of recommendations for each user.
+   * @param recommendations Matrix to store the recommendations in, one column
+   *     per user.
+   * @param queryUsers Users to get recommendations for; they must be in the
+   *     loaded shard.
+   */
+  void GetRecommendations(const size_t numRecs,
+                          arma::Mat<size_t>& recommendations,
+                          const arma::Col<size_t>& queryUsers) const;
+
+  /**
+   * Save the model in files with the given prefix: <prefix>.meta.bin,
+   * <prefix>.items.bin and one <prefix>.users.<shard>.bin for each shard of
+   * usersPerShard users.  All users of the model must be present.
+   *
+   * @param prefix Prefix of the files.
+   * @param usersPerShard Number of users in each shard (0 means one shard).
+   */
+  void Save(const std::string& prefix, const size_t usersPerShard = 0) const;
+
+  /**
+   * Load every shard of the model saved with the given prefix.
+   *
+   * @param prefix Prefix of the files.
+   */
+  void Load(const std::string& prefix);
+
+  /**
+   * Load a single shard of the model saved with the given prefix, along with
+   * the item factors.
+   *
+   * @param prefix Prefix of the files.
+   * @param shard Index of the shard to load.
+   */
+  void Load(const std::string& prefix, const size_t shard);
+
+  //! Get the number of users of the whole model.
+  size_t NumUsers() const { return numUsers; }
+  //! Get the number of items.
+  size_t NumItems() const { return items.n_cols; }
+  //! Get the first user of the loaded shard.
+  size_t FirstUser() const { return firstUser; }
+  //! Get the number of users of the loaded shard.
+  size_t NumShardUsers() const { return users.n_cols; }
+
+  //! Get the item factors, one column per item.
+  const arma::mat& Items() const { return items; }
+  //! Get the user factors of the loaded shard, one column per user.
+  const arma::mat& Users() const { return users; }
+
+ private:
+  /**
+   * Get the factors of a decomposition whose rating is W.row(item) *
+   * H.col(user): the item factors, the item biases, the user factors and the
+   * user biases.
+   */
+  template<typename DecompositionPolicy>
+  static void Factors(const DecompositionPolicy& decomposition,
+                      arma::mat& itemFactors,
+                      arma::vec& itemBias,
+                      arma::mat& userFactors,
+                      arma::vec& userBias);
+
+  //! Get the factors of a BiasSVD decomposition.
+  static void Factors(const BiasSVDPolicy& decomposition,
+                      arma::mat& itemFactors,
+                      arma::vec& itemBias,
+                      arma::mat& userFactors,
+                      arma::vec& userBias);
+
+  //! Get the factors of an SVD++ decomposition; the implicit feedback of each
+  //! user is added to its factors.
+  static void Factors(const SVDPlusPlusPolicy& decomposition,
+                      arma::mat& itemFactors,
+                      arma::vec& itemBias,
+                      arma::mat& userFactors,
+                      arma::vec& userBias);
+
+  //! Throw if the given user is not in the loaded shard.
+  void CheckUser(const size_t user) const;
+
+  //! Load the metadata and the item factors of the model with the given
+  //! prefix.
+  void LoadMetadata(const std::string& prefix,
+                    size_t& shardSize,
+                    size_t& numShards);
+
+  //! Load the user factors of the given shard, and check their size.
+  void LoadShard(const std::string& prefix,
+                 const size_t shard,
+                 const size_t shardSize,
+                 arma::mat& shardUsers) const;
+
+  //! The item factors, one column per item.
+  arma::mat items;
+  //! The user factors of the loaded shard, one column per user.
+  arma::mat users;
+  //! The first user of the loaded shard.
+  size_t firstUser;
+  //! The number of users of the whole model.
+  size_t numUsers;
+};
+
+} // namespace cf
+} // namespace mlpack
+
+// Include implementation.
+#include "cf_serving_model_impl.hpp"
+
+#endif
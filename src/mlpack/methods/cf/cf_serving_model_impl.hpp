@@ -0,0 +1,353 @@
+/**
+ * @file methods/cf/cf_serving_model_impl.hpp
+ *
+ * Implementation of CFServingModel.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_CF_CF_SERVING_MODEL_IMPL_HPP
+#define MLPACK_METHODS_CF_CF_SERVING_MODEL_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "cf_serving_model.hpp"
+
+namespace mlpack {
+namespace cf {
+
+inline CFServingModel::CFServingModel() :
+    firstUser(0),
+    numUsers(0)
+{
+  // Nothing to do.
+}
+
+template<typename DecompositionPolicy, typename NormalizationType>
+CFServingModel::CFServingModel(
+    const CFType<DecompositionPolicy, NormalizationType>& cf) :
+    firstUser(0),
+    numUsers(0)
+{
+  Build(cf);
+}
+
+template<typename NeighborSearchPolicy,
+         typename InterpolationPolicy,
+         typename DecompositionPolicy,
+         typename NormalizationType>
+void CFServingModel::Build(
+    const CFType<DecompositionPolicy, NormalizationType>& cf)
+{
+  const arma::sp_mat& cleanedData = cf.CleanedData();
+  const DecompositionPolicy& decomposition = cf.Decomposition();
+  const NormalizationType& normalization = cf.Normalization();
+  const size_t numItems = cleanedData.n_rows;
+  const size_t numNeighbors = cf.NumUsersForSimilarity();
+  numUsers = cleanedData.n_cols;
+  firstUser = 0;
+
+  arma::mat itemFactors, userFactors;
+  arma::vec itemBias, userBias;
+  Factors(decomposition, itemFactors, itemBias, userFactors, userBias);
+  const size_t rank = itemFactors.n_rows;
+
+  // Calculate the neighborhood of every user.  As in CFType::Predict(), the
+  // user is part of its own neighborhood.
+  const arma::Col<size_t> allUsers = arma::linspace<arma::Col<size_t>>(0,
+      numUsers - 1, numUsers);
+  arma::Mat<size_t> neighborhood;
+  arma::mat similarities;
+  decomposition.template GetNeighborhood<NeighborSearchPolicy>(allUsers,
+      numNeighbors, neighborhood, similarities);
+
+  // The interpolation policy may cache values while computing the weights, so
+  // this is done serially.
+  arma::mat weights(numNeighbors, numUsers);
+  InterpolationPolicy interpolation(cleanedData);
+  for (size_t i = 0; i < numUsers; ++i)
+  {
+    interpolation.GetWeights(weights.col(i), decomposition, i,
+        neighborhood.col(i), similarities.col(i), cleanedData);
+  }
+
+  // A rating r is denormalized as scale * r + b(user) + c(item), where
+  // offset = b(0) + c(0).
+  const double offset = normalization.Denormalize(0, 0, 0.0);
+  const double scale = normalization.Denormalize(0, 0, 1.0) - offset;
+
+  // The item factors end with the scaled item bias, the item part of the
+  // normalization, and a 1 for the user part of the normalization.
+  items.set_size(rank + 3, numItems);
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) numItems; ++i)
+  {
+    items.col(i).head(rank) = scale * itemFactors.col(i);
+    items(rank, i) = scale * itemBias[i];
+    items(rank + 1, i) = normalization.Denormalize(0, i, 0.0);
+    items(rank + 2, i) = 1.0;
+  }
+
+  // The user factors are the weighted sums of the factors of the neighbors;
+  // the weight of the item bias is the sum of the weights.
+  users.zeros(rank + 3, numUsers);
+  #pragma omp parallel for
+  for (omp_size_t u = 0; u < (omp_size_t) numUsers; ++u)
+  {
+    double bias = 0.0;
+    for (size_t j = 0; j < neighborhood.n_rows; ++j)
+    {
+      const size_t neighbor = neighborhood(j, u);
+      users.col(u).head(rank) += weights(j, u) * userFactors.col(neighbor);
+      users(rank, u) += weights(j, u);
+      bias += weights(j, u) * userBias[neighbor];
+    }
+    users(rank + 1, u) = 1.0;
+    users(rank + 2, u) = scale * bias + normalization.Denormalize(u, 0, 0.0) -
+        offset;
+  }
+}
+
+inline double CFServingModel::Predict(const size_t user,
+                                      const size_t item) const
+{
+  CheckUser(user);
+  if (item >= items.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "CFServingModel::Predict(): item " << item << " is not in the model "
+        << "(" << items.n_cols << " items)!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  return arma::dot(items.col(item), users.col(user - firstUser));
+}
+
+inline void CFServingModel::Predict(const arma::Mat<size_t>& combinations,
+                                    arma::vec& predictions) const
+{
+  // Check the combinations before predicting in parallel.
+  for (size_t i = 0; i < combinations.n_cols; ++i)
+  {
+    CheckUser(combinations(0, i));
+    if (combinations(1, i) >= items.n_cols)
+    {
+      std::ostringstream oss;
+      oss << "CFServingModel::Predict(): item " << combinations(1, i)
+          << " is not in the model (" << items.n_cols << " items)!";
+      throw std::invalid_argument(oss.str());
+    }
+  }
+
+  predictions.set_size(combinations.n_cols);
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) combinations.n_cols; ++i)
+  {
+    predictions[i] = arma::dot(items.col(combinations(1, i)),
+        users.col(combinations(0, i) - firstUser));
+  }
+}
+
+inline void CFServingModel::GetRecommendations(
+    const size_t numRecs,
+    arma::Mat<size_t>& recommendations,
+    const arma::Col<size_t>& queryUsers) const
+{
+  if (numRecs > items.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "CFServingModel::GetRecommendations(): cannot give " << numRecs
+        << " recommendations, since there are only " << items.n_cols
+        << " items!";
+    throw std::invalid_argument(oss.str());
+  }
+  for (size_t i = 0; i < queryUsers.n_elem; ++i)
+    CheckUser(queryUsers[i]);
+
+  recommendations.set_size(numRecs, queryUsers.n_elem);
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) queryUsers.n_elem; ++i)
+  {
+    const arma::vec ratings = items.t() * users.col(queryUsers[i] - firstUser);
+    const arma::uvec order = arma::sort_index(ratings, "descend");
+    for (size_t j = 0; j < numRecs; ++j)
+      recommendations(j, i) = order[j];
+  }
+}
+
+inline void CFServingModel::Save(const std::string& prefix,
+                                 const size_t usersPerShard) const
+{
+  if (firstUser != 0 || users.n_cols != numUsers)
+  {
+    throw std::invalid_argument("CFServingModel::Save(): only a model with "
+        "all of its users loaded can be saved!");
+  }
+
+  const size_t shardSize = (usersPerShard == 0) ?
+      std::max(numUsers, (size_t) 1) : usersPerShard;
+  const size_t numShards = (numUsers + shardSize - 1) / shardSize;
+
+  arma::Mat<size_t> metadata(4, 1);
+  metadata[0] = numUsers;
+  metadata[1] = items.n_cols;
+  metadata[2] = shardSize;
+  metadata[3] = numShards;
+  data::Save(prefix + ".meta.bin", metadata, true, false);
+  data::Save(prefix + ".items.bin", items, true, false);
+
+  for (size_t s = 0; s < numShards; ++s)
+  {
+    const size_t end = std::min((s + 1) * shardSize, numUsers);
+    const arma::mat shard = users.cols(s * shardSize, end - 1);
+    data::Save(prefix + ".users." + std::to_string(s) + ".bin", shard, true,
+        false);
+  }
+}
+
+inline void CFServingModel::Load(const std::string& prefix)
+{
+  size_t shardSize, numShards;
+  LoadMetadata(prefix, shardSize, numShards);
+
+  users.set_size(items.n_rows, numUsers);
+  arma::mat shard;
+  for (size_t s = 0; s < numShards; ++s)
+  {
+    LoadShard(prefix, s, shardSize, shard);
+    users.cols(s * shardSize, s * shardSize + shard.n_cols - 1) = shard;
+  }
+  firstUser = 0;
+}
+
+inline void CFServingModel::Load(const std::string& prefix, const size_t shard)
+{
+  size_t shardSize, numShards;
+  LoadMetadata(prefix, shardSize, numShards);
+
+  if (shard >= numShards)
+  {
+    std::ostringstream oss;
+    oss << "CFServingModel::Load(): shard " << shard << " is not in the model "
+        << "(" << numShards << " shards)!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  LoadShard(prefix, shard, shardSize, users);
+  firstUser = shard * shardSize;
+}
+
+template<typename DecompositionPolicy>
+void CFServingModel::Factors(const DecompositionPolicy& decomposition,
+                             arma::mat& itemFactors,
+                             arma::vec& itemBias,
+                             arma::mat& userFactors,
+                             arma::vec& userBias)
+{
+  itemFactors = decomposition.W().t();
+  itemBias.zeros(itemFactors.n_cols);
+  userFactors = decomposition.H();
+  userBias.zeros(userFactors.n_cols);
+}
+
+inline void CFServingModel::Factors(const BiasSVDPolicy& decomposition,
+                                    arma::mat& itemFactors,
+                                    arma::vec& itemBias,
+                                    arma::mat& userFactors,
+                                    arma::vec& userBias)
+{
+  itemFactors = decomposition.W().t();
+  itemBias = decomposition.P();
+  userFactors = decomposition.H();
+  userBias = decomposition.Q();
+}
+
+inline void CFServingModel::Factors(const SVDPlusPlusPolicy& decomposition,
+                                    arma::mat& itemFactors,
+                                    arma::vec& itemBias,
+                                    arma::mat& userFactors,
+                                    arma::vec& userBias)
+{
+  itemFactors = decomposition.W().t();
+  itemBias = decomposition.P();
+  userFactors = decomposition.H();
+  userBias = decomposition.Q();
+
+  // Add the implicit feedback of each user, as in
+  // SVDPlusPlusPolicy::GetRating().
+  const arma::sp_mat& implicitData = decomposition.ImplicitData();
+  const arma::mat& y = decomposition.Y();
+  for (size_t u = 0; u < userFactors.n_cols; ++u)
+  {
+    arma::vec implicitVec(userFactors.n_rows, arma::fill::zeros);
+    size_t implicitCount = 0;
+    for (arma::sp_mat::const_iterator it = implicitData.begin_col(u);
+         it != implicitData.end_col(u); ++it)
+    {
+      implicitVec += y.col(it.row());
+      ++implicitCount;
+    }
+    if (implicitCount != 0)
+      userFactors.col(u) += implicitVec / std::sqrt(implicitCount);
+  }
+}
+
+inline void CFServingModel::CheckUser(const size_t user) const
+{
+  if (user < firstUser || user >= firstUser + users.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "CFServingModel: user " << user << " is not in the loaded shard "
+        << "(users " << firstUser << " to " << firstUser + users.n_cols
+        << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+}
+
+inline void CFServingModel::LoadMetadata(const std::string& prefix,
+                                         size_t& shardSize,
+                                         size_t& numShards)
+{
+  arma::Mat<size_t> metadata;
+  data::Load(prefix + ".meta.bin", metadata, true, false);
+  if (metadata.n_elem != 4 || metadata[2] == 0)
+  {
+    throw std::runtime_error("CFServingModel::Load(): invalid metadata in '" +
+        prefix + ".meta.bin'!");
+  }
+
+  numUsers = metadata[0];
+  shardSize = metadata[2];
+  numShards = metadata[3];
+
+  data::Load(prefix + ".items.bin", items, true, false);
+  if (items.n_cols != metadata[1])
+  {
+    throw std::runtime_error("CFServingModel::Load(): the item factors in '" +
+        prefix + ".items.bin' do not match the metadata!");
+  }
+}
+
+inline void CFServingModel::LoadShard(const std::string& prefix,
+                                      const size_t shard,
+                                      const size_t shardSize,
+                                      arma::mat& shardUsers) const
+{
+  const std::string filename = prefix + ".users." + std::to_string(shard) +
+      ".bin";
+  data::Load(filename, shardUsers, true, false);
+
+  const size_t expectedUsers = std::min(numUsers - shard * shardSize,
+      shardSize);
+  if (shardUsers.n_rows != items.n_rows || shardUsers.n_cols != expectedUsers)
+  {
+    throw std::runtime_error("CFServingModel::Load(): the user factors in '" +
+        filename + "' do not match the metadata!");
+  }
+}
+
+} // namespace cf
+} // namespace mlpack
+
+#endif
@@ -136,6 +136,14 @@ class BiasSVDPolicy
         query, numUsersForSimilarity, neighborhood, similarities);
   }
 
+  /**
+   * Get the vectors of the users that GetNeighborhood() searches: the columns
+   * of H.
+   *
+   * @param referenceSet Matrix to store the vectors of the users into.
+   */
+  void NeighborSearchSet(arma::mat& referenceSet) const { referenceSet = h; }
+
   //! Get the Item Matrix.
   const arma::mat& W() const { return w; }
   //! Get the User Matrix.
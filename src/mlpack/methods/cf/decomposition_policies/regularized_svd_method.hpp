@@ -125,8 +125,8 @@ class RegSVDPolicy
     // matrix with the Mahalanobis distance where M^{-1} = W^T W.  So, we'll
     // decompose M^{-1} = L L^T (the Cholesky decomposition), and then multiply
     // H by L^T. Then we can perform nearest neighbor search.
-    arma::mat l = arma::chol(w.t() * w);
-    arma::mat stretchedH = l * h; // Due to the Armadillo API, l is L^T.
+    arma::mat stretchedH;
+    NeighborSearchSet(stretchedH);
 
     // Temporarily store feature vector of queried users.
     arma::mat query(stretchedH.n_rows, users.n_elem);
@@ -139,6 +139,19 @@ class RegSVDPolicy
         query, numUsersForSimilarity, neighborhood, similarities);
   }
 
+  /**
+   * Get the vectors of the users that GetNeighborhood() searches: the columns
+   * of H multiplied by L^T, where W^T W = L L^T, so that the Euclidean
+   * distances between them are the distances between the ratings of the users.
+   *
+   * @param referenceSet Matrix to store the vectors of the users into.
+   */
+  void NeighborSearchSet(arma::mat& referenceSet) const
+  {
+    arma::mat l = arma::chol(w.t() * w);
+    referenceSet = l * h; // Due to the Armadillo API, l is L^T.
+  }
+
   //! Get the Item Matrix.
   const arma::mat& W() const { return w; }
   //! Get the User Matrix.
@@ -0,0 +1,259 @@
+/**
+ * @file methods/cf/decomposition_policies/weighted_als_method.hpp
+ *
+ * Implementation of the weighted alternating least squares method for use in
+ * the Collaborative Filtering.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+
+#ifndef MLPACK_METHODS_CF_DECOMPOSITION_POLICIES_WEIGHTED_ALS_METHOD_HPP
+#define MLPACK_METHODS_CF_DECOMPOSITION_POLICIES_WEIGHTED_ALS_METHOD_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/methods/amf/amf.hpp>
+#include <mlpack/methods/amf/update_rules/weighted_als.hpp>
+#include <mlpack/methods/amf/termination_policies/max_iteration_termination.hpp>
+#include <mlpack/methods/amf/termination_policies/simple_residue_termination.hpp>
+
+namespace mlpack {
+namespace cf {
+
+/**
+ * Implementation of the weighted alternating least squares policy to act as a
+ * wrapper when accessing amf::WeightedALSUpdate from within CFType.  The
+ * factorization only visits the nonzero entries of the rating matrix, and the
+ * least squares problems of the users and of the items are solved in
+ * parallel.
+ *
+ * An example of how to use WeightedALSPolicy in CF is shown below:
+ *
+ * @code
+ * extern arma::mat data; // data is a (user, item, rating) table.
+ * // Users for whom recommendations are generated.
+ * extern arma::Col<size_t> users;
+ * arma::Mat<size_t> recommendations; // Resulting recommendations.
+ *
+ * // Use a regularization of 0.05 for explicit ratings.
+ * WeightedALSPolicy decomposition(0.05);
+ * CFType<WeightedALSPolicy> cf(data, decomposition);
+ *
+ * // Generate 10 recommendations for all users.
+ * cf.GetRecommendations(10, recommendations);
+ * @endcode
+ */
+class WeightedALSPolicy
+{
+ public:
+  /**
+   * Create the policy with the given parameters of the update rule.
+   *
+   * @param lambda Regularization parameter.
+   * @param implicit Whether the ratings are implicit feedback.
+   * @param alpha Confidence of the nonzero ratings, for implicit feedback.
+   */
+  WeightedALSPolicy(const double lambda = 0.1,
+                    const bool implicit = false,
+                    const double alpha = 40.0) :
+      lambda(lambda),
+      implicit(implicit),
+      alpha(alpha)
+  {
+    /* Nothing to do here */
+  }
+
+  /**
+   * Apply Collaborative Filtering to the provided data set using weighted
+   * alternating least squares.
+   *
+   * @param * (data) Data matrix: dense matrix (coordinate lists)
+   *    or sparse matrix(cleaned).
+   * @param cleanedData item user table in form of sparse matrix.
+   * @param rank Rank parameter for matrix factorization.
+   * @param maxIterations Maximum number of iterations.
+   * @param minResidue Residue required to terminate.
+   * @param mit Whether to terminate only when maxIterations is reached.
+   */
+  template<typename MatType>
+  void Apply(const MatType& /* data */,
+             const arma::sp_mat& cleanedData,
+             const size_t rank,
+             const size_t maxIterations,
+             const double minResidue,
+             const bool mit)
+  {
+    amf::WeightedALSUpdate update(lambda, implicit, alpha);
+    if (mit)
+    {
+      amf::MaxIterationTermination iter(maxIterations);
+      amf::AMF<amf::MaxIterationTermination, amf::RandomInitialization,
+          amf::WeightedALSUpdate> als(iter, amf::RandomInitialization(),
+          update);
+
+      als.Apply(cleanedData, rank, w, h);
+    }
+    else
+    {
+      amf::SimpleResidueTermination srt(minResidue, maxIterations);
+      amf::AMF<amf::SimpleResidueTermination, amf::RandomInitialization,
+          amf::WeightedALSUpdate> als(srt, amf::RandomInitialization(),
+          update);
+
+      als.Apply(cleanedData, rank, w, h);
+    }
+  }
+
+  /**
+   * Return predicted rating given user ID and item ID.
+   *
+   * @param user User ID.
+   * @param item Item ID.
+   */
+  double GetRating(const size_t user, const size_t item) const
+  {
+    double rating = arma::as_scalar(w.row(item) * h.col(user));
+    return rating;
+  }
+
+  /**
+   * Get predicted ratings for a user.
+   *
+   * @param user User ID.
+   * @param rating Resulting rating vector.
+   */
+  void GetRatingOfUser(const size_t user, arma::vec& rating) const
+  {
+    rating = w * h.col(user);
+  }
+
+  /**
+   * Get the neighborhood and corresponding similarities for a set of users.
+   *
+   * @tparam NeighborSearchPolicy The policy to perform neighbor search.
+   *
+   * @param users Users whose neighborhood is to be computed.
+   * @param numUsersForSimilarity The number of neighbors returned for
+   *     each user.
+   * @param neighborhood Neighbors represented by user IDs.
+   * @param similarities Similarity between each user and each of its
+   *     neighbors.
+   */
+  template<typename NeighborSearchPolicy>
+  void GetNeighborhood(const arma::Col<size_t>& users,
+                       const size_t numUsersForSimilarity,
+                       arma::Mat<size_t>& neighborhood,
+                       arma::mat& similarities) const
+  {
+    // We want to avoid calculating the full rating matrix, so we will do
+    // nearest neighbor search only on the H matrix, using the observation that
+    // if the rating matrix X = W*H, then d(X.col(i), X.col(j)) = d(W H.col(i),
+    // W H.col(j)).  This can be seen as nearest neighbor search on the H
+    // matrix with the Mahalanobis distance where M^{-1} = W^T W.  So, we'll
+    // decompose M^{-1} = L L^T (the Cholesky decomposition), and then multiply
+    // H by L^T. Then we can perform nearest neighbor search.
+    arma::mat stretchedH;
+    NeighborSearchSet(stretchedH);
+
+    // Temporarily store feature vector of queried users.
+    arma::mat query(stretchedH.n_rows, users.n_elem);
+    // Select feature vectors of queried users.
+    for (size_t i = 0; i < users.n_elem; i++)
+      query.col(i) = stretchedH.col(users(i));
+
+    NeighborSearchPolicy neighborSearch(stretchedH);
+    neighborSearch.Search(
+        query, numUsersForSimilarity, neighborhood, similarities);
+  }
+
+  /**
+   * Compute the factors of the given users from their ratings, keeping the
+   * item matrix fixed, without refactorizing the whole rating matrix.  Each
+   * column of H is the solution of the same regularized least squares problem
+   * as in training, and the columns are solved in parallel.  Users beyond the
+   * current number of columns of H are appended; users that are neither given
+   * nor known get zero factors.
+   *
+   * @param ratings Normalized ratings, one row per item and one column per
+   *     given user.
+   * @param users User ID of each column of the ratings.
+   */
+  void FoldIn(const arma::sp_mat& ratings, const arma::Col<size_t>& users)
+  {
+    amf::WeightedALSUpdate update(lambda, implicit, alpha);
+    arma::mat userFactors;
+    update.Solve(ratings, w, userFactors);
+
+    const size_t numUsers = (users.n_elem == 0) ? 0 : users.max() + 1;
+    if (numUsers > h.n_cols)
+      h.resize(h.n_rows, numUsers);
+
+    for (size_t i = 0; i < users.n_elem; ++i)
+      h.col(users[i]) = userFactors.col(i);
+  }
+
+  /**
+   * Get the vectors of the users that GetNeighborhood() searches: the columns
+   * of H multiplied by L^T, where W^T W = L L^T, so that the Euclidean
+   * distances between them are the distances between the ratings of the users.
+   *
+   * @param referenceSet Matrix to store the vectors of the users into.
+   */
+  void NeighborSearchSet(arma::mat& referenceSet) const
+  {
+    arma::mat l = arma::chol(w.t() * w);
+    referenceSet = l * h; // Due to the Armadillo API, l is L^T.
+  }
+
+  //! Get the Item Matrix.
+  const arma::mat& W() const { return w; }
+  //! Get the User Matrix.
+  const arma::mat& H() const { return h; }
+
+  //! Get the regularization parameter.
+  double Lambda() const { return lambda; }
+  //! Modify the regularization parameter.
+  double& Lambda() { return lambda; }
+
+  //! Get whether the ratings are implicit feedback.
+  bool Implicit() const { return implicit; }
+  //! Modify whether the ratings are implicit feedback.
+  bool& Implicit() { return implicit; }
+
+  //! Get the confidence of nonzero ratings for implicit feedback.
+  double Alpha() const { return alpha; }
+  //! Modify the confidence of nonzero ratings for implicit feedback.
+  double& Alpha() { return alpha; }
+
+  /**
+   * Serialization.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(lambda);
+    ar & BOOST_SERIALIZATION_NVP(implicit);
+    ar & BOOST_SERIALIZATION_NVP(alpha);
+    ar & BOOST_SERIALIZATION_NVP(w);
+    ar & BOOST_SERIALIZATION_NVP(h);
+  }
+
+ private:
+  //! Regularization parameter.
+  double lambda;
+  //! Whether the ratings are implicit feedback.
+  bool implicit;
+  //! Confidence of nonzero ratings for implicit feedback.
+  double alpha;
+  //! Item matrix.
+  arma::mat w;
+  //! User matrix.
+  arma::mat h;
+};
+
+} // namespace cf
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,166 @@
+/**
+ * @file methods/cf/neighbor_search_cache.hpp
+ *
+ * Definition of the NeighborSearchCache class, which keeps the neighbor search
+ * object of a trained CF model between queries.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_CF_NEIGHBOR_SEARCH_CACHE_HPP
+#define MLPACK_METHODS_CF_NEIGHBOR_SEARCH_CACHE_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/sfinae_utility.hpp>
+
+namespace mlpack {
+namespace cf {
+
+HAS_MEM_FUNC(NeighborSearchSet, HasNeighborSearchSetCheck);
+
+/**
+ * 'value' is true if the DecompositionPolicy class has a member
+ * void NeighborSearchSet(arma::mat& referenceSet) const.
+ */
+template<typename DecompositionPolicy>
+struct HasNeighborSearchSet
+{
+  static const bool value = HasNeighborSearchSetCheck<DecompositionPolicy,
+      void(DecompositionPolicy::*)(arma::mat&) const>::value;
+};
+
+/**
+ * The neighborhood of a user is found by a neighbor search among the vectors
+ * of all the users given by the decomposition.  Building that search (for
+ * instance, normalizing the vectors for CosineSearch and PearsonSearch and
+ * building the tree) costs far more than searching for the neighbors of a
+ * small batch of users, and it only depends on the trained model.  So this
+ * class keeps the vectors of the users and the NeighborSearchPolicy object
+ * built on them between queries, until Reset() is called (CFType calls it
+ * whenever the model changes).
+ *
+ * Only one NeighborSearchPolicy is kept at a time: a query with another
+ * NeighborSearchPolicy replaces it.  Decomposition policies that don't provide
+ * NeighborSearchSet() fall back to their own GetNeighborhood(), without
+ * caching.  A copy of the cache is empty.
+ */
+class NeighborSearchCache
+{
+ public:
+  //! Create an empty cache.
+  NeighborSearchCache() { }
+
+  //! Create an empty cache; the cache of the other object is not copied.
+  NeighborSearchCache(const NeighborSearchCache& /* other */) { }
+
+  //! Take the cache of the other object.
+  NeighborSearchCache(NeighborSearchCache&& other) :
+      cache(std::move(other.cache)) { }
+
+  //! Empty the cache; the cache of the other object is not copied.
+  NeighborSearchCache& operator=(const NeighborSearchCache& /* other */)
+  {
+    Reset();
+    return *this;
+  }
+
+  //! Take the cache of the other object.
+  NeighborSearchCache& operator=(NeighborSearchCache&& other)
+  {
+    cache = std::move(other.cache);
+    return *this;
+  }
+
+  //! Empty the cache, because the model changed.
+  void Reset() { cache.reset(); }
+
+  /**
+   * Find the neighborhood of the given users, building the neighbor search
+   * only if it isn't cached yet.
+   *
+   * @param decomposition The trained decomposition.
+   * @param users Users whose neighborhood is to be computed.
+   * @param numUsersForSimilarity The number of neighbors of each user.
+   * @param neighborhood Neighbors represented by user IDs.
+   * @param similarities Similarity between each user and each of its
+   *     neighbors.
+   */
+  template<typename NeighborSearchPolicy, typename DecompositionPolicy>
+  void GetNeighborhood(
+      const DecompositionPolicy& decomposition,
+      const arma::Col<size_t>& users,
+      const size_t numUsersForSimilarity,
+      arma::Mat<size_t>& neighborhood,
+      arma::mat& similarities,
+      const typename std::enable_if_t<
+          HasNeighborSearchSet<DecompositionPolicy>::value>* = 0)
+  {
+    Holder<NeighborSearchPolicy>* holder =
+        dynamic_cast<Holder<NeighborSearchPolicy>*>(cache.get());
+    if (!holder)
+    {
+      arma::mat referenceSet;
+      decomposition.NeighborSearchSet(referenceSet);
+      holder = new Holder<NeighborSearchPolicy>(std::move(referenceSet));
+      cache.reset(holder);
+    }
+
+    const arma::mat& referenceSet = holder->referenceSet;
+    arma::mat query(referenceSet.n_rows, users.n_elem);
+    for (size_t i = 0; i < users.n_elem; i++)
+      query.col(i) = referenceSet.col(users(i));
+
+    holder->neighborSearch.Search(query, numUsersForSimilarity, neighborhood,
+        similarities);
+  }
+
+  /**
+   * Find the neighborhood of the given users with the GetNeighborhood() method
+   * of the decomposition, which doesn't provide NeighborSearchSet().
+   */
+  template<typename NeighborSearchPolicy, typename DecompositionPolicy>
+  void GetNeighborhood(
+      const DecompositionPolicy& decomposition,
+      const arma::Col<size_t>& users,
+      const size_t numUsersForSimilarity,
+      arma::Mat<size_t>& neighborhood,
+      arma::mat& similarities,
+      const typename std::enable_if_t<
+          !HasNeighborSearchSet<DecompositionPolicy>::value>* = 0)
+  {
+    decomposition.template GetNeighborhood<NeighborSearchPolicy>(users,
+        numUsersForSimilarity, neighborhood, similarities);
+  }
+
+ private:
+  //! Base class of the cached objects, so that any type can be held.
+  struct HolderBase
+  {
+    virtual ~HolderBase() { }
+  };
+
+  //! The vectors of the users and the neighbor search built on them.
+  template<typename NeighborSearchPolicy>
+  struct Holder : public HolderBase
+  {
+    Holder(arma::mat&& referenceSet) :
+        referenceSet(std::move(referenceSet)),
+        neighborSearch(this->referenceSet)
+    { }
+
+    //! The vectors of the users.
+    arma::mat referenceSet;
+    //! The neighbor search built on the vectors of the users.
+    NeighborSearchPolicy neighborSearch;
+  };
+
+  //! The cached object, if any.
+  std::unique_ptr<HolderBase> cache;
+};
+
+} // namespace cf
+} // namespace mlpack
+
+#endif
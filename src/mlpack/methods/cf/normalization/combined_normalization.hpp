@@ -60,6 +60,18 @@ class CombinedNormalization
     SequenceNormalize<0>(data);
   }
 
+  /**
+   * Normalize the ratings of users folded into the model by calling FoldIn()
+   * in each normalization object, in the same order as Normalize().
+   *
+   * @param ratings Ratings of the users, one column per user.
+   * @param users User ID of each column.
+   */
+  void FoldIn(arma::sp_mat& ratings, const arma::Col<size_t>& users)
+  {
+    SequenceFoldIn<0>(ratings, users);
+  }
+
   /**
    * Denormalize rating by calling Denormalize() in each normalization object.
    * Note that the order of objects calling Denormalize() should be the
@@ -130,6 +142,24 @@ class CombinedNormalization
       typename = void>
   void SequenceNormalize(MatType& /* data */) { }
 
+  //! Unpack normalizations tuple to normalize folded-in ratings.
+  template<
+      int I, /* Which normalization in tuple to use */
+      typename = std::enable_if_t<(I < std::tuple_size<TupleType>::value)>>
+  void SequenceFoldIn(arma::sp_mat& ratings, const arma::Col<size_t>& users)
+  {
+    std::get<I>(normalizations).FoldIn(ratings, users);
+    SequenceFoldIn<I + 1>(ratings, users);
+  }
+
+  //! End of tuple unpacking.
+  template<
+      int I, /* Which normalization in tuple to use */
+      typename = std::enable_if_t<(I >= std::tuple_size<TupleType>::value)>,
+      typename = void>
+  void SequenceFoldIn(arma::sp_mat& /* ratings */,
+                      const arma::Col<size_t>& /* users */) { }
+
   //! Unpack normalizations tuple to denormalize.
   template<
       int I, /* Which normalization in tuple to use */
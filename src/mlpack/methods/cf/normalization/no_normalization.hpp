@@ -36,6 +36,15 @@ class NoNormalization
   template<typename MatType>
   inline void Normalize(const MatType& /* data */) const { }
 
+  /**
+   * Do nothing.
+   *
+   * @param * (ratings) Ratings of the users folded into the model.
+   * @param * (users) User ID of each column.
+   */
+  inline void FoldIn(const arma::sp_mat& /* ratings */,
+                     const arma::Col<size_t>& /* users */) const { }
+
   /**
    * Do nothing.
    *
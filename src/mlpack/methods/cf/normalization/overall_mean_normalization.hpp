@@ -93,6 +93,28 @@ class OverallMeanNormalization
     }
   }
 
+  /**
+   * Normalize the ratings of users folded into the model, by subtracting the
+   * mean of the training data.
+   *
+   * @param ratings Ratings of the users, one column per user.
+   * @param * (users) User ID of each column.
+   */
+  void FoldIn(arma::sp_mat& ratings, const arma::Col<size_t>& /* users */)
+  {
+    for (arma::sp_mat::iterator it = ratings.begin(); it != ratings.end(); ++it)
+    {
+      double tmp = *it - mean;
+
+      // The algorithm omits rating of zero. If normalized rating equals zero,
+      // it is set to the smallest positive float value.
+      if (tmp == 0)
+        tmp = std::numeric_limits<float>::min();
+
+      *it = tmp;
+    }
+  }
+
   /**
    * Denormalize computed rating by adding mean.
    *
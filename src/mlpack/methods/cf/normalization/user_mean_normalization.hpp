@@ -120,6 +120,45 @@ class UserMeanNormalization
     }
   }
 
+  /**
+   * Normalize the ratings of users folded into the model, by subtracting the
+   * mean of the ratings of each user.  The means of the given users are
+   * replaced (or added, for new users).
+   *
+   * @param ratings Ratings of the users, one column per user.
+   * @param users User ID of each column.
+   */
+  void FoldIn(arma::sp_mat& ratings, const arma::Col<size_t>& users)
+  {
+    if (users.n_elem > 0 && users.max() >= userMean.n_elem)
+      userMean.resize(users.max() + 1);
+
+    for (size_t i = 0; i < users.n_elem; ++i)
+    {
+      double sum = 0.0;
+      size_t count = 0;
+      for (arma::sp_mat::const_iterator it = ratings.begin_col(i);
+           it != ratings.end_col(i); ++it)
+      {
+        sum += *it;
+        ++count;
+      }
+      userMean(users[i]) = (count == 0) ? 0.0 : sum / count;
+    }
+
+    for (arma::sp_mat::iterator it = ratings.begin(); it != ratings.end(); ++it)
+    {
+      double tmp = *it - userMean(users[it.col()]);
+
+      // The algorithm omits rating of zero. If normalized rating equals zero,
+      // it is set to the smallest positive float value.
+      if (tmp == 0)
+        tmp = std::numeric_limits<float>::min();
+
+      *it = tmp;
+    }
+  }
+
   /**
    * Denormalize computed rating by adding user mean.
    *
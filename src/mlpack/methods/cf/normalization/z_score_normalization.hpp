@@ -105,6 +105,28 @@ class ZScoreNormalization
     }
   }
 
+  /**
+   * Normalize the ratings of users folded into the model, with the mean and
+   * standard deviation of the training data.
+   *
+   * @param ratings Ratings of the users, one column per user.
+   * @param * (users) User ID of each column.
+   */
+  void FoldIn(arma::sp_mat& ratings, const arma::Col<size_t>& /* users */)
+  {
+    for (arma::sp_mat::iterator it = ratings.begin(); it != ratings.end(); ++it)
+    {
+      double tmp = (*it - mean) / stddev;
+
+      // The algorithm omits rating of zero. If normalized rating equals zero,
+      // it is set to the smallest positive float value.
+      if (tmp == 0)
+        tmp = std::numeric_limits<float>::min();
+
+      *it = tmp;
+    }
+  }
+
   /**
    * Denormalize computed rating by adding mean and multiplying stddev.
    *
@@ -15,7 +15,7 @@
 
 #include <mlpack/core.hpp>
 #include <mlpack/methods/range_search/range_search.hpp>
-#include <mlpack/methods/emst/union_find.hpp>
+#include <mlpack/methods/emst/concurrent_union_find.hpp>
 #include "random_point_selection.hpp"
 #include "ordered_point_selection.hpp"
 #include <boost/dynamic_bitset.hpp>
@@ -44,6 +44,17 @@ namespace dbscan {
  * range search technique used and the point selection strategy by means of
  * template parameters.
  *
+ * A point is a core point if at least minPoints points (including itself) are
+ * within epsilon of it.  Core points within epsilon of each other are in the
+ * same cluster; each other point is in the cluster of the closest core point
+ * within epsilon of it, or is noise if there is none.  The core points are
+ * found first by counting the points within epsilon of each point, which stops
+ * at minPoints.  Then the points are searched in blocks of a fixed size, so
+ * that only the neighbors of one block are held in memory at once, and the
+ * range searches and unions of each block are done in parallel with OpenMP
+ * (the searches only when the tree is not modified by searching, i.e. not for
+ * the cover tree, and not in naive mode).
+ *
  * @tparam RangeSearchType Class to use for range searching.
  * @tparam PointSelectionPolicy Strategy for selecting next point to cluster
  *      with.
@@ -58,19 +69,23 @@ class DBSCAN
    * parameter should be set to false in the case where RAM issues will be
    * encountered (i.e. if the dataset is very large or if epsilon is large).
    * When batchMode is false, each point will be searched iteratively, which
-   * could be slower but will use less memory.
+   * could be slower but will use less memory.  In either case, at most
+   * blockSize points are searched before their neighbors are processed.
    *
    * @param epsilon Size of range query.
    * @param minPoints Minimum number of points for each cluster.
    * @param batchMode If true, all points are searched in batch.
    * @param rangeSearch Optional instantiated RangeSearch object.
    * @param pointSelector OptionL instantiated PointSelectionPolicy object.
+   * @param blockSize Number of points to search before processing their
+   *     neighbors.
    */
   DBSCAN(const double epsilon,
          const size_t minPoints,
          const bool batchMode = true,
          RangeSearchType rangeSearch = RangeSearchType(),
-         PointSelectionPolicy pointSelector = PointSelectionPolicy());
+         PointSelectionPolicy pointSelector = PointSelectionPolicy(),
+         const size_t blockSize = 10000);
 
   /**
    * Performs DBSCAN clustering on the data, returning number of clusters
@@ -129,32 +144,69 @@ class DBSCAN
   //! Instantiated point selection policy.
   PointSelectionPolicy pointSelector;
 
+  //! Number of points searched at once.
+  size_t blockSize;
+
   /**
-   * Performs DBSCAN clustering on the data, returning the number of clusters and
-   * also the list of cluster assignments.  This searches each point iteratively,
-   * and can save on RAM usage.  It may be slower than the batch search with a
-   * dual-tree algorithm.
+   * Cluster the given points block by block.  The points are identified by
+   * their index in the given matrix, which is that of the range search results;
+   * oldFromNew maps these to the indices of the original dataset (or is empty
+   * if they are the same).  The clusters are numbered in the order in which the
+   * point selection policy reaches them.
    *
-   * @param data Dataset to cluster.
-   * @param assignments Assignments for each point.
-   * @param uf UnionFind structure that will be modified.
+   * @param data Points to cluster, in the order of the range search results.
+   * @param oldFromNew Mapping to the indices of the original dataset.
+   * @param parallelSearch Whether to search with one RangeSearch object per
+   *     thread, sharing the reference tree of rangeSearch.
+   * @param assignments Vector to store cluster assignments.
+   * @return The number of clusters.
    */
   template<typename MatType>
-  void PointwiseCluster(const MatType& data,
-                        emst::UnionFind& uf);
+  size_t BlockCluster(const MatType& data,
+                      const std::vector<size_t>& oldFromNew,
+                      const bool parallelSearch,
+                      arma::Row<size_t>& assignments);
 
   /**
-   * Performs DBSCAN clustering on the data, returning number of clusters
-   * and also the list of cluster assignments.  This can perform search in batch,
-   * so it is well suited for dual-tree or naive search.
+   * Find the core points, that is, the points with at least minPoints points
+   * (including themselves) within epsilon.  The points are counted with
+   * RangeSearch::Count(), which stops for each point once minPoints points are
+   * found, and are split into chunks like in SearchBlock().
    *
-   * @param data Dataset to cluster.
-   * @param assignments Assignments for each point.
-   * @param uf UnionFind structure that will be modified.
+   * @param data Points to cluster, in the order of the range search results.
+   * @param parallelSearch Whether to search with one RangeSearch object per
+   *     thread.
+   * @param core Will hold whether each point is a core point.
+   */
+  template<typename MatType>
+  void FindCorePoints(const MatType& data,
+                      const bool parallelSearch,
+                      std::vector<char>& core);
+
+  /**
+   * Find the neighbors within epsilon of the points in the given block.  In
+   * batch mode, the points are searched together, in a few chunks per thread;
+   * otherwise, each point is searched by itself.
+   *
+   * @param data Points to cluster, in the order of the range search results.
+   * @param begin Index of the first point of the block.
+   * @param end Index after the last point of the block.
+   * @param parallelSearch Whether to search with one RangeSearch object per
+   *     thread.
+   * @param neighbors Will hold the neighbors of each point.
+   * @param distances Will hold the distances to the neighbors of each point.
    */
   template<typename MatType>
-  void BatchCluster(const MatType& data,
-                    emst::UnionFind& uf);
+  void SearchBlock(const MatType& data,
+                   const size_t begin,
+                   const size_t end,
+                   const bool parallelSearch,
+                   std::vector<std::vector<size_t>>& neighbors,
+                   std::vector<std::vector<double>>& distances);
+
+  //! Get the number of chunks to search the given number of points in: a few
+  //! per thread in batch mode, and one per point otherwise.
+  size_t NumChunks(const size_t numPoints, const bool parallelSearch) const;
 };
 
 } // namespace dbscan
@@ -26,12 +26,14 @@ DBSCAN<RangeSearchType, PointSelectionPolicy>::DBSCAN(
     const size_t minPoints,
     const bool batchMode,
     RangeSearchType rangeSearch,
-    PointSelectionPolicy pointSelector) :
+    PointSelectionPolicy pointSelector,
+    const size_t blockSize) :
     epsilon(epsilon),
     minPoints(minPoints),
     batchMode(batchMode),
     rangeSearch(rangeSearch),
-    pointSelector(pointSelector)
+    pointSelector(pointSelector),
+    blockSize(blockSize)
 {
   // Nothing to do.
 }
@@ -100,40 +102,134 @@ size_t DBSCAN<RangeSearchType, PointSelectionPolicy>::Cluster(
     const MatType& data,
     arma::Row<size_t>& assignments)
 {
-  // Initialize the UnionFind object.
-  emst::UnionFind uf(data.n_cols);
   rangeSearch.Train(data);
 
-  if (batchMode)
-    BatchCluster(data, uf);
-  else
-    PointwiseCluster(data, uf);
+  // If searching does not modify the reference tree, each thread can search
+  // with its own RangeSearch object built on that tree.  Those objects do not
+  // map the results back to the original indices, so in that case we cluster
+  // the points of the tree, in the order of the tree.
+  typedef typename RangeSearchType::Tree Tree;
+  if (!rangeSearch.Naive() && !tree::TreeTraits<Tree>::FirstPointIsCentroid)
+  {
+    const std::vector<size_t> noMapping;
+    return BlockCluster(rangeSearch.ReferenceSet(),
+        tree::TreeTraits<Tree>::RearrangesDataset ?
+        rangeSearch.OldFromNewReferences() : noMapping, true, assignments);
+  }
 
-  // Now set assignments.
-  assignments.set_size(data.n_cols);
-  for (size_t i = 0; i < data.n_cols; ++i)
-    assignments[i] = uf.Find(i);
+  return BlockCluster(data, std::vector<size_t>(), false, assignments);
+}
+
+/**
+ * Cluster the points block by block: first find the core points, then unite
+ * the core points of each block with the core points in their neighborhood.
+ */
+template<typename RangeSearchType, typename PointSelectionPolicy>
+template<typename MatType>
+size_t DBSCAN<RangeSearchType, PointSelectionPolicy>::BlockCluster(
+    const MatType& data,
+    const std::vector<size_t>& oldFromNew,
+    const bool parallelSearch,
+    arma::Row<size_t>& assignments)
+{
+  const size_t n = data.n_cols;
 
-  // Get a count of all clusters.
-  const size_t numClusters = arma::max(assignments) + 1;
-  arma::Col<size_t> counts(numClusters, arma::fill::zeros);
-  for (size_t i = 0; i < assignments.n_elem; ++i)
-    counts[assignments[i]]++;
+  // Whether each point is a core point.  The search for each point stops once
+  // minPoints points are found, so this is cheap even in dense regions.
+  std::vector<char> core(n, 0);
+  FindCorePoints(data, parallelSearch, core);
 
-  // Now assign clusters to new indices.
-  size_t currentCluster = 0;
-  arma::Col<size_t> newAssignments(numClusters);
-  for (size_t i = 0; i < counts.n_elem; ++i)
+  // The components of the core points.
+  emst::ConcurrentUnionFind uf(n);
+  // The closest core point in the neighborhood of each non-core point.
+  arma::Col<size_t> closestCore(n);
+  closestCore.fill(SIZE_MAX);
+
+  for (size_t begin = 0; begin < n; begin += blockSize)
   {
-    if (counts[i] >= minPoints)
-      newAssignments[i] = currentCluster++;
-    else
-      newAssignments[i] = SIZE_MAX;
+    const size_t end = std::min(begin + blockSize, n);
+    if (begin > 0)
+      Log::Info << "DBSCAN clustering on point " << begin << "..." << std::endl;
+
+    // Only the neighbors of the points in this block are held at once.
+    std::vector<std::vector<size_t>> neighbors;
+    std::vector<std::vector<double>> distances;
+    SearchBlock(data, begin, end, parallelSearch, neighbors, distances);
+
+    // Unite each core point with the core points in its neighborhood that
+    // come before it; the others will unite with it when they are reached.
+    // For each other point, find the closest core point in its neighborhood,
+    // breaking ties by the original index so that the result does not depend
+    // on the order of the points in the tree.
+    #pragma omp parallel for schedule(dynamic)
+    for (omp_size_t i = 0; i < (omp_size_t) (end - begin); ++i)
+    {
+      const size_t index = begin + i;
+      if (core[index])
+      {
+        for (size_t j = 0; j < neighbors[i].size(); ++j)
+        {
+          const size_t neighbor = neighbors[i][j];
+          if (neighbor < index && core[neighbor])
+            uf.Union(index, neighbor);
+        }
+
+        continue;
+      }
+
+      double bestDistance = DBL_MAX;
+      size_t bestOriginal = SIZE_MAX;
+      for (size_t j = 0; j < neighbors[i].size(); ++j)
+      {
+        const size_t neighbor = neighbors[i][j];
+        if (!core[neighbor])
+          continue;
+
+        const double distance = distances[i][j];
+        const size_t original = oldFromNew.empty() ? neighbor :
+            oldFromNew[neighbor];
+        if (distance < bestDistance ||
+            (distance == bestDistance && original < bestOriginal))
+        {
+          bestDistance = distance;
+          bestOriginal = original;
+          closestCore[index] = neighbor;
+        }
+      }
+    }
   }
 
-  // Now reassign.
-  for (size_t i = 0; i < assignments.n_elem; ++i)
-    assignments[i] = newAssignments[assignments[i]];
+  std::vector<size_t> newFromOld;
+  if (!oldFromNew.empty())
+  {
+    newFromOld.resize(n);
+    for (size_t i = 0; i < n; ++i)
+      newFromOld[oldFromNew[i]] = i;
+  }
+
+  // Now set assignments, numbering the clusters in the order in which the
+  // point selection policy reaches them.  Points that are not core points and
+  // have no core point in their neighborhood are noise.
+  assignments.set_size(n);
+  arma::Col<size_t> clusterIndices(n);
+  clusterIndices.fill(SIZE_MAX);
+  size_t currentCluster = 0;
+  for (size_t i = 0; i < n; ++i)
+  {
+    const size_t original = pointSelector.Select(i, data);
+    const size_t index = newFromOld.empty() ? original : newFromOld[original];
+    const size_t corePoint = core[index] ? index : closestCore[index];
+    if (corePoint == SIZE_MAX)
+    {
+      assignments[original] = SIZE_MAX;
+      continue;
+    }
+
+    const size_t component = uf.Find(corePoint);
+    if (clusterIndices[component] == SIZE_MAX)
+      clusterIndices[component] = currentCluster++;
+    assignments[original] = clusterIndices[component];
+  }
 
   Log::Info << currentCluster << " clusters found." << std::endl;
 
@@ -141,64 +237,120 @@ size_t DBSCAN<RangeSearchType, PointSelectionPolicy>::Cluster(
 }
 
 /**
- * Performs DBSCAN clustering on the data, returning the number of clusters and
- * also the list of cluster assignments.  This searches each point iteratively,
- * and can save on RAM usage.  It may be slower than the batch search with a
- * dual-tree algorithm.
+ * Find the points that have at least minPoints points within epsilon.
  */
 template<typename RangeSearchType, typename PointSelectionPolicy>
 template<typename MatType>
-void DBSCAN<RangeSearchType, PointSelectionPolicy>::PointwiseCluster(
+void DBSCAN<RangeSearchType, PointSelectionPolicy>::FindCorePoints(
     const MatType& data,
-    emst::UnionFind& uf)
+    const bool parallelSearch,
+    std::vector<char>& core)
 {
-  std::vector<std::vector<size_t>> neighbors;
-  std::vector<std::vector<double>> distances;
+  if (data.n_cols == 0)
+    return;
 
-  for (size_t i = 0; i < data.n_cols; ++i)
+  const size_t numChunks = NumChunks(data.n_cols, parallelSearch);
+  const size_t chunkSize = (data.n_cols + numChunks - 1) / numChunks;
+
+  #pragma omp parallel if(parallelSearch)
   {
-    if (i % 10000 == 0 && i > 0)
-      Log::Info << "DBSCAN clustering on point " << i << "..." << std::endl;
+    RangeSearchType* search = parallelSearch ? new RangeSearchType(
+        rangeSearch.ReferenceTree(), rangeSearch.SingleMode()) : &rangeSearch;
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t c = 0; c < (omp_size_t) numChunks; ++c)
+    {
+      const size_t first = c * chunkSize;
+      const size_t last = std::min(first + chunkSize, (size_t) data.n_cols);
+      if (first >= last)
+        continue;
+
+      // The count of each point includes the point itself.
+      arma::Col<size_t> counts;
+      search->Count(data.cols(first, last - 1), math::Range(0.0, epsilon),
+          counts, minPoints);
 
-    // Do the range search for only this point.
-    rangeSearch.Search(data.col(i), math::Range(0.0, epsilon), neighbors,
-        distances);
+      for (size_t i = 0; i < counts.n_elem; ++i)
+        core[first + i] = (counts[i] >= minPoints);
+    }
 
-    // Union to all neighbors.
-    for (size_t j = 0; j < neighbors[0].size(); ++j)
-      uf.Union(i, neighbors[0][j]);
+    if (parallelSearch)
+      delete search;
   }
 }
 
 /**
- * Performs DBSCAN clustering on the data, returning number of clusters
- * and also the list of cluster assignments.  This can perform search in batch,
- * naive search).
+ * Find the neighbors of the points in the given block.
  */
 template<typename RangeSearchType, typename PointSelectionPolicy>
 template<typename MatType>
-void DBSCAN<RangeSearchType, PointSelectionPolicy>::BatchCluster(
+void DBSCAN<RangeSearchType, PointSelectionPolicy>::SearchBlock(
     const MatType& data,
-    emst::UnionFind& uf)
+    const size_t begin,
+    const size_t end,
+    const bool parallelSearch,
+    std::vector<std::vector<size_t>>& neighbors,
+    std::vector<std::vector<double>>& distances)
 {
-  // For each point, find the points in epsilon-nighborhood and their distances.
-  std::vector<std::vector<size_t>> neighbors;
-  std::vector<std::vector<double>> distances;
-  Log::Info << "Performing range search." << std::endl;
-  rangeSearch.Train(data);
-  rangeSearch.Search(data, math::Range(0.0, epsilon), neighbors, distances);
-  Log::Info << "Range search complete." << std::endl;
+  neighbors.resize(end - begin);
+  distances.resize(end - begin);
 
-  // Now loop over all points.
-  for (size_t i = 0; i < data.n_cols; ++i)
+  const size_t numChunks = NumChunks(end - begin, parallelSearch);
+  const size_t chunkSize = (end - begin + numChunks - 1) / numChunks;
+
+  #pragma omp parallel if(parallelSearch)
   {
-    // Get the next index.
-    const size_t index = pointSelector.Select(i, data);
-    for (size_t j = 0; j < neighbors[index].size(); ++j)
-      uf.Union(index, neighbors[index][j]);
+    // Each thread needs its own RangeSearch object; they all share the
+    // reference tree.
+    RangeSearchType* search = parallelSearch ? new RangeSearchType(
+        rangeSearch.ReferenceTree(), rangeSearch.SingleMode()) : &rangeSearch;
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t c = 0; c < (omp_size_t) numChunks; ++c)
+    {
+      const size_t first = begin + c * chunkSize;
+      const size_t last = std::min(first + chunkSize, end);
+      if (first >= last)
+        continue;
+
+      std::vector<std::vector<size_t>> chunkNeighbors;
+      std::vector<std::vector<double>> chunkDistances;
+      search->Search(data.cols(first, last - 1), math::Range(0.0, epsilon),
+          chunkNeighbors, chunkDistances);
+
+      for (size_t i = 0; i < chunkNeighbors.size(); ++i)
+      {
+        neighbors[first - begin + i] = std::move(chunkNeighbors[i]);
+        distances[first - begin + i] = std::move(chunkDistances[i]);
+      }
+    }
+
+    if (parallelSearch)
+      delete search;
   }
 }
 
+/**
+ * Get the number of chunks to search the given number of points in.
+ */
+template<typename RangeSearchType, typename PointSelectionPolicy>
+size_t DBSCAN<RangeSearchType, PointSelectionPolicy>::NumChunks(
+    const size_t numPoints,
+    const bool parallelSearch) const
+{
+  size_t numThreads = 1;
+  #ifdef HAS_OPENMP
+    if (parallelSearch)
+      numThreads = omp_get_max_threads();
+  #endif
+
+  // In batch mode, use a few chunks per thread, so that dense regions can be
+  // balanced between threads.
+  if (!batchMode)
+    return numPoints;
+  return std::min(numPoints, (numThreads == 1) ? 1 : 4 * numThreads);
+}
+
 } // namespace dbscan
 } // namespace mlpack
 
@@ -39,8 +39,11 @@ PROGRAM_INFO("DBSCAN clustering",
     "The input dataset to be clustered may be specified with the " +
     PRINT_PARAM_STRING("input") + " parameter; the radius of each range "
     "search may be specified with the " + PRINT_PARAM_STRING("epsilon") +
-    " parameters, and the minimum number of points in a cluster may be "
-    "specified with the " + PRINT_PARAM_STRING("min_size") + " parameter."
+    " parameters, and the minimum number of points (including itself) within "
+    "the radius of a core point may be specified with the " +
+    PRINT_PARAM_STRING("min_size") + " parameter.  Points that are not core "
+    "points join the cluster of the closest core point within the radius, or "
+    "are labeled as noise."
     "\n\n"
     "The " + PRINT_PARAM_STRING("assignments") + " and " +
     PRINT_PARAM_STRING("centroids") + " output parameters may be "
@@ -78,7 +81,8 @@ PARAM_UROW_OUT("assignments", "Output matrix for assignments of each "
 PARAM_MATRIX_OUT("centroids", "Matrix to save output centroids to.", "C");
 
 PARAM_DOUBLE_IN("epsilon", "Radius of each range search.", "e", 1.0);
-PARAM_INT_IN("min_size", "Minimum number of points for a cluster.", "m", 5);
+PARAM_INT_IN("min_size", "Minimum number of points in the neighborhood of a "
+    "core point.", "m", 5);
 
 PARAM_STRING_IN("tree_type", "If using single-tree or dual-tree search, the "
     "type of tree to use ('kd', 'r', 'r-star', 'x', 'hilbert-r', 'r-plus', "
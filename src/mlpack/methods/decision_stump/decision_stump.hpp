@@ -29,6 +29,12 @@ namespace decision_stump {
  * case).
  * Points that are below the first bin will take the label of the first bin.
  *
+ * Training sorts each dimension of the data, and the dimensions are evaluated
+ * in parallel when OpenMP is available.  When the stump is trained many times
+ * on the same data with different weights, as in AdaBoost, Presort() can sort
+ * the data once: stumps built from this stump with the boosting constructor
+ * then reuse that order instead of sorting every dimension again.
+ *
  * @note
  * This class has been deprecated and should be removed in mlpack 4.0.0.  Use
  * `ID3DecisionStump`, found in src/mlpack/methods/decision_tree/, instead.
@@ -112,6 +118,17 @@ class DecisionStump
                                  const size_t numClasses,
                                  const size_t bucketSize);
 
+  /**
+   * Sort each dimension of the given data once and keep the order, so that
+   * decision stumps built from this one with the boosting constructor (which
+   * takes the weights) on this same data don't sort it again.  AdaBoost calls
+   * this before its boosting rounds.  The order is not used by the stumps
+   * built from this one, nor by Train(), and it is not serialized.
+   *
+   * @param data Dataset that the stumps will be trained on.
+   */
+  void Presort(const MatType& data);
+
   /**
    * Classification function. After training, classify test, and put the
    * predicted classes in predictedLabels.
@@ -143,6 +160,10 @@ class DecisionStump
   void serialize(Archive& ar, const unsigned int /* version */);
 
  private:
+  // Allow access to the presorted order of stumps of other types.
+  template<typename OtherMatType>
+  friend class DecisionStump;
+
   //! The number of classes (we must store this for boosting).
   size_t numClasses;
   //! The minimum number of points in a bucket.
@@ -154,6 +175,9 @@ class DecisionStump
   arma::vec split;
   //! Stores the labels for each splitting bin.
   arma::Col<size_t> binLabels;
+  //! The order of the points in each dimension (one column per dimension),
+  //! set by Presort() and shared by the copies of this stump.
+  std::shared_ptr<const arma::umat> sortedIndices;
 
   /**
    * Sets up dimension as if it were splitting on it and finds entropy when
@@ -161,10 +185,13 @@ class DecisionStump
    *
    * @param dimension A row from the training data, which might be a
    *     candidate for the splitting dimension.
+   * @param sortedIndexDim The indices of the points sorted by their value in
+   *     the dimension.
    * @tparam UseWeights Whether we need to run a weighted Decision Stump.
    */
   template<bool UseWeights, typename VecType>
   double SetupSplitDimension(const VecType& dimension,
+                             const arma::uvec& sortedIndexDim,
                              const arma::Row<size_t>& labels,
                              const arma::rowvec& weightD);
 
@@ -174,9 +201,12 @@ class DecisionStump
    *
    * @tparam dimension dimension is the dimension decided by the constructor
    *      on which we now train the decision stump.
+   * @param sortedIndexDim The indices of the points sorted by their value in
+   *     the dimension.
    */
   template<typename VecType>
   void TrainOnDim(const VecType& dimension,
+                  const arma::uvec& sortedIndexDim,
                   const arma::Row<size_t>& labels);
 
   /**
@@ -221,6 +251,7 @@ class DecisionStump
    * @param data Dataset to train on.
    * @param labels Labels for dataset.
    * @param weights Weights for this set of labels.
+   * @param presorted If not NULL, the order of the points in each dimension.
    * @tparam UseWeights If true, the weights in the weight vector will be used
    *      (otherwise they are ignored).
    * @return The final entropy after splitting.
@@ -228,7 +259,8 @@ class DecisionStump
   template<bool UseWeights>
   double Train(const MatType& data,
                const arma::Row<size_t>& labels,
-               const arma::rowvec& weights);
+               const arma::rowvec& weights,
+               const arma::umat* presorted = NULL);
 };
 
 } // namespace decision_stump
@@ -100,24 +100,42 @@ template<typename MatType>
 template<bool UseWeights>
 double DecisionStump<MatType>::Train(const MatType& data,
                                      const arma::Row<size_t>& labels,
-                                     const arma::rowvec& weights)
+                                     const arma::rowvec& weights,
+                                     const arma::umat* presorted)
 {
   // If classLabels are not all identical, proceed with training.
   size_t bestDim = 0;
-  double entropy;
   const double rootEntropy = CalculateEntropy<UseWeights>(labels, weights);
 
+  // For each dimension with non-identical values, treat it as a potential
+  // splitting dimension and calculate entropy if split on it.  The dimensions
+  // are independent, so they are evaluated in parallel.
+  arma::vec entropies(data.n_rows);
+  arma::uvec distinct(data.n_rows);
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_rows; i++)
+  {
+    distinct[i] = IsDistinct(data.row(i));
+    if (distinct[i])
+    {
+      arma::uvec sortedIndexDim;
+      if (presorted)
+        sortedIndexDim = presorted->col(i);
+      else
+        sortedIndexDim = arma::stable_sort_index(data.row(i).t());
+
+      entropies[i] = SetupSplitDimension<UseWeights>(data.row(i),
+          sortedIndexDim, labels, weights);
+    }
+  }
+
   double gain, bestGain = 0.0;
   for (size_t i = 0; i < data.n_rows; i++)
   {
     // Go through each dimension of the data.
-    if (IsDistinct(data.row(i)))
+    if (distinct[i])
     {
-      // For each dimension with non-identical values, treat it as a potential
-      // splitting dimension and calculate entropy if split on it.
-      entropy = SetupSplitDimension<UseWeights>(data.row(i), labels, weights);
-
-      gain = rootEntropy - entropy;
+      gain = rootEntropy - entropies[i];
       // Find the dimension with the best entropy so that the gain is
       // maximized.
 
@@ -133,10 +151,33 @@ double DecisionStump<MatType>::Train(const MatType& data,
   splitDimension = bestDim;
 
   // Once the splitting column/dimension has been decided, train on it.
-  TrainOnDim(data.row(splitDimension), labels);
+  arma::uvec sortedIndexDim;
+  if (presorted)
+    sortedIndexDim = presorted->col(splitDimension);
+  else
+    sortedIndexDim = arma::stable_sort_index(data.row(splitDimension).t());
+
+  TrainOnDim(data.row(splitDimension), sortedIndexDim, labels);
   return -bestGain;
 }
 
+/**
+ * Sort each dimension of the data once, for the stumps that will be trained on
+ * it with the boosting constructor.
+ */
+template<typename MatType>
+void DecisionStump<MatType>::Presort(const MatType& data)
+{
+  std::shared_ptr<arma::umat> order =
+      std::make_shared<arma::umat>(data.n_cols, data.n_rows);
+
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_rows; i++)
+    order->col(i) = arma::stable_sort_index(data.row(i).t());
+
+  sortedIndices = order;
+}
+
 /**
  * Classification function. After training, classify test, and put the predicted
  * classes in predictedLabels.
@@ -191,7 +232,14 @@ DecisionStump<MatType>::DecisionStump(const DecisionStump<>& other,
     numClasses(numClasses),
     bucketSize(other.bucketSize)
 {
-  Train<true>(data, labels, weights);
+  // Reuse the order of the points presorted by the other stump, if it sorted
+  // data of this shape.
+  const arma::umat* presorted = NULL;
+  if (other.sortedIndices && other.sortedIndices->n_rows == data.n_cols &&
+      other.sortedIndices->n_cols == data.n_rows)
+    presorted = other.sortedIndices.get();
+
+  Train<true>(data, labels, weights, presorted);
 }
 
 /**
@@ -217,22 +265,23 @@ void DecisionStump<MatType>::serialize(Archive& ar,
  *
  * @param dimension A row from the training data, which might be a candidate for
  *      the splitting dimension.
+ * @param sortedIndexDim The indices of the points sorted (stably) by their
+ *      value in the dimension.
  * @param UseWeights Whether we need to run a weighted Decision Stump.
  */
 template<typename MatType>
 template<bool UseWeights, typename VecType>
 double DecisionStump<MatType>::SetupSplitDimension(
     const VecType& dimension,
+    const arma::uvec& sortedIndexDim,
     const arma::Row<size_t>& labels,
     const arma::rowvec& weights)
 {
   size_t i, count, begin, end;
   double entropy = 0.0;
 
-  // Store the indices of the sorted dimension to build a vector of sorted
-  // labels.  This sort is stable.
-  arma::uvec sortedIndexDim = arma::stable_sort_index(dimension.t());
-
+  // The indices of the sorted dimension are used to build a vector of sorted
+  // labels.
   arma::Row<size_t> sortedLabels(dimension.n_elem);
   arma::rowvec sortedWeights(dimension.n_elem);
 
@@ -308,21 +357,25 @@ double DecisionStump<MatType>::SetupSplitDimension(
  *
  * @param dimension Dimension is the dimension decided by the constructor on
  *      which we now train the decision stump.
+ * @param sortedIndexDim The indices of the points sorted (stably) by their
+ *      value in the dimension.
  */
 template<typename MatType>
 template<typename VecType>
 void DecisionStump<MatType>::TrainOnDim(const VecType& dimension,
+                                        const arma::uvec& sortedIndexDim,
                                         const arma::Row<size_t>& labels)
 {
   size_t i, count, begin, end;
 
-  typename MatType::row_type sortedSplitDim = arma::sort(dimension);
-  arma::uvec sortedSplitIndexDim = arma::stable_sort_index(dimension.t());
+  typename MatType::row_type sortedSplitDim(dimension.n_elem);
   arma::Row<size_t> sortedLabels(dimension.n_elem);
-  sortedLabels.fill(0);
 
   for (i = 0; i < dimension.n_elem; i++)
-    sortedLabels(i) = labels(sortedSplitIndexDim(i));
+  {
+    sortedSplitDim(i) = dimension(sortedIndexDim(i));
+    sortedLabels(i) = labels(sortedIndexDim(i));
+  }
 
   arma::rowvec subCols;
   double mostFreq;
@@ -17,8 +17,12 @@
 #include "gini_gain.hpp"
 #include "information_gain.hpp"
 #include "best_binary_numeric_split.hpp"
+#include "histogram_numeric_split.hpp"
+#include "presorted_binary_numeric_split.hpp"
+#include "numeric_split_traits.hpp"
 #include "all_categorical_split.hpp"
 #include "all_dimension_select.hpp"
+#include "indexed_matrix.hpp"
 #include <type_traits>
 
 namespace mlpack {
@@ -465,6 +469,17 @@ class DecisionTree :
   //! trained tree).
   size_t SplitDimension() const { return splitDimension; }
 
+  //! Get the type of the split dimension (only meaningful if this is a
+  //! non-leaf in a trained tree).
+  data::Datatype SplitDimensionType() const
+  {
+    return (data::Datatype) dimensionTypeOrMajorityClass;
+  }
+
+  //! Get the class probabilities of a leaf, or the information the split of a
+  //! non-leaf uses to find the child of a point.
+  const arma::vec& ClassProbabilities() const { return classProbabilities; }
+
   /**
    * Given a point and that this node is not a leaf, calculate the index of the
    * child node this point would go towards.  This method is primarily used by
@@ -480,6 +495,19 @@ class DecisionTree :
    */
   size_t NumClasses() const;
 
+  /**
+   * Get or modify the number of points a node must have for its search over
+   * dimensions and the training of its children to be split into OpenMP tasks.
+   * Smaller nodes are trained serially.  This only has an effect when mlpack is
+   * compiled with OpenMP, and the trees that are built do not depend on it.
+   * The default is 10000 points.
+   */
+  static size_t& ParallelThreshold()
+  {
+    static size_t parallelThreshold = 10000;
+    return parallelThreshold;
+  }
+
  private:
   //! The vector of children.
   std::vector<DecisionTree*> children;
@@ -528,6 +556,9 @@ class DecisionTree :
    * @param minimumLeafSize Minimum number of points in each leaf node.
    * @param minimumGainSplit Minimum gain for the node to split.
    * @param maximumDepth Maximum depth for the tree.
+   * @param sortedIndices If the numeric split uses sorted indices, the columns
+   *      of the points sorted by each dimension (one column per dimension);
+   *      NULL at the root, where they are computed.
    * @return The final entropy of decision tree.
    */
   template<bool UseWeights, typename MatType>
@@ -541,7 +572,8 @@ class DecisionTree :
                const size_t minimumLeafSize,
                const double minimumGainSplit,
                const size_t maximumDepth,
-               DimensionSelectionType& dimensionSelector);
+               DimensionSelectionType& dimensionSelector,
+               arma::umat* sortedIndices = NULL);
 
   /**
    * Corresponding to the public Train() method, this method is designed for
@@ -557,6 +589,9 @@ class DecisionTree :
    * @param minimumLeafSize Minimum number of points in each leaf node.
    * @param minimumGainSplit Minimum gain for the node to split.
    * @param maximumDepth Maximum depth for the tree.
+   * @param sortedIndices If the numeric split uses sorted indices, the columns
+   *      of the points sorted by each dimension (one column per dimension);
+   *      NULL at the root, where they are computed.
    * @return The final entropy of decision tree.
    */
   template<bool UseWeights, typename MatType>
@@ -569,7 +604,83 @@ class DecisionTree :
                const size_t minimumLeafSize,
                const double minimumGainSplit,
                const size_t maximumDepth,
-               DimensionSelectionType& dimensionSelector);
+               DimensionSelectionType& dimensionSelector,
+               arma::umat* sortedIndices = NULL);
+
+  /**
+   * Call the SplitIfBetter() function of the numeric split for one dimension
+   * of the points of the node.  This overload is used for numeric splits that
+   * do not use sorted indices.
+   */
+  template<bool UseWeights, typename MatType>
+  double NumericSplitIfBetter(const double bestGain,
+                              const MatType& data,
+                              const size_t begin,
+                              const size_t count,
+                              const size_t dimension,
+                              const arma::Row<size_t>& labels,
+                              const size_t numClasses,
+                              const arma::rowvec& weights,
+                              const size_t minimumLeafSize,
+                              const double minimumGainSplit,
+                              arma::vec& probabilities,
+                              NumericAuxiliarySplitInfo& aux,
+                              const arma::umat* sortedIndices,
+                              const std::false_type& /* usesSortedIndices */);
+
+  /**
+   * Call the SplitIfBetter() function of the numeric split for one dimension
+   * of the points of the node, with the sorted order of the points of the
+   * node.  This overload is used for numeric splits that use sorted indices.
+   */
+  template<bool UseWeights, typename MatType>
+  double NumericSplitIfBetter(const double bestGain,
+                              const MatType& data,
+                              const size_t begin,
+                              const size_t count,
+                              const size_t dimension,
+                              const arma::Row<size_t>& labels,
+                              const size_t numClasses,
+                              const arma::rowvec& weights,
+                              const size_t minimumLeafSize,
+                              const double minimumGainSplit,
+                              arma::vec& probabilities,
+                              NumericAuxiliarySplitInfo& aux,
+                              const arma::umat* sortedIndices,
+                              const std::true_type& /* usesSortedIndices */);
+
+  /**
+   * Sort the points of the root by each dimension, for numeric splits that use
+   * sorted indices.
+   *
+   * @param data Dataset to train on.
+   * @param begin Index of the first point of the root.
+   * @param count Number of points of the root.
+   * @return The columns of the points sorted by each dimension.
+   */
+  template<typename MatType>
+  static arma::umat SortIndices(const MatType& data,
+                                const size_t begin,
+                                const size_t count);
+
+  /**
+   * Update the sorted indices of the points of a node after its points have
+   * been moved to their children, so that the part of each child holds the
+   * new columns of the points of the child, still in sorted order.
+   *
+   * @param sortedIndices The sorted indices to update.
+   * @param begin Index of the first point of the node.
+   * @param count Number of points of the node.
+   * @param oldColumns The old column of the point at each new position.
+   * @param childAssignments The child of the point at each new position.
+   * @param childBegins The index of the first point of each child.
+   */
+  static void PartitionSortedIndices(arma::umat& sortedIndices,
+                                     const size_t begin,
+                                     const size_t count,
+                                     const arma::uvec& oldColumns,
+                                     const arma::Row<size_t>& childAssignments,
+                                     const std::vector<size_t>& childBegins);
 };
 
 /**
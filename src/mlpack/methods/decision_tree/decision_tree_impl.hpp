@@ -679,8 +679,37 @@ double DecisionTree<FitnessFunction,
     const size_t minimumLeafSize,
     const double minimumGainSplit,
     const size_t maximumDepth,
-    DimensionSelectionType& dimensionSelector)
+    DimensionSelectionType& dimensionSelector,
+    arma::umat* sortedIndices)
 {
+  // If the numeric split uses sorted indices, sort each dimension once at the
+  // root; the children get the sorted order of their points.
+  if (NumericSplitTraits<NumericSplit>::UsesSortedIndices &&
+      sortedIndices == NULL)
+  {
+    arma::umat rootSortedIndices = SortIndices(data, begin, count);
+    return Train<UseWeights>(data, begin, count, datasetInfo, labels,
+        numClasses, weights, minimumLeafSize, minimumGainSplit, maximumDepth,
+        dimensionSelector, &rootSortedIndices);
+  }
+
+#ifdef HAS_OPENMP
+  // Start the threads at the first node that is large enough; below it, the
+  // dimensions and the children of large nodes are handled by tasks.
+  if (count >= ParallelThreshold() && omp_get_level() == 0)
+  {
+    double gain = 0.0;
+    #pragma omp parallel
+    {
+      #pragma omp single
+      gain = Train<UseWeights>(data, begin, count, datasetInfo, labels,
+          numClasses, weights, minimumLeafSize, minimumGainSplit,
+          maximumDepth, dimensionSelector, sortedIndices);
+    }
+    return gain;
+  }
+#endif
+
   // Clear children if needed.
   for (size_t i = 0; i < children.size(); ++i)
     delete children[i];
@@ -698,6 +727,71 @@ double DecisionTree<FitnessFunction,
   size_t bestDim = datasetInfo.Dimensionality(); // This means "no split".
   const size_t end = dimensionSelector.End();
 
+#ifdef HAS_OPENMP
+  if (maximumDepth != 1 && count >= ParallelThreshold())
+  {
+    // Evaluate all the dimensions at the same time, each against the gain of
+    // the node, and then take the split that the serial search below finds.
+    std::vector<size_t> dimensions;
+    for (size_t i = dimensionSelector.Begin(); i != end;
+         i = dimensionSelector.Next())
+      dimensions.push_back(i);
+
+    const double nodeGain = bestGain;
+    std::vector<double> gains(dimensions.size(), DBL_MAX);
+    std::vector<arma::vec> probabilities(dimensions.size());
+    std::vector<NumericAuxiliarySplitInfo> numericAux(dimensions.size());
+    std::vector<CategoricalAuxiliarySplitInfo> categoricalAux(
+        dimensions.size());
+    for (size_t d = 0; d < dimensions.size(); ++d)
+    {
+      #pragma omp task default(shared) firstprivate(d)
+      {
+        const size_t i = dimensions[d];
+        if (datasetInfo.Type(i) == data::Datatype::categorical)
+        {
+          gains[d] = CategoricalSplit::template SplitIfBetter<UseWeights>(
+              nodeGain,
+              data.cols(begin, begin + count - 1).row(i),
+              datasetInfo.NumMappings(i),
+              labels.subvec(begin, begin + count - 1),
+              numClasses,
+              UseWeights ? weights.subvec(begin, begin + count - 1) : weights,
+              minimumLeafSize,
+              minimumGainSplit,
+              probabilities[d],
+              categoricalAux[d]);
+        }
+        else if (datasetInfo.Type(i) == data::Datatype::numeric)
+        {
+          gains[d] = NumericSplitIfBetter<UseWeights>(nodeGain, data, begin,
+              count, i, labels, numClasses, weights, minimumLeafSize,
+              minimumGainSplit, probabilities[d], numericAux[d],
+              sortedIndices, std::integral_constant<bool,
+              NumericSplitTraits<NumericSplit>::UsesSortedIndices>());
+        }
+      }
+    }
+    #pragma omp taskwait
+
+    for (size_t d = 0; d < dimensions.size() && bestGain < 0.0; ++d)
+    {
+      // A later dimension has to improve on the best split so far.
+      if (gains[d] == DBL_MAX || (bestDim != datasetInfo.Dimensionality() &&
+          !(gains[d] > std::min(bestGain + minimumGainSplit, 0.0))))
+        continue;
+
+      bestDim = dimensions[d];
+      bestGain = gains[d];
+      classProbabilities = probabilities[d];
+      if (datasetInfo.Type(bestDim) == data::Datatype::categorical)
+        CategoricalAuxiliarySplitInfo::operator=(categoricalAux[d]);
+      else
+        NumericAuxiliarySplitInfo::operator=(numericAux[d]);
+    }
+  }
+  else
+#endif
   if (maximumDepth != 1)
   {
     for (size_t i = dimensionSelector.Begin(); i != end;
@@ -719,15 +813,11 @@ double DecisionTree<FitnessFunction,
       }
       else if (datasetInfo.Type(i) == data::Datatype::numeric)
       {
-        dimGain = NumericSplit::template SplitIfBetter<UseWeights>(bestGain,
-            data.cols(begin, begin + count - 1).row(i),
-            labels.subvec(begin, begin + count - 1),
-            numClasses,
-            UseWeights ? weights.subvec(begin, begin + count - 1) : weights,
-            minimumLeafSize,
-            minimumGainSplit,
-            classProbabilities,
-            *this);
+        dimGain = NumericSplitIfBetter<UseWeights>(bestGain, data, begin,
+            count, i, labels, numClasses, weights, minimumLeafSize,
+            minimumGainSplit, classProbabilities, *this, sortedIndices,
+            std::integral_constant<bool,
+            NumericSplitTraits<NumericSplit>::UsesSortedIndices>());
       }
 
       // If the splitter reported that it did not split, move to the next
@@ -786,12 +876,20 @@ double DecisionTree<FitnessFunction,
       bestGain = 0.0;
     }
 
-    // Split into children.
+    // Move the points of each child next to each other.  If there are sorted
+    // indices, the old column of each point is tracked, so that the sorted
+    // indices can follow the points.
+    arma::uvec oldColumns;
+    if (sortedIndices != NULL)
+      oldColumns = arma::linspace<arma::uvec>(begin, begin + count - 1,
+          count);
+
+    std::vector<size_t> childBegins(numChildren + 1);
     size_t currentCol = begin;
     for (size_t i = 0; i < numChildren; ++i)
     {
-      size_t currentChildBegin = currentCol;
-      for (size_t j = currentChildBegin; j < begin + count; ++j)
+      childBegins[i] = currentCol;
+      for (size_t j = currentCol; j < begin + count; ++j)
       {
         if (childAssignments[j - begin] == i)
         {
@@ -800,29 +898,57 @@ double DecisionTree<FitnessFunction,
           labels.swap_cols(currentCol, j);
           if (UseWeights)
             weights.swap_cols(currentCol, j);
+          if (sortedIndices != NULL)
+            oldColumns.swap_rows(currentCol - begin, j - begin);
           ++currentCol;
         }
       }
+    }
+    childBegins[numChildren] = currentCol;
 
-      // Now build the child recursively.
-      DecisionTree* child = new DecisionTree();
-      if (NoRecursion)
-      {
-        child->Train<UseWeights>(data, currentChildBegin,
-            currentCol - currentChildBegin, datasetInfo, labels, numClasses,
-            weights, currentCol - currentChildBegin, minimumGainSplit,
-            maximumDepth - 1, dimensionSelector);
-      }
-      else
+    if (sortedIndices != NULL)
+    {
+      PartitionSortedIndices(*sortedIndices, begin, count, oldColumns,
+          childAssignments, childBegins);
+    }
+
+    // Now build the children recursively.  With OpenMP, each large child is
+    // built by a task, with its own copy of the dimension selector.  Without
+    // recursion, the children are leaves.
+    for (size_t i = 0; i < numChildren; ++i)
+      children.push_back(new DecisionTree());
+
+    std::vector<double> childGains(numChildren, 0.0);
+    for (size_t i = 0; i < numChildren; ++i)
+    {
+      const size_t childBegin = childBegins[i];
+      const size_t childCount = childBegins[i + 1] - childBegins[i];
+      const size_t childLeafSize = NoRecursion ? childCount : minimumLeafSize;
+#ifdef HAS_OPENMP
+      if (childCount >= ParallelThreshold())
       {
-        // During recursion entropy of child node may change.
-        double childGain = child->Train<UseWeights>(data, currentChildBegin,
-            currentCol - currentChildBegin, datasetInfo, labels, numClasses,
-            weights, minimumLeafSize, minimumGainSplit, maximumDepth - 1,
-            dimensionSelector);
-        bestGain += double(childCounts[i]) / double(count) * (-childGain);
+        DimensionSelectionType childSelector(dimensionSelector);
+        #pragma omp task default(shared) firstprivate(i, childBegin, \
+            childCount, childLeafSize, childSelector)
+        childGains[i] = children[i]->template Train<UseWeights>(data,
+            childBegin, childCount, datasetInfo, labels, numClasses, weights,
+            childLeafSize, minimumGainSplit, maximumDepth - 1, childSelector,
+            sortedIndices);
+        continue;
       }
-      children.push_back(child);
+#endif
+      childGains[i] = children[i]->template Train<UseWeights>(data,
+          childBegin, childCount, datasetInfo, labels, numClasses, weights,
+          childLeafSize, minimumGainSplit, maximumDepth - 1, dimensionSelector,
+          sortedIndices);
+    }
+    #pragma omp taskwait
+
+    // During recursion entropy of child node may change.
+    if (!NoRecursion)
+    {
+      for (size_t i = 0; i < numChildren; ++i)
+        bestGain += double(childCounts[i]) / double(count) * (-childGains[i]);
     }
   }
   else
@@ -864,8 +990,37 @@ double DecisionTree<FitnessFunction,
     const size_t minimumLeafSize,
     const double minimumGainSplit,
     const size_t maximumDepth,
-    DimensionSelectionType& dimensionSelector)
+    DimensionSelectionType& dimensionSelector,
+    arma::umat* sortedIndices)
 {
+  // If the numeric split uses sorted indices, sort each dimension once at the
+  // root; the children get the sorted order of their points.
+  if (NumericSplitTraits<NumericSplit>::UsesSortedIndices &&
+      sortedIndices == NULL)
+  {
+    arma::umat rootSortedIndices = SortIndices(data, begin, count);
+    return Train<UseWeights>(data, begin, count, labels, numClasses,
+        weights, minimumLeafSize, minimumGainSplit, maximumDepth,
+        dimensionSelector, &rootSortedIndices);
+  }
+
+#ifdef HAS_OPENMP
+  // Start the threads at the first node that is large enough; below it, the
+  // dimensions and the children of large nodes are handled by tasks.
+  if (count >= ParallelThreshold() && omp_get_level() == 0)
+  {
+    double gain = 0.0;
+    #pragma omp parallel
+    {
+      #pragma omp single
+      gain = Train<UseWeights>(data, begin, count, labels, numClasses,
+          weights, minimumLeafSize, minimumGainSplit, maximumDepth,
+          dimensionSelector, sortedIndices);
+    }
+    return gain;
+  }
+#endif
+
   // Clear children if needed.
   for (size_t i = 0; i < children.size(); ++i)
     delete children[i];
@@ -885,23 +1040,56 @@ double DecisionTree<FitnessFunction,
       UseWeights ? weights.subvec(begin, begin + count - 1) : weights);
   size_t bestDim = data.n_rows; // This means "no split".
 
+#ifdef HAS_OPENMP
+  if (maximumDepth != 1 && count >= ParallelThreshold())
+  {
+    // Evaluate all the dimensions at the same time, each against the gain of
+    // the node, and then take the split that the serial search below finds.
+    std::vector<size_t> dimensions;
+    for (size_t i = dimensionSelector.Begin(); i != dimensionSelector.End();
+         i = dimensionSelector.Next())
+      dimensions.push_back(i);
+
+    const double nodeGain = bestGain;
+    std::vector<double> gains(dimensions.size(), DBL_MAX);
+    std::vector<arma::vec> probabilities(dimensions.size());
+    std::vector<NumericAuxiliarySplitInfo> numericAux(dimensions.size());
+    for (size_t d = 0; d < dimensions.size(); ++d)
+    {
+      #pragma omp task default(shared) firstprivate(d)
+      gains[d] = NumericSplitIfBetter<UseWeights>(nodeGain, data, begin,
+          count, dimensions[d], labels, numClasses, weights, minimumLeafSize,
+          minimumGainSplit, probabilities[d], numericAux[d], sortedIndices,
+          std::integral_constant<bool,
+          NumericSplitTraits<NumericSplit>::UsesSortedIndices>());
+    }
+    #pragma omp taskwait
+
+    for (size_t d = 0; d < dimensions.size() && bestGain < 0.0; ++d)
+    {
+      // A later dimension has to improve on the best split so far.
+      if (gains[d] == DBL_MAX || (bestDim != data.n_rows &&
+          !(gains[d] > std::min(bestGain + minimumGainSplit, 0.0))))
+        continue;
+
+      bestDim = dimensions[d];
+      bestGain = gains[d];
+      classProbabilities = probabilities[d];
+      NumericAuxiliarySplitInfo::operator=(numericAux[d]);
+    }
+  }
+  else
+#endif
   if (maximumDepth != 1)
   {
     for (size_t i = dimensionSelector.Begin(); i != dimensionSelector.End();
          i = dimensionSelector.Next())
     {
-      const double dimGain = NumericSplitType<FitnessFunction>::template
-          SplitIfBetter<UseWeights>(bestGain,
-                                    data.cols(begin, begin + count - 1).row(i),
-                                    labels.cols(begin, begin + count - 1),
-                                    numClasses,
-                                    UseWeights ?
-                                        weights.cols(begin, begin + count - 1) :
-                                        weights,
-                                    minimumLeafSize,
-                                    minimumGainSplit,
-                                    classProbabilities,
-                                    *this);
+      const double dimGain = NumericSplitIfBetter<UseWeights>(bestGain, data,
+          begin, count, i, labels, numClasses, weights, minimumLeafSize,
+          minimumGainSplit, classProbabilities, *this, sortedIndices,
+          std::integral_constant<bool,
+          NumericSplitTraits<NumericSplit>::UsesSortedIndices>());
 
       // If the splitter did not report that it improved, then move to the next
       // dimension.
@@ -946,11 +1134,20 @@ double DecisionTree<FitnessFunction,
       bestGain = 0.0;
     }
 
+    // Move the points of each child next to each other.  If there are sorted
+    // indices, the old column of each point is tracked, so that the sorted
+    // indices can follow the points.
+    arma::uvec oldColumns;
+    if (sortedIndices != NULL)
+      oldColumns = arma::linspace<arma::uvec>(begin, begin + count - 1,
+          count);
+
+    std::vector<size_t> childBegins(numChildren + 1);
     size_t currentCol = begin;
     for (size_t i = 0; i < numChildren; ++i)
     {
-      size_t currentChildBegin = currentCol;
-      for (size_t j = currentChildBegin; j < begin + count; ++j)
+      childBegins[i] = currentCol;
+      for (size_t j = currentCol; j < begin + count; ++j)
       {
         if (childAssignments[j - begin] == i)
         {
@@ -959,29 +1156,57 @@ double DecisionTree<FitnessFunction,
           labels.swap_cols(currentCol, j);
           if (UseWeights)
             weights.swap_cols(currentCol, j);
+          if (sortedIndices != NULL)
+            oldColumns.swap_rows(currentCol - begin, j - begin);
           ++currentCol;
         }
       }
+    }
+    childBegins[numChildren] = currentCol;
 
-      // Now build the child recursively.
-      DecisionTree* child = new DecisionTree();
-      if (NoRecursion)
-      {
-        child->Train<UseWeights>(data, currentChildBegin,
-            currentCol - currentChildBegin, labels, numClasses, weights,
-            currentCol - currentChildBegin, minimumGainSplit, maximumDepth - 1,
-            dimensionSelector);
-      }
-      else
+    if (sortedIndices != NULL)
+    {
+      PartitionSortedIndices(*sortedIndices, begin, count, oldColumns,
+          childAssignments, childBegins);
+    }
+
+    // Now build the children recursively.  With OpenMP, each large child is
+    // built by a task, with its own copy of the dimension selector.  Without
+    // recursion, the children are leaves.
+    for (size_t i = 0; i < numChildren; ++i)
+      children.push_back(new DecisionTree());
+
+    std::vector<double> childGains(numChildren, 0.0);
+    for (size_t i = 0; i < numChildren; ++i)
+    {
+      const size_t childBegin = childBegins[i];
+      const size_t childCount = childBegins[i + 1] - childBegins[i];
+      const size_t childLeafSize = NoRecursion ? childCount : minimumLeafSize;
+#ifdef HAS_OPENMP
+      if (childCount >= ParallelThreshold())
       {
-        // During recursion entropy of child node may change.
-        double childGain = child->Train<UseWeights>(data, currentChildBegin,
-            currentCol - currentChildBegin, labels, numClasses, weights,
-            minimumLeafSize, minimumGainSplit, maximumDepth - 1,
-            dimensionSelector);
-        bestGain += double(childCounts[i]) / double(count) * (-childGain);
+        DimensionSelectionType childSelector(dimensionSelector);
+        #pragma omp task default(shared) firstprivate(i, childBegin, \
+            childCount, childLeafSize, childSelector)
+        childGains[i] = children[i]->template Train<UseWeights>(data,
+            childBegin, childCount, labels, numClasses, weights,
+            childLeafSize, minimumGainSplit, maximumDepth - 1, childSelector,
+            sortedIndices);
+        continue;
       }
-      children.push_back(child);
+#endif
+      childGains[i] = children[i]->template Train<UseWeights>(data,
+          childBegin, childCount, labels, numClasses, weights,
+          childLeafSize, minimumGainSplit, maximumDepth - 1, dimensionSelector,
+          sortedIndices);
+    }
+    #pragma omp taskwait
+
+    // During recursion entropy of child node may change.
+    if (!NoRecursion)
+    {
+      for (size_t i = 0; i < numChildren; ++i)
+        bestGain += double(childCounts[i]) / double(count) * (-childGains[i]);
     }
   }
   else
@@ -999,6 +1224,164 @@ double DecisionTree<FitnessFunction,
   return -bestGain;
 }
 
+//! Find a numeric split for a split type that does not use sorted indices.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         typename ElemType,
+         bool NoRecursion>
+template<bool UseWeights, typename MatType>
+double DecisionTree<FitnessFunction,
+                    NumericSplitType,
+                    CategoricalSplitType,
+                    DimensionSelectionType,
+                    ElemType,
+                    NoRecursion>::NumericSplitIfBetter(
+    const double bestGain,
+    const MatType& data,
+    const size_t begin,
+    const size_t count,
+    const size_t dimension,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const arma::rowvec& weights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    arma::vec& probabilities,
+    NumericAuxiliarySplitInfo& aux,
+    const arma::umat* /* sortedIndices */,
+    const std::false_type& /* usesSortedIndices */)
+{
+  return NumericSplit::template SplitIfBetter<UseWeights>(bestGain,
+      data.cols(begin, begin + count - 1).row(dimension),
+      labels.subvec(begin, begin + count - 1),
+      numClasses,
+      UseWeights ? weights.subvec(begin, begin + count - 1) : weights,
+      minimumLeafSize,
+      minimumGainSplit,
+      probabilities,
+      aux);
+}
+
+//! Find a numeric split for a split type that uses sorted indices.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         typename ElemType,
+         bool NoRecursion>
+template<bool UseWeights, typename MatType>
+double DecisionTree<FitnessFunction,
+                    NumericSplitType,
+                    CategoricalSplitType,
+                    DimensionSelectionType,
+                    ElemType,
+                    NoRecursion>::NumericSplitIfBetter(
+    const double bestGain,
+    const MatType& data,
+    const size_t begin,
+    const size_t count,
+    const size_t dimension,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const arma::rowvec& weights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    arma::vec& probabilities,
+    NumericAuxiliarySplitInfo& aux,
+    const arma::umat* sortedIndices,
+    const std::true_type& /* usesSortedIndices */)
+{
+  // The split gets the positions of the points inside the node.
+  const arma::uvec nodeIndices = sortedIndices->col(dimension).subvec(begin,
+      begin + count - 1) - begin;
+
+  return NumericSplit::template SplitIfBetter<UseWeights>(bestGain,
+      data.cols(begin, begin + count - 1).row(dimension),
+      nodeIndices,
+      labels.subvec(begin, begin + count - 1),
+      numClasses,
+      UseWeights ? weights.subvec(begin, begin + count - 1) : weights,
+      minimumLeafSize,
+      minimumGainSplit,
+      probabilities,
+      aux);
+}
+
+//! Sort the points of the root by each dimension.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         typename ElemType,
+         bool NoRecursion>
+template<typename MatType>
+arma::umat DecisionTree<FitnessFunction,
+                    NumericSplitType,
+                    CategoricalSplitType,
+                    DimensionSelectionType,
+                    ElemType,
+                    NoRecursion>::SortIndices(
+    const MatType& data,
+    const size_t begin,
+    const size_t count)
+{
+  // The rows are indexed by the column of the point in the dataset, so that
+  // the part of each node is at the same place as its points.
+  arma::umat sortedIndices(data.n_cols, data.n_rows);
+  for (size_t d = 0; d < data.n_rows; ++d)
+  {
+    sortedIndices.col(d).subvec(begin, begin + count - 1) =
+        arma::uvec(arma::sort_index(data.cols(begin, begin + count - 1).row(
+        d))) + begin;
+  }
+
+  return sortedIndices;
+}
+
+//! Let the sorted indices follow the points moved to the children.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         typename ElemType,
+         bool NoRecursion>
+void DecisionTree<FitnessFunction,
+                    NumericSplitType,
+                    CategoricalSplitType,
+                    DimensionSelectionType,
+                    ElemType,
+                    NoRecursion>::PartitionSortedIndices(
+    arma::umat& sortedIndices,
+    const size_t begin,
+    const size_t count,
+    const arma::uvec& oldColumns,
+    const arma::Row<size_t>& childAssignments,
+    const std::vector<size_t>& childBegins)
+{
+  // Find the new column of each point from its old column.
+  arma::uvec newColumns(count);
+  for (size_t i = 0; i < count; ++i)
+    newColumns[oldColumns[i] - begin] = begin + i;
+
+  // Going through the sorted points and appending each to the part of its
+  // child keeps the sorted order inside each child.
+  std::vector<size_t> next(childBegins.size());
+  arma::uvec buffer(count);
+  for (size_t d = 0; d < sortedIndices.n_cols; ++d)
+  {
+    std::copy(childBegins.begin(), childBegins.end(), next.begin());
+    for (size_t i = begin; i < begin + count; ++i)
+    {
+      const size_t column = newColumns[sortedIndices(i, d) - begin];
+      buffer[next[childAssignments[column - begin]]++ - begin] = column;
+    }
+
+    sortedIndices.col(d).subvec(begin, begin + count - 1) = buffer;
+  }
+}
+
 //! Return the class.
 template<typename FitnessFunction,
          template<typename> class NumericSplitType,
@@ -1074,8 +1457,9 @@ void DecisionTree<FitnessFunction,
     return;
   }
 
-  // Loop over each point.
-  for (size_t i = 0; i < data.n_cols; ++i)
+  // Loop over each point; the points are independent.
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
     predictions[i] = Classify(data.col(i));
 }
 
@@ -1111,7 +1495,8 @@ void DecisionTree<FitnessFunction,
     node = &node->Child(0);
   probabilities.set_size(node->classProbabilities.n_elem, data.n_cols);
 
-  for (size_t i = 0; i < data.n_cols; ++i)
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
   {
     arma::vec v = probabilities.unsafe_col(i); // Alias of column.
     Classify(data.col(i), predictions[i], v);
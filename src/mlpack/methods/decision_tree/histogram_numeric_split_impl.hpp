@@ -0,0 +1,207 @@
+/**
+ * @file methods/decision_tree/histogram_numeric_split_impl.hpp
+ *
+ * Implementation of the strategy that finds a binary numeric split using a
+ * histogram of the values.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_HISTOGRAM_NUMERIC_SPLIT_IMPL_HPP
+#define MLPACK_METHODS_DECISION_TREE_HISTOGRAM_NUMERIC_SPLIT_IMPL_HPP
+
+namespace mlpack {
+namespace tree {
+
+template<typename FitnessFunction>
+template<bool UseWeights, typename VecType, typename WeightVecType>
+double HistogramNumericSplit<FitnessFunction>::SplitIfBetter(
+    const double bestGain,
+    const VecType& data,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const WeightVecType& weights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    arma::Col<typename VecType::elem_type>& classProbabilities,
+    AuxiliarySplitInfo<typename VecType::elem_type>& /* aux */)
+{
+  typedef typename VecType::elem_type ElemType;
+
+  // First sanity check: if we don't have enough points, we can't split.
+  if (data.n_elem < (minimumLeafSize * 2))
+    return DBL_MAX;
+  if (bestGain == 0.0)
+    return DBL_MAX; // It can't be outperformed.
+
+  // Sanity check: if all the values are the same, we can't split in this
+  // dimension.
+  const ElemType minValue = arma::min(data);
+  const ElemType maxValue = arma::max(data);
+  if (minValue == maxValue)
+    return DBL_MAX;
+
+  // Build the histogram of the classes: the count (or the weight sum) of each
+  // class, and the smallest and largest value, of each bin.
+  const size_t bins = std::min((size_t) MaxBins, (size_t) data.n_elem);
+  const double binScale = bins / (double(maxValue) - double(minValue));
+
+  arma::Col<size_t> binCounts(bins, arma::fill::zeros);
+  arma::Col<ElemType> binMin(bins), binMax(bins);
+  arma::Mat<size_t> classCounts;
+  arma::mat classWeightSums;
+  if (UseWeights)
+    classWeightSums.zeros(numClasses, bins);
+  else
+    classCounts.zeros(numClasses, bins);
+
+  for (size_t i = 0; i < data.n_elem; ++i)
+  {
+    const ElemType value = data[i];
+    const size_t bin = std::min((size_t) ((value - minValue) * binScale),
+        bins - 1);
+
+    if (binCounts[bin] == 0)
+    {
+      binMin[bin] = value;
+      binMax[bin] = value;
+    }
+    else
+    {
+      binMin[bin] = std::min(binMin[bin], value);
+      binMax[bin] = std::max(binMax[bin], value);
+    }
+    ++binCounts[bin];
+
+    if (UseWeights)
+      classWeightSums(labels[i], bin) += weights[i];
+    else
+      ++classCounts(labels[i], bin);
+  }
+
+  // Choose the best boundary between two bins.  Also, force a minimum leaf
+  // size of 1 (empty children don't make sense).
+  double bestFoundGain = std::min(bestGain + minimumGainSplit, 0.0);
+  bool improved = false;
+  const size_t minimum = std::max(minimumLeafSize, (size_t) 1);
+
+  // The left child starts empty, and the right child has all the points.
+  arma::vec leftWeightSums, rightWeightSums;
+  arma::Col<size_t> leftCounts, rightCounts;
+  double totalWeight = 0.0;
+  double totalLeftWeight = 0.0;
+  double totalRightWeight = 0.0;
+  if (UseWeights)
+  {
+    leftWeightSums.zeros(numClasses);
+    rightWeightSums = arma::sum(classWeightSums, 1);
+    totalWeight = arma::accu(rightWeightSums);
+    totalRightWeight = totalWeight;
+    bestFoundGain *= totalWeight;
+  }
+  else
+  {
+    leftCounts.zeros(numClasses);
+    rightCounts = arma::sum(classCounts, 1);
+    bestFoundGain *= data.n_elem;
+  }
+
+  size_t leftPoints = 0;
+  for (size_t bin = 0; bin < bins - 1; ++bin)
+  {
+    // An empty bin gives the same split as the previous boundary.
+    if (binCounts[bin] == 0)
+      continue;
+
+    // Move the points of the bin to the left child.
+    leftPoints += binCounts[bin];
+    if (UseWeights)
+    {
+      const double binWeight = arma::accu(classWeightSums.col(bin));
+      leftWeightSums += classWeightSums.col(bin);
+      rightWeightSums -= classWeightSums.col(bin);
+      totalLeftWeight += binWeight;
+      totalRightWeight -= binWeight;
+    }
+    else
+    {
+      leftCounts += classCounts.col(bin);
+      rightCounts -= classCounts.col(bin);
+    }
+
+    const size_t rightPoints = data.n_elem - leftPoints;
+    if (leftPoints < minimum)
+      continue;
+    if (rightPoints < minimum)
+      break;
+
+    // Calculate the gain for the left and right child.  Only use weights if
+    // needed.
+    const double leftGain = UseWeights ?
+        FitnessFunction::template EvaluatePtr<true>(leftWeightSums.memptr(),
+            numClasses, totalLeftWeight) :
+        FitnessFunction::template EvaluatePtr<false>(leftCounts.memptr(),
+            numClasses, leftPoints);
+    const double rightGain = UseWeights ?
+        FitnessFunction::template EvaluatePtr<true>(rightWeightSums.memptr(),
+            numClasses, totalRightWeight) :
+        FitnessFunction::template EvaluatePtr<false>(rightCounts.memptr(),
+            numClasses, rightPoints);
+
+    double gain;
+    if (UseWeights)
+      gain = totalLeftWeight * leftGain + totalRightWeight * rightGain;
+    else
+      gain = double(leftPoints) * leftGain + double(rightPoints) * rightGain;
+
+    if (gain > bestFoundGain || gain >= 0.0)
+    {
+      // The split value is halfway between this bin and the next non-empty
+      // one.
+      size_t next = bin + 1;
+      while (binCounts[next] == 0)
+        ++next;
+
+      bestFoundGain = gain;
+      classProbabilities.set_size(1);
+      classProbabilities[0] = (binMax[bin] + binMin[next]) / 2.0;
+      improved = true;
+
+      // Corner case: no split will be better than this, so just take this one.
+      if (gain >= 0.0)
+        return gain;
+    }
+  }
+
+  // If we didn't improve, return the original gain exactly as we got it
+  // (without introducing floating point errors).
+  if (!improved)
+    return DBL_MAX;
+
+  if (UseWeights)
+    bestFoundGain /= totalWeight;
+  else
+    bestFoundGain /= data.n_elem;
+
+  return bestFoundGain;
+}
+
+template<typename FitnessFunction>
+template<typename ElemType>
+size_t HistogramNumericSplit<FitnessFunction>::CalculateDirection(
+    const ElemType& point,
+    const arma::Col<ElemType>& classProbabilities,
+    const AuxiliarySplitInfo<ElemType>& /* aux */)
+{
+  if (point <= classProbabilities[0])
+    return 0; // Go left.
+  else
+    return 1; // Go right.
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
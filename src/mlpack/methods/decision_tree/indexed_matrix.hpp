@@ -0,0 +1,127 @@
+/**
+ * @file methods/decision_tree/indexed_matrix.hpp
+ *
+ * Definition of the IndexedMatrix class, which lets a decision tree train on
+ * a selection of the columns of a matrix without copying them.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_INDEXED_MATRIX_HPP
+#define MLPACK_METHODS_DECISION_TREE_INDEXED_MATRIX_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * An IndexedMatrix is a matrix whose columns are columns of another matrix,
+ * given by their indices; the same column may be given several times, as in a
+ * bootstrap sample.  It can be given to DecisionTree in place of the dataset,
+ * in which case the tree reorders the indices instead of the columns, and the
+ * other matrix is not copied or modified (it must outlive the IndexedMatrix).
+ * The tree that is trained is the same as the one trained on a copy of the
+ * selected columns.
+ *
+ * Only the operations that DecisionTree needs are provided.
+ *
+ * @code
+ * arma::uvec indices = ...;
+ * IndexedMatrix<arma::mat> view(dataset, indices);
+ * arma::Row<size_t> sampleLabels = labels.cols(indices);
+ * DecisionTree<> tree(view, sampleLabels, numClasses);
+ * @endcode
+ *
+ * @tparam MatType Type of the matrix that holds the columns.
+ */
+template<typename MatType>
+class IndexedMatrix
+{
+ public:
+  //! The type of the elements of the matrix.
+  typedef typename MatType::elem_type elem_type;
+
+  /**
+   * A range of columns of an IndexedMatrix; its rows are gathered into new
+   * vectors.
+   */
+  class Columns
+  {
+   public:
+    //! Create the range of columns from first to last, inclusive.
+    Columns(const IndexedMatrix& matrix,
+            const size_t first,
+            const size_t last) :
+        matrix(matrix), first(first), last(last) { }
+
+    //! Get the given row of the range of columns.
+    arma::Row<elem_type> row(const size_t r) const
+    {
+      arma::Row<elem_type> result(last - first + 1);
+      for (size_t i = first; i <= last; ++i)
+        result[i - first] = matrix(r, i);
+      return result;
+    }
+
+   private:
+    //! The matrix the columns belong to.
+    const IndexedMatrix& matrix;
+    //! The first column of the range.
+    size_t first;
+    //! The last column of the range.
+    size_t last;
+  };
+
+  /**
+   * Create an IndexedMatrix with the given columns of the given matrix.
+   *
+   * @param matrix Matrix that holds the columns.
+   * @param indices Indices of the columns in the matrix.
+   */
+  IndexedMatrix(const MatType& matrix, arma::uvec indices) :
+      n_rows(matrix.n_rows),
+      n_cols(indices.n_elem),
+      matrix(&matrix),
+      indices(std::move(indices))
+  { }
+
+  //! Get the element at the given row and column.
+  elem_type operator()(const size_t r, const size_t c) const
+  {
+    return (*matrix)(r, indices[c]);
+  }
+
+  //! Get the range of columns from first to last, inclusive.
+  Columns cols(const size_t first, const size_t last) const
+  {
+    return Columns(*this, first, last);
+  }
+
+  //! Swap two columns; only the indices are swapped.
+  void swap_cols(const size_t a, const size_t b)
+  {
+    std::swap(indices[a], indices[b]);
+  }
+
+  //! Get the indices of the columns in the matrix.
+  const arma::uvec& Indices() const { return indices; }
+
+  //! The number of rows.
+  size_t n_rows;
+  //! The number of columns.
+  size_t n_cols;
+
+ private:
+  //! The matrix that holds the columns.
+  const MatType* matrix;
+  //! The indices of the columns in the matrix.
+  arma::uvec indices;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,38 @@
+/**
+ * @file methods/decision_tree/numeric_split_traits.hpp
+ *
+ * This provides the NumericSplitTraits class, a template class to get
+ * information about the numeric split types of decision trees.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_NUMERIC_SPLIT_TRAITS_HPP
+#define MLPACK_METHODS_DECISION_TREE_NUMERIC_SPLIT_TRAITS_HPP
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * This is a template class that can provide information about a numeric split
+ * type.  By default, a split type gets only the values of a dimension; a split
+ * type that needs more can specialize this class.
+ */
+template<typename SplitType>
+struct NumericSplitTraits
+{
+  /**
+   * If true, the decision tree sorts each numeric dimension once before
+   * training, keeps the sorted order of the points of each node, and calls
+   * the overload of SplitIfBetter() that takes the sorted indices of the
+   * points of the node.
+   */
+  static const bool UsesSortedIndices = false;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,54 @@
+/**
+ * @file methods/decision_tree/presorted_binary_numeric_split.hpp
+ *
+ * A tree splitter that finds the best binary numeric split, using the order of
+ * the points that is computed once for the whole tree.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_PRESORTED_BINARY_NUMERIC_SPLIT_HPP
+#define MLPACK_METHODS_DECISION_TREE_PRESORTED_BINARY_NUMERIC_SPLIT_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "best_binary_numeric_split.hpp"
+#include "numeric_split_traits.hpp"
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The PresortedBinaryNumericSplit finds exactly the same splits as the
+ * BestBinaryNumericSplit, but the decision tree sorts each numeric dimension
+ * only once, at the root; the sorted lists of points are then partitioned
+ * (keeping their order) between the children of each node, as in the classic
+ * SPRINT and C4.5 implementations.  This takes O(n) time per dimension and
+ * node instead of O(n log n), at the price of one index per point and
+ * dimension of extra memory during training.
+ *
+ * @code
+ * DecisionTree<GiniGain, PresortedBinaryNumericSplit> tree(data, labels,
+ *     numClasses);
+ * @endcode
+ *
+ * @tparam FitnessFunction Fitness function to use to calculate gain.
+ */
+template<typename FitnessFunction>
+class PresortedBinaryNumericSplit :
+    public BestBinaryNumericSplit<FitnessFunction>
+{ };
+
+//! The decision tree gives the PresortedBinaryNumericSplit the sorted order of
+//! the points.
+template<typename FitnessFunction>
+struct NumericSplitTraits<PresortedBinaryNumericSplit<FitnessFunction> >
+{
+  static const bool UsesSortedIndices = true;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
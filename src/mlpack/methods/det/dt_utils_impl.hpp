@@ -173,7 +173,9 @@ DTree<MatType, TagType>* Trainer(MatType& dataset,
   Log::Info << prunedSequence.size() << " trees in the sequence; maximum alpha:"
       << " " << oldAlpha << "." << std::endl;
 
-  const MatType cvData(dataset);
+  // The tree was grown on a copy of the dataset, so the folds can read their
+  // test points from the dataset itself.
+  const MatType& cvData = dataset;
   const size_t testSize = dataset.n_cols / folds;
 
   arma::vec regularizationConstants(prunedSequence.size());
@@ -183,17 +185,22 @@ DTree<MatType, TagType>* Trainer(MatType& dataset,
   // Go through each fold.  On the Visual Studio compiler, we have to use
   // intmax_t because size_t is not yet supported by their OpenMP
   // implementation. omp_size_t is the appropriate type according to the
-  // platform.
-  #pragma omp parallel for shared(prunedSequence, regularizationConstants)
+  // platform.  The folds are scheduled dynamically, since the trees of some
+  // folds may be much larger than the others; threads without a fold help to
+  // grow the trees of the other folds (see DTree::Grow()).
+  #pragma omp parallel for schedule(dynamic) \
+      shared(prunedSequence, regularizationConstants)
   for (omp_size_t fold = 0; fold < (omp_size_t) folds; fold++)
   {
-    // Break up data into train and test sets.
+    // Break up data into train and test sets.  The test points are the columns
+    // [start, end) of the dataset; only the training points are copied, since
+    // growing the tree reorders them.
     const size_t start = fold * testSize;
     const size_t end = std::min((size_t) (fold + 1)
                                 * testSize, (size_t) cvData.n_cols);
+    const size_t testCount = end - start;
 
-    MatType test = cvData.cols(start, end - 1);
-    MatType train(cvData.n_rows, cvData.n_cols - test.n_cols);
+    MatType train(cvData.n_rows, cvData.n_cols - testCount);
 
     if (start == 0 && end < cvData.n_cols)
     {
@@ -231,9 +238,9 @@ DTree<MatType, TagType>* Trainer(MatType& dataset,
     {
       // Compute test values for this state of the tree.
       double cvVal = 0.0;
-      for (size_t j = 0; j < test.n_cols; j++)
+      for (size_t j = start; j < end; j++)
       {
-        arma::vec testPoint = test.unsafe_col(j);
+        const typename MatType::vec_type testPoint = cvData.col(j);
         cvVal += cvDTree.ComputeValue(testPoint);
       }
 
@@ -248,9 +255,9 @@ DTree<MatType, TagType>* Trainer(MatType& dataset,
 
     // Compute test values for this state of the tree.
     double cvVal = 0.0;
-    for (size_t i = 0; i < test.n_cols; ++i)
+    for (size_t i = start; i < end; ++i)
     {
-      typename MatType::vec_type testPoint = test.unsafe_col(i);
+      const typename MatType::vec_type testPoint = cvData.col(i);
       cvVal += cvDTree.ComputeValue(testPoint);
     }
 
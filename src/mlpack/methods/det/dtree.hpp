@@ -326,6 +326,19 @@ class DTree
   //! Return the minimum values.
   const StatType& MinVals() const { return minVals; }
 
+  /**
+   * Get or modify the number of points a node must have for its search over
+   * dimensions and the growth of its left child to be split into OpenMP tasks
+   * during Grow().  Smaller nodes are grown serially.  This only has an effect
+   * when mlpack is compiled with OpenMP, and the trees that are grown do not
+   * depend on it.  The default is 1000 points.
+   */
+  static size_t& ParallelThreshold()
+  {
+    static size_t parallelThreshold = 1000;
+    return parallelThreshold;
+  }
+
   /**
    * Serialize the density estimation tree.
    */
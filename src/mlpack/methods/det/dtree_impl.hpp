@@ -15,6 +15,10 @@
 #include <stack>
 #include <vector>
 
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
 using namespace mlpack;
 using namespace det;
 
@@ -453,21 +457,26 @@ bool DTree<MatType, TagType>::FindSplit(const MatType& data,
   double minError = logNegError;
   bool splitFound = false;
 
-  // Loop through each dimension.
-#ifdef _WIN32
-  #pragma omp parallel for default(shared)
-  for (intmax_t dim = 0; dim < (intmax_t) maxVals.n_elem; ++dim)
-#else
-  #pragma omp parallel for default(shared)
-  for (size_t dim = 0; dim < maxVals.n_elem; ++dim)
-#endif
+  // The best split of each dimension.  The dimensions are searched at the same
+  // time, and then the best split is taken in order of dimension, so that the
+  // tree doesn't depend on the number of threads.  (std::vector<bool> can't be
+  // written by several threads at once.)
+  const size_t dims = maxVals.n_elem;
+  std::vector<char> dimSplitsFound(dims, false);
+  std::vector<double> dimErrors(dims);
+  std::vector<double> dimLeftErrors(dims);
+  std::vector<double> dimRightErrors(dims);
+  std::vector<ElemType> dimSplitValues(dims);
+
+  // Search one dimension.
+  auto searchDim = [&](const size_t dim)
   {
     const ElemType min = minVals[dim];
     const ElemType max = maxVals[dim];
 
     // If there is nothing to split in this dimension, move on.
     if (max - min == 0.0)
-      continue; // Skip to next dimension.
+      return; // Skip to next dimension.
 
     // Find the log volume of all the other dimensions.
     const double volumeWithoutDim = logVolume - std::log(max - min);
@@ -528,22 +537,54 @@ bool DTree<MatType, TagType>::FindSplit(const MatType& data,
       }
     }
 
-    const double actualMinDimError = std::log(minDimError)
-      - 2 * std::log((double) data.n_cols)
-      - volumeWithoutDim;
-
-#pragma omp critical(DTreeFindUpdate)
-    if ((actualMinDimError > minError) && dimSplitFound)
+    if (dimSplitFound)
     {
       // Calculate actual error (in logspace) by adding terms back to our
       // estimate.
-      minError = actualMinDimError;
-      splitDim = dim;
-      splitValue = dimSplitValue;
-      leftError = std::log(dimLeftError) - 2 * std::log((double) data.n_cols)
+      dimErrors[dim] = std::log(minDimError)
+        - 2 * std::log((double) data.n_cols)
+        - volumeWithoutDim;
+      dimLeftErrors[dim] = std::log(dimLeftError)
+        - 2 * std::log((double) data.n_cols)
         - volumeWithoutDim;
-      rightError = std::log(dimRightError) - 2 * std::log((double) data.n_cols)
+      dimRightErrors[dim] = std::log(dimRightError)
+        - 2 * std::log((double) data.n_cols)
         - volumeWithoutDim;
+      dimSplitValues[dim] = dimSplitValue;
+      dimSplitsFound[dim] = true;
+    }
+  };
+
+#ifdef HAS_OPENMP
+  if (omp_in_parallel())
+  {
+    // The tree is being grown by tasks (or a cross-validation fold is being
+    // grown), so the dimensions of large nodes are searched by tasks too.
+    for (size_t dim = 0; dim < dims; ++dim)
+    {
+      #pragma omp task default(shared) firstprivate(dim) \
+          if(points >= ParallelThreshold())
+      searchDim(dim);
+    }
+    #pragma omp taskwait
+  }
+  else
+#endif
+  {
+    #pragma omp parallel for default(shared)
+    for (omp_size_t dim = 0; dim < (omp_size_t) dims; ++dim)
+      searchDim(dim);
+  }
+
+  for (size_t dim = 0; dim < dims; ++dim)
+  {
+    if (dimSplitsFound[dim] && (dimErrors[dim] > minError))
+    {
+      minError = dimErrors[dim];
+      splitDim = dim;
+      splitValue = dimSplitValues[dim];
+      leftError = dimLeftErrors[dim];
+      rightError = dimRightErrors[dim];
       splitFound = true;
     } // end if better split found in this dimension.
   }
@@ -596,6 +637,21 @@ double DTree<MatType, TagType>::Grow(MatType& data,
   Log::Assert(data.n_rows == maxVals.n_elem);
   Log::Assert(data.n_rows == minVals.n_elem);
 
+#ifdef HAS_OPENMP
+  // Start the threads at the root, if it is large enough; below it, the
+  // dimensions and the children of large nodes are handled by tasks.
+  if ((size_t) (end - start) >= ParallelThreshold() && omp_get_level() == 0)
+  {
+    double alpha = 0.0;
+    #pragma omp parallel
+    {
+      #pragma omp single
+      alpha = Grow(data, oldFromNew, useVolReg, maxLeafSize, minLeafSize);
+    }
+    return alpha;
+  }
+#endif
+
   double leftG, rightG;
 
   // Compute points ratio.
@@ -637,10 +693,18 @@ double DTree<MatType, TagType>::Grow(MatType& data,
       left = new DTree(maxValsL, minValsL, start, splitIndex, leftError);
       right = new DTree(maxValsR, minValsR, splitIndex, end, rightError);
 
+      // The children only reorder their own columns of the dataset, so a large
+      // left child is grown by a task while this thread grows the right
+      // child.  Reordering the columns of a sparse matrix changes the whole
+      // matrix, so sparse children are grown one after the other.
+      const bool leftTask = !arma::is_SpMat<MatType>::value &&
+          (splitIndex - start >= ParallelThreshold());
+      #pragma omp task default(shared) if(leftTask)
       leftG = left->Grow(data, oldFromNew, useVolReg, maxLeafSize,
                          minLeafSize);
       rightG = right->Grow(data, oldFromNew, useVolReg, maxLeafSize,
                            minLeafSize);
+      #pragma omp taskwait
 
       // Store values of R(T~) and |T~|.
       subtreeLeaves = left->SubtreeLeaves() + right->SubtreeLeaves();
@@ -0,0 +1,121 @@
+/**
+ * @file methods/emst/concurrent_union_find.hpp
+ *
+ * A union-find data structure that can be used by many threads at once.  Like
+ * UnionFind, it tracks the components of a graph, but Find() and Union() may be
+ * called concurrently without any locking.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_EMST_CONCURRENT_UNION_FIND_HPP
+#define MLPACK_METHODS_EMST_CONCURRENT_UNION_FIND_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <atomic>
+
+namespace mlpack {
+namespace emst {
+
+/**
+ * A lock-free union-find data structure.  Each point in the graph is initially
+ * in its own component.  Calling Union(x, y) unites the components indexed by x
+ * and y, and Find(x) returns the index of the component containing point x.
+ * Both may be called from any number of threads at the same time.
+ *
+ * The parent of each element is stored atomically.  Union() links the root
+ * with the larger index below the root with the smaller index with a single
+ * compare-and-swap, retrying if another thread changed either root first; this
+ * means that the root of each component is always its smallest element, and no
+ * cycle can ever be created.  Find() uses path splitting, which also only
+ * replaces parents with other ancestors, so it is safe with concurrent calls to
+ * Union().  This is the approach of the following paper, without the ranks:
+ *
+ * @code
+ * @inproceedings{anderson1991wait,
+ *   title={Wait-free parallel algorithms for the union-find problem},
+ *   author={Anderson, Richard J. and Woll, Heather},
+ *   booktitle={Proceedings of the Twenty-Third Annual ACM Symposium on Theory
+ *       of Computing (STOC '91)},
+ *   pages={370--380},
+ *   year={1991}
+ * }
+ * @endcode
+ */
+class ConcurrentUnionFind
+{
+ private:
+  //! The parent of each element; roots are their own parent.
+  std::vector<std::atomic<size_t>> parent;
+
+ public:
+  //! Construct the object with the given size.
+  ConcurrentUnionFind(const size_t size) : parent(size)
+  {
+    for (size_t i = 0; i < size; ++i)
+      parent[i].store(i);
+  }
+
+  /**
+   * Returns the component containing an element.  The path to the root is
+   * shortened along the way.
+   *
+   * @param x the component to be found
+   * @return The index of the component containing x
+   */
+  size_t Find(size_t x)
+  {
+    size_t p = parent[x].load();
+    while (p != x)
+    {
+      // Point x at its grandparent.  If another thread changed the parent of x
+      // in the meantime, it is now an ancestor anyway, so nothing is lost.
+      const size_t grandparent = parent[p].load();
+      if (grandparent != p)
+      {
+        size_t expected = p;
+        parent[x].compare_exchange_weak(expected, grandparent);
+      }
+
+      x = p;
+      p = grandparent;
+    }
+
+    return x;
+  }
+
+  /**
+   * Union the components containing x and y.
+   *
+   * @param x one component
+   * @param y the other component
+   * @return true if the components were different and have been united, false
+   *     if x and y were already in the same component.
+   */
+  bool Union(const size_t x, const size_t y)
+  {
+    while (true)
+    {
+      size_t xRoot = Find(x);
+      size_t yRoot = Find(y);
+
+      if (xRoot == yRoot)
+        return false;
+
+      // Link the larger root below the smaller one.  This fails if the larger
+      // root has been linked to something else since we found it.
+      if (xRoot < yRoot)
+        std::swap(xRoot, yRoot);
+      size_t expected = xRoot;
+      if (parent[xRoot].compare_exchange_strong(expected, yRoot))
+        return true;
+    }
+  }
+}; // class ConcurrentUnionFind
+
+} // namespace emst
+} // namespace mlpack
+
+#endif // MLPACK_METHODS_EMST_CONCURRENT_UNION_FIND_HPP
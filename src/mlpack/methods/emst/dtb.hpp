@@ -27,11 +27,13 @@
 
 #include "dtb_stat.hpp"
 #include "edge_pair.hpp"
+#include "concurrent_union_find.hpp"
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/metrics/lmetric.hpp>
 
 #include <mlpack/core/tree/binary_space_tree.hpp>
+#include <mlpack/core/tree/traversal_statistics.hpp>
 
 namespace mlpack {
 namespace emst /** Euclidean Minimum Spanning Trees. */ {
@@ -40,6 +42,13 @@ namespace emst /** Euclidean Minimum Spanning Trees. */ {
  * Performs the MST calculation using the Dual-Tree Boruvka algorithm, using any
  * type of tree.
  *
+ * Each Boruvka round is parallelized with OpenMP: the query tree is split into
+ * disjoint subtrees, which are traversed against the whole reference tree by
+ * different threads, and the edges found are then added with a concurrent
+ * union-find structure.  (Trees that hold points in their internal nodes or
+ * duplicate points between nodes, like the cover tree, are traversed by one
+ * thread.)
+ *
  * For more information on the algorithm, see the following citation:
  *
  * @code
@@ -103,7 +112,7 @@ class DualTreeBoruvka
   std::vector<EdgePair> edges; // We must use vector with non-numerical types.
 
   //! Connections.
-  UnionFind connections;
+  ConcurrentUnionFind connections;
 
   //! List of edge nodes.
   arma::Col<size_t> neighborsInComponent;
@@ -112,12 +121,25 @@ class DualTreeBoruvka
   //! List of edge distances.
   arma::vec neighborsDistances;
 
+  //! The pruning bound of each component during the traversal.
+  std::vector<std::atomic<double>> componentDistances;
+  //! The distance to the candidate neighbor of each point.
+  arma::vec pointDistances;
+  //! The candidate neighbor of each point.
+  arma::Col<size_t> pointNeighbors;
+
+  //! Disjoint query subtrees that can be traversed in parallel.
+  std::vector<Tree*> queryNodes;
+
   //! Total distance of the tree.
   double totalDist;
 
   //! The instantiated metric.
   MetricType metric;
 
+  //! The statistics of the tree traversals of the last MST computation.
+  tree::TraversalStatistics statistics;
+
   //! For sorting the edge list after the computation.
   struct SortEdgesHelper
   {
@@ -175,6 +197,11 @@ class DualTreeBoruvka
    */
   void ComputeMST(arma::mat& results);
 
+  //! Get the statistics of the tree traversals of the last call to
+  //! ComputeMST(), summed over all of its iterations.  These are empty for
+  //! naive computation.
+  const tree::TraversalStatistics& Statistics() const { return statistics; }
+
  private:
   /**
    * Adds a single edge to the edge list
@@ -186,6 +213,12 @@ class DualTreeBoruvka
    */
   void AddAllEdges();
 
+  /**
+   * Split the tree into disjoint subtrees, at least one per thread if
+   * possible, and store them in queryNodes.
+   */
+  void SplitQueryTree();
+
   /**
    * Unpermute the edge list and output it to results.
    */
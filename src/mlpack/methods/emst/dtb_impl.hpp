@@ -58,6 +58,7 @@ DualTreeBoruvka<MetricType, MatType, TreeType>::DualTreeBoruvka(
     ownTree(!naive),
     naive(naive),
     connections(dataset.n_cols),
+    componentDistances(dataset.n_cols),
     totalDist(0.0),
     metric(metric)
 {
@@ -67,6 +68,15 @@ DualTreeBoruvka<MetricType, MatType, TreeType>::DualTreeBoruvka(
   neighborsOutComponent.set_size(data.n_cols);
   neighborsDistances.set_size(data.n_cols);
   neighborsDistances.fill(DBL_MAX);
+
+  for (size_t i = 0; i < data.n_cols; ++i)
+    componentDistances[i].store(DBL_MAX);
+  pointDistances.set_size(data.n_cols);
+  pointDistances.fill(DBL_MAX);
+  pointNeighbors.set_size(data.n_cols);
+
+  if (!naive)
+    SplitQueryTree();
 }
 
 template<
@@ -83,6 +93,7 @@ DualTreeBoruvka<MetricType, MatType, TreeType>::DualTreeBoruvka(
     ownTree(false),
     naive(false),
     connections(data.n_cols),
+    componentDistances(data.n_cols),
     totalDist(0.0),
     metric(metric)
 {
@@ -92,6 +103,15 @@ DualTreeBoruvka<MetricType, MatType, TreeType>::DualTreeBoruvka(
   neighborsOutComponent.set_size(data.n_cols);
   neighborsDistances.set_size(data.n_cols);
   neighborsDistances.fill(DBL_MAX);
+
+  for (size_t i = 0; i < data.n_cols; ++i)
+    componentDistances[i].store(DBL_MAX);
+  pointDistances.set_size(data.n_cols);
+  pointDistances.fill(DBL_MAX);
+  pointNeighbors.set_size(data.n_cols);
+
+  if (!naive)
+    SplitQueryTree();
 }
 
 template<
@@ -124,21 +144,42 @@ void DualTreeBoruvka<MetricType, MatType, TreeType>::ComputeMST(
   totalDist = 0; // Reset distance.
 
   typedef DTBRules<MetricType, Tree> RuleType;
-  RuleType rules(data, connections, neighborsDistances, neighborsInComponent,
-                 neighborsOutComponent, metric);
+  size_t baseCases = 0;
+  size_t scores = 0;
+  statistics.Reset();
   while (edges.size() < (data.n_cols - 1))
   {
-    if (naive)
+    // Each thread has its own rules, and handles its own query points, so the
+    // candidate neighbors of the points are never shared between threads.
+    #pragma omp parallel reduction(+:baseCases, scores)
     {
-      // Full O(N^2) traversal.
-      for (size_t i = 0; i < data.n_cols; ++i)
-        for (size_t j = 0; j < data.n_cols; ++j)
-          rules.BaseCase(i, j);
-    }
-    else
-    {
-      typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
-      traverser.Traverse(*tree, *tree);
+      RuleType rules(data, connections, componentDistances, pointDistances,
+          pointNeighbors, metric);
+
+      if (naive)
+      {
+        // Full O(N^2) traversal.
+        #pragma omp for
+        for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+          for (size_t j = 0; j < data.n_cols; ++j)
+            rules.BaseCase(i, j);
+      }
+      else
+      {
+        tree::TraversalStatistics threadStatistics;
+        tree::CountingRules<RuleType> countingRules(rules, threadStatistics);
+        typename Tree::template DualTreeTraverser<
+            tree::CountingRules<RuleType>> traverser(countingRules);
+        #pragma omp for schedule(dynamic)
+        for (omp_size_t i = 0; i < (omp_size_t) queryNodes.size(); ++i)
+          traverser.Traverse(*queryNodes[i], *tree);
+
+        #pragma omp critical(DTBStatistics)
+        statistics += threadStatistics;
+      }
+
+      baseCases += rules.BaseCases();
+      scores += rules.Scores();
     }
 
     AddAllEdges();
@@ -148,14 +189,17 @@ void DualTreeBoruvka<MetricType, MatType, TreeType>::ComputeMST(
     Log::Info << edges.size() << " edges found so far." << std::endl;
     if (!naive)
     {
-      Log::Info << rules.BaseCases() << " cumulative base cases." << std::endl;
-      Log::Info << rules.Scores() << " cumulative node combinations scored."
+      Log::Info << baseCases << " cumulative base cases." << std::endl;
+      Log::Info << scores << " cumulative node combinations scored."
           << std::endl;
     }
   }
 
   Timer::Stop("emst/mst_computation");
 
+  if (!naive)
+    statistics.Print(Log::Info);
+
   EmitResults(results);
 
   Log::Info << "Total spanning tree length: " << totalDist << std::endl;
@@ -195,19 +239,105 @@ template<
              typename TreeMatType> class TreeType>
 void DualTreeBoruvka<MetricType, MatType, TreeType>::AddAllEdges()
 {
+  // The candidate edge of each component is the best candidate of its points.
+  std::vector<size_t> components;
   for (size_t i = 0; i < data.n_cols; i++)
   {
-    size_t component = connections.Find(i);
-    size_t inEdge = neighborsInComponent[component];
-    size_t outEdge = neighborsOutComponent[component];
-    if (connections.Find(inEdge) != connections.Find(outEdge))
+    const size_t component = connections.Find(i);
+    if (component == i)
+      components.push_back(component);
+
+    if (pointDistances[i] < neighborsDistances[component])
+    {
+      neighborsDistances[component] = pointDistances[i];
+      neighborsInComponent[component] = i;
+      neighborsOutComponent[component] = pointNeighbors[i];
+    }
+  }
+
+  size_t numThreads = 1;
+  #ifdef HAS_OPENMP
+    numThreads = omp_get_max_threads();
+  #endif
+
+  // Add the candidate edges in parallel.  Union() fails for an edge whose
+  // endpoints have already been joined by other edges of this round.
+  std::vector<std::vector<EdgePair>> threadEdges(numThreads);
+  double roundDist = 0.0;
+  #pragma omp parallel for reduction(+:roundDist)
+  for (omp_size_t c = 0; c < (omp_size_t) components.size(); ++c)
+  {
+    const size_t component = components[c];
+    const size_t inEdge = neighborsInComponent[component];
+    const size_t outEdge = neighborsOutComponent[component];
+    if (neighborsDistances[component] == DBL_MAX ||
+        !connections.Union(inEdge, outEdge))
+      continue;
+
+    size_t threadId = 0;
+    #ifdef HAS_OPENMP
+      threadId = omp_get_thread_num();
+    #endif
+
+    // totalDist = totalDist + dist;
+    // changed to make this agree with the cover tree code
+    roundDist += neighborsDistances[component];
+    threadEdges[threadId].push_back(EdgePair(std::min(inEdge, outEdge),
+        std::max(inEdge, outEdge), neighborsDistances[component]));
+  }
+
+  totalDist += roundDist;
+  for (size_t t = 0; t < threadEdges.size(); ++t)
+    for (size_t e = 0; e < threadEdges[t].size(); ++e)
+      AddEdge(threadEdges[t][e].Lesser(), threadEdges[t][e].Greater(),
+          threadEdges[t][e].Distance());
+}
+
+/**
+ * Split the tree into disjoint subtrees to be traversed in parallel.
+ */
+template<
+    typename MetricType,
+    typename MatType,
+    template<typename TreeMetricType,
+             typename TreeStatType,
+             typename TreeMatType> class TreeType>
+void DualTreeBoruvka<MetricType, MatType, TreeType>::SplitQueryTree()
+{
+  size_t numThreads = 1;
+  #ifdef HAS_OPENMP
+    numThreads = omp_get_max_threads();
+  #endif
+
+  // Ask for a few subtrees per thread, to balance the load between threads
+  // with dynamic scheduling.
+  const size_t targetNodes = (numThreads == 1) ? 1 : 8 * numThreads;
+
+  // Each point must belong to exactly one subtree, so a node can only be
+  // replaced by its children if it holds no points itself, and if points are
+  // never duplicated between children.
+  queryNodes.clear();
+  queryNodes.push_back(tree);
+  bool split = !tree::TreeTraits<Tree>::HasDuplicatedPoints;
+  while (split && queryNodes.size() < targetNodes)
+  {
+    split = false;
+    std::vector<Tree*> newQueryNodes;
+    for (size_t i = 0; i < queryNodes.size(); ++i)
     {
-      // totalDist = totalDist + dist;
-      // changed to make this agree with the cover tree code
-      totalDist += neighborsDistances[component];
-      AddEdge(inEdge, outEdge, neighborsDistances[component]);
-      connections.Union(inEdge, outEdge);
+      Tree* node = queryNodes[i];
+      if (node->NumChildren() == 0 || node->NumPoints() != 0)
+      {
+        newQueryNodes.push_back(node);
+        continue;
+      }
+
+      for (size_t j = 0; j < node->NumChildren(); ++j)
+        newQueryNodes.push_back(&node->Child(j));
+      split = true;
     }
+
+    queryNodes.swap(newQueryNodes);
   }
 }
 
@@ -318,8 +448,16 @@ template<
              typename TreeMatType> class TreeType>
 void DualTreeBoruvka<MetricType, MatType, TreeType>::Cleanup()
 {
-  for (size_t i = 0; i < data.n_cols; i++)
+  // Finding the component of every point also compresses the paths in the
+  // union-find structure, so that the next traversal does not have to.
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; i++)
+  {
     neighborsDistances[i] = DBL_MAX;
+    componentDistances[i].store(DBL_MAX);
+    pointDistances[i] = DBL_MAX;
+    connections.Find(i);
+  }
 
   if (!naive)
     CleanupHelper(tree);
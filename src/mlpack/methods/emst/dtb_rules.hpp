@@ -16,18 +16,39 @@
 
 #include <mlpack/core/tree/traversal_info.hpp>
 
+#include "concurrent_union_find.hpp"
+
 namespace mlpack {
 namespace emst {
 
+/**
+ * The rules for the dual-tree traversal of one Boruvka round: for each point,
+ * find its nearest neighbor outside of its component.  Several DTBRules objects
+ * may be used by different threads at the same time, as long as each query
+ * point is only ever handled by one of them (i.e. the threads traverse disjoint
+ * query subtrees).  The candidate of each query point is stored per point, and
+ * only the pruning bound of each component is shared between threads.
+ */
 template<typename MetricType, typename TreeType>
 class DTBRules
 {
  public:
+  /**
+   * Construct the rules.
+   *
+   * @param dataSet The data points.
+   * @param connections The components found so far.
+   * @param componentDistances The distance to the best candidate found so far
+   *     for each component, shared between threads and used for pruning.
+   * @param pointDistances The distance to the candidate neighbor of each point.
+   * @param pointNeighbors The candidate neighbor of each point.
+   * @param metric The instantiated metric.
+   */
   DTBRules(const arma::mat& dataSet,
-           UnionFind& connections,
-           arma::vec& neighborsDistances,
-           arma::Col<size_t>& neighborsInComponent,
-           arma::Col<size_t>& neighborsOutComponent,
+           ConcurrentUnionFind& connections,
+           std::vector<std::atomic<double>>& componentDistances,
+           arma::vec& pointDistances,
+           arma::Col<size_t>& pointNeighbors,
            MetricType& metric);
 
   double BaseCase(const size_t queryIndex, const size_t referenceIndex);
@@ -102,18 +123,19 @@ class DTBRules
   const arma::mat& dataSet;
 
   //! Stores the tree structure so far
-  UnionFind& connections;
+  ConcurrentUnionFind& connections;
 
-  //! The distance to the candidate nearest neighbor for each component.
-  arma::vec& neighborsDistances;
+  //! The distance to the best candidate nearest neighbor found so far for each
+  //! component.  This may be larger than the best candidate found by another
+  //! thread, but it is always a valid bound for pruning.
+  std::vector<std::atomic<double>>& componentDistances;
 
-  //! The index of the point in the component that is an endpoint of the
-  //! candidate edge.
-  arma::Col<size_t>& neighborsInComponent;
+  //! The distance to the candidate nearest neighbor for each point.
+  arma::vec& pointDistances;
 
-  //! The index of the point outside of the component that is an endpoint
-  //! of the candidate edge.
-  arma::Col<size_t>& neighborsOutComponent;
+  //! The index of the candidate nearest neighbor (outside of the component of
+  //! the point) for each point.
+  arma::Col<size_t>& pointNeighbors;
 
   //! The instantiated metric.
   MetricType& metric;
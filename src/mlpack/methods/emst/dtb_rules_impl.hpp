@@ -18,17 +18,17 @@ namespace emst {
 template<typename MetricType, typename TreeType>
 DTBRules<MetricType, TreeType>::
 DTBRules(const arma::mat& dataSet,
-         UnionFind& connections,
-         arma::vec& neighborsDistances,
-         arma::Col<size_t>& neighborsInComponent,
-         arma::Col<size_t>& neighborsOutComponent,
+         ConcurrentUnionFind& connections,
+         std::vector<std::atomic<double>>& componentDistances,
+         arma::vec& pointDistances,
+         arma::Col<size_t>& pointNeighbors,
          MetricType& metric)
 :
   dataSet(dataSet),
   connections(connections),
-  neighborsDistances(neighborsDistances),
-  neighborsInComponent(neighborsInComponent),
-  neighborsOutComponent(neighborsOutComponent),
+  componentDistances(componentDistances),
+  pointDistances(pointDistances),
+  pointNeighbors(pointNeighbors),
   metric(metric),
   baseCases(0),
   scores(0)
@@ -57,18 +57,30 @@ double DTBRules<MetricType, TreeType>::BaseCase(const size_t queryIndex,
     double distance = metric.Evaluate(dataSet.col(queryIndex),
                                       dataSet.col(referenceIndex));
 
-    if (distance < neighborsDistances[queryComponentIndex])
+    // Only this thread handles this query point.
+    if (distance < pointDistances[queryIndex])
     {
       Log::Assert(queryIndex != referenceIndex);
 
-      neighborsDistances[queryComponentIndex] = distance;
-      neighborsInComponent[queryComponentIndex] = queryIndex;
-      neighborsOutComponent[queryComponentIndex] = referenceIndex;
+      pointDistances[queryIndex] = distance;
+      pointNeighbors[queryIndex] = referenceIndex;
+    }
+
+    // Another thread may lower the bound of the component between the load and
+    // the store; then the bound is a little looser than it could be, but it is
+    // still the distance of an edge leaving the component, so it is valid.
+    if (distance < componentDistances[queryComponentIndex].load(
+        std::memory_order_relaxed))
+    {
+      componentDistances[queryComponentIndex].store(distance,
+          std::memory_order_relaxed);
     }
   }
 
-  if (newUpperBound < neighborsDistances[queryComponentIndex])
-    newUpperBound = neighborsDistances[queryComponentIndex];
+  const double componentDistance = componentDistances[
+      queryComponentIndex].load(std::memory_order_relaxed);
+  if (newUpperBound < componentDistance)
+    newUpperBound = componentDistance;
 
   Log::Assert(newUpperBound >= 0.0);
 
@@ -93,8 +105,8 @@ double DTBRules<MetricType, TreeType>::Score(const size_t queryIndex,
 
   // If all the points in the reference node are farther than the candidate
   // nearest neighbor for the query's component, we prune.
-  return neighborsDistances[queryComponentIndex] < distance
-      ? DBL_MAX : distance;
+  return componentDistances[queryComponentIndex].load(
+      std::memory_order_relaxed) < distance ? DBL_MAX : distance;
 }
 
 template<typename MetricType, typename TreeType>
@@ -104,8 +116,8 @@ double DTBRules<MetricType, TreeType>::Rescore(const size_t queryIndex,
 {
   // We don't need to check component membership again, because it can't
   // change inside a single iteration.
-  return (oldScore > neighborsDistances[connections.Find(queryIndex)])
-      ? DBL_MAX : oldScore;
+  return (oldScore > componentDistances[connections.Find(queryIndex)].load(
+      std::memory_order_relaxed)) ? DBL_MAX : oldScore;
 }
 
 template<typename MetricType, typename TreeType>
@@ -153,7 +165,8 @@ inline double DTBRules<MetricType, TreeType>::CalculateBound(
   for (size_t i = 0; i < queryNode.NumPoints(); ++i)
   {
     const size_t pointComponent = connections.Find(queryNode.Point(i));
-    const double bound = neighborsDistances[pointComponent];
+    const double bound = componentDistances[pointComponent].load(
+        std::memory_order_relaxed);
 
     if (bound > worstPointBound)
       worstPointBound = bound;
@@ -17,6 +17,7 @@
 #include <mlpack/core/metrics/ip_metric.hpp>
 #include "fastmks_stat.hpp"
 #include <mlpack/core/tree/cover_tree.hpp>
+#include <mlpack/core/tree/traversal_statistics.hpp>
 #include <queue>
 
 namespace mlpack {
@@ -297,6 +298,10 @@ class FastMKS
   //! Modify whether or not brute-force (naive) search is used.
   bool& Naive() { return naive; }
 
+  //! Get the statistics of the tree traversals of the last search.  These are
+  //! empty for naive search.
+  const tree::TraversalStatistics& Statistics() const { return statistics; }
+
   //! Serialize the model.
   template<typename Archive>
   void serialize(Archive& ar, const unsigned int /* version */);
@@ -320,6 +325,18 @@ class FastMKS
   //! The instantiated inner-product metric induced by the given kernel.
   metric::IPMetric<KernelType> metric;
 
+  //! The statistics of the tree traversals of the last search.
+  tree::TraversalStatistics statistics;
+
+  /**
+   * Traverse the given query tree against the reference tree with the given
+   * rules.  With OpenMP, disjoint subtrees of the query tree are traversed in
+   * parallel, each with its own rules object that shares the candidate lists
+   * of the given one.
+   */
+  template<typename RuleType>
+  void DualTreeTraverse(RuleType& rules, Tree& queryTree);
+
   //! Candidate represents a possible candidate point (value, index).
   typedef std::pair<double, size_t> Candidate;
 
@@ -18,6 +18,12 @@
 #include "fastmks_rules.hpp"
 
 #include <mlpack/core/kernels/gaussian_kernel.hpp>
+#include <mlpack/core/kernels/kernel_matrix.hpp>
+#include <mlpack/core/tree/subtree_frontier.hpp>
+
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
 
 namespace mlpack {
 namespace fastmks {
@@ -180,7 +186,8 @@ FastMKS<KernelType, MatType, TreeType>::FastMKS(const FastMKS& other) :
     setOwner(other.referenceTree == NULL),
     singleMode(other.singleMode),
     naive(other.naive),
-    metric(other.metric)
+    metric(other.metric),
+    statistics(other.statistics)
 {
   // Set reference set correctly.
   if (referenceTree)
@@ -201,7 +208,8 @@ FastMKS<KernelType, MatType, TreeType>::FastMKS(FastMKS&& other) :
     setOwner(other.setOwner),
     singleMode(other.singleMode),
     naive(other.naive),
-    metric(std::move(other.metric))
+    metric(std::move(other.metric)),
+    statistics(other.statistics)
 {
   // Clear information from the other.
   other.referenceSet = NULL;
@@ -210,6 +218,7 @@ FastMKS<KernelType, MatType, TreeType>::FastMKS(FastMKS&& other) :
   other.setOwner = false;
   other.singleMode = false;
   other.naive = false;
+  other.statistics.Reset();
 }
 
 template<typename KernelType,
@@ -248,6 +257,7 @@ FastMKS<KernelType, MatType, TreeType>::operator=(const FastMKS& other)
 
   singleMode = other.singleMode;
   naive = other.naive;
+  statistics = other.statistics;
 }
 
 template<typename KernelType,
@@ -418,6 +428,7 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
   }
 
   Timer::Start("computing_products");
+  statistics.Reset();
 
   // No remapping will be necessary because we are using the cover tree.
   indices.set_size(k, querySet.n_cols);
@@ -426,31 +437,44 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
   // Naive implementation.
   if (naive)
   {
-    // Simple double loop.  Stupid, slow, but a good benchmark.
-    for (size_t q = 0; q < querySet.n_cols; ++q)
+    // Compute the kernel values of a block of queries with every reference
+    // point at once, then find the best candidates of each query in parallel.
+    // The blocks are small enough that their kernel matrices (of about 2^22
+    // elements) fit in memory.
+    const size_t blockSize = std::max((size_t) 1, ((size_t) 1 << 22) /
+        std::max((size_t) 1, (size_t) referenceSet->n_cols));
+    arma::mat blockKernels;
+    for (size_t begin = 0; begin < querySet.n_cols; begin += blockSize)
     {
-      const Candidate def = std::make_pair(-DBL_MAX, size_t() - 1);
-      std::vector<Candidate> cList(k, def);
-      CandidateList pqueue(CandidateCmp(), std::move(cList));
+      const size_t end = std::min(begin + blockSize, (size_t) querySet.n_cols);
+      kernel::KernelMatrix(metric.Kernel(), *referenceSet,
+          querySet.cols(begin, end - 1), blockKernels);
 
-      for (size_t r = 0; r < referenceSet->n_cols; ++r)
+      #pragma omp parallel for
+      for (omp_size_t q = (omp_size_t) begin; q < (omp_size_t) end; ++q)
       {
-        const double eval = metric.Kernel().Evaluate(querySet.col(q),
-                                                     referenceSet->col(r));
+        const Candidate def = std::make_pair(-DBL_MAX, size_t() - 1);
+        std::vector<Candidate> cList(k, def);
+        CandidateList pqueue(CandidateCmp(), std::move(cList));
 
-        if (eval > pqueue.top().first)
+        for (size_t r = 0; r < referenceSet->n_cols; ++r)
         {
-          Candidate c = std::make_pair(eval, r);
-          pqueue.pop();
-          pqueue.push(c);
+          const double eval = blockKernels(r, q - begin);
+
+          if (eval > pqueue.top().first)
+          {
+            Candidate c = std::make_pair(eval, r);
+            pqueue.pop();
+            pqueue.push(c);
+          }
         }
-      }
 
-      for (size_t j = 1; j <= k; j++)
-      {
-        indices(k - j, q) = pqueue.top().second;
-        kernels(k - j, q) = pqueue.top().first;
-        pqueue.pop();
+        for (size_t j = 1; j <= k; j++)
+        {
+          indices(k - j, q) = pqueue.top().second;
+          kernels(k - j, q) = pqueue.top().first;
+          pqueue.pop();
+        }
       }
     }
 
@@ -467,13 +491,16 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
     typedef FastMKSRules<KernelType, Tree> RuleType;
     RuleType rules(*referenceSet, querySet, k, metric.Kernel());
 
-    typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
+    tree::CountingRules<RuleType> countingRules(rules, statistics);
+    typename Tree::template SingleTreeTraverser<tree::CountingRules<RuleType>>
+        traverser(countingRules);
 
     for (size_t i = 0; i < querySet.n_cols; ++i)
       traverser.Traverse(i, *referenceTree);
 
     Log::Info << rules.BaseCases() << " base cases." << std::endl;
     Log::Info << rules.Scores() << " scores." << std::endl;
+    statistics.Print(Log::Info);
 
     rules.GetResults(indices, kernels);
 
@@ -530,15 +557,15 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
   kernels.set_size(k, queryTree->Dataset().n_cols);
 
   Timer::Start("computing_products");
+  statistics.Reset();
   typedef FastMKSRules<KernelType, Tree> RuleType;
   RuleType rules(*referenceSet, queryTree->Dataset(), k, metric.Kernel());
 
-  typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
-
-  traverser.Traverse(*queryTree, *referenceTree);
+  DualTreeTraverse(rules, *queryTree);
 
   Log::Info << rules.BaseCases() << " base cases." << std::endl;
   Log::Info << rules.Scores() << " scores." << std::endl;
+  statistics.Print(Log::Info);
 
   rules.GetResults(indices, kernels);
 
@@ -557,41 +584,54 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
 {
   // No remapping will be necessary because we are using the cover tree.
   Timer::Start("computing_products");
+  statistics.Reset();
   indices.set_size(k, referenceSet->n_cols);
   kernels.set_size(k, referenceSet->n_cols);
 
   // Naive implementation.
   if (naive)
   {
-    // Simple double loop.  Stupid, slow, but a good benchmark.
-    for (size_t q = 0; q < referenceSet->n_cols; ++q)
+    // Compute the kernel values of a block of queries with every reference
+    // point at once, then find the best candidates of each query in parallel.
+    const size_t blockSize = std::max((size_t) 1, ((size_t) 1 << 22) /
+        std::max((size_t) 1, (size_t) referenceSet->n_cols));
+    arma::mat blockKernels;
+    for (size_t begin = 0; begin < referenceSet->n_cols; begin += blockSize)
     {
-      const Candidate def = std::make_pair(-DBL_MAX, size_t() - 1);
-      std::vector<Candidate> cList(k, def);
-      CandidateList pqueue(CandidateCmp(), std::move(cList));
+      const size_t end = std::min(begin + blockSize,
+          (size_t) referenceSet->n_cols);
+      kernel::KernelMatrix(metric.Kernel(), *referenceSet,
+          referenceSet->cols(begin, end - 1), blockKernels);
 
-      for (size_t r = 0; r < referenceSet->n_cols; ++r)
+      #pragma omp parallel for
+      for (omp_size_t q = (omp_size_t) begin; q < (omp_size_t) end; ++q)
       {
-        if (q == r)
-          continue; // Don't return the point as its own candidate.
+        const Candidate def = std::make_pair(-DBL_MAX, size_t() - 1);
+        std::vector<Candidate> cList(k, def);
+        CandidateList pqueue(CandidateCmp(), std::move(cList));
 
-        const double eval = metric.Kernel().Evaluate(referenceSet->col(q),
-                                                     referenceSet->col(r));
+        for (size_t r = 0; r < referenceSet->n_cols; ++r)
+        {
+          if ((size_t) q == r)
+            continue; // Don't return the point as its own candidate.
+
+          const double eval = blockKernels(r, q - begin);
+
+          if (eval > pqueue.top().first)
+          {
+            Candidate c = std::make_pair(eval, r);
+            pqueue.pop();
+            pqueue.push(c);
+          }
+        }
 
-        if (eval > pqueue.top().first)
+        for (size_t j = 1; j <= k; j++)
         {
-          Candidate c = std::make_pair(eval, r);
+          indices(k - j, q) = pqueue.top().second;
+          kernels(k - j, q) = pqueue.top().first;
           pqueue.pop();
-          pqueue.push(c);
         }
       }
-
-      for (size_t j = 1; j <= k; j++)
-      {
-        indices(k - j, q) = pqueue.top().second;
-        kernels(k - j, q) = pqueue.top().first;
-        pqueue.pop();
-      }
     }
 
     Timer::Stop("computing_products");
@@ -607,18 +647,16 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
     typedef FastMKSRules<KernelType, Tree> RuleType;
     RuleType rules(*referenceSet, *referenceSet, k, metric.Kernel());
 
-    typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
+    tree::CountingRules<RuleType> countingRules(rules, statistics);
+    typename Tree::template SingleTreeTraverser<tree::CountingRules<RuleType>>
+        traverser(countingRules);
 
     for (size_t i = 0; i < referenceSet->n_cols; ++i)
       traverser.Traverse(i, *referenceTree);
 
-    // Save the number of pruned nodes.
-    const size_t numPrunes = traverser.NumPrunes();
-
-    Log::Info << "Pruned " << numPrunes << " nodes." << std::endl;
-
     Log::Info << rules.BaseCases() << " base cases." << std::endl;
     Log::Info << rules.Scores() << " scores." << std::endl;
+    statistics.Print(Log::Info);
 
     rules.GetResults(indices, kernels);
 
@@ -632,6 +670,63 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
   Search(referenceTree, k, indices, kernels);
 }
 
+template<typename KernelType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+template<typename RuleType>
+void FastMKS<KernelType, MatType, TreeType>::DualTreeTraverse(
+    RuleType& rules,
+    Tree& queryTree)
+{
+#ifdef HAS_OPENMP
+  const size_t numThreads = omp_get_max_threads();
+  if (numThreads > 1)
+  {
+    // Split the query tree into disjoint subtrees.  Each query point belongs to
+    // only one subtree, and the dual-tree rules only modify the statistics of
+    // query nodes, so each subtree can be traversed against the reference tree
+    // independently.  We use more subtrees than threads to balance the load.
+    std::vector<Tree*> frontier;
+    tree::SubtreeFrontier(queryTree, 4 * numThreads, frontier);
+
+    size_t parallelScores = 0;
+    size_t parallelBaseCases = 0;
+
+    #pragma omp parallel for schedule(dynamic) \
+        reduction(+:parallelScores, parallelBaseCases)
+    for (omp_size_t i = 0; i < (omp_size_t) frontier.size(); ++i)
+    {
+      // This rules object writes its results into the candidate lists of the
+      // given rules object.
+      RuleType threadRules(&rules);
+      tree::TraversalStatistics threadStatistics;
+      tree::CountingRules<RuleType> countingRules(threadRules,
+          threadStatistics);
+      typename Tree::template DualTreeTraverser<tree::CountingRules<RuleType>>
+          traverser(countingRules);
+      traverser.Traverse(*frontier[i], *referenceTree);
+
+      parallelScores += threadRules.Scores();
+      parallelBaseCases += threadRules.BaseCases();
+
+      #pragma omp critical(FastMKSStatistics)
+      statistics += threadStatistics;
+    }
+
+    rules.Scores() += parallelScores;
+    rules.BaseCases() += parallelBaseCases;
+    return;
+  }
+#endif
+
+  tree::CountingRules<RuleType> countingRules(rules, statistics);
+  typename Tree::template DualTreeTraverser<tree::CountingRules<RuleType>>
+      traverser(countingRules);
+  traverser.Traverse(queryTree, *referenceTree);
+}
+
 //! Serialize the model.
 template<typename KernelType,
          typename MatType,
@@ -48,6 +48,19 @@ class FastMKSRules
                const size_t k,
                KernelType& kernel);
 
+  /**
+   * Construct a FastMKSRules object that searches the same data as the given
+   * rules object and stores results in the same candidate lists (sharing its
+   * cached self-kernels too), but has its own base case cache, traversal
+   * information, and statistics.  This is used for parallel traversals, where
+   * each thread must hold its own rules object.  The caller must ensure that
+   * no query point is visited by more than one thread at a time, and that the
+   * given rules object outlives this one.
+   *
+   * @param other Rules object whose candidate lists will be shared.
+   */
+  FastMKSRules(FastMKSRules* other);
+
   /**
    * Store the list of candidates for each query point in the given matrices.
    *
@@ -148,8 +161,13 @@ class FastMKSRules
   typedef boost::heap::priority_queue<Candidate,
       boost::heap::compare<CandidateCmp>> CandidateList;
 
-  //! Set of candidates for each point.
-  std::vector<CandidateList> candidates;
+  //! Storage for the candidates of each point.  This is empty if the
+  //! candidate lists of another rules object are used.
+  std::vector<CandidateList> candidateStorage;
+
+  //! Set of candidates for each point.  This points either to
+  //! candidateStorage or to the storage of another rules object.
+  CandidateList* candidates;
 
   //! Number of points to search for.
   const size_t k;
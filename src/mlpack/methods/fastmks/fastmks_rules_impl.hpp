@@ -36,12 +36,14 @@ FastMKSRules<KernelType, TreeType>::FastMKSRules(
 {
   // Precompute each self-kernel.
   queryKernels.set_size(querySet.n_cols);
-  for (size_t i = 0; i < querySet.n_cols; ++i)
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) querySet.n_cols; ++i)
     queryKernels[i] = sqrt(kernel.Evaluate(querySet.col(i),
                                            querySet.col(i)));
 
   referenceKernels.set_size(referenceSet.n_cols);
-  for (size_t i = 0; i < referenceSet.n_cols; ++i)
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) referenceSet.n_cols; ++i)
     referenceKernels[i] = sqrt(kernel.Evaluate(referenceSet.col(i),
                                                referenceSet.col(i)));
 
@@ -61,7 +63,32 @@ FastMKSRules<KernelType, TreeType>::FastMKSRules(
   for (size_t i = 0; i < k; i++)
     pqueue.push(def);
   std::vector<CandidateList> tmp(querySet.n_cols, pqueue);
-  candidates.swap(tmp);
+  candidateStorage.swap(tmp);
+  candidates = candidateStorage.data();
+}
+
+template<typename KernelType, typename TreeType>
+FastMKSRules<KernelType, TreeType>::FastMKSRules(FastMKSRules* other) :
+    referenceSet(other->referenceSet),
+    querySet(other->querySet),
+    candidates(other->candidates),
+    k(other->k),
+    // The self-kernels are not copied; these are aliases of the other rules
+    // object's vectors.
+    queryKernels(other->queryKernels.memptr(), other->queryKernels.n_elem,
+        false, true),
+    referenceKernels(other->referenceKernels.memptr(),
+        other->referenceKernels.n_elem, false, true),
+    kernel(other->kernel),
+    lastQueryIndex(-1),
+    lastReferenceIndex(-1),
+    lastKernel(0.0),
+    baseCases(0),
+    scores(0)
+{
+  // See the other constructor for why we use the this pointer here.
+  traversalInfo.LastQueryNode() = (TreeType*) this;
+  traversalInfo.LastReferenceNode() = (TreeType*) this;
 }
 
 template<typename KernelType, typename TreeType>
@@ -19,6 +19,8 @@
 
 // This is the default fitting method class.
 #include "em_fit.hpp"
+// Online fitting method, which can stream chunks.
+#include "online_em_fit.hpp"
 
 // This is the default covariance matrix constraint.
 #include "diagonal_constraint.hpp"
@@ -263,6 +265,29 @@ class DiagonalGMM
                const bool useExistingModel = false,
                FittingType fitter = FittingType());
 
+  /**
+   * Estimate the probability distribution from the observations given by the
+   * chunk loader, using the given algorithm in the FittingType class to fit
+   * the data; the FittingType must be able to stream the chunks (as OnlineEMFit
+   * does).  The chunks must not have any response rows.  Once the model is
+   * trained, one more pass over the chunks is made to compute the
+   * log-likelihood of the model, which is returned.
+   *
+   * Optionally, the existing model can be used as an initial model for the
+   * estimation by setting 'useExistingModel' to true.
+   *
+   * @param loader Chunk loader that gives the observations.
+   * @param useExistingModel If true, the existing model is used as an initial
+   *     model for the estimation.
+   * @param fitter The fitter to use, optional.
+   * @return The log-likelihood of the trained model.
+   */
+  template<typename FittingType = OnlineEMFit<kmeans::KMeans<>,
+      DiagonalConstraint, distribution::DiagonalGaussianDistribution>>
+  double Train(data::ChunkLoader& loader,
+               const bool useExistingModel = false,
+               FittingType fitter = FittingType());
+
   /**
    * Classify the given observations as being from an individual component in
    * this DiagonalGMM. The resultant classifications are stored in the 'labels'
@@ -189,6 +189,28 @@ double DiagonalGMM::Train(const arma::mat& observations,
   return bestLikelihood;
 }
 
+/**
+ * Fit the DiagonalGMM to the observations given by the chunk loader.
+ */
+template<typename FittingType>
+double DiagonalGMM::Train(data::ChunkLoader& loader,
+                          const bool useExistingModel,
+                          FittingType fitter)
+{
+  fitter.Estimate(loader, dists, weights, useExistingModel);
+
+  // The observations may not fit in memory, so the log-likelihood is computed
+  // chunk by chunk.
+  double likelihood = 0.0;
+  arma::mat observations, responses;
+  while (loader.Next(observations, responses))
+    likelihood += LogLikelihood(observations, dists, weights);
+
+  Log::Info << "DiagonalGMM::Train(): log-likelihood of trained DiagonalGMM "
+      << "is " << likelihood << "." << std::endl;
+  return likelihood;
+}
+
 //! Serialize the object.
 template<typename Archive>
 void DiagonalGMM::serialize(Archive& ar, const unsigned int /* version */)
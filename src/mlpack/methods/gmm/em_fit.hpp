@@ -162,6 +162,37 @@ class EMFit
       const std::vector<Distribution>& dists,
       const arma::vec& weights) const;
 
+  /**
+   * Calculate the conditional log-probability of each Gaussian given each
+   * observation (the E-step), and store one column per Gaussian in
+   * condLogProb.  The observations are processed in parallel, in blocks.
+   *
+   * @param observations List of observations.
+   * @param dists Distributions of the model.
+   * @param weights Vector of a priori weights.
+   * @param condLogProb Matrix to store the conditional log-probabilities in.
+   */
+  void ConditionalLogProbabilities(
+      const arma::mat& observations,
+      const std::vector<Distribution>& dists,
+      const arma::vec& weights,
+      arma::mat& condLogProb) const;
+
+  /**
+   * Set the mean and covariance of the given distribution to the weighted mean
+   * and covariance of the observations (the M-step).  The covariance is
+   * accumulated over blocks of observations in parallel, with one sum per
+   * thread.
+   *
+   * @param observations List of observations.
+   * @param pointWeights Weight of each observation; these must sum to 1.
+   * @param dist Distribution to update.
+   */
+  void UpdateDistribution(
+      const arma::mat& observations,
+      const arma::vec& pointWeights,
+      Distribution& dist);
+
   /**
    * Use the Armadillo gmm_diag clusterer to train a GMM with diagonal
    * covariance.  If InitialClusteringType == kmeans::KMeans<>, this will use
@@ -178,6 +209,9 @@ class EMFit
       arma::vec& weights,
       const bool useInitialModel);
 
+  //! Number of observations processed together by each thread.
+  static constexpr size_t blockSize = 1024;
+
   //! Maximum iterations of EM algorithm.
   size_t maxIterations;
   //! Tolerance for convergence of EM.
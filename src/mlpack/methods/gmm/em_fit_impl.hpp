@@ -88,70 +88,26 @@ Estimate(const arma::mat& observations,
 
     // Calculate the conditional probabilities of choosing a particular
     // Gaussian given the observations and the present theta value.
-    for (size_t i = 0; i < dists.size(); i++)
-    {
-      // Store conditional log probabilities into condLogProb vector for each
-      // Gaussian.  First we make an alias of the condLogProb vector.
-      arma::vec condLogProbAlias = condLogProb.unsafe_col(i);
-      dists[i].LogProbability(observations, condLogProbAlias);
-      condLogProbAlias += log(weights[i]);
-    }
-
-    // Normalize row-wise.
-    for (size_t i = 0; i < condLogProb.n_rows; i++)
-    {
-      // Avoid dividing by zero; if the probability for everything is 0, we
-      // don't want to make it NaN.
-      const double probSum = mlpack::math::AccuLog(condLogProb.row(i));
-      if (probSum != -std::numeric_limits<double>::infinity())
-        condLogProb.row(i) -= probSum;
-    }
+    ConditionalLogProbabilities(observations, dists, weights, condLogProb);
 
     // Store the sum of the probability of each state over all the observations.
     arma::vec probRowSums(dists.size());
-    for (size_t i = 0; i < dists.size(); ++i)
+    #pragma omp parallel for
+    for (omp_size_t i = 0; i < (omp_size_t) dists.size(); ++i)
     {
       probRowSums(i) = mlpack::math::AccuLog(condLogProb.col(i));
     }
 
-    // Calculate the new value of the means using the updated conditional
-    // probabilities.
+    // Calculate the new values of the means and covariances using the updated
+    // conditional probabilities.
     for (size_t i = 0; i < dists.size(); i++)
     {
       // Don't update if there's no probability of the Gaussian having points.
-      if (probRowSums[i] != -std::numeric_limits<double>::infinity())
-        dists[i].Mean() = observations * arma::exp(condLogProb.col(i) -
-                                                   probRowSums[i]);
-      else
+      if (probRowSums[i] == -std::numeric_limits<double>::infinity())
         continue;
 
-      // Calculate the new value of the covariances using the updated
-      // conditional probabilities and the updated means.
-      arma::mat tmp = observations.each_col() - dists[i].Mean();
-
-      // If the distribution is DiagonalGaussianDistribution, calculate the
-      // covariance only with diagonal components.
-      if (std::is_same<Distribution,
-          distribution::DiagonalGaussianDistribution>::value)
-      {
-        arma::vec covariance = arma::sum((tmp % tmp) %
-            (arma::ones<arma::vec>(observations.n_rows) *
-            trans(arma::exp(condLogProb.col(i) - probRowSums[i]))), 1);
-
-        // Apply covariance constraint.
-        constraint.ApplyConstraint(covariance);
-        dists[i].Covariance(std::move(covariance));
-      }
-      else
-      {
-        arma::mat tmpB = tmp.each_row() % trans(arma::exp(condLogProb.col(i) -
-                                                          probRowSums[i]));
-        arma::mat covariance = tmp * trans(tmpB);
-
-        // Apply covariance constraint.
-        constraint.ApplyConstraint(covariance);
-        dists[i].Covariance(std::move(covariance));
-      }
+      UpdateDistribution(observations, arma::exp(condLogProb.col(i) -
+          probRowSums[i]), dists[i]);
     }
 
     // Calculate the new values for omega using the updated conditional
@@ -193,24 +149,7 @@ Estimate(const arma::mat& observations,
   {
     // Calculate the conditional probabilities of choosing a particular
     // Gaussian given the observations and the present theta value.
-    for (size_t i = 0; i < dists.size(); i++)
-    {
-      // Store conditional log probabilities into condLogProb vector for each
-      // Gaussian.  First we make an alias of the condLogProb vector.
-      arma::vec condLogProbAlias = condLogProb.unsafe_col(i);
-      dists[i].LogProbability(observations, condLogProbAlias);
-      condLogProbAlias += log(weights[i]);
-    }
-
-    // Normalize row-wise.
-    for (size_t i = 0; i < condLogProb.n_rows; i++)
-    {
-      // Avoid dividing by zero; if the probability for everything is 0, we
-      // don't want to make it NaN.
-      const double probSum = mlpack::math::AccuLog(condLogProb.row(i));
-      if (probSum != -std::numeric_limits<double>::infinity())
-        condLogProb.row(i) -= probSum;
-    }
+    ConditionalLogProbabilities(observations, dists, weights, condLogProb);
 
     // This will store the sum of probabilities of each state over all the
     // observations.
@@ -229,42 +168,11 @@ Estimate(const arma::mat& observations,
       probRowSums[i] = mlpack::math::AccuLog(tmpProb);
 
       // Don't update if there's no probability of the Gaussian having points.
-      if (probRowSums[i] != -std::numeric_limits<double>::infinity())
-      {
-        dists[i].Mean() = observations *
-              arma::exp(condLogProb.col(i) + logProbabilities - probRowSums[i]);
-      }
-      else
+      if (probRowSums[i] == -std::numeric_limits<double>::infinity())
         continue;
 
-      // Calculate the new value of the covariances using the updated
-      // conditional probabilities and the updated means.
-      arma::mat tmp = observations.each_col() - dists[i].Mean();
-
-      // If the distribution is DiagonalGaussianDistribution, calculate the
-      // covariance only with diagonal components.
-      if (std::is_same<Distribution,
-          distribution::DiagonalGaussianDistribution>::value)
-      {
-        arma::vec cov = arma::sum((tmp % tmp) %
-            (arma::ones<arma::vec>(observations.n_rows) *
-            trans(arma::exp(condLogProb.col(i) +
-                            logProbabilities - probRowSums[i]))), 1);
-
-        // Apply covariance constraint.
-        constraint.ApplyConstraint(cov);
-        dists[i].Covariance(std::move(cov));
-      }
-      else
-      {
-        arma::mat tmpB = tmp.each_row() % trans(arma::exp(condLogProb.col(i) +
-            logProbabilities - probRowSums[i]));
-        arma::mat cov = (tmp * trans(tmpB));
-
-        // Apply covariance constraint.
-        constraint.ApplyConstraint(cov);
-        dists[i].Covariance(std::move(cov));
-      }
+      UpdateDistribution(observations, arma::exp(tmpProb - probRowSums[i]),
+          dists[i]);
     }
 
     // Calculate the new values for omega using the updated conditional
@@ -382,29 +290,173 @@ LogLikelihood(const arma::mat& observations,
               const arma::vec& weights) const
 {
   double logLikelihood = 0;
+  size_t numOutliers = 0;
 
-  arma::vec logPhis;
-  arma::mat logLikelihoods(dists.size(), observations.n_cols);
+  const arma::vec logWeights = arma::log(weights);
+  const size_t numBlocks = (observations.n_cols + blockSize - 1) / blockSize;
+  #pragma omp parallel for schedule(dynamic) \
+      reduction(+:logLikelihood, numOutliers)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const size_t begin = (size_t) b * blockSize;
+    const size_t end = std::min(begin + blockSize,
+        (size_t) observations.n_cols);
+    const arma::mat block = observations.cols(begin, end - 1);
+
+    // It has to be LogProbability() otherwise Probability() would overflow
+    // easily.
+    arma::vec logPhis;
+    arma::mat logLikelihoods(block.n_cols, dists.size());
+    for (size_t i = 0; i < dists.size(); ++i)
+    {
+      dists[i].LogProbability(block, logPhis);
+      logLikelihoods.col(i) = logPhis + logWeights[i];
+    }
 
-  // It has to be LogProbability() otherwise Probability() would overflow easily
-  for (size_t i = 0; i < dists.size(); ++i)
+    // Now sum over every component of each point, subtracting the largest
+    // term so that the exponentials do not underflow.
+    const arma::vec maxLogLikelihoods = arma::max(logLikelihoods, 1);
+    const arma::vec sums = arma::sum(arma::exp(
+        logLikelihoods.each_col() - maxLogLikelihoods), 1);
+    for (size_t j = 0; j < block.n_cols; ++j)
+    {
+      if (maxLogLikelihoods[j] == -std::numeric_limits<double>::infinity())
+      {
+        ++numOutliers;
+        logLikelihood += maxLogLikelihoods[j];
+      }
+      else
+      {
+        logLikelihood += maxLogLikelihoods[j] + std::log(sums[j]);
+      }
+    }
+  }
+
+  if (numOutliers > 0)
   {
-    dists[i].LogProbability(observations, logPhis);
-    logLikelihoods.row(i) = log(weights(i)) + trans(logPhis);
+    Log::Info << "Likelihood of " << numOutliers << " point(s) is 0!  They "
+        << "are probably outliers." << std::endl;
   }
-  // Now sum over every point.
-  for (size_t j = 0; j < observations.n_cols; ++j)
+
+  return logLikelihood;
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void EMFit<InitialClusteringType, CovarianceConstraintPolicy, Distribution>::
+ConditionalLogProbabilities(const arma::mat& observations,
+                            const std::vector<Distribution>& dists,
+                            const arma::vec& weights,
+                            arma::mat& condLogProb) const
+{
+  condLogProb.set_size(observations.n_cols, dists.size());
+
+  const arma::vec logWeights = arma::log(weights);
+  const size_t numBlocks = (observations.n_cols + blockSize - 1) / blockSize;
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
   {
-    if (mlpack::math::AccuLog(logLikelihoods.col(j)) ==
-        -std::numeric_limits<double>::infinity())
+    const size_t begin = (size_t) b * blockSize;
+    const size_t end = std::min(begin + blockSize,
+        (size_t) observations.n_cols);
+    const arma::mat block = observations.cols(begin, end - 1);
+
+    // Store conditional log probabilities of the block for each Gaussian.
+    arma::vec logProbabilities;
+    for (size_t i = 0; i < dists.size(); ++i)
     {
-      Log::Info << "Likelihood of point " << j << " is 0!  It is probably an "
-          << "outlier." << std::endl;
+      dists[i].LogProbability(block, logProbabilities);
+      condLogProb.submat(begin, i, end - 1, i) = logProbabilities +
+          logWeights[i];
+    }
+
+    // Normalize row-wise.
+    for (size_t j = begin; j < end; ++j)
+    {
+      // Avoid dividing by zero; if the probability for everything is 0, we
+      // don't want to make it NaN.
+      const double probSum = mlpack::math::AccuLog(condLogProb.row(j));
+      if (probSum != -std::numeric_limits<double>::infinity())
+        condLogProb.row(j) -= probSum;
     }
-    logLikelihood += mlpack::math::AccuLog(logLikelihoods.col(j));
   }
+}
 
-  return logLikelihood;
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void EMFit<InitialClusteringType, CovarianceConstraintPolicy, Distribution>::
+UpdateDistribution(const arma::mat& observations,
+                   const arma::vec& pointWeights,
+                   Distribution& dist)
+{
+  dist.Mean() = observations * pointWeights;
+  const arma::vec& mean = dist.Mean();
+
+  // The covariance is accumulated over blocks of observations; each thread
+  // keeps its own sum, and the sums are added at the end.
+  const size_t numBlocks = (observations.n_cols + blockSize - 1) / blockSize;
+
+  // If the distribution is DiagonalGaussianDistribution, calculate the
+  // covariance only with diagonal components.
+  if (std::is_same<Distribution,
+      distribution::DiagonalGaussianDistribution>::value)
+  {
+    arma::vec covariance(observations.n_rows, arma::fill::zeros);
+    #pragma omp parallel
+    {
+      arma::vec threadCovariance(observations.n_rows, arma::fill::zeros);
+
+      #pragma omp for schedule(dynamic)
+      for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+      {
+        const size_t begin = (size_t) b * blockSize;
+        const size_t end = std::min(begin + blockSize,
+            (size_t) observations.n_cols);
+        arma::mat diffs = observations.cols(begin, end - 1);
+        diffs.each_col() -= mean;
+        threadCovariance += (diffs % diffs) *
+            pointWeights.subvec(begin, end - 1);
+      }
+
+      #pragma omp critical
+      covariance += threadCovariance;
+    }
+
+    // Apply covariance constraint.
+    constraint.ApplyConstraint(covariance);
+    dist.Covariance(std::move(covariance));
+  }
+  else
+  {
+    arma::mat covariance(observations.n_rows, observations.n_rows,
+        arma::fill::zeros);
+    #pragma omp parallel
+    {
+      arma::mat threadCovariance(observations.n_rows, observations.n_rows,
+          arma::fill::zeros);
+
+      #pragma omp for schedule(dynamic)
+      for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+      {
+        const size_t begin = (size_t) b * blockSize;
+        const size_t end = std::min(begin + blockSize,
+            (size_t) observations.n_cols);
+        arma::mat diffs = observations.cols(begin, end - 1);
+        diffs.each_col() -= mean;
+        threadCovariance += (diffs.each_row() %
+            pointWeights.subvec(begin, end - 1).t()) * diffs.t();
+      }
+
+      #pragma omp critical
+      covariance += threadCovariance;
+    }
+
+    // Apply covariance constraint.
+    constraint.ApplyConstraint(covariance);
+    dist.Covariance(std::move(covariance));
+  }
 }
 
 template<typename InitialClusteringType,
@@ -96,6 +96,75 @@ double GMM::Probability(const arma::vec& observation,
   return exp(LogProbability(observation, component));
 }
 
+/**
+ * Return the log probability of each of the given observations being from this
+ * GMM.
+ */
+void GMM::LogProbability(const arma::mat& observations,
+                         arma::vec& logProbabilities) const
+{
+  if (observations.n_rows != dimensionality)
+  {
+    std::ostringstream oss;
+    oss << "GMM::LogProbability(): dimensionality of observations ("
+        << observations.n_rows << ") is not equal to the dimensionality of the "
+        << "model (" << dimensionality << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  logProbabilities.set_size(observations.n_cols);
+  const arma::vec logWeights = arma::log(weights);
+
+  // Each block holds the log probabilities of its points for every component,
+  // so it has to stay small enough to be cheap for many components.
+  const size_t blockSize = 1024;
+  const size_t numBlocks = (observations.n_cols + blockSize - 1) / blockSize;
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const size_t begin = b * blockSize;
+    const size_t count = std::min(blockSize, observations.n_cols - begin);
+    const arma::mat block(const_cast<double*>(observations.colptr(begin)),
+        observations.n_rows, count, false, true);
+
+    arma::vec logPhis;
+    arma::mat logLikelihoods(gaussians, count);
+    for (size_t i = 0; i < gaussians; ++i)
+    {
+      dists[i].LogProbability(block, logPhis);
+      logLikelihoods.row(i) = logWeights[i] + trans(logPhis);
+    }
+
+    // Sum over the components with the log-sum-exp trick: shift each column by
+    // its largest value so that the exponentials can't overflow.
+    const arma::rowvec maxima = arma::max(logLikelihoods, 0);
+    for (size_t j = 0; j < count; ++j)
+    {
+      if (std::isinf(maxima[j]))
+      {
+        // Every component gives -inf (or one gives +inf): so does the sum.
+        logProbabilities[begin + j] = maxima[j];
+        continue;
+      }
+
+      logProbabilities[begin + j] = maxima[j] + std::log(arma::accu(
+          arma::exp(logLikelihoods.col(j) - maxima[j])));
+    }
+  }
+}
+
+/**
+ * Return the probability of each of the given observations being from this
+ * GMM.
+ */
+void GMM::Probability(const arma::mat& observations,
+                      arma::vec& probabilities) const
+{
+  LogProbability(observations, probabilities);
+  probabilities = arma::exp(probabilities);
+}
+
 /**
  * Return a randomly generated observation according to the probability
  * distribution defined by this object.
@@ -126,6 +195,49 @@ arma::vec GMM::Random() const
       arma::randn<arma::vec>(dimensionality) + dists[gaussian].Mean();
 }
 
+/**
+ * Return the given number of randomly generated observations according to the
+ * probability distribution defined by this object.
+ */
+arma::mat GMM::Random(const size_t samples) const
+{
+  // Determine which Gaussian each observation will be coming from, the same way
+  // as Random() does.
+  const arma::vec cumulativeWeights = arma::cumsum(weights);
+  arma::Col<size_t> components(samples);
+  arma::Col<size_t> counts(gaussians, arma::fill::zeros);
+  for (size_t i = 0; i < samples; ++i)
+  {
+    const double gaussRand = math::Random();
+    const double* end = cumulativeWeights.memptr() + gaussians;
+    const size_t g = std::lower_bound(cumulativeWeights.memptr(), end,
+        gaussRand) - cumulativeWeights.memptr();
+    components[i] = (g == gaussians) ? 0 : g;
+    ++counts[components[i]];
+  }
+
+  arma::mat observations(dimensionality, samples);
+  for (size_t g = 0; g < gaussians; ++g)
+  {
+    if (counts[g] == 0)
+      continue;
+
+    arma::mat cholDecomp;
+    if (!arma::chol(cholDecomp, dists[g].Covariance()))
+    {
+      Log::Fatal << "Cholesky decomposition failed." << std::endl;
+    }
+
+    const arma::uvec indices = arma::find(components == g);
+    arma::mat componentObservations = trans(cholDecomp) *
+        arma::randn<arma::mat>(dimensionality, counts[g]);
+    componentObservations.each_col() += dists[g].Mean();
+    observations.cols(indices) = componentObservations;
+  }
+
+  return observations;
+}
+
 /**
  * Classify the given observations as being from an individual component in this
  * GMM.
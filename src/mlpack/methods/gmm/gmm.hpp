@@ -17,6 +17,8 @@
 
 // This is the default fitting method class.
 #include "em_fit.hpp"
+// Online fitting method, which can stream chunks.
+#include "online_em_fit.hpp"
 
 namespace mlpack {
 namespace gmm /** Gaussian Mixture Models. */ {
@@ -191,6 +193,29 @@ class GMM
    */
   double LogProbability(const arma::vec& observation,
                         const size_t component) const;
+
+  /**
+   * Compute the probability of each of the given observations (columns) being
+   * from this distribution.  The observations are processed in blocks, in
+   * parallel if OpenMP is enabled.
+   *
+   * @param observations Observations to evaluate the probabilities of.
+   * @param probabilities Vector to store the probabilities in.
+   */
+  void Probability(const arma::mat& observations,
+                   arma::vec& probabilities) const;
+
+  /**
+   * Compute the log probability of each of the given observations (columns)
+   * being from this distribution.  The observations are processed in blocks,
+   * in parallel if OpenMP is enabled.
+   *
+   * @param observations Observations to evaluate the probabilities of.
+   * @param logProbabilities Vector to store the log probabilities in.
+   */
+  void LogProbability(const arma::mat& observations,
+                      arma::vec& logProbabilities) const;
+
   /**
    * Return a randomly generated observation according to the probability
    * distribution defined by this object.
@@ -199,6 +224,17 @@ class GMM
    */
   arma::vec Random() const;
 
+  /**
+   * Return the given number of randomly generated observations (one per
+   * column) according to the probability distribution defined by this object.
+   * The covariance of each component is only factorized once, and the
+   * observations of each component are generated together.
+   *
+   * @param samples Number of observations to generate.
+   * @return Random observations from this GMM.
+   */
+  arma::mat Random(const size_t samples) const;
+
   /**
    * Estimate the probability distribution directly from the given observations,
    * using the given algorithm in the FittingType class to fit the data.
@@ -260,6 +296,28 @@ class GMM
                const bool useExistingModel = false,
                FittingType fitter = FittingType());
 
+  /**
+   * Estimate the probability distribution from the observations given by the
+   * chunk loader, using the given algorithm in the FittingType class to fit
+   * the data; the FittingType must be able to stream the chunks (as OnlineEMFit
+   * does).  The chunks must not have any response rows.  Once the model is
+   * trained, one more pass over the chunks is made to compute the
+   * log-likelihood of the model, which is returned.
+   *
+   * Optionally, the existing model can be used as an initial model for the
+   * estimation by setting 'useExistingModel' to true.
+   *
+   * @param loader Chunk loader that gives the observations.
+   * @param useExistingModel If true, the existing model is used as an initial
+   *     model for the estimation.
+   * @param fitter The fitter to use, optional.
+   * @return The log-likelihood of the trained model.
+   */
+  template<typename FittingType = OnlineEMFit<>>
+  double Train(data::ChunkLoader& loader,
+               const bool useExistingModel = false,
+               FittingType fitter = FittingType());
+
   /**
    * Classify the given observations as being from an individual component in
    * this GMM.  The resultant classifications are stored in the 'labels' object,
@@ -69,10 +69,6 @@ static void mlpackMain()
 
   size_t length = (size_t) CLI::GetParam<int>("samples");
   Log::Info << "Generating " << length << " samples..." << endl;
-  arma::mat samples(gmm->Dimensionality(), length);
-  for (size_t i = 0; i < length; ++i)
-    samples.col(i) = gmm->Random();
-
   // Save, if the user asked for it.
-  CLI::GetParam<arma::mat>("output") = std::move(samples);
+  CLI::GetParam<arma::mat>("output") = gmm->Random(length);
 }
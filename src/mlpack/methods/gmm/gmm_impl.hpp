@@ -187,6 +187,28 @@ double GMM::Train(const arma::mat& observations,
   return bestLikelihood;
 }
 
+/**
+ * Fit the GMM to the observations given by the chunk loader.
+ */
+template<typename FittingType>
+double GMM::Train(data::ChunkLoader& loader,
+                  const bool useExistingModel,
+                  FittingType fitter)
+{
+  fitter.Estimate(loader, dists, weights, useExistingModel);
+
+  // The observations may not fit in memory, so the log-likelihood is computed
+  // chunk by chunk.
+  double likelihood = 0.0;
+  arma::mat observations, responses;
+  while (loader.Next(observations, responses))
+    likelihood += LogLikelihood(observations, dists, weights);
+
+  Log::Info << "GMM::Train(): log-likelihood of trained GMM is "
+      << likelihood << "." << std::endl;
+  return likelihood;
+}
+
 /**
  * Serialize the object.
  */
@@ -49,6 +49,7 @@ PROGRAM_INFO("GMM Probability Calculator",
 PARAM_MODEL_IN_REQ(GMM, "input_model", "Input GMM to use as model.", "m");
 PARAM_MATRIX_IN_REQ("input", "Input matrix to calculate probabilities of.",
     "i");
+BINDING_STREAMING_INPUT("input");
 
 PARAM_MATRIX_OUT("output", "Matrix to store calculated probabilities in.", "o");
 
@@ -62,10 +63,9 @@ static void mlpackMain()
   arma::mat dataset = std::move(CLI::GetParam<arma::mat>("input"));
 
   // Now calculate the probabilities.
-  arma::rowvec probabilities(dataset.n_cols);
-  for (size_t i = 0; i < dataset.n_cols; ++i)
-    probabilities[i] = gmm->Probability(dataset.unsafe_col(i));
+  arma::vec probabilities;
+  gmm->Probability(dataset, probabilities);
 
   // And save the result.
-  CLI::GetParam<arma::mat>("output") = std::move(probabilities);
+  CLI::GetParam<arma::mat>("output") = trans(probabilities);
 }
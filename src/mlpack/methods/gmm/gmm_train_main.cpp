@@ -65,6 +65,14 @@ PROGRAM_INFO("Gaussian Mixture Model (GMM) Training",
     "causes training to be faster, but restricts the ability to fit more "
     "complex GMMs."
     "\n\n"
+    "If the " + PRINT_PARAM_STRING("online") + " flag is given, online "
+    "(stepwise) EM is used instead: the points are visited in random "
+    "minibatches of " + PRINT_PARAM_STRING("batch_size") + " points, and the "
+    "model is updated after each minibatch with a step size that decreases "
+    "with exponent " + PRINT_PARAM_STRING("step_decay") + ".  Then, " +
+    PRINT_PARAM_STRING("max_iterations") + " is the maximum number of passes "
+    "over the data.  This is much faster than EM for large datasets."
+    "\n\n"
     "If GMM training fails with an error indicating that a covariance matrix "
     "could not be inverted, make sure that the " +
     PRINT_PARAM_STRING("no_force_positive") + " parameter is not "
@@ -116,6 +124,14 @@ PARAM_INT_IN("max_iterations", "Maximum number of iterations of EM algorithm "
 PARAM_FLAG("diagonal_covariance", "Force the covariance of the Gaussians to "
     "be diagonal.  This can accelerate training time significantly.", "d");
 
+// Parameters for online EM.
+PARAM_FLAG("online", "Use online EM, which updates the model after each "
+    "minibatch of points, instead of EM.", "O");
+PARAM_INT_IN("batch_size", "Number of points in each minibatch of online EM.",
+    "b", 1000);
+PARAM_DOUBLE_IN("step_decay", "Exponent of the decreasing step size of online "
+    "EM (should be greater than 0.5 and at most 1).", "D", 0.7);
+
 // Parameters for dataset modification.
 PARAM_DOUBLE_IN("noise", "Variance of zero-mean Gaussian noise to add to data.",
     "N", 0);
@@ -136,6 +152,38 @@ PARAM_MODEL_IN(GMM, "input_model", "Initial input GMM model to start training "
     "with.", "m");
 PARAM_MODEL_OUT(GMM, "output_model", "Output for trained GMM model.", "M");
 
+// Train the model with EM, or with online EM if --online is given, using the
+// given clusterer for the initial model.
+template<typename ConstraintType,
+         typename DistributionType,
+         typename GMMType,
+         typename KMeansType>
+double Fit(GMMType& gmm, const arma::mat& dataPoints, const KMeansType& k)
+{
+  const size_t maxIterations = (size_t) CLI::GetParam<int>("max_iterations");
+  const double tolerance = CLI::GetParam<double>("tolerance");
+  const size_t trials = (size_t) CLI::GetParam<int>("trials");
+
+  double likelihood;
+  Timer::Start("em");
+  if (CLI::HasParam("online"))
+  {
+    OnlineEMFit<KMeansType, ConstraintType, DistributionType> em(
+        (size_t) CLI::GetParam<int>("batch_size"), maxIterations,
+        CLI::GetParam<double>("step_decay"), 2.0, tolerance, k);
+    likelihood = gmm.Train(dataPoints, trials, false, em);
+  }
+  else
+  {
+    EMFit<KMeansType, ConstraintType, DistributionType> em(maxIterations,
+        tolerance, k);
+    likelihood = gmm.Train(dataPoints, trials, false, em);
+  }
+  Timer::Stop("em");
+
+  return likelihood;
+}
+
 static void mlpackMain()
 {
   // Check parameters and load data.
@@ -162,6 +210,17 @@ static void mlpackMain()
   RequireParamValue<int>("kmeans_max_iterations", [](int x) { return x >= 0; },
       true, "kmeans_max_iterations must be greater than or equal to 0");
 
+  ReportIgnoredParam({{ "online", false }}, "batch_size");
+  ReportIgnoredParam({{ "online", false }}, "step_decay");
+  if (CLI::HasParam("online"))
+  {
+    RequireParamValue<int>("batch_size", [](int x) { return x > 0; }, true,
+        "batch_size must be positive");
+    RequireParamValue<double>("step_decay", [](double x) {
+        return x > 0.5 && x <= 1.0; }, true, "step_decay must be greater than "
+        "0.5 and less than or equal to 1.0");
+  }
+
   arma::mat dataPoints = std::move(CLI::GetParam<arma::mat>("input"));
 
   // Do we need to add noise to the dataset?
@@ -189,9 +248,7 @@ static void mlpackMain()
           << " has dimensionality " << gmm->Dimensionality() << "!" << endl;
   }
 
-  // Gather parameters for EMFit object.
-  const size_t maxIterations = (size_t) CLI::GetParam<int>("max_iterations");
-  const double tolerance = CLI::GetParam<double>("tolerance");
+  // Gather parameters for the fitter.
   const bool forcePositive = !CLI::HasParam("no_force_positive");
   const bool diagonalCovariance = CLI::HasParam("diagonal_covariance");
   const size_t kmeansMaxIterations =
@@ -236,14 +293,8 @@ static void mlpackMain()
       dgmm.Weights() = gmm->Weights();
 
       // Compute the parameters of the model using the EM algorithm.
-      Timer::Start("em");
-      EMFit<KMeansType, PositiveDefiniteConstraint,
-          distribution::DiagonalGaussianDistribution> em(maxIterations,
-          tolerance, k);
-
-      likelihood = dgmm.Train(dataPoints, CLI::GetParam<int>("trials"), false,
-          em);
-      Timer::Stop("em");
+      likelihood = Fit<PositiveDefiniteConstraint,
+          distribution::DiagonalGaussianDistribution>(dgmm, dataPoints, k);
 
       // Convert DiagonalGMMs into GMMs.
       for (size_t i = 0; i < size_t(gaussians); i++)
@@ -257,20 +308,14 @@ static void mlpackMain()
     else if (forcePositive)
     {
       // Compute the parameters of the model using the EM algorithm.
-      Timer::Start("em");
-      EMFit<KMeansType> em(maxIterations, tolerance, k);
-      likelihood = gmm->Train(dataPoints, CLI::GetParam<int>("trials"), false,
-          em);
-      Timer::Stop("em");
+      likelihood = Fit<PositiveDefiniteConstraint,
+          distribution::GaussianDistribution>(*gmm, dataPoints, k);
     }
     else
     {
       // Compute the parameters of the model using the EM algorithm.
-      Timer::Start("em");
-      EMFit<KMeansType, NoConstraint> em(maxIterations, tolerance, k);
-      likelihood = gmm->Train(dataPoints, CLI::GetParam<int>("trials"), false,
-          em);
-      Timer::Stop("em");
+      likelihood = Fit<NoConstraint, distribution::GaussianDistribution>(*gmm,
+          dataPoints, k);
     }
   }
   else
@@ -294,14 +339,9 @@ static void mlpackMain()
       dgmm.Weights() = gmm->Weights();
 
       // Compute the parameters of the model using the EM algorithm.
-      Timer::Start("em");
-      EMFit<KMeans<>, PositiveDefiniteConstraint,
-          distribution::DiagonalGaussianDistribution> em(maxIterations,
-          tolerance, KMeans<>(kmeansMaxIterations));
-
-      likelihood = dgmm.Train(dataPoints, CLI::GetParam<int>("trials"), false,
-          em);
-      Timer::Stop("em");
+      likelihood = Fit<PositiveDefiniteConstraint,
+          distribution::DiagonalGaussianDistribution>(dgmm, dataPoints,
+          KMeans<>(kmeansMaxIterations));
 
       // Convert DiagonalGMMs into GMMs.
       for (size_t i = 0; i < size_t(gaussians); i++)
@@ -315,21 +355,15 @@ static void mlpackMain()
     else if (forcePositive)
     {
       // Compute the parameters of the model using the EM algorithm.
-      Timer::Start("em");
-      EMFit<> em(maxIterations, tolerance, KMeans<>(kmeansMaxIterations));
-      likelihood = gmm->Train(dataPoints, CLI::GetParam<int>("trials"), false,
-          em);
-      Timer::Stop("em");
+      likelihood = Fit<PositiveDefiniteConstraint,
+          distribution::GaussianDistribution>(*gmm, dataPoints,
+          KMeans<>(kmeansMaxIterations));
     }
     else
     {
       // Compute the parameters of the model using the EM algorithm.
-      Timer::Start("em");
-      KMeans<> k(kmeansMaxIterations);
-      EMFit<KMeans<>, NoConstraint> em(maxIterations, tolerance, k);
-      likelihood = gmm->Train(dataPoints, CLI::GetParam<int>("trials"), false,
-          em);
-      Timer::Stop("em");
+      likelihood = Fit<NoConstraint, distribution::GaussianDistribution>(*gmm,
+          dataPoints, KMeans<>(kmeansMaxIterations));
     }
   }
 
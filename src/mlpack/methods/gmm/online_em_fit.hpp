@@ -0,0 +1,309 @@
+/**
+ * @file methods/gmm/online_em_fit.hpp
+ *
+ * Utility class to fit a GMM with online (stepwise) EM over minibatches.  Used
+ * by GMM::Train<>() and DiagonalGMM::Train<>().
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_GMM_ONLINE_EM_FIT_HPP
+#define MLPACK_METHODS_GMM_ONLINE_EM_FIT_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/data/chunk_loader.hpp>
+#include <mlpack/core/dists/gaussian_distribution.hpp>
+#include <mlpack/core/dists/diagonal_gaussian_distribution.hpp>
+
+// Default clustering mechanism.
+#include <mlpack/methods/kmeans/kmeans.hpp>
+// Default covariance matrix constraint.
+#include "positive_definite_constraint.hpp"
+// The initial model is found as EMFit does.
+#include "em_fit.hpp"
+
+namespace mlpack {
+namespace gmm {
+
+/**
+ * This class fits a GMM to observations with the online EM algorithm, also
+ * known as stepwise EM.  Instead of recomputing the sufficient statistics of
+ * the model (the weight, the weighted sum and the weighted sum of squares of
+ * each component) from the whole dataset at each iteration, the statistics of
+ * each minibatch are computed and blended into the running statistics with a
+ * decreasing step size
+ *
+ * \f[
+ * \eta_t = (t + t_0)^{-\kappa},
+ * \f]
+ *
+ * after which the model is updated from the running statistics.  This is
+ * described in the following papers:
+ *
+ * @code
+ * @article{cappe2009online,
+ *   title={On-line expectation-maximization algorithm for latent data
+ *       models},
+ *   author={Capp{\'e}, Olivier and Moulines, Eric},
+ *   journal={Journal of the Royal Statistical Society: Series B},
+ *   volume={71},
+ *   number={3},
+ *   pages={593--613},
+ *   year={2009}
+ * }
+ *
+ * @inproceedings{liang2009online,
+ *   title={Online EM for Unsupervised Models},
+ *   author={Liang, Percy and Klein, Dan},
+ *   booktitle={Proceedings of Human Language Technologies: The 2009 Annual
+ *       Conference of the North American Chapter of the Association for
+ *       Computational Linguistics},
+ *   pages={611--619},
+ *   year={2009}
+ * }
+ * @endcode
+ *
+ * The model converges for \f$ 0.5 < \kappa \le 1 \f$.  Each update only needs
+ * one minibatch, so the observations may also be streamed from a
+ * data::ChunkLoader, and the whole dataset never has to be in memory.  Unless
+ * an initial model is given, the model is initialized by clustering the first
+ * minibatch with the InitialClusteringType, as EMFit does with the whole
+ * dataset.
+ */
+template<typename InitialClusteringType = kmeans::KMeans<>,
+         typename CovarianceConstraintPolicy = PositiveDefiniteConstraint,
+         typename Distribution = distribution::GaussianDistribution>
+class OnlineEMFit
+{
+ public:
+  /**
+   * Construct the OnlineEMFit object.  Setting the maximum number of epochs to
+   * 0 means that the algorithm will make passes over the data until the
+   * log-likelihood of an epoch changes by less than the tolerance.
+   *
+   * @param batchSize Number of observations in each minibatch.
+   * @param maxEpochs Maximum number of passes over the data.
+   * @param stepDecay Exponent of the step size (kappa); it should be in
+   *     (0.5, 1].
+   * @param stepOffset Offset of the step size (t_0).
+   * @param tolerance Change of the log-likelihood of an epoch required for
+   *     convergence.
+   * @param clusterer Object which will perform the initial clustering.
+   * @param constraint Constraint policy of covariance.
+   */
+  OnlineEMFit(const size_t batchSize = 1000,
+              const size_t maxEpochs = 10,
+              const double stepDecay = 0.7,
+              const double stepOffset = 2.0,
+              const double tolerance = 1e-10,
+              InitialClusteringType clusterer = InitialClusteringType(),
+              CovarianceConstraintPolicy constraint =
+                  CovarianceConstraintPolicy());
+
+  /**
+   * Fit the observations to a Gaussian mixture model (GMM) with online EM,
+   * visiting the observations in random minibatches.  The size of the vectors
+   * (indicating the number of components) must already be set.  If
+   * useInitialModel is set to true, the given model is used as the initial
+   * model.
+   *
+   * @param observations List of observations to train on.
+   * @param dists Distributions to store model in.
+   * @param weights Vector to store a priori weights in.
+   * @param useInitialModel If true, the given model is used as the initial
+   *      model.
+   */
+  void Estimate(const arma::mat& observations,
+                std::vector<Distribution>& dists,
+                arma::vec& weights,
+                const bool useInitialModel = false);
+
+  /**
+   * Fit the observations to a Gaussian mixture model (GMM) with online EM,
+   * taking into account the probabilities of each point being from this
+   * mixture.
+   *
+   * @param observations List of observations to train on.
+   * @param probabilities Probability of each point being from this model.
+   * @param dists Distributions to store model in.
+   * @param weights Vector to store a priori weights in.
+   * @param useInitialModel If true, the given model is used as the initial
+   *      model.
+   */
+  void Estimate(const arma::mat& observations,
+                const arma::vec& probabilities,
+                std::vector<Distribution>& dists,
+                arma::vec& weights,
+                const bool useInitialModel = false);
+
+  /**
+   * Fit the observations given by the chunk loader to a Gaussian mixture model
+   * (GMM) with online EM.  Each epoch visits every chunk once, and the
+   * observations of each chunk are visited in random minibatches.  The chunks
+   * must not have any response rows.
+   *
+   * @param loader Chunk loader that gives the observations.
+   * @param dists Distributions to store model in.
+   * @param weights Vector to store a priori weights in.
+   * @param useInitialModel If true, the given model is used as the initial
+   *      model.
+   */
+  void Estimate(data::ChunkLoader& loader,
+                std::vector<Distribution>& dists,
+                arma::vec& weights,
+                const bool useInitialModel = false);
+
+  /**
+   * Update the model with one minibatch of observations.  The first step after
+   * construction or Reset() starts from the sufficient statistics of the given
+   * model.
+   *
+   * @param observations Minibatch of observations.
+   * @param dists Distributions of the model to update.
+   * @param weights A priori weights of the model to update.
+   * @return Log-likelihood of the minibatch before the update.
+   */
+  double Step(const arma::mat& observations,
+              std::vector<Distribution>& dists,
+              arma::vec& weights);
+
+  /**
+   * Update the model with one minibatch of observations, each of which has a
+   * certain probability of being from this mixture.
+   *
+   * @param observations Minibatch of observations.
+   * @param probabilities Probability of each point being from this model.
+   * @param dists Distributions of the model to update.
+   * @param weights A priori weights of the model to update.
+   * @return Log-likelihood of the minibatch before the update.
+   */
+  double Step(const arma::mat& observations,
+              const arma::vec& probabilities,
+              std::vector<Distribution>& dists,
+              arma::vec& weights);
+
+  //! Forget the running statistics, so that the next step starts again from
+  //! the statistics of the model with the largest step size.
+  void Reset() { steps = 0; }
+
+  //! Get the number of steps since the last Reset().
+  size_t Steps() const { return steps; }
+
+  //! Get the clusterer.
+  const InitialClusteringType& Clusterer() const { return clusterer; }
+  //! Modify the clusterer.
+  InitialClusteringType& Clusterer() { return clusterer; }
+
+  //! Get the covariance constraint policy class.
+  const CovarianceConstraintPolicy& Constraint() const { return constraint; }
+  //! Modify the covariance constraint policy class.
+  CovarianceConstraintPolicy& Constraint() { return constraint; }
+
+  //! Get the number of observations in each minibatch.
+  size_t BatchSize() const { return batchSize; }
+  //! Modify the number of observations in each minibatch.
+  size_t& BatchSize() { return batchSize; }
+
+  //! Get the maximum number of passes over the data.
+  size_t MaxEpochs() const { return maxEpochs; }
+  //! Modify the maximum number of passes over the data.
+  size_t& MaxEpochs() { return maxEpochs; }
+
+  //! Get the exponent of the step size.
+  double StepDecay() const { return stepDecay; }
+  //! Modify the exponent of the step size.
+  double& StepDecay() { return stepDecay; }
+
+  //! Get the offset of the step size.
+  double StepOffset() const { return stepOffset; }
+  //! Modify the offset of the step size.
+  double& StepOffset() { return stepOffset; }
+
+  //! Get the tolerance for the convergence of the algorithm.
+  double Tolerance() const { return tolerance; }
+  //! Modify the tolerance for the convergence of the algorithm.
+  double& Tolerance() { return tolerance; }
+
+  //! Serialize the fitter.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int version);
+
+ private:
+  //! The type of the covariance of a component.
+  typedef typename std::conditional<std::is_same<Distribution,
+      distribution::DiagonalGaussianDistribution>::value, arma::vec,
+      arma::mat>::type CovarianceType;
+
+  /**
+   * Make one pass over the given observations in random minibatches.
+   *
+   * @param observations List of observations.
+   * @param probabilities Probability of each point being from this model.
+   * @param dists Distributions of the model to update.
+   * @param weights A priori weights of the model to update.
+   * @param initialize If true, the model is first initialized from the first
+   *     minibatch.
+   * @return Sum of the log-likelihoods of the minibatches.
+   */
+  double Epoch(const arma::mat& observations,
+               const arma::vec& probabilities,
+               std::vector<Distribution>& dists,
+               arma::vec& weights,
+               const bool initialize);
+
+  /**
+   * Initialize the model from the given observations in the same way as EMFit
+   * does, with the clusterer.
+   *
+   * @param observations List of observations.
+   * @param dists Distributions to store model in.
+   * @param weights Vector to store a priori weights in.
+   */
+  void InitialClustering(const arma::mat& observations,
+                         std::vector<Distribution>& dists,
+                         arma::vec& weights);
+
+  //! Set the running statistics to the statistics of the given model.
+  void InitializeStatistics(const std::vector<Distribution>& dists,
+                            const arma::vec& weights);
+
+  //! Throw if the parameters or the observations are invalid.
+  void CheckParameters(const arma::mat& observations,
+                       const std::vector<Distribution>& dists) const;
+
+  //! Number of observations in each minibatch.
+  size_t batchSize;
+  //! Maximum number of passes over the data.
+  size_t maxEpochs;
+  //! Exponent of the step size.
+  double stepDecay;
+  //! Offset of the step size.
+  double stepOffset;
+  //! Tolerance for convergence.
+  double tolerance;
+  //! Object which will perform the clustering.
+  InitialClusteringType clusterer;
+  //! Object which applies constraints to the covariance matrix.
+  CovarianceConstraintPolicy constraint;
+
+  //! Number of steps since the last Reset().
+  size_t steps;
+  //! Running weight of each component.
+  arma::vec sumWeights;
+  //! Running weighted sum of the observations of each component, one column
+  //! per component.
+  arma::mat sumObservations;
+  //! Running weighted sum of the outer products (or the squares, for diagonal
+  //! covariances) of the observations of each component.
+  std::vector<CovarianceType> sumSquares;
+};
+
+} // namespace gmm
+} // namespace mlpack
+
+// Include implementation.
+#include "online_em_fit_impl.hpp"
+
+#endif
@@ -0,0 +1,377 @@
+/**
+ * @file methods/gmm/online_em_fit_impl.hpp
+ *
+ * Implementation of the online EM algorithm for fitting GMMs.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_GMM_ONLINE_EM_FIT_IMPL_HPP
+#define MLPACK_METHODS_GMM_ONLINE_EM_FIT_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "online_em_fit.hpp"
+
+namespace mlpack {
+namespace gmm {
+
+//! Constructor.
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy, Distribution>::
+OnlineEMFit(const size_t batchSize,
+            const size_t maxEpochs,
+            const double stepDecay,
+            const double stepOffset,
+            const double tolerance,
+            InitialClusteringType clusterer,
+            CovarianceConstraintPolicy constraint) :
+    batchSize(batchSize),
+    maxEpochs(maxEpochs),
+    stepDecay(stepDecay),
+    stepOffset(stepOffset),
+    tolerance(tolerance),
+    clusterer(clusterer),
+    constraint(constraint),
+    steps(0)
+{ /* Nothing to do. */ }
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::Estimate(const arma::mat& observations,
+                            std::vector<Distribution>& dists,
+                            arma::vec& weights,
+                            const bool useInitialModel)
+{
+  Estimate(observations, arma::ones<arma::vec>(observations.n_cols), dists,
+      weights, useInitialModel);
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::Estimate(const arma::mat& observations,
+                            const arma::vec& probabilities,
+                            std::vector<Distribution>& dists,
+                            arma::vec& weights,
+                            const bool useInitialModel)
+{
+  CheckParameters(observations, dists);
+  Reset();
+
+  double lOld = -DBL_MAX;
+  for (size_t epoch = 0; epoch != maxEpochs; ++epoch)
+  {
+    const double l = Epoch(observations, probabilities, dists, weights,
+        !useInitialModel && epoch == 0);
+
+    Log::Info << "OnlineEMFit::Estimate(): epoch " << epoch << ", "
+        << "log-likelihood " << l << "." << std::endl;
+
+    if (std::abs(l - lOld) < tolerance)
+      break;
+    lOld = l;
+  }
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::Estimate(data::ChunkLoader& loader,
+                            std::vector<Distribution>& dists,
+                            arma::vec& weights,
+                            const bool useInitialModel)
+{
+  if (loader.ResponseRows() != 0)
+  {
+    throw std::invalid_argument("OnlineEMFit::Estimate(): the chunks must not "
+        "have response rows!");
+  }
+
+  Reset();
+
+  arma::mat observations, responses;
+  bool initialize = !useInitialModel;
+  double lOld = -DBL_MAX;
+  for (size_t epoch = 0; epoch != maxEpochs; ++epoch)
+  {
+    // The next chunk is loaded while this one is used.
+    double l = 0.0;
+    while (loader.Next(observations, responses))
+    {
+      CheckParameters(observations, dists);
+      l += Epoch(observations, arma::ones<arma::vec>(observations.n_cols),
+          dists, weights, initialize);
+      initialize = false;
+    }
+
+    Log::Info << "OnlineEMFit::Estimate(): epoch " << epoch << ", "
+        << "log-likelihood " << l << "." << std::endl;
+
+    if (std::abs(l - lOld) < tolerance)
+      break;
+    lOld = l;
+  }
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+double OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::Step(const arma::mat& observations,
+                        std::vector<Distribution>& dists,
+                        arma::vec& weights)
+{
+  return Step(observations, arma::ones<arma::vec>(observations.n_cols), dists,
+      weights);
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+double OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::Step(const arma::mat& observations,
+                        const arma::vec& probabilities,
+                        std::vector<Distribution>& dists,
+                        arma::vec& weights)
+{
+  CheckParameters(observations, dists);
+  if (probabilities.n_elem != observations.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "OnlineEMFit::Step(): " << probabilities.n_elem << " probabilities "
+        << "given for " << observations.n_cols << " observations!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  const bool isDiagGaussDist = std::is_same<Distribution,
+      distribution::DiagonalGaussianDistribution>::value;
+
+  if (steps == 0)
+    InitializeStatistics(dists, weights);
+
+  // Calculate the conditional probabilities of choosing a particular Gaussian
+  // given the observations and the present model (the E-step).
+  const arma::vec logWeights = arma::log(weights);
+  arma::mat condLogProb(observations.n_cols, dists.size());
+  arma::vec logProbabilities;
+  for (size_t i = 0; i < dists.size(); ++i)
+  {
+    dists[i].LogProbability(observations, logProbabilities);
+    condLogProb.col(i) = logProbabilities + logWeights[i];
+  }
+
+  // Normalize each point, subtracting the largest term so that the
+  // exponentials do not underflow, and weight it by its probability.  Points
+  // with zero likelihood under every component are ignored.
+  const arma::vec maxLogProb = arma::max(condLogProb, 1);
+  arma::mat responsibilities = arma::exp(condLogProb.each_col() - maxLogProb);
+  const double totalProbability = arma::accu(probabilities);
+  double logLikelihood = 0.0;
+  for (size_t j = 0; j < observations.n_cols; ++j)
+  {
+    if (maxLogProb[j] == -std::numeric_limits<double>::infinity())
+    {
+      logLikelihood += maxLogProb[j];
+      responsibilities.row(j).zeros();
+      continue;
+    }
+
+    const double sum = arma::accu(responsibilities.row(j));
+    logLikelihood += maxLogProb[j] + std::log(sum);
+    responsibilities.row(j) *= probabilities[j] / (sum * totalProbability);
+  }
+
+  // Blend the statistics of the minibatch into the running statistics.
+  const double stepSize = std::pow(steps + stepOffset, -stepDecay);
+  sumWeights = (1.0 - stepSize) * sumWeights + stepSize *
+      arma::sum(responsibilities, 0).t();
+  sumObservations = (1.0 - stepSize) * sumObservations + stepSize *
+      observations * responsibilities;
+  if (isDiagGaussDist)
+  {
+    const arma::mat batchSquares = (observations % observations) *
+        responsibilities;
+    for (size_t i = 0; i < dists.size(); ++i)
+    {
+      sumSquares[i] = (1.0 - stepSize) * sumSquares[i] + stepSize *
+          batchSquares.col(i);
+    }
+  }
+  else
+  {
+    #pragma omp parallel for
+    for (omp_size_t i = 0; i < (omp_size_t) dists.size(); ++i)
+    {
+      sumSquares[i] = (1.0 - stepSize) * sumSquares[i] + stepSize *
+          (observations.each_row() % responsibilities.col(i).t()) *
+          observations.t();
+    }
+  }
+
+  // Now compute the model from the running statistics (the M-step).
+  for (size_t i = 0; i < dists.size(); ++i)
+  {
+    // Don't update if the Gaussian has never had any points.
+    if (sumWeights[i] <= 0.0)
+      continue;
+
+    arma::vec mean = sumObservations.col(i) / sumWeights[i];
+    CovarianceType covariance;
+    if (isDiagGaussDist)
+      covariance = sumSquares[i] / sumWeights[i] - mean % mean;
+    else
+      covariance = sumSquares[i] / sumWeights[i] - mean * mean.t();
+
+    // Apply constraints to covariance matrix.
+    constraint.ApplyConstraint(covariance);
+
+    dists[i].Mean() = std::move(mean);
+    dists[i].Covariance(std::move(covariance));
+  }
+
+  weights = sumWeights / arma::accu(sumWeights);
+  ++steps;
+
+  return logLikelihood;
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+double OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::Epoch(const arma::mat& observations,
+                         const arma::vec& probabilities,
+                         std::vector<Distribution>& dists,
+                         arma::vec& weights,
+                         const bool initialize)
+{
+  const arma::uvec order = arma::randperm<arma::uvec>(observations.n_cols);
+
+  double logLikelihood = 0.0;
+  for (size_t begin = 0; begin < observations.n_cols; begin += batchSize)
+  {
+    const size_t end = std::min(begin + batchSize,
+        (size_t) observations.n_cols);
+    const arma::uvec batch = order.subvec(begin, end - 1);
+    const arma::mat batchObservations = observations.cols(batch);
+
+    if (initialize && begin == 0)
+      InitialClustering(batchObservations, dists, weights);
+
+    logLikelihood += Step(batchObservations, probabilities.elem(batch), dists,
+        weights);
+  }
+
+  return logLikelihood;
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::InitialClustering(const arma::mat& observations,
+                                     std::vector<Distribution>& dists,
+                                     arma::vec& weights)
+{
+  // With a single iteration, EMFit only finds the initial model (with
+  // diagonal covariances, Armadillo also runs one EM iteration).
+  EMFit<InitialClusteringType, CovarianceConstraintPolicy, Distribution>
+      fitter(1, 1e-10, clusterer, constraint);
+  fitter.Estimate(observations, dists, weights, false);
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::InitializeStatistics(const std::vector<Distribution>& dists,
+                                        const arma::vec& weights)
+{
+  const bool isDiagGaussDist = std::is_same<Distribution,
+      distribution::DiagonalGaussianDistribution>::value;
+
+  sumWeights = weights;
+  sumObservations.set_size(dists[0].Mean().n_elem, dists.size());
+  sumSquares.resize(dists.size());
+  for (size_t i = 0; i < dists.size(); ++i)
+  {
+    const arma::vec& mean = dists[i].Mean();
+    sumObservations.col(i) = weights[i] * mean;
+    if (isDiagGaussDist)
+      sumSquares[i] = weights[i] * (dists[i].Covariance() + mean % mean);
+    else
+      sumSquares[i] = weights[i] * (dists[i].Covariance() + mean * mean.t());
+  }
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::CheckParameters(const arma::mat& observations,
+                                   const std::vector<Distribution>& dists)
+    const
+{
+  if (batchSize == 0)
+  {
+    throw std::invalid_argument("OnlineEMFit: the batch size must be "
+        "positive!");
+  }
+
+  if (stepDecay <= 0.5 || stepDecay > 1.0)
+  {
+    throw std::invalid_argument("OnlineEMFit: the step decay must be in "
+        "(0.5, 1]!");
+  }
+
+  if (stepOffset < 1.0)
+  {
+    throw std::invalid_argument("OnlineEMFit: the step offset must be at "
+        "least 1!");
+  }
+
+  if (dists.empty())
+    throw std::invalid_argument("OnlineEMFit: the model has no components!");
+
+  if (observations.n_rows != dists[0].Mean().n_elem)
+  {
+    std::ostringstream oss;
+    oss << "OnlineEMFit: the observations have dimensionality "
+        << observations.n_rows << ", but the model has dimensionality "
+        << dists[0].Mean().n_elem << "!";
+    throw std::invalid_argument(oss.str());
+  }
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+template<typename Archive>
+void OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::serialize(Archive& ar, const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(batchSize);
+  ar & BOOST_SERIALIZATION_NVP(maxEpochs);
+  ar & BOOST_SERIALIZATION_NVP(stepDecay);
+  ar & BOOST_SERIALIZATION_NVP(stepOffset);
+  ar & BOOST_SERIALIZATION_NVP(tolerance);
+  ar & BOOST_SERIALIZATION_NVP(clusterer);
+  ar & BOOST_SERIALIZATION_NVP(constraint);
+
+  // The running statistics are not kept.
+  if (Archive::is_loading::value)
+    Reset();
+}
+
+} // namespace gmm
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,42 @@
+/**
+ * @file methods/gradient_boosting/gradient_boosting.cpp
+ *
+ * Implementation of the non-templated functions of the GradientBoosting class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "gradient_boosting.hpp"
+
+namespace mlpack {
+namespace tree {
+
+GradientBoosting::GradientBoosting() :
+    numClasses(0),
+    learningRate(0.0)
+{
+  // Nothing to do.
+}
+
+void GradientBoosting::Softmax(double* scores, const size_t numClasses)
+{
+  // Subtract the largest score to avoid overflow.
+  double maxScore = scores[0];
+  for (size_t k = 1; k < numClasses; ++k)
+    maxScore = std::max(maxScore, scores[k]);
+
+  double sum = 0.0;
+  for (size_t k = 0; k < numClasses; ++k)
+  {
+    scores[k] = std::exp(scores[k] - maxScore);
+    sum += scores[k];
+  }
+
+  for (size_t k = 0; k < numClasses; ++k)
+    scores[k] /= sum;
+}
+
+} // namespace tree
+} // namespace mlpack
@@ -0,0 +1,197 @@
+/**
+ * @file methods/gradient_boosting/gradient_boosting.hpp
+ *
+ * Definition of the GradientBoosting class, which trains an ensemble of
+ * regression trees by gradient boosting for classification.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_GRADIENT_BOOSTING_GRADIENT_BOOSTING_HPP
+#define MLPACK_METHODS_GRADIENT_BOOSTING_GRADIENT_BOOSTING_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "gradient_boosting_tree.hpp"
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The GradientBoosting class implements gradient boosted decision trees for
+ * classification.  Each class has a score, and the probabilities of the
+ * classes are the softmax of the scores.  Starting from the logarithms of the
+ * class frequencies, each iteration fits one GradientBoostingTree per class to
+ * the first and second derivatives of the cross-entropy loss, and adds its
+ * predictions, scaled by the learning rate (shrinkage), to the scores.
+ *
+ * The dataset is binned once, before training: each dimension gets up to
+ * numBins bins, bounded by quantiles of its values.  In each iteration a
+ * random fraction of the points (row subsampling) and of the dimensions
+ * (feature subsampling) are used.  With OpenMP, the histograms of the
+ * dimensions of a node are built in parallel, as are the predictions.
+ *
+ * @code
+ * GradientBoosting gb(data, labels, numClasses, 100, 0.1);
+ * gb.Classify(testData, predictions, probabilities);
+ * @endcode
+ */
+class GradientBoosting
+{
+ public:
+  /**
+   * Create the GradientBoosting object without training; Classify() will
+   * throw an exception until Train() is called.
+   */
+  GradientBoosting();
+
+  /**
+   * Train a model on the given labeled data.  See Train() for the meaning of
+   * the parameters.
+   */
+  template<typename MatType>
+  GradientBoosting(const MatType& data,
+                   const arma::Row<size_t>& labels,
+                   const size_t numClasses,
+                   const size_t numIterations = 100,
+                   const double learningRate = 0.1,
+                   const size_t maximumDepth = 6,
+                   const size_t minimumLeafSize = 20,
+                   const double subsampleRatio = 1.0,
+                   const double featureRatio = 1.0,
+                   const size_t numBins = 256,
+                   const double lambda = 1.0);
+
+  /**
+   * Train the model on the given labeled data; any previous model is
+   * discarded.
+   *
+   * @param data Dataset to train on.
+   * @param labels Labels of the points, in [0, numClasses).
+   * @param numClasses Number of classes.
+   * @param numIterations Number of boosting iterations; each one adds one
+   *     tree per class.
+   * @param learningRate Factor applied to the predictions of each tree.
+   * @param maximumDepth Maximum depth of each tree (0 means no limit).
+   * @param minimumLeafSize Minimum number of points in each leaf.
+   * @param subsampleRatio Fraction of the points used in each iteration.
+   * @param featureRatio Fraction of the dimensions used in each iteration.
+   * @param numBins Maximum number of bins of each dimension (at most 256).
+   * @param lambda L2 regularization of the values of the leaves.
+   * @return The average cross-entropy of the training points at the end.
+   */
+  template<typename MatType>
+  double Train(const MatType& data,
+               const arma::Row<size_t>& labels,
+               const size_t numClasses,
+               const size_t numIterations = 100,
+               const double learningRate = 0.1,
+               const size_t maximumDepth = 6,
+               const size_t minimumLeafSize = 20,
+               const double subsampleRatio = 1.0,
+               const double featureRatio = 1.0,
+               const size_t numBins = 256,
+               const double lambda = 1.0);
+
+  /**
+   * Predict the class of the given point.
+   *
+   * @param point Point to classify.
+   */
+  template<typename VecType>
+  size_t Classify(const VecType& point) const;
+
+  /**
+   * Predict the class of the given point, and the probabilities of all
+   * classes.
+   *
+   * @param point Point to classify.
+   * @param prediction This will be set to the predicted class.
+   * @param probabilities This will be filled with the class probabilities.
+   */
+  template<typename VecType>
+  void Classify(const VecType& point,
+                size_t& prediction,
+                arma::vec& probabilities) const;
+
+  /**
+   * Predict the class of each of the given points.
+   *
+   * @param data Points to classify.
+   * @param predictions This will be filled with the predicted classes.
+   */
+  template<typename MatType>
+  void Classify(const MatType& data, arma::Row<size_t>& predictions) const;
+
+  /**
+   * Predict the class of each of the given points, and the probabilities of
+   * all classes for each point.
+   *
+   * @param data Points to classify.
+   * @param predictions This will be filled with the predicted classes.
+   * @param probabilities This will be filled with the class probabilities of
+   *     each point.
+   */
+  template<typename MatType>
+  void Classify(const MatType& data,
+                arma::Row<size_t>& predictions,
+                arma::mat& probabilities) const;
+
+  //! Get the number of classes.
+  size_t NumClasses() const { return numClasses; }
+  //! Get the number of boosting iterations of the model.
+  size_t NumIterations() const
+  {
+    return (numClasses == 0) ? 0 : trees.size() / numClasses;
+  }
+  //! Get the learning rate that the model was trained with.
+  double LearningRate() const { return learningRate; }
+
+  //! Get the tree of the given class at the given iteration.
+  const GradientBoostingTree& Tree(const size_t iteration,
+                                   const size_t label) const
+  {
+    return trees[iteration * numClasses + label];
+  }
+
+  //! Serialize the model.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  /**
+   * Find the thresholds of the bins of each dimension of the given data.  A
+   * dimension with few distinct values gets one bin per value.
+   */
+  template<typename MatType>
+  static void ComputeThresholds(const MatType& data,
+                                const size_t numBins,
+                                std::vector<arma::vec>& thresholds);
+
+  //! Find the bin of each value of the given data.
+  template<typename MatType>
+  static void ComputeBins(const MatType& data,
+                          const std::vector<arma::vec>& thresholds,
+                          arma::Mat<unsigned char>& bins);
+
+  //! Turn the given scores into class probabilities, in place.
+  static void Softmax(double* scores, const size_t numClasses);
+
+  //! The number of classes.
+  size_t numClasses;
+  //! The learning rate the model was trained with.
+  double learningRate;
+  //! The scores of the classes before the first iteration.
+  arma::vec initialScores;
+  //! The trees; the trees of one iteration are next to each other.
+  std::vector<GradientBoostingTree> trees;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "gradient_boosting_impl.hpp"
+
+#endif
@@ -0,0 +1,293 @@
+/**
+ * @file methods/gradient_boosting/gradient_boosting_impl.hpp
+ *
+ * Implementation of the templated functions of the GradientBoosting class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_GRADIENT_BOOSTING_GRADIENT_BOOSTING_IMPL_HPP
+#define MLPACK_METHODS_GRADIENT_BOOSTING_GRADIENT_BOOSTING_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "gradient_boosting.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template<typename MatType>
+GradientBoosting::GradientBoosting(const MatType& data,
+                                   const arma::Row<size_t>& labels,
+                                   const size_t numClasses,
+                                   const size_t numIterations,
+                                   const double learningRate,
+                                   const size_t maximumDepth,
+                                   const size_t minimumLeafSize,
+                                   const double subsampleRatio,
+                                   const double featureRatio,
+                                   const size_t numBins,
+                                   const double lambda) :
+    numClasses(0),
+    learningRate(0.0)
+{
+  Train(data, labels, numClasses, numIterations, learningRate, maximumDepth,
+      minimumLeafSize, subsampleRatio, featureRatio, numBins, lambda);
+}
+
+template<typename MatType>
+double GradientBoosting::Train(const MatType& data,
+                               const arma::Row<size_t>& labels,
+                               const size_t numClasses,
+                               const size_t numIterations,
+                               const double learningRate,
+                               const size_t maximumDepth,
+                               const size_t minimumLeafSize,
+                               const double subsampleRatio,
+                               const double featureRatio,
+                               const size_t numBins,
+                               const double lambda)
+{
+  // Sanity checks on the parameters.
+  if (data.n_cols != labels.n_elem)
+  {
+    std::ostringstream oss;
+    oss << "GradientBoosting::Train(): number of points (" << data.n_cols
+        << ") does not match number of labels (" << labels.n_elem << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (data.n_cols == 0 || numClasses == 0)
+  {
+    throw std::invalid_argument("GradientBoosting::Train(): need at least one "
+        "point and one class!");
+  }
+
+  if (arma::max(labels) >= numClasses)
+  {
+    throw std::invalid_argument("GradientBoosting::Train(): labels must be in "
+        "[0, numClasses)!");
+  }
+
+  if (subsampleRatio <= 0.0 || subsampleRatio > 1.0 || featureRatio <= 0.0 ||
+      featureRatio > 1.0)
+  {
+    throw std::invalid_argument("GradientBoosting::Train(): the subsampling "
+        "ratios must be in (0, 1]!");
+  }
+
+  if (numBins < 2 || numBins > 256)
+  {
+    throw std::invalid_argument("GradientBoosting::Train(): the number of bins "
+        "must be between 2 and 256!");
+  }
+
+  this->numClasses = numClasses;
+  this->learningRate = learningRate;
+  trees.clear();
+  trees.resize(numIterations * numClasses);
+
+  Timer::Start("gradient_boosting_binning");
+  std::vector<arma::vec> thresholds;
+  arma::Mat<unsigned char> bins;
+  ComputeThresholds(data, numBins, thresholds);
+  ComputeBins(data, thresholds, bins);
+  Timer::Stop("gradient_boosting_binning");
+
+  // Start from the logarithms of the class frequencies; classes that do not
+  // appear get a count of one.
+  arma::vec counts(numClasses, arma::fill::zeros);
+  for (size_t i = 0; i < labels.n_elem; ++i)
+    counts[labels[i]] += 1.0;
+  initialScores = arma::log(arma::clamp(counts, 1.0, DBL_MAX) / data.n_cols);
+
+  arma::mat scores = arma::repmat(initialScores, 1, data.n_cols);
+  arma::mat probabilities(numClasses, data.n_cols);
+  arma::vec gradients(data.n_cols);
+  arma::vec hessians(data.n_cols);
+
+  const size_t numPoints = std::max((size_t) std::round(subsampleRatio *
+      data.n_cols), (size_t) 1);
+  const size_t numDimensions = std::max((size_t) std::round(featureRatio *
+      data.n_rows), (size_t) 1);
+
+  for (size_t t = 0; t < numIterations; ++t)
+  {
+    probabilities = scores;
+    #pragma omp parallel for
+    for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+      Softmax(probabilities.colptr(i), numClasses);
+
+    // The same points and dimensions are used for the trees of all classes.
+    arma::uvec points = (numPoints == data.n_cols) ?
+        arma::linspace<arma::uvec>(0, data.n_cols - 1, data.n_cols) :
+        arma::uvec(arma::sort(arma::randperm<arma::uvec>(data.n_cols,
+        numPoints)));
+    arma::uvec dimensions = (numDimensions == data.n_rows) ?
+        arma::linspace<arma::uvec>(0, data.n_rows - 1, data.n_rows) :
+        arma::uvec(arma::sort(arma::randperm<arma::uvec>(data.n_rows,
+        numDimensions)));
+
+    Timer::Start("gradient_boosting_tree_training");
+    for (size_t k = 0; k < numClasses; ++k)
+    {
+      // The derivatives of the cross-entropy with respect to the score.
+      for (size_t i = 0; i < data.n_cols; ++i)
+      {
+        const double p = probabilities(k, i);
+        gradients[i] = p - ((labels[i] == k) ? 1.0 : 0.0);
+        hessians[i] = std::max(p * (1.0 - p), 1e-16);
+      }
+
+      GradientBoostingTree& tree = trees[t * numClasses + k];
+      tree.Train(bins, thresholds, points, dimensions, gradients, hessians,
+          maximumDepth, minimumLeafSize, lambda);
+
+      #pragma omp parallel for
+      for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+        scores(k, i) += learningRate * tree.PredictBins(bins.colptr(i));
+    }
+    Timer::Stop("gradient_boosting_tree_training");
+  }
+
+  // Compute the final loss.
+  double loss = 0.0;
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    Softmax(scores.colptr(i), numClasses);
+    loss -= std::log(std::max(scores(labels[i], i), 1e-300));
+  }
+
+  return loss / data.n_cols;
+}
+
+template<typename VecType>
+size_t GradientBoosting::Classify(const VecType& point) const
+{
+  size_t prediction;
+  arma::vec probabilities;
+  Classify(point, prediction, probabilities);
+
+  return prediction;
+}
+
+template<typename VecType>
+void GradientBoosting::Classify(const VecType& point,
+                                size_t& prediction,
+                                arma::vec& probabilities) const
+{
+  if (numClasses == 0)
+  {
+    throw std::invalid_argument("GradientBoosting::Classify(): no model "
+        "trained!");
+  }
+
+  probabilities = initialScores;
+  for (size_t t = 0; t < trees.size(); ++t)
+    probabilities[t % numClasses] += learningRate * trees[t].Predict(point);
+  Softmax(probabilities.memptr(), numClasses);
+
+  arma::uword maxIndex = 0;
+  probabilities.max(maxIndex);
+  prediction = (size_t) maxIndex;
+}
+
+template<typename MatType>
+void GradientBoosting::Classify(const MatType& data,
+                                arma::Row<size_t>& predictions) const
+{
+  arma::mat probabilities;
+  Classify(data, predictions, probabilities);
+}
+
+template<typename MatType>
+void GradientBoosting::Classify(const MatType& data,
+                                arma::Row<size_t>& predictions,
+                                arma::mat& probabilities) const
+{
+  if (numClasses == 0)
+  {
+    throw std::invalid_argument("GradientBoosting::Classify(): no model "
+        "trained!");
+  }
+
+  predictions.set_size(data.n_cols);
+  probabilities.set_size(numClasses, data.n_cols);
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+  {
+    arma::vec probs = probabilities.unsafe_col(i);
+    Classify(data.col(i), predictions[i], probs);
+  }
+}
+
+template<typename Archive>
+void GradientBoosting::serialize(Archive& ar, const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(numClasses);
+  ar & BOOST_SERIALIZATION_NVP(learningRate);
+  ar & BOOST_SERIALIZATION_NVP(initialScores);
+  ar & BOOST_SERIALIZATION_NVP(trees);
+}
+
+template<typename MatType>
+void GradientBoosting::ComputeThresholds(const MatType& data,
+                                         const size_t numBins,
+                                         std::vector<arma::vec>& thresholds)
+{
+  thresholds.resize(data.n_rows);
+  #pragma omp parallel for
+  for (omp_size_t d = 0; d < (omp_size_t) data.n_rows; ++d)
+  {
+    const arma::vec values = arma::sort(arma::vec(
+        arma::conv_to<arma::rowvec>::from(data.row(d)).t()));
+    const arma::vec distinct = arma::unique(values);
+
+    if (distinct.n_elem <= numBins)
+    {
+      // Put the thresholds between the distinct values.
+      thresholds[d] = (distinct.n_elem < 2) ? arma::vec() :
+          arma::vec((distinct.head(distinct.n_elem - 1) +
+          distinct.tail(distinct.n_elem - 1)) / 2.0);
+    }
+    else
+    {
+      // Use quantiles of the values; a value that covers several quantiles
+      // gives only one threshold.
+      arma::vec quantiles(numBins - 1);
+      for (size_t b = 1; b < numBins; ++b)
+        quantiles[b - 1] = values[b * values.n_elem / numBins];
+      thresholds[d] = arma::unique(quantiles);
+
+      // The largest value does not need a threshold.
+      if (thresholds[d][thresholds[d].n_elem - 1] >= distinct.max())
+        thresholds[d].shed_row(thresholds[d].n_elem - 1);
+    }
+  }
+}
+
+template<typename MatType>
+void GradientBoosting::ComputeBins(const MatType& data,
+                                   const std::vector<arma::vec>& thresholds,
+                                   arma::Mat<unsigned char>& bins)
+{
+  bins.set_size(data.n_rows, data.n_cols);
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+  {
+    for (size_t d = 0; d < data.n_rows; ++d)
+    {
+      // The bin is the index of the first threshold that is at least the
+      // value.
+      const arma::vec& t = thresholds[d];
+      bins(d, i) = (unsigned char) (std::lower_bound(t.begin(), t.end(),
+          (double) data(d, i)) - t.begin());
+    }
+  }
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,290 @@
+/**
+ * @file methods/gradient_boosting/gradient_boosting_main.cpp
+ *
+ * A program to build and evaluate gradient boosted trees.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/gradient_boosting/gradient_boosting.hpp>
+#include <mlpack/core/util/mlpack_main.hpp>
+
+using namespace mlpack;
+using namespace mlpack::tree;
+using namespace mlpack::util;
+using namespace std;
+
+PROGRAM_INFO("Gradient boosted trees",
+    // Short description.
+    "An implementation of gradient boosted decision trees for classification.  "
+    "Given labeled data, a model can be trained and saved for future use; or, "
+    "a pre-trained model can be used for classification.",
+    // Long description.
+    "This program is an implementation of gradient boosted decision trees for "
+    "classification, in the style of XGBoost and LightGBM.  In each boosting "
+    "iteration one regression tree per class is fit to the derivatives of the "
+    "cross-entropy loss, using histograms of the binned dataset.  A model can "
+    "be trained and saved for later use, or a model may be loaded and "
+    "predictions or class probabilities for points may be generated."
+    "\n\n"
+    "The training set and associated labels are specified with the " +
+    PRINT_PARAM_STRING("training") + " and " + PRINT_PARAM_STRING("labels") +
+    " parameters, respectively.  The labels should be in the range [0, "
+    "num_classes - 1]."
+    "\n\n"
+    "When a model is trained, the " + PRINT_PARAM_STRING("output_model") + " "
+    "output parameter may be used to save the trained model.  A model may be "
+    "loaded for predictions with the " + PRINT_PARAM_STRING("input_model") +
+    " parameter.  The " + PRINT_PARAM_STRING("input_model") + " parameter may "
+    "not be specified when the " + PRINT_PARAM_STRING("training") + " parameter"
+    " is specified.  The " + PRINT_PARAM_STRING("num_iterations") + " parameter"
+    " controls the number of boosting iterations, and the " +
+    PRINT_PARAM_STRING("learning_rate") + " parameter scales the predictions "
+    "of each tree (shrinkage).  The " + PRINT_PARAM_STRING("maximum_depth") +
+    " and " + PRINT_PARAM_STRING("minimum_leaf_size") + " parameters control "
+    "the size of each tree, and the " + PRINT_PARAM_STRING("lambda") +
+    " parameter is the L2 regularization of the values of the leaves.  The " +
+    PRINT_PARAM_STRING("subsample") + " and " +
+    PRINT_PARAM_STRING("feature_subsample") + " parameters give the fraction "
+    "of the points and of the dimensions used in each iteration, and " +
+    PRINT_PARAM_STRING("num_bins") + " is the maximum number of bins of each "
+    "dimension.  If " + PRINT_PARAM_STRING("print_training_accuracy") + " is "
+    "specified, the calculated accuracy on the training set will be printed."
+    "\n\n"
+    "Test data may be specified with the " + PRINT_PARAM_STRING("test") + " "
+    "parameter, and if performance measures are desired for that test set, "
+    "labels for the test points may be specified with the " +
+    PRINT_PARAM_STRING("test_labels") + " parameter.  Predictions for each "
+    "test point may be saved via the " + PRINT_PARAM_STRING("predictions") +
+    " output parameter.  Class probabilities for each prediction may be saved "
+    "with the " + PRINT_PARAM_STRING("probabilities") + " output parameter."
+    "\n\n"
+    "For example, to train a model with 200 iterations and a learning rate of "
+    "0.05 on the dataset contained in " + PRINT_DATASET("data") + " with "
+    "labels " + PRINT_DATASET("labels") + ", saving the output model to " +
+    PRINT_MODEL("gb_model") + " and printing the training error, one could "
+    "call"
+    "\n\n" +
+    PRINT_CALL("gradient_boosting", "training", "data", "labels", "labels",
+        "num_iterations", 200, "learning_rate", 0.05, "output_model",
+        "gb_model", "print_training_accuracy", true) +
+    "\n\n"
+    "Then, to use that model to classify points in " +
+    PRINT_DATASET("test_set") + " and print the test error given the labels " +
+    PRINT_DATASET("test_labels") + " using that model, while saving the "
+    "predictions for each point to " + PRINT_DATASET("predictions") + ", one "
+    "could call "
+    "\n\n" +
+    PRINT_CALL("gradient_boosting", "input_model", "gb_model", "test",
+        "test_set", "test_labels", "test_labels", "predictions",
+        "predictions"),
+    SEE_ALSO("@random_forest", "#random_forest"),
+    SEE_ALSO("@adaboost", "#adaboost"),
+    SEE_ALSO("@decision_tree", "#decision_tree"),
+    SEE_ALSO("Gradient boosting on Wikipedia",
+        "https://en.wikipedia.org/wiki/Gradient_boosting"),
+    SEE_ALSO("XGBoost: A Scalable Tree Boosting System (pdf)",
+        "https://arxiv.org/pdf/1603.02754.pdf"),
+    SEE_ALSO("mlpack::tree::GradientBoosting C++ class documentation",
+        "@doxygen/classmlpack_1_1tree_1_1GradientBoosting.html"));
+
+PARAM_MATRIX_IN("training", "Training dataset.", "t");
+PARAM_UROW_IN("labels", "Labels for training dataset.", "l");
+PARAM_MATRIX_IN("test", "Test dataset to produce predictions for.", "T");
+PARAM_UROW_IN("test_labels", "Test dataset labels, if accuracy calculation is "
+    "desired.", "L");
+
+PARAM_FLAG("print_training_accuracy", "If set, then the accuracy of the model "
+    "on the training set will be predicted (verbose must also be specified).",
+    "a");
+
+PARAM_INT_IN("num_iterations", "Number of boosting iterations; each one adds "
+    "a tree for each class.", "N", 100);
+PARAM_DOUBLE_IN("learning_rate", "Factor applied to the predictions of each "
+    "tree.", "r", 0.1);
+PARAM_INT_IN("maximum_depth", "Maximum depth of each tree (0 means no limit).",
+    "D", 6);
+PARAM_INT_IN("minimum_leaf_size", "Minimum number of points in each leaf "
+    "node.", "n", 20);
+PARAM_DOUBLE_IN("lambda", "L2 regularization of the values of the leaves.",
+    "g", 1.0);
+PARAM_DOUBLE_IN("subsample", "Fraction of the points used in each "
+    "iteration.", "S", 1.0);
+PARAM_DOUBLE_IN("feature_subsample", "Fraction of the dimensions used in each "
+    "iteration.", "F", 1.0);
+PARAM_INT_IN("num_bins", "Maximum number of bins of each dimension (at most "
+    "256).", "b", 256);
+
+PARAM_MATRIX_OUT("probabilities", "Predicted class probabilities for each "
+    "point in the test set.", "P");
+PARAM_UROW_OUT("predictions", "Predicted classes for each point in the test "
+    "set.", "p");
+
+PARAM_INT_IN("seed", "Random seed.  If 0, 'std::time(NULL)' is used.", "s", 0);
+
+/**
+ * This is the class that we will serialize.  It is a simple wrapper around
+ * GradientBoosting.
+ */
+class GradientBoostingModel
+{
+ public:
+  // The model itself, left public for direct access by this program.
+  GradientBoosting gb;
+
+  // Create the model.
+  GradientBoostingModel() { /* Nothing to do. */ }
+
+  // Serialize the model.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(gb);
+  }
+};
+
+PARAM_MODEL_IN(GradientBoostingModel, "input_model", "Pre-trained gradient "
+    "boosting model to use for classification.", "m");
+PARAM_MODEL_OUT(GradientBoostingModel, "output_model", "Model to save trained "
+    "gradient boosting model to.", "M");
+
+static void mlpackMain()
+{
+  // Initialize random seed if needed.
+  if (CLI::GetParam<int>("seed") != 0)
+    math::RandomSeed((size_t) CLI::GetParam<int>("seed"));
+  else
+    math::RandomSeed((size_t) std::time(NULL));
+
+  // Check for incompatible input parameters.
+  RequireOnlyOnePassed({ "training", "input_model" }, true);
+
+  ReportIgnoredParam({{ "training", false }}, "print_training_accuracy");
+  ReportIgnoredParam({{ "test", false }}, "test_labels");
+
+  RequireAtLeastOnePassed({ "test", "output_model", "print_training_accuracy" },
+      false, "the trained model will not be used or saved");
+
+  if (CLI::HasParam("training"))
+  {
+    RequireAtLeastOnePassed({ "labels" }, true, "must pass labels when training"
+        " set given");
+  }
+
+  RequireParamValue<int>("num_iterations", [](int x) { return x > 0; }, true,
+      "number of iterations must be positive");
+  RequireParamValue<double>("learning_rate", [](double x) { return x > 0.0; },
+      true, "learning rate must be positive");
+  RequireParamValue<int>("maximum_depth", [](int x) { return x >= 0; }, true,
+      "maximum depth must not be negative");
+  RequireParamValue<int>("minimum_leaf_size", [](int x) { return x > 0; }, true,
+      "minimum leaf size must be greater than 0");
+  RequireParamValue<double>("lambda", [](double x) { return x >= 0.0; }, true,
+      "lambda must be nonnegative");
+  RequireParamValue<double>("subsample",
+      [](double x) { return x > 0.0 && x <= 1.0; }, true,
+      "subsample ratio must be in (0, 1]");
+  RequireParamValue<double>("feature_subsample",
+      [](double x) { return x > 0.0 && x <= 1.0; }, true,
+      "feature subsample ratio must be in (0, 1]");
+  RequireParamValue<int>("num_bins", [](int x) { return x >= 2 && x <= 256; },
+      true, "number of bins must be between 2 and 256");
+
+  ReportIgnoredParam({{ "test", false }}, "predictions");
+  ReportIgnoredParam({{ "test", false }}, "probabilities");
+
+  ReportIgnoredParam({{ "training", false }}, "num_iterations");
+  ReportIgnoredParam({{ "training", false }}, "learning_rate");
+  ReportIgnoredParam({{ "training", false }}, "maximum_depth");
+  ReportIgnoredParam({{ "training", false }}, "minimum_leaf_size");
+
+  GradientBoostingModel* gbModel;
+  if (CLI::HasParam("training"))
+  {
+    Timer::Start("gb_training");
+    gbModel = new GradientBoostingModel();
+
+    // Train the model on the given input data.
+    arma::mat data = std::move(CLI::GetParam<arma::mat>("training"));
+    arma::Row<size_t> labels =
+        std::move(CLI::GetParam<arma::Row<size_t>>("labels"));
+
+    const size_t numIterations = (size_t) CLI::GetParam<int>("num_iterations");
+    const double learningRate = CLI::GetParam<double>("learning_rate");
+    const size_t maxDepth = (size_t) CLI::GetParam<int>("maximum_depth");
+    const size_t minimumLeafSize =
+        (size_t) CLI::GetParam<int>("minimum_leaf_size");
+    const double lambda = CLI::GetParam<double>("lambda");
+    const double subsample = CLI::GetParam<double>("subsample");
+    const double featureSubsample = CLI::GetParam<double>("feature_subsample");
+    const size_t numBins = (size_t) CLI::GetParam<int>("num_bins");
+
+    Log::Info << "Training gradient boosted trees with " << numIterations
+        << " iterations..." << endl;
+
+    const size_t numClasses = arma::max(labels) + 1;
+
+    // Train the model.
+    const double loss = gbModel->gb.Train(data, labels, numClasses,
+        numIterations, learningRate, maxDepth, minimumLeafSize, subsample,
+        featureSubsample, numBins, lambda);
+    Log::Info << "Average cross-entropy on the training set: " << loss << "."
+        << endl;
+    Timer::Stop("gb_training");
+
+    // Did we want training accuracy?
+    if (CLI::HasParam("print_training_accuracy"))
+    {
+      Timer::Start("gb_prediction");
+      arma::Row<size_t> predictions;
+      gbModel->gb.Classify(data, predictions);
+
+      const size_t correct = arma::accu(predictions == labels);
+
+      Log::Info << correct << " of " << labels.n_elem << " correct on training"
+          << " set (" << (double(correct) / double(labels.n_elem) * 100) << ")."
+          << endl;
+      Timer::Stop("gb_prediction");
+    }
+  }
+  else
+  {
+    // Then we must be loading a model.
+    gbModel = CLI::GetParam<GradientBoostingModel*>("input_model");
+  }
+
+  if (CLI::HasParam("test"))
+  {
+    arma::mat testData = std::move(CLI::GetParam<arma::mat>("test"));
+    Timer::Start("gb_prediction");
+
+    // Get predictions and probabilities.
+    arma::Row<size_t> predictions;
+    arma::mat probabilities;
+    gbModel->gb.Classify(testData, predictions, probabilities);
+
+    // Did we want to calculate test accuracy?
+    if (CLI::HasParam("test_labels"))
+    {
+      arma::Row<size_t> testLabels =
+          std::move(CLI::GetParam<arma::Row<size_t>>("test_labels"));
+
+      const size_t correct = arma::accu(predictions == testLabels);
+
+      Log::Info << correct << " of " << testLabels.n_elem << " correct on test"
+          << " set (" << (double(correct) / double(testLabels.n_elem) * 100)
+          << ")." << endl;
+    }
+    Timer::Stop("gb_prediction");
+
+    // Save the outputs.
+    CLI::GetParam<arma::mat>("probabilities") = std::move(probabilities);
+    CLI::GetParam<arma::Row<size_t>>("predictions") = std::move(predictions);
+  }
+
+  // Save the output model.
+  CLI::GetParam<GradientBoostingModel*>("output_model") = gbModel;
+}
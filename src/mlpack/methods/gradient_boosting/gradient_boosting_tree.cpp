@@ -0,0 +1,174 @@
+/**
+ * @file methods/gradient_boosting/gradient_boosting_tree.cpp
+ *
+ * Implementation of the GradientBoostingTree class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "gradient_boosting_tree.hpp"
+
+namespace mlpack {
+namespace tree {
+
+GradientBoostingTree::GradientBoostingTree()
+{
+  // Nothing to do.
+}
+
+void GradientBoostingTree::Train(const arma::Mat<unsigned char>& bins,
+                                 const std::vector<arma::vec>& thresholds,
+                                 const arma::uvec& points,
+                                 const arma::uvec& dimensions,
+                                 const arma::vec& gradients,
+                                 const arma::vec& hessians,
+                                 const size_t maximumDepth,
+                                 const size_t minimumLeafSize,
+                                 const double lambda)
+{
+  nodes.clear();
+  nodes.resize(1);
+
+  std::vector<arma::uword> order(points.begin(), points.end());
+  Grow(0, bins, thresholds, order, 0, order.size(), dimensions, gradients,
+      hessians, maximumDepth, minimumLeafSize, lambda);
+}
+
+double GradientBoostingTree::PredictBins(const unsigned char* bins) const
+{
+  if (nodes.empty())
+    return 0.0;
+
+  size_t i = 0;
+  while (nodes[i].left != 0)
+  {
+    const Node& node = nodes[i];
+    i = node.left + ((bins[node.dimension] <= node.bin) ? 0 : 1);
+  }
+
+  return nodes[i].value;
+}
+
+void GradientBoostingTree::Grow(const size_t index,
+                                const arma::Mat<unsigned char>& bins,
+                                const std::vector<arma::vec>& thresholds,
+                                std::vector<arma::uword>& points,
+                                const size_t begin,
+                                const size_t count,
+                                const arma::uvec& dimensions,
+                                const arma::vec& gradients,
+                                const arma::vec& hessians,
+                                const size_t maximumDepth,
+                                const size_t minimumLeafSize,
+                                const double lambda)
+{
+  double sumGradients = 0.0;
+  double sumHessians = 0.0;
+  for (size_t i = begin; i < begin + count; ++i)
+  {
+    sumGradients += gradients[points[i]];
+    sumHessians += hessians[points[i]];
+  }
+
+  // Until a split is found, this is a leaf.
+  nodes[index].dimension = 0;
+  nodes[index].bin = 0;
+  nodes[index].left = 0;
+  nodes[index].value = (count == 0) ? 0.0 :
+      -sumGradients / (sumHessians + lambda);
+
+  // Force a minimum leaf size of 1 (empty children don't make sense).
+  const size_t minimum = std::max(minimumLeafSize, (size_t) 1);
+  if (maximumDepth == 1 || count < 2 * minimum)
+    return;
+
+  // Find the best split of each dimension from the histogram of the
+  // derivatives over its bins.  Small nodes are not worth the threads.
+  const double nodeScore = sumGradients * sumGradients / (sumHessians + lambda);
+  arma::vec gains(dimensions.n_elem, arma::fill::zeros);
+  arma::Col<size_t> splitBins(dimensions.n_elem, arma::fill::zeros);
+  #pragma omp parallel for schedule(dynamic) if(count >= 1000)
+  for (omp_size_t j = 0; j < (omp_size_t) dimensions.n_elem; ++j)
+  {
+    const size_t d = dimensions[j];
+    const size_t numBins = thresholds[d].n_elem + 1;
+    if (numBins < 2)
+      continue;
+
+    arma::vec binGradients(numBins, arma::fill::zeros);
+    arma::vec binHessians(numBins, arma::fill::zeros);
+    arma::Col<size_t> binCounts(numBins, arma::fill::zeros);
+    for (size_t i = begin; i < begin + count; ++i)
+    {
+      const size_t b = bins(d, points[i]);
+      binGradients[b] += gradients[points[i]];
+      binHessians[b] += hessians[points[i]];
+      ++binCounts[b];
+    }
+
+    double leftGradients = 0.0;
+    double leftHessians = 0.0;
+    size_t leftCount = 0;
+    for (size_t b = 0; b < numBins - 1; ++b)
+    {
+      leftGradients += binGradients[b];
+      leftHessians += binHessians[b];
+      leftCount += binCounts[b];
+
+      // An empty bin gives the same split as the bin before it.
+      if (binCounts[b] == 0 || leftCount < minimum)
+        continue;
+      if (count - leftCount < minimum)
+        break;
+
+      const double rightGradients = sumGradients - leftGradients;
+      const double rightHessians = sumHessians - leftHessians;
+      const double gain =
+          leftGradients * leftGradients / (leftHessians + lambda) +
+          rightGradients * rightGradients / (rightHessians + lambda) -
+          nodeScore;
+      if (gain > gains[j])
+      {
+        gains[j] = gain;
+        splitBins[j] = b;
+      }
+    }
+  }
+
+  // Take the best dimension; ties go to the first one.
+  size_t best = 0;
+  for (size_t j = 1; j < dimensions.n_elem; ++j)
+  {
+    if (gains[j] > gains[best])
+      best = j;
+  }
+
+  if (dimensions.n_elem == 0 || gains[best] <= 0.0)
+    return;
+
+  // Move the points of the left child before those of the right child.
+  const size_t dimension = dimensions[best];
+  const size_t bin = splitBins[best];
+  const size_t leftCount = std::stable_partition(points.begin() + begin,
+      points.begin() + begin + count,
+      [&](const arma::uword p) { return bins(dimension, p) <= bin; }) -
+      (points.begin() + begin);
+
+  const size_t left = nodes.size();
+  nodes[index].dimension = dimension;
+  nodes[index].bin = bin;
+  nodes[index].value = thresholds[dimension][bin];
+  nodes[index].left = left;
+  nodes.resize(left + 2);
+
+  Grow(left, bins, thresholds, points, begin, leftCount, dimensions,
+      gradients, hessians, maximumDepth - 1, minimumLeafSize, lambda);
+  Grow(left + 1, bins, thresholds, points, begin + leftCount,
+      count - leftCount, dimensions, gradients, hessians, maximumDepth - 1,
+      minimumLeafSize, lambda);
+}
+
+} // namespace tree
+} // namespace mlpack
@@ -0,0 +1,144 @@
+/**
+ * @file methods/gradient_boosting/gradient_boosting_tree.hpp
+ *
+ * Definition of the GradientBoostingTree class, the regression tree that is
+ * fit to the gradients of the loss in each iteration of gradient boosting.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_GRADIENT_BOOSTING_GRADIENT_BOOSTING_TREE_HPP
+#define MLPACK_METHODS_GRADIENT_BOOSTING_GRADIENT_BOOSTING_TREE_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * A GradientBoostingTree is a regression tree that is trained on the first
+ * and second derivatives of a loss with respect to the current scores of the
+ * points, as in XGBoost and LightGBM.  The points are given as bins: each
+ * dimension has a sorted list of thresholds, and the bin of a value is the
+ * index of the first threshold that is at least the value.  Each node is split
+ * on the threshold that gives the largest gain
+ *
+ * \f[
+ * \frac{G_L^2}{H_L + \lambda} + \frac{G_R^2}{H_R + \lambda} -
+ * \frac{G^2}{H + \lambda},
+ * \f]
+ *
+ * where G and H are the sums of the derivatives in a node, found from the
+ * histogram of the derivatives over the bins of each dimension.  The value of
+ * a leaf is -G / (H + lambda).
+ *
+ * Once trained, the tree can predict both binned points and raw points, since
+ * the threshold of each split is kept.
+ */
+class GradientBoostingTree
+{
+ public:
+  //! Create an empty tree, which predicts 0 for all points.
+  GradientBoostingTree();
+
+  /**
+   * Train the tree on the given points.
+   *
+   * @param bins Bins of all points, one column per point.
+   * @param thresholds The thresholds of the bins of each dimension.
+   * @param points Indices of the points to train on.
+   * @param dimensions Dimensions that may be split on.
+   * @param gradients First derivative of the loss for each point.
+   * @param hessians Second derivative of the loss for each point.
+   * @param maximumDepth Maximum depth of the tree (0 means no limit).
+   * @param minimumLeafSize Minimum number of points in a leaf.
+   * @param lambda L2 regularization of the values of the leaves.
+   */
+  void Train(const arma::Mat<unsigned char>& bins,
+             const std::vector<arma::vec>& thresholds,
+             const arma::uvec& points,
+             const arma::uvec& dimensions,
+             const arma::vec& gradients,
+             const arma::vec& hessians,
+             const size_t maximumDepth,
+             const size_t minimumLeafSize,
+             const double lambda);
+
+  /**
+   * Predict the value of the given raw point.
+   *
+   * @param point Point to predict.
+   */
+  template<typename VecType>
+  double Predict(const VecType& point) const;
+
+  /**
+   * Predict the value of the given binned point.
+   *
+   * @param bins Bins of the point.
+   */
+  double PredictBins(const unsigned char* bins) const;
+
+  //! Get the number of nodes of the tree.
+  size_t NumNodes() const { return nodes.size(); }
+
+  //! Serialize the tree.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  //! A node of the tree.
+  struct Node
+  {
+    //! The dimension the node splits on.
+    size_t dimension;
+    //! The bin of the split; points with a bin up to this one go left.
+    size_t bin;
+    //! The threshold of the split, or the value of a leaf.
+    double value;
+    //! The index of the left child (the right child follows it), or 0 for a
+    //! leaf.
+    size_t left;
+
+    //! Serialize the node.
+    template<typename Archive>
+    void serialize(Archive& ar, const unsigned int /* version */)
+    {
+      ar & BOOST_SERIALIZATION_NVP(dimension);
+      ar & BOOST_SERIALIZATION_NVP(bin);
+      ar & BOOST_SERIALIZATION_NVP(value);
+      ar & BOOST_SERIALIZATION_NVP(left);
+    }
+  };
+
+  /**
+   * Train the node at the given index on the points in
+   * points[begin, begin + count).  The points are reordered so that those of
+   * each child are next to each other.
+   */
+  void Grow(const size_t index,
+            const arma::Mat<unsigned char>& bins,
+            const std::vector<arma::vec>& thresholds,
+            std::vector<arma::uword>& points,
+            const size_t begin,
+            const size_t count,
+            const arma::uvec& dimensions,
+            const arma::vec& gradients,
+            const arma::vec& hessians,
+            const size_t maximumDepth,
+            const size_t minimumLeafSize,
+            const double lambda);
+
+  //! The nodes of the tree; the root is the first node.
+  std::vector<Node> nodes;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation of templated functions.
+#include "gradient_boosting_tree_impl.hpp"
+
+#endif
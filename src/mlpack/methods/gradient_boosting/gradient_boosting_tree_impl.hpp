@@ -0,0 +1,46 @@
+/**
+ * @file methods/gradient_boosting/gradient_boosting_tree_impl.hpp
+ *
+ * Implementation of the templated functions of the GradientBoostingTree class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_GRADIENT_BOOSTING_GRADIENT_BOOSTING_TREE_IMPL_HPP
+#define MLPACK_METHODS_GRADIENT_BOOSTING_GRADIENT_BOOSTING_TREE_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "gradient_boosting_tree.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template<typename VecType>
+double GradientBoostingTree::Predict(const VecType& point) const
+{
+  if (nodes.empty())
+    return 0.0;
+
+  size_t i = 0;
+  while (nodes[i].left != 0)
+  {
+    const Node& node = nodes[i];
+    i = node.left + ((point[node.dimension] <= node.value) ? 0 : 1);
+  }
+
+  return nodes[i].value;
+}
+
+template<typename Archive>
+void GradientBoostingTree::serialize(Archive& ar,
+                                     const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(nodes);
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -282,6 +282,22 @@ class HMM
   double Predict(const arma::mat& dataSeq,
                  arma::Row<size_t>& stateSeq) const;
 
+  /**
+   * Compute the most probable hidden state sequence of each of the given data
+   * sequences, using the Viterbi algorithm.  The sequences are decoded in
+   * parallel, and each thread reuses its trellis buffers for all of its
+   * sequences.
+   *
+   * @param dataSeq Sequences of observations.
+   * @param stateSeq Vector in which the most probable state sequence of each
+   *    data sequence will be stored.
+   * @param logLikelihoods Vector in which the log-likelihood of each most
+   *    probable state sequence will be stored.
+   */
+  void Predict(const std::vector<arma::mat>& dataSeq,
+               std::vector<arma::Row<size_t>>& stateSeq,
+               arma::vec& logLikelihoods) const;
+
   /**
    * Compute the log-likelihood of the given data sequence.
    *
@@ -419,6 +435,52 @@ class HMM
    */
   void ConvertToLogSpace() const;
 
+  /**
+   * Compute the log-probability of each observation of the given sequence
+   * under the emission distribution of each state; logEmission must have one
+   * row per state and at least one column per observation.
+   */
+  void LogEmissions(const arma::mat& dataSeq, arma::mat& logEmission) const;
+
+  /**
+   * Run the Forward algorithm on a sequence, given the log-probabilities of
+   * its emissions (one column per observation).
+   */
+  void ScaledForward(const arma::mat& logEmission,
+                     arma::vec& logScales,
+                     arma::mat& forwardLogProb) const;
+
+  /**
+   * Run the Backward algorithm on a sequence, given the log-probabilities of
+   * its emissions (one column per observation) and the scaling factors found
+   * by ScaledForward().
+   */
+  void ScaledBackward(const arma::mat& logEmission,
+                      const arma::vec& logScales,
+                      arma::mat& backwardLogProb) const;
+
+  /**
+   * Run the Viterbi algorithm on the given sequence, with the given buffers;
+   * each buffer must have one row per state and at least one column per
+   * observation.  The columns of logTransitionT are the rows of the log
+   * transition matrix.
+   */
+  double Viterbi(const arma::mat& dataSeq,
+                 const arma::mat& logTransitionT,
+                 arma::Row<size_t>& stateSeq,
+                 arma::mat& logEmission,
+                 arma::mat& logStateProb,
+                 arma::Mat<size_t>& stateSeqBack) const;
+
+  //! Return the largest a[i] + b[i] of the n elements, and store its index.
+  static double MaxPlus(const double* a,
+                        const double* b,
+                        const size_t n,
+                        size_t& index);
+
+  //! Return log(sum_i exp(a[i] + b[i])) over the n elements.
+  static double LogSumExp(const double* a, const double* b, const size_t n);
+
   /**
    * A proxy vriable in linear space for logInitial.
    * Should be removed in mlpack 4.0.
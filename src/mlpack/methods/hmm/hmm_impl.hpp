@@ -101,10 +101,14 @@ double HMM<Distribution>::Train(const std::vector<arma::mat>& dataSeq)
   // Maximum iterations?
   size_t iterations = 1000;
 
-  // Find length of all sequences and ensure they are the correct size.
+  // Find length of all sequences and ensure they are the correct size.  The
+  // offset of each sequence in the list of emissions is kept, so that the
+  // sequences can be processed in parallel.
   size_t totalLength = 0;
+  std::vector<size_t> offsets(dataSeq.size());
   for (size_t seq = 0; seq < dataSeq.size(); seq++)
   {
+    offsets[seq] = totalLength;
     totalLength += dataSeq[seq].n_cols;
 
     if (dataSeq[seq].n_rows != dimensionality)
@@ -119,6 +123,10 @@ double HMM<Distribution>::Train(const std::vector<arma::mat>& dataSeq)
       arma::vec(totalLength));
   arma::mat emissionList(dimensionality, totalLength);
 
+  // Every thread uses the log-space parameters, so they must be up to date
+  // before the sequences are processed.
+  ConvertToLogSpace();
+
   // This should be the Baum-Welch algorithm (EM for HMM estimation). This
   // follows the procedure outlined in Elliot, Aggoun, and Moore's book "Hidden
   // Markov Models: Estimation and Control", pp. 36-40.
@@ -133,53 +141,88 @@ double HMM<Distribution>::Train(const std::vector<arma::mat>& dataSeq)
     // Reset log likelihood.
     loglik = 0;
 
-    // Sum over time.
-    size_t sumTime = 0;
-
-    // Loop over each sequence.
-    for (size_t seq = 0; seq < dataSeq.size(); seq++)
+    // The sequences are independent, so the E-step is run on each of them in
+    // parallel.  Each thread keeps its own sums of the initial and transition
+    // probabilities, and the sums are added at the end.
+    #pragma omp parallel
     {
-      arma::mat stateLogProb;
-      arma::mat forwardLog;
-      arma::mat backwardLog;
-      arma::vec logScales;
-
-      // Add the log-likelihood of this sequence.  This is the E-step.
-      loglik += LogEstimate(dataSeq[seq], stateLogProb, forwardLog,
-          backwardLog, logScales);
-
-      // Add to estimate of initial probability for state j.
-      for (size_t j = 0; j < logTransition.n_cols; ++j)
-        newLogInitial[j] = math::LogAdd(newLogInitial[j], stateLogProb(j, 0));
-
-      // Now re-estimate the parameters.  This is the M-step.
-      //   pi_i = sum_d ((1 / P(seq[d])) sum_t (f(i, 0) b(i, 0))
-      //   T_ij = sum_d ((1 / P(seq[d])) sum_t (f(i, t) T_ij E_i(seq[d][t]) b(i,
-      //           t + 1)))
-      //   E_ij = sum_d ((1 / P(seq[d])) sum_{t | seq[d][t] = j} f(i, t) b(i, t)
-      // We store the new estimates in a different matrix.
-      for (size_t t = 0; t < dataSeq[seq].n_cols; ++t)
+      arma::vec threadLogInitial(logTransition.n_rows);
+      threadLogInitial.fill(-std::numeric_limits<double>::infinity());
+      arma::mat threadLogTransition(logTransition.n_rows,
+          logTransition.n_cols);
+      threadLogTransition.fill(-std::numeric_limits<double>::infinity());
+
+      #pragma omp for schedule(dynamic) reduction(+:loglik)
+      for (omp_size_t seq = 0; seq < (omp_size_t) dataSeq.size(); seq++)
       {
+        const arma::mat& data = dataSeq[seq];
+        arma::mat logEmission(logTransition.n_rows, data.n_cols);
+        arma::mat forwardLog;
+        arma::mat backwardLog;
+        arma::vec logScales;
+
+        // The emission log-probabilities are needed by the forward, backward
+        // and transition computations, so they are only computed once.
+        LogEmissions(data, logEmission);
+
+        // Add the log-likelihood of this sequence.  This is the E-step.
+        ScaledForward(logEmission, logScales, forwardLog);
+        ScaledBackward(logEmission, logScales, backwardLog);
+        const arma::mat stateLogProb = forwardLog + backwardLog;
+        loglik += arma::accu(logScales);
+
+        // Add to estimate of initial probability for state j.
         for (size_t j = 0; j < logTransition.n_cols; ++j)
         {
-          if (t < dataSeq[seq].n_cols - 1)
+          threadLogInitial[j] = math::LogAdd(threadLogInitial[j],
+              stateLogProb(j, 0));
+        }
+
+        // Now re-estimate the parameters.  This is the M-step.
+        //   pi_i = sum_d ((1 / P(seq[d])) sum_t (f(i, 0) b(i, 0))
+        //   T_ij = sum_d ((1 / P(seq[d])) sum_t (f(i, t) T_ij E_i(seq[d][t])
+        //           b(i, t + 1)))
+        //   E_ij = sum_d ((1 / P(seq[d])) sum_{t | seq[d][t] = j} f(i, t)
+        //           b(i, t)
+        // We store the new estimates in a different matrix.
+        for (size_t t = 0; t < data.n_cols; ++t)
+        {
+          const size_t sumTime = offsets[seq] + t;
+          for (size_t j = 0; j < logTransition.n_cols; ++j)
           {
-            // Estimate of T_ij (probability of transition from state j to state
-            // i).  We postpone multiplication of the old T_ij until later.
-            for (size_t i = 0; i < logTransition.n_rows; i++)
+            if (t < data.n_cols - 1)
             {
-              newLogTransition(i, j) = math::LogAdd(newLogTransition(i, j),
-                  forwardLog(j, t) + backwardLog(i, t + 1) +
-                  emission[i].LogProbability(dataSeq[seq].unsafe_col(t + 1)) -
-                  logScales[t + 1]);
+              // Estimate of T_ij (probability of transition from state j to
+              // state i).  We postpone multiplication of the old T_ij until
+              // later.
+              for (size_t i = 0; i < logTransition.n_rows; i++)
+              {
+                threadLogTransition(i, j) = math::LogAdd(
+                    threadLogTransition(i, j), forwardLog(j, t) +
+                    backwardLog(i, t + 1) + logEmission(i, t + 1) -
+                    logScales[t + 1]);
+              }
             }
+
+            // Add to list of emission observations, for Distribution::Train().
+            emissionList.col(sumTime) = data.col(t);
+            emissionProb[j][sumTime] = exp(stateLogProb(j, t));
           }
+        }
+      }
 
-          // Add to list of emission observations, for Distribution::Train().
-          emissionList.col(sumTime) = dataSeq[seq].col(t);
-          emissionProb[j][sumTime] = exp(stateLogProb(j, t));
+      #pragma omp critical
+      {
+        for (size_t j = 0; j < newLogInitial.n_elem; ++j)
+        {
+          newLogInitial[j] = math::LogAdd(newLogInitial[j],
+              threadLogInitial[j]);
+        }
+        for (size_t k = 0; k < newLogTransition.n_elem; ++k)
+        {
+          newLogTransition[k] = math::LogAdd(newLogTransition[k],
+              threadLogTransition[k]);
         }
-        sumTime++;
       }
     }
 
@@ -458,53 +501,113 @@ template<typename Distribution>
 double HMM<Distribution>::Predict(const arma::mat& dataSeq,
                                   arma::Row<size_t>& stateSeq) const
 {
-  // This is an implementation of the Viterbi algorithm for finding the most
-  // probable sequence of states to produce the observed data sequence.  We
-  // don't use log-likelihoods to save that little bit of time, but we'll
-  // calculate the log-likelihood at the end of it all.
-  stateSeq.set_size(dataSeq.n_cols);
+  ConvertToLogSpace();
+
+  arma::mat logEmission(logTransition.n_rows, dataSeq.n_cols);
   arma::mat logStateProb(logTransition.n_rows, dataSeq.n_cols);
-  arma::mat stateSeqBack(logTransition.n_rows, dataSeq.n_cols);
+  arma::Mat<size_t> stateSeqBack(logTransition.n_rows, dataSeq.n_cols);
+  const arma::mat logTransitionT = logTransition.t();
+  return Viterbi(dataSeq, logTransitionT, stateSeq, logEmission, logStateProb,
+      stateSeqBack);
+}
 
+/**
+ * Compute the most probable hidden state sequence of each of the given
+ * observation sequences using the Viterbi algorithm.
+ */
+template<typename Distribution>
+void HMM<Distribution>::Predict(const std::vector<arma::mat>& dataSeq,
+                                std::vector<arma::Row<size_t>>& stateSeq,
+                                arma::vec& logLikelihoods) const
+{
+  // Every thread uses the log-space parameters, so they must be up to date
+  // before the sequences are decoded.
   ConvertToLogSpace();
+  const arma::mat logTransitionT = logTransition.t();
+
+  size_t maxLength = 0;
+  for (size_t i = 0; i < dataSeq.size(); ++i)
+    maxLength = std::max(maxLength, (size_t) dataSeq[i].n_cols);
+
+  stateSeq.resize(dataSeq.size());
+  logLikelihoods.set_size(dataSeq.size());
+
+  #pragma omp parallel
+  {
+    // The trellis buffers are large enough for the longest sequence, so they
+    // are allocated only once per thread.
+    arma::mat logEmission(logTransition.n_rows, maxLength);
+    arma::mat logStateProb(logTransition.n_rows, maxLength);
+    arma::Mat<size_t> stateSeqBack(logTransition.n_rows, maxLength);
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t i = 0; i < (omp_size_t) dataSeq.size(); ++i)
+    {
+      logLikelihoods[i] = Viterbi(dataSeq[i], logTransitionT, stateSeq[i],
+          logEmission, logStateProb, stateSeqBack);
+    }
+  }
+}
+
+/**
+ * The Viterbi algorithm, on preallocated buffers.
+ */
+template<typename Distribution>
+double HMM<Distribution>::Viterbi(const arma::mat& dataSeq,
+                                  const arma::mat& logTransitionT,
+                                  arma::Row<size_t>& stateSeq,
+                                  arma::mat& logEmission,
+                                  arma::mat& logStateProb,
+                                  arma::Mat<size_t>& stateSeqBack) const
+{
+  // This is an implementation of the Viterbi algorithm for finding the most
+  // probable sequence of states to produce the observed data sequence.
+  stateSeq.set_size(dataSeq.n_cols);
+  if (dataSeq.n_cols == 0)
+    return 0.0;
+
+  const size_t states = logTransition.n_rows;
+  LogEmissions(dataSeq, logEmission);
 
   // The calculation of the first state is slightly different; the probability
   // of the first state being state j is the maximum probability that the state
   // came to be j from another state.
-  logStateProb.col(0).zeros();
-  for (size_t state = 0; state < logTransition.n_rows; state++)
+  for (size_t state = 0; state < states; state++)
   {
-    logStateProb(state, 0) = logInitial[state] +
-        emission[state].LogProbability(dataSeq.unsafe_col(0));
+    logStateProb(state, 0) = logInitial[state] + logEmission(state, 0);
     stateSeqBack(state, 0) = state;
   }
 
-  // Store the best first state.
-  arma::uword index;
   for (size_t t = 1; t < dataSeq.n_cols; t++)
   {
-    // Assemble the state probability for this element.
-    // Given that we are in state j, we use state with the highest probability
-    // of being the previous state.
-    for (size_t j = 0; j < logTransition.n_rows; j++)
+    // Assemble the state probability for this element.  Given that we are in
+    // state j, we use state with the highest probability of being the
+    // previous state.  Row j of the transition matrix is column j of its
+    // transpose, so both operands are contiguous.
+    const double* previous = logStateProb.colptr(t - 1);
+    for (size_t j = 0; j < states; j++)
     {
-      arma::vec prob = logStateProb.col(t - 1) + logTransition.row(j).t();
-      logStateProb(j, t) = prob.max(index) +
-          emission[j].LogProbability(dataSeq.unsafe_col(t));
+      size_t index;
+      logStateProb(j, t) = MaxPlus(previous, logTransitionT.colptr(j), states,
+          index) + logEmission(j, t);
       stateSeqBack(j, t) = index;
     }
   }
 
   // Backtrack to find the most probable state sequence.
-  logStateProb.unsafe_col(dataSeq.n_cols - 1).max(index);
-  stateSeq[dataSeq.n_cols - 1] = index;
+  const size_t last = dataSeq.n_cols - 1;
+  size_t index = 0;
+  for (size_t state = 1; state < states; state++)
+    if (logStateProb(state, last) > logStateProb(index, last))
+      index = state;
+  stateSeq[last] = index;
   for (size_t t = 2; t <= dataSeq.n_cols; t++)
   {
     stateSeq[dataSeq.n_cols - t] =
         stateSeqBack(stateSeq[dataSeq.n_cols - t + 1], dataSeq.n_cols - t + 1);
   }
 
-  return logStateProb(stateSeq(dataSeq.n_cols - 1), dataSeq.n_cols - 1);
+  return logStateProb(index, last);
 }
 
 /**
@@ -577,26 +680,61 @@ template<typename Distribution>
 void HMM<Distribution>::Forward(const arma::mat& dataSeq,
                                 arma::vec& logScales,
                                 arma::mat& forwardLogProb) const
+{
+  ConvertToLogSpace();
+
+  arma::mat logEmission(logTransition.n_rows, dataSeq.n_cols);
+  LogEmissions(dataSeq, logEmission);
+  ScaledForward(logEmission, logScales, forwardLogProb);
+}
+
+template<typename Distribution>
+void HMM<Distribution>::Backward(const arma::mat& dataSeq,
+                                 const arma::vec& logScales,
+                                 arma::mat& backwardLogProb) const
+{
+  ConvertToLogSpace();
+
+  arma::mat logEmission(logTransition.n_rows, dataSeq.n_cols);
+  LogEmissions(dataSeq, logEmission);
+  ScaledBackward(logEmission, logScales, backwardLogProb);
+}
+
+template<typename Distribution>
+void HMM<Distribution>::LogEmissions(const arma::mat& dataSeq,
+                                     arma::mat& logEmission) const
+{
+  for (size_t t = 0; t < dataSeq.n_cols; t++)
+    for (size_t state = 0; state < logTransition.n_rows; state++)
+      logEmission(state, t) = emission[state].LogProbability(
+          dataSeq.unsafe_col(t));
+}
+
+template<typename Distribution>
+void HMM<Distribution>::ScaledForward(const arma::mat& logEmission,
+                                      arma::vec& logScales,
+                                      arma::mat& forwardLogProb) const
 {
   // Our goal is to calculate the forward probabilities:
   //  P(X_k | o_{1:k}) for all possible states X_k, for each time point k.
-  forwardLogProb.resize(logTransition.n_rows, dataSeq.n_cols);
-  forwardLogProb.fill(-std::numeric_limits<double>::infinity());
-  logScales.resize(dataSeq.n_cols);
-  logScales.fill(-std::numeric_limits<double>::infinity());
+  const size_t states = logTransition.n_rows;
+  const size_t length = logEmission.n_cols;
+  forwardLogProb.set_size(states, length);
+  logScales.set_size(length);
+  if (length == 0)
+    return;
 
-  ConvertToLogSpace();
+  // Row j of the transition matrix is column j of its transpose, so that the
+  // sums below are over contiguous memory.
+  const arma::mat logTransitionT = logTransition.t();
 
   // The first entry in the forward algorithm uses the initial state
   // probabilities.  Note that MATLAB assumes that the starting state (at
   // t = -1) is state 0; this is not our assumption here.  To force that
   // behavior, you could append a single starting state to every single data
   // sequence and that should produce results in line with MATLAB.
-  for (size_t state = 0; state < logTransition.n_rows; state++)
-  {
-    forwardLogProb(state, 0) = logInitial(state) +
-        emission[state].LogProbability(dataSeq.unsafe_col(0));
-  }
+  for (size_t state = 0; state < states; state++)
+    forwardLogProb(state, 0) = logInitial(state) + logEmission(state, 0);
 
   // Then normalize the column.
   logScales[0] = math::AccuLog(forwardLogProb.col(0));
@@ -604,16 +742,16 @@ void HMM<Distribution>::Forward(const arma::mat& dataSeq,
     forwardLogProb.col(0) -= logScales[0];
 
   // Now compute the probabilities for each successive observation.
-  for (size_t t = 1; t < dataSeq.n_cols; t++)
+  for (size_t t = 1; t < length; t++)
   {
-    for (size_t j = 0; j < logTransition.n_rows; j++)
+    // The forward probability of state j at time t is the sum over all states
+    // of the probability of the previous state transitioning to the current
+    // state and emitting the given observation.
+    const double* previous = forwardLogProb.colptr(t - 1);
+    for (size_t j = 0; j < states; j++)
     {
-      // The forward probability of state j at time t is the sum over all states
-      // of the probability of the previous state transitioning to the current
-      // state and emitting the given observation.
-      arma::vec tmp = forwardLogProb.col(t - 1) + logTransition.row(j).t();
-      forwardLogProb(j, t) = math::AccuLog(tmp) +
-          emission[j].LogProbability(dataSeq.unsafe_col(t));
+      forwardLogProb(j, t) = LogSumExp(previous, logTransitionT.colptr(j),
+          states) + logEmission(j, t);
     }
 
     // Normalize probability.
@@ -624,33 +762,37 @@ void HMM<Distribution>::Forward(const arma::mat& dataSeq,
 }
 
 template<typename Distribution>
-void HMM<Distribution>::Backward(const arma::mat& dataSeq,
-                                 const arma::vec& logScales,
-                                 arma::mat& backwardLogProb) const
+void HMM<Distribution>::ScaledBackward(const arma::mat& logEmission,
+                                       const arma::vec& logScales,
+                                       arma::mat& backwardLogProb) const
 {
   // Our goal is to calculate the backward probabilities:
   //  P(X_k | o_{k + 1:T}) for all possible states X_k, for each time point k.
-  backwardLogProb.resize(logTransition.n_rows, dataSeq.n_cols);
-  backwardLogProb.fill(-std::numeric_limits<double>::infinity());
+  const size_t states = logTransition.n_rows;
+  const size_t length = logEmission.n_cols;
+  backwardLogProb.set_size(states, length);
+  if (length == 0)
+    return;
 
   // The last element probability is 1.
-  backwardLogProb.col(dataSeq.n_cols - 1).fill(0);
+  backwardLogProb.col(length - 1).fill(0);
 
   // Now step backwards through all other observations.
-  for (size_t t = dataSeq.n_cols - 2; t + 1 > 0; t--)
+  arma::vec next(states);
+  for (size_t t = length - 2; t + 1 > 0; t--)
   {
-    for (size_t j = 0; j < logTransition.n_rows; j++)
+    // The probability of each next state emitting the next observation, given
+    // the rest of the sequence, does not depend on the current state.
+    next = backwardLogProb.col(t + 1) + logEmission.col(t + 1);
+
+    for (size_t j = 0; j < states; j++)
     {
       // The backward probability of state j at time t is the sum over all state
       // of the probability of the next state having been a transition from the
       // current state multiplied by the probability of each of those states
       // emitting the given observation.
-      for (size_t state = 0; state < logTransition.n_rows; state++)
-      {
-        backwardLogProb(j, t) = math::LogAdd(backwardLogProb(j, t),
-            logTransition(state, j) + backwardLogProb(state, t + 1)
-            + emission[state].LogProbability(dataSeq.unsafe_col(t + 1)));
-      }
+      backwardLogProb(j, t) = LogSumExp(logTransition.colptr(j),
+          next.memptr(), states);
 
       // Normalize by the weights from the forward algorithm.
       if (std::isfinite(logScales[t + 1]))
@@ -659,6 +801,50 @@ void HMM<Distribution>::Backward(const arma::mat& dataSeq,
   }
 }
 
+template<typename Distribution>
+double HMM<Distribution>::MaxPlus(const double* a,
+                                  const double* b,
+                                  const size_t n,
+                                  size_t& index)
+{
+  // The first largest element is taken, as arma::max() does.
+  double best = a[0] + b[0];
+  index = 0;
+  for (size_t i = 1; i < n; ++i)
+  {
+    const double value = a[i] + b[i];
+    if (value > best)
+    {
+      best = value;
+      index = i;
+    }
+  }
+
+  return best;
+}
+
+template<typename Distribution>
+double HMM<Distribution>::LogSumExp(const double* a,
+                                    const double* b,
+                                    const size_t n)
+{
+  // Subtract the largest term so that the exponentials do not overflow.  Both
+  // loops have no dependencies between iterations, so they can be
+  // vectorized.
+  double maxValue = -std::numeric_limits<double>::infinity();
+  for (size_t i = 0; i < n; ++i)
+    maxValue = std::max(maxValue, a[i] + b[i]);
+
+  if (maxValue == -std::numeric_limits<double>::infinity())
+    return maxValue;
+
+  double sum = 0.0;
+  for (size_t i = 0; i < n; ++i)
+    sum += std::exp(a[i] + b[i] - maxValue);
+
+  return maxValue + std::log(sum);
+}
+
 /**
  * Make sure the variables in log space are in sync with the linear counter parts
  */
@@ -0,0 +1,245 @@
+/**
+ * @file methods/hnsw/hnsw_main.cpp
+ *
+ * This file computes the approximate nearest-neighbors using a hierarchical
+ * navigable small world graph.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/cli.hpp>
+#include <mlpack/core/util/mlpack_main.hpp>
+
+#include "hnsw_search.hpp"
+
+using namespace std;
+using namespace mlpack;
+using namespace mlpack::neighbor;
+using namespace mlpack::util;
+
+// Information about the program itself.
+PROGRAM_INFO("K-Approximate-Nearest-Neighbor Search with HNSW",
+    // Short description.
+    "An implementation of approximate k-nearest-neighbor search with "
+    "hierarchical navigable small world (HNSW) graphs.  Given a set of "
+    "reference points and a set of query points, this will compute the k "
+    "approximate nearest neighbors of each query point in the reference set; "
+    "models can be saved for future use.",
+    // Long description.
+    "This program will calculate the k approximate-nearest-neighbors of a set "
+    "of points by walking a hierarchical navigable small world graph built on "
+    "the reference points. You may specify a separate set of reference points "
+    "and query points, or just a reference set which will be used as both the "
+    "reference and query set."
+    "\n\n"
+    "For example, the following will return 5 neighbors from the data for each "
+    "point in " + PRINT_DATASET("input") + " and store the distances in " +
+    PRINT_DATASET("distances") + " and the neighbors in " +
+    PRINT_DATASET("neighbors") + ":"
+    "\n\n" +
+    PRINT_CALL("hnsw", "k", 5, "reference", "input", "distances", "distances",
+        "neighbors", "neighbors") +
+    "\n\n"
+    "The output is organized such that row i and column j in the neighbors "
+    "output corresponds to the index of the point in the reference set which "
+    "is the j'th nearest neighbor from the point in the query set with index "
+    "i.  Row j and column i in the distances output file corresponds to the "
+    "distance between those two points."
+    "\n\n"
+    "Each node of the graph is linked to at most " +
+    PRINT_PARAM_STRING("max_connections") + " other nodes (twice as many at "
+    "the bottom level).  The " + PRINT_PARAM_STRING("ef_construction") +
+    " parameter controls the quality of the graph, and the " +
+    PRINT_PARAM_STRING("ef") + " parameter the number of candidates kept by "
+    "each search; larger values give a better recall for a longer build or "
+    "search.  For example, the following searches a saved model " +
+    PRINT_MODEL("model") + " for the 10 neighbors of each point in " +
+    PRINT_DATASET("queries") + " keeping 100 candidates, and prints the recall "
+    "against the true neighbors " + PRINT_DATASET("true_neighbors") + ":"
+    "\n\n" +
+    PRINT_CALL("hnsw", "input_model", "model", "query", "queries", "k", 10,
+        "ef", 100, "true_neighbors", "true_neighbors", "neighbors",
+        "neighbors", "verbose", true) +
+    "\n\n"
+    "Because the nodes are placed in the levels of the graph at random, "
+    "results may be different from run to run.  Thus, the " +
+    PRINT_PARAM_STRING("seed") + " parameter can be specified to set the "
+    "random seed (when the graph is built with several threads, the order of "
+    "the insertions can still change the graph).",
+    SEE_ALSO("@knn", "#knn"),
+    SEE_ALSO("@lsh", "#lsh"),
+    SEE_ALSO("Efficient and robust approximate nearest neighbor search using "
+        "Hierarchical Navigable Small World graphs (pdf)",
+        "https://arxiv.org/pdf/1603.09320.pdf"),
+    SEE_ALSO("mlpack::neighbor::HNSWSearch C++ class documentation",
+        "@doxygen/classmlpack_1_1neighbor_1_1HNSWSearch.html"));
+
+// Define our input parameters that this program will take.
+PARAM_MATRIX_IN("reference", "Matrix containing the reference dataset.", "r");
+PARAM_MATRIX_OUT("distances", "Matrix to output distances into.", "d");
+PARAM_UMATRIX_OUT("neighbors", "Matrix to output neighbors into.", "n");
+
+// We can load or save models.
+PARAM_MODEL_IN(HNSWSearch<>, "input_model", "Input HNSW model.", "m");
+PARAM_MODEL_OUT(HNSWSearch<>, "output_model", "Output for trained HNSW model.",
+    "M");
+
+// For testing recall.
+PARAM_UMATRIX_IN("true_neighbors", "Matrix of true neighbors to compute "
+    "recall with (the recall is printed when -v is specified).", "t");
+
+PARAM_INT_IN("k", "Number of nearest neighbors to find.", "k", 0);
+PARAM_MATRIX_IN("query", "Matrix containing query points (optional).", "q");
+
+PARAM_INT_IN("max_connections", "The number of links of each node of the "
+    "graph at each level above the bottom one (twice as many at the bottom "
+    "level).", "c", 16);
+PARAM_INT_IN("ef_construction", "The number of candidate neighbors kept when "
+    "a point is inserted in the graph.", "e", 200);
+PARAM_INT_IN("ef", "The number of candidate neighbors kept by each search (at "
+    "least k are kept); if 0, the value of " +
+    PRINT_PARAM_STRING("ef_construction") + " of the model is used.", "E", 0);
+PARAM_INT_IN("seed", "Random seed.  If 0, 'std::time(NULL)' is used.", "s", 0);
+
+static void mlpackMain()
+{
+  if (CLI::GetParam<int>("seed") != 0)
+    math::RandomSeed((size_t) CLI::GetParam<int>("seed"));
+  else
+    math::RandomSeed((size_t) time(NULL));
+
+  // Get all the parameters after checking them.
+  if (CLI::HasParam("k"))
+  {
+    RequireParamValue<int>("k", [](int x) { return x > 0; }, true,
+        "k must be greater than 0");
+  }
+  RequireParamValue<int>("max_connections", [](int x) { return x >= 2; },
+      true, "number of connections must be at least 2");
+  RequireParamValue<int>("ef_construction", [](int x) { return x > 0; }, true,
+      "ef_construction must be greater than 0");
+  RequireParamValue<int>("ef", [](int x) { return x >= 0; }, true,
+      "ef must be nonnegative");
+
+  const size_t k = CLI::GetParam<int>("k");
+
+  RequireOnlyOnePassed({ "input_model", "reference" }, true);
+  RequireAtLeastOnePassed({ "neighbors", "distances", "output_model" }, false,
+      "no results will be saved");
+  if (CLI::HasParam("k"))
+  {
+    RequireAtLeastOnePassed({ "query", "reference", "input_model" }, true,
+        "must pass set to search");
+  }
+
+  if (CLI::HasParam("input_model") && CLI::HasParam("k") &&
+      !CLI::HasParam("query"))
+  {
+    Log::Info << "Performing HNSW-based approximate nearest neighbor search on "
+        << "the reference dataset in the model stored in '"
+        << CLI::GetPrintableParam<HNSWSearch<>>("input_model") << "'." << endl;
+  }
+
+  ReportIgnoredParam({{ "k", false }}, "neighbors");
+  ReportIgnoredParam({{ "k", false }}, "distances");
+  ReportIgnoredParam({{ "k", false }}, "ef");
+
+  ReportIgnoredParam({{ "reference", false }}, "max_connections");
+  ReportIgnoredParam({{ "reference", false }}, "ef_construction");
+
+  if (CLI::HasParam("input_model") && !CLI::HasParam("k"))
+  {
+    Log::Warn << PRINT_PARAM_STRING("k") << " not passed; no search will be "
+        << "performed!" << std::endl;
+  }
+
+  // Pick up the HNSW-specific parameters.
+  const size_t maxConnections = CLI::GetParam<int>("max_connections");
+  const size_t efConstruction = CLI::GetParam<int>("ef_construction");
+  const size_t ef = CLI::GetParam<int>("ef");
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+
+  HNSWSearch<>* allkann;
+  if (CLI::HasParam("reference"))
+  {
+    Log::Info << "Using HNSW with " << maxConnections << " connections per "
+        << "node and ef_construction " << efConstruction << "." << endl;
+    Log::Info << "Using reference data from "
+        << CLI::GetPrintableParam<arma::mat>("reference") << "." << endl;
+    allkann = new HNSWSearch<>();
+
+    Timer::Start("graph_building");
+    allkann->Train(std::move(CLI::GetParam<arma::mat>("reference")),
+        maxConnections, efConstruction);
+    Timer::Stop("graph_building");
+
+    Log::Info << "Built a graph with " << allkann->MaxLevel() + 1
+        << " levels." << endl;
+  }
+  else // We must have an input model.
+  {
+    allkann = CLI::GetParam<HNSWSearch<>*>("input_model");
+  }
+
+  if (CLI::HasParam("k"))
+  {
+    Log::Info << "Computing " << k << " distance approximate nearest neighbors."
+        << endl;
+    if (CLI::HasParam("query"))
+    {
+      Log::Info << "Loaded query data from "
+          << CLI::GetPrintableParam<arma::mat>("query") << "." << endl;
+      const arma::mat queryData =
+          std::move(CLI::GetParam<arma::mat>("query"));
+
+      allkann->Search(queryData, k, neighbors, distances, ef);
+    }
+    else
+    {
+      allkann->Search(k, neighbors, distances, ef);
+    }
+
+    Log::Info << "Neighbors computed." << endl;
+  }
+
+  // Compute recall, if desired.
+  if (CLI::HasParam("true_neighbors"))
+  {
+    Log::Info << "Using true neighbor indices from '"
+        << CLI::GetPrintableParam<arma::Mat<size_t>>("true_neighbors") << "'."
+        << endl;
+
+    // Load the true neighbors.
+    arma::Mat<size_t> trueNeighbors =
+        std::move(CLI::GetParam<arma::Mat<size_t>>("true_neighbors"));
+
+    if (trueNeighbors.n_rows != neighbors.n_rows ||
+        trueNeighbors.n_cols != neighbors.n_cols)
+    {
+      // Delete the model if needed.
+      if (CLI::HasParam("reference"))
+        delete allkann;
+      Log::Fatal << "The true neighbors file must have the same number of "
+          << "values as the set of neighbors being queried!" << endl;
+    }
+
+    // Compute recall and print it.
+    double recallPercentage = 100 * allkann->ComputeRecall(neighbors,
+        trueNeighbors);
+
+    Log::Info << "Recall: " << recallPercentage << endl;
+  }
+
+  // Save output, if we did a search.
+  if (CLI::HasParam("k"))
+  {
+    CLI::GetParam<arma::mat>("distances") = std::move(distances);
+    CLI::GetParam<arma::Mat<size_t>>("neighbors") = std::move(neighbors);
+  }
+  CLI::GetParam<HNSWSearch<>*>("output_model") = allkann;
+}
@@ -0,0 +1,324 @@
+/**
+ * @file methods/hnsw/hnsw_search.hpp
+ *
+ * Defines the HNSWSearch class, which performs an approximate nearest neighbor
+ * search for the points of a query set over a given dataset with a
+ * hierarchical navigable small world graph.
+ *
+ * The details of this method can be found in the following paper:
+ *
+ * @code
+ * @article{malkov2018efficient,
+ *   title={Efficient and robust approximate nearest neighbor search using
+ *       Hierarchical Navigable Small World graphs},
+ *   author={Malkov, Yu A. and Yashunin, D. A.},
+ *   journal={IEEE Transactions on Pattern Analysis and Machine Intelligence},
+ *   volume={42},
+ *   number={4},
+ *   pages={824--836},
+ *   year={2018}
+ * }
+ * @endcode
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HNSW_HNSW_SEARCH_HPP
+#define MLPACK_METHODS_HNSW_HNSW_SEARCH_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <mlpack/core/metrics/lmetric.hpp>
+
+#include <mutex>
+#include <queue>
+
+namespace mlpack {
+namespace neighbor {
+
+/**
+ * The HNSWSearch class; this class builds a hierarchical navigable small world
+ * graph on the reference set and walks it to compute the approximate nearest
+ * neighbors of the given queries.
+ *
+ * Each reference point is a node of the graph at a random number of levels
+ * (most points are only at level 0, and each level has about maxConnections
+ * times fewer points than the one below it).  At each of its levels a node is
+ * linked to at most maxConnections other nodes (2 * maxConnections at level
+ * 0), chosen among its nearest neighbors so that the links point in diverse
+ * directions.  A search starts at the single node of the top level, walks
+ * greedily down to level 0 and then runs a best-first search there, keeping
+ * the ef best candidates; a larger ef gives a better recall for a longer
+ * search.
+ *
+ * The graph is built by inserting the points one after another; with OpenMP,
+ * the points are inserted in parallel, with a lock on the links of each node,
+ * so the graph (and so the results) may differ from run to run.
+ *
+ * @tparam MetricType The metric to use for the distances.
+ * @tparam MatType Type of matrix to use to store the data (arma::mat or
+ *     arma::fmat).
+ */
+template<
+    typename MetricType = metric::EuclideanDistance,
+    typename MatType = arma::mat
+>
+class HNSWSearch
+{
+ public:
+  //! The type of the elements of the data.
+  typedef typename MatType::elem_type ElemType;
+
+  /**
+   * Build the graph on the given reference set.  In order to avoid copying the
+   * reference set, consider passing it with std::move().
+   *
+   * @param referenceSet Set of reference points.
+   * @param maxConnections The number of links of each node at each level
+   *     above 0 (twice as many at level 0); between 8 and 48 is common, larger
+   *     values suit data of higher dimension.
+   * @param efConstruction The number of candidate neighbors kept when a point
+   *     is inserted; larger values give a better graph for a longer build.
+   * @param metric Instantiated metric.
+   */
+  HNSWSearch(MatType referenceSet,
+             const size_t maxConnections = 16,
+             const size_t efConstruction = 200,
+             const MetricType metric = MetricType());
+
+  /**
+   * Create an untrained HNSW model.  Be sure to call Train() before calling
+   * Search(); otherwise, an exception will be thrown when Search() is called.
+   */
+  HNSWSearch();
+
+  /**
+   * Build the graph on the given reference set, replacing the current one.  In
+   * order to avoid copying the reference set, consider passing it with
+   * std::move().
+   *
+   * @param referenceSet Set of reference points.
+   * @param maxConnections The number of links of each node at each level
+   *     above 0 (twice as many at level 0).
+   * @param efConstruction The number of candidate neighbors kept when a point
+   *     is inserted.
+   */
+  void Train(MatType referenceSet,
+             const size_t maxConnections = 16,
+             const size_t efConstruction = 200);
+
+  /**
+   * Compute the approximate nearest neighbors of the points in the given query
+   * set and store the output in the given matrices.  The matrices will be set
+   * to the size of n columns by k rows, where n is the number of points in the
+   * query dataset and k is the number of neighbors being searched for.  If
+   * fewer than k neighbors are found for a query, the remaining neighbors are
+   * SIZE_MAX and their distances DBL_MAX.
+   *
+   * @param querySet Set of query points.
+   * @param k Number of neighbors to search for.
+   * @param resultingNeighbors Matrix storing lists of neighbors for each query
+   *     point.
+   * @param distances Matrix storing distances of neighbors for each query
+   *     point.
+   * @param ef The number of candidates kept by the search at level 0 (at least
+   *     k are kept).  If 0, the efConstruction of the model is used.
+   */
+  void Search(const MatType& querySet,
+              const size_t k,
+              arma::Mat<size_t>& resultingNeighbors,
+              arma::mat& distances,
+              const size_t ef = 0);
+
+  /**
+   * Compute the approximate nearest neighbors of the points in the reference
+   * set (each point is not its own neighbor) and store the output in the given
+   * matrices, as with the other overload of Search().
+   *
+   * @param k Number of neighbors to search for.
+   * @param resultingNeighbors Matrix storing lists of neighbors for each query
+   *     point.
+   * @param distances Matrix storing distances of neighbors for each query
+   *     point.
+   * @param ef The number of candidates kept by the search at level 0 (at least
+   *     k are kept).  If 0, the efConstruction of the model is used.
+   */
+  void Search(const size_t k,
+              arma::Mat<size_t>& resultingNeighbors,
+              arma::mat& distances,
+              const size_t ef = 0);
+
+  /**
+   * Compute the recall (% of neighbors found) given the neighbors returned by
+   * HNSWSearch::Search and a "ground truth" set of neighbors.  The recall
+   * returned will be in the range [0, 1].
+   *
+   * @param foundNeighbors Set of neighbors to compute recall of.
+   * @param realNeighbors Set of "ground truth" neighbors to compute recall
+   *     against.
+   */
+  static double ComputeRecall(const arma::Mat<size_t>& foundNeighbors,
+                              const arma::Mat<size_t>& realNeighbors);
+
+  /**
+   * Serialize the HNSW model.
+   *
+   * @param ar Archive to serialize to.
+   * @param version Version number.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+  //! Return the number of distance evaluations.
+  size_t DistanceEvaluations() const { return distanceEvaluations; }
+  //! Modify the number of distance evaluations.
+  size_t& DistanceEvaluations() { return distanceEvaluations; }
+
+  //! Return the reference dataset.
+  const MatType& ReferenceSet() const { return referenceSet; }
+
+  //! Get the number of links of each node at each level above 0.
+  size_t MaxConnections() const { return maxConnections; }
+
+  //! Get the number of candidate neighbors kept when a point is inserted.
+  size_t EfConstruction() const { return efConstruction; }
+
+  //! Get the top level of the graph.
+  size_t MaxLevel() const { return maxLevel; }
+
+  //! Get the node where every search starts (the node of the top level).
+  size_t EntryPoint() const { return entryPoint; }
+
+  //! Get the top level of the given node.
+  size_t Level(const size_t point) const { return graph[point].size() - 1; }
+
+  //! Get the links of the given node at the given level.
+  const std::vector<size_t>& Links(const size_t point, const size_t level) const
+  { return graph[point][level]; }
+
+  //! Get the metric.
+  const MetricType& Metric() const { return metric; }
+  //! Modify the metric.
+  MetricType& Metric() { return metric; }
+
+ private:
+  //! Candidate represents a possible candidate neighbor (distance, index).
+  typedef std::pair<ElemType, size_t> Candidate;
+
+  /**
+   * Keep the ef nodes of the given level nearest to the query, with a
+   * best-first search from the given entry points.
+   *
+   * @param query The query point.
+   * @param candidates The entry points on input; the nearest nodes found, in
+   *     increasing order of distance, on output.
+   * @param ef The number of nodes to keep.
+   * @param level The level to search.
+   * @param visited Mark of each node, so that each search visits a node once.
+   * @param visitedMark Last mark used in visited.
+   * @param locks The locks of the links of the nodes while the graph is being
+   *     built, or NULL.
+   * @param evaluations Number of distance evaluations (incremented).
+   */
+  template<typename VecType>
+  void SearchLevel(const VecType& query,
+                   std::vector<Candidate>& candidates,
+                   const size_t ef,
+                   const size_t level,
+                   std::vector<size_t>& visited,
+                   size_t& visitedMark,
+                   std::vector<std::mutex>* locks,
+                   size_t& evaluations) const;
+
+  /**
+   * Choose at most the given number of neighbors among the given candidates:
+   * a candidate is kept if it is nearer to the point than to every neighbor
+   * kept before it, so that the links point in diverse directions.
+   *
+   * @param candidates The candidates, in increasing order of distance.
+   * @param count The maximum number of neighbors.
+   * @param neighbors The chosen neighbors.
+   * @param evaluations Number of distance evaluations (incremented).
+   */
+  void SelectNeighbors(const std::vector<Candidate>& candidates,
+                       const size_t count,
+                       std::vector<size_t>& neighbors,
+                       size_t& evaluations) const;
+
+  /**
+   * Insert the given reference point in the graph, at the levels that were
+   * allocated for it.
+   *
+   * @param point The point to insert.
+   * @param locks The locks of the links of the nodes.
+   * @param entryLock The lock of the entry point and the top level.
+   * @param visited Mark of each node, for SearchLevel().
+   * @param visitedMark Last mark used in visited.
+   * @param evaluations Number of distance evaluations (incremented).
+   */
+  void Insert(const size_t point,
+              std::vector<std::mutex>& locks,
+              std::mutex& entryLock,
+              std::vector<size_t>& visited,
+              size_t& visitedMark,
+              size_t& evaluations);
+
+  /**
+   * Find the k nearest neighbors of the given query, and store them (and their
+   * distances) in the given columns.
+   *
+   * @param query The query point.
+   * @param k Number of neighbors to search for.
+   * @param ef The number of candidates kept at level 0.
+   * @param exclude A point that must not be returned (SIZE_MAX for none).
+   * @param neighbors Column to store the neighbors in.
+   * @param distances Column to store the distances in.
+   * @param visited Mark of each node, for SearchLevel().
+   * @param visitedMark Last mark used in visited.
+   * @param evaluations Number of distance evaluations (incremented).
+   */
+  template<typename VecType>
+  void SearchPoint(const VecType& query,
+                   const size_t k,
+                   const size_t ef,
+                   const size_t exclude,
+                   size_t* neighbors,
+                   double* distances,
+                   std::vector<size_t>& visited,
+                   size_t& visitedMark,
+                   size_t& evaluations) const;
+
+  //! Reference dataset.
+  MatType referenceSet;
+
+  //! The number of links of each node at each level above 0.
+  size_t maxConnections;
+
+  //! The number of candidate neighbors kept when a point is inserted.
+  size_t efConstruction;
+
+  //! The top level of the graph.
+  size_t maxLevel;
+
+  //! The node of the top level.
+  size_t entryPoint;
+
+  //! The links of each node (graph[point][level]).
+  std::vector<std::vector<std::vector<size_t>>> graph;
+
+  //! Instantiated metric.
+  MetricType metric;
+
+  //! The number of distance evaluations.
+  size_t distanceEvaluations;
+}; // class HNSWSearch
+
+} // namespace neighbor
+} // namespace mlpack
+
+// Include implementation.
+#include "hnsw_search_impl.hpp"
+
+#endif
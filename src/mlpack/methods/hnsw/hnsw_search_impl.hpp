@@ -0,0 +1,484 @@
+/**
+ * @file methods/hnsw/hnsw_search_impl.hpp
+ *
+ * Implementation of the HNSWSearch class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HNSW_HNSW_SEARCH_IMPL_HPP
+#define MLPACK_METHODS_HNSW_HNSW_SEARCH_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "hnsw_search.hpp"
+
+namespace mlpack {
+namespace neighbor {
+
+// Construct and train the model.
+template<typename MetricType, typename MatType>
+HNSWSearch<MetricType, MatType>::HNSWSearch(MatType referenceSet,
+                                            const size_t maxConnections,
+                                            const size_t efConstruction,
+                                            const MetricType metric) :
+    maxConnections(maxConnections),
+    efConstruction(efConstruction),
+    maxLevel(0),
+    entryPoint(0),
+    metric(metric),
+    distanceEvaluations(0)
+{
+  Train(std::move(referenceSet), maxConnections, efConstruction);
+}
+
+// Empty constructor.
+template<typename MetricType, typename MatType>
+HNSWSearch<MetricType, MatType>::HNSWSearch() :
+    maxConnections(16),
+    efConstruction(200),
+    maxLevel(0),
+    entryPoint(0),
+    distanceEvaluations(0)
+{
+  // Nothing to do here.
+}
+
+// Build the graph.
+template<typename MetricType, typename MatType>
+void HNSWSearch<MetricType, MatType>::Train(MatType referenceSet,
+                                            const size_t maxConnections,
+                                            const size_t efConstruction)
+{
+  if (maxConnections < 2)
+  {
+    throw std::invalid_argument("HNSWSearch::Train(): the number of "
+        "connections must be at least 2");
+  }
+
+  this->referenceSet = std::move(referenceSet);
+  this->maxConnections = maxConnections;
+  this->efConstruction = std::max(efConstruction, maxConnections);
+
+  // Draw the top level of each node, so that each level has maxConnections
+  // times fewer nodes than the one below it.
+  const size_t n = this->referenceSet.n_cols;
+  const double levelScale = 1.0 / std::log((double) maxConnections);
+  graph.clear();
+  graph.resize(n);
+  for (size_t i = 0; i < n; ++i)
+  {
+    const size_t level = (size_t) (-std::log(1.0 - math::Random()) *
+        levelScale);
+    graph[i].resize(level + 1);
+  }
+
+  maxLevel = 0;
+  entryPoint = 0;
+  if (n == 0)
+    return;
+
+  // The first node is the whole graph; the others are inserted in parallel.
+  maxLevel = graph[0].size() - 1;
+  std::vector<std::mutex> locks(n);
+  std::mutex entryLock;
+  size_t evaluations = 0;
+
+  #pragma omp parallel reduction(+:evaluations)
+  {
+    std::vector<size_t> visited(n, 0);
+    size_t visitedMark = 0;
+
+    #pragma omp for schedule(dynamic, 16)
+    for (omp_size_t i = 1; i < (omp_size_t) n; ++i)
+      Insert(i, locks, entryLock, visited, visitedMark, evaluations);
+  }
+
+  distanceEvaluations += evaluations;
+}
+
+// Insert one point of the reference set in the graph.
+template<typename MetricType, typename MatType>
+void HNSWSearch<MetricType, MatType>::Insert(const size_t point,
+                                             std::vector<std::mutex>& locks,
+                                             std::mutex& entryLock,
+                                             std::vector<size_t>& visited,
+                                             size_t& visitedMark,
+                                             size_t& evaluations)
+{
+  // A point that becomes the new entry point keeps the lock until it is
+  // linked, so that no search starts from it before.
+  const size_t level = graph[point].size() - 1;
+  std::unique_lock<std::mutex> entryGuard(entryLock);
+  const size_t topLevel = maxLevel;
+  const size_t start = entryPoint;
+  if (level <= topLevel)
+    entryGuard.unlock();
+
+  const auto query = referenceSet.col(point);
+  std::vector<Candidate> candidates(1, Candidate(metric.Evaluate(query,
+      referenceSet.col(start)), start));
+  ++evaluations;
+
+  // Walk down greedily to the top level of the point.
+  for (size_t l = topLevel; l > level; --l)
+  {
+    SearchLevel(query, candidates, 1, l, visited, visitedMark, &locks,
+        evaluations);
+  }
+
+  // Link the point at each of its levels.
+  std::vector<size_t> neighbors;
+  for (size_t l = std::min(level, topLevel) + 1; l-- > 0; )
+  {
+    SearchLevel(query, candidates, efConstruction, l, visited, visitedMark,
+        &locks, evaluations);
+    SelectNeighbors(candidates, maxConnections, neighbors, evaluations);
+    {
+      std::lock_guard<std::mutex> guard(locks[point]);
+      graph[point][l] = neighbors;
+    }
+
+    // Link each neighbor back to the point, and choose its links again if it
+    // has too many.
+    const size_t maxLinks = (l == 0) ? 2 * maxConnections : maxConnections;
+    for (size_t i = 0; i < neighbors.size(); ++i)
+    {
+      const size_t neighbor = neighbors[i];
+      std::lock_guard<std::mutex> guard(locks[neighbor]);
+      std::vector<size_t>& links = graph[neighbor][l];
+      links.push_back(point);
+      if (links.size() <= maxLinks)
+        continue;
+
+      std::vector<Candidate> linkCandidates(links.size());
+      for (size_t j = 0; j < links.size(); ++j)
+      {
+        linkCandidates[j] = Candidate(metric.Evaluate(
+            referenceSet.col(neighbor), referenceSet.col(links[j])), links[j]);
+      }
+      evaluations += links.size();
+      std::sort(linkCandidates.begin(), linkCandidates.end());
+      SelectNeighbors(linkCandidates, maxLinks, links, evaluations);
+    }
+  }
+
+  if (level > topLevel)
+  {
+    maxLevel = level;
+    entryPoint = point;
+  }
+}
+
+// Best-first search of one level of the graph.
+template<typename MetricType, typename MatType>
+template<typename VecType>
+void HNSWSearch<MetricType, MatType>::SearchLevel(
+    const VecType& query,
+    std::vector<Candidate>& candidates,
+    const size_t ef,
+    const size_t level,
+    std::vector<size_t>& visited,
+    size_t& visitedMark,
+    std::vector<std::mutex>* locks,
+    size_t& evaluations) const
+{
+  // The nodes to expand, nearest first, and the ef nearest nodes found,
+  // farthest first.
+  std::priority_queue<Candidate, std::vector<Candidate>,
+      std::greater<Candidate>> frontier;
+  std::priority_queue<Candidate> nearest;
+
+  ++visitedMark;
+  for (size_t i = 0; i < candidates.size(); ++i)
+  {
+    visited[candidates[i].second] = visitedMark;
+    frontier.push(candidates[i]);
+    nearest.push(candidates[i]);
+  }
+  while (nearest.size() > ef)
+    nearest.pop();
+
+  std::vector<size_t> links;
+  while (!frontier.empty())
+  {
+    const Candidate current = frontier.top();
+    if (nearest.size() == ef && current.first > nearest.top().first)
+      break;
+    frontier.pop();
+
+    if (locks)
+    {
+      std::lock_guard<std::mutex> guard((*locks)[current.second]);
+      links = graph[current.second][level];
+    }
+    else
+    {
+      links = graph[current.second][level];
+    }
+
+    for (size_t i = 0; i < links.size(); ++i)
+    {
+      const size_t node = links[i];
+      if (visited[node] == visitedMark)
+        continue;
+      visited[node] = visitedMark;
+
+      const ElemType distance = metric.Evaluate(query,
+          referenceSet.col(node));
+      ++evaluations;
+      if (nearest.size() < ef || distance < nearest.top().first)
+      {
+        frontier.push(Candidate(distance, node));
+        nearest.push(Candidate(distance, node));
+        if (nearest.size() > ef)
+          nearest.pop();
+      }
+    }
+  }
+
+  candidates.resize(nearest.size());
+  for (size_t i = candidates.size(); i-- > 0; )
+  {
+    candidates[i] = nearest.top();
+    nearest.pop();
+  }
+}
+
+// Choose the links of a node among its nearest candidates.
+template<typename MetricType, typename MatType>
+void HNSWSearch<MetricType, MatType>::SelectNeighbors(
+    const std::vector<Candidate>& candidates,
+    const size_t count,
+    std::vector<size_t>& neighbors,
+    size_t& evaluations) const
+{
+  // The candidates may be the current neighbors.
+  std::vector<size_t> selected;
+  for (size_t i = 0; i < candidates.size() && selected.size() < count; ++i)
+  {
+    bool diverse = true;
+    for (size_t j = 0; j < selected.size(); ++j)
+    {
+      ++evaluations;
+      if (metric.Evaluate(referenceSet.col(candidates[i].second),
+          referenceSet.col(selected[j])) < candidates[i].first)
+      {
+        diverse = false;
+        break;
+      }
+    }
+
+    if (diverse)
+      selected.push_back(candidates[i].second);
+  }
+
+  neighbors = std::move(selected);
+}
+
+// Search for the nearest neighbors of one point.
+template<typename MetricType, typename MatType>
+template<typename VecType>
+void HNSWSearch<MetricType, MatType>::SearchPoint(
+    const VecType& query,
+    const size_t k,
+    const size_t ef,
+    const size_t exclude,
+    size_t* neighbors,
+    double* distances,
+    std::vector<size_t>& visited,
+    size_t& visitedMark,
+    size_t& evaluations) const
+{
+  std::vector<Candidate> candidates(1, Candidate(metric.Evaluate(query,
+      referenceSet.col(entryPoint)), entryPoint));
+  ++evaluations;
+
+  for (size_t l = maxLevel; l > 0; --l)
+  {
+    SearchLevel(query, candidates, 1, l, visited, visitedMark, NULL,
+        evaluations);
+  }
+  SearchLevel(query, candidates, ef, 0, visited, visitedMark, NULL,
+      evaluations);
+
+  size_t found = 0;
+  for (size_t i = 0; i < candidates.size() && found < k; ++i)
+  {
+    if (candidates[i].second == exclude)
+      continue;
+
+    neighbors[found] = candidates[i].second;
+    distances[found] = candidates[i].first;
+    ++found;
+  }
+
+  for (; found < k; ++found)
+  {
+    neighbors[found] = SIZE_MAX;
+    distances[found] = DBL_MAX;
+  }
+}
+
+// Search for the approximate neighbors of the query set.
+template<typename MetricType, typename MatType>
+void HNSWSearch<MetricType, MatType>::Search(
+    const MatType& querySet,
+    const size_t k,
+    arma::Mat<size_t>& resultingNeighbors,
+    arma::mat& distances,
+    const size_t ef)
+{
+  // Ensure the dimensionality of the query set is correct.
+  if (querySet.n_rows != referenceSet.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "HNSWSearch::Search(): dimensionality of query set ("
+        << querySet.n_rows << ") is not equal to the dimensionality the model "
+        << "was trained on (" << referenceSet.n_rows << ")!" << std::endl;
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (k > referenceSet.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "HNSWSearch::Search(): requested " << k << " approximate nearest "
+        << "neighbors, but reference set has " << referenceSet.n_cols
+        << " points!" << std::endl;
+    throw std::invalid_argument(oss.str());
+  }
+
+  resultingNeighbors.set_size(k, querySet.n_cols);
+  distances.set_size(k, querySet.n_cols);
+
+  // If the user asked for 0 nearest neighbors... uh... we're done.
+  if (k == 0)
+    return;
+
+  const size_t searchEf = std::max((ef == 0) ? efConstruction : ef, k);
+  size_t evaluations = 0;
+
+  Timer::Start("computing_neighbors");
+
+  // Parallelization to process more than one query at a time.
+  #pragma omp parallel reduction(+:evaluations)
+  {
+    std::vector<size_t> visited(referenceSet.n_cols, 0);
+    size_t visitedMark = 0;
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t i = 0; i < (omp_size_t) querySet.n_cols; ++i)
+    {
+      SearchPoint(querySet.col(i), k, searchEf, SIZE_MAX,
+          resultingNeighbors.colptr(i), distances.colptr(i), visited,
+          visitedMark, evaluations);
+    }
+  }
+
+  Timer::Stop("computing_neighbors");
+
+  distanceEvaluations += evaluations;
+  Log::Info << evaluations / querySet.n_cols << " distance evaluations per "
+      << "query on average." << std::endl;
+}
+
+// Search for approximate neighbors of the reference set.
+template<typename MetricType, typename MatType>
+void HNSWSearch<MetricType, MatType>::Search(
+    const size_t k,
+    arma::Mat<size_t>& resultingNeighbors,
+    arma::mat& distances,
+    const size_t ef)
+{
+  if (k >= referenceSet.n_cols && k > 0)
+  {
+    std::ostringstream oss;
+    oss << "HNSWSearch::Search(): requested " << k << " approximate nearest "
+        << "neighbors, but reference set has " << referenceSet.n_cols
+        << " points!" << std::endl;
+    throw std::invalid_argument(oss.str());
+  }
+
+  // This is monochromatic search; the query set is the reference set.
+  resultingNeighbors.set_size(k, referenceSet.n_cols);
+  distances.set_size(k, referenceSet.n_cols);
+
+  if (k == 0)
+    return;
+
+  // One more candidate is kept, since each point finds itself.
+  const size_t searchEf = std::max((ef == 0) ? efConstruction : ef, k) + 1;
+  size_t evaluations = 0;
+
+  Timer::Start("computing_neighbors");
+
+  // Parallelization to process more than one query at a time.
+  #pragma omp parallel reduction(+:evaluations)
+  {
+    std::vector<size_t> visited(referenceSet.n_cols, 0);
+    size_t visitedMark = 0;
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t i = 0; i < (omp_size_t) referenceSet.n_cols; ++i)
+    {
+      SearchPoint(referenceSet.col(i), k, searchEf, i,
+          resultingNeighbors.colptr(i), distances.colptr(i), visited,
+          visitedMark, evaluations);
+    }
+  }
+
+  Timer::Stop("computing_neighbors");
+
+  distanceEvaluations += evaluations;
+  Log::Info << evaluations / referenceSet.n_cols << " distance evaluations "
+      << "per query on average." << std::endl;
+}
+
+template<typename MetricType, typename MatType>
+double HNSWSearch<MetricType, MatType>::ComputeRecall(
+    const arma::Mat<size_t>& foundNeighbors,
+    const arma::Mat<size_t>& realNeighbors)
+{
+  if (foundNeighbors.n_rows != realNeighbors.n_rows ||
+      foundNeighbors.n_cols != realNeighbors.n_cols)
+    throw std::invalid_argument("HNSWSearch::ComputeRecall(): matrices "
+        "provided must have equal size");
+
+  const size_t queries = foundNeighbors.n_cols;
+  const size_t neighbors = foundNeighbors.n_rows; // Should be equal to k.
+
+  // The recall is the set intersection of found and real neighbors.
+  size_t found = 0;
+  for (size_t col = 0; col < queries; ++col)
+    for (size_t row = 0; row < neighbors; ++row)
+      for (size_t nei = 0; nei < realNeighbors.n_rows; ++nei)
+        if (realNeighbors(row, col) == foundNeighbors(nei, col))
+        {
+          found++;
+          break;
+        }
+
+  return ((double) found) / realNeighbors.n_elem;
+}
+
+template<typename MetricType, typename MatType>
+template<typename Archive>
+void HNSWSearch<MetricType, MatType>::serialize(
+    Archive& ar,
+    const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(referenceSet);
+  ar & BOOST_SERIALIZATION_NVP(maxConnections);
+  ar & BOOST_SERIALIZATION_NVP(efConstruction);
+  ar & BOOST_SERIALIZATION_NVP(maxLevel);
+  ar & BOOST_SERIALIZATION_NVP(entryPoint);
+  ar & BOOST_SERIALIZATION_NVP(graph);
+  ar & BOOST_SERIALIZATION_NVP(metric);
+  ar & BOOST_SERIALIZATION_NVP(distanceEvaluations);
+}
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
@@ -162,7 +162,9 @@ class HoeffdingTree
 
   /**
    * Train on a set of points, either in streaming mode or in batch mode, with
-   * the given labels.
+   * the given labels.  In streaming mode, the tree is the same as after
+   * training on each point in turn, but with OpenMP the split statistics of
+   * the dimensions and the subtrees are updated in parallel.
    *
    * @param data Data points to train on.
    * @param labels Labels of data points.
@@ -240,6 +242,35 @@ class HoeffdingTree
   //! Modify the number of samples before a split check is performed.
   void CheckInterval(const size_t checkInterval);
 
+  //! Get the maximum number of active leaves (0 means no limit).
+  size_t MaxActiveLeaves() const { return maxActiveLeaves; }
+  /**
+   * Modify the maximum number of active leaves (0 means no limit).  Only the
+   * active leaves of the tree keep the statistics needed to split; when there
+   * are more leaves than the limit, only the most promising ones are kept
+   * active (see Promise()).  The others are deactivated: they release their
+   * statistics, and keep classifying points with their majority class.  The
+   * limit is applied at the end of each call to Train() with a set of points,
+   * and every CheckInterval() calls to Train() with one point; a deactivated
+   * leaf that becomes one of the most promising leaves again is reactivated,
+   * with empty statistics.
+   */
+  void MaxActiveLeaves(const size_t maxActiveLeaves);
+
+  //! Get whether this node, if it is a leaf, keeps the statistics to split.
+  bool Active() const { return active; }
+
+  /**
+   * Get the promise of this node: the number of training points that reached
+   * it while it was a leaf and that its majority class misclassified (that is,
+   * its error rate times the number of points it saw).  The most promising
+   * leaves are the ones where splitting would fix the most errors.
+   */
+  size_t Promise() const { return promise; }
+
+  //! Get the number of active leaves of the tree.
+  size_t NumActiveLeaves() const;
+
   /**
    * Given a point and that this node is not a leaf, calculate the index of the
    * child node this point would go towards.  This method is primarily used by
@@ -358,11 +389,89 @@ class HoeffdingTree
   typename NumericSplitType<FitnessFunction>::SplitInfo numericSplit;
   //! If the split has occurred, these are the children.
   std::vector<HoeffdingTree*> children;
+
+  //! Whether this node keeps the statistics for splitting (if it is a leaf).
+  bool active;
+  //! The number of training points misclassified while this node was a leaf.
+  size_t promise;
+  //! The maximum number of active leaves of the tree (0 for no limit).
+  size_t maxActiveLeaves;
+  //! The number of points given to Train() since the limit was last applied.
+  size_t pointsSinceUpdate;
+
+  /**
+   * Train on the given point, without applying the limit on the number of
+   * active leaves.
+   */
+  template<typename VecType>
+  void TrainPoint(const VecType& point, const size_t label);
+
+  /**
+   * Train on the given set of points in batch mode, without applying the limit
+   * on the number of active leaves.
+   */
+  template<typename MatType>
+  void BatchTrain(const MatType& data, const arma::Row<size_t>& labels);
+  /**
+   * Train on the given points in streaming mode, in the given order.  The
+   * result is the same as that of training on each point in turn, but the
+   * splits of the dimensions of a leaf are updated in parallel OpenMP tasks
+   * between two split checks, and the points that reach the children of a
+   * split node are given to the children in parallel tasks.
+   *
+   * @param data Data points to train on.
+   * @param labels Labels of data points.
+   * @param points Indices of the points to train on, in order.
+   */
+  template<typename MatType>
+  void StreamTrain(const MatType& data,
+                   const arma::Row<size_t>& labels,
+                   const arma::uvec& points);
+
+  /**
+   * Rank the leaves of the tree by promise, and keep the first
+   * MaxActiveLeaves() leaves active and the others inactive.
+   */
+  void UpdateActiveLeaves();
+
+  /**
+   * Create empty statistics for splitting, with the parameters of the given
+   * splits.
+   */
+  void Activate(const NumericSplitType<FitnessFunction>& numericSplitIn,
+                const CategoricalSplitType<FitnessFunction>&
+                    categoricalSplitIn);
+
+  //! Release the statistics for splitting.
+  void Deactivate();
 };
 
 } // namespace tree
 } // namespace mlpack
 
+//! Set the serialization version of the HoeffdingTree class.  (This can't use
+//! BOOST_TEMPLATE_CLASS_VERSION, since HoeffdingTree has more than one template
+//! parameter.)
+namespace boost {
+namespace serialization {
+
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType>
+struct version<mlpack::tree::HoeffdingTree<FitnessFunction,
+                                           NumericSplitType,
+                                           CategoricalSplitType>>
+{
+  typedef mpl::int_<1> type;
+  typedef mpl::integral_c_tag tag;
+  BOOST_STATIC_CONSTANT(int, value = version::type::value);
+  BOOST_MPL_ASSERT((boost::mpl::less<boost::mpl::int_<1>,
+                    boost::mpl::int_<256>>));
+};
+
+} // namespace serialization
+} // namespace boost
+
 #include "hoeffding_tree_impl.hpp"
 
 #endif
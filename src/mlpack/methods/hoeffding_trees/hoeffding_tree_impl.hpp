@@ -54,7 +54,11 @@ HoeffdingTree<
     majorityClass(0),
     majorityProbability(0.0),
     categoricalSplit(0),
-    numericSplit()
+    numericSplit(),
+    active(true),
+    promise(0),
+    maxActiveLeaves(0),
+    pointsSinceUpdate(0)
 {
   // Generate dimension mappings and create split objects.
   for (size_t i = 0; i < datasetInfo.Dimensionality(); ++i)
@@ -114,7 +118,11 @@ HoeffdingTree<
     majorityClass(0),
     majorityProbability(0.0),
     categoricalSplit(0),
-    numericSplit()
+    numericSplit(),
+    active(true),
+    promise(0),
+    maxActiveLeaves(0),
+    pointsSinceUpdate(0)
 {
   // Do we need to generate the mappings too?
   if (ownsMappings)
@@ -178,7 +186,11 @@ HoeffdingTree<
     majorityClass(0),
     majorityProbability(0.0),
     categoricalSplit(0),
-    numericSplit()
+    numericSplit(),
+    active(true),
+    promise(0),
+    maxActiveLeaves(0),
+    pointsSinceUpdate(0)
 {
   // Nothing to do.
 }
@@ -206,7 +218,11 @@ HoeffdingTree<FitnessFunction, NumericSplitType, CategoricalSplitType>::
     majorityClass(other.majorityClass),
     majorityProbability(other.majorityProbability),
     categoricalSplit(other.categoricalSplit),
-    numericSplit(other.numericSplit)
+    numericSplit(other.numericSplit),
+    active(other.active),
+    promise(other.promise),
+    maxActiveLeaves(other.maxActiveLeaves),
+    pointsSinceUpdate(0)
 {
   // Copy each of the children.
   for (size_t i = 0; i < other.children.size(); ++i)
@@ -253,66 +269,90 @@ void HoeffdingTree<
 {
   if (batchTraining)
   {
-    // Pass all the points through the nodes, and then split only after that.
-    checkInterval = data.n_cols; // Only split on the last sample.
-    // Don't split if there are fewer than five points.
-    size_t oldMaxSamples = maxSamples;
-    maxSamples = std::max(size_t(data.n_cols - 1), size_t(5));
-    for (size_t i = 0; i < data.n_cols; ++i)
-      Train(data.col(i), labels[i]);
-    maxSamples = oldMaxSamples;
-
-    // Now, if we did split, find out which points go to which child, and
-    // perform the same batch training.
-    if (children.size() > 0)
-    {
-      // We need to create a vector of indices that represent the points that
-      // must go to each child, so we need children.size() vectors, but we don't
-      // know how long they will be.  Therefore, we will create vectors each of
-      // size data.n_cols, but will probably not use all the memory we
-      // allocated, and then pass subvectors to the submat() function.
-      std::vector<arma::uvec> indices(children.size(), arma::uvec(data.n_cols));
-      arma::Col<size_t> counts =
-          arma::zeros<arma::Col<size_t>>(children.size());
-
-      for (size_t i = 0; i < data.n_cols; ++i)
-      {
-        size_t direction = CalculateDirection(data.col(i));
-        size_t currentIndex = counts[direction];
-        indices[direction][currentIndex] = i;
-        counts[direction]++;
-      }
+    BatchTrain(data, labels);
+  }
+  else
+  {
+    // We aren't training in batch mode; stream the points through the tree.
+    if (data.n_cols == 0)
+      return;
 
-      // Now pass each of these submatrices to the children to perform
-      // batch-mode training.
-      for (size_t i = 0; i < children.size(); ++i)
-      {
-        // If we don't have any points that go to the child in question, don't
-        // train that child.
-        if (counts[i] == 0)
-          continue;
-
-        // The submatrix here is non-contiguous, but I think this will be faster
-        // than copying the points to an ordered state.  We still have to
-        // assemble the labels vector, though.
-        arma::Row<size_t> childLabels = labels.cols(
-            indices[i].subvec(0, counts[i] - 1));
-
-        // Unfortunately, limitations of Armadillo's non-contiguous subviews
-        // prohibits us from successfully passing the non-contiguous subview to
-        // Train(), since the col() function is not provided.  So,
-        // unfortunately, instead, we'll just extract the non-contiguous
-        // submatrix.
-        MatType childData = data.cols(indices[i].subvec(0, counts[i] - 1));
-        children[i]->Train(childData, childLabels, true);
-      }
+    const arma::uvec points = arma::linspace<arma::uvec>(0, data.n_cols - 1,
+        data.n_cols);
+    #pragma omp parallel
+    {
+      #pragma omp single
+      StreamTrain(data, labels, points);
     }
   }
-  else
+
+  UpdateActiveLeaves();
+}
+
+//! Train on a set of points in batch mode.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType>
+template<typename MatType>
+void HoeffdingTree<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::BatchTrain(const MatType& data, const arma::Row<size_t>& labels)
+{
+  // Pass all the points through the nodes, and then split only after that.
+  checkInterval = data.n_cols; // Only split on the last sample.
+  // Don't split if there are fewer than five points.
+  size_t oldMaxSamples = maxSamples;
+  maxSamples = std::max(size_t(data.n_cols - 1), size_t(5));
+  for (size_t i = 0; i < data.n_cols; ++i)
+    TrainPoint(data.col(i), labels[i]);
+  maxSamples = oldMaxSamples;
+
+  // Now, if we did split, find out which points go to which child, and
+  // perform the same batch training.
+  if (children.size() > 0)
   {
-    // We aren't training in batch mode; loop through the points.
+    // We need to create a vector of indices that represent the points that
+    // must go to each child, so we need children.size() vectors, but we don't
+    // know how long they will be.  Therefore, we will create vectors each of
+    // size data.n_cols, but will probably not use all the memory we
+    // allocated, and then pass subvectors to the submat() function.
+    std::vector<arma::uvec> indices(children.size(), arma::uvec(data.n_cols));
+    arma::Col<size_t> counts =
+        arma::zeros<arma::Col<size_t>>(children.size());
+
     for (size_t i = 0; i < data.n_cols; ++i)
-      Train(data.col(i), labels[i]);
+    {
+      size_t direction = CalculateDirection(data.col(i));
+      size_t currentIndex = counts[direction];
+      indices[direction][currentIndex] = i;
+      counts[direction]++;
+    }
+
+    // Now pass each of these submatrices to the children to perform
+    // batch-mode training.
+    for (size_t i = 0; i < children.size(); ++i)
+    {
+      // If we don't have any points that go to the child in question, don't
+      // train that child.
+      if (counts[i] == 0)
+        continue;
+
+      // The submatrix here is non-contiguous, but I think this will be faster
+      // than copying the points to an ordered state.  We still have to
+      // assemble the labels vector, though.
+      arma::Row<size_t> childLabels = labels.cols(
+          indices[i].subvec(0, counts[i] - 1));
+
+      // Unfortunately, limitations of Armadillo's non-contiguous subviews
+      // prohibits us from successfully passing the non-contiguous subview to
+      // Train(), since the col() function is not provided.  So,
+      // unfortunately, instead, we'll just extract the non-contiguous
+      // submatrix.
+      MatType childData = data.cols(indices[i].subvec(0, counts[i] - 1));
+      children[i]->BatchTrain(childData, childLabels);
+    }
   }
 }
 
@@ -367,6 +407,7 @@ void HoeffdingTree<
   for (size_t i = 0; i < children.size(); ++i)
     delete children[i];
   children.clear();
+  active = true;
 
   // Now train.
   Train(data, labels, batchTraining);
@@ -382,9 +423,37 @@ void HoeffdingTree<
     NumericSplitType,
     CategoricalSplitType
 >::Train(const VecType& point, const size_t label)
+{
+  TrainPoint(point, label);
+
+  // Don't rank the leaves after every point.
+  if (maxActiveLeaves > 0 && ++pointsSinceUpdate >= checkInterval)
+  {
+    pointsSinceUpdate = 0;
+    UpdateActiveLeaves();
+  }
+}
+
+//! Train on one point, without applying the limit on the active leaves.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType>
+template<typename VecType>
+void HoeffdingTree<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::TrainPoint(const VecType& point, const size_t label)
 {
   if (splitDimension == size_t(-1))
   {
+    if (label != majorityClass)
+      ++promise;
+
+    // An inactive leaf has no statistics to train.
+    if (!active)
+      return;
+
     ++numSamples;
     size_t numericIndex = 0;
     size_t categoricalIndex = 0;
@@ -425,8 +494,115 @@ void HoeffdingTree<
   {
     // Already split.  Pass the training point to the relevant child.
     size_t direction = CalculateDirection(point);
-    children[direction]->Train(point, label);
+    children[direction]->TrainPoint(point, label);
+  }
+}
+
+//! Train on several points in streaming mode.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType>
+template<typename MatType>
+void HoeffdingTree<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::StreamTrain(const MatType& data,
+               const arma::Row<size_t>& labels,
+               const arma::uvec& points)
+{
+  // An inactive leaf only counts the points it misclassifies.
+  if (splitDimension == size_t(-1) && !active)
+  {
+    for (size_t j = 0; j < points.n_elem; ++j)
+    {
+      if (labels[points[j]] != majorityClass)
+        ++promise;
+    }
+    return;
   }
+
+  // While this node is a leaf, give the points up to the next split check to
+  // the splits of all dimensions.  Each dimension sees the points in order.
+  size_t start = 0;
+  while (splitDimension == size_t(-1) && start < points.n_elem)
+  {
+    const size_t end = std::min(start + checkInterval -
+        numSamples % checkInterval, (size_t) points.n_elem);
+    for (size_t j = start; j < end; ++j)
+    {
+      if (labels[points[j]] != majorityClass)
+        ++promise;
+    }
+
+    for (size_t i = 0; i < data.n_rows; ++i)
+    {
+      // Small chunks are not worth a task.
+      #pragma omp task default(shared) firstprivate(i) if(end - start >= 64)
+      {
+        const size_t index = dimensionMappings->at(i).second;
+        if (datasetInfo->Type(i) == data::Datatype::categorical)
+        {
+          for (size_t j = start; j < end; ++j)
+            categoricalSplits[index].Train(data(i, points[j]),
+                labels[points[j]]);
+        }
+        else if (datasetInfo->Type(i) == data::Datatype::numeric)
+        {
+          for (size_t j = start; j < end; ++j)
+            numericSplits[index].Train(data(i, points[j]), labels[points[j]]);
+        }
+      }
+    }
+    #pragma omp taskwait
+
+    numSamples += end - start;
+    start = end;
+
+    // Grab majority class from splits.
+    if (categoricalSplits.size() > 0)
+    {
+      majorityClass = categoricalSplits[0].MajorityClass();
+      majorityProbability = categoricalSplits[0].MajorityProbability();
+    }
+    else
+    {
+      majorityClass = numericSplits[0].MajorityClass();
+      majorityProbability = numericSplits[0].MajorityProbability();
+    }
+
+    // Check for a split, if we should.
+    if (numSamples % checkInterval == 0)
+    {
+      const size_t numChildren = SplitCheck();
+      if (numChildren > 0)
+      {
+        children.clear();
+        CreateChildren();
+      }
+    }
+  }
+
+  if (start == points.n_elem)
+    return;
+
+  // The node is split, so pass the rest of the points to the children.
+  std::vector<std::vector<arma::uword>> childPoints(children.size());
+  for (size_t j = start; j < points.n_elem; ++j)
+  {
+    childPoints[CalculateDirection(data.col(points[j]))].push_back(
+        points[j]);
+  }
+
+  for (size_t c = 0; c < children.size(); ++c)
+  {
+    if (childPoints[c].empty())
+      continue;
+
+    #pragma omp task default(shared) firstprivate(c)
+    children[c]->StreamTrain(data, labels, arma::uvec(childPoints[c]));
+  }
+  #pragma omp taskwait
 }
 
 template<typename FitnessFunction,
@@ -582,6 +758,32 @@ void HoeffdingTree<
     children[i]->CheckInterval(checkInterval);
 }
 
+template<
+    typename FitnessFunction,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType
+>
+void HoeffdingTree<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::MaxActiveLeaves(const size_t maxActiveLeaves)
+{
+  // Set the limit in the whole tree before applying it once.
+  std::stack<HoeffdingTree*> stack;
+  stack.push(this);
+  while (!stack.empty())
+  {
+    HoeffdingTree* node = stack.top();
+    stack.pop();
+    node->maxActiveLeaves = maxActiveLeaves;
+    for (size_t i = 0; i < node->children.size(); ++i)
+      stack.push(node->children[i]);
+  }
+
+  UpdateActiveLeaves();
+}
+
 template<
     typename FitnessFunction,
     template<typename> class NumericSplitType,
@@ -626,6 +828,30 @@ size_t HoeffdingTree<
   return nodes;
 }
 
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType>
+size_t HoeffdingTree<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::NumActiveLeaves() const
+{
+  size_t leaves = 0;
+  std::stack<const HoeffdingTree*> stack;
+  stack.push(this);
+  while (!stack.empty())
+  {
+    const HoeffdingTree* node = stack.top();
+    stack.pop();
+    if (node->NumChildren() == 0 && node->active)
+      ++leaves;
+    for (size_t i = 0; i < node->NumChildren(); ++i)
+      stack.push(&node->Child(i));
+  }
+  return leaves;
+}
+
 template<
     typename FitnessFunction,
     template<typename> class NumericSplitType,
@@ -776,6 +1002,7 @@ void HoeffdingTree<
     }
 
     children[i]->MajorityClass() = childMajorities[i];
+    children[i]->maxActiveLeaves = maxActiveLeaves;
   }
 
   // Eliminate now-unnecessary split information.
@@ -783,6 +1010,126 @@ void HoeffdingTree<
   categoricalSplits.clear();
 }
 
+template<
+    typename FitnessFunction,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType
+>
+void HoeffdingTree<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::UpdateActiveLeaves()
+{
+  if (maxActiveLeaves == 0)
+    return;
+
+  std::vector<HoeffdingTree*> leaves;
+  std::stack<HoeffdingTree*> stack;
+  stack.push(this);
+  while (!stack.empty())
+  {
+    HoeffdingTree* node = stack.top();
+    stack.pop();
+    if (node->children.empty())
+      leaves.push_back(node);
+    for (size_t i = 0; i < node->children.size(); ++i)
+      stack.push(node->children[i]);
+  }
+
+  // Sort the leaves by decreasing promise; for equal promises, keep the active
+  // leaves active, so that their statistics aren't lost.
+  std::stable_sort(leaves.begin(), leaves.end(),
+      [](const HoeffdingTree* a, const HoeffdingTree* b)
+      {
+        return (a->promise > b->promise) ||
+            (a->promise == b->promise && a->active && !b->active);
+      });
+
+  // Reactivated leaves take the parameters of the splits of an active leaf.
+  NumericSplitType<FitnessFunction> numericSplitIn(0);
+  CategoricalSplitType<FitnessFunction> categoricalSplitIn(0, 0);
+  for (size_t i = 0; i < leaves.size(); ++i)
+  {
+    if (!leaves[i]->active)
+      continue;
+
+    if (!leaves[i]->numericSplits.empty())
+    {
+      numericSplitIn = NumericSplitType<FitnessFunction>(0,
+          leaves[i]->numericSplits[0]);
+    }
+    if (!leaves[i]->categoricalSplits.empty())
+    {
+      categoricalSplitIn = CategoricalSplitType<FitnessFunction>(0, 0,
+          leaves[i]->categoricalSplits[0]);
+    }
+    break;
+  }
+
+  // Release the statistics before allocating new ones.
+  for (size_t i = maxActiveLeaves; i < leaves.size(); ++i)
+  {
+    if (leaves[i]->active)
+      leaves[i]->Deactivate();
+  }
+  for (size_t i = 0; i < std::min(maxActiveLeaves, leaves.size()); ++i)
+  {
+    if (!leaves[i]->active)
+      leaves[i]->Activate(numericSplitIn, categoricalSplitIn);
+  }
+}
+
+template<
+    typename FitnessFunction,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType
+>
+void HoeffdingTree<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::Activate(const NumericSplitType<FitnessFunction>& numericSplitIn,
+            const CategoricalSplitType<FitnessFunction>& categoricalSplitIn)
+{
+  numericSplits.clear();
+  categoricalSplits.clear();
+  for (size_t i = 0; i < datasetInfo->Dimensionality(); ++i)
+  {
+    if (datasetInfo->Type(i) == data::Datatype::categorical)
+    {
+      categoricalSplits.push_back(CategoricalSplitType<FitnessFunction>(
+          datasetInfo->NumMappings(i), numClasses, categoricalSplitIn));
+    }
+    else
+    {
+      numericSplits.push_back(NumericSplitType<FitnessFunction>(numClasses,
+          numericSplitIn));
+    }
+  }
+
+  // The statistics start over.
+  numSamples = 0;
+  active = true;
+}
+
+template<
+    typename FitnessFunction,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType
+>
+void HoeffdingTree<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::Deactivate()
+{
+  // Swap with empty vectors, so that the memory is actually released.
+  std::vector<NumericSplitType<FitnessFunction>>().swap(numericSplits);
+  std::vector<CategoricalSplitType<FitnessFunction>>().swap(categoricalSplits);
+  active = false;
+}
+
 template<
     typename FitnessFunction,
     template<typename> class NumericSplitType,
@@ -793,10 +1140,15 @@ void HoeffdingTree<
     FitnessFunction,
     NumericSplitType,
     CategoricalSplitType
->::serialize(Archive& ar, const unsigned int /* version */)
+>::serialize(Archive& ar, const unsigned int version)
 {
   ar & BOOST_SERIALIZATION_NVP(splitDimension);
 
+  if (version > 0)
+    ar & BOOST_SERIALIZATION_NVP(maxActiveLeaves);
+  else if (Archive::is_loading::value)
+    maxActiveLeaves = 0;
+
   // Clear memory for the mappings if necessary.
   if (Archive::is_loading::value && ownsMappings && dimensionMappings)
     delete dimensionMappings;
@@ -836,14 +1188,25 @@ void HoeffdingTree<
     ar & BOOST_SERIALIZATION_NVP(maxSamples);
     ar & BOOST_SERIALIZATION_NVP(successProbability);
 
+    if (version > 0)
+    {
+      ar & BOOST_SERIALIZATION_NVP(active);
+      ar & BOOST_SERIALIZATION_NVP(promise);
+    }
+    else if (Archive::is_loading::value)
+    {
+      active = true;
+      promise = 0;
+    }
+
     // Serialize the splits, but not if we haven't seen any samples yet (in
     // which case we can just reinitialize).
     if (Archive::is_loading::value)
     {
-      // Re-initialize all of the splits.
+      // Re-initialize all of the splits (an inactive leaf has none).
       numericSplits.clear();
       categoricalSplits.clear();
-      for (size_t i = 0; i < datasetInfo->Dimensionality(); ++i)
+      for (size_t i = 0; active && i < datasetInfo->Dimensionality(); ++i)
       {
         if (datasetInfo->Type(i) == data::Datatype::categorical)
           categoricalSplits.push_back(CategoricalSplitType<FitnessFunction>(
@@ -0,0 +1,271 @@
+/**
+ * @file methods/kde/gaussian_expansion.hpp
+ *
+ * Definition of the GaussianExpansion class, which holds the far-field
+ * (Hermite) and local (Taylor) series expansions of the Gaussian kernel used by
+ * the fast Gauss transform.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KDE_GAUSSIAN_EXPANSION_HPP
+#define MLPACK_METHODS_KDE_GAUSSIAN_EXPANSION_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/kernels/gaussian_kernel.hpp>
+
+namespace mlpack {
+namespace kde {
+
+/**
+ * The series expansions of the Gaussian kernel
+ * exp(-||x - y||^2 / (2 h^2)) used by the fast Gauss transform (Greengard and
+ * Strain, 1991), with the dual-tree error control of Lee, Gray and Moore
+ * (2006).  All the offsets below are scaled by 1 / (sqrt(2) h), and the terms
+ * of an expansion of order p are the multi-indices alpha with |alpha| < p.
+ *
+ *  - The far-field (Hermite) expansion of a reference node with center c_R
+ *    holds the moments A_alpha = sum_y ((y - c_R)^alpha / alpha!), from which
+ *    the sum of the kernel values at a query point x is
+ *    sum_alpha A_alpha h_alpha(x - c_R), with h_alpha the Hermite functions.
+ *
+ *  - The local (Taylor) expansion around the center c_Q of a query node holds
+ *    the coefficients B_beta, from which the sum of the kernel values at a
+ *    query point x is sum_beta B_beta (x - c_Q)^beta.  They are computed either
+ *    directly from the reference points, or translated from the far-field
+ *    expansion of a reference node.
+ *
+ * The error bounds are derived from Cramer's inequality
+ * |h_n(t)| <= K 2^(n / 2) sqrt(n!), so they only depend on the number of
+ * reference points and on the radius of the nodes: the largest distance along
+ * one dimension between the center of a node and one of its descendants.
+ *
+ * The maximum order is chosen so that expansions have at most MaxTerms terms,
+ * so expansions are most useful in low dimensions.
+ */
+class GaussianExpansion
+{
+ public:
+  //! Largest number of terms of an expansion.
+  static constexpr size_t MaxTerms = 256;
+
+  //! Largest order of an expansion.
+  static constexpr size_t MaxOrderLimit = 10;
+
+  /**
+   * Create the expansions for the given dimensionality and bandwidth.
+   *
+   * @param dimensionality Dimensionality of the points.
+   * @param bandwidth Bandwidth of the Gaussian kernel.
+   */
+  GaussianExpansion(const size_t dimensionality, const double bandwidth);
+
+  //! Get the largest order of an expansion.
+  size_t MaxOrder() const { return maxOrder; }
+
+  //! Get the number of terms of an expansion of the given order.
+  size_t Terms(const size_t order) const { return terms[order]; }
+
+  /**
+   * Add the given reference point to far-field moments of the largest order.
+   *
+   * @param center Center of the expansion.
+   * @param point Reference point.
+   * @param moments Moments, of size Terms(MaxOrder()).
+   */
+  template<typename VecType>
+  void AccumulateMoments(const arma::vec& center,
+                         const VecType& point,
+                         arma::vec& moments) const;
+
+  /**
+   * Add far-field moments around another center (for instance the ones of a
+   * child node) to the given far-field moments.  This is exact.
+   *
+   * @param childCenter Center of the moments to translate.
+   * @param childMoments Moments to translate.
+   * @param center Center of the expansion.
+   * @param moments Moments, of size Terms(MaxOrder()).
+   */
+  void TranslateMoments(const arma::vec& childCenter,
+                        const arma::vec& childMoments,
+                        const arma::vec& center,
+                        arma::vec& moments) const;
+
+  /**
+   * Evaluate the far-field expansion of the given order at a query point.
+   *
+   * @param center Center of the expansion.
+   * @param moments Moments.
+   * @param order Order of the expansion.
+   * @param point Query point.
+   */
+  template<typename VecType>
+  double EvaluateMoments(const arma::vec& center,
+                         const arma::vec& moments,
+                         const size_t order,
+                         const VecType& point) const;
+
+  /**
+   * Add the given reference point to local coefficients, up to the given
+   * order.
+   *
+   * @param center Center of the expansion.
+   * @param point Reference point.
+   * @param order Order of the expansion.
+   * @param coefficients Local coefficients, of size Terms(MaxOrder()).
+   */
+  template<typename VecType>
+  void AccumulateLocal(const arma::vec& center,
+                       const VecType& point,
+                       const size_t order,
+                       arma::vec& coefficients) const;
+
+  /**
+   * Translate a far-field expansion of the given order into local coefficients
+   * of the same order.
+   *
+   * @param referenceCenter Center of the far-field expansion.
+   * @param moments Far-field moments.
+   * @param queryCenter Center of the local expansion.
+   * @param order Order of both expansions.
+   * @param coefficients Local coefficients, of size Terms(MaxOrder()).
+   */
+  void TranslateToLocal(const arma::vec& referenceCenter,
+                        const arma::vec& moments,
+                        const arma::vec& queryCenter,
+                        const size_t order,
+                        arma::vec& coefficients) const;
+
+  /**
+   * Evaluate the local expansion at a query point.
+   *
+   * @param center Center of the expansion.
+   * @param coefficients Local coefficients.
+   * @param point Query point.
+   */
+  template<typename VecType>
+  double EvaluateLocal(const arma::vec& center,
+                       const arma::vec& coefficients,
+                       const VecType& point) const;
+
+  /**
+   * Find the smallest order of the far-field expansion of a reference node
+   * whose error, for each query point, is at most maxError.
+   *
+   * @param numPoints Number of reference points.
+   * @param radius Radius of the reference node.
+   * @param maxError Largest error allowed.
+   * @param error Will hold the bound of the error of the returned order.
+   * @return The order, or 0 if no order is accurate enough.
+   */
+  size_t FarFieldOrder(const size_t numPoints,
+                       const double radius,
+                       const double maxError,
+                       double& error) const;
+
+  /**
+   * Find the smallest order of the local expansion of a query node, computed
+   * directly from the reference points, whose error is at most maxError.
+   *
+   * @param numPoints Number of reference points.
+   * @param radius Radius of the query node.
+   * @param maxError Largest error allowed.
+   * @param error Will hold the bound of the error of the returned order.
+   * @return The order, or 0 if no order is accurate enough.
+   */
+  size_t LocalOrder(const size_t numPoints,
+                    const double radius,
+                    const double maxError,
+                    double& error) const;
+
+  /**
+   * Find the smallest order of the local expansion of a query node, translated
+   * from the far-field expansion of a reference node, whose error is at most
+   * maxError.
+   *
+   * @param numPoints Number of reference points.
+   * @param referenceRadius Radius of the reference node.
+   * @param queryRadius Radius of the query node.
+   * @param maxError Largest error allowed.
+   * @param error Will hold the bound of the error of the returned order.
+   * @return The order, or 0 if no order is accurate enough.
+   */
+  size_t TranslationOrder(const size_t numPoints,
+                          const double referenceRadius,
+                          const double queryRadius,
+                          const double maxError,
+                          double& error) const;
+
+ private:
+  //! Set powers(n, d) to t(d)^n, for n < rows.
+  void Powers(const arma::vec& t, const size_t rows, arma::mat& powers) const;
+
+  //! Set hermite(n, d) to h_n(t(d)), for n < rows.
+  void Hermite(const arma::vec& t, const size_t rows, arma::mat& hermite)
+      const;
+
+  //! Multiply the entries of the table for the given term.
+  double Product(const arma::mat& table, const size_t term) const;
+
+  /**
+   * Set tails(p) to an upper bound of the sum, over the multi-indices alpha of
+   * the given dimensionality with |alpha| >= p, of
+   * prod_d z^alpha_d / sqrt(alpha_d!), for p <= MaxOrder().
+   */
+  void TailBounds(const double z,
+                  const size_t dims,
+                  arma::vec& tails) const;
+
+  //! Find the smallest order whose error bound is at most maxError.
+  size_t SmallestOrder(const arma::vec& errors,
+                       const double maxError,
+                       double& error) const;
+
+  //! Dimensionality of the points.
+  size_t dimensionality;
+  //! Scale of the offsets, 1 / (sqrt(2) h).
+  double scale;
+  //! Largest order of an expansion.
+  size_t maxOrder;
+  //! The number of terms of an expansion of each order.
+  std::vector<size_t> terms;
+  //! The multi-index of each term (one column per term), by total degree.
+  arma::Mat<size_t> indices;
+  //! 1 / alpha! for each term.
+  arma::vec inverseFactorials;
+  //! (-1)^|alpha| / alpha! for each term.
+  arma::vec localFactors;
+  //! For each term alpha, the terms beta <= alpha and alpha - beta.
+  std::vector<std::vector<std::pair<size_t, size_t>>> translations;
+};
+
+/**
+ * Create the series expansions of the given kernel, for points of the given
+ * dimensionality.  Only the Gaussian kernel has series expansions, so this
+ * returns NULL for any other kernel.
+ */
+template<typename KernelType>
+inline GaussianExpansion* NewGaussianExpansion(const KernelType& /* kernel */,
+                                               const size_t /* dims */)
+{
+  return NULL;
+}
+
+//! Create the series expansions of the Gaussian kernel.
+inline GaussianExpansion* NewGaussianExpansion(
+    const kernel::GaussianKernel& kernel,
+    const size_t dims)
+{
+  return new GaussianExpansion(dims, kernel.Bandwidth());
+}
+
+} // namespace kde
+} // namespace mlpack
+
+// Include implementation.
+#include "gaussian_expansion_impl.hpp"
+
+#endif
@@ -0,0 +1,379 @@
+/**
+ * @file methods/kde/gaussian_expansion_impl.hpp
+ *
+ * Implementation of the series expansions of the Gaussian kernel.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KDE_GAUSSIAN_EXPANSION_IMPL_HPP
+#define MLPACK_METHODS_KDE_GAUSSIAN_EXPANSION_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "gaussian_expansion.hpp"
+
+namespace mlpack {
+namespace kde {
+
+inline GaussianExpansion::GaussianExpansion(const size_t dimensionality,
+                                            const double bandwidth) :
+    dimensionality(dimensionality),
+    scale(1.0 / (std::sqrt(2.0) * bandwidth)),
+    maxOrder(1)
+{
+  // Enumerate the multi-indices by total degree, as long as there are not too
+  // many of them.  The multi-indices of the next degree are obtained by
+  // increasing one entry of a multi-index of the last degree; only the entries
+  // from the last nonzero one on are increased, so that each multi-index is
+  // only obtained once.
+  std::vector<std::vector<size_t>> multiIndices(1,
+      std::vector<size_t>(dimensionality, 0));
+  std::vector<std::vector<size_t>> lastDegree(multiIndices);
+  terms.push_back(0);
+  terms.push_back(1);
+  while (maxOrder < MaxOrderLimit)
+  {
+    std::vector<std::vector<size_t>> nextDegree;
+    for (size_t i = 0; i < lastDegree.size(); ++i)
+    {
+      size_t last = 0;
+      for (size_t d = 0; d < dimensionality; ++d)
+        if (lastDegree[i][d] > 0)
+          last = d;
+
+      for (size_t d = last; d < dimensionality; ++d)
+      {
+        nextDegree.push_back(lastDegree[i]);
+        ++nextDegree.back()[d];
+      }
+    }
+
+    if (multiIndices.size() + nextDegree.size() > MaxTerms)
+      break;
+
+    multiIndices.insert(multiIndices.end(), nextDegree.begin(),
+        nextDegree.end());
+    lastDegree.swap(nextDegree);
+    terms.push_back(multiIndices.size());
+    ++maxOrder;
+  }
+
+  const size_t numTerms = multiIndices.size();
+  std::map<std::vector<size_t>, size_t> positions;
+  indices.set_size(dimensionality, numTerms);
+  inverseFactorials.set_size(numTerms);
+  localFactors.set_size(numTerms);
+  for (size_t k = 0; k < numTerms; ++k)
+  {
+    positions[multiIndices[k]] = k;
+
+    double factorial = 1.0;
+    size_t degree = 0;
+    for (size_t d = 0; d < dimensionality; ++d)
+    {
+      indices(d, k) = multiIndices[k][d];
+      factorial *= std::tgamma(multiIndices[k][d] + 1.0);
+      degree += multiIndices[k][d];
+    }
+
+    inverseFactorials[k] = 1.0 / factorial;
+    localFactors[k] = (degree % 2 == 0) ? inverseFactorials[k] :
+        -inverseFactorials[k];
+  }
+
+  // For each multi-index alpha, list the multi-indices beta <= alpha, with
+  // alpha - beta.
+  translations.resize(numTerms);
+  for (size_t k = 0; k < numTerms; ++k)
+  {
+    const std::vector<size_t>& alpha = multiIndices[k];
+    std::vector<size_t> beta(dimensionality, 0);
+    std::vector<size_t> difference(alpha);
+    while (true)
+    {
+      translations[k].push_back(std::make_pair(positions[beta],
+          positions[difference]));
+
+      // Go to the next beta, as with a mixed-radix counter.
+      size_t d = 0;
+      while (d < dimensionality && beta[d] == alpha[d])
+      {
+        beta[d] = 0;
+        difference[d] = alpha[d];
+        ++d;
+      }
+
+      if (d == dimensionality)
+        break;
+
+      ++beta[d];
+      --difference[d];
+    }
+  }
+}
+
+template<typename VecType>
+void GaussianExpansion::AccumulateMoments(const arma::vec& center,
+                                          const VecType& point,
+                                          arma::vec& moments) const
+{
+  const arma::vec offset = scale * (point - center);
+  arma::mat powers;
+  Powers(offset, maxOrder, powers);
+
+  for (size_t k = 0; k < terms[maxOrder]; ++k)
+    moments[k] += inverseFactorials[k] * Product(powers, k);
+}
+
+inline void GaussianExpansion::TranslateMoments(const arma::vec& childCenter,
+                                                const arma::vec& childMoments,
+                                                const arma::vec& center,
+                                                arma::vec& moments) const
+{
+  // (v + w)^alpha / alpha! is the sum over beta <= alpha of
+  // v^beta / beta! * w^(alpha - beta) / (alpha - beta)!.
+  const arma::vec offset = scale * (childCenter - center);
+  arma::mat powers;
+  Powers(offset, maxOrder, powers);
+
+  arma::vec monomials(terms[maxOrder]);
+  for (size_t k = 0; k < terms[maxOrder]; ++k)
+    monomials[k] = inverseFactorials[k] * Product(powers, k);
+
+  for (size_t k = 0; k < terms[maxOrder]; ++k)
+  {
+    for (size_t i = 0; i < translations[k].size(); ++i)
+    {
+      moments[k] += childMoments[translations[k][i].first] *
+          monomials[translations[k][i].second];
+    }
+  }
+}
+
+template<typename VecType>
+double GaussianExpansion::EvaluateMoments(const arma::vec& center,
+                                          const arma::vec& moments,
+                                          const size_t order,
+                                          const VecType& point) const
+{
+  const arma::vec offset = scale * (point - center);
+  arma::mat hermite;
+  Hermite(offset, order, hermite);
+
+  double sum = 0.0;
+  for (size_t k = 0; k < terms[order]; ++k)
+    sum += moments[k] * Product(hermite, k);
+
+  return sum;
+}
+
+template<typename VecType>
+void GaussianExpansion::AccumulateLocal(const arma::vec& center,
+                                        const VecType& point,
+                                        const size_t order,
+                                        arma::vec& coefficients) const
+{
+  const arma::vec offset = scale * (center - point);
+  arma::mat hermite;
+  Hermite(offset, order, hermite);
+
+  for (size_t k = 0; k < terms[order]; ++k)
+    coefficients[k] += localFactors[k] * Product(hermite, k);
+}
+
+inline void GaussianExpansion::TranslateToLocal(
+    const arma::vec& referenceCenter,
+    const arma::vec& moments,
+    const arma::vec& queryCenter,
+    const size_t order,
+    arma::vec& coefficients) const
+{
+  // B_beta = (-1)^|beta| / beta! * sum_alpha A_alpha h_(alpha + beta)(s), with
+  // s the offset between the centers.
+  const arma::vec offset = scale * (queryCenter - referenceCenter);
+  arma::mat hermite;
+  Hermite(offset, 2 * order - 1, hermite);
+
+  for (size_t b = 0; b < terms[order]; ++b)
+  {
+    double sum = 0.0;
+    for (size_t a = 0; a < terms[order]; ++a)
+    {
+      double product = moments[a];
+      for (size_t d = 0; d < dimensionality; ++d)
+        product *= hermite(indices(d, a) + indices(d, b), d);
+      sum += product;
+    }
+
+    coefficients[b] += localFactors[b] * sum;
+  }
+}
+
+template<typename VecType>
+double GaussianExpansion::EvaluateLocal(const arma::vec& center,
+                                        const arma::vec& coefficients,
+                                        const VecType& point) const
+{
+  const arma::vec offset = scale * (point - center);
+  arma::mat powers;
+  Powers(offset, maxOrder, powers);
+
+  double sum = 0.0;
+  for (size_t k = 0; k < coefficients.n_elem; ++k)
+    sum += coefficients[k] * Product(powers, k);
+
+  return sum;
+}
+
+inline size_t GaussianExpansion::FarFieldOrder(const size_t numPoints,
+                                               const double radius,
+                                               const double maxError,
+                                               double& error) const
+{
+  // |h_alpha(t)| <= K^D 2^(|alpha| / 2) sqrt(alpha!) and
+  // |A_alpha| <= N r^|alpha| / alpha!, with r the scaled radius.
+  arma::vec tails;
+  TailBounds(std::sqrt(2.0) * scale * radius, dimensionality, tails);
+
+  const double cramer = std::pow(1.09, (double) dimensionality);
+  return SmallestOrder(numPoints * cramer * tails, maxError, error);
+}
+
+inline size_t GaussianExpansion::LocalOrder(const size_t numPoints,
+                                            const double radius,
+                                            const double maxError,
+                                            double& error) const
+{
+  // The terms left out are bounded like the ones of the far-field expansion,
+  // with the radius of the query node.
+  return FarFieldOrder(numPoints, radius, maxError, error);
+}
+
+inline size_t GaussianExpansion::TranslationOrder(const size_t numPoints,
+                                                  const double referenceRadius,
+                                                  const double queryRadius,
+                                                  const double maxError,
+                                                  double& error) const
+{
+  // The error is at most the one of the local expansion computed directly,
+  // plus the one of the far-field moments left out of the translation, which
+  // is bounded with sqrt((alpha + beta)!) <= 2^(|alpha + beta| / 2)
+  // sqrt(alpha! beta!).
+  arma::vec localTails, queryTails, referenceTails;
+  TailBounds(std::sqrt(2.0) * scale * queryRadius, dimensionality,
+      localTails);
+  TailBounds(2.0 * scale * queryRadius, 1, queryTails);
+  TailBounds(2.0 * scale * referenceRadius, dimensionality, referenceTails);
+
+  const double cramer = std::pow(1.09, (double) dimensionality);
+  const double querySum = std::pow(queryTails[0], (double) dimensionality);
+  return SmallestOrder(numPoints * cramer *
+      (localTails + querySum * referenceTails), maxError, error);
+}
+
+inline void GaussianExpansion::Powers(const arma::vec& t,
+                                      const size_t rows,
+                                      arma::mat& powers) const
+{
+  powers.set_size(rows, dimensionality);
+  powers.row(0).ones();
+  for (size_t n = 1; n < rows; ++n)
+    powers.row(n) = powers.row(n - 1) % t.t();
+}
+
+inline void GaussianExpansion::Hermite(const arma::vec& t,
+                                       const size_t rows,
+                                       arma::mat& hermite) const
+{
+  // h_0(t) = exp(-t^2), h_1(t) = 2 t h_0(t), and
+  // h_(n + 1)(t) = 2 t h_n(t) - 2 n h_(n - 1)(t).
+  hermite.set_size(std::max(rows, (size_t) 2), dimensionality);
+  hermite.row(0) = arma::exp(-arma::square(t)).t();
+  hermite.row(1) = 2 * t.t() % hermite.row(0);
+  for (size_t n = 1; n + 1 < rows; ++n)
+  {
+    hermite.row(n + 1) = 2 * t.t() % hermite.row(n) -
+        2.0 * n * hermite.row(n - 1);
+  }
+}
+
+inline double GaussianExpansion::Product(const arma::mat& table,
+                                         const size_t term) const
+{
+  double product = 1.0;
+  for (size_t d = 0; d < dimensionality; ++d)
+    product *= table(indices(d, term), d);
+
+  return product;
+}
+
+inline void GaussianExpansion::TailBounds(const double z,
+                                          const size_t dims,
+                                          arma::vec& tails) const
+{
+  // With alpha! >= |alpha|! / D^|alpha|, the sum over the multi-indices of
+  // degree n is at most t_n = C(n + D - 1, D - 1) (z sqrt(D))^n / sqrt(n!).
+  tails.zeros(maxOrder + 1);
+  const double x = z * std::sqrt((double) dims);
+  if (x == 0.0)
+  {
+    tails[0] = 1.0;
+    return;
+  }
+
+  const double logX = std::log(x);
+  auto term = [&](const size_t n)
+  {
+    return std::exp(std::lgamma(n + (double) dims) -
+        std::lgamma((double) dims) - 1.5 * std::lgamma(n + 1.0) + n * logX);
+  };
+
+  // The ratio t_(n + 1) / t_n decreases with n, so once it is at most 1/2, the
+  // rest of the sum is at most t_n.
+  double rest = 0.0;
+  for (size_t n = maxOrder; ; ++n)
+  {
+    const double t = term(n);
+    rest += t;
+
+    const double ratio = (n + (double) dims) / (n + 1.0) * x /
+        std::sqrt(n + 1.0);
+    if (ratio <= 0.5)
+    {
+      rest += t;
+      break;
+    }
+    else if (n > maxOrder + 10000)
+    {
+      rest = DBL_MAX;
+      break;
+    }
+  }
+
+  tails[maxOrder] = rest;
+  for (size_t p = maxOrder; p > 0; --p)
+    tails[p - 1] = tails[p] + term(p - 1);
+}
+
+inline size_t GaussianExpansion::SmallestOrder(const arma::vec& errors,
+                                               const double maxError,
+                                               double& error) const
+{
+  for (size_t p = 1; p <= maxOrder; ++p)
+  {
+    if (errors[p] <= maxError)
+    {
+      error = errors[p];
+      return p;
+    }
+  }
+
+  return 0;
+}
+
+} // namespace kde
+} // namespace mlpack
+
+#endif
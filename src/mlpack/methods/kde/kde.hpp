@@ -15,8 +15,11 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/tree/binary_space_tree.hpp>
+#include <mlpack/core/tree/traversal_statistics.hpp>
+#include <mlpack/core/tree/is_dynamic_tree.hpp>
 
 #include "kde_stat.hpp"
+#include "gaussian_expansion.hpp"
 
 namespace mlpack {
 namespace kde /** Kernel Density Estimation. */ {
@@ -55,6 +58,9 @@ struct KDEDefaultParams
 
   //! Monte Carlo break coefficient.
   static constexpr double mcBreakCoef = 0.4;
+
+  //! Whether to use series expansions of the Gaussian kernel when possible.
+  static constexpr bool seriesExpansion = false;
 };
 
 /**
@@ -63,6 +69,9 @@ struct KDEDefaultParams
  * probability density function of a variable in a non parametric way.
  * This implementation performs this estimation using a tree-independent
  * dual-tree algorithm. Details about this algorithm are available in KDERules.
+ * Evaluations are parallelized with OpenMP: subtrees of the query tree (or
+ * query points, in single-tree mode) are handled by different threads, each
+ * with its own share of the error budget.
  *
  * @tparam KernelType Kernel function to use for KDE calculations.
  * @tparam MetricType Metric to use for KDE calculations.
@@ -110,6 +119,8 @@ class KDE
    * @param mcBreakCoef Coefficient to control what fraction of the node's
    *                    descendants evaluated is the limit before Monte Carlo
    *                    estimation recurses.
+   * @param seriesExpansion Whether to use series expansions of the Gaussian
+   *                        kernel (fast Gauss transform) when possible.
    */
   KDE(const double relError = KDEDefaultParams::relError,
       const double absError = KDEDefaultParams::absError,
@@ -120,7 +131,8 @@ class KDE
       const double mcProb = KDEDefaultParams::mcProb,
       const size_t initialSampleSize = KDEDefaultParams::initialSampleSize,
       const double mcEntryCoef = KDEDefaultParams::mcEntryCoef,
-      const double mcBreakCoef = KDEDefaultParams::mcBreakCoef);
+      const double mcBreakCoef = KDEDefaultParams::mcBreakCoef,
+      const bool seriesExpansion = KDEDefaultParams::seriesExpansion);
 
   /**
    * Construct KDE object as a copy of the given model. This may be
@@ -173,6 +185,19 @@ class KDE
    */
   void Train(Tree* referenceTree, std::vector<size_t>* oldFromNewReferences);
 
+  /**
+   * Add the given points to the reference set of the trained model.  If the
+   * tree supports dynamic insertion (like RectangleTree), the points are
+   * inserted into the current reference tree, which is much cheaper than
+   * rebuilding it; otherwise the reference tree is rebuilt with all the points.
+   * If the reference tree was given to Train() and supports dynamic insertion,
+   * that tree (and its dataset) is modified.
+   *
+   * @pre The model has to be previously trained.
+   * @param points Points to add to the reference set.
+   */
+  void Insert(const MatType& points);
+
   /**
    * Estimate density of each point in the query set given the data of the
    * reference set. The result is stored in an estimations vector.
@@ -194,6 +219,10 @@ class KDE
    * already created query tree. The result is stored in an estimations vector.
    * Estimations might not be normalized.
    *
+   * - The query tree is not modified (except for its statistics), so the same
+   *   query tree can be built once and used for many evaluations, even after
+   *   the reference set changes.
+   *
    * - Dimension of each point in the queryTree dataset must match the dimension
    *    of each point in the reference set.
    *
@@ -290,6 +319,18 @@ class KDE
   //! Modify Monte Carlo break coefficient. (0 < newCoef <= 1).
   void MCBreakCoef(const double newCoef);
 
+  //! Get whether series expansions of the Gaussian kernel are being used or
+  //! not.
+  bool SeriesExpansion() const { return seriesExpansion; }
+
+  //! Modify whether series expansions of the Gaussian kernel are being used or
+  //! not.  They are only used in dual-tree mode, with the Gaussian kernel and
+  //! the Euclidean distance.
+  bool& SeriesExpansion() { return seriesExpansion; }
+
+  //! Get the statistics of the tree traversals of the last evaluation.
+  const tree::TraversalStatistics& Statistics() const { return statistics; }
+
   //! Serialize the model.
   template<typename Archive>
   void serialize(Archive& ar, const unsigned int version);
@@ -341,9 +382,102 @@ class KDE
   //! is the limit before Monte Carlo estimation recurses.
   double mcBreakCoef;
 
+  //! If true series expansions of the Gaussian kernel will be used when
+  //! possible.
+  bool seriesExpansion;
+
+  //! The statistics of the tree traversals of the last evaluation.
+  tree::TraversalStatistics statistics;
+
+  /**
+   * Compute the estimations of the points of the query tree with the dual-tree
+   * algorithm.  The query tree is split into subtrees that are traversed in
+   * parallel with OpenMP.  Each query point belongs to exactly one subtree, and
+   * its leftover error tolerance and Monte Carlo alpha are only kept in that
+   * subtree, so the error bounds and confidence still hold.
+   *
+   * @param queryTree Tree of query points (may be the reference tree).
+   * @param estimations Unnormalized estimations, which must be zero.
+   * @param sameSet Whether the query tree is the reference tree.
+   * @param scores Will hold the number of scores.
+   * @param baseCases Will hold the number of base cases.
+   */
+  void DualTreeEvaluate(Tree* queryTree,
+                        arma::vec& estimations,
+                        const bool sameSet,
+                        size_t& scores,
+                        size_t& baseCases);
+
+  /**
+   * Compute the estimations of the query points with the single-tree
+   * algorithm.  The query points are handled in parallel with OpenMP, and the
+   * leftover error tolerance and Monte Carlo alpha of each query point are only
+   * used by the thread handling it.
+   *
+   * @param querySet Set of query points (may be the reference set).
+   * @param estimations Unnormalized estimations, which must be zero.
+   * @param sameSet Whether the query set is the reference set.
+   * @param scores Will hold the number of scores.
+   * @param baseCases Will hold the number of base cases.
+   */
+  void SingleTreeEvaluate(const MatType& querySet,
+                          arma::vec& estimations,
+                          const bool sameSet,
+                          size_t& scores,
+                          size_t& baseCases);
+
+  //! Reset the error tolerance and Monte Carlo alpha accumulated in the given
+  //! tree during earlier evaluations.
+  static void CleanTree(Tree* tree);
+
+  //! Set the Monte Carlo alpha of each node of the reference tree, so that the
+  //! reference tree is not modified during parallel traversals.  The root gets
+  //! an alpha of 1 - mcProb, which is split evenly between children.
+  void InitializeAlpha(Tree* node, const double alpha) const;
+
+  /**
+   * Compute the center and radius of the series expansions of each node of the
+   * given tree and, if requested, the far-field moments of the nodes that have
+   * more descendants than an expansion has terms.  The moments of a node are
+   * translated from the ones of its children when possible.
+   *
+   * @param node Root of the tree.
+   * @param expansion Series expansions of the kernel.
+   * @param moments Whether to compute the far-field moments.
+   */
+  static void InitializeExpansion(Tree* node,
+                                  const GaussianExpansion& expansion,
+                                  const bool moments);
+
+  //! Add the local expansions accumulated in the nodes of the given query tree
+  //! to the estimations of their descendants, and empty them.
+  static void EvaluateLocal(Tree* node,
+                            const GaussianExpansion& expansion,
+                            arma::vec& estimations);
+
+  //! Free the far-field moments of the nodes of the given tree.
+  static void ClearMoments(Tree* node);
+
+  //! Split the given tree into disjoint subtrees that hold all its points, for
+  //! parallel traversals.
+  static void SplitTree(Tree* tree, std::vector<Tree*>& subtrees);
+
   //! Check whether absolute and relative error values are compatible.
   static void CheckErrorValues(const double relError, const double absError);
 
+  //! Insert points into a reference tree that supports dynamic insertion.
+  template<typename T = Tree>
+  void InsertIntoTree(
+      const MatType& points,
+      const typename std::enable_if_t<tree::IsDynamicTree<T>::value>* = 0);
+
+  //! Insert points by rebuilding a reference tree that doesn't support dynamic
+  //! insertion.
+  template<typename T = Tree>
+  void InsertIntoTree(
+      const MatType& points,
+      const typename std::enable_if_t<!tree::IsDynamicTree<T>::value>* = 0);
+
   //! Rearrange estimations vector if required.
   static void RearrangeEstimations(const std::vector<size_t>& oldFromNew,
                                    arma::vec& estimations);
@@ -377,7 +511,7 @@ struct version<mlpack::kde::KDE<KernelType,
                                 DualTreeTraversalType,
                                 SingleTreeTraversalType>>
 {
-  typedef mpl::int_<1> type;
+  typedef mpl::int_<2> type;
   typedef mpl::integral_c_tag tag;
   BOOST_STATIC_CONSTANT(int, value = version::type::value);
   BOOST_MPL_ASSERT((boost::mpl::less<boost::mpl::int_<1>,
@@ -61,7 +61,8 @@ KDE(const double relError,
     const double mcProb,
     const size_t initialSampleSize,
     const double mcEntryCoef,
-    const double mcBreakCoef) :
+    const double mcBreakCoef,
+    const bool seriesExpansion) :
     kernel(kernel),
     metric(metric),
     referenceTree(nullptr),
@@ -72,7 +73,8 @@ KDE(const double relError,
     trained(false),
     mode(mode),
     monteCarlo(monteCarlo),
-    initialSampleSize(initialSampleSize)
+    initialSampleSize(initialSampleSize),
+    seriesExpansion(seriesExpansion)
 {
   CheckErrorValues(relError, absError);
   MCProb(mcProb);
@@ -106,7 +108,9 @@ KDE(const KDE& other) :
     mcProb(other.mcProb),
     initialSampleSize(other.initialSampleSize),
     mcEntryCoef(other.mcEntryCoef),
-    mcBreakCoef(other.mcBreakCoef)
+    mcBreakCoef(other.mcBreakCoef),
+    seriesExpansion(other.seriesExpansion),
+    statistics(other.statistics)
 {
   if (trained)
   {
@@ -152,7 +156,9 @@ KDE(KDE&& other) :
     mcProb(other.mcProb),
     initialSampleSize(other.initialSampleSize),
     mcEntryCoef(other.mcEntryCoef),
-    mcBreakCoef(other.mcBreakCoef)
+    mcBreakCoef(other.mcBreakCoef),
+    seriesExpansion(other.seriesExpansion),
+    statistics(other.statistics)
 {
   other.kernel = std::move(KernelType());
   other.metric = std::move(MetricType());
@@ -168,6 +174,8 @@ KDE(KDE&& other) :
   other.initialSampleSize = KDEDefaultParams::initialSampleSize;
   other.mcEntryCoef = KDEDefaultParams::mcEntryCoef;
   other.mcBreakCoef = KDEDefaultParams::mcBreakCoef;
+  other.seriesExpansion = KDEDefaultParams::seriesExpansion;
+  other.statistics.Reset();
 }
 
 template<typename KernelType,
@@ -214,6 +222,8 @@ operator=(KDE other)
   this->initialSampleSize = other.initialSampleSize;
   this->mcEntryCoef = other.mcEntryCoef;
   this->mcBreakCoef = other.mcBreakCoef;
+  this->seriesExpansion = other.seriesExpansion;
+  this->statistics = other.statistics;
 
   return *this;
 }
@@ -314,6 +324,44 @@ Train(Tree* referenceTree, std::vector<size_t>* oldFromNewReferences)
   this->trained = true;
 }
 
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void KDE<KernelType,
+         MetricType,
+         MatType,
+         TreeType,
+         DualTreeTraversalType,
+         SingleTreeTraversalType>::
+Insert(const MatType& points)
+{
+  // Check whether has already been trained.
+  if (!trained)
+  {
+    throw std::runtime_error("cannot insert points into KDE model: model "
+                             "needs to be trained before insertion");
+  }
+
+  // Check whether dimensions match.
+  if (points.n_rows != referenceTree->Dataset().n_rows)
+  {
+    throw std::invalid_argument("cannot insert points into KDE model: points "
+                                "and referenceSet dimensions don't match");
+  }
+
+  if (points.n_cols == 0)
+    return;
+
+  Timer::Start("inserting_reference_points");
+  InsertIntoTree(points);
+  Timer::Stop("inserting_reference_points");
+}
+
 template<typename KernelType,
          typename MetricType,
          typename MatType,
@@ -380,35 +428,15 @@ Evaluate(MatType querySet, arma::vec& estimations)
     Timer::Start("computing_kde");
 
     // Evaluate.
-    typedef KDERules<MetricType, KernelType, Tree> RuleType;
-    RuleType rules = RuleType(referenceTree->Dataset(),
-                              querySet,
-                              estimations,
-                              relError,
-                              absError,
-                              mcProb,
-                              initialSampleSize,
-                              mcEntryCoef,
-                              mcBreakCoef,
-                              metric,
-                              kernel,
-                              monteCarlo,
-                              false);
-
-    // Create traverser.
-    SingleTreeTraversalType<RuleType> traverser(rules);
-
-    // Traverse for each point.
-    for (size_t i = 0; i < querySet.n_cols; ++i)
-      traverser.Traverse(i, *referenceTree);
+    size_t scores, baseCases;
+    SingleTreeEvaluate(querySet, estimations, false, scores, baseCases);
 
     estimations /= referenceTree->Dataset().n_cols;
     Timer::Stop("computing_kde");
 
-    Log::Info << rules.Scores() << " node combinations were scored."
-              << std::endl;
-    Log::Info << rules.BaseCases() << " base cases were calculated."
-              << std::endl;
+    Log::Info << scores << " node combinations were scored." << std::endl;
+    Log::Info << baseCases << " base cases were calculated." << std::endl;
+    statistics.Print(Log::Info);
   }
 }
 
@@ -465,45 +493,25 @@ Evaluate(Tree* queryTree,
                                 "dual-tree");
   }
 
-  // Clean accumulated alpha if Monte Carlo estimations are available.
-  if (monteCarlo && std::is_same<KernelType, kernel::GaussianKernel>::value)
-  {
-    Timer::Start("cleaning_query_tree");
-    KDECleanRules<Tree> cleanRules;
-    SingleTreeTraversalType<KDECleanRules<Tree>> cleanTraverser(cleanRules);
-    cleanTraverser.Traverse(0, *queryTree);
-    Timer::Stop("cleaning_query_tree");
-  }
+  // Clean the error tolerance and alpha accumulated in earlier evaluations.
+  Timer::Start("cleaning_query_tree");
+  CleanTree(queryTree);
+  Timer::Stop("cleaning_query_tree");
 
   Timer::Start("computing_kde");
 
   // Evaluate.
-  typedef KDERules<MetricType, KernelType, Tree> RuleType;
-  RuleType rules = RuleType(referenceTree->Dataset(),
-                            queryTree->Dataset(),
-                            estimations,
-                            relError,
-                            absError,
-                            mcProb,
-                            initialSampleSize,
-                            mcEntryCoef,
-                            mcBreakCoef,
-                            metric,
-                            kernel,
-                            monteCarlo,
-                            false);
-
-  // Create traverser.
-  DualTreeTraversalType<RuleType> traverser(rules);
-  traverser.Traverse(*queryTree, *referenceTree);
+  size_t scores, baseCases;
+  DualTreeEvaluate(queryTree, estimations, false, scores, baseCases);
   estimations /= referenceTree->Dataset().n_cols;
   Timer::Stop("computing_kde");
 
   // Rearrange if necessary.
   RearrangeEstimations(oldFromNewQueries, estimations);
 
-  Log::Info << rules.Scores() << " node combinations were scored." << std::endl;
-  Log::Info << rules.BaseCases() << " base cases were calculated." << std::endl;
+  Log::Info << scores << " node combinations were scored." << std::endl;
+  Log::Info << baseCases << " base cases were calculated." << std::endl;
+  statistics.Print(Log::Info);
 }
 
 template<typename KernelType,
@@ -534,45 +542,23 @@ Evaluate(arma::vec& estimations)
   estimations.set_size(referenceTree->Dataset().n_cols);
   estimations.fill(arma::fill::zeros);
 
-  // Clean accumulated alpha if Monte Carlo estimations are available.
-  if (monteCarlo && std::is_same<KernelType, kernel::GaussianKernel>::value)
-  {
-    Timer::Start("cleaning_query_tree");
-    KDECleanRules<Tree> cleanRules;
-    SingleTreeTraversalType<KDECleanRules<Tree>> cleanTraverser(cleanRules);
-    cleanTraverser.Traverse(0, *referenceTree);
-    Timer::Stop("cleaning_query_tree");
-  }
+  // Clean the error tolerance and alpha accumulated in earlier evaluations.
+  Timer::Start("cleaning_query_tree");
+  CleanTree(referenceTree);
+  Timer::Stop("cleaning_query_tree");
 
   Timer::Start("computing_kde");
 
   // Evaluate.
-  typedef KDERules<MetricType, KernelType, Tree> RuleType;
-  RuleType rules = RuleType(referenceTree->Dataset(),
-                            referenceTree->Dataset(),
-                            estimations,
-                            relError,
-                            absError,
-                            mcProb,
-                            initialSampleSize,
-                            mcEntryCoef,
-                            mcBreakCoef,
-                            metric,
-                            kernel,
-                            monteCarlo,
-                            true);
-
+  size_t scores = 0, baseCases = 0;
   if (mode == DUAL_TREE_MODE)
   {
-    // Create traverser.
-    DualTreeTraversalType<RuleType> traverser(rules);
-    traverser.Traverse(*referenceTree, *referenceTree);
+    DualTreeEvaluate(referenceTree, estimations, true, scores, baseCases);
   }
   else if (mode == SINGLE_TREE_MODE)
   {
-    SingleTreeTraversalType<RuleType> traverser(rules);
-    for (size_t i = 0; i < referenceTree->Dataset().n_cols; ++i)
-      traverser.Traverse(i, *referenceTree);
+    SingleTreeEvaluate(referenceTree->Dataset(), estimations, true, scores,
+        baseCases);
   }
 
   estimations /= referenceTree->Dataset().n_cols;
@@ -580,8 +566,9 @@ Evaluate(arma::vec& estimations)
   RearrangeEstimations(*oldFromNewReferences, estimations);
   Timer::Stop("computing_kde");
 
-  Log::Info << rules.Scores() << " node combinations were scored." << std::endl;
-  Log::Info << rules.BaseCases() << " base cases were calculated." << std::endl;
+  Log::Info << scores << " node combinations were scored." << std::endl;
+  Log::Info << baseCases << " base cases were calculated." << std::endl;
+  statistics.Print(Log::Info);
 }
 
 template<typename KernelType,
@@ -739,6 +726,13 @@ serialize(Archive& ar, const unsigned int version)
     mcBreakCoef = KDEDefaultParams::mcBreakCoef;
   }
 
+  // Backward compatibility: Old versions of KDE did not have series
+  // expansions.
+  if (version > 1)
+    ar & BOOST_SERIALIZATION_NVP(seriesExpansion);
+  else if (Archive::is_loading::value)
+    seriesExpansion = KDEDefaultParams::seriesExpansion;
+
   // If we are loading, clean up memory if necessary.
   if (Archive::is_loading::value)
   {
@@ -758,6 +752,467 @@ serialize(Archive& ar, const unsigned int version)
   ar & BOOST_SERIALIZATION_NVP(oldFromNewReferences);
 }
 
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void KDE<KernelType,
+         MetricType,
+         MatType,
+         TreeType,
+         DualTreeTraversalType,
+         SingleTreeTraversalType>::
+DualTreeEvaluate(Tree* queryTree,
+                 arma::vec& estimations,
+                 const bool sameSet,
+                 size_t& scores,
+                 size_t& baseCases)
+{
+  typedef KDERules<MetricType, KernelType, Tree> RuleType;
+  const bool useMonteCarlo = monteCarlo &&
+      std::is_same<KernelType, kernel::GaussianKernel>::value;
+
+  // Reference nodes are shared between threads, so their alpha is computed
+  // before the traversal.
+  if (useMonteCarlo)
+    InitializeAlpha(referenceTree, 1 - mcProb);
+
+  // The series expansions are only available for the Gaussian kernel with the
+  // Euclidean distance.  The moments of the reference nodes are also computed
+  // before the traversal.
+  std::unique_ptr<GaussianExpansion> expansion;
+  if (seriesExpansion &&
+      std::is_same<MetricType, metric::EuclideanDistance>::value)
+  {
+    expansion.reset(NewGaussianExpansion(kernel,
+        referenceTree->Dataset().n_rows));
+  }
+
+  if (expansion)
+  {
+    InitializeExpansion(referenceTree, *expansion, true);
+    if (queryTree != referenceTree)
+      InitializeExpansion(queryTree, *expansion, false);
+  }
+
+  std::vector<Tree*> queryNodes;
+  SplitTree(queryTree, queryNodes);
+
+  // The leftover error tolerance and Monte Carlo alpha of each query point,
+  // shared by all threads; each entry is only used by the thread handling that
+  // query point.
+  const size_t numQueries = queryTree->Dataset().n_cols;
+  arma::vec accumError(numQueries, arma::fill::zeros);
+  arma::vec accumMCAlpha(useMonteCarlo ? numQueries : 0, arma::fill::zeros);
+
+  // Each thread draws its Monte Carlo samples from its own generator.
+  #ifdef HAS_OPENMP
+  const size_t numThreads = omp_get_max_threads();
+  #else
+  const size_t numThreads = 1;
+  #endif
+  std::vector<size_t> seeds(numThreads);
+  for (size_t i = 0; i < numThreads; ++i)
+    seeds[i] = math::RandInt(std::numeric_limits<int>::max());
+
+  scores = 0;
+  baseCases = 0;
+  statistics.Reset();
+  #pragma omp parallel reduction(+:scores, baseCases) \
+      if (queryNodes.size() > 1)
+  {
+    #ifdef HAS_OPENMP
+    const size_t seed = seeds[omp_get_thread_num()];
+    #else
+    const size_t seed = seeds[0];
+    #endif
+
+    RuleType rules(referenceTree->Dataset(),
+                   queryTree->Dataset(),
+                   estimations,
+                   accumError,
+                   accumMCAlpha,
+                   relError,
+                   absError,
+                   mcProb,
+                   initialSampleSize,
+                   mcEntryCoef,
+                   mcBreakCoef,
+                   metric,
+                   kernel,
+                   monteCarlo,
+                   sameSet,
+                   seed,
+                   expansion.get());
+    tree::TraversalStatistics threadStatistics;
+    tree::CountingRules<RuleType> countingRules(rules, threadStatistics);
+    DualTreeTraversalType<tree::CountingRules<RuleType>>
+        traverser(countingRules);
+
+    // Each subtree of the query tree is traversed against the whole reference
+    // tree by one thread.  The subtrees are disjoint, so the estimations and
+    // the error tolerance accumulated in the query nodes are never shared.
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t i = 0; i < (omp_size_t) queryNodes.size(); ++i)
+      traverser.Traverse(*queryNodes[i], *referenceTree);
+
+    scores += rules.Scores();
+    baseCases += rules.BaseCases();
+
+    #pragma omp critical(KDEStatistics)
+    statistics += threadStatistics;
+  }
+
+  if (expansion)
+  {
+    // The local expansions were only accumulated in the nodes of the
+    // subtrees, so each subtree can be evaluated by a different thread.
+    #pragma omp parallel for schedule(dynamic) if (queryNodes.size() > 1)
+    for (omp_size_t i = 0; i < (omp_size_t) queryNodes.size(); ++i)
+      EvaluateLocal(queryNodes[i], *expansion, estimations);
+
+    ClearMoments(referenceTree);
+  }
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void KDE<KernelType,
+         MetricType,
+         MatType,
+         TreeType,
+         DualTreeTraversalType,
+         SingleTreeTraversalType>::
+SingleTreeEvaluate(const MatType& querySet,
+                   arma::vec& estimations,
+                   const bool sameSet,
+                   size_t& scores,
+                   size_t& baseCases)
+{
+  typedef KDERules<MetricType, KernelType, Tree> RuleType;
+  const bool useMonteCarlo = monteCarlo &&
+      std::is_same<KernelType, kernel::GaussianKernel>::value;
+
+  // Reference nodes are shared between threads, so their alpha is computed
+  // before the traversal.
+  if (useMonteCarlo)
+    InitializeAlpha(referenceTree, 1 - mcProb);
+
+  // The leftover error tolerance and Monte Carlo alpha of each query point,
+  // shared by all threads; each entry is only used by the thread handling that
+  // query point.
+  arma::vec accumError(querySet.n_cols, arma::fill::zeros);
+  arma::vec accumMCAlpha(useMonteCarlo ? querySet.n_cols : 0,
+      arma::fill::zeros);
+
+  // Each thread draws its Monte Carlo samples from its own generator.
+  #ifdef HAS_OPENMP
+  const size_t numThreads = omp_get_max_threads();
+  #else
+  const size_t numThreads = 1;
+  #endif
+  std::vector<size_t> seeds(numThreads);
+  for (size_t i = 0; i < numThreads; ++i)
+    seeds[i] = math::RandInt(std::numeric_limits<int>::max());
+
+  scores = 0;
+  baseCases = 0;
+  statistics.Reset();
+  #pragma omp parallel reduction(+:scores, baseCases)
+  {
+    #ifdef HAS_OPENMP
+    const size_t seed = seeds[omp_get_thread_num()];
+    #else
+    const size_t seed = seeds[0];
+    #endif
+
+    RuleType rules(referenceTree->Dataset(),
+                   querySet,
+                   estimations,
+                   accumError,
+                   accumMCAlpha,
+                   relError,
+                   absError,
+                   mcProb,
+                   initialSampleSize,
+                   mcEntryCoef,
+                   mcBreakCoef,
+                   metric,
+                   kernel,
+                   monteCarlo,
+                   sameSet,
+                   seed);
+    tree::TraversalStatistics threadStatistics;
+    tree::CountingRules<RuleType> countingRules(rules, threadStatistics);
+    SingleTreeTraversalType<tree::CountingRules<RuleType>>
+        traverser(countingRules);
+
+    // Traverse for each point.
+    #pragma omp for schedule(dynamic, 64)
+    for (omp_size_t i = 0; i < (omp_size_t) querySet.n_cols; ++i)
+      traverser.Traverse(i, *referenceTree);
+
+    scores += rules.Scores();
+    baseCases += rules.BaseCases();
+
+    #pragma omp critical(KDEStatistics)
+    statistics += threadStatistics;
+  }
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void KDE<KernelType,
+         MetricType,
+         MatType,
+         TreeType,
+         DualTreeTraversalType,
+         SingleTreeTraversalType>::
+InitializeAlpha(Tree* node, const double alpha) const
+{
+  node->Stat().MCAlpha() = alpha;
+  node->Stat().MCBeta() = 1 - mcProb;
+
+  for (size_t i = 0; i < node->NumChildren(); ++i)
+    InitializeAlpha(&node->Child(i), alpha / node->NumChildren());
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void KDE<KernelType,
+         MetricType,
+         MatType,
+         TreeType,
+         DualTreeTraversalType,
+         SingleTreeTraversalType>::
+CleanTree(Tree* tree)
+{
+  KDECleanRules<Tree> cleanRules;
+  SingleTreeTraversalType<KDECleanRules<Tree>> cleanTraverser(cleanRules);
+  cleanTraverser.Traverse(0, *tree);
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void KDE<KernelType,
+         MetricType,
+         MatType,
+         TreeType,
+         DualTreeTraversalType,
+         SingleTreeTraversalType>::
+InitializeExpansion(Tree* node,
+                    const GaussianExpansion& expansion,
+                    const bool moments)
+{
+  KDEStat& stat = node->Stat();
+  const MatType& dataset = node->Dataset();
+  arma::vec& center = stat.ExpansionCenter();
+  node->Center(center);
+
+  // The radius is bounded with the radius of the children, so that the
+  // descendants are not visited again.
+  double radius = 0.0;
+  for (size_t i = 0; i < node->NumPoints(); ++i)
+  {
+    radius = std::max(radius,
+        arma::max(arma::abs(dataset.col(node->Point(i)) - center)));
+  }
+
+  for (size_t i = 0; i < node->NumChildren(); ++i)
+  {
+    InitializeExpansion(&node->Child(i), expansion, moments);
+    const KDEStat& childStat = node->Child(i).Stat();
+    radius = std::max(radius, childStat.ExpansionRadius() +
+        arma::max(arma::abs(childStat.ExpansionCenter() - center)));
+  }
+  stat.ExpansionRadius() = radius;
+
+  // The far-field expansion of a node is only useful if it has fewer terms
+  // than the node has descendants.
+  const size_t numTerms = expansion.Terms(expansion.MaxOrder());
+  if (!moments || node->NumDescendants() <= numTerms)
+  {
+    stat.Moments().reset();
+    return;
+  }
+
+  stat.Moments().zeros(numTerms);
+  if (tree::TreeTraits<Tree>::HasSelfChildren ||
+      tree::TreeTraits<Tree>::HasDuplicatedPoints)
+  {
+    // The points of the node may also be held by its children.
+    for (size_t i = 0; i < node->NumDescendants(); ++i)
+    {
+      expansion.AccumulateMoments(center, dataset.col(node->Descendant(i)),
+          stat.Moments());
+    }
+    return;
+  }
+
+  for (size_t i = 0; i < node->NumPoints(); ++i)
+  {
+    expansion.AccumulateMoments(center, dataset.col(node->Point(i)),
+        stat.Moments());
+  }
+
+  for (size_t i = 0; i < node->NumChildren(); ++i)
+  {
+    Tree& child = node->Child(i);
+    if (!child.Stat().Moments().is_empty())
+    {
+      expansion.TranslateMoments(child.Stat().ExpansionCenter(),
+          child.Stat().Moments(), center, stat.Moments());
+    }
+    else
+    {
+      for (size_t j = 0; j < child.NumDescendants(); ++j)
+      {
+        expansion.AccumulateMoments(center, dataset.col(child.Descendant(j)),
+            stat.Moments());
+      }
+    }
+  }
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void KDE<KernelType,
+         MetricType,
+         MatType,
+         TreeType,
+         DualTreeTraversalType,
+         SingleTreeTraversalType>::
+EvaluateLocal(Tree* node,
+              const GaussianExpansion& expansion,
+              arma::vec& estimations)
+{
+  KDEStat& stat = node->Stat();
+  if (!stat.LocalCoefficients().is_empty())
+  {
+    for (size_t i = 0; i < node->NumDescendants(); ++i)
+    {
+      const size_t queryIndex = node->Descendant(i);
+      estimations[queryIndex] += expansion.EvaluateLocal(
+          stat.ExpansionCenter(), stat.LocalCoefficients(),
+          node->Dataset().col(queryIndex));
+    }
+
+    stat.LocalCoefficients().reset();
+  }
+
+  for (size_t i = 0; i < node->NumChildren(); ++i)
+    EvaluateLocal(&node->Child(i), expansion, estimations);
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void KDE<KernelType,
+         MetricType,
+         MatType,
+         TreeType,
+         DualTreeTraversalType,
+         SingleTreeTraversalType>::
+ClearMoments(Tree* node)
+{
+  node->Stat().Moments().reset();
+  for (size_t i = 0; i < node->NumChildren(); ++i)
+    ClearMoments(&node->Child(i));
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void KDE<KernelType,
+         MetricType,
+         MatType,
+         TreeType,
+         DualTreeTraversalType,
+         SingleTreeTraversalType>::
+SplitTree(Tree* tree, std::vector<Tree*>& subtrees)
+{
+  #ifdef HAS_OPENMP
+  const size_t numThreads = omp_get_max_threads();
+  #else
+  const size_t numThreads = 1;
+  #endif
+
+  // Ask for a few subtrees per thread, to balance the load between threads
+  // with dynamic scheduling.
+  const size_t targetNodes = (numThreads == 1) ? 1 : 8 * numThreads;
+
+  // Each point must belong to exactly one subtree, so a node can only be
+  // replaced by its children if it holds no points itself, and if points are
+  // never duplicated between children.
+  subtrees.clear();
+  subtrees.push_back(tree);
+  bool split = !tree::TreeTraits<Tree>::HasDuplicatedPoints;
+  while (split && subtrees.size() < targetNodes)
+  {
+    split = false;
+    std::vector<Tree*> newSubtrees;
+    for (size_t i = 0; i < subtrees.size(); ++i)
+    {
+      Tree* node = subtrees[i];
+      if (node->NumChildren() == 0 || node->NumPoints() != 0)
+      {
+        newSubtrees.push_back(node);
+        continue;
+      }
+
+      for (size_t j = 0; j < node->NumChildren(); ++j)
+        newSubtrees.push_back(&node->Child(j));
+      split = true;
+    }
+
+    subtrees.swap(newSubtrees);
+  }
+}
+
 template<typename KernelType,
          typename MetricType,
          typename MatType,
@@ -786,6 +1241,77 @@ CheckErrorValues(const double relError, const double absError)
   }
 }
 
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+template<typename T>
+void KDE<KernelType,
+         MetricType,
+         MatType,
+         TreeType,
+         DualTreeTraversalType,
+         SingleTreeTraversalType>::
+InsertIntoTree(
+    const MatType& points,
+    const typename std::enable_if_t<tree::IsDynamicTree<T>::value>*)
+{
+  // The statistics of the nodes are reset by each evaluation, so there is
+  // nothing else to update.
+  const size_t oldSize = referenceTree->Dataset().n_cols;
+  referenceTree->Dataset().insert_cols(oldSize, points);
+  for (size_t i = 0; i < points.n_cols; ++i)
+    referenceTree->InsertPoint(oldSize + i);
+
+  // Keep the mappings valid if the tree has any.
+  if (oldFromNewReferences && !oldFromNewReferences->empty())
+  {
+    for (size_t i = 0; i < points.n_cols; ++i)
+      oldFromNewReferences->push_back(oldSize + i);
+  }
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+template<typename T>
+void KDE<KernelType,
+         MetricType,
+         MatType,
+         TreeType,
+         DualTreeTraversalType,
+         SingleTreeTraversalType>::
+InsertIntoTree(
+    const MatType& points,
+    const typename std::enable_if_t<!tree::IsDynamicTree<T>::value>*)
+{
+  // Recover the reference set in its original order, so that the order of the
+  // estimations of a monochromatic evaluation is kept.
+  const MatType& dataset = referenceTree->Dataset();
+  MatType referenceSet(dataset.n_rows, dataset.n_cols + points.n_cols);
+  if (tree::TreeTraits<Tree>::RearrangesDataset)
+  {
+    for (size_t i = 0; i < dataset.n_cols; ++i)
+      referenceSet.col((*oldFromNewReferences)[i]) = dataset.col(i);
+  }
+  else
+  {
+    referenceSet.cols(0, dataset.n_cols - 1) = dataset;
+  }
+  referenceSet.cols(dataset.n_cols, referenceSet.n_cols - 1) = points;
+
+  Train(std::move(referenceSet));
+}
+
 template<typename KernelType,
          typename MetricType,
          typename MatType,
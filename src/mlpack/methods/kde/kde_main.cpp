@@ -68,6 +68,14 @@ PROGRAM_INFO("Kernel Density Estimation",
     "already been computed. This fraction is set using " +
     PRINT_PARAM_STRING("mc_break_coef") + "."
     "\n\n"
+    "With the Gaussian kernel and the dual-tree algorithm, series expansions "
+    "of the kernel (the fast Gauss transform) can also be used when they are "
+    "cheaper than the exact computation of a pair of nodes, with the same "
+    "error guarantee.  This is mostly useful for low-dimensional data (up to "
+    "about five dimensions) and large bandwidths.  To enable series "
+    "expansions, the " + PRINT_PARAM_STRING("series_expansion") + " flag can "
+    "be used."
+    "\n\n"
     "For example, the following will run KDE using the data in " +
     PRINT_DATASET("ref_data") + " for training and the data in " +
     PRINT_DATASET("qu_data") + " as query data. It will apply an Epanechnikov "
@@ -156,6 +164,10 @@ PARAM_DOUBLE_IN("abs_error",
 PARAM_FLAG("monte_carlo",
            "Whether to use Monte Carlo estimations when possible.",
            "S");
+PARAM_FLAG("series_expansion",
+           "Whether to use series expansions of the Gaussian kernel when "
+           "possible.",
+           "x");
 PARAM_DOUBLE_IN("mc_probability",
                 "Probability of the estimation being bounded by relative error "
                 "when using Monte Carlo estimations.",
@@ -197,6 +209,7 @@ static void mlpackMain()
   const int initialSampleSize = CLI::GetParam<int>("initial_sample_size");
   const double mcEntryCoef = CLI::GetParam<double>("mc_entry_coef");
   const double mcBreakCoef = CLI::GetParam<double>("mc_break_coef");
+  const bool seriesExpansion = CLI::GetParam<bool>("series_expansion");
 
   // Initialize results vector.
   arma::vec estimations;
@@ -217,6 +230,19 @@ static void mlpackMain()
                        "Monte Carlo only works with Gaussian kernel");
   }
 
+  // Series expansions are only available for the Gaussian kernel in dual-tree
+  // mode.
+  if (seriesExpansion && kernelStr != "gaussian")
+  {
+    ReportIgnoredParam("series_expansion",
+                       "series expansions only work with Gaussian kernel");
+  }
+  else if (seriesExpansion && modeStr != "dual-tree")
+  {
+    ReportIgnoredParam("series_expansion",
+                       "series expansions only work with dual-tree algorithm");
+  }
+
   // Requirements for parameter values.
   RequireParamInSet<string>("kernel", { "gaussian", "epanechnikov",
       "laplacian", "spherical", "triangular" }, true, "unknown kernel type");
@@ -297,6 +323,7 @@ static void mlpackMain()
   kde->MCInitialSampleSize(initialSampleSize);
   kde->MCEntryCoefficient(mcEntryCoef);
   kde->MCBreakCoefficient(mcBreakCoef);
+  kde->SeriesExpansion(seriesExpansion);
 
   // Evaluation.
   if (CLI::HasParam("query"))
@@ -340,6 +340,28 @@ class MCBreakCoefVisitor : public boost::static_visitor<void>
   MCBreakCoefVisitor(const double breakCoef);
 };
 
+/**
+ * SeriesExpansionVisitor activates or deactivates series expansions of the
+ * Gaussian kernel for a given KDEType.
+ */
+class SeriesExpansionVisitor : public boost::static_visitor<void>
+{
+ private:
+  //! Whether to use series expansions or not.
+  const bool seriesExpansion;
+
+ public:
+  //! Default SeriesExpansionVisitor on some KDEType.
+  template<typename KernelType,
+           template<typename TreeMetricType,
+                    typename TreeStatType,
+                    typename TreeMatType> class TreeType>
+  void operator()(KDEType<KernelType, TreeType>* kde) const;
+
+  //! SeriesExpansionVisitor constructor.
+  SeriesExpansionVisitor(const bool seriesExpansion);
+};
+
 /**
  * ModeVisitor exposes the Mode() method of the KDEType.
  */
@@ -412,6 +434,9 @@ class KDEModel
   //! Break coefficient for Monte Carlo estimations.
   double mcBreakCoef;
 
+  //! Whether series expansions of the Gaussian kernel will be used.
+  bool seriesExpansion;
+
   /**
    * kdeModel holds an instance of each possible combination of KernelType and
    * TreeType. It is initialized using BuildModel.
@@ -466,6 +491,8 @@ class KDEModel
    * @param mcBreakCoef Coefficient to control what fraction of the node's
    *                    descendants evaluated is the limit before Monte Carlo
    *                    estimation recurses.
+   * @param seriesExpansion Whether to use series expansions of the Gaussian
+   *                        kernel when possible.
    */
   KDEModel(const double bandwidth = 1.0,
            const double relError = KDEDefaultParams::relError,
@@ -476,7 +503,8 @@ class KDEModel
            const double mcProb = KDEDefaultParams::mcProb,
            const size_t initialSampleSize = KDEDefaultParams::initialSampleSize,
            const double mcEntryCoef = KDEDefaultParams::mcEntryCoef,
-           const double mcBreakCoef = KDEDefaultParams::mcBreakCoef);
+           const double mcBreakCoef = KDEDefaultParams::mcBreakCoef,
+           const bool seriesExpansion = KDEDefaultParams::seriesExpansion);
 
   //! Copy constructor of the given model.
   KDEModel(const KDEModel& other);
@@ -560,6 +588,12 @@ class KDEModel
   //! Modify Monte Carlo break coefficient.
   void MCBreakCoefficient(const double newBreakCoef);
 
+  //! Get whether the model is using series expansions or not.
+  bool SeriesExpansion() const { return seriesExpansion; }
+
+  //! Modify whether the model is using series expansions or not.
+  void SeriesExpansion(const bool newSeriesExpansion);
+
   //! Get the mode of the model.
   KDEMode Mode() const;
 
@@ -609,7 +643,7 @@ class KDEModel
 } // namespace mlpack
 
 //! Set the serialization version of the KDEModel class.
-BOOST_TEMPLATE_CLASS_VERSION(template<>, mlpack::kde::KDEModel, 1);
+BOOST_TEMPLATE_CLASS_VERSION(template<>, mlpack::kde::KDEModel, 2);
 
 #include "kde_model_impl.hpp"
 
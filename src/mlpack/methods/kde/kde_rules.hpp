@@ -15,6 +15,8 @@
 
 #include <mlpack/core/tree/traversal_info.hpp>
 
+#include "gaussian_expansion.hpp"
+
 namespace mlpack {
 namespace kde {
 
@@ -60,6 +62,76 @@ class KDERules
            const bool monteCarlo,
            const bool sameSet);
 
+  /**
+   * Construct KDERules with an external vector of accumulated error tolerance
+   * for each query point.  This allows the query points to be split between
+   * several KDERules objects (for instance one for each thread) that share the
+   * densities and accumError vectors: as long as each query point is only
+   * handled by one of them, the error tolerance left over for a query point is
+   * only ever used for that query point.  The same holds for the Monte Carlo
+   * alpha accumulated for each query point, and each KDERules object draws its
+   * Monte Carlo samples from its own random number generator.  The Monte Carlo
+   * alpha of each reference node must already have been computed (see
+   * KDE::InitializeAlpha()), so that reference nodes are never modified.
+   *
+   * @param referenceSet Reference set data.
+   * @param querySet Query set data.
+   * @param densities Vector where estimations will be written.
+   * @param accumError Vector of accumulated error tolerance for each query
+   *                   point; must be of the size of the query set, and filled
+   *                   with zeros before the first query point is handled.
+   * @param accumMCAlpha Vector of accumulated Monte Carlo alpha for each
+   *                     query point; like accumError, but only used (and
+   *                     only needs to be of the size of the query set) if
+   *                     Monte Carlo estimations are applied.
+   * @param relError Relative error tolerance.
+   * @param absError Absolute error tolerance.
+   * @param mcProb Probability of relative error compliance for Monte Carlo
+   *               estimations.
+   * @param initialSampleSize Initial size of the Monte Carlo samples.
+   * @param mcAccessCoef Access coefficient for Monte Carlo estimations.
+   * @param mcBreakCoef Break coefficient for Monte Carlo estimations.
+   * @param metric Instantiated metric.
+   * @param kernel Instantiated kernel.
+   * @param monteCarlo If true Monte Carlo estimations will be applied when
+   *                   possible.
+   * @param sameSet True if query and reference sets are the same
+   *                (monochromatic evaluation).
+   * @param seed Seed of the random number generator for Monte Carlo
+   *             estimations.
+   * @param expansion Series expansions of the Gaussian kernel, used in
+   *                  dual-tree mode when they are cheaper than the exact
+   *                  computation; if given, the expansion center and radius of
+   *                  all nodes and the moments of the reference nodes must
+   *                  already have been computed (see
+   *                  KDE::InitializeExpansion()).  The local coefficients
+   *                  accumulated in the query nodes must be evaluated after the
+   *                  traversal.
+   */
+  KDERules(const arma::mat& referenceSet,
+           const arma::mat& querySet,
+           arma::vec& densities,
+           arma::vec& accumError,
+           arma::vec& accumMCAlpha,
+           const double relError,
+           const double absError,
+           const double mcProb,
+           const size_t initialSampleSize,
+           const double mcAccessCoef,
+           const double mcBreakCoef,
+           MetricType& metric,
+           KernelType& kernel,
+           const bool monteCarlo,
+           const bool sameSet,
+           const size_t seed,
+           const GaussianExpansion* expansion = NULL);
+
+  //! accumError and accumMCAlpha may refer to buffers of the object itself,
+  //! which a copy would keep using, so the rules can't be copied.
+  KDERules(const KDERules& other) = delete;
+  //! The rules can't be copied.
+  KDERules& operator=(const KDERules& other) = delete;
+
   //! Base Case.
   double BaseCase(const size_t queryIndex, const size_t referenceIndex);
 
@@ -105,6 +177,22 @@ class KDERules
   //! Calculate depth alpha for some node.
   double CalculateAlpha(TreeType* node);
 
+  //! Pick a random integer in [lo, hiExclusive) for Monte Carlo sampling.
+  size_t RandomPoint(const size_t lo, const size_t hiExclusive);
+
+  /**
+   * Try to evaluate the combination of nodes with the series expansions,
+   * within the same error tolerance as the dual-tree prune.
+   *
+   * @param queryNode Query node.
+   * @param referenceNode Reference node.
+   * @param errorTolerance Error tolerance of each pair of points.
+   * @return Whether the combination was evaluated.
+   */
+  bool SeriesPrune(TreeType& queryNode,
+                   TreeType& referenceNode,
+                   const double errorTolerance);
+
   //! The reference set.
   const arma::mat& referenceSet;
 
@@ -145,15 +233,29 @@ class KDERules
   //! Whether Monte Carlo estimations are going to be applied.
   const bool monteCarlo;
 
+  //! Accumulated not used MC alpha values for each query point, if they are not
+  //! given by the user.
+  arma::vec ownAccumMCAlpha;
+
   //! Accumulated not used MC alpha values for each query point.
-  arma::vec accumMCAlpha;
+  arma::vec& accumMCAlpha;
+
+  //! Accumulated not used error tolerance for each query point, if it is not
+  //! given by the user.
+  arma::vec ownAccumError;
 
   //! Accumulated not used error tolerance for each query point.
-  arma::vec accumError;
+  arma::vec& accumError;
 
   //! Whether reference and query sets are the same.
   const bool sameSet;
 
+  //! Random number generator for Monte Carlo estimations.
+  std::mt19937 generator;
+
+  //! Series expansions of the Gaussian kernel, if they are used.
+  const GaussianExpansion* expansion;
+
   //! Whether the kernel used for the rule is the Gaussian Kernel.
   constexpr static bool kernelIsGaussian =
       std::is_same<KernelType, kernel::GaussianKernel>::value;
@@ -49,19 +49,66 @@ KDERules<MetricType, KernelType, TreeType>::KDERules(
     metric(metric),
     kernel(kernel),
     monteCarlo(monteCarlo),
+    accumMCAlpha(ownAccumMCAlpha),
+    ownAccumError(querySet.n_cols, arma::fill::zeros),
+    accumError(ownAccumError),
     sameSet(sameSet),
+    generator((uint32_t) math::RandInt(std::numeric_limits<int>::max())),
+    expansion(NULL),
     absErrorTol(absError / referenceSet.n_cols),
     lastQueryIndex(querySet.n_cols),
     lastReferenceIndex(referenceSet.n_cols),
     baseCases(0),
     scores(0)
 {
-  // Initialize accumError.
-  accumError = arma::vec(querySet.n_cols, arma::fill::zeros);
-
   // Initialize accumMCAlpha only if Monte Carlo estimations are available.
   if (monteCarlo && kernelIsGaussian)
-    accumMCAlpha = arma::vec(querySet.n_cols, arma::fill::zeros);
+    ownAccumMCAlpha = arma::vec(querySet.n_cols, arma::fill::zeros);
+}
+
+template<typename MetricType, typename KernelType, typename TreeType>
+KDERules<MetricType, KernelType, TreeType>::KDERules(
+    const arma::mat& referenceSet,
+    const arma::mat& querySet,
+    arma::vec& densities,
+    arma::vec& accumError,
+    arma::vec& accumMCAlpha,
+    const double relError,
+    const double absError,
+    const double mcProb,
+    const size_t initialSampleSize,
+    const double mcAccessCoef,
+    const double mcBreakCoef,
+    MetricType& metric,
+    KernelType& kernel,
+    const bool monteCarlo,
+    const bool sameSet,
+    const size_t seed,
+    const GaussianExpansion* expansion) :
+    referenceSet(referenceSet),
+    querySet(querySet),
+    densities(densities),
+    absError(absError),
+    relError(relError),
+    mcBeta(1 - mcProb),
+    initialSampleSize(initialSampleSize),
+    mcAccessCoef(mcAccessCoef),
+    mcBreakCoef(mcBreakCoef),
+    metric(metric),
+    kernel(kernel),
+    monteCarlo(monteCarlo),
+    accumMCAlpha(accumMCAlpha),
+    accumError(accumError),
+    sameSet(sameSet),
+    generator((uint32_t) seed),
+    expansion(expansion),
+    absErrorTol(absError / referenceSet.n_cols),
+    lastQueryIndex(querySet.n_cols),
+    lastReferenceIndex(referenceSet.n_cols),
+    baseCases(0),
+    scores(0)
+{
+  // Nothing to do.
 }
 
 //! The base case.
@@ -222,9 +269,9 @@ Score(const size_t queryIndex, TreeType& referenceNode)
         // Sample and evaluate random points from the reference node.
         size_t randomPoint;
         if (alreadyDidRefPoint0)
-          randomPoint = math::RandInt(1, refNumDesc);
+          randomPoint = RandomPoint(1, refNumDesc);
         else
-          randomPoint = math::RandInt(0, refNumDesc);
+          randomPoint = RandomPoint(0, refNumDesc);
 
         sample(oldSize + i) =
             EvaluateKernel(queryIndex, referenceNode.Descendant(randomPoint));
@@ -393,6 +440,17 @@ Score(TreeType& queryNode, TreeType& referenceNode)
     if (kernelIsGaussian && monteCarlo)
       queryStat.AccumAlpha() += depthAlpha;
   }
+  else if (expansion && !alreadyDidRefPoint0 &&
+           SeriesPrune(queryNode, referenceNode, errorTolerance))
+  {
+    // The series expansions were accurate enough and cheaper than the exact
+    // computation.
+    score = DBL_MAX;
+
+    // Store not used alpha for Monte Carlo.
+    if (monteCarlo)
+      queryStat.AccumAlpha() += depthAlpha;
+  }
   else if (monteCarlo &&
            refNumDesc >= mcAccessCoef * initialSampleSize &&
            kernelIsGaussian)
@@ -439,9 +497,9 @@ Score(TreeType& queryNode, TreeType& referenceNode)
           // Sample and evaluate random points from the reference node.
           size_t randomPoint;
           if (alreadyDidRefPoint0)
-            randomPoint = math::RandInt(1, refNumDesc);
+            randomPoint = RandomPoint(1, refNumDesc);
           else
-            randomPoint = math::RandInt(0, refNumDesc);
+            randomPoint = RandomPoint(0, refNumDesc);
 
           sample(oldSize + i) =
               EvaluateKernel(queryIndex, referenceNode.Descendant(randomPoint));
@@ -573,6 +631,144 @@ CalculateAlpha(TreeType* node)
   return stat.MCAlpha();
 }
 
+template<typename MetricType, typename KernelType, typename TreeType>
+inline force_inline size_t KDERules<MetricType, KernelType, TreeType>::
+RandomPoint(const size_t lo, const size_t hiExclusive)
+{
+  return std::uniform_int_distribution<size_t>(lo, hiExclusive - 1)(generator);
+}
+
+template<typename MetricType, typename KernelType, typename TreeType>
+inline bool KDERules<MetricType, KernelType, TreeType>::
+SeriesPrune(TreeType& queryNode,
+            TreeType& referenceNode,
+            const double errorTolerance)
+{
+  // The estimation of a point with itself is not computed, so in the
+  // monochromatic case the nodes must not share any point.  Unless the tree
+  // duplicates points, this only happens if one node is an ancestor of the
+  // other.
+  if (sameSet)
+  {
+    if (tree::TreeTraits<TreeType>::HasDuplicatedPoints)
+      return false;
+
+    for (TreeType* node = &queryNode; node != NULL; node = node->Parent())
+      if (node == &referenceNode)
+        return false;
+
+    for (TreeType* node = &referenceNode; node != NULL; node = node->Parent())
+      if (node == &queryNode)
+        return false;
+  }
+
+  KDEStat& queryStat = queryNode.Stat();
+  const KDEStat& referenceStat = referenceNode.Stat();
+  const size_t queryNumDesc = queryNode.NumDescendants();
+  const size_t refNumDesc = referenceNode.NumDescendants();
+
+  // The error allowed for each query point is the same as in the dual-tree
+  // prune.
+  const double maxError = refNumDesc * errorTolerance +
+      queryStat.AccumError() / 2;
+
+  // Find the cheapest of the three ways to use the expansions that is accurate
+  // enough, if it is cheaper than the exact computation.  The cost of each is
+  // the number of terms evaluated.
+  enum { EXACT, FAR_FIELD, LOCAL, TRANSLATION } method = EXACT;
+  double cost = (double) queryNumDesc * refNumDesc;
+  size_t order = 0;
+  double error = 0.0;
+
+  const bool hasMoments = !referenceStat.Moments().is_empty();
+  size_t newOrder;
+  double newError;
+  if (hasMoments)
+  {
+    // Evaluate the far-field expansion of the reference node at each query
+    // point.
+    newOrder = expansion->FarFieldOrder(refNumDesc,
+        referenceStat.ExpansionRadius(), maxError, newError);
+    if (newOrder > 0 &&
+        (double) queryNumDesc * expansion->Terms(newOrder) < cost)
+    {
+      method = FAR_FIELD;
+      cost = (double) queryNumDesc * expansion->Terms(newOrder);
+      order = newOrder;
+      error = newError;
+    }
+  }
+
+  // Add each reference point to the local expansion of the query node.
+  newOrder = expansion->LocalOrder(refNumDesc, queryStat.ExpansionRadius(),
+      maxError, newError);
+  if (newOrder > 0 && (double) refNumDesc * expansion->Terms(newOrder) < cost)
+  {
+    method = LOCAL;
+    cost = (double) refNumDesc * expansion->Terms(newOrder);
+    order = newOrder;
+    error = newError;
+  }
+
+  if (hasMoments)
+  {
+    // Translate the far-field expansion of the reference node into the local
+    // expansion of the query node.
+    newOrder = expansion->TranslationOrder(refNumDesc,
+        referenceStat.ExpansionRadius(), queryStat.ExpansionRadius(), maxError,
+        newError);
+    const double terms = expansion->Terms(newOrder);
+    if (newOrder > 0 && terms * terms < cost)
+    {
+      method = TRANSLATION;
+      order = newOrder;
+      error = newError;
+    }
+  }
+
+  if (method == EXACT)
+    return false;
+
+  if (method == FAR_FIELD)
+  {
+    for (size_t i = 0; i < queryNumDesc; ++i)
+    {
+      const size_t queryIndex = queryNode.Descendant(i);
+      densities(queryIndex) += expansion->EvaluateMoments(
+          referenceStat.ExpansionCenter(), referenceStat.Moments(), order,
+          querySet.unsafe_col(queryIndex));
+    }
+  }
+  else
+  {
+    arma::vec& coefficients = queryStat.LocalCoefficients();
+    if (coefficients.is_empty())
+      coefficients.zeros(expansion->Terms(expansion->MaxOrder()));
+
+    if (method == LOCAL)
+    {
+      for (size_t i = 0; i < refNumDesc; ++i)
+      {
+        expansion->AccumulateLocal(queryStat.ExpansionCenter(),
+            referenceSet.unsafe_col(referenceNode.Descendant(i)), order,
+            coefficients);
+      }
+    }
+    else
+    {
+      expansion->TranslateToLocal(referenceStat.ExpansionCenter(),
+          referenceStat.Moments(), queryStat.ExpansionCenter(), order,
+          coefficients);
+    }
+  }
+
+  // Subtract used error tolerance or add extra available tolerance, as in the
+  // dual-tree prune.
+  queryStat.AccumError() -= 2 * (error - refNumDesc * errorTolerance);
+
+  return true;
+}
+
 //! Clean rules base case.
 template<typename TreeType>
 inline force_inline
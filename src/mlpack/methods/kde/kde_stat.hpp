@@ -29,7 +29,8 @@ class KDEStat
       mcBeta(0),
       mcAlpha(0),
       accumAlpha(0),
-      accumError(0)
+      accumError(0),
+      expansionRadius(0)
   { /* Nothing to do.*/ }
 
   //! Initialization for a fully initialized node.
@@ -38,7 +39,8 @@ class KDEStat
       mcBeta(0),
       mcAlpha(0),
       accumAlpha(0),
-      accumError(0)
+      accumError(0),
+      expansionRadius(0)
   { /* Nothing to do. */ }
 
   //! Get accumulated Monte Carlo alpha of the node.
@@ -65,7 +67,35 @@ class KDEStat
   //! Modify Monte Carlo alpha of the node.
   inline double& MCAlpha() { return mcAlpha; }
 
-  //! Serialize the statistic to/from an archive.
+  //! Get the center of the series expansions of the node.
+  inline const arma::vec& ExpansionCenter() const { return expansionCenter; }
+
+  //! Modify the center of the series expansions of the node.
+  inline arma::vec& ExpansionCenter() { return expansionCenter; }
+
+  //! Get the largest distance along one dimension between the center of the
+  //! series expansions and a descendant of the node.
+  inline double ExpansionRadius() const { return expansionRadius; }
+
+  //! Modify the largest distance along one dimension between the center of the
+  //! series expansions and a descendant of the node.
+  inline double& ExpansionRadius() { return expansionRadius; }
+
+  //! Get the far-field moments of the node (empty if not computed).
+  inline const arma::vec& Moments() const { return moments; }
+
+  //! Modify the far-field moments of the node.
+  inline arma::vec& Moments() { return moments; }
+
+  //! Get the local coefficients accumulated in the node (empty if none).
+  inline const arma::vec& LocalCoefficients() const
+  { return localCoefficients; }
+
+  //! Modify the local coefficients accumulated in the node.
+  inline arma::vec& LocalCoefficients() { return localCoefficients; }
+
+  //! Serialize the statistic to/from an archive.  The series expansions are
+  //! only used during an evaluation, so they are not serialized.
   template<typename Archive>
   void serialize(Archive& ar, const unsigned int version)
   {
@@ -111,6 +141,19 @@ class KDEStat
 
   //! Accumulated not used error tolerance in the current node.
   double accumError;
+
+  //! Center of the series expansions of the node.
+  arma::vec expansionCenter;
+
+  //! Largest distance along one dimension between the center and a
+  //! descendant of the node.
+  double expansionRadius;
+
+  //! Far-field (Hermite) moments of the node, as a reference node.
+  arma::vec moments;
+
+  //! Local (Taylor) coefficients accumulated in the node, as a query node.
+  arma::vec localCoefficients;
 };
 
 } // namespace kde
@@ -28,6 +28,8 @@
 #include <mlpack/methods/nystroem_method/ordered_selection.hpp>
 #include <mlpack/methods/nystroem_method/random_selection.hpp>
 #include <mlpack/methods/nystroem_method/kmeans_selection.hpp>
+#include <mlpack/methods/nystroem_method/mini_batch_kmeans_selection.hpp>
+#include <mlpack/methods/nystroem_method/uniform_selection.hpp>
 #include <mlpack/methods/nystroem_method/nystroem_method.hpp>
 #include <mlpack/methods/kernel_pca/kernel_rules/nystroem_method.hpp>
 
@@ -98,7 +100,10 @@ PROGRAM_INFO("Kernel Principal Components Analysis",
     "the kernel matrix; to specify the sampling scheme, the " +
     PRINT_PARAM_STRING("sampling") + " parameter is used.  The "
     "sampling scheme for the Nystroem method can be chosen from the "
-    "following list: 'kmeans', 'random', 'ordered'.",
+    "following list: 'kmeans', 'minibatch-kmeans', 'random', 'uniform', "
+    "'ordered'.  For large datasets, 'minibatch-kmeans' (k-means on random "
+    "samples of the data) or 'uniform' (distinct random points) are much "
+    "cheaper than 'kmeans'.",
     SEE_ALSO("Kernel principal component analysis on Wikipedia",
         "https://en.wikipedia.org/wiki/Kernel_principal_component_analysis"),
     SEE_ALSO("Kernel Principal Component Analysis (pdf)",
@@ -121,7 +126,8 @@ PARAM_FLAG("center", "If set, the transformed data will be centered about the "
 PARAM_FLAG("nystroem_method", "If set, the Nystroem method will be used.", "n");
 
 PARAM_STRING_IN("sampling", "Sampling scheme to use for the Nystroem method: "
-    "'kmeans', 'random', 'ordered'", "s", "kmeans");
+    "'kmeans', 'minibatch-kmeans', 'random', 'uniform', 'ordered'", "s",
+    "kmeans");
 
 PARAM_DOUBLE_IN("kernel_scale", "Scale, for 'hyptan' kernel.", "S", 1.0);
 PARAM_DOUBLE_IN("offset", "Offset, for 'hyptan' and 'polynomial' kernels.", "O",
@@ -149,12 +155,24 @@ void RunKPCA(arma::mat& dataset,
           KMeansSelection<> > > kpca(kernel, centerTransformedData);
       kpca.Apply(dataset, newDim);
     }
+    else if (sampling == "minibatch-kmeans")
+    {
+      KernelPCA<KernelType, NystroemKernelRule<KernelType,
+          MiniBatchKMeansSelection<> > > kpca(kernel, centerTransformedData);
+      kpca.Apply(dataset, newDim);
+    }
     else if (sampling == "random")
     {
       KernelPCA<KernelType, NystroemKernelRule<KernelType,
           RandomSelection> > kpca(kernel, centerTransformedData);
       kpca.Apply(dataset, newDim);
     }
+    else if (sampling == "uniform")
+    {
+      KernelPCA<KernelType, NystroemKernelRule<KernelType,
+          UniformSelection> > kpca(kernel, centerTransformedData);
+      kpca.Apply(dataset, newDim);
+    }
     else if (sampling == "ordered")
     {
       KernelPCA<KernelType, NystroemKernelRule<KernelType,
@@ -165,7 +183,8 @@ void RunKPCA(arma::mat& dataset,
     {
       // Invalid sampling scheme.
       Log::Fatal << "Invalid sampling scheme ('" << sampling << "'); valid "
-        << "choices are 'kmeans', 'random' and 'ordered'" << endl;
+        << "choices are 'kmeans', 'minibatch-kmeans', 'random', 'uniform' "
+        << "and 'ordered'" << endl;
     }
   }
   else
@@ -0,0 +1,126 @@
+/**
+ * @file methods/kmeans/centroid_accumulator.hpp
+ *
+ * Per-thread buffers for the centroid sums of a Lloyd iteration, so that the
+ * points of a dataset can be added to their clusters in parallel without any
+ * locking.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_CENTROID_ACCUMULATOR_HPP
+#define MLPACK_METHODS_KMEANS_CENTROID_ACCUMULATOR_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace kmeans {
+
+/**
+ * This class holds one buffer of centroid sums and counts for each OpenMP
+ * thread.  Inside a parallel region, each thread adds points to its own buffer
+ * with Add(); afterwards, Reduce() sums all the buffers, with each thread
+ * summing a different set of clusters.  Unlike merging the buffers one thread
+ * at a time in a critical section, this scales with the number of threads.
+ */
+class CentroidAccumulator
+{
+ public:
+  /**
+   * Create the buffers for the given dimensionality and number of clusters.
+   * This must be called outside of a parallel region.
+   *
+   * @param dimensionality Dimensionality of the points.
+   * @param clusters Number of clusters.
+   */
+  CentroidAccumulator(const size_t dimensionality, const size_t clusters)
+  {
+    size_t numThreads = 1;
+    #ifdef HAS_OPENMP
+      numThreads = omp_get_max_threads();
+    #endif
+
+    sums.resize(numThreads);
+    counts.resize(numThreads);
+    for (size_t t = 0; t < numThreads; ++t)
+    {
+      sums[t].zeros(dimensionality, clusters);
+      counts[t].zeros(clusters);
+    }
+  }
+
+  /**
+   * Add the given point to the given cluster, in the buffer of the calling
+   * thread.
+   *
+   * @param cluster Cluster the point is assigned to.
+   * @param point Point to add.
+   */
+  template<typename VecType>
+  void Add(const size_t cluster, const VecType& point)
+  {
+    size_t threadId = 0;
+    #ifdef HAS_OPENMP
+      threadId = omp_get_thread_num();
+    #endif
+
+    sums[threadId].unsafe_col(cluster) += point;
+    counts[threadId][cluster]++;
+  }
+
+  /**
+   * Add the given number of points, whose sum is given, to the given cluster,
+   * in the buffer of the calling thread.
+   *
+   * @param cluster Cluster the points are assigned to.
+   * @param sum Sum of the points to add.
+   * @param count Number of points to add.
+   */
+  template<typename VecType>
+  void Add(const size_t cluster, const VecType& sum, const size_t count)
+  {
+    size_t threadId = 0;
+    #ifdef HAS_OPENMP
+      threadId = omp_get_thread_num();
+    #endif
+
+    sums[threadId].unsafe_col(cluster) += sum;
+    counts[threadId][cluster] += count;
+  }
+
+  /**
+   * Sum the buffers of all threads.  This must be called outside of a parallel
+   * region.
+   *
+   * @param newCentroids Will be set to the sum of the points of each cluster.
+   * @param newCounts Will be set to the number of points of each cluster.
+   */
+  void Reduce(arma::mat& newCentroids, arma::Col<size_t>& newCounts) const
+  {
+    newCentroids = sums[0];
+    newCounts = counts[0];
+
+    #pragma omp parallel for
+    for (omp_size_t c = 0; c < (omp_size_t) newCentroids.n_cols; ++c)
+    {
+      for (size_t t = 1; t < sums.size(); ++t)
+      {
+        newCentroids.unsafe_col(c) += sums[t].col(c);
+        newCounts[c] += counts[t][c];
+      }
+    }
+  }
+
+ private:
+  //! The sum of the points of each cluster, for each thread.
+  std::vector<arma::mat> sums;
+  //! The number of points of each cluster, for each thread.
+  std::vector<arma::Col<size_t>> counts;
+};
+
+} // namespace kmeans
+} // namespace mlpack
+
+#endif
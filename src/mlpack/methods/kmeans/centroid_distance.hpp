@@ -0,0 +1,132 @@
+/**
+ * @file methods/kmeans/centroid_distance.hpp
+ *
+ * A helper that evaluates the distance between a point of the dataset and a
+ * centroid, with a fast path for sparse data and the Euclidean distance.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_CENTROID_DISTANCE_HPP
+#define MLPACK_METHODS_KMEANS_CENTROID_DISTANCE_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
+
+namespace mlpack {
+namespace kmeans {
+
+/**
+ * Evaluate the distance between the points of a dataset and a set of (dense)
+ * centroids.  Centroids() must be called whenever the centroids change, and
+ * before any call to Evaluate().
+ *
+ * In general, this simply calls the metric.  With sparse data and the
+ * Euclidean distance, the specialization below is used instead.
+ *
+ * @tparam MetricType Type of metric.
+ * @tparam MatType Type of the dataset.
+ */
+template<typename MetricType, typename MatType>
+class CentroidDistance
+{
+ public:
+  /**
+   * Create the object for the given dataset and metric.
+   *
+   * @param dataset Dataset.
+   * @param metric Instantiated metric.
+   */
+  CentroidDistance(const MatType& dataset, MetricType& metric) :
+      dataset(dataset), metric(metric), centroids(NULL) { }
+
+  //! Set the centroids that Evaluate() uses.
+  void Centroids(const arma::mat& newCentroids) { centroids = &newCentroids; }
+
+  //! Evaluate the distance between the given point and the given centroid.
+  double Evaluate(const size_t point, const size_t centroid) const
+  {
+    return metric.Evaluate(dataset.col(point), centroids->col(centroid));
+  }
+
+ private:
+  //! The dataset.
+  const MatType& dataset;
+  //! The instantiated metric.
+  MetricType& metric;
+  //! The current centroids.
+  const arma::mat* centroids;
+};
+
+/**
+ * With sparse data, evaluating the metric between a sparse point and a dense
+ * centroid walks over every dimension, which is slow for high-dimensional data
+ * such as TF-IDF features.  For the (squared) Euclidean distance, this
+ * specialization instead uses
+ *
+ *   ||x - c||^2 = ||x||^2 + ||c||^2 - 2 x^T c,
+ *
+ * with the squared norms of the points computed once, the squared norms of the
+ * centroids computed by Centroids(), and the inner product computed over the
+ * nonzero elements of the point only.
+ */
+template<bool TakeRoot>
+class CentroidDistance<metric::LMetric<2, TakeRoot>, arma::sp_mat>
+{
+ public:
+  /**
+   * Create the object for the given dataset and metric, and compute the squared
+   * norm of each point.
+   *
+   * @param dataset Dataset.
+   * @param metric Instantiated metric.
+   */
+  CentroidDistance(const arma::sp_mat& dataset,
+                   metric::LMetric<2, TakeRoot>& /* metric */) :
+      dataset(dataset), centroids(NULL)
+  {
+    pointNorms.zeros(dataset.n_cols);
+    for (arma::sp_mat::const_iterator it = dataset.begin();
+         it != dataset.end(); ++it)
+      pointNorms[it.col()] += (*it) * (*it);
+  }
+
+  //! Set the centroids that Evaluate() uses, and compute their squared norms.
+  void Centroids(const arma::mat& newCentroids)
+  {
+    centroids = &newCentroids;
+    centroidNorms = arma::sum(arma::square(newCentroids), 0).t();
+  }
+
+  //! Evaluate the distance between the given point and the given centroid.
+  double Evaluate(const size_t point, const size_t centroid) const
+  {
+    const double* c = centroids->colptr(centroid);
+    double dot = 0.0;
+    for (arma::sp_mat::const_col_iterator it = dataset.begin_col(point);
+         it != dataset.end_col(point); ++it)
+      dot += (*it) * c[it.row()];
+
+    // Rounding may make the result slightly negative.
+    const double distance = std::max(0.0,
+        pointNorms[point] + centroidNorms[centroid] - 2 * dot);
+    return TakeRoot ? std::sqrt(distance) : distance;
+  }
+
+ private:
+  //! The dataset.
+  const arma::sp_mat& dataset;
+  //! The current centroids.
+  const arma::mat* centroids;
+  //! The squared norm of each point.
+  arma::vec pointNorms;
+  //! The squared norm of each current centroid.
+  arma::vec centroidNorms;
+};
+
+} // namespace kmeans
+} // namespace mlpack
+
+#endif
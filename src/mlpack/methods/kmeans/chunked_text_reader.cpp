@@ -0,0 +1,103 @@
+/**
+ * @file methods/kmeans/chunked_text_reader.cpp
+ *
+ * Implementation of the ChunkedTextReader class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "chunked_text_reader.hpp"
+
+#include <cstdlib>
+
+namespace mlpack {
+namespace kmeans {
+
+ChunkedTextReader::ChunkedTextReader(const std::string& filename,
+                                     const size_t batchSize) :
+    filename(filename),
+    batchSize(batchSize),
+    stream(filename),
+    dimensionality(0),
+    lineNumber(0)
+{
+  if (!stream.is_open())
+  {
+    throw std::runtime_error("ChunkedTextReader: cannot open file '" +
+        filename + "'");
+  }
+}
+
+bool ChunkedTextReader::NextBatch(arma::mat& batch)
+{
+  std::vector<double> values;
+  size_t numPoints = 0;
+  std::string line;
+  while (numPoints < batchSize && std::getline(stream, line))
+  {
+    ++lineNumber;
+
+    // Parse each value of the line.
+    const size_t start = values.size();
+    const char* cursor = line.c_str();
+    while (true)
+    {
+      while (*cursor == ',' || *cursor == ' ' || *cursor == '\t' ||
+          *cursor == '\r')
+        ++cursor;
+
+      if (*cursor == '\0')
+        break;
+
+      char* end;
+      const double value = std::strtod(cursor, &end);
+      if (end == cursor)
+      {
+        std::ostringstream oss;
+        oss << "ChunkedTextReader: cannot parse line " << lineNumber << " of '"
+            << filename << "'";
+        throw std::runtime_error(oss.str());
+      }
+
+      values.push_back(value);
+      cursor = end;
+    }
+
+    // Skip empty lines.
+    const size_t lineSize = values.size() - start;
+    if (lineSize == 0)
+      continue;
+
+    if (dimensionality == 0)
+      dimensionality = lineSize;
+
+    if (lineSize != dimensionality)
+    {
+      std::ostringstream oss;
+      oss << "ChunkedTextReader: line " << lineNumber << " of '" << filename
+          << "' has " << lineSize << " values, but " << dimensionality
+          << " were expected";
+      throw std::runtime_error(oss.str());
+    }
+
+    ++numPoints;
+  }
+
+  if (numPoints == 0)
+    return false;
+
+  batch = arma::mat(values.data(), dimensionality, numPoints);
+  return true;
+}
+
+void ChunkedTextReader::Reset()
+{
+  stream.clear();
+  stream.seekg(0);
+  lineNumber = 0;
+}
+
+} // namespace kmeans
+} // namespace mlpack
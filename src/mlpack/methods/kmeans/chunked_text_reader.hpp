@@ -0,0 +1,79 @@
+/**
+ * @file methods/kmeans/chunked_text_reader.hpp
+ *
+ * A reader that gives the points of a text file one chunk at a time, so that
+ * the file does not have to fit in memory.  This can be used with
+ * StreamingKMeans.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_CHUNKED_TEXT_READER_HPP
+#define MLPACK_METHODS_KMEANS_CHUNKED_TEXT_READER_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <fstream>
+
+namespace mlpack {
+namespace kmeans {
+
+/**
+ * Read the points of a text file in chunks.  The file must hold one point per
+ * line, with values separated by commas, spaces, or tabs (so CSV files saved by
+ * data::Save() can be read); empty lines are skipped.  Each chunk is returned
+ * as a matrix with one point per column, like data::Load() would give.
+ */
+class ChunkedTextReader
+{
+ public:
+  /**
+   * Open the given file for reading.  A std::runtime_error is thrown if the
+   * file cannot be opened.
+   *
+   * @param filename Name of the file to read.
+   * @param batchSize Maximum number of points in each chunk.
+   */
+  ChunkedTextReader(const std::string& filename,
+                    const size_t batchSize = 10000);
+
+  /**
+   * Read the next chunk of points.  A std::runtime_error is thrown if a line
+   * cannot be parsed, or if it does not have as many values as the first line
+   * of the file.
+   *
+   * @param batch Matrix to store the points in, one point per column.
+   * @return false if there were no points left to read.
+   */
+  bool NextBatch(arma::mat& batch);
+
+  //! Go back to the start of the file.
+  void Reset();
+
+  //! Get the maximum number of points in each chunk.
+  size_t BatchSize() const { return batchSize; }
+  //! Modify the maximum number of points in each chunk.
+  size_t& BatchSize() { return batchSize; }
+
+  //! Get the dimensionality of the points (0 until a point has been read).
+  size_t Dimensionality() const { return dimensionality; }
+
+ private:
+  //! The name of the file.
+  std::string filename;
+  //! The maximum number of points in each chunk.
+  size_t batchSize;
+  //! The stream of the file.
+  std::ifstream stream;
+  //! The number of values on each line.
+  size_t dimensionality;
+  //! The number of the line that was last read.
+  size_t lineNumber;
+};
+
+} // namespace kmeans
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,161 @@
+/**
+ * @file methods/kmeans/distributed_kmeans.hpp
+ *
+ * Defines the DistributedKMeans class, which runs Lloyd's k-means algorithm
+ * on a dataset split into partitions, possibly held by other processes.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_DISTRIBUTED_KMEANS_HPP
+#define MLPACK_METHODS_KMEANS_DISTRIBUTED_KMEANS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "kmeans.hpp"
+#include "local_partition_transport.hpp"
+
+namespace mlpack {
+namespace kmeans {
+
+/**
+ * This class runs k-means on a dataset split into partitions, each one held by
+ * whoever runs the Lloyd step on it; the partitions are reached through a
+ * transport.  In each iteration, the current centroids are sent to every
+ * partition, each partition runs one Lloyd step on its points, and the sums
+ * and counts of the points of each cluster are summed over the partitions to
+ * give the new centroids, so the result is that of KMeans on the whole
+ * dataset.
+ *
+ * The initial centroids and the handling of empty clusters need some points:
+ * they use a sample of SampleSize() points drawn from the partitions (in
+ * proportion to their size) once per clustering, together with the global
+ * counts of the clusters.  With AllowEmptyClusters or KillEmptyClusters, empty
+ * clusters are handled exactly as KMeans does.
+ *
+ * The transport must provide these methods (see LocalPartitionTransport, which
+ * holds the partitions in the process itself):
+ *
+ * @code
+ * // The total number of points, and their dimensionality.
+ * size_t NumPoints() const;
+ * size_t Dimensionality() const;
+ * // Run one Lloyd step on every partition, and give the sum of the points of
+ * // each cluster and their number, summed over the partitions.
+ * void Iterate(const arma::mat& centroids,
+ *              arma::mat& sums,
+ *              arma::Col<size_t>& counts);
+ * // Draw (about) the given number of points from the partitions.
+ * void Sample(const size_t size, arma::mat& sample) const;
+ * @endcode
+ *
+ * @tparam MetricType The distance metric to use for this KMeans; see
+ *     metric::LMetric for an example.
+ * @tparam InitialPartitionPolicy Initial partitioning policy, applied to the
+ *     sample of the points.
+ * @tparam EmptyClusterPolicy Policy for what to do on an empty cluster.
+ * @tparam TransportType The transport to the partitions.
+ */
+template<typename MetricType = metric::EuclideanDistance,
+         typename InitialPartitionPolicy = SampleInitialization,
+         typename EmptyClusterPolicy = MaxVarianceNewCluster,
+         typename TransportType = LocalPartitionTransport<MetricType>>
+class DistributedKMeans
+{
+ public:
+  /**
+   * Create the DistributedKMeans object.
+   *
+   * @param transport The transport to the partitions.
+   * @param maxIterations Maximum number of iterations allowed before giving
+   *     up (0 is valid, but the algorithm may never terminate).
+   * @param sampleSize The number of points drawn for the initialization and
+   *     the empty clusters.
+   * @param metric Optional MetricType object; for when the metric has state it
+   *     needs to store.
+   * @param partitioner Optional InitialPartitionPolicy object.
+   * @param emptyClusterAction Optional EmptyClusterPolicy object.
+   */
+  DistributedKMeans(TransportType transport = TransportType(),
+                    const size_t maxIterations = 1000,
+                    const size_t sampleSize = 10000,
+                    const MetricType metric = MetricType(),
+                    const InitialPartitionPolicy partitioner =
+                        InitialPartitionPolicy(),
+                    const EmptyClusterPolicy emptyClusterAction =
+                        EmptyClusterPolicy());
+
+  /**
+   * Cluster the points of the partitions into the given number of clusters.
+   *
+   * @param clusters Number of clusters to compute.
+   * @param centroids Matrix in which centroids are stored.
+   * @param initialGuess If true, then it is assumed that centroids contains
+   *     the initial cluster centroids.
+   */
+  void Cluster(const size_t clusters,
+               arma::mat& centroids,
+               const bool initialGuess = false);
+
+  //! Get the maximum number of iterations.
+  size_t MaxIterations() const { return maxIterations; }
+  //! Set the maximum number of iterations.
+  size_t& MaxIterations() { return maxIterations; }
+
+  //! Get the number of points drawn for the initialization and the empty
+  //! clusters.
+  size_t SampleSize() const { return sampleSize; }
+  //! Modify the number of points drawn for the initialization and the empty
+  //! clusters.
+  size_t& SampleSize() { return sampleSize; }
+
+  //! Get the number of iterations of the last clustering.
+  size_t Iterations() const { return iterations; }
+
+  //! Get the transport.
+  const TransportType& Transport() const { return transport; }
+  //! Modify the transport.
+  TransportType& Transport() { return transport; }
+
+  //! Get the distance metric.
+  const MetricType& Metric() const { return metric; }
+  //! Modify the distance metric.
+  MetricType& Metric() { return metric; }
+
+  //! Get the initial partitioning policy.
+  const InitialPartitionPolicy& Partitioner() const { return partitioner; }
+  //! Modify the initial partitioning policy.
+  InitialPartitionPolicy& Partitioner() { return partitioner; }
+
+  //! Get the empty cluster policy.
+  const EmptyClusterPolicy& EmptyClusterAction() const
+  { return emptyClusterAction; }
+  //! Modify the empty cluster policy.
+  EmptyClusterPolicy& EmptyClusterAction() { return emptyClusterAction; }
+
+ private:
+  //! The transport to the partitions.
+  TransportType transport;
+  //! Maximum number of iterations before giving up.
+  size_t maxIterations;
+  //! The number of points drawn for the initialization and the empty clusters.
+  size_t sampleSize;
+  //! The number of iterations of the last clustering.
+  size_t iterations;
+  //! Instantiated distance metric.
+  MetricType metric;
+  //! Instantiated initial partitioning policy.
+  InitialPartitionPolicy partitioner;
+  //! Instantiated empty cluster policy.
+  EmptyClusterPolicy emptyClusterAction;
+};
+
+} // namespace kmeans
+} // namespace mlpack
+
+// Include implementation.
+#include "distributed_kmeans_impl.hpp"
+
+#endif
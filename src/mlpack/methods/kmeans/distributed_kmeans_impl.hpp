@@ -0,0 +1,172 @@
+/**
+ * @file methods/kmeans/distributed_kmeans_impl.hpp
+ *
+ * Implementation of the DistributedKMeans class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_DISTRIBUTED_KMEANS_IMPL_HPP
+#define MLPACK_METHODS_KMEANS_DISTRIBUTED_KMEANS_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "distributed_kmeans.hpp"
+
+namespace mlpack {
+namespace kmeans {
+
+template<typename MetricType,
+         typename InitialPartitionPolicy,
+         typename EmptyClusterPolicy,
+         typename TransportType>
+DistributedKMeans<
+    MetricType,
+    InitialPartitionPolicy,
+    EmptyClusterPolicy,
+    TransportType>::
+DistributedKMeans(TransportType transport,
+                  const size_t maxIterations,
+                  const size_t sampleSize,
+                  const MetricType metric,
+                  const InitialPartitionPolicy partitioner,
+                  const EmptyClusterPolicy emptyClusterAction) :
+    transport(std::move(transport)),
+    maxIterations(maxIterations),
+    sampleSize(sampleSize),
+    iterations(0),
+    metric(metric),
+    partitioner(partitioner),
+    emptyClusterAction(emptyClusterAction)
+{
+  // Nothing to do.
+}
+
+template<typename MetricType,
+         typename InitialPartitionPolicy,
+         typename EmptyClusterPolicy,
+         typename TransportType>
+void DistributedKMeans<
+    MetricType,
+    InitialPartitionPolicy,
+    EmptyClusterPolicy,
+    TransportType>::
+Cluster(const size_t clusters,
+        arma::mat& centroids,
+        const bool initialGuess)
+{
+  const size_t numPoints = transport.NumPoints();
+  if (numPoints == 0)
+  {
+    throw std::invalid_argument("DistributedKMeans::Cluster(): there are no "
+        "points to cluster!");
+  }
+
+  // Make sure we have more points than clusters.
+  if (clusters > numPoints)
+    Log::Warn << "DistributedKMeans::Cluster(): more clusters requested than "
+        << "points given." << std::endl;
+  else if (clusters == 0)
+    Log::Warn << "DistributedKMeans::Cluster(): zero clusters requested.  "
+        << "This probably isn't going to work.  Brace for crash." << std::endl;
+
+  // Check validity of initial guess.
+  if (initialGuess)
+  {
+    if (centroids.n_cols != clusters)
+      Log::Fatal << "DistributedKMeans::Cluster(): wrong number of initial "
+          << "cluster centroids (" << centroids.n_cols << ", should be "
+          << clusters << ")!" << std::endl;
+
+    if (centroids.n_rows != transport.Dimensionality())
+      Log::Fatal << "DistributedKMeans::Cluster(): initial cluster centroids "
+          << "have wrong dimensionality (" << centroids.n_rows << ", should "
+          << "be " << transport.Dimensionality() << ")!" << std::endl;
+  }
+
+  // The sample used for the initial centroids and the empty clusters.
+  arma::mat sample;
+  transport.Sample(std::min(std::max(sampleSize, clusters), numPoints),
+      sample);
+
+  if (!initialGuess)
+  {
+    arma::Row<size_t> assignments;
+    const bool gotAssignments = GetInitialAssignmentsOrCentroids(partitioner,
+        sample, clusters, assignments, centroids);
+    if (gotAssignments)
+    {
+      // The partitioner gives assignments, so we need to calculate centroids
+      // from those assignments.
+      arma::Row<size_t> counts;
+      counts.zeros(clusters);
+      centroids.zeros(sample.n_rows, clusters);
+      for (size_t i = 0; i < sample.n_cols; ++i)
+      {
+        centroids.col(assignments[i]) += sample.col(i);
+        counts[assignments[i]]++;
+      }
+
+      for (size_t i = 0; i < clusters; ++i)
+        if (counts[i] != 0)
+          centroids.col(i) /= counts[i];
+    }
+  }
+
+  arma::Col<size_t> counts;
+  arma::mat newCentroids;
+  double cNorm;
+  iterations = 0;
+
+  do
+  {
+    // The sums and counts of every partition, and then the new centroids.
+    transport.Iterate(centroids, newCentroids, counts);
+    for (size_t i = 0; i < counts.n_elem; ++i)
+      if (counts[i] != 0)
+        newCentroids.col(i) /= counts[i];
+
+    cNorm = 0.0;
+    for (size_t i = 0; i < centroids.n_cols; ++i)
+    {
+      cNorm += std::pow(metric.Evaluate(centroids.col(i),
+          newCentroids.col(i)), 2.0);
+    }
+    cNorm = std::sqrt(cNorm);
+
+    // The empty clusters are handled with the global counts.
+    for (size_t i = 0; i < counts.n_elem; i++)
+    {
+      if (counts[i] == 0)
+      {
+        Log::Info << "Cluster " << i << " is empty.\n";
+        emptyClusterAction.EmptyCluster(sample, i, centroids, newCentroids,
+            counts, metric, iterations);
+      }
+    }
+
+    centroids.swap(newCentroids);
+    iterations++;
+    Log::Info << "DistributedKMeans::Cluster(): iteration " << iterations
+        << ", residual " << cNorm << ".\n";
+    if (std::isnan(cNorm) || std::isinf(cNorm))
+      cNorm = 1e-4; // Keep iterating.
+  } while (cNorm > 1e-5 && iterations != maxIterations);
+
+  if (iterations != maxIterations)
+  {
+    Log::Info << "DistributedKMeans::Cluster(): converged after "
+        << iterations << " iterations." << std::endl;
+  }
+  else
+  {
+    Log::Info << "DistributedKMeans::Cluster(): terminated after limit of "
+        << iterations << " iterations." << std::endl;
+  }
+}
+
+} // namespace kmeans
+} // namespace mlpack
+
+#endif
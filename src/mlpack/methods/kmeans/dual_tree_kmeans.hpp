@@ -18,8 +18,10 @@
 #include <mlpack/core/tree/binary_space_tree.hpp>
 #include <mlpack/methods/neighbor_search/neighbor_search.hpp>
 #include <mlpack/core/tree/cover_tree.hpp>
+#include <mlpack/core/tree/traversal_statistics.hpp>
 
 #include "dual_tree_kmeans_statistic.hpp"
+#include "centroid_accumulator.hpp"
 
 namespace mlpack {
 namespace kmeans {
@@ -30,6 +32,13 @@ namespace kmeans {
  * dataset.  The conditions under which this will perform best are probably
  * limited to the case where k is close to the number of points in the dataset,
  * and the number of iterations of the k-means algorithm will be few.
+ *
+ * The tree built on the centroids is kept between iterations; when no centroid
+ * moved by more than a quarter of the distance to its nearest other centroid,
+ * its bounds are refit in place (for trees that support it, such as the
+ * kd-tree) instead of building a new tree.  With OpenMP, the data tree is split
+ * into subtrees that are traversed in parallel, each thread adding the points
+ * it assigns to its own centroid sums.
  */
 template<
     typename MetricType,
@@ -78,7 +87,15 @@ class DualTreeKMeans
   //! Modify the number of distance calculations.
   size_t& DistanceCalculations() { return distanceCalculations; }
 
+  //! Return the statistics of the tree traversals of all iterations so far
+  //! (both the search for the nearest centroids and the assignment of points).
+  const tree::TraversalStatistics& Statistics() const { return statistics; }
+
  private:
+  //! The nearest neighbor search object that holds the tree on the centroids.
+  typedef neighbor::NeighborSearch<neighbor::NearestNeighborSort, MetricType,
+      MatType, NNSTreeType> CentroidSearchType;
+
   //! The original dataset reference.
   const MatType& datasetOrig; // Maybe not necessary.
   //! The tree built on the points.
@@ -90,6 +107,8 @@ class DualTreeKMeans
 
   //! Track distance calculations.
   size_t distanceCalculations;
+  //! The statistics of the tree traversals of all iterations so far.
+  tree::TraversalStatistics statistics;
   //! Track iteration number.
   size_t iteration;
 
@@ -97,12 +116,14 @@ class DualTreeKMeans
   arma::vec upperBounds;
   //! Lower bounds on second closest cluster distance for each point.
   arma::vec lowerBounds;
-  //! Indicator of whether or not the point is pruned.
-  std::vector<bool> prunedPoints;
+  //! Indicator of whether or not the point is pruned.  This is not a
+  //! std::vector<bool>, because the points are updated by several threads at
+  //! once.
+  std::vector<char> prunedPoints;
 
   arma::Row<size_t> assignments;
 
-  std::vector<bool> visited; // Was the point visited this iteration?
+  std::vector<char> visited; // Was the point visited this iteration?
 
   arma::mat lastIterationCentroids; // For sanity checks.
 
@@ -110,6 +131,20 @@ class DualTreeKMeans
 
   arma::mat interclusterDistances; // Static storage for intercluster distances.
 
+  //! The search object holding the tree built on the centroids (NULL before
+  //! the first iteration).
+  CentroidSearchType* centroidSearch;
+  //! The mapping from the indices of the centroids in the centroid tree to
+  //! their original indices.
+  std::vector<size_t> oldFromNewCentroids;
+
+  /**
+   * Move the points of the centroid tree to the given centroids and refit its
+   * bounds, if no centroid moved too far since the tree was built and the tree
+   * type supports it.  Return false if a new tree must be built instead.
+   */
+  bool RefitCentroidTree(const arma::mat& centroids);
+
   //! Update the bounds in the tree before the next iteration.
   //! centroids is the current (not yet searched) centroids.
   void UpdateTree(Tree& node,
@@ -120,10 +155,7 @@ class DualTreeKMeans
                   const double adjustedParentLowerBound = 0.0);
 
   //! Extract the centroids of the clusters.
-  void ExtractCentroids(Tree& node,
-                        arma::mat& newCentroids,
-                        arma::Col<size_t>& newCounts,
-                        const arma::mat& centroids);
+  void ExtractCentroids(Tree& node, CentroidAccumulator& accumulator);
 
   void CoalesceTree(Tree& node, const size_t child = 0);
   void DecoalesceTree(Tree& node);
@@ -158,6 +190,27 @@ void RestoreChildren(TreeType& node,
                      const typename std::enable_if_t<tree::TreeTraits<
                          TreeType>::BinaryTree>* junk = 0);
 
+//! Utility function for moving the points of a tree (given in their original
+//! order) and refitting its bounds.  This is called for trees that can't be
+//! refit, does nothing, and returns false.
+template<typename TreeType>
+bool RefitTree(TreeType& node,
+               const arma::mat& points,
+               const std::vector<size_t>& oldFromNew);
+
+//! Utility function for moving the points of a tree (given in their original
+//! order) and refitting its bounds.  This is called for binary space trees with
+//! hyperrectangle bounds (such as the kd-tree), and returns true.
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+bool RefitTree(tree::BinarySpaceTree<MetricType, StatisticType, MatType,
+                   bound::HRectBound, SplitType>& node,
+               const arma::mat& points,
+               const std::vector<size_t>& oldFromNew);
+
 //! A template typedef for the DualTreeKMeans algorithm with the default tree
 //! type (a kd-tree).
 template<typename MetricType, typename MatType>
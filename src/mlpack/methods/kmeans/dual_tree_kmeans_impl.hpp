@@ -20,6 +20,8 @@
 
 #include "dual_tree_kmeans_rules.hpp"
 
+#include <mlpack/core/tree/subtree_frontier.hpp>
+
 namespace mlpack {
 namespace kmeans {
 
@@ -65,7 +67,8 @@ DualTreeKMeans<MetricType, MatType, TreeType>::DualTreeKMeans(
     lowerBounds(dataset.n_cols),
     prunedPoints(dataset.n_cols, false), // Fill with false.
     assignments(dataset.n_cols),
-    visited(dataset.n_cols, false) // Fill with false.
+    visited(dataset.n_cols, false), // Fill with false.
+    centroidSearch(NULL)
 {
   for (size_t i = 0; i < dataset.n_cols; ++i)
   {
@@ -86,6 +89,8 @@ DualTreeKMeans<MetricType, MatType, TreeType>::~DualTreeKMeans()
 {
   if (tree)
     delete tree;
+  if (centroidSearch)
+    delete centroidSearch;
 }
 
 // Run a single iteration.
@@ -99,16 +104,26 @@ double DualTreeKMeans<MetricType, MatType, TreeType>::Iterate(
     arma::mat& newCentroids,
     arma::Col<size_t>& counts)
 {
-  // Build a tree on the centroids.  This will make a copy if necessary, which
-  // is unfortunate, but I don't see a reasonable way around it.
-  std::vector<size_t> oldFromNewCentroids;
-  Tree* centroidTree = BuildTree<Tree>(centroids, oldFromNewCentroids);
+  // Refit the tree on the centroids of the last iteration if the centroids
+  // moved little; otherwise, build a tree on the centroids.  This will make a
+  // copy if necessary, which is unfortunate, but I don't see a reasonable way
+  // around it.
+  Timer::Start("tree_mod");
+  if (!RefitCentroidTree(centroids))
+  {
+    delete centroidSearch;
 
-  // Find the nearest neighbors of each of the clusters.  We have to make our
-  // own TreeType, which is a little bit abuse, but we know for sure the
-  // TreeStatType we have will work.
-  neighbor::NeighborSearch<neighbor::NearestNeighborSort, MetricType, MatType,
-      NNSTreeType> nns(std::move(*centroidTree));
+    oldFromNewCentroids.clear();
+    Tree* centroidTree = BuildTree<Tree>(centroids, oldFromNewCentroids);
+
+    // Find the nearest neighbors of each of the clusters.  We have to make our
+    // own TreeType, which is a little bit abuse, but we know for sure the
+    // TreeStatType we have will work.
+    centroidSearch = new CentroidSearchType(std::move(*centroidTree));
+    delete centroidTree;
+  }
+  Timer::Stop("tree_mod");
+  CentroidSearchType& nns = *centroidSearch;
 
   // Reset information in the tree, if we need to.
   if (iteration > 0)
@@ -123,6 +138,7 @@ double DualTreeKMeans<MetricType, MatType, TreeType>::Iterate(
     arma::Mat<size_t> closestClusters; // We don't actually care about these.
     nns.Search(1, closestClusters, *interclusterDistancesTemp);
     distanceCalculations += nns.BaseCases() + nns.Scores();
+    statistics += nns.Statistics();
 
     // We need to do the unmapping ourselves, if the tree does mapping.
     if (tree::TreeTraits<Tree>::RearrangesDataset)
@@ -136,7 +152,12 @@ double DualTreeKMeans<MetricType, MatType, TreeType>::Iterate(
 
     Timer::Stop("knn");
 
-    UpdateTree(*tree, centroids);
+    // The subtrees of the data tree are updated in parallel, as tasks.
+    #pragma omp parallel
+    {
+      #pragma omp single
+      UpdateTree(*tree, centroids);
+    }
 
     for (size_t i = 0; i < dataset.n_cols; ++i)
       visited[i] = false;
@@ -151,30 +172,59 @@ double DualTreeKMeans<MetricType, MatType, TreeType>::Iterate(
   // We won't use the KNN class here because we have our own set of rules.
   lastIterationCentroids = centroids;
   typedef DualTreeKMeansRules<MetricType, Tree> RuleType;
-  RuleType rules(nns.ReferenceTree().Dataset(), dataset, assignments,
-      upperBounds, lowerBounds, metric, prunedPoints, oldFromNewCentroids,
-      visited);
-
-  typename Tree::template BreadthFirstDualTreeTraverser<RuleType>
-      traverser(rules);
 
   Timer::Start("tree_mod");
   CoalesceTree(*tree);
   Timer::Stop("tree_mod");
 
-  // Set the number of pruned centroids in the root to 0.
-  tree->Stat().Pruned() = 0;
-  traverser.Traverse(*tree, nns.ReferenceTree());
-  distanceCalculations += rules.BaseCases() + rules.Scores();
+  // Split the data tree into disjoint subtrees, which only touch their own
+  // nodes and points, so that they can be traversed in parallel against the
+  // whole centroid tree.  Each subtree root starts like the root of the tree.
+  // We use more subtrees than threads to balance the load.
+  size_t numThreads = 1;
+  #ifdef HAS_OPENMP
+    numThreads = omp_get_max_threads();
+  #endif
+  std::vector<Tree*> subtrees;
+  tree::SubtreeFrontier(*tree, (numThreads == 1) ? 1 : 4 * numThreads,
+      subtrees);
+
+  size_t traversalDistances = 0;
+  #pragma omp parallel for schedule(dynamic) reduction(+:traversalDistances)
+  for (omp_size_t i = 0; i < (omp_size_t) subtrees.size(); ++i)
+  {
+    RuleType rules(nns.ReferenceTree().Dataset(), dataset, assignments,
+        upperBounds, lowerBounds, metric, prunedPoints, oldFromNewCentroids,
+        visited);
+
+    tree::TraversalStatistics subtreeStatistics;
+    tree::CountingRules<RuleType> countingRules(rules, subtreeStatistics);
+    typename Tree::template BreadthFirstDualTreeTraverser<
+        tree::CountingRules<RuleType>> traverser(countingRules);
+
+    // Set the number of pruned centroids in the subtree root to 0.
+    subtrees[i]->Stat().Pruned() = 0;
+    traverser.Traverse(*subtrees[i], nns.ReferenceTree());
+    traversalDistances += rules.BaseCases() + rules.Scores();
+
+    #pragma omp critical(dualTreeKMeansStatistics)
+    statistics += subtreeStatistics;
+  }
+  distanceCalculations += traversalDistances;
 
   Timer::Start("tree_mod");
   DecoalesceTree(*tree);
   Timer::Stop("tree_mod");
 
-  // Now we need to extract the clusters.
-  newCentroids.zeros(centroids.n_rows, centroids.n_cols);
-  counts.zeros(centroids.n_cols);
-  ExtractCentroids(*tree, newCentroids, counts, centroids);
+  // Now we need to extract the clusters.  Each thread adds the points of the
+  // subtrees it handles to its own sums.
+  CentroidAccumulator accumulator(centroids.n_rows, centroids.n_cols);
+  #pragma omp parallel
+  {
+    #pragma omp single
+    ExtractCentroids(*tree, accumulator);
+  }
+  accumulator.Reduce(newCentroids, counts);
 
   // Now, calculate how far the clusters moved, after normalizing them.
   double residual = 0.0;
@@ -199,8 +249,6 @@ double DualTreeKMeans<MetricType, MatType, TreeType>::Iterate(
   }
   distanceCalculations += centroids.n_cols;
 
-  delete centroidTree;
-
   ++iteration;
 
   return std::sqrt(residual);
@@ -328,6 +376,7 @@ visited[node.Descendant(i)] << ".\n";
                    node.MaxDistance(centroids.col(node.Stat().Owner())));
       adjustedUpperBound = node.Stat().UpperBound();
 
+      #pragma omp atomic
       ++distanceCalculations;
       if (node.Stat().UpperBound() < node.Stat().LowerBound())
         node.Stat().StaticPruned() = true;
@@ -339,12 +388,20 @@ visited[node.Descendant(i)] << ".\n";
   }
 
   // Recurse into children, and if all the children (and all the points) are
-  // pruned, then we can mark this as statically pruned.
-  bool allChildrenPruned = true;
+  // pruned, then we can mark this as statically pruned.  The children only
+  // touch their own subtrees, so large ones are updated as parallel tasks.
   for (size_t i = 0; i < node.NumChildren(); ++i)
   {
+    #pragma omp task default(shared) firstprivate(i) \
+        if (node.Child(i).NumDescendants() > 1024)
     UpdateTree(node.Child(i), centroids, unadjustedUpperBound,
         adjustedUpperBound, unadjustedLowerBound, adjustedLowerBound);
+  }
+  #pragma omp taskwait
+
+  bool allChildrenPruned = true;
+  for (size_t i = 0; i < node.NumChildren(); ++i)
+  {
     if (!node.Child(i).Stat().StaticPruned())
       allChildrenPruned = false;
   }
@@ -400,6 +457,7 @@ visited[node.Descendant(i)] << ".\n";
         // Attempt to tighten the bound.
         upperBounds[index] = metric.Evaluate(dataset.col(index),
                                              centroids.col(owner));
+        #pragma omp atomic
         ++distanceCalculations;
         if (upperBounds[index] < pruningLowerBound)
         {
@@ -478,17 +536,17 @@ template<typename MetricType,
                   typename TreeMatType> class TreeType>
 void DualTreeKMeans<MetricType, MatType, TreeType>::ExtractCentroids(
     Tree& node,
-    arma::mat& newCentroids,
-    arma::Col<size_t>& newCounts,
-    const arma::mat& centroids)
+    CentroidAccumulator& accumulator)
 {
+  const size_t numClusters = lastIterationCentroids.n_cols;
+
   // Does this node own points?
-  if ((node.Stat().Pruned() == newCentroids.n_cols) ||
-      (node.Stat().StaticPruned() && node.Stat().Owner() < newCentroids.n_cols))
+  if ((node.Stat().Pruned() == numClusters) ||
+      (node.Stat().StaticPruned() && node.Stat().Owner() < numClusters))
   {
     const size_t owner = node.Stat().Owner();
-    newCentroids.col(owner) += node.Stat().Centroid() * node.NumDescendants();
-    newCounts[owner] += node.NumDescendants();
+    accumulator.Add(owner, node.Stat().Centroid() * node.NumDescendants(),
+        node.NumDescendants());
 
     // Perform the sanity check here.
 /*
@@ -526,8 +584,7 @@ node.Stat().UpperBound() << " and owner " << node.Stat().Owner() << ".\n";
       for (size_t i = 0; i < node.NumPoints(); ++i)
       {
         const size_t owner = assignments[node.Point(i)];
-        newCentroids.col(owner) += dataset.col(node.Point(i));
-        ++newCounts[owner];
+        accumulator.Add(owner, dataset.col(node.Point(i)));
 
 /*
         const size_t index = node.Point(i);
@@ -558,12 +615,51 @@ assignments[node.Point(i)] << " with ub " << upperBounds[node.Point(i)] <<
       }
     }
 
-    // The node is not entirely owned by a cluster.  Recurse.
+    // The node is not entirely owned by a cluster.  Recurse, with large
+    // children as parallel tasks.
     for (size_t i = 0; i < node.NumChildren(); ++i)
-      ExtractCentroids(node.Child(i), newCentroids, newCounts, centroids);
+    {
+      #pragma omp task default(shared) firstprivate(i) \
+          if (node.Child(i).NumDescendants() > 1024)
+      ExtractCentroids(node.Child(i), accumulator);
+    }
+    #pragma omp taskwait
   }
 }
 
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+bool DualTreeKMeans<MetricType, MatType, TreeType>::RefitCentroidTree(
+    const arma::mat& centroids)
+{
+  // The distances between the centroids are only known once a search has been
+  // done on the tree.
+  if (centroidSearch == NULL || iteration < 2 ||
+      centroidSearch->ReferenceTree().Dataset().n_cols != centroids.n_cols)
+    return false;
+
+  // If a centroid moved by more than a quarter of the distance to its nearest
+  // other centroid, the shape of the tree may be far from what a new tree
+  // would have, and the traversals would prune less.
+  const MatType& treeCentroids = centroidSearch->ReferenceTree().Dataset();
+  for (size_t i = 0; i < treeCentroids.n_cols; ++i)
+  {
+    const size_t c = (tree::TreeTraits<Tree>::RearrangesDataset) ?
+        oldFromNewCentroids[i] : i;
+    const double movement = metric.Evaluate(treeCentroids.col(i),
+        centroids.col(c));
+    if (movement > interclusterDistances[c] / 4.0)
+      return false;
+  }
+  distanceCalculations += centroids.n_cols;
+
+  return RefitTree(centroidSearch->ReferenceTree(), centroids,
+      oldFromNewCentroids);
+}
+
 template<typename MetricType,
          typename MatType,
          template<typename TreeMetricType,
@@ -627,6 +723,36 @@ void DualTreeKMeans<MetricType, MatType, TreeType>::DecoalesceTree(Tree& node)
     DecoalesceTree(node.Child(i));
 }
 
+//! Utility function for refitting a tree that can't be refit.
+template<typename TreeType>
+bool RefitTree(TreeType& /* node */,
+               const arma::mat& /* points */,
+               const std::vector<size_t>& /* oldFromNew */)
+{
+  return false;
+}
+
+//! Utility function for refitting a binary space tree with hyperrectangle
+//! bounds.
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+bool RefitTree(tree::BinarySpaceTree<MetricType, StatisticType, MatType,
+                   bound::HRectBound, SplitType>& node,
+               const arma::mat& points,
+               const std::vector<size_t>& oldFromNew)
+{
+  // The tree holds the points in its own order.
+  MatType& dataset = node.Dataset();
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+    dataset.col(i) = points.col(oldFromNew[i]);
+
+  node.RefitBounds();
+  return true;
+}
+
 //! Utility function for hiding children in a non-binary tree.
 template<typename TreeType>
 void HideChild(TreeType& node,
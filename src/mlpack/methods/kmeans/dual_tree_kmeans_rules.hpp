@@ -29,9 +29,9 @@ class DualTreeKMeansRules
                       arma::vec& upperBounds,
                       arma::vec& lowerBounds,
                       MetricType& metric,
-                      const std::vector<bool>& prunedPoints,
+                      const std::vector<char>& prunedPoints,
                       const std::vector<size_t>& oldFromNewCentroids,
-                      std::vector<bool>& visited);
+                      std::vector<char>& visited);
 
   double BaseCase(const size_t queryIndex, const size_t referenceIndex);
 
@@ -63,11 +63,11 @@ class DualTreeKMeansRules
   arma::vec& lowerBounds;
   MetricType& metric;
 
-  const std::vector<bool>& prunedPoints;
+  const std::vector<char>& prunedPoints;
 
   const std::vector<size_t>& oldFromNewCentroids;
 
-  std::vector<bool>& visited;
+  std::vector<char>& visited;
 
   size_t baseCases;
   size_t scores;
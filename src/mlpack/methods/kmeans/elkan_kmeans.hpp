@@ -12,6 +12,8 @@
 #ifndef MLPACK_METHODS_KMEANS_ELKAN_KMEANS_HPP
 #define MLPACK_METHODS_KMEANS_ELKAN_KMEANS_HPP
 
+#include "centroid_distance.hpp"
+
 namespace mlpack {
 namespace kmeans {
 
@@ -43,6 +45,8 @@ class ElkanKMeans
   const MatType& dataset;
   //! The instantiated metric.
   MetricType& metric;
+  //! Evaluates the distances between points and centroids.
+  CentroidDistance<MetricType, MatType> distances;
 
   //! Holds intra-cluster distances.
   arma::mat clusterDistances;
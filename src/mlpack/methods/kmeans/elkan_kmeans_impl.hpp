@@ -15,6 +15,8 @@
 // In case it hasn't been included yet.
 #include "elkan_kmeans.hpp"
 
+#include "centroid_accumulator.hpp"
+
 namespace mlpack {
 namespace kmeans {
 
@@ -23,6 +25,7 @@ ElkanKMeans<MetricType, MatType>::ElkanKMeans(const MatType& dataset,
                                               MetricType& metric) :
     dataset(dataset),
     metric(metric),
+    distances(dataset, metric),
     distanceCalculations(0)
 {
   // Nothing to do here.
@@ -34,9 +37,12 @@ double ElkanKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
                                                  arma::mat& newCentroids,
                                                  arma::Col<size_t>& counts)
 {
-  // Clear new centroids.
-  newCentroids.zeros(centroids.n_rows, centroids.n_cols);
-  counts.zeros(centroids.n_cols);
+  // Each thread adds its points to its own buffer of the accumulator.
+  CentroidAccumulator accumulator(centroids.n_rows, centroids.n_cols);
+  distances.Centroids(centroids);
+
+  // The distance calculations of this iteration.
+  size_t iterationDistances = 0;
 
   // At the beginning of the iteration, we must compute the distances between
   // all centers.  This is O(k^2).
@@ -46,8 +52,9 @@ double ElkanKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
   // being the closest cluster centroid.
   clusterDistances.diag().fill(DBL_MAX);
 
-  // Initially set r(x) to true.
-  std::vector<bool> mustRecalculate(dataset.n_cols, true);
+  // Initially set r(x) to true.  (This is not a std::vector<bool>, since
+  // different threads set r(x) for different points.)
+  std::vector<char> mustRecalculate(dataset.n_cols, true);
 
   // If this is the first iteration, we must reset all the bounds.
   if (lowerBounds.n_rows != centroids.n_cols)
@@ -63,13 +70,14 @@ double ElkanKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
 
   // Step 1: for all centers, compute between-cluster distances.  For all
   // centers, compute s(c) = 1/2 min d(c, c').
-  for (size_t i = 0; i < centroids.n_cols; ++i)
+  #pragma omp parallel for schedule(dynamic) reduction(+:iterationDistances)
+  for (omp_size_t i = 0; i < (omp_size_t) centroids.n_cols; ++i)
   {
     for (size_t j = i + 1; j < centroids.n_cols; ++j)
     {
       const double distance = metric.Evaluate(centroids.col(i),
                                               centroids.col(j));
-      distanceCalculations++;
+      iterationDistances++;
       clusterDistances(i, j) = distance;
       clusterDistances(j, i) = distance;
     }
@@ -79,15 +87,17 @@ double ElkanKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
   // that this is equivalent to s(c) for each cluster c.
   minClusterDistances = 0.5 * arma::min(clusterDistances).t();
 
-  // Now loop over all points, and see which ones need to be updated.
-  for (size_t i = 0; i < dataset.n_cols; ++i)
+  // Now loop over all points, and see which ones need to be updated.  Each
+  // point only changes its own bounds, so this can be done in parallel.
+  #pragma omp parallel for schedule(dynamic, 256) \
+      reduction(+:iterationDistances)
+  for (omp_size_t i = 0; i < (omp_size_t) dataset.n_cols; ++i)
   {
     // Step 2: identify all points such that u(x) <= s(c(x)).
     if (upperBounds(i) <= minClusterDistances(assignments[i]))
     {
       // No change needed.  This point must still belong to that cluster.
-      counts(assignments[i])++;
-      newCentroids.col(assignments[i]) += arma::vec(dataset.col(i));
+      accumulator.Add(assignments[i], dataset.col(i));
       continue;
     }
     else
@@ -111,10 +121,10 @@ double ElkanKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
         if (mustRecalculate[i])
         {
           mustRecalculate[i] = false;
-          dist = metric.Evaluate(dataset.col(i), centroids.col(assignments[i]));
+          dist = distances.Evaluate(i, assignments[i]);
           lowerBounds(assignments[i], i) = dist;
           upperBounds(i) = dist;
-          distanceCalculations++;
+          iterationDistances++;
 
           // Check if we can prune again.
           if (upperBounds(i) <= lowerBounds(c, i))
@@ -133,10 +143,9 @@ double ElkanKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
             dist > 0.5 * clusterDistances(assignments[i], c))
         {
           // Compute d(x, c).  If d(x, c) < d(x, c(x)) then assign c(x) = c.
-          const double pointDist = metric.Evaluate(dataset.col(i),
-                                                   centroids.col(c));
+          const double pointDist = distances.Evaluate(i, c);
           lowerBounds(c, i) = pointDist;
-          distanceCalculations++;
+          iterationDistances++;
           if (pointDist < dist)
           {
             upperBounds(i) = pointDist;
@@ -149,10 +158,12 @@ double ElkanKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
     // At this point, we know the new cluster assignment.
     // Step 4: for each center c, let m(c) be the mean of the points assigned to
     // c.
-    newCentroids.col(assignments[i]) += arma::vec(dataset.col(i));
-    counts[assignments[i]]++;
+    accumulator.Add(assignments[i], dataset.col(i));
   }
 
+  // Combine calculated state from each thread.
+  accumulator.Reduce(newCentroids, counts);
+
   // Now, normalize and calculate the distance each cluster has moved.
   arma::vec moveDistances(centroids.n_cols);
   double cNorm = 0.0; // Cluster movement for residual.
@@ -163,10 +174,12 @@ double ElkanKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
 
     moveDistances(c) = metric.Evaluate(newCentroids.col(c), centroids.col(c));
     cNorm += std::pow(moveDistances(c), 2.0);
-    distanceCalculations++;
+    iterationDistances++;
   }
+  distanceCalculations += iterationDistances;
 
-  for (size_t i = 0; i < dataset.n_cols; ++i)
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) dataset.n_cols; ++i)
   {
     // Step 5: for each point x and center c, assign
     //   l(x, c) = max { l(x, c) - d(c, m(c)), 0 }.
@@ -15,6 +15,8 @@
 // In case it hasn't been included yet.
 #include "hamerly_kmeans.hpp"
 
+#include "centroid_accumulator.hpp"
+
 namespace mlpack {
 namespace kmeans {
 
@@ -23,6 +25,7 @@ HamerlyKMeans<MetricType, MatType>::HamerlyKMeans(const MatType& dataset,
                                                   MetricType& metric) :
     dataset(dataset),
     metric(metric),
+    distances(dataset, metric),
     distanceCalculations(0)
 {
   // Nothing to do.
@@ -45,29 +48,51 @@ double HamerlyKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
     minClusterDistances.set_size(centroids.n_cols);
   }
 
-  // Reset new centroids.
-  newCentroids.zeros(centroids.n_rows, centroids.n_cols);
-  counts.zeros(centroids.n_cols);
-
-  // Calculate minimum intra-cluster distance for each cluster.
-  minClusterDistances.fill(DBL_MAX);
-  for (size_t i = 0; i < centroids.n_cols; ++i)
+  // Each thread adds its points to its own buffer of the accumulator.
+  CentroidAccumulator accumulator(centroids.n_rows, centroids.n_cols);
+  distances.Centroids(centroids);
+
+  // The distance calculations of this iteration.
+  size_t iterationDistances = 0;
+
+  // Calculate minimum intra-cluster distance for each cluster.  Each thread
+  // keeps its own minimums, since one distance updates the minimums of two
+  // clusters.
+  size_t numThreads = 1;
+  #ifdef HAS_OPENMP
+    numThreads = omp_get_max_threads();
+  #endif
+  arma::mat threadMinDistances(centroids.n_cols, numThreads);
+  threadMinDistances.fill(DBL_MAX);
+
+  #pragma omp parallel for schedule(dynamic) reduction(+:iterationDistances)
+  for (omp_size_t i = 0; i < (omp_size_t) centroids.n_cols; ++i)
   {
+    size_t threadId = 0;
+    #ifdef HAS_OPENMP
+      threadId = omp_get_thread_num();
+    #endif
+
     for (size_t j = i + 1; j < centroids.n_cols; ++j)
     {
       const double dist = metric.Evaluate(centroids.col(i), centroids.col(j)) /
           2.0;
-      ++distanceCalculations;
+      ++iterationDistances;
 
       // Update bounds, if this intra-cluster distance is smaller.
-      if (dist < minClusterDistances(i))
-        minClusterDistances(i) = dist;
-      if (dist < minClusterDistances(j))
-        minClusterDistances(j) = dist;
+      if (dist < threadMinDistances(i, threadId))
+        threadMinDistances(i, threadId) = dist;
+      if (dist < threadMinDistances(j, threadId))
+        threadMinDistances(j, threadId) = dist;
     }
   }
+  minClusterDistances = arma::min(threadMinDistances, 1);
 
-  for (size_t i = 0; i < dataset.n_cols; ++i)
+  // Each point only changes its own bounds, so the points can be handled in
+  // parallel.
+  #pragma omp parallel for schedule(dynamic, 256) \
+      reduction(+:iterationDistances, hamerlyPruned)
+  for (omp_size_t i = 0; i < (omp_size_t) dataset.n_cols; ++i)
   {
     const double m = std::max(minClusterDistances(assignments[i]),
                               lowerBounds(i));
@@ -76,21 +101,18 @@ double HamerlyKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
     if (upperBounds(i) <= m)
     {
       ++hamerlyPruned;
-      newCentroids.col(assignments[i]) += dataset.col(i);
-      ++counts(assignments[i]);
+      accumulator.Add(assignments[i], dataset.col(i));
       continue;
     }
 
     // Tighten upper bound.
-    upperBounds(i) = metric.Evaluate(dataset.col(i),
-                                     centroids.col(assignments[i]));
-    ++distanceCalculations;
+    upperBounds(i) = distances.Evaluate(i, assignments[i]);
+    ++iterationDistances;
 
     // Second bound test.
     if (upperBounds(i) <= m)
     {
-      newCentroids.col(assignments[i]) += dataset.col(i);
-      ++counts(assignments[i]);
+      accumulator.Add(assignments[i], dataset.col(i));
       continue;
     }
 
@@ -103,7 +125,7 @@ double HamerlyKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
       if (c == assignments[i])
         continue;
 
-      const double dist = metric.Evaluate(dataset.col(i), centroids.col(c));
+      const double dist = distances.Evaluate(i, c);
 
       // Is this a better cluster?  At this point, upperBounds[i] = d(i, c(i)).
       if (dist < upperBounds(i))
@@ -119,13 +141,15 @@ double HamerlyKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
         lowerBounds(i) = dist;
       }
     }
-    distanceCalculations += centroids.n_cols - 1;
+    iterationDistances += centroids.n_cols - 1;
 
     // Update new centroids.
-    newCentroids.col(assignments[i]) += dataset.col(i);
-    ++counts(assignments[i]);
+    accumulator.Add(assignments[i], dataset.col(i));
   }
 
+  // Combine calculated state from each thread.
+  accumulator.Reduce(newCentroids, counts);
+
   // Normalize centroids and calculate cluster movement (contains parts of
   // Move-Centers() and Update-Bounds()).
   double furthestMovement = 0.0;
@@ -143,7 +167,7 @@ double HamerlyKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
                                             newCentroids.col(c));
     centroidMovements(c) = movement;
     centroidMovement += std::pow(movement, 2.0);
-    ++distanceCalculations;
+    ++iterationDistances;
 
     if (movement > furthestMovement)
     {
@@ -157,8 +181,11 @@ double HamerlyKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
     }
   }
 
+  distanceCalculations += iterationDistances;
+
   // Now update bounds (lines 3-8 of Update-Bounds()).
-  for (size_t i = 0; i < dataset.n_cols; ++i)
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) dataset.n_cols; ++i)
   {
     upperBounds(i) += centroidMovements(assignments[i]);
     if (assignments[i] == furthestMovingCluster)
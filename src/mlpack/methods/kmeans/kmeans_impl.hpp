@@ -11,9 +11,11 @@
  * http://www.opensource.org/licenses/BSD-3-Clause for more information.
  */
 #include "kmeans.hpp"
+#include "centroid_distance.hpp"
 
 #include <mlpack/core/metrics/lmetric.hpp>
 #include <mlpack/core/util/sfinae_utility.hpp>
+#include <mlpack/core/tree/traversal_statistics.hpp>
 
 namespace mlpack {
 namespace kmeans {
@@ -42,6 +44,38 @@ struct GivesCentroids
         void(*)(const arma::mat&, const size_t, arma::mat&)>::value;
 };
 
+HAS_MEM_FUNC(Statistics, HasTraversalStatisticsCheck);
+
+/**
+ * 'value' is true if the LloydStepType class has a member
+ * const tree::TraversalStatistics& Statistics() const (that is, if it uses
+ * tree traversals).
+ */
+template<typename LloydStepType>
+struct HasTraversalStatistics
+{
+  static const bool value = HasTraversalStatisticsCheck<LloydStepType,
+      const tree::TraversalStatistics&(LloydStepType::*)() const>::value;
+};
+
+//! Print the traversal statistics of the given Lloyd step, if it has any.
+template<typename LloydStepType>
+void PrintTraversalStatistics(
+    const LloydStepType& lloydStep,
+    const typename std::enable_if_t<
+        HasTraversalStatistics<LloydStepType>::value>* = 0)
+{
+  lloydStep.Statistics().Print(Log::Info);
+}
+
+//! Print nothing, since the given Lloyd step has no traversal statistics.
+template<typename LloydStepType>
+void PrintTraversalStatistics(
+    const LloydStepType& /* lloydStep */,
+    const typename std::enable_if_t<
+        !HasTraversalStatistics<LloydStepType>::value>* = 0)
+{ }
+
 //! Call the initial partition policy, if it returns assignments.  This returns
 //! 'true' to indicate that assignments were given.
 template<typename MatType,
@@ -192,7 +226,7 @@ Cluster(const MatType& data,
       centroids.zeros(data.n_rows, clusters);
       for (size_t i = 0; i < data.n_cols; ++i)
       {
-        centroids.col(assignments[i]) += arma::vec(data.col(i));
+        centroids.unsafe_col(assignments[i]) += data.col(i);
         counts[assignments[i]]++;
       }
 
@@ -261,6 +295,7 @@ Cluster(const MatType& data,
   }
   Log::Info << lloydStep.DistanceCalculations() << " distance calculations."
       << std::endl;
+  PrintTraversalStatistics(lloydStep);
 }
 
 /**
@@ -299,7 +334,7 @@ Cluster(const MatType& data,
     centroids.zeros(data.n_rows, clusters);
     for (size_t i = 0; i < data.n_cols; ++i)
     {
-      centroids.col(assignments[i]) += arma::vec(data.col(i));
+      centroids.unsafe_col(assignments[i]) += data.col(i);
       counts[assignments[i]]++;
     }
 
@@ -313,6 +348,8 @@ Cluster(const MatType& data,
 
   // Calculate final assignments in parallel over the entire dataset.
   assignments.set_size(data.n_cols);
+  CentroidDistance<MetricType, MatType> distances(data, metric);
+  distances.Centroids(centroids);
 
   #pragma omp parallel for
   for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
@@ -323,7 +360,7 @@ Cluster(const MatType& data,
 
     for (size_t j = 0; j < centroids.n_cols; j++)
     {
-      const double distance = metric.Evaluate(data.col(i), centroids.col(j));
+      const double distance = distances.Evaluate(i, j);
 
       if (distance < minDistance)
       {
@@ -17,6 +17,8 @@
 #include "allow_empty_clusters.hpp"
 #include "kill_empty_clusters.hpp"
 #include "refined_start.hpp"
+#include "kmeans_plus_plus_initialization.hpp"
+#include "kmeans_parallel_initialization.hpp"
 #include "elkan_kmeans.hpp"
 #include "hamerly_kmeans.hpp"
 #include "pelleg_moore_kmeans.hpp"
@@ -49,6 +51,11 @@ PROGRAM_INFO("K-Means Clustering",
     "used in each sample, the " + PRINT_PARAM_STRING("percentage") +
     " parameter is used (it should be a value between 0.0 and 1.0)."
     "\n\n"
+    "Alternately, the k-means++ strategy can be used to select initial points "
+    "by specifying the " + PRINT_PARAM_STRING("kmeans_plus_plus") + " "
+    "parameter, or its scalable variant k-means|| by specifying the " +
+    PRINT_PARAM_STRING("kmeans_parallel") + " parameter."
+    "\n\n"
     "There are several options available for the algorithm used for each Lloyd "
     "iteration, specified with the " + PRINT_PARAM_STRING("algorithm") + " "
     " option.  The standard O(kN) approach can be used ('naive').  Other "
@@ -140,6 +147,12 @@ PARAM_INT_IN("samplings", "Number of samplings to perform for refined start "
 PARAM_DOUBLE_IN("percentage", "Percentage of dataset to use for each refined "
     "start sampling (use when --refined_start is specified).", "p", 0.02);
 
+// Parameters for k-means++ and k-means||.
+PARAM_FLAG("kmeans_plus_plus", "Use the k-means++ initial point strategy to "
+    "choose initial points.", "k");
+PARAM_FLAG("kmeans_parallel", "Use the k-means|| initial point strategy to "
+    "choose initial points.", "K");
+
 PARAM_STRING_IN("algorithm", "Algorithm to use for the Lloyd iteration "
     "('naive', 'pelleg-moore', 'elkan', 'hamerly', 'dualtree', or "
     "'dualtree-covertree').", "a", "naive");
@@ -168,6 +181,10 @@ static void mlpackMain()
   else
     math::RandomSeed((size_t) std::time(NULL));
 
+  ReportIgnoredParam({{ "refined_start", true }}, "kmeans_plus_plus");
+  ReportIgnoredParam({{ "refined_start", true }}, "kmeans_parallel");
+  ReportIgnoredParam({{ "kmeans_plus_plus", true }}, "kmeans_parallel");
+
   // Now, start building the KMeans type that we'll be using.  Start with the
   // initial partition policy.  The call to FindEmptyClusterPolicy<> results in
   // a call to RunKMeans<> and the algorithm is completed.
@@ -183,6 +200,16 @@ static void mlpackMain()
 
     FindEmptyClusterPolicy<RefinedStart>(RefinedStart(samplings, percentage));
   }
+  else if (CLI::HasParam("kmeans_plus_plus"))
+  {
+    FindEmptyClusterPolicy<KMeansPlusPlusInitialization>(
+        KMeansPlusPlusInitialization());
+  }
+  else if (CLI::HasParam("kmeans_parallel"))
+  {
+    FindEmptyClusterPolicy<KMeansParallelInitialization>(
+        KMeansParallelInitialization());
+  }
   else
   {
     FindEmptyClusterPolicy<SampleInitialization>(SampleInitialization());
@@ -266,7 +293,10 @@ void RunKMeans(const InitialPartitionPolicy& ipp)
   RequireAtLeastOnePassed({ "in_place", "output", "centroid" }, false,
       "no results will be saved");
 
-  arma::mat dataset = CLI::GetParam<arma::mat>("input");  // Load our dataset.
+  // Copy our dataset with the threads that will cluster it, so that on NUMA
+  // machines each thread reads its points from local memory.
+  arma::mat dataset;
+  math::FirstTouchCopy(CLI::GetParam<arma::mat>("input"), dataset);
   arma::mat centroids;
 
   const bool initialCentroidGuess = CLI::HasParam("initial_centroids");
@@ -278,6 +308,8 @@ void RunKMeans(const InitialPartitionPolicy& ipp)
       clusters = centroids.n_cols;
 
     ReportIgnoredParam({{ "refined_start", true }}, "initial_centroids");
+    ReportIgnoredParam({{ "kmeans_plus_plus", true }}, "initial_centroids");
+    ReportIgnoredParam({{ "kmeans_parallel", true }}, "initial_centroids");
 
     if (!CLI::HasParam("refined_start"))
       Log::Info << "Using initial centroid guesses." << endl;
@@ -0,0 +1,104 @@
+/**
+ * @file methods/kmeans/kmeans_parallel_initialization.hpp
+ *
+ * The k-means|| strategy for choosing initial centroids, a scalable variant of
+ * k-means++ that samples many candidate centroids in each pass over the data.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_KMEANS_PARALLEL_INITIALIZATION_HPP
+#define MLPACK_METHODS_KMEANS_KMEANS_PARALLEL_INITIALIZATION_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "kmeans_plus_plus_initialization.hpp"
+
+namespace mlpack {
+namespace kmeans {
+
+/**
+ * An initialization strategy for k-means that gives centroids of the same
+ * quality as k-means++ with only a few passes over the data.  After a first
+ * centroid is chosen at random, each of a small number of rounds samples every
+ * point independently, with probability proportional to its squared distance
+ * to the closest candidate so far; about (oversampling * clusters) candidates
+ * are added in each round.  Each candidate is then weighted by the number of
+ * points closest to it, and the weighted candidates are reduced to the
+ * requested number of centroids with k-means++.  The passes over the data are
+ * parallelized with OpenMP.  This is an implementation of the following paper:
+ *
+ * @code
+ * @article{bahmani2012scalable,
+ *   title={Scalable k-means++},
+ *   author={Bahmani, Bahman and Moseley, Benjamin and Vattani, Andrea and
+ *       Kumar, Ravi and Vassilvitskii, Sergei},
+ *   journal={Proceedings of the VLDB Endowment},
+ *   volume={5},
+ *   number={7},
+ *   pages={622--633},
+ *   year={2012}
+ * }
+ * @endcode
+ */
+class KMeansParallelInitialization
+{
+ public:
+  /**
+   * Create the KMeansParallelInitialization object, optionally specifying the
+   * oversampling factor and the number of rounds.
+   *
+   * @param oversampling Expected number of candidates sampled in each round,
+   *     as a multiple of the number of clusters.
+   * @param rounds Number of sampling rounds.
+   */
+  KMeansParallelInitialization(const double oversampling = 2.0,
+                               const size_t rounds = 5) :
+      oversampling(oversampling), rounds(rounds) { }
+
+  /**
+   * Initialize the centroids matrix with the k-means|| sampling scheme.
+   *
+   * @tparam MatType Type of data (arma::mat or arma::sp_mat).
+   * @param data Dataset.
+   * @param clusters Number of clusters.
+   * @param centroids Matrix to put initial centroids into.
+   */
+  template<typename MatType>
+  void Cluster(const MatType& data,
+               const size_t clusters,
+               arma::mat& centroids) const;
+
+  //! Get the oversampling factor.
+  double Oversampling() const { return oversampling; }
+  //! Modify the oversampling factor.
+  double& Oversampling() { return oversampling; }
+
+  //! Get the number of sampling rounds.
+  size_t Rounds() const { return rounds; }
+  //! Modify the number of sampling rounds.
+  size_t& Rounds() { return rounds; }
+
+  //! Serialize the object.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(oversampling);
+    ar & BOOST_SERIALIZATION_NVP(rounds);
+  }
+
+ private:
+  //! The expected number of candidates in each round, per cluster.
+  double oversampling;
+  //! The number of sampling rounds.
+  size_t rounds;
+};
+
+} // namespace kmeans
+} // namespace mlpack
+
+// Include implementation.
+#include "kmeans_parallel_initialization_impl.hpp"
+
+#endif
@@ -0,0 +1,101 @@
+/**
+ * @file methods/kmeans/kmeans_parallel_initialization_impl.hpp
+ *
+ * Implementation of the k-means|| sampling scheme.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_KMEANS_PARALLEL_INITIALIZATION_IMPL_HPP
+#define MLPACK_METHODS_KMEANS_KMEANS_PARALLEL_INITIALIZATION_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "kmeans_parallel_initialization.hpp"
+
+namespace mlpack {
+namespace kmeans {
+
+template<typename MatType>
+void KMeansParallelInitialization::Cluster(const MatType& data,
+                                           const size_t clusters,
+                                           arma::mat& centroids) const
+{
+  // The squared distance from each point to its closest candidate, and the
+  // index of that candidate.
+  arma::vec minDistances(data.n_cols);
+  minDistances.fill(DBL_MAX);
+  arma::Col<size_t> closest(data.n_cols, arma::fill::zeros);
+
+  // Start with one candidate, chosen uniformly at random.
+  std::vector<size_t> candidates;
+  candidates.push_back((size_t) math::RandInt(data.n_cols));
+
+  size_t start = 0; // The first candidate that distances were not updated for.
+  for (size_t round = 0; round <= rounds; ++round)
+  {
+    // Update the distances with the new candidates, and compute the cost of
+    // the current candidates.
+    double cost = 0.0;
+    #pragma omp parallel for reduction(+:cost)
+    for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+    {
+      for (size_t c = start; c < candidates.size(); ++c)
+      {
+        const double distance = metric::SquaredEuclideanDistance::Evaluate(
+            data.col(i), data.col(candidates[c]));
+        if (distance < minDistances[i])
+        {
+          minDistances[i] = distance;
+          closest[i] = c;
+        }
+      }
+
+      cost += minDistances[i];
+    }
+    start = candidates.size();
+
+    // After the last round, the distances only need to be up to date.  If the
+    // cost is 0, every point is already a candidate.
+    if (round == rounds || cost == 0.0)
+      break;
+
+    // Sample each point independently, so that about (oversampling * clusters)
+    // points are sampled.
+    const double factor = oversampling * clusters / cost;
+    const arma::vec thresholds = arma::randu<arma::vec>(data.n_cols);
+    for (size_t i = 0; i < data.n_cols; ++i)
+      if (thresholds[i] < factor * minDistances[i])
+        candidates.push_back(i);
+  }
+
+  // Weight each candidate by the number of points closest to it.
+  arma::vec weights(candidates.size(), arma::fill::zeros);
+  for (size_t i = 0; i < data.n_cols; ++i)
+    weights[closest[i]] += 1.0;
+
+  arma::mat candidateMat(data.n_rows, candidates.size());
+  for (size_t c = 0; c < candidates.size(); ++c)
+    candidateMat.col(c) = arma::vec(data.col(candidates[c]));
+
+  if (candidates.size() <= clusters)
+  {
+    // There are too few candidates, so use them all, and fill the remaining
+    // centroids with random points.
+    centroids.set_size(data.n_rows, clusters);
+    centroids.cols(0, candidates.size() - 1) = candidateMat;
+    for (size_t c = candidates.size(); c < clusters; ++c)
+      centroids.col(c) = data.col((size_t) math::RandInt(data.n_cols));
+  }
+  else
+  {
+    // Reduce the weighted candidates to the requested number of clusters.
+    KMeansPlusPlusSample(candidateMat, weights, clusters, centroids);
+  }
+}
+
+} // namespace kmeans
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,92 @@
+/**
+ * @file methods/kmeans/kmeans_plus_plus_initialization.hpp
+ *
+ * The k-means++ strategy for choosing initial centroids: each centroid is
+ * sampled from the dataset with probability proportional to the squared
+ * distance to the closest centroid already chosen.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_KMEANS_PLUS_PLUS_INITIALIZATION_HPP
+#define MLPACK_METHODS_KMEANS_KMEANS_PLUS_PLUS_INITIALIZATION_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/random.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
+
+namespace mlpack {
+namespace kmeans {
+
+/**
+ * Choose the given number of points of the dataset as centroids with the
+ * k-means++ sampling scheme.  If weights are given, the point i is treated as
+ * weights[i] copies of itself (this is used by KMeansParallelInitialization).
+ * The distances to the chosen centroids are updated in parallel with OpenMP.
+ *
+ * @tparam MatType Type of data (arma::mat or arma::sp_mat).
+ * @param data Dataset to choose the centroids from.
+ * @param weights Weight of each point, or an empty vector for unit weights.
+ * @param clusters Number of centroids to choose.
+ * @param centroids Matrix to store the centroids into.
+ */
+template<typename MatType>
+void KMeansPlusPlusSample(const MatType& data,
+                          const arma::vec& weights,
+                          const size_t clusters,
+                          arma::mat& centroids);
+
+/**
+ * An initialization strategy for k-means that chooses the first centroid
+ * uniformly at random from the dataset, and then each other centroid with
+ * probability proportional to its squared distance to the closest centroid
+ * chosen so far.  This gives centroids that are spread over the dataset, and
+ * usually makes the Lloyd iterations converge much faster than with
+ * SampleInitialization.  It is an implementation of the following paper:
+ *
+ * @code
+ * @inproceedings{arthur2007kmeans,
+ *   title={k-means++: The advantages of careful seeding},
+ *   author={Arthur, David and Vassilvitskii, Sergei},
+ *   booktitle={Proceedings of the Eighteenth Annual ACM-SIAM Symposium on
+ *       Discrete Algorithms (SODA '07)},
+ *   pages={1027--1035},
+ *   year={2007}
+ * }
+ * @endcode
+ *
+ * Each centroid requires a pass over the dataset, so for large numbers of
+ * clusters, KMeansParallelInitialization may be faster.
+ */
+class KMeansPlusPlusInitialization
+{
+ public:
+  //! Empty constructor, required by the InitialPartitionPolicy type definition.
+  KMeansPlusPlusInitialization() { }
+
+  /**
+   * Initialize the centroids matrix with the k-means++ sampling scheme.
+   *
+   * @tparam MatType Type of data (arma::mat or arma::sp_mat).
+   * @param data Dataset.
+   * @param clusters Number of clusters.
+   * @param centroids Matrix to put initial centroids into.
+   */
+  template<typename MatType>
+  inline static void Cluster(const MatType& data,
+                             const size_t clusters,
+                             arma::mat& centroids)
+  {
+    KMeansPlusPlusSample(data, arma::vec(), clusters, centroids);
+  }
+};
+
+} // namespace kmeans
+} // namespace mlpack
+
+// Include implementation.
+#include "kmeans_plus_plus_initialization_impl.hpp"
+
+#endif
@@ -0,0 +1,84 @@
+/**
+ * @file methods/kmeans/kmeans_plus_plus_initialization_impl.hpp
+ *
+ * Implementation of the k-means++ sampling scheme.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_KMEANS_PLUS_PLUS_INITIALIZATION_IMPL_HPP
+#define MLPACK_METHODS_KMEANS_KMEANS_PLUS_PLUS_INITIALIZATION_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "kmeans_plus_plus_initialization.hpp"
+
+namespace mlpack {
+namespace kmeans {
+
+template<typename MatType>
+void KMeansPlusPlusSample(const MatType& data,
+                          const arma::vec& weights,
+                          const size_t clusters,
+                          arma::mat& centroids)
+{
+  const bool weighted = !weights.is_empty();
+  centroids.set_size(data.n_rows, clusters);
+  if (clusters == 0)
+    return;
+
+  // The squared distance from each point to its closest centroid so far.
+  arma::vec minDistances(data.n_cols);
+  minDistances.fill(DBL_MAX);
+
+  // The first centroid is sampled according to the weights only.
+  arma::vec probabilities = weighted ? weights :
+      arma::ones<arma::vec>(data.n_cols);
+  double total = arma::accu(probabilities);
+
+  for (size_t c = 0; c < clusters; ++c)
+  {
+    // Sample a point with probability proportional to its entry in
+    // probabilities.  If every point is already a centroid, any point will do.
+    size_t index = (size_t) math::RandInt(data.n_cols);
+    if (total > 0.0)
+    {
+      const double target = math::Random() * total;
+      double sum = 0.0;
+      for (size_t i = 0; i < data.n_cols; ++i)
+      {
+        sum += probabilities[i];
+        if (sum > target && probabilities[i] > 0.0)
+        {
+          index = i;
+          break;
+        }
+      }
+    }
+
+    centroids.col(c) = data.col(index);
+    if (c + 1 == clusters)
+      break;
+
+    // Update the distances to the closest centroid with the new centroid.
+    total = 0.0;
+    #pragma omp parallel for reduction(+:total)
+    for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+    {
+      const double distance = metric::SquaredEuclideanDistance::Evaluate(
+          data.col(i), centroids.col(c));
+      if (distance < minDistances[i])
+        minDistances[i] = distance;
+
+      probabilities[i] = weighted ? weights[i] * minDistances[i] :
+          minDistances[i];
+      total += probabilities[i];
+    }
+  }
+}
+
+} // namespace kmeans
+} // namespace mlpack
+
+#endif
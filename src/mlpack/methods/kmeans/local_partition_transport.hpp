@@ -0,0 +1,238 @@
+/**
+ * @file methods/kmeans/local_partition_transport.hpp
+ *
+ * Defines the LocalPartitionTransport class, the transport of
+ * DistributedKMeans for partitions held in the process itself.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_LOCAL_PARTITION_TRANSPORT_HPP
+#define MLPACK_METHODS_KMEANS_LOCAL_PARTITION_TRANSPORT_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
+
+#include "naive_kmeans.hpp"
+
+namespace mlpack {
+namespace kmeans {
+
+/**
+ * A transport for DistributedKMeans whose partitions are held in the process
+ * itself.  This is the reference implementation of the transport interface
+ * (see DistributedKMeans): a transport to the ranks of an MPI job implements
+ * the same methods by broadcasting the centroids and all-reducing the sums and
+ * counts, each rank running the Lloyd step on its own partition.
+ *
+ * Each call to Iterate() runs one iteration of the given LloydStepType on each
+ * partition, with a new LloydStepType object: the steps that keep bounds from
+ * the centroids they computed (ElkanKMeans, HamerlyKMeans, DualTreeKMeans)
+ * would otherwise use bounds computed from the centroids of their partition
+ * instead of the global ones.
+ *
+ * @tparam MetricType The distance metric.
+ * @tparam MatType The type of the data.
+ * @tparam LloydStepType The Lloyd step run on each partition.
+ */
+template<typename MetricType = metric::EuclideanDistance,
+         typename MatType = arma::mat,
+         template<class, class> class LloydStepType = NaiveKMeans>
+class LocalPartitionTransport
+{
+ public:
+  //! Create a transport without partitions.
+  LocalPartitionTransport(const MetricType metric = MetricType()) :
+      numPoints(0),
+      distanceCalculations(0),
+      metric(metric)
+  { }
+
+  /**
+   * Split the given dataset into the given number of partitions of contiguous
+   * points (of nearly equal size).
+   *
+   * @param data The dataset.
+   * @param numPartitions The number of partitions.
+   * @param metric Instantiated metric.
+   */
+  LocalPartitionTransport(const MatType& data,
+                          const size_t numPartitions,
+                          const MetricType metric = MetricType()) :
+      numPoints(0),
+      distanceCalculations(0),
+      metric(metric)
+  {
+    if (numPartitions == 0 || numPartitions > data.n_cols)
+    {
+      throw std::invalid_argument("LocalPartitionTransport: the number of "
+          "partitions must be between 1 and the number of points!");
+    }
+
+    for (size_t p = 0; p < numPartitions; ++p)
+    {
+      const size_t first = p * data.n_cols / numPartitions;
+      const size_t last = (p + 1) * data.n_cols / numPartitions - 1;
+      AddPartition(data.cols(first, last));
+    }
+  }
+
+  /**
+   * Add a partition with the given points.  In order to avoid copying the
+   * points, consider passing them with std::move().
+   *
+   * @param partition The points of the partition.
+   */
+  void AddPartition(MatType partition)
+  {
+    if (!partitions.empty() && partition.n_rows != partitions[0].n_rows)
+    {
+      throw std::invalid_argument("LocalPartitionTransport::AddPartition(): "
+          "the partitions must have the same dimensionality!");
+    }
+
+    numPoints += partition.n_cols;
+    partitions.push_back(std::move(partition));
+  }
+
+  //! Get the number of partitions.
+  size_t NumPartitions() const { return partitions.size(); }
+
+  //! Get the total number of points.
+  size_t NumPoints() const { return numPoints; }
+
+  //! Get the dimensionality of the points.
+  size_t Dimensionality() const
+  { return partitions.empty() ? 0 : partitions[0].n_rows; }
+
+  //! Get the given partition.
+  const MatType& Partition(const size_t partition) const
+  { return partitions[partition]; }
+
+  /**
+   * Run one Lloyd iteration on every partition with the given centroids, and
+   * sum the results.
+   *
+   * @param centroids The current centroids.
+   * @param sums Will be set to the sum of the points of each cluster.
+   * @param counts Will be set to the number of points of each cluster.
+   */
+  void Iterate(const arma::mat& centroids,
+               arma::mat& sums,
+               arma::Col<size_t>& counts)
+  {
+    sums.zeros(centroids.n_rows, centroids.n_cols);
+    counts.zeros(centroids.n_cols);
+
+    arma::mat partitionCentroids;
+    arma::Col<size_t> partitionCounts;
+    for (size_t p = 0; p < partitions.size(); ++p)
+    {
+      LloydStepType<MetricType, MatType> step(partitions[p], metric);
+      step.Iterate(centroids, partitionCentroids, partitionCounts);
+      distanceCalculations += step.DistanceCalculations();
+
+      // The step gives the mean of the points of each cluster.
+      for (size_t c = 0; c < centroids.n_cols; ++c)
+      {
+        if (partitionCounts[c] > 0)
+        {
+          sums.col(c) += partitionCounts[c] * partitionCentroids.col(c);
+          counts[c] += partitionCounts[c];
+        }
+      }
+    }
+  }
+
+  /**
+   * Draw points at random from the partitions, from each one in proportion to
+   * its size.
+   *
+   * @param size The number of points to draw (about).
+   * @param sample Will be set to the points drawn.
+   */
+  void Sample(const size_t size, arma::mat& sample) const
+  {
+    std::vector<arma::mat> samples(partitions.size());
+    size_t total = 0;
+    for (size_t p = 0; p < partitions.size(); ++p)
+    {
+      const size_t partitionSize = std::min((size_t) partitions[p].n_cols,
+          (size_t) std::ceil((double) size * partitions[p].n_cols /
+          numPoints));
+      const arma::uvec indices = arma::randperm(partitions[p].n_cols,
+          partitionSize);
+      samples[p] = arma::mat(partitions[p].cols(indices));
+      total += partitionSize;
+    }
+
+    sample.set_size(Dimensionality(), total);
+    size_t offset = 0;
+    for (size_t p = 0; p < samples.size(); ++p)
+    {
+      if (samples[p].n_cols > 0)
+        sample.cols(offset, offset + samples[p].n_cols - 1) = samples[p];
+      offset += samples[p].n_cols;
+    }
+  }
+
+  /**
+   * Assign each point of each partition to its closest centroid.
+   *
+   * @param centroids The centroids.
+   * @param assignments Will be set to the assignments of each partition.
+   */
+  void Assign(const arma::mat& centroids,
+              std::vector<arma::Row<size_t>>& assignments)
+  {
+    assignments.resize(partitions.size());
+    for (size_t p = 0; p < partitions.size(); ++p)
+    {
+      const MatType& partition = partitions[p];
+      assignments[p].set_size(partition.n_cols);
+
+      #pragma omp parallel for
+      for (omp_size_t i = 0; i < (omp_size_t) partition.n_cols; ++i)
+      {
+        double minDistance = std::numeric_limits<double>::infinity();
+        size_t closestCluster = 0;
+        for (size_t c = 0; c < centroids.n_cols; ++c)
+        {
+          const double distance = metric.Evaluate(partition.col(i),
+              centroids.col(c));
+          if (distance < minDistance)
+          {
+            minDistance = distance;
+            closestCluster = c;
+          }
+        }
+
+        assignments[p][i] = closestCluster;
+      }
+      distanceCalculations += partition.n_cols * centroids.n_cols;
+    }
+  }
+
+  //! Get the number of distance calculations.
+  size_t DistanceCalculations() const { return distanceCalculations; }
+
+ private:
+  //! The partitions.
+  std::vector<MatType> partitions;
+
+  //! The total number of points.
+  size_t numPoints;
+
+  //! The number of distance calculations.
+  size_t distanceCalculations;
+
+  //! The instantiated metric.
+  MetricType metric;
+};
+
+} // namespace kmeans
+} // namespace mlpack
+
+#endif
@@ -14,6 +14,7 @@
 
 // Just in case it has not been included.
 #include "max_variance_new_cluster.hpp"
+#include "centroid_distance.hpp"
 
 namespace mlpack {
 namespace kmeans {
@@ -45,14 +46,16 @@ void MaxVarianceNewCluster::EmptyCluster(const MatType& data,
     return;
 
   // Now, inside this cluster, find the point which is furthest away.
+  CentroidDistance<MetricType, MatType> distances(data, metric);
+  distances.Centroids(newCentroids);
   size_t furthestPoint = data.n_cols;
   double maxDistance = -DBL_MAX;
   for (size_t i = 0; i < data.n_cols; ++i)
   {
     if (assignments[i] == maxVarCluster)
     {
-      const double distance = std::pow(metric.Evaluate(data.col(i),
-          newCentroids.col(maxVarCluster)), 2.0);
+      const double distance = std::pow(distances.Evaluate(i, maxVarCluster),
+          2.0);
 
       if (distance > maxDistance)
       {
@@ -123,6 +126,9 @@ void MaxVarianceNewCluster::Precalculate(const MatType& data,
   variances.zeros(oldCentroids.n_cols);
   assignments.set_size(data.n_cols);
 
+  CentroidDistance<MetricType, MatType> distances(data, metric);
+  distances.Centroids(oldCentroids);
+
   // Add the variance of each point's distance away from the cluster.  I think
   // this is the sensible thing to do.
   for (size_t i = 0; i < data.n_cols; ++i)
@@ -133,7 +139,7 @@ void MaxVarianceNewCluster::Precalculate(const MatType& data,
 
     for (size_t j = 0; j < oldCentroids.n_cols; j++)
     {
-      const double distance = metric.Evaluate(data.col(i), oldCentroids.col(j));
+      const double distance = distances.Evaluate(i, j);
 
       if (distance < minDistance)
       {
@@ -143,8 +149,7 @@ void MaxVarianceNewCluster::Precalculate(const MatType& data,
     }
 
     assignments[i] = closestCluster;
-    variances[closestCluster] += std::pow(metric.Evaluate(data.col(i),
-        oldCentroids.col(closestCluster)), 2.0);
+    variances[closestCluster] += std::pow(minDistance, 2.0);
   }
 
   // Divide by the number of points in the cluster to produce the variance,
@@ -0,0 +1,129 @@
+/**
+ * @file methods/kmeans/mini_batch_kmeans.hpp
+ *
+ * An implementation of a step of Sculley's mini-batch k-means algorithm.  Each
+ * iteration looks at only a small random sample of the dataset, and moves each
+ * centroid towards the points assigned to it with a learning rate that shrinks
+ * as the centroid is given more points.
+ *
+ * The algorithm is described in the following paper:
+ *
+ * @code
+ * @inproceedings{sculley2010web,
+ *   title={Web-scale k-means clustering},
+ *   author={Sculley, D.},
+ *   booktitle={Proceedings of the 19th International Conference on World Wide
+ *       Web (WWW '10)},
+ *   pages={1177--1178},
+ *   year={2010}
+ * }
+ * @endcode
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_MINI_BATCH_KMEANS_HPP
+#define MLPACK_METHODS_KMEANS_MINI_BATCH_KMEANS_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/random.hpp>
+
+namespace mlpack {
+namespace kmeans {
+
+/**
+ * Update the given centroids with one mini-batch of points.  Each point of the
+ * batch is first assigned to its closest centroid; then, for each point in
+ * turn, its centroid c is moved towards it with a learning rate of 1 / v(c),
+ * where v(c) is the number of points c has been given so far (including this
+ * one).
+ *
+ * @param batch Points of the mini-batch.
+ * @param metric Instantiated metric.
+ * @param centroids Centroids to update.
+ * @param counts Number of points each centroid has been given so far; this is
+ *     updated with the points of the batch.
+ * @return Number of distance calculations performed.
+ */
+template<typename MetricType, typename BatchType>
+size_t MiniBatchUpdate(const BatchType& batch,
+                       MetricType& metric,
+                       arma::mat& centroids,
+                       arma::Col<size_t>& counts);
+
+/**
+ * This is an implementation of a single iteration of Sculley's mini-batch
+ * k-means algorithm, for use as the LloydStepType of the KMeans class.  Each
+ * iteration draws a random sample of BatchSize() points from the dataset and
+ * updates the centroids with MiniBatchUpdate().  The number of points given to
+ * each centroid is kept across iterations, so the centroids move less and less
+ * and the residual decreases until KMeans stops.
+ *
+ * The counts returned by Iterate() are the number of points each centroid has
+ * been given over all iterations so far, so a cluster is only reported empty
+ * if it has never been the closest centroid of any sampled point.
+ *
+ * To cluster a dataset that does not fit in memory, see StreamingKMeans.
+ *
+ * @tparam MetricType Type of metric used with this implementation.
+ * @tparam MatType Matrix type (arma::mat or arma::sp_mat).
+ */
+template<typename MetricType, typename MatType>
+class MiniBatchKMeans
+{
+ public:
+  /**
+   * Construct the MiniBatchKMeans object with the given dataset and metric.
+   *
+   * @param dataset Dataset.
+   * @param metric Instantiated metric.
+   * @param batchSize Number of points to sample at each iteration.
+   */
+  MiniBatchKMeans(const MatType& dataset,
+                  MetricType& metric,
+                  const size_t batchSize = 1000);
+
+  /**
+   * Run a single iteration of mini-batch k-means, updating the given centroids
+   * into the newCentroids matrix.
+   *
+   * @param centroids Current cluster centroids.
+   * @param newCentroids New cluster centroids.
+   * @param counts Number of points given to each cluster so far.
+   */
+  double Iterate(const arma::mat& centroids,
+                 arma::mat& newCentroids,
+                 arma::Col<size_t>& counts);
+
+  //! Get the number of distance calculations.
+  size_t DistanceCalculations() const { return distanceCalculations; }
+
+  //! Get the number of points sampled at each iteration.
+  size_t BatchSize() const { return batchSize; }
+  //! Modify the number of points sampled at each iteration.
+  size_t& BatchSize() { return batchSize; }
+
+ private:
+  //! The dataset.
+  const MatType& dataset;
+  //! The instantiated metric.
+  MetricType& metric;
+
+  //! The number of points sampled at each iteration.
+  size_t batchSize;
+  //! The number of points given to each centroid so far.
+  arma::Col<size_t> centroidCounts;
+
+  //! Number of distance calculations.
+  size_t distanceCalculations;
+};
+
+} // namespace kmeans
+} // namespace mlpack
+
+// Include implementation.
+#include "mini_batch_kmeans_impl.hpp"
+
+#endif
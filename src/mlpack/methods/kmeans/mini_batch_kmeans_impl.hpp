@@ -0,0 +1,114 @@
+/**
+ * @file methods/kmeans/mini_batch_kmeans_impl.hpp
+ *
+ * Implementation of a step of Sculley's mini-batch k-means algorithm.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_MINI_BATCH_KMEANS_IMPL_HPP
+#define MLPACK_METHODS_KMEANS_MINI_BATCH_KMEANS_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "mini_batch_kmeans.hpp"
+
+namespace mlpack {
+namespace kmeans {
+
+template<typename MetricType, typename BatchType>
+size_t MiniBatchUpdate(const BatchType& batch,
+                       MetricType& metric,
+                       arma::mat& centroids,
+                       arma::Col<size_t>& counts)
+{
+  // First, find the closest centroid to each point of the batch, with the
+  // centroids as they are at the start of the batch.
+  arma::Col<size_t> assignments(batch.n_cols);
+
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) batch.n_cols; ++i)
+  {
+    double minDistance = std::numeric_limits<double>::infinity();
+    size_t closestCluster = centroids.n_cols; // Invalid value.
+
+    for (size_t j = 0; j < centroids.n_cols; j++)
+    {
+      const double distance = metric.Evaluate(batch.col(i),
+          centroids.unsafe_col(j));
+      if (distance < minDistance)
+      {
+        minDistance = distance;
+        closestCluster = j;
+      }
+    }
+
+    Log::Assert(closestCluster != centroids.n_cols);
+    assignments[i] = closestCluster;
+  }
+
+  // Now move each centroid towards its points, with a per-centroid learning
+  // rate.  This must be done in order, since each step depends on the count.
+  for (size_t i = 0; i < batch.n_cols; ++i)
+  {
+    const size_t c = assignments[i];
+    const double eta = 1.0 / (double) (++counts[c]);
+    centroids.col(c) = (1.0 - eta) * centroids.col(c) +
+        eta * arma::vec(batch.col(i));
+  }
+
+  return batch.n_cols * centroids.n_cols;
+}
+
+template<typename MetricType, typename MatType>
+MiniBatchKMeans<MetricType, MatType>::MiniBatchKMeans(const MatType& dataset,
+                                                      MetricType& metric,
+                                                      const size_t batchSize) :
+    dataset(dataset),
+    metric(metric),
+    batchSize(batchSize),
+    distanceCalculations(0)
+{ /* Nothing to do. */ }
+
+// Run a single iteration.
+template<typename MetricType, typename MatType>
+double MiniBatchKMeans<MetricType, MatType>::Iterate(
+    const arma::mat& centroids,
+    arma::mat& newCentroids,
+    arma::Col<size_t>& counts)
+{
+  // Start counting the points given to each centroid on the first iteration.
+  if (centroidCounts.n_elem != centroids.n_cols)
+    centroidCounts.zeros(centroids.n_cols);
+
+  // Draw the mini-batch from the dataset.
+  const size_t numPoints = std::min(batchSize, (size_t) dataset.n_cols);
+  arma::mat batch(dataset.n_rows, numPoints);
+  for (size_t i = 0; i < numPoints; ++i)
+  {
+    const size_t index = (size_t) math::RandInt(dataset.n_cols);
+    batch.col(i) = arma::vec(dataset.col(index));
+  }
+
+  newCentroids = centroids;
+  distanceCalculations += MiniBatchUpdate(batch, metric, newCentroids,
+      centroidCounts);
+  counts = centroidCounts;
+
+  // Calculate cluster distortion for this iteration.
+  double cNorm = 0.0;
+  for (size_t i = 0; i < centroids.n_cols; ++i)
+  {
+    cNorm += std::pow(metric.Evaluate(centroids.col(i), newCentroids.col(i)),
+        2.0);
+  }
+  distanceCalculations += centroids.n_cols;
+
+  return std::sqrt(cNorm);
+}
+
+} // namespace kmeans
+} // namespace mlpack
+
+#endif
@@ -15,6 +15,9 @@
 #ifndef MLPACK_METHODS_KMEANS_NAIVE_KMEANS_HPP
 #define MLPACK_METHODS_KMEANS_NAIVE_KMEANS_HPP
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
+
+#include "centroid_accumulator.hpp"
 
 namespace mlpack {
 namespace kmeans {
@@ -25,6 +28,15 @@ namespace kmeans {
  * looking for the mlpack::kmeans::KMeans class instead of this one.  This class
  * is used by KMeans as the actual implementation of the Lloyd iteration.
  *
+ * With the (squared) Euclidean distance and double-precision data, the points
+ * are assigned to their closest centroids in blocks: the distances of a block
+ * of points to all the centroids are computed with a single matrix
+ * multiplication, as ||c||^2 - 2 C^T x (||x||^2 does not change which centroid
+ * is closest).  With many centroids this is much faster than evaluating the
+ * metric for each pair.  With sparse data the multiplication only visits the
+ * nonzero elements of the points, so this also suits very high-dimensional
+ * data such as TF-IDF features.
+ *
  * @param MetricType Type of metric used with this implementation.
  * @param MatType Matrix type (arma::mat or arma::sp_mat).
  */
@@ -57,6 +69,28 @@ class NaiveKMeans
   size_t DistanceCalculations() const { return distanceCalculations; }
 
  private:
+  /**
+   * Assign each point to its closest centroid and add it to the accumulator,
+   * using matrix multiplications over blocks of points.
+   */
+  template<bool TakeRoot, typename AnyMatType = MatType>
+  void Assign(const metric::LMetric<2, TakeRoot>& /* metric */,
+              const arma::mat& centroids,
+              CentroidAccumulator& accumulator,
+              const typename std::enable_if_t<
+                  std::is_same<typename AnyMatType::elem_type,
+                               double>::value>* = 0);
+
+  /**
+   * Assign each point to its closest centroid and add it to the accumulator,
+   * evaluating the metric for each pair of point and centroid.  This is used
+   * for every metric other than the Euclidean distance.
+   */
+  template<typename AnyMetricType>
+  void Assign(const AnyMetricType& /* metric */,
+              const arma::mat& centroids,
+              CentroidAccumulator& accumulator);
+
   //! The dataset.
   const MatType& dataset;
   //! The instantiated metric.
@@ -36,49 +36,14 @@ double NaiveKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
                                                  arma::mat& newCentroids,
                                                  arma::Col<size_t>& counts)
 {
-  newCentroids.zeros(centroids.n_rows, centroids.n_cols);
-  counts.zeros(centroids.n_cols);
+  // Each thread adds its points to its own buffer of the accumulator.
+  CentroidAccumulator accumulator(centroids.n_rows, centroids.n_cols);
 
   // Find the closest centroid to each point and update the new centroids.
-  // Computed in parallel over the complete dataset
-  #pragma omp parallel
-  {
-    // The current state of the K-means is private for each thread
-    arma::mat localCentroids(centroids.n_rows, centroids.n_cols,
-        arma::fill::zeros);
-    arma::Col<size_t> localCounts(centroids.n_cols, arma::fill::zeros);
-
-    #pragma omp for
-    for (omp_size_t i = 0; i < (omp_size_t) dataset.n_cols; ++i)
-    {
-      // Find the closest centroid to this point.
-      double minDistance = std::numeric_limits<double>::infinity();
-      size_t closestCluster = centroids.n_cols; // Invalid value.
+  Assign(metric, centroids, accumulator);
 
-      for (size_t j = 0; j < centroids.n_cols; j++)
-      {
-        const double distance = metric.Evaluate(dataset.col(i),
-            centroids.unsafe_col(j));
-        if (distance < minDistance)
-        {
-          minDistance = distance;
-          closestCluster = j;
-        }
-      }
-
-      Log::Assert(closestCluster != centroids.n_cols);
-
-      // We now have the minimum distance centroid index.  Update that centroid.
-      localCentroids.unsafe_col(closestCluster) += dataset.col(i);
-      localCounts(closestCluster)++;
-    }
-    // Combine calculated state from each thread
-    #pragma omp critical
-    {
-      newCentroids += localCentroids;
-      counts += localCounts;
-    }
-  }
+  // Combine calculated state from each thread.
+  accumulator.Reduce(newCentroids, counts);
 
   // Now normalize the centroid.
   for (size_t i = 0; i < centroids.n_cols; ++i)
@@ -99,6 +64,82 @@ double NaiveKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
   return std::sqrt(cNorm);
 }
 
+template<typename MetricType, typename MatType>
+template<bool TakeRoot, typename AnyMatType>
+void NaiveKMeans<MetricType, MatType>::Assign(
+    const metric::LMetric<2, TakeRoot>& /* metric */,
+    const arma::mat& centroids,
+    CentroidAccumulator& accumulator,
+    const typename std::enable_if_t<
+        std::is_same<typename AnyMatType::elem_type, double>::value>*)
+{
+  // The squared norm of each centroid.
+  const arma::rowvec centroidNorms = arma::sum(arma::square(centroids), 0);
+
+  // Blocks hold about 2^16 distances, so that the distances of each thread fit
+  // in cache, and there are enough points per block for an efficient matrix
+  // multiplication even with thousands of centroids.
+  const size_t blockSize = std::max((size_t) 64,
+      (size_t) 65536 / centroids.n_cols);
+  const size_t numBlocks = (dataset.n_cols + blockSize - 1) / blockSize;
+
+  // Computed in parallel over the complete dataset.  The static schedule keeps
+  // each thread on the same columns in every iteration, so that a dataset
+  // placed with math::FirstTouch() is read from local memory.
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t block = 0; block < (omp_size_t) numBlocks; ++block)
+  {
+    const size_t first = block * blockSize;
+    const size_t last = std::min(first + blockSize, (size_t) dataset.n_cols)
+        - 1;
+
+    // Each column holds the squared distances of one point to the centroids,
+    // minus the squared norm of the point.
+    // (For sparse data, the product only visits the nonzero elements.)
+    arma::mat distances = -2 * centroids.t() * dataset.cols(first, last);
+    distances.each_col() += centroidNorms.t();
+
+    const arma::urowvec closest = arma::index_min(distances, 0);
+    for (size_t i = 0; i < closest.n_elem; ++i)
+      accumulator.Add(closest[i], dataset.col(first + i));
+  }
+}
+
+template<typename MetricType, typename MatType>
+template<typename AnyMetricType>
+void NaiveKMeans<MetricType, MatType>::Assign(
+    const AnyMetricType& /* metric */,
+    const arma::mat& centroids,
+    CentroidAccumulator& accumulator)
+{
+  // Computed in parallel over the complete dataset.  The static schedule
+  // keeps each thread on the same columns in every iteration, so that a
+  // dataset placed with math::FirstTouch() is read from local memory.
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) dataset.n_cols; ++i)
+  {
+    // Find the closest centroid to this point.
+    double minDistance = std::numeric_limits<double>::infinity();
+    size_t closestCluster = centroids.n_cols; // Invalid value.
+
+    for (size_t j = 0; j < centroids.n_cols; j++)
+    {
+      const double distance = metric.Evaluate(dataset.col(i),
+          centroids.unsafe_col(j));
+      if (distance < minDistance)
+      {
+        minDistance = distance;
+        closestCluster = j;
+      }
+    }
+
+    Log::Assert(closestCluster != centroids.n_cols);
+
+    // We now have the minimum distance centroid index.  Update that centroid.
+    accumulator.Add(closestCluster, dataset.col(i));
+  }
+}
+
 } // namespace kmeans
 } // namespace mlpack
 
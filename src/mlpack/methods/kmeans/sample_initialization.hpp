@@ -44,7 +44,7 @@ class SampleInitialization
     {
       // Randomly sample a point.
       const size_t index = math::RandInt(0, data.n_cols);
-      centroids.col(i) = data.col(index);
+      centroids.col(i) = arma::vec(data.col(index));
     }
   }
 };
@@ -0,0 +1,139 @@
+/**
+ * @file methods/kmeans/streaming_kmeans.hpp
+ *
+ * Out-of-core k-means clustering with Sculley's mini-batch updates.  The data
+ * is read one chunk at a time from a reader, so the dataset never has to fit in
+ * memory.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_STREAMING_KMEANS_HPP
+#define MLPACK_METHODS_KMEANS_STREAMING_KMEANS_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
+#include "mini_batch_kmeans.hpp"
+
+namespace mlpack {
+namespace kmeans {
+
+/**
+ * This class clusters a dataset that is read in chunks, using Sculley's
+ * mini-batch k-means: each chunk is a mini-batch, and is used to update the
+ * centroids with MiniBatchUpdate() before the next chunk is read.  The whole
+ * dataset may be read several times (passes); clustering stops when the
+ * centroids move less than the tolerance during one pass, or when the maximum
+ * number of passes is reached.
+ *
+ * The ReaderType class must implement the following two functions:
+ *
+ * @code
+ * // Get the next chunk of points (one point per column), or return false if
+ * // there are no more points in this pass.
+ * bool NextBatch(arma::mat& batch);
+ *
+ * // Start a new pass over the data.
+ * void Reset();
+ * @endcode
+ *
+ * ChunkedTextReader is one such class, for text files with one point per line.
+ * For example, to cluster a large CSV file into 100 clusters:
+ *
+ * @code
+ * ChunkedTextReader reader("data.csv", 10000);
+ * StreamingKMeans<> kmeans;
+ * arma::mat centroids;
+ * kmeans.Cluster(reader, 100, centroids);
+ * @endcode
+ *
+ * @tparam MetricType The distance metric to use for this KMeans; see
+ *     metric::LMetric for an example.
+ */
+template<typename MetricType = metric::EuclideanDistance>
+class StreamingKMeans
+{
+ public:
+  /**
+   * Create a StreamingKMeans object.
+   *
+   * @param maxPasses Maximum number of passes over the data.  If 0, passes are
+   *     made until the centroids converge.
+   * @param tolerance Clustering stops when the centroids move less than this
+   *     (in total) during one pass.
+   * @param metric Optional MetricType object; for when the metric has state
+   *     it needs to store.
+   */
+  StreamingKMeans(const size_t maxPasses = 10,
+                  const double tolerance = 1e-5,
+                  const MetricType metric = MetricType());
+
+  /**
+   * Cluster the data given by the reader into the given number of clusters,
+   * returning the centroid of each cluster.  If initialGuess is false, the
+   * initial centroids are sampled from the first points that the reader gives.
+   *
+   * @tparam ReaderType Type of reader to get the data from.
+   * @param reader Reader to get the data from.
+   * @param clusters Number of clusters to compute.
+   * @param centroids Matrix in which centroids are stored.
+   * @param initialGuess If true, then it is assumed that centroids contains
+   *     the initial cluster centroids.
+   */
+  template<typename ReaderType>
+  void Cluster(ReaderType& reader,
+               const size_t clusters,
+               arma::mat& centroids,
+               const bool initialGuess = false);
+
+  //! Get the maximum number of passes.
+  size_t MaxPasses() const { return maxPasses; }
+  //! Set the maximum number of passes.
+  size_t& MaxPasses() { return maxPasses; }
+
+  //! Get the convergence tolerance.
+  double Tolerance() const { return tolerance; }
+  //! Modify the convergence tolerance.
+  double& Tolerance() { return tolerance; }
+
+  //! Get the distance metric.
+  const MetricType& Metric() const { return metric; }
+  //! Modify the distance metric.
+  MetricType& Metric() { return metric; }
+
+  //! Get the number of points given to each cluster by the last call to
+  //! Cluster().
+  const arma::Col<size_t>& Counts() const { return counts; }
+
+  //! Get the number of distance calculations of the last call to Cluster().
+  size_t DistanceCalculations() const { return distanceCalculations; }
+
+ private:
+  //! Maximum number of passes over the data.
+  size_t maxPasses;
+  //! Convergence tolerance.
+  double tolerance;
+  //! Instantiated distance metric.
+  MetricType metric;
+
+  //! The number of points given to each cluster.
+  arma::Col<size_t> counts;
+  //! The number of distance calculations.
+  size_t distanceCalculations;
+
+  //! Sample the initial centroids from the first points of the reader.
+  template<typename ReaderType>
+  void InitialCentroids(ReaderType& reader,
+                        const size_t clusters,
+                        arma::mat& centroids);
+};
+
+} // namespace kmeans
+} // namespace mlpack
+
+// Include implementation.
+#include "streaming_kmeans_impl.hpp"
+
+#endif
@@ -0,0 +1,141 @@
+/**
+ * @file methods/kmeans/streaming_kmeans_impl.hpp
+ *
+ * Implementation of out-of-core k-means clustering with mini-batch updates.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_STREAMING_KMEANS_IMPL_HPP
+#define MLPACK_METHODS_KMEANS_STREAMING_KMEANS_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "streaming_kmeans.hpp"
+
+namespace mlpack {
+namespace kmeans {
+
+template<typename MetricType>
+StreamingKMeans<MetricType>::StreamingKMeans(const size_t maxPasses,
+                                             const double tolerance,
+                                             const MetricType metric) :
+    maxPasses(maxPasses),
+    tolerance(tolerance),
+    metric(metric),
+    distanceCalculations(0)
+{
+  // Nothing to do.
+}
+
+template<typename MetricType>
+template<typename ReaderType>
+void StreamingKMeans<MetricType>::Cluster(ReaderType& reader,
+                                          const size_t clusters,
+                                          arma::mat& centroids,
+                                          const bool initialGuess)
+{
+  if (clusters == 0)
+  {
+    throw std::invalid_argument("StreamingKMeans::Cluster(): zero clusters "
+        "requested");
+  }
+
+  if (initialGuess && centroids.n_cols != clusters)
+  {
+    std::ostringstream oss;
+    oss << "StreamingKMeans::Cluster(): wrong number of initial cluster "
+        << "centroids (" << centroids.n_cols << ", should be " << clusters
+        << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (!initialGuess)
+    InitialCentroids(reader, clusters, centroids);
+
+  counts.zeros(clusters);
+  distanceCalculations = 0;
+
+  arma::mat batch;
+  size_t pass = 0;
+  double cNorm;
+  do
+  {
+    const arma::mat oldCentroids = centroids;
+
+    reader.Reset();
+    while (reader.NextBatch(batch))
+    {
+      if (batch.n_rows != centroids.n_rows)
+      {
+        std::ostringstream oss;
+        oss << "StreamingKMeans::Cluster(): dimensionality of batch ("
+            << batch.n_rows << ") is not equal to the dimensionality of the "
+            << "centroids (" << centroids.n_rows << ")!";
+        throw std::invalid_argument(oss.str());
+      }
+
+      distanceCalculations += MiniBatchUpdate(batch, metric, centroids,
+          counts);
+    }
+
+    // Calculate how far the centroids moved during this pass.
+    cNorm = 0.0;
+    for (size_t i = 0; i < clusters; ++i)
+    {
+      cNorm += std::pow(metric.Evaluate(oldCentroids.col(i),
+          centroids.col(i)), 2.0);
+    }
+    cNorm = std::sqrt(cNorm);
+    distanceCalculations += clusters;
+
+    pass++;
+    Log::Info << "StreamingKMeans::Cluster(): pass " << pass << ", residual "
+        << cNorm << ".\n";
+  } while (cNorm > tolerance && pass != maxPasses);
+
+  if (pass != maxPasses)
+  {
+    Log::Info << "StreamingKMeans::Cluster(): converged after " << pass
+        << " passes." << std::endl;
+  }
+  else
+  {
+    Log::Info << "StreamingKMeans::Cluster(): terminated after limit of "
+        << pass << " passes." << std::endl;
+  }
+  Log::Info << distanceCalculations << " distance calculations." << std::endl;
+}
+
+template<typename MetricType>
+template<typename ReaderType>
+void StreamingKMeans<MetricType>::InitialCentroids(ReaderType& reader,
+                                                   const size_t clusters,
+                                                   arma::mat& centroids)
+{
+  // Collect the first points of the data until we have enough of them, then
+  // sample distinct points from them.
+  arma::mat points;
+  arma::mat batch;
+  reader.Reset();
+  while (points.n_cols < clusters && reader.NextBatch(batch))
+    points = arma::join_rows(points, batch);
+
+  if (points.n_cols < clusters)
+  {
+    std::ostringstream oss;
+    oss << "StreamingKMeans::Cluster(): more clusters requested (" << clusters
+        << ") than points given (" << points.n_cols << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  const arma::uvec order = arma::shuffle(arma::linspace<arma::uvec>(0,
+      points.n_cols - 1, points.n_cols));
+  centroids = points.cols(order.subvec(0, clusters - 1));
+}
+
+} // namespace kmeans
+} // namespace mlpack
+
+#endif
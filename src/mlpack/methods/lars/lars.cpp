@@ -162,6 +162,37 @@ LARS& LARS::operator=(LARS&& other)
   return *this;
 }
 
+namespace {
+
+// Compute the dot product of every column of the data with the given vector.
+// The columns of the row-major data are the dimensions, so this is X^T v.
+void ColumnDots(const arma::mat& matX,
+                const arma::vec& v,
+                arma::vec& dots)
+{
+  dots = trans(matX) * v;
+}
+
+// Sparse version of ColumnDots().  Each dimension only touches its own nonzero
+// elements, so the dimensions are handled in parallel.
+void ColumnDots(const arma::sp_mat& matX,
+                const arma::vec& v,
+                arma::vec& dots)
+{
+  dots.set_size(matX.n_cols);
+
+  #pragma omp parallel for
+  for (omp_size_t j = 0; j < (omp_size_t) matX.n_cols; ++j)
+  {
+    double value = 0.0;
+    for (size_t k = matX.col_ptrs[j]; k < matX.col_ptrs[j + 1]; ++k)
+      value += matX.values[k] * v[matX.row_indices[k]];
+    dots[j] = value;
+  }
+}
+
+} // namespace
+
 double LARS::Train(const arma::mat& matX,
                    const arma::rowvec& y,
                    arma::vec& beta,
@@ -169,6 +200,44 @@ double LARS::Train(const arma::mat& matX,
 {
   Timer::Start("lars_regression");
 
+  // This matrix may end up holding the transpose -- if necessary.
+  arma::mat dataTrans;
+  // dataRef is row-major.
+  const arma::mat& dataRef = (transposeData ? dataTrans : matX);
+  if (transposeData)
+    dataTrans = trans(matX);
+
+  TrainRowMajor(dataRef, y, beta);
+
+  Timer::Stop("lars_regression");
+  return ComputeError(matX, y, !transposeData);
+}
+
+double LARS::Train(const arma::sp_mat& matX,
+                   const arma::rowvec& y,
+                   arma::vec& beta,
+                   const bool transposeData)
+{
+  Timer::Start("lars_regression");
+
+  // This matrix may end up holding the transpose -- if necessary.
+  arma::sp_mat dataTrans;
+  // dataRef is row-major.
+  const arma::sp_mat& dataRef = (transposeData ? dataTrans : matX);
+  if (transposeData)
+    dataTrans = trans(matX);
+
+  TrainRowMajor(dataRef, y, beta);
+
+  Timer::Stop("lars_regression");
+  return ComputeError(matX, y, !transposeData);
+}
+
+template<typename MatType>
+void LARS::TrainRowMajor(const MatType& dataRef,
+                         const arma::rowvec& y,
+                         arma::vec& beta)
+{
   // Clear any previous solution information.
   betaPath.clear();
   lambdaPath.clear();
@@ -178,15 +247,9 @@ double LARS::Train(const arma::mat& matX,
   isIgnored.clear();
   matUtriCholFactor.reset();
 
-  // This matrix may end up holding the transpose -- if necessary.
-  arma::mat dataTrans;
-  // dataRef is row-major.
-  const arma::mat& dataRef = (transposeData ? dataTrans : matX);
-  if (transposeData)
-    dataTrans = trans(matX);
-
   // Compute X' * y.
-  arma::vec vecXTy = trans(y * dataRef);
+  arma::vec vecXTy;
+  ColumnDots(dataRef, arma::vec(trans(y)), vecXTy);
 
   // Set up active set variables.  In the beginning, the active set has size 0
   // (all dimensions are inactive).
@@ -222,20 +285,18 @@ double LARS::Train(const arma::mat& matX,
   if (maxCorr < lambda1)
   {
     lambdaPath[0] = lambda1;
-    Timer::Stop("lars_regression");
-    return maxCorr;
+    return;
   }
 
-  // Compute the Gram matrix.  If this is the elastic net problem, we will add
-  // lambda2 * I_n to the matrix.
-  if (matGram->n_elem != dataRef.n_cols * dataRef.n_cols)
-  {
-    // In this case, matGram should reference matGramInternal.
-    matGramInternal = trans(dataRef) * dataRef;
-
-    if (elasticNet && !useCholesky)
-      matGramInternal += lambda2 * arma::eye(dataRef.n_cols, dataRef.n_cols);
-  }
+  // If no Gram matrix was given, the full Gram matrix is never computed: it
+  // has dataRef.n_cols^2 elements, which is too many for wide problems.
+  // Instead, the Gram matrix of the active set is built as dimensions are
+  // activated, from the dot products of the new dimension with the active
+  // ones.  If this is the elastic net problem, lambda2 is added to its
+  // diagonal (which the Cholesky factorization does by itself).
+  const bool gramProvided =
+      (matGram->n_elem == dataRef.n_cols * dataRef.n_cols);
+  arma::mat matGramActive;
 
   // Main loop.
   while (((activeSet.size() + ignoreSet.size()) < dataRef.n_cols) &&
@@ -254,18 +315,27 @@ double LARS::Train(const arma::mat& matX,
 
     if (!lassocond)
     {
+      arma::vec newGramCol;
+      double sqNormNewX;
+      GramColumn(dataRef, gramProvided, changeInd, newGramCol, sqNormNewX);
+
       if (useCholesky)
       {
-        // vec newGramCol = vec(activeSet.size());
-        // for (size_t i = 0; i < activeSet.size(); i++)
-        // {
-        //   newGramCol[i] = dot(matX.col(activeSet[i]), matX.col(changeInd));
-        // }
-        // This is equivalent to the above 5 lines.
-        arma::vec newGramCol = matGram->elem(changeInd * dataRef.n_cols +
-            arma::conv_to<arma::uvec>::from(activeSet));
-
-        CholeskyInsert((*matGram)(changeInd, changeInd), newGramCol);
+        CholeskyInsert(sqNormNewX, newGramCol);
+      }
+      else
+      {
+        if (elasticNet && !gramProvided)
+          sqNormNewX += lambda2;
+
+        const size_t n = matGramActive.n_rows;
+        matGramActive.resize(n + 1, n + 1);
+        if (n > 0)
+        {
+          matGramActive(arma::span(0, n - 1), n) = newGramCol;
+          matGramActive(n, arma::span(0, n - 1)) = trans(newGramCol);
+        }
+        matGramActive(n, n) = sqNormNewX;
       }
 
       // Add variable to active set.
@@ -323,11 +393,6 @@ double LARS::Train(const arma::mat& matX,
     }
     else
     {
-      arma::mat matGramActive = arma::mat(activeSet.size(), activeSet.size());
-      for (size_t i = 0; i < activeSet.size(); i++)
-        for (size_t j = 0; j < activeSet.size(); j++)
-          matGramActive(i, j) = (*matGram)(activeSet[i], activeSet[j]);
-
       // Check for singularity.
       arma::mat matS = s * arma::ones<arma::mat>(1, activeSet.size());
       const bool solvedOk = solve(unnormalizedBetaDirection,
@@ -345,6 +410,8 @@ double LARS::Train(const arma::mat& matX,
         // and look for new variable to add.
         Deactivate(activeSet.size() - 1);
         Ignore(changeInd);
+        matGramActive.shed_row(matGramActive.n_rows - 1);
+        matGramActive.shed_col(matGramActive.n_cols - 1);
         Log::Warn << "Encountered singularity when adding variable "
             << changeInd << " to active set; permanently removing."
             << std::endl;
@@ -360,13 +427,16 @@ double LARS::Train(const arma::mat& matX,
     // If not all variables are active.
     if ((activeSet.size() + ignoreSet.size()) < dataRef.n_cols)
     {
-      // Compute correlations with direction.
+      // Compute correlations with direction, all at once.
+      arma::vec dirCorrs;
+      ColumnDots(dataRef, yHatDirection, dirCorrs);
+
       for (size_t ind = 0; ind < dataRef.n_cols; ind++)
       {
         if (isActive[ind] || isIgnored[ind])
           continue;
 
-        double dirCorr = dot(dataRef.col(ind), yHatDirection);
+        double dirCorr = dirCorrs[ind];
         double val1 = (maxCorr - corr(ind)) / (normalization - dirCorr);
         double val2 = (maxCorr + corr(ind)) / (normalization + dirCorr);
         if ((val1 > 0) && (val1 < gamma))
@@ -423,12 +493,21 @@ double LARS::Train(const arma::mat& matX,
     {
       // Index is in position changeInd in activeSet.
       if (useCholesky)
+      {
         CholeskyDelete(changeInd);
+      }
+      else
+      {
+        matGramActive.shed_row(changeInd);
+        matGramActive.shed_col(changeInd);
+      }
 
       Deactivate(changeInd);
     }
 
-    corr = vecXTy - trans(dataRef) * yHat;
+    arma::vec xTyHat;
+    ColumnDots(dataRef, yHat, xTyHat);
+    corr = vecXTy - xTyHat;
     if (elasticNet)
       corr -= lambda2 * beta;
 
@@ -453,9 +532,6 @@ double LARS::Train(const arma::mat& matX,
 
   // Unfortunate copy...
   beta = betaPath.back();
-
-  Timer::Stop("lars_regression");
-  return ComputeError(matX, y, !transposeData);
 }
 
 double LARS::Train(const arma::mat& data,
@@ -466,6 +542,14 @@ double LARS::Train(const arma::mat& data,
   return Train(data, responses, beta, transposeData);
 }
 
+double LARS::Train(const arma::sp_mat& data,
+                   const arma::rowvec& responses,
+                   const bool transposeData)
+{
+  arma::vec beta;
+  return Train(data, responses, beta, transposeData);
+}
+
 void LARS::Predict(const arma::mat& points,
                    arma::rowvec& predictions,
                    const bool rowMajor) const
@@ -477,6 +561,22 @@ void LARS::Predict(const arma::mat& points,
     predictions = betaPath.back().t() * points;
 }
 
+void LARS::Predict(const arma::sp_mat& points,
+                   arma::rowvec& predictions,
+                   const bool rowMajor) const
+{
+  if (rowMajor)
+  {
+    predictions = trans(points * betaPath.back());
+  }
+  else
+  {
+    arma::vec dots;
+    ColumnDots(points, betaPath.back(), dots);
+    predictions = trans(dots);
+  }
+}
+
 // Private functions.
 void LARS::Deactivate(const size_t activeVarInd)
 {
@@ -496,7 +596,33 @@ void LARS::Ignore(const size_t varInd)
   ignoreSet.push_back(varInd);
 }
 
-void LARS::ComputeYHatDirection(const arma::mat& matX,
+template<typename MatType>
+void LARS::GramColumn(const MatType& matX,
+                      const bool gramProvided,
+                      const size_t varInd,
+                      arma::vec& newGramCol,
+                      double& sqNormNewX) const
+{
+  if (gramProvided)
+  {
+    // newGramCol[i] = (*matGram)(activeSet[i], varInd).
+    newGramCol = matGram->elem(varInd * matX.n_cols +
+        arma::conv_to<arma::uvec>::from(activeSet));
+    sqNormNewX = (*matGram)(varInd, varInd);
+    return;
+  }
+
+  newGramCol.set_size(activeSet.size());
+
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) activeSet.size(); ++i)
+    newGramCol[i] = arma::dot(matX.col(activeSet[i]), matX.col(varInd));
+
+  sqNormNewX = arma::dot(matX.col(varInd), matX.col(varInd));
+}
+
+template<typename MatType>
+void LARS::ComputeYHatDirection(const MatType& matX,
                                 const arma::vec& betaDirection,
                                 arma::vec& yHatDirection)
 {
@@ -647,3 +773,12 @@ double LARS::ComputeError(const arma::mat& matX,
     return arma::accu(arma::pow(y - betaPath.back().t() * matX, 2.0));
   }
 }
+
+double LARS::ComputeError(const arma::sp_mat& matX,
+                          const arma::rowvec& y,
+                          const bool rowMajor)
+{
+  arma::rowvec predictions;
+  Predict(matX, predictions, rowMajor);
+  return arma::accu(arma::pow(y - predictions, 2.0));
+}
@@ -236,6 +236,37 @@ class LARS
                const arma::rowvec& responses,
                const bool transposeData = true);
 
+  /**
+   * Run LARS on sparse data.  This is useful when the data has many more
+   * dimensions than points: unless a Gram matrix was given to the constructor,
+   * the Gram matrix is only computed between the dimensions in the active set,
+   * so the memory used does not grow with the square of the dimensionality.
+   *
+   * @param data Column-major input data (or row-major input data if rowMajor =
+   *     true).
+   * @param responses A vector of targets.
+   * @param beta Vector to store the solution (the coefficients) in.
+   * @param transposeData Set to false if the data is row-major.
+   * @return minimum cost error(||y-beta*X||2 is used to calculate error).
+   */
+  double Train(const arma::sp_mat& data,
+               const arma::rowvec& responses,
+               arma::vec& beta,
+               const bool transposeData = true);
+
+  /**
+   * Run LARS on sparse data.  See the other overload for details.
+   *
+   * @param data Input data.
+   * @param responses A vector of targets.
+   * @param transposeData Should be true if the input data is column-major and
+   *     false otherwise.
+   * @return minimum cost error(||y-beta*X||2 is used to calculate error).
+   */
+  double Train(const arma::sp_mat& data,
+               const arma::rowvec& responses,
+               const bool transposeData = true);
+
   /**
    * Predict y_i for each data point in the given data matrix using the
    * currently-trained LARS model.
@@ -249,6 +280,19 @@ class LARS
                arma::rowvec& predictions,
                const bool rowMajor = false) const;
 
+  /**
+   * Predict y_i for each sparse data point in the given data matrix using the
+   * currently-trained LARS model.
+   *
+   * @param points The data points to regress on.
+   * @param predictions y, which will contained calculated values on completion.
+   * @param rowMajor Should be true if the data points matrix is row-major and
+   *     false otherwise.
+   */
+  void Predict(const arma::sp_mat& points,
+               arma::rowvec& predictions,
+               const bool rowMajor = false) const;
+
   //! Access the set of active dimensions.
   const std::vector<size_t>& ActiveSet() const { return activeSet; }
 
@@ -288,6 +332,21 @@ class LARS
                       const arma::rowvec& y,
                       const bool rowMajor = false);
 
+  /**
+   * Compute cost error of the given sparse data matrix using the
+   * currently-trained LARS model.  See the other overload for details.
+   *
+   * @param matX Column-major input data (or row-major input data if rowMajor =
+   *     true).
+   * @param y responses A vector of targets.
+   * @param rowMajor Should be true if the data points matrix is row-major and
+   *   false otherwise.
+   * @return The minimum cost error.
+   */
+  double ComputeError(const arma::sp_mat& matX,
+                      const arma::rowvec& y,
+                      const bool rowMajor = false);
+
  private:
   //! Gram matrix.
   arma::mat matGramInternal;
@@ -355,8 +414,41 @@ class LARS
    */
   void Ignore(const size_t varInd);
 
+  /**
+   * Run LARS on row-major data (each row is a point and each column is a
+   * dimension), dense or sparse.
+   *
+   * @param dataRef Row-major input data.
+   * @param y A vector of targets.
+   * @param beta Vector to store the solution (the coefficients) in.
+   */
+  template<typename MatType>
+  void TrainRowMajor(const MatType& dataRef,
+                     const arma::rowvec& y,
+                     arma::vec& beta);
+
+  /**
+   * Get the entries of the Gram matrix between dimension varInd and each
+   * dimension of the active set, and the squared norm of dimension varInd.
+   * These are taken from the given Gram matrix if there is one, and are
+   * computed (in parallel) from the row-major data otherwise.
+   *
+   * @param matX Row-major input data.
+   * @param gramProvided Whether the Gram matrix was given.
+   * @param varInd Dimension to get the Gram matrix column of.
+   * @param newGramCol Vector to store the entries for the active set in.
+   * @param sqNormNewX Squared norm of dimension varInd.
+   */
+  template<typename MatType>
+  void GramColumn(const MatType& matX,
+                  const bool gramProvided,
+                  const size_t varInd,
+                  arma::vec& newGramCol,
+                  double& sqNormNewX) const;
+
   // compute "equiangular" direction in output space
-  void ComputeYHatDirection(const arma::mat& matX,
+  template<typename MatType>
+  void ComputeYHatDirection(const MatType& matX,
                             const arma::vec& betaDirection,
                             arma::vec& yHatDirection);
 
@@ -46,46 +46,142 @@ double LinearRegression::Train(const arma::mat& predictors,
                                const arma::rowvec& weights,
                                const bool intercept)
 {
-  this->intercept = intercept;
+  // Start over from the products of the whole dataset.  This is also cheaper
+  // than solving the augmented system directly, as the predictors are never
+  // copied.
+  gram.clear();
+  crossProducts.clear();
+  PartialTrain(predictors, responses, weights, intercept);
 
+  return ComputeError(predictors, responses);
+}
+
+void LinearRegression::PartialTrain(const arma::mat& predictors,
+                                    const arma::rowvec& responses,
+                                    const bool intercept)
+{
+  PartialTrain(predictors, responses, arma::rowvec(), intercept);
+}
+
+void LinearRegression::PartialTrain(const arma::mat& predictors,
+                                    const arma::rowvec& responses,
+                                    const arma::rowvec& weights,
+                                    const bool intercept)
+{
   /*
    * We want to calculate the a_i coefficients of:
    * \sum_{i=0}^n (a_i * x_i^i)
-   * In order to get the intercept value, we will add a row of ones.
+   * In order to get the intercept value, we will act as if the predictors had
+   * a first row of ones.
    */
+  const size_t offset = intercept ? 1 : 0;
+  const size_t dims = predictors.n_rows + offset;
+  if (gram.is_empty())
+  {
+    this->intercept = intercept;
+    gram.zeros(dims, dims);
+    crossProducts.zeros(dims);
+  }
+  else if (gram.n_rows != dims || this->intercept != intercept)
+  {
+    throw std::invalid_argument("LinearRegression::PartialTrain(): "
+        "dimensionality or intercept of the chunk does not match the data "
+        "seen so far");
+  }
 
-  // We store the number of rows and columns of the predictors.
-  // Reminder: Armadillo stores the data transposed from how we think of it,
-  //           that is, columns are actually rows (see: column major order).
-  const size_t nCols = predictors.n_cols;
-
-  arma::mat p = predictors;
-  arma::rowvec r = responses;
+  // Add the products of the chunk:
+  // a * (X X^T) = y X^T.
+  // The total runtime of this should be O(d^2 N), and solving it is O(d^3).
+  if (dims > offset)
+  {
+    if (weights.n_elem > 0)
+    {
+      const arma::mat weighted = predictors.each_row() % weights;
+      gram.submat(offset, offset, dims - 1, dims - 1) +=
+          weighted * predictors.t();
+      crossProducts.subvec(offset, dims - 1) += weighted * responses.t();
+      if (intercept)
+      {
+        const arma::vec sums = arma::sum(weighted, 1);
+        gram.submat(1, 0, dims - 1, 0) += sums;
+        gram.submat(0, 1, 0, dims - 1) += sums.t();
+      }
+    }
+    else
+    {
+      gram.submat(offset, offset, dims - 1, dims - 1) +=
+          predictors * predictors.t();
+      crossProducts.subvec(offset, dims - 1) += predictors * responses.t();
+      if (intercept)
+      {
+        const arma::vec sums = arma::sum(predictors, 1);
+        gram.submat(1, 0, dims - 1, 0) += sums;
+        gram.submat(0, 1, 0, dims - 1) += sums.t();
+      }
+    }
+  }
 
-  // Here we add the row of ones to the predictors.
-  // The intercept is not penalized. Add an "all ones" row to design and set
-  // intercept = false to get a penalized intercept.
   if (intercept)
   {
-    p.insert_rows(0, arma::ones<arma::mat>(1, nCols));
+    if (weights.n_elem > 0)
+    {
+      gram(0, 0) += arma::accu(weights);
+      crossProducts(0) += arma::dot(weights, responses);
+    }
+    else
+    {
+      gram(0, 0) += predictors.n_cols;
+      crossProducts(0) += arma::accu(responses);
+    }
   }
 
-  if (weights.n_elem > 0)
+  Solve();
+}
+
+void LinearRegression::Merge(const LinearRegression& other)
+{
+  if (other.gram.is_empty())
+    return;
+
+  if (gram.is_empty())
+  {
+    intercept = other.intercept;
+    gram = other.gram;
+    crossProducts = other.crossProducts;
+  }
+  else if (gram.n_rows != other.gram.n_rows || intercept != other.intercept)
   {
-    p = p * diagmat(sqrt(weights));
-    r = sqrt(weights) % responses;
+    throw std::invalid_argument("LinearRegression::Merge(): dimensionality or "
+        "intercept of the other model does not match this model");
+  }
+  else
+  {
+    gram += other.gram;
+    crossProducts += other.crossProducts;
   }
 
-  // Convert to this form:
-  // a * (X X^T) = y X^T.
-  // Then we'll use Armadillo to solve it.
-  // The total runtime of this should be O(d^2 N) + O(d^3) + O(dN).
-  // (assuming the SVD is used to solve it)
-  arma::mat cov = p * p.t() +
-      lambda * arma::eye<arma::mat>(p.n_rows, p.n_rows);
+  Solve();
+}
 
-  parameters = arma::solve(cov, p * r.t());
-  return ComputeError(predictors, responses);
+void LinearRegression::Solve()
+{
+  // Note that lambda penalizes the intercept too.
+  const arma::mat cov = gram +
+      lambda * arma::eye<arma::mat>(gram.n_rows, gram.n_rows);
+
+  // X X^T + lambda I is symmetric positive semidefinite, and positive definite
+  // unless the problem is degenerate, so the Cholesky decomposition is nearly
+  // always enough.
+  arma::mat upper;
+  if (arma::chol(upper, cov))
+  {
+    parameters = arma::solve(arma::trimatu(upper),
+        arma::solve(arma::trimatl(upper.t()), crossProducts));
+  }
+  else
+  {
+    parameters = arma::solve(cov, crossProducts);
+  }
 }
 
 void LinearRegression::Predict(const arma::mat& points,
@@ -22,6 +22,19 @@ namespace regression /** Regression methods. */ {
  * A simple linear regression algorithm using ordinary least squares.
  * Optionally, this class can perform ridge regression, if the lambda parameter
  * is set to a number greater than zero.
+ *
+ * The model is the solution of the normal equations, which only need the
+ * products X X^T and X y of the predictors; the model keeps them, so that a
+ * dataset too large for memory can be trained on in chunks with
+ * PartialTrain(), and models trained on different parts of a dataset (for
+ * instance by different threads or machines) can be combined with Merge():
+ *
+ * @code
+ * LinearRegression lr;
+ * lr.Lambda() = 0.01;
+ * while (LoadNextChunk(predictors, responses))
+ *   lr.PartialTrain(predictors, responses);
+ * @endcode
  */
 class LinearRegression
 {
@@ -63,10 +76,9 @@ class LinearRegression
 
   /**
    * Train the LinearRegression model on the given data. Careful! This will
-   * completely ignore and overwrite the existing model. This particular
-   * implementation does not have an incremental training algorithm.  To set the
-   * regularization parameter lambda, call Lambda() or set a different value in
-   * the constructor.
+   * completely ignore and overwrite the existing model.  To train the model
+   * incrementally, use PartialTrain().  To set the regularization parameter
+   * lambda, call Lambda() or set a different value in the constructor.
    *
    * @param predictors X, the matrix of data points to train the model on.
    * @param responses y, the responses to the data points.
@@ -79,10 +91,10 @@ class LinearRegression
 
   /**
    * Train the LinearRegression model on the given data and weights. Careful!
-   * This will completely ignore and overwrite the existing model. This
-   * particular implementation does not have an incremental training algorithm.
-   * To set the regularization parameter lambda, call Lambda() or set a
-   * different value in the constructor.
+   * This will completely ignore and overwrite the existing model.  To train the
+   * model incrementally, use PartialTrain().  To set the regularization
+   * parameter lambda, call Lambda() or set a different value in the
+   * constructor.
    *
    * @param predictors X, the matrix of data points to train the model on.
    * @param responses y, the responses to the data points.
@@ -95,6 +107,46 @@ class LinearRegression
                const arma::rowvec& weights,
                const bool intercept = true);
 
+  /**
+   * Update the model with another chunk of the dataset.  The products of the
+   * chunk are added to the products of the data seen so far, and the model is
+   * solved again, so training every chunk of a dataset with PartialTrain()
+   * gives the same model as training the whole dataset with Train() (up to
+   * floating-point error).  Train() starts over.
+   *
+   * @param predictors X, the chunk of data points to train the model on.
+   * @param responses y, the responses to the data points.
+   * @param intercept Whether or not to fit an intercept term (this must be the
+   *     same for all the chunks).
+   */
+  void PartialTrain(const arma::mat& predictors,
+                    const arma::rowvec& responses,
+                    const bool intercept = true);
+
+  /**
+   * Update the model with another chunk of the dataset and its weights.  See
+   * the other overload of PartialTrain() for details.
+   *
+   * @param predictors X, the chunk of data points to train the model on.
+   * @param responses y, the responses to the data points.
+   * @param weights Observation weights (for boosting).
+   * @param intercept Whether or not to fit an intercept term (this must be the
+   *     same for all the chunks).
+   */
+  void PartialTrain(const arma::mat& predictors,
+                    const arma::rowvec& responses,
+                    const arma::rowvec& weights,
+                    const bool intercept = true);
+
+  /**
+   * Add the data seen by another model (trained with Train() or
+   * PartialTrain() on a different part of the dataset, with the same
+   * intercept setting) to this model, and solve it again.
+   *
+   * @param other The model to merge into this one.
+   */
+  void Merge(const LinearRegression& other);
+
   /**
    * Calculate y_i for each data point in points.
    *
@@ -136,18 +188,44 @@ class LinearRegression
   //! Return whether or not an intercept term is used in the model.
   bool Intercept() const { return intercept; }
 
+  //! Return X X^T for the data seen so far (with a first row of ones in X if
+  //! there is an intercept).
+  const arma::mat& Gram() const { return gram; }
+  //! Return X y for the data seen so far.
+  const arma::vec& CrossProducts() const { return crossProducts; }
+
   /**
    * Serialize the model.
    */
   template<typename Archive>
-  void serialize(Archive& ar, const unsigned int /* version */)
+  void serialize(Archive& ar, const unsigned int version)
   {
     ar & BOOST_SERIALIZATION_NVP(parameters);
     ar & BOOST_SERIALIZATION_NVP(lambda);
     ar & BOOST_SERIALIZATION_NVP(intercept);
+
+    // Older models can't be updated with PartialTrain(), which will train them
+    // again from scratch.
+    if (version > 0)
+    {
+      ar & BOOST_SERIALIZATION_NVP(gram);
+      ar & BOOST_SERIALIZATION_NVP(crossProducts);
+    }
+    else if (Archive::is_loading::value)
+    {
+      gram.clear();
+      crossProducts.clear();
+    }
   }
 
  private:
+  /**
+   * Solve the normal equations (X X^T + lambda I) b = X y with the Cholesky
+   * decomposition, falling back to a general solver if the matrix is not
+   * positive definite.
+   */
+  void Solve();
+
   /**
    * The calculated B.
    * Initialized and filled by constructor to hold the least squares solution.
@@ -162,9 +240,17 @@ class LinearRegression
 
   //! Indicates whether first parameter is intercept.
   bool intercept;
+
+  //! X X^T for the data seen so far.
+  arma::mat gram;
+
+  //! X y for the data seen so far.
+  arma::vec crossProducts;
 };
 
 } // namespace regression
 } // namespace mlpack
 
+BOOST_CLASS_VERSION(mlpack::regression::LinearRegression, 1);
+
 #endif // MLPACK_METHODS_LINEAR_REGRESSION_HPP
@@ -23,6 +23,11 @@ namespace svm {
  * The hinge loss function for the linear SVM objective function.
  * This is used by various ensmallen optimizers to train the linear
  * SVM model.
+ *
+ * The dataset may be dense (arma::mat) or sparse (arma::sp_mat).  The loss and
+ * gradient are computed over blocks of points, so that the scores of all the
+ * points are never held at once, and the blocks are processed in parallel when
+ * OpenMP is available.
  */
 template <typename MatType = arma::mat>
 class LinearSVMFunction
@@ -164,9 +169,9 @@ class LinearSVMFunction
   arma::mat& InitialPoint() { return initialPoint; }
 
   //! Get the dataset.
-  const arma::sp_mat& Dataset() const { return dataset; }
+  const MatType& Dataset() const { return dataset; }
   //! Modify the dataset.
-  arma::sp_mat& Dataset() { return dataset; }
+  MatType& Dataset() { return dataset; }
 
   //! Sets the regularization parameter.
   double& Lambda() { return lambda; }
@@ -180,15 +185,31 @@ class LinearSVMFunction
   size_t NumFunctions() const;
 
  private:
+  /**
+   * Compute the hinge loss of the given points, summed over the points and
+   * without the regularization term, and optionally its gradient (also summed
+   * and without the regularization term).
+   *
+   * @param parameters The parameters of the SVM.
+   * @param firstId Index of the first point.
+   * @param batchSize Number of points.
+   * @param gradient If not NULL, the gradient is stored here.
+   * @return The sum of the hinge loss of the points.
+   */
+  double HingeLoss(const arma::mat& parameters,
+                   const size_t firstId,
+                   const size_t batchSize,
+                   arma::mat* gradient = NULL) const;
+
   //! The initial point, from which to start the optimization.
   arma::mat initialPoint;
 
-  //! Label matrix for provided data
-  arma::sp_mat groundTruth;
-
   //! The datapoints for training.
   MatType dataset;
 
+  //! The labels of the datapoints.
+  arma::Row<size_t> labels;
+
   //! Number of Classes.
   size_t numClasses;
 
@@ -32,6 +32,7 @@ LinearSVMFunction<MatType>::LinearSVMFunction(
     const double delta,
     const bool fitIntercept) :
     dataset(math::MakeAlias(const_cast<MatType&>(dataset), false)),
+    labels(labels),
     numClasses(numClasses),
     lambda(lambda),
     delta(delta),
@@ -39,9 +40,6 @@ LinearSVMFunction<MatType>::LinearSVMFunction(
 {
   InitializeWeights(initialPoint, dataset.n_rows, numClasses, fitIntercept);
   initialPoint *= 0.005;
-
-  // Calculate the label matrix.
-  GetGroundTruthMatrix(labels, groundTruth);
 }
 
 /**
@@ -110,86 +108,109 @@ void LinearSVMFunction<MatType>::GetGroundTruthMatrix(
 template <typename MatType>
 void LinearSVMFunction<MatType>::Shuffle()
 {
-  // Determine new ordering.
-  arma::uvec ordering = arma::shuffle(arma::linspace<arma::uvec>(0,
-      dataset.n_cols - 1, dataset.n_cols));
+  // The sparse overload of ShuffleData() handles sparse datasets.
+  MatType newData;
+  arma::Row<size_t> newLabels;
+  math::ShuffleData(dataset, labels, newData, newLabels);
 
-  // Re-sort data.
-  arma::mat newData = dataset.cols(ordering);
   math::ClearAlias(dataset);
   dataset = std::move(newData);
+  labels = std::move(newLabels);
+}
 
-  // Assemble data for batch constructor.  We need reverse orderings though...
-  arma::uvec reverseOrdering(ordering.n_elem);
-  for (size_t i = 0; i < ordering.n_elem; ++i)
-    reverseOrdering[ordering[i]] = i;
-
-  arma::umat newLocations(2, groundTruth.n_nonzero);
-  arma::vec values(groundTruth.n_nonzero);
-  arma::sp_mat::const_iterator it = groundTruth.begin();
-  size_t loc = 0;
-  while (it != groundTruth.end())
+template <typename MatType>
+double LinearSVMFunction<MatType>::HingeLoss(
+    const arma::mat& parameters,
+    const size_t firstId,
+    const size_t batchSize,
+    arma::mat* gradient) const
+{
+  // The loss is
+  // L_i = Σ_i Σ_m max(0, Δ + (w_m x_i + b_m) - (w_{y_i} x_i + b_{y_i}))
+  // where (m != y_i).  The gradient of each term adds `x_i` to `w_m` and
+  // subtracts it from `w_{y_i}` if the margin is positive.
+  //
+  // The points are processed in blocks, so that only the scores of one block
+  // of points per thread are held at a time, and the blocks are split between
+  // the threads when OpenMP is available.
+  const size_t blockSize = 1024;
+  const size_t numBlocks = (batchSize + blockSize - 1) / blockSize;
+  const size_t dims = dataset.n_rows;
+
+  if (gradient)
+    gradient->zeros(arma::size(parameters));
+
+  double loss = 0.0;
+  #pragma omp parallel reduction(+:loss)
   {
-    newLocations(0, loc) = reverseOrdering(it.col());
-    newLocations(1, loc) = it.row();
-    values(loc) = (*it);
-
-    ++it;
-    ++loc;
+    arma::mat localGradient;
+    if (gradient)
+      localGradient.zeros(arma::size(parameters));
+
+    #pragma omp for schedule(static)
+    for (omp_size_t block = 0; block < (omp_size_t) numBlocks; ++block)
+    {
+      const size_t begin = firstId + block * blockSize;
+      const size_t end = std::min(begin + blockSize, firstId + batchSize) - 1;
+
+      // Scores for each class are evaluated.
+      arma::mat scores = parameters.rows(0, dims - 1).t() *
+          dataset.cols(begin, end);
+      if (fitIntercept)
+      {
+        // The last row of the parameters holds the intercept `b_i`.
+        scores.each_col() += parameters.row(dims).t();
+      }
+
+      // Turn the scores into the coefficient of each point in the gradient of
+      // each class, adding the positive margins to the loss on the way.
+      for (size_t i = 0; i < scores.n_cols; ++i)
+      {
+        const size_t label = labels[begin + i];
+        const double correctScore = scores(label, i);
+        size_t positive = 0;
+        for (size_t m = 0; m < numClasses; ++m)
+        {
+          const double margin = scores(m, i) - correctScore + delta;
+          if (m != label && margin > 0)
+          {
+            loss += margin;
+            scores(m, i) = 1;
+            ++positive;
+          }
+          else
+          {
+            scores(m, i) = 0;
+          }
+        }
+
+        scores(label, i) = -((double) positive);
+      }
+
+      if (gradient)
+      {
+        localGradient.rows(0, dims - 1) += dataset.cols(begin, end) *
+            scores.t();
+        if (fitIntercept)
+          localGradient.row(dims) += arma::sum(scores, 1).t();
+      }
+    }
+
+    if (gradient)
+    {
+      #pragma omp critical(linearSVMGradient)
+      *gradient += localGradient;
+    }
   }
 
-  groundTruth = arma::sp_mat(newLocations, values, groundTruth.n_rows,
-                             groundTruth.n_cols);
+  return loss;
 }
 
 template <typename MatType>
 double LinearSVMFunction<MatType>::Evaluate(
     const arma::mat& parameters)
 {
-  // The objective function is the hinge loss function and it is
-  // calculated over all the training examples.
-
-  // Calculate the loss and regularization terms.
-  // L_i = Σ_i Σ_m max(0, Δ + (w_m x_i + b_m) - (w_{y_i} x_i + b_{y_i}))
-  // where (m != y_i)
-  double loss, regularization;
-
-  // Scores for each class are evaluated.
-  arma::mat scores;
-
-  // Check intercept condition.
-  if (!fitIntercept)
-  {
-    scores = parameters.t() * dataset;
-  }
-  else
-  {
-    // When using `fitIntercept` we need to add the `b_i` term explicitly.
-    // The first `parameters.n_rows - 1` rows of parameters holds the value
-    // of Weights `w_i`, and the last row holds `b_i`.
-    // On calculating the score, we add `b_i` term to each element of
-    // `i_th` row of `scores`.
-    scores = parameters.rows(0, dataset.n_rows - 1).t() * dataset
-        + arma::repmat(parameters.row(dataset.n_rows).t(), 1,
-        dataset.n_cols);
-  }
-
-  // Evaluate the margin by the following steps:
-  //  - Subtracting the score of correct class from all the class scores.
-  //  - Adding the margin parameter `delta`.
-  //  - Removing the `delta` parameter from correct class label in each
-  //    column.
-  arma::mat margin = scores - (arma::repmat(arma::ones(numClasses).t()
-      * (scores % groundTruth), numClasses, 1)) + delta
-      - (delta * groundTruth);
-
-  // The Hinge Loss Function
-  loss = arma::accu(arma::clamp(margin, 0.0, DBL_MAX)) / dataset.n_cols;
-
-  // Adding the regularization term.
-  regularization = 0.5 * lambda * arma::dot(parameters, parameters);
-
-  return loss + regularization;
+  return Evaluate(parameters, 0, dataset.n_cols);
 }
 
 template <typename MatType>
@@ -198,40 +219,9 @@ double LinearSVMFunction<MatType>::Evaluate(
     const size_t firstId,
     const size_t batchSize)
 {
-  const size_t lastId = firstId + batchSize - 1;
-
-  // Calculate the loss and regularization terms.
-  double loss, regularization, cost;
-
-  // Scores for each class are evaluated.
-  arma::mat scores;
-
-  // Check intercept condition.
-  if (!fitIntercept)
-  {
-    scores = parameters.t() * dataset.cols(firstId, lastId);
-  }
-  else
-  {
-    scores = parameters.rows(0, dataset.n_rows - 1).t()
-        * dataset.cols(firstId, lastId)
-        + arma::repmat(parameters.row(dataset.n_rows).t(), 1,
-        dataset.n_cols);
-  }
-
-  arma::mat margin = scores - (arma::repmat(arma::ones(numClasses).t()
-      * (scores % groundTruth.cols(firstId, lastId)), numClasses, 1))
-      + delta - (delta * groundTruth.cols(firstId, lastId));
-
-  // The Hinge Loss Function
-  loss = arma::accu(arma::clamp(margin, 0.0, DBL_MAX));
-  loss /= batchSize;
-
-  // Adding the regularization term.
-  regularization = 0.5 * lambda * arma::dot(parameters, parameters);
-
-  cost = loss + regularization;
-  return cost;
+  // The hinge loss, with the regularization term.
+  return HingeLoss(parameters, firstId, batchSize) / batchSize +
+      0.5 * lambda * arma::dot(parameters, parameters);
 }
 
 template <typename MatType>
@@ -240,62 +230,7 @@ void LinearSVMFunction<MatType>::Gradient(
     const arma::mat& parameters,
     GradType& gradient)
 {
-  // The objective is to minimize the loss, which is evaluated as the sum
-  // of all the positive elements of `margin` matrix.
-  // So, we focus of these positive elements and reduce them.
-  // Also, we need to increase the score of the correct class.
-
-  // Scores for each class are evaluated.
-  arma::mat scores;
-
-  if (!fitIntercept)
-  {
-    scores = parameters.t() * dataset;
-  }
-  else
-  {
-    scores = parameters.rows(0, dataset.n_rows - 1).t() * dataset
-        + arma::repmat(parameters.row(dataset.n_rows).t(), 1,
-        dataset.n_cols);
-  }
-
-  arma::mat margin = scores - (arma::repmat(arma::ones(numClasses).t()
-      * (scores % groundTruth), numClasses, 1)) + delta
-      - (delta * groundTruth);
-
-  // An element of `mask` matrix holds `1` corresponding to
-  // each positive element of `margin` matrix.
-  arma::mat mask = margin.for_each([](arma::mat::elem_type& val)
-      { val = (val > 0) ? 1: 0; });
-
-  arma::mat difference = groundTruth
-      % (-arma::repmat(arma::sum(mask), numClasses, 1)) + mask;
-
-  // The gradient is evaluated as follows:
-  //  - Add `x_i` to `w_j` if `margin_i_m`is positive.
-  //  - Subtract `x_i` from `w_y_i` for each positive
-  //    `margin_i_j`.
-  //  - Take the average over the size of dataset.
-  //  - Add the regularization parameter.
-
-  // Check intercept condition
-  if (!fitIntercept)
-  {
-    gradient = dataset * difference.t();
-  }
-  else
-  {
-    gradient.set_size(arma::size(parameters));
-    gradient.submat(0, 0, parameters.n_rows - 2, parameters.n_cols - 1) =
-        dataset * difference.t();
-    gradient.row(parameters.n_rows - 1) =
-        arma::ones<arma::rowvec>(dataset.n_cols) * difference.t();
-  }
-
-  gradient /= dataset.n_cols;
-
-  // Adding the regularization contribution to the gradient.
-  gradient += lambda * parameters;
+  Gradient(parameters, 0, gradient, dataset.n_cols);
 }
 
 template <typename MatType>
@@ -306,53 +241,7 @@ void LinearSVMFunction<MatType>::Gradient(
     GradType& gradient,
     const size_t batchSize)
 {
-  const size_t lastId = firstId + batchSize - 1;
-
-  // Scores for each class are evaluated.
-  arma::mat scores;
-
-  // Check intercept condition.
-  if (!fitIntercept)
-  {
-    scores = parameters.t() * dataset.cols(firstId, lastId);
-  }
-  else
-  {
-    scores = parameters.rows(0, dataset.n_rows - 1).t()
-        * dataset.cols(firstId, lastId)
-        + arma::repmat(parameters.row(dataset.n_rows).t(), 1, batchSize);
-  }
-
-  arma::mat margin = scores - (arma::repmat(arma::ones(numClasses).t()
-      * (scores % groundTruth.cols(firstId, lastId)), numClasses, 1))
-      + delta - (delta * groundTruth.cols(firstId, lastId));
-
-  // For each sample, find the total number of classes where
-  // ( margin > 0 ).
-  arma::mat mask = margin.for_each([](arma::mat::elem_type& val)
-      { val = (val > 0) ? 1: 0; });
-
-  arma::mat difference = groundTruth.cols(firstId, lastId)
-      % (-arma::repmat(arma::sum(mask), numClasses, 1)) + mask;
-
-  // Check intercept condition
-  if (!fitIntercept)
-  {
-    gradient = dataset.cols(firstId, lastId) * difference.t();
-  }
-  else
-  {
-    gradient.set_size(arma::size(parameters));
-    gradient.submat(0, 0, parameters.n_rows - 2, parameters.n_cols - 1) =
-        dataset.cols(firstId, lastId) * difference.t();
-    gradient.row(parameters.n_rows - 1) =
-        arma::ones<arma::rowvec>(batchSize) * difference.t();
-  }
-
-  gradient /= batchSize;
-
-  // Adding the regularization contribution to the gradient.
-  gradient += lambda * parameters;
+  EvaluateWithGradient(parameters, firstId, gradient, batchSize);
 }
 
 template <typename MatType>
@@ -361,62 +250,7 @@ double LinearSVMFunction<MatType>::EvaluateWithGradient(
     const arma::mat& parameters,
     GradType& gradient) const
 {
-  double loss, regularization, cost;
-
-  // Scores for each class are evaluated.
-  arma::mat scores;
-
-  if (!fitIntercept)
-  {
-    scores = parameters.t() * dataset;
-  }
-  else
-  {
-    scores = parameters.rows(0, dataset.n_rows - 1).t() * dataset
-        + arma::repmat(parameters.row(dataset.n_rows).t(), 1,
-        dataset.n_cols);
-  }
-
-  arma::mat margin = scores - (arma::repmat(arma::ones(numClasses).t()
-      * (scores % groundTruth), numClasses, 1)) + delta
-      - (delta * groundTruth);
-
-  // For each sample, find the total number of classes where
-  // ( margin > 0 ).
-  arma::mat mask = margin.for_each([](arma::mat::elem_type& val)
-      { val = (val > 0) ? 1: 0; });
-
-  arma::mat difference = groundTruth
-      % (-arma::repmat(arma::sum(mask), numClasses, 1)) + mask;
-
-  // Check intercept condition
-  if (!fitIntercept)
-  {
-    gradient = dataset * difference.t();
-  }
-  else
-  {
-    gradient.set_size(arma::size(parameters));
-    gradient.submat(0, 0, parameters.n_rows - 2, parameters.n_cols - 1) =
-            dataset * difference.t();
-    gradient.row(parameters.n_rows - 1) =
-            arma::ones<arma::rowvec>(dataset.n_cols) * difference.t();
-  }
-
-  gradient /= dataset.n_cols;
-
-  // Adding the regularization contribution to the gradient.
-  gradient += lambda * parameters;
-
-  // The Hinge Loss Function
-  loss = arma::accu(arma::clamp(margin, 0.0, DBL_MAX));
-  loss /= dataset.n_cols;
-
-  // Adding the regularization term.
-  regularization = 0.5 * lambda * arma::dot(parameters, parameters);
-
-  cost = loss + regularization;
-  return cost;
+  return EvaluateWithGradient(parameters, 0, gradient, dataset.n_cols);
 }
 
 template <typename MatType>
@@ -427,67 +261,15 @@ double LinearSVMFunction<MatType>::EvaluateWithGradient(
     GradType& gradient,
     const size_t batchSize) const
 {
-  const size_t lastId = firstId + batchSize - 1;
-
-  // Calculate the loss and regularization terms.
-  double loss, regularization, cost;
-
-  // Scores for each class are evaluated.
-  arma::mat scores;
-
-  // Check intercept condition.
-  if (!fitIntercept)
-  {
-    scores = parameters.t() * dataset.cols(firstId, lastId);
-  }
-  else
-  {
-    scores = parameters.rows(0, dataset.n_rows - 1).t()
-        * dataset.cols(firstId, lastId)
-        + arma::repmat(parameters.row(dataset.n_rows).t(), 1, dataset.n_cols);
-  }
-
-  arma::mat margin = scores - (arma::repmat(arma::ones(numClasses).t()
-      * (scores % groundTruth.cols(firstId, lastId)), numClasses, 1))
-      + delta - (delta * groundTruth.cols(firstId, lastId));
-
-  // For each sample, find the total number of classes where
-  // ( margin > 0 ).
-  arma::mat mask = margin.for_each([](arma::mat::elem_type& val)
-      { val = (val > 0) ? 1: 0; });
-
-  arma::mat difference = groundTruth.cols(firstId, lastId)
-      % (-arma::repmat(arma::sum(mask), numClasses, 1)) + mask;
-
-  // Check intercept condition
-  if (!fitIntercept)
-  {
-    gradient = dataset.cols(firstId, lastId) * difference.t();
-  }
-  else
-  {
-    gradient.set_size(arma::size(parameters));
-    gradient.submat(0, 0, parameters.n_rows - 2, parameters.n_cols - 1) =
-        dataset.cols(firstId, lastId) * difference.t();
-    gradient.row(parameters.n_rows - 1) =
-        arma::ones<arma::rowvec>(batchSize) * difference.t();
-  }
-
-  gradient /= batchSize;
-
-
-  // Adding the regularization contribution to the gradient.
-  gradient += lambda * parameters;
-
-  // The Hinge Loss Function
-  loss = arma::accu(arma::clamp(margin.cols(firstId, lastId), 0.0, DBL_MAX));
-  loss /= batchSize;
+  arma::mat hingeGradient;
+  const double loss = HingeLoss(parameters, firstId, batchSize,
+      &hingeGradient);
 
-  // Adding the regularization term.
-  regularization = 0.5 * lambda * arma::dot(parameters, parameters);
+  // Take the average over the batch and add the regularization contribution
+  // to the gradient.
+  gradient = hingeGradient / batchSize + lambda * parameters;
 
-  cost = loss + regularization;
-  return cost;
+  return loss / batchSize + 0.5 * lambda * arma::dot(parameters, parameters);
 }
 
 template <typename MatType>
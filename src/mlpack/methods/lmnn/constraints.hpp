@@ -26,8 +26,21 @@ namespace lmnn {
  * of each data point), Impostors() (used for calculating impostors of each
  * data point) and Triplets() (Generates sets of {dataset, target neighbors,
  * impostors} tripltets.)
+ *
+ * The target neighbors of all the points are found with one all-kNN search
+ * per class, done by TargetSearchType; it can be any class with a
+ * default constructor, Train(referenceSet) and Search(k, neighbors, distances)
+ * methods like NeighborSearch, for instance neighbor::NNDescent for an
+ * approximate search on high-dimensional data.
+ *
+ * @tparam MetricType The metric to use for the searches.
+ * @tparam TargetSearchType The all-kNN search used for the target neighbors.
  */
-template<typename MetricType = metric::SquaredEuclideanDistance>
+template<
+    typename MetricType = metric::SquaredEuclideanDistance,
+    typename TargetSearchType = neighbor::NeighborSearch<
+        neighbor::NearestNeighborSort, MetricType>
+>
 class Constraints
 {
  public:
@@ -213,6 +226,14 @@ class Constraints
   */
   inline void Precalculate(const arma::Row<size_t>& labels);
 
+  /**
+  * Return whether the searches of the different classes should be run in
+  * parallel (each class only writes to the columns of its own points).  This
+  * is the case when there are at least as many classes as threads, and we are
+  * not already in a parallel region; otherwise each search is parallel itself.
+  */
+  inline bool ParallelOverClasses() const;
+
   /**
   * Re-order neighbors on the basis of increasing norm in case
   * of ties among distances.
@@ -15,11 +15,15 @@
 // In case it hasn't been included already.
 #include "constraints.hpp"
 
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
 namespace mlpack {
 namespace lmnn {
 
-template<typename MetricType>
-Constraints<MetricType>::Constraints(
+template<typename MetricType, typename TargetSearchType>
+Constraints<MetricType, TargetSearchType>::Constraints(
     const arma::mat& /* dataset */,
     const arma::Row<size_t>& labels,
     const size_t k) :
@@ -37,11 +41,11 @@ Constraints<MetricType>::Constraints(
   }
 }
 
-template<typename MetricType>
-inline void Constraints<MetricType>::ReorderResults(
-                                            const arma::mat& distances,
-                                            arma::Mat<size_t>& neighbors,
-                                            const arma::vec& norms)
+template<typename MetricType, typename TargetSearchType>
+inline void Constraints<MetricType, TargetSearchType>::ReorderResults(
+    const arma::mat& distances,
+    arma::Mat<size_t>& neighbors,
+    const arma::vec& norms)
 {
   // Shortcut...
   if (neighbors.n_rows == 1)
@@ -78,23 +82,26 @@ inline void Constraints<MetricType>::ReorderResults(
 }
 
 // Calculates k similar labeled nearest neighbors.
-template<typename MetricType>
-void Constraints<MetricType>::TargetNeighbors(arma::Mat<size_t>& outputMatrix,
-                                              const arma::mat& dataset,
-                                              const arma::Row<size_t>& labels,
-                                              const arma::vec& norms)
+template<typename MetricType, typename TargetSearchType>
+void Constraints<MetricType, TargetSearchType>::TargetNeighbors(
+    arma::Mat<size_t>& outputMatrix,
+    const arma::mat& dataset,
+    const arma::Row<size_t>& labels,
+    const arma::vec& norms)
 {
   // Perform pre-calculation. If neccesary.
   Precalculate(labels);
 
-  // KNN instance.
-  KNN knn;
+  const bool parallel = ParallelOverClasses();
+  #pragma omp parallel for schedule(dynamic) if(parallel)
+  for (omp_size_t i = 0; i < (omp_size_t) uniqueLabels.n_cols; i++)
+  {
+    // Search instance.
+    TargetSearchType knn;
 
-  arma::Mat<size_t> neighbors;
-  arma::mat distances;
+    arma::Mat<size_t> neighbors;
+    arma::mat distances;
 
-  for (size_t i = 0; i < uniqueLabels.n_cols; i++)
-  {
     // Perform KNN search with same class points as both reference
     // set and query set.
     knn.Train(dataset.cols(indexSame[i]));
@@ -115,13 +122,14 @@ void Constraints<MetricType>::TargetNeighbors(arma::Mat<size_t>& outputMatrix,
 
 // Calculates k similar labeled nearest neighbors  on a
 // batch of data points.
-template<typename MetricType>
-void Constraints<MetricType>::TargetNeighbors(arma::Mat<size_t>& outputMatrix,
-                                              const arma::mat& dataset,
-                                              const arma::Row<size_t>& labels,
-                                              const arma::vec& norms,
-                                              const size_t begin,
-                                              const size_t batchSize)
+template<typename MetricType, typename TargetSearchType>
+void Constraints<MetricType, TargetSearchType>::TargetNeighbors(
+    arma::Mat<size_t>& outputMatrix,
+    const arma::mat& dataset,
+    const arma::Row<size_t>& labels,
+    const arma::vec& norms,
+    const size_t begin,
+    const size_t batchSize)
 {
   // Perform pre-calculation. If neccesary.
   Precalculate(labels);
@@ -129,19 +137,18 @@ void Constraints<MetricType>::TargetNeighbors(arma::Mat<size_t>& outputMatrix,
   arma::mat subDataset = dataset.cols(begin, begin + batchSize - 1);
   arma::Row<size_t> sublabels = labels.cols(begin, begin + batchSize - 1);
 
-  // KNN instance.
-  KNN knn;
-
-  arma::Mat<size_t> neighbors;
-  arma::mat distances;
+  const bool parallel = ParallelOverClasses();
+  #pragma omp parallel for schedule(dynamic) if(parallel)
+  for (omp_size_t i = 0; i < (omp_size_t) uniqueLabels.n_cols; i++)
+  {
+    // KNN instance.
+    KNN knn;
 
-  // Vectors to store indices.
-  arma::uvec subIndexSame;
+    arma::Mat<size_t> neighbors;
+    arma::mat distances;
 
-  for (size_t i = 0; i < uniqueLabels.n_cols; i++)
-  {
     // Calculate Target Neighbors.
-    subIndexSame = arma::find(sublabels == uniqueLabels[i]);
+    const arma::uvec subIndexSame = arma::find(sublabels == uniqueLabels[i]);
 
     // Perform KNN search with same class points as both reference
     // set and query set.
@@ -162,23 +169,26 @@ void Constraints<MetricType>::TargetNeighbors(arma::Mat<size_t>& outputMatrix,
 }
 
 // Calculates k differently labeled nearest neighbors.
-template<typename MetricType>
-void Constraints<MetricType>::Impostors(arma::Mat<size_t>& outputMatrix,
-                                        const arma::mat& dataset,
-                                        const arma::Row<size_t>& labels,
-                                        const arma::vec& norms)
+template<typename MetricType, typename TargetSearchType>
+void Constraints<MetricType, TargetSearchType>::Impostors(
+    arma::Mat<size_t>& outputMatrix,
+    const arma::mat& dataset,
+    const arma::Row<size_t>& labels,
+    const arma::vec& norms)
 {
   // Perform pre-calculation. If neccesary.
   Precalculate(labels);
 
-  // KNN instance.
-  KNN knn;
+  const bool parallel = ParallelOverClasses();
+  #pragma omp parallel for schedule(dynamic) if(parallel)
+  for (omp_size_t i = 0; i < (omp_size_t) uniqueLabels.n_cols; i++)
+  {
+    // KNN instance.
+    KNN knn;
 
-  arma::Mat<size_t> neighbors;
-  arma::mat distances;
+    arma::Mat<size_t> neighbors;
+    arma::mat distances;
 
-  for (size_t i = 0; i < uniqueLabels.n_cols; i++)
-  {
     // Perform KNN search with differently labeled points as reference
     // set and  same class points as query set.
     knn.Train(dataset.cols(indexDiff[i]));
@@ -199,24 +209,27 @@ void Constraints<MetricType>::Impostors(arma::Mat<size_t>& outputMatrix,
 
 // Calculates k differently labeled nearest neighbors. The function
 // writes back calculated neighbors & distances to passed matrices.
-template<typename MetricType>
-void Constraints<MetricType>::Impostors(arma::Mat<size_t>& outputNeighbors,
-                                        arma::mat& outputDistance,
-                                        const arma::mat& dataset,
-                                        const arma::Row<size_t>& labels,
-                                        const arma::vec& norms)
+template<typename MetricType, typename TargetSearchType>
+void Constraints<MetricType, TargetSearchType>::Impostors(
+    arma::Mat<size_t>& outputNeighbors,
+    arma::mat& outputDistance,
+    const arma::mat& dataset,
+    const arma::Row<size_t>& labels,
+    const arma::vec& norms)
 {
   // Perform pre-calculation. If neccesary.
   Precalculate(labels);
 
-  // KNN instance.
-  KNN knn;
+  const bool parallel = ParallelOverClasses();
+  #pragma omp parallel for schedule(dynamic) if(parallel)
+  for (omp_size_t i = 0; i < (omp_size_t) uniqueLabels.n_cols; i++)
+  {
+    // KNN instance.
+    KNN knn;
 
-  arma::Mat<size_t> neighbors;
-  arma::mat distances;
+    arma::Mat<size_t> neighbors;
+    arma::mat distances;
 
-  for (size_t i = 0; i < uniqueLabels.n_cols; i++)
-  {
     // Perform KNN search with differently labeled points as reference
     // set and  same class points as query set.
     knn.Train(dataset.cols(indexDiff[i]));
@@ -238,13 +251,14 @@ void Constraints<MetricType>::Impostors(arma::Mat<size_t>& outputNeighbors,
 
 // Calculates k differently labeled nearest neighbors on a
 // batch of data points.
-template<typename MetricType>
-void Constraints<MetricType>::Impostors(arma::Mat<size_t>& outputMatrix,
-                                        const arma::mat& dataset,
-                                        const arma::Row<size_t>& labels,
-                                        const arma::vec& norms,
-                                        const size_t begin,
-                                        const size_t batchSize)
+template<typename MetricType, typename TargetSearchType>
+void Constraints<MetricType, TargetSearchType>::Impostors(
+    arma::Mat<size_t>& outputMatrix,
+    const arma::mat& dataset,
+    const arma::Row<size_t>& labels,
+    const arma::vec& norms,
+    const size_t begin,
+    const size_t batchSize)
 {
   // Perform pre-calculation. If neccesary.
   Precalculate(labels);
@@ -252,19 +266,18 @@ void Constraints<MetricType>::Impostors(arma::Mat<size_t>& outputMatrix,
   arma::mat subDataset = dataset.cols(begin, begin + batchSize - 1);
   arma::Row<size_t> sublabels = labels.cols(begin, begin + batchSize - 1);
 
-  // KNN instance.
-  KNN knn;
-
-  arma::Mat<size_t> neighbors;
-  arma::mat distances;
+  const bool parallel = ParallelOverClasses();
+  #pragma omp parallel for schedule(dynamic) if(parallel)
+  for (omp_size_t i = 0; i < (omp_size_t) uniqueLabels.n_cols; i++)
+  {
+    // KNN instance.
+    KNN knn;
 
-  // Vectors to store indices.
-  arma::uvec subIndexSame;
+    arma::Mat<size_t> neighbors;
+    arma::mat distances;
 
-  for (size_t i = 0; i < uniqueLabels.n_cols; i++)
-  {
     // Calculate impostors.
-    subIndexSame = arma::find(sublabels == uniqueLabels[i]);
+    const arma::uvec subIndexSame = arma::find(sublabels == uniqueLabels[i]);
 
     // Perform KNN search with differently labeled points as reference
     // set and same class points as query set.
@@ -286,14 +299,15 @@ void Constraints<MetricType>::Impostors(arma::Mat<size_t>& outputMatrix,
 
 // Calculates k differently labeled nearest neighbors & distances on a
 // batch of data points.
-template<typename MetricType>
-void Constraints<MetricType>::Impostors(arma::Mat<size_t>& outputNeighbors,
-                                        arma::mat& outputDistance,
-                                        const arma::mat& dataset,
-                                        const arma::Row<size_t>& labels,
-                                        const arma::vec& norms,
-                                        const size_t begin,
-                                        const size_t batchSize)
+template<typename MetricType, typename TargetSearchType>
+void Constraints<MetricType, TargetSearchType>::Impostors(
+    arma::Mat<size_t>& outputNeighbors,
+    arma::mat& outputDistance,
+    const arma::mat& dataset,
+    const arma::Row<size_t>& labels,
+    const arma::vec& norms,
+    const size_t begin,
+    const size_t batchSize)
 {
   // Perform pre-calculation. If neccesary.
   Precalculate(labels);
@@ -301,19 +315,18 @@ void Constraints<MetricType>::Impostors(arma::Mat<size_t>& outputNeighbors,
   arma::mat subDataset = dataset.cols(begin, begin + batchSize - 1);
   arma::Row<size_t> sublabels = labels.cols(begin, begin + batchSize - 1);
 
-  // KNN instance.
-  KNN knn;
-
-  arma::Mat<size_t> neighbors;
-  arma::mat distances;
+  const bool parallel = ParallelOverClasses();
+  #pragma omp parallel for schedule(dynamic) if(parallel)
+  for (omp_size_t i = 0; i < (omp_size_t) uniqueLabels.n_cols; i++)
+  {
+    // KNN instance.
+    KNN knn;
 
-  // Vectors to store indices.
-  arma::uvec subIndexSame;
+    arma::Mat<size_t> neighbors;
+    arma::mat distances;
 
-  for (size_t i = 0; i < uniqueLabels.n_cols; i++)
-  {
     // Calculate impostors.
-    subIndexSame = arma::find(sublabels == uniqueLabels[i]);
+    const arma::uvec subIndexSame = arma::find(sublabels == uniqueLabels[i]);
 
     // Perform KNN search with differently labeled points as reference
     // set and same class points as query set.
@@ -336,32 +349,32 @@ void Constraints<MetricType>::Impostors(arma::Mat<size_t>& outputNeighbors,
 
 // Calculates k differently labeled nearest neighbors & distances over some
 // data points.
-template<typename MetricType>
-void Constraints<MetricType>::Impostors(arma::Mat<size_t>& outputNeighbors,
-                                        arma::mat& outputDistance,
-                                        const arma::mat& dataset,
-                                        const arma::Row<size_t>& labels,
-                                        const arma::vec& norms,
-                                        const arma::uvec& points,
-                                        const size_t numPoints)
+template<typename MetricType, typename TargetSearchType>
+void Constraints<MetricType, TargetSearchType>::Impostors(
+    arma::Mat<size_t>& outputNeighbors,
+    arma::mat& outputDistance,
+    const arma::mat& dataset,
+    const arma::Row<size_t>& labels,
+    const arma::vec& norms,
+    const arma::uvec& points,
+    const size_t numPoints)
 {
   // Perform pre-calculation. If neccesary.
   Precalculate(labels);
 
-  // KNN instance.
-  KNN knn;
-
-  arma::Mat<size_t> neighbors;
-  arma::mat distances;
+  const bool parallel = ParallelOverClasses();
+  #pragma omp parallel for schedule(dynamic) if(parallel)
+  for (omp_size_t i = 0; i < (omp_size_t) uniqueLabels.n_cols; i++)
+  {
+    // KNN instance.
+    KNN knn;
 
-  // Vectors to store indices.
-  arma::uvec subIndexSame;
+    arma::Mat<size_t> neighbors;
+    arma::mat distances;
 
-  for (size_t i = 0; i < uniqueLabels.n_cols; i++)
-  {
     // Calculate impostors.
-    subIndexSame = arma::find(labels.cols(points.head(numPoints)) ==
-        uniqueLabels[i]);
+    const arma::uvec subIndexSame = arma::find(
+        labels.cols(points.head(numPoints)) == uniqueLabels[i]);
 
     // Perform KNN search with differently labeled points as reference
     // set and same class points as query set.
@@ -385,11 +398,12 @@ void Constraints<MetricType>::Impostors(arma::Mat<size_t>& outputNeighbors,
 
 // Generates {data point, target neighbors, impostors} triplets using
 // TargetNeighbors() and Impostors().
-template<typename MetricType>
-void Constraints<MetricType>::Triplets(arma::Mat<size_t>& outputMatrix,
-                                       const arma::mat& dataset,
-                                       const arma::Row<size_t>& labels,
-                                       const arma::vec& norms)
+template<typename MetricType, typename TargetSearchType>
+void Constraints<MetricType, TargetSearchType>::Triplets(
+    arma::Mat<size_t>& outputMatrix,
+    const arma::mat& dataset,
+    const arma::Row<size_t>& labels,
+    const arma::vec& norms)
 {
   // Perform pre-calculation. If neccesary.
   Precalculate(labels);
@@ -419,9 +433,21 @@ void Constraints<MetricType>::Triplets(arma::Mat<size_t>& outputMatrix,
   }
 }
 
-template<typename MetricType>
-inline void Constraints<MetricType>::Precalculate(
-                                         const arma::Row<size_t>& labels)
+template<typename MetricType, typename TargetSearchType>
+inline bool
+Constraints<MetricType, TargetSearchType>::ParallelOverClasses() const
+{
+#ifdef HAS_OPENMP
+  return (omp_get_level() == 0) &&
+      (uniqueLabels.n_cols >= (size_t) omp_get_max_threads());
+#else
+  return false;
+#endif
+}
+
+template<typename MetricType, typename TargetSearchType>
+inline void Constraints<MetricType, TargetSearchType>::Precalculate(
+    const arma::Row<size_t>& labels)
 {
   // Make sure the calculation is necessary.
   if (precalculated)
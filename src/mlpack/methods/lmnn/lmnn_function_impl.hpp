@@ -257,7 +257,8 @@ double LMNNFunction<MetricType>::Evaluate(const arma::mat& transformation)
     constraint.Impostors(impostors, distance, transformedDataset, labels, norm);
   }
 
-  for (size_t i = 0; i < dataset.n_cols; i++)
+  #pragma omp parallel for reduction(+:cost)
+  for (omp_size_t i = 0; i < (omp_size_t) dataset.n_cols; i++)
   {
     for (size_t j = 0; j < k ; j++)
     {
@@ -384,7 +385,9 @@ double LMNNFunction<MetricType>::Evaluate(const arma::mat& transformation,
         norm, begin, batchSize);
   }
 
-  for (size_t i = begin; i < begin + batchSize; i++)
+  #pragma omp parallel for reduction(+:cost)
+  for (omp_size_t i = (omp_size_t) begin;
+      i < (omp_size_t) (begin + batchSize); i++)
   {
     for (size_t j = 0; j < k ; j++)
     {
@@ -411,7 +414,7 @@ double LMNNFunction<MetricType>::Evaluate(const arma::mat& transformation,
           maxImpNorm(l, i) = std::max(maxImpNorm(l, i), norm(impostors(l, i)));
 
           eval = evalOld(l, j, i) +
-              transformationDiffs[lastTransformationIndices[i]] *
+              transformationDiffs.at(lastTransformationIndices[i]) *
               (norm(targetNeighbors(j, i)) + maxImpNorm(l, i) + 2 * norm(i));
         }
 
@@ -452,6 +455,7 @@ double LMNNFunction<MetricType>::Evaluate(const arma::mat& transformation,
           // update bound.
           evalOld(l, j, i) = 0;
           maxImpNorm(l, i) = 0;
+          #pragma omp atomic
           --oldTransformationCounts[lastTransformationIndices(i)];
           lastTransformationIndices(i) = 0;
         }
@@ -520,73 +524,86 @@ void LMNNFunction<MetricType>::Gradient(const arma::mat& transformation,
   // Calculate gradient due to impostors.
   arma::mat cil = arma::zeros(dataset.n_rows, dataset.n_rows);
 
-  for (size_t i = 0; i < dataset.n_cols; i++)
+  #pragma omp parallel
   {
-    for (int j = k - 1; j >= 0; j--)
+    // Each thread sums the outer products of its own points.
+    arma::mat threadCil = arma::zeros(dataset.n_rows, dataset.n_rows);
+
+    #pragma omp for
+    for (omp_size_t i = 0; i < (omp_size_t) dataset.n_cols; i++)
     {
-      // Bound constraints to avoid uneccesary computation.
-      for (size_t l = 0, bp = k; l < bp ; l++)
+      for (int j = k - 1; j >= 0; j--)
       {
-        // Calculate cost due to {data point, target neighbors, impostors}
-        // triplets.
-        double eval = 0;
-
-        // Bounds for eval.
-        if (!transformationOld.is_empty() && evalOld(l, j, i) < -1)
+        // Bound constraints to avoid uneccesary computation.
+        for (size_t l = 0, bp = k; l < bp ; l++)
         {
-          // Update cache max impostor norm.
-          maxImpNorm(l, i) = std::max(maxImpNorm(l, i), norm(impostors(l, i)));
-
-          eval = evalOld(l, j, i) + transformationDiff *
-              (norm(targetNeighbors(j, i)) + maxImpNorm(l, i) +
-              2 * norm(i));
-        }
+          // Calculate cost due to {data point, target neighbors, impostors}
+          // triplets.
+          double eval = 0;
 
-        // Calculate exact eval value.
-        if (eval > -1)
-        {
-          if (iteration - 1 % range == 0)
+          // Bounds for eval.
+          if (!transformationOld.is_empty() && evalOld(l, j, i) < -1)
           {
-            eval = metric.Evaluate(transformedDataset.col(i),
-                     transformedDataset.col(targetNeighbors(j, i))) -
-                 distance(l, i);
+            // Update cache max impostor norm.
+            maxImpNorm(l, i) = std::max(maxImpNorm(l, i),
+                norm(impostors(l, i)));
+
+            eval = evalOld(l, j, i) + transformationDiff *
+                (norm(targetNeighbors(j, i)) + maxImpNorm(l, i) +
+                2 * norm(i));
           }
-          else
+
+          // Calculate exact eval value.
+          if (eval > -1)
           {
-            eval = metric.Evaluate(transformedDataset.col(i),
-                     transformedDataset.col(targetNeighbors(j, i))) -
-                   metric.Evaluate(transformedDataset.col(i),
-                       transformedDataset.col(impostors(l, i)));
+            if (iteration - 1 % range == 0)
+            {
+              eval = metric.Evaluate(transformedDataset.col(i),
+                       transformedDataset.col(targetNeighbors(j, i))) -
+                   distance(l, i);
+            }
+            else
+            {
+              eval = metric.Evaluate(transformedDataset.col(i),
+                       transformedDataset.col(targetNeighbors(j, i))) -
+                     metric.Evaluate(transformedDataset.col(i),
+                         transformedDataset.col(impostors(l, i)));
+            }
           }
-        }
 
-        // Update cache eval value.
-        evalOld(l, j, i) = eval;
+          // Update cache eval value.
+          evalOld(l, j, i) = eval;
 
-        // Check bounding condition.
-        if (eval <= -1)
-        {
-          // update bound.
-          bp = l;
-          break;
-        }
+          // Check bounding condition.
+          if (eval <= -1)
+          {
+            // update bound.
+            bp = l;
+            break;
+          }
 
-        // Reset cache.
-        if (eval > -1)
-        {
-          // update bound.
-          evalOld(l, j, i) = 0;
-          maxImpNorm(l, i) = 0;
-        }
+          // Reset cache.
+          if (eval > -1)
+          {
+            // update bound.
+            evalOld(l, j, i) = 0;
+            maxImpNorm(l, i) = 0;
+          }
 
-        // Caculate gradient due to impostors.
-        arma::vec diff = dataset.col(i) - dataset.col(targetNeighbors(j, i));
-        cil += diff * arma::trans(diff);
+          // Caculate gradient due to impostors.
+          arma::vec diff = dataset.col(i) - dataset.col(targetNeighbors(j, i));
+          threadCil += diff * arma::trans(diff);
 
-        diff = dataset.col(i) - dataset.col(impostors(l, i));
-        cil -= diff * arma::trans(diff);
+          diff = dataset.col(i) - dataset.col(impostors(l, i));
+          threadCil -= diff * arma::trans(diff);
+        }
       }
     }
+
+    #pragma omp critical(LMNNGradient)
+    {
+      cil += threadCil;
+    }
   }
 
   gradient = 2 * transformation * ((1 - regularization) * cij +
@@ -649,82 +666,99 @@ void LMNNFunction<MetricType>::Gradient(const arma::mat& transformation,
   arma::mat cij = arma::zeros(dataset.n_rows, dataset.n_rows);
   arma::mat cil = arma::zeros(dataset.n_rows, dataset.n_rows);
 
-  for (size_t i = begin; i < begin + batchSize; i++)
+  #pragma omp parallel
   {
-    for (size_t j = 0; j < k ; j++)
-    {
-      // Calculate gradient due to target neighbors.
-      arma::vec diff = dataset.col(i) - dataset.col(targetNeighbors(j, i));
-      cij += diff * arma::trans(diff);
-    }
+    // Each thread sums the outer products of its own points.
+    arma::mat threadCij = arma::zeros(dataset.n_rows, dataset.n_rows);
+    arma::mat threadCil = arma::zeros(dataset.n_rows, dataset.n_rows);
 
-    for (int j = k - 1; j >= 0; j--)
+    #pragma omp for
+    for (omp_size_t i = (omp_size_t) begin;
+        i < (omp_size_t) (begin + batchSize); i++)
     {
-      // Bound constraints to avoid uneccesary computation.
-      for (size_t l = 0, bp = k; l < bp ; l++)
+      for (size_t j = 0; j < k ; j++)
       {
-        // Calculate cost due to {data point, target neighbors, impostors}
-        // triplets.
-        double eval = 0;
+        // Calculate gradient due to target neighbors.
+        arma::vec diff = dataset.col(i) - dataset.col(targetNeighbors(j, i));
+        threadCij += diff * arma::trans(diff);
+      }
 
-        // Bounds for eval.
-        if (lastTransformationIndices(i) && evalOld(l, j, i) < -1)
+      for (int j = k - 1; j >= 0; j--)
+      {
+        // Bound constraints to avoid uneccesary computation.
+        for (size_t l = 0, bp = k; l < bp ; l++)
         {
-          // Update cache max impostor norm.
-          maxImpNorm(l, i) = std::max(maxImpNorm(l, i), norm(impostors(l, i)));
-
-          eval = evalOld(l, j, i) +
-              transformationDiffs[lastTransformationIndices[i]] *
-              (norm(targetNeighbors(j, i)) + maxImpNorm(l, i) + 2 * norm(i));
-        }
+          // Calculate cost due to {data point, target neighbors, impostors}
+          // triplets.
+          double eval = 0;
 
-        // Calculate exact eval value.
-        if (eval > -1)
-        {
-          if (iteration - 1 % range == 0)
+          // Bounds for eval.
+          if (lastTransformationIndices(i) && evalOld(l, j, i) < -1)
           {
-            eval = metric.Evaluate(transformedDataset.col(i),
-                     transformedDataset.col(targetNeighbors(j, i))) -
-                 distance(l, i);
+            // Update cache max impostor norm.
+            maxImpNorm(l, i) = std::max(maxImpNorm(l, i),
+                norm(impostors(l, i)));
+
+            eval = evalOld(l, j, i) +
+                transformationDiffs.at(lastTransformationIndices[i]) *
+                (norm(targetNeighbors(j, i)) + maxImpNorm(l, i) + 2 * norm(i));
           }
-          else
+
+          // Calculate exact eval value.
+          if (eval > -1)
           {
-            eval = metric.Evaluate(transformedDataset.col(i),
-                     transformedDataset.col(targetNeighbors(j, i))) -
-                   metric.Evaluate(transformedDataset.col(i),
-                       transformedDataset.col(impostors(l, i)));
+            if (iteration - 1 % range == 0)
+            {
+              eval = metric.Evaluate(transformedDataset.col(i),
+                       transformedDataset.col(targetNeighbors(j, i))) -
+                   distance(l, i);
+            }
+            else
+            {
+              eval = metric.Evaluate(transformedDataset.col(i),
+                       transformedDataset.col(targetNeighbors(j, i))) -
+                     metric.Evaluate(transformedDataset.col(i),
+                         transformedDataset.col(impostors(l, i)));
+            }
           }
-        }
 
-        // Update cache eval value.
-        evalOld(l, j, i) = eval;
+          // Update cache eval value.
+          evalOld(l, j, i) = eval;
 
-        // Check bounding condition.
-        if (eval <= -1)
-        {
-          // update bound.
-          bp = l;
-          break;
-        }
+          // Check bounding condition.
+          if (eval <= -1)
+          {
+            // update bound.
+            bp = l;
+            break;
+          }
 
-        // Reset cache.
-        if (eval > -1 && lastTransformationIndices(i))
-        {
-          // update bound.
-          evalOld(l, j, i) = 0;
-          maxImpNorm(l, i) = 0;
-          --oldTransformationCounts[lastTransformationIndices(i)];
-          lastTransformationIndices(i) = 0;
-        }
+          // Reset cache.
+          if (eval > -1 && lastTransformationIndices(i))
+          {
+            // update bound.
+            evalOld(l, j, i) = 0;
+            maxImpNorm(l, i) = 0;
+            #pragma omp atomic
+            --oldTransformationCounts[lastTransformationIndices(i)];
+            lastTransformationIndices(i) = 0;
+          }
 
-        // Caculate gradient due to impostors.
-        arma::vec diff = dataset.col(i) - dataset.col(targetNeighbors(j, i));
-        cil += diff * arma::trans(diff);
+          // Caculate gradient due to impostors.
+          arma::vec diff = dataset.col(i) - dataset.col(targetNeighbors(j, i));
+          threadCil += diff * arma::trans(diff);
 
-        diff = dataset.col(i) - dataset.col(impostors(l, i));
-        cil -= diff * arma::trans(diff);
+          diff = dataset.col(i) - dataset.col(impostors(l, i));
+          threadCil -= diff * arma::trans(diff);
+        }
       }
     }
+
+    #pragma omp critical(LMNNGradient)
+    {
+      cij += threadCij;
+      cil += threadCil;
+    }
   }
 
   gradient = 2 * transformation * ((1 - regularization) * cij +
@@ -795,75 +829,88 @@ double LMNNFunction<MetricType>::EvaluateWithGradient(
   // Calculate gradient due to impostors.
   arma::mat cil = arma::zeros(dataset.n_rows, dataset.n_rows);
 
-  for (size_t i = 0; i < dataset.n_cols; i++)
+  #pragma omp parallel reduction(+:cost)
   {
-    for (size_t j = 0; j < k ; j++)
-    {
-      // Calculate cost due to distance between target neighbors & data point.
-      double eval = metric.Evaluate(transformedDataset.col(i),
-                        transformedDataset.col(targetNeighbors(j, i)));
-      cost += (1 - regularization) * eval;
-    }
+    // Each thread sums the outer products of its own points.
+    arma::mat threadCil = arma::zeros(dataset.n_rows, dataset.n_rows);
 
-    for (int j = k - 1; j >= 0; j--)
+    #pragma omp for
+    for (omp_size_t i = 0; i < (omp_size_t) dataset.n_cols; i++)
     {
-      // Bound constraints to avoid uneccesary computation.
-      for (size_t l = 0, bp = k; l < bp ; l++)
+      for (size_t j = 0; j < k ; j++)
       {
-        // Calculate cost due to {data point, target neighbors, impostors}
-        // triplets.
-        double eval = 0;
+        // Calculate cost due to distance between target neighbors & data point.
+        double eval = metric.Evaluate(transformedDataset.col(i),
+                          transformedDataset.col(targetNeighbors(j, i)));
+        cost += (1 - regularization) * eval;
+      }
 
-        // Bounds for eval.
-        if (!transformationOld.is_empty() && evalOld(l, j, i) < -1)
+      for (int j = k - 1; j >= 0; j--)
+      {
+        // Bound constraints to avoid uneccesary computation.
+        for (size_t l = 0, bp = k; l < bp ; l++)
         {
-          // Update cache max impostor norm.
-          maxImpNorm(l, i) = std::max(maxImpNorm(l, i), norm(impostors(l, i)));
+          // Calculate cost due to {data point, target neighbors, impostors}
+          // triplets.
+          double eval = 0;
 
-          eval = evalOld(l, j, i) + transformationDiff *
-              (norm(targetNeighbors(j, i)) + maxImpNorm(l, i) +
-              2 * norm(i));
-        }
-
-        // Calculate exact eval value.
-        if (eval > -1)
-        {
-          if (iteration - 1 % range == 0)
+          // Bounds for eval.
+          if (!transformationOld.is_empty() && evalOld(l, j, i) < -1)
           {
-            eval = metric.Evaluate(transformedDataset.col(i),
-                     transformedDataset.col(targetNeighbors(j, i))) -
-                 distance(l, i);
+            // Update cache max impostor norm.
+            maxImpNorm(l, i) = std::max(maxImpNorm(l, i),
+                norm(impostors(l, i)));
+
+            eval = evalOld(l, j, i) + transformationDiff *
+                (norm(targetNeighbors(j, i)) + maxImpNorm(l, i) +
+                2 * norm(i));
           }
-          else
+
+          // Calculate exact eval value.
+          if (eval > -1)
           {
-            eval = metric.Evaluate(transformedDataset.col(i),
-                     transformedDataset.col(targetNeighbors(j, i))) -
-                   metric.Evaluate(transformedDataset.col(i),
-                       transformedDataset.col(impostors(l, i)));
+            if (iteration - 1 % range == 0)
+            {
+              eval = metric.Evaluate(transformedDataset.col(i),
+                       transformedDataset.col(targetNeighbors(j, i))) -
+                   distance(l, i);
+            }
+            else
+            {
+              eval = metric.Evaluate(transformedDataset.col(i),
+                       transformedDataset.col(targetNeighbors(j, i))) -
+                     metric.Evaluate(transformedDataset.col(i),
+                         transformedDataset.col(impostors(l, i)));
+            }
           }
-        }
 
-        // Update cache eval value.
-        evalOld(l, j, i) = eval;
+          // Update cache eval value.
+          evalOld(l, j, i) = eval;
 
-        // Check bounding condition.
-        if (eval <= -1)
-        {
-          // update bound.
-          bp = l;
-          break;
-        }
+          // Check bounding condition.
+          if (eval <= -1)
+          {
+            // update bound.
+            bp = l;
+            break;
+          }
 
-        cost += regularization * (1 + eval);
+          cost += regularization * (1 + eval);
 
-        // Caculate gradient due to impostors.
-        arma::vec diff = dataset.col(i) - dataset.col(targetNeighbors(j, i));
-        cil += diff * arma::trans(diff);
+          // Caculate gradient due to impostors.
+          arma::vec diff = dataset.col(i) - dataset.col(targetNeighbors(j, i));
+          threadCil += diff * arma::trans(diff);
 
-        diff = dataset.col(i) - dataset.col(impostors(l, i));
-        cil -= diff * arma::trans(diff);
+          diff = dataset.col(i) - dataset.col(impostors(l, i));
+          threadCil -= diff * arma::trans(diff);
+        }
       }
     }
+
+    #pragma omp critical(LMNNGradient)
+    {
+      cil += threadCil;
+    }
   }
 
   gradient = 2 * transformation * ((1 - regularization) * cij +
@@ -931,79 +978,95 @@ double LMNNFunction<MetricType>::EvaluateWithGradient(
   arma::mat cij = arma::zeros(dataset.n_rows, dataset.n_rows);
   arma::mat cil = arma::zeros(dataset.n_rows, dataset.n_rows);
 
-  for (size_t i = begin; i < begin + batchSize; i++)
+  #pragma omp parallel reduction(+:cost)
   {
-    for (size_t j = 0; j < k ; j++)
-    {
-      // Calculate cost due to distance between target neighbors & data point.
-      double eval = metric.Evaluate(transformedDataset.col(i),
-                        transformedDataset.col(targetNeighbors(j, i)));
-      cost += (1 - regularization) * eval;
+    // Each thread sums the outer products of its own points.
+    arma::mat threadCij = arma::zeros(dataset.n_rows, dataset.n_rows);
+    arma::mat threadCil = arma::zeros(dataset.n_rows, dataset.n_rows);
 
-      // Calculate gradient due to target neighbors.
-      arma::vec diff = dataset.col(i) - dataset.col(targetNeighbors(j, i));
-      cij += diff * arma::trans(diff);
-    }
-
-    for (int j = k - 1; j >= 0; j--)
+    #pragma omp for
+    for (omp_size_t i = (omp_size_t) begin;
+        i < (omp_size_t) (begin + batchSize); i++)
     {
-      // Bound constraints to avoid uneccesary computation.
-      for (size_t l = 0, bp = k; l < bp ; l++)
+      for (size_t j = 0; j < k ; j++)
       {
-        // Calculate cost due to {data point, target neighbors, impostors}
-        // triplets.
-        double eval = 0;
-
-        // Bounds for eval.
-        if (lastTransformationIndices(i) && evalOld(l, j, i) < -1)
-        {
-          // Update cache max impostor norm.
-          maxImpNorm(l, i) = std::max(maxImpNorm(l, i), norm(impostors(l, i)));
+        // Calculate cost due to distance between target neighbors & data point.
+        double eval = metric.Evaluate(transformedDataset.col(i),
+                          transformedDataset.col(targetNeighbors(j, i)));
+        cost += (1 - regularization) * eval;
 
-          eval = evalOld(l, j, i) +
-              transformationDiffs[lastTransformationIndices[i]] *
-              (norm(targetNeighbors(j, i)) + maxImpNorm(l, i) + 2 * norm(i));
-        }
+        // Calculate gradient due to target neighbors.
+        arma::vec diff = dataset.col(i) - dataset.col(targetNeighbors(j, i));
+        threadCij += diff * arma::trans(diff);
+      }
 
-        // Calculate exact eval value.
-        if (eval > -1)
+      for (int j = k - 1; j >= 0; j--)
+      {
+        // Bound constraints to avoid uneccesary computation.
+        for (size_t l = 0, bp = k; l < bp ; l++)
         {
-          if (iteration - 1 % range == 0)
+          // Calculate cost due to {data point, target neighbors, impostors}
+          // triplets.
+          double eval = 0;
+
+          // Bounds for eval.
+          if (lastTransformationIndices(i) && evalOld(l, j, i) < -1)
           {
-            eval = metric.Evaluate(transformedDataset.col(i),
-                     transformedDataset.col(targetNeighbors(j, i))) -
-                 distance(l, i);
+            // Update cache max impostor norm.
+            maxImpNorm(l, i) = std::max(maxImpNorm(l, i),
+                norm(impostors(l, i)));
+
+            eval = evalOld(l, j, i) +
+                transformationDiffs.at(lastTransformationIndices[i]) *
+                (norm(targetNeighbors(j, i)) + maxImpNorm(l, i) + 2 * norm(i));
           }
-          else
+
+          // Calculate exact eval value.
+          if (eval > -1)
           {
-            eval = metric.Evaluate(transformedDataset.col(i),
-                     transformedDataset.col(targetNeighbors(j, i))) -
-                   metric.Evaluate(transformedDataset.col(i),
-                       transformedDataset.col(impostors(l, i)));
+            if (iteration - 1 % range == 0)
+            {
+              eval = metric.Evaluate(transformedDataset.col(i),
+                       transformedDataset.col(targetNeighbors(j, i))) -
+                   distance(l, i);
+            }
+            else
+            {
+              eval = metric.Evaluate(transformedDataset.col(i),
+                       transformedDataset.col(targetNeighbors(j, i))) -
+                     metric.Evaluate(transformedDataset.col(i),
+                         transformedDataset.col(impostors(l, i)));
+            }
           }
-        }
 
-        // Update cache eval value.
-        evalOld(l, j, i) = eval;
+          // Update cache eval value.
+          evalOld(l, j, i) = eval;
 
-        // Check bounding condition.
-        if (eval <= -1)
-        {
-          // update bound.
-          bp = l;
-          break;
-        }
+          // Check bounding condition.
+          if (eval <= -1)
+          {
+            // update bound.
+            bp = l;
+            break;
+          }
 
-        cost += regularization * (1 + eval);
+          cost += regularization * (1 + eval);
 
-        // Caculate gradient due to impostors.
-        arma::vec diff = dataset.col(i) - dataset.col(targetNeighbors(j, i));
-        cil += diff * arma::trans(diff);
+          // Caculate gradient due to impostors.
+          arma::vec diff = dataset.col(i) - dataset.col(targetNeighbors(j, i));
+          threadCil += diff * arma::trans(diff);
 
-        diff = dataset.col(i) - dataset.col(impostors(l, i));
-        cil -= diff * arma::trans(diff);
+          diff = dataset.col(i) - dataset.col(impostors(l, i));
+          threadCil -= diff * arma::trans(diff);
+        }
       }
     }
+
+    #pragma omp critical(LMNNGradient)
+    {
+      cij += threadCij;
+      cil += threadCil;
+    }
   }
 
   gradient = 2 * transformation * ((1 - regularization) * cij +
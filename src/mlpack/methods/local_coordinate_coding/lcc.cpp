@@ -34,32 +34,42 @@ void LocalCoordinateCoding::Encode(const arma::mat& data, arma::mat& codes)
       data.n_cols) + repmat(sum(square(data)), atoms, 1) - 2 * trans(dictionary)
       * data);
 
-  arma::mat dictGram = trans(dictionary) * dictionary;
-  arma::mat dictGramTD(dictGram.n_rows, dictGram.n_cols);
+  const arma::mat dictGram = trans(dictionary) * dictionary;
 
   codes.set_size(atoms, data.n_cols);
-  for (size_t i = 0; i < data.n_cols; i++)
+
+  // The points are encoded independently, so they are split between the
+  // threads.  Each thread reweights the shared Gram matrix of the dictionary
+  // into its own buffers for each of its points.
+  #pragma omp parallel
   {
-    // Report progress.
-    if ((i % 100) == 0)
-    {
-      Log::Debug << "Optimization at point " << i << "." << std::endl;
-    }
+    arma::mat dictPrime(dictionary.n_rows, dictionary.n_cols);
+    arma::mat dictGramTD(dictGram.n_rows, dictGram.n_cols);
 
-    arma::vec invW = invSqDists.unsafe_col(i);
-    arma::mat dictPrime = dictionary * diagmat(invW);
+    #pragma omp for schedule(dynamic, 16)
+    for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; i++)
+    {
+      // Report progress.
+      if ((i % 100) == 0)
+      {
+        #pragma omp critical(LCCEncodeLog)
+        Log::Debug << "Optimization at point " << i << "." << std::endl;
+      }
 
-    arma::mat dictGramTD = diagmat(invW) * dictGram * diagmat(invW);
+      const arma::vec invW = invSqDists.unsafe_col(i);
+      dictPrime = dictionary * diagmat(invW);
+      dictGramTD = dictGram % (invW * trans(invW));
 
-    bool useCholesky = false;
-    regression::LARS lars(useCholesky, dictGramTD, 0.5 * lambda);
+      bool useCholesky = false;
+      regression::LARS lars(useCholesky, dictGramTD, 0.5 * lambda);
 
-    // Run LARS for this point, by making an alias of the point and passing
-    // that.
-    arma::vec beta = codes.unsafe_col(i);
-    arma::rowvec responses = data.unsafe_col(i).t();
-    lars.Train(dictPrime, responses, beta, false);
-    beta %= invW; // Remember, beta is an alias of codes.col(i).
+      // Run LARS for this point, by making an alias of the point and passing
+      // that.
+      arma::vec beta = codes.unsafe_col(i);
+      arma::rowvec responses = data.unsafe_col(i).t();
+      lars.Train(dictPrime, responses, beta, false);
+      beta %= invW; // Remember, beta is an alias of codes.col(i).
+    }
   }
 }
 
@@ -142,6 +142,8 @@ PARAM_MODEL_OUT(LogisticRegression<>, "output_model", "Output for trained "
 
 // Testing.
 PARAM_MATRIX_IN("test", "Matrix containing test dataset.", "T");
+// Each test point is classified on its own, so the test set can be streamed.
+BINDING_STREAMING_INPUT("test");
 // The PARAM_UROW_OUT("output"..) is deprecated and can be removed
 // in mlpack 4.0.0
 PARAM_UROW_OUT("output", "If test data is specified, this matrix is where "
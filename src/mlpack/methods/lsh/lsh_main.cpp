@@ -91,6 +91,10 @@ PARAM_DOUBLE_IN("hash_width", "The hash width for the first-level hashing in "
     "a hash width for its use.", "H", 0.0);
 PARAM_INT_IN("num_probes", "Number of additional probes for multiprobe LSH; if "
     "0, traditional LSH is used.", "T", 0);
+PARAM_INT_IN("probe_budget", "Total number of additional probes per query for "
+    "query-directed multiprobe LSH, spread over all tables by how likely each "
+    "bin is to hold neighbors; if nonzero, " + PRINT_PARAM_STRING("num_probes")
+    + " is ignored.", "P", 0);
 PARAM_INT_IN("second_hash_size", "The size of the second level hash table.",
     "S", 99901);
 PARAM_INT_IN("bucket_size", "The size of a bucket in the second level hash.",
@@ -142,6 +146,12 @@ static void mlpackMain()
   ReportIgnoredParam({{ "reference", false }}, "bucket_size");
   ReportIgnoredParam({{ "reference", false }}, "second_hash_size");
   ReportIgnoredParam({{ "reference", false }}, "hash_width");
+  ReportIgnoredParam({{ "probe_budget", true }}, "num_probes");
+
+  RequireParamValue<int>("num_probes", [](int x) { return x >= 0; }, true,
+      "number of probes must be nonnegative");
+  RequireParamValue<int>("probe_budget", [](int x) { return x >= 0; }, true,
+      "probe budget must be nonnegative");
 
   if (CLI::HasParam("input_model") && !CLI::HasParam("k"))
   {
@@ -158,6 +168,7 @@ static void mlpackMain()
   const size_t numTables = CLI::GetParam<int>("tables");
   const double hashWidth = CLI::GetParam<double>("hash_width");
   const size_t numProbes = (size_t) CLI::GetParam<int>("num_probes");
+  const size_t probeBudget = (size_t) CLI::GetParam<int>("probe_budget");
 
   arma::Mat<size_t> neighbors;
   arma::mat distances;
@@ -197,11 +208,12 @@ static void mlpackMain()
           << CLI::GetPrintableParam<arma::mat>("query") << "." << endl;
       queryData = std::move(CLI::GetParam<arma::mat>("query"));
 
-      allkann->Search(queryData, k, neighbors, distances, 0, numProbes);
+      allkann->Search(queryData, k, neighbors, distances, 0, numProbes,
+          probeBudget);
     }
     else
     {
-      allkann->Search(k, neighbors, distances, 0, numProbes);
+      allkann->Search(k, neighbors, distances, 0, numProbes, probeBudget);
     }
 
     Log::Info << "Neighbors computed." << endl;
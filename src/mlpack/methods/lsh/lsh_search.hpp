@@ -49,10 +49,12 @@
 
 #include <mlpack/prereqs.hpp>
 
+#include <mlpack/core/math/first_touch.hpp>
 #include <mlpack/core/metrics/lmetric.hpp>
 #include <mlpack/methods/neighbor_search/sort_policies/nearest_neighbor_sort.hpp>
 
 #include <queue>
+#include <tuple>
 
 namespace mlpack {
 namespace neighbor {
@@ -216,13 +218,19 @@ class LSHSearch
    *     considered.
    * @param T The number of additional probing bins to examine with multiprobe
    *     LSH. If T = 0, classic single-probe LSH is run (default).
+   * @param probeBudget If nonzero, T is ignored and query-directed multiprobe
+   *     LSH is run instead: the probeBudget additional bins that are most
+   *     likely to hold neighbors of each query, over all tables searched, are
+   *     examined.  This usually reaches a given recall with far fewer tables
+   *     than T bins per table would need.
    */
   void Search(const MatType& querySet,
               const size_t k,
               arma::Mat<size_t>& resultingNeighbors,
               arma::mat& distances,
               const size_t numTablesToSearch = 0,
-              const size_t T = 0);
+              const size_t T = 0,
+              const size_t probeBudget = 0);
 
   /**
    * Compute the nearest neighbors and store the output in the given matrices.
@@ -242,12 +250,16 @@ class LSHSearch
    *     By default, this is set to zero in which case all tables are
    *     considered.
    * @param T Number of probing bins.
+   * @param probeBudget If nonzero, T is ignored and the probeBudget additional
+   *     bins most likely to hold neighbors of each query, over all tables
+   *     searched, are examined (query-directed multiprobe LSH).
    */
   void Search(const size_t k,
               arma::Mat<size_t>& resultingNeighbors,
               arma::mat& distances,
               const size_t numTablesToSearch = 0,
-              size_t T = 0);
+              size_t T = 0,
+              const size_t probeBudget = 0);
 
   /**
    * Compute the recall (% of neighbors found) given the neighbors returned by
@@ -290,9 +302,36 @@ class LSHSearch
   //! Get the bucket size of the second hash.
   size_t BucketSize() const { return bucketSize; }
 
-  //! Get the second hash table.
-  const std::vector<arma::Col<size_t>>& SecondHashTable() const
-      { return secondHashTable; }
+  //! Get the offset of each row of the second hash table in BucketIndices();
+  //! row r holds the points BucketIndices()[BucketOffsets()[r]] to
+  //! BucketIndices()[BucketOffsets()[r + 1] - 1].
+  const arma::Col<size_t>& BucketOffsets() const { return bucketOffsets; }
+
+  //! Get the points held in all rows of the second hash table, row after row.
+  const arma::Col<size_t>& BucketIndices() const { return bucketIndices; }
+
+  /**
+   * Get a copy of the second hash table, with one vector of points for each
+   * row.  The table is no longer stored this way, so the vectors are built
+   * from BucketOffsets() and BucketIndices() on each call.
+   *
+   * @note
+   * This method has been deprecated and will be removed in mlpack 4.0.0.  Use
+   * BucketOffsets() and BucketIndices() instead.
+   */
+  mlpack_deprecated std::vector<arma::Col<size_t>> SecondHashTable() const
+  {
+    const size_t numRows = (bucketOffsets.n_elem == 0) ? 0 :
+        bucketOffsets.n_elem - 1;
+    std::vector<arma::Col<size_t>> secondHashTable(numRows);
+    for (size_t i = 0; i < numRows; ++i)
+    {
+      secondHashTable[i] = arma::Col<size_t>(bucketIndices.memptr() +
+          bucketOffsets[i], bucketOffsets[i + 1] - bucketOffsets[i]);
+    }
+
+    return secondHashTable;
+  }
 
   //! Get the projection tables.
   const arma::cube& Projections() { return projections; }
@@ -320,12 +359,15 @@ class LSHSearch
    *    0, all tables are searched.
    * @param T The number of additional probing bins for multiprobe LSH. If 0,
    *    single-probe is used.
+   * @param probeBudget If nonzero, T is ignored, and this is the total number
+   *    of additional probing bins, chosen over all tables by their score.
    */
   template<typename VecType>
   void ReturnIndicesFromTable(const VecType& queryPoint,
                               arma::uvec& referenceIndices,
                               size_t numTablesToSearch,
-                              const size_t T) const;
+                              const size_t T,
+                              const size_t probeBudget = 0) const;
 
   /**
    * This is a helper function that computes the distance of the query to the
@@ -380,11 +422,15 @@ class LSHSearch
    * @param T number of additional probing bins.
    * @param additionalProbingBins matrix. Each column will hold one additional
    *    bin.
+   * @param additionalProbingScores vector holding the score of each additional
+   *    bin, in increasing order (a lower score means the bin is more likely to
+   *    hold neighbors of the query).
   */
   void GetAdditionalProbingBins(const arma::vec& queryCode,
                                 const arma::vec& queryCodeNotFloored,
                                 const size_t T,
-                                arma::mat& additionalProbingBins) const;
+                                arma::mat& additionalProbingBins,
+                                arma::vec& additionalProbingScores) const;
 
   /**
    * Returns the score of a perturbation vector generated by perturbation set A.
@@ -450,15 +496,16 @@ class LSHSearch
   //! The bucket size of the second hash.
   size_t bucketSize;
 
-  //! The final hash table; should be (< secondHashSize) vectors each with
-  //! (<= bucketSize) elements.
-  std::vector<arma::Col<size_t>> secondHashTable;
+  //! The final hash table is stored in compressed sparse row form, with
+  //! (< secondHashSize) rows each with (<= bucketSize) elements.  This holds
+  //! the offset of each row in bucketIndices, plus the total number of
+  //! elements at the end.
+  arma::Col<size_t> bucketOffsets;
 
-  //! The number of elements present in each hash bucket; should be
-  //! secondHashSize.
-  arma::Col<size_t> bucketContentSize;
+  //! The points in each row of the final hash table, row after row.
+  arma::Col<size_t> bucketIndices;
 
-  //! For a particular hash value, points to the row in secondHashTable
+  //! For a particular hash value, points to the row in the final hash table
   //! corresponding to this value. Length secondHashSize.
   arma::Col<size_t> bucketRowInHashTable;
 
@@ -486,7 +533,7 @@ class LSHSearch
 
 //! Set the serialization version of the LSHSearch class.
 BOOST_TEMPLATE_CLASS_VERSION(template<typename SortPolicy>,
-    mlpack::neighbor::LSHSearch<SortPolicy>, 1);
+    mlpack::neighbor::LSHSearch<SortPolicy>, 2);
 
 // Include implementation.
 #include "lsh_search_impl.hpp"
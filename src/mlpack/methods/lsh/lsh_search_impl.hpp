@@ -83,8 +83,8 @@ LSHSearch<SortPolicy, MatType>::LSHSearch(const LSHSearch& other) :
     secondHashSize(other.secondHashSize),
     secondHashWeights(other.secondHashWeights),
     bucketSize(other.bucketSize),
-    secondHashTable(other.secondHashTable),
-    bucketContentSize(other.bucketContentSize),
+    bucketOffsets(other.bucketOffsets),
+    bucketIndices(other.bucketIndices),
     bucketRowInHashTable(other.bucketRowInHashTable),
     distanceEvaluations(other.distanceEvaluations)
 {
@@ -103,8 +103,8 @@ LSHSearch<SortPolicy, MatType>::LSHSearch(LSHSearch&& other) :
     secondHashSize(other.secondHashSize),
     secondHashWeights(std::move(other.secondHashWeights)),
     bucketSize(other.bucketSize),
-    secondHashTable(std::move(other.secondHashTable)),
-    bucketContentSize(std::move(other.bucketContentSize)),
+    bucketOffsets(std::move(other.bucketOffsets)),
+    bucketIndices(std::move(other.bucketIndices)),
     bucketRowInHashTable(std::move(other.bucketRowInHashTable)),
     distanceEvaluations(other.distanceEvaluations)
 {
@@ -131,8 +131,8 @@ LSHSearch<SortPolicy, MatType>& LSHSearch<SortPolicy, MatType>::operator=(
   secondHashSize = other.secondHashSize;
   secondHashWeights = other.secondHashWeights;
   bucketSize = other.bucketSize;
-  secondHashTable = other.secondHashTable;
-  bucketContentSize = other.bucketContentSize;
+  bucketOffsets = other.bucketOffsets;
+  bucketIndices = other.bucketIndices;
   bucketRowInHashTable = other.bucketRowInHashTable;
   distanceEvaluations = other.distanceEvaluations;
 
@@ -153,8 +153,8 @@ LSHSearch<SortPolicy, MatType>& LSHSearch<SortPolicy, MatType>::operator=(
   secondHashSize = other.secondHashSize;
   secondHashWeights = std::move(other.secondHashWeights);
   bucketSize = other.bucketSize;
-  secondHashTable = std::move(other.secondHashTable);
-  bucketContentSize = std::move(other.bucketContentSize);
+  bucketOffsets = std::move(other.bucketOffsets);
+  bucketIndices = std::move(other.bucketIndices);
   bucketRowInHashTable = std::move(other.bucketRowInHashTable);
   distanceEvaluations = other.distanceEvaluations;
 
@@ -179,8 +179,11 @@ void LSHSearch<SortPolicy, MatType>::Train(MatType referenceSet,
                                            const size_t bucketSize,
                                            const arma::cube& projection)
 {
-  // Set new reference set.
+  // Set new reference set.  The candidates of the queries are read from it
+  // at random by every thread, so spread it over the NUMA nodes of the
+  // threads.
   this->referenceSet = std::move(referenceSet);
+  math::FirstTouch(this->referenceSet);
 
   // Set new parameters.
   this->numProj = numProj;
@@ -258,7 +261,10 @@ void LSHSearch<SortPolicy, MatType>::Train(MatType referenceSet,
   // size_t, otherwise negative numbers are cast to 0.
   arma::Mat<size_t> secondHashVectors(numTables, this->referenceSet.n_cols);
 
-  for (size_t i = 0; i < numTables; i++)
+  // Each table is hashed independently, so the tables can be built in
+  // parallel.
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) numTables; i++)
   {
     // Step IV: create the 'numProj'-dimensional key for each point in each
     // table.
@@ -277,7 +283,7 @@ void LSHSearch<SortPolicy, MatType>::Train(MatType referenceSet,
     hashMat += offsetMat;
     hashMat /= hashWidth;
 
-    // Step V: Putting the points in the 'secondHashTable' by hashing the key.
+    // Step V: Putting the points in the second hash table by hashing the key.
     // Now we hash every key, point ID to its corresponding bucket.  We must
     // also normalize the hashes to the range [0, secondHashSize).
     arma::rowvec unmodVector = secondHashWeights.t() * arma::floor(hashMat);
@@ -310,36 +316,45 @@ void LSHSearch<SortPolicy, MatType>::Train(MatType referenceSet,
       { return std::min(val, effectiveBucketSize); });
 
   const size_t numRowsInTable = arma::accu(secondHashBinCounts > 0);
-  bucketContentSize.zeros(numRowsInTable);
-  secondHashTable.resize(numRowsInTable);
 
-  // Next we must assign each point in each table to the right second hash
-  // table.
+  // The second hash table is stored in compressed sparse row form: the points
+  // in row r are bucketIndices[bucketOffsets[r]] to
+  // bucketIndices[bucketOffsets[r + 1] - 1].  A row is created for each bucket
+  // the first time a point is hashed into it, scanning the tables in order.
+  arma::Col<size_t> rowSizes(numRowsInTable);
   size_t currentRow = 0;
   for (size_t i = 0; i < numTables; ++i)
   {
-    // Insert the point in the corresponding row to its bucket in the
-    // 'secondHashTable'.
-    for (size_t j = 0; j < secondHashVectors.n_cols; j++)
+    for (size_t j = 0; j < secondHashVectors.n_cols; ++j)
     {
-      // This is the bucket number.
-      size_t hashInd = (size_t) secondHashVectors(i, j);
-      // The point ID is 'j'.
-
-      // If this is currently an empty bucket, start a new row keep track of
-      // which row corresponds to the bucket.
-      const size_t maxSize = secondHashBinCounts[hashInd];
+      const size_t hashInd = secondHashVectors(i, j);
       if (bucketRowInHashTable[hashInd] == secondHashSize)
       {
         bucketRowInHashTable[hashInd] = currentRow;
-        secondHashTable[currentRow].set_size(maxSize);
-        currentRow++;
+        rowSizes[currentRow++] = secondHashBinCounts[hashInd];
       }
+    }
+  }
 
-      // If this vector in the hash table is not full, add the point.
-      const size_t index = bucketRowInHashTable[hashInd];
-      if (bucketContentSize[index] < maxSize)
-        secondHashTable[index](bucketContentSize[index]++) = j;
+  bucketOffsets.set_size(numRowsInTable + 1);
+  bucketOffsets[0] = 0;
+  for (size_t r = 0; r < numRowsInTable; ++r)
+    bucketOffsets[r + 1] = bucketOffsets[r] + rowSizes[r];
+  bucketIndices.set_size(bucketOffsets[numRowsInTable]);
+
+  // Next we must assign each point in each table to the right row of the
+  // second hash table.
+  arma::Col<size_t> rowFill(numRowsInTable, arma::fill::zeros);
+  for (size_t i = 0; i < numTables; ++i)
+  {
+    for (size_t j = 0; j < secondHashVectors.n_cols; j++)
+    {
+      // This is the bucket number.  The point ID is 'j'.
+      const size_t row = bucketRowInHashTable[secondHashVectors(i, j)];
+
+      // If this row of the hash table is not full, add the point.
+      if (rowFill[row] < rowSizes[row])
+        bucketIndices[bucketOffsets[row] + rowFill[row]++] = j;
     } // Loop over all points in the reference set.
   } // Loop over tables.
 
@@ -525,7 +540,8 @@ void LSHSearch<SortPolicy, MatType>::GetAdditionalProbingBins(
     const arma::vec& queryCode,
     const arma::vec& queryCodeNotFloored,
     const size_t T,
-    arma::mat& additionalProbingBins) const
+    arma::mat& additionalProbingBins,
+    arma::vec& additionalProbingScores) const
 {
   // No additional bins requested. Our work is done.
   if (T == 0)
@@ -533,6 +549,7 @@ void LSHSearch<SortPolicy, MatType>::GetAdditionalProbingBins(
 
   // Each column of additionalProbingBins is the code of a bin.
   additionalProbingBins.set_size(numProj, T);
+  additionalProbingScores.set_size(T);
 
   // Copy the query's code, then in the end we will  add/subtract according
   // to perturbations we calculated.
@@ -588,6 +605,7 @@ void LSHSearch<SortPolicy, MatType>::GetAdditionalProbingBins(
 
     // Add or subtract 1 to dimension corresponding to minimum score.
     additionalProbingBins(positions[minloc], 0) += actions[minloc];
+    additionalProbingScores[0] = minscore;
     if (T == 1)
       return; // Done if asked for only 1 code.
 
@@ -613,6 +631,7 @@ void LSHSearch<SortPolicy, MatType>::GetAdditionalProbingBins(
 
     // Add or subtract 1 to create second-lowest scoring vector.
     additionalProbingBins(positions[minloc2], 1) += actions[minloc2];
+    additionalProbingScores[1] = minscore2;
     return;
   }
 
@@ -666,6 +685,7 @@ void LSHSearch<SortPolicy, MatType>::GetAdditionalProbingBins(
     {
       // Get the perturbation set corresponding to the minimum score.
       Ai = perturbationSets[ minHeap.top().second ];
+      additionalProbingScores[pvec] = minHeap.top().first;
       minHeap.pop(); // .top() returns, .pop() removes
 
       // Shift operation on Ai (replace max with max+1).
@@ -708,7 +728,8 @@ void LSHSearch<SortPolicy, MatType>::ReturnIndicesFromTable(
     const VecType& queryPoint,
     arma::uvec& referenceIndices,
     size_t numTablesToSearch,
-    const size_t T) const
+    const size_t T,
+    const size_t probeBudget) const
 {
   // Decide on the number of tables to look into.
   if (numTablesToSearch == 0) // If no user input is given, search all.
@@ -733,52 +754,90 @@ void LSHSearch<SortPolicy, MatType>::ReturnIndicesFromTable(
   queryCodesNotFloored += offsets.cols(0, numTablesToSearch - 1);
   allProjInTables = arma::floor(queryCodesNotFloored / hashWidth);
 
-  // Use hashMat to store the primary probing codes and any additional codes
-  // from multiprobe LSH.
-  arma::Mat<size_t> hashMat;
-  hashMat.set_size(T + 1, numTablesToSearch);
-
   // Compute the primary hash value of each key of the query into a bucket of
-  // the secondHashTable using the secondHashWeights.
-  hashMat.row(0) = arma::conv_to<arma::Row<size_t>> // Floor by typecasting
-      ::from(secondHashWeights.t() * allProjInTables);
-  // Mod to compute 2nd-level codes.
-  for (size_t i = 0; i < numTablesToSearch; i++)
-    hashMat(0, i) = (hashMat(0, i) % secondHashSize);
+  // the second hash table using the secondHashWeights.
+  const arma::Row<size_t> primaryCodes = arma::conv_to<arma::Row<size_t>>
+      ::from(secondHashWeights.t() * allProjInTables); // Floor by typecasting.
+
+  // The number of additional probing bins to look into in each table, and the
+  // bins themselves.
+  arma::Col<size_t> numProbes(numTablesToSearch, arma::fill::zeros);
+  std::vector<arma::mat> additionalProbingBins(numTablesToSearch);
+
+  if (probeBudget > 0)
+  {
+    // Query-directed multiprobe: the bins to look into are the probeBudget
+    // lowest-scoring bins over all tables.  The probing sequence of each table
+    // is sorted by score, so no table needs more than probeBudget bins, and
+    // the selected bins of each table form a prefix of its sequence.
+    const size_t maxT = std::min(probeBudget,
+        (size_t) ((1 << numProj) - 1));
+    std::vector<std::tuple<double, size_t, size_t>> candidateBins;
+    candidateBins.reserve(maxT * numTablesToSearch);
+    for (size_t i = 0; i < numTablesToSearch; ++i)
+    {
+      arma::vec additionalProbingScores;
+      GetAdditionalProbingBins(allProjInTables.unsafe_col(i),
+                               queryCodesNotFloored.unsafe_col(i),
+                               maxT,
+                               additionalProbingBins[i],
+                               additionalProbingScores);
+      for (size_t p = 0; p < maxT; ++p)
+      {
+        candidateBins.push_back(std::make_tuple(additionalProbingScores[p], i,
+            p));
+      }
+    }
 
-  // Compute hash codes of additional probing bins.
-  if (T > 0)
+    const size_t numSelected = std::min(probeBudget, candidateBins.size());
+    std::partial_sort(candidateBins.begin(),
+        candidateBins.begin() + numSelected, candidateBins.end());
+    for (size_t c = 0; c < numSelected; ++c)
+      ++numProbes[std::get<1>(candidateBins[c])];
+  }
+  else if (T > 0)
   {
     for (size_t i = 0; i < numTablesToSearch; ++i)
     {
       // Construct this table's probing sequence of length T.
-      arma::mat additionalProbingBins;
+      arma::vec additionalProbingScores;
       GetAdditionalProbingBins(allProjInTables.unsafe_col(i),
-                                queryCodesNotFloored.unsafe_col(i),
-                                T,
-                                additionalProbingBins);
-
-      // Map each probing bin to a bin in secondHashTable (just like we did for
-      // the primary hash table).
-      hashMat(arma::span(1, T), i) = // Compute code of rows 1:end of column i
-        arma::conv_to< arma::Col<size_t> >:: // floor by typecasting to size_t
-        from(secondHashWeights.t() * additionalProbingBins);
-      for (size_t p = 1; p < T + 1; ++p)
-        hashMat(p, i) = (hashMat(p, i) % secondHashSize);
+                               queryCodesNotFloored.unsafe_col(i),
+                               T,
+                               additionalProbingBins[i],
+                               additionalProbingScores);
+      numProbes[i] = T;
     }
   }
 
+  // Use probeCodes to store the 2nd-level codes of the primary bins and of any
+  // additional bins from multiprobe LSH.
+  arma::Col<size_t> probeCodes(numTablesToSearch + arma::accu(numProbes));
+  size_t numCodes = 0;
+  for (size_t i = 0; i < numTablesToSearch; ++i)
+  {
+    // Mod to compute 2nd-level codes.
+    probeCodes[numCodes++] = (primaryCodes[i] % secondHashSize);
+    if (numProbes[i] == 0)
+      continue;
+
+    // Map each probing bin to a bin in the second hash table (just like we did
+    // for the primary hash table).
+    const arma::Col<size_t> codes = arma::conv_to<arma::Col<size_t>>::from(
+        secondHashWeights.t() * // Floor by typecasting to size_t.
+        additionalProbingBins[i].cols(0, numProbes[i] - 1));
+    for (size_t p = 0; p < numProbes[i]; ++p)
+      probeCodes[numCodes++] = (codes[p] % secondHashSize);
+  }
+
   // Count number of points hashed in the same bucket as the query.
   size_t maxNumPoints = 0;
-  for (size_t i = 0; i < numTablesToSearch; ++i)
+  for (size_t p = 0; p < probeCodes.n_elem; ++p)
   {
-    for (size_t p = 0; p < T + 1; ++p)
-    {
-      const size_t hashInd = hashMat(p, i); // find query's bucket
-      const size_t tableRow = bucketRowInHashTable[hashInd];
-      if (tableRow < secondHashSize)
-        maxNumPoints += bucketContentSize[tableRow]; // count bucket contents
-    }
+    const size_t hashInd = probeCodes[p]; // find query's bucket
+    const size_t tableRow = bucketRowInHashTable[hashInd];
+    if (tableRow < secondHashSize) // count bucket contents
+      maxNumPoints += bucketOffsets[tableRow + 1] - bucketOffsets[tableRow];
   }
 
   // There are two ways to proceed here:
@@ -800,20 +859,18 @@ void LSHSearch<SortPolicy, MatType>::ReturnIndicesFromTable(
     arma::Col<size_t> refPointsConsidered;
     refPointsConsidered.zeros(referenceSet.n_cols);
 
-    for (size_t i = 0; i < numTablesToSearch; ++i) // for all tables
+    for (size_t p = 0; p < probeCodes.n_elem; ++p) // For all probed bins.
     {
-      for (size_t p = 0; p < T + 1; ++p) // For entire probing sequence.
-      {
-        // get the sequence code
-        size_t hashInd = hashMat(p, i);
-        size_t tableRow = bucketRowInHashTable[hashInd];
+      // get the sequence code
+      size_t hashInd = probeCodes[p];
+      size_t tableRow = bucketRowInHashTable[hashInd];
 
-        if (tableRow < secondHashSize && bucketContentSize[tableRow] > 0)
-        {
-          // Pick the indices in the bucket corresponding to hashInd.
-          for (size_t j = 0; j < bucketContentSize[tableRow]; ++j)
-            refPointsConsidered[ secondHashTable[tableRow](j) ]++;
-        }
+      if (tableRow < secondHashSize)
+      {
+        // Pick the indices in the bucket corresponding to hashInd.
+        for (size_t j = bucketOffsets[tableRow];
+             j < bucketOffsets[tableRow + 1]; ++j)
+          refPointsConsidered[ bucketIndices[j] ]++;
       }
     }
 
@@ -832,19 +889,17 @@ void LSHSearch<SortPolicy, MatType>::ReturnIndicesFromTable(
     // Retrieve candidates.
     size_t start = 0;
 
-    for (size_t i = 0; i < numTablesToSearch; ++i) // For all tables
+    for (size_t p = 0; p < probeCodes.n_elem; ++p) // For all probed bins.
     {
-      for (size_t p = 0; p < T + 1; ++p)
-      {
-        const size_t hashInd =  hashMat(p, i); // Find the query's bucket.
-        const size_t tableRow = bucketRowInHashTable[hashInd];
+      const size_t hashInd = probeCodes[p]; // Find the query's bucket.
+      const size_t tableRow = bucketRowInHashTable[hashInd];
 
-        if (tableRow < secondHashSize)
-        {
-          // Store all secondHashTable points in the candidates set.
-          for (size_t j = 0; j < bucketContentSize[tableRow]; ++j)
-            refPointsConsideredSmall(start++) = secondHashTable[tableRow](j);
-       }
+      if (tableRow < secondHashSize)
+      {
+        // Store all the points of the bucket in the candidates set.
+        for (size_t j = bucketOffsets[tableRow];
+             j < bucketOffsets[tableRow + 1]; ++j)
+          refPointsConsideredSmall(start++) = bucketIndices[j];
       }
     }
 
@@ -862,7 +917,8 @@ void LSHSearch<SortPolicy, MatType>::Search(
     arma::Mat<size_t>& resultingNeighbors,
     arma::mat& distances,
     const size_t numTablesToSearch,
-    const size_t T)
+    const size_t T,
+    const size_t probeBudget)
 {
   // Ensure the dimensionality of the query set is correct.
   if (querySet.n_rows != referenceSet.n_rows)
@@ -903,7 +959,10 @@ void LSHSearch<SortPolicy, MatType>::Search(
   }
 
   // If the user set multiprobe, log it
-  if (Teffective > 0)
+  if (probeBudget > 0)
+    Log::Info << "Running query-directed multiprobe LSH with " << probeBudget
+        << " additional probing bins per query." << std::endl;
+  else if (Teffective > 0)
     Log::Info << "Running multiprobe LSH with " << Teffective
         <<" additional probing bins per table per query." << std::endl;
 
@@ -920,10 +979,10 @@ void LSHSearch<SortPolicy, MatType>::Search(
   {
     // Go through every query point.
     // Hash every query into every hash table and eventually into the
-    // 'secondHashTable' to obtain the neighbor candidates.
+    // second hash table to obtain the neighbor candidates.
     arma::uvec refIndices;
     ReturnIndicesFromTable(querySet.col(i), refIndices, numTablesToSearch,
-        Teffective);
+        Teffective, probeBudget);
 
     // An informative book-keeping for the number of neighbor candidates
     // returned on average.
@@ -951,7 +1010,8 @@ Search(const size_t k,
        arma::Mat<size_t>& resultingNeighbors,
        arma::mat& distances,
        const size_t numTablesToSearch,
-       size_t T)
+       size_t T,
+       const size_t probeBudget)
 {
   // This is monochromatic search; the query set is the reference set.
   resultingNeighbors.set_size(k, referenceSet.n_cols);
@@ -969,7 +1029,10 @@ Search(const size_t k,
   }
 
   // If the user set multiprobe, log it
-  if (T > 0)
+  if (probeBudget > 0)
+    Log::Info << "Running query-directed multiprobe LSH with " << probeBudget
+        << " additional probing bins per query." << std::endl;
+  else if (T > 0)
     Log::Info << "Running multiprobe LSH with " << Teffective <<
       " additional probing bins per table per query."<< std::endl;
 
@@ -986,10 +1049,10 @@ Search(const size_t k,
   {
     // Go through every query point.
     // Hash every query into every hash table and eventually into the
-    // 'secondHashTable' to obtain the neighbor candidates.
+    // second hash table to obtain the neighbor candidates.
     arma::uvec refIndices;
     ReturnIndicesFromTable(referenceSet.col(i), refIndices, numTablesToSearch,
-        Teffective);
+        Teffective, probeBudget);
 
     // An informative book-keeping for the number of neighbor candidates
     // returned on average.
@@ -1071,7 +1134,22 @@ void LSHSearch<SortPolicy, MatType>::serialize(Archive& ar,
   ar & BOOST_SERIALIZATION_NVP(secondHashSize);
   ar & BOOST_SERIALIZATION_NVP(secondHashWeights);
   ar & BOOST_SERIALIZATION_NVP(bucketSize);
-  // needs specific handling for new version
+
+  // Since version 2, the second hash table is stored in compressed sparse row
+  // form.
+  if (version >= 2)
+  {
+    ar & BOOST_SERIALIZATION_NVP(bucketOffsets);
+    ar & BOOST_SERIALIZATION_NVP(bucketIndices);
+    ar & BOOST_SERIALIZATION_NVP(bucketRowInHashTable);
+    ar & BOOST_SERIALIZATION_NVP(distanceEvaluations);
+    return;
+  }
+
+  // Older versions stored one vector per row of the second hash table, and the
+  // number of points in each row separately.
+  std::vector<arma::Col<size_t>> secondHashTable;
+  arma::Col<size_t> bucketContentSize;
 
   // Backward compatibility: in older versions of LSHSearch, the secondHashTable
   // was stored as an arma::Mat<size_t>.  So we need to properly load that, then
@@ -1104,17 +1182,10 @@ void LSHSearch<SortPolicy, MatType>::serialize(Archive& ar,
   }
   else
   {
+    // This is only reached when loading.
     size_t tables;
-    if (Archive::is_saving::value)
-      tables = secondHashTable.size();
     ar & BOOST_SERIALIZATION_NVP(tables);
-
-    // Set size of second hash table if needed.
-    if (Archive::is_loading::value)
-    {
-      secondHashTable.clear();
-      secondHashTable.resize(tables);
-    }
+    secondHashTable.resize(tables);
 
     ar & BOOST_SERIALIZATION_NVP(secondHashTable);
   }
@@ -1143,6 +1214,22 @@ void LSHSearch<SortPolicy, MatType>::serialize(Archive& ar,
     ar & BOOST_SERIALIZATION_NVP(bucketRowInHashTable);
   }
 
+  // Convert the old representation to compressed sparse row form.
+  bucketOffsets.set_size(secondHashTable.size() + 1);
+  bucketOffsets[0] = 0;
+  for (size_t i = 0; i < secondHashTable.size(); ++i)
+  {
+    bucketOffsets[i + 1] = bucketOffsets[i] + std::min(
+        (size_t) bucketContentSize[i], (size_t) secondHashTable[i].n_elem);
+  }
+
+  bucketIndices.set_size(bucketOffsets[secondHashTable.size()]);
+  for (size_t i = 0; i < secondHashTable.size(); ++i)
+  {
+    for (size_t j = bucketOffsets[i]; j < bucketOffsets[i + 1]; ++j)
+      bucketIndices[j] = secondHashTable[i][j - bucketOffsets[i]];
+  }
+
   ar & BOOST_SERIALIZATION_NVP(distanceEvaluations);
 }
 
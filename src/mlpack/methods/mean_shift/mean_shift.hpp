@@ -156,6 +156,20 @@ class MeanShift
                     const std::vector<double>&, /*unused*/
                     arma::colvec& centroid);
 
+  /**
+   * Add the converged centroids to the given centroids, in order, unless they
+   * are closer than the radius to a centroid that is already there.  The
+   * centroids are hashed into bins of side length radius, so that only the
+   * centroids in the neighboring bins have to be checked.
+   *
+   * @param allCentroids Centroids of the seeds.
+   * @param converged Whether each centroid has converged.
+   * @param centroids Matrix of centroids to add to.
+   */
+  void MergeCentroids(const arma::mat& allCentroids,
+                      const std::vector<char>& converged,
+                      arma::mat& centroids);
+
   /**
    * If distance of two centroids is less than radius, one will be removed.
    * Points with distance to current centroid less than radius will be used
@@ -176,6 +176,88 @@ CalculateCentroid(const MatType& data,
   return true;
 }
 
+// Merge the converged centroids that are closer than the radius.
+template<bool UseKernel, typename KernelType, typename MatType>
+void MeanShift<UseKernel, KernelType, MatType>::MergeCentroids(
+    const arma::mat& allCentroids,
+    const std::vector<char>& converged,
+    arma::mat& centroids)
+{
+  // The centroids kept so far are hashed into hypercube bins of side length
+  // radius, so that the centroids closer than the radius to a new one can only
+  // be in the neighboring bins.  There are 3^d such bins, so when there are
+  // more of them than the centroids kept so far, they are scanned instead.
+  typedef arma::colvec VecType;
+  std::map<VecType, std::vector<size_t>, less<VecType> > bins;
+  const size_t dimensionality = allCentroids.n_rows;
+  const bool useBins = (dimensionality <= 20);
+
+  for (size_t k = 0; k < centroids.n_cols; ++k)
+    bins[arma::floor(centroids.col(k) / radius)].push_back(k);
+
+  for (size_t i = 0; i < allCentroids.n_cols; ++i)
+  {
+    if (!converged[i])
+      continue;
+
+    const VecType bin = arma::floor(allCentroids.col(i) / radius);
+
+    // Determine if the new centroid is duplicate with old ones.
+    bool isDuplicated = false;
+    if (useBins && std::pow(3.0, (double) dimensionality) <= centroids.n_cols)
+    {
+      // Visit every neighboring bin, with offsets in {-1, 0, 1}.
+      arma::Col<int> offsets(dimensionality);
+      offsets.fill(-1);
+      while (!isDuplicated)
+      {
+        typename std::map<VecType, std::vector<size_t>,
+            less<VecType> >::const_iterator it = bins.find(bin +
+            arma::conv_to<VecType>::from(offsets));
+        if (it != bins.end())
+        {
+          for (size_t j = 0; j < it->second.size(); ++j)
+          {
+            if (metric::EuclideanDistance::Evaluate(allCentroids.col(i),
+                centroids.col(it->second[j])) < radius)
+            {
+              isDuplicated = true;
+              break;
+            }
+          }
+        }
+
+        // Go to the next offset.
+        size_t d = 0;
+        while (d < dimensionality && offsets[d] == 1)
+          offsets[d++] = -1;
+        if (d == dimensionality)
+          break;
+        ++offsets[d];
+      }
+    }
+    else
+    {
+      for (size_t k = 0; k < centroids.n_cols; ++k)
+      {
+        const double distance = metric::EuclideanDistance::Evaluate(
+            allCentroids.unsafe_col(i), centroids.unsafe_col(k));
+        if (distance < radius)
+        {
+          isDuplicated = true;
+          break;
+        }
+      }
+    }
+
+    if (!isDuplicated)
+    {
+      bins[bin].push_back(centroids.n_cols);
+      centroids.insert_cols(centroids.n_cols, allCentroids.unsafe_col(i));
+    }
+  }
+}
+
 /**
  * Perform Mean Shift clustering on the data set, returning a list of cluster
  * assignments and centroids.
@@ -204,63 +286,73 @@ inline void MeanShift<UseKernel, KernelType, MatType>::Cluster(
 
   // Holds all centroids before removing duplicate ones.
   arma::mat allCentroids(pSeeds->n_rows, pSeeds->n_cols);
+  // Whether each centroid has converged.
+  std::vector<char> converged(pSeeds->n_cols, 0);
 
   assignments.set_size(data.n_cols);
 
-  range::RangeSearch<> rangeSearcher(data);
-  math::Range validRadius(0, radius);
-  std::vector<std::vector<size_t> > neighbors;
-  std::vector<std::vector<double> > distances;
+  // The reference tree is built once and shared (read-only) by the threads,
+  // which shift their own seeds with single-tree range searches.
+  typedef range::RangeSearch<>::Tree Tree;
+  typedef range::RangeSearchRules<metric::EuclideanDistance, Tree> RuleType;
+  Tree referenceTree(data);
+  const math::Range validRadius(0, radius);
 
   // For each seed, perform mean shift algorithm.
-  for (size_t i = 0; i < pSeeds->n_cols; ++i)
+  #pragma omp parallel
   {
-    // Initial centroid is the seed itself.
-    allCentroids.col(i) = pSeeds->unsafe_col(i);
-    for (size_t completedIterations = 0; completedIterations < maxIterations
-        || forceConvergence; completedIterations++)
-    {
-      // Store new centroid in this.
-      arma::colvec newCentroid = arma::zeros<arma::colvec>(pSeeds->n_rows);
-
-      rangeSearcher.Search(allCentroids.unsafe_col(i), validRadius,
-          neighbors, distances);
-      if (neighbors[0].size() == 0) // There are no points in the cluster.
-        break;
+    metric::EuclideanDistance metric;
+    std::vector<std::vector<size_t> > neighbors;
+    std::vector<std::vector<double> > distances;
 
-      // Calculate new centroid.
-      if (!CalculateCentroid(data, neighbors[0], distances[0], newCentroid))
-        newCentroid = allCentroids.unsafe_col(i);
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t i = 0; i < (omp_size_t) pSeeds->n_cols; ++i)
+    {
+      // Initial centroid is the seed itself.
+      allCentroids.col(i) = pSeeds->unsafe_col(i);
+      const arma::mat centroid(allCentroids.colptr(i), allCentroids.n_rows, 1,
+          false, true);
 
-      // If the mean shift vector is small enough, it has converged.
-      if (metric::EuclideanDistance::Evaluate(newCentroid,
-          allCentroids.unsafe_col(i)) < 1e-3 * radius)
+      for (size_t completedIterations = 0; completedIterations < maxIterations
+          || forceConvergence; completedIterations++)
       {
-        // Determine if the new centroid is duplicate with old ones.
-        bool isDuplicated = false;
-        for (size_t k = 0; k < centroids.n_cols; ++k)
+        // Store new centroid in this.
+        arma::colvec newCentroid = arma::zeros<arma::colvec>(pSeeds->n_rows);
+
+        neighbors.assign(1, std::vector<size_t>());
+        distances.assign(1, std::vector<double>());
+        RuleType rules(referenceTree.Dataset(), centroid, validRadius,
+            neighbors, distances, metric);
+        typename Tree::template SingleTreeTraverser<RuleType>
+            traverser(rules);
+        traverser.Traverse(0, referenceTree);
+
+        if (neighbors[0].size() == 0) // There are no points in the cluster.
+          break;
+
+        // Calculate new centroid.  The neighbors are indices into the dataset
+        // of the tree, which may be rearranged.
+        if (!CalculateCentroid(referenceTree.Dataset(), neighbors[0],
+            distances[0], newCentroid))
+          newCentroid = allCentroids.unsafe_col(i);
+
+        // If the mean shift vector is small enough, it has converged.
+        if (metric::EuclideanDistance::Evaluate(newCentroid,
+            allCentroids.unsafe_col(i)) < 1e-3 * radius)
         {
-          const double distance = metric::EuclideanDistance::Evaluate(
-              allCentroids.unsafe_col(i), centroids.unsafe_col(k));
-          if (distance < radius)
-          {
-            isDuplicated = true;
-            break;
-          }
+          converged[i] = 1;
+          break;
         }
 
-        if (!isDuplicated)
-          centroids.insert_cols(centroids.n_cols, allCentroids.unsafe_col(i));
-
-        // Get out of the loop.
-        break;
+        // Update the centroid.
+        allCentroids.col(i) = newCentroid;
       }
-
-      // Update the centroid.
-      allCentroids.col(i) = newCentroid;
     }
   }
 
+  // Merge the converged centroids, in the order of the seeds.
+  MergeCentroids(allCentroids, converged, centroids);
+
   // If no centroid has converged due to too little iterations and without
   // forcing convergence, take 1 random centroid calculated.
   if (centroids.empty())
@@ -4,8 +4,6 @@
  *
  * Implementation of the MVU class and its auxiliary objective function class.
  *
- * Note: this implementation of MVU does not work.  See #189.
- *
  * mlpack is free software; you may redistribute it and/or modify it under the
  * terms of the 3-clause BSD license.  You should have received a copy of the
  * 3-clause BSD license along with mlpack.  If not, see
@@ -13,98 +11,216 @@
  */
 #include "mvu.hpp"
 
-#include <mlpack/core/optimizers/sdp/lrsdp.hpp>
+#include <ensmallen.hpp>
 
 #include <mlpack/methods/neighbor_search/neighbor_search.hpp>
+#include <mlpack/methods/nn_descent/nn_descent.hpp>
 
 using namespace mlpack;
 using namespace mlpack::mvu;
-using namespace mlpack::optimization;
-
-MVU::MVU(const arma::mat& data) : data(data)
+using namespace mlpack::neighbor;
+
+MVU::MVU(const arma::mat& data,
+         const bool approximate,
+         const size_t numLandmarks) :
+    data(data),
+    approximate(approximate),
+    numLandmarks(numLandmarks)
 {
   // Nothing to do.
 }
 
-void MVU::Unfold(const size_t newDim,
-                 const size_t numNeighbors,
-                 arma::mat& outputData)
+void MVU::NeighborPairs(const size_t numNeighbors,
+                        arma::umat& pairs,
+                        arma::vec& squaredDistances) const
 {
-  // First we have to choose the output point.  We'll take a linear projection
-  // of the data for now (this is probably not a good final solution).
-//  outputData = trans(data.rows(0, newDim - 1));
-  // Following Nick's idea.
-  outputData.randu(data.n_cols, newDim);
-
-  // The number of constraints is the number of nearest neighbors plus one.
-  LRSDP<arma::sp_mat> mvuSolver(numNeighbors * data.n_cols + 1, outputData);
-
-  // Set up the objective.  Because we are maximizing the trace of (R R^T),
-  // we'll instead state it as min(-I_n * (R R^T)), meaning C() is -I_n.
-  mvuSolver.C().eye(data.n_cols, data.n_cols);
-  mvuSolver.C() *= -1;
-
-  // Now set up each of the constraints.
-  // The first constraint is trace(ones * R * R^T) = 0.
-  mvuSolver.B()[0] = 0;
-  mvuSolver.A()[0].ones(data.n_cols, data.n_cols);
-
-  // All of our other constraints will be sparse except the first.  So set that
-  // vector of modes accordingly.
-  mvuSolver.AModes().ones();
-  mvuSolver.AModes()[0] = 0;
-
-  // Now all of the other constraints.  We first have to run KNN to get the
-  // list of nearest neighbors.
   arma::Mat<size_t> neighbors;
   arma::mat distances;
+  if (approximate)
+  {
+    NNDescent<> nnDescent(data);
+    nnDescent.Search(numNeighbors, neighbors, distances);
+  }
+  else
+  {
+    KNN knn(data);
+    knn.Search(numNeighbors, neighbors, distances);
+  }
 
-  KNN knn(data);
-  knn.Search(numNeighbors, neighbors, distances);
-
-  // Add each of the other constraints.  They are sparse constraints:
-  //   Tr(A_ij K) = d_ij;
-  //   A_ij = zeros except for 1 at (i, i), (j, j); -1 at (i, j), (j, i).
+  // If j is a neighbor of i and i is a neighbor of j, the two constraints are
+  // the same, so we keep each pair once.
+  std::vector<std::pair<size_t, size_t>> edges;
+  edges.reserve(neighbors.n_elem);
   for (size_t i = 0; i < neighbors.n_cols; ++i)
   {
-    for (size_t j = 0; j < numNeighbors; ++j)
+    for (size_t j = 0; j < neighbors.n_rows; ++j)
+    {
+      const size_t n = neighbors(j, i);
+      edges.push_back(std::make_pair(std::min(i, n), std::max(i, n)));
+    }
+  }
+
+  std::sort(edges.begin(), edges.end());
+  edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+  pairs.set_size(2, edges.size());
+  squaredDistances.set_size(edges.size());
+  for (size_t e = 0; e < edges.size(); ++e)
+  {
+    pairs(0, e) = edges[e].first;
+    pairs(1, e) = edges[e].second;
+    squaredDistances[e] = arma::accu(arma::square(
+        data.col(edges[e].first) - data.col(edges[e].second)));
+  }
+}
+
+void MVU::LandmarkWeights(const arma::uvec& landmarks,
+                          const size_t numNeighbors,
+                          arma::sp_mat& weights) const
+{
+  const size_t k = std::min(numNeighbors, (size_t) landmarks.n_elem);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  arma::mat landmarkPoints = data.cols(landmarks);
+  KNN knn(std::move(landmarkPoints));
+  knn.Search(data, k, neighbors, distances);
+
+  // Each point is reconstructed from its k nearest landmarks with the weights
+  // of locally linear embedding: the weights sum to one and minimize the
+  // reconstruction error, with a small regularization.  The landmarks are
+  // their own reconstruction.
+  arma::umat locations(2, k * data.n_cols);
+  arma::vec values(k * data.n_cols, arma::fill::zeros);
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+  {
+    arma::vec w(k, arma::fill::zeros);
+    if (distances(0, i) == 0.0)
     {
-      // This is the index of the constraint.
-      const size_t index = (i * numNeighbors) + j + 1;
+      w[0] = 1.0;
+    }
+    else
+    {
+      arma::uvec nearest(k);
+      for (size_t j = 0; j < k; ++j)
+        nearest[j] = landmarks[neighbors(j, i)];
 
-      arma::mat& aRef = mvuSolver.A()[index];
+      arma::mat z = data.cols(nearest);
+      z.each_col() -= data.col(i);
 
-      aRef.set_size(3, 4);
+      arma::mat gram = z.t() * z;
+      const double trace = arma::trace(gram);
+      gram.diag() += (trace > 0.0) ? 1e-3 * trace : 1e-3;
 
-      // A_ij(i, i) = 1.
-      aRef(0, 0) = i;
-      aRef(1, 0) = i;
-      aRef(2, 0) = 1;
+      w = arma::solve(gram, arma::ones<arma::vec>(k));
+      w /= arma::accu(w);
+    }
 
-      // A_ij(i, j) = -1.
-      aRef(0, 1) = i;
-      aRef(1, 1) = neighbors(j, i);
-      aRef(2, 1) = -1;
+    for (size_t j = 0; j < k; ++j)
+    {
+      locations(0, i * k + j) = i;
+      locations(1, i * k + j) = neighbors(j, i);
+      values[i * k + j] = w[j];
+    }
+  }
 
-      // A_ij(j, i) = -1.
-      aRef(0, 2) = neighbors(j, i);
-      aRef(1, 2) = i;
-      aRef(2, 2) = -1;
+  // The zero weights of the landmarks are dropped.
+  weights = arma::sp_mat(locations, values, data.n_cols, landmarks.n_elem);
+}
 
-      // A_ij(j, j) = 1.
-      aRef(0, 3) = neighbors(j, i);
-      aRef(1, 3) = neighbors(j, i);
-      aRef(2, 3) = 1;
+void MVU::Unfold(const size_t newDim,
+                 const size_t numNeighbors,
+                 arma::mat& outputData)
+{
+  // The constraints are on the squared distances between pairs of neighbors.
+  arma::umat pairs;
+  arma::vec squaredDistances;
+  NeighborPairs(numNeighbors, pairs, squaredDistances);
 
-      // The constraint b_ij is the distance between these two points.
-      mvuSolver.B()[index] = distances(j, i);
+  if (numLandmarks == 0 || numLandmarks >= data.n_cols)
+  {
+    // Following Nick's idea, we start from a random point.
+    outputData.randu(data.n_cols, newDim);
+
+    // There is one sparse constraint for each pair of neighbors, and the
+    // centering constraint, which is dense.
+    ens::LRSDP<ens::SDP<arma::sp_mat>> mvuSolver(pairs.n_cols, 1, outputData);
+
+    // Set up the objective.  Because we are maximizing the trace of (R R^T),
+    // we'll instead state it as min(-I_n * (R R^T)), meaning C() is -I_n.
+    mvuSolver.SDP().C().eye(data.n_cols, data.n_cols);
+    mvuSolver.SDP().C() *= -1;
+
+    // The centering constraint is trace(ones * R * R^T) = 0.
+    mvuSolver.SDP().DenseA()[0].ones(data.n_cols, data.n_cols);
+    mvuSolver.SDP().DenseB()[0] = 0;
+
+    // Add each of the other constraints.  They are sparse constraints:
+    //   Tr(A_ij K) = d_ij^2;
+    //   A_ij = zeros except for 1 at (i, i), (j, j); -1 at (i, j), (j, i).
+    // Each one is built independently, so we can build them in parallel.
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t e = 0; e < (omp_size_t) pairs.n_cols; ++e)
+    {
+      const size_t i = pairs(0, e);
+      const size_t j = pairs(1, e);
+
+      arma::umat locations(2, 4);
+      locations(0, 0) = i; locations(1, 0) = i;
+      locations(0, 1) = i; locations(1, 1) = j;
+      locations(0, 2) = j; locations(1, 2) = i;
+      locations(0, 3) = j; locations(1, 3) = j;
+      const arma::vec values("1 -1 -1 1");
+
+      mvuSolver.SDP().SparseA()[e] = arma::sp_mat(locations, values,
+          data.n_cols, data.n_cols);
+      mvuSolver.SDP().SparseB()[e] = squaredDistances[e];
     }
+
+    // Now on with the solving.
+    const double objective = mvuSolver.Optimize(outputData);
+    Log::Info << "Final objective is " << objective << "." << std::endl;
   }
+  else
+  {
+    // Choose the landmarks randomly, and express K as Q L Q^T.
+    const arma::uvec landmarks = arma::sort(arma::randperm(data.n_cols,
+        numLandmarks));
+    arma::sp_mat q;
+    LandmarkWeights(landmarks, numNeighbors, q);
+    const arma::sp_mat qt = q.t();
+
+    arma::mat landmarkData;
+    landmarkData.randu(numLandmarks, newDim);
+
+    ens::LRSDP<ens::SDP<arma::mat>> mvuSolver(pairs.n_cols, 1, landmarkData);
+
+    // Tr(K) = Tr(L Q^T Q), and we minimize its negation.
+    mvuSolver.SDP().C() = -arma::mat(qt * q);
+
+    // The centering constraint is 1^T Q L Q^T 1 = 0.
+    const arma::vec sums = qt * arma::ones<arma::vec>(data.n_cols);
+    mvuSolver.SDP().DenseA()[0] = sums * sums.t();
+    mvuSolver.SDP().DenseB()[0] = 0;
+
+    // The constraint of the pair (i, j) is
+    //   Tr(L (q_i - q_j) (q_i - q_j)^T) = d_ij^2,
+    // and q_i - q_j has at most 2k nonzero elements.
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t e = 0; e < (omp_size_t) pairs.n_cols; ++e)
+    {
+      const arma::sp_mat diff = qt.col(pairs(0, e)) - qt.col(pairs(1, e));
+      mvuSolver.SDP().SparseA()[e] = diff * diff.t();
+      mvuSolver.SDP().SparseB()[e] = squaredDistances[e];
+    }
 
-  // Now on with the solving.
-  double objective = mvuSolver.Optimize(outputData);
+    const double objective = mvuSolver.Optimize(landmarkData);
+    Log::Info << "Final objective is " << objective << "." << std::endl;
 
-  Log::Info << "Final objective is " << objective << "." << std::endl;
+    outputData = q * landmarkData;
+  }
 
   // Revert to original data format.
   outputData = trans(outputData);
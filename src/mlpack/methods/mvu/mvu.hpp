@@ -7,8 +7,6 @@
  * program) which MVU seeks to minimize.  Minimization is performed by the
  * Augmented Lagrangian optimizer (which in turn uses the L-BFGS optimizer).
  *
- * Note: this implementation of MVU does not work.  See #189.
- *
  * mlpack is free software; you may redistribute it and/or modify it under the
  * terms of the 3-clause BSD license.  You should have received a copy of the
  * 3-clause BSD license along with mlpack.  If not, see
@@ -28,18 +26,97 @@ namespace mvu {
  *
  * - dataset
  * - new dimensionality
+ *
+ * The kernel matrix K = R R^T of the output points (the rows of R) maximizes
+ * Tr(K) subject to K being centered and to the squared distances between each
+ * point and its nearest neighbors being preserved.  This semidefinite program
+ * is solved with the low-rank LRSDP solver.  Each distance constraint is a
+ * sparse matrix with four nonzero elements, and each pair of neighbors gives
+ * a single constraint.
+ *
+ * The nearest neighbor graph is found with KNN (exact) or, if approximate is
+ * true, with NNDescent, which builds it in parallel.
+ *
+ * If numLandmarks is nonzero, landmark MVU is used: each point is
+ * reconstructed as a weighted combination of its nearest landmarks (a random
+ * subset of the points), K = Q L Q^T, and the program is solved for the
+ * numLandmarks x numLandmarks matrix L.  This is the way to handle more than
+ * a few thousand points.  See the following paper:
+ *
+ * @code
+ * @inproceedings{weinberger2005nonlinear,
+ *   title={Nonlinear Dimensionality Reduction by Semidefinite Programming and
+ *       Kernel Matrix Factorization},
+ *   author={Weinberger, Kilian Q. and Packer, Benjamin D. and Saul, Lawrence
+ *       K.},
+ *   booktitle={Proceedings of the Tenth International Workshop on Artificial
+ *       Intelligence and Statistics (AISTATS)},
+ *   pages={381--388},
+ *   year={2005}
+ * }
+ * @endcode
  */
 class MVU
 {
  public:
-  MVU(const arma::mat& dataIn);
+  /**
+   * Create the MVU object on the given dataset.
+   *
+   * @param dataIn Dataset (one column per point).
+   * @param approximate If true, find the nearest neighbors with NNDescent.
+   * @param numLandmarks Number of landmarks (0 to use all the points).
+   */
+  MVU(const arma::mat& dataIn,
+      const bool approximate = false,
+      const size_t numLandmarks = 0);
 
+  /**
+   * Unfold the dataset into newDim dimensions, preserving the distances
+   * between each point and its numNeighbors nearest neighbors.
+   *
+   * @param newDim Dimensionality of the output.
+   * @param numNeighbors Number of nearest neighbors of each point.
+   * @param outputCoordinates Matrix to store the unfolded points in (one
+   *     column per point).
+   */
   void Unfold(const size_t newDim,
               const size_t numNeighbors,
               arma::mat& outputCoordinates);
 
+  //! Get whether the nearest neighbors are found with NNDescent.
+  bool Approximate() const { return approximate; }
+  //! Modify whether the nearest neighbors are found with NNDescent.
+  bool& Approximate() { return approximate; }
+
+  //! Get the number of landmarks (0 if all the points are used).
+  size_t NumLandmarks() const { return numLandmarks; }
+  //! Modify the number of landmarks (0 if all the points are used).
+  size_t& NumLandmarks() { return numLandmarks; }
+
  private:
+  /**
+   * Find the pairs of nearest neighbors of the dataset (each pair once, with
+   * the smaller index first) and their squared distances.
+   */
+  void NeighborPairs(const size_t numNeighbors,
+                     arma::umat& pairs,
+                     arma::vec& squaredDistances) const;
+
+  /**
+   * Compute the reconstruction weights of each point from its nearest
+   * landmarks (one row per point, one column per landmark).
+   */
+  void LandmarkWeights(const arma::uvec& landmarks,
+                       const size_t numNeighbors,
+                       arma::sp_mat& weights) const;
+
   const arma::mat& data;
+
+  //! Whether the nearest neighbors are found with NNDescent.
+  bool approximate;
+
+  //! The number of landmarks (0 if all the points are used).
+  size_t numLandmarks;
 };
 
 } // namespace mvu
@@ -4,8 +4,6 @@
  *
  * Executable for MVU.
  *
- * Note: this implementation of MVU does not work.  See #189.
- *
  * mlpack is free software; you may redistribute it and/or modify it under the
  * terms of the 3-clause BSD license.  You should have received a copy of the
  * 3-clause BSD license along with mlpack.  If not, see
@@ -13,13 +11,38 @@
  */
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/util/cli.hpp>
+#include <mlpack/core/util/mlpack_main.hpp>
+#include <mlpack/core/math/random.hpp>
 #include "mvu.hpp"
 
-PROGRAM_INFO("Maximum Variance Unfolding (MVU)", "This program implements "
-    "Maximum Variance Unfolding, a nonlinear dimensionality reduction "
-    "technique.  The method minimizes dimensionality by unfolding a manifold "
-    "such that the distances to the nearest neighbors of each point are held "
-    "constant.");
+PROGRAM_INFO("Maximum Variance Unfolding (MVU)",
+    // Short description.
+    "An implementation of Maximum Variance Unfolding, a nonlinear "
+    "dimensionality reduction technique that unfolds a manifold while keeping "
+    "the distances between each point and its nearest neighbors.",
+    // Long description.
+    "This program implements Maximum Variance Unfolding, a nonlinear "
+    "dimensionality reduction technique.  The method minimizes dimensionality "
+    "by unfolding a manifold such that the distances to the nearest neighbors "
+    "of each point are held constant."
+    "\n\n"
+    "The input dataset is specified with the " + PRINT_PARAM_STRING("input") +
+    " parameter, the new dimensionality with the " +
+    PRINT_PARAM_STRING("new_dim") + " parameter, and the unfolded dataset "
+    "may be saved with the " + PRINT_PARAM_STRING("output") + " output "
+    "parameter.  If " + PRINT_PARAM_STRING("approximate") + " is specified, "
+    "the nearest neighbors are found with NN-descent instead of exactly.  For "
+    "large datasets, landmark MVU can be used by setting the number of "
+    "landmarks with the " + PRINT_PARAM_STRING("landmarks") + " parameter."
+    "\n\n"
+    "For example, to unfold the dataset " + PRINT_DATASET("data") + " into 2 "
+    "dimensions with 50 landmarks, saving the result to " +
+    PRINT_DATASET("unfolded") + ", the following command may be used:"
+    "\n\n" +
+    PRINT_CALL("mvu", "input", "data", "new_dim", 2, "landmarks", 50,
+        "output", "unfolded"),
+    SEE_ALSO("mlpack::mvu::MVU C++ class documentation",
+        "@doxygen/classmlpack_1_1mvu_1_1MVU.html"));
 
 PARAM_MATRIX_IN_REQ("input", "Input dataset.", "i");
 PARAM_INT_IN_REQ("new_dim", "New dimensionality of dataset.", "d");
@@ -27,6 +50,11 @@ PARAM_INT_IN_REQ("new_dim", "New dimensionality of dataset.", "d");
 PARAM_MATRIX_OUT("output", "Matrix to save unfolded dataset to.", "o");
 PARAM_INT_IN("num_neighbors", "Number of nearest neighbors to consider while "
     "unfolding.", "k", 5);
+PARAM_FLAG("approximate", "Find the nearest neighbors approximately with "
+    "NN-descent (in parallel) instead of exactly.", "a");
+PARAM_INT_IN("landmarks", "Number of landmarks for landmark MVU (0 uses all "
+    "the points).", "l", 0);
+PARAM_INT_IN("seed", "Random seed.  If 0, 'std::time(NULL)' is used.", "s", 0);
 
 using namespace mlpack;
 using namespace mlpack::mvu;
@@ -35,44 +63,38 @@ using namespace mlpack::util;
 using namespace arma;
 using namespace std;
 
-int main(int argc, char **argv)
+static void mlpackMain()
 {
-  // Read from command line.
-  CLI::ParseCommandLine(argc, argv);
-  const string inputFile = CLI::GetParam<string>("input_file");
-  const string outputFile = CLI::GetParam<string>("output_file");
-  const int newDim = CLI::GetParam<int>("new_dim");
-  const int numNeighbors = CLI::GetParam<int>("num_neighbors");
-
-  if (!CLI::HasParam("output"))
-  {
-    Log::Warn << "--output_file (-o) is not specified; no results will be "
-        << "saved!" << endl;
-  }
+  if (CLI::GetParam<int>("seed") != 0)
+    RandomSeed((size_t) CLI::GetParam<int>("seed"));
+  else
+    RandomSeed((size_t) std::time(NULL));
 
-  RandomSeed(time(NULL));
+  RequireAtLeastOnePassed({ "output" }, false, "no results will be saved");
 
   // Load input dataset.
   mat data = std::move(CLI::GetParam<arma::mat>("input"));
 
-  // Verify that the requested dimensionality is valid.
-  if (newDim <= 0 || newDim > (int) data.n_rows)
-  {
-    Log::Fatal << "Invalid new dimensionality (" << newDim << ").  Must be "
-      << "between 1 and the input dataset dimensionality (" << data.n_rows
-      << ")." << std::endl;
-  }
+  // Verify that the requested dimensionality and the number of neighbors are
+  // valid.
+  RequireParamValue<int>("new_dim", [&data](int x) {
+      return x > 0 && x <= (int) data.n_rows; }, true,
+      "new dimensionality must be between 1 and the input dataset "
+      "dimensionality");
+  RequireParamValue<int>("num_neighbors", [&data](int x) {
+      return x > 0 && x < (int) data.n_cols; }, true,
+      "number of neighbors must be positive and less than the number of points "
+      "in the input dataset");
+  RequireParamValue<int>("landmarks", [](int x) { return x >= 0; }, true,
+      "number of landmarks must be nonnegative");
 
-  // Verify that the number of neighbors is valid.
-  if (numNeighbors <= 0 || numNeighbors > (int) data.n_cols)
-  {
-    Log::Fatal << "Invalid number of neighbors (" << numNeighbors << ").  Must "
-        << "be between 1 and the number of points in the input dataset ("
-        << data.n_cols << ")." << std::endl;
-  }
+  const size_t newDim = (size_t) CLI::GetParam<int>("new_dim");
+  const size_t numNeighbors = (size_t) CLI::GetParam<int>("num_neighbors");
+  const bool approximate = CLI::HasParam("approximate");
+  const size_t numLandmarks = (size_t) CLI::GetParam<int>("landmarks");
 
   // Now run MVU.
-  MVU mvu(data);
+  MVU mvu(data, approximate, numLandmarks);
 
   mat output;
   mvu.Unfold(newDim, numNeighbors, output);
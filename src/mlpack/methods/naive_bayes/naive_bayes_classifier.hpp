@@ -34,6 +34,11 @@ namespace naive_bayes /** The Naive Bayes Classifier. */ {
  * For classifying a data point (x_1, x_2, ..., x_n), it computes the following:
  * arg max_y(P(Y = y)*P(X_1 = x_1 | Y = y) * ... * P(X_n = x_n | Y = y))
  *
+ * Training and classification are parallelized with OpenMP.  Sparse data (for
+ * instance, TF-IDF features from data::TfIdfEncodingPolicy) can be given as an
+ * arma::sp_mat; then only its nonzero elements are visited, and it is never
+ * converted to a dense matrix.
+ *
  * Example use:
  *
  * @code
@@ -240,7 +245,65 @@ class NaiveBayesClassifier
    */
   template<typename MatType>
   void LogLikelihood(const MatType& data,
+                     ModelMatType& logLikelihoods,
+                     const typename std::enable_if_t<
+                         !arma::is_arma_sparse_type<MatType>::value>* = 0)
+                     const;
+
+  /**
+   * Compute the unnormalized posterior log probability of the given sparse
+   * points.  Only the nonzero elements of each point are visited; the
+   * contribution of the zero elements is the same for every point of a class,
+   * so it is computed once.
+   *
+   * @param data Set of points to compute posterior log probability for.
+   * @param logLikelihoods Matrix to store log likelihoods in.
+   */
+  void LogLikelihood(const arma::SpMat<ElemType>& data,
                      ModelMatType& logLikelihoods) const;
+
+  /**
+   * Compute the number of points, the sample mean, and the sum of squared
+   * deviations from the mean of the features of each class of the given
+   * points.  The points are split between OpenMP threads, each of which has
+   * its own accumulators.
+   *
+   * @param data Points to compute statistics of.
+   * @param labels Labels of the points.
+   * @param numClasses Number of classes.
+   * @param counts Vector to store the number of points of each class in.
+   * @param sampleMeans Matrix to store the mean of each class in.
+   * @param squaredDeviations Matrix to store the sum of squared deviations of
+   *     each class in.
+   */
+  template<typename MatType>
+  void Statistics(const MatType& data,
+                  const arma::Row<size_t>& labels,
+                  const size_t numClasses,
+                  arma::Col<ElemType>& counts,
+                  ModelMatType& sampleMeans,
+                  ModelMatType& squaredDeviations,
+                  const typename std::enable_if_t<
+                      !arma::is_arma_sparse_type<MatType>::value>* = 0) const;
+
+  /**
+   * Compute the statistics of the features of each class of the given sparse
+   * points, visiting only the nonzero elements.
+   *
+   * @param data Points to compute statistics of.
+   * @param labels Labels of the points.
+   * @param numClasses Number of classes.
+   * @param counts Vector to store the number of points of each class in.
+   * @param sampleMeans Matrix to store the mean of each class in.
+   * @param squaredDeviations Matrix to store the sum of squared deviations of
+   *     each class in.
+   */
+  void Statistics(const arma::SpMat<ElemType>& data,
+                  const arma::Row<size_t>& labels,
+                  const size_t numClasses,
+                  arma::Col<ElemType>& counts,
+                  ModelMatType& sampleMeans,
+                  ModelMatType& squaredDeviations) const;
 };
 
 } // namespace naive_bayes
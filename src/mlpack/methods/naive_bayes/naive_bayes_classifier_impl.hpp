@@ -106,21 +106,36 @@ void NaiveBayesClassifier<ModelMatType>::Train(
   }
 
   // Calculate the class probabilities as well as the sample mean and variance
-  // for each of the features with respect to each of the labels.
+  // for each of the features with respect to each of the labels.  This is a
+  // two-pass algorithm: the mean of each class is found first, and then the
+  // sum of squared deviations from the mean.  It is possible to calculate the
+  // means and variances using a faster one-pass algorithm but there are some
+  // precision and stability issues.
+  arma::Col<ElemType> counts;
+  ModelMatType sampleMeans, squaredDeviations;
+  Statistics(data, labels, numClasses, counts, sampleMeans, squaredDeviations);
+
   if (incremental)
   {
     // Use incremental algorithm.
     // Fist, de-normalize probabilities.
     probabilities *= trainingPoints;
 
-    for (size_t j = 0; j < data.n_cols; ++j)
+    // Now merge the statistics of the new points into the model.  This gives
+    // the same model as updating it one point at a time (see Chan, Golub and
+    // LeVeque, "Updating formulae and a pairwise algorithm for computing
+    // sample variances", 1979).
+    for (size_t i = 0; i < probabilities.n_elem; ++i)
     {
-      const size_t label = labels[j];
-      ++probabilities[label];
-
-      arma::vec delta = data.col(j) - means.col(label);
-      means.col(label) += delta / probabilities[label];
-      variances.col(label) += delta % (data.col(j) - means.col(label));
+      if (counts[i] == 0)
+        continue;
+
+      const ElemType total = probabilities[i] + counts[i];
+      const arma::Col<ElemType> delta = sampleMeans.col(i) - means.col(i);
+      means.col(i) += delta * (counts[i] / total);
+      variances.col(i) += squaredDeviations.col(i) +
+          arma::square(delta) * (probabilities[i] * counts[i] / total);
+      probabilities[i] = total;
     }
 
     for (size_t i = 0; i < probabilities.n_elem; ++i)
@@ -131,36 +146,9 @@ void NaiveBayesClassifier<ModelMatType>::Train(
   }
   else
   {
-    // Set all parameters to zero.
-    probabilities.zeros();
-    means.zeros();
-    variances.zeros();
-
-    // Don't use incremental algorithm.  This is a two-pass algorithm.  It is
-    // possible to calculate the means and variances using a faster one-pass
-    // algorithm but there are some precision and stability issues.  If this is
-    // too slow, it's an option to use the faster algorithm by default and then
-    // have this (and the incremental algorithm) be other options.
-
-    // Calculate the means.
-    for (size_t j = 0; j < data.n_cols; ++j)
-    {
-      const size_t label = labels[j];
-      ++probabilities[label];
-      means.col(label) += data.col(j);
-    }
-
-    // Normalize means.
-    for (size_t i = 0; i < probabilities.n_elem; ++i)
-      if (probabilities[i] != 0.0)
-        means.col(i) /= probabilities[i];
-
-    // Calculate variances.
-    for (size_t j = 0; j < data.n_cols; ++j)
-    {
-      const size_t label = labels[j];
-      variances.col(label) += square(data.col(j) - means.col(label));
-    }
+    probabilities = counts;
+    means = sampleMeans;
+    variances = squaredDeviations;
 
     // Normalize variances.
     for (size_t i = 0; i < probabilities.n_elem; ++i)
@@ -200,11 +188,146 @@ void NaiveBayesClassifier<ModelMatType>::Train(const VecType& point,
   probabilities /= trainingPoints;
 }
 
+template<typename ModelMatType>
+template<typename MatType>
+void NaiveBayesClassifier<ModelMatType>::Statistics(
+    const MatType& data,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    arma::Col<ElemType>& counts,
+    ModelMatType& sampleMeans,
+    ModelMatType& squaredDeviations,
+    const typename std::enable_if_t<
+        !arma::is_arma_sparse_type<MatType>::value>*) const
+{
+  counts.zeros(numClasses);
+  sampleMeans.zeros(data.n_rows, numClasses);
+  squaredDeviations.zeros(data.n_rows, numClasses);
+
+  // Calculate the means.  Each thread sums its own points.
+  #pragma omp parallel
+  {
+    arma::Col<ElemType> threadCounts(numClasses, arma::fill::zeros);
+    ModelMatType threadSums(data.n_rows, numClasses, arma::fill::zeros);
+
+    #pragma omp for
+    for (omp_size_t j = 0; j < (omp_size_t) data.n_cols; ++j)
+    {
+      const size_t label = labels[j];
+      ++threadCounts[label];
+      threadSums.col(label) += data.col(j);
+    }
+
+    #pragma omp critical
+    {
+      counts += threadCounts;
+      sampleMeans += threadSums;
+    }
+  }
+
+  // Normalize means.
+  for (size_t i = 0; i < numClasses; ++i)
+    if (counts[i] != 0.0)
+      sampleMeans.col(i) /= counts[i];
+
+  // Calculate the sums of squared deviations.
+  #pragma omp parallel
+  {
+    ModelMatType threadDeviations(data.n_rows, numClasses, arma::fill::zeros);
+
+    #pragma omp for
+    for (omp_size_t j = 0; j < (omp_size_t) data.n_cols; ++j)
+    {
+      const size_t label = labels[j];
+      threadDeviations.col(label) +=
+          arma::square(data.col(j) - sampleMeans.col(label));
+    }
+
+    #pragma omp critical
+    squaredDeviations += threadDeviations;
+  }
+}
+
+template<typename ModelMatType>
+void NaiveBayesClassifier<ModelMatType>::Statistics(
+    const arma::SpMat<ElemType>& data,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    arma::Col<ElemType>& counts,
+    ModelMatType& sampleMeans,
+    ModelMatType& squaredDeviations) const
+{
+  counts.zeros(numClasses);
+  sampleMeans.zeros(data.n_rows, numClasses);
+  squaredDeviations.zeros(data.n_rows, numClasses);
+
+  // Calculate the means; the zero elements do not contribute to the sums.
+  #pragma omp parallel
+  {
+    arma::Col<ElemType> threadCounts(numClasses, arma::fill::zeros);
+    ModelMatType threadSums(data.n_rows, numClasses, arma::fill::zeros);
+
+    #pragma omp for
+    for (omp_size_t j = 0; j < (omp_size_t) data.n_cols; ++j)
+    {
+      const size_t label = labels[j];
+      ++threadCounts[label];
+      for (typename arma::SpMat<ElemType>::const_iterator it =
+           data.begin_col(j); it != data.end_col(j); ++it)
+        threadSums(it.row(), label) += (*it);
+    }
+
+    #pragma omp critical
+    {
+      counts += threadCounts;
+      sampleMeans += threadSums;
+    }
+  }
+
+  // Normalize means.
+  for (size_t i = 0; i < numClasses; ++i)
+    if (counts[i] != 0.0)
+      sampleMeans.col(i) /= counts[i];
+
+  // Calculate the sums of squared deviations.  If every element were zero, the
+  // sum for class c would be counts[c] * mean^2; each nonzero element x then
+  // replaces one mean^2 term by (x - mean)^2, which differs by x * (x - 2 *
+  // mean).
+  #pragma omp parallel
+  {
+    ModelMatType threadDeviations(data.n_rows, numClasses, arma::fill::zeros);
+
+    #pragma omp for
+    for (omp_size_t j = 0; j < (omp_size_t) data.n_cols; ++j)
+    {
+      const size_t label = labels[j];
+      for (typename arma::SpMat<ElemType>::const_iterator it =
+           data.begin_col(j); it != data.end_col(j); ++it)
+      {
+        threadDeviations(it.row(), label) += (*it) *
+            ((*it) - 2 * sampleMeans(it.row(), label));
+      }
+    }
+
+    #pragma omp critical
+    squaredDeviations += threadDeviations;
+  }
+
+  for (size_t i = 0; i < numClasses; ++i)
+    squaredDeviations.col(i) += counts[i] * arma::square(sampleMeans.col(i));
+
+  // Rounding may leave tiny negative sums when all points of a class have the
+  // same value.
+  squaredDeviations.elem(arma::find(squaredDeviations < 0)).zeros();
+}
+
 template<typename ModelMatType>
 template<typename MatType>
 void NaiveBayesClassifier<ModelMatType>::LogLikelihood(
     const MatType& data,
-    ModelMatType& logLikelihoods) const
+    ModelMatType& logLikelihoods,
+    const typename std::enable_if_t<
+        !arma::is_arma_sparse_type<MatType>::value>*) const
 {
   static_assert(std::is_same<ElemType, typename MatType::elem_type>::value,
       "NaiveBayesClassifier: element type of given data must match the element "
@@ -217,7 +340,8 @@ void NaiveBayesClassifier<ModelMatType>::LogLikelihood(
   // means.n_cols.
 
   // Loop over every class.
-  for (size_t i = 0; i < means.n_cols; i++)
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) means.n_cols; i++)
   {
     // This is an adaptation of gmm::phi() for the case where the covariance is
     // a diagonal matrix.
@@ -230,6 +354,40 @@ void NaiveBayesClassifier<ModelMatType>::LogLikelihood(
   }
 }
 
+template<typename ModelMatType>
+void NaiveBayesClassifier<ModelMatType>::LogLikelihood(
+    const arma::SpMat<ElemType>& data,
+    ModelMatType& logLikelihoods) const
+{
+  logLikelihoods = arma::log(arma::repmat(probabilities, 1, data.n_cols));
+  const ModelMatType invVar = 1.0 / variances;
+
+  // The exponent of a point that is all zeros is the same for every point, so
+  // it is added first.
+  for (size_t i = 0; i < means.n_cols; ++i)
+  {
+    logLikelihoods.row(i) += data.n_rows / -2.0 * log(2 * M_PI) - 0.5 *
+        arma::accu(arma::log(variances.col(i))) - 0.5 *
+        arma::accu(arma::square(means.col(i)) % invVar.col(i));
+  }
+
+  // Each nonzero element x then changes the exponent by -0.5 * x * (x - 2 *
+  // mean) / variance.
+  #pragma omp parallel for
+  for (omp_size_t j = 0; j < (omp_size_t) data.n_cols; ++j)
+  {
+    for (typename arma::SpMat<ElemType>::const_iterator it =
+         data.begin_col(j); it != data.end_col(j); ++it)
+    {
+      for (size_t i = 0; i < means.n_cols; ++i)
+      {
+        logLikelihoods(i, j) -= 0.5 * (*it) *
+            ((*it) - 2 * means(it.row(), i)) * invVar(it.row(), i);
+      }
+    }
+  }
+}
+
 template<typename ModelMatType>
 template<typename VecType>
 size_t NaiveBayesClassifier<ModelMatType>::Classify(const VecType& point) const
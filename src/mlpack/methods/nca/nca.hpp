@@ -57,10 +57,13 @@ class NCA
    * @param dataset Input dataset.
    * @param labels Input dataset labels.
    * @param metric Instantiated metric to use.
+   * @param numNeighbors Number of nearest neighbors of each point used by the
+   *     objective function (0 uses all the points; see SoftmaxErrorFunction).
    */
   NCA(const arma::mat& dataset,
       const arma::Row<size_t>& labels,
-      MetricType metric = MetricType());
+      MetricType metric = MetricType(),
+      const size_t numNeighbors = 0);
 
   /**
    * Perform Neighborhood Components Analysis.  The output distance learning
@@ -86,6 +89,12 @@ class NCA
   const OptimizerType& Optimizer() const { return optimizer; }
   OptimizerType& Optimizer() { return optimizer; }
 
+  //! Get the objective function.
+  const SoftmaxErrorFunction<MetricType>& ErrorFunction() const
+  { return errorFunction; }
+  //! Modify the objective function.
+  SoftmaxErrorFunction<MetricType>& ErrorFunction() { return errorFunction; }
+
  private:
   //! Dataset reference.
   const arma::mat& dataset;
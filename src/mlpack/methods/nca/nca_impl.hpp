@@ -22,11 +22,12 @@ namespace nca {
 template<typename MetricType, typename OptimizerType>
 NCA<MetricType, OptimizerType>::NCA(const arma::mat& dataset,
                                     const arma::Row<size_t>& labels,
-                                    MetricType metric) :
+                                    MetricType metric,
+                                    const size_t numNeighbors) :
     dataset(dataset),
     labels(labels),
     metric(metric),
-    errorFunction(dataset, labels, metric)
+    errorFunction(dataset, labels, metric, numNeighbors)
 { /* Nothing to do. */ }
 
 template<typename MetricType, typename OptimizerType>
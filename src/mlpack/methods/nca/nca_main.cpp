@@ -88,7 +88,13 @@ PROGRAM_INFO("Neighborhood Components Analysis (NCA)",
     "mlpack L-BFGS documentation (in lbfgs.hpp) or the vast set of published "
     "literature on L-BFGS."
     "\n\n"
-    "By default, the SGD optimizer is used.",
+    "By default, the SGD optimizer is used."
+    "\n\n"
+    "The objective function takes quadratic time in the number of points.  For "
+    "large datasets, the " + PRINT_PARAM_STRING("num_neighbors") + " parameter "
+    "can be set to restrict the objective of each point to its nearest "
+    "neighbors in the transformed space, which are searched with a kd-tree "
+    "once per pass over the data.",
     SEE_ALSO("@lmnn", "#lmnn"),
     SEE_ALSO("Neighbourhood components analysis on Wikipedia",
         "https://en.wikipedia.org/wiki/Neighbourhood_components_analysis"),
@@ -129,6 +135,9 @@ PARAM_DOUBLE_IN("min_step", "Minimum step of line search for L-BFGS.", "m",
 PARAM_DOUBLE_IN("max_step", "Maximum step of line search for L-BFGS.", "M",
     1e20);
 
+PARAM_INT_IN("num_neighbors", "Number of nearest neighbors of each point used "
+    "by the objective function (0 uses all the points).", "k", 0);
+
 PARAM_INT_IN("seed", "Random seed.  If 0, 'std::time(NULL)' is used.", "s", 0);
 
 using namespace mlpack;
@@ -182,6 +191,10 @@ static void mlpackMain()
   const double maxStep = CLI::GetParam<double>("max_step");
   const size_t batchSize = (size_t) CLI::GetParam<int>("batch_size");
 
+  RequireParamValue<int>("num_neighbors", [](int x) { return x >= 0; }, true,
+      "number of neighbors must be nonnegative");
+  const size_t numNeighbors = (size_t) CLI::GetParam<int>("num_neighbors");
+
   // Load data.
   arma::mat data = std::move(CLI::GetParam<arma::mat>("input"));
 
@@ -234,7 +247,7 @@ static void mlpackMain()
   // Now create the NCA object and run the optimization.
   if (optimizerType == "sgd")
   {
-    NCA<LMetric<2> > nca(data, labels);
+    NCA<LMetric<2> > nca(data, labels, LMetric<2>(), numNeighbors);
     nca.Optimizer().StepSize() = stepSize;
     nca.Optimizer().MaxIterations() = maxIterations;
     nca.Optimizer().Tolerance() = tolerance;
@@ -245,7 +258,8 @@ static void mlpackMain()
   }
   else if (optimizerType == "lbfgs")
   {
-    NCA<LMetric<2>, ens::L_BFGS> nca(data, labels);
+    NCA<LMetric<2>, ens::L_BFGS> nca(data, labels, LMetric<2>(),
+        numNeighbors);
     nca.Optimizer().NumBasis() = numBasis;
     nca.Optimizer().MaxIterations() = maxIterations;
     nca.Optimizer().ArmijoConstant() = armijoConstant;
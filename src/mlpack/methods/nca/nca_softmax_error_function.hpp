@@ -38,6 +38,15 @@ namespace nca {
  * optimizers use, overloads of Evaluate() and Gradient() are given which only
  * operate on one point in the dataset.  This is useful for optimizers like
  * stochastic gradient descent (see mlpack::optimization::SGD).
+ *
+ * The exact objective sums over all pairs of points, which takes O(n^2) time
+ * per evaluation.  If numNeighbors is nonzero, the sums of each point are
+ * truncated to its numNeighbors nearest neighbors in the transformed space (the
+ * terms of the other points are nearly zero once the transformation is
+ * learned).  The neighbors are found with a kd-tree (with the Euclidean
+ * distance) and searched again after every refreshInterval points that have
+ * been evaluated, and the points are processed in parallel when OpenMP is
+ * available.
  */
 template<typename MetricType = metric::SquaredEuclideanDistance>
 class SoftmaxErrorFunction
@@ -52,10 +61,16 @@ class SoftmaxErrorFunction
    * @param dataset Matrix containing the dataset.
    * @param labels Vector of class labels for each point in the dataset.
    * @param metric Instantiated metric (optional).
+   * @param numNeighbors Number of nearest neighbors of each point to use (0
+   *     uses all the points).
+   * @param refreshInterval Number of evaluated points after which the nearest
+   *     neighbors are searched again (0 for once per pass over the dataset).
    */
   SoftmaxErrorFunction(const arma::mat& dataset,
                        const arma::Row<size_t>& labels,
-                       MetricType metric = MetricType());
+                       MetricType metric = MetricType(),
+                       const size_t numNeighbors = 0,
+                       const size_t refreshInterval = 0);
 
   /**
    * Shuffle the dataset.
@@ -129,6 +144,16 @@ class SoftmaxErrorFunction
    */
   size_t NumFunctions() const { return dataset.n_cols; }
 
+  //! Get the number of nearest neighbors of each point used (0 for all).
+  size_t NumNeighbors() const { return numNeighbors; }
+  //! Modify the number of nearest neighbors of each point used (0 for all).
+  size_t& NumNeighbors() { return numNeighbors; }
+
+  //! Get the number of evaluated points between nearest neighbor searches.
+  size_t RefreshInterval() const { return refreshInterval; }
+  //! Modify the number of evaluated points between nearest neighbor searches.
+  size_t& RefreshInterval() { return refreshInterval; }
+
  private:
   //! The dataset.  This is an alias until Shuffle() is called.
   arma::mat dataset;
@@ -152,6 +177,37 @@ class SoftmaxErrorFunction
   //! False if nothing has ever been precalculated (only at construction time).
   bool precalculated;
 
+  //! The number of nearest neighbors of each point used (0 for all).
+  size_t numNeighbors;
+  //! The number of evaluated points between nearest neighbor searches.
+  size_t refreshInterval;
+  //! The nearest neighbors of each point (one column per point).
+  arma::umat neighbors;
+  //! The number of points evaluated since the last nearest neighbor search.
+  size_t pointsSinceSearch;
+
+  /**
+   * Compute the truncated objective (the negated sum of p_i over the given
+   * points, with the sums of each point restricted to its nearest neighbors),
+   * and optionally its gradient.  The nearest neighbors are searched again
+   * first if needed.
+   *
+   * @param coordinates Coordinates matrix.
+   * @param begin Index of the first point.
+   * @param batchSize Number of points.
+   * @param gradient If not NULL, the gradient is stored here.
+   */
+  double TruncatedEvaluate(const arma::mat& coordinates,
+                           const size_t begin,
+                           const size_t batchSize,
+                           arma::mat* gradient = NULL);
+
+  /**
+   * Find the nearest neighbors of every point in the space transformed by the
+   * given coordinates.
+   */
+  void SearchNeighbors(const arma::mat& coordinates);
+
   /**
    * Precalculate the denominators and numerators that will make up the p_ij,
    * but only if the coordinates matrix is different than the last coordinates
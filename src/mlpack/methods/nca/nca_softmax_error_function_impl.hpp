@@ -16,6 +16,7 @@
 #include "nca_softmax_error_function.hpp"
 
 #include <mlpack/core.hpp>
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
 
 namespace mlpack {
 namespace nca {
@@ -25,11 +26,16 @@ template<typename MetricType>
 SoftmaxErrorFunction<MetricType>::SoftmaxErrorFunction(
     const arma::mat& dataset,
     const arma::Row<size_t>& labels,
-    MetricType metric) :
+    MetricType metric,
+    const size_t numNeighbors,
+    const size_t refreshInterval) :
     dataset(math::MakeAlias(const_cast<arma::mat&>(dataset), false)),
     labels(math::MakeAlias(const_cast<arma::Row<size_t>&>(labels), false)),
     metric(metric),
-    precalculated(false)
+    precalculated(false),
+    numNeighbors(numNeighbors),
+    refreshInterval(refreshInterval),
+    pointsSinceSearch(0)
 { /* nothing to do */ }
 
 //! Shuffle the dataset.
@@ -46,12 +52,18 @@ void SoftmaxErrorFunction<MetricType>::Shuffle()
 
   dataset = std::move(newDataset);
   labels = std::move(newLabels);
+
+  // The indices of the nearest neighbors are no longer valid.
+  neighbors.clear();
 }
 
 //! The non-separable implementation, which uses Precalculate() to save time.
 template<typename MetricType>
 double SoftmaxErrorFunction<MetricType>::Evaluate(const arma::mat& coordinates)
 {
+  if (numNeighbors > 0)
+    return TruncatedEvaluate(coordinates, 0, dataset.n_cols);
+
   // Calculate the denominators and numerators, if necessary.
   Precalculate(coordinates);
 
@@ -66,6 +78,9 @@ double SoftmaxErrorFunction<MetricType>::Evaluate(const arma::mat& coordinates,
                                                   const size_t begin,
                                                   const size_t batchSize)
 {
+  if (numNeighbors > 0)
+    return TruncatedEvaluate(coordinates, begin, batchSize);
+
   // Unfortunately each evaluation will take O(N) time because it requires a
   // scan over all points in the dataset.  Our objective is to compute p_i.
   double denominator = 0;
@@ -112,6 +127,12 @@ template<typename MetricType>
 void SoftmaxErrorFunction<MetricType>::Gradient(const arma::mat& coordinates,
                                                 arma::mat& gradient)
 {
+  if (numNeighbors > 0)
+  {
+    TruncatedEvaluate(coordinates, 0, dataset.n_cols, &gradient);
+    return;
+  }
+
   // Calculate the denominators and numerators, if necessary.
   Precalculate(coordinates);
 
@@ -163,6 +184,14 @@ void SoftmaxErrorFunction<MetricType>::Gradient(const arma::mat& coordinates,
                                                 GradType& gradient,
                                                 const size_t batchSize)
 {
+  if (numNeighbors > 0)
+  {
+    arma::mat truncatedGradient;
+    TruncatedEvaluate(coordinates, begin, batchSize, &truncatedGradient);
+    gradient = truncatedGradient;
+    return;
+  }
+
   // The gradient involves two matrix terms which are eventually combined into
   // one.
   GradType firstTerm, secondTerm;
@@ -231,6 +260,124 @@ void SoftmaxErrorFunction<MetricType>::Gradient(const arma::mat& coordinates,
   }
 }
 
+//! The truncated implementation, over the nearest neighbors of each point.
+template<typename MetricType>
+double SoftmaxErrorFunction<MetricType>::TruncatedEvaluate(
+    const arma::mat& coordinates,
+    const size_t begin,
+    const size_t batchSize,
+    arma::mat* gradient)
+{
+  const size_t interval = (refreshInterval == 0) ? dataset.n_cols :
+      refreshInterval;
+  if (neighbors.n_cols != dataset.n_cols || pointsSinceSearch >= interval)
+    SearchNeighbors(coordinates);
+  pointsSinceSearch += batchSize;
+
+  // Stretch the whole dataset at once if most of it is needed; otherwise,
+  // stretch only the points of the batch and their neighbors.
+  const bool stretchAll = (batchSize * (neighbors.n_rows + 1) >=
+      dataset.n_cols);
+  if (stretchAll)
+    stretchedDataset = coordinates * dataset;
+
+  // For each point i, we compute p_i over its neighbors only, and the gradient
+  // of p_i, which is
+  //   2 A sum_k (p_i p_ik - [k in class of i] p_ik) x_ik x_ik^T.
+  // Each thread accumulates the sum for its points.
+  if (gradient)
+    gradient->zeros(dataset.n_rows, dataset.n_rows);
+
+  double result = 0;
+  #pragma omp parallel reduction(+:result)
+  {
+    arma::mat sum;
+    if (gradient)
+      sum.zeros(dataset.n_rows, dataset.n_rows);
+
+    #pragma omp for schedule(static)
+    for (omp_size_t b = 0; b < (omp_size_t) batchSize; ++b)
+    {
+      const size_t i = begin + b;
+      const arma::uvec near = neighbors.col(i);
+
+      arma::vec point;
+      arma::mat nearPoints;
+      if (stretchAll)
+      {
+        point = stretchedDataset.col(i);
+        nearPoints = stretchedDataset.cols(near);
+      }
+      else
+      {
+        point = coordinates * dataset.col(i);
+        nearPoints = coordinates * dataset.cols(near);
+      }
+
+      // We want to evaluate exp(-D(A x_i, A x_k)) for each neighbor k.
+      arma::vec evals(near.n_elem);
+      double numerator = 0, denominator = 0;
+      for (size_t j = 0; j < near.n_elem; ++j)
+      {
+        evals[j] = std::exp(-metric.Evaluate(point, nearPoints.col(j)));
+        if (labels[i] == labels[near[j]])
+          numerator += evals[j];
+        denominator += evals[j];
+      }
+
+      // If the denominator is zero, then all p_ik are zero and there is no
+      // contribution from this point.
+      if (denominator == 0.0)
+        continue;
+
+      const double p = numerator / denominator;
+      result -= p; // Negate because the optimizer is a minimizer.
+
+      if (gradient)
+      {
+        for (size_t j = 0; j < near.n_elem; ++j)
+        {
+          const double same = (labels[i] == labels[near[j]]) ? 1.0 : 0.0;
+          evals[j] *= (p - same) / denominator;
+        }
+
+        // For x_ik we are not using stretched points.
+        arma::mat x = dataset.cols(near);
+        x.each_col() -= dataset.col(i);
+        sum += (x.each_row() % evals.t()) * x.t();
+      }
+    }
+
+    if (gradient)
+    {
+      #pragma omp critical(ncaTruncatedGradient)
+      *gradient += sum;
+    }
+  }
+
+  // Multiply all by 2 * A, negated, because our optimizer is a minimizer.
+  if (gradient)
+    *gradient = -2 * coordinates * (*gradient);
+
+  return result;
+}
+
+template<typename MetricType>
+void SoftmaxErrorFunction<MetricType>::SearchNeighbors(
+    const arma::mat& coordinates)
+{
+  stretchedDataset = coordinates * dataset;
+
+  neighbor::KNN knn(stretchedDataset);
+  arma::Mat<size_t> found;
+  arma::mat distances;
+  knn.Search(std::min(numNeighbors, (size_t) dataset.n_cols - 1), found,
+      distances);
+
+  neighbors = arma::conv_to<arma::umat>::from(found);
+  pointsSinceSearch = 0;
+}
+
 template<typename MetricType>
 const arma::mat SoftmaxErrorFunction<MetricType>::GetInitialPoint() const
 {
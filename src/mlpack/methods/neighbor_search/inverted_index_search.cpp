@@ -0,0 +1,377 @@
+/**
+ * @file methods/neighbor_search/inverted_index_search.cpp
+ *
+ * Implementation of the InvertedIndexSearch class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "inverted_index_search.hpp"
+
+#include <queue>
+
+using namespace mlpack;
+using namespace mlpack::neighbor;
+
+namespace {
+
+//! A candidate neighbor: its similarity and its index.
+typedef std::pair<double, size_t> Candidate;
+
+//! Order candidates so that the top of a priority queue is the worst one: a
+//! smaller similarity is worse, and for equal similarities, a larger index.
+struct BetterCandidate
+{
+  bool operator()(const Candidate& a, const Candidate& b) const
+  {
+    return (a.first > b.first) || (a.first == b.first && a.second < b.second);
+  }
+};
+
+typedef std::priority_queue<Candidate, std::vector<Candidate>, BetterCandidate>
+    CandidateQueue;
+
+//! Add the given candidate to the queue of the k best candidates.
+inline void Insert(CandidateQueue& queue,
+                   const size_t k,
+                   const double similarity,
+                   const size_t index)
+{
+  if (queue.size() < k)
+    queue.push(Candidate(similarity, index));
+  else if (BetterCandidate()(Candidate(similarity, index), queue.top()))
+  {
+    queue.pop();
+    queue.push(Candidate(similarity, index));
+  }
+}
+
+//! The position of a query in the postings of one of its dimensions.
+struct Cursor
+{
+  //! Value of the query in the dimension.
+  double value;
+  //! Largest contribution of the dimension to a similarity.
+  double bound;
+  //! Current and end position in the postings.
+  size_t position;
+  size_t end;
+};
+
+} // namespace
+
+InvertedIndexSearch::InvertedIndexSearch(const arma::sp_mat& referenceSet,
+                                         const bool normalize,
+                                         const double approximation) :
+    normalize(normalize),
+    approximation(approximation),
+    numPoints(0),
+    nonNegative(true)
+{
+  Train(referenceSet);
+}
+
+InvertedIndexSearch::InvertedIndexSearch(const bool normalize,
+                                         const double approximation) :
+    normalize(normalize),
+    approximation(approximation),
+    numPoints(0),
+    nonNegative(true)
+{
+  // Nothing to do.
+}
+
+void InvertedIndexSearch::Train(const arma::sp_mat& referenceSet)
+{
+  if (referenceSet.n_cols == 0)
+  {
+    throw std::invalid_argument("InvertedIndexSearch::Train(): the reference "
+        "set is empty!");
+  }
+
+  referenceSet.sync();
+  const arma::uword* colPtrs = referenceSet.col_ptrs;
+  const arma::uword* rowIndices = referenceSet.row_indices;
+  const double* referenceValues = referenceSet.values;
+
+  // Count the postings of each dimension.
+  offsets.zeros(referenceSet.n_rows + 1);
+  for (size_t i = 0; i < referenceSet.n_nonzero; ++i)
+    ++offsets[rowIndices[i] + 1];
+  offsets = arma::cumsum(offsets);
+
+  // The points are visited in order, so the postings of each dimension are
+  // sorted by point.
+  arma::Col<size_t> next = offsets.subvec(0, referenceSet.n_rows - 1);
+  postings.set_size(referenceSet.n_nonzero);
+  values.set_size(referenceSet.n_nonzero);
+  maxValues.zeros(referenceSet.n_rows);
+  nonNegative = true;
+  for (size_t c = 0; c < referenceSet.n_cols; ++c)
+  {
+    double norm = 1.0;
+    if (normalize)
+    {
+      double sum = 0.0;
+      for (size_t i = colPtrs[c]; i < colPtrs[c + 1]; ++i)
+        sum += referenceValues[i] * referenceValues[i];
+      if (sum > 0.0)
+        norm = std::sqrt(sum);
+    }
+
+    for (size_t i = colPtrs[c]; i < colPtrs[c + 1]; ++i)
+    {
+      const size_t d = rowIndices[i];
+      const size_t position = next[d]++;
+      postings[position] = c;
+      values[position] = referenceValues[i] / norm;
+      maxValues[d] = std::max(maxValues[d], values[position]);
+      if (values[position] < 0.0)
+        nonNegative = false;
+    }
+  }
+
+  numPoints = referenceSet.n_cols;
+}
+
+void InvertedIndexSearch::Search(const arma::sp_mat& querySet,
+                                 const size_t k,
+                                 arma::Mat<size_t>& neighbors,
+                                 arma::mat& similarities) const
+{
+  SearchAll(querySet, k, false, neighbors, similarities);
+}
+
+void InvertedIndexSearch::Search(const size_t k,
+                                 arma::Mat<size_t>& neighbors,
+                                 arma::mat& similarities) const
+{
+  // Recover the (normalized) reference points from the postings.
+  arma::umat locations(2, postings.n_elem);
+  for (size_t d = 0; d + 1 < offsets.n_elem; ++d)
+  {
+    for (size_t i = offsets[d]; i < offsets[d + 1]; ++i)
+    {
+      locations(0, i) = d;
+      locations(1, i) = postings[i];
+    }
+  }
+  const arma::sp_mat referenceSet(locations, values, maxValues.n_elem,
+      numPoints);
+
+  SearchAll(referenceSet, k, true, neighbors, similarities);
+}
+
+void InvertedIndexSearch::SearchAll(const arma::sp_mat& querySet,
+                                    const size_t k,
+                                    const bool monochromatic,
+                                    arma::Mat<size_t>& neighbors,
+                                    arma::mat& similarities) const
+{
+  if (numPoints == 0)
+  {
+    throw std::invalid_argument("InvertedIndexSearch::Search(): the model is "
+        "not trained!");
+  }
+  if (querySet.n_rows != maxValues.n_elem)
+  {
+    std::ostringstream oss;
+    oss << "InvertedIndexSearch::Search(): dimensionality of query set ("
+        << querySet.n_rows << ") is not equal to the dimensionality the model "
+        << "was trained on (" << maxValues.n_elem << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+  const size_t candidates = monochromatic ? numPoints - 1 : numPoints;
+  if (k > candidates)
+  {
+    std::ostringstream oss;
+    oss << "InvertedIndexSearch::Search(): requested " << k << " neighbors, "
+        << "but the reference set has only " << candidates << " candidate "
+        << "points!";
+    throw std::invalid_argument(oss.str());
+  }
+  if (k == 0)
+  {
+    throw std::invalid_argument("InvertedIndexSearch::Search(): the number of "
+        "neighbors must be positive!");
+  }
+  if (approximation < 1.0)
+  {
+    throw std::invalid_argument("InvertedIndexSearch::Search(): the "
+        "approximation factor must be at least 1!");
+  }
+
+  querySet.sync();
+  neighbors.set_size(k, querySet.n_cols);
+  similarities.set_size(k, querySet.n_cols);
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t q = 0; q < (omp_size_t) querySet.n_cols; ++q)
+  {
+    SearchPoint(querySet, q, k, monochromatic ? (size_t) q : numPoints,
+        neighbors, similarities);
+  }
+}
+
+void InvertedIndexSearch::SearchPoint(const arma::sp_mat& querySet,
+                                      const size_t queryIndex,
+                                      const size_t k,
+                                      const size_t skip,
+                                      arma::Mat<size_t>& neighbors,
+                                      arma::mat& similarities) const
+{
+  const size_t begin = querySet.col_ptrs[queryIndex];
+  const size_t end = querySet.col_ptrs[queryIndex + 1];
+  const arma::uword* rowIndices = querySet.row_indices;
+  const double* queryValues = querySet.values;
+
+  double norm = 1.0;
+  bool queryNonNegative = true;
+  for (size_t i = begin; i < end; ++i)
+  {
+    if (queryValues[i] < 0.0)
+      queryNonNegative = false;
+  }
+  if (normalize)
+  {
+    double sum = 0.0;
+    for (size_t i = begin; i < end; ++i)
+      sum += queryValues[i] * queryValues[i];
+    if (sum > 0.0)
+      norm = std::sqrt(sum);
+  }
+
+  CandidateQueue queue;
+  if (nonNegative && queryNonNegative)
+  {
+    std::vector<Cursor> cursors;
+    for (size_t i = begin; i < end; ++i)
+    {
+      const size_t d = rowIndices[i];
+      if (offsets[d] == offsets[d + 1])
+        continue;
+
+      Cursor cursor;
+      cursor.value = queryValues[i] / norm;
+      cursor.bound = cursor.value * maxValues[d];
+      cursor.position = offsets[d];
+      cursor.end = offsets[d + 1];
+      cursors.push_back(cursor);
+    }
+
+    // The point of the current posting of a cursor, or numPoints if the
+    // postings are exhausted.
+    auto point = [this](const Cursor& c)
+    {
+      return (c.position < c.end) ? postings[c.position] : numPoints;
+    };
+    auto before = [&point](const Cursor& a, const Cursor& b)
+    {
+      return point(a) < point(b);
+    };
+
+    while (true)
+    {
+      std::sort(cursors.begin(), cursors.end(), before);
+
+      // Find the pivot: the first cursor at which the sum of the bounds of the
+      // cursors up to it can beat the threshold.  No point before the point of
+      // the pivot can.
+      const double threshold = (queue.size() < k) ?
+          -std::numeric_limits<double>::infinity() :
+          queue.top().first * approximation;
+      double bound = 0.0;
+      size_t pivot = cursors.size();
+      for (size_t i = 0; i < cursors.size(); ++i)
+      {
+        if (point(cursors[i]) == numPoints)
+          break;
+        bound += cursors[i].bound;
+        if (bound > threshold)
+        {
+          pivot = i;
+          break;
+        }
+      }
+      if (pivot == cursors.size())
+        break;
+
+      const size_t pivotPoint = point(cursors[pivot]);
+      if (point(cursors[0]) == pivotPoint)
+      {
+        // All the cursors up to the pivot are at its point: score it.
+        double similarity = 0.0;
+        for (size_t i = 0; i < cursors.size() &&
+            point(cursors[i]) == pivotPoint; ++i)
+        {
+          similarity += cursors[i].value * values[cursors[i].position];
+          ++cursors[i].position;
+        }
+        if (pivotPoint != skip)
+          Insert(queue, k, similarity, pivotPoint);
+      }
+      else
+      {
+        // Skip the cursors before the pivot to its point.
+        for (size_t i = 0; i < pivot; ++i)
+        {
+          cursors[i].position = std::lower_bound(
+              postings.memptr() + cursors[i].position,
+              postings.memptr() + cursors[i].end, pivotPoint) -
+              postings.memptr();
+        }
+      }
+    }
+
+    // Fill in the points that share no dimension with the query.  While the
+    // queue isn't full, every scored point is inserted, so they are the only
+    // points left out.
+    if (queue.size() < k)
+    {
+      std::vector<bool> found(numPoints, false);
+      std::vector<Candidate> kept;
+      while (!queue.empty())
+      {
+        found[queue.top().second] = true;
+        kept.push_back(queue.top());
+        queue.pop();
+      }
+      for (size_t i = 0; i < kept.size(); ++i)
+        queue.push(kept[i]);
+      for (size_t i = 0; i < numPoints && queue.size() < k; ++i)
+      {
+        if (!found[i] && i != skip)
+          queue.push(Candidate(0.0, i));
+      }
+    }
+  }
+  else
+  {
+    // With negative values, the bounds don't hold, so accumulate all the
+    // postings of the query dimensions.
+    arma::vec scores(numPoints, arma::fill::zeros);
+    for (size_t i = begin; i < end; ++i)
+    {
+      const size_t d = rowIndices[i];
+      const double value = queryValues[i] / norm;
+      for (size_t j = offsets[d]; j < offsets[d + 1]; ++j)
+        scores[postings[j]] += value * values[j];
+    }
+
+    for (size_t i = 0; i < numPoints; ++i)
+    {
+      if (i != skip)
+        Insert(queue, k, scores[i], i);
+    }
+  }
+
+  // The queue holds the worst candidate on top.
+  for (size_t i = k; i > 0; --i)
+  {
+    neighbors(i - 1, queryIndex) = queue.top().second;
+    similarities(i - 1, queryIndex) = queue.top().first;
+    queue.pop();
+  }
+}
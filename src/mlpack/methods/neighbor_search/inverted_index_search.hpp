@@ -0,0 +1,190 @@
+/**
+ * @file methods/neighbor_search/inverted_index_search.hpp
+ *
+ * Defines the InvertedIndexSearch class, which finds the reference points with
+ * the largest cosine similarity (or inner product) to sparse query points with
+ * an inverted index.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_INVERTED_INDEX_SEARCH_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_INVERTED_INDEX_SEARCH_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace neighbor {
+
+/**
+ * The InvertedIndexSearch class computes, for sparse query points (such as
+ * TF-IDF vectors of documents), the k reference points with the largest cosine
+ * similarity or inner product.  Trees don't help with such data, which has many
+ * dimensions but few nonzero values per point; instead, the reference set is
+ * stored as an inverted index: for each dimension, the list of the reference
+ * points that have a nonzero value in it (its postings), sorted by point.  A
+ * query then only visits the postings of its own nonzero dimensions.
+ *
+ * When the reference and query values are nonnegative, the postings are
+ * traversed point by point with the WAND algorithm: the largest value of each
+ * dimension bounds the contribution of the dimension, and the points whose
+ * bound can't beat the k-th best score so far are skipped without being scored.
+ * The search is exact, unless an approximation factor larger than 1 is given,
+ * in which case only the points whose bound is larger than the factor times the
+ * k-th best score are scored.  With negative values, every posting of the query
+ * dimensions is accumulated.  In both cases, the query points are searched in
+ * parallel when OpenMP is available.
+ *
+ * @code
+ * arma::sp_mat documents, queries; // TF-IDF vectors, one per column.
+ * InvertedIndexSearch search(documents);
+ * arma::Mat<size_t> neighbors;
+ * arma::mat similarities;
+ * search.Search(queries, 10, neighbors, similarities);
+ * @endcode
+ */
+class InvertedIndexSearch
+{
+ public:
+  /**
+   * Build the inverted index of the given reference set.
+   *
+   * @param referenceSet Set of reference points.
+   * @param normalize If true, the similarity is the cosine similarity (the
+   *     points are normalized); otherwise, it is the inner product.
+   * @param approximation Approximation factor of the search (at least 1; 1
+   *     gives exact results).
+   */
+  InvertedIndexSearch(const arma::sp_mat& referenceSet,
+                      const bool normalize = true,
+                      const double approximation = 1.0);
+
+  /**
+   * Create an untrained model.  Be sure to call Train() before calling
+   * Search(); otherwise, an exception will be thrown when Search() is called.
+   *
+   * @param normalize If true, the similarity is the cosine similarity (the
+   *     points are normalized); otherwise, it is the inner product.
+   * @param approximation Approximation factor of the search (at least 1; 1
+   *     gives exact results).
+   */
+  InvertedIndexSearch(const bool normalize = true,
+                      const double approximation = 1.0);
+
+  /**
+   * Build the inverted index of the given reference set, replacing the current
+   * model.
+   *
+   * @param referenceSet Set of reference points.
+   */
+  void Train(const arma::sp_mat& referenceSet);
+
+  /**
+   * Compute the k reference points with the largest similarity to each point
+   * of the given query set, in decreasing order of similarity.  The matrices
+   * will be set to k rows and one column per query point.  If fewer than k
+   * reference points share a nonzero dimension with a query point, the others
+   * are filled in with similarity 0, in increasing order of index.
+   *
+   * @param querySet Set of query points.
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix storing lists of neighbors for each query point.
+   * @param similarities Matrix storing similarities of neighbors for each query
+   *     point.
+   */
+  void Search(const arma::sp_mat& querySet,
+              const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& similarities) const;
+
+  /**
+   * Compute the k reference points with the largest similarity to each point
+   * of the reference set itself, the point excluded, in decreasing order of
+   * similarity.  The reference points are recovered from the inverted index.
+   *
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix storing lists of neighbors for each point.
+   * @param similarities Matrix storing similarities of neighbors for each
+   *     point.
+   */
+  void Search(const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& similarities) const;
+
+  /**
+   * Serialize the model.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(normalize);
+    ar & BOOST_SERIALIZATION_NVP(approximation);
+    ar & BOOST_SERIALIZATION_NVP(numPoints);
+    ar & BOOST_SERIALIZATION_NVP(nonNegative);
+    ar & BOOST_SERIALIZATION_NVP(offsets);
+    ar & BOOST_SERIALIZATION_NVP(postings);
+    ar & BOOST_SERIALIZATION_NVP(values);
+    ar & BOOST_SERIALIZATION_NVP(maxValues);
+  }
+
+  //! Get the dimensionality of the reference points.
+  size_t Dimensionality() const { return maxValues.n_elem; }
+
+  //! Get the number of reference points.
+  size_t NumPoints() const { return numPoints; }
+
+  //! Get the number of nonzero values of the reference set.
+  size_t NumNonZero() const { return postings.n_elem; }
+
+  //! Get whether the similarity is the cosine similarity.
+  bool Normalize() const { return normalize; }
+
+  //! Get the approximation factor of the search.
+  double Approximation() const { return approximation; }
+  //! Modify the approximation factor of the search (at least 1).
+  double& Approximation() { return approximation; }
+
+ private:
+  //! Search the given query point (the given column of the query set), and
+  //! store its k neighbors in the given columns; the reference point `skip`
+  //! is excluded.
+  void SearchPoint(const arma::sp_mat& querySet,
+                   const size_t queryIndex,
+                   const size_t k,
+                   const size_t skip,
+                   arma::Mat<size_t>& neighbors,
+                   arma::mat& similarities) const;
+
+  //! Search all the points of the given query set, excluding the reference
+  //! point with the same index if `monochromatic` is true.
+  void SearchAll(const arma::sp_mat& querySet,
+                 const size_t k,
+                 const bool monochromatic,
+                 arma::Mat<size_t>& neighbors,
+                 arma::mat& similarities) const;
+
+  //! Whether the points are normalized.
+  bool normalize;
+  //! The approximation factor of the search.
+  double approximation;
+  //! The number of reference points.
+  size_t numPoints;
+  //! Whether all the values of the reference set are nonnegative.
+  bool nonNegative;
+  //! The postings of dimension d are postings[offsets[d]] to
+  //! postings[offsets[d + 1] - 1].
+  arma::Col<size_t> offsets;
+  //! The reference point of each posting.
+  arma::Col<size_t> postings;
+  //! The (normalized) value of each posting.
+  arma::vec values;
+  //! The largest value of each dimension.
+  arma::vec maxValues;
+}; // class InvertedIndexSearch
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
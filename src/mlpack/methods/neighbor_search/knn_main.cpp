@@ -12,6 +12,7 @@
  */
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/util/cli.hpp>
+#include <mlpack/core/util/profiler.hpp>
 #include <mlpack/core/metrics/lmetric.hpp>
 #include <mlpack/core/tree/cover_tree.hpp>
 #include <mlpack/core/util/mlpack_main.hpp>
@@ -23,6 +24,7 @@
 #include "neighbor_search.hpp"
 #include "unmap.hpp"
 #include "ns_model.hpp"
+#include "inverted_index_search.hpp"
 
 using namespace std;
 using namespace mlpack;
@@ -89,6 +91,9 @@ PARAM_MODEL_OUT(KNNModel, "output_model", "If specified, the kNN model will be "
 // The user may specify a query file of query points and a number of nearest
 // neighbors to search for.
 PARAM_MATRIX_IN("query", "Matrix containing query points (optional).", "q");
+// The neighbors of each query point are found on their own, so the query set
+// can be streamed (with an input model, so the tree is built only once).
+BINDING_STREAMING_INPUT("query");
 PARAM_INT_IN("k", "Number of nearest neighbors to find.", "k", 0);
 
 // The user may specify the type of tree to use, and a few parameters for tree
@@ -111,9 +116,26 @@ PARAM_INT_IN("seed", "Random seed (if 0, std::time(NULL) is used).", "s", 0);
 
 // Search settings.
 PARAM_STRING_IN("algorithm", "Type of neighbor search: 'naive', 'single_tree', "
-    "'dual_tree', 'greedy'.", "a", "dual_tree");
+    "'dual_tree', 'greedy', 'brute_force', 'inverted_index'.  'brute_force' "
+    "computes all distances in blocks with matrix multiplications, which is "
+    "usually fastest for high-dimensional data.  'inverted_index' finds the "
+    "neighbors with the largest cosine similarity instead, with an inverted "
+    "index over the nonzero values of the reference points, which is fastest "
+    "for sparse data such as TF-IDF vectors; the distances are then cosine "
+    "distances (one minus the cosine similarity), and models can't be loaded "
+    "or saved.", "a", "dual_tree");
 PARAM_DOUBLE_IN("epsilon", "If specified, will do approximate nearest neighbor "
-    "search with given relative error.", "e", 0);
+    "search with given relative error (for 'inverted_index', the points whose "
+    "similarity can't exceed (1 + epsilon) times the k'th best similarity so "
+    "far are skipped).", "e", 0);
+PARAM_INT_IN("max_base_cases", "If specified, the search for each query point "
+    "stops after this many distance evaluations (base cases), and the best "
+    "neighbors found so far are returned.  Only valid for 'single_tree' and "
+    "'dual_tree' search; must be at least k.", "", 0);
+PARAM_STRING_IN("profile_file", "If specified, profile tree building and the "
+    "search, and save the time spent in each phase and the number of base "
+    "cases, scores, and prunes to this file in the Chrome trace format.", "",
+    "");
 
 static void mlpackMain()
 {
@@ -122,6 +144,9 @@ static void mlpackMain()
   else
     math::RandomSeed((size_t) std::time(NULL));
 
+  if (CLI::HasParam("profile_file"))
+    Profiler::Enable();
+
   // A user cannot specify both reference data and a model.
   RequireOnlyOnePassed({ "reference", "input_model" }, true);
 
@@ -181,12 +206,18 @@ static void mlpackMain()
   RequireParamValue<double>("epsilon", [](double x) { return x >= 0.0; }, true,
       "epsilon must be positive");
 
+  // Sanity check on the maximum number of base cases.
+  RequireParamValue<int>("max_base_cases", [](int x) { return x >= 0; }, true,
+      "maximum number of base cases must be non-negative");
+  const size_t maxBaseCases = (size_t) CLI::GetParam<int>("max_base_cases");
+
   // We either have to load the reference data, or we have to load the model.
   KNNModel* knn;
 
   const string algorithm = CLI::GetParam<string>("algorithm");
   RequireParamInSet<string>("algorithm", { "naive", "single_tree", "dual_tree",
-      "greedy" }, true, "unknown neighbor search algorithm");
+      "greedy", "brute_force", "inverted_index" }, true,
+      "unknown neighbor search algorithm");
   NeighborSearchMode searchMode = DUAL_TREE_MODE;
 
   if (algorithm == "naive")
@@ -197,6 +228,89 @@ static void mlpackMain()
     searchMode = DUAL_TREE_MODE;
   else if (algorithm == "greedy")
     searchMode = GREEDY_SINGLE_TREE_MODE;
+  else if (algorithm == "brute_force")
+    searchMode = BRUTE_FORCE_MODE;
+
+  // The inverted index isn't a tree, so it is used on its own, without a kNN
+  // model.  The bindings only load dense matrices, which are converted.
+  if (algorithm == "inverted_index")
+  {
+    if (CLI::HasParam("input_model") || CLI::HasParam("output_model"))
+    {
+      Log::Fatal << "Models can't be loaded or saved with the 'inverted_index' "
+          << "algorithm." << endl;
+    }
+    ReportIgnoredParam("tree_type", "the inverted index doesn't use trees");
+    ReportIgnoredParam("leaf_size", "the inverted index doesn't use trees");
+    ReportIgnoredParam("random_basis", "the inverted index doesn't use trees");
+    ReportIgnoredParam("max_base_cases", "the inverted index doesn't use "
+        "trees");
+    if (!CLI::HasParam("k"))
+      return;
+
+    const size_t k = (size_t) CLI::GetParam<int>("k");
+    const arma::sp_mat referenceSet(CLI::GetParam<arma::mat>("reference"));
+    const size_t candidates = CLI::HasParam("query") ? referenceSet.n_cols :
+        referenceSet.n_cols - 1;
+    if (k == 0 || k > candidates)
+    {
+      Log::Fatal << "Invalid k: " << k << "; must be greater than 0 and less "
+          << "than or equal to " << candidates << "." << endl;
+    }
+
+    InvertedIndexSearch search(referenceSet, true, 1.0 + epsilon);
+    Log::Info << "Built an inverted index of " << search.NumNonZero()
+        << " nonzero values." << endl;
+
+    arma::Mat<size_t> neighbors;
+    arma::mat similarities;
+    if (CLI::HasParam("query"))
+    {
+      const arma::sp_mat querySet(CLI::GetParam<arma::mat>("query"));
+      if (querySet.n_rows != referenceSet.n_rows)
+      {
+        Log::Fatal << "Query has invalid dimensions(" << querySet.n_rows
+            << "); should be " << referenceSet.n_rows << "!" << endl;
+      }
+      search.Search(querySet, k, neighbors, similarities);
+    }
+    else
+    {
+      search.Search(k, neighbors, similarities);
+    }
+    Log::Info << "Search complete." << endl;
+
+    arma::mat distances = 1.0 - similarities;
+    if (CLI::HasParam("true_distances"))
+    {
+      arma::mat& trueDistances =
+          CLI::GetParam<arma::mat>("true_distances");
+      if (trueDistances.n_rows != distances.n_rows ||
+          trueDistances.n_cols != distances.n_cols)
+      {
+        Log::Fatal << "The true distances file must have the same number of "
+            << "values than the set of distances being queried!" << endl;
+      }
+      Log::Info << "Effective error: " << KNN::EffectiveError(distances,
+          trueDistances) << endl;
+    }
+    if (CLI::HasParam("true_neighbors"))
+    {
+      arma::Mat<size_t>& trueNeighbors =
+          CLI::GetParam<arma::Mat<size_t>>("true_neighbors");
+      if (trueNeighbors.n_rows != neighbors.n_rows ||
+          trueNeighbors.n_cols != neighbors.n_cols)
+      {
+        Log::Fatal << "The true neighbors file must have the same number of "
+            << "values than the set of neighbors being queried!" << endl;
+      }
+      Log::Info << "Recall: " << KNN::Recall(neighbors, trueNeighbors) << endl;
+    }
+
+    CLI::GetParam<arma::Mat<size_t>>("neighbors") = std::move(neighbors);
+    CLI::GetParam<arma::mat>("distances") = std::move(distances);
+    return;
+  }
 
   if (CLI::HasParam("reference"))
   {
@@ -255,6 +369,7 @@ static void mlpackMain()
 
     knn->BuildModel(std::move(referenceSet), size_t(lsInt), searchMode,
         epsilon);
+    knn->MaxBaseCases() = maxBaseCases;
   }
   else
   {
@@ -264,6 +379,7 @@ static void mlpackMain()
     // Adjust search mode.
     knn->SearchMode() = searchMode;
     knn->Epsilon() = epsilon;
+    knn->MaxBaseCases() = maxBaseCases;
 
     // If leaf_size wasn't provided, let's consider the current value in the
     // loaded model.  Else, update it (only considered when building the query
@@ -326,6 +442,16 @@ static void mlpackMain()
           << "not been provided." << endl;
     }
 
+    // Sanity check on the maximum number of base cases: each query point must
+    // be able to get k candidates.
+    if (maxBaseCases > 0 && maxBaseCases < k)
+    {
+      if (CLI::HasParam("reference"))
+        delete knn;
+      Log::Fatal << "Invalid max_base_cases: " << maxBaseCases << "; must be "
+          << "0 or at least k (" << k << ")." << endl;
+    }
+
     // Now run the search.
     arma::Mat<size_t> neighbors;
     arma::mat distances;
@@ -336,6 +462,24 @@ static void mlpackMain()
       knn->Search(k, neighbors, distances);
     Log::Info << "Search complete." << endl;
 
+    if (CLI::HasParam("profile_file"))
+    {
+      const string profileFile = CLI::GetParam<string>("profile_file");
+      ofstream profileStream(profileFile);
+      if (!profileStream.is_open())
+      {
+        Log::Warn << "Could not open " << PRINT_PARAM_STRING("profile_file")
+            << " '" << profileFile << "' for writing!" << endl;
+      }
+      else
+      {
+        Profiler::ExportChromeTrace(profileStream);
+      }
+
+      Profiler::Disable();
+      Profiler::Reset();
+    }
+
     // Calculate the effective error, if desired.
     if (CLI::HasParam("true_distances"))
     {
@@ -0,0 +1,174 @@
+/**
+ * @file methods/neighbor_search/local_shard_transport.hpp
+ *
+ * Defines the LocalShardTransport class, the transport of
+ * ShardedNeighborSearch for shards held in the process itself.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_LOCAL_SHARD_TRANSPORT_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_LOCAL_SHARD_TRANSPORT_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/tree/hrectbound.hpp>
+
+#include "neighbor_search.hpp"
+
+namespace mlpack {
+namespace neighbor {
+
+/**
+ * A transport for ShardedNeighborSearch whose shards are held in the process
+ * itself, each one with its own NeighborSearch object (and so its own tree);
+ * the shards of a request are searched in parallel with OpenMP.  This is the
+ * reference implementation of the transport interface (see
+ * ShardedNeighborSearch): a transport to other processes implements the same
+ * methods by sending each shard its queries and waiting for the answers.
+ *
+ * @tparam MetricType The metric to use for the search; it must be an LMetric,
+ *     for the bounds of the shards.
+ * @tparam MatType The type of the data.
+ * @tparam TreeType The type of tree built on each shard.
+ */
+template<
+    typename MetricType = metric::EuclideanDistance,
+    typename MatType = arma::mat,
+    template<typename TreeMetricType,
+             typename TreeStatType,
+             typename TreeMatType> class TreeType = tree::KDTree
+>
+class LocalShardTransport
+{
+ public:
+  //! The type of the data.
+  typedef MatType DataType;
+  //! The type of the bounds of the shards.
+  typedef bound::HRectBound<MetricType, typename MatType::elem_type> BoundType;
+  //! The type of the search of each shard.
+  typedef NeighborSearch<NearestNeighborSort, MetricType, MatType, TreeType>
+      ShardSearchType;
+
+  //! Create a transport without shards.
+  LocalShardTransport() : numPoints(0) { }
+
+  /**
+   * Split the given reference set into the given number of shards of
+   * contiguous points (of nearly equal size), and build the tree of each.
+   *
+   * @param referenceSet Set of reference points.
+   * @param numShards The number of shards.
+   */
+  LocalShardTransport(const MatType& referenceSet, const size_t numShards) :
+      numPoints(0)
+  {
+    if (numShards == 0 || numShards > referenceSet.n_cols)
+    {
+      throw std::invalid_argument("LocalShardTransport: the number of shards "
+          "must be between 1 and the number of reference points!");
+    }
+
+    for (size_t s = 0; s < numShards; ++s)
+    {
+      const size_t first = s * referenceSet.n_cols / numShards;
+      const size_t last = (s + 1) * referenceSet.n_cols / numShards - 1;
+      AddShard(referenceSet.cols(first, last));
+    }
+  }
+
+  /**
+   * Add a shard with the given points; their indices follow those of the
+   * previous shards.  In order to avoid copying the points, consider passing
+   * them with std::move().
+   *
+   * @param shardSet The points of the shard.
+   */
+  void AddShard(MatType shardSet)
+  {
+    if (shardSet.n_cols == 0)
+      throw std::invalid_argument("LocalShardTransport::AddShard(): empty "
+          "shard!");
+
+    BoundType bound(shardSet.n_rows);
+    bound |= shardSet;
+    bounds.push_back(bound);
+    offsets.push_back(numPoints);
+    numPoints += shardSet.n_cols;
+    searches.emplace_back(std::move(shardSet));
+  }
+
+  //! Get the number of shards.
+  size_t NumShards() const { return searches.size(); }
+
+  //! Get the total number of reference points.
+  size_t NumPoints() const { return numPoints; }
+
+  //! Get the bound of the points of the given shard.
+  const BoundType& Bound(const size_t shard) const { return bounds[shard]; }
+
+  //! Get the index of the first point of the given shard.
+  size_t Offset(const size_t shard) const { return offsets[shard]; }
+
+  //! Get the search of the given shard.
+  ShardSearchType& ShardSearch(const size_t shard) { return searches[shard]; }
+
+  /**
+   * Search each shard for the k nearest neighbors of its queries (a shard
+   * without queries is not contacted).  The neighbors are global indices; if
+   * a shard has fewer than k points, the remaining neighbors are SIZE_MAX and
+   * their distances DBL_MAX.
+   *
+   * @param queries The queries of each shard.
+   * @param k The number of neighbors to search for.
+   * @param neighbors The neighbors found by each shard.
+   * @param distances The distances of the neighbors found by each shard.
+   */
+  void Search(const std::vector<MatType>& queries,
+              const size_t k,
+              std::vector<arma::Mat<size_t>>& neighbors,
+              std::vector<arma::mat>& distances)
+  {
+    neighbors.resize(searches.size());
+    distances.resize(searches.size());
+
+    #pragma omp parallel for schedule(dynamic)
+    for (omp_size_t s = 0; s < (omp_size_t) searches.size(); ++s)
+    {
+      neighbors[s].set_size(k, queries[s].n_cols);
+      distances[s].set_size(k, queries[s].n_cols);
+      if (queries[s].n_cols == 0)
+        continue;
+
+      const size_t shardK = std::min(k,
+          (size_t) searches[s].ReferenceSet().n_cols);
+      arma::Mat<size_t> shardNeighbors;
+      arma::mat shardDistances;
+      searches[s].Search(queries[s], shardK, shardNeighbors, shardDistances);
+
+      neighbors[s].fill(SIZE_MAX);
+      distances[s].fill(DBL_MAX);
+      neighbors[s].rows(0, shardK - 1) = shardNeighbors + offsets[s];
+      distances[s].rows(0, shardK - 1) = shardDistances;
+    }
+  }
+
+ private:
+  //! The search of each shard.
+  std::vector<ShardSearchType> searches;
+
+  //! The bound of each shard.
+  std::vector<BoundType> bounds;
+
+  //! The index of the first point of each shard.
+  std::vector<size_t> offsets;
+
+  //! The total number of reference points.
+  size_t numPoints;
+};
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
@@ -20,19 +20,24 @@
 #include <mlpack/core/tree/binary_space_tree.hpp>
 #include <mlpack/core/tree/rectangle_tree.hpp>
 #include <mlpack/core/tree/binary_space_tree/binary_space_tree.hpp>
+#include <mlpack/core/tree/is_dynamic_tree.hpp>
+#include <mlpack/core/tree/traversal_statistics.hpp>
 
 #include "neighbor_search_stat.hpp"
 #include "sort_policies/nearest_neighbor_sort.hpp"
 #include "neighbor_search_rules.hpp"
+#include "pending_updates.hpp"
 
 namespace mlpack {
 // Neighbor-search routines. These include all-nearest-neighbors and
 // all-furthest-neighbors searches.
 namespace neighbor  {
 
-// Forward declaration.
-template<typename SortPolicy>
+// Forward declarations.
+template<typename SortPolicy, typename MatType>
 class TrainVisitor;
+template<typename SortPolicy, typename MatType>
+class LoadFlatVisitor;
 
 //! NeighborSearchMode represents the different neighbor search modes available.
 enum NeighborSearchMode
@@ -40,9 +45,19 @@ enum NeighborSearchMode
   NAIVE_MODE,
   SINGLE_TREE_MODE,
   DUAL_TREE_MODE,
-  GREEDY_SINGLE_TREE_MODE
+  GREEDY_SINGLE_TREE_MODE,
+  BRUTE_FORCE_MODE
 };
 
+/**
+ * Return whether the given search mode needs a reference tree.  NAIVE_MODE and
+ * BRUTE_FORCE_MODE only use the reference set.
+ */
+inline bool UsesTree(const NeighborSearchMode mode)
+{
+  return (mode != NAIVE_MODE) && (mode != BRUTE_FORCE_MODE);
+}
+
 /**
  * The NeighborSearch class is a template class for performing distance-based
  * neighbor searches.  It takes a query dataset and a reference dataset (or just
@@ -95,7 +110,10 @@ class NeighborSearch
    *
    * This method will move the matrices to internal copies, which are rearranged
    * during tree-building.  You can avoid creating an extra copy by pre-constructing
-   * the trees, passing std::move(yourReferenceSet).
+   * the trees, passing std::move(yourReferenceSet).  To build the tree directly
+   * over a buffer that you own, pass a matrix that uses its memory (such as
+   * arma::mat(buffer, rows, cols, false, false)): the columns of the buffer are
+   * then permuted in place, and OldFromNewReferences() gives the permutation.
    *
    * @param referenceSet Set of reference points.
    * @param mode Neighbor search mode.
@@ -187,9 +205,11 @@ class NeighborSearch
   /**
    * Set the reference set to a new reference set, and build a tree if
    * necessary. The dataset is copied by default, but the copy can be avoided by
-   * transferring the ownership of the dataset using std::move().  This method
-   * is called 'Train()' in order to match the rest of the mlpack abstractions,
-   * even though calling this "training" is maybe a bit of a stretch.
+   * transferring the ownership of the dataset using std::move().  As with the
+   * constructor, a matrix that uses the memory of a buffer you own can be given
+   * to build the tree over the buffer in place.  This method is called
+   * 'Train()' in order to match the rest of the mlpack abstractions, even
+   * though calling this "training" is maybe a bit of a stretch.
    *
    * @param referenceSet New set of reference data.
    */
@@ -206,6 +226,45 @@ class NeighborSearch
    */
   void Train(Tree referenceTree);
 
+  /**
+   * Add the given points to the reference set.  They are given the indices
+   * n, ..., n + points.n_cols - 1, where n is the number of reference points
+   * before the call.  If the tree type supports dynamic insertion (see
+   * tree::IsDynamicTree; this is the case for the RectangleTree family), the
+   * points are inserted into the existing tree.  If no tree is used, the points
+   * are just appended to the reference set.
+   *
+   * Other tree types (such as kd-trees) can't be updated in place, so the
+   * points are kept in a buffer until the number of pending insertions and
+   * deletions exceeds RebuildThreshold() times the size of the tree; the tree
+   * is then rebuilt on the updated reference set.  Until then, Search() with a
+   * query set searches the tree and the buffer, and the other searches rebuild
+   * the tree first.  ReferenceSet() and ReferenceTree() don't include the
+   * pending updates; call Rebuild() to apply them.
+   *
+   * @param points Points to add to the reference set.
+   */
+  void Insert(const MatType& points);
+
+  /**
+   * Remove the reference point with the given index from the reference set.
+   * To avoid renumbering every point after it, the last reference point takes
+   * the index of the removed point.  As with Insert(), trees that can't be
+   * updated in place are only rebuilt once there are enough pending updates;
+   * until then, the deleted point is only marked as deleted, and searches of
+   * the tree look for one more neighbor for each deleted point.
+   *
+   * @param index Index of the reference point to remove.
+   */
+  void Delete(const size_t index);
+
+  /**
+   * Rebuild the reference tree with the pending insertions and deletions (see
+   * Insert()), if there are any.  As with Train(), the new tree is built with
+   * the default parameters of the tree type.
+   */
+  void Rebuild();
+
   /**
    * For each point in the query set, compute the nearest neighbors and store
    * the output in the given matrices.  The matrices will be set to the size of
@@ -311,6 +370,11 @@ class NeighborSearch
   //! Return the number of node combination scores during the last search.
   size_t Scores() const { return scores; }
 
+  //! Return the statistics of the tree traversals of the last search (base
+  //! cases, scores, prunes by depth, and reference leaf visits).  These are
+  //! empty for naive and brute-force search.
+  const tree::TraversalStatistics& Statistics() const { return statistics; }
+
   //! Access the search mode.
   NeighborSearchMode SearchMode() const { return searchMode; }
   //! Modify the search mode.
@@ -321,6 +385,48 @@ class NeighborSearch
   //! Modify the relative error to be considered in approximate search.
   double& Epsilon() { return epsilon; }
 
+  //! Access the maximum number of base cases for each query point in
+  //! single-tree and dual-tree search (0 means no limit).
+  size_t MaxBaseCases() const { return maxBaseCases; }
+  //! Modify the maximum number of base cases for each query point in
+  //! single-tree and dual-tree search (0 means no limit).  Once a query point
+  //! has had this many base cases, the traversal of the reference tree stops
+  //! for it, and the best candidates found so far are returned; the last leaf
+  //! visited may take it slightly over the limit.  This must be at least k, so
+  //! that k candidates are always found.
+  size_t& MaxBaseCases() { return maxBaseCases; }
+
+  //! Access whether the results of Search() are mapped back to the original
+  //! indices of the points (true by default).
+  bool UnmapResults() const { return unmapResults; }
+  //! Modify whether the results of Search() are mapped back to the original
+  //! indices of the points.  If false, and the tree rearranges the points, the
+  //! neighbors are indices in ReferenceSet() (in the order of the tree), and
+  //! in dual-tree search the columns of the results follow the order of the
+  //! query tree; this saves the temporary result matrices and the mapping.
+  //! Unmap(neighbors, distances, OldFromNewReferences(), OldFromNewQueries(),
+  //! ...) maps the results later.
+  bool& UnmapResults() { return unmapResults; }
+
+  //! Access the original index of each point of ReferenceSet() (empty if the
+  //! tree doesn't rearrange the points).
+  const std::vector<size_t>& OldFromNewReferences() const
+  { return oldFromNewReferences; }
+
+  //! Access the original index of each column of the results of the last
+  //! search, if the columns were rearranged (empty otherwise): the mapping of
+  //! the query tree of a dual-tree search, or the mapping of the reference
+  //! tree for a search of the reference set itself.
+  const std::vector<size_t>& OldFromNewQueries() const
+  { return oldFromNewQueries; }
+
+  //! Get the fraction of the size of the reference tree that the number of
+  //! pending updates must exceed for the tree to be rebuilt (see Insert()).
+  double RebuildThreshold() const { return pending.RebuildThreshold(); }
+  //! Modify the fraction of the size of the reference tree that the number of
+  //! pending updates must exceed for the tree to be rebuilt (see Insert()).
+  double& RebuildThreshold() { return pending.RebuildThreshold(); }
+
   //! Access the reference dataset.
   const MatType& ReferenceSet() const { return *referenceSet; }
 
@@ -336,6 +442,8 @@ class NeighborSearch
  private:
   //! Permutations of reference points during tree building.
   std::vector<size_t> oldFromNewReferences;
+  //! Permutation of the columns of the results of the last search.
+  std::vector<size_t> oldFromNewQueries;
   //! Pointer to the root of the reference tree.
   Tree* referenceTree;
   //! Reference dataset.  In some situations we may be the owner of this.
@@ -345,6 +453,10 @@ class NeighborSearch
   NeighborSearchMode searchMode;
   //! Indicates the relative error to be considered in approximate search.
   double epsilon;
+  //! The maximum number of base cases for each query point (0 means no limit).
+  size_t maxBaseCases;
+  //! If true, the results are mapped back to the original indices.
+  bool unmapResults;
 
   //! Instantiation of metric.
   MetricType metric;
@@ -353,14 +465,148 @@ class NeighborSearch
   size_t baseCases;
   //! The total number of scores (applicable for non-naive search).
   size_t scores;
+  //! The statistics of the tree traversals of the last search.
+  tree::TraversalStatistics statistics;
 
   //! If this is true, the reference tree bounds need to be reset on a call to
   //! Search() without a query set.
   bool treeNeedsReset;
 
+  //! The insertions and deletions that the reference tree doesn't hold yet,
+  //! for trees that can't be updated in place.
+  PendingUpdates<MatType> pending;
+
+  //! Search the reference set with the given query set, ignoring the pending
+  //! updates.
+  void SearchReferenceSet(const MatType& querySet,
+                          const size_t k,
+                          arma::Mat<size_t>& neighbors,
+                          arma::mat& distances);
+
+  /**
+   * Search the reference tree and the pending updates with the given query
+   * set.  The tree is searched for k neighbors plus one for each deleted point
+   * of the tree; the deleted points are then dropped, and the results are
+   * merged with the distances to the inserted points, which are computed
+   * exhaustively.
+   */
+  void SearchPending(const MatType& querySet,
+                     const size_t k,
+                     arma::Mat<size_t>& neighbors,
+                     arma::mat& distances);
+
+  /**
+   * Traverse the given query tree and the reference tree with the given rules
+   * using the dual-tree traverser.  If OpenMP is available, the query tree is
+   * split into disjoint subtrees which are traversed against the reference tree
+   * in parallel.  Each thread uses its own rules object, but all results are
+   * stored in the candidate lists of the given rules object, and the number of
+   * base cases and scores is accumulated into it.
+   *
+   * @param rules Rules to use for the traversal.
+   * @param queryTree Tree built on the query points.
+   */
+  template<typename RuleType>
+  void DualTreeTraverse(RuleType& rules, Tree& queryTree);
+
+  /**
+   * Traverse the reference tree with the given rules for each of the first
+   * numQueries query points using the single-tree traverser.  If OpenMP is
+   * available, the query points are partitioned across threads.  Each thread
+   * uses its own rules object and traverser, but all results are stored in the
+   * candidate lists of the given rules object, and the number of base cases and
+   * scores is accumulated into it.
+   *
+   * @param rules Rules to use for the traversal.
+   * @param numQueries Number of query points to search for.
+   */
+  template<typename RuleType>
+  void SingleTreeTraverse(RuleType& rules, const size_t numQueries);
+
+  /**
+   * Exhaustively compute the k best neighbors of every query point, without
+   * using any tree.  The query and reference sets are split into blocks; for
+   * each pair of blocks, the distances between all of their points are
+   * computed at once (for the Euclidean distance on dense data, with a single
+   * matrix multiplication, using ||q - r||^2 = ||q||^2 + ||r||^2 - 2 q^T r),
+   * and only the k best candidates of each query point are kept.  The
+   * distances of the final neighbors are then computed exactly with the
+   * metric.  If OpenMP is available, query blocks are searched in parallel.
+   *
+   * @param querySet Set of query points.
+   * @param k Number of neighbors to find.
+   * @param neighbors Matrix to store the neighbors in.
+   * @param distances Matrix to store the distances in.
+   * @param sameSet If true, a query point is never returned as its own
+   *     neighbor (the query set must be the reference set).
+   */
+  void BruteForceSearch(const MatType& querySet,
+                        const size_t k,
+                        arma::Mat<size_t>& neighbors,
+                        arma::mat& distances,
+                        const bool sameSet);
+
+  /**
+   * Compute the squared Euclidean distances between the given blocks of query
+   * and reference points with a matrix multiplication.  The squared distance
+   * gives the same neighbors as the (rooted) Euclidean distance.
+   */
+  template<bool TakeRoot, typename AnyMatType = MatType>
+  void BruteForceDistances(
+      const metric::LMetric<2, TakeRoot>& /* metric */,
+      const MatType& querySet,
+      const size_t queryBegin,
+      const size_t queryCount,
+      const size_t referenceBegin,
+      const size_t referenceCount,
+      arma::Mat<typename MatType::elem_type>& block,
+      const typename std::enable_if_t<
+          !arma::is_arma_sparse_type<AnyMatType>::value>* = 0);
+
+  /**
+   * Compute the distances between the given blocks of query and reference
+   * points with the metric, one pair at a time.  This is used for every metric
+   * other than the Euclidean distance, and for sparse data.
+   */
+  template<typename AnyMetricType>
+  void BruteForceDistances(
+      const AnyMetricType& /* metric */,
+      const MatType& querySet,
+      const size_t queryBegin,
+      const size_t queryCount,
+      const size_t referenceBegin,
+      const size_t referenceCount,
+      arma::Mat<typename MatType::elem_type>& block);
+
+  //! Insert points into a tree that supports dynamic insertion.
+  template<typename T = Tree>
+  void InsertIntoTree(
+      const MatType& points,
+      const typename std::enable_if_t<tree::IsDynamicTree<T>::value>* = 0);
+
+  //! Buffer points for a tree that doesn't support dynamic insertion.
+  template<typename T = Tree>
+  void InsertIntoTree(
+      const MatType& points,
+      const typename std::enable_if_t<!tree::IsDynamicTree<T>::value>* = 0);
+
+  //! Delete a point from a tree that supports dynamic deletion.
+  template<typename T = Tree>
+  void DeleteFromTree(
+      const size_t index,
+      const typename std::enable_if_t<tree::IsDynamicTree<T>::value>* = 0);
+
+  //! Mark a point as deleted for a tree that doesn't support dynamic deletion.
+  template<typename T = Tree>
+  void DeleteFromTree(
+      const size_t index,
+      const typename std::enable_if_t<!tree::IsDynamicTree<T>::value>* = 0);
+
   //! The NSModel class should have access to internal members.
-  template<typename SortPol>
+  template<typename SortPol, typename MatT>
   friend class TrainVisitor;
+  template<typename SortPol, typename MatT>
+  friend class LoadFlatVisitor;
 }; // class NeighborSearch
 
 } // namespace neighbor
@@ -15,8 +15,15 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/tree/greedy_single_tree_traverser.hpp>
+#include <mlpack/core/tree/subtree_frontier.hpp>
+#include <mlpack/core/tree/traversal_statistics.hpp>
 #include "neighbor_search_rules.hpp"
 #include <mlpack/core/tree/spill_tree/is_spill_tree.hpp>
+#include <mlpack/core/util/profiler.hpp>
+
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
 
 namespace mlpack {
 namespace neighbor {
@@ -30,6 +37,7 @@ TreeType* BuildTree(
         tree::TreeTraits<TreeType>::RearrangesDataset, TreeType
     >* = 0)
 {
+  ProfileSpan span("tree_building");
   return new TreeType(std::forward<MatType>(dataset), oldFromNew);
 }
 
@@ -42,6 +50,7 @@ TreeType* BuildTree(
         !tree::TreeTraits<TreeType>::RearrangesDataset, TreeType
     >* = 0)
 {
+  ProfileSpan span("tree_building");
   return new TreeType(std::forward<MatType>(dataset));
 }
 
@@ -59,12 +68,14 @@ SingleTreeTraversalType>::NeighborSearch(MatType referenceSetIn,
                                          const NeighborSearchMode mode,
                                          const double epsilon,
                                          const MetricType metric) :
-    referenceTree(mode == NAIVE_MODE ? NULL :
+    referenceTree(!UsesTree(mode) ? NULL :
         BuildTree<Tree>(std::move(referenceSetIn), oldFromNewReferences)),
-    referenceSet(mode == NAIVE_MODE ?  new MatType(std::move(referenceSetIn)) :
+    referenceSet(!UsesTree(mode) ? new MatType(std::move(referenceSetIn)) :
         &referenceTree->Dataset()),
     searchMode(mode),
     epsilon(epsilon),
+    maxBaseCases(0),
+    unmapResults(true),
     metric(metric),
     baseCases(0),
     scores(0),
@@ -92,6 +103,8 @@ SingleTreeTraversalType>::NeighborSearch(Tree referenceTree,
     referenceSet(&this->referenceTree->Dataset()),
     searchMode(mode),
     epsilon(epsilon),
+    maxBaseCases(0),
+    unmapResults(true),
     metric(metric),
     baseCases(0),
     scores(0),
@@ -115,9 +128,11 @@ SingleTreeTraversalType>::NeighborSearch(const NeighborSearchMode mode,
                                          const double epsilon,
                                          const MetricType metric) :
     referenceTree(NULL),
-    referenceSet(mode == NAIVE_MODE ? new MatType() : NULL), // Empty matrix.
+    referenceSet(!UsesTree(mode) ? new MatType() : NULL), // Empty matrix.
     searchMode(mode),
     epsilon(epsilon),
+    maxBaseCases(0),
+    unmapResults(true),
     metric(metric),
     baseCases(0),
     scores(0),
@@ -127,9 +142,9 @@ SingleTreeTraversalType>::NeighborSearch(const NeighborSearchMode mode,
     throw std::invalid_argument("epsilon must be non-negative");
 
   // Build the tree on the empty dataset, if necessary.
-  if (mode != NAIVE_MODE)
+  if (UsesTree(mode))
   {
-    referenceTree = BuildTree<Tree>(std::move(arma::mat()),
+    referenceTree = BuildTree<Tree>(std::move(MatType()),
         oldFromNewReferences);
     referenceSet = &referenceTree->Dataset();
   }
@@ -152,10 +167,14 @@ SingleTreeTraversalType>::NeighborSearch(const NeighborSearch& other) :
         new MatType(*other.referenceSet)),
     searchMode(other.searchMode),
     epsilon(other.epsilon),
+    maxBaseCases(other.maxBaseCases),
+    unmapResults(other.unmapResults),
     metric(other.metric),
     baseCases(other.baseCases),
     scores(other.scores),
-    treeNeedsReset(false)
+    statistics(other.statistics),
+    treeNeedsReset(false),
+    pending(other.pending)
 {
   // Nothing else to do.
 }
@@ -176,10 +195,14 @@ SingleTreeTraversalType>::NeighborSearch(NeighborSearch&& other) :
     referenceSet(other.referenceSet),
     searchMode(other.searchMode),
     epsilon(other.epsilon),
+    maxBaseCases(other.maxBaseCases),
+    unmapResults(other.unmapResults),
     metric(std::move(other.metric)),
     baseCases(other.baseCases),
     scores(other.scores),
-    treeNeedsReset(other.treeNeedsReset)
+    statistics(other.statistics),
+    treeNeedsReset(other.treeNeedsReset),
+    pending(std::move(other.pending))
 {
   // Clear the other model.
   other.referenceTree = BuildTree<Tree>(std::move(MatType()),
@@ -187,9 +210,13 @@ SingleTreeTraversalType>::NeighborSearch(NeighborSearch&& other) :
   other.referenceSet = &other.referenceTree->Dataset();
   other.searchMode = DUAL_TREE_MODE,
   other.epsilon = 0.0;
+  other.maxBaseCases = 0;
+  other.unmapResults = true;
   other.baseCases = 0;
   other.scores = 0;
+  other.statistics.Reset();
   other.treeNeedsReset = false;
+  other.pending.Clear();
 }
 
 // Copy operator.
@@ -229,10 +256,14 @@ NeighborSearch<SortPolicy,
       new MatType(*other.referenceSet);
   searchMode = other.searchMode;
   epsilon = other.epsilon;
+  maxBaseCases = other.maxBaseCases;
+  unmapResults = other.unmapResults;
   metric = other.metric;
   baseCases = other.baseCases;
   scores = other.scores;
+  statistics = other.statistics;
   treeNeedsReset = false;
+  pending = other.pending;
 }
 
 // Move operator.
@@ -271,23 +302,31 @@ NeighborSearch<SortPolicy,
   referenceSet = other.referenceSet;
   searchMode = other.searchMode;
   epsilon = other.epsilon;
+  maxBaseCases = other.maxBaseCases;
+  unmapResults = other.unmapResults;
   metric = other.metric;
   baseCases = other.baseCases;
   scores = other.scores;
+  statistics = other.statistics;
   treeNeedsReset = other.treeNeedsReset;
+  pending = std::move(other.pending);
 
   // Reset the other object.  Clean memory if needed.
   if (!other.referenceTree)
     delete other.referenceSet;
 
-  other.referenceTree = BuildTree<Tree>(std::move(arma::mat()),
+  other.referenceTree = BuildTree<Tree>(std::move(MatType()),
       other.oldFromNewReferences);
   other.referenceSet = &other.referenceTree->Dataset();
   other.searchMode = DUAL_TREE_MODE,
   other.epsilon = 0.0;
+  other.maxBaseCases = 0;
+  other.unmapResults = true;
   other.baseCases = 0;
   other.scores = 0;
+  other.statistics.Reset();
   other.treeNeedsReset = false;
+  other.pending.Clear();
 }
 
 // Clean memory.
@@ -319,6 +358,8 @@ template<typename SortPolicy,
 void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
 DualTreeTraversalType, SingleTreeTraversalType>::Train(MatType referenceSetIn)
 {
+  pending.Clear();
+
   // Clean up the old tree, if we built one.
   if (referenceTree)
   {
@@ -332,7 +373,7 @@ DualTreeTraversalType, SingleTreeTraversalType>::Train(MatType referenceSetIn)
   }
 
   // We may need to rebuild the tree.
-  if (searchMode != NAIVE_MODE)
+  if (UsesTree(searchMode))
   {
     referenceTree = BuildTree<Tree>(std::move(referenceSetIn),
         oldFromNewReferences);
@@ -355,10 +396,11 @@ template<typename SortPolicy,
 void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
 DualTreeTraversalType, SingleTreeTraversalType>::Train(Tree referenceTree)
 {
-  if (searchMode == NAIVE_MODE)
+  if (!UsesTree(searchMode))
     throw std::invalid_argument("cannot train on given reference tree when "
-        "naive search (without trees) is desired");
+        "naive or brute-force search (without trees) is desired");
 
+  pending.Clear();
   if (this->referenceTree)
   {
     oldFromNewReferences.clear();
@@ -373,6 +415,297 @@ DualTreeTraversalType, SingleTreeTraversalType>::Train(Tree referenceTree)
   this->referenceSet = &this->referenceTree->Dataset();
 }
 
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::Insert(const MatType& points)
+{
+  if (referenceSet->n_cols > 0 && points.n_rows != referenceSet->n_rows)
+  {
+    std::stringstream ss;
+    ss << "NeighborSearch::Insert(): dimensionality of points ("
+        << points.n_rows << ") does not match the dimensionality of the "
+        << "reference set (" << referenceSet->n_rows << ")";
+    throw std::invalid_argument(ss.str());
+  }
+
+  if (points.n_cols == 0)
+    return;
+
+  if (!referenceTree)
+  {
+    // We own the reference set, so we can modify it.
+    MatType& data = const_cast<MatType&>(*referenceSet);
+    data.insert_cols(data.n_cols, points);
+    return;
+  }
+
+  InsertIntoTree(points);
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::Delete(const size_t index)
+{
+  const size_t numPoints = pending.Active() ? pending.Size() :
+      referenceSet->n_cols;
+  if (index >= numPoints)
+  {
+    std::stringstream ss;
+    ss << "NeighborSearch::Delete(): index " << index << " is out of range "
+        << "(there are " << numPoints << " reference points)";
+    throw std::invalid_argument(ss.str());
+  }
+
+  if (!referenceTree)
+  {
+    MatType& data = const_cast<MatType&>(*referenceSet);
+    const size_t last = data.n_cols - 1;
+    if (index != last)
+      data.col(index) = data.col(last);
+    data.shed_col(last);
+    return;
+  }
+
+  DeleteFromTree(index);
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+template<typename T>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::InsertIntoTree(
+    const MatType& points,
+    const typename std::enable_if_t<tree::IsDynamicTree<T>::value>*)
+{
+  const size_t oldSize = referenceTree->Dataset().n_cols;
+  referenceTree->Dataset().insert_cols(oldSize, points);
+  for (size_t i = 0; i < points.n_cols; ++i)
+    referenceTree->InsertPoint(oldSize + i);
+
+  // The statistics of the nodes are no longer valid.
+  treeNeedsReset = true;
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+template<typename T>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::InsertIntoTree(
+    const MatType& points,
+    const typename std::enable_if_t<!tree::IsDynamicTree<T>::value>*)
+{
+  // The tree can't be updated in place, so the points wait in a buffer until
+  // there are enough pending updates to rebuild the tree.
+  pending.Start(referenceSet->n_cols);
+  pending.Insert(points);
+  if (pending.NeedsRebuild())
+    Rebuild();
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+template<typename T>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::DeleteFromTree(
+    const size_t index,
+    const typename std::enable_if_t<tree::IsDynamicTree<T>::value>*)
+{
+  // The tree finds a point by its location, so each point must be removed from
+  // the tree before its column in the dataset is modified.
+  MatType& data = referenceTree->Dataset();
+  const size_t last = data.n_cols - 1;
+  referenceTree->DeletePoint(index);
+  if (index != last)
+  {
+    referenceTree->DeletePoint(last);
+    data.col(index) = data.col(last);
+    referenceTree->InsertPoint(index);
+  }
+  data.shed_col(last);
+
+  // The statistics of the nodes are no longer valid.
+  treeNeedsReset = true;
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+template<typename T>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::DeleteFromTree(
+    const size_t index,
+    const typename std::enable_if_t<!tree::IsDynamicTree<T>::value>*)
+{
+  // The point is only marked as deleted until there are enough pending updates
+  // to rebuild the tree.
+  pending.Start(referenceSet->n_cols);
+  pending.Delete(index);
+  if (pending.NeedsRebuild())
+    Rebuild();
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::Rebuild()
+{
+  if (!pending.Active())
+    return;
+
+  MatType data;
+  pending.Assemble(*referenceSet, oldFromNewReferences, data);
+  Train(std::move(data));
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::Search(
+    const MatType& querySet,
+    const size_t k,
+    arma::Mat<size_t>& neighbors,
+    arma::mat& distances)
+{
+  if (pending.Active())
+  {
+    // The pending updates can only be merged into results that use the
+    // current indices of the reference points.
+    if (unmapResults)
+    {
+      SearchPending(querySet, k, neighbors, distances);
+      return;
+    }
+
+    Rebuild();
+  }
+
+  SearchReferenceSet(querySet, k, neighbors, distances);
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::SearchPending(
+    const MatType& querySet,
+    const size_t k,
+    arma::Mat<size_t>& neighbors,
+    arma::mat& distances)
+{
+  if (k > pending.Size())
+  {
+    std::stringstream ss;
+    ss << "Requested value of k (" << k << ") is greater than the number of "
+        << "points in the reference set (" << pending.Size() << ")";
+    throw std::invalid_argument(ss.str());
+  }
+
+  // Look for enough neighbors in the tree that k of them are left once the
+  // deleted points are dropped.
+  const size_t treeK = std::min(k + pending.NumDeleted(),
+      (size_t) referenceSet->n_cols);
+  arma::Mat<size_t> treeNeighbors;
+  arma::mat treeDistances;
+  if (treeK > 0)
+    SearchReferenceSet(querySet, treeK, treeNeighbors, treeDistances);
+
+  const MatType& points = pending.Points();
+  const std::vector<size_t>& pointIndices = pending.PointIndices();
+  baseCases += querySet.n_cols * points.n_cols;
+
+  neighbors.set_size(k, querySet.n_cols);
+  distances.set_size(k, querySet.n_cols);
+
+  typedef std::pair<double, size_t> Candidate;
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) querySet.n_cols; ++i)
+  {
+    std::vector<Candidate> candidates;
+    candidates.reserve(treeK + points.n_cols);
+    for (size_t j = 0; j < treeK; ++j)
+    {
+      if (treeNeighbors(j, i) == size_t(-1))
+        continue;
+
+      const size_t index = pending.CurrentIndex(treeNeighbors(j, i));
+      if (index != size_t(-1))
+        candidates.push_back(Candidate(treeDistances(j, i), index));
+    }
+
+    for (size_t j = 0; j < points.n_cols; ++j)
+    {
+      candidates.push_back(Candidate(metric.Evaluate(querySet.col(i),
+          points.col(j)), pointIndices[j]));
+    }
+
+    const size_t found = std::min(k, candidates.size());
+    std::partial_sort(candidates.begin(), candidates.begin() + found,
+        candidates.end(), [](const Candidate& a, const Candidate& b)
+        { return SortPolicy::IsBetter(a.first, b.first); });
+
+    for (size_t j = 0; j < k; ++j)
+    {
+      neighbors(j, i) = (j < found) ? candidates[j].second : size_t(-1);
+      distances(j, i) = (j < found) ? candidates[j].first :
+          SortPolicy::WorstDistance();
+    }
+  }
+}
+
 /**
  * Computes the best neighbors and stores them in resultingNeighbors and
  * distances.
@@ -386,7 +719,7 @@ template<typename SortPolicy,
          template<typename> class DualTreeTraversalType,
          template<typename> class SingleTreeTraversalType>
 void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
-DualTreeTraversalType, SingleTreeTraversalType>::Search(
+DualTreeTraversalType, SingleTreeTraversalType>::SearchReferenceSet(
     const MatType& querySet,
     const size_t k,
     arma::Mat<size_t>& neighbors,
@@ -400,13 +733,15 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
     throw std::invalid_argument(ss.str());
   }
 
+  ProfileSpan span("neighbor_search");
   Timer::Start("computing_neighbors");
 
   baseCases = 0;
   scores = 0;
+  statistics.Reset();
 
   // This will hold mappings for query points, if necessary.
-  std::vector<size_t> oldFromNewQueries;
+  oldFromNewQueries.clear();
 
   // If we have built the trees ourselves, then we will have to map all the
   // indices back to their original indices when this computation is finished.
@@ -416,7 +751,7 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
   arma::mat* distancePtr = &distances;
 
   // Mapping is only necessary if the tree rearranges points.
-  if (tree::TreeTraits<Tree>::RearrangesDataset)
+  if (unmapResults && tree::TreeTraits<Tree>::RearrangesDataset)
   {
     if (searchMode == DUAL_TREE_MODE)
     {
@@ -453,14 +788,11 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
     case SINGLE_TREE_MODE:
     {
       // Create the helper object for the tree traversal.
-      RuleType rules(*referenceSet, querySet, k, metric, epsilon);
+      RuleType rules(*referenceSet, querySet, k, metric, epsilon, false,
+          maxBaseCases);
 
-      // Create the traverser.
-      SingleTreeTraversalType<RuleType> traverser(rules);
-
-      // Now have it traverse for each point.
-      for (size_t i = 0; i < querySet.n_cols; ++i)
-        traverser.Traverse(i, *referenceTree);
+      // Now traverse for each point.
+      SingleTreeTraverse(rules, querySet.n_cols);
 
       scores += rules.Scores();
       baseCases += rules.BaseCases();
@@ -483,12 +815,10 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
       Timer::Start("computing_neighbors");
 
       // Create the helper object for the tree traversal.
-      RuleType rules(*referenceSet, queryTree->Dataset(), k, metric, epsilon);
-
-      // Create the traverser.
-      DualTreeTraversalType<RuleType> traverser(rules);
+      RuleType rules(*referenceSet, queryTree->Dataset(), k, metric, epsilon,
+          false, maxBaseCases);
 
-      traverser.Traverse(*queryTree, *referenceTree);
+      DualTreeTraverse(rules, *queryTree);
 
       scores += rules.Scores();
       baseCases += rules.BaseCases();
@@ -509,7 +839,9 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
       RuleType rules(*referenceSet, querySet, k, metric);
 
       // Create the traverser.
-      tree::GreedySingleTreeTraverser<Tree, RuleType> traverser(rules);
+      tree::CountingRules<RuleType> countingRules(rules, statistics);
+      tree::GreedySingleTreeTraverser<Tree, tree::CountingRules<RuleType>>
+          traverser(countingRules);
 
       // Set the value of minBaseCases.
       traverser.MinBaseCases() = k;
@@ -529,12 +861,23 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
       rules.GetResults(*neighborPtr, *distancePtr);
       break;
     }
+    case BRUTE_FORCE_MODE:
+    {
+      BruteForceSearch(querySet, k, *neighborPtr, *distancePtr, false);
+      break;
+    }
   }
 
   Timer::Stop("computing_neighbors");
 
+  Profiler::AddCount("base_cases", baseCases);
+  Profiler::AddCount("scores", scores);
+  Profiler::AddCount("prunes", statistics.prunes);
+  if (UsesTree(searchMode))
+    statistics.Print(Log::Info);
+
   // Map points back to original indices, if necessary.
-  if (tree::TreeTraits<Tree>::RearrangesDataset)
+  if (unmapResults && tree::TreeTraits<Tree>::RearrangesDataset)
   {
     if (searchMode == DUAL_TREE_MODE && !oldFromNewReferences.empty())
     {
@@ -609,6 +952,9 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
     arma::mat& distances,
     bool sameSet)
 {
+  // The query tree can't hold the pending updates, so the reference tree must.
+  Rebuild();
+
   if (k > referenceSet->n_cols)
   {
     std::stringstream ss;
@@ -622,18 +968,22 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
     throw std::invalid_argument("cannot call NeighborSearch::Search() with a "
         "query tree when naive or singleMode are set to true");
 
+  ProfileSpan span("neighbor_search");
   Timer::Start("computing_neighbors");
 
   baseCases = 0;
   scores = 0;
+  statistics.Reset();
 
   // Get a reference to the query set.
   const MatType& querySet = queryTree.Dataset();
 
-  // We won't need to map query indices, but will we need to map distances?
+  // We won't need to map query indices (the caller knows the mapping of the
+  // query tree), but will we need to map distances?
+  oldFromNewQueries.clear();
   arma::Mat<size_t>* neighborPtr = &neighbors;
 
-  if (!oldFromNewReferences.empty() &&
+  if (unmapResults && !oldFromNewReferences.empty() &&
       tree::TreeTraits<Tree>::RearrangesDataset)
     neighborPtr = new arma::Mat<size_t>;
 
@@ -642,11 +992,10 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
 
   // Create the helper object for the traversal.
   typedef NeighborSearchRules<SortPolicy, MetricType, Tree> RuleType;
-  RuleType rules(*referenceSet, querySet, k, metric, epsilon, sameSet);
+  RuleType rules(*referenceSet, querySet, k, metric, epsilon, sameSet,
+      maxBaseCases);
 
-  // Create the traverser.
-  DualTreeTraversalType<RuleType> traverser(rules);
-  traverser.Traverse(queryTree, *referenceTree);
+  DualTreeTraverse(rules, queryTree);
 
   scores += rules.Scores();
   baseCases += rules.BaseCases();
@@ -661,8 +1010,14 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
 
   Timer::Stop("computing_neighbors");
 
+  Profiler::AddCount("base_cases", baseCases);
+  Profiler::AddCount("scores", scores);
+  Profiler::AddCount("prunes", statistics.prunes);
+  if (UsesTree(searchMode))
+    statistics.Print(Log::Info);
+
   // Do we need to map indices?
-  if (!oldFromNewReferences.empty() &&
+  if (unmapResults && !oldFromNewReferences.empty() &&
       tree::TreeTraits<Tree>::RearrangesDataset)
   {
     // We must map reference indices only.
@@ -692,6 +1047,10 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
     arma::Mat<size_t>& neighbors,
     arma::mat& distances)
 {
+  // Searching the reference set with itself needs the pending updates in the
+  // tree.
+  Rebuild();
+
   if (k > referenceSet->n_cols)
   {
     std::stringstream ss;
@@ -708,15 +1067,22 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
     throw std::invalid_argument(ss.str());
   }
 
+  ProfileSpan span("neighbor_search");
   Timer::Start("computing_neighbors");
 
   baseCases = 0;
   scores = 0;
+  statistics.Reset();
 
   arma::Mat<size_t>* neighborPtr = &neighbors;
   arma::mat* distancePtr = &distances;
 
-  if (!oldFromNewReferences.empty() &&
+  // If the results aren't mapped, their columns follow the reference tree.
+  oldFromNewQueries.clear();
+  if (!unmapResults)
+    oldFromNewQueries = oldFromNewReferences;
+
+  if (unmapResults && !oldFromNewReferences.empty() &&
       tree::TreeTraits<Tree>::RearrangesDataset)
   {
     // We will always need to rearrange in this case.
@@ -731,7 +1097,8 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
   // Create the helper object for the traversal.
   typedef NeighborSearchRules<SortPolicy, MetricType, Tree> RuleType;
   RuleType rules(*referenceSet, *referenceSet, k, metric, epsilon,
-      true /* don't return the same point as nearest neighbor */);
+      true /* don't return the same point as nearest neighbor */,
+      maxBaseCases);
 
   switch (searchMode)
   {
@@ -747,12 +1114,8 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
     }
     case SINGLE_TREE_MODE:
     {
-      // Create the traverser.
-      SingleTreeTraversalType<RuleType> traverser(rules);
-
-      // Now have it traverse for each point.
-      for (size_t i = 0; i < referenceSet->n_cols; ++i)
-        traverser.Traverse(i, *referenceTree);
+      // Traverse for each point.
+      SingleTreeTraverse(rules, referenceSet->n_cols);
 
       scores += rules.Scores();
       baseCases += rules.BaseCases();
@@ -785,19 +1148,16 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
         }
       }
 
-      // Create the traverser.
-      DualTreeTraversalType<RuleType> traverser(rules);
-
       if (tree::IsSpillTree<Tree>::value)
       {
         // For Dual Tree Search on SpillTree, the queryTree must be built with
         // non overlapping (tau = 0).
         Tree queryTree(*referenceSet);
-        traverser.Traverse(queryTree, *referenceTree);
+        DualTreeTraverse(rules, queryTree);
       }
       else
       {
-        traverser.Traverse(*referenceTree, *referenceTree);
+        DualTreeTraverse(rules, *referenceTree);
         // Next time we perform this search, we'll need to reset the tree.
         treeNeedsReset = true;
       }
@@ -817,7 +1177,9 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
     case GREEDY_SINGLE_TREE_MODE:
     {
       // Create the traverser.
-      tree::GreedySingleTreeTraverser<Tree, RuleType> traverser(rules);
+      tree::CountingRules<RuleType> countingRules(rules, statistics);
+      tree::GreedySingleTreeTraverser<Tree, tree::CountingRules<RuleType>>
+          traverser(countingRules);
 
       // Set the value of minBaseCases.
       traverser.MinBaseCases() = k;
@@ -835,14 +1197,27 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
           << std::endl;
       break;
     }
+    case BRUTE_FORCE_MODE:
+    {
+      BruteForceSearch(*referenceSet, k, *neighborPtr, *distancePtr, true);
+      break;
+    }
   }
 
-  rules.GetResults(*neighborPtr, *distancePtr);
+  // The brute-force search does not use the rules.
+  if (searchMode != BRUTE_FORCE_MODE)
+    rules.GetResults(*neighborPtr, *distancePtr);
 
   Timer::Stop("computing_neighbors");
 
+  Profiler::AddCount("base_cases", baseCases);
+  Profiler::AddCount("scores", scores);
+  Profiler::AddCount("prunes", statistics.prunes);
+  if (UsesTree(searchMode))
+    statistics.Print(Log::Info);
+
   // Do we need to map the reference indices?
-  if (!oldFromNewReferences.empty() &&
+  if (unmapResults && !oldFromNewReferences.empty() &&
       tree::TreeTraits<Tree>::RearrangesDataset)
   {
     neighbors.set_size(k, referenceSet->n_cols);
@@ -854,9 +1229,14 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
       const size_t refMapping = oldFromNewReferences[i];
       distances.col(refMapping) = distancePtr->col(i);
 
-      // Map each neighbor's index.
+      // Map each neighbor's index.  If k is the number of points, the last
+      // neighbor of each point is missing.
       for (size_t j = 0; j < distances.n_rows; ++j)
-        neighbors(j, refMapping) = oldFromNewReferences[(*neighborPtr)(j, i)];
+      {
+        const size_t neighbor = (*neighborPtr)(j, i);
+        neighbors(j, refMapping) = (neighbor == size_t(-1)) ? neighbor :
+            oldFromNewReferences[neighbor];
+      }
     }
 
     // Finished with temporary matrices.
@@ -865,6 +1245,323 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
   }
 }
 
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+template<typename RuleType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::DualTreeTraverse(
+    RuleType& rules,
+    Tree& queryTree)
+{
+  ProfileSpan span("traversal");
+
+#ifdef HAS_OPENMP
+  // Spill trees may hold the same query point in more than one node, so we
+  // can't split them into independent subtrees.
+  const size_t numThreads = omp_get_max_threads();
+  if (numThreads > 1 && !tree::IsSpillTree<Tree>::value)
+  {
+    // Split the query tree into disjoint subtrees.  Each query point belongs to
+    // only one subtree, so each subtree can be traversed against the reference
+    // tree independently.  We use more subtrees than threads to balance the
+    // load, since the subtrees may take very different amounts of time.
+    std::vector<Tree*> frontier;
+    tree::SubtreeFrontier(queryTree, 4 * numThreads, frontier);
+
+    size_t parallelScores = 0;
+    size_t parallelBaseCases = 0;
+
+    #pragma omp parallel for schedule(dynamic) \
+        reduction(+:parallelScores, parallelBaseCases)
+    for (omp_size_t i = 0; i < (omp_size_t) frontier.size(); ++i)
+    {
+      // This rules object writes its results into the candidate lists of the
+      // given rules object.
+      RuleType threadRules(&rules);
+      tree::TraversalStatistics threadStatistics;
+      tree::CountingRules<RuleType> countingRules(threadRules,
+          threadStatistics);
+      DualTreeTraversalType<tree::CountingRules<RuleType>>
+          traverser(countingRules);
+      traverser.Traverse(*frontier[i], *referenceTree);
+
+      parallelScores += threadRules.Scores();
+      parallelBaseCases += threadRules.BaseCases();
+
+      #pragma omp critical(NeighborSearchStatistics)
+      statistics += threadStatistics;
+    }
+
+    rules.Scores() += parallelScores;
+    rules.BaseCases() += parallelBaseCases;
+    return;
+  }
+#endif
+
+  tree::CountingRules<RuleType> countingRules(rules, statistics);
+  DualTreeTraversalType<tree::CountingRules<RuleType>> traverser(countingRules);
+  traverser.Traverse(queryTree, *referenceTree);
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+template<typename RuleType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::SingleTreeTraverse(
+    RuleType& rules,
+    const size_t numQueries)
+{
+  ProfileSpan span("traversal");
+
+#ifdef HAS_OPENMP
+  // Trees whose first point is the centroid and that have self-children (i.e.
+  // cover trees) cache base cases in the statistics of the reference nodes
+  // during single-tree search, so they can't be traversed by multiple threads
+  // at once.
+  const bool cachesBaseCases = tree::TreeTraits<Tree>::FirstPointIsCentroid &&
+      tree::TreeTraits<Tree>::HasSelfChildren;
+  if (omp_get_max_threads() > 1 && !cachesBaseCases)
+  {
+    size_t parallelScores = 0;
+    size_t parallelBaseCases = 0;
+
+    #pragma omp parallel reduction(+:parallelScores, parallelBaseCases)
+    {
+      // This rules object writes its results into the candidate lists of the
+      // given rules object.
+      RuleType threadRules(&rules);
+      tree::TraversalStatistics threadStatistics;
+      tree::CountingRules<RuleType> countingRules(threadRules,
+          threadStatistics);
+      SingleTreeTraversalType<tree::CountingRules<RuleType>>
+          traverser(countingRules);
+
+      #pragma omp for
+      for (omp_size_t i = 0; i < (omp_size_t) numQueries; ++i)
+        traverser.Traverse(i, *referenceTree);
+
+      parallelScores += threadRules.Scores();
+      parallelBaseCases += threadRules.BaseCases();
+
+      #pragma omp critical(NeighborSearchStatistics)
+      statistics += threadStatistics;
+    }
+
+    rules.Scores() += parallelScores;
+    rules.BaseCases() += parallelBaseCases;
+    return;
+  }
+#endif
+
+  tree::CountingRules<RuleType> countingRules(rules, statistics);
+  SingleTreeTraversalType<tree::CountingRules<RuleType>>
+      traverser(countingRules);
+  for (size_t i = 0; i < numQueries; ++i)
+    traverser.Traverse(i, *referenceTree);
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::BruteForceSearch(
+    const MatType& querySet,
+    const size_t k,
+    arma::Mat<size_t>& neighbors,
+    arma::mat& distances,
+    const bool sameSet)
+{
+  typedef typename MatType::elem_type ElemType;
+  typedef std::pair<double, size_t> Candidate;
+
+  // The blocks are small enough that a block of distances fits in the cache of
+  // one core, but large enough for the matrix multiplication to be efficient.
+  const size_t queryBlockSize = 128;
+  const size_t referenceBlockSize = 2048;
+
+  const size_t numQueries = querySet.n_cols;
+  const size_t numReferences = referenceSet->n_cols;
+  const size_t numQueryBlocks = (numQueries + queryBlockSize - 1) /
+      queryBlockSize;
+
+  neighbors.set_size(k, numQueries);
+  distances.set_size(k, numQueries);
+  if (k == 0)
+    return;
+
+  // Candidates are sorted by distance, and then by index so that the results
+  // do not depend on the blocking.
+  auto better = [](const Candidate& a, const Candidate& b)
+  {
+    if (a.first == b.first)
+      return a.second < b.second;
+    return SortPolicy::IsBetter(a.first, b.first);
+  };
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t b = 0; b < (omp_size_t) numQueryBlocks; ++b)
+  {
+    const size_t queryBegin = b * queryBlockSize;
+    const size_t queryCount = std::min(queryBlockSize,
+        numQueries - queryBegin);
+
+    std::vector<std::vector<Candidate>> best(queryCount);
+    for (size_t j = 0; j < queryCount; ++j)
+      best[j].reserve(k + referenceBlockSize);
+
+    arma::Mat<ElemType> block;
+    for (size_t referenceBegin = 0; referenceBegin < numReferences;
+         referenceBegin += referenceBlockSize)
+    {
+      const size_t referenceCount = std::min(referenceBlockSize,
+          numReferences - referenceBegin);
+
+      BruteForceDistances(metric, querySet, queryBegin, queryCount,
+          referenceBegin, referenceCount, block);
+
+      // Keep only the k best candidates of each query point.
+      for (size_t j = 0; j < queryCount; ++j)
+      {
+        std::vector<Candidate>& candidates = best[j];
+        const size_t queryIndex = queryBegin + j;
+        const bool full = (candidates.size() == k);
+        const Candidate worst = full ? candidates[k - 1] :
+            Candidate(SortPolicy::WorstDistance(), size_t(-1));
+
+        for (size_t i = 0; i < referenceCount; ++i)
+        {
+          const size_t referenceIndex = referenceBegin + i;
+          if (sameSet && (queryIndex == referenceIndex))
+            continue;
+
+          const Candidate c((double) block(i, j), referenceIndex);
+          if (!full || better(c, worst))
+            candidates.push_back(c);
+        }
+
+        // This also moves the worst of the k candidates to the end, so that
+        // it can be found quickly for the next block.
+        if (candidates.size() >= k)
+        {
+          std::nth_element(candidates.begin(), candidates.begin() + (k - 1),
+              candidates.end(), better);
+          candidates.resize(k);
+        }
+      }
+    }
+
+    // Compute the distances of the neighbors exactly with the metric, since
+    // the expanded form of the Euclidean distance loses precision.
+    for (size_t j = 0; j < queryCount; ++j)
+    {
+      std::vector<Candidate>& candidates = best[j];
+      const size_t queryIndex = queryBegin + j;
+      for (size_t i = 0; i < candidates.size(); ++i)
+      {
+        candidates[i].first = metric.Evaluate(querySet.col(queryIndex),
+            referenceSet->col(candidates[i].second));
+      }
+
+      // In monochromatic search, a point isn't its own neighbor, so there may
+      // be fewer than k candidates; the missing ones are filled in the way the
+      // rules of the tree searches fill them.
+      std::sort(candidates.begin(), candidates.end(), better);
+      for (size_t i = 0; i < k; ++i)
+      {
+        if (i < candidates.size())
+        {
+          neighbors(i, queryIndex) = candidates[i].second;
+          distances(i, queryIndex) = candidates[i].first;
+        }
+        else
+        {
+          neighbors(i, queryIndex) = size_t(-1);
+          distances(i, queryIndex) = SortPolicy::WorstDistance();
+        }
+      }
+    }
+  }
+
+  baseCases += numQueries * numReferences;
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+template<bool TakeRoot, typename AnyMatType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::BruteForceDistances(
+    const metric::LMetric<2, TakeRoot>& /* metric */,
+    const MatType& querySet,
+    const size_t queryBegin,
+    const size_t queryCount,
+    const size_t referenceBegin,
+    const size_t referenceCount,
+    arma::Mat<typename MatType::elem_type>& block,
+    const typename std::enable_if_t<
+        !arma::is_arma_sparse_type<AnyMatType>::value>*)
+{
+  const auto queries = querySet.cols(queryBegin, queryBegin + queryCount - 1);
+  const auto references = referenceSet->cols(referenceBegin,
+      referenceBegin + referenceCount - 1);
+
+  block = -2 * references.t() * queries;
+  block.each_col() += arma::sum(arma::square(references), 0).t();
+  block.each_row() += arma::sum(arma::square(queries), 0);
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+template<typename AnyMetricType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::BruteForceDistances(
+    const AnyMetricType& /* metric */,
+    const MatType& querySet,
+    const size_t queryBegin,
+    const size_t queryCount,
+    const size_t referenceBegin,
+    const size_t referenceCount,
+    arma::Mat<typename MatType::elem_type>& block)
+{
+  block.set_size(referenceCount, queryCount);
+  for (size_t j = 0; j < queryCount; ++j)
+  {
+    for (size_t i = 0; i < referenceCount; ++i)
+    {
+      block(i, j) = metric.Evaluate(querySet.col(queryBegin + j),
+          referenceSet->col(referenceBegin + i));
+    }
+  }
+}
+
 //! Calculate the average relative error.
 template<typename SortPolicy,
          typename MetricType,
@@ -949,13 +1646,20 @@ DualTreeTraversalType, SingleTreeTraversalType>::serialize(
     Archive& ar,
     const unsigned int /* version */)
 {
+  // The pending updates are applied to the tree before it is saved, so a loaded
+  // model has none.
+  if (Archive::is_saving::value)
+    Rebuild();
+  else
+    pending.Clear();
+
   // Serialize preferences for search.
   ar & BOOST_SERIALIZATION_NVP(searchMode);
   ar & BOOST_SERIALIZATION_NVP(treeNeedsReset);
 
-  // If we are doing naive search, we serialize the dataset.  Otherwise we
-  // serialize the tree.
-  if (searchMode == NAIVE_MODE)
+  // If we are doing naive or brute-force search, we serialize the dataset.
+  // Otherwise we serialize the tree.
+  if (!UsesTree(searchMode))
   {
     // Delete the current reference set, if necessary and if we are loading.
     if (Archive::is_loading::value && referenceSet)
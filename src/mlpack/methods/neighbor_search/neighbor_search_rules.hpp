@@ -14,6 +14,7 @@
 #define MLPACK_METHODS_NEIGHBOR_SEARCH_NEIGHBOR_SEARCH_RULES_HPP
 
 #include <mlpack/core/tree/traversal_info.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
 
 #include <queue>
 
@@ -46,13 +47,38 @@ class NeighborSearchRules
    * @param epsilon Relative approximate error.
    * @param sameSet If true, the query and reference set are taken to be the
    *      same, and a query point will not return itself in the results.
+   * @param maxBaseCases Maximum number of base cases for each query point; once
+   *      a query point has had this many, every node combination involving it
+   *      (in dual-tree search, every combination with a query leaf whose points
+   *      have all had this many) is pruned.  The last leaf visited may take a
+   *      query point over the limit.  This must be 0 (no limit) or at least k.
    */
   NeighborSearchRules(const typename TreeType::Mat& referenceSet,
                       const typename TreeType::Mat& querySet,
                       const size_t k,
                       MetricType& metric,
                       const double epsilon = 0,
-                      const bool sameSet = false);
+                      const bool sameSet = false,
+                      const size_t maxBaseCases = 0);
+
+  /**
+   * Construct a NeighborSearchRules object that searches the same data as the
+   * given rules object and stores results in the same candidate lists, but has
+   * its own base case cache, traversal information, and statistics (the number
+   * of base cases of each query point is shared, like the candidates).  This is
+   * used for parallel traversals, where each thread must hold its own rules
+   * object.  The caller must ensure that no query point is visited by more than
+   * one thread at a time, and that the given rules object outlives this one.
+   *
+   * @param other Rules object whose candidate lists will be shared.
+   */
+  NeighborSearchRules(NeighborSearchRules* other);
+
+  //! A copy would share the candidate lists of the original without knowing
+  //! it; use the constructor above to share them explicitly.
+  NeighborSearchRules(const NeighborSearchRules& other) = delete;
+  //! Rules objects can't be copied.
+  NeighborSearchRules& operator=(const NeighborSearchRules& other) = delete;
 
   /**
    * Store the list of candidates for each query point in the given matrices.
@@ -73,6 +99,21 @@ class NeighborSearchRules
    */
   double BaseCase(const size_t queryIndex, const size_t referenceIndex);
 
+  /**
+   * Run the base case between the query point and each of the reference points
+   * referenceBegin, ..., referenceBegin + referenceCount - 1.  This gives the
+   * same results as calling BaseCase() for each of those reference points, but
+   * the distances are computed all at once when that is supported by the
+   * metric (see LMetric::BatchEvaluate()).
+   *
+   * @param queryIndex Index of query point.
+   * @param referenceBegin Index of first reference point.
+   * @param referenceCount Number of reference points.
+   */
+  void BatchBaseCase(const size_t queryIndex,
+                     const size_t referenceBegin,
+                     const size_t referenceCount);
+
   /**
    * Get the score for recursion order.  A low score indicates priority for
    * recursion, while DBL_MAX indicates that the node should not be recursed
@@ -179,8 +220,13 @@ class NeighborSearchRules
   typedef std::priority_queue<Candidate, std::vector<Candidate>, CandidateCmp>
       CandidateList;
 
-  //! Set of candidate neighbors for each point.
-  std::vector<CandidateList> candidates;
+  //! Storage for the candidate neighbors of each point.  This is empty if the
+  //! candidate lists of another rules object are used.
+  std::vector<CandidateList> candidateStorage;
+
+  //! Set of candidate neighbors for each point.  This points either to
+  //! candidateStorage or to the storage of another rules object.
+  CandidateList* candidates;
 
   //! Number of neighbors to search for.
   const size_t k;
@@ -194,6 +240,16 @@ class NeighborSearchRules
   //! Relative error to be considered in approximate search.
   const double epsilon;
 
+  //! The maximum number of base cases for each query point (0 means no limit).
+  const size_t maxBaseCases;
+  //! Storage for the number of base cases of each query point.  This is empty
+  //! if there is no limit, or if the counts of another rules object are used.
+  std::vector<size_t> queryBaseCaseStorage;
+  //! The number of base cases of each query point.  This points either to
+  //! queryBaseCaseStorage or to the storage of another rules object, or is NULL
+  //! if there is no limit.
+  size_t* queryBaseCases;
+
   //! The last query point BaseCase() was called with.
   size_t lastQueryIndex;
   //! The last reference point BaseCase() was called with.
@@ -201,6 +257,9 @@ class NeighborSearchRules
   //! The last base case result.
   double lastBaseCase;
 
+  //! Distances computed by the last call to BatchBaseCase().
+  arma::Col<typename TreeType::ElemType> batchDistances;
+
   //! The number of base cases that have been performed.
   size_t baseCases;
   //! The number of scores that have been performed.
@@ -210,11 +269,50 @@ class NeighborSearchRules
   //! traversal before each call to Score().
   TraversalInfoType traversalInfo;
 
+  /**
+   * Return whether the given query point has used up its base cases.
+   */
+  bool BudgetSpent(const size_t queryIndex) const
+  {
+    return (queryBaseCases != NULL) &&
+        (queryBaseCases[queryIndex] >= maxBaseCases);
+  }
+
+  /**
+   * Return whether every point of the given query node has used up its base
+   * cases.  This is only checked for leaves, which hold few points.
+   */
+  bool BudgetSpent(const TreeType& queryNode) const;
+
   /**
    * Recalculate the bound for a given query node.
    */
   double CalculateBound(TreeType& queryNode) const;
 
+  /**
+   * Compute the distances between the query point and a block of reference
+   * points into batchDistances, for an LMetric on dense data.
+   */
+  template<int Power, bool TakeRoot, typename MatType = typename TreeType::Mat>
+  void BatchDistances(
+      const metric::LMetric<Power, TakeRoot>& /* metric */,
+      const size_t queryIndex,
+      const size_t referenceBegin,
+      const size_t referenceCount,
+      const typename std::enable_if_t<
+          !arma::is_arma_sparse_type<MatType>::value>* = 0);
+
+  /**
+   * Compute the distances between the query point and a block of reference
+   * points into batchDistances, one at a time.  This is used for any metric
+   * other than LMetric, and for sparse data.
+   */
+  template<typename AnyMetricType>
+  void BatchDistances(const AnyMetricType& /* metric */,
+                      const size_t queryIndex,
+                      const size_t referenceBegin,
+                      const size_t referenceCount);
+
   /**
    * Helper function to insert a point into the list of candidate points.
    *
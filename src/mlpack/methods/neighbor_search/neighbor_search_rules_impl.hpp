@@ -26,13 +26,16 @@ NeighborSearchRules<SortPolicy, MetricType, TreeType>::NeighborSearchRules(
     const size_t k,
     MetricType& metric,
     const double epsilon,
-    const bool sameSet) :
+    const bool sameSet,
+    const size_t maxBaseCases) :
     referenceSet(referenceSet),
     querySet(querySet),
     k(k),
     metric(metric),
     sameSet(sameSet),
     epsilon(epsilon),
+    maxBaseCases(maxBaseCases),
+    queryBaseCases(NULL),
     lastQueryIndex(querySet.n_cols),
     lastReferenceIndex(referenceSet.n_cols),
     baseCases(0),
@@ -54,9 +57,47 @@ NeighborSearchRules<SortPolicy, MetricType, TreeType>::NeighborSearchRules(
   std::vector<Candidate> vect(k, def);
   CandidateList pqueue(CandidateCmp(), std::move(vect));
 
-  candidates.reserve(querySet.n_cols);
+  candidateStorage.reserve(querySet.n_cols);
   for (size_t i = 0; i < querySet.n_cols; i++)
-    candidates.push_back(pqueue);
+    candidateStorage.push_back(pqueue);
+
+  candidates = candidateStorage.data();
+
+  if (maxBaseCases > 0)
+  {
+    if (maxBaseCases < k)
+    {
+      std::stringstream ss;
+      ss << "NeighborSearchRules: the maximum number of base cases ("
+          << maxBaseCases << ") must be at least k (" << k << ")";
+      throw std::invalid_argument(ss.str());
+    }
+
+    queryBaseCaseStorage.resize(querySet.n_cols, 0);
+    queryBaseCases = queryBaseCaseStorage.data();
+  }
+}
+
+template<typename SortPolicy, typename MetricType, typename TreeType>
+NeighborSearchRules<SortPolicy, MetricType, TreeType>::NeighborSearchRules(
+    NeighborSearchRules* other) :
+    referenceSet(other->referenceSet),
+    querySet(other->querySet),
+    candidates(other->candidates),
+    k(other->k),
+    metric(other->metric),
+    sameSet(other->sameSet),
+    epsilon(other->epsilon),
+    maxBaseCases(other->maxBaseCases),
+    queryBaseCases(other->queryBaseCases),
+    lastQueryIndex(querySet.n_cols),
+    lastReferenceIndex(referenceSet.n_cols),
+    baseCases(0),
+    scores(0)
+{
+  // See the other constructor for why we use the this pointer here.
+  traversalInfo.LastQueryNode() = (TreeType*) this;
+  traversalInfo.LastReferenceNode() = (TreeType*) this;
 }
 
 template<typename SortPolicy, typename MetricType, typename TreeType>
@@ -96,6 +137,8 @@ BaseCase(const size_t queryIndex, const size_t referenceIndex)
   double distance = metric.Evaluate(querySet.col(queryIndex),
                                     referenceSet.col(referenceIndex));
   ++baseCases;
+  if (queryBaseCases)
+    ++queryBaseCases[queryIndex];
 
   InsertNeighbor(queryIndex, referenceIndex, distance);
 
@@ -107,12 +150,90 @@ BaseCase(const size_t queryIndex, const size_t referenceIndex)
   return distance;
 }
 
+template<typename SortPolicy, typename MetricType, typename TreeType>
+inline void NeighborSearchRules<SortPolicy, MetricType, TreeType>::
+BatchBaseCase(const size_t queryIndex,
+              const size_t referenceBegin,
+              const size_t referenceCount)
+{
+  if (referenceCount == 0)
+    return;
+
+  BatchDistances(metric, queryIndex, referenceBegin, referenceCount);
+
+  for (size_t i = 0; i < referenceCount; ++i)
+  {
+    const size_t referenceIndex = referenceBegin + i;
+
+    // These are the same checks as in BaseCase().
+    if (sameSet && (queryIndex == referenceIndex))
+      continue;
+    if ((lastQueryIndex == queryIndex) &&
+        (lastReferenceIndex == referenceIndex))
+      continue;
+
+    const double distance = batchDistances[i];
+    ++baseCases;
+    if (queryBaseCases)
+      ++queryBaseCases[queryIndex];
+
+    InsertNeighbor(queryIndex, referenceIndex, distance);
+  }
+
+  // Cache the last base case, as if BaseCase() had been called for each
+  // reference point in turn.
+  const size_t referenceIndex = referenceBegin + referenceCount - 1;
+  if (!sameSet || (queryIndex != referenceIndex))
+  {
+    lastQueryIndex = queryIndex;
+    lastReferenceIndex = referenceIndex;
+    lastBaseCase = batchDistances[referenceCount - 1];
+  }
+}
+
+template<typename SortPolicy, typename MetricType, typename TreeType>
+template<int Power, bool TakeRoot, typename MatType>
+inline void NeighborSearchRules<SortPolicy, MetricType, TreeType>::
+BatchDistances(
+    const metric::LMetric<Power, TakeRoot>& /* metric */,
+    const size_t queryIndex,
+    const size_t referenceBegin,
+    const size_t referenceCount,
+    const typename std::enable_if_t<
+        !arma::is_arma_sparse_type<MatType>::value>*)
+{
+  metric::LMetric<Power, TakeRoot>::BatchEvaluate(querySet.col(queryIndex),
+      referenceSet.cols(referenceBegin, referenceBegin + referenceCount - 1),
+      batchDistances);
+}
+
+template<typename SortPolicy, typename MetricType, typename TreeType>
+template<typename AnyMetricType>
+inline void NeighborSearchRules<SortPolicy, MetricType, TreeType>::
+BatchDistances(const AnyMetricType& /* metric */,
+               const size_t queryIndex,
+               const size_t referenceBegin,
+               const size_t referenceCount)
+{
+  batchDistances.set_size(referenceCount);
+  for (size_t i = 0; i < referenceCount; ++i)
+  {
+    batchDistances[i] = metric.Evaluate(querySet.col(queryIndex),
+        referenceSet.col(referenceBegin + i));
+  }
+}
+
 template<typename SortPolicy, typename MetricType, typename TreeType>
 inline double NeighborSearchRules<SortPolicy, MetricType, TreeType>::Score(
     const size_t queryIndex,
     TreeType& referenceNode)
 {
   ++scores; // Count number of Score() calls.
+
+  // Stop the traversal for this point once it has used up its base cases.
+  if (BudgetSpent(queryIndex))
+    return DBL_MAX;
+
   double distance;
   if (tree::TreeTraits<TreeType>::FirstPointIsCentroid)
   {
@@ -172,9 +293,10 @@ inline double NeighborSearchRules<SortPolicy, MetricType, TreeType>::Rescore(
     TreeType& /* referenceNode */,
     const double oldScore) const
 {
-  // If we are already pruning, still prune.
-  if (oldScore == DBL_MAX)
-    return oldScore;
+  // If we are already pruning, or the point has used up its base cases, still
+  // prune.
+  if (oldScore == DBL_MAX || BudgetSpent(queryIndex))
+    return DBL_MAX;
 
   const double distance = SortPolicy::ConvertToDistance(oldScore);
 
@@ -192,6 +314,11 @@ inline double NeighborSearchRules<SortPolicy, MetricType, TreeType>::Score(
 {
   ++scores; // Count number of Score() calls.
 
+  // Stop the traversal for this leaf once all its points used up their base
+  // cases.
+  if (BudgetSpent(queryNode))
+    return DBL_MAX;
+
   // Update our bound.
   const double bestDistance = CalculateBound(queryNode);
 
@@ -352,7 +479,9 @@ inline double NeighborSearchRules<SortPolicy, MetricType, TreeType>::Rescore(
     TreeType& /* referenceNode */,
     const double oldScore) const
 {
-  if (oldScore == DBL_MAX || oldScore == 0.0)
+  if (oldScore == DBL_MAX || BudgetSpent(queryNode))
+    return DBL_MAX;
+  if (oldScore == 0.0)
     return oldScore;
 
   const double distance = SortPolicy::ConvertToDistance(oldScore);
@@ -363,6 +492,20 @@ inline double NeighborSearchRules<SortPolicy, MetricType, TreeType>::Rescore(
   return (SortPolicy::IsBetter(distance, bestDistance)) ? oldScore : DBL_MAX;
 }
 
+template<typename SortPolicy, typename MetricType, typename TreeType>
+inline bool NeighborSearchRules<SortPolicy, MetricType, TreeType>::BudgetSpent(
+    const TreeType& queryNode) const
+{
+  if (queryBaseCases == NULL || !queryNode.IsLeaf())
+    return false;
+
+  for (size_t i = 0; i < queryNode.NumPoints(); ++i)
+    if (queryBaseCases[queryNode.Point(i)] < maxBaseCases)
+      return false;
+
+  return true;
+}
+
 // Calculate the bound for a given query node in its current state and update
 // it.
 template<typename SortPolicy, typename MetricType, typename TreeType>
@@ -22,6 +22,7 @@
 #include <mlpack/core/tree/octree.hpp>
 #include <boost/variant.hpp>
 #include "neighbor_search.hpp"
+#include "query_cache.hpp"
 
 namespace mlpack {
 namespace neighbor {
@@ -32,14 +33,15 @@ namespace neighbor {
 template<typename SortPolicy,
          template<typename TreeMetricType,
                   typename TreeStatType,
-                  typename TreeMatType> class TreeType>
+                  typename TreeMatType> class TreeType,
+         typename MatType = arma::mat>
 using NSType = NeighborSearch<SortPolicy,
                               metric::EuclideanDistance,
-                              arma::mat,
+                              MatType,
                               TreeType,
                               TreeType<metric::EuclideanDistance,
                                   NeighborSearchStat<SortPolicy>,
-                                  arma::mat>::template DualTreeTraverser>;
+                                  MatType>::template DualTreeTraverser>;
 
 /**
  * MonoSearchVisitor executes a monochromatic neighbor search on the given
@@ -76,12 +78,12 @@ class MonoSearchVisitor : public boost::static_visitor<void>
  * accept leafSize as a parameter. In these cases, before doing neighbor search,
  * a query tree with proper leafSize is built from the querySet.
  */
-template<typename SortPolicy>
+template<typename SortPolicy, typename MatType = arma::mat>
 class BiSearchVisitor : public boost::static_visitor<void>
 {
  private:
   //! The query set for the bichromatic search.
-  const arma::mat& querySet;
+  const MatType& querySet;
   //! The number of neighbors to search for.
   const size_t k;
   //! The result matrix for neighbors.
@@ -104,7 +106,7 @@ class BiSearchVisitor : public boost::static_visitor<void>
   template<template<typename TreeMetricType,
                     typename TreeStatType,
                     typename TreeMatType> class TreeType>
-  using NSTypeT = NSType<SortPolicy, TreeType>;
+  using NSTypeT = NSType<SortPolicy, TreeType, MatType>;
 
   //! Default Bichromatic neighbor search on the given NSType instance.
   template<template<typename TreeMetricType,
@@ -119,13 +121,13 @@ class BiSearchVisitor : public boost::static_visitor<void>
   void operator()(NSTypeT<tree::BallTree>* ns) const;
 
   //! Bichromatic neighbor search specialized for SPTrees.
-  void operator()(SpillKNN* ns) const;
+  void operator()(DefeatistKNN<tree::SPTree, MatType>* ns) const;
 
   //! Bichromatic neighbor search specialized for octrees.
   void operator()(NSTypeT<tree::Octree>* ns) const;
 
   //! Construct the BiSearchVisitor.
-  BiSearchVisitor(const arma::mat& querySet,
+  BiSearchVisitor(const MatType& querySet,
                   const size_t k,
                   arma::Mat<size_t>& neighbors,
                   arma::mat& distances,
@@ -140,12 +142,12 @@ class BiSearchVisitor : public boost::static_visitor<void>
  * accept leafSize as a parameter. In these cases, a reference tree with proper
  * leafSize is built from the referenceSet.
  */
-template<typename SortPolicy>
+template<typename SortPolicy, typename MatType = arma::mat>
 class TrainVisitor : public boost::static_visitor<void>
 {
  private:
   //! The reference set to use for training.
-  arma::mat&& referenceSet;
+  MatType&& referenceSet;
   //! The leaf size, used only by BinarySpaceTree.
   size_t leafSize;
   //! Overlapping size (for spill trees).
@@ -162,7 +164,7 @@ class TrainVisitor : public boost::static_visitor<void>
   template<template<typename TreeMetricType,
                     typename TreeStatType,
                     typename TreeMatType> class TreeType>
-  using NSTypeT = NSType<SortPolicy, TreeType>;
+  using NSTypeT = NSType<SortPolicy, TreeType, MatType>;
 
   //! Default Train on the given NSType instance.
   template<template<typename TreeMetricType,
@@ -177,19 +179,46 @@ class TrainVisitor : public boost::static_visitor<void>
   void operator()(NSTypeT<tree::BallTree>* ns) const;
 
   //! Train specialized for SPTrees.
-  void operator()(SpillKNN* ns) const;
+  void operator()(DefeatistKNN<tree::SPTree, MatType>* ns) const;
 
   //! Train specialized for octrees.
   void operator()(NSTypeT<tree::Octree>* ns) const;
 
   //! Construct the TrainVisitor object with the given reference set, leafSize
   //! for BinarySpaceTrees, and tau and rho for spill trees.
-  TrainVisitor(arma::mat&& referenceSet,
+  TrainVisitor(MatType&& referenceSet,
                const size_t leafSize,
                const double tau,
                const double rho);
 };
 
+/**
+ * UpdateVisitor either adds points to the reference set of the given NSType or
+ * removes a point from it; see NeighborSearch::Insert() and
+ * NeighborSearch::Delete().
+ */
+template<typename MatType = arma::mat>
+class UpdateVisitor : public boost::static_visitor<void>
+{
+ private:
+  //! The points to insert, or NULL if a point is being deleted.
+  const MatType* points;
+  //! The index of the point to delete (if points is NULL).
+  const size_t index;
+
+ public:
+  //! Insert the points into, or delete the point from, the given NSType.
+  template<typename NSType>
+  void operator()(NSType* ns) const;
+
+  //! Construct the UpdateVisitor object to insert the given points.
+  UpdateVisitor(const MatType& points);
+
+  //! Construct the UpdateVisitor object to delete the point with the given
+  //! index.
+  UpdateVisitor(const size_t index);
+};
+
 /**
  * SearchModeVisitor exposes the SearchMode() method of the given NSType.
  */
@@ -212,15 +241,27 @@ class EpsilonVisitor : public boost::static_visitor<double&>
   double& operator()(NSType *ns) const;
 };
 
+/**
+ * MaxBaseCasesVisitor exposes the MaxBaseCases method of the given NSType.
+ */
+class MaxBaseCasesVisitor : public boost::static_visitor<size_t&>
+{
+ public:
+  //! Return the maximum number of base cases for each query point.
+  template<typename NSType>
+  size_t& operator()(NSType* ns) const;
+};
+
 /**
  * ReferenceSetVisitor exposes the referenceSet of the given NSType.
  */
-class ReferenceSetVisitor : public boost::static_visitor<const arma::mat&>
+template<typename MatType = arma::mat>
+class ReferenceSetVisitor : public boost::static_visitor<const MatType&>
 {
  public:
   //! Return the reference set.
   template<typename NSType>
-  const arma::mat& operator()(NSType *ns) const;
+  const MatType& operator()(NSType *ns) const;
 };
 
 /**
@@ -234,6 +275,106 @@ class DeleteVisitor : public boost::static_visitor<void>
   void operator()(NSType *ns) const;
 };
 
+/**
+ * SaveFlatVisitor saves the reference tree of the given NSType, and its
+ * mapping, with BinarySpaceTree::SaveFlat().  Only KD trees and ball trees can
+ * be saved this way; for other tree types, std::invalid_argument is thrown.
+ */
+template<typename SortPolicy, typename MatType = arma::mat>
+class SaveFlatVisitor : public boost::static_visitor<void>
+{
+ private:
+  //! The file to save the tree to.
+  const std::string& filename;
+
+  //! Save the tree of the given NSType.
+  template<typename NSType>
+  void SaveTree(NSType* ns) const;
+
+ public:
+  //! Alias template necessary for visual c++ compiler.
+  template<template<typename TreeMetricType,
+                    typename TreeStatType,
+                    typename TreeMatType> class TreeType>
+  using NSTypeT = NSType<SortPolicy, TreeType, MatType>;
+
+  //! Throw an exception, since the tree of the given NSType can't be saved.
+  template<typename NSType>
+  void operator()(NSType* ns) const;
+
+  //! Save the tree of the given NSType specialized for KDTrees.
+  void operator()(NSTypeT<tree::KDTree>* ns) const;
+
+  //! Save the tree of the given NSType specialized for BallTrees.
+  void operator()(NSTypeT<tree::BallTree>* ns) const;
+
+  //! Construct the SaveFlatVisitor with the file to save the tree to.
+  SaveFlatVisitor(const std::string& filename) : filename(filename) { }
+};
+
+/**
+ * LoadFlatVisitor loads a reference tree saved with SaveFlatVisitor into the
+ * given NSType, along with its mapping.  Only KD trees and ball trees can be
+ * loaded this way; for other tree types, std::invalid_argument is thrown.
+ */
+template<typename SortPolicy, typename MatType = arma::mat>
+class LoadFlatVisitor : public boost::static_visitor<void>
+{
+ private:
+  //! The file to load the tree from.
+  const std::string& filename;
+
+  //! Load the tree of the given NSType.
+  template<typename NSType>
+  void LoadTree(NSType* ns) const;
+
+ public:
+  //! Alias template necessary for visual c++ compiler.
+  template<template<typename TreeMetricType,
+                    typename TreeStatType,
+                    typename TreeMatType> class TreeType>
+  using NSTypeT = NSType<SortPolicy, TreeType, MatType>;
+
+  //! Throw an exception, since the tree of the given NSType can't be loaded.
+  template<typename NSType>
+  void operator()(NSType* ns) const;
+
+  //! Load the tree of the given NSType specialized for KDTrees.
+  void operator()(NSTypeT<tree::KDTree>* ns) const;
+
+  //! Load the tree of the given NSType specialized for BallTrees.
+  void operator()(NSTypeT<tree::BallTree>* ns) const;
+
+  //! Construct the LoadFlatVisitor with the file to load the tree from.
+  LoadFlatVisitor(const std::string& filename) : filename(filename) { }
+};
+
+//! The magic string of the parameters that NSModel::SaveFlat() appends to a
+//! flat tree file.
+static const char NSModelFlatMagic[8] = { 'M', 'L', 'P', 'K', 'N', 'S', 'M',
+    '1' };
+
+/**
+ * The parameters of an NSModel that NSModel::SaveFlat() appends to the end of
+ * the flat tree file (see core/tree/binary_space_tree/flat_file.hpp), after the
+ * dataset, so that NSModel::LoadFlat() can rebuild the model around the tree.
+ */
+struct NSModelFlatFooter
+{
+  //! Must be equal to NSModelFlatMagic.
+  char magic[8];
+  //! The type of the tree (KD_TREE or BALL_TREE).
+  uint64_t treeType;
+  //! The leaf size, used for query trees.
+  uint64_t leafSize;
+  //! The search mode.
+  uint64_t searchMode;
+  //! The relative approximate error.
+  double epsilon;
+  //! The maximum number of base cases for each query point.
+  uint64_t maxBaseCases;
+};
+
 /**
  * The NSModel class provides an easy way to serialize a model, abstracts away
  * the different types of trees, and also reflects the NeighborSearch API.  This
@@ -243,8 +384,11 @@ class DeleteVisitor : public boost::static_visitor<void>
  * mlpack_knn and mlpack_kfn, be aware that it is limited!
  *
  * @tparam SortPolicy The sort policy for distances; see NearestNeighborSort.
+ * @tparam MatType The type of data matrix to use; arma::fmat halves the memory
+ *     used by the reference set and the trees built on it, compared to
+ *     arma::mat.  Distances are always returned as doubles.
  */
-template<typename SortPolicy>
+template<typename SortPolicy, typename MatType = arma::mat>
 class NSModel
 {
  public:
@@ -283,28 +427,31 @@ class NSModel
   //! If true, random projections are used.
   bool randomBasis;
   //! This is the random projection matrix; only used if randomBasis is true.
-  arma::mat q;
+  MatType q;
 
   /**
    * nSearch holds an instance of the NeigborSearch class for the current
    * treeType. It is initialized every time BuildModel is executed.
    * We access to the contained value through the visitor classes defined above.
    */
-  boost::variant<NSType<SortPolicy, tree::KDTree>*,
-                 NSType<SortPolicy, tree::StandardCoverTree>*,
-                 NSType<SortPolicy, tree::RTree>*,
-                 NSType<SortPolicy, tree::RStarTree>*,
-                 NSType<SortPolicy, tree::BallTree>*,
-                 NSType<SortPolicy, tree::XTree>*,
-                 NSType<SortPolicy, tree::HilbertRTree>*,
-                 NSType<SortPolicy, tree::RPlusTree>*,
-                 NSType<SortPolicy, tree::RPlusPlusTree>*,
-                 NSType<SortPolicy, tree::VPTree>*,
-                 NSType<SortPolicy, tree::RPTree>*,
-                 NSType<SortPolicy, tree::MaxRPTree>*,
-                 SpillKNN*,
-                 NSType<SortPolicy, tree::UBTree>*,
-                 NSType<SortPolicy, tree::Octree>*> nSearch;
+  boost::variant<NSType<SortPolicy, tree::KDTree, MatType>*,
+                 NSType<SortPolicy, tree::StandardCoverTree, MatType>*,
+                 NSType<SortPolicy, tree::RTree, MatType>*,
+                 NSType<SortPolicy, tree::RStarTree, MatType>*,
+                 NSType<SortPolicy, tree::BallTree, MatType>*,
+                 NSType<SortPolicy, tree::XTree, MatType>*,
+                 NSType<SortPolicy, tree::HilbertRTree, MatType>*,
+                 NSType<SortPolicy, tree::RPlusTree, MatType>*,
+                 NSType<SortPolicy, tree::RPlusPlusTree, MatType>*,
+                 NSType<SortPolicy, tree::VPTree, MatType>*,
+                 NSType<SortPolicy, tree::RPTree, MatType>*,
+                 NSType<SortPolicy, tree::MaxRPTree, MatType>*,
+                 DefeatistKNN<tree::SPTree, MatType>*,
+                 NSType<SortPolicy, tree::UBTree, MatType>*,
+                 NSType<SortPolicy, tree::Octree, MatType>*> nSearch;
+
+  //! Cache of the results of the query points (disabled by default).
+  QueryCache cache;
 
  public:
   /**
@@ -353,7 +500,7 @@ class NSModel
   void serialize(Archive& ar, const unsigned int /* version */);
 
   //! Expose the dataset.
-  const arma::mat& Dataset() const;
+  const MatType& Dataset() const;
 
   //! Expose SearchMode.
   NeighborSearchMode SearchMode() const;
@@ -363,6 +510,10 @@ class NSModel
   double Epsilon() const;
   double& Epsilon();
 
+  //! Expose MaxBaseCases.
+  size_t MaxBaseCases() const;
+  size_t& MaxBaseCases();
+
   //! Expose leafSize.
   size_t LeafSize() const { return leafSize; }
   size_t& LeafSize() { return leafSize; }
@@ -383,14 +534,42 @@ class NSModel
   bool RandomBasis() const { return randomBasis; }
   bool& RandomBasis() { return randomBasis; }
 
+  /**
+   * Expose the cache of the results of the query points of Search(), which is
+   * disabled by default; enable it with, for instance,
+   * `model.Cache() = QueryCache(10000)`.  The cache is cleared when the model
+   * is built, loaded or updated.  It is not serialized.
+   */
+  const QueryCache& Cache() const { return cache; }
+  QueryCache& Cache() { return cache; }
+
   //! Build the reference tree.
-  void BuildModel(arma::mat&& referenceSet,
+  void BuildModel(MatType&& referenceSet,
                   const size_t leafSize,
                   const NeighborSearchMode searchMode,
                   const double epsilon = 0);
 
-  //! Perform neighbor search.  The query set will be reordered.
-  void Search(arma::mat&& querySet,
+  /**
+   * Add the given points to the reference set; see NeighborSearch::Insert().
+   * Trees in the RectangleTree family are updated in place; other trees are
+   * rebuilt once there are enough pending updates, and Dataset() doesn't
+   * include the pending updates until then.
+   */
+  void Insert(MatType&& points);
+
+  /**
+   * Remove the reference point with the given index; the last reference point
+   * takes its index.  See NeighborSearch::Delete().
+   */
+  void Delete(const size_t index);
+
+  /**
+   * Perform neighbor search.  The query set will be reordered.  If the cache
+   * is enabled, the query points whose results are in the cache (for the same
+   * k, search mode, epsilon and maximum number of base cases) aren't searched
+   * again.
+   */
+  void Search(MatType&& querySet,
               const size_t k,
               arma::Mat<size_t>& neighbors,
               arma::mat& distances);
@@ -402,14 +581,58 @@ class NSModel
 
   //! Return a string representation of the current tree type.
   std::string TreeName() const;
+
+  /**
+   * Save the model to the given file in the flat, pointer-free layout of
+   * BinarySpaceTree::SaveFlat(), followed by the parameters of the model, so
+   * that it can be loaded with LoadFlat() without any deserialization.  Only
+   * models with a KD tree or a ball tree and without a random basis can be
+   * saved this way; for other models, std::invalid_argument is thrown.
+   *
+   * @param filename File to save the model to.
+   */
+  void SaveFlat(const std::string& filename) const;
+
+  /**
+   * Load a model that was saved with SaveFlat().  The reference tree is
+   * memory-mapped (see BinarySpaceTree::LoadFlat()), so the reference set is
+   * not read or copied, and processes that load the same file share its
+   * memory.  If the file can't be loaded, std::runtime_error is thrown and the
+   * model is not changed.
+   *
+   * @param filename File to load the model from.
+   */
+  void LoadFlat(const std::string& filename);
+
+ private:
+  //! Search the given query set, without the cache.
+  void SearchQueries(MatType&& querySet,
+                     const size_t k,
+                     arma::Mat<size_t>& neighbors,
+                     arma::mat& distances);
 };
 
 } // namespace neighbor
 } // namespace mlpack
 
-//! Set the serialization version of the NSModel class.
-BOOST_TEMPLATE_CLASS_VERSION(template<typename SortPolicy>,
-    mlpack::neighbor::NSModel<SortPolicy>, 1);
+//! Set the serialization version of the NSModel class.  (This can't use
+//! BOOST_TEMPLATE_CLASS_VERSION, since NSModel has more than one template
+//! parameter.)
+namespace boost {
+namespace serialization {
+
+template<typename SortPolicy, typename MatType>
+struct version<mlpack::neighbor::NSModel<SortPolicy, MatType>>
+{
+  typedef mpl::int_<1> type;
+  typedef mpl::integral_c_tag tag;
+  BOOST_STATIC_CONSTANT(int, value = version::type::value);
+  BOOST_MPL_ASSERT((boost::mpl::less<boost::mpl::int_<1>,
+                    boost::mpl::int_<256>>));
+};
+
+} // namespace serialization
+} // namespace boost
 
 // Include implementation.
 #include "ns_model_impl.hpp"
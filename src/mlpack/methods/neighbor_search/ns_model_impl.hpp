@@ -33,14 +33,15 @@ void MonoSearchVisitor::operator()(NSType *ns) const
 }
 
 //! Save parameters for bichromatic neighbor search.
-template<typename SortPolicy>
-BiSearchVisitor<SortPolicy>::BiSearchVisitor(const arma::mat& querySet,
-                                             const size_t k,
-                                             arma::Mat<size_t>& neighbors,
-                                             arma::mat& distances,
-                                             const size_t leafSize,
-                                             const double tau,
-                                             const double rho) :
+template<typename SortPolicy, typename MatType>
+BiSearchVisitor<SortPolicy, MatType>::BiSearchVisitor(
+    const MatType& querySet,
+    const size_t k,
+    arma::Mat<size_t>& neighbors,
+    arma::mat& distances,
+    const size_t leafSize,
+    const double tau,
+    const double rho) :
     querySet(querySet),
     k(k),
     neighbors(neighbors),
@@ -51,11 +52,12 @@ BiSearchVisitor<SortPolicy>::BiSearchVisitor(const arma::mat& querySet,
 {}
 
 //! Default Bichromatic neighbor search on the given NSType instance.
-template<typename SortPolicy>
+template<typename SortPolicy, typename MatType>
 template<template<typename TreeMetricType,
                   typename TreeStatType,
                   typename TreeMatType> class TreeType>
-void BiSearchVisitor<SortPolicy>::operator()(NSTypeT<TreeType>* ns) const
+void BiSearchVisitor<SortPolicy, MatType>::operator()(
+    NSTypeT<TreeType>* ns) const
 {
   if (ns)
     return ns->Search(querySet, k, neighbors, distances);
@@ -63,8 +65,9 @@ void BiSearchVisitor<SortPolicy>::operator()(NSTypeT<TreeType>* ns) const
 }
 
 //! Bichromatic neighbor search on the given NSType specialized for KDTrees.
-template<typename SortPolicy>
-void BiSearchVisitor<SortPolicy>::operator()(NSTypeT<tree::KDTree>* ns) const
+template<typename SortPolicy, typename MatType>
+void BiSearchVisitor<SortPolicy, MatType>::operator()(
+    NSTypeT<tree::KDTree>* ns) const
 {
   if (ns)
     return SearchLeaf(ns);
@@ -72,8 +75,9 @@ void BiSearchVisitor<SortPolicy>::operator()(NSTypeT<tree::KDTree>* ns) const
 }
 
 //! Bichromatic neighbor search on the given NSType specialized for BallTrees.
-template<typename SortPolicy>
-void BiSearchVisitor<SortPolicy>::operator()(NSTypeT<tree::BallTree>* ns) const
+template<typename SortPolicy, typename MatType>
+void BiSearchVisitor<SortPolicy, MatType>::operator()(
+    NSTypeT<tree::BallTree>* ns) const
 {
   if (ns)
     return SearchLeaf(ns);
@@ -81,8 +85,9 @@ void BiSearchVisitor<SortPolicy>::operator()(NSTypeT<tree::BallTree>* ns) const
 }
 
 //! Bichromatic neighbor search specialized for SPTrees.
-template<typename SortPolicy>
-void BiSearchVisitor<SortPolicy>::operator()(SpillKNN* ns) const
+template<typename SortPolicy, typename MatType>
+void BiSearchVisitor<SortPolicy, MatType>::operator()(
+    DefeatistKNN<tree::SPTree, MatType>* ns) const
 {
   if (ns)
   {
@@ -90,8 +95,8 @@ void BiSearchVisitor<SortPolicy>::operator()(SpillKNN* ns) const
     {
       // For Dual Tree Search on SpillTrees, the queryTree must be built with
       // non overlapping (tau = 0).
-      typename SpillKNN::Tree queryTree(std::move(querySet), 0 /* tau*/,
-          leafSize, rho);
+      typename DefeatistKNN<tree::SPTree, MatType>::Tree queryTree(
+          std::move(querySet), 0 /* tau*/, leafSize, rho);
       ns->Search(queryTree, k, neighbors, distances);
     }
     else
@@ -102,8 +107,9 @@ void BiSearchVisitor<SortPolicy>::operator()(SpillKNN* ns) const
 }
 
 //! Bichromatic neighbor search specialized for octrees.
-template<typename SortPolicy>
-void BiSearchVisitor<SortPolicy>::operator()(NSTypeT<tree::Octree>* ns) const
+template<typename SortPolicy, typename MatType>
+void BiSearchVisitor<SortPolicy, MatType>::operator()(
+    NSTypeT<tree::Octree>* ns) const
 {
   if (ns)
     return SearchLeaf(ns);
@@ -111,9 +117,9 @@ void BiSearchVisitor<SortPolicy>::operator()(NSTypeT<tree::Octree>* ns) const
 }
 
 //! Bichromatic neighbor search on the given NSType considering the leafSize.
-template<typename SortPolicy>
+template<typename SortPolicy, typename MatType>
 template<typename NSType>
-void BiSearchVisitor<SortPolicy>::SearchLeaf(NSType* ns) const
+void BiSearchVisitor<SortPolicy, MatType>::SearchLeaf(NSType* ns) const
 {
   if (ns->SearchMode() == DUAL_TREE_MODE)
   {
@@ -139,11 +145,11 @@ void BiSearchVisitor<SortPolicy>::SearchLeaf(NSType* ns) const
 }
 
 //! Save parameters for Train.
-template<typename SortPolicy>
-TrainVisitor<SortPolicy>::TrainVisitor(arma::mat&& referenceSet,
-                                       const size_t leafSize,
-                                       const double tau,
-                                       const double rho) :
+template<typename SortPolicy, typename MatType>
+TrainVisitor<SortPolicy, MatType>::TrainVisitor(MatType&& referenceSet,
+                                                const size_t leafSize,
+                                                const double tau,
+                                                const double rho) :
     referenceSet(std::move(referenceSet)),
     leafSize(leafSize),
     tau(tau),
@@ -151,11 +157,12 @@ TrainVisitor<SortPolicy>::TrainVisitor(arma::mat&& referenceSet,
 {}
 
 //! Default Train on the given NSType instance.
-template<typename SortPolicy>
+template<typename SortPolicy, typename MatType>
 template<template<typename TreeMetricType,
                   typename TreeStatType,
                   typename TreeMatType> class TreeType>
-void TrainVisitor<SortPolicy>::operator()(NSTypeT<TreeType>* ns) const
+void TrainVisitor<SortPolicy, MatType>::operator()(
+    NSTypeT<TreeType>* ns) const
 {
   if (ns)
     return ns->Train(std::move(referenceSet));
@@ -163,8 +170,9 @@ void TrainVisitor<SortPolicy>::operator()(NSTypeT<TreeType>* ns) const
 }
 
 //! Train on the given NSType specialized for KDTrees.
-template<typename SortPolicy>
-void TrainVisitor<SortPolicy>::operator()(NSTypeT<tree::KDTree>* ns) const
+template<typename SortPolicy, typename MatType>
+void TrainVisitor<SortPolicy, MatType>::operator()(
+    NSTypeT<tree::KDTree>* ns) const
 {
   if (ns)
     return TrainLeaf(ns);
@@ -172,8 +180,9 @@ void TrainVisitor<SortPolicy>::operator()(NSTypeT<tree::KDTree>* ns) const
 }
 
 //! Train on the given NSType specialized for BallTrees.
-template<typename SortPolicy>
-void TrainVisitor<SortPolicy>::operator()(NSTypeT<tree::BallTree>* ns) const
+template<typename SortPolicy, typename MatType>
+void TrainVisitor<SortPolicy, MatType>::operator()(
+    NSTypeT<tree::BallTree>* ns) const
 {
   if (ns)
     return TrainLeaf(ns);
@@ -181,16 +190,18 @@ void TrainVisitor<SortPolicy>::operator()(NSTypeT<tree::BallTree>* ns) const
 }
 
 //! Train specialized for SPTrees.
-template<typename SortPolicy>
-void TrainVisitor<SortPolicy>::operator()(SpillKNN* ns) const
+template<typename SortPolicy, typename MatType>
+void TrainVisitor<SortPolicy, MatType>::operator()(
+    DefeatistKNN<tree::SPTree, MatType>* ns) const
 {
   if (ns)
   {
-    if (ns->SearchMode() == NAIVE_MODE)
+    if (!UsesTree(ns->SearchMode()))
       ns->Train(std::move(referenceSet));
     else
     {
-      typename SpillKNN::Tree tree(std::move(referenceSet), tau, leafSize, rho);
+      typename DefeatistKNN<tree::SPTree, MatType>::Tree tree(
+          std::move(referenceSet), tau, leafSize, rho);
       ns->Train(std::move(tree));
     }
   }
@@ -199,8 +210,9 @@ void TrainVisitor<SortPolicy>::operator()(SpillKNN* ns) const
 }
 
 //! Train specialized for Octrees.
-template<typename SortPolicy>
-void TrainVisitor<SortPolicy>::operator()(NSTypeT<tree::Octree>* ns) const
+template<typename SortPolicy, typename MatType>
+void TrainVisitor<SortPolicy, MatType>::operator()(
+    NSTypeT<tree::Octree>* ns) const
 {
   if (ns)
     return TrainLeaf(ns);
@@ -208,11 +220,11 @@ void TrainVisitor<SortPolicy>::operator()(NSTypeT<tree::Octree>* ns) const
 }
 
 //! Train on the given NSType considering the leafSize.
-template<typename SortPolicy>
+template<typename SortPolicy, typename MatType>
 template<typename NSType>
-void TrainVisitor<SortPolicy>::TrainLeaf(NSType* ns) const
+void TrainVisitor<SortPolicy, MatType>::TrainLeaf(NSType* ns) const
 {
-  if (ns->SearchMode() == NAIVE_MODE)
+  if (!UsesTree(ns->SearchMode()))
     ns->Train(std::move(referenceSet));
   else
   {
@@ -225,6 +237,34 @@ void TrainVisitor<SortPolicy>::TrainLeaf(NSType* ns) const
   }
 }
 
+//! Construct the UpdateVisitor object to insert the given points.
+template<typename MatType>
+UpdateVisitor<MatType>::UpdateVisitor(const MatType& points) :
+    points(&points),
+    index(0)
+{}
+
+//! Construct the UpdateVisitor object to delete the given point.
+template<typename MatType>
+UpdateVisitor<MatType>::UpdateVisitor(const size_t index) :
+    points(NULL),
+    index(index)
+{}
+
+//! Insert or delete points.
+template<typename MatType>
+template<typename NSType>
+void UpdateVisitor<MatType>::operator()(NSType* ns) const
+{
+  if (!ns)
+    throw std::runtime_error("no neighbor search model initialized");
+
+  if (points)
+    ns->Insert(*points);
+  else
+    ns->Delete(index);
+}
+
 //! Return the search mode.
 template<typename NSType>
 NeighborSearchMode& SearchModeVisitor::operator()(NSType* ns) const
@@ -243,9 +283,19 @@ double& EpsilonVisitor::operator()(NSType* ns) const
   throw std::runtime_error("no neighbor search model initialized");
 }
 
+//! Expose the MaxBaseCases method of the given NSType.
+template<typename NSType>
+size_t& MaxBaseCasesVisitor::operator()(NSType* ns) const
+{
+  if (ns)
+    return ns->MaxBaseCases();
+  throw std::runtime_error("no neighbor search model initialized");
+}
+
 //! Expose the referenceSet of the given NSType.
+template<typename MatType>
 template<typename NSType>
-const arma::mat& ReferenceSetVisitor::operator()(NSType* ns) const
+const MatType& ReferenceSetVisitor<MatType>::operator()(NSType* ns) const
 {
   if (ns)
     return ns->ReferenceSet();
@@ -260,12 +310,99 @@ void DeleteVisitor::operator()(NSType* ns) const
     delete ns;
 }
 
+//! Trees other than KD trees and ball trees can't be saved in the flat format.
+template<typename SortPolicy, typename MatType>
+template<typename NSType>
+void SaveFlatVisitor<SortPolicy, MatType>::operator()(NSType* /* ns */) const
+{
+  throw std::invalid_argument("only models with a KD tree or a ball tree can "
+      "be saved in the flat format");
+}
+
+//! Save the tree of a KD tree model.
+template<typename SortPolicy, typename MatType>
+void SaveFlatVisitor<SortPolicy, MatType>::operator()(
+    NSTypeT<tree::KDTree>* ns) const
+{
+  SaveTree(ns);
+}
+
+//! Save the tree of a ball tree model.
+template<typename SortPolicy, typename MatType>
+void SaveFlatVisitor<SortPolicy, MatType>::operator()(
+    NSTypeT<tree::BallTree>* ns) const
+{
+  SaveTree(ns);
+}
+
+//! Save the tree of the given NSType, with its mapping.
+template<typename SortPolicy, typename MatType>
+template<typename NSType>
+void SaveFlatVisitor<SortPolicy, MatType>::SaveTree(NSType* ns) const
+{
+  if (!ns)
+    throw std::runtime_error("no neighbor search model initialized");
+
+  if (!UsesTree(ns->SearchMode()))
+  {
+    throw std::invalid_argument("models that use naive or brute-force search "
+        "have no tree to save in the flat format");
+  }
+
+  // The pending updates of the model must be in the tree that is saved.
+  ns->Rebuild();
+  ns->ReferenceTree().SaveFlat(filename, ns->OldFromNewReferences());
+}
+
+//! Trees other than KD trees and ball trees can't be loaded from the flat
+//! format.
+template<typename SortPolicy, typename MatType>
+template<typename NSType>
+void LoadFlatVisitor<SortPolicy, MatType>::operator()(NSType* /* ns */) const
+{
+  throw std::invalid_argument("only models with a KD tree or a ball tree can "
+      "be loaded from the flat format");
+}
+
+//! Load the tree of a KD tree model.
+template<typename SortPolicy, typename MatType>
+void LoadFlatVisitor<SortPolicy, MatType>::operator()(
+    NSTypeT<tree::KDTree>* ns) const
+{
+  LoadTree(ns);
+}
+
+//! Load the tree of a ball tree model.
+template<typename SortPolicy, typename MatType>
+void LoadFlatVisitor<SortPolicy, MatType>::operator()(
+    NSTypeT<tree::BallTree>* ns) const
+{
+  LoadTree(ns);
+}
+
+//! Load the tree of the given NSType, with its mapping.
+template<typename SortPolicy, typename MatType>
+template<typename NSType>
+void LoadFlatVisitor<SortPolicy, MatType>::LoadTree(NSType* ns) const
+{
+  if (!ns)
+    throw std::runtime_error("no neighbor search model initialized");
+
+  std::vector<size_t> oldFromNewReferences;
+  typename NSType::Tree* referenceTree = NSType::Tree::LoadFlat(filename,
+      oldFromNewReferences);
+  ns->Train(std::move(*referenceTree));
+  delete referenceTree;
+  // Set the mappings.
+  ns->oldFromNewReferences = std::move(oldFromNewReferences);
+}
+
 /**
  * Initialize the NSModel with the given type and whether or not a random
  * basis should be used.
  */
-template<typename SortPolicy>
-NSModel<SortPolicy>::NSModel(TreeTypes treeType, bool randomBasis) :
+template<typename SortPolicy, typename MatType>
+NSModel<SortPolicy, MatType>::NSModel(TreeTypes treeType, bool randomBasis) :
     treeType(treeType),
     leafSize(20),
     tau(0),
@@ -275,28 +412,30 @@ NSModel<SortPolicy>::NSModel(TreeTypes treeType, bool randomBasis) :
   // Nothing to do.
 }
 
-template<typename SortPolicy>
-NSModel<SortPolicy>::NSModel(const NSModel& other) :
+template<typename SortPolicy, typename MatType>
+NSModel<SortPolicy, MatType>::NSModel(const NSModel& other) :
     treeType(other.treeType),
     leafSize(other.leafSize),
     tau(other.tau),
     rho(other.rho),
     randomBasis(other.randomBasis),
     q(other.q),
-    nSearch(other.nSearch)
+    nSearch(other.nSearch),
+    cache(other.cache)
 {
   // Nothing to do.
 }
 
-template<typename SortPolicy>
-NSModel<SortPolicy>::NSModel(NSModel&& other) :
+template<typename SortPolicy, typename MatType>
+NSModel<SortPolicy, MatType>::NSModel(NSModel&& other) :
     treeType(other.treeType),
     leafSize(other.leafSize),
     tau(other.tau),
     rho(other.rho),
     randomBasis(other.randomBasis),
     q(std::move(other.q)),
-    nSearch(other.nSearch)
+    nSearch(other.nSearch),
+    cache(other.cache)
 {
   // Reset parameters of the other model.
   other.treeType = TreeTypes::KD_TREE;
@@ -307,8 +446,9 @@ NSModel<SortPolicy>::NSModel(NSModel&& other) :
   other.nSearch = decltype(other.nSearch)();
 }
 
-template<typename SortPolicy>
-NSModel<SortPolicy>& NSModel<SortPolicy>::operator=(const NSModel& other)
+template<typename SortPolicy, typename MatType>
+NSModel<SortPolicy, MatType>& NSModel<SortPolicy, MatType>::operator=(
+    const NSModel& other)
 {
   boost::apply_visitor(DeleteVisitor(), nSearch);
 
@@ -319,12 +459,14 @@ NSModel<SortPolicy>& NSModel<SortPolicy>::operator=(const NSModel& other)
   randomBasis = other.randomBasis;
   q = other.q;
   nSearch = other.nSearch;
+  cache = other.cache;
 
   return *this;
 }
 
-template<typename SortPolicy>
-NSModel<SortPolicy>& NSModel<SortPolicy>::operator=(NSModel&& other)
+template<typename SortPolicy, typename MatType>
+NSModel<SortPolicy, MatType>& NSModel<SortPolicy, MatType>::operator=(
+    NSModel&& other)
 {
   boost::apply_visitor(DeleteVisitor(), nSearch);
 
@@ -336,6 +478,7 @@ NSModel<SortPolicy>& NSModel<SortPolicy>::operator=(NSModel&& other)
   q = std::move(other.q);
   // Copy the pointer and type.
   nSearch = other.nSearch;
+  cache = other.cache;
 
   // Reset parameters of the other model.
   other.treeType = TreeTypes::KD_TREE;
@@ -349,16 +492,17 @@ NSModel<SortPolicy>& NSModel<SortPolicy>::operator=(NSModel&& other)
 }
 
 //! Clean memory, if necessary.
-template<typename SortPolicy>
-NSModel<SortPolicy>::~NSModel()
+template<typename SortPolicy, typename MatType>
+NSModel<SortPolicy, MatType>::~NSModel()
 {
   boost::apply_visitor(DeleteVisitor(), nSearch);
 }
 
 //! Serialize the kNN model.
-template<typename SortPolicy>
+template<typename SortPolicy, typename MatType>
 template<typename Archive>
-void NSModel<SortPolicy>::serialize(Archive& ar, const unsigned int version)
+void NSModel<SortPolicy, MatType>::serialize(Archive& ar,
+                                             const unsigned int version)
 {
   ar & BOOST_SERIALIZATION_NVP(treeType);
   // Backward compatibility: older versions of NSModel didn't include these
@@ -374,62 +518,81 @@ void NSModel<SortPolicy>::serialize(Archive& ar, const unsigned int version)
 
   // This should never happen, but just in case, be clean with memory.
   if (Archive::is_loading::value)
+  {
     boost::apply_visitor(DeleteVisitor(), nSearch);
+    cache.Clear();
+  }
 
   ar & BOOST_SERIALIZATION_NVP(nSearch);
 }
 
 //! Expose the dataset.
-template<typename SortPolicy>
-const arma::mat& NSModel<SortPolicy>::Dataset() const
+template<typename SortPolicy, typename MatType>
+const MatType& NSModel<SortPolicy, MatType>::Dataset() const
 {
-  return boost::apply_visitor(ReferenceSetVisitor(), nSearch);
+  return boost::apply_visitor(ReferenceSetVisitor<MatType>(), nSearch);
 }
 
 //! Access the search mode.
-template<typename SortPolicy>
-NeighborSearchMode NSModel<SortPolicy>::SearchMode() const
+template<typename SortPolicy, typename MatType>
+NeighborSearchMode NSModel<SortPolicy, MatType>::SearchMode() const
 {
   return boost::apply_visitor(SearchModeVisitor(), nSearch);
 }
 
 //! Modify the search mode.
-template<typename SortPolicy>
-NeighborSearchMode& NSModel<SortPolicy>::SearchMode()
+template<typename SortPolicy, typename MatType>
+NeighborSearchMode& NSModel<SortPolicy, MatType>::SearchMode()
 {
   return boost::apply_visitor(SearchModeVisitor(), nSearch);
 }
 
-template<typename SortPolicy>
-double NSModel<SortPolicy>::Epsilon() const
+template<typename SortPolicy, typename MatType>
+double NSModel<SortPolicy, MatType>::Epsilon() const
 {
   return boost::apply_visitor(EpsilonVisitor(), nSearch);
 }
 
-template<typename SortPolicy>
-double& NSModel<SortPolicy>::Epsilon()
+template<typename SortPolicy, typename MatType>
+double& NSModel<SortPolicy, MatType>::Epsilon()
 {
   return boost::apply_visitor(EpsilonVisitor(), nSearch);
 }
 
-//! Build the reference tree.
-template<typename SortPolicy>
-void NSModel<SortPolicy>::BuildModel(arma::mat&& referenceSet,
-                                     const size_t leafSize,
-                                     const NeighborSearchMode searchMode,
-                                     const double epsilon)
+template<typename SortPolicy, typename MatType>
+size_t NSModel<SortPolicy, MatType>::MaxBaseCases() const
+{
+  return boost::apply_visitor(MaxBaseCasesVisitor(), nSearch);
+}
+
+template<typename SortPolicy, typename MatType>
+size_t& NSModel<SortPolicy, MatType>::MaxBaseCases()
 {
+  return boost::apply_visitor(MaxBaseCasesVisitor(), nSearch);
+}
+
+//! Build the reference tree.
+template<typename SortPolicy, typename MatType>
+void NSModel<SortPolicy, MatType>::BuildModel(
+    MatType&& referenceSet,
+    const size_t leafSize,
+    const NeighborSearchMode searchMode,
+    const double epsilon)
+{
+  cache.Clear();
   this->leafSize = leafSize;
   // Initialize random basis if necessary.
   if (randomBasis)
   {
     Log::Info << "Creating random basis..." << std::endl;
+    // The basis is always computed in double precision.
+    arma::mat basis;
     while (true)
     {
       // [Q, R] = qr(randn(d, d));
       // Q = Q * diag(sign(diag(R)));
       arma::mat r;
-      if (arma::qr(q, r, arma::randn<arma::mat>(referenceSet.n_rows,
+      if (arma::qr(basis, r, arma::randn<arma::mat>(referenceSet.n_rows,
               referenceSet.n_rows)))
       {
         arma::vec rDiag(r.n_rows);
@@ -443,13 +606,15 @@ void NSModel<SortPolicy>::BuildModel(arma::mat&& referenceSet,
             rDiag(i) = 0;
         }
 
-        q *= arma::diagmat(rDiag);
+        basis *= arma::diagmat(rDiag);
 
         // Check if the determinant is positive.
-        if (arma::det(q) >= 0)
+        if (arma::det(basis) >= 0)
           break;
       }
     }
+
+    q = arma::conv_to<MatType>::from(basis);
   }
 
   // Clean memory, if necessary.
@@ -459,7 +624,7 @@ void NSModel<SortPolicy>::BuildModel(arma::mat&& referenceSet,
   if (randomBasis)
     referenceSet = q * referenceSet;
 
-  if (searchMode != NAIVE_MODE)
+  if (UsesTree(searchMode))
   {
     Timer::Start("tree_building");
     Log::Info << "Building reference tree..." << std::endl;
@@ -468,70 +633,168 @@ void NSModel<SortPolicy>::BuildModel(arma::mat&& referenceSet,
   switch (treeType)
   {
     case KD_TREE:
-      nSearch = new NSType<SortPolicy, tree::KDTree>(searchMode, epsilon);
+      nSearch = new NSType<SortPolicy, tree::KDTree, MatType>(searchMode,
+          epsilon);
       break;
     case COVER_TREE:
-      nSearch = new NSType<SortPolicy, tree::StandardCoverTree>(searchMode,
-          epsilon);
+      nSearch = new NSType<SortPolicy, tree::StandardCoverTree, MatType>(
+          searchMode, epsilon);
       break;
     case R_TREE:
-      nSearch = new NSType<SortPolicy, tree::RTree>(searchMode, epsilon);
+      nSearch = new NSType<SortPolicy, tree::RTree, MatType>(searchMode,
+          epsilon);
       break;
     case R_STAR_TREE:
-      nSearch = new NSType<SortPolicy, tree::RStarTree>(searchMode, epsilon);
+      nSearch = new NSType<SortPolicy, tree::RStarTree, MatType>(searchMode,
+          epsilon);
       break;
     case BALL_TREE:
-      nSearch = new NSType<SortPolicy, tree::BallTree>(searchMode, epsilon);
+      nSearch = new NSType<SortPolicy, tree::BallTree, MatType>(searchMode,
+          epsilon);
       break;
     case X_TREE:
-      nSearch = new NSType<SortPolicy, tree::XTree>(searchMode, epsilon);
+      nSearch = new NSType<SortPolicy, tree::XTree, MatType>(searchMode,
+          epsilon);
       break;
     case HILBERT_R_TREE:
-      nSearch = new NSType<SortPolicy, tree::HilbertRTree>(searchMode, epsilon);
+      nSearch = new NSType<SortPolicy, tree::HilbertRTree, MatType>(searchMode,
+          epsilon);
       break;
     case R_PLUS_TREE:
-      nSearch = new NSType<SortPolicy, tree::RPlusTree>(searchMode, epsilon);
+      nSearch = new NSType<SortPolicy, tree::RPlusTree, MatType>(searchMode,
+          epsilon);
       break;
     case R_PLUS_PLUS_TREE:
-      nSearch = new NSType<SortPolicy, tree::RPlusPlusTree>(searchMode,
+      nSearch = new NSType<SortPolicy, tree::RPlusPlusTree, MatType>(searchMode,
           epsilon);
       break;
     case VP_TREE:
-      nSearch = new NSType<SortPolicy, tree::VPTree>(searchMode, epsilon);
+      nSearch = new NSType<SortPolicy, tree::VPTree, MatType>(searchMode,
+          epsilon);
       break;
     case RP_TREE:
-      nSearch = new NSType<SortPolicy, tree::RPTree>(searchMode, epsilon);
+      nSearch = new NSType<SortPolicy, tree::RPTree, MatType>(searchMode,
+          epsilon);
       break;
     case MAX_RP_TREE:
-      nSearch = new NSType<SortPolicy, tree::MaxRPTree>(searchMode, epsilon);
+      nSearch = new NSType<SortPolicy, tree::MaxRPTree, MatType>(searchMode,
+          epsilon);
       break;
     case SPILL_TREE:
-      nSearch = new SpillKNN(searchMode, epsilon);
+      nSearch = new DefeatistKNN<tree::SPTree, MatType>(searchMode, epsilon);
       break;
     case UB_TREE:
-      nSearch = new NSType<SortPolicy, tree::UBTree>(searchMode, epsilon);
+      nSearch = new NSType<SortPolicy, tree::UBTree, MatType>(searchMode,
+          epsilon);
       break;
     case OCTREE:
-      nSearch = new NSType<SortPolicy, tree::Octree>(searchMode, epsilon);
+      nSearch = new NSType<SortPolicy, tree::Octree, MatType>(searchMode,
+          epsilon);
       break;
   }
 
-  TrainVisitor<SortPolicy> tn(std::move(referenceSet), leafSize, tau, rho);
+  TrainVisitor<SortPolicy, MatType> tn(std::move(referenceSet), leafSize, tau,
+      rho);
   boost::apply_visitor(tn, nSearch);
 
-  if (searchMode != NAIVE_MODE)
+  if (UsesTree(searchMode))
   {
     Timer::Stop("tree_building");
     Log::Info << "Tree built." << std::endl;
   }
 }
 
+//! Add points to the reference set.
+template<typename SortPolicy, typename MatType>
+void NSModel<SortPolicy, MatType>::Insert(MatType&& points)
+{
+  // The reference set was projected onto the random basis, so the new points
+  // must be too.
+  if (randomBasis)
+    points = q * points;
+
+  UpdateVisitor<MatType> update(points);
+  boost::apply_visitor(update, nSearch);
+  cache.Clear();
+}
+
+//! Remove a point from the reference set.
+template<typename SortPolicy, typename MatType>
+void NSModel<SortPolicy, MatType>::Delete(const size_t index)
+{
+  UpdateVisitor<MatType> update(index);
+  boost::apply_visitor(update, nSearch);
+  cache.Clear();
+}
+
 //! Perform neighbor search.  The query set will be reordered.
-template<typename SortPolicy>
-void NSModel<SortPolicy>::Search(arma::mat&& querySet,
-                                 const size_t k,
-                                 arma::Mat<size_t>& neighbors,
-                                 arma::mat& distances)
+template<typename SortPolicy, typename MatType>
+void NSModel<SortPolicy, MatType>::Search(MatType&& querySet,
+                                          const size_t k,
+                                          arma::Mat<size_t>& neighbors,
+                                          arma::mat& distances)
+{
+  if (!cache.Enabled())
+  {
+    SearchQueries(std::move(querySet), k, neighbors, distances);
+    return;
+  }
+
+  // Take the results of the query points that are in the cache, and only
+  // search the others.
+  const NeighborSearchMode searchMode = SearchMode();
+  const double epsilon = Epsilon();
+  const size_t maxBaseCases = MaxBaseCases();
+  neighbors.set_size(k, querySet.n_cols);
+  distances.set_size(k, querySet.n_cols);
+  std::vector<std::string> keys(querySet.n_cols);
+  std::vector<size_t> missed;
+  arma::Col<size_t> pointNeighbors;
+  arma::vec pointDistances;
+  for (size_t i = 0; i < querySet.n_cols; ++i)
+  {
+    keys[i] = cache.Key(querySet.col(i), k, searchMode, epsilon, maxBaseCases);
+    if (cache.Lookup(keys[i], pointNeighbors, pointDistances))
+    {
+      neighbors.col(i) = pointNeighbors;
+      distances.col(i) = pointDistances;
+    }
+    else
+    {
+      missed.push_back(i);
+    }
+  }
+
+  Log::Info << querySet.n_cols - missed.size() << " of " << querySet.n_cols
+      << " query points found in the cache." << std::endl;
+  if (missed.empty())
+    return;
+
+  arma::uvec indices(missed.size());
+  for (size_t i = 0; i < missed.size(); ++i)
+    indices[i] = missed[i];
+
+  arma::Mat<size_t> missedNeighbors;
+  arma::mat missedDistances;
+  SearchQueries(MatType(querySet.cols(indices)), k, missedNeighbors,
+      missedDistances);
+
+  for (size_t i = 0; i < missed.size(); ++i)
+  {
+    pointNeighbors = missedNeighbors.col(i);
+    pointDistances = missedDistances.col(i);
+    neighbors.col(missed[i]) = pointNeighbors;
+    distances.col(missed[i]) = pointDistances;
+    cache.Store(keys[missed[i]], pointNeighbors, pointDistances);
+  }
+}
+
+//! Search the query set, without the cache.
+template<typename SortPolicy, typename MatType>
+void NSModel<SortPolicy, MatType>::SearchQueries(MatType&& querySet,
+                                                 const size_t k,
+                                                 arma::Mat<size_t>& neighbors,
+                                                 arma::mat& distances)
 {
   // We may need to map the query set randomly.
   if (randomBasis)
@@ -554,18 +817,21 @@ void NSModel<SortPolicy>::Search(arma::mat&& querySet,
       Log::Info << "greedy single-tree " << TreeName() << " search..."
           << std::endl;
       break;
+    case BRUTE_FORCE_MODE:
+      Log::Info << "blocked brute-force search..." << std::endl;
+      break;
   }
 
-  BiSearchVisitor<SortPolicy> search(querySet, k, neighbors, distances,
+  BiSearchVisitor<SortPolicy, MatType> search(querySet, k, neighbors, distances,
       leafSize, tau, rho);
   boost::apply_visitor(search, nSearch);
 }
 
 //! Perform neighbor search.
-template<typename SortPolicy>
-void NSModel<SortPolicy>::Search(const size_t k,
-                                 arma::Mat<size_t>& neighbors,
-                                 arma::mat& distances)
+template<typename SortPolicy, typename MatType>
+void NSModel<SortPolicy, MatType>::Search(const size_t k,
+                                          arma::Mat<size_t>& neighbors,
+                                          arma::mat& distances)
 {
   Log::Info << "Searching for " << k << " neighbors with ";
 
@@ -584,9 +850,12 @@ void NSModel<SortPolicy>::Search(const size_t k,
       Log::Info << "greedy single-tree " << TreeName() << " search..."
           << std::endl;
       break;
+    case BRUTE_FORCE_MODE:
+      Log::Info << "blocked brute-force search..." << std::endl;
+      break;
   }
 
-  if (Epsilon() != 0 && SearchMode() != NAIVE_MODE)
+  if (Epsilon() != 0 && UsesTree(SearchMode()))
     Log::Info << "Maximum of " << Epsilon() * 100 << "% relative error."
         << std::endl;
 
@@ -595,8 +864,8 @@ void NSModel<SortPolicy>::Search(const size_t k,
 }
 
 //! Get the name of the tree type.
-template<typename SortPolicy>
-std::string NSModel<SortPolicy>::TreeName() const
+template<typename SortPolicy, typename MatType>
+std::string NSModel<SortPolicy, MatType>::TreeName() const
 {
   switch (treeType)
   {
@@ -635,6 +904,104 @@ std::string NSModel<SortPolicy>::TreeName() const
   }
 }
 
+//! Save the model in the flat format.
+template<typename SortPolicy, typename MatType>
+void NSModel<SortPolicy, MatType>::SaveFlat(const std::string& filename) const
+{
+  if (randomBasis)
+  {
+    throw std::invalid_argument("NSModel::SaveFlat(): models with a random "
+        "basis can't be saved in the flat format");
+  }
+
+  boost::apply_visitor(SaveFlatVisitor<SortPolicy, MatType>(filename),
+      nSearch);
+
+  // The parameters of the model follow the dataset.
+  NSModelFlatFooter footer;
+  std::memcpy(footer.magic, NSModelFlatMagic, sizeof(footer.magic));
+  footer.treeType = (uint64_t) treeType;
+  footer.leafSize = (uint64_t) leafSize;
+  footer.searchMode = (uint64_t) SearchMode();
+  footer.epsilon = Epsilon();
+  footer.maxBaseCases = (uint64_t) MaxBaseCases();
+
+  std::ofstream out(filename, std::ios::binary | std::ios::app);
+  if (!out.write(reinterpret_cast<const char*>(&footer), sizeof(footer)))
+  {
+    throw std::runtime_error("NSModel::SaveFlat(): cannot write to '" +
+        filename + "'");
+  }
+}
+
+//! Load a model saved in the flat format.
+template<typename SortPolicy, typename MatType>
+void NSModel<SortPolicy, MatType>::LoadFlat(const std::string& filename)
+{
+  std::ifstream in(filename, std::ios::binary | std::ios::ate);
+  if (!in.is_open())
+  {
+    throw std::runtime_error("NSModel::LoadFlat(): cannot open '" + filename +
+        "'");
+  }
+
+  NSModelFlatFooter footer;
+  const std::streamoff length = in.tellg();
+  if (length < (std::streamoff) sizeof(footer) ||
+      !in.seekg(length - sizeof(footer)) ||
+      !in.read(reinterpret_cast<char*>(&footer), sizeof(footer)) ||
+      std::memcmp(footer.magic, NSModelFlatMagic, sizeof(footer.magic)) != 0)
+  {
+    throw std::runtime_error("NSModel::LoadFlat(): '" + filename + "' is not "
+        "a flat neighbor search model file");
+  }
+  in.close();
+
+  if ((footer.treeType != KD_TREE && footer.treeType != BALL_TREE) ||
+      footer.searchMode > BRUTE_FORCE_MODE ||
+      !UsesTree((NeighborSearchMode) footer.searchMode))
+  {
+    throw std::runtime_error("NSModel::LoadFlat(): '" + filename + "' has "
+        "invalid model parameters");
+  }
+
+  // Load the tree into a new object, so that the model is left unchanged if
+  // the file can't be loaded.
+  const NeighborSearchMode searchMode = (NeighborSearchMode) footer.searchMode;
+  decltype(nSearch) loaded;
+  if (footer.treeType == KD_TREE)
+  {
+    loaded = new NSType<SortPolicy, tree::KDTree, MatType>(searchMode,
+        footer.epsilon);
+  }
+  else
+  {
+    loaded = new NSType<SortPolicy, tree::BallTree, MatType>(searchMode,
+        footer.epsilon);
+  }
+
+  try
+  {
+    boost::apply_visitor(LoadFlatVisitor<SortPolicy, MatType>(filename),
+        loaded);
+  }
+  catch (...)
+  {
+    boost::apply_visitor(DeleteVisitor(), loaded);
+    throw;
+  }
+
+  boost::apply_visitor(DeleteVisitor(), nSearch);
+  nSearch = loaded;
+  cache.Clear();
+
+  treeType = (TreeTypes) footer.treeType;
+  leafSize = (size_t) footer.leafSize;
+  randomBasis = false;
+  q.reset();
+  MaxBaseCases() = (size_t) footer.maxBaseCases;
+}
+
 } // namespace neighbor
 } // namespace mlpack
 
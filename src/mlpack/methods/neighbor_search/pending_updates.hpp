@@ -0,0 +1,225 @@
+/**
+ * @file methods/neighbor_search/pending_updates.hpp
+ *
+ * Defines the PendingUpdates class, which holds the insertions and deletions
+ * of reference points that have not yet been applied to a reference tree that
+ * can't be updated in place.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_PENDING_UPDATES_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_PENDING_UPDATES_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace neighbor {
+
+/**
+ * PendingUpdates keeps track of the points that were inserted into and deleted
+ * from a reference set since its tree was built, for trees that can't be
+ * updated in place (such as kd-trees).  Inserted points are kept in a buffer,
+ * and deleted points of the tree are only marked as deleted, so that the tree
+ * is not rebuilt after every update; NeighborSearch rebuilds it when the
+ * number of pending updates exceeds a fraction of the size of the tree (see
+ * NeedsRebuild()).
+ *
+ * The points of the tree are identified by their index when the tree was built
+ * (their "tree index"), and every point has a current index, which is the
+ * index the user sees.  Current indices follow the conventions of
+ * NeighborSearch::Insert() and NeighborSearch::Delete(): inserted points are
+ * appended, and a deleted point is replaced by the last point.
+ *
+ * @tparam MatType Type of the reference set.
+ */
+template<typename MatType>
+class PendingUpdates
+{
+ public:
+  /**
+   * Create an object without any pending updates.
+   *
+   * @param rebuildThreshold Fraction of the size of the tree that the number of
+   *     pending updates must exceed for the tree to be rebuilt.
+   */
+  PendingUpdates(const double rebuildThreshold = 0.05) :
+      rebuildThreshold(rebuildThreshold),
+      active(false),
+      treeSize(0),
+      numDeleted(0)
+  { }
+
+  //! Return whether there are any pending updates.
+  bool Active() const { return active; }
+
+  /**
+   * Start tracking the updates of a tree built on the given number of points,
+   * if no updates are being tracked yet.
+   */
+  void Start(const size_t numPoints)
+  {
+    if (active)
+      return;
+
+    active = true;
+    treeSize = numPoints;
+    numDeleted = 0;
+    locations.resize(numPoints);
+    currentFromTree.resize(numPoints);
+    for (size_t i = 0; i < numPoints; ++i)
+    {
+      locations[i] = i;
+      currentFromTree[i] = i;
+    }
+  }
+
+  //! Forget all the pending updates, once the tree has been rebuilt.
+  void Clear()
+  {
+    active = false;
+    treeSize = 0;
+    numDeleted = 0;
+    locations.clear();
+    currentFromTree.clear();
+    points.reset();
+    pointIndices.clear();
+  }
+
+  /**
+   * Add the given points; they are given the next current indices.  Start()
+   * must have been called.
+   */
+  void Insert(const MatType& newPoints)
+  {
+    for (size_t i = 0; i < newPoints.n_cols; ++i)
+    {
+      locations.push_back(treeSize + points.n_cols + i);
+      pointIndices.push_back(locations.size() - 1);
+    }
+    points.insert_cols(points.n_cols, newPoints);
+  }
+
+  /**
+   * Remove the point with the given current index; the last point takes its
+   * index.  Start() must have been called.
+   */
+  void Delete(const size_t index)
+  {
+    const size_t location = locations[index];
+    if (location < treeSize)
+    {
+      currentFromTree[location] = size_t(-1);
+      ++numDeleted;
+    }
+    else
+    {
+      // Move the last buffered point into the column of the deleted one.
+      const size_t column = location - treeSize;
+      const size_t lastColumn = points.n_cols - 1;
+      if (column != lastColumn)
+      {
+        points.col(column) = points.col(lastColumn);
+        pointIndices[column] = pointIndices[lastColumn];
+        locations[pointIndices[column]] = location;
+      }
+      points.shed_col(lastColumn);
+      pointIndices.pop_back();
+    }
+
+    const size_t last = locations.size() - 1;
+    if (index != last)
+    {
+      const size_t lastLocation = locations[last];
+      locations[index] = lastLocation;
+      if (lastLocation < treeSize)
+        currentFromTree[lastLocation] = index;
+      else
+        pointIndices[lastLocation - treeSize] = index;
+    }
+    locations.pop_back();
+  }
+
+  //! Return whether there are so many pending updates that the tree should be
+  //! rebuilt.
+  bool NeedsRebuild() const
+  {
+    return (double) (points.n_cols + numDeleted) >
+        rebuildThreshold * treeSize;
+  }
+
+  /**
+   * Fill the given matrix with the current reference set, in the order of the
+   * current indices.
+   *
+   * @param treeData The dataset of the tree.
+   * @param oldFromNew The tree index of each point of treeData (empty if the
+   *     tree doesn't rearrange the points).
+   * @param data Matrix to store the current reference set in.
+   */
+  void Assemble(const MatType& treeData,
+                const std::vector<size_t>& oldFromNew,
+                MatType& data) const
+  {
+    std::vector<size_t> newFromOld(treeSize);
+    for (size_t i = 0; i < treeSize; ++i)
+      newFromOld[oldFromNew.empty() ? i : oldFromNew[i]] = i;
+
+    data.set_size(treeData.n_rows, locations.size());
+    for (size_t i = 0; i < locations.size(); ++i)
+    {
+      if (locations[i] < treeSize)
+        data.col(i) = treeData.col(newFromOld[locations[i]]);
+      else
+        data.col(i) = points.col(locations[i] - treeSize);
+    }
+  }
+
+  //! Return the current number of points.
+  size_t Size() const { return locations.size(); }
+  //! Return the number of points of the tree that are deleted.
+  size_t NumDeleted() const { return numDeleted; }
+
+  //! Return the current index of the point of the tree with the given tree
+  //! index, or size_t(-1) if it was deleted.
+  size_t CurrentIndex(const size_t treeIndex) const
+  { return currentFromTree[treeIndex]; }
+
+  //! Get the points that were inserted and are not in the tree.
+  const MatType& Points() const { return points; }
+  //! Get the current index of each column of Points().
+  const std::vector<size_t>& PointIndices() const { return pointIndices; }
+
+  //! Get the fraction of the size of the tree that the number of pending
+  //! updates must exceed for the tree to be rebuilt.
+  double RebuildThreshold() const { return rebuildThreshold; }
+  //! Modify the fraction of the size of the tree that the number of pending
+  //! updates must exceed for the tree to be rebuilt.
+  double& RebuildThreshold() { return rebuildThreshold; }
+
+ private:
+  //! The fraction of the size of the tree above which the tree is rebuilt.
+  double rebuildThreshold;
+  //! Whether any updates are being tracked.
+  bool active;
+  //! The number of points of the tree when it was built.
+  size_t treeSize;
+  //! The number of points of the tree that are deleted.
+  size_t numDeleted;
+  //! The location of each current point: a tree index if it is less than
+  //! treeSize, and otherwise treeSize plus its column in points.
+  std::vector<size_t> locations;
+  //! The current index of each point of the tree (size_t(-1) if deleted).
+  std::vector<size_t> currentFromTree;
+  //! The points that were inserted since the tree was built.
+  MatType points;
+  //! The current index of each column of points.
+  std::vector<size_t> pointIndices;
+};
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
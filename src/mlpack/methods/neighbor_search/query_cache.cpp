@@ -0,0 +1,157 @@
+/**
+ * @file methods/neighbor_search/query_cache.cpp
+ *
+ * Implementation of the QueryCache class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "query_cache.hpp"
+
+using namespace mlpack;
+using namespace mlpack::neighbor;
+
+QueryCache::QueryCache(const size_t capacity,
+                       const double quantum,
+                       const size_t shards) :
+    capacity(capacity),
+    quantum(quantum),
+    hits(0),
+    misses(0)
+{
+  if (quantum < 0.0)
+  {
+    throw std::invalid_argument("QueryCache::QueryCache(): the quantum must "
+        "not be negative!");
+  }
+  if (shards == 0)
+  {
+    throw std::invalid_argument("QueryCache::QueryCache(): the number of "
+        "shards must be positive!");
+  }
+
+  CreateShards(shards);
+}
+
+QueryCache::QueryCache(const QueryCache& other) :
+    capacity(other.capacity),
+    quantum(other.quantum),
+    hits(0),
+    misses(0)
+{
+  CreateShards(other.shards.size());
+}
+
+QueryCache& QueryCache::operator=(const QueryCache& other)
+{
+  if (this != &other)
+  {
+    capacity = other.capacity;
+    quantum = other.quantum;
+    CreateShards(other.shards.size());
+  }
+
+  return *this;
+}
+
+bool QueryCache::Lookup(const std::string& key,
+                        arma::Col<size_t>& neighbors,
+                        arma::vec& distances)
+{
+  if (capacity == 0)
+    return false;
+
+  Shard& shard = ShardOf(key);
+  std::lock_guard<std::mutex> guard(shard.lock);
+  auto it = shard.positions.find(key);
+  if (it == shard.positions.end())
+  {
+    misses.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+
+  // Move the entry to the front of the list.
+  shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+  neighbors = it->second->neighbors;
+  distances = it->second->distances;
+  hits.fetch_add(1, std::memory_order_relaxed);
+  return true;
+}
+
+void QueryCache::Store(const std::string& key,
+                       const arma::Col<size_t>& neighbors,
+                       const arma::vec& distances)
+{
+  if (capacity == 0)
+    return;
+
+  Shard& shard = ShardOf(key);
+  std::lock_guard<std::mutex> guard(shard.lock);
+  auto it = shard.positions.find(key);
+  if (it != shard.positions.end())
+  {
+    // Another thread stored the results of the key in the meantime.
+    shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+    it->second->neighbors = neighbors;
+    it->second->distances = distances;
+    return;
+  }
+
+  if (shard.entries.size() == shardCapacity)
+  {
+    // Reuse the least recently used entry.
+    shard.positions.erase(shard.entries.back().key);
+    shard.entries.splice(shard.entries.begin(), shard.entries,
+        std::prev(shard.entries.end()));
+  }
+  else
+  {
+    shard.entries.emplace_front();
+  }
+
+  Entry& entry = shard.entries.front();
+  entry.key = key;
+  entry.neighbors = neighbors;
+  entry.distances = distances;
+  shard.positions[key] = shard.entries.begin();
+}
+
+void QueryCache::Clear()
+{
+  for (size_t i = 0; i < shards.size(); ++i)
+  {
+    std::lock_guard<std::mutex> guard(shards[i]->lock);
+    shards[i]->entries.clear();
+    shards[i]->positions.clear();
+  }
+}
+
+size_t QueryCache::Size() const
+{
+  size_t size = 0;
+  for (size_t i = 0; i < shards.size(); ++i)
+  {
+    std::lock_guard<std::mutex> guard(shards[i]->lock);
+    size += shards[i]->entries.size();
+  }
+
+  return size;
+}
+
+QueryCache::Shard& QueryCache::ShardOf(const std::string& key)
+{
+  return *shards[std::hash<std::string>()(key) % shards.size()];
+}
+
+void QueryCache::CreateShards(const size_t count)
+{
+  // There is no use in more shards than results.
+  const size_t used = std::max(std::min(count, capacity), (size_t) 1);
+  shards.clear();
+  for (size_t i = 0; i < used; ++i)
+    shards.emplace_back(new Shard());
+
+  shardCapacity = (capacity + used - 1) / used;
+}
@@ -0,0 +1,204 @@
+/**
+ * @file methods/neighbor_search/query_cache.hpp
+ *
+ * Defines the QueryCache class, a concurrent LRU cache of the results of
+ * neighbor searches.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_QUERY_CACHE_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_QUERY_CACHE_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace mlpack {
+namespace neighbor {
+
+/**
+ * A QueryCache keeps the neighbors and distances found for the most recently
+ * searched query points, so that a query point that is searched again (for
+ * instance, by a server that gets the same requests over and over) is answered
+ * without a search.  The results are keyed on the query point and the
+ * parameters of the search (see Key()); the query point can be quantized, so
+ * that query points whose coordinates are within the same multiples of the
+ * quantum share their results.  Those results are then the ones of the first
+ * of these query points that was searched, so a quantum should only be given
+ * if this approximation is acceptable.
+ *
+ * The cache is split into shards, each with its own lock and an equal share
+ * of the capacity, so that it can be used by many threads at once; when a
+ * shard is full, its least recently used results are evicted.  A cache with
+ * capacity 0 (the default) is disabled.
+ *
+ * The cache doesn't know when the reference set changes: the owner must call
+ * Clear() then, as NSModel does when it is trained or updated.
+ */
+class QueryCache
+{
+ public:
+  /**
+   * Create a cache with the given capacity.
+   *
+   * @param capacity Number of query points whose results are kept (0 disables
+   *     the cache).
+   * @param quantum If positive, query points whose coordinates fall in the
+   *     same intervals [i * quantum, (i + 1) * quantum) have the same key.
+   * @param shards Number of independently locked parts of the cache.
+   */
+  QueryCache(const size_t capacity = 0,
+             const double quantum = 0.0,
+             const size_t shards = 16);
+
+  /**
+   * Create an empty cache with the same settings as the given cache (the
+   * results aren't copied).
+   */
+  QueryCache(const QueryCache& other);
+
+  /**
+   * Take the settings of the given cache and clear the results.
+   */
+  QueryCache& operator=(const QueryCache& other);
+
+  /**
+   * Build the key of the given query point, for a search with the given
+   * parameters.  Each parameter must be a trivially copyable value, such as a
+   * number or an enum.
+   *
+   * @param query Query point.
+   * @param parameters Parameters of the search (such as k).
+   */
+  template<typename VecType, typename... ParameterTypes>
+  std::string Key(const VecType& query,
+                  const ParameterTypes&... parameters) const;
+
+  /**
+   * Look up the results of the given key.  If they are found, they are stored
+   * in the given vectors, and they become the most recently used results.
+   *
+   * @param key Key of the query point.
+   * @param neighbors Vector to store the neighbors in.
+   * @param distances Vector to store the distances in.
+   * @return Whether the results were found.
+   */
+  bool Lookup(const std::string& key,
+              arma::Col<size_t>& neighbors,
+              arma::vec& distances);
+
+  /**
+   * Store the results of the given key, evicting the least recently used
+   * results of its shard if needed.
+   *
+   * @param key Key of the query point.
+   * @param neighbors Neighbors of the query point.
+   * @param distances Distances of the neighbors.
+   */
+  void Store(const std::string& key,
+             const arma::Col<size_t>& neighbors,
+             const arma::vec& distances);
+
+  //! Remove all the results (the statistics are kept).
+  void Clear();
+
+  //! Get whether the cache is enabled (its capacity is positive).
+  bool Enabled() const { return capacity > 0; }
+  //! Get the number of query points whose results can be kept.
+  size_t Capacity() const { return capacity; }
+  //! Get the quantum of the coordinates of the query points.
+  double Quantum() const { return quantum; }
+  //! Get the number of shards.
+  size_t Shards() const { return shards.size(); }
+
+  //! Get the number of query points whose results are kept.
+  size_t Size() const;
+  //! Get the number of successful lookups.
+  size_t Hits() const { return hits.load(std::memory_order_relaxed); }
+  //! Get the number of failed lookups.
+  size_t Misses() const { return misses.load(std::memory_order_relaxed); }
+
+ private:
+  //! Results of a query point.
+  struct Entry
+  {
+    std::string key;
+    arma::Col<size_t> neighbors;
+    arma::vec distances;
+  };
+
+  //! A part of the cache, with its own lock: its entries from the most to the
+  //! least recently used, and the position of each key in the list.
+  struct Shard
+  {
+    std::mutex lock;
+    std::list<Entry> entries;
+    std::unordered_map<std::string, std::list<Entry>::iterator> positions;
+  };
+
+  //! Append the raw bytes of the given value to the key.
+  template<typename T>
+  static void Append(std::string& key, const T& value);
+
+  //! Get the shard of the given key.
+  Shard& ShardOf(const std::string& key);
+
+  //! Create the shards.
+  void CreateShards(const size_t count);
+
+  //! The number of query points whose results can be kept.
+  size_t capacity;
+  //! The quantum of the coordinates of the query points (0 for none).
+  double quantum;
+  //! The number of results each shard can keep.
+  size_t shardCapacity;
+  //! The shards of the cache.
+  std::vector<std::unique_ptr<Shard>> shards;
+  //! The number of successful lookups.
+  std::atomic<size_t> hits;
+  //! The number of failed lookups.
+  std::atomic<size_t> misses;
+};
+
+template<typename T>
+void QueryCache::Append(std::string& key, const T& value)
+{
+  static_assert(std::is_trivially_copyable<T>::value, "QueryCache::Key(): "
+      "the parameters of a search must be trivially copyable");
+  key.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template<typename VecType, typename... ParameterTypes>
+std::string QueryCache::Key(const VecType& query,
+                            const ParameterTypes&... parameters) const
+{
+  std::string key;
+  key.reserve((sizeof...(ParameterTypes) + query.n_elem) * sizeof(double));
+
+  // Expand the parameters in order.
+  const int expand[] = { 0, (Append(key, parameters), 0)... };
+  (void) expand;
+
+  for (size_t i = 0; i < query.n_elem; ++i)
+  {
+    const double value = (double) query[i];
+    if (quantum > 0.0)
+      Append(key, (int64_t) std::floor(value / quantum));
+    else
+      Append(key, (value == 0.0) ? 0.0 : value); // -0 and +0 are the same.
+  }
+
+  return key;
+}
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
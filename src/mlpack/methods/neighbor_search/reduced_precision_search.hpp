@@ -0,0 +1,196 @@
+/**
+ * @file methods/neighbor_search/reduced_precision_search.hpp
+ *
+ * Defines the ReducedPrecisionSearch class, which performs nearest neighbor
+ * search with a kd-tree whose reference points are stored in a 16-bit
+ * floating-point format.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_REDUCED_PRECISION_SEARCH_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_REDUCED_PRECISION_SEARCH_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <mlpack/core/math/half_precision.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
+#include <mlpack/core/tree/binary_space_tree.hpp>
+
+namespace mlpack {
+namespace neighbor {
+
+/**
+ * The ReducedPrecisionSearch class computes the nearest neighbors of query
+ * points with a kd-tree over reference points stored with 16 bits per
+ * coordinate (math::BFloat16 or math::Float16), a quarter of the memory of
+ * double precision and half that of single precision.  Since a nearest
+ * neighbor search scans the reference points of many leaves, and is usually
+ * bound by the memory bandwidth, the smaller points make the base cases
+ * faster.
+ *
+ * The tree is built on the reference set in single precision and only its
+ * structure and its bounds (in single precision) are kept, together with the
+ * encoded points in the order of the tree.  A query is searched depth-first,
+ * nearer children first, and the distances are computed from the decoded
+ * points and accumulated in single precision, so they are approximate.  For
+ * exact results, Search() can re-rank a larger set of candidates with the
+ * reference set in its original precision, which the caller keeps (for
+ * instance memory-mapped or on another device) and only needs to give to the
+ * search.
+ *
+ * @tparam MetricType The L-metric to use (EuclideanDistance by default).
+ * @tparam EncodingType The 16-bit format of the reference points
+ *     (math::BFloat16 or math::Float16).
+ */
+template<typename MetricType = metric::EuclideanDistance,
+         typename EncodingType = math::BFloat16>
+class ReducedPrecisionSearch
+{
+ public:
+  //! The type of the bounds of the nodes of the tree.
+  typedef bound::HRectBound<MetricType, float> BoundType;
+
+  /**
+   * Encode the given reference set and build the tree on it.
+   *
+   * @param referenceSet Set of reference points.
+   * @param leafSize Maximum number of points in a leaf of the tree.
+   */
+  template<typename MatType>
+  ReducedPrecisionSearch(const MatType& referenceSet,
+                         const size_t leafSize = 20);
+
+  /**
+   * Create an untrained model.  Be sure to call Train() before calling
+   * Search(); otherwise, an exception will be thrown when Search() is called.
+   */
+  ReducedPrecisionSearch();
+
+  /**
+   * Encode the given reference set and build the tree on it, replacing the
+   * current model.
+   *
+   * @param referenceSet Set of reference points.
+   * @param leafSize Maximum number of points in a leaf of the tree.
+   */
+  template<typename MatType>
+  void Train(const MatType& referenceSet, const size_t leafSize = 20);
+
+  /**
+   * Compute the approximate nearest neighbors of the points in the given query
+   * set, with the distances to the encoded reference points.  The matrices
+   * will be set to k rows and one column per query point.
+   *
+   * @param querySet Set of query points.
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix storing lists of neighbors for each query point.
+   * @param distances Matrix storing distances of neighbors for each query
+   *     point.
+   */
+  template<typename MatType>
+  void Search(const MatType& querySet,
+              const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances) const;
+
+  /**
+   * Compute the nearest neighbors of the points in the given query set, with
+   * exact distances: the `rerank` nearest encoded reference points are found
+   * for each query, and the k nearest of them are given with their distances
+   * computed from the given reference set, which must be the original
+   * reference set the model was trained on.
+   *
+   * @param querySet Set of query points.
+   * @param referenceSet The original reference set.
+   * @param k Number of neighbors to search for.
+   * @param rerank Number of candidates re-ranked for each query (at least k).
+   * @param neighbors Matrix storing lists of neighbors for each query point.
+   * @param distances Matrix storing distances of neighbors for each query
+   *     point.
+   */
+  template<typename MatType>
+  void Search(const MatType& querySet,
+              const MatType& referenceSet,
+              const size_t k,
+              const size_t rerank,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances) const;
+
+  /**
+   * Serialize the model.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+  //! Get the dimensionality of the reference points.
+  size_t Dimensionality() const { return codes.n_rows; }
+
+  //! Get the number of reference points.
+  size_t NumPoints() const { return codes.n_cols; }
+
+  //! Get the number of nodes of the tree.
+  size_t NumNodes() const { return nodes.size(); }
+
+  //! Get the encoded reference points, in the order of the tree.
+  const arma::Mat<uint16_t>& Codes() const { return codes; }
+
+  //! Get the original index of each reference point in the order of the tree.
+  const arma::Col<size_t>& OldFromNew() const { return oldFromNew; }
+
+ private:
+  //! A node of the tree: the points Begin() to Begin() + Count() - 1 of the
+  //! tree order, and its two children (both 0 for a leaf).
+  struct Node
+  {
+    size_t begin;
+    size_t count;
+    size_t left;
+    size_t right;
+    BoundType bound;
+
+    //! Serialize the node.
+    template<typename Archive>
+    void serialize(Archive& ar, const unsigned int /* version */)
+    {
+      ar & BOOST_SERIALIZATION_NVP(begin);
+      ar & BOOST_SERIALIZATION_NVP(count);
+      ar & BOOST_SERIALIZATION_NVP(left);
+      ar & BOOST_SERIALIZATION_NVP(right);
+      ar & BOOST_SERIALIZATION_NVP(bound);
+    }
+  };
+
+  //! Add the given node of a tree and its descendants to the nodes, and
+  //! return its index.
+  template<typename TreeType>
+  size_t AddNode(const TreeType& node);
+
+  //! Find the `count` nearest encoded reference points of the given query,
+  //! as (distance, index in the tree order) pairs sorted by distance.
+  void SearchPoint(const arma::fvec& query,
+                   const size_t count,
+                   std::vector<std::pair<float, size_t>>& candidates) const;
+
+  //! Compute the distance between the given query and encoded point.
+  float Distance(const float* query, const uint16_t* code) const;
+
+  //! Locally-stored encoded reference points, in the order of the tree.
+  arma::Mat<uint16_t> codes;
+
+  //! Locally-stored original index of each point of the tree order.
+  arma::Col<size_t> oldFromNew;
+
+  //! Locally-stored nodes of the tree; the root is node 0.
+  std::vector<Node> nodes;
+}; // class ReducedPrecisionSearch
+
+} // namespace neighbor
+} // namespace mlpack
+
+// Include implementation.
+#include "reduced_precision_search_impl.hpp"
+
+#endif
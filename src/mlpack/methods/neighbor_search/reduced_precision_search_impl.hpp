@@ -0,0 +1,311 @@
+/**
+ * @file methods/neighbor_search/reduced_precision_search_impl.hpp
+ *
+ * Implementation of the ReducedPrecisionSearch class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_REDUCED_PRECISION_SEARCH_IMPL_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_REDUCED_PRECISION_SEARCH_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "reduced_precision_search.hpp"
+
+namespace mlpack {
+namespace neighbor {
+
+template<typename MetricType, typename EncodingType>
+template<typename MatType>
+ReducedPrecisionSearch<MetricType, EncodingType>::ReducedPrecisionSearch(
+    const MatType& referenceSet,
+    const size_t leafSize)
+{
+  Train(referenceSet, leafSize);
+}
+
+template<typename MetricType, typename EncodingType>
+ReducedPrecisionSearch<MetricType, EncodingType>::ReducedPrecisionSearch()
+{
+  // Nothing to do.
+}
+
+template<typename MetricType, typename EncodingType>
+template<typename MatType>
+void ReducedPrecisionSearch<MetricType, EncodingType>::Train(
+    const MatType& referenceSet,
+    const size_t leafSize)
+{
+  if (referenceSet.n_cols == 0)
+  {
+    throw std::invalid_argument("ReducedPrecisionSearch::Train(): the "
+        "reference set is empty!");
+  }
+  if (leafSize == 0)
+  {
+    throw std::invalid_argument("ReducedPrecisionSearch::Train(): the leaf "
+        "size must be positive!");
+  }
+
+  // Build a kd-tree on the reference set in single precision; only its
+  // structure and its bounds are kept.
+  typedef tree::KDTree<MetricType, tree::EmptyStatistic, arma::fmat> TreeType;
+  std::vector<size_t> oldFromNewReferences;
+  TreeType tree(arma::conv_to<arma::fmat>::from(referenceSet),
+      oldFromNewReferences, leafSize);
+
+  nodes.clear();
+  AddNode(tree);
+  oldFromNew = arma::conv_to<arma::Col<size_t>>::from(oldFromNewReferences);
+
+  // Encode the points in the order of the tree.
+  const arma::fmat& dataset = tree.Dataset();
+  codes.set_size(dataset.n_rows, dataset.n_cols);
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) dataset.n_cols; ++i)
+    for (size_t d = 0; d < dataset.n_rows; ++d)
+      codes(d, i) = EncodingType::Encode(dataset(d, i));
+}
+
+template<typename MetricType, typename EncodingType>
+template<typename MatType>
+void ReducedPrecisionSearch<MetricType, EncodingType>::Search(
+    const MatType& querySet,
+    const size_t k,
+    arma::Mat<size_t>& neighbors,
+    arma::mat& distances) const
+{
+  if (nodes.empty())
+  {
+    throw std::invalid_argument("ReducedPrecisionSearch::Search(): the model "
+        "is not trained!");
+  }
+  if (querySet.n_rows != codes.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "ReducedPrecisionSearch::Search(): dimensionality of query set ("
+        << querySet.n_rows << ") is not equal to the dimensionality the model "
+        << "was trained on (" << codes.n_rows << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+  if (k > codes.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "ReducedPrecisionSearch::Search(): requested " << k << " neighbors,"
+        << " but the reference set has only " << codes.n_cols << " points!";
+    throw std::invalid_argument(oss.str());
+  }
+  if (k == 0)
+  {
+    throw std::invalid_argument("ReducedPrecisionSearch::Search(): the number "
+        "of neighbors must be positive!");
+  }
+
+  neighbors.set_size(k, querySet.n_cols);
+  distances.set_size(k, querySet.n_cols);
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t q = 0; q < (omp_size_t) querySet.n_cols; ++q)
+  {
+    const arma::fvec query = arma::conv_to<arma::fvec>::from(querySet.col(q));
+    std::vector<std::pair<float, size_t>> candidates;
+    SearchPoint(query, k, candidates);
+
+    for (size_t i = 0; i < k; ++i)
+    {
+      neighbors(i, q) = oldFromNew[candidates[i].second];
+      distances(i, q) = candidates[i].first;
+    }
+  }
+}
+
+template<typename MetricType, typename EncodingType>
+template<typename MatType>
+void ReducedPrecisionSearch<MetricType, EncodingType>::Search(
+    const MatType& querySet,
+    const MatType& referenceSet,
+    const size_t k,
+    const size_t rerank,
+    arma::Mat<size_t>& neighbors,
+    arma::mat& distances) const
+{
+  if (referenceSet.n_rows != codes.n_rows ||
+      referenceSet.n_cols != codes.n_cols)
+  {
+    throw std::invalid_argument("ReducedPrecisionSearch::Search(): the "
+        "reference set is not the one the model was trained on!");
+  }
+  if (k > codes.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "ReducedPrecisionSearch::Search(): requested " << k << " neighbors,"
+        << " but the reference set has only " << codes.n_cols << " points!";
+    throw std::invalid_argument(oss.str());
+  }
+  if (rerank < k)
+  {
+    throw std::invalid_argument("ReducedPrecisionSearch::Search(): the number "
+        "of candidates to re-rank must be at least k!");
+  }
+
+  // Find the candidates; this checks the other parameters.
+  arma::Mat<size_t> candidates;
+  arma::mat candidateDistances;
+  Search(querySet, std::min(rerank, (size_t) codes.n_cols), candidates,
+      candidateDistances);
+
+  neighbors.set_size(k, querySet.n_cols);
+  distances.set_size(k, querySet.n_cols);
+
+  #pragma omp parallel for
+  for (omp_size_t q = 0; q < (omp_size_t) querySet.n_cols; ++q)
+  {
+    std::vector<std::pair<double, size_t>> exact(candidates.n_rows);
+    for (size_t i = 0; i < candidates.n_rows; ++i)
+    {
+      exact[i] = std::make_pair((double) MetricType::Evaluate(querySet.col(q),
+          referenceSet.col(candidates(i, q))), candidates(i, q));
+    }
+
+    std::partial_sort(exact.begin(), exact.begin() + k, exact.end());
+    for (size_t i = 0; i < k; ++i)
+    {
+      neighbors(i, q) = exact[i].second;
+      distances(i, q) = exact[i].first;
+    }
+  }
+}
+
+template<typename MetricType, typename EncodingType>
+template<typename Archive>
+void ReducedPrecisionSearch<MetricType, EncodingType>::serialize(
+    Archive& ar,
+    const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(codes);
+  ar & BOOST_SERIALIZATION_NVP(oldFromNew);
+  ar & BOOST_SERIALIZATION_NVP(nodes);
+}
+
+template<typename MetricType, typename EncodingType>
+template<typename TreeType>
+size_t ReducedPrecisionSearch<MetricType, EncodingType>::AddNode(
+    const TreeType& node)
+{
+  const size_t index = nodes.size();
+  nodes.push_back(Node());
+  nodes[index].begin = node.Begin();
+  nodes[index].count = node.Count();
+  nodes[index].bound = node.Bound();
+
+  // The root is node 0, so no child is node 0.
+  size_t left = 0, right = 0;
+  if (node.NumChildren() > 0)
+  {
+    left = AddNode(node.Child(0));
+    right = AddNode(node.Child(1));
+  }
+
+  // The vector may have been reallocated by the children.
+  nodes[index].left = left;
+  nodes[index].right = right;
+  return index;
+}
+
+template<typename MetricType, typename EncodingType>
+void ReducedPrecisionSearch<MetricType, EncodingType>::SearchPoint(
+    const arma::fvec& query,
+    const size_t count,
+    std::vector<std::pair<float, size_t>>& candidates) const
+{
+  // The candidates are a max-heap on the distance, so the worst one is at the
+  // front.
+  candidates.clear();
+  candidates.reserve(count);
+
+  // Search depth-first, the nearer child first.
+  std::vector<std::pair<float, size_t>> stack;
+  stack.push_back(std::make_pair(nodes[0].bound.MinDistance(query),
+      (size_t) 0));
+  while (!stack.empty())
+  {
+    const float nodeDistance = stack.back().first;
+    const Node& node = nodes[stack.back().second];
+    stack.pop_back();
+
+    if (candidates.size() == count && nodeDistance > candidates.front().first)
+      continue;
+
+    if (node.left == 0)
+    {
+      for (size_t i = node.begin; i < node.begin + node.count; ++i)
+      {
+        const float distance = Distance(query.memptr(), codes.colptr(i));
+        if (candidates.size() < count)
+        {
+          candidates.push_back(std::make_pair(distance, i));
+          std::push_heap(candidates.begin(), candidates.end());
+        }
+        else if (distance < candidates.front().first)
+        {
+          std::pop_heap(candidates.begin(), candidates.end());
+          candidates.back() = std::make_pair(distance, i);
+          std::push_heap(candidates.begin(), candidates.end());
+        }
+      }
+    }
+    else
+    {
+      const float leftDistance = nodes[node.left].bound.MinDistance(query);
+      const float rightDistance = nodes[node.right].bound.MinDistance(query);
+      if (leftDistance <= rightDistance)
+      {
+        stack.push_back(std::make_pair(rightDistance, node.right));
+        stack.push_back(std::make_pair(leftDistance, node.left));
+      }
+      else
+      {
+        stack.push_back(std::make_pair(leftDistance, node.left));
+        stack.push_back(std::make_pair(rightDistance, node.right));
+      }
+    }
+  }
+
+  std::sort_heap(candidates.begin(), candidates.end());
+}
+
+template<typename MetricType, typename EncodingType>
+float ReducedPrecisionSearch<MetricType, EncodingType>::Distance(
+    const float* query,
+    const uint16_t* code) const
+{
+  // The power is known at compile time, so only one branch is kept.
+  float sum = 0;
+  for (size_t d = 0; d < codes.n_rows; ++d)
+  {
+    const float diff = std::abs(query[d] - EncodingType::Decode(code[d]));
+    if (MetricType::Power == 1)
+      sum += diff;
+    else if (MetricType::Power == 2)
+      sum += diff * diff;
+    else if (MetricType::Power == INT_MAX)
+      sum = std::max(sum, diff);
+    else
+      sum += std::pow(diff, (float) MetricType::Power);
+  }
+
+  if (!MetricType::TakeRoot || MetricType::Power == 1 ||
+      MetricType::Power == INT_MAX)
+    return sum;
+  else if (MetricType::Power == 2)
+    return std::sqrt(sum);
+  else
+    return std::pow(sum, 1.0f / MetricType::Power);
+}
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,132 @@
+/**
+ * @file methods/neighbor_search/sharded_neighbor_search.hpp
+ *
+ * Defines the ShardedNeighborSearch class, which computes the k nearest
+ * neighbors in a reference set split into shards, possibly held by other
+ * processes.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_SHARDED_NEIGHBOR_SEARCH_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_SHARDED_NEIGHBOR_SEARCH_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "local_shard_transport.hpp"
+
+namespace mlpack {
+namespace neighbor {
+
+/**
+ * The ShardedNeighborSearch class computes the exact k nearest neighbors of a
+ * query set in a reference set split into shards, each one searched with its
+ * own tree by whoever holds it; the shards are reached through a transport.
+ * The queries are sent in batches, and the k nearest neighbors found by each
+ * shard are merged.
+ *
+ * With pruning, each query of a batch is first sent to the shard whose bound
+ * is nearest to it; it is then sent to another shard only if the bound of the
+ * shard is nearer than the k'th neighbor found so far, so that the shards far
+ * from a query are never searched for it.
+ *
+ * The transport must provide these methods (see LocalShardTransport, which
+ * holds the shards in the process itself; a transport to the ranks of an MPI
+ * job implements them with messages, each rank serving its shard):
+ *
+ * @code
+ * // The type of the data.
+ * typedef ... DataType;
+ * // The number of shards, and the total number of reference points.
+ * size_t NumShards() const;
+ * size_t NumPoints() const;
+ * // A bound of the points of each shard, with a MinDistance(point) method.
+ * const BoundType& Bound(const size_t shard) const;
+ * // Search each shard for the k nearest neighbors of its queries (global
+ * // indices, padded with SIZE_MAX and DBL_MAX).
+ * void Search(const std::vector<DataType>& queries,
+ *             const size_t k,
+ *             std::vector<arma::Mat<size_t>>& neighbors,
+ *             std::vector<arma::mat>& distances);
+ * @endcode
+ *
+ * @tparam TransportType The transport to the shards.
+ */
+template<typename TransportType = LocalShardTransport<>>
+class ShardedNeighborSearch
+{
+ public:
+  //! The type of the data.
+  typedef typename TransportType::DataType MatType;
+
+  /**
+   * Create the object with the given transport.
+   *
+   * @param transport The transport to the shards.
+   */
+  ShardedNeighborSearch(TransportType transport = TransportType());
+
+  /**
+   * Compute the k nearest neighbors of the points in the given query set and
+   * store the output in the given matrices, as NeighborSearch::Search() does.
+   * If the reference set has fewer than k points, the remaining neighbors are
+   * SIZE_MAX and their distances DBL_MAX.
+   *
+   * @param querySet Set of query points.
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix storing lists of neighbors for each query point.
+   * @param distances Matrix storing distances of neighbors for each query
+   *     point.
+   * @param batchSize The number of queries sent at once; 0 to send them all
+   *     at once.
+   * @param prune If true, the bounds of the shards are used so that a query
+   *     is only sent to the shards that can hold one of its neighbors.
+   */
+  void Search(const MatType& querySet,
+              const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances,
+              const size_t batchSize = 0,
+              const bool prune = true);
+
+  //! Get the transport.
+  const TransportType& Transport() const { return transport; }
+  //! Modify the transport.
+  TransportType& Transport() { return transport; }
+
+  //! Get the number of (query, shard) pairs searched by the last search.
+  size_t ShardQueries() const { return shardQueries; }
+
+ private:
+  /**
+   * Send the given queries of a batch to each shard, and merge the results
+   * into the neighbors of the batch.
+   *
+   * @param batch The queries of the batch.
+   * @param k The number of neighbors to search for.
+   * @param requests The indices (in the batch) of the queries of each shard.
+   * @param neighbors The neighbors of the batch.
+   * @param distances The distances of the neighbors of the batch.
+   */
+  void SearchShards(const MatType& batch,
+                    const size_t k,
+                    const std::vector<std::vector<size_t>>& requests,
+                    arma::Mat<size_t>& neighbors,
+                    arma::mat& distances);
+
+  //! The transport to the shards.
+  TransportType transport;
+
+  //! The number of (query, shard) pairs searched by the last search.
+  size_t shardQueries;
+};
+
+} // namespace neighbor
+} // namespace mlpack
+
+// Include implementation.
+#include "sharded_neighbor_search_impl.hpp"
+
+#endif
@@ -0,0 +1,159 @@
+/**
+ * @file methods/neighbor_search/sharded_neighbor_search_impl.hpp
+ *
+ * Implementation of the ShardedNeighborSearch class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_SHARDED_NEIGHBOR_SEARCH_IMPL_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_SHARDED_NEIGHBOR_SEARCH_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "sharded_neighbor_search.hpp"
+
+namespace mlpack {
+namespace neighbor {
+
+template<typename TransportType>
+ShardedNeighborSearch<TransportType>::ShardedNeighborSearch(
+    TransportType transport) :
+    transport(std::move(transport)),
+    shardQueries(0)
+{
+  // Nothing to do here.
+}
+
+template<typename TransportType>
+void ShardedNeighborSearch<TransportType>::Search(
+    const MatType& querySet,
+    const size_t k,
+    arma::Mat<size_t>& neighbors,
+    arma::mat& distances,
+    const size_t batchSize,
+    const bool prune)
+{
+  const size_t numShards = transport.NumShards();
+  if (numShards == 0)
+    throw std::invalid_argument("ShardedNeighborSearch::Search(): no shards!");
+
+  neighbors.set_size(k, querySet.n_cols);
+  distances.set_size(k, querySet.n_cols);
+  shardQueries = 0;
+
+  // If the user asked for 0 nearest neighbors... uh... we're done.
+  if (k == 0 || querySet.n_cols == 0)
+    return;
+
+  const size_t batch = (batchSize == 0) ? querySet.n_cols : batchSize;
+  for (size_t first = 0; first < querySet.n_cols; first += batch)
+  {
+    const size_t last = std::min(first + batch, (size_t) querySet.n_cols) - 1;
+    const MatType queries = querySet.cols(first, last);
+    arma::Mat<size_t> batchNeighbors(k, queries.n_cols);
+    arma::mat batchDistances(k, queries.n_cols);
+    batchNeighbors.fill(SIZE_MAX);
+    batchDistances.fill(DBL_MAX);
+
+    std::vector<std::vector<size_t>> requests(numShards);
+    if (!prune)
+    {
+      // Every query goes to every shard.
+      for (size_t s = 0; s < numShards; ++s)
+        for (size_t i = 0; i < queries.n_cols; ++i)
+          requests[s].push_back(i);
+
+      SearchShards(queries, k, requests, batchNeighbors, batchDistances);
+    }
+    else
+    {
+      // First send each query to the shard with the nearest bound.
+      arma::mat minDistances(numShards, queries.n_cols);
+      for (size_t i = 0; i < queries.n_cols; ++i)
+        for (size_t s = 0; s < numShards; ++s)
+          minDistances(s, i) = transport.Bound(s).MinDistance(queries.col(i));
+
+      arma::Mat<unsigned char> searched(numShards, queries.n_cols,
+          arma::fill::zeros);
+      for (size_t i = 0; i < queries.n_cols; ++i)
+      {
+        const size_t nearest = minDistances.col(i).index_min();
+        requests[nearest].push_back(i);
+        searched(nearest, i) = 1;
+      }
+      SearchShards(queries, k, requests, batchNeighbors, batchDistances);
+
+      // Then send each query to the other shards that can still hold one of
+      // its k nearest neighbors.
+      for (size_t s = 0; s < numShards; ++s)
+      {
+        requests[s].clear();
+        for (size_t i = 0; i < queries.n_cols; ++i)
+          if (!searched(s, i) && minDistances(s, i) < batchDistances(k - 1, i))
+            requests[s].push_back(i);
+      }
+      SearchShards(queries, k, requests, batchNeighbors, batchDistances);
+    }
+
+    neighbors.cols(first, last) = batchNeighbors;
+    distances.cols(first, last) = batchDistances;
+  }
+}
+
+template<typename TransportType>
+void ShardedNeighborSearch<TransportType>::SearchShards(
+    const MatType& batch,
+    const size_t k,
+    const std::vector<std::vector<size_t>>& requests,
+    arma::Mat<size_t>& neighbors,
+    arma::mat& distances)
+{
+  const size_t numShards = requests.size();
+  std::vector<MatType> queries(numShards);
+  for (size_t s = 0; s < numShards; ++s)
+  {
+    queries[s].set_size(batch.n_rows, requests[s].size());
+    for (size_t i = 0; i < requests[s].size(); ++i)
+      queries[s].col(i) = batch.col(requests[s][i]);
+    shardQueries += requests[s].size();
+  }
+
+  std::vector<arma::Mat<size_t>> shardNeighbors;
+  std::vector<arma::mat> shardDistances;
+  transport.Search(queries, k, shardNeighbors, shardDistances);
+
+  // Merge the sorted lists of the shards into the neighbors of the batch.
+  arma::Col<size_t> mergedNeighbors(k);
+  arma::vec mergedDistances(k);
+  for (size_t s = 0; s < numShards; ++s)
+  {
+    for (size_t i = 0; i < requests[s].size(); ++i)
+    {
+      const size_t query = requests[s][i];
+      size_t a = 0, b = 0;
+      for (size_t j = 0; j < k; ++j)
+      {
+        if (distances(a, query) <= shardDistances[s](b, i))
+        {
+          mergedNeighbors[j] = neighbors(a, query);
+          mergedDistances[j] = distances(a++, query);
+        }
+        else
+        {
+          mergedNeighbors[j] = shardNeighbors[s](b, i);
+          mergedDistances[j] = shardDistances[s](b++, i);
+        }
+      }
+
+      neighbors.col(query) = mergedNeighbors;
+      distances.col(query) = mergedDistances;
+    }
+  }
+}
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
@@ -31,15 +31,19 @@ void Unmap(const arma::Mat<size_t>& neighbors,
   for (size_t i = 0; i < distances.n_cols; ++i)
   {
     // Map columns to the correct place.  The ternary operator does not work
-    // here...
+    // here...  An empty map means that the points were not rearranged.
+    const size_t column = queryMap.empty() ? i : queryMap[i];
     if (squareRoot)
-      distancesOut.col(queryMap[i]) = sqrt(distances.col(i));
+      distancesOut.col(column) = sqrt(distances.col(i));
     else
-      distancesOut.col(queryMap[i]) = distances.col(i);
+      distancesOut.col(column) = distances.col(i);
 
     // Map indices of neighbors.
     for (size_t j = 0; j < distances.n_rows; ++j)
-      neighborsOut(j, queryMap[i]) = referenceMap[neighbors(j, i)];
+    {
+      neighborsOut(j, column) = referenceMap.empty() ? neighbors(j, i) :
+          referenceMap[neighbors(j, i)];
+    }
   }
 }
 
@@ -62,7 +66,10 @@ void Unmap(const arma::Mat<size_t>& neighbors,
 
   // Map neighbors back to original locations.
   for (size_t j = 0; j < neighbors.n_elem; ++j)
-    neighborsOut[j] = referenceMap[neighbors[j]];
+  {
+    neighborsOut[j] = referenceMap.empty() ? neighbors[j] :
+        referenceMap[neighbors[j]];
+  }
 }
 
 } // namespace neighbor
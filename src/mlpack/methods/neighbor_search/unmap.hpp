@@ -22,7 +22,7 @@ namespace neighbor {
  * queryMap (such as during kd-tree construction), unmap the columns of the
  * distances and neighbors matrices into neighborsOut and distancesOut, and also
  * unmap the entries in each row of neighbors.  This is useful for the dual-tree
- * case.
+ * case.  An empty map means that the points it refers to were not rearranged.
  *
  * @param neighbors Matrix of neighbors resulting from neighbor search.
  * @param distances Matrix of distances resulting from neighbor search.
@@ -45,6 +45,7 @@ void Unmap(const arma::Mat<size_t>& neighbors,
  * during kd-tree construction), unmap the columns of the distances and
  * neighbors matrices into neighborsOut and distancesOut, and also unmap the
  * entries in each row of neighbors.  This is useful for the single-tree case.
+ * An empty map means that the reference points were not rearranged.
  *
  * @param neighbors Matrix of neighbors resulting from neighbor search.
  * @param distances Matrix of distances resulting from neighbor search.
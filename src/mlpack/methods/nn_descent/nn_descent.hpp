@@ -0,0 +1,206 @@
+/**
+ * @file methods/nn_descent/nn_descent.hpp
+ *
+ * Defines the NNDescent class, which computes an approximate k-nearest-neighbor
+ * graph of a dataset with NN-descent.
+ *
+ * The details of this method can be found in the following paper:
+ *
+ * @code
+ * @inproceedings{dong2011efficient,
+ *   title={Efficient k-nearest neighbor graph construction for generic
+ *       similarity measures},
+ *   author={Dong, Wei and Charikar, Moses and Li, Kai},
+ *   booktitle={Proceedings of the 20th International Conference on World
+ *       Wide Web},
+ *   pages={577--586},
+ *   year={2011}
+ * }
+ * @endcode
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NN_DESCENT_NN_DESCENT_HPP
+#define MLPACK_METHODS_NN_DESCENT_NN_DESCENT_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <mlpack/core/metrics/lmetric.hpp>
+
+#include <random>
+
+namespace mlpack {
+namespace neighbor {
+
+/**
+ * The NNDescent class; this class computes the approximate k nearest neighbors
+ * of every point of the reference set (the all-kNN graph), and returns them the
+ * way NeighborSearch::Search(k, neighbors, distances) does, so it can be used
+ * in place of KNN wherever only the all-kNN graph is needed (for instance as
+ * the TargetSearchType of lmnn::Constraints).
+ *
+ * NN-descent starts from a random graph and repeatedly improves it with the
+ * observation that a neighbor of a neighbor is likely to be a neighbor: in each
+ * iteration, every point compares with each other the neighbors it links to
+ * and the points that link to it (a sample of sampleRate * k of each), and each
+ * comparison can improve the neighbor lists of the two points.  Only pairs
+ * with at least one neighbor found in the previous iteration are compared, and
+ * the iterations stop once fewer than tolerance * k * n neighbors change.
+ *
+ * With OpenMP, the comparisons of each iteration run in parallel and only
+ * record the improvements they find; the improvements are then grouped by
+ * point and applied with one thread per point, so no lock is needed and the
+ * graph does not depend on the number of threads.
+ *
+ * @tparam MetricType The metric to use for the distances.
+ * @tparam MatType Type of matrix to use to store the data (arma::mat or
+ *     arma::fmat).
+ */
+template<
+    typename MetricType = metric::EuclideanDistance,
+    typename MatType = arma::mat
+>
+class NNDescent
+{
+ public:
+  /**
+   * Create the NNDescent object with the given reference set.  In order to
+   * avoid copying the reference set, consider passing it with std::move().
+   *
+   * @param referenceSet Set of reference points.
+   * @param sampleRate The fraction of the k neighbors (and of the reverse
+   *     neighbors) of each point compared in each iteration.
+   * @param maxIterations The maximum number of iterations.
+   * @param tolerance The iterations stop once fewer than tolerance * k * n
+   *     neighbors change in an iteration.
+   * @param metric Instantiated metric.
+   */
+  NNDescent(MatType referenceSet,
+            const double sampleRate = 0.5,
+            const size_t maxIterations = 20,
+            const double tolerance = 0.001,
+            const MetricType metric = MetricType());
+
+  /**
+   * Create the NNDescent object without a reference set.  Be sure to call
+   * Train() before calling Search().
+   *
+   * @param sampleRate The fraction of the k neighbors (and of the reverse
+   *     neighbors) of each point compared in each iteration.
+   * @param maxIterations The maximum number of iterations.
+   * @param tolerance The iterations stop once fewer than tolerance * k * n
+   *     neighbors change in an iteration.
+   * @param metric Instantiated metric.
+   */
+  NNDescent(const double sampleRate = 0.5,
+            const size_t maxIterations = 20,
+            const double tolerance = 0.001,
+            const MetricType metric = MetricType());
+
+  /**
+   * Set the reference set.  In order to avoid copying the reference set,
+   * consider passing it with std::move().
+   *
+   * @param referenceSet Set of reference points.
+   */
+  void Train(MatType referenceSet);
+
+  /**
+   * Compute the approximate k nearest neighbors of every point of the
+   * reference set (a point is not its own neighbor).  The matrices will be set
+   * to k rows by n columns, where n is the number of reference points; column
+   * i holds the neighbors of point i, by increasing distance.
+   *
+   * @param k Number of neighbors to search for; it must be less than the
+   *     number of reference points.
+   * @param neighbors Matrix storing lists of neighbors for each point.
+   * @param distances Matrix storing distances of neighbors for each point.
+   */
+  void Search(const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances);
+
+  //! Get the reference dataset.
+  const MatType& ReferenceSet() const { return referenceSet; }
+
+  //! Get the fraction of the neighbors compared in each iteration.
+  double SampleRate() const { return sampleRate; }
+  //! Modify the fraction of the neighbors compared in each iteration.
+  double& SampleRate() { return sampleRate; }
+
+  //! Get the maximum number of iterations.
+  size_t MaxIterations() const { return maxIterations; }
+  //! Modify the maximum number of iterations.
+  size_t& MaxIterations() { return maxIterations; }
+
+  //! Get the tolerance of the stopping criterion.
+  double Tolerance() const { return tolerance; }
+  //! Modify the tolerance of the stopping criterion.
+  double& Tolerance() { return tolerance; }
+
+  //! Get the number of iterations of the last search.
+  size_t Iterations() const { return iterations; }
+
+  //! Get the number of distance evaluations of the last search.
+  size_t DistanceEvaluations() const { return distanceEvaluations; }
+
+  //! Access the metric.
+  const MetricType& Metric() const { return metric; }
+  //! Modify the metric.
+  MetricType& Metric() { return metric; }
+
+ private:
+  /**
+   * Insert the given candidate in the (sorted) neighbor list of the given
+   * point, if it is nearer than the farthest neighbor and not already in the
+   * list.
+   *
+   * @return Whether the list changed.
+   */
+  static bool Insert(const size_t point,
+                     const size_t candidate,
+                     const double distance,
+                     arma::Mat<size_t>& neighbors,
+                     arma::mat& distances,
+                     arma::Mat<unsigned char>& isNew);
+
+  /**
+   * Keep at most the given number of elements of the given list, chosen at
+   * random with the given generator.
+   */
+  static void Sample(std::vector<size_t>& list,
+                     const size_t size,
+                     std::mt19937& generator);
+
+  //! The reference set.
+  MatType referenceSet;
+
+  //! The fraction of the neighbors compared in each iteration.
+  double sampleRate;
+
+  //! The maximum number of iterations.
+  size_t maxIterations;
+
+  //! The tolerance of the stopping criterion.
+  double tolerance;
+
+  //! The number of iterations of the last search.
+  size_t iterations;
+
+  //! The number of distance evaluations of the last search.
+  size_t distanceEvaluations;
+
+  //! The instantiated metric.
+  MetricType metric;
+};
+
+} // namespace neighbor
+} // namespace mlpack
+
+// Include implementation.
+#include "nn_descent_impl.hpp"
+
+#endif
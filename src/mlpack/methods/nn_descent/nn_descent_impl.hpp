@@ -0,0 +1,331 @@
+/**
+ * @file methods/nn_descent/nn_descent_impl.hpp
+ *
+ * Implementation of the NNDescent class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NN_DESCENT_NN_DESCENT_IMPL_HPP
+#define MLPACK_METHODS_NN_DESCENT_NN_DESCENT_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "nn_descent.hpp"
+
+namespace mlpack {
+namespace neighbor {
+
+// Construct the object with a reference set.
+template<typename MetricType, typename MatType>
+NNDescent<MetricType, MatType>::NNDescent(MatType referenceSet,
+                                          const double sampleRate,
+                                          const size_t maxIterations,
+                                          const double tolerance,
+                                          const MetricType metric) :
+    referenceSet(std::move(referenceSet)),
+    sampleRate(sampleRate),
+    maxIterations(maxIterations),
+    tolerance(tolerance),
+    iterations(0),
+    distanceEvaluations(0),
+    metric(metric)
+{
+  // Nothing to do here.
+}
+
+// Construct the object without a reference set.
+template<typename MetricType, typename MatType>
+NNDescent<MetricType, MatType>::NNDescent(const double sampleRate,
+                                          const size_t maxIterations,
+                                          const double tolerance,
+                                          const MetricType metric) :
+    sampleRate(sampleRate),
+    maxIterations(maxIterations),
+    tolerance(tolerance),
+    iterations(0),
+    distanceEvaluations(0),
+    metric(metric)
+{
+  // Nothing to do here.
+}
+
+// Set the reference set.
+template<typename MetricType, typename MatType>
+void NNDescent<MetricType, MatType>::Train(MatType referenceSet)
+{
+  this->referenceSet = std::move(referenceSet);
+}
+
+// Compute the approximate all-kNN graph.
+template<typename MetricType, typename MatType>
+void NNDescent<MetricType, MatType>::Search(const size_t k,
+                                            arma::Mat<size_t>& neighbors,
+                                            arma::mat& distances)
+{
+  const size_t n = referenceSet.n_cols;
+  if (k >= n && k > 0)
+  {
+    std::stringstream ss;
+    ss << "Requested value of k (" << k << ") is greater than or equal to the "
+        << "number of points in the reference set (" << n << ")";
+    throw std::invalid_argument(ss.str());
+  }
+
+  neighbors.set_size(k, n);
+  distances.set_size(k, n);
+  iterations = 0;
+  distanceEvaluations = 0;
+
+  // If the user asked for 0 nearest neighbors... uh... we're done.
+  if (k == 0)
+    return;
+
+  // The random choices are drawn sequentially from a generator of this search,
+  // seeded from the random seed of mlpack, so that searches in different
+  // threads (for instance one per class in lmnn::Constraints) do not share a
+  // generator.
+  std::mt19937 generator;
+  #pragma omp critical(nn_descent_seed)
+  generator.seed((uint32_t) math::RandInt(std::numeric_limits<int>::max()));
+
+  // Start from random neighbors.
+  std::vector<size_t> order;
+  for (size_t i = 0; i < n; ++i)
+  {
+    if (2 * k >= n)
+    {
+      // Most of the points are neighbors, so draw a permutation.
+      order.resize(n - 1);
+      for (size_t j = 0; j < n - 1; ++j)
+        order[j] = (j < i) ? j : j + 1;
+      std::shuffle(order.begin(), order.end(), generator);
+      for (size_t j = 0; j < k; ++j)
+        neighbors(j, i) = order[j];
+    }
+    else
+    {
+      std::uniform_int_distribution<size_t> pointDist(0, n - 1);
+      for (size_t j = 0; j < k; ++j)
+      {
+        bool found = true;
+        while (found)
+        {
+          neighbors(j, i) = pointDist(generator);
+          found = (neighbors(j, i) == i);
+          for (size_t l = 0; l < j && !found; ++l)
+            found = (neighbors(l, i) == neighbors(j, i));
+        }
+      }
+    }
+  }
+
+  // Sort the random neighbors of each point; they are all new.
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) n; ++i)
+  {
+    for (size_t j = 0; j < k; ++j)
+    {
+      distances(j, i) = metric.Evaluate(referenceSet.col(i),
+          referenceSet.col(neighbors(j, i)));
+    }
+
+    const arma::uvec order = arma::sort_index(distances.col(i));
+    distances.col(i) = distances.col(i).eval().rows(order);
+    neighbors.col(i) = neighbors.col(i).eval().rows(order);
+  }
+  arma::Mat<unsigned char> isNew(k, n);
+  isNew.fill(1);
+  distanceEvaluations = n * k;
+
+  const size_t sampleSize = std::max((size_t) std::ceil(sampleRate * k),
+      (size_t) 1);
+
+  // An improvement found by the comparisons.
+  struct Update
+  {
+    size_t point;
+    size_t candidate;
+    double distance;
+  };
+
+  for (iterations = 0; iterations < maxIterations; )
+  {
+    ++iterations;
+
+    // Sample the new neighbors of each point (which become old), and collect
+    // the old neighbors.
+    std::vector<std::vector<size_t>> newLists(n), oldLists(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+      for (size_t j = 0; j < k; ++j)
+      {
+        if (isNew(j, i))
+          newLists[i].push_back(j);
+        else
+          oldLists[i].push_back(neighbors(j, i));
+      }
+
+      Sample(newLists[i], sampleSize, generator);
+      for (size_t j = 0; j < newLists[i].size(); ++j)
+      {
+        isNew(newLists[i][j], i) = 0;
+        newLists[i][j] = neighbors(newLists[i][j], i);
+      }
+    }
+
+    // Add a sample of the reverse neighbors of each point.
+    std::vector<std::vector<size_t>> newReverse(n), oldReverse(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+      for (size_t j = 0; j < newLists[i].size(); ++j)
+        newReverse[newLists[i][j]].push_back(i);
+      for (size_t j = 0; j < oldLists[i].size(); ++j)
+        oldReverse[oldLists[i][j]].push_back(i);
+    }
+
+    for (size_t i = 0; i < n; ++i)
+    {
+      Sample(newReverse[i], sampleSize, generator);
+      Sample(oldReverse[i], sampleSize, generator);
+      newLists[i].insert(newLists[i].end(), newReverse[i].begin(),
+          newReverse[i].end());
+      oldLists[i].insert(oldLists[i].end(), oldReverse[i].begin(),
+          oldReverse[i].end());
+    }
+    newReverse.clear();
+    oldReverse.clear();
+
+    // Compare the new neighbors of each point with each other and with the old
+    // neighbors.  The neighbor lists are not modified here, so the farthest
+    // distances can be read without locks.
+    std::vector<std::vector<Update>> updates(n);
+    size_t evaluations = 0;
+    #pragma omp parallel for schedule(dynamic) reduction(+:evaluations)
+    for (omp_size_t i = 0; i < (omp_size_t) n; ++i)
+    {
+      std::vector<size_t>& newList = newLists[i];
+      std::vector<size_t>& oldList = oldLists[i];
+      std::sort(newList.begin(), newList.end());
+      newList.erase(std::unique(newList.begin(), newList.end()),
+          newList.end());
+      std::sort(oldList.begin(), oldList.end());
+      oldList.erase(std::unique(oldList.begin(), oldList.end()),
+          oldList.end());
+
+      auto compare = [&](const size_t a, const size_t b)
+      {
+        if (a == b)
+          return;
+
+        const double distance = metric.Evaluate(referenceSet.col(a),
+            referenceSet.col(b));
+        ++evaluations;
+        if (distance < distances(k - 1, a))
+          updates[i].push_back(Update { a, b, distance });
+        if (distance < distances(k - 1, b))
+          updates[i].push_back(Update { b, a, distance });
+      };
+
+      for (size_t a = 0; a < newList.size(); ++a)
+      {
+        for (size_t b = a + 1; b < newList.size(); ++b)
+          compare(newList[a], newList[b]);
+        for (size_t b = 0; b < oldList.size(); ++b)
+          compare(newList[a], oldList[b]);
+      }
+    }
+    distanceEvaluations += evaluations;
+    newLists.clear();
+    oldLists.clear();
+
+    // Group the improvements by point, so that each neighbor list is updated
+    // by a single thread.
+    arma::Col<size_t> offsets(n + 1, arma::fill::zeros);
+    for (size_t i = 0; i < n; ++i)
+      for (size_t j = 0; j < updates[i].size(); ++j)
+        ++offsets[updates[i][j].point + 1];
+    offsets = arma::cumsum(offsets);
+
+    std::vector<Update> grouped(offsets[n]);
+    arma::Col<size_t> positions = offsets;
+    for (size_t i = 0; i < n; ++i)
+      for (size_t j = 0; j < updates[i].size(); ++j)
+        grouped[positions[updates[i][j].point]++] = updates[i][j];
+    updates.clear();
+
+    size_t changes = 0;
+    #pragma omp parallel for schedule(dynamic) reduction(+:changes)
+    for (omp_size_t i = 0; i < (omp_size_t) n; ++i)
+    {
+      for (size_t j = offsets[i]; j < offsets[i + 1]; ++j)
+      {
+        if (Insert(i, grouped[j].candidate, grouped[j].distance, neighbors,
+            distances, isNew))
+          ++changes;
+      }
+    }
+
+    Log::Info << "NNDescent: iteration " << iterations << ", " << changes
+        << " neighbors changed." << std::endl;
+    if (changes <= tolerance * k * n)
+      break;
+  }
+}
+
+// Insert a candidate in the neighbor list of a point.
+template<typename MetricType, typename MatType>
+bool NNDescent<MetricType, MatType>::Insert(const size_t point,
+                                            const size_t candidate,
+                                            const double distance,
+                                            arma::Mat<size_t>& neighbors,
+                                            arma::mat& distances,
+                                            arma::Mat<unsigned char>& isNew)
+{
+  const size_t k = neighbors.n_rows;
+  if (distance >= distances(k - 1, point))
+    return false;
+
+  for (size_t j = 0; j < k; ++j)
+    if (neighbors(j, point) == candidate)
+      return false;
+
+  // Shift the farther neighbors to make room for the candidate.
+  size_t j = k - 1;
+  while (j > 0 && distances(j - 1, point) > distance)
+  {
+    neighbors(j, point) = neighbors(j - 1, point);
+    distances(j, point) = distances(j - 1, point);
+    isNew(j, point) = isNew(j - 1, point);
+    --j;
+  }
+
+  neighbors(j, point) = candidate;
+  distances(j, point) = distance;
+  isNew(j, point) = 1;
+  return true;
+}
+
+// Keep a random sample of a list.
+template<typename MetricType, typename MatType>
+void NNDescent<MetricType, MatType>::Sample(std::vector<size_t>& list,
+                                            const size_t size,
+                                            std::mt19937& generator)
+{
+  if (list.size() <= size)
+    return;
+
+  // Partial Fisher-Yates shuffle.
+  for (size_t i = 0; i < size; ++i)
+  {
+    std::uniform_int_distribution<size_t> dist(i, list.size() - 1);
+    std::swap(list[i], list[dist(generator)]);
+  }
+  list.resize(size);
+}
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
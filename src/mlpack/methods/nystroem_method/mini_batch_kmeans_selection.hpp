@@ -0,0 +1,64 @@
+/**
+ * @file methods/nystroem_method/mini_batch_kmeans_selection.hpp
+ *
+ * Use the centroids of mini-batch k-means for use in the Nystroem method of
+ * kernel matrix approximation.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NYSTROEM_METHOD_MINI_BATCH_KMEANS_SELECTION_HPP
+#define MLPACK_METHODS_NYSTROEM_METHOD_MINI_BATCH_KMEANS_SELECTION_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/methods/kmeans/kmeans.hpp>
+#include <mlpack/methods/kmeans/mini_batch_kmeans.hpp>
+#include <mlpack/methods/kmeans/allow_empty_clusters.hpp>
+
+namespace mlpack {
+namespace kernel {
+
+/**
+ * Select the landmarks of the Nystroem method as the centroids of mini-batch
+ * k-means.  KMeansSelection runs Lloyd iterations over the whole dataset,
+ * which can cost more than the Nystroem approximation itself; here each
+ * iteration only looks at a random sample of points (see
+ * kmeans::MiniBatchKMeans), and the points of each sample are assigned to
+ * their centroids in parallel when OpenMP is available.  The centroids start
+ * at random points of the dataset, and a centroid that is never the closest
+ * to a sampled point stays at its starting point, which is still a sensible
+ * landmark.
+ *
+ * @tparam maxIterations The number of mini-batch iterations.
+ */
+template<size_t maxIterations = 50>
+class MiniBatchKMeansSelection
+{
+ public:
+  /**
+   * Use mini-batch k-means to select the specified number of points in the
+   * dataset.  You are responsible for deleting the returned matrix!
+   *
+   * @param data Dataset to sample from.
+   * @param m Number of points to select.
+   * @return Matrix pointer in which centroids are stored.
+   */
+  const static arma::mat* Select(const arma::mat& data, const size_t m)
+  {
+    arma::mat* centroids = new arma::mat;
+
+    kmeans::KMeans<metric::EuclideanDistance, kmeans::SampleInitialization,
+        kmeans::AllowEmptyClusters, kmeans::MiniBatchKMeans> kmeans(
+        maxIterations);
+    kmeans.Cluster(data, m, *centroids);
+
+    return centroids;
+  }
+};
+
+} // namespace kernel
+} // namespace mlpack
+
+#endif
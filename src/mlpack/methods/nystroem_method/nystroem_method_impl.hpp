@@ -16,6 +16,8 @@
 // In case it hasn't been included yet.
 #include "nystroem_method.hpp"
 
+#include <mlpack/core/kernels/kernel_matrix.hpp>
+
 namespace mlpack {
 namespace kernel {
 
@@ -36,17 +38,12 @@ void NystroemMethod<KernelType, PointSelectionPolicy>::GetKernelMatrix(
     arma::mat& semiKernel)
 {
   // Assemble mini-kernel matrix.
-  for (size_t i = 0; i < rank; ++i)
-    for (size_t j = 0; j < rank; ++j)
-      miniKernel(i, j) = kernel.Evaluate(selectedData->col(i),
-                                         selectedData->col(j));
+  KernelMatrix(kernel, *selectedData, miniKernel);
 
   // Construct semi-kernel matrix with interactions between selected data and
   // all points.
-  for (size_t i = 0; i < data.n_cols; ++i)
-    for (size_t j = 0; j < rank; ++j)
-      semiKernel(i, j) = kernel.Evaluate(data.col(i),
-                                         selectedData->col(j));
+  KernelMatrix(kernel, data, *selectedData, semiKernel);
+
   // Clean the memory.
   delete selectedData;
 }
@@ -57,22 +54,17 @@ void NystroemMethod<KernelType, PointSelectionPolicy>::GetKernelMatrix(
     arma::mat& miniKernel,
     arma::mat& semiKernel)
 {
+  // Gather the selected points, so that the kernel matrices can be computed
+  // in blocks.
+  const arma::mat selectedData = data.cols(arma::conv_to<arma::uvec>::from(
+      selectedPoints));
+
   // Assemble mini-kernel matrix.
-  for (size_t i = 0; i < rank; ++i)
-  {
-    for (size_t j = 0; j < rank; ++j)
-    {
-      miniKernel(i, j) = kernel.Evaluate(data.col(selectedPoints(i)),
-                                         data.col(selectedPoints(j)));
-    }
-  }
+  KernelMatrix(kernel, selectedData, miniKernel);
 
   // Construct semi-kernel matrix with interactions between selected points and
   // all points.
-  for (size_t i = 0; i < data.n_cols; ++i)
-    for (size_t j = 0; j < rank; ++j)
-      semiKernel(i, j) = kernel.Evaluate(data.col(i),
-                                         data.col(selectedPoints(j)));
+  KernelMatrix(kernel, data, selectedData, semiKernel);
 }
 
 template<typename KernelType, typename PointSelectionPolicy>
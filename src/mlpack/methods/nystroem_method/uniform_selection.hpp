@@ -0,0 +1,62 @@
+/**
+ * @file methods/nystroem_method/uniform_selection.hpp
+ *
+ * Select distinct points of the dataset uniformly at random for use in the
+ * Nystroem method of kernel matrix approximation.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NYSTROEM_METHOD_UNIFORM_SELECTION_HPP
+#define MLPACK_METHODS_NYSTROEM_METHOD_UNIFORM_SELECTION_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/random.hpp>
+
+namespace mlpack {
+namespace kernel {
+
+/**
+ * Select the landmarks of the Nystroem method uniformly at random, without
+ * replacement.  Unlike RandomSelection, no point is selected twice, so the
+ * kernel matrix of the selected points does not have repeated columns.
+ */
+class UniformSelection
+{
+ public:
+  /**
+   * Randomly select the specified number of distinct points in the dataset.
+   *
+   * @param data Dataset to sample from.
+   * @param m Number of points to select; it must not be greater than the
+   *     number of points.
+   * @return Indices of selected points from the dataset.
+   */
+  const static arma::Col<size_t> Select(const arma::mat& data, const size_t m)
+  {
+    if (m > data.n_cols)
+    {
+      Log::Fatal << "UniformSelection::Select(): cannot select " << m
+          << " distinct points from a dataset of " << data.n_cols << " points!"
+          << std::endl;
+    }
+
+    // Partial Fisher-Yates shuffle: the first m indices are a uniform sample.
+    arma::Col<size_t> indices = arma::linspace<arma::Col<size_t>>(0,
+        data.n_cols - 1, data.n_cols);
+    for (size_t i = 0; i < m; ++i)
+    {
+      const size_t j = math::RandInt((int) i, (int) data.n_cols);
+      std::swap(indices[i], indices[j]);
+    }
+
+    return indices.head(m);
+  }
+};
+
+} // namespace kernel
+} // namespace mlpack
+
+#endif
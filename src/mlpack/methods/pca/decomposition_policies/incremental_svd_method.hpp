@@ -0,0 +1,272 @@
+/**
+ * @file methods/pca/decomposition_policies/incremental_svd_method.hpp
+ *
+ * Implementation of the incremental SVD method for use in the Principal
+ * Components Analysis method.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+
+#ifndef MLPACK_METHODS_PCA_DECOMPOSITION_POLICIES_INCREMENTAL_SVD_METHOD_HPP
+#define MLPACK_METHODS_PCA_DECOMPOSITION_POLICIES_INCREMENTAL_SVD_METHOD_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace pca {
+
+/**
+ * Implementation of the incremental SVD policy.  The principal components are
+ * computed from minibatches of points: for each minibatch, the current basis
+ * (scaled by its singular values), the centered minibatch, and a correction
+ * for the change of the mean are stacked and decomposed, and only the leading
+ * components are kept.  Each step only needs a matrix with as many columns as
+ * the number of components plus the size of the minibatch, so the full
+ * covariance matrix or SVD of the dataset is never formed.
+ *
+ * When used as the decomposition policy of PCA, the centered dataset is
+ * processed in minibatches of the given size.  The policy can also be used on
+ * its own to compute the principal components of a stream of points that
+ * doesn't fit in memory, and to project new points onto them:
+ *
+ * @code
+ * IncrementalSVDPolicy ipca;
+ * ipca.Reset(10); // Keep 10 components.
+ * while (LoadNextChunk(chunk))
+ *   ipca.Update(chunk);
+ *
+ * arma::mat transformed;
+ * ipca.Transform(newPoints, transformed);
+ * @endcode
+ *
+ * For more information, see the following paper:
+ *
+ * @code
+ * @article{ross2008incremental,
+ *   title={Incremental Learning for Robust Visual Tracking},
+ *   author={Ross, David A. and Lim, Jongwoo and Lin, Ruei-Sung and Yang,
+ *       Ming-Hsuan},
+ *   journal={International Journal of Computer Vision},
+ *   volume={77},
+ *   number={1--3},
+ *   pages={125--141},
+ *   year={2008}
+ * }
+ * @endcode
+ */
+class IncrementalSVDPolicy
+{
+ public:
+  /**
+   * Use the incremental SVD method to perform the principal components
+   * analysis (PCA).
+   *
+   * @param batchSize Number of points in each minibatch (Default: 1000).
+   * @param oversampling Number of components kept in addition to the rank
+   *     requested by PCA, to improve the accuracy of the leading components
+   *     (Default: 10).
+   */
+  IncrementalSVDPolicy(const size_t batchSize = 1000,
+                       const size_t oversampling = 10) :
+      batchSize(batchSize),
+      oversampling(oversampling),
+      numComponents(0),
+      numPoints(0)
+  {
+    /* Nothing to do here */
+  }
+
+  /**
+   * Apply Principal Component Analysis to the provided data set using the
+   * incremental SVD method.
+   *
+   * @param data Data matrix.
+   * @param centeredData Centered data matrix.
+   * @param transformedData Matrix to put results of PCA into.
+   * @param eigVal Vector to put eigenvalues into.
+   * @param eigvec Matrix to put eigenvectors (loadings) into.
+   * @param rank Rank of the decomposition.
+   */
+  void Apply(const arma::mat& /* data */,
+             const arma::mat& centeredData,
+             arma::mat& transformedData,
+             arma::vec& eigVal,
+             arma::mat& eigvec,
+             const size_t rank)
+  {
+    if (batchSize == 0)
+    {
+      throw std::invalid_argument("IncrementalSVDPolicy::Apply(): the batch "
+          "size must be positive");
+    }
+
+    Reset(std::min((size_t) centeredData.n_rows, rank + oversampling));
+    for (size_t begin = 0; begin < centeredData.n_cols; begin += batchSize)
+    {
+      const size_t end = std::min(begin + batchSize, (size_t)
+          centeredData.n_cols);
+      Update(centeredData.cols(begin, end - 1));
+    }
+
+    eigVal = EigenValues();
+    eigvec = basis;
+
+    // Project the samples to the principals.
+    transformedData = arma::trans(eigvec) * centeredData;
+  }
+
+  /**
+   * Forget all the points seen so far, and set the number of components to
+   * keep.
+   *
+   * @param numComponents Number of components to keep (0 keeps them all).
+   */
+  void Reset(const size_t numComponents)
+  {
+    this->numComponents = numComponents;
+    numPoints = 0;
+    mean.reset();
+    basis.reset();
+    singularValues.reset();
+  }
+
+  /**
+   * Update the principal components with the given minibatch of points (one
+   * per column).  The points don't need to be centered.
+   *
+   * @param batch Minibatch of points.
+   */
+  void Update(const arma::mat& batch)
+  {
+    if (batch.n_cols == 0)
+      return;
+
+    if (numPoints > 0 && batch.n_rows != mean.n_elem)
+    {
+      throw std::invalid_argument("IncrementalSVDPolicy::Update(): the "
+          "dimensionality of the batch (" + std::to_string(batch.n_rows) +
+          ") does not match the dimensionality of the previous points (" +
+          std::to_string(mean.n_elem) + ")");
+    }
+
+    const double n = numPoints;
+    const double b = batch.n_cols;
+    const arma::vec batchMean = arma::mean(batch, 1);
+
+    arma::mat stacked = batch.each_col() - batchMean;
+    if (numPoints == 0)
+    {
+      mean = batchMean;
+    }
+    else
+    {
+      // The mean correction accounts for the variance between the mean of the
+      // previous points and the mean of the batch.
+      stacked = arma::join_rows(basis * arma::diagmat(singularValues),
+          arma::join_rows(stacked, std::sqrt(n * b / (n + b)) *
+          (mean - batchMean)));
+      mean += (batchMean - mean) * (b / (n + b));
+    }
+
+    arma::mat u, v;
+    arma::vec s;
+    if (!arma::svd_econ(u, s, v, stacked, 'l'))
+    {
+      throw std::runtime_error("IncrementalSVDPolicy::Update(): singular "
+          "value decomposition failed");
+    }
+
+    const size_t k = (numComponents == 0) ? (size_t) s.n_elem :
+        std::min(numComponents, (size_t) s.n_elem);
+    basis = u.head_cols(k);
+    singularValues = s.head(k);
+    numPoints += batch.n_cols;
+  }
+
+  /**
+   * Project the given points onto the principal components found so far.
+   *
+   * @param data Points to project (one per column).
+   * @param transformedData Matrix to store the projected points into.
+   */
+  void Transform(const arma::mat& data, arma::mat& transformedData) const
+  {
+    if (data.n_rows != mean.n_elem)
+    {
+      throw std::invalid_argument("IncrementalSVDPolicy::Transform(): the "
+          "dimensionality of the data (" + std::to_string(data.n_rows) +
+          ") does not match the dimensionality of the principal components (" +
+          std::to_string(mean.n_elem) + ")");
+    }
+
+    transformedData = arma::trans(basis) * (data.each_col() - mean);
+  }
+
+  //! Get the eigenvalues of the covariance matrix of the points seen so far.
+  arma::vec EigenValues() const
+  {
+    // The covariance matrix is X * X' / (N - 1).
+    if (numPoints < 2)
+      return arma::zeros<arma::vec>(singularValues.n_elem);
+    return arma::square(singularValues) / (numPoints - 1);
+  }
+
+  //! Get the mean of the points seen so far.
+  const arma::vec& Mean() const { return mean; }
+  //! Get the principal components found so far (one per column).
+  const arma::mat& Basis() const { return basis; }
+  //! Get the singular values of the centered points seen so far.
+  const arma::vec& SingularValues() const { return singularValues; }
+  //! Get the number of points seen so far.
+  size_t NumPoints() const { return numPoints; }
+
+  //! Get the number of points in each minibatch.
+  size_t BatchSize() const { return batchSize; }
+  //! Modify the number of points in each minibatch.
+  size_t& BatchSize() { return batchSize; }
+
+  //! Get the number of extra components kept when used by PCA.
+  size_t Oversampling() const { return oversampling; }
+  //! Modify the number of extra components kept when used by PCA.
+  size_t& Oversampling() { return oversampling; }
+
+  //! Get the number of components to keep (0 keeps them all).
+  size_t NumComponents() const { return numComponents; }
+
+  //! Serialize the policy, so that a stream can be resumed later.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(batchSize);
+    ar & BOOST_SERIALIZATION_NVP(oversampling);
+    ar & BOOST_SERIALIZATION_NVP(numComponents);
+    ar & BOOST_SERIALIZATION_NVP(numPoints);
+    ar & BOOST_SERIALIZATION_NVP(mean);
+    ar & BOOST_SERIALIZATION_NVP(basis);
+    ar & BOOST_SERIALIZATION_NVP(singularValues);
+  }
+
+ private:
+  //! The number of points in each minibatch.
+  size_t batchSize;
+  //! The number of extra components kept when used by PCA.
+  size_t oversampling;
+  //! The number of components to keep.
+  size_t numComponents;
+  //! The number of points seen so far.
+  size_t numPoints;
+  //! The mean of the points seen so far.
+  arma::vec mean;
+  //! The principal components found so far.
+  arma::mat basis;
+  //! The singular values of the centered points seen so far.
+  arma::vec singularValues;
+};
+
+} // namespace pca
+} // namespace mlpack
+
+#endif
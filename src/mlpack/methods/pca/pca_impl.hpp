@@ -113,7 +113,9 @@ double PCA<DecompositionPolicy>::Apply(arma::mat& data,
 
   decomposition.Apply(data, centeredData, data, eigVal, eigvec, newDimension);
 
-  if (newDimension < eigvec.n_rows)
+  // Some decomposition policies only return the leading components, so the
+  // transformed data may already have fewer rows than the data.
+  if (newDimension < data.n_rows)
     // Drop unnecessary rows.
     data.shed_rows(newDimension, data.n_rows - 1);
 
@@ -16,6 +16,7 @@
 
 #include "pca.hpp"
 #include <mlpack/methods/pca/decomposition_policies/exact_svd_method.hpp>
+#include <mlpack/methods/pca/decomposition_policies/incremental_svd_method.hpp>
 #include <mlpack/methods/pca/decomposition_policies/quic_svd_method.hpp>
 #include <mlpack/methods/pca/decomposition_policies/randomized_svd_method.hpp>
 #include <mlpack/methods/pca/decomposition_policies/randomized_block_krylov_method.hpp>
@@ -34,7 +35,8 @@ PROGRAM_INFO("Principal Components Analysis",
     "linear transformation determined by PCA.",
     // Long description.
     "This program performs principal components analysis on the given dataset "
-    "using the exact, randomized, randomized block Krylov, or QUIC SVD method. "
+    "using the exact, randomized, randomized block Krylov, QUIC, or "
+    "incremental SVD method. "
     "It will transform the data onto its principal components, optionally "
     "performing dimensionality reduction by ignoring the principal components "
     "with the smallest eigenvalues."
@@ -50,7 +52,11 @@ PROGRAM_INFO("Principal Components Analysis",
     "Multiple different decomposition techniques can be used.  The method to "
     "use can be specified with the " +
     PRINT_PARAM_STRING("decomposition_method") + " parameter, and it may take "
-    "the values 'exact', 'randomized', or 'quic'."
+    "the values 'exact', 'randomized', 'randomized-block-krylov', 'quic', or "
+    "'incremental'.  The 'incremental' method computes the principal "
+    "components from minibatches of points, whose size can be specified with "
+    "the " + PRINT_PARAM_STRING("batch_size") + " parameter; it needs much "
+    "less memory than the other methods for the decomposition itself."
     "\n\n"
     "For example, to reduce the dimensionality of the matrix " +
     PRINT_DATASET("data") + " to 5 dimensions using randomized SVD for the "
@@ -77,7 +83,9 @@ PARAM_FLAG("scale", "If set, the data will be scaled before running PCA, such "
 
 PARAM_STRING_IN("decomposition_method", "Method used for the principal "
     "components analysis: 'exact', 'randomized', 'randomized-block-krylov', "
-    "'quic'.", "c", "exact");
+    "'quic', 'incremental'.", "c", "exact");
+PARAM_INT_IN("batch_size", "Number of points in each minibatch for the "
+    "'incremental' decomposition method.", "b", 1000);
 
 
 //! Run RunPCA on the specified dataset with the given decomposition method.
@@ -85,9 +93,10 @@ template<typename DecompositionPolicy>
 void RunPCA(arma::mat& dataset,
             const size_t newDimension,
             const bool scale,
-            const double varToRetain)
+            const double varToRetain,
+            const DecompositionPolicy& decomposition = DecompositionPolicy())
 {
-  PCA<DecompositionPolicy> p(scale);
+  PCA<DecompositionPolicy> p(scale, decomposition);
 
   Log::Info << "Performing PCA on dataset..." << endl;
   double varRetained;
@@ -119,9 +128,12 @@ static void mlpackMain()
 
   // Check decomposition method validity.
   RequireParamInSet<string>("decomposition_method", { "exact", "randomized",
-      "randomized-block-krylov", "quic" }, true,
+      "randomized-block-krylov", "quic", "incremental" }, true,
       "unknown decomposition method");
 
+  RequireParamValue<int>("batch_size", [](int x) { return x > 0; }, true,
+      "batch size must be positive");
+
   // Find out what dimension we want.
   RequireParamValue<int>("new_dimensionality", [](int x) { return x >= 0; },
       true, "new dimensionality must be non-negative");
@@ -162,6 +174,13 @@ static void mlpackMain()
   {
     RunPCA<QUICSVDPolicy>(dataset, newDimension, scale, varToRetain);
   }
+  else if (decompositionMethod == "incremental")
+  {
+    IncrementalSVDPolicy decomposition(
+        (size_t) CLI::GetParam<int>("batch_size"));
+    RunPCA<IncrementalSVDPolicy>(dataset, newDimension, scale, varToRetain,
+        decomposition);
+  }
 
   // Now save the results.
   if (CLI::HasParam("output"))
@@ -26,6 +26,13 @@ namespace perceptron {
  * network).  It converges if the supplied training dataset is linearly
  * separable.
  *
+ * By default the weights are updated after each point.  With a BatchSize()
+ * larger than one, the scores of each batch of points are computed with one
+ * matrix product, using the weights from the start of the batch, and the
+ * updates of the misclassified points of the batch are applied after that.
+ * This is much faster on large datasets, and converges to a separating model
+ * just the same when the dataset is linearly separable.
+ *
  * @tparam LearnPolicy Options of SimpleWeightUpdate and GradientDescent.
  * @tparam WeightInitializationPolicy Option of ZeroInitialization and
  *      RandomInitialization.
@@ -127,6 +134,11 @@ class Perceptron
   //! Modify the maximum number of iterations.
   size_t& MaxIterations() { return maxIterations; }
 
+  //! Get the number of points scored at once during training.
+  size_t BatchSize() const { return batchSize; }
+  //! Modify the number of points scored at once during training.
+  size_t& BatchSize() { return batchSize; }
+
   //! Get the number of classes this perceptron has been trained for.
   size_t NumClasses() const { return weights.n_cols; }
 
@@ -144,6 +156,9 @@ class Perceptron
   //! The maximum number of iterations during training.
   size_t maxIterations;
 
+  //! The number of points scored at once during training.
+  size_t batchSize;
+
   /**
    * Stores the weights for each of the input class labels.  Each column
    * corresponds to the weights for one class label, and each row corresponds to
@@ -159,6 +174,29 @@ class Perceptron
 } // namespace perceptron
 } // namespace mlpack
 
+//! Set the serialization version of the Perceptron class.  (This can't use
+//! BOOST_TEMPLATE_CLASS_VERSION, since Perceptron has more than one template
+//! parameter.)
+namespace boost {
+namespace serialization {
+
+template<typename LearnPolicy,
+         typename WeightInitializationPolicy,
+         typename MatType>
+struct version<mlpack::perceptron::Perceptron<LearnPolicy,
+                                              WeightInitializationPolicy,
+                                              MatType>>
+{
+  typedef mpl::int_<1> type;
+  typedef mpl::integral_c_tag tag;
+  BOOST_STATIC_CONSTANT(int, value = version::type::value);
+  BOOST_MPL_ASSERT((boost::mpl::less<boost::mpl::int_<1>,
+                    boost::mpl::int_<256>>));
+};
+
+} // namespace serialization
+} // namespace boost
+
 #include "perceptron_impl.hpp"
 
 #endif
@@ -30,7 +30,8 @@ Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::Perceptron(
     const size_t numClasses,
     const size_t dimensionality,
     const size_t maxIterations) :
-    maxIterations(maxIterations)
+    maxIterations(maxIterations),
+    batchSize(1)
 {
   WeightInitializationPolicy wip;
   wip.Initialize(weights, biases, dimensionality, numClasses);
@@ -56,7 +57,8 @@ Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::Perceptron(
     const arma::Row<size_t>& labels,
     const size_t numClasses,
     const size_t maxIterations) :
-    maxIterations(maxIterations)
+    maxIterations(maxIterations),
+    batchSize(1)
 {
   // Start training.
   Train(data, labels, numClasses);
@@ -84,7 +86,8 @@ Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::Perceptron(
     const arma::Row<size_t>& labels,
     const size_t numClasses,
     const arma::rowvec& instanceWeights) :
-    maxIterations(other.maxIterations)
+    maxIterations(other.maxIterations),
+    batchSize(other.batchSize)
 {
   Train(data, labels, numClasses, instanceWeights);
 }
@@ -106,16 +109,12 @@ void Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::Classify(
     const MatType& test,
     arma::Row<size_t>& predictedLabels)
 {
-  arma::vec tempLabelMat;
-  arma::uword maxIndex = 0;
+  // Score all the points with one (multithreaded) matrix product.
+  arma::mat scores = weights.t() * test;
+  scores.each_col() += biases;
 
-  // Could probably be faster if done in batch.
-  for (size_t i = 0; i < test.n_cols; i++)
-  {
-    tempLabelMat = weights.t() * test.col(i) + biases;
-    tempLabelMat.max(maxIndex);
-    predictedLabels(0, i) = maxIndex;
-  }
+  predictedLabels = arma::conv_to<arma::Row<size_t>>::from(
+      arma::index_max(scores, 0));
 }
 
 /**
@@ -148,7 +147,7 @@ void Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::Train(
   size_t j, i = 0;
   bool converged = false;
   size_t tempLabel;
-  arma::uword maxIndexRow = 0, maxIndexCol = 0;
+  arma::uword maxIndexRow = 0;
   arma::mat tempLabelMat;
 
   LearnPolicy LP;
@@ -162,31 +161,39 @@ void Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::Train(
     i++;
     converged = true;
 
-    // Now this inner loop is for going through the dataset in each iteration.
-    for (j = 0; j < data.n_cols; j++)
+    // Now this inner loop is for going through the dataset in each iteration,
+    // one batch of points at a time.
+    for (size_t begin = 0; begin < data.n_cols; begin += batchSize)
     {
-      // Multiply for each variable and check whether the current weight vector
-      // correctly classifies this.
-      tempLabelMat = weights.t() * data.col(j) + biases;
+      const size_t end = std::min(begin + batchSize, (size_t) data.n_cols) - 1;
 
-      tempLabelMat.max(maxIndexRow, maxIndexCol);
+      // Multiply for each variable of the batch (with the weights from the
+      // start of the batch), and check whether the weight vectors correctly
+      // classify each point.
+      tempLabelMat = weights.t() * data.cols(begin, end);
+      tempLabelMat.each_col() += biases;
 
-      // Check whether prediction is correct.
-      if (maxIndexRow != labels(0, j))
+      for (j = begin; j <= end; j++)
       {
-        // Due to incorrect prediction, convergence set to false.
-        converged = false;
-        tempLabel = labels(0, j);
-
-        // Send maxIndexRow for knowing which weight to update, send j to know
-        // the value of the vector to update it with.  Send tempLabel to know
-        // the correct class.
-        if (hasWeights)
-          LP.UpdateWeights(data.col(j), weights, biases, maxIndexRow, tempLabel,
-              instanceWeights(j));
-        else
-          LP.UpdateWeights(data.col(j), weights, biases, maxIndexRow,
-              tempLabel);
+        maxIndexRow = tempLabelMat.col(j - begin).index_max();
+
+        // Check whether prediction is correct.
+        if (maxIndexRow != labels(0, j))
+        {
+          // Due to incorrect prediction, convergence set to false.
+          converged = false;
+          tempLabel = labels(0, j);
+
+          // Send maxIndexRow for knowing which weight to update, send j to
+          // know the value of the vector to update it with.  Send tempLabel to
+          // know the correct class.
+          if (hasWeights)
+            LP.UpdateWeights(data.col(j), weights, biases, maxIndexRow,
+                tempLabel, instanceWeights(j));
+          else
+            LP.UpdateWeights(data.col(j), weights, biases, maxIndexRow,
+                tempLabel);
+        }
       }
     }
   }
@@ -199,13 +206,19 @@ template<typename LearnPolicy,
 template<typename Archive>
 void Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::serialize(
     Archive& ar,
-    const unsigned int /* version */)
+    const unsigned int version)
 {
-  // We just need to serialize the maximum number of iterations, the weights,
-  // and the biases.
+  // We just need to serialize the maximum number of iterations, the batch
+  // size, the weights, and the biases.
   ar & BOOST_SERIALIZATION_NVP(maxIterations);
   ar & BOOST_SERIALIZATION_NVP(weights);
   ar & BOOST_SERIALIZATION_NVP(biases);
+
+  // Older models were trained one point at a time.
+  if (version > 0)
+    ar & BOOST_SERIALIZATION_NVP(batchSize);
+  else if (Archive::is_loading::value)
+    batchSize = 1;
 }
 
 } // namespace perceptron
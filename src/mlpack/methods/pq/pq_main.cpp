@@ -0,0 +1,278 @@
+/**
+ * @file methods/pq/pq_main.cpp
+ *
+ * This file computes the approximate nearest-neighbors from a reference set
+ * compressed with product quantization.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/cli.hpp>
+#include <mlpack/core/util/mlpack_main.hpp>
+
+#include "pq_search.hpp"
+
+using namespace std;
+using namespace mlpack;
+using namespace mlpack::neighbor;
+using namespace mlpack::util;
+
+// Information about the program itself.
+PROGRAM_INFO("K-Approximate-Nearest-Neighbor Search with Product Quantization",
+    // Short description.
+    "An implementation of approximate k-nearest-neighbor search on a reference "
+    "set compressed with product quantization, optionally with an inverted "
+    "file.  Given a set of reference points and a set of query points, this "
+    "will compute the k approximate nearest neighbors of each query point in "
+    "the reference set; models can be saved for future use.",
+    // Long description.
+    "This program will calculate the k approximate-nearest-neighbors of a set "
+    "of query points in a set of reference points compressed with product "
+    "quantization: the dimensions are split into " +
+    PRINT_PARAM_STRING("subvectors") + " groups, each group has its own "
+    "codebook of " + PRINT_PARAM_STRING("centroids") + " centroids (at most "
+    "256) found with k-means, and each reference point is stored as one byte "
+    "per group.  You may specify a separate set of reference points and query "
+    "points, or just a reference set which will be used as both the reference "
+    "and query set."
+    "\n\n"
+    "For example, the following will return 5 neighbors from the data for each "
+    "point in " + PRINT_DATASET("input") + ", with 8 bytes per point, and "
+    "store the distances in " + PRINT_DATASET("distances") + " and the "
+    "neighbors in " + PRINT_DATASET("neighbors") + ":"
+    "\n\n" +
+    PRINT_CALL("pq", "k", 5, "reference", "input", "subvectors", 8,
+        "distances", "distances", "neighbors", "neighbors") +
+    "\n\n"
+    "The output is organized such that row i and column j in the neighbors "
+    "output corresponds to the index of the point in the reference set which "
+    "is the j'th nearest neighbor from the point in the query set with index "
+    "i.  Row j and column i in the distances output file corresponds to the "
+    "distance between those two points."
+    "\n\n"
+    "If " + PRINT_PARAM_STRING("lists") + " is nonzero, the reference points "
+    "are also clustered into that many coarse clusters, and each query only "
+    "scans the points of its " + PRINT_PARAM_STRING("probes") + " nearest "
+    "clusters.  If " + PRINT_PARAM_STRING("keep_reference") + " is given, the "
+    "model also keeps the reference set, so that a search can re-rank the " +
+    PRINT_PARAM_STRING("rerank") + " nearest codes with the exact distance.  "
+    "For example, the following searches a saved model " +
+    PRINT_MODEL("model") + " for the 10 neighbors of each point in " +
+    PRINT_DATASET("queries") + ", scanning 4 clusters and re-ranking 100 "
+    "codes, and prints the recall against the true neighbors " +
+    PRINT_DATASET("true_neighbors") + ":"
+    "\n\n" +
+    PRINT_CALL("pq", "input_model", "model", "query", "queries", "k", 10,
+        "probes", 4, "rerank", 100, "true_neighbors", "true_neighbors",
+        "neighbors", "neighbors", "verbose", true) +
+    "\n\n"
+    "Because k-means is initialized at random, results may be different from "
+    "run to run.  Thus, the " + PRINT_PARAM_STRING("seed") + " parameter can "
+    "be specified to set the random seed.",
+    SEE_ALSO("@knn", "#knn"),
+    SEE_ALSO("@lsh", "#lsh"),
+    SEE_ALSO("@hnsw", "#hnsw"),
+    SEE_ALSO("Product quantization for nearest neighbor search (pdf)",
+        "https://hal.inria.fr/inria-00514462v2/document"),
+    SEE_ALSO("mlpack::neighbor::PQSearch C++ class documentation",
+        "@doxygen/classmlpack_1_1neighbor_1_1PQSearch.html"));
+
+// Define our input parameters that this program will take.
+PARAM_MATRIX_IN("reference", "Matrix containing the reference dataset.", "r");
+PARAM_MATRIX_OUT("distances", "Matrix to output distances into.", "d");
+PARAM_UMATRIX_OUT("neighbors", "Matrix to output neighbors into.", "n");
+
+// We can load or save models.
+PARAM_MODEL_IN(PQSearch<>, "input_model", "Input PQ model.", "m");
+PARAM_MODEL_OUT(PQSearch<>, "output_model", "Output for trained PQ model.",
+    "M");
+
+// For testing recall.
+PARAM_UMATRIX_IN("true_neighbors", "Matrix of true neighbors to compute "
+    "recall with (the recall is printed when -v is specified).", "t");
+
+PARAM_INT_IN("k", "Number of nearest neighbors to find.", "k", 0);
+PARAM_MATRIX_IN("query", "Matrix containing query points (optional).", "q");
+
+PARAM_INT_IN("subvectors", "The number of groups the dimensions are split "
+    "into (the number of bytes of each code).", "b", 8);
+PARAM_INT_IN("centroids", "The number of centroids of the codebook of each "
+    "group (at most 256).", "c", 256);
+PARAM_INT_IN("lists", "The number of coarse clusters of the inverted file; 0 "
+    "for no inverted file.", "l", 0);
+PARAM_FLAG("keep_reference", "If set, the model keeps the reference set, so "
+    "that the neighbors can be re-ranked.", "K");
+PARAM_INT_IN("sample_size", "If nonzero, the codebooks are learned from this "
+    "many points drawn at random from the reference set.", "S", 0);
+PARAM_INT_IN("max_iterations", "The maximum number of iterations of each "
+    "k-means clustering.", "i", 100);
+PARAM_INT_IN("probes", "The number of coarse clusters scanned for each query.",
+    "p", 1);
+PARAM_INT_IN("rerank", "If nonzero, the number of nearest codes re-ranked with "
+    "the exact distance (the model must keep the reference set).", "R", 0);
+PARAM_INT_IN("seed", "Random seed.  If 0, 'std::time(NULL)' is used.", "s", 0);
+
+static void mlpackMain()
+{
+  if (CLI::GetParam<int>("seed") != 0)
+    math::RandomSeed((size_t) CLI::GetParam<int>("seed"));
+  else
+    math::RandomSeed((size_t) time(NULL));
+
+  // Get all the parameters after checking them.
+  if (CLI::HasParam("k"))
+  {
+    RequireParamValue<int>("k", [](int x) { return x > 0; }, true,
+        "k must be greater than 0");
+  }
+  RequireParamValue<int>("subvectors", [](int x) { return x > 0; }, true,
+      "number of subvectors must be greater than 0");
+  RequireParamValue<int>("centroids", [](int x) { return x > 0 && x <= 256; },
+      true, "number of centroids must be between 1 and 256");
+  RequireParamValue<int>("lists", [](int x) { return x >= 0; }, true,
+      "number of lists must be nonnegative");
+  RequireParamValue<int>("sample_size", [](int x) { return x >= 0; }, true,
+      "sample size must be nonnegative");
+  RequireParamValue<int>("max_iterations", [](int x) { return x >= 0; }, true,
+      "maximum number of iterations must be nonnegative");
+  RequireParamValue<int>("probes", [](int x) { return x > 0; }, true,
+      "number of probes must be greater than 0");
+  RequireParamValue<int>("rerank", [](int x) { return x >= 0; }, true,
+      "number of re-ranked neighbors must be nonnegative");
+
+  const size_t k = CLI::GetParam<int>("k");
+
+  RequireOnlyOnePassed({ "input_model", "reference" }, true);
+  RequireAtLeastOnePassed({ "neighbors", "distances", "output_model" }, false,
+      "no results will be saved");
+  if (CLI::HasParam("input_model") && CLI::HasParam("k"))
+  {
+    // The model does not necessarily keep the reference set.
+    RequireAtLeastOnePassed({ "query" }, true, "must pass set to search");
+  }
+
+  ReportIgnoredParam({{ "k", false }}, "neighbors");
+  ReportIgnoredParam({{ "k", false }}, "distances");
+  ReportIgnoredParam({{ "k", false }}, "probes");
+  ReportIgnoredParam({{ "k", false }}, "rerank");
+
+  ReportIgnoredParam({{ "reference", false }}, "subvectors");
+  ReportIgnoredParam({{ "reference", false }}, "centroids");
+  ReportIgnoredParam({{ "reference", false }}, "lists");
+  ReportIgnoredParam({{ "reference", false }}, "keep_reference");
+  ReportIgnoredParam({{ "reference", false }}, "sample_size");
+  ReportIgnoredParam({{ "reference", false }}, "max_iterations");
+
+  if (CLI::HasParam("input_model") && !CLI::HasParam("k"))
+  {
+    Log::Warn << PRINT_PARAM_STRING("k") << " not passed; no search will be "
+        << "performed!" << std::endl;
+  }
+
+  // Pick up the PQ-specific parameters.
+  const size_t numSubvectors = CLI::GetParam<int>("subvectors");
+  const size_t numCentroids = CLI::GetParam<int>("centroids");
+  const size_t numLists = CLI::GetParam<int>("lists");
+  const bool keepReferenceSet = CLI::HasParam("keep_reference");
+  const size_t sampleSize = CLI::GetParam<int>("sample_size");
+  const size_t maxIterations = CLI::GetParam<int>("max_iterations");
+  const size_t numProbes = CLI::GetParam<int>("probes");
+  const size_t rerank = CLI::GetParam<int>("rerank");
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+
+  PQSearch<>* allkann;
+  arma::mat referenceData;
+  if (CLI::HasParam("reference"))
+  {
+    Log::Info << "Using product quantization with " << numSubvectors
+        << " subvectors of " << numCentroids << " centroids." << endl;
+    Log::Info << "Using reference data from "
+        << CLI::GetPrintableParam<arma::mat>("reference") << "." << endl;
+    referenceData = std::move(CLI::GetParam<arma::mat>("reference"));
+    allkann = new PQSearch<>();
+
+    Timer::Start("pq_training");
+    try
+    {
+      allkann->Train(referenceData, numSubvectors, numCentroids, numLists,
+          keepReferenceSet, sampleSize, maxIterations);
+    }
+    catch (std::invalid_argument& e)
+    {
+      delete allkann;
+      Log::Fatal << e.what();
+    }
+    Timer::Stop("pq_training");
+  }
+  else // We must have an input model.
+  {
+    allkann = CLI::GetParam<PQSearch<>*>("input_model");
+  }
+
+  if (CLI::HasParam("k"))
+  {
+    Log::Info << "Computing " << k << " distance approximate nearest neighbors."
+        << endl;
+    if (CLI::HasParam("query"))
+    {
+      Log::Info << "Loaded query data from "
+          << CLI::GetPrintableParam<arma::mat>("query") << "." << endl;
+      referenceData = std::move(CLI::GetParam<arma::mat>("query"));
+    }
+
+    try
+    {
+      allkann->Search(referenceData, k, neighbors, distances, numProbes,
+          rerank);
+    }
+    catch (std::invalid_argument& e)
+    {
+      if (CLI::HasParam("reference"))
+        delete allkann;
+      Log::Fatal << e.what();
+    }
+
+    Log::Info << "Neighbors computed." << endl;
+  }
+
+  // Compute recall, if desired.
+  if (CLI::HasParam("true_neighbors"))
+  {
+    Log::Info << "Using true neighbor indices from '"
+        << CLI::GetPrintableParam<arma::Mat<size_t>>("true_neighbors") << "'."
+        << endl;
+
+    // Load the true neighbors.
+    arma::Mat<size_t> trueNeighbors =
+        std::move(CLI::GetParam<arma::Mat<size_t>>("true_neighbors"));
+
+    if (trueNeighbors.n_rows != neighbors.n_rows ||
+        trueNeighbors.n_cols != neighbors.n_cols)
+    {
+      // Delete the model if needed.
+      if (CLI::HasParam("reference"))
+        delete allkann;
+      Log::Fatal << "The true neighbors file must have the same number of "
+          << "values as the set of neighbors being queried!" << endl;
+    }
+
+    // Compute recall and print it.
+    double recallPercentage = 100 * allkann->ComputeRecall(neighbors,
+        trueNeighbors);
+
+    Log::Info << "Recall: " << recallPercentage << endl;
+  }
+
+  // Save output, if we did a search.
+  if (CLI::HasParam("k"))
+  {
+    CLI::GetParam<arma::mat>("distances") = std::move(distances);
+    CLI::GetParam<arma::Mat<size_t>>("neighbors") = std::move(neighbors);
+  }
+  CLI::GetParam<PQSearch<>*>("output_model") = allkann;
+}
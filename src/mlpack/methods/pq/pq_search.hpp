@@ -0,0 +1,239 @@
+/**
+ * @file methods/pq/pq_search.hpp
+ *
+ * Defines the PQSearch class, which performs approximate nearest neighbor
+ * search over a reference set compressed with product quantization, with an
+ * optional inverted file of coarse clusters.
+ *
+ * The details of this method can be found in the following paper:
+ *
+ * @code
+ * @article{jegou2011product,
+ *   title={Product quantization for nearest neighbor search},
+ *   author={J{\'e}gou, Herv{\'e} and Douze, Matthijs and Schmid, Cordelia},
+ *   journal={IEEE Transactions on Pattern Analysis and Machine Intelligence},
+ *   volume={33},
+ *   number={1},
+ *   pages={117--128},
+ *   year={2011}
+ * }
+ * @endcode
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_PQ_PQ_SEARCH_HPP
+#define MLPACK_METHODS_PQ_PQ_SEARCH_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <mlpack/core/metrics/lmetric.hpp>
+#include <mlpack/methods/kmeans/kmeans.hpp>
+
+namespace mlpack {
+namespace neighbor {
+
+/**
+ * The PQSearch class; this class compresses the reference set with product
+ * quantization and computes the approximate (Euclidean) nearest neighbors of
+ * the given queries from the compressed codes.
+ *
+ * The dimensions are split into numSubvectors groups, and each group has its
+ * own codebook of numCentroids centroids found with k-means; a reference point
+ * is stored as the index of the nearest centroid of each group, one byte per
+ * group instead of one double per dimension.  For a query, the squared
+ * distances between each group of the query and each centroid of the group are
+ * computed once, and the distance to a reference point is then the sum of
+ * numSubvectors of these (asymmetric distance computation).
+ *
+ * With an inverted file (numLists > 0), the reference points are first
+ * clustered into numLists coarse clusters, the codes quantize the residual of
+ * each point from its coarse centroid, and a query only scans the points of
+ * its numProbes nearest coarse clusters.
+ *
+ * The reference set itself can be kept (keepReferenceSet) so that a search can
+ * re-rank a shortlist of the nearest codes with the exact distance.
+ *
+ * @tparam MatType Type of matrix to use to store the data (arma::mat or
+ *     arma::fmat).
+ */
+template<typename MatType = arma::mat>
+class PQSearch
+{
+ public:
+  /**
+   * Compress the given reference set.
+   *
+   * @param referenceSet Set of reference points.
+   * @param numSubvectors The number of groups of dimensions, each one stored
+   *     in one byte.
+   * @param numCentroids The number of centroids of each group (at most 256).
+   * @param numLists The number of coarse clusters of the inverted file; 0 for
+   *     no inverted file (every query scans every code).
+   * @param keepReferenceSet If true, the reference set is kept for
+   *     re-ranking.
+   * @param sampleSize If nonzero, the codebooks are learned from this many
+   *     points drawn at random from the reference set.
+   * @param maxIterations The maximum number of iterations of each k-means.
+   */
+  PQSearch(const MatType& referenceSet,
+           const size_t numSubvectors,
+           const size_t numCentroids = 256,
+           const size_t numLists = 0,
+           const bool keepReferenceSet = false,
+           const size_t sampleSize = 0,
+           const size_t maxIterations = 100);
+
+  /**
+   * Create an untrained PQ model.  Be sure to call Train() before calling
+   * Search(); otherwise, an exception will be thrown when Search() is called.
+   */
+  PQSearch();
+
+  /**
+   * Compress the given reference set, replacing the current model.  See the
+   * constructor for the parameters.
+   */
+  void Train(const MatType& referenceSet,
+             const size_t numSubvectors,
+             const size_t numCentroids = 256,
+             const size_t numLists = 0,
+             const bool keepReferenceSet = false,
+             const size_t sampleSize = 0,
+             const size_t maxIterations = 100);
+
+  /**
+   * Compute the approximate nearest neighbors of the points in the given query
+   * set and store the output in the given matrices.  The matrices will be set
+   * to the size of n columns by k rows, where n is the number of points in the
+   * query dataset and k is the number of neighbors being searched for.  If
+   * fewer than k reference points are scanned for a query, the remaining
+   * neighbors are SIZE_MAX and their distances DBL_MAX.
+   *
+   * @param querySet Set of query points.
+   * @param k Number of neighbors to search for.
+   * @param resultingNeighbors Matrix storing lists of neighbors for each query
+   *     point.
+   * @param distances Matrix storing distances of neighbors for each query
+   *     point (approximate, unless the neighbors are re-ranked).
+   * @param numProbes The number of coarse clusters scanned for each query
+   *     (ignored without an inverted file).
+   * @param rerank If nonzero, the max(k, rerank) nearest codes are re-ranked
+   *     with the exact distance; the reference set must have been kept.
+   */
+  void Search(const MatType& querySet,
+              const size_t k,
+              arma::Mat<size_t>& resultingNeighbors,
+              arma::mat& distances,
+              const size_t numProbes = 1,
+              const size_t rerank = 0);
+
+  /**
+   * Compute the codes (and the coarse clusters) of the given points with the
+   * current codebooks.
+   *
+   * @param points The points to encode.
+   * @param codes The code of each point (numSubvectors x number of points).
+   * @param lists The coarse cluster of each point.
+   */
+  void Encode(const MatType& points,
+              arma::Mat<unsigned char>& codes,
+              arma::Row<size_t>& lists) const;
+
+  /**
+   * Compute the recall (% of neighbors found) given the neighbors returned by
+   * PQSearch::Search and a "ground truth" set of neighbors.  The recall
+   * returned will be in the range [0, 1].
+   *
+   * @param foundNeighbors Set of neighbors to compute recall of.
+   * @param realNeighbors Set of "ground truth" neighbors to compute recall
+   *     against.
+   */
+  static double ComputeRecall(const arma::Mat<size_t>& foundNeighbors,
+                              const arma::Mat<size_t>& realNeighbors);
+
+  /**
+   * Serialize the PQ model.
+   *
+   * @param ar Archive to serialize to.
+   * @param version Version number.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+  //! Get the dimensionality of the data.
+  size_t Dimensionality() const { return dimensionality; }
+
+  //! Get the number of groups of dimensions.
+  size_t NumSubvectors() const { return subvectorBounds.n_elem - 1; }
+
+  //! Get the number of centroids of each group.
+  size_t NumCentroids() const { return codebooks.n_cols; }
+
+  //! Get the number of coarse clusters (1 without an inverted file).
+  size_t NumLists() const { return coarseCentroids.n_cols; }
+
+  //! Get the first dimension of each group (and the dimensionality at the
+  //! end).
+  const arma::Col<size_t>& SubvectorBounds() const { return subvectorBounds; }
+
+  //! Get the codebooks: the rows of group j are the rows SubvectorBounds()[j]
+  //! to SubvectorBounds()[j + 1] - 1, and each column is one centroid.
+  const arma::mat& Codebooks() const { return codebooks; }
+
+  //! Get the coarse centroids (one zero centroid without an inverted file).
+  const arma::mat& CoarseCentroids() const { return coarseCentroids; }
+
+  //! Get the offset of each coarse cluster in ListIndices() and Codes(); list
+  //! l holds the positions ListOffsets()[l] to ListOffsets()[l + 1] - 1.
+  const arma::Col<size_t>& ListOffsets() const { return listOffsets; }
+
+  //! Get the reference point at each position of the lists.
+  const arma::Col<size_t>& ListIndices() const { return listIndices; }
+
+  //! Get the codes, one column per position of the lists.
+  const arma::Mat<unsigned char>& Codes() const { return codes; }
+
+  //! Get the kept reference set (empty if it was not kept).
+  const MatType& ReferenceSet() const { return referenceSet; }
+
+ private:
+  //! Compute the squared distance between each point and each column of the
+  //! given centroids, with one matrix product.
+  static arma::mat SquaredDistances(const arma::mat& points,
+                                    const arma::mat& centroids);
+
+  //! Locally-stored dimensionality of the data.
+  size_t dimensionality;
+
+  //! Locally-stored first dimension of each group.
+  arma::Col<size_t> subvectorBounds;
+
+  //! Locally-stored codebooks of all the groups.
+  arma::mat codebooks;
+
+  //! Locally-stored coarse centroids.
+  arma::mat coarseCentroids;
+
+  //! Locally-stored offsets of the coarse clusters.
+  arma::Col<size_t> listOffsets;
+
+  //! Locally-stored reference point at each position of the lists.
+  arma::Col<size_t> listIndices;
+
+  //! Locally-stored codes.
+  arma::Mat<unsigned char> codes;
+
+  //! Locally-stored reference set, for re-ranking.
+  MatType referenceSet;
+}; // class PQSearch
+
+} // namespace neighbor
+} // namespace mlpack
+
+// Include implementation.
+#include "pq_search_impl.hpp"
+
+#endif
@@ -0,0 +1,386 @@
+/**
+ * @file methods/pq/pq_search_impl.hpp
+ *
+ * Implementation of the PQSearch class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_PQ_PQ_SEARCH_IMPL_HPP
+#define MLPACK_METHODS_PQ_PQ_SEARCH_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "pq_search.hpp"
+
+#include <queue>
+
+namespace mlpack {
+namespace neighbor {
+
+// Construct and train the model.
+template<typename MatType>
+PQSearch<MatType>::PQSearch(const MatType& referenceSet,
+                            const size_t numSubvectors,
+                            const size_t numCentroids,
+                            const size_t numLists,
+                            const bool keepReferenceSet,
+                            const size_t sampleSize,
+                            const size_t maxIterations) :
+    dimensionality(0)
+{
+  Train(referenceSet, numSubvectors, numCentroids, numLists, keepReferenceSet,
+      sampleSize, maxIterations);
+}
+
+// Empty constructor.
+template<typename MatType>
+PQSearch<MatType>::PQSearch() :
+    dimensionality(0)
+{
+  // Nothing to do here.
+}
+
+// Learn the codebooks and encode the reference set.
+template<typename MatType>
+void PQSearch<MatType>::Train(const MatType& referenceSet,
+                              const size_t numSubvectors,
+                              const size_t numCentroids,
+                              const size_t numLists,
+                              const bool keepReferenceSet,
+                              const size_t sampleSize,
+                              const size_t maxIterations)
+{
+  if (numSubvectors == 0 || numSubvectors > referenceSet.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "PQSearch::Train(): the number of subvectors (" << numSubvectors
+        << ") must be between 1 and the dimensionality of the data ("
+        << referenceSet.n_rows << ")!" << std::endl;
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (numCentroids == 0 || numCentroids > 256)
+  {
+    throw std::invalid_argument("PQSearch::Train(): the number of centroids "
+        "must be between 1 and 256!");
+  }
+
+  // Learn the codebooks from a sample of the reference set, if requested.
+  const size_t n = referenceSet.n_cols;
+  arma::mat sample;
+  if (sampleSize == 0 || sampleSize >= n)
+  {
+    sample = arma::conv_to<arma::mat>::from(referenceSet);
+  }
+  else
+  {
+    const arma::uvec indices = arma::randperm(n, sampleSize);
+    sample = arma::conv_to<arma::mat>::from(referenceSet.cols(indices));
+  }
+
+  if (sample.n_cols < std::max(numCentroids, numLists))
+  {
+    std::ostringstream oss;
+    oss << "PQSearch::Train(): " << sample.n_cols << " points are not enough "
+        << "to learn " << std::max(numCentroids, numLists) << " centroids!"
+        << std::endl;
+    throw std::invalid_argument(oss.str());
+  }
+
+  // Split the dimensions into groups of (nearly) equal size.
+  dimensionality = referenceSet.n_rows;
+  subvectorBounds.set_size(numSubvectors + 1);
+  for (size_t j = 0; j <= numSubvectors; ++j)
+    subvectorBounds[j] = j * dimensionality / numSubvectors;
+
+  // The coarse clusters of the inverted file; without one, there is a single
+  // list whose centroid is zero, so the residuals are the points themselves.
+  kmeans::KMeans<> kmeans(maxIterations);
+  if (numLists > 0)
+    kmeans.Cluster(sample, numLists, coarseCentroids);
+  else
+    coarseCentroids.zeros(dimensionality, 1);
+
+  const arma::urowvec sampleLists = arma::index_min(SquaredDistances(sample,
+      coarseCentroids), 0);
+  sample -= coarseCentroids.cols(sampleLists);
+
+  // One codebook for each group, learned from the residuals.
+  codebooks.set_size(dimensionality, numCentroids);
+  for (size_t j = 0; j < numSubvectors; ++j)
+  {
+    arma::mat centroids;
+    kmeans.Cluster(arma::mat(sample.rows(subvectorBounds[j],
+        subvectorBounds[j + 1] - 1)), numCentroids, centroids);
+    codebooks.rows(subvectorBounds[j], subvectorBounds[j + 1] - 1) =
+        centroids;
+  }
+  sample.reset();
+
+  // Encode every point, and store the codes list after list.
+  arma::Mat<unsigned char> pointCodes;
+  arma::Row<size_t> lists;
+  Encode(referenceSet, pointCodes, lists);
+
+  listOffsets.zeros(coarseCentroids.n_cols + 1);
+  for (size_t i = 0; i < n; ++i)
+    ++listOffsets[lists[i] + 1];
+  listOffsets = arma::cumsum(listOffsets);
+
+  arma::Col<size_t> positions = listOffsets;
+  listIndices.set_size(n);
+  codes.set_size(numSubvectors, n);
+  for (size_t i = 0; i < n; ++i)
+  {
+    const size_t position = positions[lists[i]]++;
+    listIndices[position] = i;
+    codes.col(position) = pointCodes.col(i);
+  }
+
+  if (keepReferenceSet)
+    this->referenceSet = referenceSet;
+  else
+    this->referenceSet.reset();
+}
+
+// Compute the codes of the given points.
+template<typename MatType>
+void PQSearch<MatType>::Encode(const MatType& points,
+                               arma::Mat<unsigned char>& pointCodes,
+                               arma::Row<size_t>& lists) const
+{
+  if (points.n_rows != dimensionality)
+  {
+    std::ostringstream oss;
+    oss << "PQSearch::Encode(): dimensionality of the points ("
+        << points.n_rows << ") is not equal to the dimensionality the model "
+        << "was trained on (" << dimensionality << ")!" << std::endl;
+    throw std::invalid_argument(oss.str());
+  }
+
+  const size_t numSubvectors = NumSubvectors();
+  pointCodes.set_size(numSubvectors, points.n_cols);
+  lists.set_size(points.n_cols);
+
+  // Encode the points in blocks, so that the distances to the centroids are
+  // computed with matrix products without holding all of them at once.
+  const size_t blockSize = 4096;
+  const size_t numBlocks = (points.n_cols + blockSize - 1) / blockSize;
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const size_t first = b * blockSize;
+    const size_t last = std::min(first + blockSize, (size_t) points.n_cols) -
+        1;
+    arma::mat block = arma::conv_to<arma::mat>::from(points.cols(first, last));
+
+    const arma::urowvec blockLists = arma::index_min(SquaredDistances(block,
+        coarseCentroids), 0);
+    lists.cols(first, last) = arma::conv_to<arma::Row<size_t>>::from(
+        blockLists);
+    block -= coarseCentroids.cols(blockLists);
+
+    for (size_t j = 0; j < numSubvectors; ++j)
+    {
+      const arma::uword firstRow = subvectorBounds[j];
+      const arma::uword lastRow = subvectorBounds[j + 1] - 1;
+      pointCodes.submat(j, first, j, last) =
+          arma::conv_to<arma::Row<unsigned char>>::from(arma::index_min(
+          SquaredDistances(block.rows(firstRow, lastRow),
+          codebooks.rows(firstRow, lastRow)), 0));
+    }
+  }
+}
+
+// Search for the approximate neighbors of the query set.
+template<typename MatType>
+void PQSearch<MatType>::Search(const MatType& querySet,
+                               const size_t k,
+                               arma::Mat<size_t>& resultingNeighbors,
+                               arma::mat& distances,
+                               const size_t numProbes,
+                               const size_t rerank)
+{
+  // Ensure the dimensionality of the query set is correct.
+  if (querySet.n_rows != dimensionality)
+  {
+    std::ostringstream oss;
+    oss << "PQSearch::Search(): dimensionality of query set ("
+        << querySet.n_rows << ") is not equal to the dimensionality the model "
+        << "was trained on (" << dimensionality << ")!" << std::endl;
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (k > listIndices.n_elem)
+  {
+    std::ostringstream oss;
+    oss << "PQSearch::Search(): requested " << k << " approximate nearest "
+        << "neighbors, but reference set has " << listIndices.n_elem
+        << " points!" << std::endl;
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (rerank > 0 && referenceSet.n_cols != listIndices.n_elem)
+  {
+    throw std::invalid_argument("PQSearch::Search(): cannot re-rank the "
+        "neighbors, since the reference set was not kept!");
+  }
+
+  resultingNeighbors.set_size(k, querySet.n_cols);
+  distances.set_size(k, querySet.n_cols);
+
+  // If the user asked for 0 nearest neighbors... uh... we're done.
+  if (k == 0)
+    return;
+
+  const size_t numSubvectors = NumSubvectors();
+  const size_t numCentroids = NumCentroids();
+  const size_t probes = std::min(std::max(numProbes, (size_t) 1), NumLists());
+  const size_t shortlist = std::max(k, rerank);
+
+  Timer::Start("computing_neighbors");
+
+  // Parallelization to process more than one query at a time.
+  #pragma omp parallel for \
+      shared(resultingNeighbors, distances) \
+      schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) querySet.n_cols; ++i)
+  {
+    const arma::vec query = arma::conv_to<arma::vec>::from(querySet.col(i));
+    const arma::uvec order = arma::sort_index(SquaredDistances(query,
+        coarseCentroids));
+
+    // The shortlist of the nearest codes, farthest first.
+    typedef std::pair<double, size_t> Candidate;
+    std::priority_queue<Candidate> nearest;
+    arma::mat table(numCentroids, numSubvectors);
+    for (size_t p = 0; p < probes; ++p)
+    {
+      // The squared distance between each group of the residual of the query
+      // and each centroid of the group.
+      const size_t list = order[p];
+      const arma::vec residual = query - coarseCentroids.col(list);
+      for (size_t j = 0; j < numSubvectors; ++j)
+      {
+        const arma::uword firstRow = subvectorBounds[j];
+        const arma::uword lastRow = subvectorBounds[j + 1] - 1;
+        table.col(j) = SquaredDistances(residual.rows(firstRow, lastRow),
+            codebooks.rows(firstRow, lastRow));
+      }
+
+      const double* tableMem = table.memptr();
+      for (size_t pos = listOffsets[list]; pos < listOffsets[list + 1]; ++pos)
+      {
+        const unsigned char* code = codes.colptr(pos);
+        double distance = 0.0;
+        for (size_t j = 0; j < numSubvectors; ++j)
+          distance += tableMem[j * numCentroids + code[j]];
+
+        if (nearest.size() < shortlist)
+        {
+          nearest.push(Candidate(distance, listIndices[pos]));
+        }
+        else if (distance < nearest.top().first)
+        {
+          nearest.pop();
+          nearest.push(Candidate(distance, listIndices[pos]));
+        }
+      }
+    }
+
+    std::vector<Candidate> candidates(nearest.size());
+    for (size_t j = candidates.size(); j-- > 0; )
+    {
+      candidates[j] = nearest.top();
+      candidates[j].first = std::sqrt(std::max(candidates[j].first, 0.0));
+      nearest.pop();
+    }
+
+    // Re-rank the shortlist with the exact distances, if requested.
+    if (rerank > 0)
+    {
+      for (size_t j = 0; j < candidates.size(); ++j)
+      {
+        candidates[j].first = metric::EuclideanDistance::Evaluate(
+            querySet.col(i), referenceSet.col(candidates[j].second));
+      }
+      std::sort(candidates.begin(), candidates.end());
+    }
+
+    for (size_t j = 0; j < k; ++j)
+    {
+      if (j < candidates.size())
+      {
+        resultingNeighbors(j, i) = candidates[j].second;
+        distances(j, i) = candidates[j].first;
+      }
+      else
+      {
+        resultingNeighbors(j, i) = SIZE_MAX;
+        distances(j, i) = DBL_MAX;
+      }
+    }
+  }
+
+  Timer::Stop("computing_neighbors");
+}
+
+template<typename MatType>
+arma::mat PQSearch<MatType>::SquaredDistances(const arma::mat& points,
+                                              const arma::mat& centroids)
+{
+  arma::mat result = -2.0 * centroids.t() * points;
+  result.each_col() += arma::sum(arma::square(centroids), 0).t();
+  result.each_row() += arma::sum(arma::square(points), 0);
+  return result;
+}
+
+template<typename MatType>
+double PQSearch<MatType>::ComputeRecall(
+    const arma::Mat<size_t>& foundNeighbors,
+    const arma::Mat<size_t>& realNeighbors)
+{
+  if (foundNeighbors.n_rows != realNeighbors.n_rows ||
+      foundNeighbors.n_cols != realNeighbors.n_cols)
+    throw std::invalid_argument("PQSearch::ComputeRecall(): matrices provided"
+        " must have equal size");
+
+  const size_t queries = foundNeighbors.n_cols;
+  const size_t neighbors = foundNeighbors.n_rows; // Should be equal to k.
+
+  // The recall is the set intersection of found and real neighbors.
+  size_t found = 0;
+  for (size_t col = 0; col < queries; ++col)
+    for (size_t row = 0; row < neighbors; ++row)
+      for (size_t nei = 0; nei < realNeighbors.n_rows; ++nei)
+        if (realNeighbors(row, col) == foundNeighbors(nei, col))
+        {
+          found++;
+          break;
+        }
+
+  return ((double) found) / realNeighbors.n_elem;
+}
+
+template<typename MatType>
+template<typename Archive>
+void PQSearch<MatType>::serialize(Archive& ar,
+                                  const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(dimensionality);
+  ar & BOOST_SERIALIZATION_NVP(subvectorBounds);
+  ar & BOOST_SERIALIZATION_NVP(codebooks);
+  ar & BOOST_SERIALIZATION_NVP(coarseCentroids);
+  ar & BOOST_SERIALIZATION_NVP(listOffsets);
+  ar & BOOST_SERIALIZATION_NVP(listIndices);
+  ar & BOOST_SERIALIZATION_NVP(codes);
+  ar & BOOST_SERIALIZATION_NVP(referenceSet);
+}
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
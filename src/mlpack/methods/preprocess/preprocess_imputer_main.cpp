@@ -167,31 +167,28 @@ static void mlpackMain()
       Log::Info << "Performing '" << strategy << "' imputation strategy "
           << "to replace '" << missingValue << "' on all dimensions." << endl;
 
+      // Every dimension is imputed in a single pass.
       if (strategy == "mean")
       {
         Imputer<double, MapperType, MeanImputation<double>> imputer(info);
-        for (size_t i : dirtyDimensions)
-          imputer.Impute(input, missingValue, i);
+        imputer.Impute(input, missingValue);
       }
       else if (strategy == "median")
       {
         Imputer<double, MapperType, MedianImputation<double>> imputer(info);
-        for (size_t i : dirtyDimensions)
-          imputer.Impute(input, missingValue, i);
+        imputer.Impute(input, missingValue);
       }
       else if (strategy == "listwise_deletion")
       {
         Imputer<double, MapperType, ListwiseDeletion<double>> imputer(info);
-        for (size_t i : dirtyDimensions)
-          imputer.Impute(input, missingValue, i);
+        imputer.Impute(input, missingValue);
       }
       else if (strategy == "custom")
       {
         CustomImputation<double> strat(customValue);
         Imputer<double, MapperType, CustomImputation<double>> imputer(
             info, strat);
-        for (size_t i : dirtyDimensions)
-          imputer.Impute(input, missingValue, i);
+        imputer.Impute(input, missingValue);
       }
       else
       {
@@ -119,9 +119,9 @@ static void mlpackMain()
     "standard_scaler", "max_abs_scaler", "mean_normalization", "pca_whitening",
     "zca_whitening" }, true, "unknown scaler type");
 
-  // Load the data.
-  arma::mat& input = CLI::GetParam<arma::mat>("input");
-  arma::mat output;
+  // Load the data.  It is scaled in place, so that only one copy of it is held
+  // in memory.
+  arma::mat data = std::move(CLI::GetParam<arma::mat>("input"));
   ScalingModel* m;
   Timer::Start("feature_scaling");
   if (CLI::HasParam("input_model"))
@@ -162,7 +162,7 @@ static void mlpackMain()
     // and clean the memory in that situation.
     try
     {
-      m->Fit(input);
+      m->Fit(data);
     }
     catch (std::exception& e)
     {
@@ -173,7 +173,7 @@ static void mlpackMain()
 
   if (!CLI::HasParam("inverse_scaling"))
   {
-    m->Transform(input, output);
+    m->Transform(data);
   }
   else
   {
@@ -182,12 +182,12 @@ static void mlpackMain()
       delete m;
       throw std::runtime_error("Please provide a saved model.");
     }
-    m->InverseTransform(input, output);
+    m->InverseTransform(data);
   }
 
   // Save the output.
   if (CLI::HasParam("output"))
-    CLI::GetParam<arma::mat>("output") = std::move(output);
+    CLI::GetParam<arma::mat>("output") = std::move(data);
   Timer::Stop("feature_scaling");
 
   CLI::GetParam<ScalingModel*>("output_model") = m;
@@ -77,14 +77,33 @@ class ScalingModel
   template<typename MatType>
   void Transform(const MatType& input, MatType& output);
 
+  //! Transform to scale features in place.
+  template<typename MatType>
+  void Transform(MatType& input);
+
   // Fit to intialize the scaling parameter.
   template<typename MatType>
   void Fit(const MatType& input);
 
+  /**
+   * Update the scaling parameters with another chunk of the dataset, so that a
+   * dataset too large for memory can be fit in chunks.  The scaler is created
+   * by the first call.  PCA and ZCA whitening cannot be fit in chunks; for
+   * them, std::invalid_argument is thrown.
+   *
+   * @param input Chunk of the dataset to fit.
+   */
+  template<typename MatType>
+  void PartialFit(const MatType& input);
+
   // Scale back the dataset to their original values.
   template<typename MatType>
   void InverseTransform(const MatType& input, MatType& output);
 
+  //! Scale back the dataset to their original values, in place.
+  template<typename MatType>
+  void InverseTransform(MatType& input);
+
   //! Serialize the model.
   template<typename Archive>
   void serialize(Archive& ar, const unsigned int /* version */)
@@ -174,6 +174,40 @@ void ScalingModel::Fit(const MatType& input)
   }
 }
 
+template<typename MatType>
+void ScalingModel::PartialFit(const MatType& input)
+{
+  if (scalerType == ScalerTypes::STANDARD_SCALER)
+  {
+    if (!standardscale)
+      standardscale = new data::StandardScaler();
+    standardscale->PartialFit(input);
+  }
+  else if (scalerType == ScalerTypes::MIN_MAX_SCALER)
+  {
+    if (!minmaxscale)
+      minmaxscale = new data::MinMaxScaler(minValue, maxValue);
+    minmaxscale->PartialFit(input);
+  }
+  else if (scalerType == ScalerTypes::MEAN_NORMALIZATION)
+  {
+    if (!meanscale)
+      meanscale = new data::MeanNormalization();
+    meanscale->PartialFit(input);
+  }
+  else if (scalerType == ScalerTypes::MAX_ABS_SCALER)
+  {
+    if (!maxabsscale)
+      maxabsscale = new data::MaxAbsScaler();
+    maxabsscale->PartialFit(input);
+  }
+  else
+  {
+    throw std::invalid_argument("ScalingModel::PartialFit(): PCA and ZCA "
+        "whitening cannot be fit in chunks");
+  }
+}
+
 template<typename MatType>
 void ScalingModel::Transform(const MatType& input, MatType& output)
 {
@@ -203,6 +237,35 @@ void ScalingModel::Transform(const MatType& input, MatType& output)
   }
 }
 
+template<typename MatType>
+void ScalingModel::Transform(MatType& input)
+{
+  if (scalerType == ScalerTypes::STANDARD_SCALER)
+  {
+    standardscale->Transform(input);
+  }
+  else if (scalerType == ScalerTypes::MIN_MAX_SCALER)
+  {
+    minmaxscale->Transform(input);
+  }
+  else if (scalerType == ScalerTypes::MEAN_NORMALIZATION)
+  {
+    meanscale->Transform(input);
+  }
+  else if (scalerType == ScalerTypes::MAX_ABS_SCALER)
+  {
+    maxabsscale->Transform(input);
+  }
+  else
+  {
+    // The whitening transforms are matrix products, which can't be computed in
+    // place.
+    MatType output;
+    Transform(input, output);
+    input = std::move(output);
+  }
+}
+
 template<typename MatType>
 void ScalingModel::InverseTransform(const MatType& input, MatType& output)
 {
@@ -232,6 +295,33 @@ void ScalingModel::InverseTransform(const MatType& input, MatType& output)
   }
 }
 
+template<typename MatType>
+void ScalingModel::InverseTransform(MatType& input)
+{
+  if (scalerType == ScalerTypes::STANDARD_SCALER)
+  {
+    standardscale->InverseTransform(input);
+  }
+  else if (scalerType == ScalerTypes::MIN_MAX_SCALER)
+  {
+    minmaxscale->InverseTransform(input);
+  }
+  else if (scalerType == ScalerTypes::MEAN_NORMALIZATION)
+  {
+    meanscale->InverseTransform(input);
+  }
+  else if (scalerType == ScalerTypes::MAX_ABS_SCALER)
+  {
+    maxabsscale->InverseTransform(input);
+  }
+  else
+  {
+    MatType output;
+    InverseTransform(input, output);
+    input = std::move(output);
+  }
+}
+
 } // namespace data
 } // namespace mlpack
 
@@ -45,7 +45,8 @@ void Radical::CopyAndPerturb(mat& xNew, const mat& x) const
 
 double Radical::Vasicek(vec& z) const
 {
-  z = sort(z);
+  // Sort in place, to avoid allocating a new vector at each evaluation.
+  std::sort(z.begin(), z.end());
 
   // Apparently slower.
   /*
@@ -70,26 +71,30 @@ double Radical::DoRadical2D(const mat& matX)
 {
   CopyAndPerturb(perturbed, matX);
 
-  mat::fixed<2, 2> matJacobi;
-
   vec values(angles);
 
-  for (size_t i = 0; i < angles; i++)
+  // The angles are independent, so they are evaluated in parallel; each thread
+  // rotates the perturbed data into its own buffers, which Vasicek() sorts in
+  // place.
+  #pragma omp parallel
   {
-    const double theta = (i / (double) angles) * M_PI / 2.0;
-    const double cosTheta = cos(theta);
-    const double sinTheta = sin(theta);
+    vec candidateY1(perturbed.n_rows);
+    vec candidateY2(perturbed.n_rows);
 
-    matJacobi(0, 0) = cosTheta;
-    matJacobi(1, 0) = -sinTheta;
-    matJacobi(0, 1) = sinTheta;
-    matJacobi(1, 1) = cosTheta;
+    #pragma omp for schedule(static)
+    for (omp_size_t i = 0; i < (omp_size_t) angles; i++)
+    {
+      const double theta = (i / (double) angles) * M_PI / 2.0;
+      const double cosTheta = cos(theta);
+      const double sinTheta = sin(theta);
 
-    candidate = perturbed * matJacobi;
-    vec candidateY1 = candidate.unsafe_col(0);
-    vec candidateY2 = candidate.unsafe_col(1);
+      // This is the product of the perturbed data with the Jacobi rotation
+      // [cos sin; -sin cos].
+      candidateY1 = cosTheta * perturbed.col(0) - sinTheta * perturbed.col(1);
+      candidateY2 = sinTheta * perturbed.col(0) + cosTheta * perturbed.col(1);
 
-    values(i) = Vasicek(candidateY1) + Vasicek(candidateY2);
+      values(i) = Vasicek(candidateY1) + Vasicek(candidateY2);
+    }
   }
 
   uword indOpt = 0;
@@ -134,8 +139,6 @@ void Radical::DoRadical(const mat& matXT, mat& matY, mat& matW)
 
   mat matYSubspace(nPoints, 2);
 
-  mat matJ = eye(nDims, nDims);
-
   for (size_t sweepNum = 0; sweepNum < sweeps; sweepNum++)
   {
     Log::Info << "RADICAL: sweep " << sweepNum << "." << std::endl;
@@ -155,19 +158,13 @@ void Radical::DoRadical(const mat& matXT, mat& matY, mat& matW)
         const double cosThetaOpt = cos(thetaOpt);
         const double sinThetaOpt = sin(thetaOpt);
 
-        // Set elements of transformation matrix.
-        matJ(i, i) = cosThetaOpt;
-        matJ(j, i) = -sinThetaOpt;
-        matJ(i, j) = sinThetaOpt;
-        matJ(j, j) = cosThetaOpt;
-
-        matY *= matJ;
-
-        // Unset elements of transformation matrix, so matJ = eye() again.
-        matJ(i, i) = 1;
-        matJ(j, i) = 0;
-        matJ(i, j) = 0;
-        matJ(j, j) = 1;
+        // Apply the Jacobi rotation of dimensions i and j.  It only changes
+        // those two columns, so we don't need to multiply by the full
+        // nDims x nDims transformation matrix.
+        matY.col(i) = cosThetaOpt * matYSubspace.col(0) -
+            sinThetaOpt * matYSubspace.col(1);
+        matY.col(j) = sinThetaOpt * matYSubspace.col(0) +
+            cosThetaOpt * matYSubspace.col(1);
       }
     }
   }
@@ -78,6 +78,7 @@ class Radical
    * (Learned-Miller and Fisher, 2003).
    *
    * @param x Empirical sample (one-dimensional) over which to estimate entropy.
+   *     It is sorted in place.
    */
   double Vasicek(arma::vec& x) const;
 
@@ -88,7 +89,10 @@ class Radical
    */
   void CopyAndPerturb(arma::mat& xNew, const arma::mat& x) const;
 
-  //! Two-dimensional version of RADICAL.
+  /**
+   * Two-dimensional version of RADICAL.  The angles are evaluated in parallel
+   * if OpenMP is available.
+   */
   double DoRadical2D(const arma::mat& matX);
 
   //! Get the standard deviation of the additive Gaussian noise.
@@ -131,8 +135,6 @@ class Radical
 
   //! Internal matrix, held as member variable to prevent memory reallocations.
   arma::mat perturbed;
-  //! Internal matrix, held as member variable to prevent memory reallocations.
-  arma::mat candidate;
 };
 
 void WhitenFeatureMajorMatrix(const arma::mat& matX,
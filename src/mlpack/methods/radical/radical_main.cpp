@@ -133,9 +133,9 @@ static void mlpackMain()
     }
 
     // Force output even if --verbose is not given.
-    const bool ignoring = Log::Info.ignoreInput;
-    Log::Info.ignoreInput = false;
+    const bool ignoring = Log::Info.IgnoreInput();
+    Log::Info.SetIgnoreInput(false);
     Log::Info << "Objective (estimate): " << valEst << "." << endl;
-    Log::Info.ignoreInput = ignoring;
+    Log::Info.SetIgnoreInput(ignoring);
   }
 }
@@ -47,6 +47,37 @@ void Bootstrap(const MatType& dataset,
   }
 }
 
+/**
+ * Given a dataset, draw the indices of the points of a bootstrap sample, and
+ * create the labels (and weights) of the sample.  The points themselves are
+ * not copied; the indices can be given to IndexedMatrix.
+ */
+template<bool UseWeights,
+         typename MatType,
+         typename LabelsType,
+         typename WeightsType>
+void BootstrapIndices(const MatType& dataset,
+                      const LabelsType& labels,
+                      const WeightsType& weights,
+                      arma::uvec& indices,
+                      LabelsType& bootstrapLabels,
+                      WeightsType& bootstrapWeights)
+{
+  bootstrapLabels.set_size(labels.n_elem);
+  if (UseWeights)
+    bootstrapWeights.set_size(weights.n_elem);
+
+  // Random sampling with replacement.
+  indices = arma::randi<arma::uvec>(dataset.n_cols,
+      arma::distr_param(0, dataset.n_cols - 1));
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    bootstrapLabels[i] = labels[indices[i]];
+    if (UseWeights)
+      bootstrapWeights[i] = weights[indices[i]];
+  }
+}
+
 } // namespace tree
 } // namespace mlpack
 
@@ -0,0 +1,220 @@
+/**
+ * @file methods/random_forest/flat_forest.hpp
+ *
+ * Definition of the FlatForest class, a compact form of trained decision trees
+ * and random forests that is only used for classification.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RANDOM_FOREST_FLAT_FOREST_HPP
+#define MLPACK_METHODS_RANDOM_FOREST_FLAT_FOREST_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "random_forest.hpp"
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * FlatForest holds the trees of a trained DecisionTree or RandomForest in one
+ * contiguous array of nodes, and the class probabilities of all leaves in one
+ * matrix, so that classification does not follow pointers between nodes that
+ * are spread over the heap.  Points are classified in blocks: all points of a
+ * block go through one tree before the next tree is used, so that both the
+ * block and the top of the tree stay in cache.  With OpenMP the blocks are
+ * classified in parallel.
+ *
+ * The predictions and probabilities are the same as those of the original
+ * model.  The trees may use any numeric split whose children are chosen with
+ * a threshold (as BestBinaryNumericSplit and HistogramNumericSplit do), and
+ * categorical splits with one child per category (as AllCategoricalSplit
+ * does).  A FlatForest cannot be trained; it has to be built again when the
+ * original model changes.
+ *
+ * @code
+ * RandomForest<> rf(data, labels, numClasses, 500);
+ * FlatForest flat(rf);
+ * flat.Classify(testData, predictions, probabilities);
+ * @endcode
+ */
+class FlatForest
+{
+ public:
+  //! Create an empty FlatForest; Classify() throws until a model is loaded.
+  FlatForest() : numClasses(0), blockSize(64) { }
+
+  /**
+   * Create a FlatForest that holds the given decision tree.
+   *
+   * @param tree Trained decision tree.
+   */
+  template<typename FitnessFunction,
+           template<typename> class NumericSplitType,
+           template<typename> class CategoricalSplitType,
+           typename DimensionSelectionType,
+           typename ElemType,
+           bool NoRecursion>
+  explicit FlatForest(const DecisionTree<FitnessFunction,
+                                         NumericSplitType,
+                                         CategoricalSplitType,
+                                         DimensionSelectionType,
+                                         ElemType,
+                                         NoRecursion>& tree);
+
+  /**
+   * Create a FlatForest that holds all trees of the given random forest.
+   *
+   * @param forest Trained random forest.
+   */
+  template<typename FitnessFunction,
+           typename DimensionSelectionType,
+           template<typename> class NumericSplitType,
+           template<typename> class CategoricalSplitType,
+           typename ElemType>
+  explicit FlatForest(const RandomForest<FitnessFunction,
+                                         DimensionSelectionType,
+                                         NumericSplitType,
+                                         CategoricalSplitType,
+                                         ElemType>& forest);
+
+  /**
+   * Predict the class of the given point.
+   *
+   * @param point Point to classify.
+   */
+  template<typename VecType>
+  size_t Classify(const VecType& point) const;
+
+  /**
+   * Predict the class of each of the given points.
+   *
+   * @param data Points to classify.
+   * @param predictions This will be filled with the predicted classes.
+   */
+  template<typename eT>
+  void Classify(const arma::Mat<eT>& data,
+                arma::Row<size_t>& predictions) const;
+
+  /**
+   * Predict the class of each of the given points, and the average class
+   * probabilities of the trees for each point.
+   *
+   * @param data Points to classify.
+   * @param predictions This will be filled with the predicted classes.
+   * @param probabilities This will be filled with the class probabilities of
+   *     each point.
+   */
+  template<typename eT>
+  void Classify(const arma::Mat<eT>& data,
+                arma::Row<size_t>& predictions,
+                arma::mat& probabilities) const;
+
+  //! Get the number of trees.
+  size_t NumTrees() const { return roots.size(); }
+  //! Get the number of nodes of all trees.
+  size_t NumNodes() const { return nodes.size(); }
+  //! Get the number of classes.
+  size_t NumClasses() const { return numClasses; }
+
+  //! Get the number of points that are classified together.
+  size_t BlockSize() const { return blockSize; }
+  //! Modify the number of points that are classified together.
+  size_t& BlockSize() { return blockSize; }
+
+  //! Serialize the FlatForest.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  //! A node of one of the trees.
+  struct Node
+  {
+    //! The dimension the node splits on, or the column of its class
+    //! probabilities if the node is a leaf.
+    size_t dimension;
+    //! The index of the first child; the children are next to each other.
+    //! This is 0 for leaves, since no node has the root of a tree as a child.
+    size_t firstChild;
+    //! The threshold of a numeric split; points with a value up to the
+    //! threshold go to the first child, the others to the second child.
+    double threshold;
+    //! Whether the node splits on a categorical dimension, in which case the
+    //! points go to the child of their category.
+    bool categorical;
+
+    //! Serialize the node.
+    template<typename Archive>
+    void serialize(Archive& ar, const unsigned int /* version */)
+    {
+      ar & BOOST_SERIALIZATION_NVP(dimension);
+      ar & BOOST_SERIALIZATION_NVP(firstChild);
+      ar & BOOST_SERIALIZATION_NVP(threshold);
+      ar & BOOST_SERIALIZATION_NVP(categorical);
+    }
+  };
+
+  /**
+   * Append the given tree to the forest.
+   *
+   * @param tree Trained decision tree.
+   * @param leafValues The class probabilities of the leaves found so far; the
+   *     ones of the leaves of the tree are appended.
+   */
+  template<typename TreeType>
+  void AddTree(const TreeType& tree, std::vector<double>& leafValues);
+
+  /**
+   * Store the given node of a tree at the given index, and append its
+   * children.
+   */
+  template<typename TreeType>
+  void FlattenNode(const TreeType& node,
+                   const size_t index,
+                   std::vector<double>& leafValues);
+
+  /**
+   * Find the leaf of the given tree that the given point falls into.
+   *
+   * @param point Point to classify; it only needs operator[].
+   * @param root Index of the root of the tree.
+   * @return The column of the class probabilities of the leaf.
+   */
+  template<typename PointType>
+  size_t Leaf(const PointType& point, const size_t root) const
+  {
+    size_t i = root;
+    while (nodes[i].firstChild != 0)
+    {
+      const Node& node = nodes[i];
+      const double value = point[node.dimension];
+      if (node.categorical)
+        i = node.firstChild + (size_t) value;
+      else
+        i = node.firstChild + ((value <= node.threshold) ? 0 : 1);
+    }
+
+    return nodes[i].dimension;
+  }
+
+  //! The nodes of all trees.
+  std::vector<Node> nodes;
+  //! The index of the root of each tree.
+  std::vector<size_t> roots;
+  //! The class probabilities of each leaf.
+  arma::mat leafProbabilities;
+  //! The number of classes.
+  size_t numClasses;
+  //! The number of points that are classified together.
+  size_t blockSize;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "flat_forest_impl.hpp"
+
+#endif
@@ -0,0 +1,219 @@
+/**
+ * @file methods/random_forest/flat_forest_impl.hpp
+ *
+ * Implementation of the FlatForest class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RANDOM_FOREST_FLAT_FOREST_IMPL_HPP
+#define MLPACK_METHODS_RANDOM_FOREST_FLAT_FOREST_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "flat_forest.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         typename ElemType,
+         bool NoRecursion>
+FlatForest::FlatForest(const DecisionTree<FitnessFunction,
+                                          NumericSplitType,
+                                          CategoricalSplitType,
+                                          DimensionSelectionType,
+                                          ElemType,
+                                          NoRecursion>& tree) :
+    numClasses(tree.NumClasses()),
+    blockSize(64)
+{
+  std::vector<double> leafValues;
+  AddTree(tree, leafValues);
+  leafProbabilities = arma::mat(leafValues.data(), numClasses,
+      leafValues.size() / numClasses);
+}
+
+template<typename FitnessFunction,
+         typename DimensionSelectionType,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename ElemType>
+FlatForest::FlatForest(const RandomForest<FitnessFunction,
+                                          DimensionSelectionType,
+                                          NumericSplitType,
+                                          CategoricalSplitType,
+                                          ElemType>& forest) :
+    numClasses(0),
+    blockSize(64)
+{
+  if (forest.NumTrees() == 0)
+  {
+    throw std::invalid_argument("FlatForest::FlatForest(): no random forest "
+        "trained!");
+  }
+
+  numClasses = forest.Tree(0).NumClasses();
+  std::vector<double> leafValues;
+  for (size_t i = 0; i < forest.NumTrees(); ++i)
+    AddTree(forest.Tree(i), leafValues);
+
+  leafProbabilities = arma::mat(leafValues.data(), numClasses,
+      leafValues.size() / numClasses);
+}
+
+template<typename VecType>
+size_t FlatForest::Classify(const VecType& point) const
+{
+  if (roots.empty())
+  {
+    throw std::invalid_argument("FlatForest::Classify(): no trees in the "
+        "forest!");
+  }
+
+  // Add the probabilities in the same order as the original model, so that
+  // the result is the same.
+  arma::vec probabilities(numClasses, arma::fill::zeros);
+  for (size_t t = 0; t < roots.size(); ++t)
+    probabilities += leafProbabilities.col(Leaf(point, roots[t]));
+  probabilities /= roots.size();
+
+  arma::uword maxIndex = 0;
+  probabilities.max(maxIndex);
+  return (size_t) maxIndex;
+}
+
+template<typename eT>
+void FlatForest::Classify(const arma::Mat<eT>& data,
+                          arma::Row<size_t>& predictions) const
+{
+  arma::mat probabilities;
+  Classify(data, predictions, probabilities);
+}
+
+template<typename eT>
+void FlatForest::Classify(const arma::Mat<eT>& data,
+                          arma::Row<size_t>& predictions,
+                          arma::mat& probabilities) const
+{
+  if (roots.empty())
+  {
+    predictions.clear();
+    probabilities.clear();
+
+    throw std::invalid_argument("FlatForest::Classify(): no trees in the "
+        "forest!");
+  }
+
+  predictions.set_size(data.n_cols);
+  probabilities.zeros(numClasses, data.n_cols);
+
+  const size_t block = std::max(blockSize, (size_t) 1);
+  const size_t numBlocks = (data.n_cols + block - 1) / block;
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const size_t begin = b * block;
+    const size_t end = std::min(begin + block, (size_t) data.n_cols);
+
+    // All points of the block go through one tree before the next tree is
+    // used.
+    for (size_t t = 0; t < roots.size(); ++t)
+    {
+      for (size_t i = begin; i < end; ++i)
+      {
+        const double* leaf = leafProbabilities.colptr(Leaf(data.colptr(i),
+            roots[t]));
+        double* out = probabilities.colptr(i);
+        for (size_t c = 0; c < numClasses; ++c)
+          out[c] += leaf[c];
+      }
+    }
+
+    for (size_t i = begin; i < end; ++i)
+    {
+      double* out = probabilities.colptr(i);
+      for (size_t c = 0; c < numClasses; ++c)
+        out[c] /= roots.size();
+
+      arma::uword maxIndex = 0;
+      probabilities.unsafe_col(i).max(maxIndex);
+      predictions[i] = (size_t) maxIndex;
+    }
+  }
+}
+
+template<typename Archive>
+void FlatForest::serialize(Archive& ar, const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(nodes);
+  ar & BOOST_SERIALIZATION_NVP(roots);
+  ar & BOOST_SERIALIZATION_NVP(leafProbabilities);
+  ar & BOOST_SERIALIZATION_NVP(numClasses);
+  ar & BOOST_SERIALIZATION_NVP(blockSize);
+}
+
+template<typename TreeType>
+void FlatForest::AddTree(const TreeType& tree,
+                         std::vector<double>& leafValues)
+{
+  if (tree.NumClasses() != numClasses)
+  {
+    std::ostringstream oss;
+    oss << "FlatForest::AddTree(): tree has " << tree.NumClasses()
+        << " classes, but the forest has " << numClasses << "!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  roots.push_back(nodes.size());
+  nodes.push_back(Node());
+  FlattenNode(tree, roots.back(), leafValues);
+}
+
+template<typename TreeType>
+void FlatForest::FlattenNode(const TreeType& node,
+                             const size_t index,
+                             std::vector<double>& leafValues)
+{
+  // Only indices are used, since appending nodes can move them.
+  nodes[index].categorical = false;
+  nodes[index].threshold = 0.0;
+  if (node.NumChildren() == 0)
+  {
+    nodes[index].dimension = leafValues.size() / numClasses;
+    nodes[index].firstChild = 0;
+    leafValues.insert(leafValues.end(), node.ClassProbabilities().begin(),
+        node.ClassProbabilities().end());
+    return;
+  }
+
+  nodes[index].dimension = node.SplitDimension();
+  if (node.SplitDimensionType() == data::Datatype::categorical)
+  {
+    nodes[index].categorical = true;
+  }
+  else if (node.NumChildren() == 2)
+  {
+    nodes[index].threshold = node.ClassProbabilities()[0];
+  }
+  else
+  {
+    throw std::invalid_argument("FlatForest::FlattenNode(): only numeric "
+        "splits with two children are supported!");
+  }
+
+  const size_t firstChild = nodes.size();
+  nodes[index].firstChild = firstChild;
+  nodes.resize(firstChild + node.NumChildren());
+  for (size_t i = 0; i < node.NumChildren(); ++i)
+    FlattenNode(node.Child(i), firstChild + i, leafValues);
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
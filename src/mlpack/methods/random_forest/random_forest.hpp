@@ -160,6 +160,12 @@ class RandomForest
    * you may specify a DimensionSelectionType to set parameters for the strategy
    * used to choose dimensions.
    *
+   * If warmStart is true, the trees already in the forest are kept, and only
+   * numTrees new trees are trained and added to them; this can be used to
+   * update a large forest with new data without retraining all of its trees.
+   * The new trees must have the same number of classes as the existing trees,
+   * or an exception is thrown.
+   *
    * @param data Dataset to train on.
    * @param labels Labels for dataset.
    * @param numClasses Number of classes in dataset.
@@ -168,7 +174,9 @@ class RandomForest
    * @param minimumGainSplit Minimum gain for splitting a decision tree node.
    * @param maximumDepth Maximum depth for the tree.
    * @param dimensionSelector Instantiated dimension selection policy.
-   * @return The average entropy of all the decision trees trained under forest.
+   * @param warmStart If true, the new trees are added to the trees already in
+   *     the forest, which are kept as they are; otherwise, they replace them.
+   * @return The average entropy of the decision trees trained by this call.
    */
   template<typename MatType>
   double Train(const MatType& data,
@@ -179,7 +187,8 @@ class RandomForest
                const double minimumGainSplit = 1e-7,
                const size_t maximumDepth = 0,
                DimensionSelectionType dimensionSelector =
-                   DimensionSelectionType());
+                   DimensionSelectionType(),
+               const bool warmStart = false);
 
   /**
    * Train the random forest on the given labeled training data with the given
@@ -199,7 +208,9 @@ class RandomForest
    * @param minimumGainSplit Minimum gain for splitting a decision tree node.
    * @param maximumDepth Maximum depth for the tree.
    * @param dimensionSelector Instantiated dimension selection policy.
-   * @return The average entropy of all the decision trees trained under forest.
+   * @param warmStart If true, the new trees are added to the trees already in
+   *     the forest, which are kept as they are; otherwise, they replace them.
+   * @return The average entropy of the decision trees trained by this call.
    */
   template<typename MatType>
   double Train(const MatType& data,
@@ -211,7 +222,8 @@ class RandomForest
                const double minimumGainSplit = 1e-7,
                const size_t maximumDepth = 0,
                DimensionSelectionType dimensionSelector =
-                   DimensionSelectionType());
+                   DimensionSelectionType(),
+               const bool warmStart = false);
 
   /**
    * Train the random forest on the given weighted labeled training data with
@@ -229,7 +241,9 @@ class RandomForest
    * @param minimumGainSplit Minimum gain for splitting a decision tree node.
    * @param maximumDepth Maximum depth for the tree.
    * @param dimensionSelector Instantiated dimension selection policy.
-   * @return The average entropy of all the decision trees trained under forest.
+   * @param warmStart If true, the new trees are added to the trees already in
+   *     the forest, which are kept as they are; otherwise, they replace them.
+   * @return The average entropy of the decision trees trained by this call.
    */
   template<typename MatType>
   double Train(const MatType& data,
@@ -241,7 +255,8 @@ class RandomForest
                const double minimumGainSplit = 1e-7,
                const size_t maximumDepth = 0,
                DimensionSelectionType dimensionSelector =
-                   DimensionSelectionType());
+                   DimensionSelectionType(),
+               const bool warmStart = false);
 
   /**
    * Train the random forest on the given weighted labeled training data with
@@ -261,7 +276,9 @@ class RandomForest
    * @param minimumGainSplit Minimum gain for splitting a decision tree node.
    * @param maximumDepth Maximum depth for the tree.
    * @param dimensionSelector Instantiated dimension selection policy.
-   * @return The average entropy of all the decision trees trained under forest.
+   * @param warmStart If true, the new trees are added to the trees already in
+   *     the forest, which are kept as they are; otherwise, they replace them.
+   * @return The average entropy of the decision trees trained by this call.
    */
   template<typename MatType>
   double Train(const MatType& data,
@@ -274,7 +291,8 @@ class RandomForest
                const double minimumGainSplit = 1e-7,
                const size_t maximumDepth = 0,
                DimensionSelectionType dimensionSelector =
-                   DimensionSelectionType());
+                   DimensionSelectionType(),
+               const bool warmStart = false);
 
   /**
    * Predict the class of the given point.  If the random forest has not been
@@ -315,6 +333,11 @@ class RandomForest
    * predicted class probabilities for each point.  If the random forest has not
    * been trained, this will throw an exception.
    *
+   * The points are processed in blocks, in parallel when OpenMP is available:
+   * all the points of a block go down each tree before the next tree, and the
+   * class probabilities of the leaves are summed directly into the output
+   * matrix, with no temporary vector per point or per tree.
+   *
    * @param data Dataset to be classified.
    * @param predictions Output predictions for each point in the dataset.
    * @param probabilities Output matrix of class probabilities for each point.
@@ -324,6 +347,28 @@ class RandomForest
                 arma::Row<size_t>& predictions,
                 arma::mat& probabilities) const;
 
+  /**
+   * Add the trees of the given random forest to this one.  This can be used to
+   * train a large forest in pieces (for instance, each piece on a different
+   * machine, with a different random seed) and then combine the pieces; since
+   * the predictions of the forest average those of its trees, the merged forest
+   * is the same as one trained with all the trees at once.  Both forests must
+   * have been trained for the same number of classes, or an exception is
+   * thrown.
+   *
+   * @param other Random forest whose trees will be added to this one.
+   */
+  void Merge(const RandomForest& other);
+
+  /**
+   * Add the trees of the given random forest to this one, taking ownership of
+   * them instead of copying them.  The other random forest will have no trees
+   * afterwards.  See Merge(const RandomForest&).
+   *
+   * @param other Random forest whose trees will be moved into this one.
+   */
+  void Merge(RandomForest&& other);
+
   //! Access a tree in the forest.
   const DecisionTreeType& Tree(const size_t i) const { return trees[i]; }
   //! Modify a tree in the forest (be careful!).
@@ -354,10 +399,11 @@ class RandomForest
    * @param minimumGainSplit Minimum gain for splitting a decision tree node.
    * @param maximumDepth Maximum depth for the tree.
    * @param dimensionSelector Instantiated dimension selection policy.
+   * @param warmStart Whether to add the new trees to the existing trees.
    * @tparam UseWeights Whether or not to use the weights parameter.
    * @tparam UseDatasetInfo Whether or not to use the datasetInfo parameter.
    * @tparam MatType The type of data matrix (i.e. arma::mat).
-   * @return The average entropy of all the decision trees trained under forest.
+   * @return The average entropy of the decision trees trained by this call.
    */
   template<bool UseWeights, bool UseDatasetInfo, typename MatType>
   double Train(const MatType& data,
@@ -369,7 +415,18 @@ class RandomForest
                const size_t minimumLeafSize,
                const double minimumGainSplit,
                const size_t maximumDepth,
-               DimensionSelectionType& dimensionSelector);
+               DimensionSelectionType& dimensionSelector,
+               const bool warmStart);
+
+  /**
+   * Find the leaf of the given tree that the given point falls in.
+   *
+   * @param tree Tree to descend.
+   * @param point Point to find the leaf of.
+   */
+  template<typename VecType>
+  static const DecisionTreeType& Leaf(const DecisionTreeType& tree,
+                                      const VecType& point);
 
   //! The trees in the forest.
   std::vector<DecisionTreeType> trees;
@@ -45,7 +45,8 @@ RandomForest<
   data::DatasetInfo info; // Ignored.
   arma::rowvec weights; // Fake weights, not used.
   Train<false, false>(dataset, info, labels, numClasses, weights, numTrees,
-      minimumLeafSize, minimumGainSplit, maximumDepth, dimensionSelector);
+      minimumLeafSize, minimumGainSplit, maximumDepth, dimensionSelector,
+      false);
 }
 
 template<
@@ -76,7 +77,7 @@ RandomForest<
   arma::rowvec weights; // Fake weights, not used.
   Train<false, true>(dataset, datasetInfo, labels, numClasses, weights,
       numTrees, minimumLeafSize, minimumGainSplit, maximumDepth,
-      dimensionSelector);
+      dimensionSelector, false);
 }
 
 template<
@@ -106,7 +107,8 @@ RandomForest<
   // Pass off work to the Train() method.
   data::DatasetInfo info; // Ignored by Train().
   Train<true, false>(dataset, info, labels, numClasses, weights, numTrees,
-      minimumLeafSize, minimumGainSplit, maximumDepth, dimensionSelector);
+      minimumLeafSize, minimumGainSplit, maximumDepth, dimensionSelector,
+      false);
 }
 
 template<
@@ -136,7 +138,8 @@ RandomForest<
 {
   // Pass off work to the Train() method.
   Train<true, true>(dataset, datasetInfo, labels, numClasses, weights, numTrees,
-      minimumLeafSize, minimumGainSplit, maximumDepth, dimensionSelector);
+      minimumLeafSize, minimumGainSplit, maximumDepth, dimensionSelector,
+      false);
 }
 
 template<
@@ -160,14 +163,15 @@ double RandomForest<
          const size_t minimumLeafSize,
          const double minimumGainSplit,
          const size_t maximumDepth,
-         DimensionSelectionType dimensionSelector)
+         DimensionSelectionType dimensionSelector,
+         const bool warmStart)
 {
   // Pass off to Train().
   data::DatasetInfo info; // Ignored by Train().
   arma::rowvec weights; // Ignored by Train().
   return Train<false, false>(dataset, info, labels, numClasses, weights,
       numTrees, minimumLeafSize, minimumGainSplit, maximumDepth,
-      dimensionSelector);
+      dimensionSelector, warmStart);
 }
 
 template<
@@ -192,13 +196,14 @@ double RandomForest<
          const size_t minimumLeafSize,
          const double minimumGainSplit,
          const size_t maximumDepth,
-         DimensionSelectionType dimensionSelector)
+         DimensionSelectionType dimensionSelector,
+         const bool warmStart)
 {
   // Pass off to Train().
   arma::rowvec weights; // Ignored by Train().
   return Train<false, true>(dataset, datasetInfo, labels, numClasses, weights,
       numTrees, minimumLeafSize, minimumGainSplit, maximumDepth,
-      dimensionSelector);
+      dimensionSelector, warmStart);
 }
 
 template<
@@ -223,13 +228,14 @@ double RandomForest<
          const size_t minimumLeafSize,
          const double minimumGainSplit,
          const size_t maximumDepth,
-         DimensionSelectionType dimensionSelector)
+         DimensionSelectionType dimensionSelector,
+         const bool warmStart)
 {
   // Pass off to Train().
   data::DatasetInfo info; // Ignored by Train().
   return Train<false, false>(dataset, info, labels, numClasses, weights,
       numTrees, minimumLeafSize, minimumGainSplit, maximumDepth,
-      dimensionSelector);
+      dimensionSelector, warmStart);
 }
 
 template<
@@ -255,12 +261,13 @@ double RandomForest<
          const size_t minimumLeafSize,
          const double minimumGainSplit,
          const size_t maximumDepth,
-         DimensionSelectionType dimensionSelector)
+         DimensionSelectionType dimensionSelector,
+         const bool warmStart)
 {
   // Pass off to Train().
   return Train<true, true>(dataset, datasetInfo, labels, numClasses, weights,
       numTrees, minimumLeafSize, minimumGainSplit, maximumDepth,
-      dimensionSelector);
+      dimensionSelector, warmStart);
 }
 
 template<
@@ -315,15 +322,10 @@ void RandomForest<
         "trained!");
   }
 
+  // Sum the class probabilities of the leaves directly.
   probabilities.zeros(trees[0].NumClasses());
   for (size_t i = 0; i < trees.size(); ++i)
-  {
-    arma::vec treeProbs;
-    size_t treePrediction; // Ignored.
-    trees[i].Classify(point, treePrediction, treeProbs);
-
-    probabilities += treeProbs;
-  }
+    probabilities += Leaf(trees[i], point).ClassProbabilities();
 
   // Find maximum element after renormalizing probabilities.
   probabilities /= trees.size();
@@ -362,7 +364,9 @@ void RandomForest<
 
   predictions.set_size(data.n_cols);
 
-  #pragma omp parallel for
+  // With a static schedule each thread reads the same block of columns that
+  // math::FirstTouch() placed on its NUMA node.
+  #pragma omp parallel for schedule(static)
   for (omp_size_t i = 0; i < data.n_cols; ++i)
   {
     predictions[i] = Classify(data.col(i));
@@ -397,14 +401,94 @@ void RandomForest<
         "trained!");
   }
 
-  probabilities.set_size(trees[0].NumClasses(), data.n_cols);
+  probabilities.zeros(trees[0].NumClasses(), data.n_cols);
   predictions.set_size(data.n_cols);
-  #pragma omp parallel for
-  for (omp_size_t i = 0; i < data.n_cols; ++i)
+
+  // Each block of points goes down a tree before the next tree, so that the
+  // top nodes of the tree stay in cache.  The blocks are contiguous, so with a
+  // static schedule each thread still reads the columns that
+  // math::FirstTouch() placed on its NUMA node.
+  const size_t blockSize = 64;
+  const size_t numBlocks = (data.n_cols + blockSize - 1) / blockSize;
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const size_t begin = b * blockSize;
+    const size_t end = std::min(begin + blockSize, (size_t) data.n_cols);
+    for (size_t t = 0; t < trees.size(); ++t)
+    {
+      for (size_t i = begin; i < end; ++i)
+      {
+        probabilities.col(i) +=
+            Leaf(trees[t], data.col(i)).ClassProbabilities();
+      }
+    }
+
+    for (size_t i = begin; i < end; ++i)
+    {
+      probabilities.col(i) /= trees.size();
+      predictions[i] = (size_t) arma::index_max(probabilities.col(i));
+    }
+  }
+}
+
+template<
+    typename FitnessFunction,
+    typename DimensionSelectionType,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType,
+    typename ElemType
+>
+void RandomForest<
+    FitnessFunction,
+    DimensionSelectionType,
+    NumericSplitType,
+    CategoricalSplitType,
+    ElemType
+>::Merge(const RandomForest& other)
+{
+  if (!trees.empty() && !other.trees.empty() &&
+      trees[0].NumClasses() != other.trees[0].NumClasses())
+  {
+    std::ostringstream oss;
+    oss << "RandomForest::Merge(): cannot merge a forest with "
+        << other.trees[0].NumClasses() << " classes into a forest with "
+        << trees[0].NumClasses() << " classes!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  trees.insert(trees.end(), other.trees.begin(), other.trees.end());
+}
+
+template<
+    typename FitnessFunction,
+    typename DimensionSelectionType,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType,
+    typename ElemType
+>
+void RandomForest<
+    FitnessFunction,
+    DimensionSelectionType,
+    NumericSplitType,
+    CategoricalSplitType,
+    ElemType
+>::Merge(RandomForest&& other)
+{
+  if (!trees.empty() && !other.trees.empty() &&
+      trees[0].NumClasses() != other.trees[0].NumClasses())
   {
-    arma::vec probs = probabilities.unsafe_col(i);
-    Classify(data.col(i), predictions[i], probs);
+    std::ostringstream oss;
+    oss << "RandomForest::Merge(): cannot merge a forest with "
+        << other.trees[0].NumClasses() << " classes into a forest with "
+        << trees[0].NumClasses() << " classes!";
+    throw std::invalid_argument(oss.str());
   }
+
+  trees.reserve(trees.size() + other.trees.size());
+  for (size_t i = 0; i < other.trees.size(); ++i)
+    trees.push_back(std::move(other.trees[i]));
+  other.trees.clear();
 }
 
 template<
@@ -461,21 +545,39 @@ double RandomForest<
          const size_t minimumLeafSize,
          const double minimumGainSplit,
          const size_t maximumDepth,
-         DimensionSelectionType& dimensionSelector)
+         DimensionSelectionType& dimensionSelector,
+         const bool warmStart)
 {
+  // With a warm start, the existing trees are kept and the new trees are
+  // trained after them.
+  const size_t oldNumTrees = warmStart ? trees.size() : 0;
+  if (oldNumTrees > 0 && trees[0].NumClasses() != numClasses)
+  {
+    std::ostringstream oss;
+    oss << "RandomForest::Train(): cannot add trees with " << numClasses
+        << " classes to a forest with " << trees[0].NumClasses()
+        << " classes!";
+    throw std::invalid_argument(oss.str());
+  }
+
   // Train each tree individually.
-  trees.resize(numTrees); // This will fill the vector with untrained trees.
+  trees.resize(oldNumTrees + numTrees); // New trees are untrained.
   double avgGain = 0.0;
 
   #pragma omp parallel for reduction( + : avgGain)
-  for (omp_size_t i = 0; i < numTrees; ++i)
+  for (omp_size_t t = 0; t < numTrees; ++t)
   {
+    const size_t i = oldNumTrees + t;
+
+    // The tree is trained on the indices of the points of the bootstrap
+    // sample, so that the dataset is not copied for each tree.
     Timer::Start("bootstrap");
-    MatType bootstrapDataset;
+    arma::uvec indices;
     arma::Row<size_t> bootstrapLabels;
     arma::rowvec bootstrapWeights;
-    Bootstrap<UseWeights>(dataset, labels, weights, bootstrapDataset,
+    BootstrapIndices<UseWeights>(dataset, labels, weights, indices,
         bootstrapLabels, bootstrapWeights);
+    IndexedMatrix<MatType> bootstrapDataset(dataset, std::move(indices));
     Timer::Stop("bootstrap");
 
     // Now build the decision tree.
@@ -514,6 +616,35 @@ double RandomForest<
   return avgGain / numTrees;
 }
 
+template<
+    typename FitnessFunction,
+    typename DimensionSelectionType,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType,
+    typename ElemType
+>
+template<typename VecType>
+const typename RandomForest<
+    FitnessFunction,
+    DimensionSelectionType,
+    NumericSplitType,
+    CategoricalSplitType,
+    ElemType
+>::DecisionTreeType& RandomForest<
+    FitnessFunction,
+    DimensionSelectionType,
+    NumericSplitType,
+    CategoricalSplitType,
+    ElemType
+>::Leaf(const DecisionTreeType& tree, const VecType& point)
+{
+  const DecisionTreeType* node = &tree;
+  while (node->NumChildren() > 0)
+    node = &node->Child(node->CalculateDirection(point));
+
+  return *node;
+}
+
 } // namespace tree
 } // namespace mlpack
 
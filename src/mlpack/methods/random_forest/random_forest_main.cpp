@@ -66,6 +66,22 @@ PROGRAM_INFO("Random forests",
     "output parameter.  Class probabilities for each prediction may be saved "
     "with the " + PRINT_PARAM_STRING("probabilities") + " output parameter."
     "\n\n"
+    "The trees of a random forest are independent, so a large forest can be "
+    "trained in pieces, for instance on several machines, each with a "
+    "different " + PRINT_PARAM_STRING("seed") + ".  The trees of the forest "
+    "given with the " + PRINT_PARAM_STRING("merge_model") + " parameter are "
+    "added to those of the trained or loaded forest, so that the pieces can be "
+    "combined into one forest, which gives the same predictions as a forest "
+    "trained with all of the trees at once.  Both forests must have been "
+    "trained for the same number of classes."
+    "\n\n"
+    "If " + PRINT_PARAM_STRING("warm_start") + " is specified along with both "
+    + PRINT_PARAM_STRING("training") + " and " +
+    PRINT_PARAM_STRING("input_model") + ", then " +
+    PRINT_PARAM_STRING("num_trees") + " new trees are trained on the given "
+    "data and added to the trees of the input model, which are not retrained; "
+    "this can be used to update a large forest with new data."
+    "\n\n"
     "For example, to train a random forest with a minimum leaf size of 20 "
     "using 10 trees on the dataset contained in " + PRINT_DATASET("data") +
     "with labels " + PRINT_DATASET("labels") + ", saving the output random "
@@ -83,7 +99,15 @@ PROGRAM_INFO("Random forests",
     "could call "
     "\n\n" +
     PRINT_CALL("random_forest", "input_model", "rf_model", "test", "test_set",
-        "test_labels", "test_labels", "predictions", "predictions"),
+        "test_labels", "test_labels", "predictions", "predictions") +
+    "\n\n"
+    "To combine a forest " + PRINT_MODEL("rf_model_2") + ", trained on "
+    "another machine with a different seed, with " + PRINT_MODEL("rf_model") +
+    " and save the merged forest to " + PRINT_MODEL("rf_merged") + ", one "
+    "could call"
+    "\n\n" +
+    PRINT_CALL("random_forest", "input_model", "rf_model", "merge_model",
+        "rf_model_2", "output_model", "rf_merged"),
     SEE_ALSO("@decision_tree", "#decision_tree"),
     SEE_ALSO("@hoeffding_tree", "#hoeffding_tree"),
     SEE_ALSO("@softmax_regression", "#softmax_regression"),
@@ -97,6 +121,8 @@ PROGRAM_INFO("Random forests",
 PARAM_MATRIX_IN("training", "Training dataset.", "t");
 PARAM_UROW_IN("labels", "Labels for training dataset.", "l");
 PARAM_MATRIX_IN("test", "Test dataset to produce predictions for.", "T");
+// Each test point is classified on its own, so the test set can be streamed.
+BINDING_STREAMING_INPUT("test");
 PARAM_UROW_IN("test_labels", "Test dataset labels, if accuracy calculation is "
     "desired.", "L");
 
@@ -121,6 +147,8 @@ PARAM_INT_IN("subspace_dim", "Dimensionality of random subspace to use for "
     "d", 0);
 
 PARAM_INT_IN("seed", "Random seed.  If 0, 'std::time(NULL)' is used.", "s", 0);
+PARAM_FLAG("warm_start", "If true and passed along with training and "
+    "input_model, then train more trees and add them to the input model.", "w");
 
 /**
  * This is the class that we will serialize.  It is a pretty simple wrapper
@@ -146,6 +174,8 @@ class RandomForestModel
 
 PARAM_MODEL_IN(RandomForestModel, "input_model", "Pre-trained random forest to "
     "use for classification.", "m");
+PARAM_MODEL_IN(RandomForestModel, "merge_model", "Random forest whose trees "
+    "will be added to the trained or loaded random forest.", "r");
 PARAM_MODEL_OUT(RandomForestModel, "output_model", "Model to save trained "
     "random forest to.", "M");
 
@@ -158,7 +188,18 @@ static void mlpackMain()
     math::RandomSeed((size_t) std::time(NULL));
 
   // Check for incompatible input parameters.
-  RequireOnlyOnePassed({ "training", "input_model" }, true);
+  const bool warmStart = CLI::HasParam("warm_start");
+  if (warmStart)
+  {
+    RequireAtLeastOnePassed({ "training" }, true, "must pass training data "
+        "when warm_start is given");
+    RequireAtLeastOnePassed({ "input_model" }, true, "must pass an input "
+        "model when warm_start is given");
+  }
+  else
+  {
+    RequireOnlyOnePassed({ "training", "input_model" }, true);
+  }
 
   ReportIgnoredParam({{ "training", false }}, "print_training_accuracy");
   ReportIgnoredParam({{ "test", false }}, "test_labels");
@@ -195,7 +236,11 @@ static void mlpackMain()
   if (CLI::HasParam("training"))
   {
     Timer::Start("rf_training");
-    rfModel = new RandomForestModel();
+
+    // Don't modify the input model when adding trees to it.
+    rfModel = warmStart ? new RandomForestModel(
+        *CLI::GetParam<RandomForestModel*>("input_model")) :
+        new RandomForestModel();
 
     // Train the model on the given input data.
     arma::mat data = std::move(CLI::GetParam<arma::mat>("training"));
@@ -220,11 +265,23 @@ static void mlpackMain()
     Log::Info << "Training random forest with " << numTrees << " trees..."
         << endl;
 
-    const size_t numClasses = arma::max(labels) + 1;
+    // New trees must have as many classes as the trees of the input model.
+    size_t numClasses = arma::max(labels) + 1;
+    if (warmStart && rfModel->rf.NumTrees() > 0)
+      numClasses = std::max(numClasses, rfModel->rf.Tree(0).NumClasses());
 
     // Train the model.
-    rfModel->rf.Train(data, labels, numClasses, numTrees, minimumLeafSize,
-        minimumGainSplit, maxDepth, mrds);
+    try
+    {
+      rfModel->rf.Train(data, labels, numClasses, numTrees, minimumLeafSize,
+          minimumGainSplit, maxDepth, mrds, warmStart);
+    }
+    catch (std::invalid_argument& e)
+    {
+      // The model is not owned by the CLI yet.
+      delete rfModel;
+      Log::Fatal << e.what() << endl;
+    }
     Timer::Stop("rf_training");
 
     // Did we want training accuracy?
@@ -248,9 +305,37 @@ static void mlpackMain()
     rfModel = CLI::GetParam<RandomForestModel*>("input_model");
   }
 
+  if (CLI::HasParam("merge_model"))
+  {
+    RandomForestModel* mergeModel =
+        CLI::GetParam<RandomForestModel*>("merge_model");
+
+    // Don't modify the input model; the merged forest is a new model.
+    if (!CLI::HasParam("training"))
+      rfModel = new RandomForestModel(*rfModel);
+
+    Log::Info << "Merging " << mergeModel->rf.NumTrees() << " trees into the "
+        << "random forest with " << rfModel->rf.NumTrees() << " trees..."
+        << endl;
+
+    Timer::Start("rf_merge");
+    try
+    {
+      rfModel->rf.Merge(mergeModel->rf);
+    }
+    catch (std::invalid_argument& e)
+    {
+      // The model is not owned by the CLI yet.
+      delete rfModel;
+      Log::Fatal << e.what() << endl;
+    }
+    Timer::Stop("rf_merge");
+  }
+
   if (CLI::HasParam("test"))
   {
     arma::mat testData = std::move(CLI::GetParam<arma::mat>("test"));
+    math::FirstTouch(testData);
     Timer::Start("rf_prediction");
 
     // Get predictions and probabilities.
@@ -72,5 +72,29 @@ void RandomizedSVD::Apply(const arma::mat& data,
   Apply(data, u, s, v, rank, rowMean);
 }
 
+void RandomizedSVD::Apply(const arma::sp_fmat& data,
+                          arma::fmat& u,
+                          arma::fvec& s,
+                          arma::fmat& v,
+                          const size_t rank)
+{
+  // Center the data into a temporary matrix for sparse matrix.
+  arma::sp_fmat rowMean = arma::sum(data, 1) / data.n_cols;
+
+  Apply(data, u, s, v, rank, rowMean);
+}
+
+void RandomizedSVD::Apply(const arma::fmat& data,
+                          arma::fmat& u,
+                          arma::fvec& s,
+                          arma::fmat& v,
+                          const size_t rank)
+{
+  // Center the data into a temporary matrix.
+  arma::fmat rowMean = arma::sum(data, 1) / data.n_cols + eps;
+
+  Apply(data, u, s, v, rank, rowMean);
+}
+
 } // namespace svd
 } // namespace mlpack
@@ -14,6 +14,7 @@
 #define MLPACK_METHODS_RANDOMIZED_SVD_RANDOMIZED_SVD_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/product.hpp>
 
 namespace mlpack {
 namespace svd {
@@ -62,6 +63,11 @@ namespace svd {
  * // Use the Apply() method to get a factorization.
  * rSVD.Apply(data, u, s, v, rank);
  * @endcode
+ *
+ * Dense and sparse matrices of single or double precision are supported
+ * (arma::mat, arma::fmat, arma::sp_mat and arma::sp_fmat).  The products of
+ * sparse matrices with dense matrices are computed in parallel when OpenMP is
+ * available.
  */
 class RandomizedSVD
 {
@@ -136,6 +142,38 @@ class RandomizedSVD
              arma::mat& v,
              const size_t rank);
 
+  /**
+   * Center the data to apply Principal Component Analysis on given sparse
+   * single-precision matrix dataset using randomized SVD.
+   *
+   * @param data Sparse data matrix.
+   * @param u First unitary matrix.
+   * @param v Second unitary matrix.
+   * @param s Diagonal "Sigma" matrix of singular values.
+   * @param rank Rank of the approximation.
+   */
+  void Apply(const arma::sp_fmat& data,
+             arma::fmat& u,
+             arma::fvec& s,
+             arma::fmat& v,
+             const size_t rank);
+
+  /**
+   * Center the data to apply Principal Component Analysis on given
+   * single-precision matrix dataset using randomized SVD.
+   *
+   * @param data Data matrix.
+   * @param u First unitary matrix.
+   * @param v Second unitary matrix.
+   * @param s Diagonal "Sigma" matrix of singular values.
+   * @param rank Rank of the approximation.
+   */
+  void Apply(const arma::fmat& data,
+             arma::fmat& u,
+             arma::fvec& s,
+             arma::fmat& v,
+             const size_t rank);
+
   /**
    * Apply Principal Component Analysis to the provided matrix data set
    * using the randomized SVD.
@@ -149,28 +187,33 @@ class RandomizedSVD
    */
   template<typename MatType>
   void Apply(const MatType& data,
-             arma::mat& u,
-             arma::vec& s,
-             arma::mat& v,
+             arma::Mat<typename MatType::elem_type>& u,
+             arma::Col<typename MatType::elem_type>& s,
+             arma::Mat<typename MatType::elem_type>& v,
              const size_t rank,
              MatType rowMean)
   {
+    typedef arma::Mat<typename MatType::elem_type> DenseMatType;
+
     if (iteratedPower == 0)
       iteratedPower = rank + 2;
 
-    arma::mat R, Q, Qdata;
+    // The mean is dense, even if the data is sparse.  The centered data is
+    // never formed; the mean is subtracted from each product instead.
+    const DenseMatType mean(rowMean);
+    DenseMatType R, Q, Qdata;
 
     // Apply the centered data matrix to a random matrix, obtaining Q.
     if (data.n_cols >= data.n_rows)
     {
-      R = arma::randn<arma::mat>(data.n_rows, iteratedPower);
-      Q = (data.t() * R) - arma::repmat(arma::trans(R.t() * rowMean),
-          data.n_cols, 1);
+      R = arma::randn<DenseMatType>(data.n_rows, iteratedPower);
+      Q = math::TransProduct(data, R) - arma::repmat(arma::trans(R.t() *
+          mean), data.n_cols, 1);
     }
     else
     {
-      R = arma::randn<arma::mat>(data.n_cols, iteratedPower);
-      Q = (data * R) - (rowMean * (arma::ones(1, data.n_cols) * R));
+      R = arma::randn<DenseMatType>(data.n_cols, iteratedPower);
+      Q = math::Product(data, R) - (mean * arma::sum(R, 0));
     }
 
     // Form a matrix Q whose columns constitute a
@@ -189,15 +232,17 @@ class RandomizedSVD
     {
       if (data.n_cols >= data.n_rows)
       {
-        Q = (data * Q) - rowMean * (arma::ones(1, data.n_cols) * Q);
+        Q = math::Product(data, Q) - mean * arma::sum(Q, 0);
         arma::lu(Q, v, Q);
-        Q = (data.t() * Q) - arma::repmat(rowMean.t() * Q, data.n_cols, 1);
+        Q = math::TransProduct(data, Q) - arma::repmat(mean.t() * Q,
+            data.n_cols, 1);
       }
       else
       {
-        Q = (data.t() * Q) - arma::repmat(rowMean.t() * Q, data.n_cols, 1);
+        Q = math::TransProduct(data, Q) - arma::repmat(mean.t() * Q,
+            data.n_cols, 1);
         arma::lu(Q, v, Q);
-        Q = (data * Q) - (rowMean * (arma::ones(1, data.n_cols) * Q));
+        Q = math::Product(data, Q) - mean * arma::sum(Q, 0);
       }
 
       // Computing the LU decomposition is more efficient than computing the QR
@@ -219,13 +264,14 @@ class RandomizedSVD
     // applied to Q.
     if (data.n_cols >= data.n_rows)
     {
-      Qdata = (data * Q) - rowMean * (arma::ones(1, data.n_cols) * Q);
+      Qdata = math::Product(data, Q) - mean * arma::sum(Q, 0);
       arma::svd_econ(u, s, v, Qdata);
       v = Q * v;
     }
     else
     {
-      Qdata = (Q.t() * data) - arma::repmat(Q.t() * rowMean, 1,  data.n_cols);
+      Qdata = arma::trans(math::TransProduct(data, Q)) - arma::repmat(Q.t() *
+          mean, 1, data.n_cols);
       arma::svd_econ(u, s, v, Qdata);
       u = Q * u;
     }
@@ -16,12 +16,15 @@
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/metrics/lmetric.hpp>
 #include <mlpack/core/tree/binary_space_tree.hpp>
+#include <mlpack/core/tree/traversal_statistics.hpp>
 #include "range_search_stat.hpp"
+#include "range_search_rules.hpp"
 
 namespace mlpack {
 namespace range /** Range-search routines. */ {
 
 //! Forward declaration.
+template<typename MatType>
 class TrainVisitor;
 
 /**
@@ -259,6 +262,111 @@ class RangeSearch
               std::vector<std::vector<size_t>>& neighbors,
               std::vector<std::vector<double>>& distances);
 
+  /**
+   * Search for all reference points in the given range for each point in the
+   * query set, returning the results in compressed sparse row (CSR) format.
+   * The results are collected in a few flat buffers (one for each thread in
+   * single-tree and naive mode, where the query points are searched in
+   * parallel with OpenMP), instead of one vector for each query point, so this
+   * is much faster than the other overloads when there are many results.
+   *
+   * That is:
+   *
+   * - offsets.n_elem is the number of query points plus one.
+   *
+   * - neighbors[offsets[i]] to neighbors[offsets[i + 1] - 1] are the indices of
+   *   all the points in the reference set which have distances inside the given
+   *   range to query point i.
+   *
+   * - distances[j] is the distance corresponding to the index neighbors[j].
+   *
+   * - The neighbors of each query point are not sorted in any particular
+   *   order.
+   *
+   * @param querySet Set of query points to search with.
+   * @param range Range of distances in which to search.
+   * @param offsets Will hold the offset of the results of each query point.
+   * @param neighbors Will hold the indices of the results.
+   * @param distances Will hold the distances of the results.
+   */
+  void Search(const MatType& querySet,
+              const math::Range& range,
+              arma::Col<size_t>& offsets,
+              arma::Col<size_t>& neighbors,
+              arma::vec& distances);
+
+  /**
+   * Given a pre-built query tree, search for all reference points in the given
+   * range for each point in the query set, returning the results in compressed
+   * sparse row (CSR) format; see the overload of Search() that takes a query
+   * set for the format.  As with the other overload of Search() that takes a
+   * query tree, this will throw an invalid_argument exception if either naive
+   * or singleMode are set to true, and the query indices are the indices of the
+   * points in the query tree's dataset.
+   *
+   * @param queryTree Tree built on query points.
+   * @param range Range of distances in which to search.
+   * @param offsets Will hold the offset of the results of each query point.
+   * @param neighbors Will hold the indices of the results.
+   * @param distances Will hold the distances of the results.
+   */
+  void Search(Tree* queryTree,
+              const math::Range& range,
+              arma::Col<size_t>& offsets,
+              arma::Col<size_t>& neighbors,
+              arma::vec& distances);
+
+  /**
+   * Search for all points in the given range for each point in the reference
+   * set (which was passed to the constructor), returning the results in
+   * compressed sparse row (CSR) format; see the overload of Search() that takes
+   * a query set for the format.  A point is not returned in its own results.
+   *
+   * @param range Range of distances in which to search.
+   * @param offsets Will hold the offset of the results of each point.
+   * @param neighbors Will hold the indices of the results.
+   * @param distances Will hold the distances of the results.
+   */
+  void Search(const math::Range& range,
+              arma::Col<size_t>& offsets,
+              arma::Col<size_t>& neighbors,
+              arma::vec& distances);
+
+  /**
+   * Count the reference points in the given range of each point in the query
+   * set, without storing them.  This is much faster than Search() when the
+   * ranges hold many points, because whole nodes of the reference tree that
+   * are in the range are counted without visiting their points.  If maxCount
+   * is given, the search stops for each query point once maxCount points are
+   * found, and the count is then maxCount; this is enough to check whether
+   * there are at least maxCount points in the range.
+   *
+   * @param querySet Set of query points to search with.
+   * @param range Range of distances in which to search.
+   * @param counts Will hold the number of reference points in the range of
+   *      each query point.
+   * @param maxCount Maximum count of each query point.
+   */
+  void Count(const MatType& querySet,
+             const math::Range& range,
+             arma::Col<size_t>& counts,
+             const size_t maxCount = SIZE_MAX);
+
+  /**
+   * Count the points in the given range of each point in the reference set
+   * (which was passed to the constructor), without storing them.  As with the
+   * monochromatic Search(), a point is not counted in its own range.  If
+   * maxCount is given, the search stops for each point once maxCount points
+   * are found, and the count is then maxCount.
+   *
+   * @param range Range of distances in which to search.
+   * @param counts Will hold the number of points in the range of each point.
+   * @param maxCount Maximum count of each point.
+   */
+  void Count(const math::Range& range,
+             arma::Col<size_t>& counts,
+             const size_t maxCount = SIZE_MAX);
+
   //! Get whether single-tree search is being used.
   bool SingleMode() const { return singleMode; }
   //! Modify whether single-tree search is being used.
@@ -273,6 +381,9 @@ class RangeSearch
   size_t BaseCases() const { return baseCases; }
   //! Get the number of scores during the last search.
   size_t Scores() const { return scores; }
+  //! Get the statistics of the tree traversal of the last search.  These are
+  //! empty for naive search.
+  const tree::TraversalStatistics& Statistics() const { return statistics; }
 
   //! Serialize the model.
   template<typename Archive>
@@ -284,6 +395,14 @@ class RangeSearch
   //! Return the reference tree (or NULL if in naive mode).
   Tree* ReferenceTree() { return referenceTree; }
 
+  //! Get the mappings from the points of the reference tree to the original
+  //! reference indices, if the tree was built by this object and rearranges
+  //! the dataset.
+  const std::vector<size_t>& OldFromNewReferences() const
+  {
+    return oldFromNewReferences;
+  }
+
  private:
   //! Mappings to old reference indices (used when this object builds trees).
   std::vector<size_t> oldFromNewReferences;
@@ -308,8 +427,32 @@ class RangeSearch
   size_t baseCases;
   //! The total number of scores during the last search.
   size_t scores;
+  //! The statistics of the tree traversal of the last search.
+  tree::TraversalStatistics statistics;
+
+  /**
+   * Search with one rules object for each thread, each appending its results
+   * to its own buffer.  This is used in naive and single-tree mode.
+   */
+  void ParallelSearch(const MatType& querySet,
+                      const math::Range& range,
+                      const bool sameSet,
+                      std::vector<RangeSearchBuffer>& buffers);
+
+  /**
+   * Gather the results in the given buffers into CSR arrays, mapping the query
+   * and reference indices with the given mappings if they are not NULL.
+   */
+  static void BuildCSR(const std::vector<RangeSearchBuffer>& buffers,
+                       const size_t numQueries,
+                       const std::vector<size_t>* oldFromNewQueries,
+                       const std::vector<size_t>* oldFromNewRefs,
+                       arma::Col<size_t>& offsets,
+                       arma::Col<size_t>& neighbors,
+                       arma::vec& distances);
 
   //! For access to mappings when building models.
+  template<typename MatT>
   friend class TrainVisitor;
 };
 
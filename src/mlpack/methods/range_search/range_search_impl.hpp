@@ -108,7 +108,7 @@ RangeSearch<MetricType, MatType, TreeType>::RangeSearch(
   // Build the tree on the empty dataset, if necessary.
   if (!naive)
   {
-    referenceTree = BuildTree<Tree>(std::move(arma::mat()),
+    referenceTree = BuildTree<Tree>(std::move(MatType()),
         oldFromNewReferences);
     referenceSet = &referenceTree->Dataset();
     treeOwner = true;
@@ -131,7 +131,8 @@ RangeSearch<MetricType, MatType, TreeType>::RangeSearch(
     singleMode(other.singleMode),
     metric(other.metric),
     baseCases(other.baseCases),
-    scores(other.scores)
+    scores(other.scores),
+    statistics(other.statistics)
 {
   // Nothing to do.
 }
@@ -150,17 +151,19 @@ RangeSearch<MetricType, MatType, TreeType>::RangeSearch(RangeSearch&& other) :
     singleMode(other.singleMode),
     metric(std::move(other.metric)),
     baseCases(other.baseCases),
-    scores(other.scores)
+    scores(other.scores),
+    statistics(other.statistics)
 {
   // Clear other object.
   other.referenceTree =
-      BuildTree<Tree>(std::move(arma::mat()), other.oldFromNewReferences);
+      BuildTree<Tree>(std::move(MatType()), other.oldFromNewReferences);
   other.referenceSet = &other.referenceTree->Dataset();
   other.treeOwner = true;
   other.naive = false;
   other.singleMode = false;
   other.baseCases = 0;
   other.scores = 0;
+  other.statistics.Reset();
 }
 
 template<typename MetricType,
@@ -187,6 +190,7 @@ RangeSearch<MetricType, MatType, TreeType>::operator=(RangeSearch other)
   metric = std::move(other.metric);
   baseCases = other.baseCases;
   scores = other.scores;
+  statistics = other.statistics;
 
   return *this;
 }
@@ -327,6 +331,7 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
   // Reset counts.
   baseCases = 0;
   scores = 0;
+  statistics.Reset();
 
   if (naive)
   {
@@ -345,7 +350,10 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
     // Create the traverser.
     RuleType rules(*referenceSet, querySet, range, *neighborPtr, *distancePtr,
         metric);
-    typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
+    statistics.Reset();
+    tree::CountingRules<RuleType> countingRules(rules, statistics);
+    typename Tree::template SingleTreeTraverser<tree::CountingRules<RuleType>>
+        traverser(countingRules);
 
     // Now have it traverse for each point.
     for (size_t i = 0; i < querySet.n_cols; ++i)
@@ -366,7 +374,10 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
     // Create the traverser.
     RuleType rules(*referenceSet, queryTree->Dataset(), range, *neighborPtr,
         *distancePtr, metric);
-    typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
+    statistics.Reset();
+    tree::CountingRules<RuleType> countingRules(rules, statistics);
+    typename Tree::template DualTreeTraverser<tree::CountingRules<RuleType>>
+        traverser(countingRules);
 
     traverser.Traverse(*queryTree, *referenceTree);
 
@@ -378,6 +389,8 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
   }
 
   Timer::Stop("range_search/computing_neighbors");
+  if (!naive)
+    statistics.Print(Log::Info);
 
   // Map points back to original indices, if necessary.
   if (tree::TreeTraits<Tree>::RearrangesDataset)
@@ -489,11 +502,16 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
       distances, metric);
 
   // Create the traverser.
-  typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
+  statistics.Reset();
+  tree::CountingRules<RuleType> countingRules(rules, statistics);
+  typename Tree::template DualTreeTraverser<tree::CountingRules<RuleType>>
+      traverser(countingRules);
 
   traverser.Traverse(*queryTree, *referenceTree);
 
   Timer::Stop("range_search/computing_neighbors");
+  if (!naive)
+    statistics.Print(Log::Info);
 
   baseCases = rules.BaseCases();
   scores = rules.Scores();
@@ -564,11 +582,15 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
 
     baseCases = (referenceSet->n_cols * referenceSet->n_cols);
     scores = 0;
+    statistics.Reset();
   }
   else if (singleMode)
   {
     // Create the traverser.
-    typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
+    statistics.Reset();
+    tree::CountingRules<RuleType> countingRules(rules, statistics);
+    typename Tree::template SingleTreeTraverser<tree::CountingRules<RuleType>>
+        traverser(countingRules);
 
     // Now have it traverse for each point.
     for (size_t i = 0; i < referenceSet->n_cols; ++i)
@@ -580,7 +602,10 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
   else // Dual-tree recursion.
   {
     // Create the traverser.
-    typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
+    statistics.Reset();
+    tree::CountingRules<RuleType> countingRules(rules, statistics);
+    typename Tree::template DualTreeTraverser<tree::CountingRules<RuleType>>
+        traverser(countingRules);
 
     traverser.Traverse(*referenceTree, *referenceTree);
 
@@ -589,6 +614,8 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
   }
 
   Timer::Stop("range_search/computing_neighbors");
+  if (!naive)
+    statistics.Print(Log::Info);
 
   // Do we need to map the reference indices?
   if (treeOwner && tree::TreeTraits<Tree>::RearrangesDataset)
@@ -618,6 +645,502 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
   }
 }
 
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void RangeSearch<MetricType, MatType, TreeType>::Search(
+    const MatType& querySet,
+    const math::Range& range,
+    arma::Col<size_t>& offsets,
+    arma::Col<size_t>& neighbors,
+    arma::vec& distances)
+{
+  if (querySet.n_rows != referenceSet->n_rows)
+  {
+    std::ostringstream oss;
+    oss << "RangeSearch::Search(): dimensionalities of query set ("
+        << querySet.n_rows << ") and reference set (" << referenceSet->n_rows
+        << ") do not match!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // Reference indices only need to be mapped if we built the reference tree
+  // ourselves.
+  const std::vector<size_t>* oldFromNewRefs = (treeOwner &&
+      tree::TreeTraits<Tree>::RearrangesDataset) ? &oldFromNewReferences :
+      NULL;
+
+  std::vector<RangeSearchBuffer> buffers;
+  std::vector<size_t> oldFromNewQueries;
+  if (referenceSet->n_cols == 0)
+  {
+    // If there are no points, there is no search to be done.
+  }
+  else if (naive || singleMode)
+  {
+    ParallelSearch(querySet, range, false, buffers);
+  }
+  else // Dual-tree recursion.
+  {
+    Timer::Start("range_search/tree_building");
+    Tree* queryTree = BuildTree<Tree>(querySet, oldFromNewQueries);
+    Timer::Stop("range_search/tree_building");
+
+    Timer::Start("range_search/computing_neighbors");
+    buffers.resize(1);
+    typedef RangeSearchRules<MetricType, Tree> RuleType;
+    RuleType rules(*referenceSet, queryTree->Dataset(), range, buffers[0],
+        metric);
+    statistics.Reset();
+    tree::CountingRules<RuleType> countingRules(rules, statistics);
+    typename Tree::template DualTreeTraverser<tree::CountingRules<RuleType>>
+        traverser(countingRules);
+
+    traverser.Traverse(*queryTree, *referenceTree);
+
+    baseCases = rules.BaseCases();
+    scores = rules.Scores();
+    Timer::Stop("range_search/computing_neighbors");
+    statistics.Print(Log::Info);
+
+    // Clean up tree memory.
+    delete queryTree;
+  }
+
+  BuildCSR(buffers, querySet.n_cols, oldFromNewQueries.empty() ? NULL :
+      &oldFromNewQueries, oldFromNewRefs, offsets, neighbors, distances);
+}
+
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void RangeSearch<MetricType, MatType, TreeType>::Search(
+    Tree* queryTree,
+    const math::Range& range,
+    arma::Col<size_t>& offsets,
+    arma::Col<size_t>& neighbors,
+    arma::vec& distances)
+{
+  // Make sure we are in dual-tree mode.
+  if (singleMode || naive)
+    throw std::invalid_argument("cannot call RangeSearch::Search() with a "
+        "query tree when naive or singleMode are set to true");
+
+  std::vector<RangeSearchBuffer> buffers(1);
+  if (referenceSet->n_cols > 0)
+  {
+    Timer::Start("range_search/computing_neighbors");
+    typedef RangeSearchRules<MetricType, Tree> RuleType;
+    RuleType rules(*referenceSet, queryTree->Dataset(), range, buffers[0],
+        metric);
+    statistics.Reset();
+    tree::CountingRules<RuleType> countingRules(rules, statistics);
+    typename Tree::template DualTreeTraverser<tree::CountingRules<RuleType>>
+        traverser(countingRules);
+
+    traverser.Traverse(*queryTree, *referenceTree);
+
+    baseCases = rules.BaseCases();
+    scores = rules.Scores();
+    Timer::Stop("range_search/computing_neighbors");
+    statistics.Print(Log::Info);
+  }
+
+  // We won't need to map query indices, but we may need to map reference
+  // indices.
+  BuildCSR(buffers, queryTree->Dataset().n_cols, NULL, (treeOwner &&
+      tree::TreeTraits<Tree>::RearrangesDataset) ? &oldFromNewReferences :
+      NULL, offsets, neighbors, distances);
+}
+
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void RangeSearch<MetricType, MatType, TreeType>::Search(
+    const math::Range& range,
+    arma::Col<size_t>& offsets,
+    arma::Col<size_t>& neighbors,
+    arma::vec& distances)
+{
+  std::vector<RangeSearchBuffer> buffers;
+  if (referenceSet->n_cols == 0)
+  {
+    // If there are no points, there is no search to be done.
+  }
+  else if (naive || singleMode)
+  {
+    ParallelSearch(*referenceSet, range, true, buffers);
+  }
+  else // Dual-tree recursion.
+  {
+    Timer::Start("range_search/computing_neighbors");
+    buffers.resize(1);
+    typedef RangeSearchRules<MetricType, Tree> RuleType;
+    RuleType rules(*referenceSet, *referenceSet, range, buffers[0], metric,
+        true /* don't return the query in the results */);
+    statistics.Reset();
+    tree::CountingRules<RuleType> countingRules(rules, statistics);
+    typename Tree::template DualTreeTraverser<tree::CountingRules<RuleType>>
+        traverser(countingRules);
+
+    traverser.Traverse(*referenceTree, *referenceTree);
+
+    baseCases = rules.BaseCases();
+    scores = rules.Scores();
+    Timer::Stop("range_search/computing_neighbors");
+    statistics.Print(Log::Info);
+  }
+
+  // Both the query and reference indices are mapped if we built the tree.
+  const std::vector<size_t>* oldFromNew = (treeOwner &&
+      tree::TreeTraits<Tree>::RearrangesDataset) ? &oldFromNewReferences :
+      NULL;
+  BuildCSR(buffers, referenceSet->n_cols, oldFromNew, oldFromNew, offsets,
+      neighbors, distances);
+}
+
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void RangeSearch<MetricType, MatType, TreeType>::ParallelSearch(
+    const MatType& querySet,
+    const math::Range& range,
+    const bool sameSet,
+    std::vector<RangeSearchBuffer>& buffers)
+{
+  Timer::Start("range_search/computing_neighbors");
+
+  #ifdef HAS_OPENMP
+  buffers.resize(omp_get_max_threads());
+  #else
+  buffers.resize(1);
+  #endif
+
+  typedef RangeSearchRules<MetricType, Tree> RuleType;
+  statistics.Reset();
+  size_t totalBaseCases = 0;
+  size_t totalScores = 0;
+
+  // When the first point of a node is its centroid, Score() caches the last
+  // distance in the statistic of the reference node, so the traversals of
+  // different query points can't share the reference tree.
+  const bool parallel = naive ||
+      !tree::TreeTraits<Tree>::FirstPointIsCentroid;
+
+  #pragma omp parallel if(parallel) reduction(+:totalBaseCases, totalScores)
+  {
+    #ifdef HAS_OPENMP
+    RangeSearchBuffer& buffer = buffers[omp_get_thread_num()];
+    #else
+    RangeSearchBuffer& buffer = buffers[0];
+    #endif
+
+    // Each thread has its own rules, so that the state of the rules and the
+    // results are not shared.
+    RuleType rules(*referenceSet, querySet, range, buffer, metric, sameSet);
+    tree::TraversalStatistics threadStatistics;
+    tree::CountingRules<RuleType> countingRules(rules, threadStatistics);
+    typename Tree::template SingleTreeTraverser<tree::CountingRules<RuleType>>
+        traverser(countingRules);
+
+    // The search time differs a lot between query points, so they are given to
+    // the threads in small chunks.
+    #pragma omp for schedule(dynamic, 16)
+    for (omp_size_t i = 0; i < (omp_size_t) querySet.n_cols; ++i)
+    {
+      if (naive)
+      {
+        // The naive brute-force solution.
+        for (size_t j = 0; j < referenceSet->n_cols; ++j)
+          rules.BaseCase(i, j);
+      }
+      else
+      {
+        traverser.Traverse(i, *referenceTree);
+      }
+    }
+
+    totalBaseCases += rules.BaseCases();
+    totalScores += rules.Scores();
+
+    #pragma omp critical(RangeSearchStatistics)
+    statistics += threadStatistics;
+  }
+
+  if (naive)
+  {
+    baseCases = (querySet.n_cols * referenceSet->n_cols);
+    scores = 0;
+  }
+  else
+  {
+    baseCases = totalBaseCases;
+    scores = totalScores;
+  }
+
+  Timer::Stop("range_search/computing_neighbors");
+  if (!naive)
+    statistics.Print(Log::Info);
+}
+
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void RangeSearch<MetricType, MatType, TreeType>::BuildCSR(
+    const std::vector<RangeSearchBuffer>& buffers,
+    const size_t numQueries,
+    const std::vector<size_t>* oldFromNewQueries,
+    const std::vector<size_t>* oldFromNewRefs,
+    arma::Col<size_t>& offsets,
+    arma::Col<size_t>& neighbors,
+    arma::vec& distances)
+{
+  // First count the results of each query point, then turn the counts into
+  // offsets.
+  offsets.zeros(numQueries + 1);
+  for (size_t b = 0; b < buffers.size(); ++b)
+  {
+    for (size_t i = 0; i < buffers[b].queries.size(); ++i)
+    {
+      const size_t query = oldFromNewQueries ?
+          (*oldFromNewQueries)[buffers[b].queries[i]] : buffers[b].queries[i];
+      ++offsets[query + 1];
+    }
+  }
+
+  for (size_t i = 1; i <= numQueries; ++i)
+    offsets[i] += offsets[i - 1];
+
+  // Now put each result in its place.  The results of each query point keep
+  // the order they were found in.
+  neighbors.set_size(offsets[numQueries]);
+  distances.set_size(offsets[numQueries]);
+  arma::Col<size_t> positions = offsets.head(numQueries);
+  for (size_t b = 0; b < buffers.size(); ++b)
+  {
+    for (size_t i = 0; i < buffers[b].queries.size(); ++i)
+    {
+      const size_t query = oldFromNewQueries ?
+          (*oldFromNewQueries)[buffers[b].queries[i]] : buffers[b].queries[i];
+      const size_t position = positions[query]++;
+      neighbors[position] = oldFromNewRefs ?
+          (*oldFromNewRefs)[buffers[b].neighbors[i]] : buffers[b].neighbors[i];
+      distances[position] = buffers[b].distances[i];
+    }
+  }
+}
+
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void RangeSearch<MetricType, MatType, TreeType>::Count(
+    const MatType& querySet,
+    const math::Range& range,
+    arma::Col<size_t>& counts,
+    const size_t maxCount)
+{
+  if (querySet.n_rows != referenceSet->n_rows)
+  {
+    std::ostringstream oss;
+    oss << "RangeSearch::Count(): dimensionalities of query set ("
+        << querySet.n_rows << ") and reference set (" << referenceSet->n_rows
+        << ") do not match!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  counts.zeros(querySet.n_cols);
+
+  // If there are no points, there is no search to be done.
+  if (referenceSet->n_cols == 0)
+    return;
+
+  Timer::Start("range_search/computing_neighbors");
+
+  // Create the helper object for the traversal.
+  typedef RangeSearchRules<MetricType, Tree> RuleType;
+
+  // Reset counts.
+  baseCases = 0;
+  scores = 0;
+  statistics.Reset();
+
+  if (naive)
+  {
+    RuleType rules(*referenceSet, querySet, range, counts, maxCount, metric);
+
+    // The naive brute-force solution.
+    for (size_t i = 0; i < querySet.n_cols; ++i)
+      for (size_t j = 0; j < referenceSet->n_cols; ++j)
+        rules.BaseCase(i, j);
+
+    baseCases += (querySet.n_cols * referenceSet->n_cols);
+  }
+  else if (singleMode)
+  {
+    // Create the traverser.
+    RuleType rules(*referenceSet, querySet, range, counts, maxCount, metric);
+    statistics.Reset();
+    tree::CountingRules<RuleType> countingRules(rules, statistics);
+    typename Tree::template SingleTreeTraverser<tree::CountingRules<RuleType>>
+        traverser(countingRules);
+
+    // Now have it traverse for each point.
+    for (size_t i = 0; i < querySet.n_cols; ++i)
+      traverser.Traverse(i, *referenceTree);
+
+    baseCases += rules.BaseCases();
+    scores += rules.Scores();
+  }
+  else // Dual-tree recursion.
+  {
+    // Build the query tree.
+    Timer::Stop("range_search/computing_neighbors");
+    Timer::Start("range_search/tree_building");
+    std::vector<size_t> oldFromNewQueries;
+    Tree* queryTree = BuildTree<Tree>(querySet, oldFromNewQueries);
+    Timer::Stop("range_search/tree_building");
+    Timer::Start("range_search/computing_neighbors");
+
+    // Create the traverser.
+    arma::Col<size_t> treeCounts(querySet.n_cols, arma::fill::zeros);
+    RuleType rules(*referenceSet, queryTree->Dataset(), range, treeCounts,
+        maxCount, metric);
+    statistics.Reset();
+    tree::CountingRules<RuleType> countingRules(rules, statistics);
+    typename Tree::template DualTreeTraverser<tree::CountingRules<RuleType>>
+        traverser(countingRules);
+
+    traverser.Traverse(*queryTree, *referenceTree);
+
+    baseCases += rules.BaseCases();
+    scores += rules.Scores();
+
+    // Map the counts back to the original query indices, if necessary.
+    if (tree::TreeTraits<Tree>::RearrangesDataset)
+    {
+      for (size_t i = 0; i < treeCounts.n_elem; ++i)
+        counts[oldFromNewQueries[i]] = treeCounts[i];
+    }
+    else
+    {
+      counts = std::move(treeCounts);
+    }
+
+    // Clean up tree memory.
+    delete queryTree;
+  }
+
+  Timer::Stop("range_search/computing_neighbors");
+  if (!naive)
+    statistics.Print(Log::Info);
+
+  // The counts may be a little over maxCount.
+  if (maxCount != SIZE_MAX)
+    counts.transform([maxCount](size_t c) { return std::min(c, maxCount); });
+}
+
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void RangeSearch<MetricType, MatType, TreeType>::Count(
+    const math::Range& range,
+    arma::Col<size_t>& counts,
+    const size_t maxCount)
+{
+  counts.zeros(referenceSet->n_cols);
+
+  // If there are no points, there is no search to be done.
+  if (referenceSet->n_cols == 0)
+    return;
+
+  Timer::Start("range_search/computing_neighbors");
+
+  // In counting mode, each point is counted in its own range if the range
+  // contains zero (exactly once, unless the search stopped early), so we
+  // count one more point and subtract it at the end.
+  const bool countsSelf = range.Contains(0.0);
+  const size_t ruleMaxCount = (countsSelf && maxCount != SIZE_MAX) ?
+      maxCount + 1 : maxCount;
+
+  // Here, we will use the query set as the reference set.
+  arma::Col<size_t> treeCounts(referenceSet->n_cols, arma::fill::zeros);
+
+  // Create the helper object for the traversal.
+  typedef RangeSearchRules<MetricType, Tree> RuleType;
+  RuleType rules(*referenceSet, *referenceSet, range, treeCounts,
+      ruleMaxCount, metric);
+
+  if (naive)
+  {
+    // The naive brute-force solution.
+    for (size_t i = 0; i < referenceSet->n_cols; ++i)
+      for (size_t j = 0; j < referenceSet->n_cols; ++j)
+        rules.BaseCase(i, j);
+
+    baseCases = (referenceSet->n_cols * referenceSet->n_cols);
+    scores = 0;
+    statistics.Reset();
+  }
+  else if (singleMode)
+  {
+    // Create the traverser.
+    statistics.Reset();
+    tree::CountingRules<RuleType> countingRules(rules, statistics);
+    typename Tree::template SingleTreeTraverser<tree::CountingRules<RuleType>>
+        traverser(countingRules);
+
+    // Now have it traverse for each point.
+    for (size_t i = 0; i < referenceSet->n_cols; ++i)
+      traverser.Traverse(i, *referenceTree);
+
+    baseCases = rules.BaseCases();
+    scores = rules.Scores();
+  }
+  else // Dual-tree recursion.
+  {
+    // Create the traverser.
+    statistics.Reset();
+    tree::CountingRules<RuleType> countingRules(rules, statistics);
+    typename Tree::template DualTreeTraverser<tree::CountingRules<RuleType>>
+        traverser(countingRules);
+
+    traverser.Traverse(*referenceTree, *referenceTree);
+
+    baseCases = rules.BaseCases();
+    scores = rules.Scores();
+  }
+
+  Timer::Stop("range_search/computing_neighbors");
+  if (!naive)
+    statistics.Print(Log::Info);
+
+  // Map the counts back to the original indices, if necessary, and remove
+  // each point from its own count.
+  for (size_t i = 0; i < treeCounts.n_elem; ++i)
+  {
+    const size_t index = (treeOwner &&
+        tree::TreeTraits<Tree>::RearrangesDataset) ? oldFromNewReferences[i] :
+        i;
+    const size_t count = (countsSelf && treeCounts[i] > 0) ?
+        treeCounts[i] - 1 : treeCounts[i];
+    counts[index] = std::min(count, maxCount);
+  }
+}
+
 template<typename MetricType,
          typename MatType,
          template<typename TreeMetricType,
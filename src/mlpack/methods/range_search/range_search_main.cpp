@@ -62,7 +62,17 @@ PROGRAM_INFO("Range Search",
     " resultant CSV-like files may not be loadable by many programs.  However, "
     "at this time a better way to store this non-square result is not known.  "
     "As a result, any output files will be written as CSVs in this manner, "
-    "regardless of the given extension.",
+    "regardless of the given extension, unless the " +
+    PRINT_PARAM_STRING("binary_output") + " flag is given."
+    "\n\n"
+    "If " + PRINT_PARAM_STRING("binary_output") + " is given, the results are "
+    "collected and written in a compact binary (compressed sparse row) format,"
+    " which is much faster for large results.  Each output file then starts "
+    "with the number of query points n, followed by n + 1 offsets, all stored "
+    "as 64-bit unsigned integers; the results for query point i are the "
+    "entries offsets[i] to offsets[i + 1] - 1 of the rest of the file, which "
+    "holds the neighbor indices as 64-bit unsigned integers or the distances "
+    "as 64-bit doubles.  All values are in the byte order of the machine.",
     SEE_ALSO("@knn", "#knn"),
     SEE_ALSO("Range searching on Wikipedia",
         "https://en.wikipedia.org/wiki/Range_searching"),
@@ -105,6 +115,51 @@ PARAM_FLAG("naive", "If true, O(n^2) naive mode is used for computation.", "N");
 PARAM_FLAG("single_mode", "If true, single-tree search is used (as opposed to "
     "dual-tree search).", "S");
 
+// Output settings.
+PARAM_FLAG("binary_output", "If true, the neighbors and distances files are "
+    "written in a compact binary format instead of as CSV-like text.", "B");
+
+/**
+ * Write range search results in CSR format to the given file, as described in
+ * the documentation of the binary_output parameter.
+ */
+template<typename eT>
+static void SaveBinaryResults(const string& filename,
+                              const arma::Col<size_t>& offsets,
+                              const arma::Col<eT>& values,
+                              const string& description)
+{
+  fstream stream(filename.c_str(), fstream::out | fstream::binary);
+  if (!stream.is_open())
+  {
+    Log::Warn << "Cannot open file '" << filename << "' to save output "
+        << description << " to!" << endl;
+    return;
+  }
+
+  const uint64_t numQueries = offsets.n_elem - 1;
+  stream.write((const char*) &numQueries, sizeof(uint64_t));
+  for (size_t i = 0; i < offsets.n_elem; ++i)
+  {
+    const uint64_t offset = offsets[i];
+    stream.write((const char*) &offset, sizeof(uint64_t));
+  }
+
+  // Indices are written as 64-bit integers whatever the size of size_t.
+  if (std::is_same<eT, size_t>::value && sizeof(size_t) != sizeof(uint64_t))
+  {
+    for (size_t i = 0; i < values.n_elem; ++i)
+    {
+      const uint64_t value = values[i];
+      stream.write((const char*) &value, sizeof(uint64_t));
+    }
+  }
+  else
+  {
+    stream.write((const char*) values.memptr(), values.n_elem * sizeof(eT));
+  }
+}
+
 static void mlpackMain()
 {
   if (CLI::GetParam<int>("seed") != 0)
@@ -244,6 +299,36 @@ static void mlpackMain()
       Log::Warn << PRINT_PARAM_STRING("single_mode") << " ignored because "
           << PRINT_PARAM_STRING("naive") << " is present." << endl;
 
+    if (CLI::HasParam("binary_output"))
+    {
+      // Collect the results in CSR format, and write them as they are.
+      arma::Col<size_t> offsets, neighbors;
+      arma::vec distances;
+
+      if (CLI::HasParam("query"))
+        rs->Search(std::move(queryData), r, offsets, neighbors, distances);
+      else
+        rs->Search(r, offsets, neighbors, distances);
+
+      Log::Info << "Search complete." << endl;
+
+      if (CLI::HasParam("distances_file"))
+      {
+        SaveBinaryResults(CLI::GetParam<string>("distances_file"), offsets,
+            distances, "distances");
+      }
+
+      if (CLI::HasParam("neighbors_file"))
+      {
+        SaveBinaryResults(CLI::GetParam<string>("neighbors_file"), offsets,
+            neighbors, "neighbor indices");
+      }
+
+      // Save the output model.
+      CLI::GetParam<RSModel*>("output_model") = rs;
+      return;
+    }
+
     // Now run the search.
     vector<vector<size_t>> neighbors;
     vector<vector<double>> distances;
@@ -17,6 +17,23 @@
 namespace mlpack {
 namespace range {
 
+/**
+ * A flat buffer of range search results, stored in the order they are found:
+ * the i'th result is the reference point neighbors[i], at distance
+ * distances[i] from the query point queries[i].  Collecting results this way
+ * needs only a few large allocations, instead of one small vector for each
+ * query point.
+ */
+struct RangeSearchBuffer
+{
+  //! The query point of each result.
+  std::vector<size_t> queries;
+  //! The reference point of each result.
+  std::vector<size_t> neighbors;
+  //! The distance of each result.
+  std::vector<double> distances;
+};
+
 /**
  * The RangeSearchRules class is a template helper class used by RangeSearch
  * class when performing range searches.
@@ -41,14 +58,58 @@ class RangeSearchRules
    * @param sameSet If true, the query and reference set are taken to be the
    *      same, and a query point will not return itself in the results.
    */
-  RangeSearchRules(const arma::mat& referenceSet,
-                   const arma::mat& querySet,
+  RangeSearchRules(const typename TreeType::Mat& referenceSet,
+                   const typename TreeType::Mat& querySet,
                    const math::Range& range,
                    std::vector<std::vector<size_t> >& neighbors,
                    std::vector<std::vector<double> >& distances,
                    MetricType& metric,
                    const bool sameSet = false);
 
+  /**
+   * Construct the RangeSearchRules object so that the results are appended to
+   * the given buffer, instead of being stored separately for each query point.
+   *
+   * @param referenceSet Set of reference data.
+   * @param querySet Set of query data.
+   * @param range Range to search for.
+   * @param buffer Buffer to append the results to.
+   * @param metric Instantiated metric.
+   * @param sameSet If true, the query and reference set are taken to be the
+   *      same, and a query point will not return itself in the results.
+   */
+  RangeSearchRules(const typename TreeType::Mat& referenceSet,
+                   const typename TreeType::Mat& querySet,
+                   const math::Range& range,
+                   RangeSearchBuffer& buffer,
+                   MetricType& metric,
+                   const bool sameSet = false);
+
+  /**
+   * Construct the RangeSearchRules object in counting mode: instead of storing
+   * the neighbors and distances of each query point, only their number is
+   * stored.  When all the points of a reference node are in the range, their
+   * number is added without visiting them.  Once the count of a query point
+   * reaches maxCount, the rest of the search is pruned for that query point (so
+   * counts may exceed maxCount by a little, but are exact below it).  In
+   * counting mode, a query point is counted in its own range even if the query
+   * and reference set are the same.
+   *
+   * @param referenceSet Set of reference data.
+   * @param querySet Set of query data.
+   * @param range Range to search for.
+   * @param counts Vector to store resulting counts in; must be filled with
+   *      zeros.
+   * @param maxCount Count after which a query point is not searched further.
+   * @param metric Instantiated metric.
+   */
+  RangeSearchRules(const typename TreeType::Mat& referenceSet,
+                   const typename TreeType::Mat& querySet,
+                   const math::Range& range,
+                   arma::Col<size_t>& counts,
+                   const size_t maxCount,
+                   MetricType& metric);
+
   /**
    * Compute the base case between the given query point and reference point.
    *
@@ -119,19 +180,32 @@ class RangeSearchRules
 
  private:
   //! The reference set.
-  const arma::mat& referenceSet;
+  const typename TreeType::Mat& referenceSet;
 
   //! The query set.
-  const arma::mat& querySet;
+  const typename TreeType::Mat& querySet;
 
   //! The range of distances for which we are searching.
   const math::Range& range;
 
-  //! The vector the resultant neighbor indices should be stored in.
-  std::vector<std::vector<size_t> >& neighbors;
+  //! The vector the resultant neighbor indices should be stored in (NULL in
+  //! counting and buffer mode).
+  std::vector<std::vector<size_t> >* neighbors;
+
+  //! The vector the resultant neighbor distances should be stored in (NULL in
+  //! counting and buffer mode).
+  std::vector<std::vector<double> >* distances;
 
-  //! The vector the resultant neighbor distances should be stored in.
-  std::vector<std::vector<double> >& distances;
+  //! The vector the resultant counts should be stored in (NULL unless in
+  //! counting mode).
+  arma::Col<size_t>* counts;
+
+  //! The buffer the results should be appended to (NULL unless in buffer
+  //! mode).
+  RangeSearchBuffer* buffer;
+
+  //! The count after which a query point is not searched further.
+  size_t maxCount;
 
   //! The instantiated metric.
   MetricType& metric;
@@ -144,6 +218,11 @@ class RangeSearchRules
   //! The last reference index.
   size_t lastReferenceIndex;
 
+  //! Store the given reference point as a result of the given query point.
+  void AddNeighbor(const size_t queryIndex,
+                   const size_t referenceIndex,
+                   const double distance);
+
   //! Add all the points in the given node to the results for the given query
   //! point.  If the base case has already been calculated, we make sure to not
   //! add that to the results twice.
@@ -20,8 +20,8 @@ namespace range {
 
 template<typename MetricType, typename TreeType>
 RangeSearchRules<MetricType, TreeType>::RangeSearchRules(
-    const arma::mat& referenceSet,
-    const arma::mat& querySet,
+    const typename TreeType::Mat& referenceSet,
+    const typename TreeType::Mat& querySet,
     const math::Range& range,
     std::vector<std::vector<size_t> >& neighbors,
     std::vector<std::vector<double> >& distances,
@@ -30,8 +30,11 @@ RangeSearchRules<MetricType, TreeType>::RangeSearchRules(
     referenceSet(referenceSet),
     querySet(querySet),
     range(range),
-    neighbors(neighbors),
-    distances(distances),
+    neighbors(&neighbors),
+    distances(&distances),
+    counts(NULL),
+    buffer(NULL),
+    maxCount(SIZE_MAX),
     metric(metric),
     sameSet(sameSet),
     lastQueryIndex(querySet.n_cols),
@@ -42,6 +45,58 @@ RangeSearchRules<MetricType, TreeType>::RangeSearchRules(
   // Nothing to do.
 }
 
+template<typename MetricType, typename TreeType>
+RangeSearchRules<MetricType, TreeType>::RangeSearchRules(
+    const typename TreeType::Mat& referenceSet,
+    const typename TreeType::Mat& querySet,
+    const math::Range& range,
+    RangeSearchBuffer& buffer,
+    MetricType& metric,
+    const bool sameSet) :
+    referenceSet(referenceSet),
+    querySet(querySet),
+    range(range),
+    neighbors(NULL),
+    distances(NULL),
+    counts(NULL),
+    buffer(&buffer),
+    maxCount(SIZE_MAX),
+    metric(metric),
+    sameSet(sameSet),
+    lastQueryIndex(querySet.n_cols),
+    lastReferenceIndex(referenceSet.n_cols),
+    baseCases(0),
+    scores(0)
+{
+  // Nothing to do.
+}
+
+template<typename MetricType, typename TreeType>
+RangeSearchRules<MetricType, TreeType>::RangeSearchRules(
+    const typename TreeType::Mat& referenceSet,
+    const typename TreeType::Mat& querySet,
+    const math::Range& range,
+    arma::Col<size_t>& counts,
+    const size_t maxCount,
+    MetricType& metric) :
+    referenceSet(referenceSet),
+    querySet(querySet),
+    range(range),
+    neighbors(NULL),
+    distances(NULL),
+    counts(&counts),
+    buffer(NULL),
+    maxCount(maxCount),
+    metric(metric),
+    sameSet(false),
+    lastQueryIndex(querySet.n_cols),
+    lastReferenceIndex(referenceSet.n_cols),
+    baseCases(0),
+    scores(0)
+{
+  // Nothing to do.
+}
+
 //! The base case.  Evaluate the distance between the two points and add to the
 //! results if necessary.
 template<typename MetricType, typename TreeType>
@@ -68,8 +123,7 @@ double RangeSearchRules<MetricType, TreeType>::BaseCase(
 
   if (range.Contains(distance))
   {
-    neighbors[queryIndex].push_back(referenceIndex);
-    distances[queryIndex].push_back(distance);
+    AddNeighbor(queryIndex, referenceIndex, distance);
   }
 
   return distance;
@@ -80,6 +134,11 @@ template<typename MetricType, typename TreeType>
 double RangeSearchRules<MetricType, TreeType>::Score(const size_t queryIndex,
                                                      TreeType& referenceNode)
 {
+  // In counting mode, stop searching for query points that have enough
+  // results.
+  if (counts && (*counts)[queryIndex] >= maxCount)
+    return DBL_MAX;
+
   // We must get the minimum and maximum distances and store them in this
   // object.
   math::Range distances;
@@ -236,14 +295,26 @@ void RangeSearchRules<MetricType, TreeType>::AddResult(const size_t queryIndex,
     baseCaseMod = 1;
   }
 
+  // In counting mode, the points do not need to be visited at all.
+  if (counts)
+  {
+    (*counts)[queryIndex] += referenceNode.NumDescendants() - baseCaseMod;
+    return;
+  }
+
   // Resize distances and neighbors vectors appropriately.  We have to use
   // reserve() and not resize(), because we don't know if we will encounter the
   // case where the datasets and points are the same (and we skip in that case).
-  const size_t oldSize = neighbors[queryIndex].size();
-  neighbors[queryIndex].reserve(oldSize + referenceNode.NumDescendants() -
-      baseCaseMod);
-  distances[queryIndex].reserve(oldSize + referenceNode.NumDescendants() -
-      baseCaseMod);
+  // A flat buffer is left to grow by itself, since reserving the exact size
+  // each time would defeat its geometric growth.
+  if (!buffer)
+  {
+    const size_t oldSize = (*neighbors)[queryIndex].size();
+    (*neighbors)[queryIndex].reserve(oldSize + referenceNode.NumDescendants() -
+        baseCaseMod);
+    (*distances)[queryIndex].reserve(oldSize + referenceNode.NumDescendants() -
+        baseCaseMod);
+  }
 
   for (size_t i = baseCaseMod; i < referenceNode.NumDescendants(); ++i)
   {
@@ -254,8 +325,30 @@ void RangeSearchRules<MetricType, TreeType>::AddResult(const size_t queryIndex,
     const double distance = metric.Evaluate(querySet.unsafe_col(queryIndex),
         referenceNode.Dataset().unsafe_col(referenceNode.Descendant(i)));
 
-    neighbors[queryIndex].push_back(referenceNode.Descendant(i));
-    distances[queryIndex].push_back(distance);
+    AddNeighbor(queryIndex, referenceNode.Descendant(i), distance);
+  }
+}
+
+template<typename MetricType, typename TreeType>
+void RangeSearchRules<MetricType, TreeType>::AddNeighbor(
+    const size_t queryIndex,
+    const size_t referenceIndex,
+    const double distance)
+{
+  if (counts)
+  {
+    ++(*counts)[queryIndex];
+  }
+  else if (buffer)
+  {
+    buffer->queries.push_back(queryIndex);
+    buffer->neighbors.push_back(referenceIndex);
+    buffer->distances.push_back(distance);
+  }
+  else
+  {
+    (*neighbors)[queryIndex].push_back(referenceIndex);
+    (*distances)[queryIndex].push_back(distance);
   }
 }
 
@@ -30,8 +30,9 @@ namespace range {
  */
 template<template<typename TreeMetricType,
                   typename TreeStatType,
-                  typename TreeMatType> class TreeType>
-using RSType = RangeSearch<metric::EuclideanDistance, arma::mat, TreeType>;
+                  typename TreeMatType> class TreeType,
+         typename MatType = arma::mat>
+using RSType = RangeSearch<metric::EuclideanDistance, MatType, TreeType>;
 
 /**
  * MonoSearchVisitor executes a monochromatic range search on the given
@@ -42,10 +43,16 @@ class MonoSearchVisitor : public  boost::static_visitor<void>
  private:
   //! The range to search for.
   const math::Range& range;
-  //! Output neighbors.
-  std::vector<std::vector<size_t>>& neighbors;
-  //! Output distances.
-  std::vector<std::vector<double>>& distances;
+  //! Output neighbors (NULL if the results are in CSR format).
+  std::vector<std::vector<size_t>>* neighbors;
+  //! Output distances (NULL if the results are in CSR format).
+  std::vector<std::vector<double>>* distances;
+  //! Output offsets in CSR format (NULL otherwise).
+  arma::Col<size_t>* offsets;
+  //! Output neighbors in CSR format (NULL otherwise).
+  arma::Col<size_t>* flatNeighbors;
+  //! Output distances in CSR format (NULL otherwise).
+  arma::vec* flatDistances;
 
  public:
   //! Perform monochromatic search with the given RangeSearch object.
@@ -57,8 +64,24 @@ class MonoSearchVisitor : public  boost::static_visitor<void>
                     std::vector<std::vector<size_t>>& neighbors,
                     std::vector<std::vector<double>>& distances):
       range(range),
-      neighbors(neighbors),
-      distances(distances)
+      neighbors(&neighbors),
+      distances(&distances),
+      offsets(NULL),
+      flatNeighbors(NULL),
+      flatDistances(NULL)
+  {};
+
+  //! Construct the MonoSearchVisitor to return results in CSR format.
+  MonoSearchVisitor(const math::Range& range,
+                    arma::Col<size_t>& offsets,
+                    arma::Col<size_t>& flatNeighbors,
+                    arma::vec& flatDistances):
+      range(range),
+      neighbors(NULL),
+      distances(NULL),
+      offsets(&offsets),
+      flatNeighbors(&flatNeighbors),
+      flatDistances(&flatDistances)
   {};
 };
 
@@ -68,17 +91,24 @@ class MonoSearchVisitor : public  boost::static_visitor<void>
  * accept leafSize as a parameter. In these cases, before doing range search,
  * a query tree with proper leafSize is built from the querySet.
  */
+template<typename MatType = arma::mat>
 class BiSearchVisitor : public boost::static_visitor<void>
 {
  private:
   //! The query set for the bichromatic search.
-  const arma::mat& querySet;
+  const MatType& querySet;
   //! Range to search neighbours for.
   const math::Range& range;
-  //! The result vector for neighbors.
-  std::vector<std::vector<size_t>>& neighbors;
-  //! The result vector for distances.
-  std::vector<std::vector<double>>& distances;
+  //! The result vector for neighbors (NULL if the results are in CSR format).
+  std::vector<std::vector<size_t>>* neighbors;
+  //! The result vector for distances (NULL if the results are in CSR format).
+  std::vector<std::vector<double>>* distances;
+  //! The result offsets in CSR format (NULL otherwise).
+  arma::Col<size_t>* offsets;
+  //! The result neighbors in CSR format (NULL otherwise).
+  arma::Col<size_t>* flatNeighbors;
+  //! The result distances in CSR format (NULL otherwise).
+  arma::vec* flatDistances;
   //! The number of points in a leaf (for BinarySpaceTrees).
   const size_t leafSize;
 
@@ -91,7 +121,7 @@ class BiSearchVisitor : public boost::static_visitor<void>
   template<template<typename TreeMetricType,
                     typename TreeStatType,
                     typename TreeMatType> class TreeType>
-  using RSTypeT = RSType<TreeType>;
+  using RSTypeT = RSType<TreeType, MatType>;
 
   //! Default Bichromatic range search on the given RSType instance.
   template<template<typename TreeMetricType,
@@ -109,11 +139,19 @@ class BiSearchVisitor : public boost::static_visitor<void>
   void operator()(RSTypeT<tree::Octree>* rs) const;
 
   //! Construct the BiSearchVisitor.
-  BiSearchVisitor(const arma::mat& querySet,
+  BiSearchVisitor(const MatType& querySet,
                   const math::Range& range,
                   std::vector<std::vector<size_t>>& neighbors,
                   std::vector<std::vector<double>>& distances,
                   const size_t leafSize);
+
+  //! Construct the BiSearchVisitor to return results in CSR format.
+  BiSearchVisitor(const MatType& querySet,
+                  const math::Range& range,
+                  arma::Col<size_t>& offsets,
+                  arma::Col<size_t>& flatNeighbors,
+                  arma::vec& flatDistances,
+                  const size_t leafSize);
 };
 
 /**
@@ -122,11 +160,12 @@ class BiSearchVisitor : public boost::static_visitor<void>
  * accept leafSize as a parameter. In these cases, a reference tree with proper
  * leafSize is built from the referenceSet.
  */
+template<typename MatType = arma::mat>
 class TrainVisitor : public boost::static_visitor<void>
 {
  private:
   //! The reference set to use for training.
-  arma::mat&& referenceSet;
+  MatType&& referenceSet;
   //! The leaf size, used only by BinarySpaceTree.
   size_t leafSize;
   //! Train on the given RsType considering the leafSize.
@@ -138,7 +177,7 @@ class TrainVisitor : public boost::static_visitor<void>
   template<template<typename TreeMetricType,
                     typename TreeStatType,
                     typename TreeMatType> class TreeType>
-  using RSTypeT = RSType<TreeType>;
+  using RSTypeT = RSType<TreeType, MatType>;
 
   //! Default Train on the given RSType instance.
   template<template<typename TreeMetricType,
@@ -156,19 +195,20 @@ class TrainVisitor : public boost::static_visitor<void>
   void operator()(RSTypeT<tree::Octree>* rs) const;
 
   //! Construct the TrainVisitor object with the given reference set, leafSize
-  TrainVisitor(arma::mat&& referenceSet,
+  TrainVisitor(MatType&& referenceSet,
                const size_t leafSize);
 };
 
 /**
  * ReferenceSetVisitor exposes the referenceSet of the given RSType.
  */
-class ReferenceSetVisitor : public boost::static_visitor<const arma::mat&>
+template<typename MatType = arma::mat>
+class ReferenceSetVisitor : public boost::static_visitor<const MatType&>
 {
  public:
   //! Return the reference set.
   template<typename RSType>
-  const arma::mat& operator()(RSType* rs) const;
+  const MatType& operator()(RSType* rs) const;
 };
 
 /**
@@ -209,7 +249,17 @@ class NaiveVisitor : public boost::static_visitor<bool&>
   bool& operator()(RSType* rs) const;
 };
 
-class RSModel
+/**
+ * The RSModelType class provides an easy way to serialize a range search
+ * model, and abstracts away the different types of trees.  It is meant to be
+ * used by the command-line mlpack_range_search program.
+ *
+ * @tparam MatType The type of data matrix to use; arma::fmat halves the memory
+ *     used by the reference set and the trees built on it, compared to
+ *     arma::mat.  Distances are always returned as doubles.
+ */
+template<typename MatType = arma::mat>
+class RSModelType
 {
  public:
   enum TreeTypes
@@ -237,73 +287,73 @@ class RSModel
   //! If true, we randomly project the data into a new basis before search.
   bool randomBasis;
   //! Random projection matrix.
-  arma::mat q;
+  MatType q;
 
   /**
    * rSearch holds an instance of the RangeSearch class for the current
    * treeType. It is initialized every time BuildModel is executed.
    * We access to the contained value through the visitor classes defined above.
    */
-  boost::variant<RSType<tree::KDTree>*,
-                 RSType<tree::StandardCoverTree>*,
-                 RSType<tree::RTree>*,
-                 RSType<tree::RStarTree>*,
-                 RSType<tree::BallTree>*,
-                 RSType<tree::XTree>*,
-                 RSType<tree::HilbertRTree>*,
-                 RSType<tree::RPlusTree>*,
-                 RSType<tree::RPlusPlusTree>*,
-                 RSType<tree::VPTree>*,
-                 RSType<tree::RPTree>*,
-                 RSType<tree::MaxRPTree>*,
-                 RSType<tree::UBTree>*,
-                 RSType<tree::Octree>*> rSearch;
+  boost::variant<RSType<tree::KDTree, MatType>*,
+                 RSType<tree::StandardCoverTree, MatType>*,
+                 RSType<tree::RTree, MatType>*,
+                 RSType<tree::RStarTree, MatType>*,
+                 RSType<tree::BallTree, MatType>*,
+                 RSType<tree::XTree, MatType>*,
+                 RSType<tree::HilbertRTree, MatType>*,
+                 RSType<tree::RPlusTree, MatType>*,
+                 RSType<tree::RPlusPlusTree, MatType>*,
+                 RSType<tree::VPTree, MatType>*,
+                 RSType<tree::RPTree, MatType>*,
+                 RSType<tree::MaxRPTree, MatType>*,
+                 RSType<tree::UBTree, MatType>*,
+                 RSType<tree::Octree, MatType>*> rSearch;
 
  public:
   /**
-   * Initialize the RSModel with the given type and whether or not a random
+   * Initialize the RSModelType with the given type and whether or not a random
    * basis should be used.
    *
    * @param treeType Type of tree to use.
    * @param randomBasis Whether or not to use a random basis.
    */
-  RSModel(const TreeTypes treeType = TreeTypes::KD_TREE,
-          const bool randomBasis = false);
+  RSModelType(const TreeTypes treeType = TreeTypes::KD_TREE,
+              const bool randomBasis = false);
 
   /**
-   * Copy the given RSModel.
+   * Copy the given RSModelType.
    *
-   * @param other RSModel to copy.
+   * @param other RSModelType to copy.
    */
-  RSModel(const RSModel& other);
+  RSModelType(const RSModelType& other);
 
   /**
-   * Take ownership of the given RSModel.
+   * Take ownership of the given RSModelType.
    *
-   * @param other RSModel to take ownership of.
+   * @param other RSModelType to take ownership of.
    */
-  RSModel(RSModel&& other);
+  RSModelType(RSModelType&& other);
 
   /**
-   * Copy the given RSModel.
+   * Copy the given RSModelType.
    *
    * Use std::move to pass in the model if the old copy is no longer needed.
    *
-   * @param other RSModel to copy.
+   * @param other RSModelType to copy.
    */
-  RSModel& operator=(RSModel other);
+  RSModelType& operator=(RSModelType other);
 
   /**
    * Clean memory, if necessary.
    */
-  ~RSModel();
+  ~RSModelType();
 
   //! Serialize the range search model.
   template<typename Archive>
   void serialize(Archive& ar, const unsigned int /* version */);
 
   //! Expose the dataset.
-  const arma::mat& Dataset() const;
+  const MatType& Dataset() const;
 
   //! Get whether the model is in single-tree search mode.
   bool SingleMode() const;
@@ -340,7 +390,7 @@ class RSModel
    * @param naive Whether naive search should be used.
    * @param singleMode Whether single-tree search should be used.
    */
-  void BuildModel(arma::mat&& referenceSet,
+  void BuildModel(MatType&& referenceSet,
                   const size_t leafSize,
                   const bool naive,
                   const bool singleMode);
@@ -355,7 +405,7 @@ class RSModel
    * @param neighbors Output: neighbors falling within the desired range.
    * @param distances Output: distances of neighbors.
    */
-  void Search(arma::mat&& querySet,
+  void Search(MatType&& querySet,
               const math::Range& range,
               std::vector<std::vector<size_t>>& neighbors,
               std::vector<std::vector<double>>& distances);
@@ -373,7 +423,43 @@ class RSModel
               std::vector<std::vector<size_t>>& neighbors,
               std::vector<std::vector<double>>& distances);
 
+  /**
+   * Perform range search, returning the results in compressed sparse row (CSR)
+   * format.  This takes possession of the query set, so the query set will not
+   * be usable after the search.  For more information on the output format,
+   * see RangeSearch<>::Search().
+   *
+   * @param querySet Set of query points.
+   * @param range Range to search for.
+   * @param offsets Output: offsets of the results of each query point.
+   * @param neighbors Output: neighbors falling within the desired range.
+   * @param distances Output: distances of neighbors.
+   */
+  void Search(MatType&& querySet,
+              const math::Range& range,
+              arma::Col<size_t>& offsets,
+              arma::Col<size_t>& neighbors,
+              arma::vec& distances);
+
+  /**
+   * Perform monochromatic range search, with the reference set as the query
+   * set, returning the results in compressed sparse row (CSR) format.  For
+   * more information on the output format, see RangeSearch<>::Search().
+   *
+   * @param range Range to search for.
+   * @param offsets Output: offsets of the results of each query point.
+   * @param neighbors Output: neighbors falling within the desired range.
+   * @param distances Output: distances of neighbors.
+   */
+  void Search(const math::Range& range,
+              arma::Col<size_t>& offsets,
+              arma::Col<size_t>& neighbors,
+              arma::vec& distances);
+
  private:
+  //! Print which kind of search is about to be performed.
+  void LogSearch(const math::Range& range) const;
+
   /**
    * Return a string representing the name of the tree.  This is used for
    * logging output.
@@ -386,6 +472,9 @@ class RSModel
   void CleanMemory();
 };
 
+//! The range search model used by the mlpack_range_search program.
+typedef RSModelType<arma::mat> RSModel;
+
 } // namespace range
 } // namespace mlpack
 
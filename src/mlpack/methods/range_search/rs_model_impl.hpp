@@ -2,7 +2,7 @@
  * @file methods/range_search/rs_model_impl.hpp
  * @author Ryan Curtin
  *
- * Implementation of serialize() and inline functions for RSModel.
+ * Implementation of serialize() and inline functions for RSModelType.
  *
  * mlpack is free software; you may redistribute it and/or modify it under the
  * terms of the 3-clause BSD license.  You should have received a copy of the
@@ -22,10 +22,11 @@ namespace mlpack {
 namespace range {
 
 /**
- * Initialize the RSModel with the given tree type and whether or not a random
- * basis should be used.
+ * Initialize the RSModelType with the given tree type and whether or not a
+ * random basis should be used.
  */
-inline RSModel::RSModel(TreeTypes treeType, bool randomBasis) :
+template<typename MatType>
+RSModelType<MatType>::RSModelType(TreeTypes treeType, bool randomBasis) :
     treeType(treeType),
     leafSize(0),
     randomBasis(randomBasis)
@@ -34,7 +35,8 @@ inline RSModel::RSModel(TreeTypes treeType, bool randomBasis) :
 }
 
 // Copy constructor.
-inline RSModel::RSModel(const RSModel& other) :
+template<typename MatType>
+RSModelType<MatType>::RSModelType(const RSModelType& other) :
     treeType(other.treeType),
     leafSize(other.leafSize),
     randomBasis(other.randomBasis),
@@ -45,7 +47,8 @@ inline RSModel::RSModel(const RSModel& other) :
 }
 
 // Move constructor.
-inline RSModel::RSModel(RSModel&& other) :
+template<typename MatType>
+RSModelType<MatType>::RSModelType(RSModelType&& other) :
     treeType(other.treeType),
     leafSize(other.leafSize),
     randomBasis(other.randomBasis),
@@ -59,7 +62,8 @@ inline RSModel::RSModel(RSModel&& other) :
   other.rSearch = decltype(other.rSearch)();
 }
 
-inline RSModel& RSModel::operator=(RSModel other)
+template<typename MatType>
+RSModelType<MatType>& RSModelType<MatType>::operator=(RSModelType other)
 {
   boost::apply_visitor(DeleteVisitor(), rSearch);
 
@@ -73,21 +77,26 @@ inline RSModel& RSModel::operator=(RSModel other)
 }
 
 // Clean memory, if necessary.
-inline RSModel::~RSModel()
+template<typename MatType>
+RSModelType<MatType>::~RSModelType()
 {
   boost::apply_visitor(DeleteVisitor(), rSearch);
 }
 
-inline void RSModel::BuildModel(arma::mat&& referenceSet,
-                                const size_t leafSize,
-                                const bool naive,
-                                const bool singleMode)
+template<typename MatType>
+void RSModelType<MatType>::BuildModel(MatType&& referenceSet,
+                                      const size_t leafSize,
+                                      const bool naive,
+                                      const bool singleMode)
 {
-  // Initialize random basis if necessary.
+  // Initialize random basis if necessary.  The basis is always computed in
+  // double precision.
   if (randomBasis)
   {
     Log::Info << "Creating random basis..." << std::endl;
-    math::RandomBasis(q, referenceSet.n_rows);
+    arma::mat basis;
+    math::RandomBasis(basis, referenceSet.n_rows);
+    q = arma::conv_to<MatType>::from(basis);
   }
 
   this->leafSize = leafSize;
@@ -108,63 +117,63 @@ inline void RSModel::BuildModel(arma::mat&& referenceSet,
   switch (treeType)
   {
     case KD_TREE:
-      rSearch = new RSType<tree::KDTree> (naive, singleMode);
+      rSearch = new RSType<tree::KDTree, MatType>(naive, singleMode);
       break;
 
     case COVER_TREE:
-      rSearch = new RSType<tree::StandardCoverTree>(naive, singleMode);
+      rSearch = new RSType<tree::StandardCoverTree, MatType>(naive, singleMode);
       break;
 
     case R_TREE:
-      rSearch = new RSType<tree::RTree>(naive, singleMode);
+      rSearch = new RSType<tree::RTree, MatType>(naive, singleMode);
       break;
 
     case R_STAR_TREE:
-      rSearch = new RSType<tree::RStarTree>(naive, singleMode);
+      rSearch = new RSType<tree::RStarTree, MatType>(naive, singleMode);
       break;
 
     case BALL_TREE:
-      rSearch = new RSType<tree::BallTree>(naive, singleMode);
+      rSearch = new RSType<tree::BallTree, MatType>(naive, singleMode);
       break;
 
     case X_TREE:
-      rSearch = new RSType<tree::XTree>(naive, singleMode);
+      rSearch = new RSType<tree::XTree, MatType>(naive, singleMode);
       break;
 
     case HILBERT_R_TREE:
-      rSearch = new RSType<tree::HilbertRTree>(naive, singleMode);
+      rSearch = new RSType<tree::HilbertRTree, MatType>(naive, singleMode);
       break;
 
     case R_PLUS_TREE:
-      rSearch = new RSType<tree::RPlusTree>(naive, singleMode);
+      rSearch = new RSType<tree::RPlusTree, MatType>(naive, singleMode);
       break;
 
     case R_PLUS_PLUS_TREE:
-      rSearch = new RSType<tree::RPlusPlusTree>(naive, singleMode);
+      rSearch = new RSType<tree::RPlusPlusTree, MatType>(naive, singleMode);
       break;
 
     case VP_TREE:
-      rSearch = new RSType<tree::VPTree>(naive, singleMode);
+      rSearch = new RSType<tree::VPTree, MatType>(naive, singleMode);
       break;
 
     case RP_TREE:
-      rSearch = new RSType<tree::RPTree>(naive, singleMode);
+      rSearch = new RSType<tree::RPTree, MatType>(naive, singleMode);
       break;
 
     case MAX_RP_TREE:
-      rSearch = new RSType<tree::MaxRPTree>(naive, singleMode);
+      rSearch = new RSType<tree::MaxRPTree, MatType>(naive, singleMode);
       break;
 
     case UB_TREE:
-      rSearch = new RSType<tree::UBTree>(naive, singleMode);
+      rSearch = new RSType<tree::UBTree, MatType>(naive, singleMode);
       break;
 
     case OCTREE:
-      rSearch = new RSType<tree::Octree>(naive, singleMode);
+      rSearch = new RSType<tree::Octree, MatType>(naive, singleMode);
       break;
   }
 
-  TrainVisitor tn(std::move(referenceSet), leafSize);
+  TrainVisitor<MatType> tn(std::move(referenceSet), leafSize);
   boost::apply_visitor(tn, rSearch);
 
   if (!naive)
@@ -175,34 +184,74 @@ inline void RSModel::BuildModel(arma::mat&& referenceSet,
 }
 
 // Perform range search.
-inline void RSModel::Search(arma::mat&& querySet,
-                            const math::Range& range,
-                            std::vector<std::vector<size_t>>& neighbors,
-                            std::vector<std::vector<double>>& distances)
+template<typename MatType>
+void RSModelType<MatType>::Search(
+    MatType&& querySet,
+    const math::Range& range,
+    std::vector<std::vector<size_t>>& neighbors,
+    std::vector<std::vector<double>>& distances)
 {
   // We may need to map the query set randomly.
   if (randomBasis)
     querySet = q * querySet;
 
-  Log::Info << "Search for points in the range [" << range.Lo() << ", "
-      << range.Hi() << "] with ";
-  if (!Naive() && !SingleMode())
-    Log::Info << "dual-tree " << TreeName() << " search..." << std::endl;
-  else if (!Naive())
-    Log::Info << "single-tree " << TreeName() << " search..." << std::endl;
-  else
-    Log::Info << "brute-force (naive) search..." << std::endl;
-
+  LogSearch(range);
 
-  BiSearchVisitor search(querySet, range, neighbors, distances,
+  BiSearchVisitor<MatType> search(querySet, range, neighbors, distances,
       leafSize);
   boost::apply_visitor(search, rSearch);
 }
 
 // Perform range search (monochromatic case).
-inline void RSModel::Search(const math::Range& range,
-                            std::vector<std::vector<size_t>>& neighbors,
-                            std::vector<std::vector<double>>& distances)
+template<typename MatType>
+void RSModelType<MatType>::Search(
+    const math::Range& range,
+    std::vector<std::vector<size_t>>& neighbors,
+    std::vector<std::vector<double>>& distances)
+{
+  LogSearch(range);
+
+  MonoSearchVisitor search(range, neighbors, distances);
+  boost::apply_visitor(search, rSearch);
+}
+
+// Perform range search with results in CSR format.
+template<typename MatType>
+void RSModelType<MatType>::Search(
+    MatType&& querySet,
+    const math::Range& range,
+    arma::Col<size_t>& offsets,
+    arma::Col<size_t>& neighbors,
+    arma::vec& distances)
+{
+  // We may need to map the query set randomly.
+  if (randomBasis)
+    querySet = q * querySet;
+
+  LogSearch(range);
+
+  BiSearchVisitor<MatType> search(querySet, range, offsets, neighbors,
+      distances, leafSize);
+  boost::apply_visitor(search, rSearch);
+}
+
+// Perform range search (monochromatic case) with results in CSR format.
+template<typename MatType>
+void RSModelType<MatType>::Search(
+    const math::Range& range,
+    arma::Col<size_t>& offsets,
+    arma::Col<size_t>& neighbors,
+    arma::vec& distances)
+{
+  LogSearch(range);
+
+  MonoSearchVisitor search(range, offsets, neighbors, distances);
+  boost::apply_visitor(search, rSearch);
+}
+
+// Print which kind of search is about to be performed.
+template<typename MatType>
+void RSModelType<MatType>::LogSearch(const math::Range& range) const
 {
   Log::Info << "Search for points in the range [" << range.Lo() << ", "
       << range.Hi() << "] with ";
@@ -212,13 +261,11 @@ inline void RSModel::Search(const math::Range& range,
     Log::Info << "single-tree " << TreeName() << " search..." << std::endl;
   else
     Log::Info << "brute-force (naive) search..." << std::endl;
-
-  MonoSearchVisitor search(range, neighbors, distances);
-  boost::apply_visitor(search, rSearch);
 }
 
 // Get the name of the tree type.
-inline std::string RSModel::TreeName() const
+template<typename MatType>
+std::string RSModelType<MatType>::TreeName() const
 {
   switch (treeType)
   {
@@ -256,7 +303,8 @@ inline std::string RSModel::TreeName() const
 }
 
 // Clean memory.
-inline void RSModel::CleanMemory()
+template<typename MatType>
+void RSModelType<MatType>::CleanMemory()
 {
   boost::apply_visitor(DeleteVisitor(), rSearch);
 }
@@ -265,38 +313,71 @@ inline void RSModel::CleanMemory()
 template<typename RSType>
 void MonoSearchVisitor::operator()(RSType* rs) const
 {
-  if (rs)
-    return rs->Search(range, neighbors, distances);
-  throw std::runtime_error("no range search model initialized");
+  if (!rs)
+    throw std::runtime_error("no range search model initialized");
+
+  if (offsets)
+    rs->Search(range, *offsets, *flatNeighbors, *flatDistances);
+  else
+    rs->Search(range, *neighbors, *distances);
 }
 
 //! Save parameters for bichromatic range search.
-inline BiSearchVisitor::BiSearchVisitor(
-    const arma::mat& querySet,
+template<typename MatType>
+BiSearchVisitor<MatType>::BiSearchVisitor(
+    const MatType& querySet,
     const math::Range& range,
     std::vector<std::vector<size_t>>& neighbors,
     std::vector<std::vector<double>>& distances,
     const size_t leafSize) :
     querySet(querySet),
     range(range),
-    neighbors(neighbors),
-    distances(distances),
+    neighbors(&neighbors),
+    distances(&distances),
+    offsets(NULL),
+    flatNeighbors(NULL),
+    flatDistances(NULL),
+    leafSize(leafSize)
+{}
+
+//! Save parameters for bichromatic range search with results in CSR format.
+template<typename MatType>
+BiSearchVisitor<MatType>::BiSearchVisitor(
+    const MatType& querySet,
+    const math::Range& range,
+    arma::Col<size_t>& offsets,
+    arma::Col<size_t>& flatNeighbors,
+    arma::vec& flatDistances,
+    const size_t leafSize) :
+    querySet(querySet),
+    range(range),
+    neighbors(NULL),
+    distances(NULL),
+    offsets(&offsets),
+    flatNeighbors(&flatNeighbors),
+    flatDistances(&flatDistances),
     leafSize(leafSize)
 {}
 
 //! Default Bichromatic range search on the given RSType instance.
+template<typename MatType>
 template<template<typename TreeMetricType,
                   typename TreeStatType,
                   typename TreeMatType> class TreeType>
-void BiSearchVisitor::operator()(RSTypeT<TreeType>* rs) const
+void BiSearchVisitor<MatType>::operator()(RSTypeT<TreeType>* rs) const
 {
-  if (rs)
-    return rs->Search(querySet, range, neighbors, distances);
-  throw std::runtime_error("no range search model initialized");
+  if (!rs)
+    throw std::runtime_error("no range search model initialized");
+
+  if (offsets)
+    rs->Search(querySet, range, *offsets, *flatNeighbors, *flatDistances);
+  else
+    rs->Search(querySet, range, *neighbors, *distances);
 }
 
 //! Bichromatic range search on the given RSType specialized for KDTrees.
-inline void BiSearchVisitor::operator()(RSTypeT<tree::KDTree>* rs) const
+template<typename MatType>
+void BiSearchVisitor<MatType>::operator()(RSTypeT<tree::KDTree>* rs) const
 {
   if (rs)
     return SearchLeaf(rs);
@@ -304,7 +385,8 @@ inline void BiSearchVisitor::operator()(RSTypeT<tree::KDTree>* rs) const
 }
 
 //! Bichromatic range search on the given RSType specialized for BallTrees.
-inline void BiSearchVisitor::operator()(RSTypeT<tree::BallTree>* rs) const
+template<typename MatType>
+void BiSearchVisitor<MatType>::operator()(RSTypeT<tree::BallTree>* rs) const
 {
   if (rs)
     return SearchLeaf(rs);
@@ -312,7 +394,8 @@ inline void BiSearchVisitor::operator()(RSTypeT<tree::BallTree>* rs) const
 }
 
 //! Bichromatic range search specialized for Ocrees.
-inline void BiSearchVisitor::operator()(RSTypeT<tree::Octree>* rs) const
+template<typename MatType>
+void BiSearchVisitor<MatType>::operator()(RSTypeT<tree::Octree>* rs) const
 {
   if (rs)
     return SearchLeaf(rs);
@@ -320,8 +403,9 @@ inline void BiSearchVisitor::operator()(RSTypeT<tree::Octree>* rs) const
 }
 
 //! Bichromatic range search on the given RSType considering the leafSize.
+template<typename MatType>
 template<typename RSType>
-void BiSearchVisitor::SearchLeaf(RSType* rs) const
+void BiSearchVisitor<MatType>::SearchLeaf(RSType* rs) const
 {
   if (!rs->Naive() && !rs->SingleMode())
   {
@@ -334,35 +418,70 @@ void BiSearchVisitor::SearchLeaf(RSType* rs) const
     Log::Info << "Tree built." << std::endl;
     Timer::Stop("tree_building");
 
-    std::vector<std::vector<size_t>> neighborsOut;
-    std::vector<std::vector<double>> distancesOut;
-    rs->Search(&queryTree, range, neighborsOut, distancesOut);
-
-    // Remap the query points.
-    neighbors.resize(queryTree.Dataset().n_cols);
-    distances.resize(queryTree.Dataset().n_cols);
-    for (size_t i = 0; i < queryTree.Dataset().n_cols; ++i)
+    const size_t numQueries = queryTree.Dataset().n_cols;
+    if (offsets)
+    {
+      arma::Col<size_t> offsetsOut, neighborsOut;
+      arma::vec distancesOut;
+      rs->Search(&queryTree, range, offsetsOut, neighborsOut, distancesOut);
+
+      // Remap the query points: first compute the new offsets, then copy the
+      // results of each query point.
+      offsets->zeros(numQueries + 1);
+      for (size_t i = 0; i < numQueries; ++i)
+        (*offsets)[oldFromNewQueries[i] + 1] = offsetsOut[i + 1] -
+            offsetsOut[i];
+      for (size_t i = 1; i <= numQueries; ++i)
+        (*offsets)[i] += (*offsets)[i - 1];
+
+      flatNeighbors->set_size(neighborsOut.n_elem);
+      flatDistances->set_size(distancesOut.n_elem);
+      for (size_t i = 0; i < numQueries; ++i)
+      {
+        size_t position = (*offsets)[oldFromNewQueries[i]];
+        for (size_t j = offsetsOut[i]; j < offsetsOut[i + 1]; ++j, ++position)
+        {
+          (*flatNeighbors)[position] = neighborsOut[j];
+          (*flatDistances)[position] = distancesOut[j];
+        }
+      }
+    }
+    else
     {
-      neighbors[oldFromNewQueries[i]] = neighborsOut[i];
-      distances[oldFromNewQueries[i]] = distancesOut[i];
+      std::vector<std::vector<size_t>> neighborsOut;
+      std::vector<std::vector<double>> distancesOut;
+      rs->Search(&queryTree, range, neighborsOut, distancesOut);
+
+      // Remap the query points.
+      neighbors->resize(numQueries);
+      distances->resize(numQueries);
+      for (size_t i = 0; i < numQueries; ++i)
+      {
+        (*neighbors)[oldFromNewQueries[i]] = neighborsOut[i];
+        (*distances)[oldFromNewQueries[i]] = distancesOut[i];
+      }
     }
   }
+  else if (offsets)
+    rs->Search(querySet, range, *offsets, *flatNeighbors, *flatDistances);
   else
-    rs->Search(querySet, range, neighbors, distances);
+    rs->Search(querySet, range, *neighbors, *distances);
 }
 
 //! Save parameters for Train.
-inline TrainVisitor::TrainVisitor(arma::mat&& referenceSet,
-                                  const size_t leafSize) :
+template<typename MatType>
+TrainVisitor<MatType>::TrainVisitor(MatType&& referenceSet,
+                                    const size_t leafSize) :
     referenceSet(std::move(referenceSet)),
     leafSize(leafSize)
 {}
 
 //! Default Train on the given RSType instance.
+template<typename MatType>
 template<template<typename TreeMetricType,
                   typename TreeStatType,
                   typename TreeMatType> class TreeType>
-void TrainVisitor::operator()(RSTypeT<TreeType>* rs) const
+void TrainVisitor<MatType>::operator()(RSTypeT<TreeType>* rs) const
 {
   if (rs)
     return rs->Train(std::move(referenceSet));
@@ -370,7 +489,8 @@ void TrainVisitor::operator()(RSTypeT<TreeType>* rs) const
 }
 
 //! Train on the given RSType specialized for KDTrees.
-inline void TrainVisitor::operator()(RSTypeT<tree::KDTree>* rs) const
+template<typename MatType>
+void TrainVisitor<MatType>::operator()(RSTypeT<tree::KDTree>* rs) const
 {
   if (rs)
     return TrainLeaf(rs);
@@ -378,7 +498,8 @@ inline void TrainVisitor::operator()(RSTypeT<tree::KDTree>* rs) const
 }
 
 //! Train on the given RSType specialized for BallTrees.
-inline void TrainVisitor::operator()(RSTypeT<tree::BallTree>* rs) const
+template<typename MatType>
+void TrainVisitor<MatType>::operator()(RSTypeT<tree::BallTree>* rs) const
 {
   if (rs)
     return TrainLeaf(rs);
@@ -386,7 +507,8 @@ inline void TrainVisitor::operator()(RSTypeT<tree::BallTree>* rs) const
 }
 
 //! Train specialized for Octrees.
-inline void TrainVisitor::operator()(RSTypeT<tree::Octree>* rs) const
+template<typename MatType>
+void TrainVisitor<MatType>::operator()(RSTypeT<tree::Octree>* rs) const
 {
   if (rs)
     return TrainLeaf(rs);
@@ -394,8 +516,9 @@ inline void TrainVisitor::operator()(RSTypeT<tree::Octree>* rs) const
 }
 
 //! Train on the given RSType considering the leafSize.
+template<typename MatType>
 template<typename RSType>
-void TrainVisitor::TrainLeaf(RSType* rs) const
+void TrainVisitor<MatType>::TrainLeaf(RSType* rs) const
 {
   if (rs->Naive())
     rs->Train(std::move(referenceSet));
@@ -414,8 +537,9 @@ void TrainVisitor::TrainLeaf(RSType* rs) const
 }
 
 //! Expose the referenceSet of the given RSType.
+template<typename MatType>
 template<typename RSType>
-const arma::mat& ReferenceSetVisitor::operator()(RSType* rs) const
+const MatType& ReferenceSetVisitor<MatType>::operator()(RSType* rs) const
 {
   if (rs)
     return rs->ReferenceSet();
@@ -449,8 +573,10 @@ bool& NaiveVisitor::operator()(RSType* rs) const
 }
 
 // Serialize the model.
+template<typename MatType>
 template<typename Archive>
-void RSModel::serialize(Archive& ar, const unsigned int /* version */)
+void RSModelType<MatType>::serialize(Archive& ar,
+                                     const unsigned int /* version */)
 {
   ar & BOOST_SERIALIZATION_NVP(treeType);
   ar & BOOST_SERIALIZATION_NVP(randomBasis);
@@ -464,27 +590,32 @@ void RSModel::serialize(Archive& ar, const unsigned int /* version */)
   ar & BOOST_SERIALIZATION_NVP(rSearch);
 }
 
-inline const arma::mat& RSModel::Dataset() const
+template<typename MatType>
+const MatType& RSModelType<MatType>::Dataset() const
 {
-  return boost::apply_visitor(ReferenceSetVisitor(), rSearch);
+  return boost::apply_visitor(ReferenceSetVisitor<MatType>(), rSearch);
 }
 
-inline bool RSModel::SingleMode() const
+template<typename MatType>
+bool RSModelType<MatType>::SingleMode() const
 {
   return boost::apply_visitor(SingleModeVisitor(), rSearch);
 }
 
-inline bool& RSModel::SingleMode()
+template<typename MatType>
+bool& RSModelType<MatType>::SingleMode()
 {
   return boost::apply_visitor(SingleModeVisitor(), rSearch);
 }
 
-inline bool RSModel::Naive() const
+template<typename MatType>
+bool RSModelType<MatType>::Naive() const
 {
   return boost::apply_visitor(NaiveVisitor(), rSearch);
 }
 
-inline bool& RSModel::Naive()
+template<typename MatType>
+bool& RSModelType<MatType>::Naive()
 {
   return boost::apply_visitor(NaiveVisitor(), rSearch);
 }
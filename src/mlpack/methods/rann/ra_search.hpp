@@ -393,6 +393,31 @@ class RASearch
   //! Instantiation of kernel.
   MetricType metric;
 
+  /**
+   * Run a single-tree traversal for each of the given number of query points.
+   * The queries are traversed in parallel when OpenMP is available.  Each
+   * query samples points with its own random stream, keyed by the index of
+   * the query and by a seed drawn from the global random number generator for
+   * each search, so the results don't depend on the number of threads and
+   * every search draws new samples.
+   *
+   * @param rules Rules to traverse with.
+   * @param numQueries Number of query points.
+   */
+  template<typename RuleType>
+  void SingleTreeTraverse(RuleType& rules, const size_t numQueries);
+
+  /**
+   * Run a dual-tree traversal of the given query tree against the reference
+   * tree.  When OpenMP is available, the query tree is split into disjoint
+   * subtrees that are traversed in parallel, each with its own random stream.
+   *
+   * @param rules Rules to traverse with.
+   * @param queryTree Query tree to traverse.
+   */
+  template<typename RuleType>
+  void DualTreeTraverse(RuleType& rules, Tree& queryTree);
+
   //! For access to mappings when building models.
   template<typename SortPol>
   friend class TrainVisitor;
@@ -16,6 +16,11 @@
 #include <mlpack/prereqs.hpp>
 
 #include "ra_search_rules.hpp"
+#include <mlpack/core/tree/subtree_frontier.hpp>
+
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
 
 namespace mlpack {
 namespace neighbor {
@@ -323,12 +328,7 @@ Search(const MatType& querySet,
     {
       Log::Info << "Performing single-tree traversal..." << std::endl;
 
-      // Create the traverser.
-      typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
-
-      // Now have it traverse for each point.
-      for (size_t i = 0; i < querySet.n_cols; ++i)
-        traverser.Traverse(i, *referenceTree);
+      SingleTreeTraverse(rules, querySet.n_cols);
 
       Log::Info << "Single-tree traversal complete." << std::endl;
       Log::Info << "Average number of distance calculations per query point: "
@@ -352,12 +352,10 @@ Search(const MatType& querySet,
 
     RuleType rules(*referenceSet, queryTree->Dataset(), k, metric, tau, alpha,
         naive, sampleAtLeaves, firstLeafExact, singleSampleLimit, false);
-    typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
-
     Log::Info << "Query statistic pre-search: "
         << queryTree->Stat().NumSamplesMade() << std::endl;
 
-    traverser.Traverse(*queryTree, *referenceTree);
+    DualTreeTraverse(rules, *queryTree);
 
     Log::Info << "Dual-tree traversal complete." << std::endl;
     Log::Info << "Average number of distance calculations per query point: "
@@ -466,9 +464,7 @@ void RASearch<SortPolicy, MetricType, MatType, TreeType>::Search(
   RuleType rules(*referenceSet, queryTree->Dataset(), k, metric, tau, alpha,
       naive, sampleAtLeaves, firstLeafExact, singleSampleLimit, false);
 
-  // Create the traverser.
-  typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
-  traverser.Traverse(*queryTree, *referenceTree);
+  DualTreeTraverse(rules, *queryTree);
 
   rules.GetResults(*neighborPtr, distances);
 
@@ -539,19 +535,11 @@ void RASearch<SortPolicy, MetricType, MatType, TreeType>::Search(
   }
   else if (singleMode)
   {
-    // Create the traverser.
-    typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
-
-    // Now have it traverse for each point.
-    for (size_t i = 0; i < referenceSet->n_cols; ++i)
-      traverser.Traverse(i, *referenceTree);
+    SingleTreeTraverse(rules, referenceSet->n_cols);
   }
   else
   {
-    // Create the traverser.
-    typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
-
-    traverser.Traverse(*referenceTree, *referenceTree);
+    DualTreeTraverse(rules, *referenceTree);
   }
 
   rules.GetResults(*neighborPtr, *distancePtr);
@@ -673,6 +661,101 @@ void RASearch<SortPolicy, MetricType, MatType, TreeType>::serialize(
   }
 }
 
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+template<typename RuleType>
+void RASearch<SortPolicy, MetricType, MatType, TreeType>::SingleTreeTraverse(
+    RuleType& rules,
+    const size_t numQueries)
+{
+  // The rules only write to the candidate list and the number of samples of
+  // the query being traversed, so the queries can be traversed at once.
+  size_t numDistComputations = 0;
+  const uint64_t searchSeed = math::RandInt(std::numeric_limits<int>::max());
+
+  #pragma omp parallel reduction(+:numDistComputations)
+  {
+    // This rules object writes its results into the candidate lists of the
+    // given rules object.
+    RuleType threadRules(&rules);
+    typename Tree::template SingleTreeTraverser<RuleType> traverser(
+        threadRules);
+
+    #pragma omp for schedule(dynamic, 16)
+    for (omp_size_t i = 0; i < (omp_size_t) numQueries; ++i)
+    {
+      // The samples of each query only depend on the seed of the search and
+      // the index of the query.
+      math::RandomStream stream(searchSeed, i);
+      threadRules.Stream() = &stream;
+      traverser.Traverse(i, *referenceTree);
+    }
+
+    threadRules.Stream() = NULL;
+    numDistComputations += threadRules.NumDistComputations();
+  }
+
+  rules.NumDistComputations() += numDistComputations;
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+template<typename RuleType>
+void RASearch<SortPolicy, MetricType, MatType, TreeType>::DualTreeTraverse(
+    RuleType& rules,
+    Tree& queryTree)
+{
+#ifdef HAS_OPENMP
+  const size_t numThreads = omp_get_max_threads();
+  if (numThreads > 1)
+  {
+    // Split the query tree into disjoint subtrees.  The rules only write to the
+    // statistics of the query nodes and to the candidate lists and numbers of
+    // samples of the query points, so each subtree can be traversed against
+    // the reference tree independently.  Every query point still makes at
+    // least the required number of samples, so the rank-approximation
+    // guarantee holds.
+    std::vector<Tree*> frontier;
+    tree::SubtreeFrontier(queryTree, 4 * numThreads, frontier);
+
+    size_t numDistComputations = 0;
+    const uint64_t searchSeed = math::RandInt(
+        std::numeric_limits<int>::max());
+
+    #pragma omp parallel for schedule(dynamic) \
+        reduction(+:numDistComputations)
+    for (omp_size_t i = 0; i < (omp_size_t) frontier.size(); ++i)
+    {
+      math::RandomStream stream(searchSeed, i);
+
+      // This rules object writes its results into the candidate lists of the
+      // given rules object.
+      RuleType threadRules(&rules);
+      threadRules.Stream() = &stream;
+      typename Tree::template DualTreeTraverser<RuleType> traverser(
+          threadRules);
+      traverser.Traverse(*frontier[i], *referenceTree);
+
+      numDistComputations += threadRules.NumDistComputations();
+    }
+
+    rules.NumDistComputations() += numDistComputations;
+    return;
+  }
+#endif
+
+  typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
+  traverser.Traverse(queryTree, *referenceTree);
+}
+
 } // namespace neighbor
 } // namespace mlpack
 
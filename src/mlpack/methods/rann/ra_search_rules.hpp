@@ -15,6 +15,7 @@
 #define MLPACK_METHODS_RANN_RA_SEARCH_RULES_HPP
 
 #include <mlpack/core/tree/traversal_info.hpp>
+#include <mlpack/core/math/random_stream.hpp>
 
 #include <queue>
 
@@ -66,6 +67,18 @@ class RASearchRules
                 const size_t singleSampleLimit = 20,
                 const bool sameSet = false);
 
+  /**
+   * Construct a rules object that shares the candidate lists and the numbers of
+   * samples made of the given rules object, but has its own statistics,
+   * traversal information and random stream.  This is used for parallel
+   * traversals, where each thread must hold its own rules object.  The caller
+   * must ensure that no query point is visited by more than one thread at a
+   * time, and that the given rules object outlives this one.
+   *
+   * @param other Rules object whose candidate lists will be shared.
+   */
+  RASearchRules(RASearchRules* other);
+
   /**
    * Store the list of candidates for each query point in the given matrices.
    *
@@ -227,7 +240,10 @@ class RASearchRules
                  const double oldScore);
 
 
-  size_t NumDistComputations() { return numDistComputations; }
+  //! Get the number of distance calculations performed.
+  size_t NumDistComputations() const { return numDistComputations; }
+  //! Modify the number of distance calculations performed.
+  size_t& NumDistComputations() { return numDistComputations; }
   size_t NumEffectiveSamples()
   {
     if (numSamplesMade.n_elem == 0)
@@ -241,6 +257,14 @@ class RASearchRules
   const TraversalInfoType& TraversalInfo() const { return traversalInfo; }
   TraversalInfoType& TraversalInfo() { return traversalInfo; }
 
+  /**
+   * Get the random stream that points are sampled with.  If it is NULL (the
+   * default), the global random number generator is used.
+   */
+  math::RandomStream* Stream() const { return stream; }
+  //! Modify the random stream that points are sampled with.
+  math::RandomStream*& Stream() { return stream; }
+
  private:
   //! The reference set.
   const arma::mat& referenceSet;
@@ -263,8 +287,13 @@ class RASearchRules
   typedef std::priority_queue<Candidate, std::vector<Candidate>, CandidateCmp>
       CandidateList;
 
-  //! Set of candidate neighbors for each point.
-  std::vector<CandidateList> candidates;
+  //! Storage of the candidate neighbors for each point, if this rules object
+  //! owns them.
+  std::vector<CandidateList> candidateStorage;
+
+  //! Set of candidate neighbors for each point.  This points either to
+  //! candidateStorage or to the storage of another rules object.
+  CandidateList* candidates;
 
   //! Number of neighbors to search for.
   const size_t k;
@@ -298,6 +327,25 @@ class RASearchRules
 
   TraversalInfoType traversalInfo;
 
+  //! The random stream to sample points with, or NULL for the global random
+  //! number generator.
+  math::RandomStream* stream;
+
+  /**
+   * Obtain no more than numSamples distinct samples in [0, hiExclusive), with
+   * the random stream if there is one.
+   */
+  void ObtainDistinctSamples(const size_t hiExclusive,
+                             const size_t numSamples,
+                             arma::uvec& distinctSamples)
+  {
+    if (stream)
+      stream->ObtainDistinctSamples(0, hiExclusive, numSamples,
+          distinctSamples);
+    else
+      math::ObtainDistinctSamples(0, hiExclusive, numSamples, distinctSamples);
+  }
+
   /**
    * Helper function to insert a point into the list of candidate points.
    *
@@ -38,7 +38,8 @@ RASearchRules(const arma::mat& referenceSet,
     sampleAtLeaves(sampleAtLeaves),
     firstLeafExact(firstLeafExact),
     singleSampleLimit(singleSampleLimit),
-    sameSet(sameSet)
+    sameSet(sameSet),
+    stream(NULL)
 {
   // Validate tau to make sure that the rank approximation is greater than the
   // number of neighbors requested.
@@ -80,9 +81,11 @@ RASearchRules(const arma::mat& referenceSet,
   std::vector<Candidate> vect(k, def);
   CandidateList pqueue(CandidateCmp(), std::move(vect));
 
-  candidates.reserve(querySet.n_cols);
+  candidateStorage.reserve(querySet.n_cols);
   for (size_t i = 0; i < querySet.n_cols; i++)
-    candidates.push_back(pqueue);
+    candidateStorage.push_back(pqueue);
+
+  candidates = candidateStorage.data();
 
   if (naive) // No tree traversal; just do naive sampling here.
   {
@@ -90,13 +93,35 @@ RASearchRules(const arma::mat& referenceSet,
     arma::uvec distinctSamples;
     for (size_t i = 0; i < querySet.n_cols; ++i)
     {
-      math::ObtainDistinctSamples(0, n, numSamplesReqd, distinctSamples);
+      ObtainDistinctSamples(n, numSamplesReqd, distinctSamples);
       for (size_t j = 0; j < distinctSamples.n_elem; j++)
         BaseCase(i, (size_t) distinctSamples[j]);
     }
   }
 }
 
+template<typename SortPolicy, typename MetricType, typename TreeType>
+RASearchRules<SortPolicy, MetricType, TreeType>::RASearchRules(
+    RASearchRules* other) :
+    referenceSet(other->referenceSet),
+    querySet(other->querySet),
+    candidates(other->candidates),
+    k(other->k),
+    metric(other->metric),
+    sampleAtLeaves(other->sampleAtLeaves),
+    firstLeafExact(other->firstLeafExact),
+    singleSampleLimit(other->singleSampleLimit),
+    numSamplesReqd(other->numSamplesReqd),
+    numSamplesMade(other->numSamplesMade.memptr(),
+        other->numSamplesMade.n_elem, false, true),
+    samplingRatio(other->samplingRatio),
+    numDistComputations(0),
+    sameSet(other->sameSet),
+    stream(NULL)
+{
+  // Nothing to do.
+}
+
 template<typename SortPolicy, typename MetricType, typename TreeType>
 void RASearchRules<SortPolicy, MetricType, TreeType>::GetResults(
     arma::Mat<size_t>& neighbors,
@@ -204,7 +229,7 @@ inline double RASearchRules<SortPolicy, MetricType, TreeType>::Score(
           // Then samplesReqd <= singleSampleLimit.
           // Hence, approximate the node by sampling enough number of points.
           arma::uvec distinctSamples;
-          math::ObtainDistinctSamples(0, referenceNode.NumDescendants(),
+          ObtainDistinctSamples(referenceNode.NumDescendants(),
               samplesReqd, distinctSamples);
           for (size_t i = 0; i < distinctSamples.n_elem; i++)
             // The counting of the samples are done in the 'BaseCase' function
@@ -220,7 +245,7 @@ inline double RASearchRules<SortPolicy, MetricType, TreeType>::Score(
           {
             // Approximate node by sampling enough number of points.
             arma::uvec distinctSamples;
-            math::ObtainDistinctSamples(0, referenceNode.NumDescendants(),
+            ObtainDistinctSamples(referenceNode.NumDescendants(),
                 samplesReqd, distinctSamples);
             for (size_t i = 0; i < distinctSamples.n_elem; i++)
               // The counting of the samples are done in the 'BaseCase' function
@@ -308,7 +333,7 @@ Rescore(const size_t queryIndex,
         // Then, samplesReqd <= singleSampleLimit.  Hence, approximate the node
         // by sampling enough number of points.
         arma::uvec distinctSamples;
-        math::ObtainDistinctSamples(0, referenceNode.NumDescendants(),
+        ObtainDistinctSamples(referenceNode.NumDescendants(),
             samplesReqd, distinctSamples);
         for (size_t i = 0; i < distinctSamples.n_elem; i++)
           // The counting of the samples are done in the 'BaseCase' function so
@@ -324,7 +349,7 @@ Rescore(const size_t queryIndex,
         {
           // Approximate node by sampling enough points.
           arma::uvec distinctSamples;
-          math::ObtainDistinctSamples(0, referenceNode.NumDescendants(),
+          ObtainDistinctSamples(referenceNode.NumDescendants(),
               samplesReqd, distinctSamples);
           for (size_t i = 0; i < distinctSamples.n_elem; i++)
             // The counting of the samples are done in the 'BaseCase' function
@@ -511,7 +536,7 @@ inline double RASearchRules<SortPolicy, MetricType, TreeType>::Score(
           for (size_t i = 0; i < queryNode.NumDescendants(); ++i)
           {
             const size_t queryIndex = queryNode.Descendant(i);
-            math::ObtainDistinctSamples(0, referenceNode.NumDescendants(),
+            ObtainDistinctSamples(referenceNode.NumDescendants(),
                 samplesReqd, distinctSamples);
             for (size_t j = 0; j < distinctSamples.n_elem; j++)
               // The counting of the samples are done in the 'BaseCase' function
@@ -541,7 +566,7 @@ inline double RASearchRules<SortPolicy, MetricType, TreeType>::Score(
             for (size_t i = 0; i < queryNode.NumDescendants(); ++i)
             {
               const size_t queryIndex = queryNode.Descendant(i);
-              math::ObtainDistinctSamples(0, referenceNode.NumDescendants(),
+              ObtainDistinctSamples(referenceNode.NumDescendants(),
                   samplesReqd, distinctSamples);
               for (size_t j = 0; j < distinctSamples.n_elem; j++)
                 // The counting of the samples are done in the 'BaseCase'
@@ -716,7 +741,7 @@ Rescore(TreeType& queryNode,
         for (size_t i = 0; i < queryNode.NumDescendants(); ++i)
         {
           const size_t queryIndex = queryNode.Descendant(i);
-          math::ObtainDistinctSamples(0, referenceNode.NumDescendants(),
+          ObtainDistinctSamples(referenceNode.NumDescendants(),
               samplesReqd, distinctSamples);
           for (size_t j = 0; j < distinctSamples.n_elem; j++)
             // The counting of the samples are done in the 'BaseCase'
@@ -745,7 +770,7 @@ Rescore(TreeType& queryNode,
           for (size_t i = 0; i < queryNode.NumDescendants(); ++i)
           {
             const size_t queryIndex = queryNode.Descendant(i);
-            math::ObtainDistinctSamples(0, referenceNode.NumDescendants(),
+            ObtainDistinctSamples(referenceNode.NumDescendants(),
                 samplesReqd, distinctSamples);
             for (size_t j = 0; j < distinctSamples.n_elem; j++)
               // The counting of the samples are done in BaseCase() so no
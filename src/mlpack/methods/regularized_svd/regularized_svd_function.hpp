@@ -149,6 +149,8 @@ namespace ens {
       mlpack::svd::RegularizedSVDFunction<arma::mat>& function,
       arma::mat& parameters);
 
+  // The parallel SGD specialization is Hogwild!: the threads take blocks of
+  // threadShareSize shuffled ratings and update the parameters without locks.
   template <>
   template <>
   inline double ParallelSGD<ExponentialBackoff>::Optimize(
@@ -68,7 +68,10 @@ void AsyncLearning<
   NetworkType learningNetwork = std::move(this->learningNetwork);
   if (learningNetwork.Parameters().is_empty())
     learningNetwork.ResetParameters();
-  NetworkType targetNetwork = learningNetwork;
+  // The workers update the parameters of the learning network without locks
+  // (Hogwild!), and read the target network from snapshots that are swapped
+  // atomically, so no worker waits for another one.
+  NetworkSnapshot<NetworkType> targetNetwork(learningNetwork);
   size_t totalSteps = 0;
   PolicyType policy = this->policy;
   bool stop = false;
@@ -0,0 +1,134 @@
+/**
+ * @file methods/reinforcement_learning/environment/vector_environment.hpp
+ *
+ * Wrapper that steps several copies of an RL environment in lockstep.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RL_ENVIRONMENT_VECTOR_ENVIRONMENT_HPP
+#define MLPACK_METHODS_RL_ENVIRONMENT_VECTOR_ENVIRONMENT_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace rl {
+
+/**
+ * Hold several independent copies of an environment, each with its own state,
+ * so that they can be stepped in lockstep.  The states of any subset of the
+ * copies can be encoded into the columns of one matrix, so that the network
+ * evaluates all of them with a single forward pass (a matrix product per
+ * layer) instead of one forward pass per state.
+ *
+ * @tparam EnvironmentType The type of the environment to copy.
+ */
+template<typename EnvironmentType>
+class VectorEnvironment
+{
+ public:
+  //! Convenient typedef for state.
+  using State = typename EnvironmentType::State;
+
+  //! Convenient typedef for action.
+  using Action = typename EnvironmentType::Action;
+
+  /**
+   * Create the given number of copies of the environment.
+   *
+   * @param environment The environment to copy.
+   * @param numEnvironments The number of copies.
+   */
+  VectorEnvironment(const EnvironmentType& environment,
+                    const size_t numEnvironments) :
+      environments(numEnvironments, environment),
+      states(numEnvironments)
+  {
+    if (numEnvironments == 0)
+    {
+      throw std::invalid_argument("VectorEnvironment: the number of "
+          "environments must be positive");
+    }
+  }
+
+  //! Get the initial state of every copy.
+  void InitialSample()
+  {
+    for (size_t i = 0; i < environments.size(); ++i)
+      states[i] = environments[i].InitialSample();
+  }
+
+  /**
+   * Encode the states of the given copies into the columns of a matrix.
+   *
+   * @param indices Indices of the copies to encode the states of.
+   * @param encoded Matrix to store the encoded states in, one per column.
+   */
+  void Encode(const std::vector<size_t>& indices, arma::mat& encoded) const
+  {
+    if (indices.empty())
+    {
+      encoded.reset();
+      return;
+    }
+
+    const arma::colvec& first = states[indices[0]].Encode();
+    encoded.set_size(first.n_elem, indices.size());
+    for (size_t j = 0; j < indices.size(); ++j)
+      encoded.col(j) = states[indices[j]].Encode();
+  }
+
+  /**
+   * Take the given action in the given copy, from its current state.  The
+   * current state of the copy is not changed, so that the transition can be
+   * stored before the copy moves on with SetState().
+   *
+   * @param i Index of the copy.
+   * @param action Action to take.
+   * @param nextState Next state of the copy.
+   * @return The reward of the transition.
+   */
+  double Sample(const size_t i, const Action& action, State& nextState)
+  {
+    return environments[i].Sample(states[i], action, nextState);
+  }
+
+  //! Get whether the given state is terminal for the given copy.
+  bool IsTerminal(const size_t i, const State& state) const
+  {
+    return environments[i].IsTerminal(state);
+  }
+
+  //! Get whether the current state of the given copy is terminal.
+  bool IsTerminal(const size_t i) const
+  {
+    return environments[i].IsTerminal(states[i]);
+  }
+
+  //! Get the number of copies.
+  size_t NumEnvironments() const { return environments.size(); }
+
+  //! Get the current state of the given copy.
+  const State& GetState(const size_t i) const { return states[i]; }
+  //! Set the current state of the given copy.
+  void SetState(const size_t i, const State& state) { states[i] = state; }
+
+  //! Get the given copy of the environment.
+  const EnvironmentType& Environment(const size_t i) const
+  { return environments[i]; }
+  //! Modify the given copy of the environment.
+  EnvironmentType& Environment(const size_t i) { return environments[i]; }
+
+ private:
+  //! The copies of the environment.
+  std::vector<EnvironmentType> environments;
+  //! The current state of each copy.
+  std::vector<State> states;
+};
+
+} // namespace rl
+} // namespace mlpack
+
+#endif
@@ -15,6 +15,7 @@
 
 #include <mlpack/prereqs.hpp>
 
+#include "environment/vector_environment.hpp"
 #include "replay/random_replay.hpp"
 #include "replay/prioritized_replay.hpp"
 #include "training_config.hpp"
@@ -101,6 +102,20 @@ class QLearning
    */
   double Episode();
 
+  /**
+   * Execute an episode in each of the given number of copies of the
+   * environment, stepping the copies in lockstep.  At each step, the states of
+   * the copies that haven't finished yet are evaluated by the learning
+   * network in a single batch, instead of one state at a time.  Every
+   * transition is stored and counted as a step, and triggers a learning
+   * update, exactly as in Episode().  The environment given to the
+   * constructor is copied, so its own state is not used or changed.
+   *
+   * @param numEnvironments Number of copies of the environment.
+   * @return Return of the episode of each copy.
+   */
+  arma::vec Episodes(const size_t numEnvironments);
+
   /**
    * @return Total steps from beginning.
    */
@@ -137,6 +152,18 @@ class QLearning
    */
   arma::Col<size_t> BestAction(const arma::mat& actionValues);
 
+  /**
+   * Learn from a batch of transitions sampled from the experience replay.
+   */
+  void TrainAgent();
+
+  /**
+   * Count a step taken in training mode: learn from the experience replay
+   * once enough steps have been taken, sync the target network and anneal
+   * the policy.
+   */
+  void FinishStep();
+
   //! Locally-stored hyper-parameters.
   TrainingConfig config;
 
@@ -172,6 +199,21 @@ class QLearning
 
   //! Locally-stored flag indicating training mode or test mode.
   bool deterministic;
+
+  //! Buffer for the encoded states sampled from the experience replay.
+  arma::mat sampledStates;
+
+  //! Buffer for the actions sampled from the experience replay.
+  arma::icolvec sampledActions;
+
+  //! Buffer for the rewards sampled from the experience replay.
+  arma::colvec sampledRewards;
+
+  //! Buffer for the encoded next states sampled from the experience replay.
+  arma::mat sampledNextStates;
+
+  //! Buffer for the termination flags sampled from the experience replay.
+  arma::icolvec isTerminal;
 };
 
 } // namespace rl
@@ -147,15 +147,29 @@ double QLearning<
   if (deterministic || totalSteps < config.ExplorationSteps())
     return reward;
 
-  // Start experience replay.
+  TrainAgent();
 
-  // Sample from previous experience.
-  arma::mat sampledStates;
-  arma::icolvec sampledActions;
-  arma::colvec sampledRewards;
-  arma::mat sampledNextStates;
-  arma::icolvec isTerminal;
+  return reward;
+}
+
+template <
+  typename EnvironmentType,
+  typename NetworkType,
+  typename UpdaterType,
+  typename BehaviorPolicyType,
+  typename ReplayType
+>
+void QLearning<
+  EnvironmentType,
+  NetworkType,
+  UpdaterType,
+  BehaviorPolicyType,
+  ReplayType
+>::TrainAgent()
+{
+  // Start experience replay.
 
+  // Sample from previous experience, into the same buffers at every step.
   replayMethod.Sample(sampledStates, sampledActions, sampledRewards,
       sampledNextStates, isTerminal);
 
@@ -210,8 +224,31 @@ double QLearning<
   updatePolicy->Update(learningNetwork.Parameters(), config.StepSize(),
       gradients);
   #endif
+}
 
-  return reward;
+template <
+  typename EnvironmentType,
+  typename NetworkType,
+  typename UpdaterType,
+  typename BehaviorPolicyType,
+  typename ReplayType
+>
+void QLearning<
+  EnvironmentType,
+  NetworkType,
+  UpdaterType,
+  BehaviorPolicyType,
+  ReplayType
+>::FinishStep()
+{
+  totalSteps++;
+
+  // Update target network
+  if (totalSteps % config.TargetNetworkSyncInterval() == 0)
+    targetNetwork = learningNetwork;
+
+  if (totalSteps > config.ExplorationSteps())
+    policy.Anneal();
 }
 
 template <
@@ -250,17 +287,89 @@ double QLearning<
     if (deterministic)
       continue;
 
-    totalSteps++;
+    FinishStep();
+  }
 
-    // Update target network
-    if (totalSteps % config.TargetNetworkSyncInterval() == 0)
-      targetNetwork = learningNetwork;
+  return totalReturn;
+}
+
+template <
+  typename EnvironmentType,
+  typename NetworkType,
+  typename UpdaterType,
+  typename BehaviorPolicyType,
+  typename ReplayType
+>
+arma::vec QLearning<
+  EnvironmentType,
+  NetworkType,
+  UpdaterType,
+  BehaviorPolicyType,
+  ReplayType
+>::Episodes(const size_t numEnvironments)
+{
+  VectorEnvironment<EnvironmentType> environments(environment,
+      numEnvironments);
+  environments.InitialSample();
+
+  std::vector<size_t> steps(numEnvironments, 0);
+  arma::vec totalReturns(numEnvironments, arma::fill::zeros);
+
+  std::vector<size_t> active(numEnvironments);
+  for (size_t i = 0; i < numEnvironments; ++i)
+    active[i] = i;
 
-    if (totalSteps > config.ExplorationSteps())
-      policy.Anneal();
+  arma::mat states, actionValues;
+  while (true)
+  {
+    // Drop the copies that have reached a terminal state or the step limit.
+    size_t numActive = 0;
+    for (size_t j = 0; j < active.size(); ++j)
+    {
+      const size_t i = active[j];
+      if (!environments.IsTerminal(i) &&
+          !(config.StepLimit() && steps[i] >= config.StepLimit()))
+        active[numActive++] = i;
+    }
+    active.resize(numActive);
+
+    if (active.empty())
+      break;
+
+    // Get the action values of all the active copies with one forward pass.
+    environments.Encode(active, states);
+    learningNetwork.Predict(states, actionValues);
+
+    for (size_t j = 0; j < active.size(); ++j)
+    {
+      const size_t i = active[j];
+
+      // Select an action according to the behavior policy.
+      action = policy.Sample(actionValues.unsafe_col(j), deterministic);
+
+      // Interact with the environment to advance to next state.
+      StateType nextState;
+      const double reward = environments.Sample(i, action, nextState);
+
+      // Store the transition for replay.
+      replayMethod.Store(environments.GetState(i), action, reward, nextState,
+          environments.IsTerminal(i, nextState));
+
+      environments.SetState(i, nextState);
+      totalReturns[i] += reward;
+      steps[i]++;
+
+      if (deterministic)
+        continue;
+
+      if (totalSteps >= config.ExplorationSteps())
+        TrainAgent();
+
+      FinishStep();
+    }
   }
 
-  return totalReturn;
+  return totalReturns;
 }
 
 } // namespace rl
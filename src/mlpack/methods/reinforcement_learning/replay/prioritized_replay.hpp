@@ -125,19 +125,34 @@ class PrioritizedReplay
    */
   arma::ucolvec SampleProportional()
   {
-    arma::ucolvec idxes(batchSize);
+    arma::ucolvec idxes;
+    SampleProportional(idxes);
+    return idxes;
+  }
+
+  /**
+   * Sample some experience according to their priorities, and store the
+   * chosen indices in the given vector.  The masses of the whole batch
+   * descend the sum tree together (see SumTree::FindPrefixSums()), and the
+   * given vector is only reallocated if it doesn't have batchSize elements.
+   *
+   * @param idxes Vector to store the chosen indices in.
+   */
+  void SampleProportional(arma::ucolvec& idxes)
+  {
     double totalSum = idxSum.Sum(0, (full ? capacity : position));
     double sumPerRange = totalSum / batchSize;
+    masses.set_size(batchSize);
     for (size_t bt = 0; bt < batchSize; bt++)
-    {
-      const double mass = arma::randu() * sumPerRange + bt * sumPerRange;
-      idxes(bt) = idxSum.FindPrefixSum(mass);
-    }
-    return idxes;
+      masses(bt) = arma::randu() * sumPerRange + bt * sumPerRange;
+
+    idxSum.FindPrefixSums(masses, idxes, remainingMasses);
   }
 
   /**
-   * Sample some experience according to their priorities.
+   * Sample some experience according to their priorities.  The given
+   * matrices are only reallocated if their sizes differ from the size of the
+   * batch, so passing the same buffers at every call avoids any allocation.
    *
    * @param sampledStates Sampled encoded states.
    * @param sampledActions Sampled actions.
@@ -152,7 +167,7 @@ class PrioritizedReplay
               arma::mat& sampledNextStates,
               arma::icolvec& isTerminal)
   {
-    sampledIndices = SampleProportional();
+    SampleProportional(sampledIndices);
     BetaAnneal();
 
     sampledStates = states.cols(sampledIndices);
@@ -164,11 +179,12 @@ class PrioritizedReplay
     // Calculate the weights of sampled transitions.
 
     size_t numSample = full ? capacity : position;
-    weights = arma::rowvec(sampledIndices.n_rows);
+    const double totalSum = idxSum.Sum();
+    weights.set_size(sampledIndices.n_rows);
 
     for (size_t i = 0; i < sampledIndices.n_rows; i++)
     {
-      double p_sample = idxSum.Get(sampledIndices(i)) / idxSum.Sum();
+      double p_sample = idxSum.Get(sampledIndices(i)) / totalSum;
       weights(i) = pow(numSample * p_sample, -beta);
     }
     weights /= weights.max();
@@ -284,6 +300,12 @@ class PrioritizedReplay
 
   //! Locally-stored the weights of sampled transitions.
   arma::rowvec weights;
+
+  //! Locally-stored the masses drawn for the last sample.
+  arma::colvec masses;
+
+  //! Workspace for the descent of the masses in the sum tree.
+  arma::colvec remainingMasses;
 };
 
 } // namespace rl
@@ -106,7 +106,9 @@ class RandomReplay
   }
 
   /**
-   * Sample some experiences.
+   * Sample some experiences.  The given matrices are only reallocated if
+   * their sizes differ from the size of the batch, so passing the same
+   * buffers at every call avoids any allocation.
    *
    * @param sampledStates Sampled encoded states.
    * @param sampledActions Sampled actions.
@@ -122,8 +124,12 @@ class RandomReplay
               arma::icolvec& isTerminal)
   {
     size_t upperBound = full ? capacity : position;
-    arma::uvec sampledIndices = arma::randi<arma::uvec>(
-        batchSize, arma::distr_param(0, upperBound - 1));
+    sampledIndices.set_size(batchSize);
+    for (size_t i = 0; i < batchSize; ++i)
+    {
+      sampledIndices[i] = std::min((size_t) (arma::randu() * upperBound),
+          upperBound - 1);
+    }
 
     sampledStates = states.cols(sampledIndices);
     sampledActions = actions.elem(sampledIndices);
@@ -185,6 +191,9 @@ class RandomReplay
 
   //! Locally-stored indicator that whether the memory is full or not
   bool full;
+
+  //! Locally-stored the indices of the last sample.
+  arma::uvec sampledIndices;
 };
 
 } // namespace rl
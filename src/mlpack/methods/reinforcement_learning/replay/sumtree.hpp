@@ -178,6 +178,52 @@ class SumTree
     return idx - capacity;
   }
 
+  /**
+   * Find the prefix sum index (as in FindPrefixSum()) of each of the given
+   * masses.  All the masses descend the tree together, one level at a time,
+   * so the upper levels of the tree, which every descent visits, stay in
+   * cache.
+   *
+   * @param masses The upper bounds of the segment array sums.
+   * @param indices Vector to store the indices in; it is only reallocated if
+   *     its size differs from the number of masses.
+   * @param remaining Workspace for the remaining masses; it is only
+   *     reallocated if its size differs from the number of masses.
+   */
+  void FindPrefixSums(const arma::Col<T>& masses,
+                      arma::ucolvec& indices,
+                      arma::Col<T>& remaining)
+  {
+    indices.set_size(masses.n_elem);
+    indices.fill(1);
+    remaining = masses;
+
+    bool descending = (capacity > 1);
+    while (descending)
+    {
+      descending = false;
+      for (size_t i = 0; i < indices.n_elem; ++i)
+      {
+        const size_t idx = indices[i];
+        if (idx >= capacity)
+          continue;
+
+        if (element[2 * idx] > remaining[i])
+        {
+          indices[i] = 2 * idx;
+        }
+        else
+        {
+          remaining[i] -= element[2 * idx];
+          indices[i] = 2 * idx + 1;
+        }
+        descending = true;
+      }
+    }
+
+    indices -= capacity;
+  }
+
  private:
   //! The capacity of the data array.
   size_t capacity;
@@ -127,7 +127,7 @@ class NStepQLearningWorker : public WorkerBase<
    * The agent will execute one step.
    *
    * @param learningNetwork The shared learning network.
-   * @param targetNetwork The shared target network.
+   * @param sharedTarget The shared snapshot of the target network.
    * @param totalSteps The shared counter for total steps.
    * @param policy The shared behavior policy.
    * @param totalReward This will be the episode return if the episode ends
@@ -135,7 +135,7 @@ class NStepQLearningWorker : public WorkerBase<
    * @return Indicate whether current episode ends after this step.
    */
   bool Step(NetworkType& learningNetwork,
-            NetworkType& targetNetwork,
+            NetworkSnapshot<NetworkType>& sharedTarget,
             size_t& totalSteps,
             PolicyType& policy,
             double& totalReward) override
@@ -181,6 +181,9 @@ class NStepQLearningWorker : public WorkerBase<
 
     if (terminal || this->pendingIndex >= this->config.UpdateInterval())
     {
+      // Pick up the latest target network, if it has been synced.
+      this->SyncTargetNetwork(sharedTarget);
+
       // Initialize the gradient storage.
       arma::mat totalGradients(learningNetwork.Parameters().n_rows,
           learningNetwork.Parameters().n_cols, arma::fill::zeros);
@@ -190,10 +193,7 @@ class NStepQLearningWorker : public WorkerBase<
       double target = 0;
       if (!terminal)
       {
-        #pragma omp critical
-        {
-            targetNetwork.Predict(nextState.Encode(), actionValue);
-        };
+        this->targetNetwork.Predict(nextState.Encode(), actionValue);
         target = actionValue.max();
       }
 
@@ -244,10 +244,7 @@ class NStepQLearningWorker : public WorkerBase<
 
     // Update global target network.
     if (totalSteps % this->config.TargetNetworkSyncInterval() == 0)
-    {
-      #pragma omp critical
-      { targetNetwork = learningNetwork; }
-    }
+      sharedTarget.Publish(learningNetwork);
 
     policy.Anneal();
 
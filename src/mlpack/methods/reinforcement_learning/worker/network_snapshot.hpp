@@ -0,0 +1,75 @@
+/**
+ * @file methods/reinforcement_learning/worker/network_snapshot.hpp
+ *
+ * Definition of the NetworkSnapshot class, which shares an immutable copy of a
+ * network between the workers of asynchronous learning without locks.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RL_WORKER_NETWORK_SNAPSHOT_HPP
+#define MLPACK_METHODS_RL_WORKER_NETWORK_SNAPSHOT_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <atomic>
+#include <memory>
+
+namespace mlpack {
+namespace rl {
+
+/**
+ * A snapshot of a network that is shared by several threads.  A new snapshot
+ * is published by building a copy of the network and swapping the shared
+ * pointer atomically, so that readers never wait for each other or for the
+ * writer: a reader that loads the snapshot keeps the copy it got alive until
+ * it releases it, even if a newer snapshot is published in the meantime.
+ *
+ * Evaluating a network changes its internal buffers, so the snapshot is never
+ * evaluated directly; each reader copies the snapshot into a network of its
+ * own when it sees a new one (see WorkerBase::SyncTargetNetwork()).
+ *
+ * @tparam NetworkType The type of the network.
+ */
+template<typename NetworkType>
+class NetworkSnapshot
+{
+ public:
+  /**
+   * Create the snapshot with a copy of the given network.
+   *
+   * @param network Network to publish first.
+   */
+  explicit NetworkSnapshot(const NetworkType& network) :
+      snapshot(std::make_shared<const NetworkType>(network))
+  { /* Nothing to do. */ }
+
+  /**
+   * Publish a copy of the given network.  The copy is made before the shared
+   * pointer is swapped, so the readers are never blocked while it is made.
+   *
+   * @param network Network to publish.
+   */
+  void Publish(const NetworkType& network)
+  {
+    std::shared_ptr<const NetworkType> latest =
+        std::make_shared<const NetworkType>(network);
+    std::atomic_store(&snapshot, latest);
+  }
+
+  //! Get the latest published snapshot.
+  std::shared_ptr<const NetworkType> Load() const
+  {
+    return std::atomic_load(&snapshot);
+  }
+
+ private:
+  //! The latest published snapshot.
+  std::shared_ptr<const NetworkType> snapshot;
+};
+
+} // namespace rl
+} // namespace mlpack
+
+#endif
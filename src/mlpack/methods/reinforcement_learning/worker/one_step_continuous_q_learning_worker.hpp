@@ -131,7 +131,7 @@ class OneStepContinuousQLearningWorker:
    * The agent will execute one step.
    *
    * @param learningNetwork The shared learning network.
-   * @param targetNetwork The shared target network.
+   * @param sharedTarget The shared snapshot of the target network.
    * @param totalSteps The shared counter for total steps.
    * @param policy The shared behavior policy.
    * @param totalReward This will be the episode return if the episode ends
@@ -139,7 +139,7 @@ class OneStepContinuousQLearningWorker:
    * @return Indicate whether current episode ends after this step.
    */
   bool Step(NetworkType& learningNetwork,
-            NetworkType& targetNetwork,
+            NetworkSnapshot<NetworkType>& sharedTarget,
             size_t& totalSteps,
             PolicyType& policy,
             double& totalReward) override
@@ -184,6 +184,9 @@ class OneStepContinuousQLearningWorker:
 
     if (terminal || this->pendingIndex >= this->config.UpdateInterval())
     {
+      // Pick up the latest target network, if it has been synced.
+      this->SyncTargetNetwork(sharedTarget);
+
       // Initialize the gradient storage.
       arma::mat totalGradients(learningNetwork.Parameters().n_rows,
           learningNetwork.Parameters().n_cols, arma::fill::zeros);
@@ -200,12 +203,8 @@ class OneStepContinuousQLearningWorker:
         }
         else
         {
-            #pragma omp critical
-            {
-                targetNetwork.Predict(
-                        transition.nextState.Encode(),
-                        actionValue);
-            };
+            this->targetNetwork.Predict(transition.nextState.Encode(),
+                actionValue);
         }
 
         actionValue = std::exp(- transition.reward) +
@@ -252,10 +251,7 @@ class OneStepContinuousQLearningWorker:
 
     // Update global target network.
     if (totalSteps % this->config.TargetNetworkSyncInterval() == 0)
-    {
-      #pragma omp critical
-      { targetNetwork = learningNetwork; }
-    }
+      sharedTarget.Publish(learningNetwork);
 
     policy.Anneal();
 
@@ -126,7 +126,7 @@ class OneStepQLearningWorker:public WorkerBase<
    * The agent will execute one step.
    *
    * @param learningNetwork The shared learning network.
-   * @param targetNetwork The shared target network.
+   * @param sharedTarget The shared snapshot of the target network.
    * @param totalSteps The shared counter for total steps.
    * @param policy The shared behavior policy.
    * @param totalReward This will be the episode return if the episode ends
@@ -134,7 +134,7 @@ class OneStepQLearningWorker:public WorkerBase<
    * @return Indicate whether current episode ends after this step.
    */
   bool Step(NetworkType& learningNetwork,
-            NetworkType& targetNetwork,
+            NetworkSnapshot<NetworkType>& sharedTarget,
             size_t& totalSteps,
             PolicyType& policy,
             double& totalReward) override
@@ -180,6 +180,9 @@ class OneStepQLearningWorker:public WorkerBase<
 
     if (terminal || this->pendingIndex >= this->config.UpdateInterval())
     {
+      // Pick up the latest target network, if it has been synced.
+      this->SyncTargetNetwork(sharedTarget);
+
       // Initialize the gradient storage.
       arma::mat totalGradients(learningNetwork.Parameters().n_rows,
           learningNetwork.Parameters().n_cols, arma::fill::zeros);
@@ -189,11 +192,8 @@ class OneStepQLearningWorker:public WorkerBase<
 
         // Compute the target state-action value.
         arma::colvec actionValue;
-        #pragma omp critical
-        {
-          targetNetwork.Predict(
-              transition.nextState.Encode(), actionValue);
-        };
+        this->targetNetwork.Predict(transition.nextState.Encode(),
+            actionValue);
         double targetActionValue = actionValue.max();
         if (terminal && i == this->pending.size() - 1)
         {
@@ -243,10 +243,7 @@ class OneStepQLearningWorker:public WorkerBase<
 
     // Update global target network.
     if (totalSteps % this->config.TargetNetworkSyncInterval() == 0)
-    {
-      #pragma omp critical
-      { targetNetwork = learningNetwork; }
-    }
+      sharedTarget.Publish(learningNetwork);
 
     policy.Anneal();
 
@@ -127,7 +127,7 @@ class OneStepSarsaWorker
    * The agent will execute one step.
    *
    * @param learningNetwork The shared learning network.
-   * @param targetNetwork The shared target network.
+   * @param sharedTarget The shared snapshot of the target network.
    * @param totalSteps The shared counter for total steps.
    * @param policy The shared behavior policy.
    * @param totalReward This will be the episode return if the episode ends
@@ -135,7 +135,7 @@ class OneStepSarsaWorker
    * @return Indicate whether current episode ends after this step.
    */
   bool Step(NetworkType& learningNetwork,
-            NetworkType& targetNetwork,
+            NetworkSnapshot<NetworkType>& sharedTarget,
             size_t& totalSteps,
             PolicyType& policy,
             double& totalReward) override
@@ -188,6 +188,9 @@ class OneStepSarsaWorker
 
     if (terminal || this->pendingIndex >= this->config.UpdateInterval())
     {
+      // Pick up the latest target network, if it has been synced.
+      this->SyncTargetNetwork(sharedTarget);
+
       // Initialize the gradient storage.
       arma::mat totalGradients(learningNetwork.Parameters().n_rows,
           learningNetwork.Parameters().n_cols, arma::fill::zeros);
@@ -197,11 +200,8 @@ class OneStepSarsaWorker
 
         // Compute the target state-action value.
         arma::colvec actionValue;
-        #pragma omp critical
-        {
-          targetNetwork.Predict(
-              transition.nextState.Encode(), actionValue);
-        };
+        this->targetNetwork.Predict(transition.nextState.Encode(),
+            actionValue);
         double targetActionValue = 0;
         if (!(terminal && i == this->pending.size() - 1))
           targetActionValue = actionValue[transition.nextAction];
@@ -244,10 +244,7 @@ class OneStepSarsaWorker
 
     // Update global target network.
     if (totalSteps % this->config.TargetNetworkSyncInterval() == 0)
-    {
-      #pragma omp critical
-      { targetNetwork = learningNetwork; }
-    }
+      sharedTarget.Publish(learningNetwork);
 
     policy.Anneal();
 
@@ -13,6 +13,7 @@
 #define WORKER_BASE
 
 #include <mlpack/methods/reinforcement_learning/training_config.hpp>
+#include <mlpack/methods/reinforcement_learning/worker/network_snapshot.hpp>
 
 namespace mlpack {
 namespace rl {
@@ -81,7 +82,9 @@ class WorkerBase
         pending(other.pending),
         pendingIndex(other.pendingIndex),
         network(other.network),
-        state(other.state)
+        state(other.state),
+        targetSnapshot(other.targetSnapshot),
+        targetNetwork(other.targetNetwork)
     {
 #if ENS_VERSION_MAJOR >= 2
         updatePolicy = new typename UpdaterType::template
@@ -111,7 +114,9 @@ class WorkerBase
         pending(std::move(other.pending)),
         pendingIndex(std::move(other.pendingIndex)),
         network(std::move(other.network)),
-        state(std::move(other.state))
+        state(std::move(other.state)),
+        targetSnapshot(std::move(other.targetSnapshot)),
+        targetNetwork(std::move(other.targetNetwork))
     {
 #if ENS_VERSION_MAJOR >= 2
         other.updatePolicy = NULL;
@@ -147,6 +152,8 @@ class WorkerBase
         pendingIndex = other.pendingIndex;
         network = other.network;
         state = other.state;
+        targetSnapshot = other.targetSnapshot;
+        targetNetwork = other.targetNetwork;
 
 #if ENS_VERSION_MAJOR >= 2
         updatePolicy = new typename UpdaterType::template
@@ -184,6 +191,8 @@ class WorkerBase
         pendingIndex = std::move(other.pendingIndex);
         network = std::move(other.network);
         state = std::move(other.state);
+        targetSnapshot = std::move(other.targetSnapshot);
+        targetNetwork = std::move(other.targetNetwork);
 
 #if ENS_VERSION_MAJOR >= 2
         other.updatePolicy = NULL;
@@ -227,13 +236,15 @@ class WorkerBase
 
         // Build local network.
         network = learningNetwork;
+        targetNetwork = learningNetwork;
+        targetSnapshot.reset();
     }
 
     /**
      * The agent will execute one step.
      *
      * @param learningNetwork The shared learning network.
-     * @param targetNetwork The shared target network.
+     * @param sharedTarget The shared snapshot of the target network.
      * @param totalSteps The shared counter for total steps.
      * @param policy The shared behavior policy.
      * @param totalReward This will be the episode return if the episode ends
@@ -241,7 +252,7 @@ class WorkerBase
      * @return Indicate whether current episode ends after this step.
      */
     virtual bool Step(NetworkType& learningNetwork,
-        NetworkType& targetNetwork,
+        NetworkSnapshot<NetworkType>& sharedTarget,
         size_t& totalSteps,
         PolicyType& policy,
         double& totalReward) = 0;
@@ -258,6 +269,23 @@ class WorkerBase
         state = environment.InitialSample();
     }
 
+    /**
+     * Copy the shared target network into the local target network if a new
+     * snapshot has been published since the last call.  The local copy is
+     * evaluated without any lock, since no other thread uses it.
+     *
+     * @param sharedTarget The shared snapshot of the target network.
+     */
+    void SyncTargetNetwork(NetworkSnapshot<NetworkType>& sharedTarget)
+    {
+        std::shared_ptr<const NetworkType> latest = sharedTarget.Load();
+        if (latest != targetSnapshot)
+        {
+            targetNetwork = *latest;
+            targetSnapshot = std::move(latest);
+        }
+    }
+
     //! Locally-stored optimizer.
     UpdaterType updater;
 #if ENS_VERSION_MAJOR >= 2
@@ -290,6 +318,12 @@ class WorkerBase
 
     //! Current state of the agent.
     StateType state;
+
+    //! The snapshot of the target network that the local copy was made from.
+    std::shared_ptr<const NetworkType> targetSnapshot;
+
+    //! Local copy of the target network of the worker.
+    NetworkType targetNetwork;
 };
 } // namespace rl
 } // namespace mlpack
@@ -18,7 +18,16 @@
 namespace mlpack {
 namespace regression {
 
-class SoftmaxRegressionFunction
+/**
+ * The objective function of softmax regression.  The MatType template
+ * parameter gives the type of the training data; specifying arma::sp_mat
+ * allows training on sparse data without converting it to a dense matrix, and
+ * then the cost of each evaluation is linear in the number of nonzero elements.
+ *
+ * @tparam MatType Type of data matrix.
+ */
+template<typename MatType = arma::mat>
+class SoftmaxRegressionFunctionType
 {
  public:
   /**
@@ -31,11 +40,11 @@ class SoftmaxRegressionFunction
    * @param lambda L2-regularization constant.
    * @param fitIntercept Intercept term flag.
    */
-  SoftmaxRegressionFunction(const arma::mat& data,
-                            const arma::Row<size_t>& labels,
-                            const size_t numClasses,
-                            const double lambda = 0.0001,
-                            const bool fitIntercept = false);
+  SoftmaxRegressionFunctionType(const MatType& data,
+                                const arma::Row<size_t>& labels,
+                                const size_t numClasses,
+                                const double lambda = 0.0001,
+                                const bool fitIntercept = false);
 
   //! Initializes the parameters of the model to suitable values.
   const arma::mat InitializeWeights();
@@ -188,8 +197,9 @@ class SoftmaxRegressionFunction
   bool FitIntercept() const { return fitIntercept; }
 
  private:
-  //! Training data matrix.  This is an alias until the data is shuffled.
-  arma::mat data;
+  //! Training data matrix.  This is an alias until the data is shuffled (or a
+  //! copy, for sparse data).
+  MatType data;
   //! Label matrix for the provided data.
   arma::sp_mat groundTruth;
   //! Initial parameter point.
@@ -202,7 +212,13 @@ class SoftmaxRegressionFunction
   bool fitIntercept;
 };
 
+//! The softmax regression objective function for dense data.
+typedef SoftmaxRegressionFunctionType<arma::mat> SoftmaxRegressionFunction;
+
 } // namespace regression
 } // namespace mlpack
 
+// Include implementation.
+#include "softmax_regression_function_impl.hpp"
+
 #endif
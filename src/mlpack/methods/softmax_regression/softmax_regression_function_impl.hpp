@@ -1,5 +1,5 @@
 /**
- * @file methods/softmax_regression/softmax_regression_function.cpp
+ * @file methods/softmax_regression/softmax_regression_function_impl.hpp
  * @author Siddharth Agrawal
  *
  * Implementation of function to be optimized for softmax regression.
@@ -9,19 +9,25 @@
  * 3-clause BSD license along with mlpack.  If not, see
  * http://www.opensource.org/licenses/BSD-3-Clause for more information.
  */
+#ifndef MLPACK_METHODS_SOFTMAX_REGRESSION_SOFTMAX_REGRESSION_FUNCTION_IMPL_HPP
+#define MLPACK_METHODS_SOFTMAX_REGRESSION_SOFTMAX_REGRESSION_FUNCTION_IMPL_HPP
+
+// In case it hasn't been included yet.
 #include "softmax_regression_function.hpp"
 #include <mlpack/core/math/make_alias.hpp>
+#include <mlpack/core/math/shuffle_data.hpp>
 
-using namespace mlpack;
-using namespace mlpack::regression;
+namespace mlpack {
+namespace regression {
 
-SoftmaxRegressionFunction::SoftmaxRegressionFunction(
-    const arma::mat& data,
+template<typename MatType>
+SoftmaxRegressionFunctionType<MatType>::SoftmaxRegressionFunctionType(
+    const MatType& data,
     const arma::Row<size_t>& labels,
     const size_t numClasses,
     const double lambda,
     const bool fitIntercept) :
-    data(math::MakeAlias(const_cast<arma::mat&>(data), false)),
+    data(math::MakeAlias(const_cast<MatType&>(data), false)),
     numClasses(numClasses),
     lambda(lambda),
     fitIntercept(fitIntercept)
@@ -36,14 +42,15 @@ SoftmaxRegressionFunction::SoftmaxRegressionFunction(
 /**
  * Shuffle the data.
  */
-void SoftmaxRegressionFunction::Shuffle()
+template<typename MatType>
+void SoftmaxRegressionFunctionType<MatType>::Shuffle()
 {
-  // Determine new ordering.
-  arma::uvec ordering = arma::shuffle(arma::linspace<arma::uvec>(0,
-      data.n_cols - 1, data.n_cols));
-
-  // Re-sort data.
-  arma::mat newData = data.cols(ordering);
+  // Shuffle the data, along with the index of each point to find the new
+  // ordering.
+  MatType newData;
+  arma::Row<size_t> ordering;
+  math::ShuffleData(data, arma::linspace<arma::Row<size_t>>(0,
+      data.n_cols - 1, data.n_cols), newData, ordering);
   math::ClearAlias(data);
   data = std::move(newData);
 
@@ -75,12 +82,14 @@ void SoftmaxRegressionFunction::Shuffle()
  * normal distribution. The weights cannot be initialized to zero, as that will
  * lead to each class output being the same.
  */
-const arma::mat SoftmaxRegressionFunction::InitializeWeights()
+template<typename MatType>
+const arma::mat SoftmaxRegressionFunctionType<MatType>::InitializeWeights()
 {
   return InitializeWeights(data.n_rows, numClasses, fitIntercept);
 }
 
-const arma::mat SoftmaxRegressionFunction::InitializeWeights(
+template<typename MatType>
+const arma::mat SoftmaxRegressionFunctionType<MatType>::InitializeWeights(
     const size_t featureSize,
     const size_t numClasses,
     const bool fitIntercept)
@@ -90,7 +99,8 @@ const arma::mat SoftmaxRegressionFunction::InitializeWeights(
     return parameters;
 }
 
-void SoftmaxRegressionFunction::InitializeWeights(
+template<typename MatType>
+void SoftmaxRegressionFunctionType<MatType>::InitializeWeights(
     arma::mat &weights,
     const size_t featureSize,
     const size_t numClasses,
@@ -111,7 +121,8 @@ void SoftmaxRegressionFunction::InitializeWeights(
  * labels. The output is in the form of a matrix, which leads to simpler
  * calculations in the Evaluate() and Gradient() methods.
  */
-void SoftmaxRegressionFunction::GetGroundTruthMatrix(
+template<typename MatType>
+void SoftmaxRegressionFunctionType<MatType>::GetGroundTruthMatrix(
     const arma::Row<size_t>& labels, arma::sp_mat& groundTruth)
 {
   // Calculate the ground truth matrix according to the labels passed. The
@@ -147,7 +158,8 @@ void SoftmaxRegressionFunction::GetGroundTruthMatrix(
  * Evaluate the probabilities matrix. If fitIntercept flag is true,
  * it should consider the parameters.cols(0) intercept term.
  */
-void SoftmaxRegressionFunction::GetProbabilitiesMatrix(
+template<typename MatType>
+void SoftmaxRegressionFunctionType<MatType>::GetProbabilitiesMatrix(
     const arma::mat& parameters,
     arma::mat& probabilities,
     const size_t start,
@@ -181,7 +193,9 @@ void SoftmaxRegressionFunction::GetProbabilitiesMatrix(
 /**
  * Evaluates the objective function given the parameters.
  */
-double SoftmaxRegressionFunction::Evaluate(const arma::mat& parameters) const
+template<typename MatType>
+double SoftmaxRegressionFunctionType<MatType>::Evaluate(
+    const arma::mat& parameters) const
 {
   // The objective function is the negative log likelihood of the model
   // calculated over all the training examples. Mathematically it is as follows:
@@ -219,9 +233,11 @@ double SoftmaxRegressionFunction::Evaluate(const arma::mat& parameters) const
 /**
  * Evaluate the objective function for the given points given the parameters.
  */
-double SoftmaxRegressionFunction::Evaluate(const arma::mat& parameters,
-                                           const size_t start,
-                                           const size_t batchSize) const
+template<typename MatType>
+double SoftmaxRegressionFunctionType<MatType>::Evaluate(
+    const arma::mat& parameters,
+    const size_t start,
+    const size_t batchSize) const
 {
   arma::mat probabilities;
   GetProbabilitiesMatrix(parameters, probabilities, start, batchSize);
@@ -231,7 +247,7 @@ double SoftmaxRegressionFunction::Evaluate(const arma::mat& parameters,
 
   logLikelihood = arma::accu(groundTruth.cols(start, start + batchSize - 1) %
       arma::log(probabilities)) / batchSize;
-  weightDecay = 0.5 * lambda * arma::accu(parameters * parameters);
+  weightDecay = 0.5 * lambda * arma::accu(parameters % parameters);
 
   return -logLikelihood + weightDecay;
 }
@@ -239,8 +255,10 @@ double SoftmaxRegressionFunction::Evaluate(const arma::mat& parameters,
 /**
  * Calculates and stores the gradient values given a set of parameters.
  */
-void SoftmaxRegressionFunction::Gradient(const arma::mat& parameters,
-                                         arma::mat& gradient) const
+template<typename MatType>
+void SoftmaxRegressionFunctionType<MatType>::Gradient(
+    const arma::mat& parameters,
+    arma::mat& gradient) const
 {
   // Calculate the class probabilities for each training example. The
   // probabilities for each of the classes are given by:
@@ -272,10 +290,12 @@ void SoftmaxRegressionFunction::Gradient(const arma::mat& parameters,
   }
 }
 
-void SoftmaxRegressionFunction::Gradient(const arma::mat& parameters,
-                                         const size_t start,
-                                         arma::mat& gradient,
-                                         const size_t batchSize) const
+template<typename MatType>
+void SoftmaxRegressionFunctionType<MatType>::Gradient(
+    const arma::mat& parameters,
+    const size_t start,
+    arma::mat& gradient,
+    const size_t batchSize) const
 {
   arma::mat probabilities;
   GetProbabilitiesMatrix(parameters, probabilities, start, batchSize);
@@ -301,9 +321,11 @@ void SoftmaxRegressionFunction::Gradient(const arma::mat& parameters,
   }
 }
 
-void SoftmaxRegressionFunction::PartialGradient(const arma::mat& parameters,
-                                                const size_t j,
-                                                arma::sp_mat& gradient) const
+template<typename MatType>
+void SoftmaxRegressionFunctionType<MatType>::PartialGradient(
+    const arma::mat& parameters,
+    const size_t j,
+    arma::sp_mat& gradient) const
 {
   gradient.zeros(arma::size(parameters));
 
@@ -332,3 +354,8 @@ void SoftmaxRegressionFunction::PartialGradient(const arma::mat& parameters,
         parameters.col(j);
   }
 }
+
+} // namespace regression
+} // namespace mlpack
+
+#endif
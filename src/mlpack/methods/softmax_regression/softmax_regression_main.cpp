@@ -101,6 +101,8 @@ PARAM_MODEL_OUT(SoftmaxRegression, "output_model", "File to save trained "
 
 // Testing.
 PARAM_MATRIX_IN("test", "Matrix containing test dataset.", "T");
+// Each test point is classified on its own, so the test set can be streamed.
+BINDING_STREAMING_INPUT("test");
 PARAM_UROW_OUT("predictions", "Matrix to save predictions for test dataset "
     "into.", "p");
 PARAM_UROW_IN("test_labels", "Matrix containing test labels.", "L");
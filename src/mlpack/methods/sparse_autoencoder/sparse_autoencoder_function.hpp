@@ -14,6 +14,8 @@
 #define MLPACK_METHODS_SPARSE_AUTOENCODER_SPARSE_AUTOENCODER_FUNCTION_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/make_alias.hpp>
+#include <mlpack/core/math/shuffle_data.hpp>
 
 namespace mlpack {
 namespace nn {
@@ -22,8 +24,21 @@ namespace nn {
  * This is a class for the sparse autoencoder objective function. It can be used
  * to create learning models like self-taught learning, stacked autoencoders,
  * conditional random fields (CRFs), and so forth.
+ *
+ * The function is separable, so it can be optimized with the SGD-family
+ * optimizers as well as with L-BFGS.  The objective of a batch of points is
+ * the average reconstruction error over the batch plus the regularization and
+ * the KL divergence terms, where the average activations of the hidden layer
+ * are taken over the batch (so it is an estimate of the sparsity penalty of
+ * the whole dataset).  The points are processed in blocks, so only the
+ * activations of one block per thread are held at a time, and the blocks are
+ * split between the threads when OpenMP is available.
+ *
+ * @tparam MatType Type of the data and of the parameters (arma::mat or
+ *     arma::fmat).
  */
-class SparseAutoencoderFunction
+template<typename MatType = arma::mat>
+class SparseAutoencoderFunctionType
 {
  public:
   /**
@@ -37,15 +52,21 @@ class SparseAutoencoderFunction
    * @param beta KL divergence parameter.
    * @param rho Sparsity parameter.
    */
-  SparseAutoencoderFunction(const arma::mat& data,
-                            const size_t visibleSize,
-                            const size_t hiddenSize,
-                            const double lambda = 0.0001,
-                            const double beta = 3,
-                            const double rho = 0.01);
+  SparseAutoencoderFunctionType(const MatType& data,
+                                const size_t visibleSize,
+                                const size_t hiddenSize,
+                                const double lambda = 0.0001,
+                                const double beta = 3,
+                                const double rho = 0.01);
 
   //! Initializes the parameters of the model to suitable values.
-  const arma::mat InitializeWeights();
+  const MatType InitializeWeights();
+
+  /**
+   * Shuffle the order of the points.  This is called by the SGD-family
+   * optimizers; after it, the function holds a shuffled copy of the data.
+   */
+  void Shuffle();
 
   /**
    * Evaluates the objective function of the sparse autoencoder model using the
@@ -57,7 +78,20 @@ class SparseAutoencoderFunction
    *
    * @param parameters Current values of the model parameters.
    */
-  double Evaluate(const arma::mat& parameters) const;
+  double Evaluate(const MatType& parameters) const;
+
+  /**
+   * Evaluate the objective function of the sparse autoencoder model on the
+   * given batch of points.  The reconstruction error and the average
+   * activations of the hidden layer are taken over the batch.
+   *
+   * @param parameters Current values of the model parameters.
+   * @param begin Index of the first point of the batch.
+   * @param batchSize Number of points in the batch.
+   */
+  double Evaluate(const MatType& parameters,
+                  const size_t begin,
+                  const size_t batchSize) const;
 
   /**
    * Evaluates the gradient values of the objective function given the current
@@ -68,7 +102,45 @@ class SparseAutoencoderFunction
    * @param parameters Current values of the model parameters.
    * @param gradient Matrix where gradient values will be stored.
    */
-  void Gradient(const arma::mat& parameters, arma::mat& gradient) const;
+  void Gradient(const MatType& parameters, MatType& gradient) const;
+
+  /**
+   * Evaluate the objective function and its gradient with a single forward
+   * pass over the data.
+   *
+   * @param parameters Current values of the model parameters.
+   * @param gradient Matrix where gradient values will be stored.
+   */
+  double EvaluateWithGradient(const MatType& parameters,
+                              MatType& gradient) const;
+
+  /**
+   * Evaluate the gradient of the objective function on the given batch of
+   * points.
+   *
+   * @param parameters Current values of the model parameters.
+   * @param begin Index of the first point of the batch.
+   * @param gradient Matrix where gradient values will be stored.
+   * @param batchSize Number of points in the batch.
+   */
+  void Gradient(const MatType& parameters,
+                const size_t begin,
+                MatType& gradient,
+                const size_t batchSize) const;
+
+  /**
+   * Evaluate the objective function and its gradient on the given batch of
+   * points, with a single forward pass.
+   *
+   * @param parameters Current values of the model parameters.
+   * @param begin Index of the first point of the batch.
+   * @param gradient Matrix where gradient values will be stored.
+   * @param batchSize Number of points in the batch.
+   */
+  double EvaluateWithGradient(const MatType& parameters,
+                              const size_t begin,
+                              MatType& gradient,
+                              const size_t batchSize) const;
 
   /**
    * Returns the elementwise sigmoid of the passed matrix, where the sigmoid
@@ -77,13 +149,16 @@ class SparseAutoencoderFunction
    * @param x Matrix of real values for which we require the sigmoid activation.
    * @param output Output matrix.
    */
-  void Sigmoid(const arma::mat& x, arma::mat& output) const
+  void Sigmoid(const MatType& x, MatType& output) const
   {
     output = (1.0 / (1 + arma::exp(-x)));
   }
 
   //! Return the initial point for the optimization.
-  const arma::mat& GetInitialPoint() const { return initialPoint; }
+  const MatType& GetInitialPoint() const { return initialPoint; }
+
+  //! Return the number of points.
+  size_t NumFunctions() const { return data.n_cols; }
 
   //! Sets size of the visible layer.
   void VisibleSize(const size_t visible)
@@ -146,10 +221,19 @@ class SparseAutoencoderFunction
   }
 
  private:
-  //! The matrix of data points.
-  const arma::mat& data;
+  /**
+   * Compute the objective function on the given batch of points, and its
+   * gradient if gradient is not NULL.
+   */
+  double EvaluateBlocks(const MatType& parameters,
+                        const size_t begin,
+                        const size_t batchSize,
+                        MatType* gradient) const;
+
+  //! The matrix of data points.  This is an alias until Shuffle() is called.
+  MatType data;
   //! Initial parameter vector.
-  arma::mat initialPoint;
+  MatType initialPoint;
   //! Size of the visible layer.
   size_t visibleSize;
   //! Size of the hidden layer.
@@ -162,7 +246,13 @@ class SparseAutoencoderFunction
   double rho;
 };
 
+//! The sparse autoencoder objective function on double-precision data.
+typedef SparseAutoencoderFunctionType<arma::mat> SparseAutoencoderFunction;
+
 } // namespace nn
 } // namespace mlpack
 
+// Include implementation.
+#include "sparse_autoencoder_function_impl.hpp"
+
 #endif
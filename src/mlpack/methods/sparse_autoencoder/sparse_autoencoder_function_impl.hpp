@@ -0,0 +1,301 @@
+/**
+ * @file methods/sparse_autoencoder/sparse_autoencoder_function_impl.hpp
+ * @author Siddharth Agrawal
+ *
+ * Implementation of function to be optimized for sparse autoencoders.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_SPARSE_AUTOENCODER_SPARSE_AUTOENCODER_FUNCTION_IMPL_HPP
+#define MLPACK_METHODS_SPARSE_AUTOENCODER_SPARSE_AUTOENCODER_FUNCTION_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "sparse_autoencoder_function.hpp"
+
+namespace mlpack {
+namespace nn {
+
+template<typename MatType>
+SparseAutoencoderFunctionType<MatType>::SparseAutoencoderFunctionType(
+    const MatType& data,
+    const size_t visibleSize,
+    const size_t hiddenSize,
+    const double lambda,
+    const double beta,
+    const double rho) :
+    data(math::MakeAlias(const_cast<MatType&>(data), false)),
+    visibleSize(visibleSize),
+    hiddenSize(hiddenSize),
+    lambda(lambda),
+    beta(beta),
+    rho(rho)
+{
+  // Initialize the parameters to suitable values.
+  initialPoint = InitializeWeights();
+}
+
+/** Initializes the parameter weights if the initial point is not passed to the
+  * constructor. The weights w1, w2 are initialized to randomly in the range
+  * [-r, r] where 'r' is decided using the sizes of the visible and hidden
+  * layers. The biases b1, b2 are initialized to 0.
+  */
+template<typename MatType>
+const MatType SparseAutoencoderFunctionType<MatType>::InitializeWeights()
+{
+  // The module uses a matrix to store the parameters, its structure looks like:
+  //          vSize   1
+  //       |        |  |
+  //  hSize|   w1   |b1|
+  //       |________|__|
+  //       |        |  |
+  //  hSize|   w2'  |  |
+  //       |________|__|
+  //      1|   b2'  |  |
+  //
+  // There are (hiddenSize + 1) empty cells in the matrix, but it is small
+  // compared to the matrix size. The above structure allows for smooth matrix
+  // operations without making the code too ugly.
+
+  // Initialize w1 and w2 to random values in the range [0, 1], then set b1 and
+  // b2 to 0.
+  MatType parameters;
+  parameters.randu(2 * hiddenSize + 1, visibleSize + 1);
+  parameters.row(2 * hiddenSize).zeros();
+  parameters.col(visibleSize).zeros();
+
+  // Decide the parameter 'r' depending on the size of the visible and hidden
+  // layers. The formula used is r = sqrt(6) / sqrt(vSize + hSize + 1).
+  const double range = std::sqrt(6) / std::sqrt(visibleSize + hiddenSize + 1);
+
+  // Shift range of w1 and w2 values from [0, 1] to [-r, r].
+  parameters.submat(0, 0, 2 * hiddenSize - 1, visibleSize - 1) = 2 * range *
+      (parameters.submat(0, 0, 2 * hiddenSize - 1, visibleSize - 1) - 0.5);
+
+  return parameters;
+}
+
+template<typename MatType>
+void SparseAutoencoderFunctionType<MatType>::Shuffle()
+{
+  MatType newData(data);
+  math::ShuffleDataInPlace(newData);
+
+  math::ClearAlias(data);
+  data = std::move(newData);
+}
+
+/** Evaluates the objective function given the parameters.
+  */
+template<typename MatType>
+double SparseAutoencoderFunctionType<MatType>::Evaluate(
+    const MatType& parameters) const
+{
+  return EvaluateBlocks(parameters, 0, data.n_cols, NULL);
+}
+
+template<typename MatType>
+double SparseAutoencoderFunctionType<MatType>::Evaluate(
+    const MatType& parameters,
+    const size_t begin,
+    const size_t batchSize) const
+{
+  return EvaluateBlocks(parameters, begin, batchSize, NULL);
+}
+
+/** Calculates and stores the gradient values given a set of parameters.
+  */
+template<typename MatType>
+void SparseAutoencoderFunctionType<MatType>::Gradient(
+    const MatType& parameters,
+    MatType& gradient) const
+{
+  EvaluateBlocks(parameters, 0, data.n_cols, &gradient);
+}
+
+template<typename MatType>
+void SparseAutoencoderFunctionType<MatType>::Gradient(
+    const MatType& parameters,
+    const size_t begin,
+    MatType& gradient,
+    const size_t batchSize) const
+{
+  EvaluateBlocks(parameters, begin, batchSize, &gradient);
+}
+
+template<typename MatType>
+double SparseAutoencoderFunctionType<MatType>::EvaluateWithGradient(
+    const MatType& parameters,
+    MatType& gradient) const
+{
+  return EvaluateBlocks(parameters, 0, data.n_cols, &gradient);
+}
+
+template<typename MatType>
+double SparseAutoencoderFunctionType<MatType>::EvaluateWithGradient(
+    const MatType& parameters,
+    const size_t begin,
+    MatType& gradient,
+    const size_t batchSize) const
+{
+  return EvaluateBlocks(parameters, begin, batchSize, &gradient);
+}
+
+template<typename MatType>
+double SparseAutoencoderFunctionType<MatType>::EvaluateBlocks(
+    const MatType& parameters,
+    const size_t begin,
+    const size_t batchSize,
+    MatType* gradient) const
+{
+  typedef typename MatType::elem_type ElemType;
+  typedef arma::Col<ElemType> VecType;
+
+  // The objective function is the average squared reconstruction error of the
+  // network. w1 and b1 are the weights and biases associated with the hidden
+  // layer, whereas w2 and b2 are associated with the output layer.
+  // f(w1,w2,b1,b2) = sum((data - sigmoid(w2*sigmoid(w1data + b1) + b2))^2) / 2m
+  // 'm' is the number of training examples.
+  // The cost also takes into account the regularization and KL divergence terms
+  // to control the parameter weights and sparsity of the model respectively.
+
+  // Compute the limits for the parameters w1, w2, b1 and b2.
+  const size_t l1 = hiddenSize;
+  const size_t l2 = visibleSize;
+  const size_t l3 = 2 * hiddenSize;
+
+  // w1, w2, b1 and b2 are not extracted separately, 'parameters' is directly
+  // used in their place to avoid copying data. The following representations
+  // are used:
+  // w1 <- parameters.submat(0, 0, l1-1, l2-1)
+  // w2 <- parameters.submat(l1, 0, l3-1, l2-1).t()
+  // b1 <- parameters.submat(0, l2, l1-1, l2)
+  // b2 <- parameters.submat(l3, 0, l3, l2-1).t()
+
+  // The delta vector for the output layer is given by diff * f'(z), where z is
+  // the preactivation and f is the activation function. The derivative of the
+  // sigmoid function turns out to be f(z) * (1 - f(z)). For every other layer
+  // in the neural network which comes before the output layer, the delta values
+  // are given del_n = w_n' * del_(n+1) * f'(z_n). Since our cost function also
+  // includes the KL divergence term, the hidden delta has the extra term
+  // klDivGrad * f'(z_n), but klDivGrad depends on the average activations of
+  // the whole batch.  So, to need a single pass over the points, we
+  // accumulate the sums of f'(z_n) x^T separately (in klTerms) and scale them
+  // by klDivGrad at the end.
+  //
+  // The points are processed in blocks, so that only the activations of one
+  // block of points per thread are held at a time, and the blocks are split
+  // between the threads when OpenMP is available.
+  const size_t blockSize = 1024;
+  const size_t numBlocks = (batchSize + blockSize - 1) / blockSize;
+
+  VecType hiddenSum(hiddenSize, arma::fill::zeros);
+  MatType klTerms;
+  if (gradient)
+  {
+    gradient->zeros(2 * hiddenSize + 1, visibleSize + 1);
+    klTerms.zeros(hiddenSize, visibleSize + 1);
+  }
+
+  double sumOfSquares = 0.0;
+  #pragma omp parallel reduction(+:sumOfSquares)
+  {
+    VecType localHiddenSum(hiddenSize, arma::fill::zeros);
+    MatType localGradient, localKLTerms;
+    if (gradient)
+    {
+      localGradient.zeros(2 * hiddenSize + 1, visibleSize + 1);
+      localKLTerms.zeros(hiddenSize, visibleSize + 1);
+    }
+
+    #pragma omp for schedule(static)
+    for (omp_size_t block = 0; block < (omp_size_t) numBlocks; ++block)
+    {
+      const size_t first = begin + block * blockSize;
+      const size_t last = std::min(first + blockSize, begin + batchSize) - 1;
+      const MatType x = data.cols(first, last);
+
+      // Compute activations of the hidden and output layers.
+      MatType hiddenLayer = parameters.submat(0, 0, l1 - 1, l2 - 1) * x;
+      hiddenLayer.each_col() += parameters.submat(0, l2, l1 - 1, l2);
+      Sigmoid(hiddenLayer, hiddenLayer);
+
+      MatType outputLayer = parameters.submat(l1, 0, l3 - 1, l2 - 1).t() *
+          hiddenLayer;
+      outputLayer.each_col() += parameters.submat(l3, 0, l3, l2 - 1).t();
+      Sigmoid(outputLayer, outputLayer);
+
+      // Difference between the reconstructed data and the original data.
+      const MatType diff = outputLayer - x;
+      sumOfSquares += arma::accu(diff % diff);
+      localHiddenSum += arma::sum(hiddenLayer, 1);
+
+      if (gradient)
+      {
+        const MatType delOut = diff % outputLayer % (1 - outputLayer);
+        const MatType hiddenDerivative = hiddenLayer % (1 - hiddenLayer);
+        const MatType delHid = (parameters.submat(l1, 0, l3 - 1, l2 - 1) *
+            delOut) % hiddenDerivative;
+
+        localGradient.submat(0, 0, l1 - 1, l2 - 1) += delHid * x.t();
+        localGradient.submat(0, l2, l1 - 1, l2) += arma::sum(delHid, 1);
+        localGradient.submat(l1, 0, l3 - 1, l2 - 1) += hiddenLayer *
+            delOut.t();
+        localGradient.submat(l3, 0, l3, l2 - 1) += arma::sum(delOut, 1).t();
+
+        localKLTerms.cols(0, l2 - 1) += hiddenDerivative * x.t();
+        localKLTerms.col(l2) += arma::sum(hiddenDerivative, 1);
+      }
+    }
+
+    #pragma omp critical(sparseAutoencoderGradient)
+    {
+      hiddenSum += localHiddenSum;
+      if (gradient)
+      {
+        *gradient += localGradient;
+        klTerms += localKLTerms;
+      }
+    }
+  }
+
+  // Average activations of the hidden layer.
+  const VecType rhoCap = hiddenSum / batchSize;
+
+  // Calculate the reconstruction error, the regularization cost and the KL
+  // divergence cost terms. 'sumOfSquaresError' is the average squared l2-norm
+  // of the reconstructed data difference. 'weightDecay' is the squared l2-norm
+  // of the weights w1 and w2. 'klDivergence' is the cost of the hidden layer
+  // activations not being low. It is given by the following formula:
+  // KL = sum_over_hSize(rho*log(rho/rhoCaq) + (1-rho)*log((1-rho)/(1-rhoCap)))
+  const double sumOfSquaresError = 0.5 * sumOfSquares / batchSize;
+  const double weightDecay = 0.5 * lambda * arma::accu(
+      parameters.submat(0, 0, l3 - 1, l2 - 1) %
+      parameters.submat(0, 0, l3 - 1, l2 - 1));
+  const ElemType r = (ElemType) rho;
+  const double klDivergence = beta * arma::accu(r * arma::log(r / rhoCap) +
+      (1 - r) * arma::log((1 - r) / (1 - rhoCap)));
+
+  if (gradient)
+  {
+    const VecType klDivGrad = (ElemType) beta * (-(r / rhoCap) +
+        (1 - r) / (1 - rhoCap));
+    klTerms.each_col() %= klDivGrad;
+    gradient->rows(0, l1 - 1) += klTerms;
+    *gradient /= batchSize;
+
+    // Add the gradient of the regularization terms.
+    gradient->submat(0, 0, l3 - 1, l2 - 1) += (ElemType) lambda *
+        parameters.submat(0, 0, l3 - 1, l2 - 1);
+  }
+
+  // The cost is the sum of the terms calculated above.
+  return sumOfSquaresError + weightDecay + klDivergence;
+}
+
+} // namespace nn
+} // namespace mlpack
+
+#endif
@@ -163,6 +163,8 @@ namespace ens {
       mlpack::svd::SVDPlusPlusFunction<arma::mat>& function,
       arma::mat& parameters);
 
+  // Hogwild! parallel SGD, over blocks of threadShareSize shuffled ratings;
+  // this includes lock-free updates of the item implicit vectors.
   template <>
   template <>
   inline double ParallelSGD<ExponentialBackoff>::Optimize(
@@ -406,14 +406,15 @@ inline double ParallelSGD<ExponentialBackoff>::Optimize(
   arma::Col<size_t> visitationOrder = arma::linspace<arma::Col<size_t>>(0,
       (function.NumFunctions() - 1), function.NumFunctions());
 
-  const arma::mat data = function.Dataset();
-  const arma::sp_mat implicitData = function.ImplicitDataset();
+  const arma::mat& data = function.Dataset();
+  const arma::sp_mat& implicitData = function.ImplicitDataset();
   const size_t numUsers = function.NumUsers();
   const size_t numItems = function.NumItems();
   const double lambda = function.Lambda();
 
   // Rank of decomposition.
   const size_t rank = function.Rank();
+  const size_t implicitStart = numUsers + numItems;
 
   // Iterate till the objective is within tolerance or the maximum number of
   // allowed iterations is reached. If maxIterations is 0, this will iterate
@@ -456,94 +457,90 @@ inline double ParallelSGD<ExponentialBackoff>::Optimize(
       std::shuffle(visitationOrder.begin(), visitationOrder.end(),
           mlpack::math::randGen);
 
+    // Hogwild!: the shuffled ratings are split into blocks of threadShareSize
+    // ratings, and the threads take blocks until every rating of the epoch has
+    // been visited.  Each update touches only a few parameter columns, so the
+    // updates are written without any locking.
+    const size_t blockSize = std::max(threadShareSize, (size_t) 1);
+    const size_t numBlocks = (visitationOrder.n_elem + blockSize - 1) /
+        blockSize;
     #pragma omp parallel
     {
-      // Each processor gets a subset of the instances.
-      // Each subset is of size threadShareSize.
-      size_t threadId = 0;
-      #ifdef HAS_OPENMP
-        threadId = omp_get_thread_num();
-      #endif
-
-      for (size_t j = threadId * threadShareSize;
-          j < (threadId + 1) * threadShareSize && j < visitationOrder.n_elem;
-          ++j)
+      // The user vector, including the implicit feedback, of this thread.
+      arma::vec userVec(rank);
+
+      #pragma omp for schedule(dynamic)
+      for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
       {
-        // Indices for accessing the the correct parameter columns.
-        const size_t user = data(0, visitationOrder[j]);
-        const size_t item = data(1, visitationOrder[j]) + numUsers;
-        const size_t implicitStart = numUsers + numItems;
-
-        // Prediction error for the example.
-        const double rating = data(2, visitationOrder[j]);
-        const double userBias = iterate(rank, user);
-        const double itemBias = iterate(rank, item);
-        // Iterate through each item which the user interacted with to calculate
-        // user vector.
-        arma::vec userVec(rank, arma::fill::zeros);
-        arma::sp_mat::const_iterator it = implicitData.begin_col(user);
-        arma::sp_mat::const_iterator it_end = implicitData.end_col(user);
-        size_t implicitCount = 0;
-        for (; it != it_end; ++it)
+        const size_t end = std::min(((size_t) b + 1) * blockSize,
+            (size_t) visitationOrder.n_elem);
+        for (size_t j = (size_t) b * blockSize; j < end; ++j)
         {
-          userVec += iterate.col(implicitStart + it.row()).subvec(0, rank - 1);
-          implicitCount += 1;
-        }
-        if (implicitCount != 0)
-          userVec /= std::sqrt(implicitCount);
-        userVec += iterate.col(user).subvec(0, rank - 1);
-
-        double ratingError = rating - userBias - itemBias -
-        arma::dot(userVec, iterate.col(item).subvec(0, rank - 1));
-
-        arma::mat userVecUpdate = stepSize * 2 * (
-            lambda * iterate.col(user).subvec(0, rank - 1) -
-            ratingError * iterate.col(item).subvec(0, rank - 1));
-        arma::mat itemVecUpdate = stepSize * 2 * (
-            lambda * iterate.col(item).subvec(0, rank - 1) -
-            ratingError * userVec);
-        double userBiasUpdate = stepSize * 2 * (
-            lambda * iterate(rank, user) - ratingError);
-        double itemBiasUpdate = stepSize * 2 * (
-            lambda * iterate(rank, item) - ratingError);
-
-        // Update of item implicit vectors.
-        arma::mat itemImplicitUpdate(rank, implicitCount);
-        arma::Col<size_t> implicitItems(implicitCount);
-        it = implicitData.begin_col(user);
-        it_end = implicitData.end_col(user);
-        size_t implicitIndex = 0;
-        for (; it != it_end; ++it, ++implicitIndex)
-        {
-          itemImplicitUpdate.col(implicitIndex) =
-              stepSize * 2.0 * (lambda / implicitCount *
-              iterate.col(implicitStart + it.row()).subvec(0, rank - 1) -
-              ratingError / std::sqrt(implicitCount) *
-              iterate.col(item).subvec(0, rank - 1));
-          implicitItems(implicitIndex) = it.row();
-        }
+          // Indices for accessing the the correct parameter columns.  The
+          // bias is the last element of each column.
+          const size_t user = data(0, visitationOrder[j]);
+          double* userParams = iterate.colptr(user);
+          double* itemParams = iterate.colptr(data(1, visitationOrder[j]) +
+              numUsers);
+
+          // Iterate through each item which the user interacted with to
+          // calculate user vector.
+          userVec.zeros();
+          size_t implicitCount = 0;
+          arma::sp_mat::const_iterator it = implicitData.begin_col(user);
+          arma::sp_mat::const_iterator itEnd = implicitData.end_col(user);
+          for (; it != itEnd; ++it)
+          {
+            const double* implicitVec = iterate.colptr(implicitStart +
+                it.row());
+            for (size_t k = 0; k < rank; ++k)
+              userVec[k] += implicitVec[k];
+            ++implicitCount;
+          }
+          if (implicitCount != 0)
+            userVec /= std::sqrt(implicitCount);
+          for (size_t k = 0; k < rank; ++k)
+            userVec[k] += userParams[k];
+
+          // Prediction error for the example.
+          double ratingError = data(2, visitationOrder[j]) -
+              userParams[rank] - itemParams[rank];
+          for (size_t k = 0; k < rank; ++k)
+            ratingError -= userVec[k] * itemParams[k];
+
+          // Update the item implicit vectors first, since they depend on the
+          // item vector before its update.
+          if (implicitCount != 0)
+          {
+            const double implicitLambda = lambda / implicitCount;
+            const double implicitError = ratingError /
+                std::sqrt(implicitCount);
+            for (it = implicitData.begin_col(user); it != itEnd; ++it)
+            {
+              double* implicitVec = iterate.colptr(implicitStart + it.row());
+              for (size_t k = 0; k < rank; ++k)
+              {
+                implicitVec[k] -= stepSize * 2.0 * (implicitLambda *
+                    implicitVec[k] - implicitError * itemParams[k]);
+              }
+            }
+          }
 
-        // Gradient is non-zero only for the parameter columns corresponding to
-        // the example.
-        for (size_t i = 0; i < rank; ++i)
-        {
-          #pragma omp atomic
-          iterate(i, user) -= userVecUpdate(i);
-          #pragma omp atomic
-          iterate(i, item) -= itemVecUpdate(i);
-        }
-        #pragma omp atomic
-        iterate(rank, user) -= userBiasUpdate;
-        #pragma omp atomic
-        iterate(rank, item) -= itemBiasUpdate;
-        for (size_t k = 0; k < implicitCount; ++k)
-        {
-          for (size_t i = 0; i < rank; ++i)
+          // Gradient is non-zero only for the parameter columns corresponding
+          // to the example.
+          for (size_t k = 0; k < rank; ++k)
           {
-            #pragma omp atomic
-            iterate(i, implicitStart + implicitItems(k)) -=
-                itemImplicitUpdate(i, k);
+            const double userValue = userParams[k];
+            const double itemValue = itemParams[k];
+            userParams[k] -= stepSize * 2 * (lambda * userValue -
+                ratingError * itemValue);
+            itemParams[k] -= stepSize * 2 * (lambda * itemValue -
+                ratingError * userVec[k]);
           }
+          userParams[rank] -= stepSize * 2 * (lambda * userParams[rank] -
+              ratingError);
+          itemParams[rank] -= stepSize * 2 * (lambda * itemParams[rank] -
+              ratingError);
         }
       }
     }
@@ -26,6 +26,7 @@
 #include <mlpack/methods/ann/activation_functions/gelu_function.hpp>
 #include <mlpack/methods/ann/activation_functions/elliot_function.hpp>
 #include <mlpack/methods/ann/activation_functions/elish_function.hpp>
+#include <mlpack/methods/ann/activation_functions/fast_activation_functions.hpp>
 
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
@@ -935,4 +936,58 @@ BOOST_AUTO_TEST_CASE(CELUFunctionTest)
   CheckCELUDerivativeCorrect(desiredActivations, desiredDerivatives);
 }
 
+/**
+ * Check that the fast version of an activation function gives the same
+ * activations and derivatives as the exact one, also when evaluated in place.
+ */
+template<class ExactFunction, class FastFunction>
+void CheckFastActivationCorrect(const arma::mat& input)
+{
+  arma::mat exact, fast;
+  ExactFunction::Fn(input, exact);
+  FastFunction::Fn(input, fast);
+  for (size_t i = 0; i < input.n_elem; ++i)
+  {
+    BOOST_REQUIRE_SMALL(fast[i] - exact[i], 1e-10);
+    BOOST_REQUIRE_SMALL(FastFunction::Fn(input[i]) - exact[i], 1e-10);
+  }
+
+  ExactFunction::Deriv(input, exact);
+  FastFunction::Deriv(input, fast);
+  for (size_t i = 0; i < input.n_elem; ++i)
+    BOOST_REQUIRE_SMALL(fast[i] - exact[i], 1e-10);
+
+  arma::mat inPlace(input);
+  FastFunction::Deriv(inPlace, inPlace);
+  for (size_t i = 0; i < input.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(inPlace[i], fast[i]);
+}
+
+/**
+ * Test the fast activation functions against the exact ones.
+ */
+BOOST_AUTO_TEST_CASE(FastActivationFunctionsTest)
+{
+  // Stay within the range where the exact mish function doesn't overflow.
+  arma::mat input = arma::linspace<arma::vec>(-30.0, 30.0, 6039);
+  input.reshape(61, 99);
+
+  CheckFastActivationCorrect<LogisticFunction, FastLogisticFunction>(input);
+  CheckFastActivationCorrect<TanhFunction, FastTanhFunction>(input);
+  CheckFastActivationCorrect<SoftplusFunction, FastSoftplusFunction>(input);
+  CheckFastActivationCorrect<SwishFunction, FastSwishFunction>(input);
+  CheckFastActivationCorrect<MishFunction, FastMishFunction>(input);
+  CheckFastActivationCorrect<GELUFunction, FastGELUFunction>(input);
+
+  // The fast functions don't overflow for large inputs.
+  arma::mat large("-800 -400 400 800");
+  arma::mat output;
+  FastMishFunction::Fn(large, output);
+  BOOST_REQUIRE(output.is_finite());
+  BOOST_REQUIRE_SMALL(output[0], 1e-10);
+  BOOST_REQUIRE_CLOSE(output[3], 800.0, 1e-10);
+  FastSoftplusFunction::Fn(large, output);
+  BOOST_REQUIRE_CLOSE(output[3], 800.0, 1e-10);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -668,6 +668,58 @@ BOOST_AUTO_TEST_CASE(ClassifyTest_NONLINSEP)
   BOOST_REQUIRE_LE(lError, 0.30);
 }
 
+/**
+ * This test case runs the AdaBoost.mh algorithm with full decision trees as
+ * weak learners on a non linearly separable dataset, and checks that the
+ * predictions of the batch Classify() match those of the weak learners.
+ */
+BOOST_AUTO_TEST_CASE(ClassifyTest_NONLINSEP_DecisionTree)
+{
+  arma::mat inputData;
+  if (!data::Load("train_nonlinsep.txt", inputData))
+    BOOST_FAIL("Cannot load test dataset train_nonlinsep.txt!");
+
+  arma::Mat<size_t> labels;
+  if (!data::Load("train_labels_nonlinsep.txt", labels))
+    BOOST_FAIL("Cannot load labels for train_labels_nonlinsep.txt");
+
+  arma::mat testData;
+  if (!data::Load("test_nonlinsep.txt", testData))
+    BOOST_FAIL("Cannot load test dataset test_nonlinsep.txt!");
+
+  arma::Mat<size_t> trueTestLabels;
+  if (!data::Load("test_labels_nonlinsep.txt", trueTestLabels))
+    BOOST_FAIL("Cannot load labels for test_labels_nonlinsep.txt");
+
+  const size_t numClasses = 2;
+  arma::Row<size_t> labelsvec = labels.row(0);
+
+  // The weak learners are trained with the weights of AdaBoost.
+  DecisionTree<> dt(inputData, labelsvec, numClasses, 20);
+  AdaBoost<DecisionTree<>> a(inputData, labelsvec, numClasses, dt, 20, 1e-10);
+  BOOST_REQUIRE_GT(a.WeakLearners(), 0);
+
+  arma::Row<size_t> predictedLabels;
+  arma::mat probabilities;
+  a.Classify(testData, predictedLabels, probabilities);
+
+  // Compute the votes of the weak learners one point at a time.
+  for (size_t i = 0; i < testData.n_cols; ++i)
+  {
+    arma::vec votes(numClasses, arma::fill::zeros);
+    for (size_t j = 0; j < a.WeakLearners(); ++j)
+      votes[a.WeakLearner(j).Classify(testData.col(i))] += a.Alpha(j);
+    votes /= arma::accu(votes);
+
+    for (size_t k = 0; k < numClasses; ++k)
+      BOOST_REQUIRE_CLOSE(probabilities(k, i), votes[k], 1e-5);
+  }
+
+  size_t localError = arma::accu(trueTestLabels != predictedLabels);
+  double lError = (double) localError / trueTestLabels.n_cols;
+  BOOST_REQUIRE_LE(lError, 0.30);
+}
+
 /**
  * This test case runs the AdaBoost.mh algorithm on the UCI Iris Dataset.  It
  * trains it on two thirds of the Iris dataset (iris_train.csv), and tests on
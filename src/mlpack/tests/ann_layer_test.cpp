@@ -276,6 +276,36 @@ BOOST_AUTO_TEST_CASE(NoDropoutTest)
   BOOST_REQUIRE_EQUAL(arma::accu(output), arma::accu(input));
 }
 
+/**
+ * Make sure that the backward pass of dropout uses the mask of the forward
+ * pass, and that the masks follow the random seed.
+ */
+BOOST_AUTO_TEST_CASE(DropoutMaskTest)
+{
+  // Use a size that isn't a multiple of the 32 bits of a mask word.
+  arma::mat input = arma::randu<arma::mat>(37, 29) + 1.0;
+
+  Dropout<> module(0.3);
+  module.Deterministic() = false;
+
+  math::RandomSeed(7);
+  arma::mat output, delta;
+  module.Forward(input, output);
+  module.Backward(input, input, delta);
+  CheckMatrices(output, delta);
+
+  for (size_t i = 0; i < output.n_elem; ++i)
+  {
+    if (output[i] != 0.0)
+      BOOST_REQUIRE_CLOSE(output[i], input[i] / 0.7, 1e-10);
+  }
+
+  math::RandomSeed(7);
+  arma::mat output2;
+  module.Forward(input, output2);
+  CheckMatrices(output, output2);
+}
+
 /*
  * Perform test to check whether mean and variance remain nearly same
  * after AlphaDropout.
@@ -454,6 +484,71 @@ BOOST_AUTO_TEST_CASE(GradientLinearLayerTest)
   BOOST_REQUIRE_LE(CheckGradient(function), 1e-4);
 }
 
+/**
+ * Test that the Linear, LinearNoBias, sigmoid and LogSoftMax layers give the
+ * same results in single precision as in double precision.
+ */
+BOOST_AUTO_TEST_CASE(FloatLinearLayerTest)
+{
+  Linear<> linear(10, 5);
+  LinearNoBias<> linearNoBias(5, 4);
+  linear.Parameters().randu();
+  linear.Reset();
+  linearNoBias.Parameters().randu();
+  linearNoBias.Reset();
+  SigmoidLayer<> sigmoid;
+  LogSoftMax<> logSoftMax;
+
+  Linear<arma::fmat, arma::fmat> floatLinear(10, 5);
+  LinearNoBias<arma::fmat, arma::fmat> floatLinearNoBias(5, 4);
+  floatLinear.Parameters() = arma::conv_to<arma::fmat>::from(
+      linear.Parameters());
+  floatLinear.Reset();
+  floatLinearNoBias.Parameters() = arma::conv_to<arma::fmat>::from(
+      linearNoBias.Parameters());
+  floatLinearNoBias.Reset();
+  SigmoidLayer<arma::fmat, arma::fmat> floatSigmoid;
+  LogSoftMax<arma::fmat, arma::fmat> floatLogSoftMax;
+
+  arma::mat input(10, 3, arma::fill::randu);
+  arma::fmat floatInput = arma::conv_to<arma::fmat>::from(input);
+
+  // Forward pass.
+  arma::mat linearOutput, linearNoBiasOutput, sigmoidOutput, output;
+  linear.Forward(input, linearOutput);
+  linearNoBias.Forward(linearOutput, linearNoBiasOutput);
+  sigmoid.Forward(linearNoBiasOutput, sigmoidOutput);
+  logSoftMax.Forward(sigmoidOutput, output);
+
+  arma::fmat floatLinearOutput, floatLinearNoBiasOutput, floatSigmoidOutput,
+      floatOutput;
+  floatLinear.Forward(floatInput, floatLinearOutput);
+  floatLinearNoBias.Forward(floatLinearOutput, floatLinearNoBiasOutput);
+  floatSigmoid.Forward(floatLinearNoBiasOutput, floatSigmoidOutput);
+  floatLogSoftMax.Forward(floatSigmoidOutput, floatOutput);
+  CheckMatrices(output, arma::conv_to<arma::mat>::from(floatOutput), 1e-2);
+
+  // Backward pass and gradients.
+  arma::mat error(4, 3, arma::fill::randu);
+  arma::fmat floatError = arma::conv_to<arma::fmat>::from(error);
+
+  arma::mat sigmoidDelta, delta, gradient;
+  sigmoid.Backward(sigmoidOutput, error, sigmoidDelta);
+  linearNoBias.Backward(linearOutput, sigmoidDelta, delta);
+  gradient.set_size(linear.Parameters().n_elem, 1);
+  linear.Gradient(input, delta, gradient);
+
+  arma::fmat floatSigmoidDelta, floatDelta, floatGradient;
+  floatSigmoid.Backward(floatSigmoidOutput, floatError, floatSigmoidDelta);
+  floatLinearNoBias.Backward(floatLinearOutput, floatSigmoidDelta, floatDelta);
+  floatGradient.set_size(floatLinear.Parameters().n_elem, 1);
+  floatLinear.Gradient(floatInput, floatDelta, floatGradient);
+
+  CheckMatrices(delta, arma::conv_to<arma::mat>::from(floatDelta), 1e-2);
+  CheckMatrices(gradient, arma::conv_to<arma::mat>::from(floatGradient),
+      1e-2);
+}
+
 /**
  * Simple linear no bias module test.
  */
@@ -881,6 +976,92 @@ BOOST_AUTO_TEST_CASE(GradientLSTMLayerTest)
   BOOST_REQUIRE_LE(CheckGradient(function), 1e-4);
 }
 
+/**
+ * Make sure that the packed gate computation of the LSTM layer matches the
+ * gate equations computed with the individual weights.
+ */
+BOOST_AUTO_TEST_CASE(LSTMPackedGatesTest)
+{
+  const size_t inSize = 3, outSize = 2;
+  LSTM<> layer(inSize, outSize, 5);
+  layer.Parameters().randn();
+  layer.Reset();
+
+  arma::mat input = arma::randu(inSize, 4), output;
+  layer.Forward(input, output);
+
+  // Extract the individual weights from the parameters.
+  const arma::mat& p = layer.Parameters();
+  size_t offset = 0;
+  std::vector<arma::mat> w, b;
+  for (size_t i = 0; i < 4; ++i)
+  {
+    w.push_back(arma::reshape(p.rows(offset, offset + outSize * inSize - 1),
+        outSize, inSize));
+    offset += outSize * inSize;
+    b.push_back(p.rows(offset, offset + outSize - 1));
+    offset += outSize;
+  }
+  offset += 4 * outSize * outSize;
+  const arma::vec peephole = p.rows(offset, offset + outSize - 1);
+
+  // The recurrent and the cell contributions are zero in the first step.
+  arma::mat inputGate = 1.0 / (1.0 + arma::exp(-(w[2] * input +
+      arma::repmat(b[2], 1, input.n_cols))));
+  arma::mat hidden = arma::tanh(w[3] * input +
+      arma::repmat(b[3], 1, input.n_cols));
+  arma::mat cell = inputGate % hidden;
+  arma::mat outputGate = 1.0 / (1.0 + arma::exp(-(w[0] * input +
+      arma::repmat(b[0], 1, input.n_cols) + cell.each_col() % peephole)));
+  arma::mat expected = arma::tanh(cell) % outputGate;
+
+  CheckMatrices(output, expected, 1e-5);
+}
+
+/**
+ * LSTM layer numerical gradient test with a batch of sequences.
+ */
+BOOST_AUTO_TEST_CASE(GradientLSTMLayerBatchTest)
+{
+  // LSTM function gradient instantiation.
+  struct GradientFunction
+  {
+    GradientFunction()
+    {
+      input = arma::randu(1, 3, 5);
+      target.ones(1, 3, 5);
+      const size_t rho = 5;
+
+      model = new RNN<NegativeLogLikelihood<> >(rho);
+      model->Predictors() = input;
+      model->Responses() = target;
+      model->Add<IdentityLayer<> >();
+      model->Add<Linear<> >(1, 10);
+      model->Add<LSTM<> >(10, 3, rho);
+      model->Add<LogSoftMax<> >();
+    }
+
+    ~GradientFunction()
+    {
+      delete model;
+    }
+
+    double Gradient(arma::mat& gradient) const
+    {
+      double error = model->Evaluate(model->Parameters(), 0, 3);
+      model->Gradient(model->Parameters(), 0, gradient, 3);
+      return error;
+    }
+
+    arma::mat& Parameters() { return model->Parameters(); }
+
+    RNN<NegativeLogLikelihood<> >* model;
+    arma::cube input, target;
+  } function;
+
+  BOOST_REQUIRE_LE(CheckGradient(function), 1e-3);
+}
+
 /**
  * Test that the functions that can modify and access the parameters of the
  * LSTM layer work.
@@ -1871,6 +2052,50 @@ BOOST_AUTO_TEST_CASE(GradientBatchNormTest)
   BOOST_REQUIRE_LE(CheckGradient(function), 1e-4);
 }
 
+/**
+ * Make sure that the statistics of the BatchNorm layer over several batches are
+ * the mean and variance of all the batches, and that the forward and backward
+ * passes match the textbook formulas, even for inputs with a large mean.
+ */
+BOOST_AUTO_TEST_CASE(BatchNormStatisticsTest)
+{
+  arma::mat input = arma::randn(5, 300) + 1e4;
+  input.row(2) *= 100.0;
+
+  BatchNorm<> model(5);
+  model.Reset();
+
+  arma::mat output;
+  model.Forward(arma::mat(input.cols(0, 99)), output);
+  model.Forward(arma::mat(input.cols(100, 249)), output);
+  arma::mat batch = input.cols(250, 299);
+  model.Forward(batch, output);
+
+  CheckMatrices(model.TrainingMean(), arma::mean(input, 1), 1e-7);
+  CheckMatrices(model.TrainingVariance(), arma::var(input, 1, 1), 1e-5);
+
+  const arma::mat batchMean = arma::mean(batch, 1);
+  const arma::mat stdInv = 1.0 / arma::sqrt(arma::var(batch, 1, 1) + 1e-8);
+  arma::mat normalized = batch.each_col() - batchMean;
+  normalized.each_col() %= stdInv;
+  CheckMatrices(output, normalized, 1e-5);
+
+  // With gamma = 1, the error is stdInv * (gy - mean(gy) - xhat *
+  // mean(gy * xhat)).
+  const arma::mat gy = arma::randn(5, 50);
+  arma::mat g;
+  model.Backward(output, gy, g);
+  arma::mat expected = gy.each_col() - arma::mean(gy, 1);
+  expected -= normalized.each_col() % arma::mean(gy % normalized, 1);
+  expected.each_col() %= stdInv;
+  CheckMatrices(g, expected, 1e-5);
+
+  arma::mat gradient;
+  model.Gradient(batch, gy, gradient);
+  CheckMatrices(gradient, arma::join_cols(arma::sum(normalized % gy, 1),
+      arma::sum(gy, 1)), 1e-5);
+}
+
 /**
  * Test that the functions that can access the parameters of the
  * Batch Norm layer work.
@@ -2427,6 +2652,37 @@ BOOST_AUTO_TEST_CASE(LayerNormTest)
   CheckMatrices(output, result, 1e-1);
 }
 
+/**
+ * Make sure that the forward and backward passes of the LayerNorm layer match
+ * the textbook formulas, even for inputs with a large mean.
+ */
+BOOST_AUTO_TEST_CASE(LayerNormStatisticsTest)
+{
+  arma::mat input = arma::randn(40, 20) + 1e4;
+  input.col(3) *= 100.0;
+
+  LayerNorm<> model(40);
+  model.Reset();
+
+  arma::mat output;
+  model.Forward(input, output);
+  CheckMatrices(model.Mean(), arma::mean(input, 0), 1e-7);
+  CheckMatrices(model.Variance(), arma::var(input, 1, 0), 1e-5);
+
+  const arma::mat stdInv = 1.0 / arma::sqrt(arma::var(input, 1, 0) + 1e-8);
+  arma::mat normalized = input.each_row() - arma::mean(input, 0);
+  normalized.each_row() %= stdInv;
+  CheckMatrices(output, normalized, 1e-5);
+
+  const arma::mat gy = arma::randn(40, 20);
+  arma::mat g;
+  model.Backward(output, gy, g);
+  arma::mat expected = gy.each_row() - arma::mean(gy, 0);
+  expected -= normalized.each_row() % arma::mean(gy % normalized, 0);
+  expected.each_row() %= stdInv;
+  CheckMatrices(g, expected, 1e-5);
+}
+
 /**
  * LayerNorm layer numerical gradient test.
  */
@@ -3274,6 +3530,222 @@ BOOST_AUTO_TEST_CASE(ConvolutionLayerPaddingTest)
   module2.Backward(input, output, delta);
 }
 
+/**
+ * Test that the Convolution layer gives the same results with the
+ * Im2ColConvolution rule as with the NaiveConvolution rule.
+ */
+BOOST_AUTO_TEST_CASE(Im2ColConvolutionLayerTest)
+{
+  typedef Convolution<Im2ColConvolution<ValidConvolution>,
+      Im2ColConvolution<FullConvolution>,
+      Im2ColConvolution<ValidConvolution> > Im2ColConvolutionType;
+
+  // Check both without and with padding.
+  for (size_t pad = 0; pad < 2; ++pad)
+  {
+    Convolution<> naiveModule(2, 3, 3, 3, 1, 1, pad, pad, 6, 5);
+    Im2ColConvolutionType im2colModule(2, 3, 3, 3, 1, 1, pad, pad, 6, 5);
+
+    naiveModule.Parameters().randu();
+    naiveModule.Reset();
+    im2colModule.Parameters() = naiveModule.Parameters();
+    im2colModule.Reset();
+
+    // Use a batch of four points.
+    arma::mat input(6 * 5 * 2, 4, arma::fill::randu);
+    arma::mat naiveOutput, im2colOutput;
+    naiveModule.Forward(input, naiveOutput);
+    im2colModule.Forward(input, im2colOutput);
+    CheckMatrices(naiveOutput, im2colOutput, 1e-5);
+
+    arma::mat error(naiveOutput.n_rows, naiveOutput.n_cols, arma::fill::randu);
+    arma::mat naiveDelta, im2colDelta;
+    naiveModule.Backward(input, error, naiveDelta);
+    im2colModule.Backward(input, error, im2colDelta);
+    CheckMatrices(naiveDelta, im2colDelta, 1e-5);
+
+    // The weight gradients are summed over the batch.
+    arma::mat naiveGradient, im2colGradient;
+    naiveModule.Gradient(input, error, naiveGradient);
+    im2colModule.Gradient(input, error, im2colGradient);
+    const size_t weightSize = 2 * 3 * 3 * 3;
+    CheckMatrices(naiveGradient.rows(0, weightSize - 1),
+        im2colGradient.rows(0, weightSize - 1), 1e-5);
+
+    // The bias gradient is the sum of the errors of each output map.
+    arma::cube errorCube(error.memptr(), naiveModule.OutputWidth(),
+        naiveModule.OutputHeight(), 3 * 4, false, true);
+    for (size_t outMap = 0; outMap < 3; ++outMap)
+    {
+      double sum = 0.0;
+      for (size_t b = 0; b < 4; ++b)
+        sum += arma::accu(errorCube.slice(outMap + b * 3));
+      BOOST_REQUIRE_CLOSE(im2colGradient(weightSize + outMap), sum, 1e-5);
+    }
+  }
+}
+
+/**
+ * Convolution layer with the Im2ColConvolution rule numerical gradient test.
+ */
+BOOST_AUTO_TEST_CASE(GradientIm2ColConvolutionLayerTest)
+{
+  typedef Convolution<Im2ColConvolution<ValidConvolution>,
+      Im2ColConvolution<FullConvolution>,
+      Im2ColConvolution<ValidConvolution> > Im2ColConvolutionType;
+
+  // Add function gradient instantiation.
+  struct GradientFunction
+  {
+    GradientFunction()
+    {
+      input = arma::randu(7 * 7 * 2, 1);
+      target = arma::mat("1");
+
+      model = new FFN<NegativeLogLikelihood<>, RandomInitialization,
+          Im2ColConvolutionType>();
+      model->Predictors() = input;
+      model->Responses() = target;
+      model->Add<Im2ColConvolutionType>(2, 2, 3, 3, 2, 2, 1, 1, 7, 7);
+      model->Add<LogSoftMax<> >();
+    }
+
+    ~GradientFunction()
+    {
+      delete model;
+    }
+
+    double Gradient(arma::mat& gradient) const
+    {
+      double error = model->Evaluate(model->Parameters(), 0, 1);
+      model->Gradient(model->Parameters(), 0, gradient, 1);
+      return error;
+    }
+
+    arma::mat& Parameters() { return model->Parameters(); }
+
+    FFN<NegativeLogLikelihood<>, RandomInitialization, Im2ColConvolutionType>*
+        model;
+    arma::mat input, target;
+  } function;
+
+  BOOST_REQUIRE_LE(CheckGradient(function), 1e-3);
+}
+
+/**
+ * Test that the TransposedConvolution layer gives the same results with the
+ * Im2ColConvolution rule as with the NaiveConvolution rule.
+ */
+BOOST_AUTO_TEST_CASE(Im2ColTransposedConvolutionLayerTest)
+{
+  typedef TransposedConvolution<Im2ColConvolution<ValidConvolution>,
+      Im2ColConvolution<ValidConvolution>,
+      Im2ColConvolution<ValidConvolution> > Im2ColTransposedConvolutionType;
+
+  // Check both without and with padding, with a stride of two.
+  for (size_t pad = 0; pad < 2; ++pad)
+  {
+    const size_t outputSize = 9 - 2 * pad;
+    TransposedConvolution<> naiveModule(2, 3, 3, 3, 2, 2, pad, pad, 4, 4,
+        outputSize, outputSize);
+    Im2ColTransposedConvolutionType im2colModule(2, 3, 3, 3, 2, 2, pad, pad,
+        4, 4, outputSize, outputSize);
+
+    naiveModule.Parameters().randu();
+    naiveModule.Reset();
+    im2colModule.Parameters() = naiveModule.Parameters();
+    im2colModule.Reset();
+
+    // Use a batch of four points.
+    arma::mat input(4 * 4 * 2, 4, arma::fill::randu);
+    arma::mat naiveOutput, im2colOutput;
+    naiveModule.Forward(input, naiveOutput);
+    im2colModule.Forward(input, im2colOutput);
+    CheckMatrices(naiveOutput, im2colOutput, 1e-5);
+
+    arma::mat error(naiveOutput.n_rows, naiveOutput.n_cols, arma::fill::randu);
+    arma::mat naiveDelta, im2colDelta;
+    naiveModule.Backward(input, error, naiveDelta);
+    im2colModule.Backward(input, error, im2colDelta);
+    CheckMatrices(naiveDelta, im2colDelta, 1e-5);
+
+    // The weight gradients are summed over the batch.
+    arma::mat naiveGradient, im2colGradient;
+    naiveModule.Gradient(input, error, naiveGradient);
+    im2colModule.Gradient(input, error, im2colGradient);
+    const size_t weightSize = 2 * 3 * 3 * 3;
+    CheckMatrices(naiveGradient.rows(0, weightSize - 1),
+        im2colGradient.rows(0, weightSize - 1), 1e-5);
+
+    // The bias gradient is the sum of the errors of each output map.
+    arma::cube errorCube(error.memptr(), outputSize, outputSize, 3 * 4, false,
+        true);
+    for (size_t outMap = 0; outMap < 3; ++outMap)
+    {
+      double sum = 0.0;
+      for (size_t b = 0; b < 4; ++b)
+        sum += arma::accu(errorCube.slice(outMap + b * 3));
+      BOOST_REQUIRE_CLOSE(im2colGradient(weightSize + outMap), sum, 1e-5);
+    }
+  }
+}
+
+/**
+ * Test that the AtrousConvolution layer gives the same results with the
+ * Im2ColConvolution rule as with the NaiveConvolution rule.
+ */
+BOOST_AUTO_TEST_CASE(Im2ColAtrousConvolutionLayerTest)
+{
+  typedef AtrousConvolution<Im2ColConvolution<ValidConvolution>,
+      Im2ColConvolution<FullConvolution>,
+      Im2ColConvolution<ValidConvolution> > Im2ColAtrousConvolutionType;
+
+  // Check both without and with padding, with a dilation of two.
+  for (size_t pad = 0; pad < 2; ++pad)
+  {
+    AtrousConvolution<> naiveModule(2, 3, 3, 3, 1, 1, pad, pad, 8, 7, 2, 2);
+    Im2ColAtrousConvolutionType im2colModule(2, 3, 3, 3, 1, 1, pad, pad, 8, 7,
+        2, 2);
+
+    naiveModule.Parameters().randu();
+    naiveModule.Reset();
+    im2colModule.Parameters() = naiveModule.Parameters();
+    im2colModule.Reset();
+
+    // Use a batch of four points.
+    arma::mat input(8 * 7 * 2, 4, arma::fill::randu);
+    arma::mat naiveOutput, im2colOutput;
+    naiveModule.Forward(input, naiveOutput);
+    im2colModule.Forward(input, im2colOutput);
+    CheckMatrices(naiveOutput, im2colOutput, 1e-5);
+
+    arma::mat error(naiveOutput.n_rows, naiveOutput.n_cols, arma::fill::randu);
+    arma::mat naiveDelta, im2colDelta;
+    naiveModule.Backward(input, error, naiveDelta);
+    im2colModule.Backward(input, error, im2colDelta);
+    CheckMatrices(naiveDelta, im2colDelta, 1e-5);
+
+    // The weight gradients are summed over the batch.
+    arma::mat naiveGradient, im2colGradient;
+    naiveModule.Gradient(input, error, naiveGradient);
+    im2colModule.Gradient(input, error, im2colGradient);
+    const size_t weightSize = 2 * 3 * 3 * 3;
+    CheckMatrices(naiveGradient.rows(0, weightSize - 1),
+        im2colGradient.rows(0, weightSize - 1), 1e-5);
+
+    // The bias gradient is the sum of the errors of each output map.
+    arma::cube errorCube(error.memptr(), naiveModule.OutputWidth(),
+        naiveModule.OutputHeight(), 3 * 4, false, true);
+    for (size_t outMap = 0; outMap < 3; ++outMap)
+    {
+      double sum = 0.0;
+      for (size_t b = 0; b < 4; ++b)
+        sum += arma::accu(errorCube.slice(outMap + b * 3));
+      BOOST_REQUIRE_CLOSE(im2colGradient(weightSize + outMap), sum, 1e-5);
+    }
+  }
+}
+
 /**
  * Test that the padding options in Transposed Convolution layer.
  */
@@ -3461,6 +3933,63 @@ BOOST_AUTO_TEST_CASE(MaxPoolingTestCase)
   BOOST_REQUIRE_EQUAL(output.n_cols, 1);
 }
 
+/**
+ * Make sure that the Max Pooling layer pools every channel of every point of a
+ * batch like a naive loop over the windows would, and that the backward pass
+ * sends each error to the maximum of its window.
+ */
+BOOST_AUTO_TEST_CASE(MaxPoolingBatchTest)
+{
+  const size_t width = 7, height = 6, channels = 3, points = 4;
+  arma::mat input = arma::randu<arma::mat>(width * height * channels, points);
+
+  MaxPooling<> module(3, 2, 2, 1);
+  module.InputWidth() = width;
+  module.InputHeight() = height;
+  arma::mat output;
+  module.Forward(input, output);
+
+  const size_t outputWidth = module.OutputWidth();
+  const size_t outputHeight = module.OutputHeight();
+  BOOST_REQUIRE_EQUAL(outputWidth, 3);
+  BOOST_REQUIRE_EQUAL(outputHeight, 5);
+  BOOST_REQUIRE_EQUAL(output.n_rows, outputWidth * outputHeight * channels);
+  BOOST_REQUIRE_EQUAL(output.n_cols, points);
+
+  arma::mat error = arma::randu<arma::mat>(output.n_rows, output.n_cols);
+  arma::mat delta;
+  module.Backward(input, error, delta);
+  BOOST_REQUIRE_EQUAL(delta.n_rows, input.n_rows);
+  BOOST_REQUIRE_EQUAL(delta.n_cols, input.n_cols);
+
+  arma::cube inputCube(input.memptr(), width, height, channels * points, false,
+      true);
+  arma::cube outputCube(output.memptr(), outputWidth, outputHeight,
+      channels * points, false, true);
+  arma::cube errorCube(error.memptr(), outputWidth, outputHeight,
+      channels * points, false, true);
+  arma::cube expectedDelta(width, height, channels * points, arma::fill::zeros);
+  for (size_t s = 0; s < inputCube.n_slices; ++s)
+  {
+    for (size_t j = 0; j < outputHeight; ++j)
+    {
+      for (size_t i = 0; i < outputWidth; ++i)
+      {
+        const arma::mat window = inputCube.slice(s).submat(2 * i, j,
+            2 * i + 2, j + 1);
+        const arma::uword maxIndex = window.index_max();
+        BOOST_REQUIRE_EQUAL(outputCube(i, j, s), window(maxIndex));
+
+        expectedDelta(2 * i + maxIndex % 3, j + maxIndex / 3, s) +=
+            errorCube(i, j, s);
+      }
+    }
+  }
+
+  CheckMatrices(delta, arma::mat(expectedDelta.memptr(), delta.n_rows,
+      delta.n_cols));
+}
+
 /**
  * Test that the functions that can modify and access the parameters of the
  * Glimpse layer work.
@@ -3715,4 +4244,263 @@ BOOST_AUTO_TEST_CASE(AdaptiveMeanPoolingTestCase)
   BOOST_REQUIRE_EQUAL(arma::accu(delta), 1.5);
 }
 
+/**
+ * Test that the attention weights of each head of the MultiheadAttention layer
+ * sum to one for each query, and that the attention mask is applied.
+ */
+BOOST_AUTO_TEST_CASE(MultiheadAttentionWeightsTest)
+{
+  const size_t embedDim = 4, numHeads = 2, seqLength = 3, batchSize = 2;
+  arma::mat input = arma::randu(embedDim * seqLength, batchSize);
+  arma::mat output;
+
+  MultiheadAttention<> module(embedDim, numHeads);
+  module.Parameters().randn();
+  module.Reset();
+
+  // Forbid attending to later tokens.
+  module.AttentionMask().zeros(seqLength, seqLength);
+  for (size_t i = 0; i < seqLength; ++i)
+    for (size_t j = 0; j < i; ++j)
+      module.AttentionMask()(i, j) = -DBL_MAX;
+
+  module.Forward(input, output);
+  BOOST_REQUIRE_EQUAL(output.n_rows, input.n_rows);
+  BOOST_REQUIRE_EQUAL(output.n_cols, input.n_cols);
+
+  const arma::mat& weights = module.AttentionWeights();
+  BOOST_REQUIRE_EQUAL(weights.n_rows, seqLength);
+  BOOST_REQUIRE_EQUAL(weights.n_cols, seqLength * numHeads * batchSize);
+  for (size_t j = 0; j < weights.n_cols; ++j)
+  {
+    BOOST_REQUIRE_CLOSE(arma::accu(weights.col(j)), 1.0, 1e-5);
+    for (size_t i = (j % seqLength) + 1; i < seqLength; ++i)
+      BOOST_REQUIRE_SMALL(weights(i, j), 1e-10);
+  }
+
+  // The first token can only attend to itself.
+  BOOST_REQUIRE_CLOSE(weights(0, 0), 1.0, 1e-5);
+}
+
+/**
+ * MultiheadAttention layer numerical gradient test.
+ */
+BOOST_AUTO_TEST_CASE(GradientMultiheadAttentionLayerTest)
+{
+  // MultiheadAttention function gradient instantiation.
+  struct GradientFunction
+  {
+    GradientFunction()
+    {
+      input = arma::randu(4 * 3, 2);
+      target = arma::mat("1 2");
+
+      model = new FFN<NegativeLogLikelihood<>, NguyenWidrowInitialization>();
+      model->Predictors() = input;
+      model->Responses() = target;
+      model->Add<IdentityLayer<> >();
+      model->Add<MultiheadAttention<> >(4, 2);
+      model->Add<Linear<> >(4 * 3, 2);
+      model->Add<LogSoftMax<> >();
+    }
+
+    ~GradientFunction()
+    {
+      delete model;
+    }
+
+    double Gradient(arma::mat& gradient) const
+    {
+      double error = model->Evaluate(model->Parameters(), 0, 2);
+      model->Gradient(model->Parameters(), 0, gradient, 2);
+      return error;
+    }
+
+    arma::mat& Parameters() { return model->Parameters(); }
+
+    FFN<NegativeLogLikelihood<>, NguyenWidrowInitialization>* model;
+    arma::mat input, target;
+  } function;
+
+  BOOST_REQUIRE_LE(CheckGradient(function), 1e-3);
+}
+
+/**
+ * TransformerEncoder layer numerical gradient test.
+ */
+BOOST_AUTO_TEST_CASE(GradientTransformerEncoderLayerTest)
+{
+  // TransformerEncoder function gradient instantiation.
+  struct GradientFunction
+  {
+    GradientFunction()
+    {
+      input = arma::randu(4 * 3, 2);
+      target = arma::mat("1 2");
+
+      // Without dropout, the gradient is deterministic.
+      model = new FFN<NegativeLogLikelihood<>, NguyenWidrowInitialization>();
+      model->Predictors() = input;
+      model->Responses() = target;
+      model->Add<IdentityLayer<> >();
+      model->Add<TransformerEncoder<> >(4, 2, 6, 0.0);
+      model->Add<Linear<> >(4 * 3, 2);
+      model->Add<LogSoftMax<> >();
+    }
+
+    ~GradientFunction()
+    {
+      delete model;
+    }
+
+    double Gradient(arma::mat& gradient) const
+    {
+      double error = model->Evaluate(model->Parameters(), 0, 2);
+      model->Gradient(model->Parameters(), 0, gradient, 2);
+      return error;
+    }
+
+    arma::mat& Parameters() { return model->Parameters(); }
+
+    FFN<NegativeLogLikelihood<>, NguyenWidrowInitialization>* model;
+    arma::mat input, target;
+  } function;
+
+  BOOST_REQUIRE_LE(CheckGradient(function), 1e-3);
+}
+
+/**
+ * Test that the SparseEmbedding layer looks up the embeddings of a batch, sums
+ * the gradients of repeated indices, and updates only the used embeddings, and
+ * only when Step() is called.
+ */
+BOOST_AUTO_TEST_CASE(SparseEmbeddingLayerTest)
+{
+  SparseEmbedding<> module(10, 3, LazySGDUpdate(0.5));
+  const arma::mat table = module.Embedding();
+
+  // Two sequences of two tokens; index 4 is used twice.
+  arma::mat input("4 2; 7 4");
+  arma::mat output;
+  module.Forward(input, output);
+  BOOST_REQUIRE_EQUAL(output.n_rows, 6);
+  BOOST_REQUIRE_EQUAL(output.n_cols, 2);
+  CheckMatrices(output.submat(0, 0, 2, 0), table.col(3));
+  CheckMatrices(output.submat(3, 0, 5, 0), table.col(6));
+  CheckMatrices(output.submat(0, 1, 2, 1), table.col(1));
+  CheckMatrices(output.submat(3, 1, 5, 1), table.col(3));
+
+  // The network has no parameters for the table.
+  BOOST_REQUIRE_EQUAL(module.Parameters().n_elem, 0);
+
+  arma::mat error = arma::randu(6, 2);
+  arma::mat delta, gradient;
+  module.Backward(output, error, delta);
+  BOOST_REQUIRE_EQUAL(delta.n_rows, 2);
+  BOOST_REQUIRE_EQUAL(delta.n_cols, 2);
+  module.Gradient(input, error, gradient);
+
+  BOOST_REQUIRE_EQUAL(module.SparseIndices().n_elem, 3);
+  BOOST_REQUIRE_EQUAL(module.SparseIndices()[0], 1);
+  BOOST_REQUIRE_EQUAL(module.SparseIndices()[1], 3);
+  BOOST_REQUIRE_EQUAL(module.SparseIndices()[2], 6);
+  CheckMatrices(module.SparseGradient().col(1),
+      error.submat(0, 0, 2, 0) + error.submat(3, 1, 5, 1));
+
+  // Computing the gradient doesn't change the table, and the gradients add up
+  // until the next step.
+  CheckMatrices(module.Embedding(), table);
+  module.Gradient(input, error, gradient);
+  BOOST_REQUIRE_EQUAL(module.SparseIndices().n_elem, 3);
+  CheckMatrices(module.SparseGradient().col(1),
+      2 * (error.submat(0, 0, 2, 0) + error.submat(3, 1, 5, 1)));
+  CheckMatrices(module.Embedding(), table);
+
+  module.ResetSparseGradient();
+  BOOST_REQUIRE_EQUAL(module.SparseIndices().n_elem, 0);
+  module.Gradient(input, error, gradient);
+  module.Step();
+
+  arma::mat expected = table;
+  expected.col(1) -= 0.5 * error.submat(0, 1, 2, 1);
+  expected.col(3) -= 0.5 * (error.submat(0, 0, 2, 0) +
+      error.submat(3, 1, 5, 1));
+  expected.col(6) -= 0.5 * error.submat(3, 0, 5, 0);
+  CheckMatrices(module.Embedding(), expected);
+
+  // The step discarded the gradient, so another step does nothing.
+  BOOST_REQUIRE_EQUAL(module.SparseIndices().n_elem, 0);
+  module.Step();
+  CheckMatrices(module.Embedding(), expected);
+}
+
+/**
+ * Test that a network initializes the table of a SparseEmbedding layer with its
+ * own initialization rule, and that training it updates only the embeddings
+ * that the data uses, including when the gradient is computed with several
+ * threads.
+ */
+BOOST_AUTO_TEST_CASE(SparseEmbeddingFFNTest)
+{
+  // Two tokens per point, between 1 and 5; the class is given by the first.
+  arma::mat data = arma::floor(arma::randu(2, 200) * 5) + 1;
+  arma::mat labels(1, data.n_cols);
+  for (size_t i = 0; i < data.n_cols; ++i)
+    labels(i) = (data(0, i) <= 2) ? 1 : 2;
+
+  for (size_t threads = 1; threads <= 2; ++threads)
+  {
+    FFN<NegativeLogLikelihood<>, ConstInitialization> model(
+        NegativeLogLikelihood<>(), ConstInitialization(0.5));
+    SparseEmbedding<>* embedding = new SparseEmbedding<>(10, 3,
+        LazySGDUpdate(0.1));
+    model.Add(embedding);
+    model.Add<Linear<>>(6, 2);
+    model.Add<LogSoftMax<>>();
+    model.Threads() = threads;
+
+    model.ResetParameters();
+    CheckMatrices(embedding->Embedding(), arma::mat(3, 10).fill(0.5));
+
+    ens::StandardSGD optimizer(0.1, 10, 2000);
+    model.Train(data, labels, optimizer);
+
+    // The indices 6 to 10 are never used.
+    CheckMatrices(embedding->Embedding().cols(5, 9),
+        arma::mat(3, 5).fill(0.5));
+    BOOST_REQUIRE_GT(arma::abs(embedding->Embedding().cols(0, 4) - 0.5).max(),
+        1e-3);
+    BOOST_REQUIRE_EQUAL(embedding->SparseIndices().n_elem, 0);
+  }
+}
+
+/**
+ * Test that the lazy AdaGrad and Adam update rules take the dense step on the
+ * used columns and leave the other columns untouched.
+ */
+BOOST_AUTO_TEST_CASE(LazySparseUpdateTest)
+{
+  const arma::mat table = arma::randu(3, 5);
+  const arma::uvec indices("0 3");
+  const arma::mat gradient = arma::randn(3, 2);
+
+  arma::mat embedding = table;
+  LazyAdaGradUpdate adagrad(0.1, 1e-8);
+  adagrad.Update(embedding, indices, gradient);
+  adagrad.Update(embedding, indices, gradient);
+  arma::mat expected = table;
+  expected.cols(indices) -= 0.1 * gradient / (arma::abs(gradient) + 1e-8) +
+      0.1 * gradient / (std::sqrt(2.0) * arma::abs(gradient) + 1e-8);
+  CheckMatrices(embedding, expected, 1e-5);
+
+  embedding = table;
+  LazyAdamUpdate adam(0.01, 0.9, 0.999, 1e-8);
+  adam.Update(embedding, indices, gradient);
+  expected = table;
+
+  // The first Adam step is stepSize * sign(gradient), up to epsilon.
+  expected.cols(indices) -= 0.01 * arma::sign(gradient);
+  CheckMatrices(embedding, expected, 1e-3);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -250,4 +250,28 @@ BOOST_AUTO_TEST_CASE(NStepQLearningTest)
   Log::Debug << "Total test episodes: " << testEpisodes << std::endl;
 }
 
+/**
+ * Make sure that a snapshot of the target network that was loaded before a new
+ * one is published stays valid and unchanged, so workers can keep using it.
+ */
+BOOST_AUTO_TEST_CASE(NetworkSnapshotTest)
+{
+  FFN<MeanSquaredError<>, GaussianInitialization> model(MeanSquaredError<>(),
+      GaussianInitialization(0, 0.001));
+  model.Add<Linear<>>(4, 2);
+  model.ResetParameters();
+  const arma::mat oldParameters = model.Parameters();
+
+  NetworkSnapshot<decltype(model)> snapshot(model);
+  std::shared_ptr<const decltype(model)> oldSnapshot = snapshot.Load();
+
+  model.Parameters().fill(1.0);
+  snapshot.Publish(model);
+  std::shared_ptr<const decltype(model)> newSnapshot = snapshot.Load();
+
+  BOOST_REQUIRE(oldSnapshot != newSnapshot);
+  CheckMatrices(oldSnapshot->Parameters(), oldParameters);
+  CheckMatrices(newSnapshot->Parameters(), model.Parameters());
+}
+
 BOOST_AUTO_TEST_SUITE_END();
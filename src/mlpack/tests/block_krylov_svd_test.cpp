@@ -109,4 +109,39 @@ BOOST_AUTO_TEST_CASE(RandomizedBlockKrylovSVDNoisyLowRankTest)
   BOOST_REQUIRE_SMALL(error, 1e-2);
 }
 
+/**
+ * The randomized block krylov SVD of sparse and single-precision matrices
+ * should give the same singular values as for the dense matrix.
+ */
+BOOST_AUTO_TEST_CASE(RandomizedBlockKrylovSVDSparseAndFloatTest)
+{
+  arma::mat data;
+  CreateNoisyLowRankMatrix(data, 100, 300, 5, 0.5);
+
+  // Make the matrix sparse by dropping its smallest entries.
+  data.elem(arma::find(arma::abs(data) < 0.02)).zeros();
+
+  const size_t rank = 5;
+
+  arma::mat U1, V1;
+  arma::vec s1;
+  arma::svd_econ(U1, s1, V1, data);
+
+  svd::RandomizedBlockKrylovSVD rSVD(10, 20);
+
+  arma::mat U2, V2;
+  arma::vec s2;
+  rSVD.Apply(arma::sp_mat(data), U2, s2, V2, rank);
+  double error = arma::max(arma::abs(s1.subvec(0, rank) -
+      s2.subvec(0, rank)));
+  BOOST_REQUIRE_SMALL(error, 1e-2);
+
+  arma::fmat fU, fV;
+  arma::fvec fs;
+  rSVD.Apply(arma::conv_to<arma::fmat>::from(data), fU, fs, fV, rank);
+  error = arma::max(arma::abs(s1.subvec(0, rank) -
+      arma::conv_to<arma::vec>::from(fs.subvec(0, rank))));
+  BOOST_REQUIRE_SMALL(error, 1e-2);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
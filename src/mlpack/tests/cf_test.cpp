@@ -13,6 +13,7 @@
 
 #include <mlpack/core.hpp>
 #include <mlpack/methods/cf/cf.hpp>
+#include <mlpack/methods/cf/cf_serving_model.hpp>
 #include <mlpack/methods/cf/decomposition_policies/batch_svd_method.hpp>
 #include <mlpack/methods/cf/decomposition_policies/bias_svd_method.hpp>
 #include <mlpack/methods/cf/decomposition_policies/randomized_svd_method.hpp>
@@ -20,6 +21,7 @@
 #include <mlpack/methods/cf/decomposition_policies/svd_complete_method.hpp>
 #include <mlpack/methods/cf/decomposition_policies/svd_incomplete_method.hpp>
 #include <mlpack/methods/cf/decomposition_policies/svdplusplus_method.hpp>
+#include <mlpack/methods/cf/decomposition_policies/weighted_als_method.hpp>
 #include <mlpack/methods/cf/normalization/no_normalization.hpp>
 #include <mlpack/methods/cf/normalization/overall_mean_normalization.hpp>
 #include <mlpack/methods/cf/normalization/user_mean_normalization.hpp>
@@ -580,6 +582,15 @@ BOOST_AUTO_TEST_CASE(CFGetRecommendationsAllUsersSVDPPTest)
   GetRecommendationsAllUsers<SVDPlusPlusPolicy>();
 }
 
+/**
+ * Make sure that correct number of recommendations are generated when query
+ * set for weighted ALS method.
+ */
+BOOST_AUTO_TEST_CASE(CFGetRecommendationsAllUsersWeightedALSTest)
+{
+  GetRecommendationsAllUsers<WeightedALSPolicy>();
+}
+
 /**
  * Make sure that the recommendations are generated for queried users only
  * for randomized SVD.
@@ -652,6 +663,148 @@ BOOST_AUTO_TEST_CASE(CFGetRecommendationsQueriedUserSVDPPTest)
   GetRecommendationsQueriedUser<SVDPlusPlusPolicy>();
 }
 
+/**
+ * Make sure that the recommendations of a user do not depend on the other
+ * queried users, and that no recommended item was already rated by the user.
+ */
+BOOST_AUTO_TEST_CASE(CFGetRecommendationsConsistencyTest)
+{
+  arma::mat dataset;
+  data::Load("GroupLensSmall.csv", dataset);
+
+  RegSVDPolicy decomposition;
+  CFType<RegSVDPolicy> c(dataset, decomposition, 5, 5, 30);
+
+  const size_t numRecs = 10;
+  arma::Mat<size_t> allRecommendations;
+  c.GetRecommendations(numRecs, allRecommendations);
+
+  // Query every third user, in reverse order.
+  arma::Col<size_t> users((allRecommendations.n_cols + 2) / 3);
+  for (size_t i = 0; i < users.n_elem; ++i)
+    users[i] = allRecommendations.n_cols - 1 - 3 * i;
+  arma::Mat<size_t> recommendations;
+  c.GetRecommendations(numRecs, recommendations, users);
+
+  BOOST_REQUIRE_EQUAL(recommendations.n_rows, numRecs);
+  BOOST_REQUIRE_EQUAL(recommendations.n_cols, users.n_elem);
+  for (size_t i = 0; i < users.n_elem; ++i)
+  {
+    for (size_t j = 0; j < numRecs; ++j)
+    {
+      BOOST_REQUIRE_EQUAL(recommendations(j, i),
+          allRecommendations(j, users[i]));
+      BOOST_REQUIRE_EQUAL(c.CleanedData()(recommendations(j, i), users[i]),
+          0.0);
+    }
+  }
+}
+
+/**
+ * Make sure that recommendations found with FastMKS over the item factors are
+ * the same as those found by scoring every item, for a W * H decomposition.
+ */
+BOOST_AUTO_TEST_CASE(CFGetApproximateRecommendationsTest)
+{
+  arma::mat dataset;
+  data::Load("GroupLensSmall.csv", dataset);
+
+  RegSVDPolicy decomposition;
+  CFType<RegSVDPolicy> c(dataset, decomposition, 5, 5, 30);
+
+  const size_t numRecs = 5;
+  arma::Col<size_t> users = arma::linspace<arma::Col<size_t>>(0, 49, 50);
+  arma::Mat<size_t> recommendations, approximateRecommendations;
+  c.GetRecommendations(numRecs, recommendations, users);
+  c.GetApproximateRecommendations(numRecs, approximateRecommendations, users,
+      1.0);
+
+  BOOST_REQUIRE_EQUAL(approximateRecommendations.n_rows, numRecs);
+  BOOST_REQUIRE_EQUAL(approximateRecommendations.n_cols, users.n_elem);
+  CheckMatrices(recommendations, approximateRecommendations);
+
+  // An invalid candidate ratio should throw.
+  BOOST_REQUIRE_THROW(c.GetApproximateRecommendations(numRecs,
+      approximateRecommendations, users, 0.5), std::invalid_argument);
+}
+
+/**
+ * Make sure that a CFServingModel predicts the same ratings as the CF model it
+ * was built from, including the biases and the normalization, and that a
+ * sharded model can be saved and loaded one shard at a time.
+ */
+BOOST_AUTO_TEST_CASE(CFServingModelTest)
+{
+  arma::mat dataset;
+  data::Load("GroupLensSmall.csv", dataset);
+
+  BiasSVDPolicy decomposition;
+  CFType<BiasSVDPolicy, CombinedNormalization<UserMeanNormalization,
+      ZScoreNormalization>> c(dataset, decomposition, 5, 5, 10);
+
+  CFServingModel model;
+  model.Build<EuclideanSearch, SimilarityInterpolation>(c);
+  BOOST_REQUIRE_EQUAL(model.NumUsers(), c.CleanedData().n_cols);
+  BOOST_REQUIRE_EQUAL(model.NumItems(), c.CleanedData().n_rows);
+
+  // Predict a sample of the combinations with both models.
+  arma::Mat<size_t> combinations(2, 500);
+  for (size_t i = 0; i < combinations.n_cols; ++i)
+  {
+    combinations(0, i) = (7 * i) % model.NumUsers();
+    combinations(1, i) = (13 * i) % model.NumItems();
+  }
+  arma::vec predictions, servingPredictions;
+  c.Predict<EuclideanSearch, SimilarityInterpolation>(combinations,
+      predictions);
+  model.Predict(combinations, servingPredictions);
+  for (size_t i = 0; i < combinations.n_cols; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(servingPredictions[i], predictions[i], 1e-5);
+    BOOST_REQUIRE_CLOSE(model.Predict(combinations(0, i), combinations(1, i)),
+        predictions[i], 1e-5);
+  }
+
+  // Save the model in shards of 100 users, and load one of them.
+  const size_t usersPerShard = 100;
+  model.Save("cf_serving_model_test", usersPerShard);
+  const size_t numShards = (model.NumUsers() + usersPerShard - 1) /
+      usersPerShard;
+
+  CFServingModel shard;
+  shard.Load("cf_serving_model_test", 1);
+  BOOST_REQUIRE_EQUAL(shard.FirstUser(), usersPerShard);
+  BOOST_REQUIRE_EQUAL(shard.NumShardUsers(), usersPerShard);
+  for (size_t u = usersPerShard; u < 2 * usersPerShard; u += 7)
+  {
+    for (size_t i = 0; i < model.NumItems(); i += 11)
+      BOOST_REQUIRE_CLOSE(shard.Predict(u, i), model.Predict(u, i), 1e-5);
+  }
+  BOOST_REQUIRE_THROW(shard.Predict(0, 0), std::invalid_argument);
+  BOOST_REQUIRE_THROW(shard.Load("cf_serving_model_test", numShards),
+      std::invalid_argument);
+
+  // Loading every shard gives back the whole model.
+  CFServingModel full;
+  full.Load("cf_serving_model_test");
+  CheckMatrices(full.Items(), model.Items());
+  CheckMatrices(full.Users(), model.Users());
+
+  arma::Col<size_t> users("3 150 199");
+  arma::Mat<size_t> recommendations, fullRecommendations;
+  model.GetRecommendations(10, recommendations, users);
+  full.GetRecommendations(10, fullRecommendations, users);
+  CheckMatrices(recommendations, fullRecommendations);
+
+  remove("cf_serving_model_test.meta.bin");
+  remove("cf_serving_model_test.items.bin");
+  for (size_t s = 0; s < numShards; ++s)
+  {
+    remove(("cf_serving_model_test.users." + std::to_string(s) +
+        ".bin").c_str());
+  }
+}
+
 /**
  * Make sure recommendations that are generated are reasonably accurate
  * for randomized SVD.
@@ -788,6 +941,15 @@ BOOST_AUTO_TEST_CASE(CFPredictSVDPPTest)
   CFPredict<SVDPlusPlusPolicy>();
 }
 
+/**
+ * Make sure that Predict() is returning reasonable results for weighted ALS
+ * method.
+ */
+BOOST_AUTO_TEST_CASE(CFPredictWeightedALSTest)
+{
+  CFPredict<WeightedALSPolicy>();
+}
+
 // Compare batch Predict() and individual Predict() for randomized SVD.
 BOOST_AUTO_TEST_CASE(CFBatchPredictRandSVDTest)
 {
@@ -1228,4 +1390,95 @@ BOOST_AUTO_TEST_CASE(CFPredictRegressionInterpolation)
             RegressionInterpolation>(2.0);
 }
 
+/**
+ * Make sure that folding a user into a model gives it the same factors as
+ * folding the same ratings into an existing user, and that recommendations can
+ * be generated for it.
+ */
+BOOST_AUTO_TEST_CASE(CFFoldInTest)
+{
+  arma::mat dataset;
+  data::Load("GroupLensSmall.csv", dataset);
+
+  CFType<WeightedALSPolicy, UserMeanNormalization> c(dataset,
+      WeightedALSPolicy(), 5, 5, 30);
+  const size_t numItems = c.CleanedData().n_rows;
+  const size_t numUsers = c.CleanedData().n_cols;
+
+  // Take the raw ratings of user 7.
+  arma::sp_mat ratings(numItems, 1);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+    if ((size_t) dataset(0, i) == 7)
+      ratings((size_t) dataset(1, i), 0) = dataset(2, i);
+
+  // Add them as a new user.
+  arma::Col<size_t> newUser(1);
+  newUser[0] = numUsers;
+  c.FoldIn(ratings, newUser);
+
+  BOOST_REQUIRE_EQUAL(c.CleanedData().n_cols, numUsers + 1);
+  BOOST_REQUIRE_EQUAL(c.Decomposition().H().n_cols, numUsers + 1);
+  BOOST_REQUIRE_EQUAL(c.Normalization().Mean().n_elem, numUsers + 1);
+
+  // Replace the ratings of user 7 by the same ratings.
+  arma::Col<size_t> oldUser(1);
+  oldUser[0] = 7;
+  c.FoldIn(ratings, oldUser);
+
+  BOOST_REQUIRE_EQUAL(c.CleanedData().n_cols, numUsers + 1);
+  const arma::mat& h = c.Decomposition().H();
+  for (size_t k = 0; k < h.n_rows; ++k)
+    BOOST_REQUIRE_SMALL(h(k, 7) - h(k, numUsers), 1e-10);
+  BOOST_REQUIRE_SMALL(c.Normalization().Mean()[7] -
+      c.Normalization().Mean()[numUsers], 1e-10);
+
+  // The recommendations of the new user don't contain the items it rated.
+  arma::Mat<size_t> recommendations;
+  c.GetRecommendations(5, recommendations, newUser);
+  BOOST_REQUIRE_EQUAL(recommendations.n_rows, 5);
+  BOOST_REQUIRE_EQUAL(recommendations.n_cols, 1);
+  for (size_t i = 0; i < recommendations.n_rows; ++i)
+  {
+    BOOST_REQUIRE_LT(recommendations[i], numItems);
+    BOOST_REQUIRE_EQUAL(ratings(recommendations[i], 0), 0.0);
+  }
+}
+
+/**
+ * Make sure that the neighbor search kept between queries gives the same
+ * recommendations as a neighbor search built for each query, also when the
+ * neighbor search policy changes between queries.
+ */
+BOOST_AUTO_TEST_CASE(CFNeighborSearchCacheTest)
+{
+  arma::mat dataset;
+  data::Load("GroupLensSmall.csv", dataset);
+
+  CFType<> c(dataset, NMFPolicy(), 5, 5, 30);
+
+  arma::Col<size_t> users = arma::linspace<arma::Col<size_t>>(0, 19, 20);
+  arma::Col<size_t> otherUsers = arma::linspace<arma::Col<size_t>>(20, 39, 20);
+
+  arma::Mat<size_t> cosineRecommendations, pearsonRecommendations,
+      otherRecommendations;
+  c.GetRecommendations<CosineSearch>(5, cosineRecommendations, users);
+  c.GetRecommendations<CosineSearch>(5, otherRecommendations, otherUsers);
+  c.GetRecommendations<PearsonSearch>(5, pearsonRecommendations, users);
+
+  // A copy of the model builds its neighbor searches again.
+  for (size_t run = 0; run < 2; ++run)
+  {
+    CFType<> copy(c);
+    CFType<>& model = (run == 0) ? c : copy;
+
+    arma::Mat<size_t> recommendations;
+    model.GetRecommendations<CosineSearch>(5, recommendations, users);
+    CheckMatrices(recommendations, cosineRecommendations);
+    model.GetRecommendations<CosineSearch>(5, recommendations, otherUsers);
+    CheckMatrices(recommendations, otherRecommendations);
+    model.GetRecommendations<PearsonSearch>(5, recommendations, users);
+    CheckMatrices(recommendations, pearsonRecommendations);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -11,6 +11,8 @@
  */
 #include <mlpack/core.hpp>
 #include <mlpack/bindings/cli/cli_option.hpp>
+#include <mlpack/bindings/cli/serve.hpp>
+#include <mlpack/bindings/cli/stream.hpp>
 #include <mlpack/core/kernels/gaussian_kernel.hpp>
 
 #include <boost/test/unit_test.hpp>
@@ -631,4 +633,156 @@ BOOST_AUTO_TEST_CASE(DeleteAllocatedMemoryModelTest)
       (const void*) NULL, (void*) NULL);
 }
 
+// Test that in server mode, a model is loaded only once and then taken from
+// the cache, until its file changes.
+BOOST_AUTO_TEST_CASE(GetParamCachedModelTest)
+{
+  ModelCache& cache = ModelCache::GetSingleton();
+  cache.Enabled() = true;
+
+  GaussianKernel gk(5.0);
+  data::Save("kernel.bin", "model", gk);
+
+  GaussianKernel* models[2];
+  for (size_t i = 0; i < 2; ++i)
+  {
+    util::ParamData d;
+    d.value = boost::any(make_tuple((GaussianKernel*) NULL,
+        string("kernel.bin")));
+    d.input = true;
+    d.loaded = false;
+
+    GaussianKernel** output = NULL;
+    GetParam<GaussianKernel*>((const util::ParamData&) d, (void*) NULL,
+        (void*) &output);
+    models[i] = *output;
+
+    // The cache owns the model, so it must not be deleted with the
+    // parameters.
+    void* result = NULL;
+    GetAllocatedMemory<GaussianKernel*>((const util::ParamData&) d,
+        (const void*) NULL, (void*) &result);
+    BOOST_REQUIRE(cache.Owns(result));
+  }
+
+  BOOST_REQUIRE_EQUAL(models[0], models[1]);
+  BOOST_REQUIRE_EQUAL(models[0]->Bandwidth(), 5.0);
+  BOOST_REQUIRE_EQUAL(cache.Size(), 1);
+
+  // Once the file is gone, the cached model must not be used anymore.
+  remove("kernel.bin");
+  BOOST_REQUIRE(cache.Get<GaussianKernel>("kernel.bin") == NULL);
+  BOOST_REQUIRE_EQUAL(cache.Size(), 0);
+
+  cache.Enabled() = false;
+}
+
+// Test that requests of server mode are split like command lines.
+BOOST_AUTO_TEST_CASE(SplitRequestTest)
+{
+  vector<string> arguments = SplitRequest("  --input_file \"my data.csv\" "
+      "-k 5\t--flag \"\"");
+
+  BOOST_REQUIRE_EQUAL(arguments.size(), 6);
+  BOOST_REQUIRE_EQUAL(arguments[0], "--input_file");
+  BOOST_REQUIRE_EQUAL(arguments[1], "my data.csv");
+  BOOST_REQUIRE_EQUAL(arguments[2], "-k");
+  BOOST_REQUIRE_EQUAL(arguments[3], "5");
+  BOOST_REQUIRE_EQUAL(arguments[4], "--flag");
+  BOOST_REQUIRE_EQUAL(arguments[5], "");
+
+  BOOST_REQUIRE(SplitRequest(" \t ").empty());
+  BOOST_REQUIRE_THROW(SplitRequest("--input_file \"data.csv"),
+      std::invalid_argument);
+}
+
+// Test that the chunk size of streaming mode is taken out of the arguments.
+BOOST_AUTO_TEST_CASE(StreamChunkSizeTest)
+{
+  vector<string> arguments = { "program", "--test_file", "test.csv",
+      "--stream_chunk_size", "100", "-v" };
+  vector<char*> argv;
+  for (size_t i = 0; i < arguments.size(); ++i)
+    argv.push_back(&arguments[i][0]);
+  int argc = argv.size();
+
+  BOOST_REQUIRE_EQUAL(StreamChunkSize(argc, argv.data()), 100);
+  BOOST_REQUIRE_EQUAL(argc, 4);
+  BOOST_REQUIRE_EQUAL(string(argv[3]), "-v");
+  BOOST_REQUIRE_EQUAL(StreamChunkSize(argc, argv.data()), 0);
+
+  arguments = { "program", "--stream_chunk_size=0" };
+  argv = { &arguments[0][0], &arguments[1][0] };
+  argc = 2;
+  BOOST_REQUIRE_THROW(StreamChunkSize(argc, argv.data()),
+      std::invalid_argument);
+}
+
+// Test that the points of a text file are read in chunks.
+BOOST_AUTO_TEST_CASE(ReadChunkTest)
+{
+  istringstream stream("1,2,3\n4, 5,6\r\n\n7,8,9\n10,11,12\n13,14,15\n");
+
+  arma::mat chunk;
+  size_t line = 0;
+  ReadChunk(stream, ',', 2, chunk, line);
+  BOOST_REQUIRE_EQUAL(chunk.n_rows, 3);
+  BOOST_REQUIRE_EQUAL(chunk.n_cols, 2);
+  BOOST_REQUIRE_EQUAL(chunk(1, 1), 5.0);
+  BOOST_REQUIRE_EQUAL(line, 2);
+
+  ReadChunk(stream, ',', 2, chunk, line);
+  BOOST_REQUIRE_EQUAL(chunk.n_cols, 2);
+  BOOST_REQUIRE_EQUAL(chunk(0, 0), 7.0);
+  BOOST_REQUIRE_EQUAL(chunk(2, 1), 12.0);
+  BOOST_REQUIRE_EQUAL(line, 5);
+
+  ReadChunk(stream, ',', 2, chunk, line);
+  BOOST_REQUIRE_EQUAL(chunk.n_cols, 1);
+  ReadChunk(stream, ',', 2, chunk, line);
+  BOOST_REQUIRE_EQUAL(chunk.n_elem, 0);
+
+  istringstream bad("1 2\n3 4 5\n");
+  line = 0;
+  BOOST_REQUIRE_THROW(ReadChunk(bad, ' ', 10, chunk, line),
+      std::runtime_error);
+}
+
+// Test that the matrix outputs of each chunk are appended to their file.
+BOOST_AUTO_TEST_CASE(AppendParamTest)
+{
+  util::ParamData d;
+  d.name = "predictions";
+  d.input = false;
+  d.noTranspose = false;
+
+  d.value = boost::any(make_tuple(arma::Row<size_t>("1 2"),
+      string("predictions.csv")));
+  bool truncate = true;
+  AppendParam<arma::Row<size_t>>((const util::ParamData&) d,
+      (const void*) &truncate, NULL);
+  BOOST_REQUIRE_EQUAL(std::get<0>(*boost::any_cast<
+      tuple<arma::Row<size_t>, string>>(&d.value)).n_elem, 0);
+
+  std::get<0>(*boost::any_cast<tuple<arma::Row<size_t>, string>>(
+      &d.value)) = arma::Row<size_t>("3");
+  truncate = false;
+  AppendParam<arma::Row<size_t>>((const util::ParamData&) d,
+      (const void*) &truncate, NULL);
+
+  arma::Row<size_t> predictions;
+  data::Load("predictions.csv", predictions, true);
+  remove("predictions.csv");
+
+  BOOST_REQUIRE_EQUAL(predictions.n_elem, 3);
+  for (size_t i = 0; i < 3; ++i)
+    BOOST_REQUIRE_EQUAL(predictions[i], i + 1);
+
+  // Binary files can't be appended to.
+  d.value = boost::any(make_tuple(arma::mat(2, 2, arma::fill::ones),
+      string("output.bin")));
+  BOOST_REQUIRE_THROW(AppendParam<arma::mat>((const util::ParamData&) d,
+      (const void*) &truncate, NULL), std::invalid_argument);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -436,4 +436,37 @@ BOOST_AUTO_TEST_CASE(MoveConstructorAndOperatorCosineTreeTest)
   }
 }
 
+/**
+ * Make sure that the centroid and the cosines of a node, which are computed in
+ * parallel, match the ones computed directly from the dataset.
+ */
+BOOST_AUTO_TEST_CASE(CosineNodeCentroidAndCosinesTest)
+{
+  arma::mat data = arma::randu(20, 500);
+  // A zero column must get a cosine of zero.
+  data.col(17).zeros();
+
+  CosineTree node(data);
+
+  CheckMatrices(node.Centroid(), arma::mean(data, 1));
+
+  arma::vec cosines;
+  node.CalculateCosines(cosines);
+  BOOST_REQUIRE_EQUAL(cosines.n_elem, data.n_cols);
+
+  const size_t splitPoint = node.SplitPointIndex();
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    if (i == 17 || splitPoint == 17)
+    {
+      BOOST_REQUIRE_SMALL(cosines(i), 1e-10);
+      continue;
+    }
+
+    const double cosine = std::abs(arma::norm_dot(data.col(splitPoint),
+        data.col(i)));
+    BOOST_REQUIRE_CLOSE(cosines(i), cosine, 1e-5);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -459,6 +459,25 @@ BOOST_AUTO_TEST_CASE(KFoldCVMSETest)
   cv.Model();
 }
 
+/**
+ * Make sure that k-fold cross-validation gives the same results when the folds
+ * are trained and evaluated in parallel.
+ */
+BOOST_AUTO_TEST_CASE(KFoldCVParallelTest)
+{
+  arma::mat data = arma::randu<arma::mat>(4, 500);
+  arma::rowvec responses = arma::sum(data) + 0.1 *
+      arma::randn<arma::rowvec>(500);
+
+  KFoldCV<LinearRegression, MSE> cv(5, data, responses, false);
+  BOOST_REQUIRE(!cv.Parallel());
+  const double serialMSE = cv.Evaluate();
+
+  cv.Parallel() = true;
+  BOOST_REQUIRE(cv.Parallel());
+  BOOST_REQUIRE_CLOSE(cv.Evaluate(), serialMSE, 1e-5);
+}
+
 /**
  * Test k-fold cross-validation with the Accuracy metric.
  */
@@ -309,4 +309,67 @@ BOOST_AUTO_TEST_CASE(RandomPointSelectionTest)
   BOOST_REQUIRE_EQUAL(assignments.n_elem, points.n_cols);
 }
 
+/**
+ * Check that a non-core point between two clusters joins the cluster of its
+ * closest core point, instead of merging the two clusters, with any block size
+ * and in both batch and single mode.
+ */
+BOOST_AUTO_TEST_CASE(BorderPointTest)
+{
+  // Two clusters of five points, a border point at 0.9 (closer to the first
+  // cluster), and noise at 10.0.
+  arma::mat points("-0.8 -0.6 -0.4 -0.2 0.0 0.9 1.85 2.05 2.25 2.45 2.65 10.0");
+
+  const size_t blockSizes[] = { 10000, 2, 1 };
+  for (size_t b = 0; b < 3; ++b)
+  {
+    for (size_t batchMode = 0; batchMode < 2; ++batchMode)
+    {
+      DBSCAN<> d(1.0, 5, (batchMode == 1), RangeSearch<>(),
+          OrderedPointSelection(), blockSizes[b]);
+
+      arma::Row<size_t> assignments;
+      const size_t clusters = d.Cluster(points, assignments);
+
+      BOOST_REQUIRE_EQUAL(clusters, 2);
+      BOOST_REQUIRE_EQUAL(assignments.n_elem, points.n_cols);
+      for (size_t i = 0; i < 6; ++i)
+        BOOST_REQUIRE_EQUAL(assignments[i], 0);
+      for (size_t i = 6; i < 11; ++i)
+        BOOST_REQUIRE_EQUAL(assignments[i], 1);
+      BOOST_REQUIRE_EQUAL(assignments[11], SIZE_MAX);
+    }
+  }
+}
+
+/**
+ * Check that the results do not depend on the block size, or on whether the
+ * search is done with a tree or naively.
+ */
+BOOST_AUTO_TEST_CASE(BlockSizeTest)
+{
+  arma::mat points(3, 1000, arma::fill::randu);
+
+  DBSCAN<> d(0.1, 5);
+  arma::Row<size_t> assignments;
+  const size_t clusters = d.Cluster(points, assignments);
+
+  DBSCAN<> blockD(0.1, 5, true, RangeSearch<>(), OrderedPointSelection(), 37);
+  arma::Row<size_t> blockAssignments;
+  const size_t blockClusters = blockD.Cluster(points, blockAssignments);
+
+  DBSCAN<> naiveD(0.1, 5, true, RangeSearch<>(true), OrderedPointSelection(),
+      37);
+  arma::Row<size_t> naiveAssignments;
+  const size_t naiveClusters = naiveD.Cluster(points, naiveAssignments);
+
+  BOOST_REQUIRE_EQUAL(clusters, blockClusters);
+  BOOST_REQUIRE_EQUAL(clusters, naiveClusters);
+  for (size_t i = 0; i < points.n_cols; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(assignments[i], blockAssignments[i]);
+    BOOST_REQUIRE_EQUAL(assignments[i], naiveAssignments[i]);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
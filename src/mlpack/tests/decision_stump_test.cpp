@@ -423,4 +423,33 @@ BOOST_AUTO_TEST_CASE(DecisionStumpTrainReturnEntropy)
   BOOST_REQUIRE_EQUAL(std::isfinite(gain), true);
 }
 
+/**
+ * Test that a decision stump trained with the boosting constructor from a stump
+ * that presorted the data is the same as one trained without presorting.
+ */
+BOOST_AUTO_TEST_CASE(DecisionStumpPresortTest)
+{
+  const size_t numClasses = 3;
+  arma::mat trainingData = arma::randu<arma::mat>(5, 300);
+  arma::Row<size_t> labels(300);
+  for (size_t i = 0; i < 300; ++i)
+    labels[i] = (trainingData(2, i) < 0.3) ? 0 :
+        ((trainingData(2, i) < 0.7) ? 1 : 2);
+  arma::rowvec weights = arma::randu<arma::rowvec>(300);
+
+  DecisionStump<> ds(trainingData, labels, numClasses, 5);
+  DecisionStump<> presortedDs(ds);
+  presortedDs.Presort(trainingData);
+
+  DecisionStump<> ws(ds, trainingData, labels, numClasses, weights);
+  DecisionStump<> presortedWs(presortedDs, trainingData, labels, numClasses,
+      weights);
+
+  BOOST_REQUIRE_EQUAL(ws.SplitDimension(), presortedWs.SplitDimension());
+  CheckMatrices(ws.Split(), presortedWs.Split());
+  BOOST_REQUIRE_EQUAL(ws.BinLabels().n_elem, presortedWs.BinLabels().n_elem);
+  for (size_t i = 0; i < ws.BinLabels().n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(ws.BinLabels()[i], presortedWs.BinLabels()[i]);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -370,6 +370,71 @@ BOOST_AUTO_TEST_CASE(BestBinaryNumericSplitNoGainTest)
   BOOST_REQUIRE_EQUAL(classProbabilities.n_elem, 0);
 }
 
+/**
+ * Check that the HistogramNumericSplit finds the same split as the
+ * BestBinaryNumericSplit when every distinct value gets its own bin.
+ */
+BOOST_AUTO_TEST_CASE(HistogramNumericSplitMatchesBestTest)
+{
+  arma::vec values = arma::floor(arma::randu<arma::vec>(500) * 100);
+  arma::Row<size_t> labels(values.n_elem);
+  for (size_t i = 0; i < values.n_elem; ++i)
+    labels[i] = (values[i] + 10 * arma::randn() > 50) ? 1 : 0;
+  arma::rowvec weights(labels.n_elem, arma::fill::randu);
+
+  arma::vec bestProbabilities, histogramProbabilities;
+  BestBinaryNumericSplit<GiniGain>::template AuxiliarySplitInfo<double> aux;
+  HistogramNumericSplit<GiniGain>::template AuxiliarySplitInfo<double>
+      histogramAux;
+
+  const double bestGain = GiniGain::Evaluate<false>(labels, 2, weights);
+  const double gain = BestBinaryNumericSplit<GiniGain>::SplitIfBetter<false>(
+      bestGain, values, labels, 2, weights, 5, 1e-7, bestProbabilities, aux);
+  const double histogramGain =
+      HistogramNumericSplit<GiniGain>::SplitIfBetter<false>(bestGain, values,
+      labels, 2, weights, 5, 1e-7, histogramProbabilities, histogramAux);
+
+  BOOST_REQUIRE_GT(gain, bestGain);
+  BOOST_REQUIRE_CLOSE(gain, histogramGain, 1e-5);
+  BOOST_REQUIRE_EQUAL(histogramProbabilities.n_elem, 1);
+  BOOST_REQUIRE_CLOSE(bestProbabilities[0], histogramProbabilities[0], 1e-5);
+
+  // The same has to hold with weights.
+  const double bestWeightedGain = GiniGain::Evaluate<true>(labels, 2, weights);
+  const double weightedGain =
+      BestBinaryNumericSplit<GiniGain>::SplitIfBetter<true>(bestWeightedGain,
+      values, labels, 2, weights, 5, 1e-7, bestProbabilities, aux);
+  const double histogramWeightedGain =
+      HistogramNumericSplit<GiniGain>::SplitIfBetter<true>(bestWeightedGain,
+      values, labels, 2, weights, 5, 1e-7, histogramProbabilities,
+      histogramAux);
+
+  BOOST_REQUIRE_CLOSE(weightedGain, histogramWeightedGain, 1e-5);
+  BOOST_REQUIRE_CLOSE(bestProbabilities[0], histogramProbabilities[0], 1e-5);
+}
+
+/**
+ * Check that the HistogramNumericSplit won't split if all the values are the
+ * same.
+ */
+BOOST_AUTO_TEST_CASE(HistogramNumericSplitNoGainTest)
+{
+  arma::vec values(100, arma::fill::ones);
+  arma::Row<size_t> labels(100);
+  for (size_t i = 0; i < 100; ++i)
+    labels[i] = i % 2;
+  arma::rowvec weights(labels.n_elem, arma::fill::ones);
+
+  arma::vec classProbabilities;
+  HistogramNumericSplit<GiniGain>::template AuxiliarySplitInfo<double> aux;
+
+  const double bestGain = GiniGain::Evaluate<false>(labels, 2, weights);
+  const double gain = HistogramNumericSplit<GiniGain>::SplitIfBetter<false>(
+      bestGain, values, labels, 2, weights, 10, 1e-7, classProbabilities, aux);
+
+  BOOST_REQUIRE_EQUAL(gain, DBL_MAX);
+}
+
 /**
  * Check that the AllCategoricalSplit will split when the split is obviously
  * better.
@@ -695,6 +760,202 @@ BOOST_AUTO_TEST_CASE(SimpleGeneralizationTest)
   BOOST_REQUIRE_GT(wdcorrect, 0.75);
 }
 
+/**
+ * Test that a decision tree that uses the HistogramNumericSplit generalizes
+ * reasonably.
+ */
+BOOST_AUTO_TEST_CASE(HistogramSplitGeneralizationTest)
+{
+  arma::mat inputData;
+  if (!data::Load("vc2.csv", inputData))
+    BOOST_FAIL("Cannot load test dataset vc2.csv!");
+
+  arma::Row<size_t> labels;
+  if (!data::Load("vc2_labels.txt", labels))
+    BOOST_FAIL("Cannot load labels for vc2_labels.txt");
+
+  DecisionTree<GiniGain, HistogramNumericSplit> d(inputData, labels, 3, 10);
+
+  arma::mat testData;
+  if (!data::Load("vc2_test.csv", testData))
+    BOOST_FAIL("Cannot load test dataset vc2_test.csv!");
+
+  arma::Mat<size_t> trueTestLabels;
+  if (!data::Load("vc2_test_labels.txt", trueTestLabels))
+    BOOST_FAIL("Cannot load labels for vc2_test_labels.txt");
+
+  arma::Row<size_t> predictions;
+  d.Classify(testData, predictions);
+  BOOST_REQUIRE_EQUAL(predictions.n_elem, testData.n_cols);
+
+  double correct = 0.0;
+  for (size_t i = 0; i < predictions.n_elem; ++i)
+    if (predictions[i] == trueTestLabels[i])
+      ++correct;
+  correct /= predictions.n_elem;
+
+  BOOST_REQUIRE_GT(correct, 0.75);
+}
+
+/**
+ * Test that a decision tree that uses the PresortedBinaryNumericSplit is the
+ * same as one that uses the BestBinaryNumericSplit.
+ */
+BOOST_AUTO_TEST_CASE(PresortedSplitMatchesBestSplitTest)
+{
+  arma::mat inputData;
+  if (!data::Load("vc2.csv", inputData))
+    BOOST_FAIL("Cannot load test dataset vc2.csv!");
+
+  arma::Row<size_t> labels;
+  if (!data::Load("vc2_labels.txt", labels))
+    BOOST_FAIL("Cannot load labels for vc2_labels.txt");
+
+  arma::mat testData;
+  if (!data::Load("vc2_test.csv", testData))
+    BOOST_FAIL("Cannot load test dataset vc2_test.csv!");
+
+  arma::rowvec weights(labels.n_cols, arma::fill::randu);
+
+  DecisionTree<> d(inputData, labels, 3, 5);
+  DecisionTree<GiniGain, PresortedBinaryNumericSplit> pd(inputData, labels, 3,
+      5);
+  DecisionTree<> wd(inputData, labels, 3, weights, 5);
+  DecisionTree<GiniGain, PresortedBinaryNumericSplit> pwd(inputData, labels, 3,
+      weights, 5);
+
+  // The mixed-type training has its own code path.
+  data::DatasetInfo info(inputData.n_rows);
+  DecisionTree<> id(inputData, info, labels, 3, 5);
+  DecisionTree<GiniGain, PresortedBinaryNumericSplit> pid(inputData, info,
+      labels, 3, 5);
+
+  arma::Row<size_t> predictions, presortedPredictions;
+  arma::mat probabilities, presortedProbabilities;
+
+  d.Classify(testData, predictions, probabilities);
+  pd.Classify(testData, presortedPredictions, presortedProbabilities);
+  CheckMatrices(predictions, presortedPredictions);
+  CheckMatrices(probabilities, presortedProbabilities);
+
+  wd.Classify(testData, predictions, probabilities);
+  pwd.Classify(testData, presortedPredictions, presortedProbabilities);
+  CheckMatrices(predictions, presortedPredictions);
+  CheckMatrices(probabilities, presortedProbabilities);
+
+  id.Classify(testData, predictions, probabilities);
+  pid.Classify(testData, presortedPredictions, presortedProbabilities);
+  CheckMatrices(predictions, presortedPredictions);
+  CheckMatrices(probabilities, presortedProbabilities);
+}
+
+/**
+ * Make sure that training on an IndexedMatrix gives the same tree as training
+ * on a copy of the selected columns.
+ */
+BOOST_AUTO_TEST_CASE(IndexedMatrixTrainingTest)
+{
+  arma::mat inputData;
+  if (!data::Load("vc2.csv", inputData))
+    BOOST_FAIL("Cannot load test dataset vc2.csv!");
+
+  arma::Row<size_t> labels;
+  if (!data::Load("vc2_labels.txt", labels))
+    BOOST_FAIL("Cannot load labels for vc2_labels.txt");
+
+  arma::mat testData;
+  if (!data::Load("vc2_test.csv", testData))
+    BOOST_FAIL("Cannot load test dataset vc2_test.csv!");
+
+  // Select the points with replacement, as a bootstrap sample does.
+  arma::uvec indices = arma::randi<arma::uvec>(inputData.n_cols,
+      arma::distr_param(0, inputData.n_cols - 1));
+  arma::mat sampleData = inputData.cols(indices);
+  arma::Row<size_t> sampleLabels = labels.cols(indices);
+  arma::rowvec sampleWeights(indices.n_elem, arma::fill::randu);
+  IndexedMatrix<arma::mat> view(inputData, indices);
+  const arma::mat originalData(inputData);
+
+  DecisionTree<> d(sampleData, sampleLabels, 3, 5);
+  DecisionTree<> vd(view, sampleLabels, 3, 5);
+  DecisionTree<> wd(sampleData, sampleLabels, 3, sampleWeights, 5);
+  DecisionTree<> vwd(view, sampleLabels, 3, sampleWeights, 5);
+  data::DatasetInfo info(inputData.n_rows);
+  DecisionTree<> id(sampleData, info, sampleLabels, 3, 5);
+  DecisionTree<> vid(view, info, sampleLabels, 3, 5);
+
+  // The dataset must not have been changed.
+  CheckMatrices(inputData, originalData);
+
+  arma::Row<size_t> predictions, viewPredictions;
+  arma::mat probabilities, viewProbabilities;
+
+  d.Classify(testData, predictions, probabilities);
+  vd.Classify(testData, viewPredictions, viewProbabilities);
+  CheckMatrices(predictions, viewPredictions);
+  CheckMatrices(probabilities, viewProbabilities);
+
+  wd.Classify(testData, predictions, probabilities);
+  vwd.Classify(testData, viewPredictions, viewProbabilities);
+  CheckMatrices(predictions, viewPredictions);
+  CheckMatrices(probabilities, viewProbabilities);
+
+  id.Classify(testData, predictions, probabilities);
+  vid.Classify(testData, viewPredictions, viewProbabilities);
+  CheckMatrices(predictions, viewPredictions);
+  CheckMatrices(probabilities, viewProbabilities);
+}
+
+/**
+ * Make sure that the trees trained with OpenMP tasks are the same as the trees
+ * trained serially.
+ */
+BOOST_AUTO_TEST_CASE(ParallelTrainingMatchesSerialTest)
+{
+  arma::mat inputData;
+  if (!data::Load("vc2.csv", inputData))
+    BOOST_FAIL("Cannot load test dataset vc2.csv!");
+
+  arma::Row<size_t> labels;
+  if (!data::Load("vc2_labels.txt", labels))
+    BOOST_FAIL("Cannot load labels for vc2_labels.txt");
+
+  arma::mat testData;
+  if (!data::Load("vc2_test.csv", testData))
+    BOOST_FAIL("Cannot load test dataset vc2_test.csv!");
+
+  // The mixed-type training has its own code path.
+  arma::mat categoricalData;
+  arma::Row<size_t> categoricalLabels;
+  data::DatasetInfo info;
+  MockCategoricalData(categoricalData, categoricalLabels, info);
+
+  const size_t defaultThreshold = DecisionTree<>::ParallelThreshold();
+
+  DecisionTree<>::ParallelThreshold() = std::numeric_limits<size_t>::max();
+  DecisionTree<> d(inputData, labels, 3, 5);
+  DecisionTree<> cd(categoricalData, info, categoricalLabels, 5, 10);
+
+  DecisionTree<>::ParallelThreshold() = 10;
+  DecisionTree<> pd(inputData, labels, 3, 5);
+  DecisionTree<> pcd(categoricalData, info, categoricalLabels, 5, 10);
+
+  DecisionTree<>::ParallelThreshold() = defaultThreshold;
+
+  arma::Row<size_t> predictions, parallelPredictions;
+  arma::mat probabilities, parallelProbabilities;
+
+  d.Classify(testData, predictions, probabilities);
+  pd.Classify(testData, parallelPredictions, parallelProbabilities);
+  CheckMatrices(predictions, parallelPredictions);
+  CheckMatrices(probabilities, parallelProbabilities);
+
+  cd.Classify(categoricalData, predictions, probabilities);
+  pcd.Classify(categoricalData, parallelPredictions, parallelProbabilities);
+  CheckMatrices(predictions, parallelPredictions);
+  CheckMatrices(probabilities, parallelProbabilities);
+}
+
 /**
  * Test that we can build a decision tree on a simple categorical dataset.
  */
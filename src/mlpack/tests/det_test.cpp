@@ -778,4 +778,39 @@ BOOST_AUTO_TEST_CASE(MoveOperatorTest)
   BOOST_REQUIRE_CLOSE(testDTree2.Right()->SplitValue(), 0.5, 1e-5);
 }
 
+/**
+ * Make sure that the tree trained with cross-validation doesn't depend on
+ * whether its nodes are grown by OpenMP tasks.
+ */
+BOOST_AUTO_TEST_CASE(ParallelTrainerTest)
+{
+  arma::mat dataset = arma::randn<arma::mat>(4, 3000);
+  arma::mat dataset2(dataset);
+
+  const size_t oldThreshold = DTree<>::ParallelThreshold();
+
+  // Grow all nodes serially.
+  DTree<>::ParallelThreshold() = std::numeric_limits<size_t>::max();
+  DTree<arma::mat, int>* serialTree = Trainer<arma::mat, int>(dataset, 5,
+      false, 10, 5, false);
+
+  // Grow almost all nodes with tasks.
+  DTree<>::ParallelThreshold() = 20;
+  DTree<arma::mat, int>* parallelTree = Trainer<arma::mat, int>(dataset2, 5,
+      false, 10, 5, false);
+
+  DTree<>::ParallelThreshold() = oldThreshold;
+
+  BOOST_REQUIRE_EQUAL(serialTree->SubtreeLeaves(),
+      parallelTree->SubtreeLeaves());
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(serialTree->ComputeValue(dataset.col(i)),
+        parallelTree->ComputeValue(dataset.col(i)), 1e-5);
+  }
+
+  delete serialTree;
+  delete parallelTree;
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -90,6 +90,33 @@ BOOST_AUTO_TEST_CASE(DiscreteDistributionRandomTest)
   BOOST_REQUIRE_CLOSE(actualProb(2), 0.1, 8.0);
 }
 
+/**
+ * Make sure that generating many observations at once gives the same results as
+ * repeated calls to Random().
+ */
+BOOST_AUTO_TEST_CASE(DiscreteDistributionBulkRandomTest)
+{
+  DiscreteDistribution d("3 5");
+  d.Probabilities(0) = "0.3 0.6 0.1";
+  d.Probabilities(1) = "0.1 0.2 0.0 0.4 0.3";
+
+  math::RandomSeed(12);
+  const arma::mat bulk = d.Random(1000);
+
+  math::RandomSeed(12);
+  arma::mat single(2, 1000);
+  for (size_t i = 0; i < 1000; ++i)
+    single.col(i) = d.Random();
+
+  BOOST_REQUIRE_EQUAL(bulk.n_rows, 2);
+  BOOST_REQUIRE_EQUAL(bulk.n_cols, 1000);
+  for (size_t i = 0; i < bulk.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(bulk[i], single[i]);
+
+  // The observation with probability 0 is never generated.
+  BOOST_REQUIRE_EQUAL(arma::accu(bulk.row(1) == 2.0), 0);
+}
+
 /**
  * Make sure we can estimate from observations correctly.
  */
@@ -443,6 +470,39 @@ BOOST_AUTO_TEST_CASE(GaussianMultipointMultivariateProbabilityTest)
   BOOST_REQUIRE_CLOSE(phis(5), -14.900192463287908, 1e-5);
 }
 
+/**
+ * Make sure the batched log-probabilities, in double and single precision,
+ * match the log-probabilities of each point.
+ */
+BOOST_AUTO_TEST_CASE(GaussianBatchedLogProbabilityTest)
+{
+  arma::mat a(10, 10, arma::fill::randu);
+  GaussianDistribution g(arma::randu<arma::vec>(10),
+      a * a.t() + 0.5 * arma::eye<arma::mat>(10, 10));
+
+  arma::mat points(10, 1000, arma::fill::randn);
+  points *= 2.0;
+
+  arma::vec logProbabilities, probabilities;
+  g.LogProbability(points, logProbabilities);
+  g.Probability(points, probabilities);
+
+  arma::fvec floatLogProbabilities;
+  g.LogProbability(arma::conv_to<arma::fmat>::from(points),
+      floatLogProbabilities);
+
+  BOOST_REQUIRE_EQUAL(logProbabilities.n_elem, 1000);
+  BOOST_REQUIRE_EQUAL(probabilities.n_elem, 1000);
+  BOOST_REQUIRE_EQUAL(floatLogProbabilities.n_elem, 1000);
+  for (size_t i = 0; i < points.n_cols; ++i)
+  {
+    const double expected = g.LogProbability(points.unsafe_col(i));
+    BOOST_REQUIRE_CLOSE(logProbabilities[i], expected, 1e-5);
+    BOOST_REQUIRE_CLOSE(probabilities[i], std::exp(expected), 1e-5);
+    BOOST_REQUIRE_CLOSE(floatLogProbabilities[i], expected, 1e-2);
+  }
+}
+
 /**
  * Make sure random observations follow the probability distribution correctly.
  */
@@ -278,4 +278,37 @@ BOOST_AUTO_TEST_CASE(BallTreeTest)
   }
 }
 
+#ifdef HAS_OPENMP
+/**
+ * Make sure that the parallel computation with all threads gives the same
+ * results as the computation with one thread.
+ */
+BOOST_AUTO_TEST_CASE(ParallelDualTreeTest)
+{
+  arma::mat inputData = arma::randu<arma::mat>(3, 5000);
+
+  DualTreeBoruvka<> parallelDtb(inputData);
+  arma::mat parallelResults;
+  parallelDtb.ComputeMST(parallelResults);
+
+  // The query tree is split when the object is constructed, so the number of
+  // threads must be set first.
+  const size_t prevNumThreads = omp_get_max_threads();
+  omp_set_num_threads(1);
+  DualTreeBoruvka<> sequentialDtb(inputData);
+  arma::mat sequentialResults;
+  sequentialDtb.ComputeMST(sequentialResults);
+  omp_set_num_threads(prevNumThreads);
+
+  BOOST_REQUIRE_EQUAL(parallelResults.n_cols, inputData.n_cols - 1);
+  BOOST_REQUIRE_EQUAL(sequentialResults.n_cols, inputData.n_cols - 1);
+  for (size_t i = 0; i < parallelResults.n_cols; i++)
+  {
+    BOOST_REQUIRE_EQUAL(parallelResults(0, i), sequentialResults(0, i));
+    BOOST_REQUIRE_EQUAL(parallelResults(1, i), sequentialResults(1, i));
+    BOOST_REQUIRE_CLOSE(parallelResults(2, i), sequentialResults(2, i), 1e-5);
+  }
+}
+#endif
+
 BOOST_AUTO_TEST_SUITE_END();
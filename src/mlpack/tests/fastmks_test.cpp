@@ -1100,4 +1100,36 @@ BOOST_AUTO_TEST_CASE(CopyAssignmentTest)
   }
 }
 
+/**
+ * Compare bichromatic dual-tree search and naive search with a normalized
+ * kernel, on a query set large enough that the query tree is split into many
+ * subtrees for the parallel traversal.
+ */
+BOOST_AUTO_TEST_CASE(BichromaticDualTreeVsNaiveTest)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(4, 1500);
+  arma::mat queryData = arma::randu<arma::mat>(4, 3000);
+  GaussianKernel gk(0.5);
+
+  FastMKS<GaussianKernel> naive(referenceData, gk, false, true);
+  arma::Mat<size_t> naiveIndices;
+  arma::mat naiveKernels;
+  naive.Search(queryData, 5, naiveIndices, naiveKernels);
+
+  FastMKS<GaussianKernel> dualTree(referenceData, gk);
+  arma::Mat<size_t> dualIndices;
+  arma::mat dualKernels;
+  dualTree.Search(queryData, 5, dualIndices, dualKernels);
+
+  BOOST_REQUIRE_EQUAL(dualIndices.n_cols, queryData.n_cols);
+  for (size_t q = 0; q < dualIndices.n_cols; ++q)
+  {
+    for (size_t r = 0; r < dualIndices.n_rows; ++r)
+    {
+      BOOST_REQUIRE_EQUAL(dualIndices(r, q), naiveIndices(r, q));
+      BOOST_REQUIRE_CLOSE(dualKernels(r, q), naiveKernels(r, q), 1e-5);
+    }
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -15,6 +15,7 @@
 #include <mlpack/methods/ann/layer/layer.hpp>
 #include <mlpack/methods/ann/loss_functions/mean_squared_error.hpp>
 #include <mlpack/methods/ann/ffn.hpp>
+#include <mlpack/methods/ann/static_ffn.hpp>
 
 #include <ensmallen.hpp>
 
@@ -443,6 +444,176 @@ BOOST_AUTO_TEST_CASE(SerializationTest)
       binaryPredictions);
 }
 
+/**
+ * Make sure that PrepareForInference() folds BatchNorm layers, removes Dropout
+ * layers, and that the resulting model gives the same predictions, also after
+ * serialization.
+ */
+BOOST_AUTO_TEST_CASE(PrepareForInferenceTest)
+{
+  arma::mat data(10, 50, arma::fill::randu);
+  arma::mat labels = arma::floor(arma::randu<arma::mat>(1, 50) * 3) + 1;
+
+  FFN<NegativeLogLikelihood<> > model;
+  model.Add<Linear<> >(10, 8);
+  model.Add<BatchNorm<> >(8);
+  model.Add<SigmoidLayer<> >();
+  model.Add<Dropout<> >();
+  model.Add<Linear<> >(8, 3);
+  model.Add<LogSoftMax<> >();
+
+  // Training collects the statistics of the BatchNorm layer.
+  ens::StandardSGD opt(0.01, 10, 50, -1);
+  model.Train(data, labels, opt);
+
+  arma::mat predictions;
+  model.Predict(data, predictions);
+
+  model.PrepareForInference();
+  BOOST_REQUIRE_EQUAL(model.Model().size(), 4);
+  BOOST_REQUIRE_EQUAL(model.Parameters().n_elem, 10 * 8 + 8 + 8 * 3 + 3);
+
+  arma::mat inferencePredictions;
+  model.Predict(data, inferencePredictions);
+  CheckMatrices(predictions, inferencePredictions, 1e-6);
+
+  FFN<NegativeLogLikelihood<> > xmlModel, textModel, binaryModel;
+  SerializeObjectAll(model, xmlModel, textModel, binaryModel);
+
+  arma::mat xmlPredictions, textPredictions, binaryPredictions;
+  xmlModel.Predict(data, xmlPredictions);
+  textModel.Predict(data, textPredictions);
+  binaryModel.Predict(data, binaryPredictions);
+  CheckMatrices(predictions, xmlPredictions, 1e-6);
+  CheckMatrices(predictions, textPredictions, 1e-6);
+  CheckMatrices(predictions, binaryPredictions, 1e-6);
+}
+
+/**
+ * Make sure that spreading the batches of Predict() over several threads gives
+ * the same predictions.
+ */
+BOOST_AUTO_TEST_CASE(FFNParallelPredictTest)
+{
+  arma::mat data(10, 1003, arma::fill::randu);
+
+  FFN<NegativeLogLikelihood<> > model;
+  model.Add<Linear<> >(10, 8);
+  model.Add<SigmoidLayer<> >();
+  model.Add<Linear<> >(8, 3);
+  model.Add<LogSoftMax<> >();
+  model.ResetParameters();
+
+  arma::mat predictions;
+  model.Predict(data, predictions, 50);
+
+  model.Threads() = 4;
+  arma::mat parallelPredictions;
+  model.Predict(data, parallelPredictions, 50);
+  CheckMatrices(predictions, parallelPredictions, 1e-10);
+
+  // Batches that do not divide the data.
+  model.Predict(data, parallelPredictions, 7);
+  CheckMatrices(predictions, parallelPredictions, 1e-10);
+}
+
+/**
+ * Make sure that a quantized network gives predictions close to the ones of
+ * the original network, and that it can be serialized.
+ */
+BOOST_AUTO_TEST_CASE(FFNQuantizeTest)
+{
+  arma::mat data(36, 40, arma::fill::randu);
+
+  FFN<NegativeLogLikelihood<> > model;
+  model.Add<Convolution<> >(1, 4, 3, 3, 1, 1, 1, 1, 6, 6);
+  model.Add<ReLULayer<> >();
+  model.Add<Linear<> >(144, 10);
+  model.Add<SigmoidLayer<> >();
+  model.Add<LinearNoBias<> >(10, 3);
+  model.Add<LogSoftMax<> >();
+  model.ResetParameters();
+
+  arma::mat predictions;
+  model.Predict(data, predictions);
+
+  model.Quantize(data);
+  BOOST_REQUIRE_EQUAL(model.Model().size(), 6);
+  BOOST_REQUIRE_EQUAL(model.Parameters().n_elem, 0);
+
+  arma::mat quantizedPredictions;
+  model.Predict(data, quantizedPredictions);
+  BOOST_REQUIRE_EQUAL(quantizedPredictions.n_rows, 3);
+  BOOST_REQUIRE_EQUAL(quantizedPredictions.n_cols, data.n_cols);
+  BOOST_REQUIRE_LE(arma::norm(quantizedPredictions - predictions) /
+      arma::norm(predictions), 0.05);
+
+  FFN<NegativeLogLikelihood<> > xmlModel, textModel, binaryModel;
+  SerializeObjectAll(model, xmlModel, textModel, binaryModel);
+
+  arma::mat xmlPredictions, textPredictions, binaryPredictions;
+  xmlModel.Predict(data, xmlPredictions);
+  textModel.Predict(data, textPredictions);
+  binaryModel.Predict(data, binaryPredictions);
+  CheckMatrices(quantizedPredictions, xmlPredictions, 1e-6);
+  CheckMatrices(quantizedPredictions, textPredictions, 1e-6);
+  CheckMatrices(quantizedPredictions, binaryPredictions, 1e-6);
+}
+
+/**
+ * Train a network on a dataset that is split into several files.
+ */
+BOOST_AUTO_TEST_CASE(FFNChunkLoaderTrainTest)
+{
+  arma::mat trainData;
+  data::Load("thyroid_train.csv", trainData, true);
+
+  arma::mat testData;
+  data::Load("thyroid_test.csv", testData, true);
+  arma::mat testLabels = testData.row(testData.n_rows - 1);
+  testData.shed_row(testData.n_rows - 1);
+
+  // Store the data (with the labels in the last row) in four chunks.
+  trainData = trainData.cols(arma::randperm(trainData.n_cols));
+  std::vector<std::string> files;
+  const size_t chunkSize = (trainData.n_cols + 3) / 4;
+  for (size_t i = 0; i < trainData.n_cols; i += chunkSize)
+  {
+    files.push_back("ffn_chunk_" + std::to_string(files.size()) + ".bin");
+    data::Save(files.back(), arma::mat(trainData.cols(i,
+        std::min(i + chunkSize, (size_t) trainData.n_cols) - 1)));
+  }
+
+  FFN<NegativeLogLikelihood<> > model;
+  model.Add<Linear<> >(trainData.n_rows - 1, 8);
+  model.Add<SigmoidLayer<> >();
+  model.Add<Linear<> >(8, 3);
+  model.Add<LogSoftMax<> >();
+
+  // One pass over a chunk for each call to Optimize().
+  ens::Adam opt(0.01, 32, 0.9, 0.999, 1e-8, chunkSize, -1, true, false);
+
+  data::ChunkLoader loader(files, 1);
+  for (size_t epoch = 0; epoch < 20; ++epoch)
+    BOOST_REQUIRE(std::isfinite(model.Train(loader, opt)));
+
+  for (size_t i = 0; i < files.size(); ++i)
+    remove(files[i].c_str());
+
+  arma::mat predictionTemp;
+  model.Predict(testData, predictionTemp);
+  arma::mat prediction = arma::zeros<arma::mat>(1, predictionTemp.n_cols);
+  for (size_t i = 0; i < predictionTemp.n_cols; ++i)
+  {
+    prediction(i) = arma::as_scalar(arma::find(
+        arma::max(predictionTemp.col(i)) == predictionTemp.col(i), 1)) + 1;
+  }
+
+  const size_t correct = arma::accu(prediction == testLabels);
+  const double classificationError = 1 - double(correct) / testData.n_cols;
+  BOOST_REQUIRE_LE(classificationError, 0.1);
+}
+
 /**
  * Test if the custom layers work. The target is to see if the code compiles
  * when the Train and Prediction are called.
@@ -523,6 +694,229 @@ BOOST_AUTO_TEST_CASE(PartialForwardTest)
   CheckMatrices(output, arma::ones(10, 1) * 20);
 }
 
+/**
+ * Test that batched predictions are the same for any batch size, also when the
+ * layer outputs are reused across calls and after the network is moved.
+ */
+BOOST_AUTO_TEST_CASE(BatchPredictTest)
+{
+  FFN<NegativeLogLikelihood<>, RandomInitialization> model;
+  model.Add<Linear<> >(10, 20);
+  model.Add<SigmoidLayer<> >();
+  model.Add<Linear<> >(20, 5);
+  model.Add<LogSoftMax<> >();
+  model.ResetParameters();
+
+  arma::mat data(10, 103, arma::fill::randu);
+
+  arma::mat expected;
+  model.Predict(data, expected, 1);
+  BOOST_REQUIRE_EQUAL(expected.n_rows, 5);
+  BOOST_REQUIRE_EQUAL(expected.n_cols, data.n_cols);
+
+  const size_t batchSizes[] = { 7, 32, 103, 500, 32 };
+  for (size_t batchSize : batchSizes)
+  {
+    arma::mat predictions;
+    model.Predict(data, predictions, batchSize);
+    CheckMatrices(expected, predictions);
+  }
+
+  // The full-batch forward pass must also give the same results.
+  arma::mat results;
+  model.Forward(data, results);
+  CheckMatrices(expected, results);
+
+  // Predict with a moved and a copied network.
+  FFN<NegativeLogLikelihood<>, RandomInitialization> movedModel(
+      std::move(model));
+  arma::mat predictions;
+  movedModel.Predict(data, predictions, 32);
+  CheckMatrices(expected, predictions);
+
+  FFN<NegativeLogLikelihood<>, RandomInitialization> copiedModel(movedModel);
+  copiedModel.Predict(data, predictions, 16);
+  CheckMatrices(expected, predictions);
+}
+
+/**
+ * Check that data-parallel evaluation of the given network gives the same
+ * objective and gradient as the serial one.
+ */
+template<typename ModelType>
+void CheckDataParallelGradient(ModelType& model)
+{
+  model.ResetParameters();
+  const size_t batchSize = model.Predictors().n_cols;
+
+  for (size_t trial = 0; trial < 2; ++trial)
+  {
+    // Change the parameters in place; the copies of the network must see that.
+    if (trial == 1)
+      model.Parameters() += 0.1;
+
+    model.Threads() = 1;
+    arma::mat gradient;
+    const double objective = model.EvaluateWithGradient(model.Parameters(), 0,
+        gradient, batchSize);
+
+    for (size_t threads = 2; threads <= 4; ++threads)
+    {
+      model.Threads() = threads;
+      arma::mat parallelGradient;
+      const double parallelObjective = model.EvaluateWithGradient(
+          model.Parameters(), 0, parallelGradient, batchSize);
+
+      BOOST_REQUIRE_CLOSE(objective, parallelObjective, 1e-5);
+      CheckMatrices(gradient, parallelGradient, 1e-5);
+    }
+  }
+}
+
+/**
+ * Test that data-parallel training computes the same gradient as serial
+ * training, both for a loss that is summed over the points and a loss that is
+ * averaged over the batch.
+ */
+BOOST_AUTO_TEST_CASE(DataParallelGradientTest)
+{
+  arma::mat data(10, 37, arma::fill::randu);
+  arma::mat labels = arma::floor(arma::randu<arma::mat>(1, 37) * 3) + 1;
+
+  FFN<NegativeLogLikelihood<>, RandomInitialization> model;
+  model.Add<Linear<> >(10, 8);
+  model.Add<SigmoidLayer<> >();
+  model.Add<Linear<> >(8, 3);
+  model.Add<LogSoftMax<> >();
+  model.Predictors() = data;
+  model.Responses() = labels;
+  CheckDataParallelGradient(model);
+
+  FFN<MeanSquaredError<>, RandomInitialization> mseModel;
+  mseModel.Add<Linear<> >(10, 8);
+  mseModel.Add<TanHLayer<> >();
+  mseModel.Add<Linear<> >(8, 2);
+  mseModel.Predictors() = data;
+  mseModel.Responses() = arma::randu<arma::mat>(2, 37);
+  CheckDataParallelGradient(mseModel);
+}
+
+/**
+ * Test that gradient checkpointing gives the same objective and gradient as
+ * keeping all the outputs, also with Dropout, and that the forward pass
+ * releases the outputs that are not kept.
+ */
+BOOST_AUTO_TEST_CASE(GradientCheckpointingTest)
+{
+  arma::mat data(10, 37, arma::fill::randu);
+  arma::mat labels = arma::floor(arma::randu<arma::mat>(1, 37) * 3) + 1;
+
+  FFN<NegativeLogLikelihood<>, RandomInitialization> model;
+  model.Add<Linear<> >(10, 8);
+  model.Add<SigmoidLayer<> >();
+  model.Add<Linear<> >(8, 8);
+  model.Add<Dropout<> >(0.3);
+  model.Add<Linear<> >(8, 3);
+  model.Add<LogSoftMax<> >();
+  model.Predictors() = data;
+  model.Responses() = labels;
+  model.ResetParameters();
+
+  math::RandomSeed(3);
+  arma::mat gradient;
+  const double objective = model.EvaluateWithGradient(model.Parameters(), 0,
+      gradient, 37);
+
+  for (size_t interval = 1; interval <= 6; ++interval)
+  {
+    model.CheckpointInterval() = interval;
+    math::RandomSeed(3);
+    arma::mat checkpointGradient;
+    const double checkpointObjective = model.EvaluateWithGradient(
+        model.Parameters(), 0, checkpointGradient, 37);
+
+    BOOST_REQUIRE_CLOSE(objective, checkpointObjective, 1e-5);
+    CheckMatrices(gradient, checkpointGradient, 1e-5);
+  }
+
+  // With segments of two layers, the first layer of each segment but the last
+  // one doesn't keep its output.
+  model.CheckpointInterval() = 2;
+  model.EvaluateWithGradient(model.Parameters(), 0, gradient, 37);
+
+  OutputParameterVisitor outputParameterVisitor;
+  BOOST_REQUIRE(boost::apply_visitor(outputParameterVisitor,
+      model.Model()[0]).is_empty());
+  BOOST_REQUIRE(!boost::apply_visitor(outputParameterVisitor,
+      model.Model()[1]).is_empty());
+  BOOST_REQUIRE(boost::apply_visitor(outputParameterVisitor,
+      model.Model()[2]).is_empty());
+  BOOST_REQUIRE(!boost::apply_visitor(outputParameterVisitor,
+      model.Model()[4]).is_empty());
+}
+
+/**
+ * Test that a StaticFFN computes the same predictions, objective and gradient
+ * as the FFN with the same layers and parameters, including the layers whose
+ * activation is applied in place.
+ */
+BOOST_AUTO_TEST_CASE(StaticFFNMatchesFFNTest)
+{
+  arma::mat data(10, 37, arma::fill::randu);
+  arma::mat labels = arma::floor(arma::randu<arma::mat>(1, 37) * 3) + 1;
+
+  FFN<NegativeLogLikelihood<>, RandomInitialization> model;
+  model.Add<Linear<> >(10, 8);
+  model.Add<SigmoidLayer<> >();
+  model.Add<Linear<> >(8, 6);
+  model.Add<ReLULayer<> >();
+  model.Add<Linear<> >(6, 3);
+  model.Add<LogSoftMax<> >();
+  model.Predictors() = data;
+  model.Responses() = labels;
+  model.ResetParameters();
+
+  typedef StaticFFN<NegativeLogLikelihood<>, RandomInitialization, Linear<>,
+      SigmoidLayer<>, Linear<>, ReLULayer<>, Linear<>, LogSoftMax<>>
+      StaticModelType;
+  StaticModelType staticModel(Linear<>(10, 8), SigmoidLayer<>(),
+      Linear<>(8, 6), ReLULayer<>(), Linear<>(6, 3), LogSoftMax<>());
+  staticModel.Predictors() = data;
+  staticModel.Responses() = labels;
+  staticModel.ResetParameters();
+  BOOST_REQUIRE_EQUAL(staticModel.Parameters().n_elem,
+      model.Parameters().n_elem);
+  staticModel.Parameters() = model.Parameters();
+
+  arma::mat predictions, staticPredictions;
+  model.Predict(data, predictions);
+  staticModel.Predict(data, staticPredictions, 10);
+  CheckMatrices(predictions, staticPredictions, 1e-8);
+
+  arma::mat gradient, staticGradient;
+  const double objective = model.EvaluateWithGradient(model.Parameters(), 0,
+      gradient, 37);
+  const double staticObjective = staticModel.EvaluateWithGradient(
+      staticModel.Parameters(), 0, staticGradient, 37);
+  BOOST_REQUIRE_CLOSE(objective, staticObjective, 1e-8);
+  CheckMatrices(gradient, staticGradient, 1e-8);
+
+  // A copy of the network has to use its own parameters.
+  StaticModelType copy(staticModel);
+  copy.Parameters().zeros();
+  arma::mat copyPredictions;
+  staticModel.Predict(data, staticPredictions);
+  copy.Predict(data, copyPredictions);
+  CheckMatrices(predictions, staticPredictions, 1e-8);
+  CheckMatricesNotEqual(staticPredictions, copyPredictions);
+
+  // Make sure that training works.
+  ens::StandardSGD opt(0.01, 8, 37 * 20, -1);
+  const double trainObjective = staticModel.Train(data, labels, opt);
+  BOOST_REQUIRE(std::isfinite(trainObjective));
+  BOOST_REQUIRE_LT(staticModel.Evaluate(data, labels), staticObjective);
+}
+
 /**
  * Test that FFN::Train() returns finite objective value.
  */
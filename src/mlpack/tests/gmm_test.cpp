@@ -79,6 +79,46 @@ BOOST_AUTO_TEST_CASE(GMMProbabilityComponentTest)
   BOOST_REQUIRE_CLOSE(gmm.Probability("1.4 0", 1), 0.0067568972024, 1e-5);
 }
 
+/**
+ * Make sure that the batch GMM::Probability() and GMM::LogProbability() give
+ * the same results as the single observation overloads.
+ */
+BOOST_AUTO_TEST_CASE(GMMBatchProbabilityTest)
+{
+  GMM gmm(3, 2);
+  gmm.Component(0) = distribution::GaussianDistribution("0 0", "1 0; 0 1");
+  gmm.Component(1) = distribution::GaussianDistribution("3 3", "2 1; 1 2");
+  gmm.Component(2) = distribution::GaussianDistribution("-2 4", "1 0.5; 0.5 3");
+  gmm.Weights() = "0.3 0.5 0.2";
+
+  // Use more points than a block, and some far from every component.
+  arma::mat observations(2, 2500, arma::fill::randn);
+  observations *= 4.0;
+  observations.col(0) = arma::vec("1000 -1000");
+
+  arma::vec probabilities, logProbabilities;
+  gmm.Probability(observations, probabilities);
+  gmm.LogProbability(observations, logProbabilities);
+  BOOST_REQUIRE_EQUAL(probabilities.n_elem, observations.n_cols);
+  BOOST_REQUIRE_EQUAL(logProbabilities.n_elem, observations.n_cols);
+
+  for (size_t i = 0; i < observations.n_cols; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(logProbabilities[i],
+        gmm.LogProbability(observations.col(i)), 1e-5);
+    if (gmm.Probability(observations.col(i)) < 1e-300)
+      BOOST_REQUIRE_SMALL(probabilities[i], 1e-300);
+    else
+      BOOST_REQUIRE_CLOSE(probabilities[i],
+          gmm.Probability(observations.col(i)), 1e-5);
+  }
+
+  // Observations of the wrong dimensionality are rejected.
+  arma::mat wrong(3, 10, arma::fill::randu);
+  BOOST_REQUIRE_THROW(gmm.LogProbability(wrong, logProbabilities),
+      std::invalid_argument);
+}
+
 /**
  * Test training a model on only one Gaussian (randomly generated) in two
  * dimensions.  We will vary the dataset size from small to large.  The EM
@@ -455,6 +495,44 @@ BOOST_AUTO_TEST_CASE(GMMRandomTest)
       gmm2.Component(sortedIndices[1]).Covariance()(1, 1), 13.0);
 }
 
+/**
+ * Make sure that GMM::Random() for many observations generates observations
+ * with the mean and covariance of the mixture.
+ */
+BOOST_AUTO_TEST_CASE(GMMBulkRandomTest)
+{
+  // The same GMM as the last test.
+  GMM gmm(2, 2);
+  gmm.Weights() = arma::vec("0.40 0.60");
+  gmm.Component(0) = distribution::GaussianDistribution("2.25 3.10",
+      "1.00 0.60; 0.60 0.89");
+  gmm.Component(1) = distribution::GaussianDistribution("4.10 1.01",
+      "1.00 0.70; 0.70 1.01");
+
+  const arma::mat observations = gmm.Random(20000);
+  BOOST_REQUIRE_EQUAL(observations.n_rows, 2);
+  BOOST_REQUIRE_EQUAL(observations.n_cols, 20000);
+
+  // Compute the moments of the mixture.
+  arma::vec mean(2, arma::fill::zeros);
+  for (size_t i = 0; i < 2; ++i)
+    mean += gmm.Weights()[i] * gmm.Component(i).Mean();
+  arma::mat covariance(2, 2, arma::fill::zeros);
+  for (size_t i = 0; i < 2; ++i)
+  {
+    const arma::vec diff = gmm.Component(i).Mean() - mean;
+    covariance += gmm.Weights()[i] *
+        (gmm.Component(i).Covariance() + diff * trans(diff));
+  }
+
+  const arma::vec sampleMean = arma::mean(observations, 1);
+  const arma::mat sampleCovariance = arma::cov(trans(observations));
+  for (size_t i = 0; i < 2; ++i)
+    BOOST_REQUIRE_CLOSE(sampleMean[i], mean[i], 3.0);
+  for (size_t i = 0; i < 4; ++i)
+    BOOST_REQUIRE_CLOSE(sampleCovariance[i], covariance[i], 10.0);
+}
+
 /**
  * Test classification of observations by component.
  */
@@ -636,6 +714,58 @@ BOOST_AUTO_TEST_CASE(EigenvalueRatioConstraintTest)
   }
 }
 
+/**
+ * Make sure that a single EM iteration, which processes the observations in
+ * parallel blocks, gives the same model as a direct computation of the E-step
+ * and M-step over every point.
+ */
+BOOST_AUTO_TEST_CASE(EMFitSingleIterationTest)
+{
+  // Enough points for several blocks, the last of which is partial.
+  arma::mat data(3, 5000, arma::fill::randn);
+  data.cols(0, 1999) += 4.0;
+
+  std::vector<distribution::GaussianDistribution> dists(2);
+  dists[0] = distribution::GaussianDistribution("3 3 3", "2 0 0; 0 2 0; 0 0 2");
+  dists[1] = distribution::GaussianDistribution("1 0 0", "1 0 0; 0 1 0; 0 0 1");
+  arma::vec weights("0.5 0.5");
+
+  // Compute the expected model directly.
+  arma::mat logProbs(data.n_cols, 2);
+  for (size_t j = 0; j < data.n_cols; ++j)
+  {
+    for (size_t k = 0; k < 2; ++k)
+    {
+      logProbs(j, k) = std::log(weights[k]) +
+          dists[k].LogProbability(data.col(j));
+    }
+    logProbs.row(j) -= math::AccuLog(logProbs.row(j));
+  }
+  const arma::mat responsibilities = arma::exp(logProbs);
+
+  // Two iterations of the loop means one update of the model.
+  EMFit<kmeans::KMeans<>, NoConstraint> fitter(2);
+  fitter.Estimate(data, dists, weights, true);
+
+  for (size_t k = 0; k < 2; ++k)
+  {
+    const double total = arma::accu(responsibilities.col(k));
+    const arma::vec mean = data * responsibilities.col(k) / total;
+    arma::mat covariance(3, 3, arma::fill::zeros);
+    for (size_t j = 0; j < data.n_cols; ++j)
+    {
+      const arma::vec diff = data.col(j) - mean;
+      covariance += responsibilities(j, k) * diff * diff.t() / total;
+    }
+
+    BOOST_REQUIRE_CLOSE(weights[k], total / data.n_cols, 1e-5);
+    for (size_t d = 0; d < 3; ++d)
+      BOOST_REQUIRE_CLOSE(dists[k].Mean()[d], mean[d], 1e-5);
+    for (size_t d = 0; d < 9; ++d)
+      BOOST_REQUIRE_CLOSE(dists[k].Covariance()[d], covariance[d], 1e-5);
+  }
+}
+
 BOOST_AUTO_TEST_CASE(UseExistingModelTest)
 {
   // If we run a GMM and it converges, then if we run it again using the
@@ -1181,4 +1311,127 @@ BOOST_AUTO_TEST_CASE(DiagonalGMMLoadSaveTest)
   }
 }
 
+/**
+ * Make sure that online EM recovers three well-separated Gaussians.
+ */
+BOOST_AUTO_TEST_CASE(OnlineEMFitMultipleGaussiansTest)
+{
+  std::vector<distribution::GaussianDistribution> trueDists;
+  trueDists.push_back(distribution::GaussianDistribution("0 0",
+      "1 0.5; 0.5 2"));
+  trueDists.push_back(distribution::GaussianDistribution("20 0",
+      "2 0; 0 1"));
+  trueDists.push_back(distribution::GaussianDistribution("0 20",
+      "1 -0.3; -0.3 1"));
+  const arma::vec trueWeights("0.5 0.3 0.2");
+
+  arma::mat data(2, 10000);
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    const size_t gaussian = (i < 5000) ? 0 : ((i < 8000) ? 1 : 2);
+    data.col(i) = trueDists[gaussian].Random();
+  }
+
+  // The initial clustering of a single minibatch may fall into a bad local
+  // minimum, so a few trials are allowed.
+  bool success = false;
+  for (size_t trial = 0; trial < 3; ++trial)
+  {
+    GMM gmm(3, 2);
+    OnlineEMFit<> fitter(1000, 10);
+    gmm.Train(data, 1, false, fitter);
+
+    const arma::uvec sortTry = arma::sort_index(gmm.Weights(), "descend");
+    if (arma::norm(gmm.Weights().elem(sortTry) - trueWeights) > 0.05)
+      continue;
+
+    for (size_t i = 0; i < 3; ++i)
+    {
+      BOOST_REQUIRE_LT(arma::norm(gmm.Component(sortTry[i]).Mean() -
+          trueDists[i].Mean()), 0.15);
+      BOOST_REQUIRE_LT(arma::norm(gmm.Component(sortTry[i]).Covariance() -
+          trueDists[i].Covariance()), 0.3);
+      BOOST_REQUIRE_LT(std::abs(gmm.Weights()[sortTry[i]] - trueWeights[i]),
+          0.02);
+    }
+
+    success = true;
+    break;
+  }
+
+  BOOST_REQUIRE_EQUAL(success, true);
+}
+
+/**
+ * Make sure that a DiagonalGMM trained with online EM on chunks streamed from
+ * files recovers the Gaussians, starting from an existing model, and that the
+ * returned log-likelihood is the log-likelihood of the model.
+ */
+BOOST_AUTO_TEST_CASE(OnlineEMFitChunkLoaderTest)
+{
+  distribution::DiagonalGaussianDistribution d1("0 0 0", "1 2 0.5");
+  distribution::DiagonalGaussianDistribution d2("10 10 -10", "0.5 1 3");
+
+  arma::mat data(3, 8000);
+  std::vector<std::string> files;
+  for (size_t c = 0; c < 4; ++c)
+  {
+    arma::mat chunk(3, 2000);
+    for (size_t i = 0; i < chunk.n_cols; ++i)
+      chunk.col(i) = (i % 4 == 0) ? d2.Random() : d1.Random();
+    data.cols(2000 * c, 2000 * c + 1999) = chunk;
+
+    files.push_back("online_em_chunk_" + std::to_string(c) + ".bin");
+    data::Save(files.back(), chunk, true);
+  }
+
+  DiagonalGMM dgmm(2, 3);
+  dgmm.Component(0) = distribution::DiagonalGaussianDistribution("1 1 1",
+      "2 2 2");
+  dgmm.Component(1) = distribution::DiagonalGaussianDistribution("8 8 -8",
+      "2 2 2");
+  dgmm.Weights() = "0.5 0.5";
+
+  data::ChunkLoader loader(files, 0);
+  OnlineEMFit<kmeans::KMeans<>, DiagonalConstraint,
+      distribution::DiagonalGaussianDistribution> fitter(500, 5);
+  const double likelihood = dgmm.Train(loader, true, fitter);
+
+  for (size_t c = 0; c < files.size(); ++c)
+    remove(files[c].c_str());
+
+  BOOST_REQUIRE_LT(arma::norm(dgmm.Component(0).Mean() - d1.Mean()), 0.15);
+  BOOST_REQUIRE_LT(arma::norm(dgmm.Component(0).Covariance() -
+      d1.Covariance()), 0.2);
+  BOOST_REQUIRE_LT(arma::norm(dgmm.Component(1).Mean() - d2.Mean()), 0.2);
+  BOOST_REQUIRE_LT(arma::norm(dgmm.Component(1).Covariance() -
+      d2.Covariance()), 0.4);
+  BOOST_REQUIRE_LT(std::abs(dgmm.Weights()[1] - 0.25), 0.02);
+
+  double expectedLikelihood = 0.0;
+  for (size_t i = 0; i < data.n_cols; ++i)
+    expectedLikelihood += dgmm.LogProbability(data.col(i));
+  BOOST_REQUIRE_CLOSE(likelihood, expectedLikelihood, 1e-5);
+}
+
+/**
+ * Make sure that invalid online EM parameters throw.
+ */
+BOOST_AUTO_TEST_CASE(OnlineEMFitInvalidParametersTest)
+{
+  arma::mat data(2, 100, arma::fill::randn);
+  GMM gmm(2, 2);
+
+  BOOST_REQUIRE_THROW(gmm.Train(data, 1, false, OnlineEMFit<>(0)),
+      std::invalid_argument);
+  BOOST_REQUIRE_THROW(gmm.Train(data, 1, false, OnlineEMFit<>(10, 1, 0.4)),
+      std::invalid_argument);
+  BOOST_REQUIRE_THROW(gmm.Train(data, 1, false, OnlineEMFit<>(10, 1, 0.7,
+      0.5)), std::invalid_argument);
+
+  arma::mat wrongData(3, 100, arma::fill::randn);
+  BOOST_REQUIRE_THROW(gmm.Train(wrongData, 1, false, OnlineEMFit<>(10)),
+      std::invalid_argument);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
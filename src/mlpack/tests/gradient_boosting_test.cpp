@@ -0,0 +1,182 @@
+/**
+ * @file tests/gradient_boosting_test.cpp
+ *
+ * Tests for the GradientBoosting and GradientBoostingTree classes.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/gradient_boosting/gradient_boosting.hpp>
+
+#include <boost/test/unit_test.hpp>
+#include "test_tools.hpp"
+#include "serialization.hpp"
+
+using namespace mlpack;
+using namespace mlpack::tree;
+
+BOOST_AUTO_TEST_SUITE(GradientBoostingTest);
+
+/**
+ * Make sure that a single tree fits a step function exactly when the
+ * regularization is zero.
+ */
+BOOST_AUTO_TEST_CASE(GradientBoostingTreeStepTest)
+{
+  // One dimension with ten bins; points below bin 5 have gradient 1, the
+  // others have gradient -1.
+  arma::Mat<unsigned char> bins(1, 100);
+  arma::vec gradients(100), hessians(100, arma::fill::ones);
+  for (size_t i = 0; i < 100; ++i)
+  {
+    bins(0, i) = (unsigned char) (i / 10);
+    gradients[i] = (i < 50) ? 1.0 : -1.0;
+  }
+  std::vector<arma::vec> thresholds(1);
+  thresholds[0] = arma::linspace<arma::vec>(9.5, 99.5, 10);
+
+  GradientBoostingTree tree;
+  tree.Train(bins, thresholds, arma::regspace<arma::uvec>(0, 99),
+      arma::uvec("0"), gradients, hessians, 2, 1, 0.0);
+
+  BOOST_REQUIRE_EQUAL(tree.NumNodes(), 3);
+  for (size_t i = 0; i < 100; ++i)
+  {
+    const double expected = (i < 50) ? -1.0 : 1.0;
+    arma::vec point(1);
+    point[0] = (double) i;
+    BOOST_REQUIRE_CLOSE(tree.Predict(point), expected, 1e-5);
+    BOOST_REQUIRE_CLOSE(tree.PredictBins(bins.colptr(i)), expected, 1e-5);
+  }
+}
+
+/**
+ * Make sure that gradient boosting gets reasonable accuracy on the vc2
+ * dataset, and that the training loss decreases with more iterations.
+ */
+BOOST_AUTO_TEST_CASE(GradientBoostingAccuracyTest)
+{
+  arma::mat dataset, testDataset;
+  arma::Row<size_t> labels, testLabels;
+  if (!data::Load("vc2.csv", dataset))
+    BOOST_FAIL("Cannot load dataset vc2.csv!");
+  if (!data::Load("vc2_labels.txt", labels))
+    BOOST_FAIL("Cannot load labels vc2_labels.txt!");
+  if (!data::Load("vc2_test.csv", testDataset))
+    BOOST_FAIL("Cannot load dataset vc2_test.csv!");
+  if (!data::Load("vc2_test_labels.txt", testLabels))
+    BOOST_FAIL("Cannot load labels vc2_test_labels.txt!");
+
+  GradientBoosting gb;
+  const double shortLoss = gb.Train(dataset, labels, 3, 5);
+  const double loss = gb.Train(dataset, labels, 3, 50);
+  BOOST_REQUIRE_LT(loss, shortLoss);
+  BOOST_REQUIRE_EQUAL(gb.NumIterations(), 50);
+  BOOST_REQUIRE_EQUAL(gb.NumClasses(), 3);
+
+  arma::Row<size_t> predictions;
+  arma::mat probabilities;
+  gb.Classify(testDataset, predictions, probabilities);
+
+  BOOST_REQUIRE_EQUAL(predictions.n_elem, testDataset.n_cols);
+  BOOST_REQUIRE_EQUAL(probabilities.n_rows, 3);
+  BOOST_REQUIRE_EQUAL(probabilities.n_cols, testDataset.n_cols);
+  for (size_t i = 0; i < testDataset.n_cols; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(arma::accu(probabilities.col(i)), 1.0, 1e-5);
+    BOOST_REQUIRE_EQUAL(predictions[i],
+        gb.Classify(testDataset.col(i)));
+  }
+
+  const size_t correct = arma::accu(predictions == testLabels);
+  BOOST_REQUIRE_GE(correct, size_t(0.7 * testDataset.n_cols));
+}
+
+/**
+ * Make sure that training with row and feature subsampling still learns.
+ */
+BOOST_AUTO_TEST_CASE(GradientBoostingSubsampleTest)
+{
+  arma::mat dataset, testDataset;
+  arma::Row<size_t> labels, testLabels;
+  if (!data::Load("vc2.csv", dataset))
+    BOOST_FAIL("Cannot load dataset vc2.csv!");
+  if (!data::Load("vc2_labels.txt", labels))
+    BOOST_FAIL("Cannot load labels vc2_labels.txt!");
+  if (!data::Load("vc2_test.csv", testDataset))
+    BOOST_FAIL("Cannot load dataset vc2_test.csv!");
+  if (!data::Load("vc2_test_labels.txt", testLabels))
+    BOOST_FAIL("Cannot load labels vc2_test_labels.txt!");
+
+  GradientBoosting gb(dataset, labels, 3, 50, 0.1, 4, 10, 0.7, 0.5, 64);
+
+  arma::Row<size_t> predictions;
+  gb.Classify(testDataset, predictions);
+
+  const size_t correct = arma::accu(predictions == testLabels);
+  BOOST_REQUIRE_GE(correct, size_t(0.65 * testDataset.n_cols));
+}
+
+/**
+ * Make sure that a serialized model gives the same predictions.
+ */
+BOOST_AUTO_TEST_CASE(GradientBoostingSerializationTest)
+{
+  arma::mat dataset;
+  arma::Row<size_t> labels;
+  if (!data::Load("vc2.csv", dataset))
+    BOOST_FAIL("Cannot load dataset vc2.csv!");
+  if (!data::Load("vc2_labels.txt", labels))
+    BOOST_FAIL("Cannot load labels vc2_labels.txt!");
+
+  GradientBoosting gb(dataset, labels, 3, 10);
+
+  GradientBoosting xmlGb, textGb, binaryGb;
+  SerializeObjectAll(gb, xmlGb, textGb, binaryGb);
+
+  arma::Row<size_t> predictions, xmlPredictions, textPredictions,
+      binaryPredictions;
+  arma::mat probabilities, xmlProbabilities, textProbabilities,
+      binaryProbabilities;
+  gb.Classify(dataset, predictions, probabilities);
+  xmlGb.Classify(dataset, xmlPredictions, xmlProbabilities);
+  textGb.Classify(dataset, textPredictions, textProbabilities);
+  binaryGb.Classify(dataset, binaryPredictions, binaryProbabilities);
+
+  CheckMatrices(predictions, xmlPredictions, textPredictions,
+      binaryPredictions);
+  CheckMatrices(probabilities, xmlProbabilities, textProbabilities,
+      binaryProbabilities);
+}
+
+/**
+ * Make sure that invalid parameters and untrained models throw.
+ */
+BOOST_AUTO_TEST_CASE(GradientBoostingInvalidParametersTest)
+{
+  arma::mat dataset(3, 100, arma::fill::randu);
+  arma::Row<size_t> labels(100);
+  for (size_t i = 0; i < 100; ++i)
+    labels[i] = i % 2;
+
+  GradientBoosting gb;
+  arma::Row<size_t> predictions;
+  BOOST_REQUIRE_THROW(gb.Classify(dataset, predictions),
+      std::invalid_argument);
+
+  arma::Row<size_t> shortLabels(99, arma::fill::zeros);
+  BOOST_REQUIRE_THROW(gb.Train(dataset, shortLabels, 2),
+      std::invalid_argument);
+  BOOST_REQUIRE_THROW(gb.Train(dataset, labels, 1), std::invalid_argument);
+  BOOST_REQUIRE_THROW(gb.Train(dataset, labels, 2, 10, 0.1, 6, 20, 0.0),
+      std::invalid_argument);
+  BOOST_REQUIRE_THROW(gb.Train(dataset, labels, 2, 10, 0.1, 6, 20, 1.0, 1.5),
+      std::invalid_argument);
+  BOOST_REQUIRE_THROW(gb.Train(dataset, labels, 2, 10, 0.1, 6, 20, 1.0, 1.0,
+      300), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
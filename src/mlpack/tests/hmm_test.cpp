@@ -1258,6 +1258,93 @@ BOOST_AUTO_TEST_CASE(HMMTrainReturnLogLikelihood)
   BOOST_REQUIRE_EQUAL(std::isfinite(loglik), true);
 }
 
+/**
+ * Make sure that Baum-Welch training on many short sequences does not depend on
+ * the order of the sequences, since the sequences are processed in parallel.
+ */
+BOOST_AUTO_TEST_CASE(HMMTrainManyShortSequencesTest)
+{
+  arma::mat transition("0.7 0.4; 0.3 0.6");
+  std::vector<DiscreteDistribution> emissions(2, DiscreteDistribution(3));
+  emissions[0].Probabilities() = "0.6 0.3 0.1";
+  emissions[1].Probabilities() = "0.1 0.2 0.7";
+  HMM<DiscreteDistribution> trueHmm(arma::vec("0.5 0.5"), transition,
+      emissions);
+
+  std::vector<arma::mat> observations(2000);
+  for (size_t i = 0; i < observations.size(); ++i)
+  {
+    arma::Row<size_t> states;
+    trueHmm.Generate(2 + i % 5, observations[i], states);
+  }
+  std::vector<arma::mat> reversed(observations.rbegin(), observations.rend());
+
+  HMM<DiscreteDistribution> hmm(2, DiscreteDistribution(3));
+  hmm.Transition() = arma::mat("0.6 0.5; 0.4 0.5");
+  hmm.Emission()[0].Probabilities() = "0.5 0.3 0.2";
+  hmm.Emission()[1].Probabilities() = "0.2 0.3 0.5";
+  HMM<DiscreteDistribution> reversedHmm(hmm);
+
+  const double loglik = hmm.Train(observations);
+  const double reversedLoglik = reversedHmm.Train(reversed);
+
+  BOOST_REQUIRE_EQUAL(std::isfinite(loglik), true);
+  BOOST_REQUIRE_CLOSE(loglik, reversedLoglik, 1e-5);
+  for (size_t i = 0; i < 2; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(hmm.Initial()[i], reversedHmm.Initial()[i], 1e-3);
+    for (size_t j = 0; j < 2; ++j)
+    {
+      BOOST_REQUIRE_CLOSE(hmm.Transition()(i, j),
+          reversedHmm.Transition()(i, j), 1e-3);
+    }
+    for (size_t e = 0; e < 3; ++e)
+    {
+      BOOST_REQUIRE_CLOSE(hmm.Emission()[i].Probabilities()[e],
+          reversedHmm.Emission()[i].Probabilities()[e], 1e-3);
+    }
+  }
+}
+
+/**
+ * Make sure that decoding many sequences at once gives the same state
+ * sequences and log-likelihoods as decoding each of them.
+ */
+BOOST_AUTO_TEST_CASE(HMMBatchPredictTest)
+{
+  arma::mat transition("0.5 0.2 0.1; 0.3 0.7 0.2; 0.2 0.1 0.7");
+  std::vector<GaussianDistribution> emissions;
+  emissions.push_back(GaussianDistribution("0 0", "1 0; 0 1"));
+  emissions.push_back(GaussianDistribution("2 1", "1 0.2; 0.2 1"));
+  emissions.push_back(GaussianDistribution("-1 3", "2 0; 0 0.5"));
+  HMM<GaussianDistribution> hmm(arma::vec("0.4 0.3 0.3"), transition,
+      emissions);
+
+  std::vector<arma::mat> observations(200);
+  for (size_t i = 0; i < observations.size(); ++i)
+  {
+    arma::Row<size_t> states;
+    hmm.Generate(1 + i % 37, observations[i], states, i % 3);
+  }
+
+  std::vector<arma::Row<size_t>> stateSeqs;
+  arma::vec logLikelihoods;
+  hmm.Predict(observations, stateSeqs, logLikelihoods);
+
+  BOOST_REQUIRE_EQUAL(stateSeqs.size(), observations.size());
+  BOOST_REQUIRE_EQUAL(logLikelihoods.n_elem, observations.size());
+  for (size_t i = 0; i < observations.size(); ++i)
+  {
+    arma::Row<size_t> stateSeq;
+    const double logLikelihood = hmm.Predict(observations[i], stateSeq);
+
+    BOOST_REQUIRE_CLOSE(logLikelihoods[i], logLikelihood, 1e-5);
+    BOOST_REQUIRE_EQUAL(stateSeqs[i].n_elem, stateSeq.n_elem);
+    for (size_t t = 0; t < stateSeq.n_elem; ++t)
+      BOOST_REQUIRE_EQUAL(stateSeqs[i][t], stateSeq[t]);
+  }
+}
+
 /********************************************/
 /** DiagonalGMM Hidden Markov Models Tests **/
 /********************************************/
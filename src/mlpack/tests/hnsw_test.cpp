@@ -0,0 +1,201 @@
+/**
+ * @file tests/hnsw_test.cpp
+ *
+ * Unit tests for the 'HNSWSearch' class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
+#include <boost/test/unit_test.hpp>
+#include "test_tools.hpp"
+#include "serialization.hpp"
+
+#include <mlpack/methods/hnsw/hnsw_search.hpp>
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
+
+using namespace std;
+using namespace mlpack;
+using namespace mlpack::neighbor;
+
+BOOST_AUTO_TEST_SUITE(HNSWTest);
+
+/**
+ * Test that searching the graph finds most of the true nearest neighbors, and
+ * that a larger ef finds more of them.
+ */
+BOOST_AUTO_TEST_CASE(HNSWRecallTest)
+{
+  const size_t k = 10;
+  arma::mat rdata(10, 2000, arma::fill::randu);
+  arma::mat qdata(10, 200, arma::fill::randu);
+
+  KNN knn(rdata);
+  arma::Mat<size_t> groundTruth;
+  arma::mat groundDistances;
+  knn.Search(qdata, k, groundTruth, groundDistances);
+
+  HNSWSearch<> hnsw(rdata, 16, 100);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+
+  hnsw.Search(qdata, k, neighbors, distances, 10);
+  const double cheapRecall = HNSWSearch<>::ComputeRecall(neighbors,
+      groundTruth);
+
+  hnsw.Search(qdata, k, neighbors, distances, 200);
+  const double recall = HNSWSearch<>::ComputeRecall(neighbors, groundTruth);
+
+  BOOST_REQUIRE_GE(recall, 0.95);
+  BOOST_REQUIRE_GE(recall, cheapRecall);
+
+  // The distances are those of the neighbors, in increasing order.
+  for (size_t i = 0; i < qdata.n_cols; ++i)
+  {
+    for (size_t j = 0; j < k; ++j)
+    {
+      BOOST_REQUIRE_CLOSE(distances(j, i), metric::EuclideanDistance::Evaluate(
+          qdata.col(i), rdata.col(neighbors(j, i))), 1e-5);
+      if (j > 0)
+        BOOST_REQUIRE_LE(distances(j - 1, i), distances(j, i));
+    }
+  }
+}
+
+/**
+ * Test that searching the reference set never returns a point as its own
+ * neighbor, and finds most of the true neighbors.
+ */
+BOOST_AUTO_TEST_CASE(HNSWMonochromaticTest)
+{
+  const size_t k = 5;
+  arma::mat rdata(5, 1000, arma::fill::randu);
+
+  KNN knn(rdata);
+  arma::Mat<size_t> groundTruth;
+  arma::mat groundDistances;
+  knn.Search(k, groundTruth, groundDistances);
+
+  HNSWSearch<> hnsw(rdata);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  hnsw.Search(k, neighbors, distances);
+
+  for (size_t i = 0; i < neighbors.n_cols; ++i)
+    for (size_t j = 0; j < k; ++j)
+      BOOST_REQUIRE_NE(neighbors(j, i), i);
+
+  BOOST_REQUIRE_GE(HNSWSearch<>::ComputeRecall(neighbors, groundTruth), 0.95);
+}
+
+/**
+ * Test that the links of the graph respect the levels of the nodes and the
+ * maximum number of connections.
+ */
+BOOST_AUTO_TEST_CASE(HNSWGraphStructureTest)
+{
+  const size_t maxConnections = 6;
+  arma::mat rdata(3, 1500, arma::fill::randu);
+  HNSWSearch<> hnsw(rdata, maxConnections, 50);
+
+  BOOST_REQUIRE_EQUAL(hnsw.Level(hnsw.EntryPoint()), hnsw.MaxLevel());
+  BOOST_REQUIRE_GT(hnsw.MaxLevel(), 0);
+  for (size_t i = 0; i < rdata.n_cols; ++i)
+  {
+    BOOST_REQUIRE_LE(hnsw.Level(i), hnsw.MaxLevel());
+    for (size_t l = 0; l <= hnsw.Level(i); ++l)
+    {
+      const std::vector<size_t>& links = hnsw.Links(i, l);
+      BOOST_REQUIRE_LE(links.size(), (l == 0) ? 2 * maxConnections :
+          maxConnections);
+      for (size_t j = 0; j < links.size(); ++j)
+      {
+        BOOST_REQUIRE_NE(links[j], i);
+        BOOST_REQUIRE_GE(hnsw.Level(links[j]), l);
+      }
+    }
+  }
+
+  // Every node has links at level 0.
+  for (size_t i = 0; i < rdata.n_cols; ++i)
+    BOOST_REQUIRE_GT(hnsw.Links(i, 0).size(), 0);
+}
+
+/**
+ * Test that the graph can be built on single-precision data.
+ */
+BOOST_AUTO_TEST_CASE(HNSWFloatTest)
+{
+  const size_t k = 3;
+  arma::mat rdata(8, 1000, arma::fill::randu);
+  arma::mat qdata(8, 100, arma::fill::randu);
+
+  KNN knn(rdata);
+  arma::Mat<size_t> groundTruth;
+  arma::mat groundDistances;
+  knn.Search(qdata, k, groundTruth, groundDistances);
+
+  HNSWSearch<metric::EuclideanDistance, arma::fmat> hnsw(
+      arma::conv_to<arma::fmat>::from(rdata));
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  hnsw.Search(arma::conv_to<arma::fmat>::from(qdata), k, neighbors, distances,
+      100);
+
+  BOOST_REQUIRE_GE(HNSWSearch<>::ComputeRecall(neighbors, groundTruth), 0.95);
+}
+
+/**
+ * Test that a serialized model gives the same results.
+ */
+BOOST_AUTO_TEST_CASE(HNSWSerializationTest)
+{
+  arma::mat rdata(4, 500, arma::fill::randu);
+  arma::mat qdata(4, 50, arma::fill::randu);
+
+  HNSWSearch<> hnsw(rdata, 8, 50);
+  HNSWSearch<> xmlHnsw, textHnsw, binaryHnsw;
+  SerializeObjectAll(hnsw, xmlHnsw, textHnsw, binaryHnsw);
+
+  arma::Mat<size_t> neighbors, xmlNeighbors, textNeighbors, binaryNeighbors;
+  arma::mat distances, xmlDistances, textDistances, binaryDistances;
+  hnsw.Search(qdata, 5, neighbors, distances);
+  xmlHnsw.Search(qdata, 5, xmlNeighbors, xmlDistances);
+  textHnsw.Search(qdata, 5, textNeighbors, textDistances);
+  binaryHnsw.Search(qdata, 5, binaryNeighbors, binaryDistances);
+
+  CheckMatrices(neighbors, xmlNeighbors, textNeighbors, binaryNeighbors);
+  CheckMatrices(distances, xmlDistances, textDistances, binaryDistances);
+}
+
+/**
+ * Test that invalid searches throw.
+ */
+BOOST_AUTO_TEST_CASE(HNSWInvalidSearchTest)
+{
+  arma::mat rdata(4, 20, arma::fill::randu);
+  HNSWSearch<> hnsw(rdata);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+
+  // Too many neighbors.
+  BOOST_REQUIRE_THROW(hnsw.Search(rdata, 21, neighbors, distances),
+      std::invalid_argument);
+  BOOST_REQUIRE_THROW(hnsw.Search(20, neighbors, distances),
+      std::invalid_argument);
+
+  // Wrong dimensionality.
+  arma::mat qdata(3, 5, arma::fill::randu);
+  BOOST_REQUIRE_THROW(hnsw.Search(qdata, 2, neighbors, distances),
+      std::invalid_argument);
+
+  // Untrained model.
+  HNSWSearch<> empty;
+  BOOST_REQUIRE_THROW(empty.Search(rdata, 2, neighbors, distances),
+      std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
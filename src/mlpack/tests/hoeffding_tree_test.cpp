@@ -20,6 +20,7 @@
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
 #include "serialization.hpp"
+#include "mock_categorical_data.hpp"
 
 #include <stack>
 
@@ -863,6 +864,46 @@ BOOST_AUTO_TEST_CASE(NumericHoeffdingTreeTest)
   BOOST_REQUIRE_GT(batchCorrect, 6000);
 }
 
+/**
+ * Make sure that streaming training on minibatches gives the same tree as
+ * training on each point in turn.
+ */
+BOOST_AUTO_TEST_CASE(MinibatchStreamingTrainingTest)
+{
+  arma::mat dataset;
+  arma::Row<size_t> labels;
+  data::DatasetInfo info;
+  MockCategoricalData(dataset, labels, info);
+
+  // The points are sorted by class, so shuffle them.
+  const arma::uvec order = arma::randperm<arma::uvec>(dataset.n_cols);
+  dataset = dataset.cols(order);
+  labels = labels.cols(order);
+
+  HoeffdingTree<> pointTree(info, 5);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+    pointTree.Train(dataset.col(i), labels[i]);
+
+  // Use minibatches that do not line up with the split checks.
+  HoeffdingTree<> batchTree(info, 5);
+  for (size_t begin = 0; begin < dataset.n_cols; begin += 333)
+  {
+    const size_t end = std::min(begin + 333, (size_t) dataset.n_cols) - 1;
+    batchTree.Train(dataset.cols(begin, end), labels.cols(begin, end), false);
+  }
+
+  BOOST_REQUIRE_GT(pointTree.NumChildren(), 0);
+  BOOST_REQUIRE_EQUAL(batchTree.NumChildren(), pointTree.NumChildren());
+  BOOST_REQUIRE_EQUAL(batchTree.SplitDimension(), pointTree.SplitDimension());
+
+  arma::Row<size_t> pointPredictions, batchPredictions;
+  arma::rowvec pointProbabilities, batchProbabilities;
+  pointTree.Classify(dataset, pointPredictions, pointProbabilities);
+  batchTree.Classify(dataset, batchPredictions, batchProbabilities);
+  CheckMatrices(pointPredictions, batchPredictions);
+  CheckMatrices(pointProbabilities, batchProbabilities);
+}
+
 /**
  * The same as the previous test, but with the numeric binary split, and with a
  * categorical feature.
@@ -1220,6 +1261,109 @@ BOOST_AUTO_TEST_CASE(MultipleSerializationTest)
   }
 }
 
+/**
+ * Make sure that limiting the number of active leaves keeps the most promising
+ * leaves active, doesn't change the predictions, and survives further training
+ * and serialization.
+ */
+BOOST_AUTO_TEST_CASE(MaxActiveLeavesTest)
+{
+  // Generate data.
+  arma::mat dataset(4, 9000);
+  arma::Row<size_t> labels(9000);
+  data::DatasetInfo info(4); // All features are numeric, except the fourth.
+  info.MapString<double>("0", 3);
+  for (size_t i = 0; i < 9000; i += 3)
+  {
+    dataset(0, i) = mlpack::math::Random();
+    dataset(1, i) = mlpack::math::Random();
+    dataset(2, i) = mlpack::math::Random();
+    dataset(3, i) = 0.0;
+    labels[i] = 0;
+
+    dataset(0, i + 1) = mlpack::math::Random();
+    dataset(1, i + 1) = mlpack::math::Random() - 1.0;
+    dataset(2, i + 1) = mlpack::math::Random() + 0.5;
+    dataset(3, i + 1) = 0.0;
+    labels[i + 1] = 2;
+
+    dataset(0, i + 2) = mlpack::math::Random();
+    dataset(1, i + 2) = mlpack::math::Random() + 1.0;
+    dataset(2, i + 2) = mlpack::math::Random() + 0.8;
+    dataset(3, i + 2) = 0.0;
+    labels[i + 2] = 1;
+  }
+
+  // Batch training will give a tree with many leaves.
+  HoeffdingTree<> tree(dataset, info, labels, 3, true);
+  BOOST_REQUIRE_GT(tree.NumActiveLeaves(), 2);
+
+  arma::Row<size_t> predictions;
+  tree.Classify(dataset, predictions);
+
+  tree.MaxActiveLeaves(2);
+  BOOST_REQUIRE_EQUAL(tree.NumActiveLeaves(), 2);
+
+  // No inactive leaf may be more promising than an active leaf.
+  size_t minActivePromise = size_t(-1);
+  size_t maxInactivePromise = 0;
+  std::stack<HoeffdingTree<>*> stack;
+  stack.push(&tree);
+  while (!stack.empty())
+  {
+    HoeffdingTree<>* node = stack.top();
+    stack.pop();
+
+    BOOST_REQUIRE_EQUAL(node->MaxActiveLeaves(), 2);
+    if (node->NumChildren() == 0 && node->Active())
+      minActivePromise = std::min(minActivePromise, node->Promise());
+    else if (node->NumChildren() == 0)
+      maxInactivePromise = std::max(maxInactivePromise, node->Promise());
+
+    for (size_t i = 0; i < node->NumChildren(); ++i)
+      stack.push(&node->Child(i));
+  }
+  BOOST_REQUIRE_LE(maxInactivePromise, minActivePromise);
+
+  // Inactive leaves still classify with their majority class.
+  arma::Row<size_t> limitedPredictions;
+  tree.Classify(dataset, limitedPredictions);
+  for (size_t i = 0; i < predictions.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(predictions[i], limitedPredictions[i]);
+
+  // The limit holds after streaming training, with sets of points and with
+  // single points.
+  tree.Train(dataset, labels, false);
+  BOOST_REQUIRE_LE(tree.NumActiveLeaves(), 2);
+
+  tree.CheckInterval(100);
+  for (size_t i = 0; i < 1000; ++i)
+    tree.Train(dataset.col(i), labels[i]);
+  BOOST_REQUIRE_LE(tree.NumActiveLeaves(), 2);
+
+  HoeffdingTree<> xmlTree, textTree, binaryTree;
+  SerializeObjectAll(tree, xmlTree, textTree, binaryTree);
+
+  BOOST_REQUIRE_EQUAL(xmlTree.MaxActiveLeaves(), 2);
+  BOOST_REQUIRE_EQUAL(textTree.MaxActiveLeaves(), 2);
+  BOOST_REQUIRE_EQUAL(binaryTree.MaxActiveLeaves(), 2);
+  BOOST_REQUIRE_EQUAL(xmlTree.NumActiveLeaves(), tree.NumActiveLeaves());
+  BOOST_REQUIRE_EQUAL(textTree.NumActiveLeaves(), tree.NumActiveLeaves());
+  BOOST_REQUIRE_EQUAL(binaryTree.NumActiveLeaves(), tree.NumActiveLeaves());
+
+  tree.Classify(dataset, predictions);
+  arma::Row<size_t> xmlPredictions, textPredictions, binaryPredictions;
+  xmlTree.Classify(dataset, xmlPredictions);
+  textTree.Classify(dataset, textPredictions);
+  binaryTree.Classify(dataset, binaryPredictions);
+  for (size_t i = 0; i < predictions.n_elem; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(predictions[i], xmlPredictions[i]);
+    BOOST_REQUIRE_EQUAL(predictions[i], textPredictions[i]);
+    BOOST_REQUIRE_EQUAL(predictions[i], binaryPredictions[i]);
+  }
+}
+
 // Test the Hoeffding tree model.
 BOOST_AUTO_TEST_CASE(HoeffdingTreeModelTest)
 {
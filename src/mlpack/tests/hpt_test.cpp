@@ -120,10 +120,12 @@ class QuadraticFunction
                     double xMin = 0.0,
                     double yMin = 0.0,
                     double zMin = 0.0) :
-      a(a), b(b), c(c), d(d), xMin(xMin), yMin(yMin), zMin(zMin) {}
+      a(a), b(b), c(c), d(d), xMin(xMin), yMin(yMin), zMin(zMin),
+      evaluations(0) {}
 
   double Evaluate(double x, double y, double z)
   {
+    ++evaluations;
     return a * pow(x - xMin, 2)  + b * pow(y - yMin, 2) + c * pow(z - zMin, 2)
         + d;
   }
@@ -135,8 +137,12 @@ class QuadraticFunction
     return MLAlgorithm();
   }
 
+  //! Get the number of times Evaluate() has been called.
+  size_t Evaluations() const { return evaluations; }
+
  private:
   double a, b, c, d, xMin, yMin, zMin;
+  size_t evaluations;
 };
 
 /**
@@ -179,6 +185,34 @@ BOOST_AUTO_TEST_CASE(CVFunctionGradientTest)
   BOOST_REQUIRE_CLOSE(gradient(2), aproximateZPartialDerivative, 1e-5);
 }
 
+/**
+ * Test CVFunction doesn't run cross-validation again for parameters it has
+ * already evaluated.
+ */
+BOOST_AUTO_TEST_CASE(CVFunctionCacheTest)
+{
+  QuadraticFunction<LARS> lf(1.0, -1.5, 2.5, 3.0);
+
+  IncrementPolicy policy(true);
+  DatasetMapper<IncrementPolicy, double> datasetInfo(policy, 3);
+  CVFunction<decltype(lf), LARS, 3> cvFun(lf, datasetInfo, 0.01, 0.001);
+
+  const arma::vec parameters("0.0 -1.0 2.0");
+  const double objective = cvFun.Evaluate(parameters);
+  BOOST_REQUIRE_EQUAL(lf.Evaluations(), 1);
+  BOOST_REQUIRE_EQUAL(cvFun.Evaluate(parameters), objective);
+  BOOST_REQUIRE_EQUAL(lf.Evaluations(), 1);
+
+  // The gradient only has to evaluate the three shifted points.
+  arma::mat gradient;
+  cvFun.Gradient(parameters, gradient);
+  BOOST_REQUIRE_EQUAL(lf.Evaluations(), 4);
+  BOOST_REQUIRE_EQUAL(cvFun.NumEvaluations(), 4);
+
+  cvFun.Evaluate(arma::vec("1.0 -1.0 2.0"));
+  BOOST_REQUIRE_EQUAL(lf.Evaluations(), 5);
+}
+
 
 void InitProneToOverfittingData(arma::mat& xs,
                                 arma::rowvec& ys,
@@ -402,4 +436,134 @@ BOOST_AUTO_TEST_CASE(HPTGradientDescentTest)
   BOOST_REQUIRE_CLOSE(zOptimized, zMin, 1e-4);
 }
 
+/**
+ * A function of three categorical parameters that records the configurations
+ * it is evaluated with.  Its minimum (zero) is at the given configuration.
+ */
+class CategoricalFunction
+{
+ public:
+  CategoricalFunction(const arma::vec& target) : target(target) {}
+
+  double Evaluate(const arma::mat& parameters)
+  {
+    evaluated.push_back(std::vector<double>(parameters.begin(),
+        parameters.end()));
+    return arma::accu(arma::square(arma::vectorise(parameters) - target));
+  }
+
+  //! Get the configurations the function has been evaluated with.
+  const std::vector<std::vector<double>>& Evaluated() const
+  { return evaluated; }
+
+ private:
+  arma::vec target;
+  std::vector<std::vector<double>> evaluated;
+};
+
+/**
+ * Run the given optimizer over a grid of 5 x 4 x 6 configurations, and return
+ * the best objective.  Check that no configuration is evaluated twice.
+ */
+template<typename OptimizerType>
+double OptimizeCategoricalFunction(OptimizerType& optimizer,
+                                   CategoricalFunction& function,
+                                   arma::mat& parameters)
+{
+  std::vector<bool> categoricalDimensions(3, true);
+  arma::Row<size_t> numCategories("5 4 6");
+  parameters.zeros(3, 1);
+
+  const double objective = optimizer.Optimize(function, parameters,
+      categoricalDimensions, numCategories);
+
+  std::set<std::vector<double>> distinct(function.Evaluated().begin(),
+      function.Evaluated().end());
+  BOOST_REQUIRE_EQUAL(distinct.size(), function.Evaluated().size());
+
+  return objective;
+}
+
+/**
+ * Test RandomSearch respects the budget and finds the optimum when the budget
+ * covers the whole grid.
+ */
+BOOST_AUTO_TEST_CASE(RandomSearchTest)
+{
+  arma::vec target("3 1 4");
+  arma::mat parameters;
+
+  RandomSearch budgeted(30);
+  CategoricalFunction f1(target);
+  OptimizeCategoricalFunction(budgeted, f1, parameters);
+  BOOST_REQUIRE_EQUAL(f1.Evaluated().size(), 30);
+
+  // With a bigger budget, every configuration is evaluated exactly once.
+  RandomSearch exhaustive(1000);
+  CategoricalFunction f2(target);
+  const double objective = OptimizeCategoricalFunction(exhaustive, f2,
+      parameters);
+  BOOST_REQUIRE_EQUAL(f2.Evaluated().size(), 120);
+  BOOST_REQUIRE_SMALL(objective, 1e-10);
+  for (size_t i = 0; i < 3; ++i)
+    BOOST_REQUIRE_CLOSE(parameters(i), target(i), 1e-5);
+
+  // An empty budget is an error.
+  RandomSearch empty(0);
+  CategoricalFunction f3(target);
+  BOOST_REQUIRE_THROW(OptimizeCategoricalFunction(empty, f3, parameters),
+      std::invalid_argument);
+}
+
+/**
+ * Test TPESearch respects the budget and finds the optimum with half of the
+ * grid evaluated.
+ */
+BOOST_AUTO_TEST_CASE(TPESearchTest)
+{
+  arma::vec target("3 1 4");
+  arma::mat parameters;
+
+  TPESearch optimizer(60);
+  CategoricalFunction f(target);
+  const double objective = OptimizeCategoricalFunction(optimizer, f,
+      parameters);
+
+  BOOST_REQUIRE_EQUAL(f.Evaluated().size(), 60);
+  BOOST_REQUIRE_SMALL(objective, 1e-10);
+  for (size_t i = 0; i < 3; ++i)
+    BOOST_REQUIRE_CLOSE(parameters(i), target(i), 1e-5);
+}
+
+/**
+ * Test HyperParameterTuner works with RandomSearch and TPESearch.
+ */
+BOOST_AUTO_TEST_CASE(HPTRandomAndTPESearchTest)
+{
+  arma::vec xs("-1 0 1 2 3");
+  arma::vec ys("-2 -1 0 1");
+  arma::vec zs("-3 -2 -1 0 1 2");
+
+  HyperParameterTuner<LARS, MSE, QuadraticFunction, RandomSearch>
+      randomHpt(1.0, 1.0, 1.0, 0.0, 2.0, -1.0, 1.0);
+  randomHpt.Optimizer().MaxEvaluations() = 120;
+
+  double x, y, z;
+  std::tie(x, y, z) = randomHpt.Optimize(xs, ys, zs);
+  BOOST_REQUIRE_CLOSE(x, 2.0, 1e-5);
+  BOOST_REQUIRE_CLOSE(y, -1.0, 1e-5);
+  BOOST_REQUIRE_CLOSE(z, 1.0, 1e-5);
+  BOOST_REQUIRE_SMALL(randomHpt.BestObjective(), 1e-10);
+
+  HyperParameterTuner<LARS, MSE, QuadraticFunction, TPESearch>
+      tpeHpt(1.0, 1.0, 1.0, 0.0, 2.0, -1.0, 1.0);
+  tpeHpt.Optimizer().MaxEvaluations() = 60;
+
+  std::tie(x, y, z) = tpeHpt.Optimize(xs, ys, zs);
+  BOOST_REQUIRE_CLOSE(x, 2.0, 1e-5);
+  BOOST_REQUIRE_CLOSE(y, -1.0, 1e-5);
+  BOOST_REQUIRE_CLOSE(z, 1.0, 1e-5);
+  BOOST_REQUIRE_SMALL(tpeHpt.BestObjective(), 1e-10);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
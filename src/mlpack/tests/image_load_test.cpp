@@ -133,6 +133,78 @@ BOOST_AUTO_TEST_CASE(SaveImageMatAPITest)
   remove("APITest.bmp");
 }
 
+/**
+ * Test that images are resized while they are loaded.
+ */
+BOOST_AUTO_TEST_CASE(LoadVectorImageResizeTest)
+{
+  std::vector<std::string> files(3, "test_image.png");
+  arma::Mat<unsigned char> matrix;
+  data::ImageInfo info;
+  BOOST_REQUIRE(data::Load(files, matrix, info, 20, 30, false) == true);
+  BOOST_REQUIRE_EQUAL(matrix.n_rows, 20 * 30 * 3);
+  BOOST_REQUIRE_EQUAL(matrix.n_cols, 3);
+  BOOST_REQUIRE_EQUAL(info.Width(), 20);
+  BOOST_REQUIRE_EQUAL(info.Height(), 30);
+  BOOST_REQUIRE_EQUAL(info.Channels(), 3);
+
+  // Resizing to the size of the images doesn't change them.
+  arma::Mat<unsigned char> same, original;
+  BOOST_REQUIRE(data::Load(files, same, info, 50, 50, false) == true);
+  BOOST_REQUIRE(data::Load(files, original, info, false) == true);
+  BOOST_REQUIRE_EQUAL(same.n_elem, original.n_elem);
+  for (size_t i = 0; i < same.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(same[i], original[i]);
+
+  // An image of one color keeps its color.
+  data::ImageInfo smallInfo(5, 5, 3);
+  arma::Mat<unsigned char> image(5 * 5 * 3, 1);
+  image.fill(77);
+  BOOST_REQUIRE(data::Save("ResizeTest.bmp", image, smallInfo, false));
+  files.push_back("ResizeTest.bmp");
+  BOOST_REQUIRE(data::Load(files, matrix, info, 9, 7, false) == true);
+  BOOST_REQUIRE_EQUAL(matrix.n_rows, 9 * 7 * 3);
+  BOOST_REQUIRE_EQUAL(matrix.n_cols, 4);
+  for (size_t i = 0; i < matrix.n_rows; ++i)
+    BOOST_REQUIRE_EQUAL(matrix(i, 3), 77);
+
+  // Without resizing, the images must have the same size.
+  BOOST_REQUIRE(data::Load(files, matrix, info, false) == false);
+  remove("ResizeTest.bmp");
+}
+
+/**
+ * Test that a ChunkLoader streams a dataset of images in chunks.
+ */
+BOOST_AUTO_TEST_CASE(ChunkLoaderImageTest)
+{
+  std::vector<std::string> files(5, "test_image.png");
+  arma::mat responses = arma::linspace<arma::rowvec>(0, 4, 5);
+  data::ImageInfo info(10, 10, 3);
+  data::ChunkLoader loader(files, responses, 2, info, false);
+  BOOST_REQUIRE_EQUAL(loader.NumChunks(), 3);
+  BOOST_REQUIRE_EQUAL(loader.ResponseRows(), 1);
+
+  arma::mat expected;
+  BOOST_REQUIRE(data::Load(files, expected, info, 10, 10, false) == true);
+
+  arma::mat predictors, chunkResponses;
+  size_t count = 0;
+  while (loader.Next(predictors, chunkResponses))
+  {
+    BOOST_REQUIRE_EQUAL(predictors.n_rows, 10 * 10 * 3);
+    BOOST_REQUIRE_EQUAL(chunkResponses.n_rows, 1);
+    BOOST_REQUIRE_EQUAL(predictors.n_cols, (count < 4) ? 2 : 1);
+    for (size_t i = 0; i < predictors.n_cols; ++i, ++count)
+    {
+      BOOST_REQUIRE_EQUAL(chunkResponses(0, i), (double) count);
+      for (size_t j = 0; j < predictors.n_rows; ++j)
+        BOOST_REQUIRE_EQUAL(predictors(j, i), expected(j, count));
+    }
+  }
+  BOOST_REQUIRE_EQUAL(count, 5);
+}
+
 /**
  * Serialization test for the ImageInfo class.
  */
@@ -267,6 +267,91 @@ BOOST_AUTO_TEST_CASE(ListwiseDeletionTest)
   BOOST_REQUIRE_CLOSE(rowWiseInput(1, 3), 8.0, 1e-5);
 }
 
+/**
+ * Impute every dimension of a random matrix with missing values at once, and
+ * make sure the result is the same as imputing each dimension separately.
+ */
+template<typename StrategyType>
+void CheckImputeAllDimensions(StrategyType& imputer, const bool columnMajor)
+{
+  arma::mat input = arma::round(arma::randu(7, 40) * 4.0);
+  input(3, 5) = arma::datum::nan;
+  input(3, 20) = arma::datum::nan;
+  if (!columnMajor)
+    arma::inplace_trans(input);
+
+  std::vector<size_t> dimensions = { 0, 2, 3, 6 };
+  std::vector<double> mappedValues = { 0.0, 1.0, 2.0, 0.0 };
+
+  arma::mat expected(input);
+  for (size_t d = 0; d < dimensions.size(); ++d)
+    imputer.Impute(expected, mappedValues[d], dimensions[d], columnMajor);
+
+  imputer.Impute(input, mappedValues, dimensions, columnMajor);
+
+  BOOST_REQUIRE_EQUAL(input.n_rows, expected.n_rows);
+  BOOST_REQUIRE_EQUAL(input.n_cols, expected.n_cols);
+  for (size_t i = 0; i < input.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(input[i], expected[i], 1e-5);
+}
+
+/**
+ * Make sure every strategy imputes all the given dimensions at once like it
+ * imputes each dimension.
+ */
+BOOST_AUTO_TEST_CASE(ImputeAllDimensionsTest)
+{
+  CustomImputation<double> custom(99);
+  MeanImputation<double> mean;
+  MedianImputation<double> median;
+  ListwiseDeletion<double> listwise;
+
+  for (const bool columnMajor : { true, false })
+  {
+    CheckImputeAllDimensions(custom, columnMajor);
+    CheckImputeAllDimensions(mean, columnMajor);
+    CheckImputeAllDimensions(median, columnMajor);
+    CheckImputeAllDimensions(listwise, columnMajor);
+  }
+}
+
+/**
+ * Make sure the Imputer imputes every dimension in which the missing value was
+ * mapped.
+ */
+BOOST_AUTO_TEST_CASE(ImputerAllDimensionsTest)
+{
+  fstream f;
+  f.open("test_file.csv", fstream::out);
+  f << "a, 2, 3"  << endl;
+  f << "5, 6, a"  << endl;
+  f << "8, 9, 10" << endl;
+  f.close();
+
+  arma::mat input;
+  MissingPolicy policy({"a"});
+  DatasetMapper<MissingPolicy> info(policy);
+  BOOST_REQUIRE(data::Load("test_file.csv", input, info) == true);
+
+  Imputer<double,
+          DatasetMapper<MissingPolicy>,
+          MeanImputation<double>> imputer(info);
+  imputer.Impute(input, "a");
+
+  BOOST_REQUIRE_CLOSE(input(0, 0), 6.5, 1e-5);
+  BOOST_REQUIRE_CLOSE(input(0, 1), 5.0, 1e-5);
+  BOOST_REQUIRE_CLOSE(input(0, 2), 8.0, 1e-5);
+  BOOST_REQUIRE_CLOSE(input(1, 0), 2.0, 1e-5);
+  BOOST_REQUIRE_CLOSE(input(1, 1), 6.0, 1e-5);
+  BOOST_REQUIRE_CLOSE(input(1, 2), 9.0, 1e-5);
+  BOOST_REQUIRE_CLOSE(input(2, 0), 3.0, 1e-5);
+  BOOST_REQUIRE_CLOSE(input(2, 1), 6.5, 1e-5);
+  BOOST_REQUIRE_CLOSE(input(2, 2), 10.0, 1e-5);
+
+  // Remove the file.
+  remove("test_file.csv");
+}
+
 /**
  * Make sure we can map non-strings.
  */
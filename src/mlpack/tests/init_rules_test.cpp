@@ -380,4 +380,32 @@ BOOST_AUTO_TEST_CASE(LecunNormalInitTest)
   BOOST_REQUIRE_EQUAL(weights3d.n_slices, slices);
 }
 
+/**
+ * Test that the He and LecunNormal initialization rules can initialize single
+ * precision weights.
+ */
+BOOST_AUTO_TEST_CASE(FloatInitTest)
+{
+  arma::fmat weights;
+  arma::fcube weights3d;
+
+  HeInitialization heInitializer;
+  heInitializer.Initialize(weights, 4, 5);
+  heInitializer.Initialize(weights3d, 4, 5, 2);
+
+  BOOST_REQUIRE_EQUAL(weights.n_rows, 4);
+  BOOST_REQUIRE_EQUAL(weights.n_cols, 5);
+  BOOST_REQUIRE_EQUAL(weights3d.n_slices, 2);
+
+  weights.reset();
+  weights3d.reset();
+  LecunNormalInitialization lecunInitializer;
+  lecunInitializer.Initialize(weights, 4, 5);
+  lecunInitializer.Initialize(weights3d, 4, 5, 2);
+
+  BOOST_REQUIRE_EQUAL(weights.n_rows, 4);
+  BOOST_REQUIRE_EQUAL(weights.n_cols, 5);
+  BOOST_REQUIRE_EQUAL(weights3d.n_slices, 2);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -596,6 +596,44 @@ BOOST_AUTO_TEST_CASE(BreadthFirstKDETest)
     BOOST_REQUIRE_CLOSE(bfEstimations[i], treeEstimations[i], relError * 100);
 }
 
+/**
+ * Test dual-tree best-first implementation results against brute force
+ * results.
+ */
+BOOST_AUTO_TEST_CASE(BestFirstKDETest)
+{
+  arma::mat reference = arma::randu(2, 200);
+  arma::mat query = arma::randu(2, 60);
+  arma::vec bfEstimations = arma::vec(query.n_cols, arma::fill::zeros);
+  arma::vec treeEstimations = arma::vec(query.n_cols, arma::fill::zeros);
+  const double kernelBandwidth = 0.8;
+  const double relError = 0.01;
+
+  // Brute force KDE.
+  GaussianKernel kernel(kernelBandwidth);
+  BruteForceKDE<GaussianKernel>(reference,
+                                query,
+                                bfEstimations,
+                                kernel);
+
+  // Best-first KDE.
+  metric::EuclideanDistance metric;
+  KDE<GaussianKernel,
+      metric::EuclideanDistance,
+      arma::mat,
+      tree::KDTree,
+      tree::KDTree<metric::EuclideanDistance,
+                   kde::KDEStat,
+                   arma::mat>::template BestFirstDualTreeTraverser>
+      kde(relError, 0.0, kernel, KDEMode::DUAL_TREE_MODE, metric);
+  kde.Train(reference);
+  kde.Evaluate(query, treeEstimations);
+
+  // Check whether results are equal.
+  for (size_t i = 0; i < query.n_cols; ++i)
+    BOOST_REQUIRE_CLOSE(bfEstimations[i], treeEstimations[i], relError * 100);
+}
+
 /**
  * Test 1-dimensional implementation results against brute force results.
  */
@@ -1301,4 +1339,334 @@ BOOST_AUTO_TEST_CASE(GaussianBreadthDualKDTreeMonteCarloKDE)
   BOOST_REQUIRE_GT(correctResults, 70);
 }
 
+/**
+ * Check the estimations of the given KDE type against brute force, for both
+ * bichromatic and monochromatic evaluation, with the given number of threads.
+ */
+template<typename KDEType>
+void CheckParallelKDE(const KDEMode mode, const size_t threads)
+{
+  arma::mat reference = arma::randu(2, 1000);
+  arma::mat query = arma::randu(2, 300);
+  const double kernelBandwidth = 0.12;
+  const double relError = 0.05;
+
+  GaussianKernel kernel(kernelBandwidth);
+  arma::vec bfEstimations(query.n_cols, arma::fill::zeros);
+  BruteForceKDE<GaussianKernel>(reference, query, bfEstimations, kernel);
+
+  // In the monochromatic case, a point is not evaluated with itself.
+  arma::vec bfMonoEstimations(reference.n_cols, arma::fill::zeros);
+  BruteForceKDE<GaussianKernel>(reference, reference, bfMonoEstimations,
+      kernel);
+  bfMonoEstimations -= kernel.Evaluate(0.0) / reference.n_cols;
+
+  #ifdef HAS_OPENMP
+  const int oldThreads = omp_get_max_threads();
+  omp_set_num_threads(threads);
+  #else
+  (void) threads;
+  #endif
+
+  metric::EuclideanDistance metric;
+  KDEType kde(relError, 0.0, kernel, mode, metric);
+  kde.Train(reference);
+
+  arma::vec estimations;
+  kde.Evaluate(query, estimations);
+
+  // Evaluate twice, to make sure no error tolerance is left over from the
+  // first evaluation.
+  arma::vec monoEstimations;
+  kde.Evaluate(monoEstimations);
+  kde.Evaluate(monoEstimations);
+
+  #ifdef HAS_OPENMP
+  omp_set_num_threads(oldThreads);
+  #endif
+
+  for (size_t i = 0; i < query.n_cols; ++i)
+    BOOST_REQUIRE_CLOSE(bfEstimations[i], estimations[i], relError * 100);
+  for (size_t i = 0; i < reference.n_cols; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(bfMonoEstimations[i], monoEstimations[i],
+        relError * 100);
+  }
+}
+
+/**
+ * Make sure that the parallel dual-tree and single-tree evaluations keep the
+ * error guarantees.
+ */
+BOOST_AUTO_TEST_CASE(ParallelKDETest)
+{
+  typedef KDE<GaussianKernel, EuclideanDistance, arma::mat, KDTree> KDTreeKDE;
+  typedef KDE<GaussianKernel, EuclideanDistance, arma::mat, BallTree>
+      BallTreeKDE;
+  typedef KDE<GaussianKernel, EuclideanDistance, arma::mat, StandardCoverTree>
+      CoverTreeKDE;
+
+  for (size_t threads = 1; threads <= 4; threads += 3)
+  {
+    CheckParallelKDE<KDTreeKDE>(KDEMode::DUAL_TREE_MODE, threads);
+    CheckParallelKDE<KDTreeKDE>(KDEMode::SINGLE_TREE_MODE, threads);
+    CheckParallelKDE<BallTreeKDE>(KDEMode::DUAL_TREE_MODE, threads);
+    CheckParallelKDE<CoverTreeKDE>(KDEMode::DUAL_TREE_MODE, threads);
+    CheckParallelKDE<CoverTreeKDE>(KDEMode::SINGLE_TREE_MODE, threads);
+  }
+}
+
+/**
+ * Make sure the parallel Monte Carlo estimations of the dual-tree and
+ * single-tree evaluations are as often right as the serial ones.
+ */
+BOOST_AUTO_TEST_CASE(ParallelMonteCarloKDETest)
+{
+  arma::mat reference = arma::randu(2, 3000);
+  arma::mat query = arma::randu(2, 200);
+  arma::vec bfEstimations = arma::vec(query.n_cols, arma::fill::zeros);
+  const double kernelBandwidth = 0.4;
+  const double relError = 0.05;
+
+  // Brute force KDE.
+  GaussianKernel kernel(kernelBandwidth);
+  BruteForceKDE<GaussianKernel>(reference,
+                                query,
+                                bfEstimations,
+                                kernel);
+
+  #ifdef HAS_OPENMP
+  const int oldThreads = omp_get_max_threads();
+  omp_set_num_threads(4);
+  #endif
+
+  for (size_t mode = 0; mode < 2; ++mode)
+  {
+    metric::EuclideanDistance metric;
+    KDE<GaussianKernel,
+        metric::EuclideanDistance,
+        arma::mat,
+        tree::KDTree>
+      kde(relError,
+          0.0,
+          kernel,
+          (mode == 0) ? KDEMode::DUAL_TREE_MODE : KDEMode::SINGLE_TREE_MODE,
+          metric,
+          true,
+          0.95,
+          100,
+          3,
+          0.8);
+    kde.Train(reference);
+
+    arma::vec treeEstimations;
+    kde.Evaluate(query, treeEstimations);
+
+    // The Monte Carlo estimation has a random component so it can fail.
+    // Therefore we require a reasonable amount of results to be right.
+    size_t correctResults = 0;
+    for (size_t i = 0; i < query.n_cols; ++i)
+    {
+      const double resultRelativeError =
+        std::abs((bfEstimations[i] - treeEstimations[i]) / bfEstimations[i]);
+      if (resultRelativeError < relError)
+        ++correctResults;
+    }
+
+    BOOST_REQUIRE_GT(correctResults, 70);
+  }
+
+  #ifdef HAS_OPENMP
+  omp_set_num_threads(oldThreads);
+  #endif
+}
+
+/**
+ * Check the far-field and local series expansions of the Gaussian kernel, and
+ * the translations between them, against the exact sums, within their error
+ * bounds.
+ */
+BOOST_AUTO_TEST_CASE(GaussianExpansionTest)
+{
+  const double bandwidth = 0.8;
+  const double radius = 0.25;
+  GaussianKernel kernel(bandwidth);
+  GaussianExpansion expansion(2, bandwidth);
+
+  // A cluster of reference points around referenceCenter, and one of query
+  // points around queryCenter.
+  arma::vec referenceCenter("0.0 0.0");
+  arma::vec queryCenter("1.2 0.6");
+  arma::mat reference = 2 * radius * arma::randu(2, 100) - radius;
+  reference.each_col() += referenceCenter;
+  arma::mat query = 2 * radius * arma::randu(2, 20) - radius;
+  query.each_col() += queryCenter;
+
+  arma::vec exact(query.n_cols, arma::fill::zeros);
+  BruteForceKDE<GaussianKernel>(reference, query, exact, kernel);
+  exact *= reference.n_cols;
+
+  const size_t numTerms = expansion.Terms(expansion.MaxOrder());
+  arma::vec moments(numTerms, arma::fill::zeros);
+  for (size_t i = 0; i < reference.n_cols; ++i)
+    expansion.AccumulateMoments(referenceCenter, reference.col(i), moments);
+
+  // Translating moments around another center must be exact.
+  arma::vec otherCenter("0.1 -0.2");
+  arma::vec otherMoments(numTerms, arma::fill::zeros);
+  for (size_t i = 0; i < reference.n_cols; ++i)
+    expansion.AccumulateMoments(otherCenter, reference.col(i), otherMoments);
+  arma::vec translatedMoments(numTerms, arma::fill::zeros);
+  expansion.TranslateMoments(referenceCenter, moments, otherCenter,
+      translatedMoments);
+  for (size_t k = 0; k < numTerms; ++k)
+    BOOST_REQUIRE_SMALL(translatedMoments[k] - otherMoments[k], 1e-8);
+
+  const double maxError = 0.01 * arma::min(exact);
+  double farFieldError, localError, translationError;
+  const size_t farFieldOrder = expansion.FarFieldOrder(reference.n_cols,
+      radius, maxError, farFieldError);
+  const size_t localOrder = expansion.LocalOrder(reference.n_cols, radius,
+      maxError, localError);
+  const size_t translationOrder = expansion.TranslationOrder(reference.n_cols,
+      radius, radius, maxError, translationError);
+  BOOST_REQUIRE_GT(farFieldOrder, 0);
+  BOOST_REQUIRE_GT(localOrder, 0);
+  BOOST_REQUIRE_GT(translationOrder, 0);
+
+  arma::vec localCoefficients(numTerms, arma::fill::zeros);
+  for (size_t i = 0; i < reference.n_cols; ++i)
+  {
+    expansion.AccumulateLocal(queryCenter, reference.col(i), localOrder,
+        localCoefficients);
+  }
+
+  arma::vec translatedCoefficients(numTerms, arma::fill::zeros);
+  expansion.TranslateToLocal(referenceCenter, moments, queryCenter,
+      translationOrder, translatedCoefficients);
+
+  for (size_t i = 0; i < query.n_cols; ++i)
+  {
+    const double farField = expansion.EvaluateMoments(referenceCenter,
+        moments, farFieldOrder, query.col(i));
+    const double local = expansion.EvaluateLocal(queryCenter,
+        localCoefficients, query.col(i));
+    const double translated = expansion.EvaluateLocal(queryCenter,
+        translatedCoefficients, query.col(i));
+
+    BOOST_REQUIRE_LE(std::abs(farField - exact[i]), farFieldError);
+    BOOST_REQUIRE_LE(std::abs(local - exact[i]), localError);
+    BOOST_REQUIRE_LE(std::abs(translated - exact[i]), translationError);
+  }
+}
+
+/**
+ * Make sure that the series expansions keep the error guarantees of the
+ * dual-tree evaluation, in low dimensions and with a bandwidth large enough
+ * for the expansions to be used.
+ */
+BOOST_AUTO_TEST_CASE(SeriesExpansionKDETest)
+{
+  for (size_t dims = 1; dims <= 3; ++dims)
+  {
+    arma::mat reference = arma::randu(dims, 2000);
+    arma::mat query = arma::randu(dims, 300);
+    const double kernelBandwidth = 0.3;
+    const double relError = 0.05;
+
+    GaussianKernel kernel(kernelBandwidth);
+    arma::vec bfEstimations(query.n_cols, arma::fill::zeros);
+    BruteForceKDE<GaussianKernel>(reference, query, bfEstimations, kernel);
+
+    arma::vec bfMonoEstimations(reference.n_cols, arma::fill::zeros);
+    BruteForceKDE<GaussianKernel>(reference, reference, bfMonoEstimations,
+        kernel);
+    bfMonoEstimations -= kernel.Evaluate(0.0) / reference.n_cols;
+
+    metric::EuclideanDistance metric;
+    KDE<GaussianKernel, EuclideanDistance, arma::mat, KDTree>
+        kde(relError,
+            0.0,
+            kernel,
+            KDEMode::DUAL_TREE_MODE,
+            metric,
+            KDEDefaultParams::monteCarlo,
+            KDEDefaultParams::mcProb,
+            KDEDefaultParams::initialSampleSize,
+            KDEDefaultParams::mcEntryCoef,
+            KDEDefaultParams::mcBreakCoef,
+            true);
+    kde.Train(reference);
+
+    arma::vec estimations, monoEstimations;
+    kde.Evaluate(query, estimations);
+    kde.Evaluate(monoEstimations);
+
+    for (size_t i = 0; i < query.n_cols; ++i)
+      BOOST_REQUIRE_CLOSE(bfEstimations[i], estimations[i], relError * 100);
+    for (size_t i = 0; i < reference.n_cols; ++i)
+    {
+      BOOST_REQUIRE_CLOSE(bfMonoEstimations[i], monoEstimations[i],
+          relError * 100);
+    }
+  }
+}
+
+/**
+ * Make sure that inserting reference points into a trained model gives the
+ * same results as training on all the points, both with a tree that supports
+ * dynamic insertion and with one that has to be rebuilt, and that a query tree
+ * can be reused across evaluations.
+ */
+BOOST_AUTO_TEST_CASE(InsertReferencePointsTest)
+{
+  arma::mat reference = arma::randu(2, 500);
+  arma::mat newReference = arma::randu(2, 300);
+  arma::mat query = arma::randu(2, 200);
+  const arma::mat allReference = arma::join_rows(reference, newReference);
+  const double kernelBandwidth = 0.3;
+  const double relError = 0.01;
+
+  GaussianKernel kernel(kernelBandwidth);
+  arma::vec bfEstimations(query.n_cols, arma::fill::zeros);
+  BruteForceKDE<GaussianKernel>(reference, query, bfEstimations, kernel);
+  arma::vec bfAllEstimations(query.n_cols, arma::fill::zeros);
+  BruteForceKDE<GaussianKernel>(allReference, query, bfAllEstimations,
+      kernel);
+
+  // RTree supports dynamic insertion, so the reference tree is kept.
+  typedef RTree<EuclideanDistance, kde::KDEStat, arma::mat> RTreeType;
+  RTreeType* queryTree = new RTreeType(query);
+  KDE<GaussianKernel, EuclideanDistance, arma::mat, RTree>
+      rkde(relError, 0.0, kernel);
+  rkde.Train(reference);
+  const RTreeType* referenceTree = rkde.ReferenceTree();
+
+  arma::vec estimations;
+  rkde.Evaluate(queryTree, std::vector<size_t>(), estimations);
+  for (size_t i = 0; i < query.n_cols; ++i)
+    BOOST_REQUIRE_CLOSE(bfEstimations[i], estimations[i], relError * 100);
+
+  rkde.Insert(newReference);
+  BOOST_REQUIRE_EQUAL(rkde.ReferenceTree(), referenceTree);
+  BOOST_REQUIRE_EQUAL(rkde.ReferenceTree()->NumDescendants(),
+      allReference.n_cols);
+  rkde.Evaluate(queryTree, std::vector<size_t>(), estimations);
+  for (size_t i = 0; i < query.n_cols; ++i)
+    BOOST_REQUIRE_CLOSE(bfAllEstimations[i], estimations[i], relError * 100);
+  delete queryTree;
+
+  // The kd-tree has to be rebuilt.
+  KDE<GaussianKernel, EuclideanDistance, arma::mat, KDTree>
+      kde(relError, 0.0, kernel);
+  kde.Train(reference);
+  kde.Insert(newReference);
+  kde.Evaluate(query, estimations);
+  for (size_t i = 0; i < query.n_cols; ++i)
+    BOOST_REQUIRE_CLOSE(bfAllEstimations[i], estimations[i], relError * 100);
+
+  // Points of the wrong dimensionality can't be inserted.
+  BOOST_REQUIRE_THROW(kde.Insert(arma::randu(3, 10)), std::invalid_argument);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
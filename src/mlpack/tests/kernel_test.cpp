@@ -18,8 +18,10 @@
 #include <mlpack/core/kernels/linear_kernel.hpp>
 #include <mlpack/core/kernels/polynomial_kernel.hpp>
 #include <mlpack/core/kernels/spherical_kernel.hpp>
+#include <mlpack/core/kernels/triangular_kernel.hpp>
 #include <mlpack/core/kernels/pspectrum_string_kernel.hpp>
 #include <mlpack/core/kernels/cauchy_kernel.hpp>
+#include <mlpack/core/kernels/kernel_matrix.hpp>
 #include <mlpack/core/metrics/lmetric.hpp>
 #include <mlpack/core/metrics/mahalanobis_distance.hpp>
 
@@ -622,4 +624,168 @@ BOOST_AUTO_TEST_CASE(CauchyKernelTest)
   BOOST_REQUIRE_CLOSE(ck.Evaluate(b, a), 0.92592588, 1e-5);
 }
 
+/**
+ * Check the kernel matrices computed by KernelMatrix() against evaluations of
+ * the kernel on each pair of points.
+ */
+template<typename KernelType>
+void CheckKernelMatrix(KernelType& kernel)
+{
+  arma::mat a = arma::randu<arma::mat>(5, 40);
+  arma::mat b = arma::randu<arma::mat>(5, 25);
+
+  arma::mat kernelMatrix;
+  KernelMatrix(kernel, a, b, kernelMatrix);
+  BOOST_REQUIRE_EQUAL(kernelMatrix.n_rows, a.n_cols);
+  BOOST_REQUIRE_EQUAL(kernelMatrix.n_cols, b.n_cols);
+  for (size_t j = 0; j < b.n_cols; ++j)
+  {
+    for (size_t i = 0; i < a.n_cols; ++i)
+    {
+      BOOST_REQUIRE_CLOSE(kernelMatrix(i, j),
+          kernel.Evaluate(a.col(i), b.col(j)), 1e-5);
+    }
+  }
+
+  KernelMatrix(kernel, a, kernelMatrix);
+  BOOST_REQUIRE_EQUAL(kernelMatrix.n_rows, a.n_cols);
+  BOOST_REQUIRE_EQUAL(kernelMatrix.n_cols, a.n_cols);
+  for (size_t j = 0; j < a.n_cols; ++j)
+  {
+    for (size_t i = 0; i < a.n_cols; ++i)
+    {
+      BOOST_REQUIRE_CLOSE(kernelMatrix(i, j),
+          kernel.Evaluate(a.col(i), a.col(j)), 1e-5);
+    }
+  }
+
+  arma::vec values;
+  KernelVector(kernel, b.col(3), a, values);
+  BOOST_REQUIRE_EQUAL(values.n_elem, a.n_cols);
+  for (size_t i = 0; i < a.n_cols; ++i)
+    BOOST_REQUIRE_CLOSE(values[i], kernel.Evaluate(b.col(3), a.col(i)), 1e-5);
+}
+
+/**
+ * Make sure the kernel matrices computed with matrix products, and the ones
+ * computed pair by pair, are correct.
+ */
+BOOST_AUTO_TEST_CASE(KernelMatrixTest)
+{
+  LinearKernel linear;
+  CheckKernelMatrix(linear);
+
+  PolynomialKernel polynomial(3.0, 1.5);
+  CheckKernelMatrix(polynomial);
+
+  GaussianKernel gaussian(0.7);
+  CheckKernelMatrix(gaussian);
+
+  EpanechnikovKernel epanechnikov(2.0);
+  CheckKernelMatrix(epanechnikov);
+
+  HyperbolicTangentKernel tanh(0.5, 1.0);
+  CheckKernelMatrix(tanh);
+
+  LaplacianKernel laplacian(1.3);
+  CheckKernelMatrix(laplacian);
+
+  CauchyKernel cauchy(0.8);
+  CheckKernelMatrix(cauchy);
+
+  CosineDistance cosine;
+  CheckKernelMatrix(cosine);
+
+  // These kernels are evaluated pair by pair.
+  TriangularKernel triangular(2.0);
+  CheckKernelMatrix(triangular);
+
+  SphericalKernel spherical(1.0);
+  CheckKernelMatrix(spherical);
+}
+
+/**
+ * A kernel whose KernelTraits specialization doesn't say whether it provides
+ * BatchEvaluate().
+ */
+class OldTraitsKernel
+{
+ public:
+  template<typename VecTypeA, typename VecTypeB>
+  double Evaluate(const VecTypeA& a, const VecTypeB& b) const
+  {
+    return arma::dot(a, b) + 1.0;
+  }
+};
+
+namespace mlpack {
+namespace kernel {
+
+template<>
+class KernelTraits<OldTraitsKernel>
+{
+ public:
+  static const bool IsNormalized = false;
+};
+
+} // namespace kernel
+} // namespace mlpack
+
+/**
+ * Make sure the kernels that provide BatchEvaluate() say so, and that kernels
+ * whose traits don't mention it are evaluated pair by pair.
+ */
+BOOST_AUTO_TEST_CASE(KernelBatchEvaluateTraitsTest)
+{
+  BOOST_REQUIRE(KernelTraits<LinearKernel>::HasBatchEvaluate);
+  BOOST_REQUIRE(KernelTraits<PolynomialKernel>::HasBatchEvaluate);
+  BOOST_REQUIRE(KernelTraits<HyperbolicTangentKernel>::HasBatchEvaluate);
+  BOOST_REQUIRE(KernelTraits<GaussianKernel>::HasBatchEvaluate);
+  BOOST_REQUIRE(KernelTraits<LaplacianKernel>::HasBatchEvaluate);
+  BOOST_REQUIRE(KernelTraits<EpanechnikovKernel>::HasBatchEvaluate);
+  BOOST_REQUIRE(KernelTraits<CauchyKernel>::HasBatchEvaluate);
+  BOOST_REQUIRE(KernelTraits<CosineDistance>::HasBatchEvaluate);
+  BOOST_REQUIRE(!KernelTraits<TriangularKernel>::HasBatchEvaluate);
+  BOOST_REQUIRE(!KernelTraits<SphericalKernel>::HasBatchEvaluate);
+
+  BOOST_REQUIRE(!details::UsesBatchEvaluate<OldTraitsKernel>::value);
+  BOOST_REQUIRE(details::UsesBatchEvaluate<GaussianKernel>::value);
+
+  OldTraitsKernel kernel;
+  CheckKernelMatrix(kernel);
+}
+
+/**
+ * Make sure the batched cosine distance of a zero point is zero, like the
+ * cosine distance computed pair by pair.
+ */
+BOOST_AUTO_TEST_CASE(CosineDistanceBatchZeroPointTest)
+{
+  arma::mat a = arma::randu<arma::mat>(3, 4);
+  a.col(2).zeros();
+  arma::mat kernelMatrix;
+  CosineDistance::BatchEvaluate(a, a, kernelMatrix);
+
+  for (size_t i = 0; i < a.n_cols; ++i)
+  {
+    BOOST_REQUIRE_SMALL(kernelMatrix(2, i), 1e-10);
+    BOOST_REQUIRE_SMALL(kernelMatrix(i, 2), 1e-10);
+  }
+}
+
+/**
+ * Make sure KernelMatrix() throws when the two sets of points have different
+ * dimensionalities.
+ */
+BOOST_AUTO_TEST_CASE(KernelMatrixDimensionMismatchTest)
+{
+  arma::mat a = arma::randu<arma::mat>(5, 10);
+  arma::mat b = arma::randu<arma::mat>(4, 10);
+  arma::mat kernelMatrix;
+
+  GaussianKernel gaussian;
+  BOOST_REQUIRE_THROW(KernelMatrix(gaussian, a, b, kernelMatrix),
+      std::invalid_argument);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
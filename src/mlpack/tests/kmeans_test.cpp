@@ -16,9 +16,16 @@
 #include <mlpack/methods/kmeans/hamerly_kmeans.hpp>
 #include <mlpack/methods/kmeans/pelleg_moore_kmeans.hpp>
 #include <mlpack/methods/kmeans/dual_tree_kmeans.hpp>
+#include <mlpack/methods/kmeans/mini_batch_kmeans.hpp>
+#include <mlpack/methods/kmeans/streaming_kmeans.hpp>
+#include <mlpack/methods/kmeans/chunked_text_reader.hpp>
 #include <mlpack/methods/kmeans/sample_initialization.hpp>
 #include <mlpack/methods/kmeans/random_partition.hpp>
+#include <mlpack/methods/kmeans/kmeans_plus_plus_initialization.hpp>
+#include <mlpack/methods/kmeans/kmeans_parallel_initialization.hpp>
+#include <mlpack/methods/kmeans/distributed_kmeans.hpp>
 
+#include <mlpack/core/metrics/mahalanobis_distance.hpp>
 #include <mlpack/core/tree/cover_tree/cover_tree.hpp>
 #include <mlpack/methods/neighbor_search/neighbor_search.hpp>
 
@@ -534,6 +541,54 @@ BOOST_AUTO_TEST_CASE(SparseKMeansTest)
   BOOST_REQUIRE_EQUAL(assignments[11], clusterTwo);
 }
 
+/**
+ * Run k-means with the given step type on sparse data and on the same data as a
+ * dense matrix, from the same initial centroids, and make sure the results are
+ * the same.
+ */
+template<template<class, class> class LloydStepType>
+void CheckSparseLloydStep()
+{
+  // High-dimensional data with few nonzero elements per point, like TF-IDF
+  // features.
+  arma::sp_mat sparseData;
+  sparseData.sprandu(2000, 400, 0.01);
+  arma::mat data(sparseData);
+
+  arma::mat initialCentroids(data.n_rows, 8);
+  for (size_t i = 0; i < initialCentroids.n_cols; ++i)
+    initialCentroids.col(i) = data.col(50 * i);
+
+  KMeans<metric::EuclideanDistance, SampleInitialization,
+      MaxVarianceNewCluster, LloydStepType> kmeans;
+  arma::Row<size_t> assignments;
+  arma::mat centroids(initialCentroids);
+  kmeans.Cluster(data, 8, assignments, centroids, false, true);
+
+  KMeans<metric::EuclideanDistance, SampleInitialization,
+      MaxVarianceNewCluster, LloydStepType, arma::sp_mat> sparseKMeans;
+  arma::Row<size_t> sparseAssignments;
+  arma::mat sparseCentroids(initialCentroids);
+  sparseKMeans.Cluster(sparseData, 8, sparseAssignments, sparseCentroids,
+      false, true);
+
+  for (size_t i = 0; i < assignments.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(assignments[i], sparseAssignments[i]);
+  for (size_t i = 0; i < centroids.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(centroids[i] + 1.0, sparseCentroids[i] + 1.0, 1e-5);
+}
+
+/**
+ * Make sure that the naive, Elkan and Hamerly steps give the same results on
+ * sparse and dense data.
+ */
+BOOST_AUTO_TEST_CASE(SparseLloydStepTest)
+{
+  CheckSparseLloydStep<NaiveKMeans>();
+  CheckSparseLloydStep<ElkanKMeans>();
+  CheckSparseLloydStep<HamerlyKMeans>();
+}
+
 #endif // ARMA_HAS_SPMAT
 
 BOOST_AUTO_TEST_CASE(ElkanTest)
@@ -703,6 +758,86 @@ BOOST_AUTO_TEST_CASE(DTNNCoverTreeTest)
   }
 }
 
+#ifdef HAS_OPENMP
+/**
+ * Run k-means with the given Lloyd step type with one thread and with all
+ * threads, and make sure the results are the same.
+ */
+template<template<class, class> class LloydStepType>
+void CheckParallelLloydStep()
+{
+  arma::mat dataset = arma::randu<arma::mat>(10, 2000);
+  const size_t k = 50;
+  arma::mat centroids = arma::randu<arma::mat>(10, k);
+
+  KMeans<EuclideanDistance, RandomPartition, MaxVarianceNewCluster,
+      LloydStepType> km;
+
+  arma::Row<size_t> parallelAssignments;
+  arma::mat parallelCentroids(centroids);
+  km.Cluster(dataset, k, parallelAssignments, parallelCentroids, false, true);
+
+  const size_t prevNumThreads = omp_get_max_threads();
+  omp_set_num_threads(1);
+  arma::Row<size_t> sequentialAssignments;
+  arma::mat sequentialCentroids(centroids);
+  km.Cluster(dataset, k, sequentialAssignments, sequentialCentroids, false,
+      true);
+  omp_set_num_threads(prevNumThreads);
+
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+    BOOST_REQUIRE_EQUAL(parallelAssignments[i], sequentialAssignments[i]);
+
+  for (size_t i = 0; i < centroids.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(parallelCentroids[i], sequentialCentroids[i], 1e-5);
+}
+
+/**
+ * Make sure that the naive, Elkan, Hamerly, and dual-tree steps give the same
+ * results with any number of threads.
+ */
+BOOST_AUTO_TEST_CASE(ParallelLloydStepTest)
+{
+  CheckParallelLloydStep<NaiveKMeans>();
+  CheckParallelLloydStep<ElkanKMeans>();
+  CheckParallelLloydStep<HamerlyKMeans>();
+  CheckParallelLloydStep<DefaultDualTreeKMeans>();
+}
+#endif
+
+/**
+ * The blocked assignment of NaiveKMeans for the Euclidean distance should give
+ * the same step as the pairwise assignment (here, with the Mahalanobis
+ * distance with the identity covariance, which is the squared Euclidean
+ * distance but is evaluated pair by pair).
+ */
+BOOST_AUTO_TEST_CASE(NaiveKMeansBlockedAssignmentTest)
+{
+  arma::mat dataset(10, 5000, arma::fill::randu);
+  arma::mat centroids = dataset.cols(0, 299);
+
+  EuclideanDistance euclidean;
+  NaiveKMeans<EuclideanDistance, arma::mat> blocked(dataset, euclidean);
+  arma::mat blockedCentroids;
+  arma::Col<size_t> blockedCounts;
+  const double blockedResidual = blocked.Iterate(centroids, blockedCentroids,
+      blockedCounts);
+
+  MahalanobisDistance<false> mahalanobis(10);
+  NaiveKMeans<MahalanobisDistance<false>, arma::mat> pairwise(dataset,
+      mahalanobis);
+  arma::mat pairwiseCentroids;
+  arma::Col<size_t> pairwiseCounts;
+  pairwise.Iterate(centroids, pairwiseCentroids, pairwiseCounts);
+
+  // The residual is computed with the metric, so only compare the result.
+  BOOST_REQUIRE_GT(blockedResidual, 0.0);
+  for (size_t i = 0; i < blockedCounts.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(blockedCounts[i], pairwiseCounts[i]);
+  for (size_t i = 0; i < blockedCentroids.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(blockedCentroids[i], pairwiseCentroids[i], 1e-5);
+}
+
 /**
  * Make sure that the sample initialization strategy successfully samples points
  * from the dataset.
@@ -737,4 +872,265 @@ BOOST_AUTO_TEST_CASE(SampleInitializationTest)
   }
 }
 
+/**
+ * Make sure that k-means++ and k-means|| choose points of the dataset, and that
+ * on well-separated clusters they choose one point from each cluster.
+ */
+template<typename InitialPartitionPolicy>
+void CheckSeedingPolicy(const InitialPartitionPolicy& policy)
+{
+  arma::mat dataset = trans(kMeansData);
+  arma::mat centroids;
+  policy.Cluster(dataset, 3, centroids);
+
+  BOOST_REQUIRE_EQUAL(centroids.n_rows, 2);
+  BOOST_REQUIRE_EQUAL(centroids.n_cols, 3);
+
+  // Each centroid must be a point of the dataset; find its class.
+  arma::Col<size_t> classCounts(3, arma::fill::zeros);
+  for (size_t i = 0; i < 3; ++i)
+  {
+    size_t j;
+    for (j = 0; j < dataset.n_cols; ++j)
+    {
+      if (EuclideanDistance::Evaluate(centroids.col(i), dataset.col(j)) < 1e-10)
+        break;
+    }
+    BOOST_REQUIRE_LT(j, dataset.n_cols);
+
+    classCounts[(j < 13) ? 0 : ((j < 20) ? 1 : 2)]++;
+  }
+
+  // The clusters are far enough apart that this should almost always hold.
+  BOOST_REQUIRE(arma::all(classCounts == 1));
+}
+
+BOOST_AUTO_TEST_CASE(KMeansPlusPlusInitializationTest)
+{
+  CheckSeedingPolicy(KMeansPlusPlusInitialization());
+}
+
+BOOST_AUTO_TEST_CASE(KMeansParallelInitializationTest)
+{
+  CheckSeedingPolicy(KMeansParallelInitialization());
+
+  // With too few rounds to find enough candidates, we still get the right
+  // number of centroids.
+  arma::mat dataset = arma::randu<arma::mat>(4, 200);
+  arma::mat centroids;
+  KMeansParallelInitialization(0.01, 0).Cluster(dataset, 10, centroids);
+  BOOST_REQUIRE_EQUAL(centroids.n_rows, 4);
+  BOOST_REQUIRE_EQUAL(centroids.n_cols, 10);
+
+  // Clustering with k-means|| seeds works.
+  KMeans<EuclideanDistance, KMeansParallelInitialization> kmeans;
+  arma::Row<size_t> assignments;
+  kmeans.Cluster((arma::mat) trans(kMeansData), 3, assignments);
+  for (size_t i = 1; i < 13; ++i)
+    BOOST_REQUIRE_EQUAL(assignments[i], assignments[0]);
+  for (size_t i = 14; i < 20; ++i)
+    BOOST_REQUIRE_EQUAL(assignments[i], assignments[13]);
+  for (size_t i = 21; i < 30; ++i)
+    BOOST_REQUIRE_EQUAL(assignments[i], assignments[20]);
+}
+
+/**
+ * Generate three well-separated Gaussian clusters of 1000 points each, and
+ * store their true centers.
+ */
+void GetMiniBatchData(arma::mat& dataset, arma::mat& centers)
+{
+  centers = arma::mat("0.0 10.0 -10.0;"
+                      "0.0 10.0   5.0;"
+                      "0.0 10.0   0.0");
+
+  dataset.set_size(3, 3000);
+  for (size_t c = 0; c < 3; ++c)
+  {
+    dataset.cols(1000 * c, 1000 * (c + 1) - 1) =
+        0.5 * arma::randn<arma::mat>(3, 1000) +
+        arma::repmat(centers.col(c), 1, 1000);
+  }
+
+  // Shuffle the points, so that the chunks of a reader mix all clusters.
+  dataset = dataset.cols(arma::shuffle(arma::linspace<arma::uvec>(0, 2999,
+      3000)));
+}
+
+/**
+ * Make sure that mini-batch k-means, used as the step of KMeans, finds the
+ * centers of well-separated clusters when started near them.
+ */
+BOOST_AUTO_TEST_CASE(MiniBatchKMeansTest)
+{
+  arma::mat dataset, centers;
+  GetMiniBatchData(dataset, centers);
+
+  KMeans<EuclideanDistance, SampleInitialization, MaxVarianceNewCluster,
+      MiniBatchKMeans> kmeans(100);
+
+  arma::mat centroids = centers + arma::ones<arma::mat>(3, 3);
+  kmeans.Cluster(dataset, 3, centroids, true);
+
+  BOOST_REQUIRE_EQUAL(centroids.n_rows, 3);
+  BOOST_REQUIRE_EQUAL(centroids.n_cols, 3);
+  for (size_t c = 0; c < 3; ++c)
+  {
+    BOOST_REQUIRE_SMALL(EuclideanDistance::Evaluate(centroids.col(c),
+        centers.col(c)), 0.1);
+  }
+}
+
+/**
+ * Make sure that the chunked text reader gives back the whole file, in order,
+ * and can read it again after Reset().
+ */
+BOOST_AUTO_TEST_CASE(ChunkedTextReaderTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(4, 103);
+  data::Save("chunked_text_reader_test.csv", dataset, true);
+
+  ChunkedTextReader reader("chunked_text_reader_test.csv", 10);
+
+  for (size_t trial = 0; trial < 2; ++trial)
+  {
+    reader.Reset();
+
+    arma::mat batch;
+    size_t numPoints = 0;
+    while (reader.NextBatch(batch))
+    {
+      BOOST_REQUIRE_EQUAL(batch.n_rows, 4);
+      BOOST_REQUIRE_LE(batch.n_cols, 10);
+      for (size_t i = 0; i < batch.n_elem; ++i)
+      {
+        BOOST_REQUIRE_SMALL(batch[i] - dataset(i % 4, numPoints + i / 4),
+            1e-6);
+      }
+      numPoints += batch.n_cols;
+    }
+
+    BOOST_REQUIRE_EQUAL(numPoints, dataset.n_cols);
+    BOOST_REQUIRE_EQUAL(reader.Dimensionality(), 4);
+  }
+
+  remove("chunked_text_reader_test.csv");
+
+  // A file that does not exist can't be read.
+  BOOST_REQUIRE_THROW(ChunkedTextReader("nonexistent_file.csv"),
+      std::runtime_error);
+}
+
+/**
+ * Make sure that streaming k-means finds the centers of well-separated clusters
+ * when reading the data from a file in chunks.
+ */
+BOOST_AUTO_TEST_CASE(StreamingKMeansTest)
+{
+  arma::mat dataset, centers;
+  GetMiniBatchData(dataset, centers);
+  data::Save("streaming_kmeans_test.csv", dataset, true);
+
+  ChunkedTextReader reader("streaming_kmeans_test.csv", 100);
+  StreamingKMeans<> kmeans(5);
+
+  arma::mat centroids = centers + arma::ones<arma::mat>(3, 3);
+  kmeans.Cluster(reader, 3, centroids, true);
+
+  for (size_t c = 0; c < 3; ++c)
+  {
+    BOOST_REQUIRE_SMALL(EuclideanDistance::Evaluate(centroids.col(c),
+        centers.col(c)), 0.1);
+  }
+
+  // Every point of every pass is given to some cluster.
+  BOOST_REQUIRE_EQUAL(arma::accu(kmeans.Counts()) % dataset.n_cols, 0);
+  BOOST_REQUIRE_GT(arma::accu(kmeans.Counts()), 0);
+
+  // Now let the centroids be sampled from the data.
+  kmeans.Cluster(reader, 3, centroids);
+  BOOST_REQUIRE_EQUAL(centroids.n_rows, 3);
+  BOOST_REQUIRE_EQUAL(centroids.n_cols, 3);
+  BOOST_REQUIRE(centroids.is_finite());
+
+  // There are not enough points for this many clusters.
+  BOOST_REQUIRE_THROW(kmeans.Cluster(reader, 5000, centroids),
+      std::invalid_argument);
+
+  remove("streaming_kmeans_test.csv");
+}
+
+/**
+ * Make sure that k-means on partitions of the dataset gives the centroids of
+ * k-means on the whole dataset, from the same initial centroids.
+ */
+BOOST_AUTO_TEST_CASE(DistributedKMeansTest)
+{
+  arma::mat dataset(5, 2000, arma::fill::randu);
+  arma::mat centroids(5, 8, arma::fill::randu);
+
+  arma::mat naiveCentroids(centroids);
+  KMeans<> km;
+  km.Cluster(dataset, 8, naiveCentroids, true);
+
+  // Uneven partitions.
+  LocalPartitionTransport<> transport(dataset.cols(0, 1499), 3);
+  transport.AddPartition(dataset.cols(1500, 1999));
+  BOOST_REQUIRE_EQUAL(transport.NumPartitions(), 4);
+  BOOST_REQUIRE_EQUAL(transport.NumPoints(), 2000);
+
+  DistributedKMeans<> distributed(std::move(transport));
+  arma::mat distributedCentroids(centroids);
+  distributed.Cluster(8, distributedCentroids, true);
+
+  BOOST_REQUIRE_GT(distributed.Iterations(), 1);
+  for (size_t i = 0; i < centroids.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(naiveCentroids[i], distributedCentroids[i], 1e-5);
+
+  // The assignments of each partition are those of the whole dataset.
+  std::vector<arma::Row<size_t>> assignments;
+  distributed.Transport().Assign(distributedCentroids, assignments);
+  BOOST_REQUIRE_EQUAL(assignments.size(), 4);
+  BOOST_REQUIRE_EQUAL(assignments[3].n_elem, 500);
+  for (size_t i = 0; i < 500; ++i)
+  {
+    const arma::mat differences = distributedCentroids.each_col() -
+        dataset.col(1500 + i);
+    const arma::uword nearest = arma::sum(arma::square(differences),
+        0).index_min();
+    BOOST_REQUIRE_EQUAL(assignments[3][i], nearest);
+  }
+}
+
+/**
+ * Make sure that the sample gives the initial centroids and handles the empty
+ * clusters.
+ */
+BOOST_AUTO_TEST_CASE(DistributedKMeansEmptyClusterTest)
+{
+  // Two well-separated groups of points.
+  arma::mat dataset(2, 1000, arma::fill::randu);
+  dataset.cols(500, 999) += 10.0;
+
+  LocalPartitionTransport<> transport(dataset, 5);
+  arma::mat sample;
+  transport.Sample(100, sample);
+  BOOST_REQUIRE_EQUAL(sample.n_rows, 2);
+  BOOST_REQUIRE_EQUAL(sample.n_cols, 100);
+
+  // The third centroid is far from every point, so its cluster is empty and
+  // gets the point of the cluster with the largest variance.
+  arma::mat centroids("0.5 10.5 100.0; 0.5 10.5 100.0");
+  DistributedKMeans<> distributed(std::move(transport), 1000, 200);
+  distributed.Cluster(3, centroids, true);
+  BOOST_REQUIRE_LT(arma::norm(centroids.col(2)), 20.0);
+
+  // With a sample size of 0, as many points as clusters are still drawn for
+  // the initial centroids.
+  distributed.SampleSize() = 0;
+  distributed.Cluster(2, centroids);
+  BOOST_REQUIRE_EQUAL(centroids.n_cols, 2);
+  BOOST_REQUIRE(centroids.is_finite());
+}
+
 BOOST_AUTO_TEST_SUITE_END();
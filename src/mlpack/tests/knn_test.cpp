@@ -12,10 +12,16 @@
 #include <mlpack/methods/neighbor_search/neighbor_search.hpp>
 #include <mlpack/methods/neighbor_search/unmap.hpp>
 #include <mlpack/methods/neighbor_search/ns_model.hpp>
+#include <mlpack/methods/neighbor_search/sharded_neighbor_search.hpp>
+#include <mlpack/methods/neighbor_search/reduced_precision_search.hpp>
+#include <mlpack/methods/neighbor_search/inverted_index_search.hpp>
+#include <mlpack/methods/neighbor_search/query_cache.hpp>
 #include <mlpack/core/tree/cover_tree.hpp>
 #include <mlpack/core/tree/example_tree.hpp>
+#include <mlpack/core/metrics/mahalanobis_search.hpp>
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
+#include "serialization.hpp"
 
 using namespace mlpack;
 using namespace mlpack::neighbor;
@@ -1773,4 +1779,1363 @@ BOOST_AUTO_TEST_CASE(GreedyTreeSearch)
       0);
 }
 
+/**
+ * Make sure that tree search with the given tree type and search mode gives the
+ * same results as naive search, both in the monochromatic and the bichromatic
+ * case.  When OpenMP is available, the traversal is split across threads.
+ */
+template<template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void ParallelTreeSearchTest(const NeighborSearchMode mode)
+{
+  arma::mat referenceSet = arma::randu<arma::mat>(3, 1000);
+  arma::mat querySet = arma::randu<arma::mat>(3, 700);
+
+  #ifdef HAS_OPENMP
+  const int oldThreads = omp_get_max_threads();
+  omp_set_num_threads(4);
+  #endif
+
+  KNN naive(referenceSet, NAIVE_MODE);
+  NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::mat, TreeType>
+      treeSearch(referenceSet, mode);
+
+  arma::Mat<size_t> naiveNeighbors, treeNeighbors;
+  arma::mat naiveDistances, treeDistances;
+
+  naive.Search(querySet, 10, naiveNeighbors, naiveDistances);
+  treeSearch.Search(querySet, 10, treeNeighbors, treeDistances);
+
+  CheckMatrices(treeNeighbors, naiveNeighbors);
+  CheckMatrices(treeDistances, naiveDistances);
+
+  // Run the monochromatic search twice so that the tree statistics have to be
+  // reset.
+  naive.Search(10, naiveNeighbors, naiveDistances);
+  for (size_t trial = 0; trial < 2; ++trial)
+  {
+    treeSearch.Search(10, treeNeighbors, treeDistances);
+
+    CheckMatrices(treeNeighbors, naiveNeighbors);
+    CheckMatrices(treeDistances, naiveDistances);
+  }
+
+  #ifdef HAS_OPENMP
+  omp_set_num_threads(oldThreads);
+  #endif
+}
+
+/**
+ * Test parallel dual-tree search with kd-trees.
+ */
+BOOST_AUTO_TEST_CASE(ParallelDualTreeKDTreeTest)
+{
+  ParallelTreeSearchTest<KDTree>(DUAL_TREE_MODE);
+}
+
+/**
+ * Test parallel dual-tree search with ball trees.
+ */
+BOOST_AUTO_TEST_CASE(ParallelDualTreeBallTreeTest)
+{
+  ParallelTreeSearchTest<BallTree>(DUAL_TREE_MODE);
+}
+
+/**
+ * Test parallel dual-tree search with cover trees.
+ */
+BOOST_AUTO_TEST_CASE(ParallelDualTreeCoverTreeTest)
+{
+  ParallelTreeSearchTest<StandardCoverTree>(DUAL_TREE_MODE);
+}
+
+/**
+ * Test parallel dual-tree search with R trees.
+ */
+BOOST_AUTO_TEST_CASE(ParallelDualTreeRTreeTest)
+{
+  ParallelTreeSearchTest<RTree>(DUAL_TREE_MODE);
+}
+
+/**
+ * Test parallel single-tree search with kd-trees.
+ */
+BOOST_AUTO_TEST_CASE(ParallelSingleTreeKDTreeTest)
+{
+  ParallelTreeSearchTest<KDTree>(SINGLE_TREE_MODE);
+}
+
+/**
+ * Test parallel single-tree search with ball trees.
+ */
+BOOST_AUTO_TEST_CASE(ParallelSingleTreeBallTreeTest)
+{
+  ParallelTreeSearchTest<BallTree>(SINGLE_TREE_MODE);
+}
+
+/**
+ * Test single-tree search with cover trees when multiple threads are
+ * available (cover trees are searched serially in single-tree mode).
+ */
+BOOST_AUTO_TEST_CASE(ParallelSingleTreeCoverTreeTest)
+{
+  ParallelTreeSearchTest<StandardCoverTree>(SINGLE_TREE_MODE);
+}
+
+/**
+ * Test parallel single-tree search with R trees.
+ */
+BOOST_AUTO_TEST_CASE(ParallelSingleTreeRTreeTest)
+{
+  ParallelTreeSearchTest<RTree>(SINGLE_TREE_MODE);
+}
+
+/**
+ * Make sure that searching with a compacted kd-tree gives the same results as
+ * searching with a regular kd-tree.
+ */
+BOOST_AUTO_TEST_CASE(CompactKDTreeSearchTest)
+{
+  arma::mat referenceSet = arma::randu<arma::mat>(3, 1000);
+  arma::mat querySet = arma::randu<arma::mat>(3, 300);
+
+  typedef KNN::Tree TreeType;
+
+  const NodeLayout layouts[] = { BREADTH_FIRST_LAYOUT, VAN_EMDE_BOAS_LAYOUT };
+  for (size_t l = 0; l < 2; ++l)
+  {
+    TreeType tree(referenceSet);
+    TreeType compactTree(tree);
+    compactTree.Compact(layouts[l]);
+
+    KNN knn(std::move(tree));
+    KNN compactKnn(std::move(compactTree));
+
+    const NeighborSearchMode modes[] = { SINGLE_TREE_MODE, DUAL_TREE_MODE };
+    for (size_t m = 0; m < 2; ++m)
+    {
+      knn.SearchMode() = modes[m];
+      compactKnn.SearchMode() = modes[m];
+
+      arma::Mat<size_t> neighbors, compactNeighbors;
+      arma::mat distances, compactDistances;
+
+      knn.Search(querySet, 10, neighbors, distances);
+      compactKnn.Search(querySet, 10, compactNeighbors, compactDistances);
+
+      CheckMatrices(neighbors, compactNeighbors);
+      CheckMatrices(distances, compactDistances);
+    }
+  }
+}
+
+/**
+ * Check that brute-force search gives the same results as naive search, for
+ * both bichromatic and monochromatic search.
+ */
+template<typename SortPolicy, typename MetricType>
+void BruteForceSearchTest(const size_t dimensionality)
+{
+  // These sizes are not multiples of the block sizes, so partial blocks are
+  // tested too.
+  arma::mat referenceSet = arma::randu<arma::mat>(dimensionality, 2500);
+  arma::mat querySet = arma::randu<arma::mat>(dimensionality, 300);
+
+  NeighborSearch<SortPolicy, MetricType> naive(referenceSet, NAIVE_MODE);
+  NeighborSearch<SortPolicy, MetricType> bruteForce(referenceSet,
+      BRUTE_FORCE_MODE);
+
+  arma::Mat<size_t> naiveNeighbors, bruteForceNeighbors;
+  arma::mat naiveDistances, bruteForceDistances;
+
+  naive.Search(querySet, 7, naiveNeighbors, naiveDistances);
+  bruteForce.Search(querySet, 7, bruteForceNeighbors, bruteForceDistances);
+
+  CheckMatrices(bruteForceNeighbors, naiveNeighbors);
+  CheckMatrices(bruteForceDistances, naiveDistances);
+
+  naive.Search(7, naiveNeighbors, naiveDistances);
+  bruteForce.Search(7, bruteForceNeighbors, bruteForceDistances);
+
+  CheckMatrices(bruteForceNeighbors, naiveNeighbors);
+  CheckMatrices(bruteForceDistances, naiveDistances);
+}
+
+/**
+ * Test brute-force nearest neighbor search with the Euclidean distance, which
+ * uses matrix multiplications.
+ */
+BOOST_AUTO_TEST_CASE(BruteForceEuclideanTest)
+{
+  BruteForceSearchTest<NearestNeighborSort, EuclideanDistance>(3);
+  BruteForceSearchTest<NearestNeighborSort, EuclideanDistance>(64);
+  BruteForceSearchTest<NearestNeighborSort, SquaredEuclideanDistance>(10);
+}
+
+/**
+ * Test brute-force furthest neighbor search, and search with a metric that is
+ * not the Euclidean distance.
+ */
+BOOST_AUTO_TEST_CASE(BruteForceOtherSearchTest)
+{
+  BruteForceSearchTest<FurthestNeighborSort, EuclideanDistance>(5);
+  BruteForceSearchTest<NearestNeighborSort, ManhattanDistance>(5);
+}
+
+/**
+ * Make sure that monochromatic brute-force search with as many neighbors as
+ * points fills in the missing neighbor like the other search modes do.
+ */
+BOOST_AUTO_TEST_CASE(BruteForceAllNeighborsTest)
+{
+  arma::mat referenceSet = arma::randu<arma::mat>(3, 50);
+
+  KNN naive(referenceSet, NAIVE_MODE);
+  KNN bruteForce(referenceSet, BRUTE_FORCE_MODE);
+  KNN withTree(referenceSet, DUAL_TREE_MODE);
+  withTree.SearchMode() = BRUTE_FORCE_MODE;
+
+  arma::Mat<size_t> naiveNeighbors, neighbors, treeNeighbors;
+  arma::mat naiveDistances, distances, treeDistances;
+
+  naive.Search(50, naiveNeighbors, naiveDistances);
+  bruteForce.Search(50, neighbors, distances);
+  withTree.Search(50, treeNeighbors, treeDistances);
+
+  CheckMatrices(neighbors, naiveNeighbors);
+  CheckMatrices(distances, naiveDistances);
+  CheckMatrices(treeNeighbors, naiveNeighbors);
+  CheckMatrices(treeDistances, naiveDistances);
+
+  for (size_t i = 0; i < neighbors.n_cols; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(neighbors(49, i), size_t(-1));
+    BOOST_REQUIRE_EQUAL(distances(49, i), DBL_MAX);
+  }
+}
+
+/**
+ * Make sure that brute-force search works when the reference set comes from a
+ * tree that rearranged it.
+ */
+BOOST_AUTO_TEST_CASE(BruteForceWithTreeTest)
+{
+  arma::mat referenceSet = arma::randu<arma::mat>(4, 1000);
+  arma::mat querySet = arma::randu<arma::mat>(4, 100);
+
+  KNN naive(referenceSet, NAIVE_MODE);
+  KNN knn(referenceSet, DUAL_TREE_MODE);
+  knn.SearchMode() = BRUTE_FORCE_MODE;
+
+  arma::Mat<size_t> naiveNeighbors, neighbors;
+  arma::mat naiveDistances, distances;
+
+  naive.Search(querySet, 5, naiveNeighbors, naiveDistances);
+  knn.Search(querySet, 5, neighbors, distances);
+
+  CheckMatrices(neighbors, naiveNeighbors);
+  CheckMatrices(distances, naiveDistances);
+}
+
+/**
+ * Insert points into and delete points from a NeighborSearch object, and make
+ * sure that the results match a search on the updated reference set.
+ */
+template<template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void InsertDeleteTest(const NeighborSearchMode mode)
+{
+  arma::mat referenceSet = arma::randu<arma::mat>(3, 500);
+  arma::mat newPoints = arma::randu<arma::mat>(3, 50);
+  arma::mat querySet = arma::randu<arma::mat>(3, 100);
+
+  NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::mat, TreeType>
+      knn(referenceSet, mode);
+
+  // Insert the points in a few batches, so that trees that are rebuilt once
+  // there are enough pending updates have both rebuilt and pending points.
+  for (size_t i = 0; i < newPoints.n_cols; i += 10)
+    knn.Insert(newPoints.cols(i, i + 9));
+  referenceSet.insert_cols(referenceSet.n_cols, newPoints);
+
+  // Delete some points, including the last one.  The last point takes the
+  // index of the deleted point.
+  const size_t toDelete[] = { 3, 549, 100, 0 };
+  for (size_t i = 0; i < 4; ++i)
+  {
+    knn.Delete(toDelete[i]);
+
+    const size_t last = referenceSet.n_cols - 1;
+    if (toDelete[i] != last)
+      referenceSet.col(toDelete[i]) = referenceSet.col(last);
+    referenceSet.shed_col(last);
+  }
+
+  KNN naive(referenceSet, NAIVE_MODE);
+
+  arma::Mat<size_t> neighbors, naiveNeighbors;
+  arma::mat distances, naiveDistances;
+
+  knn.Search(querySet, 5, neighbors, distances);
+  naive.Search(querySet, 5, naiveNeighbors, naiveDistances);
+
+  CheckMatrices(neighbors, naiveNeighbors);
+  CheckMatrices(distances, naiveDistances);
+
+  knn.Search(5, neighbors, distances);
+  naive.Search(5, naiveNeighbors, naiveDistances);
+
+  CheckMatrices(neighbors, naiveNeighbors);
+  CheckMatrices(distances, naiveDistances);
+
+  // Searching the reference set with itself applies any pending updates.
+  BOOST_REQUIRE_EQUAL(knn.ReferenceSet().n_cols, referenceSet.n_cols);
+
+  BOOST_REQUIRE_THROW(knn.Delete(referenceSet.n_cols), std::invalid_argument);
+  BOOST_REQUIRE_THROW(knn.Insert(arma::randu<arma::mat>(4, 2)),
+      std::invalid_argument);
+}
+
+/**
+ * Test insertion and deletion without a tree.
+ */
+BOOST_AUTO_TEST_CASE(InsertDeleteNaiveTest)
+{
+  InsertDeleteTest<KDTree>(NAIVE_MODE);
+}
+
+/**
+ * Test insertion and deletion with trees that can't be updated in place, and
+ * are rebuilt once there are enough pending updates.
+ */
+BOOST_AUTO_TEST_CASE(InsertDeleteKDTreeTest)
+{
+  InsertDeleteTest<KDTree>(DUAL_TREE_MODE);
+  InsertDeleteTest<BallTree>(SINGLE_TREE_MODE);
+  InsertDeleteTest<StandardCoverTree>(DUAL_TREE_MODE);
+}
+
+/**
+ * Make sure that a kd-tree is only rebuilt once the number of pending updates
+ * exceeds the threshold, and that searches give the right results with any
+ * sequence of pending insertions and deletions.
+ */
+BOOST_AUTO_TEST_CASE(PendingUpdatesKDTreeTest)
+{
+  arma::mat referenceSet = arma::randu<arma::mat>(3, 200);
+  arma::mat querySet = arma::randu<arma::mat>(3, 50);
+
+  KNN knn(referenceSet);
+  knn.RebuildThreshold() = 1.0;
+
+  arma::Mat<size_t> neighbors, naiveNeighbors;
+  arma::mat distances, naiveDistances;
+  for (size_t i = 0; i < 60; ++i)
+  {
+    if (i % 3 == 0)
+    {
+      const arma::mat points = arma::randu<arma::mat>(3, 1 + i % 2);
+      knn.Insert(points);
+      referenceSet.insert_cols(referenceSet.n_cols, points);
+    }
+    else
+    {
+      const size_t index = (size_t) math::RandInt((int) referenceSet.n_cols);
+      knn.Delete(index);
+
+      const size_t last = referenceSet.n_cols - 1;
+      if (index != last)
+        referenceSet.col(index) = referenceSet.col(last);
+      referenceSet.shed_col(last);
+    }
+
+    // The tree has not been rebuilt.
+    BOOST_REQUIRE_EQUAL(knn.ReferenceSet().n_cols, 200);
+
+    if (i % 10 == 9)
+    {
+      KNN naive(referenceSet, NAIVE_MODE);
+      knn.Search(querySet, 5, neighbors, distances);
+      naive.Search(querySet, 5, naiveNeighbors, naiveDistances);
+
+      CheckMatrices(neighbors, naiveNeighbors);
+      CheckMatrices(distances, naiveDistances);
+    }
+  }
+
+  knn.Rebuild();
+  BOOST_REQUIRE_EQUAL(knn.ReferenceSet().n_cols, referenceSet.n_cols);
+
+  KNN naive(referenceSet, NAIVE_MODE);
+  knn.Search(querySet, 5, neighbors, distances);
+  naive.Search(querySet, 5, naiveNeighbors, naiveDistances);
+
+  CheckMatrices(neighbors, naiveNeighbors);
+  CheckMatrices(distances, naiveDistances);
+
+  // Once the pending updates exceed the threshold, the tree is rebuilt.
+  knn.RebuildThreshold() = 0.05;
+  knn.Insert(arma::randu<arma::mat>(3, 20));
+  BOOST_REQUIRE_EQUAL(knn.ReferenceSet().n_cols, referenceSet.n_cols + 20);
+}
+
+/**
+ * Test insertion and deletion with R trees, which are updated in place.
+ */
+BOOST_AUTO_TEST_CASE(InsertDeleteRTreeTest)
+{
+  InsertDeleteTest<RTree>(DUAL_TREE_MODE);
+  InsertDeleteTest<RStarTree>(SINGLE_TREE_MODE);
+}
+
+/**
+ * Test insertion and deletion through NSModel.
+ */
+BOOST_AUTO_TEST_CASE(InsertDeleteKNNModelTest)
+{
+  typedef NSModel<NearestNeighborSort> KNNModel;
+
+  arma::mat referenceSet = arma::randu<arma::mat>(4, 300);
+  arma::mat newPoints = arma::randu<arma::mat>(4, 20);
+
+  // Without a tree, with a tree that is updated in place, and with a tree that
+  // is rebuilt once there are enough pending updates.
+  const KNNModel::TreeTypes treeTypes[] = { KNNModel::KD_TREE,
+      KNNModel::R_TREE, KNNModel::KD_TREE };
+  const NeighborSearchMode modes[] = { NAIVE_MODE, DUAL_TREE_MODE,
+      DUAL_TREE_MODE };
+  for (size_t t = 0; t < 3; ++t)
+  {
+    KNNModel model(treeTypes[t]);
+    model.BuildModel(arma::mat(referenceSet), 10, modes[t]);
+
+    model.Insert(arma::mat(newPoints));
+    model.Delete(5);
+
+    arma::mat updatedSet = referenceSet;
+    updatedSet.insert_cols(updatedSet.n_cols, newPoints);
+    updatedSet.col(5) = updatedSet.col(updatedSet.n_cols - 1);
+    updatedSet.shed_col(updatedSet.n_cols - 1);
+
+    KNN naive(updatedSet, NAIVE_MODE);
+
+    arma::Mat<size_t> neighbors, naiveNeighbors;
+    arma::mat distances, naiveDistances;
+
+    model.Search(4, neighbors, distances);
+    naive.Search(4, naiveNeighbors, naiveDistances);
+
+    CheckMatrices(neighbors, naiveNeighbors);
+    CheckMatrices(distances, naiveDistances);
+  }
+}
+
+/**
+ * Make sure that the results of a search that aren't mapped back to the
+ * original indices are the same as the mapped results once unmapped.
+ */
+BOOST_AUTO_TEST_CASE(LazyUnmapTest)
+{
+  arma::mat referenceSet = arma::randu<arma::mat>(3, 200);
+  arma::mat querySet = arma::randu<arma::mat>(3, 50);
+
+  const NeighborSearchMode modes[] = { DUAL_TREE_MODE, SINGLE_TREE_MODE,
+      BRUTE_FORCE_MODE };
+  for (size_t m = 0; m < 3; ++m)
+  {
+    KNN knn(referenceSet, modes[m]);
+    BOOST_REQUIRE(knn.UnmapResults());
+    BOOST_REQUIRE_EQUAL(knn.OldFromNewReferences().size(),
+        (modes[m] == BRUTE_FORCE_MODE) ? 0 : 200);
+
+    arma::Mat<size_t> neighbors, lazyNeighbors, unmappedNeighbors;
+    arma::mat distances, lazyDistances, unmappedDistances;
+    knn.Search(querySet, 5, neighbors, distances);
+
+    knn.UnmapResults() = false;
+    knn.Search(querySet, 5, lazyNeighbors, lazyDistances);
+    BOOST_REQUIRE_EQUAL(knn.OldFromNewQueries().size(),
+        (modes[m] == DUAL_TREE_MODE) ? 50 : 0);
+
+    // The neighbors are indices in the reference set of the tree.
+    Unmap(lazyNeighbors, lazyDistances, knn.OldFromNewReferences(),
+        knn.OldFromNewQueries(), unmappedNeighbors, unmappedDistances);
+    CheckMatrices(unmappedNeighbors, neighbors);
+    CheckMatrices(unmappedDistances, distances);
+    for (size_t i = 0; i < lazyNeighbors.n_cols; ++i)
+    {
+      const size_t query = knn.OldFromNewQueries().empty() ? i :
+          knn.OldFromNewQueries()[i];
+      BOOST_REQUIRE_CLOSE(lazyDistances(0, i), EuclideanDistance::Evaluate(
+          querySet.col(query), knn.ReferenceSet().col(lazyNeighbors(0, i))),
+          1e-5);
+    }
+
+    // Search the reference set itself.
+    knn.UnmapResults() = true;
+    knn.Search(5, neighbors, distances);
+    knn.UnmapResults() = false;
+    knn.Search(5, lazyNeighbors, lazyDistances);
+    Unmap(lazyNeighbors, lazyDistances, knn.OldFromNewReferences(),
+        knn.OldFromNewQueries(), unmappedNeighbors, unmappedDistances);
+    CheckMatrices(unmappedNeighbors, neighbors);
+    CheckMatrices(unmappedDistances, distances);
+  }
+}
+
+/**
+ * Make sure that a tree can be built over a buffer owned by the caller, which
+ * is permuted in place.
+ */
+BOOST_AUTO_TEST_CASE(InPlaceReferenceBufferTest)
+{
+  arma::mat referenceSet = arma::randu<arma::mat>(3, 200);
+  arma::mat buffer(referenceSet);
+
+  KNN knn(arma::mat(buffer.memptr(), buffer.n_rows, buffer.n_cols, false,
+      false));
+  BOOST_REQUIRE_EQUAL(knn.ReferenceSet().memptr(), buffer.memptr());
+  for (size_t i = 0; i < buffer.n_cols; ++i)
+  {
+    CheckMatrices(arma::mat(buffer.col(i)),
+        arma::mat(referenceSet.col(knn.OldFromNewReferences()[i])));
+  }
+
+  // The results are the same as with a copy.
+  KNN copy(referenceSet);
+  arma::Mat<size_t> neighbors, copyNeighbors;
+  arma::mat distances, copyDistances;
+  knn.Search(4, neighbors, distances);
+  copy.Search(4, copyNeighbors, copyDistances);
+  CheckMatrices(neighbors, copyNeighbors);
+  CheckMatrices(distances, copyDistances);
+}
+
+/**
+ * Make sure that the query cache evicts the least recently used results and
+ * quantizes the query points.
+ */
+BOOST_AUTO_TEST_CASE(QueryCacheTest)
+{
+  // A single shard, so that the eviction order is predictable.
+  QueryCache cache(2, 0.0, 1);
+  BOOST_REQUIRE(cache.Enabled());
+  BOOST_REQUIRE_EQUAL(cache.Shards(), 1);
+
+  const arma::vec a("1.0 2.0"), b("3.0 4.0"), c("5.0 6.0");
+  const arma::Col<size_t> neighbors("1 2");
+  const arma::vec distances("0.5 0.7");
+  arma::Col<size_t> foundNeighbors;
+  arma::vec foundDistances;
+
+  BOOST_REQUIRE(cache.Key(a, (size_t) 2) != cache.Key(a, (size_t) 3));
+  BOOST_REQUIRE(!cache.Lookup(cache.Key(a, (size_t) 2), foundNeighbors,
+      foundDistances));
+  cache.Store(cache.Key(a, (size_t) 2), neighbors, distances);
+  cache.Store(cache.Key(b, (size_t) 2), neighbors, distances);
+  BOOST_REQUIRE(cache.Lookup(cache.Key(a, (size_t) 2), foundNeighbors,
+      foundDistances));
+  CheckMatrices(foundNeighbors, neighbors);
+  CheckMatrices(foundDistances, distances);
+
+  // b is now the least recently used.
+  cache.Store(cache.Key(c, (size_t) 2), neighbors, distances);
+  BOOST_REQUIRE_EQUAL(cache.Size(), 2);
+  BOOST_REQUIRE(!cache.Lookup(cache.Key(b, (size_t) 2), foundNeighbors,
+      foundDistances));
+  BOOST_REQUIRE(cache.Lookup(cache.Key(a, (size_t) 2), foundNeighbors,
+      foundDistances));
+  BOOST_REQUIRE(cache.Lookup(cache.Key(c, (size_t) 2), foundNeighbors,
+      foundDistances));
+  BOOST_REQUIRE_EQUAL(cache.Hits(), 3);
+  BOOST_REQUIRE_EQUAL(cache.Misses(), 2);
+
+  // Copies keep the settings only.
+  QueryCache copy(cache);
+  BOOST_REQUIRE_EQUAL(copy.Capacity(), 2);
+  BOOST_REQUIRE_EQUAL(copy.Size(), 0);
+
+  cache.Clear();
+  BOOST_REQUIRE_EQUAL(cache.Size(), 0);
+
+  QueryCache quantized(10, 0.1);
+  BOOST_REQUIRE(quantized.Key(arma::vec("1.01 2.02")) ==
+      quantized.Key(arma::vec("1.02 2.01")));
+  BOOST_REQUIRE(quantized.Key(arma::vec("1.01 2.02")) !=
+      quantized.Key(arma::vec("1.11 2.02")));
+
+  BOOST_REQUIRE(!QueryCache().Enabled());
+  BOOST_REQUIRE_THROW(QueryCache(10, -1.0), std::invalid_argument);
+}
+
+/**
+ * Make sure that an NSModel with a cache gives the same results as without,
+ * and that the cache is cleared when the model is updated.
+ */
+BOOST_AUTO_TEST_CASE(KNNModelCacheTest)
+{
+  typedef NSModel<NearestNeighborSort> KNNModel;
+
+  arma::mat referenceSet = arma::randu<arma::mat>(4, 300);
+  arma::mat querySet = arma::randu<arma::mat>(4, 50);
+
+  KNNModel model(KNNModel::R_TREE);
+  model.BuildModel(arma::mat(referenceSet), 10, DUAL_TREE_MODE);
+  model.Cache() = QueryCache(100);
+
+  arma::Mat<size_t> neighbors, cachedNeighbors, trueNeighbors;
+  arma::mat distances, cachedDistances, trueDistances;
+  KNN naive(referenceSet, NAIVE_MODE);
+  naive.Search(querySet, 5, trueNeighbors, trueDistances);
+
+  model.Search(arma::mat(querySet), 5, neighbors, distances);
+  BOOST_REQUIRE_EQUAL(model.Cache().Size(), 50);
+  BOOST_REQUIRE_EQUAL(model.Cache().Misses(), 50);
+  CheckMatrices(neighbors, trueNeighbors);
+  CheckMatrices(distances, trueDistances);
+
+  // Half of the query points are in the cache.
+  arma::mat mixedSet = arma::join_rows(querySet.cols(0, 24),
+      arma::randu<arma::mat>(4, 25));
+  model.Search(arma::mat(mixedSet), 5, cachedNeighbors, cachedDistances);
+  BOOST_REQUIRE_EQUAL(model.Cache().Hits(), 25);
+  naive.Search(mixedSet, 5, trueNeighbors, trueDistances);
+  CheckMatrices(cachedNeighbors, trueNeighbors);
+  CheckMatrices(cachedDistances, trueDistances);
+
+  // A different k isn't found in the cache.
+  model.Search(arma::mat(querySet), 3, cachedNeighbors, cachedDistances);
+  BOOST_REQUIRE_EQUAL(model.Cache().Hits(), 25);
+  CheckMatrices(cachedNeighbors, arma::Mat<size_t>(neighbors.rows(0, 2)));
+
+  // The results change after an update.
+  model.Insert(arma::mat(querySet));
+  BOOST_REQUIRE_EQUAL(model.Cache().Size(), 0);
+  model.Search(arma::mat(querySet), 1, cachedNeighbors, cachedDistances);
+  for (size_t i = 0; i < querySet.n_cols; ++i)
+    BOOST_REQUIRE_SMALL(cachedDistances(0, i), 1e-10);
+}
+
+
+/**
+ * Make sure that an NSModel built on single-precision data gives the same
+ * results as naive search on that data, for a few tree types, both before and
+ * after serialization.
+ */
+BOOST_AUTO_TEST_CASE(FloatKNNModelTest)
+{
+  typedef NSModel<NearestNeighborSort, arma::fmat> FloatKNNModel;
+
+  arma::fmat referenceData = arma::randu<arma::fmat>(4, 300);
+  arma::fmat queryData = arma::randu<arma::fmat>(4, 50);
+
+  // Naive search on the float data computes exactly the same distances.
+  FloatKNNModel naive;
+  naive.BuildModel(arma::fmat(referenceData), 20, NAIVE_MODE);
+
+  arma::Mat<size_t> naiveNeighbors, naiveMonoNeighbors;
+  arma::mat naiveDistances, naiveMonoDistances;
+  naive.Search(arma::fmat(queryData), 5, naiveNeighbors, naiveDistances);
+  naive.Search(5, naiveMonoNeighbors, naiveMonoDistances);
+
+  // The distances should also be close to the double-precision ones.
+  KNN doubleNaive(arma::conv_to<arma::mat>::from(referenceData), NAIVE_MODE);
+  arma::Mat<size_t> doubleNeighbors;
+  arma::mat doubleDistances;
+  doubleNaive.Search(arma::conv_to<arma::mat>::from(queryData), 5,
+      doubleNeighbors, doubleDistances);
+  CheckMatrices(naiveDistances, doubleDistances, 1e-3);
+
+  const FloatKNNModel::TreeTypes treeTypes[] = { FloatKNNModel::KD_TREE,
+      FloatKNNModel::COVER_TREE, FloatKNNModel::BALL_TREE,
+      FloatKNNModel::R_TREE, FloatKNNModel::OCTREE };
+
+  for (size_t t = 0; t < 5; ++t)
+  {
+    FloatKNNModel model(treeTypes[t]);
+    model.BuildModel(arma::fmat(referenceData), 20, DUAL_TREE_MODE);
+
+    FloatKNNModel xmlModel, textModel, binaryModel;
+    SerializeObjectAll(model, xmlModel, textModel, binaryModel);
+
+    FloatKNNModel* models[] = { &model, &xmlModel, &textModel, &binaryModel };
+    for (size_t m = 0; m < 4; ++m)
+    {
+      BOOST_REQUIRE_EQUAL(models[m]->Dataset().n_cols, 300);
+
+      arma::Mat<size_t> neighbors;
+      arma::mat distances;
+      models[m]->Search(arma::fmat(queryData), 5, neighbors, distances);
+
+      CheckMatrices(neighbors, naiveNeighbors);
+      CheckMatrices(distances, naiveDistances);
+
+      models[m]->Search(5, neighbors, distances);
+
+      CheckMatrices(neighbors, naiveMonoNeighbors);
+      CheckMatrices(distances, naiveMonoDistances);
+    }
+  }
+}
+
+/**
+ * Make sure that an NSModel saved with SaveFlat() and loaded with LoadFlat()
+ * gives the same results as the original model, for KD trees and ball trees.
+ */
+BOOST_AUTO_TEST_CASE(KNNModelFlatFileTest)
+{
+  typedef NSModel<NearestNeighborSort> KNNModel;
+
+  arma::mat referenceData = arma::randu<arma::mat>(4, 300);
+  arma::mat queryData = arma::randu<arma::mat>(4, 50);
+
+  const KNNModel::TreeTypes treeTypes[] = { KNNModel::KD_TREE,
+      KNNModel::BALL_TREE };
+  const NeighborSearchMode modes[] = { DUAL_TREE_MODE, SINGLE_TREE_MODE };
+
+  for (size_t t = 0; t < 2; ++t)
+  {
+    KNNModel model(treeTypes[t]);
+    model.BuildModel(arma::mat(referenceData), 15, modes[t], 0.1);
+    model.MaxBaseCases() = 1000;
+    model.SaveFlat("knn_model.flat");
+
+    // Load into a model of another tree type, which must be replaced.
+    KNNModel loaded(KNNModel::COVER_TREE);
+    loaded.LoadFlat("knn_model.flat");
+
+    BOOST_REQUIRE_EQUAL(loaded.TreeType(), treeTypes[t]);
+    BOOST_REQUIRE_EQUAL(loaded.LeafSize(), 15);
+    BOOST_REQUIRE_EQUAL(loaded.SearchMode(), modes[t]);
+    BOOST_REQUIRE_CLOSE(loaded.Epsilon(), 0.1, 1e-5);
+    BOOST_REQUIRE_EQUAL(loaded.MaxBaseCases(), 1000);
+    CheckMatrices(model.Dataset(), loaded.Dataset());
+
+    arma::Mat<size_t> neighbors, loadedNeighbors;
+    arma::mat distances, loadedDistances;
+    model.Search(arma::mat(queryData), 5, neighbors, distances);
+    loaded.Search(arma::mat(queryData), 5, loadedNeighbors, loadedDistances);
+    CheckMatrices(neighbors, loadedNeighbors);
+    CheckMatrices(distances, loadedDistances);
+
+    model.Search(5, neighbors, distances);
+    loaded.Search(5, loadedNeighbors, loadedDistances);
+    CheckMatrices(neighbors, loadedNeighbors);
+    CheckMatrices(distances, loadedDistances);
+  }
+
+  remove("knn_model.flat");
+}
+
+/**
+ * Make sure that models that can't be saved in the flat format are rejected,
+ * and that a failed LoadFlat() leaves the model unchanged.
+ */
+BOOST_AUTO_TEST_CASE(KNNModelFlatFileInvalidTest)
+{
+  typedef NSModel<NearestNeighborSort> KNNModel;
+
+  arma::mat referenceData = arma::randu<arma::mat>(3, 100);
+
+  KNNModel coverModel(KNNModel::COVER_TREE);
+  coverModel.BuildModel(arma::mat(referenceData), 20, DUAL_TREE_MODE);
+  BOOST_REQUIRE_THROW(coverModel.SaveFlat("knn_model.flat"),
+      std::invalid_argument);
+
+  KNNModel randomBasisModel(KNNModel::KD_TREE, true);
+  randomBasisModel.BuildModel(arma::mat(referenceData), 20, DUAL_TREE_MODE);
+  BOOST_REQUIRE_THROW(randomBasisModel.SaveFlat("knn_model.flat"),
+      std::invalid_argument);
+
+  KNNModel naiveModel(KNNModel::KD_TREE);
+  naiveModel.BuildModel(arma::mat(referenceData), 20, NAIVE_MODE);
+  BOOST_REQUIRE_THROW(naiveModel.SaveFlat("knn_model.flat"),
+      std::invalid_argument);
+
+  // A flat tree file without the parameters of a model is not a model file.
+  typedef NSType<NearestNeighborSort, tree::KDTree> KDTreeKNN;
+  std::vector<size_t> oldFromNew;
+  KDTreeKNN::Tree tree(referenceData, oldFromNew, 20);
+  tree.SaveFlat("knn_model.flat", oldFromNew);
+
+  KNNModel model(KNNModel::BALL_TREE);
+  model.BuildModel(arma::mat(referenceData), 10, SINGLE_TREE_MODE);
+  BOOST_REQUIRE_THROW(model.LoadFlat("knn_model.flat"), std::runtime_error);
+  BOOST_REQUIRE_THROW(model.LoadFlat("nonexistent_model.flat"),
+      std::runtime_error);
+
+  BOOST_REQUIRE_EQUAL(model.TreeType(), KNNModel::BALL_TREE);
+  BOOST_REQUIRE_EQUAL(model.LeafSize(), 10);
+  BOOST_REQUIRE_EQUAL(model.SearchMode(), SINGLE_TREE_MODE);
+  BOOST_REQUIRE_EQUAL(model.Dataset().n_cols, 100);
+
+  remove("knn_model.flat");
+}
+
+/**
+ * Make sure that a tree built with another statistic can be converted to the
+ * tree type of KNN, by copying it or by taking it over, and that searching with
+ * it gives the right results.
+ */
+BOOST_AUTO_TEST_CASE(ConvertedTreeTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(5, 200);
+  KNN baseline(dataset);
+
+  arma::Mat<size_t> baselineNeighbors;
+  arma::mat baselineDistances;
+  baseline.Search(5, baselineNeighbors, baselineDistances);
+
+  typedef KDTree<EuclideanDistance, EmptyStatistic, arma::mat> OtherTreeType;
+  std::vector<size_t> oldFromNew;
+  OtherTreeType otherTree(dataset, oldFromNew);
+
+  for (size_t trial = 0; trial < 2; ++trial)
+  {
+    KNN knn((trial == 0) ? KNN::Tree(otherTree) :
+        KNN::Tree(std::move(otherTree)));
+
+    arma::Mat<size_t> neighbors;
+    arma::mat distances;
+    knn.Search(5, neighbors, distances);
+
+    // The converted tree keeps the order of the other tree, so its mapping is
+    // used to unmap the results.
+    for (size_t i = 0; i < oldFromNew.size(); ++i)
+    {
+      for (size_t j = 0; j < distances.n_rows; ++j)
+      {
+        BOOST_REQUIRE_EQUAL(oldFromNew[neighbors(j, i)],
+            baselineNeighbors(j, oldFromNew[i]));
+        BOOST_REQUIRE_CLOSE(distances(j, i),
+            baselineDistances(j, oldFromNew[i]), 1e-5);
+      }
+    }
+  }
+
+  // The tree that was taken over is empty.
+  BOOST_REQUIRE_EQUAL(otherTree.NumChildren(), 0);
+  BOOST_REQUIRE_EQUAL(otherTree.NumDescendants(), 0);
+}
+
+/**
+ * Make sure that the best-first traversers give the same results as the default
+ * traversers, in both dual-tree and single-tree mode.
+ */
+BOOST_AUTO_TEST_CASE(BestFirstTraversalTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(4, 500);
+  arma::mat querySet = arma::randu<arma::mat>(4, 150);
+
+  KNN naive(dataset, NAIVE_MODE);
+  arma::Mat<size_t> naiveNeighbors;
+  arma::mat naiveDistances;
+  naive.Search(querySet, 5, naiveNeighbors, naiveDistances);
+
+  typedef KDTree<EuclideanDistance, NeighborSearchStat<NearestNeighborSort>,
+      arma::mat> TreeType;
+  NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::mat, KDTree,
+      TreeType::template BestFirstDualTreeTraverser,
+      TreeType::template BestFirstSingleTreeTraverser> knn(dataset);
+
+  for (size_t mode = 0; mode < 2; ++mode)
+  {
+    knn.SearchMode() = (mode == 0) ? DUAL_TREE_MODE : SINGLE_TREE_MODE;
+
+    arma::Mat<size_t> neighbors;
+    arma::mat distances;
+    knn.Search(querySet, 5, neighbors, distances);
+
+    for (size_t i = 0; i < neighbors.n_elem; ++i)
+    {
+      BOOST_REQUIRE_EQUAL(neighbors[i], naiveNeighbors[i]);
+      BOOST_REQUIRE_CLOSE(distances[i], naiveDistances[i], 1e-5);
+    }
+  }
+}
+
+/**
+ * Make sure that a limit on the number of base cases for each query point
+ * bounds the work of single-tree and dual-tree search, and still returns valid
+ * neighbors; also make sure that a large enough limit gives exact results.
+ */
+BOOST_AUTO_TEST_CASE(MaxBaseCasesTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 2000);
+  arma::mat querySet = arma::randu<arma::mat>(3, 300);
+  const size_t k = 5;
+  const size_t maxBaseCases = 50;
+
+  KNN naive(dataset, NAIVE_MODE);
+  arma::Mat<size_t> naiveNeighbors;
+  arma::mat naiveDistances;
+  naive.Search(querySet, k, naiveNeighbors, naiveDistances);
+
+  KNN knn(dataset);
+  for (size_t mode = 0; mode < 2; ++mode)
+  {
+    knn.SearchMode() = (mode == 0) ? SINGLE_TREE_MODE : DUAL_TREE_MODE;
+
+    // A limit larger than the reference set changes nothing.
+    knn.MaxBaseCases() = dataset.n_cols + 1;
+    arma::Mat<size_t> neighbors;
+    arma::mat distances;
+    knn.Search(querySet, k, neighbors, distances);
+    for (size_t i = 0; i < neighbors.n_elem; ++i)
+    {
+      BOOST_REQUIRE_EQUAL(neighbors[i], naiveNeighbors[i]);
+      BOOST_REQUIRE_CLOSE(distances[i], naiveDistances[i], 1e-5);
+    }
+
+    // With a small limit, each query point may go over by at most a leaf.
+    knn.MaxBaseCases() = maxBaseCases;
+    knn.Search(querySet, k, neighbors, distances);
+    BOOST_REQUIRE_LE(knn.BaseCases(), querySet.n_cols * (maxBaseCases + 20));
+
+    for (size_t i = 0; i < querySet.n_cols; ++i)
+    {
+      for (size_t j = 0; j < k; ++j)
+      {
+        BOOST_REQUIRE_LT(neighbors(j, i), dataset.n_cols);
+        BOOST_REQUIRE_CLOSE(distances(j, i), arma::norm(querySet.col(i) -
+            dataset.col(neighbors(j, i))), 1e-5);
+        BOOST_REQUIRE_GE(distances(j, i), naiveDistances(j, i) - 1e-10);
+        if (j > 0)
+          BOOST_REQUIRE_GE(distances(j, i), distances(j - 1, i));
+      }
+    }
+  }
+
+  // The limit can't be smaller than k.
+  knn.MaxBaseCases() = k - 1;
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  BOOST_REQUIRE_THROW(knn.Search(querySet, k, neighbors, distances),
+      std::invalid_argument);
+}
+
+/**
+ * Make sure that searching the transformed data with MahalanobisSearch gives
+ * the same results as searching with the Mahalanobis distance.
+ */
+BOOST_AUTO_TEST_CASE(MahalanobisSearchKNNTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(4, 300);
+  arma::mat querySet = arma::randu<arma::mat>(4, 80);
+  arma::mat a = arma::randn<arma::mat>(4, 4);
+  MahalanobisDistance<true> metric(a.t() * a + 0.1 * arma::eye<arma::mat>(4,
+      4));
+
+  NeighborSearch<NearestNeighborSort, MahalanobisDistance<true>, arma::mat,
+      BallTree> naive(dataset, NAIVE_MODE, 0.0, metric);
+  arma::Mat<size_t> naiveNeighbors;
+  arma::mat naiveDistances;
+  naive.Search(querySet, 5, naiveNeighbors, naiveDistances);
+
+  MahalanobisSearch<KNN> knn(dataset, metric);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  knn.Search(querySet, 5, neighbors, distances);
+
+  for (size_t i = 0; i < neighbors.n_elem; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(neighbors[i], naiveNeighbors[i]);
+    BOOST_REQUIRE_CLOSE(distances[i], naiveDistances[i], 1e-5);
+  }
+}
+
+/**
+ * The traversal statistics of tree-based search should be consistent with the
+ * counts of the rules, and should be empty for naive search.
+ */
+BOOST_AUTO_TEST_CASE(TraversalStatisticsTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 2000);
+  arma::mat querySet = arma::randu<arma::mat>(3, 300);
+
+  KNN knn(dataset);
+  for (size_t mode = 0; mode < 2; ++mode)
+  {
+    knn.SearchMode() = (mode == 0) ? SINGLE_TREE_MODE : DUAL_TREE_MODE;
+
+    arma::Mat<size_t> neighbors;
+    arma::mat distances;
+    knn.Search(querySet, 5, neighbors, distances);
+
+    const tree::TraversalStatistics& statistics = knn.Statistics();
+    BOOST_REQUIRE_GE(statistics.baseCases, knn.BaseCases());
+    BOOST_REQUIRE_GT(statistics.baseCases, 0);
+    BOOST_REQUIRE_GT(statistics.scores, 0);
+    BOOST_REQUIRE_GT(statistics.prunes, 0);
+    BOOST_REQUIRE_GT(statistics.leafVisits, 0);
+    BOOST_REQUIRE_LE(statistics.prunes, statistics.scores);
+
+    // Every prune is at some depth.
+    size_t prunes = 0;
+    for (size_t i = 0; i < statistics.prunesPerDepth.size(); ++i)
+      prunes += statistics.prunesPerDepth[i];
+    BOOST_REQUIRE_EQUAL(prunes, statistics.prunes);
+  }
+
+  // A naive search does not traverse the tree.
+  knn.SearchMode() = NAIVE_MODE;
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  knn.Search(querySet, 5, neighbors, distances);
+  BOOST_REQUIRE_EQUAL(knn.Statistics().baseCases, 0);
+  BOOST_REQUIRE_EQUAL(knn.Statistics().scores, 0);
+}
+
+/**
+ * Make sure that the sharded search gives the exact neighbors, with and
+ * without pruning, in batches or not, even when a shard has fewer than k
+ * points.
+ */
+BOOST_AUTO_TEST_CASE(ShardedNeighborSearchExactTest)
+{
+  arma::mat reference(4, 1000, arma::fill::randu);
+  arma::mat query(4, 150, arma::fill::randu);
+
+  KNN knn(reference);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  knn.Search(query, 10, trueNeighbors, trueDistances);
+
+  LocalShardTransport<> transport(reference.cols(0, 994), 4);
+  transport.AddShard(reference.cols(995, 999));
+  BOOST_REQUIRE_EQUAL(transport.NumShards(), 5);
+  BOOST_REQUIRE_EQUAL(transport.NumPoints(), 1000);
+
+  ShardedNeighborSearch<> sharded(std::move(transport));
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  sharded.Search(query, 10, neighbors, distances, 0, false);
+  BOOST_REQUIRE_EQUAL(sharded.ShardQueries(), 5 * 150);
+  CheckMatrices(neighbors, trueNeighbors);
+  CheckMatrices(distances, trueDistances);
+
+  sharded.Search(query, 10, neighbors, distances, 32);
+  CheckMatrices(neighbors, trueNeighbors);
+  CheckMatrices(distances, trueDistances);
+}
+
+/**
+ * Make sure that pruning with the bounds of the shards avoids searching the
+ * shards far from the queries.
+ */
+BOOST_AUTO_TEST_CASE(ShardedNeighborSearchPruneTest)
+{
+  // Sort the points along the first dimension, so that each shard is a slab.
+  arma::mat reference(3, 2000, arma::fill::randu);
+  reference = reference.cols(arma::sort_index(reference.row(0)));
+  arma::mat query(3, 100, arma::fill::randu);
+
+  KNN knn(reference);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  knn.Search(query, 5, trueNeighbors, trueDistances);
+
+  ShardedNeighborSearch<> sharded(LocalShardTransport<>(reference, 10));
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  sharded.Search(query, 5, neighbors, distances);
+
+  CheckMatrices(neighbors, trueNeighbors);
+  CheckMatrices(distances, trueDistances);
+  BOOST_REQUIRE_LT(sharded.ShardQueries(), 4 * 100);
+}
+
+/**
+ * Make sure that the 16-bit formats round-trip the numbers they can represent,
+ * round to the nearest representable number, and keep infinities and NaNs.
+ */
+BOOST_AUTO_TEST_CASE(HalfPrecisionEncodingTest)
+{
+  const float exact[] = { 0.0f, 1.0f, -2.5f, 0.125f, 96.0f, -1024.0f };
+  for (const float value : exact)
+  {
+    BOOST_REQUIRE_EQUAL(math::BFloat16::Decode(math::BFloat16::Encode(value)),
+        value);
+    BOOST_REQUIRE_EQUAL(math::Float16::Decode(math::Float16::Encode(value)),
+        value);
+  }
+
+  // Ties round to even: 1 + 2^-11 is halfway between 1 and 1 + 2^-10.
+  BOOST_REQUIRE_EQUAL(math::Float16::Decode(math::Float16::Encode(
+      1.0f + std::pow(2.0f, -11.0f))), 1.0f);
+  BOOST_REQUIRE_EQUAL(math::BFloat16::Decode(math::BFloat16::Encode(
+      1.0f + std::pow(2.0f, -8.0f))), 1.0f);
+
+  // The smallest half-precision subnormal, and overflows.
+  const float subnormal = std::pow(2.0f, -24.0f);
+  BOOST_REQUIRE_EQUAL(math::Float16::Decode(math::Float16::Encode(subnormal)),
+      subnormal);
+  BOOST_REQUIRE_EQUAL(math::Float16::Decode(math::Float16::Encode(1e5f)),
+      std::numeric_limits<float>::infinity());
+  BOOST_REQUIRE_EQUAL(math::Float16::Decode(math::Float16::Encode(-1e5f)),
+      -std::numeric_limits<float>::infinity());
+  BOOST_REQUIRE(std::isfinite(math::BFloat16::Decode(
+      math::BFloat16::Encode(1e30f))));
+
+  // Random numbers are within the precision of the format.
+  for (size_t i = 0; i < 1000; ++i)
+  {
+    const float value = (float) (100.0 * (math::Random() - 0.5));
+    BOOST_REQUIRE_CLOSE(math::BFloat16::Decode(math::BFloat16::Encode(value)),
+        value, 0.5);
+    BOOST_REQUIRE_CLOSE(math::Float16::Decode(math::Float16::Encode(value)),
+        value, 0.1);
+  }
+
+  const float nan = std::numeric_limits<float>::quiet_NaN();
+  BOOST_REQUIRE(std::isnan(math::BFloat16::Decode(
+      math::BFloat16::Encode(nan))));
+  BOOST_REQUIRE(std::isnan(math::Float16::Decode(math::Float16::Encode(nan))));
+}
+
+/**
+ * Make sure that the search over 16-bit reference points finds nearly all the
+ * true neighbors, and exactly the true neighbors after re-ranking enough
+ * candidates.
+ */
+template<typename EncodingType>
+void CheckReducedPrecisionSearch()
+{
+  arma::mat reference(5, 2000, arma::fill::randu);
+  arma::mat query(5, 200, arma::fill::randu);
+
+  KNN knn(reference);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  knn.Search(query, 5, trueNeighbors, trueDistances);
+
+  ReducedPrecisionSearch<EuclideanDistance, EncodingType> search(reference, 15);
+  BOOST_REQUIRE_EQUAL(search.Dimensionality(), 5);
+  BOOST_REQUIRE_EQUAL(search.NumPoints(), 2000);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  search.Search(query, 5, neighbors, distances);
+  BOOST_REQUIRE_EQUAL(neighbors.n_rows, 5);
+  BOOST_REQUIRE_EQUAL(neighbors.n_cols, 200);
+
+  size_t found = 0;
+  for (size_t q = 0; q < query.n_cols; ++q)
+  {
+    for (size_t i = 0; i < 5; ++i)
+    {
+      if (arma::any(trueNeighbors.col(q) == neighbors(i, q)))
+        ++found;
+      // The distances are close to the true distances.
+      BOOST_REQUIRE_SMALL(distances(i, q) - EuclideanDistance::Evaluate(
+          query.col(q), reference.col(neighbors(i, q))), 0.02);
+    }
+  }
+  BOOST_REQUIRE_GT(found, 0.9 * 5 * query.n_cols);
+
+  search.Search(query, reference, 5, 50, neighbors, distances);
+  CheckMatrices(neighbors, trueNeighbors);
+  CheckMatrices(distances, trueDistances);
+}
+
+BOOST_AUTO_TEST_CASE(ReducedPrecisionSearchTest)
+{
+  CheckReducedPrecisionSearch<math::BFloat16>();
+  CheckReducedPrecisionSearch<math::Float16>();
+}
+
+/**
+ * Make sure that invalid parameters of the search over 16-bit reference
+ * points throw, and that the model can be serialized.
+ */
+BOOST_AUTO_TEST_CASE(ReducedPrecisionSearchInvalidTest)
+{
+  arma::mat reference(3, 100, arma::fill::randu);
+  arma::mat query(3, 10, arma::fill::randu);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+
+  ReducedPrecisionSearch<> untrained;
+  BOOST_REQUIRE_THROW(untrained.Search(query, 1, neighbors, distances),
+      std::invalid_argument);
+
+  ReducedPrecisionSearch<> search(reference);
+  BOOST_REQUIRE_THROW(search.Search(query, 101, neighbors, distances),
+      std::invalid_argument);
+  BOOST_REQUIRE_THROW(search.Search(query, 0, neighbors, distances),
+      std::invalid_argument);
+  BOOST_REQUIRE_THROW(search.Search(arma::mat(4, 10, arma::fill::randu), 1,
+      neighbors, distances), std::invalid_argument);
+  BOOST_REQUIRE_THROW(search.Search(query, reference, 5, 4, neighbors,
+      distances), std::invalid_argument);
+
+  search.Search(query, 3, neighbors, distances);
+
+  ReducedPrecisionSearch<> xmlSearch, textSearch, binarySearch;
+  SerializeObjectAll(search, xmlSearch, textSearch, binarySearch);
+  arma::Mat<size_t> loadedNeighbors;
+  arma::mat loadedDistances;
+  xmlSearch.Search(query, 3, loadedNeighbors, loadedDistances);
+  CheckMatrices(neighbors, loadedNeighbors);
+  CheckMatrices(distances, loadedDistances);
+  binarySearch.Search(query, 3, loadedNeighbors, loadedDistances);
+  CheckMatrices(neighbors, loadedNeighbors);
+}
+
+/**
+ * Compute the k largest similarities of each query point with brute force.
+ */
+arma::mat BruteForceSimilarities(const arma::mat& query,
+                                 const arma::mat& reference,
+                                 const size_t k,
+                                 const bool normalize,
+                                 const bool monochromatic)
+{
+  arma::mat products = query.t() * reference;
+  if (normalize)
+  {
+    arma::rowvec queryNorms = arma::sqrt(arma::sum(arma::square(query)));
+    arma::rowvec referenceNorms =
+        arma::sqrt(arma::sum(arma::square(reference)));
+    queryNorms.elem(arma::find(queryNorms == 0)).ones();
+    referenceNorms.elem(arma::find(referenceNorms == 0)).ones();
+    products.each_col() /= queryNorms.t();
+    products.each_row() /= referenceNorms;
+  }
+
+  arma::mat similarities(k, query.n_cols);
+  for (size_t q = 0; q < query.n_cols; ++q)
+  {
+    arma::vec scores = products.row(q).t();
+    if (monochromatic)
+      scores.shed_row(q);
+    scores = arma::sort(scores, "descend");
+    similarities.col(q) = scores.subvec(0, k - 1);
+  }
+
+  return similarities;
+}
+
+/**
+ * Make sure that the search with an inverted index finds the reference points
+ * with the largest cosine similarity or inner product, with both nonnegative
+ * values (searched with WAND) and negative values.
+ */
+BOOST_AUTO_TEST_CASE(InvertedIndexSearchTest)
+{
+  for (size_t trial = 0; trial < 4; ++trial)
+  {
+    const bool normalize = (trial % 2 == 0);
+    arma::sp_mat reference, query;
+    if (trial < 2)
+    {
+      reference = arma::sprandu<arma::sp_mat>(100, 500, 0.05);
+      query = arma::sprandu<arma::sp_mat>(100, 50, 0.05);
+    }
+    else
+    {
+      reference = arma::sprandn<arma::sp_mat>(100, 500, 0.05);
+      query = arma::sprandn<arma::sp_mat>(100, 50, 0.05);
+    }
+    const arma::mat denseReference(reference), denseQuery(query);
+
+    InvertedIndexSearch search(reference, normalize);
+    BOOST_REQUIRE_EQUAL(search.NumPoints(), 500);
+    BOOST_REQUIRE_EQUAL(search.Dimensionality(), 100);
+    BOOST_REQUIRE_EQUAL(search.NumNonZero(), reference.n_nonzero);
+
+    arma::Mat<size_t> neighbors;
+    arma::mat similarities;
+    search.Search(query, 10, neighbors, similarities);
+    BOOST_REQUIRE_EQUAL(neighbors.n_rows, 10);
+    BOOST_REQUIRE_EQUAL(neighbors.n_cols, 50);
+    CheckMatrices(similarities, BruteForceSimilarities(denseQuery,
+        denseReference, 10, normalize, false));
+
+    // The similarities are the ones of the neighbors.
+    for (size_t q = 0; q < neighbors.n_cols; ++q)
+    {
+      for (size_t i = 0; i < neighbors.n_rows; ++i)
+      {
+        double similarity = arma::dot(denseQuery.col(q),
+            denseReference.col(neighbors(i, q)));
+        if (normalize && similarity != 0.0)
+        {
+          similarity /= arma::norm(denseQuery.col(q)) *
+              arma::norm(denseReference.col(neighbors(i, q)));
+        }
+        BOOST_REQUIRE_SMALL(similarities(i, q) - similarity, 1e-8);
+      }
+    }
+
+    // Search the reference set itself.
+    search.Search(10, neighbors, similarities);
+    BOOST_REQUIRE_EQUAL(neighbors.n_cols, 500);
+    CheckMatrices(similarities, BruteForceSimilarities(denseReference,
+        denseReference, 10, normalize, true));
+    for (size_t q = 0; q < neighbors.n_cols; ++q)
+      for (size_t i = 0; i < neighbors.n_rows; ++i)
+        BOOST_REQUIRE_NE(neighbors(i, q), q);
+  }
+}
+
+/**
+ * Make sure that the approximate search with an inverted index gives valid
+ * neighbors, that invalid parameters throw, and that the model can be
+ * serialized.
+ */
+BOOST_AUTO_TEST_CASE(InvertedIndexSearchApproximateTest)
+{
+  arma::sp_mat reference = arma::sprandu<arma::sp_mat>(100, 500, 0.05);
+  arma::sp_mat query = arma::sprandu<arma::sp_mat>(100, 50, 0.05);
+  arma::Mat<size_t> neighbors, exactNeighbors;
+  arma::mat similarities, exactSimilarities;
+
+  InvertedIndexSearch search(reference);
+  search.Search(query, 5, exactNeighbors, exactSimilarities);
+
+  search.Approximation() = 1.5;
+  search.Search(query, 5, neighbors, similarities);
+  for (size_t q = 0; q < neighbors.n_cols; ++q)
+  {
+    for (size_t i = 0; i < neighbors.n_rows; ++i)
+    {
+      // No similarity is better than the exact one, and the best found one is
+      // within the approximation factor.
+      BOOST_REQUIRE_LE(similarities(i, q), exactSimilarities(i, q) + 1e-10);
+      if (i > 0)
+        BOOST_REQUIRE_LE(similarities(i, q), similarities(i - 1, q));
+    }
+    BOOST_REQUIRE_GE(1.5 * similarities(0, q) + 1e-10, exactSimilarities(0, q));
+  }
+
+  InvertedIndexSearch untrained;
+  BOOST_REQUIRE_THROW(untrained.Search(query, 1, neighbors, similarities),
+      std::invalid_argument);
+  BOOST_REQUIRE_THROW(search.Search(query, 501, neighbors, similarities),
+      std::invalid_argument);
+  BOOST_REQUIRE_THROW(search.Search(500, neighbors, similarities),
+      std::invalid_argument);
+  BOOST_REQUIRE_THROW(search.Search(query, 0, neighbors, similarities),
+      std::invalid_argument);
+  BOOST_REQUIRE_THROW(search.Search(arma::sp_mat(101, 10), 1, neighbors,
+      similarities), std::invalid_argument);
+  search.Approximation() = 0.5;
+  BOOST_REQUIRE_THROW(search.Search(query, 1, neighbors, similarities),
+      std::invalid_argument);
+  search.Approximation() = 1.0;
+
+  InvertedIndexSearch xmlSearch, textSearch, binarySearch;
+  SerializeObjectAll(search, xmlSearch, textSearch, binarySearch);
+  arma::Mat<size_t> loadedNeighbors;
+  arma::mat loadedSimilarities;
+  xmlSearch.Search(query, 5, loadedNeighbors, loadedSimilarities);
+  CheckMatrices(exactNeighbors, loadedNeighbors);
+  CheckMatrices(exactSimilarities, loadedSimilarities);
+  binarySearch.Search(query, 5, loadedNeighbors, loadedSimilarities);
+  CheckMatrices(exactNeighbors, loadedNeighbors);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
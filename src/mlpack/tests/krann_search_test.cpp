@@ -17,6 +17,10 @@
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
 
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
 #include <mlpack/methods/rann/ra_search.hpp>
 #include <mlpack/methods/rann/ra_model.hpp>
 
@@ -715,4 +719,50 @@ BOOST_AUTO_TEST_CASE(RAModelTest)
   }
 }
 
+/**
+ * Make sure that single-tree search gives the same results for the same random
+ * seed, no matter how many threads traverse the queries, and that consecutive
+ * searches still draw different samples.
+ */
+BOOST_AUTO_TEST_CASE(SingleTreeReproducibleSearchTest)
+{
+  arma::mat refData;
+  arma::mat queryData;
+
+  data::Load("rann_test_r_3_900.csv", refData, true);
+  data::Load("rann_test_q_3_100.csv", queryData, true);
+
+  RASearch<> tssRann(refData, false, true, 1.0, 0.95, false, false);
+
+  arma::Mat<size_t> neighbors1, neighbors2, neighbors3;
+  arma::mat distances1, distances2, distances3;
+
+#ifdef HAS_OPENMP
+  const int numThreads = omp_get_max_threads();
+  omp_set_num_threads(1);
+#endif
+
+  math::RandomSeed(42);
+  tssRann.Search(queryData, 5, neighbors1, distances1);
+  // A second search with the same seed state continues the random sequence.
+  tssRann.Search(queryData, 5, neighbors3, distances3);
+
+#ifdef HAS_OPENMP
+  omp_set_num_threads(4);
+#endif
+
+  math::RandomSeed(42);
+  tssRann.Search(queryData, 5, neighbors2, distances2);
+
+#ifdef HAS_OPENMP
+  omp_set_num_threads(numThreads);
+#endif
+
+  CheckMatrices(neighbors1, neighbors2);
+  CheckMatrices(distances1, distances2);
+
+  // Consecutive searches sample different points.
+  BOOST_REQUIRE_GT(arma::accu(neighbors1 != neighbors3), 0);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
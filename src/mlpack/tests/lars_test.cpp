@@ -463,4 +463,55 @@ BOOST_AUTO_TEST_CASE(LARSCopyConstructorTest)
   CheckMatrices(predictions, predictionsFromCopiedModel);
 }
 
+/**
+ * Make sure that training on sparse data gives the same solution as training on
+ * the same data in a dense matrix, with and without the Cholesky
+ * factorization.
+ */
+BOOST_AUTO_TEST_CASE(LARSSparseTest)
+{
+  for (size_t trial = 0; trial < 4; ++trial)
+  {
+    const bool useCholesky = (trial % 2 == 0);
+    const bool elasticNet = (trial >= 2);
+
+    arma::sp_mat sparseX;
+    sparseX.sprandn(40, 100, 0.3);
+    const arma::mat X(sparseX);
+    const arma::vec trueBeta = arma::randn(40);
+    const arma::rowvec y = trueBeta.t() * X;
+
+    arma::vec sortedAbsCorr = sort(abs(X * y.t()));
+    const double lambda1 = sortedAbsCorr(20);
+    const double lambda2 = elasticNet ? lambda1 / 2 : 0.0;
+
+    LARS denseLars(useCholesky, lambda1, lambda2);
+    arma::vec denseBeta;
+    const double denseError = denseLars.Train(X, y, denseBeta);
+
+    LARS sparseLars(useCholesky, lambda1, lambda2);
+    arma::vec sparseBeta;
+    const double sparseError = sparseLars.Train(sparseX, y, sparseBeta);
+
+    BOOST_REQUIRE_EQUAL(denseBeta.n_elem, sparseBeta.n_elem);
+    for (size_t i = 0; i < denseBeta.n_elem; ++i)
+      BOOST_REQUIRE_SMALL(denseBeta[i] - sparseBeta[i], 1e-8);
+    BOOST_REQUIRE_SMALL(denseError - sparseError, 1e-6);
+
+    arma::vec errCorr = (X * trans(X) + lambda2 *
+        arma::eye(40, 40)) * sparseBeta - X * y.t();
+    LARSVerifyCorrectness(sparseBeta, errCorr, lambda1);
+
+    // The predictions should match too.
+    arma::rowvec densePredictions, sparsePredictions;
+    denseLars.Predict(X, densePredictions);
+    sparseLars.Predict(sparseX, sparsePredictions);
+    for (size_t i = 0; i < densePredictions.n_elem; ++i)
+    {
+      BOOST_REQUIRE_SMALL(densePredictions[i] - sparsePredictions[i],
+          1e-6);
+    }
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -258,4 +258,58 @@ BOOST_AUTO_TEST_CASE(TestSymKronId)
   }
 }
 
+/**
+ * Make sure the covariance computed by blocks, in several chunks, is the same
+ * as Armadillo's.
+ */
+BOOST_AUTO_TEST_CASE(TestRunningCovariance)
+{
+  arma::mat data = arma::randn<arma::mat>(5, 1000);
+  data.row(2) *= 10.0;
+  data.row(3) += 100.0;
+
+  RunningCovariance<> covariance(0, 64);
+  covariance.Update(data.cols(0, 299));
+  covariance.Update(data.cols(300, 999));
+
+  BOOST_REQUIRE_EQUAL(covariance.Weight(), 1000.0);
+  CheckMatrices(covariance.Mean(), arma::mean(data, 1));
+  CheckMatrices(covariance.Covariance(), arma::cov(data.t()));
+  CheckMatrices(covariance.Covariance(1), arma::cov(data.t(), 1));
+  CheckMatrices(ColumnCovariance(data), arma::cov(data.t()));
+
+  // Merging the statistics of two parts gives the same result.
+  RunningCovariance<> first, second;
+  first.Update(data.cols(0, 499));
+  second.Update(data.cols(500, 999));
+  first.Merge(second);
+  CheckMatrices(first.Covariance(), covariance.Covariance());
+
+  BOOST_REQUIRE_THROW(covariance.Update(arma::mat(4, 10)),
+      std::invalid_argument);
+}
+
+/**
+ * Test the weighted covariance against a direct computation.
+ */
+BOOST_AUTO_TEST_CASE(TestWeightedRunningCovariance)
+{
+  arma::mat data = arma::randn<arma::mat>(4, 500);
+  arma::vec weights = arma::randu<arma::vec>(500);
+  weights.subvec(0, 99).zeros();
+
+  RunningCovariance<> covariance(4, 32);
+  covariance.Update(data, weights);
+
+  const double sum = arma::accu(weights);
+  const arma::vec mean = data * weights / sum;
+  const arma::mat centered = data.each_col() - mean;
+  const arma::mat expected = centered * arma::diagmat(weights) *
+      centered.t() / sum;
+
+  BOOST_REQUIRE_CLOSE(covariance.Weight(), sum, 1e-5);
+  CheckMatrices(covariance.Mean(), mean);
+  CheckMatrices(covariance.Covariance(1), expected);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -200,6 +200,49 @@ BOOST_AUTO_TEST_CASE(LinearRegressionTrainTest)
     BOOST_REQUIRE_CLOSE(lr.Parameters()[i], lrTrain.Parameters()[i], 1e-5);
 }
 
+/**
+ * Test that training a LinearRegression model on chunks with PartialTrain(), or
+ * on parts of the dataset merged with Merge(), gives the same model as Train().
+ */
+BOOST_AUTO_TEST_CASE(LinearRegressionPartialTrainTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(5, 1000);
+  arma::rowvec responses = arma::randu<arma::rowvec>(1000);
+  arma::rowvec weights = arma::randu<arma::rowvec>(1000);
+
+  LinearRegression lr;
+  lr.Lambda() = 0.3;
+  lr.Train(dataset, responses, weights);
+
+  LinearRegression lrPartial, lrMerged, lrOther;
+  lrPartial.Lambda() = 0.3;
+  lrMerged.Lambda() = 0.3;
+  for (size_t i = 0; i < 1000; i += 250)
+  {
+    lrPartial.PartialTrain(dataset.cols(i, i + 249),
+        responses.subvec(i, i + 249), weights.subvec(i, i + 249));
+  }
+
+  lrMerged.PartialTrain(dataset.cols(0, 399), responses.subvec(0, 399),
+      weights.subvec(0, 399));
+  lrOther.PartialTrain(dataset.cols(400, 999), responses.subvec(400, 999),
+      weights.subvec(400, 999));
+  lrMerged.Merge(lrOther);
+
+  BOOST_REQUIRE_EQUAL(lr.Parameters().n_elem, 6);
+  BOOST_REQUIRE_EQUAL(lrPartial.Parameters().n_elem, 6);
+  BOOST_REQUIRE_EQUAL(lrMerged.Parameters().n_elem, 6);
+  for (size_t i = 0; i < lr.Parameters().n_elem; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(lr.Parameters()[i], lrPartial.Parameters()[i], 1e-5);
+    BOOST_REQUIRE_CLOSE(lr.Parameters()[i], lrMerged.Parameters()[i], 1e-5);
+  }
+
+  // A chunk of a different dimensionality can't be added.
+  BOOST_REQUIRE_THROW(lrPartial.PartialTrain(dataset.rows(0, 3), responses),
+      std::invalid_argument);
+}
+
 /*
  * Linear regression serialization test.
  */
@@ -875,6 +875,46 @@ BOOST_AUTO_TEST_CASE(LinearSVMSparseLBFGSTest)
     BOOST_REQUIRE_CLOSE(lr.Parameters()[i], lrSparse.Parameters()[i], 5e-4);
 }
 
+/**
+ * Test that the LinearSVMFunction gives the same objective and gradient on a
+ * sparse dataset as on the equivalent dense dataset, for the whole dataset
+ * (which spans several blocks of points) and for a batch.
+ */
+BOOST_AUTO_TEST_CASE(LinearSVMFunctionSparseTest)
+{
+  arma::sp_mat dataset;
+  dataset.sprandu(50, 2500, 0.1);
+  arma::mat denseDataset(dataset);
+  arma::Row<size_t> labels(2500);
+  for (size_t i = 0; i < 2500; ++i)
+    labels[i] = math::RandInt(0, 4);
+
+  LinearSVMFunction<arma::mat> svmf(denseDataset, labels, 4, 0.01, 1.0, true);
+  LinearSVMFunction<arma::sp_mat> sparseSvmf(dataset, labels, 4, 0.01, 1.0,
+      true);
+
+  arma::mat parameters;
+  parameters.randn(51, 4);
+
+  arma::mat gradient, sparseGradient;
+  const double objective = svmf.EvaluateWithGradient(parameters, gradient);
+  const double sparseObjective = sparseSvmf.EvaluateWithGradient(parameters,
+      sparseGradient);
+  BOOST_REQUIRE_CLOSE(objective, sparseObjective, 1e-5);
+  CheckMatrices(gradient, sparseGradient, 1e-5);
+
+  const double batchObjective = svmf.EvaluateWithGradient(parameters, 1500,
+      gradient, 1000);
+  const double sparseBatchObjective = sparseSvmf.EvaluateWithGradient(
+      parameters, 1500, sparseGradient, 1000);
+  BOOST_REQUIRE_CLOSE(batchObjective, sparseBatchObjective, 1e-5);
+  CheckMatrices(gradient, sparseGradient, 1e-5);
+
+  // The separable objective must match the objective of the batch.
+  BOOST_REQUIRE_CLOSE(sparseSvmf.Evaluate(parameters, 1500, 1000),
+      sparseBatchObjective, 1e-5);
+}
+
 /**
  * Test training of linear svm for multiple classes on a complex gaussian
  * dataset using L-BFGS optimizer.
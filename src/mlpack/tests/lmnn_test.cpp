@@ -100,6 +100,58 @@ BOOST_AUTO_TEST_CASE(LMNNImpostorsTest)
   BOOST_REQUIRE_EQUAL(impostors(0, 5), 2);
 }
 
+/**
+ * With many classes the classes are searched in parallel; the impostors and
+ * target neighbors should still be the nearest points of the other classes and
+ * of the same class.
+ */
+BOOST_AUTO_TEST_CASE(LMNNManyClassesConstraintsTest)
+{
+  const size_t k = 3;
+  arma::mat dataset = arma::randu<arma::mat>(3, 240);
+  arma::Row<size_t> labels(dataset.n_cols);
+  for (size_t i = 0; i < labels.n_elem; ++i)
+    labels[i] = i % 16;
+
+  Constraints<> constraint(dataset, labels, k);
+
+  arma::vec norm(dataset.n_cols);
+  for (size_t i = 0; i < dataset.n_cols; i++)
+    norm(i) = arma::norm(dataset.col(i));
+
+  arma::Mat<size_t> impostors(k, dataset.n_cols);
+  arma::mat distances(k, dataset.n_cols);
+  constraint.Impostors(impostors, distances, dataset, labels, norm);
+  arma::Mat<size_t> targetNeighbors(k, dataset.n_cols);
+  constraint.TargetNeighbors(targetNeighbors, dataset, labels, norm);
+
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    // Sort the other points by distance to this one.
+    std::vector<std::pair<double, size_t>> same, diff;
+    for (size_t j = 0; j < dataset.n_cols; ++j)
+    {
+      if (j == i)
+        continue;
+      const double d = SquaredEuclideanDistance::Evaluate(
+          dataset.col(i), dataset.col(j));
+      if (labels[j] == labels[i])
+        same.push_back(std::make_pair(d, j));
+      else
+        diff.push_back(std::make_pair(d, j));
+    }
+    std::sort(same.begin(), same.end());
+    std::sort(diff.begin(), diff.end());
+
+    for (size_t j = 0; j < k; ++j)
+    {
+      BOOST_REQUIRE_EQUAL(impostors(j, i), diff[j].second);
+      BOOST_REQUIRE_CLOSE(distances(j, i), diff[j].first, 1e-5);
+      BOOST_REQUIRE_EQUAL(targetNeighbors(j, i), same[j].second);
+    }
+  }
+}
+
 //
 // Tests for the LMNNFunction
 //
@@ -13,10 +13,17 @@
 
 #include <mlpack/core.hpp>
 #include <mlpack/core/data/load_arff.hpp>
+#include <mlpack/core/data/binary_dataset.hpp>
+#include <mlpack/core/data/compressed_stream.hpp>
+#include <mlpack/core/data/load_parquet.hpp>
 #include <mlpack/core/data/map_policies/missing_policy.hpp>
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
 
+#ifdef HAS_PARQUET
+  #include <parquet/arrow/writer.h>
+#endif
+
 using namespace mlpack;
 using namespace mlpack::data;
 using namespace std;
@@ -554,6 +561,134 @@ BOOST_AUTO_TEST_CASE(LoadQuotedStringInTSVTest)
   remove("test_file.tsv");
 }
 
+/**
+ * Make sure that the categories of a large CSV are mapped in the order in which
+ * they appear in the file, even though the lines are split in parallel.
+ */
+BOOST_AUTO_TEST_CASE(LoadLargeCategoricalCSVTest)
+{
+  fstream f;
+  f.open("test_file.csv", fstream::out);
+
+  const size_t numPoints = 20000;
+  std::vector<size_t> categories(numPoints);
+  for (size_t i = 0; i < numPoints; ++i)
+  {
+    categories[i] = (i * 7919) % 101;
+    f << i << ", 'cat " << categories[i] << "'," << (i % 3) << endl;
+  }
+
+  f.close();
+
+  arma::mat test;
+  data::DatasetInfo info;
+  BOOST_REQUIRE(data::Load("test_file.csv", test, info, false, true) == true);
+
+  BOOST_REQUIRE_EQUAL(test.n_rows, 3);
+  BOOST_REQUIRE_EQUAL(test.n_cols, numPoints);
+  BOOST_REQUIRE(info.Type(0) == data::Datatype::numeric);
+  BOOST_REQUIRE(info.Type(1) == data::Datatype::categorical);
+  BOOST_REQUIRE(info.Type(2) == data::Datatype::numeric);
+  BOOST_REQUIRE_EQUAL(info.NumMappings(1), 101);
+
+  std::map<size_t, size_t> labels;
+  for (size_t i = 0; i < numPoints; ++i)
+  {
+    if (labels.count(categories[i]) == 0)
+    {
+      const size_t label = labels.size();
+      labels[categories[i]] = label;
+    }
+
+    BOOST_REQUIRE_EQUAL(test(0, i), (double) i);
+    BOOST_REQUIRE_EQUAL(test(1, i), (double) labels[categories[i]]);
+    BOOST_REQUIRE_EQUAL(test(2, i), (double) (i % 3));
+  }
+
+  BOOST_REQUIRE_EQUAL(info.UnmapString(test(1, 1), 1, 0), "'cat 41'");
+
+  // Remove the file.
+  remove("test_file.csv");
+}
+
+/**
+ * Make sure that the categories of a CSV with many categorical dimensions,
+ * which are mapped in parallel, are mapped in the order in which they appear in
+ * the file, both when each line is a point and when each line is a dimension.
+ */
+BOOST_AUTO_TEST_CASE(LoadManyCategoricalDimensionsCSVTest)
+{
+  fstream f;
+  f.open("test_file.csv", fstream::out);
+
+  const size_t numLines = 500;
+  const size_t numFields = 37;
+  arma::Mat<size_t> categories(numFields, numLines);
+  for (size_t i = 0; i < numLines; ++i)
+  {
+    for (size_t j = 0; j < numFields; ++j)
+    {
+      categories(j, i) = (i * (j + 3) * 7919) % (j + 5);
+      f << (j == 0 ? "" : ",") << "c" << j << "_" << categories(j, i);
+    }
+    f << endl;
+  }
+
+  f.close();
+
+  // Each line is a point.
+  arma::mat test;
+  data::DatasetInfo info;
+  BOOST_REQUIRE(data::Load("test_file.csv", test, info, false, true) == true);
+  BOOST_REQUIRE_EQUAL(test.n_rows, numFields);
+  BOOST_REQUIRE_EQUAL(test.n_cols, numLines);
+  for (size_t j = 0; j < numFields; ++j)
+  {
+    BOOST_REQUIRE(info.Type(j) == data::Datatype::categorical);
+
+    std::map<size_t, size_t> labels;
+    for (size_t i = 0; i < numLines; ++i)
+    {
+      if (labels.count(categories(j, i)) == 0)
+      {
+        const size_t label = labels.size();
+        labels[categories(j, i)] = label;
+      }
+
+      BOOST_REQUIRE_EQUAL(test(j, i), (double) labels[categories(j, i)]);
+    }
+    BOOST_REQUIRE_EQUAL(info.NumMappings(j), labels.size());
+  }
+
+  // Each line is a dimension.
+  data::DatasetInfo nontransposedInfo;
+  BOOST_REQUIRE(data::Load("test_file.csv", test, nontransposedInfo, false,
+      false) == true);
+  BOOST_REQUIRE_EQUAL(test.n_rows, numLines);
+  BOOST_REQUIRE_EQUAL(test.n_cols, numFields);
+  for (size_t i = 0; i < numLines; ++i)
+  {
+    BOOST_REQUIRE(nontransposedInfo.Type(i) == data::Datatype::categorical);
+
+    std::map<std::pair<size_t, size_t>, size_t> labels;
+    for (size_t j = 0; j < numFields; ++j)
+    {
+      const std::pair<size_t, size_t> category(j, categories(j, i));
+      if (labels.count(category) == 0)
+      {
+        const size_t label = labels.size();
+        labels[category] = label;
+      }
+
+      BOOST_REQUIRE_EQUAL(test(i, j), (double) labels[category]);
+    }
+    BOOST_REQUIRE_EQUAL(nontransposedInfo.NumMappings(i), labels.size());
+  }
+
+  // Remove the file.
+  remove("test_file.csv");
+}
+
 /**
  * Make sure Load() throws an exception when trying to load a matrix into a
  * colvec or rowvec.
@@ -1113,6 +1248,65 @@ BOOST_AUTO_TEST_CASE(OneHotEncodingTest)
   CheckMatrices(output, matrix);
 }
 
+/**
+ * Make sure the sparse one hot encoding gives the same result as the dense one,
+ * for many distinct labels.
+ */
+BOOST_AUTO_TEST_CASE(SparseOneHotEncodingTest)
+{
+  arma::irowvec labels = arma::randi<arma::irowvec>(1000,
+      arma::distr_param(-200, 200));
+
+  arma::mat dense;
+  arma::sp_mat sparse;
+  data::OneHotEncoding(labels, dense);
+  data::OneHotEncoding(labels, sparse);
+
+  BOOST_REQUIRE_EQUAL(sparse.n_rows, dense.n_rows);
+  BOOST_REQUIRE_EQUAL(sparse.n_cols, dense.n_cols);
+  BOOST_REQUIRE_EQUAL(sparse.n_nonzero, labels.n_elem);
+  CheckMatrices(arma::mat(sparse), dense);
+}
+
+/**
+ * Test one hot encoding of the categorical dimensions of a dataset.
+ */
+BOOST_AUTO_TEST_CASE(DatasetInfoOneHotEncodingTest)
+{
+  // The first and third dimensions are categorical, with 3 and 2 values.
+  data::DatasetInfo info(3);
+  info.Type(0) = data::Datatype::categorical;
+  info.Type(2) = data::Datatype::categorical;
+  info.MapString<double>("a", 0);
+  info.MapString<double>("b", 0);
+  info.MapString<double>("c", 0);
+  info.MapString<double>("x", 2);
+  info.MapString<double>("y", 2);
+
+  arma::mat input = "2 0 1 0;"
+                    "1.5 0 -3 2;"
+                    "0 1 1 0;";
+  arma::mat expected = "0 1 0 1;"
+                       "0 0 1 0;"
+                       "1 0 0 0;"
+                       "1.5 0 -3 2;"
+                       "1 0 0 1;"
+                       "0 1 1 0;";
+
+  arma::sp_mat output;
+  data::OneHotEncoding(input, info, output);
+
+  BOOST_REQUIRE_EQUAL(output.n_rows, 6);
+  BOOST_REQUIRE_EQUAL(output.n_cols, 4);
+  BOOST_REQUIRE_EQUAL(output.n_nonzero, 11);
+  CheckMatrices(arma::mat(output), expected);
+
+  // A value which is not a mapped value can't be encoded.
+  input(2, 1) = 2;
+  BOOST_REQUIRE_THROW(data::OneHotEncoding(input, info, output),
+      std::invalid_argument);
+}
+
 /**
  * Test normalization of labels.
  */
@@ -1272,6 +1466,49 @@ BOOST_AUTO_TEST_CASE(LoadTextTest)
   BOOST_REQUIRE_EQUAL(y.inb.s, x.inb.s);
 }
 
+/**
+ * Return the extensions of the compressions that mlpack was compiled with
+ * support for.
+ */
+static vector<string> CompressionExtensions()
+{
+  vector<string> extensions;
+  if (data::CompressionAvailable(data::Compression::gzip))
+    extensions.push_back(".gz");
+  if (data::CompressionAvailable(data::Compression::zstd))
+    extensions.push_back(".zst");
+
+  return extensions;
+}
+
+/**
+ * Make sure we can load and save compressed models in each format.
+ */
+BOOST_AUTO_TEST_CASE(LoadCompressedModelTest)
+{
+  for (const string& compression : CompressionExtensions())
+  {
+    for (const string& format : { "bin", "xml", "txt" })
+    {
+      const string filename = "test." + format + compression;
+      Test x(10, 12);
+      BOOST_REQUIRE_EQUAL(data::Save(filename, "x", x, false), true);
+
+      Test y(11, 14);
+      BOOST_REQUIRE_EQUAL(data::Load(filename, "x", y, false), true);
+
+      BOOST_REQUIRE_EQUAL(y.x, x.x);
+      BOOST_REQUIRE_EQUAL(y.y, x.y);
+      BOOST_REQUIRE_EQUAL(y.ina.c, x.ina.c);
+      BOOST_REQUIRE_EQUAL(y.ina.s, x.ina.s);
+      BOOST_REQUIRE_EQUAL(y.inb.c, x.inb.c);
+      BOOST_REQUIRE_EQUAL(y.inb.s, x.inb.s);
+
+      remove(filename.c_str());
+    }
+  }
+}
+
 /**
  * Test DatasetInfo by making a map for a dimension.
  */
@@ -2178,6 +2415,112 @@ BOOST_AUTO_TEST_CASE(CaseTest)
   BOOST_CHECK_EQUAL(dataset.n_cols, 3);
 }
 
+/**
+ * Make sure that sparse ARFF lines are loaded into both dense and sparse
+ * matrices, with the values they don't give set to 0.
+ */
+BOOST_AUTO_TEST_CASE(SparseARFFTest)
+{
+  fstream f;
+  f.open("test.arff", fstream::out);
+  f << "@relation test" << endl;
+  f << "@attribute one numeric" << endl;
+  f << "@attribute two string" << endl;
+  f << "@attribute three numeric" << endl;
+  f << "@attribute four numeric" << endl;
+  f << "@data" << endl;
+  f << "{0 1.5, 3 -2}" << endl;
+  f << "% comment" << endl;
+  f << "{1 'hello world', 2 3} % comment" << endl;
+  f << "{}" << endl;
+  f << "0, cheese, 0, 4" << endl;
+  f << "{ 3 5e-1, 1 cheese }" << endl;
+  f.close();
+
+  arma::mat dense;
+  DatasetInfo info;
+  data::LoadARFF("test.arff", dense, info);
+
+  BOOST_REQUIRE_EQUAL(info.Dimensionality(), 4);
+  BOOST_REQUIRE(info.Type(1) == Datatype::categorical);
+  BOOST_REQUIRE_EQUAL(info.NumMappings(1), 2);
+
+  arma::mat expected = { { 1.5, 0.0, 0.0, 0.0, 0.0 },
+                         { 0.0, 0.0, 0.0, 1.0, 1.0 },
+                         { 0.0, 3.0, 0.0, 0.0, 0.0 },
+                         { -2.0, 0.0, 0.0, 4.0, 0.5 } };
+  BOOST_REQUIRE_EQUAL(dense.n_rows, 4);
+  BOOST_REQUIRE_EQUAL(dense.n_cols, 5);
+  for (size_t i = 0; i < expected.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(dense[i] + 1.0, expected[i] + 1.0, 1e-5);
+  BOOST_REQUIRE_EQUAL(info.UnmapString(0, 1), "hello world");
+
+  arma::sp_mat sparse;
+  BOOST_REQUIRE(data::Load("test.arff", sparse, true) == true);
+  BOOST_REQUIRE_EQUAL(sparse.n_rows, 4);
+  BOOST_REQUIRE_EQUAL(sparse.n_cols, 5);
+  BOOST_REQUIRE_EQUAL(sparse.n_nonzero, 7);
+  for (size_t i = 0; i < expected.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(sparse[i] + 1.0, expected[i] + 1.0, 1e-5);
+
+  remove("test.arff");
+}
+
+/**
+ * Make sure that a large ARFF file, which is parsed in several blocks, is
+ * loaded correctly, and that the categories are mapped in the order of the
+ * file.
+ */
+BOOST_AUTO_TEST_CASE(LargeARFFTest)
+{
+  fstream f;
+  f.open("test.arff", fstream::out);
+  f << "@relation test" << endl;
+  f << "@attribute one numeric" << endl;
+  f << "@attribute two string" << endl;
+  f << "@data" << endl;
+
+  const size_t numPoints = 40000;
+  std::vector<size_t> categories(numPoints);
+  for (size_t i = 0; i < numPoints; ++i)
+  {
+    categories[i] = (i * 7919) % 101;
+    f << (0.5 * i) << ", \"cat " << categories[i] << "\"" << endl;
+  }
+  f.close();
+
+  arma::mat dataset;
+  DatasetInfo info;
+  data::LoadARFF("test.arff", dataset, info);
+
+  BOOST_REQUIRE_EQUAL(dataset.n_rows, 2);
+  BOOST_REQUIRE_EQUAL(dataset.n_cols, numPoints);
+  BOOST_REQUIRE_EQUAL(info.NumMappings(1), 101);
+
+  std::map<size_t, size_t> labels;
+  for (size_t i = 0; i < numPoints; ++i)
+  {
+    if (labels.count(categories[i]) == 0)
+    {
+      const size_t label = labels.size();
+      labels[categories[i]] = label;
+    }
+
+    BOOST_REQUIRE_EQUAL(dataset(0, i), 0.5 * i);
+    BOOST_REQUIRE_EQUAL(dataset(1, i), (double) labels[categories[i]]);
+  }
+
+  // A line with too few values must fail.
+  f.open("test.arff", fstream::out | fstream::app);
+  f << "3" << endl;
+  f.close();
+
+  BOOST_REQUIRE_THROW(data::LoadARFF("test.arff", dataset, info),
+      std::runtime_error);
+
+  remove("test.arff");
+}
+
 /**
  * Test that a CSV with the wrong number of columns fails.
  */
@@ -2353,4 +2696,373 @@ BOOST_AUTO_TEST_CASE(DatasetMapperNonUniqueTest)
   BOOST_REQUIRE_EQUAL(dm.UnmapString(nan, 0, 2), "cheese");
 }
 
+/**
+ * Make sure that ChunkLoader returns every chunk once per epoch, splits off the
+ * responses, and signals the end of each epoch.
+ */
+BOOST_AUTO_TEST_CASE(ChunkLoaderTest)
+{
+  std::vector<std::string> files;
+  std::vector<arma::mat> chunks;
+  for (size_t i = 0; i < 3; ++i)
+  {
+    // Mark every point with the index of its chunk.
+    arma::mat chunk(4, 5 + i, arma::fill::randu);
+    chunk.row(0).fill(i);
+    chunks.push_back(chunk);
+
+    files.push_back("test_chunk_" + std::to_string(i) + ".bin");
+    BOOST_REQUIRE(data::Save(files.back(), chunk));
+  }
+
+  // Without shuffling the chunks are returned in order.
+  data::ChunkLoader loader(files, 1, false);
+  BOOST_REQUIRE_EQUAL(loader.NumChunks(), 3);
+
+  arma::mat predictors, responses;
+  for (size_t epoch = 0; epoch < 2; ++epoch)
+  {
+    for (size_t i = 0; i < 3; ++i)
+    {
+      BOOST_REQUIRE(loader.Next(predictors, responses));
+      CheckMatrices(predictors, chunks[i].rows(0, 2));
+      CheckMatrices(responses, chunks[i].row(3));
+    }
+
+    BOOST_REQUIRE(!loader.Next(predictors, responses));
+  }
+
+  // With shuffling every chunk is still returned exactly once per epoch.
+  loader.Shuffle() = true;
+  loader.Reset();
+  for (size_t epoch = 0; epoch < 3; ++epoch)
+  {
+    arma::uvec seen(3, arma::fill::zeros);
+    while (loader.Next(predictors, responses))
+    {
+      const size_t index = (size_t) predictors(0, 0);
+      seen[index]++;
+      CheckMatrices(predictors, chunks[index].rows(0, 2));
+    }
+
+    BOOST_REQUIRE_EQUAL(arma::accu(seen), 3);
+    BOOST_REQUIRE_EQUAL(seen.max(), 1);
+  }
+
+  for (size_t i = 0; i < files.size(); ++i)
+    remove(files[i].c_str());
+
+  // A missing chunk gives an error when it is requested.
+  data::ChunkLoader missing(std::vector<std::string>(1, "missing_chunk.bin"),
+      1);
+  BOOST_REQUIRE_THROW(missing.Next(predictors, responses), std::runtime_error);
+}
+
+/**
+ * Make sure a matrix can be saved and loaded in the mlpack binary dataset
+ * format, with and without transposition.
+ */
+BOOST_AUTO_TEST_CASE(BinaryDatasetTest)
+{
+  arma::mat dataset(5, 20, arma::fill::randu);
+
+  BOOST_REQUIRE(data::Save("test_file.mlb", dataset) == true);
+
+  arma::mat test;
+  BOOST_REQUIRE(data::Load("test_file.mlb", test) == true);
+  BOOST_REQUIRE_EQUAL(test.n_rows, 5);
+  BOOST_REQUIRE_EQUAL(test.n_cols, 20);
+  for (size_t i = 0; i < dataset.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(test[i], dataset[i]);
+
+  BOOST_REQUIRE(data::Load("test_file.mlb", test, false, false) == true);
+  BOOST_REQUIRE_EQUAL(test.n_rows, 20);
+  BOOST_REQUIRE_EQUAL(test.n_cols, 5);
+  CheckMatrices(test, dataset.t());
+
+  // The elements are converted to the type of the matrix.
+  arma::Mat<size_t> labels;
+  arma::mat counts = arma::floor(10 * dataset);
+  BOOST_REQUIRE(data::Save("test_file.mlb", counts) == true);
+  BOOST_REQUIRE(data::Load("test_file.mlb", labels) == true);
+  CheckMatrices(labels, arma::conv_to<arma::Mat<size_t>>::from(counts));
+
+  // Saving without transposition gives one row per point in the file.
+  BOOST_REQUIRE(data::Save("test_file.mlb", dataset, false, false) == true);
+  BOOST_REQUIRE(data::Load("test_file.mlb", test, false, false) == true);
+  CheckMatrices(test, dataset);
+
+  remove("test_file.mlb");
+}
+
+/**
+ * Make sure the dimension types and mappings of a DatasetInfo are saved with a
+ * matrix in the mlpack binary dataset format, and that a mapped dataset gives
+ * the same matrix without copying it.
+ */
+BOOST_AUTO_TEST_CASE(BinaryDatasetInfoTest)
+{
+  fstream f;
+  f.open("test_file.csv", fstream::out);
+  f << "1, a, 2" << endl;
+  f << "3, b, 4" << endl;
+  f << "5, a, 6" << endl;
+  f.close();
+
+  arma::mat dataset;
+  data::DatasetInfo info;
+  BOOST_REQUIRE(data::Load("test_file.csv", dataset, info) == true);
+  remove("test_file.csv");
+
+  data::SaveBinaryDataset("test_file.mlb", dataset, info);
+
+  arma::mat test;
+  data::DatasetInfo testInfo;
+  BOOST_REQUIRE(data::Load("test_file.mlb", test, testInfo) == true);
+  CheckMatrices(test, dataset);
+  BOOST_REQUIRE_EQUAL(testInfo.Dimensionality(), 3);
+  BOOST_REQUIRE(testInfo.Type(0) == data::Datatype::numeric);
+  BOOST_REQUIRE(testInfo.Type(1) == data::Datatype::categorical);
+  BOOST_REQUIRE(testInfo.Type(2) == data::Datatype::numeric);
+  BOOST_REQUIRE_EQUAL(testInfo.NumMappings(1), 2);
+  BOOST_REQUIRE_EQUAL(testInfo.UnmapString(test(1, 1), 1), "b");
+
+  {
+    data::MappedDataset<double> mapped("test_file.mlb");
+    CheckMatrices(mapped.Matrix(), dataset);
+    BOOST_REQUIRE_EQUAL(mapped.Info().NumMappings(1), 2);
+    BOOST_REQUIRE_EQUAL(mapped.Info().UnmapString(test(1, 0), 1), "a");
+
+    // The matrix refers to the mapped memory.
+    BOOST_REQUIRE_EQUAL(mapped.Matrix().mem_state, 2);
+
+    // The element type must match.
+    BOOST_REQUIRE_THROW(data::MappedDataset<float>("test_file.mlb"),
+        std::runtime_error);
+  }
+
+  // A file without a DatasetInfo gives numeric dimensions.
+  data::SaveBinaryDataset("test_file.mlb", dataset);
+  BOOST_REQUIRE(data::Load("test_file.mlb", test, testInfo) == true);
+  BOOST_REQUIRE_EQUAL(testInfo.Dimensionality(), 3);
+  BOOST_REQUIRE(testInfo.Type(1) == data::Datatype::numeric);
+
+  // Other files are not accepted.
+  f.open("test_file.mlb", fstream::out);
+  f << "1, 2, 3" << endl;
+  f.close();
+  BOOST_REQUIRE(data::Load("test_file.mlb", test) == false);
+
+  remove("test_file.mlb");
+}
+
+/**
+ * Make sure that a file that is not a Parquet file is not loaded (this also
+ * fails if mlpack was compiled without Parquet support).
+ */
+BOOST_AUTO_TEST_CASE(LoadInvalidParquetTest)
+{
+  fstream f;
+  f.open("test_file.parquet", fstream::out);
+  f << "1, 2, 3" << endl;
+  f.close();
+
+  arma::mat test;
+  data::DatasetInfo info;
+  BOOST_REQUIRE(data::Load("test_file.parquet", test) == false);
+  BOOST_REQUIRE(data::Load("test_file.parquet", test, info) == false);
+  BOOST_REQUIRE_THROW(data::LoadParquet("test_file.parquet", test, info),
+      std::runtime_error);
+
+  remove("test_file.parquet");
+}
+
+/**
+ * Make sure the compression of a file is detected by its extension.
+ */
+BOOST_AUTO_TEST_CASE(FileCompressionTest)
+{
+  BOOST_REQUIRE(data::FileCompression("test.csv") == data::Compression::none);
+  BOOST_REQUIRE(data::FileCompression("test.csv.gz") ==
+      data::Compression::gzip);
+  BOOST_REQUIRE(data::FileCompression("test.bin.ZST") ==
+      data::Compression::zstd);
+  BOOST_REQUIRE_EQUAL(data::UncompressedName("test.csv"), "test.csv");
+  BOOST_REQUIRE_EQUAL(data::UncompressedName("a.b.csv.gz"), "a.b.csv");
+  BOOST_REQUIRE_EQUAL(data::UncompressedName("test.xml.zst"), "test.xml");
+}
+
+/**
+ * Save and load compressed dense and sparse matrices.
+ */
+BOOST_AUTO_TEST_CASE(LoadSaveCompressedMatrixTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(5, 1000);
+  arma::sp_mat sparse = arma::sprandu<arma::sp_mat>(20, 100, 0.1);
+  for (const string& compression : CompressionExtensions())
+  {
+    for (const string& format : { "csv", "txt", "bin" })
+    {
+      const string filename = "test_file." + format + compression;
+      BOOST_REQUIRE(data::Save(filename, dataset) == true);
+
+      arma::mat test;
+      BOOST_REQUIRE(data::Load(filename, test) == true);
+      BOOST_REQUIRE_EQUAL(test.n_rows, dataset.n_rows);
+      BOOST_REQUIRE_EQUAL(test.n_cols, dataset.n_cols);
+      for (size_t i = 0; i < dataset.n_elem; ++i)
+        BOOST_REQUIRE_CLOSE(test[i], dataset[i], 1e-3);
+
+      remove(filename.c_str());
+    }
+
+    const string filename = "test_file.bin" + compression;
+    BOOST_REQUIRE(data::Save(filename, sparse) == true);
+    arma::sp_mat test;
+    BOOST_REQUIRE(data::Load(filename, test) == true);
+    CheckMatrices(arma::mat(test), arma::mat(sparse));
+    remove(filename.c_str());
+  }
+}
+
+/**
+ * Load a compressed CSV file with categorical data, and make sure truncated
+ * files and formats that cannot be compressed give errors.
+ */
+BOOST_AUTO_TEST_CASE(LoadCompressedCategoricalCSVTest)
+{
+  fstream f;
+  f.open("test_file.csv", fstream::out);
+  for (size_t i = 0; i < 1000; ++i)
+    f << i << ", cat" << (i % 7) << ", " << (2 * i) << endl;
+  f.close();
+
+  arma::mat dataset;
+  data::DatasetInfo info;
+  BOOST_REQUIRE(data::Load("test_file.csv", dataset, info) == true);
+  remove("test_file.csv");
+
+  for (const string& compression : CompressionExtensions())
+  {
+    // Write the same file compressed.
+    const string filename = "test_file.csv" + compression;
+    {
+      data::CompressedOutputStream stream(filename,
+          data::FileCompression(filename));
+      BOOST_REQUIRE(stream.is_open());
+      for (size_t i = 0; i < 1000; ++i)
+        stream << i << ", cat" << (i % 7) << ", " << (2 * i) << endl;
+    }
+
+    arma::mat test;
+    data::DatasetInfo testInfo;
+    BOOST_REQUIRE(data::Load(filename, test, testInfo) == true);
+    CheckMatrices(test, dataset);
+    BOOST_REQUIRE(testInfo.Type(1) == data::Datatype::categorical);
+    BOOST_REQUIRE_EQUAL(testInfo.NumMappings(1), 7);
+    BOOST_REQUIRE_EQUAL(testInfo.UnmapString(test(1, 3), 1), "cat3");
+
+    // A truncated file is an error.
+    ifstream in(filename, ios::binary);
+    string contents((istreambuf_iterator<char>(in)),
+        istreambuf_iterator<char>());
+    in.close();
+    ofstream out(filename, ios::binary);
+    out.write(contents.data(), contents.size() / 2);
+    out.close();
+    BOOST_REQUIRE(data::Load(filename, test) == false);
+    BOOST_REQUIRE(data::Load(filename, test, testInfo) == false);
+    remove(filename.c_str());
+
+    // The mlpack binary dataset format cannot be compressed.
+    BOOST_REQUIRE(data::Save("test_file.mlb" + compression, dataset) ==
+        false);
+  }
+}
+
+#ifdef HAS_PARQUET
+
+/**
+ * Load a Parquet file with several row groups, with and without selecting
+ * columns.
+ */
+BOOST_AUTO_TEST_CASE(LoadParquetTest)
+{
+  arrow::DoubleBuilder xBuilder;
+  arrow::Int64Builder yBuilder;
+  arrow::StringBuilder cBuilder;
+  std::shared_ptr<arrow::Array> x, y, c;
+  PARQUET_THROW_NOT_OK(xBuilder.AppendValues({ 1.5, 2.5, 3.5, 4.5, 5.5 }));
+  PARQUET_THROW_NOT_OK(yBuilder.AppendValues({ 1, 2, 3, 4, 5 }));
+  PARQUET_THROW_NOT_OK(cBuilder.AppendValues({ "a", "b", "a", "c", "b" }));
+  PARQUET_THROW_NOT_OK(xBuilder.Finish(&x));
+  PARQUET_THROW_NOT_OK(yBuilder.Finish(&y));
+  PARQUET_THROW_NOT_OK(cBuilder.Finish(&c));
+
+  std::shared_ptr<arrow::Schema> schema = arrow::schema({
+      arrow::field("x", arrow::float64()),
+      arrow::field("y", arrow::int64()),
+      arrow::field("c", arrow::utf8()) });
+  std::shared_ptr<arrow::Table> table = arrow::Table::Make(schema,
+      { x, y, c });
+
+  // Write two points per row group.
+  std::shared_ptr<arrow::io::FileOutputStream> file;
+  PARQUET_ASSIGN_OR_THROW(file,
+      arrow::io::FileOutputStream::Open("test_file.parquet"));
+  PARQUET_THROW_NOT_OK(parquet::arrow::WriteTable(*table,
+      arrow::default_memory_pool(), file, 2));
+  PARQUET_THROW_NOT_OK(file->Close());
+
+  // The categorical column needs a DatasetInfo.
+  arma::mat test;
+  BOOST_REQUIRE(data::Load("test_file.parquet", test) == false);
+
+  data::DatasetInfo info;
+  BOOST_REQUIRE(data::Load("test_file.parquet", test, info) == true);
+  BOOST_REQUIRE_EQUAL(test.n_rows, 3);
+  BOOST_REQUIRE_EQUAL(test.n_cols, 5);
+  BOOST_REQUIRE(info.Type(0) == data::Datatype::numeric);
+  BOOST_REQUIRE(info.Type(1) == data::Datatype::numeric);
+  BOOST_REQUIRE(info.Type(2) == data::Datatype::categorical);
+  BOOST_REQUIRE_EQUAL(info.NumMappings(2), 3);
+  for (size_t i = 0; i < 5; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(test(0, i), 1.5 + i, 1e-5);
+    BOOST_REQUIRE_CLOSE(test(1, i), 1.0 + i, 1e-5);
+  }
+  // The mappings follow the order of the points.
+  BOOST_REQUIRE_EQUAL(test(2, 0), 0);
+  BOOST_REQUIRE_EQUAL(test(2, 1), 1);
+  BOOST_REQUIRE_EQUAL(test(2, 2), 0);
+  BOOST_REQUIRE_EQUAL(test(2, 3), 2);
+  BOOST_REQUIRE_EQUAL(test(2, 4), 1);
+
+  // Select the columns, in a different order.
+  data::DatasetInfo projectedInfo;
+  data::LoadParquet("test_file.parquet", test, projectedInfo, { "c", "x" });
+  BOOST_REQUIRE_EQUAL(test.n_rows, 2);
+  BOOST_REQUIRE_EQUAL(test.n_cols, 5);
+  BOOST_REQUIRE(projectedInfo.Type(0) == data::Datatype::categorical);
+  BOOST_REQUIRE(projectedInfo.Type(1) == data::Datatype::numeric);
+  BOOST_REQUIRE_EQUAL(projectedInfo.UnmapString(test(0, 3), 0), "c");
+  BOOST_REQUIRE_CLOSE(test(1, 3), 4.5, 1e-5);
+
+  // Load a single numeric column.
+  data::DatasetInfo numericInfo;
+  data::LoadParquet("test_file.parquet", test, numericInfo, { "y" });
+  BOOST_REQUIRE_EQUAL(test.n_rows, 1);
+  BOOST_REQUIRE_CLOSE(test(0, 4), 5.0, 1e-5);
+
+  // Unknown columns and mismatched DatasetInfo objects are errors.
+  BOOST_REQUIRE_THROW(data::LoadParquet("test_file.parquet", test,
+      numericInfo, { "z" }), std::runtime_error);
+  BOOST_REQUIRE_THROW(data::LoadParquet("test_file.parquet", test,
+      numericInfo, { "x", "y" }), std::invalid_argument);
+
+  remove("test_file.parquet");
+}
+
+#endif // HAS_PARQUET.
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -30,7 +30,11 @@
 #include <mlpack/methods/ann/loss_functions/hinge_embedding_loss.hpp>
 #include <mlpack/methods/ann/loss_functions/cosine_embedding_loss.hpp>
 #include <mlpack/methods/ann/loss_functions/l1_loss.hpp>
+#include <mlpack/methods/ann/loss_functions/softmax_cross_entropy.hpp>
+#include <mlpack/methods/ann/loss_functions/sampled_softmax.hpp>
+#include <mlpack/methods/ann/loss_functions/hierarchical_softmax.hpp>
 #include <mlpack/methods/ann/init_rules/nguyen_widrow_init.hpp>
+#include <mlpack/methods/ann/init_rules/const_init.hpp>
 #include <mlpack/methods/ann/ffn.hpp>
 
 #include <boost/test/unit_test.hpp>
@@ -748,4 +752,253 @@ BOOST_AUTO_TEST_CASE(MarginRankingLossTest)
       "-0.753830 1.336900 0.000000 0.000000 -0.207000 0.328810"), 1e-6);
 }
 
+/**
+ * Make sure that the softmax cross entropy gives the same loss and gradient as
+ * a LogSoftMax layer followed by the negative log likelihood.
+ */
+BOOST_AUTO_TEST_CASE(SoftmaxCrossEntropyTest)
+{
+  arma::mat input = arma::randn(10, 7);
+  arma::mat target("1 10 3 3 5 2 8");
+
+  // The log-softmax of each column, computed directly.
+  arma::mat logProbs = input;
+  for (size_t i = 0; i < input.n_cols; ++i)
+  {
+    logProbs.col(i) -= std::log(arma::accu(arma::exp(input.col(i))));
+  }
+
+  SoftmaxCrossEntropy<> module;
+  NegativeLogLikelihood<> nll;
+  const double loss = module.Forward(input, target);
+  BOOST_REQUIRE_CLOSE(loss, nll.Forward(logProbs, target), 1e-8);
+
+  // The gradient of the log-softmax layer is exp(logProbs) plus the gradient
+  // of the negative log likelihood.
+  arma::mat output, nllGradient;
+  module.Backward(input, target, output);
+  nll.Backward(logProbs, target, nllGradient);
+  CheckMatrices(output, arma::exp(logProbs) + nllGradient, 1e-8);
+
+  // Large scores don't overflow.
+  input *= 1000;
+  BOOST_REQUIRE(std::isfinite(module.Forward(input, target)));
+  module.Backward(input, target, output);
+  BOOST_REQUIRE(output.is_finite());
+  BOOST_REQUIRE_SMALL(arma::accu(arma::abs(arma::sum(output))), 1e-8);
+}
+
+/**
+ * Check the gradients of the sampled softmax with respect to the input and to
+ * the weights of a target class against numerical gradients computed with the
+ * same sampled classes, and check that Predict() gives probabilities.
+ */
+BOOST_AUTO_TEST_CASE(SampledSoftmaxTest)
+{
+  const size_t inSize = 5;
+  const size_t numClasses = 50;
+  arma::mat input = arma::randn(inSize, 4);
+  arma::mat target("1 17 50 3");
+
+  // A step size of 1 makes the change of the weights equal to their gradient.
+  SampledSoftmax<> module(inSize, numClasses, 10, LazySGDUpdate(1.0));
+  const double eps = 1e-6;
+
+  arma::mat numericGradient(input.n_rows, input.n_cols);
+  for (size_t i = 0; i < input.n_elem; ++i)
+  {
+    const double x = input[i];
+    input[i] = x + eps;
+    math::RandomSeed(42);
+    const double lossPlus = module.Forward(input, target);
+    input[i] = x - eps;
+    math::RandomSeed(42);
+    const double lossMinus = module.Forward(input, target);
+    input[i] = x;
+
+    numericGradient[i] = (lossPlus - lossMinus) / (2 * eps);
+  }
+
+  arma::vec numericWeightsGradient(inSize + 1);
+  for (size_t i = 0; i <= inSize; ++i)
+  {
+    const double w = module.Weights()(i, 16);
+    module.Weights()(i, 16) = w + eps;
+    math::RandomSeed(42);
+    const double lossPlus = module.Forward(input, target);
+    module.Weights()(i, 16) = w - eps;
+    math::RandomSeed(42);
+    const double lossMinus = module.Forward(input, target);
+    module.Weights()(i, 16) = w;
+
+    numericWeightsGradient[i] = (lossPlus - lossMinus) / (2 * eps);
+  }
+
+  math::RandomSeed(42);
+  const double loss = module.Forward(input, target);
+  BOOST_REQUIRE(std::isfinite(loss));
+  BOOST_REQUIRE_GT(loss, 0);
+  BOOST_REQUIRE_EQUAL(module.Sampled().n_elem, 10);
+  BOOST_REQUIRE_LT(module.Sampled().max(), numClasses);
+
+  const arma::mat weights = module.Weights();
+  arma::mat output;
+  module.Backward(input, target, output);
+  CheckMatrices(output, numericGradient, 1e-2);
+
+  // Backward() only accumulates the gradient of the weights; Step() applies
+  // it once.
+  CheckMatrices(module.Weights(), weights);
+  const arma::uvec column16 = arma::find(module.SparseIndices() == 16);
+  BOOST_REQUIRE_EQUAL(column16.n_elem, 1);
+  CheckMatrices(module.SparseGradient().col(column16[0]),
+      numericWeightsGradient, 1e-2);
+
+  module.Step();
+  BOOST_REQUIRE_EQUAL(module.SparseIndices().n_elem, 0);
+  CheckMatrices(weights.col(16) - module.Weights().col(16),
+      numericWeightsGradient, 1e-2);
+  const arma::mat stepWeights = module.Weights();
+  module.Step();
+  CheckMatrices(module.Weights(), stepWeights);
+
+  // Only the columns of the target and sampled classes change.
+  arma::uvec used = arma::join_cols(module.Sampled(),
+      arma::conv_to<arma::uvec>::from(target.t() - 1));
+  for (size_t c = 0; c < numClasses; ++c)
+  {
+    if (arma::any(used == c))
+      continue;
+
+    CheckMatrices(weights.col(c), module.Weights().col(c));
+  }
+
+  arma::mat probabilities;
+  module.Predict(input, probabilities);
+  BOOST_REQUIRE_EQUAL(probabilities.n_rows, numClasses);
+  BOOST_REQUIRE_EQUAL(probabilities.n_cols, input.n_cols);
+  CheckMatrices(arma::sum(probabilities), arma::ones<arma::rowvec>(4));
+}
+
+/**
+ * Check that the hierarchical softmax is a distribution over all the classes
+ * whose negative log-likelihood is the loss, and check its gradients against
+ * numerical gradients.
+ */
+BOOST_AUTO_TEST_CASE(HierarchicalSoftmaxTest)
+{
+  const size_t inSize = 5;
+  const size_t numClasses = 23;
+  arma::mat input = arma::randn(inSize, 4);
+  arma::mat target("1 12 23 13");
+
+  HierarchicalSoftmax<> module(inSize, numClasses, 0, LazySGDUpdate(1.0));
+  BOOST_REQUIRE_EQUAL(module.NumClusters(), 5);
+  BOOST_REQUIRE_EQUAL(module.Cluster(22), 4);
+
+  // The loss is the negative log-likelihood of the targets.
+  arma::mat probabilities;
+  module.Predict(input, probabilities);
+  BOOST_REQUIRE_EQUAL(probabilities.n_rows, numClasses);
+  CheckMatrices(arma::sum(probabilities), arma::ones<arma::rowvec>(4));
+
+  double expectedLoss = 0;
+  for (size_t i = 0; i < input.n_cols; ++i)
+    expectedLoss -= std::log(probabilities((size_t) target(i) - 1, i));
+  BOOST_REQUIRE_CLOSE(module.Forward(input, target), expectedLoss, 1e-8);
+
+  const double eps = 1e-6;
+  arma::mat numericGradient(input.n_rows, input.n_cols);
+  for (size_t i = 0; i < input.n_elem; ++i)
+  {
+    const double x = input[i];
+    input[i] = x + eps;
+    const double lossPlus = module.Forward(input, target);
+    input[i] = x - eps;
+    const double lossMinus = module.Forward(input, target);
+    input[i] = x;
+
+    numericGradient[i] = (lossPlus - lossMinus) / (2 * eps);
+  }
+
+  // The gradients of the weights of the cluster and of the class of the second
+  // target.
+  arma::vec numericClusterGradient(inSize + 1);
+  arma::vec numericClassGradient(inSize + 1);
+  for (size_t i = 0; i <= inSize; ++i)
+  {
+    double& w = module.ClusterWeights()(i, 2);
+    const double wOld = w;
+    w = wOld + eps;
+    const double lossPlus = module.Forward(input, target);
+    w = wOld - eps;
+    const double lossMinus = module.Forward(input, target);
+    w = wOld;
+    numericClusterGradient[i] = (lossPlus - lossMinus) / (2 * eps);
+
+    double& v = module.ClassWeights()(i, 11);
+    const double vOld = v;
+    v = vOld + eps;
+    const double classLossPlus = module.Forward(input, target);
+    v = vOld - eps;
+    const double classLossMinus = module.Forward(input, target);
+    v = vOld;
+    numericClassGradient[i] = (classLossPlus - classLossMinus) / (2 * eps);
+  }
+
+  const arma::mat clusterWeights = module.ClusterWeights();
+  const arma::mat classWeights = module.ClassWeights();
+  arma::mat output;
+  module.Backward(input, target, output);
+  CheckMatrices(output, numericGradient, 1e-2);
+
+  // Backward() only accumulates the gradient of the weights.
+  CheckMatrices(module.ClusterWeights(), clusterWeights);
+  CheckMatrices(module.ClassWeights(), classWeights);
+  CheckMatrices(module.ClusterGradient().col(2), numericClusterGradient,
+      1e-2);
+
+  module.Step();
+  BOOST_REQUIRE_EQUAL(module.ClassIndices().n_elem, 0);
+  CheckMatrices(clusterWeights.col(2) - module.ClusterWeights().col(2),
+      numericClusterGradient, 1e-2);
+  CheckMatrices(classWeights.col(11) - module.ClassWeights().col(11),
+      numericClassGradient, 1e-2);
+
+  // The classes of the clusters without a target don't change.
+  CheckMatrices(classWeights.cols(5, 9), module.ClassWeights().cols(5, 9));
+  CheckMatrices(classWeights.cols(15, 19), module.ClassWeights().cols(15, 19));
+}
+
+/**
+ * Check that a network initializes the weights of a hierarchical softmax output
+ * layer with its own rule, and that Train() updates them.
+ */
+BOOST_AUTO_TEST_CASE(HierarchicalSoftmaxFFNTest)
+{
+  arma::mat data = arma::randn(3, 100);
+  arma::mat labels(1, data.n_cols);
+  for (size_t i = 0; i < data.n_cols; ++i)
+    labels(i) = (data(0, i) > 0) ? 1 : 9;
+
+  FFN<HierarchicalSoftmax<>, ConstInitialization> model(
+      HierarchicalSoftmax<>(4, 9), ConstInitialization(0.5));
+  model.Add<Linear<>>(3, 4);
+
+  model.ResetParameters();
+  const HierarchicalSoftmax<>& outputLayer = model.OutputLayer();
+  CheckMatrices(outputLayer.ClassWeights().head_rows(4),
+      arma::mat(4, 9).fill(0.5));
+  CheckMatrices(outputLayer.ClassWeights().row(4), arma::zeros(1, 9));
+
+  ens::StandardSGD optimizer(0.01, 10, 500);
+  model.Train(data, labels, optimizer);
+
+  // The weights of the classes that are targets changed, and the gradient was
+  // applied.
+  BOOST_REQUIRE_GT(arma::abs(outputLayer.ClassWeights().col(0) -
+      arma::join_cols(arma::vec(4).fill(0.5), arma::zeros(1))).max(), 1e-3);
+  BOOST_REQUIRE_EQUAL(outputLayer.ClassIndices().n_elem, 0);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -622,6 +622,119 @@ BOOST_AUTO_TEST_CASE(MultiprobeDeterministicTest)
       (neighbors.col(0) >= N / 4) && (neighbors.col(0) < N / 2)));
 }
 
+/**
+ * Test: query-directed multiprobe LSH with a growing probe budget should never
+ * lower recall, and should increase it at least a little.
+ */
+BOOST_AUTO_TEST_CASE(MultiprobeBudgetTest)
+{
+  // Test parameters.
+  const double epsilonIncrease = 0.01;
+  const size_t repetitions = 5; // Train five objects.
+
+  const size_t budgetTrials = 5;
+  const size_t probeBudgets[budgetTrials] = {0, 2, 4, 8, 16};
+
+  // Algorithm parameters.  Far fewer tables than MultiprobeTest.
+  const int k = 4;
+  const int numTables = 4;
+  const int numProj = 3;
+  const double hashWidth = 0;
+  const int secondHashSize = 99901;
+  const int bucketSize = 500;
+
+  const string trainSet = "iris_train.csv";
+  const string testSet = "iris_test.csv";
+  arma::mat rdata;
+  arma::mat qdata;
+  data::Load(trainSet, rdata, true);
+  data::Load(testSet, qdata, true);
+
+  // Add a slight amount of noise to the dataset, so that we don't end up with
+  // points that have the same distance (hopefully).
+  rdata += 0.0001 * arma::randn<arma::mat>(rdata.n_rows, rdata.n_cols);
+  qdata += 0.0001 * arma::randn<arma::mat>(qdata.n_rows, qdata.n_cols);
+
+  // Run classic knn on reference set.
+  KNN knn(rdata);
+  arma::Mat<size_t> groundTruth;
+  arma::mat groundDistances;
+  knn.Search(qdata, k, groundTruth, groundDistances);
+
+  bool foundIncrease = 0;
+
+  for (size_t rep = 0; rep < repetitions; ++rep)
+  {
+    // Train a model.
+    LSHSearch<> multiprobeTest(rdata, numProj, numTables, hashWidth,
+        secondHashSize, bucketSize);
+
+    double prevRecall = 0;
+    // Search with varying probe budgets.
+    for (size_t p = 0; p < budgetTrials; ++p)
+    {
+      arma::Mat<size_t> lshNeighbors;
+      arma::mat lshDistances;
+
+      multiprobeTest.Search(qdata, k, lshNeighbors, lshDistances, 0, 0,
+          probeBudgets[p]);
+
+      // Compute recall of this run.
+      double recall = LSHSearch<>::ComputeRecall(lshNeighbors, groundTruth);
+      if (p > 0)
+      {
+        // A larger budget should at the very least not lower recall...
+        BOOST_REQUIRE_GE(recall, prevRecall);
+
+        // ... and should ideally increase it a bit.
+        if (recall > prevRecall + epsilonIncrease)
+          foundIncrease = true;
+      }
+      prevRecall = recall;
+    }
+  }
+  BOOST_REQUIRE(foundIncrease);
+}
+
+/**
+ * Test: a probe budget large enough to cover every additional bin of every
+ * table probes exactly the same bins as the maximum number of probes per
+ * table, so the results must be identical.
+ */
+BOOST_AUTO_TEST_CASE(MultiprobeBudgetMaximumTest)
+{
+  const int k = 4;
+  const int numTables = 4;
+  const int numProj = 3;
+  const size_t maxProbes = (1 << numProj) - 1;
+
+  arma::mat rdata;
+  arma::mat qdata;
+  data::Load("iris_train.csv", rdata, true);
+  data::Load("iris_test.csv", qdata, true);
+
+  LSHSearch<> lsh(rdata, numProj, numTables);
+
+  arma::Mat<size_t> probeNeighbors, budgetNeighbors;
+  arma::mat probeDistances, budgetDistances;
+  lsh.Search(qdata, k, probeNeighbors, probeDistances, 0, maxProbes);
+  lsh.Search(qdata, k, budgetNeighbors, budgetDistances, 0, 0,
+      numTables * maxProbes);
+
+  CheckMatrices(probeNeighbors, budgetNeighbors);
+  CheckMatrices(probeDistances, budgetDistances);
+
+  // With a single table, a budget of T is the same as T probes per table.
+  for (size_t t = 1; t <= maxProbes; ++t)
+  {
+    lsh.Search(qdata, k, probeNeighbors, probeDistances, 1, t);
+    lsh.Search(qdata, k, budgetNeighbors, budgetDistances, 1, 0, t);
+
+    CheckMatrices(probeNeighbors, budgetNeighbors);
+    CheckMatrices(probeDistances, budgetDistances);
+  }
+}
+
 BOOST_AUTO_TEST_CASE(LSHTrainTest)
 {
   // This is a not very good test that simply checks that the re-trained LSH
@@ -844,8 +957,78 @@ BOOST_AUTO_TEST_CASE(ParallelMonochromatic)
       sequentialNeighbors, parallelNeighbors);
   BOOST_REQUIRE_EQUAL(recall, 1);
 }
+
+/**
+ * Test: This test verifies that building the hash tables in parallel gives
+ * the same tables as building them with one thread.
+ */
+BOOST_AUTO_TEST_CASE(ParallelTrain)
+{
+  const int numTables = 16;
+  const int numProj = 3;
+
+  arma::mat rdata;
+  data::Load("iris_train.csv", rdata, true);
+
+  // Build the tables with the maximum number of available threads.
+  math::RandomSeed(1234);
+  LSHSearch<> parallelLSH(rdata, numProj, numTables, 1.0);
+
+  // Now build the same tables with 1 thread.
+  size_t prevNumThreads = omp_get_max_threads();
+  omp_set_num_threads(1);
+  math::RandomSeed(1234);
+  LSHSearch<> sequentialLSH(rdata, numProj, numTables, 1.0);
+  omp_set_num_threads(prevNumThreads);
+
+  CheckMatrices(parallelLSH.BucketOffsets(), sequentialLSH.BucketOffsets());
+  CheckMatrices(parallelLSH.BucketIndices(), sequentialLSH.BucketIndices());
+}
 #endif
 
+/**
+ * Test: the second hash table holds each point once per table when no bucket
+ * is full, and no row holds more than bucketSize points.
+ */
+BOOST_AUTO_TEST_CASE(BucketStorageTest)
+{
+  const size_t numTables = 8;
+  const size_t numProj = 2;
+
+  arma::mat rdata = arma::randu<arma::mat>(4, 500);
+
+  // The buckets are large enough to hold every point.
+  LSHSearch<> lsh(rdata, numProj, numTables, 0.0, 99901, 0);
+
+  const arma::Col<size_t>& offsets = lsh.BucketOffsets();
+  const arma::Col<size_t>& indices = lsh.BucketIndices();
+  BOOST_REQUIRE_GT(offsets.n_elem, 1);
+  BOOST_REQUIRE_EQUAL(offsets[0], 0);
+  BOOST_REQUIRE_EQUAL(offsets[offsets.n_elem - 1], indices.n_elem);
+  BOOST_REQUIRE_EQUAL(indices.n_elem, numTables * rdata.n_cols);
+
+  arma::Col<size_t> counts(rdata.n_cols, arma::fill::zeros);
+  for (size_t i = 0; i < indices.n_elem; ++i)
+  {
+    BOOST_REQUIRE_LT(indices[i], rdata.n_cols);
+    counts[indices[i]]++;
+  }
+  BOOST_REQUIRE(arma::all(counts == numTables));
+
+  // Now limit the bucket size.
+  const size_t bucketSize = 3;
+  LSHSearch<> smallLSH(rdata, numProj, numTables, 0.0, 99901, bucketSize);
+
+  const arma::Col<size_t>& smallOffsets = smallLSH.BucketOffsets();
+  BOOST_REQUIRE_EQUAL(smallOffsets[smallOffsets.n_elem - 1],
+      smallLSH.BucketIndices().n_elem);
+  for (size_t r = 0; r + 1 < smallOffsets.n_elem; ++r)
+  {
+    BOOST_REQUIRE_GT(smallOffsets[r + 1], smallOffsets[r]);
+    BOOST_REQUIRE_LE(smallOffsets[r + 1] - smallOffsets[r], bucketSize);
+  }
+}
+
 // Test the copy constructor and the copy operator.
 BOOST_AUTO_TEST_CASE(CopyConstructorAndOperatorTest)
 {
@@ -564,4 +564,51 @@ BOOST_AUTO_TEST_CASE(GmmTrainDiagCovariance)
   }
 }
 
+// Ensure that online EM trains a valid model.
+BOOST_AUTO_TEST_CASE(GmmTrainOnlineTest)
+{
+  arma::mat inputData(5, 100, arma::fill::randu);
+
+  SetInputParam("input", std::move(inputData));
+  SetInputParam("gaussians", (int) 2);
+  SetInputParam("online", true);
+  SetInputParam("batch_size", (int) 20);
+  SetInputParam("max_iterations", (int) 3);
+
+  mlpackMain();
+
+  GMM* gmm = CLI::GetParam<GMM*>("output_model");
+  BOOST_REQUIRE_EQUAL(gmm->Gaussians(), 2);
+  BOOST_REQUIRE_CLOSE(arma::accu(gmm->Weights()), 1.0, 1e-5);
+  for (size_t i = 0; i < gmm->Gaussians(); ++i)
+    BOOST_REQUIRE_EQUAL(gmm->Component(i).Mean().n_elem, 5);
+}
+
+// Ensure that the batch size and step decay of online EM are checked.
+BOOST_AUTO_TEST_CASE(GmmTrainOnlineInvalidParametersTest)
+{
+  arma::mat inputData(5, 100, arma::fill::randu);
+
+  SetInputParam("input", inputData);
+  SetInputParam("gaussians", (int) 2);
+  SetInputParam("online", true);
+  SetInputParam("batch_size", (int) 0); // Invalid.
+
+  Log::Fatal.ignoreInput = true;
+  BOOST_REQUIRE_THROW(mlpackMain(), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+
+  bindings::tests::CleanMemory();
+  ResetGmmTrainSetting();
+
+  SetInputParam("input", std::move(inputData));
+  SetInputParam("gaussians", (int) 2);
+  SetInputParam("online", true);
+  SetInputParam("step_decay", 0.3); // Invalid.
+
+  Log::Fatal.ignoreInput = true;
+  BOOST_REQUIRE_THROW(mlpackMain(), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+}
+
 BOOST_AUTO_TEST_SUITE_END();
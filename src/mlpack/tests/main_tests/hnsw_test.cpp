@@ -0,0 +1,124 @@
+/**
+ * @file tests/main_tests/hnsw_test.cpp
+ *
+ * Test mlpackMain() of hnsw_main.cpp.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <string>
+
+#define BINDING_TYPE BINDING_TYPE_TEST
+static const std::string testName = "HNSW";
+
+#include <mlpack/core.hpp>
+#include <mlpack/core/util/mlpack_main.hpp>
+#include "test_helper.hpp"
+#include <mlpack/methods/hnsw/hnsw_main.cpp>
+
+#include <boost/test/unit_test.hpp>
+#include "../test_tools.hpp"
+
+using namespace mlpack;
+
+struct HNSWTestFixture
+{
+ public:
+  HNSWTestFixture()
+  {
+    // Cache in the options for this program.
+    CLI::RestoreSettings(testName);
+  }
+
+  ~HNSWTestFixture()
+  {
+    // Clear the settings.
+    bindings::tests::CleanMemory();
+    CLI::ClearSettings();
+  }
+};
+
+BOOST_FIXTURE_TEST_SUITE(HNSWMainTest, HNSWTestFixture);
+
+/**
+ * Check that output neighbors and distances have valid dimensions.
+ */
+BOOST_AUTO_TEST_CASE(HNSWOutputDimensionTest)
+{
+  arma::mat reference = arma::randu<arma::mat>(5, 100);
+
+  SetInputParam("reference", std::move(reference));
+  SetInputParam("k", (int) 6);
+
+  mlpackMain();
+
+  BOOST_REQUIRE_EQUAL(CLI::GetParam<arma::Mat<size_t>>("neighbors").n_rows, 6);
+  BOOST_REQUIRE_EQUAL(CLI::GetParam<arma::Mat<size_t>>("neighbors").n_cols,
+                      100);
+  BOOST_REQUIRE_EQUAL(CLI::GetParam<arma::mat>("distances").n_rows, 6);
+  BOOST_REQUIRE_EQUAL(CLI::GetParam<arma::mat>("distances").n_cols, 100);
+}
+
+/**
+ * Ensure that invalid parameters are rejected.
+ */
+BOOST_AUTO_TEST_CASE(HNSWParamValidityTest)
+{
+  arma::mat reference = arma::randu<arma::mat>(5, 100);
+
+  SetInputParam("reference", reference);
+  SetInputParam("k", (int) 6);
+  SetInputParam("max_connections", (int) 1);
+
+  Log::Fatal.ignoreInput = true;
+  BOOST_REQUIRE_THROW(mlpackMain(), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+
+  bindings::tests::CleanMemory();
+
+  SetInputParam("reference", std::move(reference));
+  SetInputParam("k", (int) 6);
+  SetInputParam("ef", (int) -1);
+
+  Log::Fatal.ignoreInput = true;
+  BOOST_REQUIRE_THROW(mlpackMain(), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+}
+
+/**
+ * Check that a saved model can be searched with a query set, and that the
+ * true neighbors must have the size of the neighbors found.
+ */
+BOOST_AUTO_TEST_CASE(HNSWModelReuseTest)
+{
+  arma::mat reference = arma::randu<arma::mat>(5, 200);
+  arma::mat query = arma::randu<arma::mat>(5, 20);
+
+  SetInputParam("reference", std::move(reference));
+  mlpackMain();
+
+  HNSWSearch<>* model = CLI::GetParam<HNSWSearch<>*>("output_model");
+  CLI::GetSingleton().Parameters()["reference"].wasPassed = false;
+
+  SetInputParam("input_model", model);
+  SetInputParam("query", query);
+  SetInputParam("k", (int) 4);
+  SetInputParam("ef", (int) 50);
+  SetInputParam("true_neighbors", arma::Mat<size_t>(4, 20, arma::fill::zeros));
+
+  mlpackMain();
+
+  BOOST_REQUIRE_EQUAL(CLI::GetParam<arma::Mat<size_t>>("neighbors").n_rows, 4);
+  BOOST_REQUIRE_EQUAL(CLI::GetParam<arma::Mat<size_t>>("neighbors").n_cols,
+                      20);
+
+  SetInputParam("true_neighbors", arma::Mat<size_t>(3, 20, arma::fill::zeros));
+
+  Log::Fatal.ignoreInput = true;
+  BOOST_REQUIRE_THROW(mlpackMain(), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+}
+
+BOOST_AUTO_TEST_SUITE_END();
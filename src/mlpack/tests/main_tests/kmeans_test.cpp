@@ -153,6 +153,38 @@ BOOST_AUTO_TEST_CASE(KmClusteringSizeCheck)
   BOOST_REQUIRE_EQUAL(CLI::GetParam<arma::mat>("centroid").n_cols, c);
 }
 
+/**
+ * Checking that size and dimensionality of prediction is correct with the
+ * k-means++ and k-means|| initial point strategies.
+ */
+BOOST_AUTO_TEST_CASE(KmClusteringSizeCheckKMeansPlusPlus)
+{
+  int c = 2;
+  arma::mat inputData;
+  if (!data::Load("vc2.csv", inputData))
+    BOOST_FAIL("Unable to load train dataset vc2.csv!");
+
+  size_t col = inputData.n_cols;
+  size_t row = inputData.n_rows;
+
+  const std::string flags[] = { "kmeans_plus_plus", "kmeans_parallel" };
+  for (size_t i = 0; i < 2; ++i)
+  {
+    SetInputParam("input", inputData);
+    SetInputParam("clusters", c);
+    SetInputParam(flags[i], true);
+
+    mlpackMain();
+
+    BOOST_REQUIRE_EQUAL(CLI::GetParam<arma::mat>("output").n_rows, row+1);
+    BOOST_REQUIRE_EQUAL(CLI::GetParam<arma::mat>("output").n_cols, col);
+    BOOST_REQUIRE_EQUAL(CLI::GetParam<arma::mat>("centroid").n_rows, row);
+    BOOST_REQUIRE_EQUAL(CLI::GetParam<arma::mat>("centroid").n_cols, c);
+
+    ResetKmSettings();
+  }
+}
+
 /**
  * Checking that size and dimensionality of prediction is correct when --labels_only is specified
  */
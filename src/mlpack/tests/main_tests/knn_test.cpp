@@ -536,8 +536,8 @@ BOOST_AUTO_TEST_CASE(KNNTrueNeighborDistanceTest)
  */
 BOOST_AUTO_TEST_CASE(KNNAllAlgorithmsTest)
 {
-  string algorithms[] = {"dual_tree", "naive", "single_tree"};
-  const int nofalgorithms = 3;
+  string algorithms[] = {"dual_tree", "naive", "single_tree", "brute_force"};
+  const int nofalgorithms = 4;
 
   arma::mat referenceData;
   referenceData.randu(3, 100); // 100 points in 3 dimensions.
@@ -266,6 +266,41 @@ BOOST_AUTO_TEST_CASE(LSHDiffNumProbesTest)
       CLI::GetParam<arma::mat>("distances")), distances.n_elem);
 }
 
+/**
+ * Check learning process using different probe_budget.
+ */
+BOOST_AUTO_TEST_CASE(LSHDiffProbeBudgetTest)
+{
+  arma::mat reference = arma::randu<arma::mat>(5, 100);
+  arma::mat query = arma::randu<arma::mat>(5, 40);
+
+  SetInputParam("reference", std::move(reference));
+  SetInputParam("query", query);
+  SetInputParam("k", (int) 6);
+
+  mlpackMain();
+
+  arma::Mat<size_t> neighbors = CLI::GetParam<arma::Mat<size_t>>("neighbors");
+  arma::mat distances = CLI::GetParam<arma::mat>("distances");
+
+  CLI::GetSingleton().Parameters()["reference"].wasPassed = false;
+
+  // Search the same model using probe_budget equals to 20.
+
+  SetInputParam("input_model", CLI::GetParam<LSHSearch<>*>("output_model"));
+  SetInputParam("query", std::move(query));
+  SetInputParam("probe_budget", (int) 20);
+
+  mlpackMain();
+
+  // Check that initial outputs and final outputs using two models are
+  // different.
+  BOOST_REQUIRE_LT(arma::accu(neighbors ==
+      CLI::GetParam<arma::Mat<size_t>>("neighbors")), neighbors.n_elem);
+  BOOST_REQUIRE_LT(arma::accu(distances ==
+      CLI::GetParam<arma::mat>("distances")), distances.n_elem);
+}
+
 /**
  * Check learning process using different second_hash_size.
  */
@@ -100,6 +100,57 @@ BOOST_AUTO_TEST_CASE(PCANoVarRetainTest)
   BOOST_REQUIRE_EQUAL(CLI::GetParam<arma::mat>("output").n_cols, 5);
 }
 
+/**
+ * Make sure the incremental decomposition method gives the same projection as
+ * the exact one, up to the signs of the components.
+ */
+BOOST_AUTO_TEST_CASE(PCAIncrementalMethodTest)
+{
+  arma::mat x = arma::randu<arma::mat>(5, 100);
+
+  SetInputParam("input", x);
+  SetInputParam("new_dimensionality", (int) 3);
+
+  mlpackMain();
+
+  const arma::mat exactOutput = CLI::GetParam<arma::mat>("output");
+
+  CLI::GetSingleton().Parameters()["input"].wasPassed = false;
+
+  SetInputParam("input", std::move(x));
+  SetInputParam("decomposition_method", std::string("incremental"));
+  SetInputParam("batch_size", (int) 7);
+
+  mlpackMain();
+
+  const arma::mat& output = CLI::GetParam<arma::mat>("output");
+  BOOST_REQUIRE_EQUAL(output.n_rows, 3);
+  BOOST_REQUIRE_EQUAL(output.n_cols, 100);
+  for (size_t i = 0; i < output.n_rows; ++i)
+  {
+    const double sign = (arma::dot(output.row(i), exactOutput.row(i)) < 0) ?
+        -1.0 : 1.0;
+    for (size_t j = 0; j < output.n_cols; ++j)
+      BOOST_REQUIRE_CLOSE(sign * output(i, j), exactOutput(i, j), 1e-3);
+  }
+}
+
+/**
+ * Make sure an invalid batch size is rejected.
+ */
+BOOST_AUTO_TEST_CASE(PCAInvalidBatchSizeTest)
+{
+  arma::mat x = arma::randu<arma::mat>(5, 5);
+
+  SetInputParam("input", std::move(x));
+  SetInputParam("decomposition_method", std::string("incremental"));
+  SetInputParam("batch_size", (int) 0);
+
+  Log::Fatal.ignoreInput = true;
+  BOOST_REQUIRE_THROW(mlpackMain(), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+}
+
 /**
  * Check that we can't specify an invalid new dimensionality.
  */
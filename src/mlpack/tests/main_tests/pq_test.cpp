@@ -0,0 +1,147 @@
+/**
+ * @file tests/main_tests/pq_test.cpp
+ *
+ * Test mlpackMain() of pq_main.cpp.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <string>
+
+#define BINDING_TYPE BINDING_TYPE_TEST
+static const std::string testName = "PQ";
+
+#include <mlpack/core.hpp>
+#include <mlpack/core/util/mlpack_main.hpp>
+#include "test_helper.hpp"
+#include <mlpack/methods/pq/pq_main.cpp>
+
+#include <boost/test/unit_test.hpp>
+#include "../test_tools.hpp"
+
+using namespace mlpack;
+
+struct PQTestFixture
+{
+ public:
+  PQTestFixture()
+  {
+    // Cache in the options for this program.
+    CLI::RestoreSettings(testName);
+  }
+
+  ~PQTestFixture()
+  {
+    // Clear the settings.
+    bindings::tests::CleanMemory();
+    CLI::ClearSettings();
+  }
+};
+
+BOOST_FIXTURE_TEST_SUITE(PQMainTest, PQTestFixture);
+
+/**
+ * Check that output neighbors and distances have valid dimensions.
+ */
+BOOST_AUTO_TEST_CASE(PQOutputDimensionTest)
+{
+  arma::mat reference = arma::randu<arma::mat>(10, 300);
+
+  SetInputParam("reference", std::move(reference));
+  SetInputParam("k", (int) 6);
+  SetInputParam("subvectors", (int) 5);
+  SetInputParam("centroids", (int) 16);
+
+  mlpackMain();
+
+  BOOST_REQUIRE_EQUAL(CLI::GetParam<arma::Mat<size_t>>("neighbors").n_rows, 6);
+  BOOST_REQUIRE_EQUAL(CLI::GetParam<arma::Mat<size_t>>("neighbors").n_cols,
+                      300);
+  BOOST_REQUIRE_EQUAL(CLI::GetParam<arma::mat>("distances").n_rows, 6);
+  BOOST_REQUIRE_EQUAL(CLI::GetParam<arma::mat>("distances").n_cols, 300);
+}
+
+/**
+ * Ensure that invalid parameters are rejected.
+ */
+BOOST_AUTO_TEST_CASE(PQParamValidityTest)
+{
+  arma::mat reference = arma::randu<arma::mat>(10, 300);
+
+  SetInputParam("reference", reference);
+  SetInputParam("k", (int) 6);
+  SetInputParam("centroids", (int) 300);
+
+  Log::Fatal.ignoreInput = true;
+  BOOST_REQUIRE_THROW(mlpackMain(), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+
+  bindings::tests::CleanMemory();
+
+  SetInputParam("reference", reference);
+  SetInputParam("k", (int) 6);
+  SetInputParam("probes", (int) 0);
+
+  Log::Fatal.ignoreInput = true;
+  BOOST_REQUIRE_THROW(mlpackMain(), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+
+  bindings::tests::CleanMemory();
+
+  // Re-ranking needs the reference set in the model.
+  SetInputParam("reference", std::move(reference));
+  SetInputParam("k", (int) 6);
+  SetInputParam("centroids", (int) 16);
+  SetInputParam("rerank", (int) 20);
+
+  Log::Fatal.ignoreInput = true;
+  BOOST_REQUIRE_THROW(mlpackMain(), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+}
+
+/**
+ * Check that a saved model can be searched with a query set, and that the
+ * true neighbors must have the size of the neighbors found.
+ */
+BOOST_AUTO_TEST_CASE(PQModelReuseTest)
+{
+  arma::mat reference = arma::randu<arma::mat>(8, 400);
+  arma::mat query = arma::randu<arma::mat>(8, 20);
+
+  SetInputParam("reference", std::move(reference));
+  SetInputParam("subvectors", (int) 4);
+  SetInputParam("centroids", (int) 32);
+  SetInputParam("lists", (int) 4);
+  SetInputParam("keep_reference", true);
+  mlpackMain();
+
+  PQSearch<>* model = CLI::GetParam<PQSearch<>*>("output_model");
+  CLI::GetSingleton().Parameters()["reference"].wasPassed = false;
+  CLI::GetSingleton().Parameters()["subvectors"].wasPassed = false;
+  CLI::GetSingleton().Parameters()["centroids"].wasPassed = false;
+  CLI::GetSingleton().Parameters()["lists"].wasPassed = false;
+  CLI::GetSingleton().Parameters()["keep_reference"].wasPassed = false;
+
+  SetInputParam("input_model", model);
+  SetInputParam("query", query);
+  SetInputParam("k", (int) 4);
+  SetInputParam("probes", (int) 2);
+  SetInputParam("rerank", (int) 30);
+  SetInputParam("true_neighbors", arma::Mat<size_t>(4, 20, arma::fill::zeros));
+
+  mlpackMain();
+
+  BOOST_REQUIRE_EQUAL(CLI::GetParam<arma::Mat<size_t>>("neighbors").n_rows, 4);
+  BOOST_REQUIRE_EQUAL(CLI::GetParam<arma::Mat<size_t>>("neighbors").n_cols,
+                      20);
+
+  SetInputParam("true_neighbors", arma::Mat<size_t>(3, 20, arma::fill::zeros));
+
+  Log::Fatal.ignoreInput = true;
+  BOOST_REQUIRE_THROW(mlpackMain(), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+}
+
+BOOST_AUTO_TEST_SUITE_END();
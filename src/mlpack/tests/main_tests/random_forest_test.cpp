@@ -453,4 +453,155 @@ BOOST_AUTO_TEST_CASE(RandomForestDiffMaxDepthTest)
   delete rf3;
 }
 
+/**
+ * Make sure that the trees of the merge model are added to those of the input
+ * model, and that the input model is not modified.
+ */
+BOOST_AUTO_TEST_CASE(RandomForestMergeModelTest)
+{
+  arma::mat inputData;
+  if (!data::Load("vc2.csv", inputData))
+    BOOST_FAIL("Cannot load train dataset vc2.csv!");
+
+  arma::Row<size_t> labels;
+  if (!data::Load("vc2_labels.txt", labels))
+    BOOST_FAIL("Cannot load labels for vc2_labels.txt");
+
+  // Train the two pieces of the forest.
+  SetInputParam("training", inputData);
+  SetInputParam("labels", labels);
+  SetInputParam("num_trees", (int) 3);
+  SetInputParam("seed", (int) 1);
+
+  mlpackMain();
+
+  RandomForestModel* rf1 = CLI::GetParam<RandomForestModel*>("output_model");
+  CLI::GetParam<RandomForestModel*>("output_model") = NULL;
+
+  bindings::tests::CleanMemory();
+
+  SetInputParam("training", inputData);
+  SetInputParam("labels", labels);
+  SetInputParam("num_trees", (int) 4);
+  SetInputParam("seed", (int) 2);
+
+  mlpackMain();
+
+  RandomForestModel* rf2 = CLI::GetParam<RandomForestModel*>("output_model");
+  CLI::GetParam<RandomForestModel*>("output_model") = NULL;
+
+  bindings::tests::CleanMemory();
+
+  // Reset passed parameters.
+  CLI::GetSingleton().Parameters()["training"].wasPassed = false;
+  CLI::GetSingleton().Parameters()["labels"].wasPassed = false;
+  CLI::GetSingleton().Parameters()["num_trees"].wasPassed = false;
+
+  // Now merge them.
+  SetInputParam("input_model", rf1);
+  SetInputParam("merge_model", rf2);
+
+  mlpackMain();
+
+  RandomForestModel* merged =
+      CLI::GetParam<RandomForestModel*>("output_model");
+  BOOST_REQUIRE_EQUAL(merged->rf.NumTrees(), 7);
+  BOOST_REQUIRE_EQUAL(rf1->rf.NumTrees(), 3);
+  BOOST_REQUIRE_EQUAL(rf2->rf.NumTrees(), 4);
+}
+
+/**
+ * Make sure that a merge model can't be given without a model to merge it
+ * into.
+ */
+BOOST_AUTO_TEST_CASE(RandomForestMergeModelOnlyTest)
+{
+  arma::mat inputData;
+  if (!data::Load("vc2.csv", inputData))
+    BOOST_FAIL("Cannot load train dataset vc2.csv!");
+
+  arma::Row<size_t> labels;
+  if (!data::Load("vc2_labels.txt", labels))
+    BOOST_FAIL("Cannot load labels for vc2_labels.txt");
+
+  SetInputParam("training", std::move(inputData));
+  SetInputParam("labels", std::move(labels));
+
+  mlpackMain();
+
+  RandomForestModel* rf = CLI::GetParam<RandomForestModel*>("output_model");
+  CLI::GetParam<RandomForestModel*>("output_model") = NULL;
+
+  bindings::tests::CleanMemory();
+
+  CLI::GetSingleton().Parameters()["training"].wasPassed = false;
+  CLI::GetSingleton().Parameters()["labels"].wasPassed = false;
+
+  SetInputParam("merge_model", rf);
+
+  Log::Fatal.ignoreInput = true;
+  BOOST_REQUIRE_THROW(mlpackMain(), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+}
+
+/**
+ * Make sure that a warm start adds trees to a copy of the input model.
+ */
+BOOST_AUTO_TEST_CASE(RandomForestWarmStartTest)
+{
+  arma::mat inputData;
+  if (!data::Load("vc2.csv", inputData))
+    BOOST_FAIL("Cannot load train dataset vc2.csv!");
+
+  arma::Row<size_t> labels;
+  if (!data::Load("vc2_labels.txt", labels))
+    BOOST_FAIL("Cannot load labels for vc2_labels.txt");
+
+  SetInputParam("training", inputData);
+  SetInputParam("labels", labels);
+  SetInputParam("num_trees", (int) 3);
+
+  mlpackMain();
+
+  RandomForestModel* rf = CLI::GetParam<RandomForestModel*>("output_model");
+  CLI::GetParam<RandomForestModel*>("output_model") = NULL;
+
+  bindings::tests::CleanMemory();
+
+  // Train two more trees on top of the model.
+  SetInputParam("training", inputData);
+  SetInputParam("labels", labels);
+  SetInputParam("num_trees", (int) 2);
+  SetInputParam("input_model", rf);
+  SetInputParam("warm_start", true);
+
+  mlpackMain();
+
+  BOOST_REQUIRE_EQUAL(
+      CLI::GetParam<RandomForestModel*>("output_model")->rf.NumTrees(), 5);
+  BOOST_REQUIRE_EQUAL(rf->rf.NumTrees(), 3);
+}
+
+/**
+ * Make sure that a warm start requires an input model.
+ */
+BOOST_AUTO_TEST_CASE(RandomForestWarmStartNoModelTest)
+{
+  arma::mat inputData;
+  if (!data::Load("vc2.csv", inputData))
+    BOOST_FAIL("Cannot load train dataset vc2.csv!");
+
+  arma::Row<size_t> labels;
+  if (!data::Load("vc2_labels.txt", labels))
+    BOOST_FAIL("Cannot load labels for vc2_labels.txt");
+
+  SetInputParam("training", std::move(inputData));
+  SetInputParam("labels", std::move(labels));
+  SetInputParam("warm_start", true);
+
+  Log::Fatal.ignoreInput = true;
+  BOOST_REQUIRE_THROW(mlpackMain(), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+}
+
 BOOST_AUTO_TEST_SUITE_END();
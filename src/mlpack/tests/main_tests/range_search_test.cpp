@@ -204,6 +204,55 @@ BOOST_AUTO_TEST_CASE(RangeSearchTest)
   remove(distanceFile.c_str());
 }
 
+/**
+ * Check that the binary output holds the same results as the text output.
+ */
+BOOST_AUTO_TEST_CASE(RangeSearchBinaryOutputTest)
+{
+  arma::mat x = {{0, 3, 3, 4, 3, 1},
+                 {4, 4, 4, 5, 5, 2},
+                 {0, 1, 2, 2, 3, 3}};
+
+  string distanceFile = "distances.bin";
+  string neighborsFile = "neighbors.bin";
+  double minVal = 0, maxVal = 3;
+  vector<vector<size_t>> neighborVal = {{},
+                                        {2, 3, 4},
+                                        {1, 3, 4, 5},
+                                        {1, 2, 4},
+                                        {1, 2, 3},
+                                        {2}};
+  vector<vector<double>> distanceVal = {{},
+                                        {1, 1.73205, 2.23607},
+                                        {1, 1.41421, 1.41421, 3},
+                                        {1.73205, 1.41421, 1.41421},
+                                        {2.23607, 1.41421, 1.41421},
+                                        {3}};
+
+  SetInputParam("reference", move(x));
+  SetInputParam("min", minVal);
+  SetInputParam("max", maxVal);
+  SetInputParam("distances_file", distanceFile);
+  SetInputParam("neighbors_file", neighborsFile);
+  SetInputParam("binary_output", true);
+
+  mlpackMain();
+
+  vector<vector<uint64_t>> rawNeighbors =
+      ReadBinaryData<uint64_t>(neighborsFile);
+  vector<vector<double>> distances = ReadBinaryData<double>(distanceFile);
+
+  vector<vector<size_t>> neighbors(rawNeighbors.size());
+  for (size_t i = 0; i < rawNeighbors.size(); ++i)
+    neighbors[i].assign(rawNeighbors[i].begin(), rawNeighbors[i].end());
+
+  CheckMatrices(neighbors, neighborVal);
+  CheckMatrices(distances, distanceVal);
+
+  remove(neighborsFile.c_str());
+  remove(distanceFile.c_str());
+}
+
 /**
  * Check that the correct output is returned for a small synthetic input case,
  * when a query set is provided.
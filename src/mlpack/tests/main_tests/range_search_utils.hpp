@@ -104,4 +104,32 @@ std::vector<std::vector<T>> ReadData(const std::string& filename)
   return table;
 }
 
+/**
+ * Load a file written with the binary_output option into a vector of vector
+ * with a templated datatype.  T must be uint64_t for neighbors and double for
+ * distances.
+ *
+ * @param filename Name of the file to load.
+ */
+template<typename T>
+std::vector<std::vector<T>> ReadBinaryData(const std::string& filename)
+{
+  std::ifstream ifs(filename, std::ios::binary);
+  uint64_t numQueries = 0;
+  ifs.read((char*) &numQueries, sizeof(uint64_t));
+
+  std::vector<uint64_t> offsets(numQueries + 1);
+  ifs.read((char*) offsets.data(), offsets.size() * sizeof(uint64_t));
+
+  std::vector<std::vector<T>> table(numQueries);
+  for (size_t i = 0; i < numQueries; ++i)
+  {
+    table[i].resize(offsets[i + 1] - offsets[i]);
+    ifs.read((char*) table[i].data(), table[i].size() * sizeof(T));
+  }
+
+  BOOST_REQUIRE(ifs.good());
+  return table;
+}
+
 #endif
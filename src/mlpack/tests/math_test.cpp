@@ -1009,4 +1009,96 @@ BOOST_AUTO_TEST_CASE(InplaceSparseShuffleWeightsTest)
   }
 }
 
+/**
+ * Make sure ShuffleDataInPlace() shuffles the points, labels, and weights in
+ * the same way, and keeps every point exactly once.
+ */
+BOOST_AUTO_TEST_CASE(ShuffleDataInPlaceTest)
+{
+  arma::mat data(3, 100, arma::fill::zeros);
+  arma::Row<size_t> labels(100);
+  arma::rowvec weights(100);
+  for (size_t i = 0; i < 100; ++i)
+  {
+    data(0, i) = i;
+    data(2, i) = 2 * i;
+    labels[i] = i;
+    weights[i] = 3 * i;
+  }
+
+  ShuffleDataInPlace(data, labels, weights);
+
+  BOOST_REQUIRE_EQUAL(data.n_rows, 3);
+  BOOST_REQUIRE_EQUAL(data.n_cols, 100);
+  BOOST_REQUIRE_EQUAL(labels.n_elem, 100);
+  BOOST_REQUIRE_EQUAL(weights.n_elem, 100);
+
+  // Make sure we only have each point once, and that something moved.
+  arma::Row<size_t> counts(100, arma::fill::zeros);
+  size_t moved = 0;
+  for (size_t i = 0; i < 100; ++i)
+  {
+    BOOST_REQUIRE_EQUAL((size_t) data(0, i), labels[i]);
+    BOOST_REQUIRE_SMALL(data(1, i), 1e-5);
+    BOOST_REQUIRE_EQUAL((size_t) data(2, i), 2 * labels[i]);
+    BOOST_REQUIRE_EQUAL((size_t) weights[i], 3 * labels[i]);
+    counts[labels[i]]++;
+    if (labels[i] != i)
+      ++moved;
+  }
+
+  for (size_t i = 0; i < 100; ++i)
+    BOOST_REQUIRE_EQUAL(counts[i], 1);
+  BOOST_REQUIRE_GT(moved, 0);
+}
+
+/**
+ * Make sure the products of sparse matrices with dense matrices are the same
+ * as with Armadillo.
+ */
+BOOST_AUTO_TEST_CASE(SparseDenseProductTest)
+{
+  arma::sp_mat a;
+  a.sprandu(50, 40, 0.1);
+  arma::mat b(40, 7, arma::fill::randn);
+  arma::mat c(50, 7, arma::fill::randn);
+
+  CheckMatrices(Product(a, b), arma::mat(a * b));
+  CheckMatrices(TransProduct(a, c), arma::mat(a.t() * c));
+  CheckMatrices(Product(arma::mat(a), b), arma::mat(a * b));
+  CheckMatrices(TransProduct(arma::mat(a), c), arma::mat(a.t() * c));
+
+  // An empty sparse matrix gives a zero product.
+  arma::sp_mat empty(50, 40);
+  BOOST_REQUIRE_EQUAL(arma::accu(arma::abs(Product(empty, b))), 0.0);
+
+  BOOST_REQUIRE_THROW(Product(a, c), std::invalid_argument);
+  BOOST_REQUIRE_THROW(TransProduct(a, b), std::invalid_argument);
+}
+
+/**
+ * Make sure FirstTouchCopy() and FirstTouch() keep the contents of the matrix.
+ */
+BOOST_AUTO_TEST_CASE(FirstTouchTest)
+{
+  arma::mat a(7, 1001, arma::fill::randu);
+  arma::mat b;
+  FirstTouchCopy(a, b);
+  CheckMatrices(a, b);
+
+  arma::fmat c(5, 333, arma::fill::randu);
+  arma::fmat d(c);
+  FirstTouch(d);
+  BOOST_REQUIRE_EQUAL(d.n_rows, 5);
+  BOOST_REQUIRE_EQUAL(d.n_cols, 333);
+  BOOST_REQUIRE_EQUAL(arma::accu(c != d), 0);
+
+  // Empty matrices are fine too.
+  arma::mat empty;
+  FirstTouchCopy(empty, b);
+  BOOST_REQUIRE_EQUAL(b.n_elem, 0);
+  FirstTouch(empty);
+  BOOST_REQUIRE_EQUAL(empty.n_elem, 0);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
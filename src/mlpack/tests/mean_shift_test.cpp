@@ -165,4 +165,43 @@ BOOST_AUTO_TEST_CASE(GaussianClustering)
   BOOST_REQUIRE_EQUAL(success, true);
 }
 
+/**
+ * With many well-separated clusters, the converged centroids are merged with
+ * the hypercube bins; make sure exactly one centroid is kept for each cluster.
+ */
+BOOST_AUTO_TEST_CASE(MeanShiftManyClustersMergeTest)
+{
+  // 16 clusters on a grid, each of 20 points close to the center.
+  arma::mat dataset(2, 16 * 20);
+  arma::mat centers(2, 16);
+  for (size_t c = 0; c < 16; ++c)
+  {
+    centers(0, c) = 10.0 * (c % 4);
+    centers(1, c) = 10.0 * (c / 4);
+    for (size_t i = 0; i < 20; ++i)
+    {
+      dataset.col(20 * c + i) = centers.col(c) + 0.2 *
+          (arma::randu<arma::vec>(2) - 0.5);
+    }
+  }
+
+  MeanShift<> meanShift(1.0);
+  arma::Row<size_t> assignments;
+  arma::mat centroids;
+  meanShift.Cluster(dataset, assignments, centroids, true, false);
+
+  BOOST_REQUIRE_EQUAL(centroids.n_cols, 16);
+
+  // Each cluster must have its own centroid, and all of its points must be
+  // assigned to it.
+  for (size_t c = 0; c < 16; ++c)
+  {
+    const size_t assignment = assignments[20 * c];
+    BOOST_REQUIRE_SMALL(metric::EuclideanDistance::Evaluate(
+        centroids.col(assignment), centers.col(c)), 0.2);
+    for (size_t i = 1; i < 20; ++i)
+      BOOST_REQUIRE_EQUAL(assignments[20 * c + i], assignment);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -10,8 +10,10 @@
  */
 #include <mlpack/core.hpp>
 #include <mlpack/core/metrics/lmetric.hpp>
+#include <mlpack/core/metrics/fixed_dim_lmetric.hpp>
 #include <boost/test/unit_test.hpp>
 #include <mlpack/core/metrics/iou_metric.hpp>
+#include <mlpack/core/metrics/mahalanobis_distance.hpp>
 #include "test_tools.hpp"
 
 using namespace std;
@@ -97,6 +99,85 @@ BOOST_AUTO_TEST_CASE(LINFMetricTest)
                       lMetric.Evaluate(a2, b2), 1e-5);
 }
 
+/**
+ * Check that LMetric::BatchEvaluate() gives the same distances as
+ * LMetric::Evaluate() for each column.
+ */
+template<typename MetricType, typename MatType>
+void CheckBatchEvaluate(const MatType& points)
+{
+  arma::Col<typename MatType::elem_type> distances;
+  MetricType::BatchEvaluate(points.col(0), points.cols(1, points.n_cols - 1),
+      distances);
+
+  BOOST_REQUIRE_EQUAL(distances.n_elem, points.n_cols - 1);
+  for (size_t i = 1; i < points.n_cols; ++i)
+  {
+    BOOST_REQUIRE_CLOSE((double) distances[i - 1],
+        (double) MetricType::Evaluate(points.col(0), points.col(i)), 1e-3);
+  }
+}
+
+/**
+ * Test batch evaluation of the L-metrics, for both double and float.
+ */
+BOOST_AUTO_TEST_CASE(LMetricBatchEvaluateTest)
+{
+  arma::mat points(7, 40, arma::fill::randn);
+  arma::fmat fpoints = arma::conv_to<arma::fmat>::from(points);
+
+  CheckBatchEvaluate<ManhattanDistance>(points);
+  CheckBatchEvaluate<SquaredEuclideanDistance>(points);
+  CheckBatchEvaluate<EuclideanDistance>(points);
+  CheckBatchEvaluate<ChebyshevDistance>(points);
+  CheckBatchEvaluate<LMetric<3, true>>(points);
+
+  CheckBatchEvaluate<ManhattanDistance>(fpoints);
+  CheckBatchEvaluate<EuclideanDistance>(fpoints);
+  CheckBatchEvaluate<ChebyshevDistance>(fpoints);
+}
+
+/**
+ * Make sure that FixedDimLMetric::Evaluate() gives the same distances as the
+ * corresponding LMetric.
+ */
+template<int Power, bool TakeRoot, typename MatType>
+void CheckFixedDimEvaluate(const MatType& points)
+{
+  for (size_t i = 1; i < points.n_cols; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(
+        (double) FixedDimLMetric<4, Power, TakeRoot>::Evaluate(points.col(0),
+            points.col(i)),
+        (double) LMetric<Power, TakeRoot>::Evaluate(points.col(0),
+            points.col(i)), 1e-3);
+  }
+}
+
+/**
+ * Test the fixed-dimension L-metrics, for both double and float.
+ */
+BOOST_AUTO_TEST_CASE(FixedDimLMetricTest)
+{
+  arma::mat points(4, 30, arma::fill::randn);
+  arma::fmat fpoints = arma::conv_to<arma::fmat>::from(points);
+
+  CheckFixedDimEvaluate<1, false>(points);
+  CheckFixedDimEvaluate<2, false>(points);
+  CheckFixedDimEvaluate<2, true>(points);
+  CheckFixedDimEvaluate<3, true>(points);
+  CheckFixedDimEvaluate<INT_MAX, false>(points);
+
+  CheckFixedDimEvaluate<1, false>(fpoints);
+  CheckFixedDimEvaluate<2, true>(fpoints);
+  CheckFixedDimEvaluate<INT_MAX, false>(fpoints);
+
+  // Fixed-size Armadillo vectors work too.
+  arma::vec::fixed<4> a(points.col(0)), b(points.col(1));
+  BOOST_REQUIRE_CLOSE(FixedDimEuclideanDistance<4>::Evaluate(a, b),
+      EuclideanDistance::Evaluate(a, b), 1e-5);
+}
+
 /**
  * Simple test for IoU metric.
  */
@@ -133,4 +214,42 @@ BOOST_AUTO_TEST_CASE(IoUMetricTest)
   BOOST_REQUIRE_CLOSE(IoU<>::Evaluate(bbox1, bbox2), 0.7309670, 1e-4);
 }
 
+/**
+ * Make sure that the transformation of the Mahalanobis distance turns it into
+ * the Euclidean distance, for positive definite and for singular covariances.
+ */
+BOOST_AUTO_TEST_CASE(MahalanobisTransformationTest)
+{
+  arma::mat a = arma::randn<arma::mat>(5, 5);
+  arma::mat b = arma::randn<arma::mat>(2, 5);
+  arma::mat points = arma::randu<arma::mat>(5, 20);
+
+  for (size_t trial = 0; trial < 2; ++trial)
+  {
+    // The second covariance has rank 2, so it has no Cholesky factor.
+    const arma::mat covariance = (trial == 0) ?
+        arma::mat(a.t() * a + arma::eye<arma::mat>(5, 5)) :
+        arma::mat(b.t() * b);
+    MahalanobisDistance<true> metric(covariance);
+
+    const arma::mat transformation = metric.Transformation();
+    BOOST_REQUIRE_EQUAL(transformation.n_cols, 5);
+    const arma::mat product = transformation.t() * transformation;
+    for (size_t i = 0; i < product.n_elem; ++i)
+      BOOST_REQUIRE_SMALL(product[i] - covariance[i], 1e-8);
+
+    const arma::mat transformed = transformation * points;
+    for (size_t i = 1; i < points.n_cols; ++i)
+    {
+      BOOST_REQUIRE_SMALL(metric.Evaluate(points.col(0), points.col(i)) -
+          EuclideanDistance::Evaluate(transformed.col(0), transformed.col(i)),
+          1e-8);
+    }
+  }
+
+  // Without a covariance there is nothing to transform.
+  MahalanobisDistance<true> identity;
+  BOOST_REQUIRE_EQUAL(identity.Transformation().n_elem, 0);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
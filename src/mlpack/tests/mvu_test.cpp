@@ -0,0 +1,149 @@
+/**
+ * @file tests/mvu_test.cpp
+ *
+ * Tests for Maximum Variance Unfolding.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/mvu/mvu.hpp>
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
+#include <boost/test/unit_test.hpp>
+#include "test_tools.hpp"
+
+using namespace mlpack;
+using namespace mlpack::mvu;
+using namespace mlpack::neighbor;
+
+// Create points along a noisy arc in three dimensions, which MVU should be
+// able to unfold into fewer dimensions.
+static arma::mat ArcDataset(const size_t n)
+{
+  arma::mat data(3, n);
+  for (size_t i = 0; i < n; ++i)
+  {
+    const double t = M_PI * i / (n - 1);
+    data(0, i) = std::cos(t);
+    data(1, i) = std::sin(t);
+    data(2, i) = 0.5 * t;
+  }
+  data += 0.01 * arma::randn<arma::mat>(3, n);
+
+  return data;
+}
+
+// Check the size of the unfolded dataset, that it is finite, and that it is
+// centered (the centering constraint of MVU).
+static void CheckUnfolded(const arma::mat& output,
+                          const size_t newDim,
+                          const size_t numPoints)
+{
+  BOOST_REQUIRE_EQUAL(output.n_rows, newDim);
+  BOOST_REQUIRE_EQUAL(output.n_cols, numPoints);
+  BOOST_REQUIRE(output.is_finite());
+
+  const double scale = arma::abs(output).max();
+  BOOST_REQUIRE_GT(scale, 0.0);
+  const arma::vec mean = arma::mean(output, 1);
+  for (size_t d = 0; d < newDim; ++d)
+    BOOST_REQUIRE_SMALL(mean[d], 0.1 * scale);
+}
+
+BOOST_AUTO_TEST_SUITE(MVUTest);
+
+/**
+ * Make sure that MVU with exact nearest neighbors keeps the distances between
+ * neighbors approximately.
+ */
+BOOST_AUTO_TEST_CASE(MVUExactTest)
+{
+  math::RandomSeed(10);
+  const arma::mat data = ArcDataset(40);
+
+  MVU mvu(data);
+  arma::mat output;
+  mvu.Unfold(2, 4, output);
+
+  CheckUnfolded(output, 2, data.n_cols);
+
+  KNN knn(data);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  knn.Search(4, neighbors, distances);
+
+  double relativeError = 0.0;
+  for (size_t i = 0; i < neighbors.n_cols; ++i)
+  {
+    for (size_t j = 0; j < neighbors.n_rows; ++j)
+    {
+      const double unfolded = arma::norm(output.col(i) -
+          output.col(neighbors(j, i)));
+      relativeError += std::abs(unfolded - distances(j, i)) / distances(j, i);
+    }
+  }
+
+  BOOST_REQUIRE_LT(relativeError / neighbors.n_elem, 0.2);
+}
+
+/**
+ * Make sure that MVU runs when the nearest neighbors are found with
+ * NNDescent.
+ */
+BOOST_AUTO_TEST_CASE(MVUApproximateTest)
+{
+  math::RandomSeed(11);
+  const arma::mat data = ArcDataset(40);
+
+  MVU mvu(data, true);
+  BOOST_REQUIRE_EQUAL(mvu.Approximate(), true);
+
+  arma::mat output;
+  mvu.Unfold(2, 4, output);
+
+  CheckUnfolded(output, 2, data.n_cols);
+}
+
+/**
+ * Make sure that landmark MVU gives an output for every point, and not only
+ * for the landmarks.
+ */
+BOOST_AUTO_TEST_CASE(MVULandmarkTest)
+{
+  math::RandomSeed(12);
+  const arma::mat data = ArcDataset(100);
+
+  MVU mvu(data, false, 20);
+  BOOST_REQUIRE_EQUAL(mvu.NumLandmarks(), 20);
+
+  arma::mat output;
+  mvu.Unfold(2, 5, output);
+
+  CheckUnfolded(output, 2, data.n_cols);
+}
+
+/**
+ * Make sure that asking for at least as many landmarks as points is the same as
+ * not using landmarks.
+ */
+BOOST_AUTO_TEST_CASE(MVUAllLandmarksTest)
+{
+  math::RandomSeed(13);
+  const arma::mat data = ArcDataset(30);
+
+  MVU mvu(data);
+  arma::mat output;
+  math::RandomSeed(14);
+  mvu.Unfold(2, 4, output);
+
+  MVU landmarkMVU(data, false, data.n_cols);
+  arma::mat landmarkOutput;
+  math::RandomSeed(14);
+  landmarkMVU.Unfold(2, 4, landmarkOutput);
+
+  CheckMatrices(output, landmarkOutput);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
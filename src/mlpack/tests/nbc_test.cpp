@@ -355,4 +355,63 @@ BOOST_AUTO_TEST_CASE(NaiveBayesClassifierHighDimensionsTest)
     BOOST_REQUIRE_EQUAL(calcVec(i), testLabels(i));
 }
 
+/**
+ * Make sure that training on a sparse matrix gives the same model as training
+ * on the equivalent dense matrix, with and without the incremental algorithm.
+ */
+BOOST_AUTO_TEST_CASE(SparseTrainTest)
+{
+  arma::sp_mat sparseData;
+  sparseData.sprandu(50, 300, 0.1);
+  arma::mat denseData(sparseData);
+  arma::Row<size_t> labels = arma::randi<arma::Row<size_t>>(300,
+      arma::distr_param(0, 2));
+
+  for (size_t incremental = 0; incremental < 2; ++incremental)
+  {
+    NaiveBayesClassifier<> dense(denseData, labels, 3, incremental);
+    NaiveBayesClassifier<> sparse(sparseData, labels, 3, incremental);
+
+    CheckMatrices(dense.Means(), sparse.Means());
+    CheckMatrices(dense.Variances(), sparse.Variances());
+    CheckMatrices(dense.Probabilities(), sparse.Probabilities());
+  }
+}
+
+/**
+ * Make sure that classifying sparse points gives the same predictions and
+ * probabilities as classifying the equivalent dense points.
+ */
+BOOST_AUTO_TEST_CASE(SparseClassifyTest)
+{
+  arma::sp_mat sparseData;
+  sparseData.sprandu(40, 200, 0.2);
+  arma::Row<size_t> labels = arma::randi<arma::Row<size_t>>(200,
+      arma::distr_param(0, 3));
+  // Make the classes different, so that the probabilities are not all close.
+  for (size_t j = 0; j < sparseData.n_cols; ++j)
+    sparseData(labels[j] * 10, j) += 1.0;
+
+  NaiveBayesClassifier<> nbc(sparseData, labels, 4);
+
+  arma::sp_mat sparseTest;
+  sparseTest.sprandu(40, 50, 0.2);
+  arma::mat denseTest(sparseTest);
+
+  arma::Row<size_t> denseLabels, sparseLabels;
+  arma::mat denseProbs, sparseProbs;
+  nbc.Classify(denseTest, denseLabels, denseProbs);
+  nbc.Classify(sparseTest, sparseLabels, sparseProbs);
+
+  CheckMatrices(denseLabels, sparseLabels);
+  CheckMatrices(denseProbs, sparseProbs);
+
+  // Classifying a single sparse point should give the same prediction.
+  for (size_t j = 0; j < sparseTest.n_cols; ++j)
+  {
+    const arma::sp_vec point = sparseTest.col(j);
+    BOOST_REQUIRE_EQUAL(nbc.Classify(point), denseLabels[j]);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -249,6 +249,70 @@ BOOST_AUTO_TEST_CASE(SoftmaxSeparableGradient)
   BOOST_REQUIRE_CLOSE(gradient(1, 1), -2.0 * -0.1435886, 0.01);
 }
 
+/**
+ * When every other point is a neighbor, the truncated objective and gradient
+ * should be the same as the exact ones.
+ */
+BOOST_AUTO_TEST_CASE(SoftmaxTruncatedAllNeighbors)
+{
+  arma::mat data;
+  data.randu(3, 40);
+  arma::Row<size_t> labels(40);
+  for (size_t i = 0; i < 40; ++i)
+    labels[i] = i % 3;
+
+  SoftmaxErrorFunction<SquaredEuclideanDistance> sef(data, labels);
+  SoftmaxErrorFunction<SquaredEuclideanDistance> truncated(data, labels,
+      SquaredEuclideanDistance(), 39);
+
+  arma::mat coordinates = 0.5 * arma::eye<arma::mat>(3, 3) +
+      0.1 * arma::randu<arma::mat>(3, 3);
+
+  BOOST_REQUIRE_CLOSE(truncated.Evaluate(coordinates),
+      sef.Evaluate(coordinates), 1e-5);
+
+  arma::mat gradient, truncatedGradient;
+  sef.Gradient(coordinates, gradient);
+  truncated.Gradient(coordinates, truncatedGradient);
+  for (size_t i = 0; i < gradient.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(truncatedGradient[i], gradient[i], 1e-5);
+
+  for (size_t b = 0; b < 40; b += 10)
+  {
+    BOOST_REQUIRE_CLOSE(truncated.Evaluate(coordinates, b, 10),
+        sef.Evaluate(coordinates, b, 10), 1e-5);
+
+    sef.Gradient(coordinates, b, gradient, 10);
+    truncated.Gradient(coordinates, b, truncatedGradient, 10);
+    for (size_t i = 0; i < gradient.n_elem; ++i)
+      BOOST_REQUIRE_CLOSE(truncatedGradient[i], gradient[i], 1e-5);
+  }
+}
+
+/**
+ * Make sure NCA with a few neighbors per point still separates the simple
+ * dataset.
+ */
+BOOST_AUTO_TEST_CASE(NCALBFGSTruncatedSimpleDataset)
+{
+  // Useful but simple dataset with six points and two classes.
+  arma::mat data           = "-0.1 -0.1 -0.1  0.1  0.1  0.1;"
+                             " 1.0  0.0 -1.0  1.0  0.0 -1.0 ";
+  arma::Row<size_t> labels = " 0    0    0    1    1    1   ";
+
+  NCA<SquaredEuclideanDistance, L_BFGS> nca(data, labels,
+      SquaredEuclideanDistance(), 3);
+  nca.Optimizer().NumBasis() = 5;
+
+  arma::mat outputMatrix;
+  nca.LearnDistance(outputMatrix);
+
+  // The exact objective should be better than at the starting point.
+  SoftmaxErrorFunction<SquaredEuclideanDistance> sef(data, labels);
+  BOOST_REQUIRE_LT(sef.Evaluate(outputMatrix),
+      sef.Evaluate(arma::eye<arma::mat>(2, 2)));
+}
+
 //
 // Tests for the NCA algorithm.
 //
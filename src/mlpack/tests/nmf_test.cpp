@@ -16,6 +16,8 @@
 #include <mlpack/methods/amf/update_rules/nmf_mult_div.hpp>
 #include <mlpack/methods/amf/update_rules/nmf_als.hpp>
 #include <mlpack/methods/amf/update_rules/nmf_mult_dist.hpp>
+#include <mlpack/methods/amf/update_rules/weighted_als.hpp>
+#include <mlpack/methods/amf/termination_policies/max_iteration_termination.hpp>
 
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
@@ -233,6 +235,63 @@ BOOST_AUTO_TEST_CASE(SparseNMFALSTest)
       1e-5);
 }
 
+/**
+ * Check that weighted ALS recovers a sparse low-rank matrix on its nonzero
+ * entries, and that the implicit feedback variant ranks the nonzero entries
+ * above the zero entries.
+ */
+BOOST_AUTO_TEST_CASE(SparseWeightedALSTest)
+{
+  // Build a rank 3 matrix and keep a fraction of its entries.
+  mat tw = randu<mat>(60, 3) + 0.1;
+  mat th = randu<mat>(3, 80) + 0.1;
+  mat full = tw * th;
+  sp_mat v(full.n_rows, full.n_cols);
+  for (size_t j = 0; j < full.n_cols; ++j)
+  {
+    for (size_t i = 0; i < full.n_rows; ++i)
+    {
+      if ((i + 3 * j) % 4 == 0)
+        v(i, j) = full(i, j);
+    }
+  }
+
+  mat w, h;
+  MaxIterationTermination mit(50);
+  AMF<MaxIterationTermination, RandomInitialization, WeightedALSUpdate>
+      als(mit, RandomInitialization(), WeightedALSUpdate(1e-6));
+  als.Apply(v, 3, w, h);
+
+  // The nonzero entries and the unobserved entries are both recovered.
+  mat vp = w * h;
+  double error = 0.0;
+  for (sp_mat::const_iterator it = v.begin(); it != v.end(); ++it)
+    error += std::pow(vp(it.row(), it.col()) - (*it), 2.0);
+  BOOST_REQUIRE_SMALL(std::sqrt(error / v.n_nonzero), 0.05);
+  BOOST_REQUIRE_SMALL(arma::norm(vp - full, "fro") / arma::norm(full, "fro"),
+      0.1);
+
+  // With implicit feedback, the observed entries are fit towards 1.
+  AMF<MaxIterationTermination, RandomInitialization, WeightedALSUpdate>
+      implicitAls(mit, RandomInitialization(),
+      WeightedALSUpdate(0.1, true, 40.0));
+  implicitAls.Apply(v, 3, w, h);
+  vp = w * h;
+  double observed = 0.0, unobserved = 0.0;
+  for (size_t j = 0; j < v.n_cols; ++j)
+  {
+    for (size_t i = 0; i < v.n_rows; ++i)
+    {
+      if (v(i, j) != 0.0)
+        observed += vp(i, j);
+      else
+        unobserved += vp(i, j);
+    }
+  }
+  BOOST_REQUIRE_GT(observed / v.n_nonzero,
+      unobserved / (v.n_elem - v.n_nonzero));
+}
+
 /**
  * Check if all elements in W and H are non-negative.
  * Default Case.
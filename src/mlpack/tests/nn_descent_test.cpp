@@ -0,0 +1,139 @@
+/**
+ * @file tests/nn_descent_test.cpp
+ *
+ * Unit tests for the 'NNDescent' class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
+#include <boost/test/unit_test.hpp>
+#include "test_tools.hpp"
+
+#include <mlpack/methods/nn_descent/nn_descent.hpp>
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
+#include <mlpack/methods/lmnn/constraints.hpp>
+
+using namespace std;
+using namespace mlpack;
+using namespace mlpack::neighbor;
+
+// Return the fraction of the true neighbors that were found.
+static double Recall(const arma::Mat<size_t>& found,
+                     const arma::Mat<size_t>& truth)
+{
+  size_t count = 0;
+  for (size_t i = 0; i < truth.n_cols; ++i)
+    for (size_t j = 0; j < truth.n_rows; ++j)
+      if (arma::any(found.col(i) == truth(j, i)))
+        ++count;
+
+  return (double) count / truth.n_elem;
+}
+
+BOOST_AUTO_TEST_SUITE(NNDescentTest);
+
+/**
+ * Test that NN-descent finds most of the true all-kNN graph, with the exact
+ * distances in increasing order and without points as their own neighbors.
+ */
+BOOST_AUTO_TEST_CASE(NNDescentRecallTest)
+{
+  const size_t k = 10;
+  arma::mat data(20, 2000, arma::fill::randu);
+
+  KNN knn(data);
+  arma::Mat<size_t> groundTruth;
+  arma::mat groundDistances;
+  knn.Search(k, groundTruth, groundDistances);
+
+  NNDescent<> nnd(data);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  nnd.Search(k, neighbors, distances);
+
+  BOOST_REQUIRE_EQUAL(neighbors.n_rows, k);
+  BOOST_REQUIRE_EQUAL(neighbors.n_cols, 2000);
+  BOOST_REQUIRE_GE(Recall(neighbors, groundTruth), 0.9);
+  BOOST_REQUIRE_GT(nnd.Iterations(), 1);
+
+  // The search is cheaper than comparing every pair of points.
+  BOOST_REQUIRE_LT(nnd.DistanceEvaluations(), 2000 * 1999 / 2);
+
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    for (size_t j = 0; j < k; ++j)
+    {
+      BOOST_REQUIRE_NE(neighbors(j, i), i);
+      BOOST_REQUIRE_CLOSE(distances(j, i), metric::EuclideanDistance::Evaluate(
+          data.col(i), data.col(neighbors(j, i))), 1e-5);
+      if (j > 0)
+        BOOST_REQUIRE_LE(distances(j - 1, i), distances(j, i));
+    }
+  }
+}
+
+/**
+ * Test that on a small dataset (where most points are neighbors, so the
+ * initial graph is drawn from permutations) the graph is nearly exact, and
+ * that k must be less than the number of points.
+ */
+BOOST_AUTO_TEST_CASE(NNDescentSmallDatasetTest)
+{
+  arma::mat data(3, 12, arma::fill::randu);
+
+  KNN knn(data);
+  arma::Mat<size_t> groundTruth;
+  arma::mat groundDistances;
+  knn.Search(8, groundTruth, groundDistances);
+
+  NNDescent<> nnd;
+  nnd.Train(data);
+  nnd.SampleRate() = 1.0;
+  nnd.Tolerance() = 0.0;
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  nnd.Search(8, neighbors, distances);
+
+  BOOST_REQUIRE_GE(Recall(neighbors, groundTruth), 0.95);
+  for (size_t i = 0; i < data.n_cols; ++i)
+    BOOST_REQUIRE_LE(distances(7, i), groundDistances(7, i) * 1.5);
+
+  BOOST_REQUIRE_THROW(nnd.Search(12, neighbors, distances),
+      std::invalid_argument);
+}
+
+/**
+ * Test that NNDescent can find the target neighbors of LMNN.
+ */
+BOOST_AUTO_TEST_CASE(NNDescentLMNNTargetNeighborsTest)
+{
+  arma::mat dataset(10, 600, arma::fill::randu);
+  arma::Row<size_t> labels(600);
+  for (size_t i = 0; i < 600; ++i)
+    labels[i] = i % 3;
+
+  arma::vec norms(dataset.n_cols);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+    norms(i) = arma::norm(dataset.col(i));
+
+  lmnn::Constraints<> constraints(dataset, labels, 5);
+  arma::Mat<size_t> targetNeighbors(5, dataset.n_cols);
+  constraints.TargetNeighbors(targetNeighbors, dataset, labels, norms);
+
+  lmnn::Constraints<metric::SquaredEuclideanDistance,
+      NNDescent<metric::SquaredEuclideanDistance>> nndConstraints(dataset,
+      labels, 5);
+  arma::Mat<size_t> nndTargetNeighbors(5, dataset.n_cols);
+  nndConstraints.TargetNeighbors(nndTargetNeighbors, dataset, labels, norms);
+
+  BOOST_REQUIRE_GE(Recall(nndTargetNeighbors, targetNeighbors), 0.9);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+    for (size_t j = 0; j < 5; ++j)
+      BOOST_REQUIRE_EQUAL(labels[nndTargetNeighbors(j, i)], labels[i]);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -18,6 +18,8 @@
 #include <mlpack/methods/nystroem_method/ordered_selection.hpp>
 #include <mlpack/methods/nystroem_method/random_selection.hpp>
 #include <mlpack/methods/nystroem_method/kmeans_selection.hpp>
+#include <mlpack/methods/nystroem_method/mini_batch_kmeans_selection.hpp>
+#include <mlpack/methods/nystroem_method/uniform_selection.hpp>
 #include <mlpack/methods/nystroem_method/nystroem_method.hpp>
 
 using namespace mlpack;
@@ -202,4 +204,55 @@ BOOST_AUTO_TEST_CASE(GermanTest)
   }
 }
 
+/**
+ * UniformSelection should select distinct points of the dataset.
+ */
+BOOST_AUTO_TEST_CASE(UniformSelectionDistinctTest)
+{
+  arma::mat data(3, 100, arma::fill::randu);
+
+  for (size_t trial = 0; trial < 10; ++trial)
+  {
+    arma::Col<size_t> selected = UniformSelection::Select(data, 40);
+    BOOST_REQUIRE_EQUAL(selected.n_elem, 40);
+    BOOST_REQUIRE_LT(selected.max(), 100);
+    BOOST_REQUIRE_EQUAL(arma::Col<size_t>(arma::unique(selected)).n_elem, 40);
+  }
+
+  // Selecting every point gives a permutation.
+  arma::Col<size_t> all = arma::sort(UniformSelection::Select(data, 100));
+  for (size_t i = 0; i < 100; ++i)
+    BOOST_REQUIRE_EQUAL(all[i], i);
+}
+
+/**
+ * The landmarks of mini-batch k-means should give an approximation of the
+ * kernel matrix of german.csv close to the one of k-means.
+ */
+BOOST_AUTO_TEST_CASE(MiniBatchKMeansSelectionTest)
+{
+  arma::mat dataset;
+  data::Load("german.csv", dataset, true);
+
+  GaussianKernel gk(16.461);
+
+  arma::mat kernel(dataset.n_cols, dataset.n_cols);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+    for (size_t j = 0; j < dataset.n_cols; ++j)
+      kernel(i, j) = gk.Evaluate(dataset.col(i), dataset.col(j));
+
+  const size_t rank = dataset.n_cols / 10;
+  NystroemMethod<GaussianKernel, MiniBatchKMeansSelection<> > nm(dataset, gk,
+      rank);
+  arma::mat g;
+  nm.Apply(g);
+
+  BOOST_REQUIRE_EQUAL(g.n_rows, dataset.n_cols);
+  BOOST_REQUIRE_EQUAL(g.n_cols, rank);
+
+  // This is the tolerance of k-means with 6% of the points as landmarks.
+  const double error = arma::norm(kernel - g * g.t(), "fro");
+  BOOST_REQUIRE_SMALL(error, 15.0);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
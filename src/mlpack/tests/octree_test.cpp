@@ -346,4 +346,109 @@ BOOST_AUTO_TEST_CASE(SerializationTest)
   delete textTree;
 }
 
+/**
+ * Make sure that the given nodes, built recursively and from Morton codes, hold
+ * the same children and the same points (possibly in another order).
+ */
+template<typename TreeType>
+void CheckSameMortonNode(const TreeType& recursive,
+                         const TreeType& morton,
+                         const std::vector<size_t>& recursiveOldFromNew,
+                         const std::vector<size_t>& mortonOldFromNew)
+{
+  BOOST_REQUIRE_EQUAL(recursive.NumChildren(), morton.NumChildren());
+  BOOST_REQUIRE_EQUAL(recursive.NumDescendants(), morton.NumDescendants());
+  if (recursive.NumDescendants() > 0)
+    BOOST_REQUIRE_EQUAL(recursive.Descendant(0), morton.Descendant(0));
+
+  std::vector<size_t> recursivePoints, mortonPoints;
+  for (size_t i = 0; i < recursive.NumDescendants(); ++i)
+  {
+    recursivePoints.push_back(recursiveOldFromNew[recursive.Descendant(i)]);
+    mortonPoints.push_back(mortonOldFromNew[morton.Descendant(i)]);
+  }
+  std::sort(recursivePoints.begin(), recursivePoints.end());
+  std::sort(mortonPoints.begin(), mortonPoints.end());
+  for (size_t i = 0; i < recursivePoints.size(); ++i)
+    BOOST_REQUIRE_EQUAL(recursivePoints[i], mortonPoints[i]);
+
+  // The bounds are the extremes of the same points, so they are equal.
+  for (size_t d = 0; d < recursive.Bound().Dim(); ++d)
+  {
+    BOOST_REQUIRE_EQUAL(recursive.Bound()[d].Lo(), morton.Bound()[d].Lo());
+    BOOST_REQUIRE_EQUAL(recursive.Bound()[d].Hi(), morton.Bound()[d].Hi());
+  }
+  BOOST_REQUIRE_CLOSE(recursive.ParentDistance(), morton.ParentDistance(),
+      1e-5);
+  BOOST_REQUIRE_CLOSE(recursive.FurthestDescendantDistance(),
+      morton.FurthestDescendantDistance(), 1e-5);
+
+  for (size_t i = 0; i < recursive.NumChildren(); ++i)
+  {
+    BOOST_REQUIRE_EQUAL(morton.Child(i).Parent(), &morton);
+    CheckSameMortonNode(recursive.Child(i), morton.Child(i),
+        recursiveOldFromNew, mortonOldFromNew);
+  }
+}
+
+/**
+ * Make sure that building an octree from Morton codes gives the same nodes as
+ * building it recursively, and that the mappings are right.
+ */
+BOOST_AUTO_TEST_CASE(MortonOrderBuildTest)
+{
+  for (size_t dims = 1; dims <= 4; ++dims)
+  {
+    arma::mat dataset(dims, 5000, arma::fill::randu);
+
+    std::vector<size_t> recursiveOldFromNew, mortonOldFromNew, newFromOld;
+    Octree<> recursive(dataset, recursiveOldFromNew, 7);
+    Octree<> morton(dataset, mortonOldFromNew, newFromOld, 7,
+        OctreeBuildMethod::MortonOrder);
+
+    for (size_t i = 0; i < dataset.n_cols; ++i)
+    {
+      BOOST_REQUIRE_EQUAL(newFromOld[mortonOldFromNew[i]], i);
+      for (size_t d = 0; d < dims; ++d)
+      {
+        BOOST_REQUIRE_EQUAL(morton.Dataset()(d, i),
+            dataset(d, mortonOldFromNew[i]));
+      }
+    }
+
+    CheckSameMortonNode(recursive, morton, recursiveOldFromNew,
+        mortonOldFromNew);
+  }
+}
+
+/**
+ * Make sure that the nodes deeper than the Morton codes can tell apart are
+ * still split, and that the constructors without mappings work.
+ */
+BOOST_AUTO_TEST_CASE(MortonOrderDeepNodeTest)
+{
+  // The 2-d codes hold 32 levels, but the clustered points are only told
+  // apart about 40 levels down.
+  arma::mat dataset(2, 130, arma::fill::randu);
+  for (size_t i = 100; i < 130; ++i)
+    dataset.col(i).fill(0.5 + 1e-12 * (i - 100));
+
+  std::vector<size_t> recursiveOldFromNew, mortonOldFromNew;
+  Octree<> recursive(dataset, recursiveOldFromNew, 3);
+  Octree<> morton(dataset, mortonOldFromNew, 3,
+      OctreeBuildMethod::MortonOrder);
+
+  CheckSameMortonNode(recursive, morton, recursiveOldFromNew,
+      mortonOldFromNew);
+
+  // Without mappings, the dataset is reordered the same way.
+  Octree<> unmapped(std::move(dataset), 3, OctreeBuildMethod::MortonOrder);
+  CheckSameMortonNode(morton, unmapped, mortonOldFromNew, mortonOldFromNew);
+  for (size_t i = 0; i < morton.Dataset().n_cols; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(morton.Dataset()(0, i), unmapped.Dataset()(0, i));
+    BOOST_REQUIRE_EQUAL(morton.Dataset()(1, i), unmapped.Dataset()(1, i));
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -13,6 +13,7 @@
 #include <mlpack/core.hpp>
 #include <mlpack/methods/pca/pca.hpp>
 #include <mlpack/methods/pca/decomposition_policies/exact_svd_method.hpp>
+#include <mlpack/methods/pca/decomposition_policies/incremental_svd_method.hpp>
 #include <mlpack/methods/pca/decomposition_policies/quic_svd_method.hpp>
 #include <mlpack/methods/pca/decomposition_policies/randomized_svd_method.hpp>
 #include <mlpack/methods/pca/decomposition_policies/randomized_block_krylov_method.hpp>
@@ -280,6 +281,98 @@ BOOST_AUTO_TEST_CASE(QUICPCADimensionalityReductionTest)
   BOOST_REQUIRE_EQUAL(data.n_cols, data1.n_cols);
 }
 
+/**
+ * Compare the output of our incremental PCA implementation with Armadillo's.
+ */
+BOOST_AUTO_TEST_CASE(ArmaComparisonIncrementalPCATest)
+{
+  IncrementalSVDPolicy decomposition(37);
+  ArmaComparisonPCA<IncrementalSVDPolicy>(false, decomposition);
+}
+
+/**
+ * Test that dimensionality reduction with incremental PCA works the same way
+ * MATLAB does, even with minibatches of two points.
+ */
+BOOST_AUTO_TEST_CASE(IncrementalPCADimensionalityReductionTest)
+{
+  IncrementalSVDPolicy decomposition(2);
+  PCADimensionalityReduction<IncrementalSVDPolicy>(false, decomposition);
+}
+
+/**
+ * Test that incremental PCA only keeps the requested components (plus the
+ * oversampling) and that dimensionality reduction still works then.
+ */
+BOOST_AUTO_TEST_CASE(IncrementalPCATruncatedTest)
+{
+  arma::mat data = arma::randu<arma::mat>(30, 500);
+  arma::mat exactData(data);
+
+  PCA<ExactSVDPolicy> exactPCA;
+  exactPCA.Apply(exactData, 5);
+
+  IncrementalSVDPolicy decomposition(50, 0);
+  PCA<IncrementalSVDPolicy> incrementalPCA(false, decomposition);
+  incrementalPCA.Apply(data, 5);
+
+  BOOST_REQUIRE_EQUAL(data.n_rows, 5);
+  BOOST_REQUIRE_EQUAL(data.n_cols, 500);
+
+  // Without oversampling, the components are only approximate, but the
+  // variance of the projections should be close to the exact one.
+  for (size_t i = 0; i < 5; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(arma::var(data.row(i)), arma::var(exactData.row(i)),
+        10.0);
+  }
+}
+
+/**
+ * Test that the incremental SVD policy gives the exact principal components of
+ * a stream of points, and projects new points onto them.
+ */
+BOOST_AUTO_TEST_CASE(IncrementalSVDPolicyStreamTest)
+{
+  arma::mat data = arma::randu<arma::mat>(4, 1000);
+  data.row(1) *= 3.0;
+  data.row(2) += 10.0;
+
+  IncrementalSVDPolicy ipca;
+  ipca.Reset(0);
+  for (size_t begin = 0; begin < data.n_cols; begin += 64)
+  {
+    const size_t end = std::min(begin + 64, (size_t) data.n_cols);
+    ipca.Update(data.cols(begin, end - 1));
+  }
+
+  BOOST_REQUIRE_EQUAL(ipca.NumPoints(), 1000);
+  CheckMatrices(ipca.Mean(), arma::mean(data, 1), 1e-5);
+
+  // The eigenvalues are those of the covariance matrix.
+  arma::vec eigVal;
+  arma::mat eigvec;
+  arma::eig_sym(eigVal, eigvec, arma::cov(data.t()));
+  eigVal = arma::flipud(eigVal);
+  CheckMatrices(ipca.EigenValues(), eigVal, 1e-5);
+
+  // Projecting the data gives the right variance in each component.
+  arma::mat transformed;
+  ipca.Transform(data, transformed);
+  BOOST_REQUIRE_EQUAL(transformed.n_rows, 4);
+  for (size_t i = 0; i < 4; ++i)
+  {
+    BOOST_REQUIRE_SMALL(arma::mean(transformed.row(i)), 1e-8);
+    BOOST_REQUIRE_CLOSE(arma::var(transformed.row(i)), eigVal[i], 1e-5);
+  }
+
+  // Points of the wrong dimensionality are rejected.
+  BOOST_REQUIRE_THROW(ipca.Update(arma::randu<arma::mat>(3, 10)),
+      std::invalid_argument);
+  BOOST_REQUIRE_THROW(ipca.Transform(arma::randu<arma::mat>(3, 10),
+      transformed), std::invalid_argument);
+}
+
 /**
  * Test that setting the variance retained parameter to perform dimensionality
  * reduction works using the exact svd PCA method.
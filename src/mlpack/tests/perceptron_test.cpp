@@ -183,6 +183,31 @@ BOOST_AUTO_TEST_CASE(Random3)
     BOOST_CHECK_EQUAL(predictedLabels(0, i), 0);
 }
 
+/**
+ * This tests the convergence of the perceptron trained with batches of points
+ * on a set of linearly separable data with 3 classes.
+ */
+BOOST_AUTO_TEST_CASE(Random3Batch)
+{
+  mat trainData;
+  trainData << 0 << 1 << 1 << 4 << 5 << 4 << 1 << 2 << 1 << endr
+            << 1 << 0 << 1 << 1 << 1 << 2 << 4 << 5 << 4 << endr;
+
+  Mat<size_t> labels;
+  labels << 0 << 0 << 0 << 1 << 1 << 1 << 2 << 2 << 2;
+
+  Perceptron<> p(3, 2, 1000);
+  p.BatchSize() = 4;
+  p.Train(trainData, labels.row(0), 3);
+
+  Row<size_t> predictedLabels;
+  p.Classify(trainData, predictedLabels);
+
+  BOOST_REQUIRE_EQUAL(predictedLabels.n_elem, trainData.n_cols);
+  for (size_t i = 0; i < predictedLabels.n_cols; i++)
+    BOOST_CHECK_EQUAL(predictedLabels(0, i), labels(0, i));
+}
+
 /**
  * This tests the convergence of the perceptron on a dataset which has only TWO
  * points which belong to different classes.
@@ -0,0 +1,172 @@
+/**
+ * @file tests/pq_test.cpp
+ *
+ * Unit tests for the 'PQSearch' class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
+#include <boost/test/unit_test.hpp>
+#include "test_tools.hpp"
+#include "serialization.hpp"
+
+#include <mlpack/methods/pq/pq_search.hpp>
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
+
+using namespace std;
+using namespace mlpack;
+using namespace mlpack::neighbor;
+
+BOOST_AUTO_TEST_SUITE(PQTest);
+
+/**
+ * Test that the compressed codes find many of the true nearest neighbors, and
+ * that re-ranking a shortlist finds more of them with the exact distances.
+ */
+BOOST_AUTO_TEST_CASE(PQRecallTest)
+{
+  const size_t k = 10;
+  arma::mat rdata(16, 2000, arma::fill::randu);
+  arma::mat qdata(16, 100, arma::fill::randu);
+
+  KNN knn(rdata);
+  arma::Mat<size_t> groundTruth;
+  arma::mat groundDistances;
+  knn.Search(qdata, k, groundTruth, groundDistances);
+
+  PQSearch<> pq(rdata, 8, 64, 0, true);
+  BOOST_REQUIRE_EQUAL(pq.Codes().n_rows, 8);
+  BOOST_REQUIRE_EQUAL(pq.Codes().n_cols, 2000);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  pq.Search(qdata, k, neighbors, distances);
+  const double recall = PQSearch<>::ComputeRecall(neighbors, groundTruth);
+
+  pq.Search(qdata, k, neighbors, distances, 1, 200);
+  const double rerankedRecall = PQSearch<>::ComputeRecall(neighbors,
+      groundTruth);
+
+  BOOST_REQUIRE_GE(recall, 0.3);
+  BOOST_REQUIRE_GE(rerankedRecall, 0.9);
+  BOOST_REQUIRE_GE(rerankedRecall, recall);
+
+  // The re-ranked distances are exact, in increasing order.
+  for (size_t i = 0; i < qdata.n_cols; ++i)
+  {
+    for (size_t j = 0; j < k; ++j)
+    {
+      BOOST_REQUIRE_CLOSE(distances(j, i), metric::EuclideanDistance::Evaluate(
+          qdata.col(i), rdata.col(neighbors(j, i))), 1e-5);
+      if (j > 0)
+        BOOST_REQUIRE_LE(distances(j - 1, i), distances(j, i));
+    }
+  }
+}
+
+/**
+ * Test the inverted file: every point is in exactly one list, with the code
+ * Encode() gives it, and probing every list finds more neighbors than probing
+ * one.
+ */
+BOOST_AUTO_TEST_CASE(PQInvertedFileTest)
+{
+  const size_t k = 5;
+  arma::mat rdata(8, 1000, arma::fill::randu);
+  arma::mat qdata(8, 50, arma::fill::randu);
+
+  KNN knn(rdata);
+  arma::Mat<size_t> groundTruth;
+  arma::mat groundDistances;
+  knn.Search(qdata, k, groundTruth, groundDistances);
+
+  PQSearch<> pq(rdata, 4, 32, 10, true);
+  BOOST_REQUIRE_EQUAL(pq.NumLists(), 10);
+  BOOST_REQUIRE_EQUAL(pq.ListOffsets()[10], 1000);
+
+  arma::Mat<unsigned char> codes;
+  arma::Row<size_t> lists;
+  pq.Encode(rdata, codes, lists);
+
+  arma::Col<size_t> seen(1000, arma::fill::zeros);
+  for (size_t l = 0; l < 10; ++l)
+  {
+    for (size_t pos = pq.ListOffsets()[l]; pos < pq.ListOffsets()[l + 1];
+        ++pos)
+    {
+      const size_t index = pq.ListIndices()[pos];
+      ++seen[index];
+      BOOST_REQUIRE_EQUAL(lists[index], l);
+      for (size_t j = 0; j < 4; ++j)
+        BOOST_REQUIRE_EQUAL(pq.Codes()(j, pos), codes(j, index));
+    }
+  }
+  BOOST_REQUIRE_EQUAL(arma::accu(seen == 1), 1000);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  pq.Search(qdata, k, neighbors, distances, 1, 50);
+  const double recall = PQSearch<>::ComputeRecall(neighbors, groundTruth);
+  pq.Search(qdata, k, neighbors, distances, 10, 50);
+  const double fullRecall = PQSearch<>::ComputeRecall(neighbors, groundTruth);
+
+  BOOST_REQUIRE_GE(fullRecall, recall);
+  BOOST_REQUIRE_GE(fullRecall, 0.9);
+}
+
+/**
+ * Make sure that a serialized model gives the same results.
+ */
+BOOST_AUTO_TEST_CASE(PQSerializationTest)
+{
+  arma::mat rdata(6, 500, arma::fill::randu);
+  arma::mat qdata(6, 50, arma::fill::randu);
+
+  PQSearch<> pq(rdata, 3, 16, 4, true);
+  PQSearch<> xmlPq, textPq, binaryPq;
+  SerializeObjectAll(pq, xmlPq, textPq, binaryPq);
+
+  arma::Mat<size_t> neighbors, xmlNeighbors, textNeighbors, binaryNeighbors;
+  arma::mat distances, xmlDistances, textDistances, binaryDistances;
+  pq.Search(qdata, 5, neighbors, distances, 2, 20);
+  xmlPq.Search(qdata, 5, xmlNeighbors, xmlDistances, 2, 20);
+  textPq.Search(qdata, 5, textNeighbors, textDistances, 2, 20);
+  binaryPq.Search(qdata, 5, binaryNeighbors, binaryDistances, 2, 20);
+
+  CheckMatrices(neighbors, xmlNeighbors, textNeighbors, binaryNeighbors);
+  CheckMatrices(distances, xmlDistances, textDistances, binaryDistances);
+}
+
+/**
+ * Make sure that invalid parameters throw.
+ */
+BOOST_AUTO_TEST_CASE(PQInvalidParametersTest)
+{
+  arma::mat rdata(4, 100, arma::fill::randu);
+  arma::mat qdata(3, 10, arma::fill::randu);
+
+  PQSearch<> pq;
+  BOOST_REQUIRE_THROW(pq.Train(rdata, 0), std::invalid_argument);
+  BOOST_REQUIRE_THROW(pq.Train(rdata, 5), std::invalid_argument);
+  BOOST_REQUIRE_THROW(pq.Train(rdata, 2, 257), std::invalid_argument);
+  BOOST_REQUIRE_THROW(pq.Train(rdata, 2, 200), std::invalid_argument);
+
+  pq.Train(rdata, 2, 16);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  BOOST_REQUIRE_THROW(pq.Search(qdata, 1, neighbors, distances),
+      std::invalid_argument);
+  BOOST_REQUIRE_THROW(pq.Search(rdata, 101, neighbors, distances),
+      std::invalid_argument);
+
+  // The reference set was not kept, so there is nothing to re-rank with.
+  BOOST_REQUIRE_THROW(pq.Search(rdata, 1, neighbors, distances, 1, 10),
+      std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
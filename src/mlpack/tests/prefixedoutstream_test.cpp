@@ -11,6 +11,7 @@
  */
 #include <iostream>
 #include <sstream>
+#include <thread>
 
 #include <mlpack/core.hpp>
 
@@ -239,4 +240,100 @@ BOOST_AUTO_TEST_CASE(TestArmaCustomPrecision)
       BASH_GREEN "[INFO ] " BASH_CLEAR "   4.0000   4.5000   5.0000\n");
 }
 
+/**
+ * A type that counts how many times it is formatted.
+ */
+struct CountedOutput
+{
+  mutable size_t count = 0;
+};
+
+std::ostream& operator<<(std::ostream& os, const CountedOutput& c)
+{
+  ++c.count;
+  return os << "counted";
+}
+
+/**
+ * Make sure that nothing is formatted for a stream that is not shown.
+ */
+BOOST_AUTO_TEST_CASE(TestIgnoredPrefixedOutStream)
+{
+  std::stringstream ss;
+  PrefixedOutStream pss(ss, BASH_GREEN "[INFO ] " BASH_CLEAR, true);
+
+  CountedOutput c;
+  pss << c << std::endl;
+  BOOST_REQUIRE_EQUAL(c.count, 0);
+  BOOST_REQUIRE_EQUAL(ss.str(), "");
+
+  pss.ignoreInput = false;
+  pss << c << std::endl;
+  BOOST_REQUIRE_EQUAL(c.count, 1);
+  BOOST_REQUIRE_EQUAL(ss.str(),
+      BASH_GREEN "[INFO ] " BASH_CLEAR "counted\n");
+}
+
+/**
+ * Test that the output of a PrefixedOutStream with a sink is the same as
+ * without it, once the sink is flushed.
+ */
+BOOST_AUTO_TEST_CASE(TestAsyncPrefixedOutStream)
+{
+  std::stringstream ss;
+  AsyncLogSink sink(4);
+  PrefixedOutStream pss(ss, BASH_GREEN "[INFO ] " BASH_CLEAR);
+  pss.sink = &sink;
+
+  std::string expected;
+  for (size_t i = 0; i < 100; ++i)
+  {
+    pss << "Line " << i << "." << std::endl;
+    expected += BASH_GREEN "[INFO ] " BASH_CLEAR "Line " +
+        std::to_string(i) + ".\n";
+  }
+
+  // Manipulators are applied to the destination in order.
+  pss << "Value: " << std::fixed << std::setprecision(2) << 1.5 << std::endl;
+  expected += BASH_GREEN "[INFO ] " BASH_CLEAR "Value: 1.50\n";
+
+  sink.Flush();
+  BOOST_REQUIRE_EQUAL(sink.Capacity(), 4);
+  BOOST_REQUIRE_EQUAL(ss.str(), expected);
+}
+
+/**
+ * Push text to a sink from several threads, and make sure all of it is
+ * written.
+ */
+BOOST_AUTO_TEST_CASE(TestAsyncLogSinkThreads)
+{
+  std::stringstream ss;
+  {
+    AsyncLogSink sink(16);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < 4; ++t)
+    {
+      threads.push_back(std::thread([&sink, &ss, t]()
+      {
+        for (size_t i = 0; i < 1000; ++i)
+          sink.Push(ss, std::to_string(t) + "\n");
+      }));
+    }
+
+    for (size_t t = 0; t < threads.size(); ++t)
+      threads[t].join();
+
+    // The destructor writes whatever is still queued.
+  }
+
+  std::vector<size_t> counts(4, 0);
+  std::string line;
+  while (std::getline(ss, line))
+    ++counts[std::stoul(line)];
+
+  for (size_t t = 0; t < counts.size(); ++t)
+    BOOST_REQUIRE_EQUAL(counts[t], 1000);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
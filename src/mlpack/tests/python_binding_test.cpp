@@ -12,6 +12,8 @@
 #include <mlpack/core.hpp>
 #include <mlpack/bindings/python/py_option.hpp>
 
+#include <thread>
+
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
 
@@ -105,4 +107,101 @@ BOOST_AUTO_TEST_CASE(GetParamMatTest)
  * All of the other functions are implicitly tested simply by compilation.
  */
 
+/**
+ * Make sure that parameters set inside a CLI::ScopedContext are only seen by
+ * that context, even when several threads use contexts at once.
+ */
+BOOST_AUTO_TEST_CASE(ScopedContextTest)
+{
+  CLI::ClearSettings();
+  programName = "context_test";
+  PyOption<double> po(0.0, "value", "A value.", "", "double", false, true,
+      false);
+
+  std::vector<double> results(8, 0.0);
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < results.size(); ++t)
+  {
+    threads.push_back(std::thread([&results, t]()
+    {
+      CLI::ScopedContext context;
+      CLI::RestoreSettings("context_test");
+      CLI::GetParam<double>("value") = (double) t;
+      CLI::SetPassed("value");
+
+      for (size_t i = 0; i < 1000; ++i)
+        std::this_thread::yield();
+
+      if (CLI::HasParam("value"))
+        results[t] = CLI::GetParam<double>("value");
+    }));
+  }
+  for (size_t t = 0; t < threads.size(); ++t)
+    threads[t].join();
+
+  for (size_t t = 0; t < results.size(); ++t)
+    BOOST_REQUIRE_EQUAL(results[t], (double) t);
+
+  // Nothing was set outside of the contexts.
+  BOOST_REQUIRE_EQUAL(CLI::Parameters().count("value"), 0);
+
+  CLI::ClearSettings();
+}
+
+/**
+ * Make sure that seeding the random generators and muting Log::Info inside a
+ * CLI::ScopedContext only affects the thread of the context.
+ */
+BOOST_AUTO_TEST_CASE(ScopedContextRandomAndVerbosityTest)
+{
+  const bool ignoring = Log::Info.ignoreInput;
+  Log::Info.ignoreInput = false;
+
+  // Numbers drawn with a given seed when no other thread draws any.
+  std::vector<double> expected(100);
+  {
+    CLI::ScopedContext context;
+    math::RandomSeed(42);
+    for (size_t i = 0; i < expected.size(); ++i)
+      expected[i] = math::Random();
+  }
+
+  std::vector<std::vector<double>> results(8);
+  // (Not std::vector<bool>, whose elements can't be written concurrently.)
+  std::vector<int> muted(8, 0);
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < results.size(); ++t)
+  {
+    threads.push_back(std::thread([&results, &muted, t]()
+    {
+      CLI::ScopedContext context;
+      Log::Info.SetIgnoreInput(t % 2 == 0);
+      math::RandomSeed((t % 2 == 0) ? 42 : t);
+
+      for (size_t i = 0; i < 100; ++i)
+      {
+        results[t].push_back(math::Random());
+        std::this_thread::yield();
+      }
+
+      muted[t] = Log::Info.IgnoreInput() ? 1 : 0;
+    }));
+  }
+  for (size_t t = 0; t < threads.size(); ++t)
+    threads[t].join();
+
+  for (size_t t = 0; t < results.size(); t += 2)
+  {
+    BOOST_REQUIRE_EQUAL(muted[t], 1);
+    BOOST_REQUIRE_EQUAL(muted[t + 1], 0);
+    for (size_t i = 0; i < expected.size(); ++i)
+      BOOST_REQUIRE_EQUAL(results[t][i], expected[i]);
+  }
+
+  // Log::Info is not muted outside of the contexts.
+  BOOST_REQUIRE_EQUAL(Log::Info.IgnoreInput(), false);
+
+  Log::Info.ignoreInput = ignoring;
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -441,4 +441,48 @@ BOOST_AUTO_TEST_CASE(DoublePoleCartWithDQN)
   BOOST_REQUIRE_EQUAL(success, true);
 }
 
+/**
+ * Run lockstep episodes in several copies of Cart Pole, and make sure that
+ * every copy runs its own episode and that the steps are counted only in
+ * training mode.
+ */
+BOOST_AUTO_TEST_CASE(CartPoleVectorEnvironmentEpisodesTest)
+{
+  SimpleDQN<> model(4, 32, 32, 2);
+  GreedyPolicy<CartPole> policy(1.0, 1000, 0.1, 0.99);
+  RandomReplay<CartPole> replayMethod(10, 10000);
+
+  TrainingConfig config;
+  config.StepSize() = 0.01;
+  config.Discount() = 0.9;
+  config.TargetNetworkSyncInterval() = 100;
+  config.ExplorationSteps() = 20;
+  config.StepLimit() = 50;
+
+  QLearning<CartPole, decltype(model), AdamUpdate, decltype(policy)>
+      agent(std::move(config), std::move(model), std::move(policy),
+      std::move(replayMethod));
+
+  size_t totalSteps = 0;
+  for (size_t trial = 0; trial < 5; ++trial)
+  {
+    arma::vec returns = agent.Episodes(8);
+    BOOST_REQUIRE_EQUAL(returns.n_elem, 8);
+    for (size_t i = 0; i < returns.n_elem; ++i)
+    {
+      BOOST_REQUIRE_GE(returns[i], 0.0);
+      BOOST_REQUIRE_LE(returns[i], 50.0);
+    }
+
+    // Each copy takes at least one step.
+    BOOST_REQUIRE_GE(agent.TotalSteps(), totalSteps + 8);
+    BOOST_REQUIRE_LE(agent.TotalSteps(), totalSteps + 8 * 50);
+    totalSteps = agent.TotalSteps();
+  }
+
+  agent.Deterministic() = true;
+  agent.Episodes(4);
+  BOOST_REQUIRE_EQUAL(agent.TotalSteps(), totalSteps);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
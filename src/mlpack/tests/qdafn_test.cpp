@@ -208,4 +208,34 @@ BOOST_AUTO_TEST_CASE(SparseTest)
   BOOST_REQUIRE_EQUAL(distances.n_cols, 1000);
 }
 
+/**
+ * Make sure that searching a batch of queries at once gives the same results
+ * as searching each query on its own.
+ */
+BOOST_AUTO_TEST_CASE(QDAFNBatchSearchTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(8, 1000);
+  arma::mat querySet = arma::randu<arma::mat>(8, 200);
+
+  QDAFN<> qdafn(dataset, 10, 30);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  qdafn.Search(querySet, 1, neighbors, distances);
+
+  BOOST_REQUIRE_EQUAL(neighbors.n_cols, 200);
+  for (size_t q = 0; q < querySet.n_cols; ++q)
+  {
+    arma::Mat<size_t> singleNeighbors;
+    arma::mat singleDistances;
+    qdafn.Search(arma::mat(querySet.col(q)), 1, singleNeighbors,
+        singleDistances);
+
+    BOOST_REQUIRE_EQUAL(neighbors(0, q), singleNeighbors(0, 0));
+    BOOST_REQUIRE_CLOSE(distances(0, q), singleDistances(0, 0), 1e-5);
+    BOOST_REQUIRE_CLOSE(distances(0, q), metric::EuclideanDistance::Evaluate(
+        querySet.col(q), dataset.col(neighbors(0, q))), 1e-5);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
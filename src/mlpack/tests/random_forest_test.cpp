@@ -11,6 +11,7 @@
  */
 #include <mlpack/core.hpp>
 #include <mlpack/methods/random_forest/random_forest.hpp>
+#include <mlpack/methods/random_forest/flat_forest.hpp>
 #include <mlpack/methods/decision_tree/random_dimension_select.hpp>
 
 #include <boost/test/unit_test.hpp>
@@ -96,6 +97,38 @@ BOOST_AUTO_TEST_CASE(BootstrapWeightsTest)
   }
 }
 
+/**
+ * Make sure the bootstrap indices are in the dataset, and the labels and
+ * weights of the sample are those of the points.
+ */
+BOOST_AUTO_TEST_CASE(BootstrapIndicesTest)
+{
+  arma::mat dataset(1, 1000);
+  arma::Row<size_t> labels = arma::linspace<arma::Row<size_t>>(0, 999, 1000);
+  arma::rowvec weights(1000, arma::fill::randu);
+
+  for (size_t trial = 0; trial < 5; ++trial)
+  {
+    arma::uvec indices;
+    arma::Row<size_t> bootstrapLabels;
+    arma::rowvec bootstrapWeights;
+
+    BootstrapIndices<true>(dataset, labels, weights, indices, bootstrapLabels,
+        bootstrapWeights);
+
+    BOOST_REQUIRE_EQUAL(indices.n_elem, 1000);
+    BOOST_REQUIRE_EQUAL(bootstrapLabels.n_elem, 1000);
+    BOOST_REQUIRE_EQUAL(bootstrapWeights.n_elem, 1000);
+
+    for (size_t i = 0; i < indices.n_elem; ++i)
+    {
+      BOOST_REQUIRE_LT(indices[i], 1000);
+      BOOST_REQUIRE_EQUAL(bootstrapLabels[i], indices[i]);
+      BOOST_REQUIRE_EQUAL(bootstrapWeights[i], weights[indices[i]]);
+    }
+  }
+}
+
 /**
  * Make sure an empty forest cannot predict.
  */
@@ -487,4 +520,233 @@ BOOST_AUTO_TEST_CASE(DifferentTreesTest)
   BOOST_REQUIRE_EQUAL(success, true);
 }
 
+/**
+ * Make sure that a FlatForest gives the same predictions and probabilities as
+ * the random forest and the decision tree it was built from.
+ */
+BOOST_AUTO_TEST_CASE(FlatForestMatchesForestTest)
+{
+  arma::mat dataset;
+  data::Load("vc2.csv", dataset);
+  arma::Row<size_t> labels;
+  data::Load("vc2_labels.txt", labels);
+  arma::mat testDataset;
+  data::Load("vc2_test.csv", testDataset);
+
+  RandomForest<> rf(dataset, labels, 3, 20 /* 20 trees */, 1);
+  FlatForest flat(rf);
+  BOOST_REQUIRE_EQUAL(flat.NumTrees(), 20);
+  BOOST_REQUIRE_EQUAL(flat.NumClasses(), 3);
+
+  // Use a block size that does not divide the number of points.
+  flat.BlockSize() = 7;
+
+  arma::Row<size_t> predictions, flatPredictions;
+  arma::mat probabilities, flatProbabilities;
+  rf.Classify(testDataset, predictions, probabilities);
+  flat.Classify(testDataset, flatPredictions, flatProbabilities);
+  CheckMatrices(predictions, flatPredictions);
+  CheckMatrices(probabilities, flatProbabilities);
+
+  for (size_t i = 0; i < testDataset.n_cols; ++i)
+    BOOST_REQUIRE_EQUAL(flat.Classify(testDataset.col(i)), predictions[i]);
+
+  // A forest on categorical data.
+  arma::mat d;
+  arma::Row<size_t> l;
+  data::DatasetInfo di;
+  MockCategoricalData(d, l, di);
+
+  RandomForest<> crf(d, di, l, 5, 10 /* 10 trees */, 5);
+  FlatForest cflat(crf);
+  crf.Classify(d, predictions, probabilities);
+  cflat.Classify(d, flatPredictions, flatProbabilities);
+  CheckMatrices(predictions, flatPredictions);
+  CheckMatrices(probabilities, flatProbabilities);
+
+  // A single decision tree.
+  DecisionTree<> tree(d, di, l, 5, 10);
+  FlatForest tflat(tree);
+  BOOST_REQUIRE_EQUAL(tflat.NumTrees(), 1);
+  tree.Classify(d, predictions, probabilities);
+  tflat.Classify(d, flatPredictions, flatProbabilities);
+  CheckMatrices(predictions, flatPredictions);
+  CheckMatrices(probabilities, flatProbabilities);
+}
+
+/**
+ * Make sure we can serialize a FlatForest.
+ */
+BOOST_AUTO_TEST_CASE(FlatForestSerializationTest)
+{
+  arma::mat dataset;
+  data::Load("vc2.csv", dataset);
+  arma::Row<size_t> labels;
+  data::Load("vc2_labels.txt", labels);
+
+  RandomForest<> rf(dataset, labels, 3, 10 /* 10 trees */, 1);
+  FlatForest flat(rf);
+
+  arma::Row<size_t> beforePredictions;
+  arma::mat beforeProbabilities;
+  flat.Classify(dataset, beforePredictions, beforeProbabilities);
+
+  FlatForest xmlFlat, textFlat, binaryFlat;
+  SerializeObjectAll(flat, xmlFlat, textFlat, binaryFlat);
+
+  arma::Row<size_t> xmlPredictions, textPredictions, binaryPredictions;
+  arma::mat xmlProbabilities, textProbabilities, binaryProbabilities;
+  xmlFlat.Classify(dataset, xmlPredictions, xmlProbabilities);
+  textFlat.Classify(dataset, textPredictions, textProbabilities);
+  binaryFlat.Classify(dataset, binaryPredictions, binaryProbabilities);
+
+  CheckMatrices(beforePredictions, xmlPredictions, textPredictions,
+      binaryPredictions);
+  CheckMatrices(beforeProbabilities, xmlProbabilities, textProbabilities,
+      binaryProbabilities);
+}
+
+/**
+ * Make sure that merging two forests gives a forest whose predictions average
+ * those of the two forests, as if all the trees were trained at once.
+ */
+BOOST_AUTO_TEST_CASE(RandomForestMergeTest)
+{
+  arma::mat dataset;
+  data::Load("vc2.csv", dataset);
+  arma::Row<size_t> labels;
+  data::Load("vc2_labels.txt", labels);
+  arma::mat testDataset;
+  data::Load("vc2_test.csv", testDataset);
+
+  // Train the two pieces of the forest with different seeds, as they would be
+  // on different machines.
+  math::RandomSeed(1);
+  RandomForest<> rf1(dataset, labels, 3, 5 /* 5 trees */, 1);
+  math::RandomSeed(2);
+  RandomForest<> rf2(dataset, labels, 3, 7 /* 7 trees */, 1);
+
+  arma::Row<size_t> predictions;
+  arma::mat probabilities1, probabilities2, probabilities;
+  rf1.Classify(testDataset, predictions, probabilities1);
+  rf2.Classify(testDataset, predictions, probabilities2);
+
+  RandomForest<> merged(rf1);
+  merged.Merge(rf2);
+  BOOST_REQUIRE_EQUAL(merged.NumTrees(), 12);
+  BOOST_REQUIRE_EQUAL(rf2.NumTrees(), 7);
+
+  merged.Classify(testDataset, predictions, probabilities);
+  CheckMatrices(probabilities, (5 * probabilities1 + 7 * probabilities2) / 12);
+
+  // Moving the trees gives the same forest and empties the other forest.
+  rf1.Merge(std::move(rf2));
+  BOOST_REQUIRE_EQUAL(rf1.NumTrees(), 12);
+  BOOST_REQUIRE_EQUAL(rf2.NumTrees(), 0);
+
+  arma::Row<size_t> movedPredictions;
+  arma::mat movedProbabilities;
+  rf1.Classify(testDataset, movedPredictions, movedProbabilities);
+  CheckMatrices(predictions, movedPredictions);
+  CheckMatrices(probabilities, movedProbabilities);
+
+  // Merging into an empty forest gives the other forest.
+  RandomForest<> empty;
+  empty.Merge(merged);
+  BOOST_REQUIRE_EQUAL(empty.NumTrees(), 12);
+}
+
+/**
+ * Make sure that forests trained for different numbers of classes can't be
+ * merged.
+ */
+BOOST_AUTO_TEST_CASE(RandomForestMergeDifferentClassesTest)
+{
+  arma::mat dataset;
+  data::Load("vc2.csv", dataset);
+  arma::Row<size_t> labels;
+  data::Load("vc2_labels.txt", labels);
+
+  RandomForest<> rf1(dataset, labels, 3, 2, 1);
+  RandomForest<> rf2(dataset, labels, 4, 2, 1);
+
+  BOOST_REQUIRE_THROW(rf1.Merge(rf2), std::invalid_argument);
+  BOOST_REQUIRE_EQUAL(rf1.NumTrees(), 2);
+}
+
+/**
+ * Make sure that a warm start adds trees to the forest without retraining the
+ * existing trees.
+ */
+BOOST_AUTO_TEST_CASE(RandomForestWarmStartTest)
+{
+  arma::mat dataset;
+  data::Load("vc2.csv", dataset);
+  arma::Row<size_t> labels;
+  data::Load("vc2_labels.txt", labels);
+  arma::mat testDataset;
+  data::Load("vc2_test.csv", testDataset);
+
+  RandomForest<> rf(dataset, labels, 3, 5 /* 5 trees */, 1);
+  RandomForest<> original(rf);
+
+  const double entropy = rf.Train(dataset, labels, 3, 4 /* 4 trees */, 1,
+      1e-7, 0, MultipleRandomDimensionSelect(), true);
+  BOOST_REQUIRE_EQUAL(rf.NumTrees(), 9);
+  BOOST_REQUIRE(std::isfinite(entropy));
+
+  // The existing trees are unchanged.
+  for (size_t i = 0; i < original.NumTrees(); ++i)
+  {
+    arma::Row<size_t> predictions, originalPredictions;
+    arma::mat probabilities, originalProbabilities;
+    rf.Tree(i).Classify(testDataset, predictions, probabilities);
+    original.Tree(i).Classify(testDataset, originalPredictions,
+        originalProbabilities);
+    CheckMatrices(predictions, originalPredictions);
+    CheckMatrices(probabilities, originalProbabilities);
+  }
+
+  // New trees must have the same number of classes.
+  BOOST_REQUIRE_THROW(rf.Train(dataset, labels, 4, 2, 1, 1e-7, 0,
+      MultipleRandomDimensionSelect(), true), std::invalid_argument);
+  BOOST_REQUIRE_EQUAL(rf.NumTrees(), 9);
+
+  // Without a warm start, the forest is replaced.
+  rf.Train(dataset, labels, 3, 2, 1);
+  BOOST_REQUIRE_EQUAL(rf.NumTrees(), 2);
+}
+
+/**
+ * Make sure that the batch classification with probabilities gives the same
+ * results as the classification of each point.
+ */
+BOOST_AUTO_TEST_CASE(RandomForestBatchProbabilitiesTest)
+{
+  arma::mat dataset;
+  data::Load("vc2.csv", dataset);
+  arma::Row<size_t> labels;
+  data::Load("vc2_labels.txt", labels);
+
+  RandomForest<> rf(dataset, labels, 3, 10 /* 10 trees */, 1);
+
+  arma::Row<size_t> predictions;
+  arma::mat probabilities;
+  rf.Classify(dataset, predictions, probabilities);
+  BOOST_REQUIRE_EQUAL(predictions.n_elem, dataset.n_cols);
+  BOOST_REQUIRE_EQUAL(probabilities.n_rows, 3);
+  BOOST_REQUIRE_EQUAL(probabilities.n_cols, dataset.n_cols);
+
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    size_t prediction;
+    arma::vec pointProbabilities;
+    rf.Classify(dataset.col(i), prediction, pointProbabilities);
+
+    BOOST_REQUIRE_EQUAL(predictions[i], prediction);
+    for (size_t c = 0; c < 3; ++c)
+      BOOST_REQUIRE_CLOSE(probabilities(c, i), pointProbabilities[c], 1e-5);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
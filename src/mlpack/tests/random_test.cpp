@@ -97,4 +97,129 @@ BOOST_AUTO_TEST_CASE(WeightedRandomTest)
   }
 }
 
+// Make sure the Philox4x32 generator gives the known answers of its reference
+// implementation.
+BOOST_AUTO_TEST_CASE(Philox4x32KnownAnswerTest)
+{
+  Philox4x32 engine;
+  BOOST_REQUIRE_EQUAL(engine(), 0x6627e8d5);
+  BOOST_REQUIRE_EQUAL(engine(), 0xe169c58d);
+  BOOST_REQUIRE_EQUAL(engine(), 0xbc57ac4c);
+  BOOST_REQUIRE_EQUAL(engine(), 0x9b00dbd8);
+  BOOST_REQUIRE_EQUAL(engine.NextBlock(), 1);
+
+  // Computing a block directly gives the same numbers.
+  uint32_t output[4];
+  Philox4x32 other;
+  other.Block(0, output);
+  BOOST_REQUIRE_EQUAL(output[0], 0x6627e8d5);
+  BOOST_REQUIRE_EQUAL(output[3], 0x9b00dbd8);
+
+  // Computing several blocks at once gives the same numbers too.
+  Philox4x32 keyed(0x123456789ABCDEF, 7);
+  uint32_t blocks[4 * 11];
+  keyed.Blocks(5, 11, blocks);
+  for (size_t b = 0; b < 11; ++b)
+  {
+    keyed.Block(5 + b, output);
+    for (size_t i = 0; i < 4; ++i)
+      BOOST_REQUIRE_EQUAL(blocks[4 * b + i], output[i]);
+  }
+}
+
+// Make sure random streams are reproducible, and that different streams give
+// different numbers.
+BOOST_AUTO_TEST_CASE(RandomStreamReproducibleTest)
+{
+  RandomSeed(42);
+  RandomStream a = TaskRandomStream(3);
+  RandomStream b = TaskRandomStream(3);
+  RandomStream c = TaskRandomStream(4);
+
+  size_t same = 0;
+  for (size_t i = 0; i < 100; ++i)
+  {
+    const double x = a.Random();
+    BOOST_REQUIRE_EQUAL(x, b.Random());
+    if (x == c.Random())
+      ++same;
+  }
+  BOOST_REQUIRE_LT(same, 5);
+
+  // Filling a matrix (in parallel) gives the same numbers every time.
+  arma::mat x(13, 17), y(13, 17);
+  RandomStream(5, 1).Randu(x);
+  RandomStream(5, 1).Randu(y);
+  BOOST_REQUIRE_GE(x.min(), 0.0);
+  BOOST_REQUIRE_LT(x.max(), 1.0);
+  CheckMatrices(x, y);
+}
+
+// Make sure random streams give numbers with the right distributions.
+BOOST_AUTO_TEST_CASE(RandomStreamDistributionTest)
+{
+  RandomStream stream(12, 34);
+  const size_t n = 100000;
+
+  arma::vec uniform(n), normal(n);
+  for (size_t i = 0; i < n; ++i)
+  {
+    uniform[i] = stream.Random(2.0, 4.0);
+    normal[i] = stream.RandNormal(1.0, 2.0);
+  }
+
+  BOOST_REQUIRE_GE(uniform.min(), 2.0);
+  BOOST_REQUIRE_LT(uniform.max(), 4.0);
+  BOOST_REQUIRE_CLOSE(arma::mean(uniform), 3.0, 1.0);
+  BOOST_REQUIRE_CLOSE(arma::mean(normal), 1.0, 2.0);
+  BOOST_REQUIRE_CLOSE(arma::stddev(normal), 2.0, 2.0);
+
+  arma::mat bulk(100, 1000);
+  stream.Randn(bulk);
+  BOOST_REQUIRE_SMALL(arma::mean(arma::vectorise(bulk)), 0.02);
+  BOOST_REQUIRE_CLOSE(arma::stddev(arma::vectorise(bulk)), 1.0, 2.0);
+
+  std::vector<size_t> counts(5, 0);
+  for (size_t i = 0; i < n; ++i)
+    counts[stream.RandInt(5)]++;
+  for (size_t i = 0; i < counts.size(); ++i)
+    BOOST_REQUIRE_CLOSE((double) counts[i] / n, 0.2, 5.0);
+}
+
+// Make sure a ThreadRandomScope replaces the global generator with one that
+// only depends on the task, and restores the global generator afterwards.
+BOOST_AUTO_TEST_CASE(ThreadRandomScopeTest)
+{
+  RandomSeed(7);
+  arma::vec global(10);
+  for (size_t i = 0; i < global.n_elem; ++i)
+    global[i] = Random();
+
+  RandomSeed(7);
+  arma::vec task(10), sameTask(10), otherTask(10);
+  {
+    ThreadRandomScope scope(2);
+    for (size_t i = 0; i < task.n_elem; ++i)
+      task[i] = (i % 2 == 0) ? Random() : RandNormal();
+  }
+
+  // The global generator hasn't been used.
+  for (size_t i = 0; i < global.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(Random(), global[i]);
+
+  {
+    ThreadRandomScope scope(2);
+    for (size_t i = 0; i < sameTask.n_elem; ++i)
+      sameTask[i] = (i % 2 == 0) ? Random() : RandNormal();
+  }
+  {
+    ThreadRandomScope scope(3);
+    for (size_t i = 0; i < otherTask.n_elem; ++i)
+      otherTask[i] = (i % 2 == 0) ? Random() : RandNormal();
+  }
+
+  CheckMatrices(task, sameTask);
+  CheckMatricesNotEqual(task, otherTask);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -64,4 +64,58 @@ BOOST_AUTO_TEST_CASE(RandomizedSVDReconstructionError)
   BOOST_REQUIRE_SMALL(error, 1e-5);
 }
 
+/**
+ * The randomized SVD of sparse and single-precision matrices should give the
+ * same singular values as the exact SVD of the centered data.
+ */
+BOOST_AUTO_TEST_CASE(RandomizedSVDSparseAndFloatTest)
+{
+  arma::mat U = arma::randn<arma::mat>(3, 20);
+  arma::mat V = arma::randn<arma::mat>(10, 3);
+
+  arma::mat R;
+  arma::qr_econ(U, R, U);
+  arma::qr_econ(V, R, V);
+
+  arma::mat data = arma::trans(U * arma::diagmat(arma::vec("1 0.1 0.01")) *
+      V.t());
+
+  arma::mat centeredData;
+  math::Center(data, centeredData);
+
+  arma::mat U1, V1;
+  arma::vec s1;
+  arma::svd_econ(U1, s1, V1, centeredData);
+
+  svd::RandomizedSVD rSVD(0, 10);
+
+  // Sparse double-precision data.
+  arma::mat U2, V2;
+  arma::vec s2;
+  rSVD.Apply(arma::sp_mat(data), U2, s2, V2, 3);
+
+  arma::vec s3 = s1.subvec(0, s2.n_elem - 1);
+  double error = arma::norm(s2 - s3, "frob") / arma::norm(s2, "frob");
+  BOOST_REQUIRE_SMALL(error, 1e-5);
+
+  arma::mat reconstruct = U2 * arma::diagmat(s2) * V2.t();
+  error = arma::norm(centeredData - reconstruct, "frob") /
+      arma::norm(centeredData, "frob");
+  BOOST_REQUIRE_SMALL(error, 1e-5);
+
+  // Dense and sparse single-precision data.
+  arma::fmat fU, fV;
+  arma::fvec fs;
+  rSVD.Apply(arma::conv_to<arma::fmat>::from(data), fU, fs, fV, 3);
+  error = arma::norm(arma::conv_to<arma::vec>::from(fs) - s3, "frob") /
+      arma::norm(s3, "frob");
+  BOOST_REQUIRE_SMALL(error, 1e-3);
+
+  rSVD.Apply(arma::sp_fmat(arma::conv_to<arma::fmat>::from(data)), fU, fs, fV,
+      3);
+  error = arma::norm(arma::conv_to<arma::vec>::from(fs) - s3, "frob") /
+      arma::norm(s3, "frob");
+  BOOST_REQUIRE_SMALL(error, 1e-3);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
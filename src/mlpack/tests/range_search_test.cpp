@@ -13,8 +13,10 @@
 #include <mlpack/methods/range_search/range_search.hpp>
 #include <mlpack/core/tree/cover_tree.hpp>
 #include <mlpack/methods/range_search/rs_model.hpp>
+#include <mlpack/core/metrics/mahalanobis_search.hpp>
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
+#include "serialization.hpp"
 
 using namespace mlpack;
 using namespace mlpack::range;
@@ -1417,6 +1419,68 @@ BOOST_AUTO_TEST_CASE(RSModelMonochromaticTest)
   }
 }
 
+/**
+ * Make sure that an RSModelType built on single-precision data gives the same
+ * results as naive search on that data, for a few tree types, both before and
+ * after serialization.
+ */
+BOOST_AUTO_TEST_CASE(FloatRSModelTest)
+{
+  typedef RSModelType<arma::fmat> FloatRSModel;
+
+  arma::fmat referenceData = arma::randu<arma::fmat>(5, 200);
+  arma::fmat queryData = arma::randu<arma::fmat>(5, 50);
+
+  // Get a baseline with naive search on the same float data.
+  RangeSearch<EuclideanDistance, arma::fmat> rs(referenceData, true);
+  vector<vector<size_t>> baselineNeighbors;
+  vector<vector<double>> baselineDistances;
+  rs.Search(queryData, math::Range(0.25, 0.75), baselineNeighbors,
+      baselineDistances);
+
+  vector<vector<pair<double, size_t>>> baselineSorted;
+  SortResults(baselineNeighbors, baselineDistances, baselineSorted);
+
+  const FloatRSModel::TreeTypes treeTypes[] = { FloatRSModel::KD_TREE,
+      FloatRSModel::COVER_TREE, FloatRSModel::BALL_TREE, FloatRSModel::R_TREE,
+      FloatRSModel::OCTREE };
+
+  for (size_t t = 0; t < 5; ++t)
+  {
+    FloatRSModel model(treeTypes[t]);
+    model.BuildModel(arma::fmat(referenceData), 5, false, false);
+
+    FloatRSModel xmlModel, textModel, binaryModel;
+    SerializeObjectAll(model, xmlModel, textModel, binaryModel);
+
+    FloatRSModel* models[] = { &model, &xmlModel, &textModel, &binaryModel };
+    for (size_t m = 0; m < 4; ++m)
+    {
+      BOOST_REQUIRE_EQUAL(models[m]->Dataset().n_cols, 200);
+
+      vector<vector<size_t>> neighbors;
+      vector<vector<double>> distances;
+      models[m]->Search(arma::fmat(queryData), math::Range(0.25, 0.75),
+          neighbors, distances);
+
+      vector<vector<pair<double, size_t>>> sorted;
+      SortResults(neighbors, distances, sorted);
+
+      BOOST_REQUIRE_EQUAL(sorted.size(), baselineSorted.size());
+      for (size_t k = 0; k < sorted.size(); ++k)
+      {
+        BOOST_REQUIRE_EQUAL(sorted[k].size(), baselineSorted[k].size());
+        for (size_t l = 0; l < sorted[k].size(); ++l)
+        {
+          BOOST_REQUIRE_EQUAL(sorted[k][l].second, baselineSorted[k][l].second);
+          BOOST_REQUIRE_CLOSE(sorted[k][l].first, baselineSorted[k][l].first,
+              1e-5);
+        }
+      }
+    }
+  }
+}
+
 /**
  * Make sure that the neighborPtr matrix isn't accidentally deleted.
  * See issue #478.
@@ -1696,4 +1760,420 @@ BOOST_AUTO_TEST_CASE(MoveOperatorNaiveTest)
   }
 }
 
+/**
+ * Make sure that Count() gives the sizes of the results of Search(), in every
+ * search mode, with and without a query set, and with a maximum count.
+ */
+template<template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void CheckCounts(const arma::mat& referenceData,
+                 const arma::mat& queryData,
+                 const math::Range& range)
+{
+  const size_t maxCount = 10;
+  for (size_t mode = 0; mode < 3; ++mode)
+  {
+    RangeSearch<EuclideanDistance, arma::mat, TreeType> rs(referenceData,
+        mode == 0, mode == 1);
+
+    vector<vector<size_t>> neighbors;
+    vector<vector<double>> distances;
+    arma::Col<size_t> counts, cappedCounts;
+
+    // Monochromatic search.
+    rs.Search(range, neighbors, distances);
+    rs.Count(range, counts);
+    rs.Count(range, cappedCounts, maxCount);
+
+    BOOST_REQUIRE_EQUAL(counts.n_elem, neighbors.size());
+    BOOST_REQUIRE_EQUAL(cappedCounts.n_elem, neighbors.size());
+    for (size_t i = 0; i < neighbors.size(); ++i)
+    {
+      BOOST_REQUIRE_EQUAL(counts[i], neighbors[i].size());
+      BOOST_REQUIRE_EQUAL(cappedCounts[i],
+          std::min(neighbors[i].size(), maxCount));
+    }
+
+    // Bichromatic search.
+    rs.Search(queryData, range, neighbors, distances);
+    rs.Count(queryData, range, counts);
+    rs.Count(queryData, range, cappedCounts, maxCount);
+
+    BOOST_REQUIRE_EQUAL(counts.n_elem, neighbors.size());
+    BOOST_REQUIRE_EQUAL(cappedCounts.n_elem, neighbors.size());
+    for (size_t i = 0; i < neighbors.size(); ++i)
+    {
+      BOOST_REQUIRE_EQUAL(counts[i], neighbors[i].size());
+      BOOST_REQUIRE_EQUAL(cappedCounts[i],
+          std::min(neighbors[i].size(), maxCount));
+    }
+  }
+}
+
+/**
+ * Test Count() with ranges that do and do not contain zero, using kd-trees.
+ */
+BOOST_AUTO_TEST_CASE(CountKDTreeTest)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(3, 500);
+  arma::mat queryData = arma::randu<arma::mat>(3, 200);
+
+  CheckCounts<KDTree>(referenceData, queryData, math::Range(0.0, 0.2));
+  CheckCounts<KDTree>(referenceData, queryData, math::Range(0.1, 0.3));
+}
+
+/**
+ * Test Count() with cover trees, which hold points in several nodes.
+ */
+BOOST_AUTO_TEST_CASE(CountCoverTreeTest)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(3, 500);
+  arma::mat queryData = arma::randu<arma::mat>(3, 200);
+
+  CheckCounts<StandardCoverTree>(referenceData, queryData,
+      math::Range(0.0, 0.2));
+  CheckCounts<StandardCoverTree>(referenceData, queryData,
+      math::Range(0.1, 0.3));
+}
+
+/**
+ * Check that results in CSR format are the same as the results in nested
+ * vectors.
+ */
+void CheckCSR(const vector<vector<size_t>>& neighbors,
+              const vector<vector<double>>& distances,
+              const arma::Col<size_t>& offsets,
+              const arma::Col<size_t>& flatNeighbors,
+              const arma::vec& flatDistances)
+{
+  BOOST_REQUIRE_EQUAL(offsets.n_elem, neighbors.size() + 1);
+  BOOST_REQUIRE_EQUAL(offsets[0], 0);
+  BOOST_REQUIRE_EQUAL(flatNeighbors.n_elem, offsets[neighbors.size()]);
+  BOOST_REQUIRE_EQUAL(flatDistances.n_elem, offsets[neighbors.size()]);
+
+  for (size_t i = 0; i < neighbors.size(); ++i)
+  {
+    BOOST_REQUIRE_EQUAL(offsets[i + 1] - offsets[i], neighbors[i].size());
+
+    // The results may be in a different order.
+    vector<pair<size_t, double>> expected, actual;
+    for (size_t j = 0; j < neighbors[i].size(); ++j)
+    {
+      expected.push_back(make_pair(neighbors[i][j], distances[i][j]));
+      actual.push_back(make_pair(flatNeighbors[offsets[i] + j],
+          flatDistances[offsets[i] + j]));
+    }
+    sort(expected.begin(), expected.end());
+    sort(actual.begin(), actual.end());
+
+    for (size_t j = 0; j < expected.size(); ++j)
+    {
+      BOOST_REQUIRE_EQUAL(actual[j].first, expected[j].first);
+      BOOST_REQUIRE_CLOSE(actual[j].second, expected[j].second, 1e-5);
+    }
+  }
+}
+
+/**
+ * Make sure the CSR overloads of Search() give the same results as the
+ * other overloads, in every search mode, with and without a query set.
+ */
+template<template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void CheckCSRSearch(const arma::mat& referenceData,
+                    const arma::mat& queryData,
+                    const math::Range& range)
+{
+  for (size_t mode = 0; mode < 3; ++mode)
+  {
+    RangeSearch<EuclideanDistance, arma::mat, TreeType> rs(referenceData,
+        mode == 0, mode == 1);
+
+    vector<vector<size_t>> neighbors;
+    vector<vector<double>> distances;
+    arma::Col<size_t> offsets, flatNeighbors;
+    arma::vec flatDistances;
+
+    rs.Search(range, neighbors, distances);
+    rs.Search(range, offsets, flatNeighbors, flatDistances);
+    CheckCSR(neighbors, distances, offsets, flatNeighbors, flatDistances);
+
+    rs.Search(queryData, range, neighbors, distances);
+    rs.Search(queryData, range, offsets, flatNeighbors, flatDistances);
+    CheckCSR(neighbors, distances, offsets, flatNeighbors, flatDistances);
+  }
+}
+
+/**
+ * Test the CSR overloads of Search() with kd-trees.
+ */
+BOOST_AUTO_TEST_CASE(CSRSearchKDTreeTest)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(3, 500);
+  arma::mat queryData = arma::randu<arma::mat>(3, 200);
+
+  CheckCSRSearch<KDTree>(referenceData, queryData, math::Range(0.0, 0.2));
+  CheckCSRSearch<KDTree>(referenceData, queryData, math::Range(0.1, 0.3));
+}
+
+/**
+ * Test the CSR overloads of Search() with cover trees, which do not rearrange
+ * the dataset.
+ */
+BOOST_AUTO_TEST_CASE(CSRSearchCoverTreeTest)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(3, 500);
+  arma::mat queryData = arma::randu<arma::mat>(3, 200);
+
+  CheckCSRSearch<StandardCoverTree>(referenceData, queryData,
+      math::Range(0.0, 0.2));
+}
+
+/**
+ * Make sure single-tree search with cover trees, whose reference nodes cache
+ * distances, gives the same results as naive search when many threads are
+ * available.
+ */
+BOOST_AUTO_TEST_CASE(CSRSearchCoverTreeSingleModeTest)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(3, 2000);
+  arma::mat queryData = arma::randu<arma::mat>(3, 1000);
+
+  #ifdef HAS_OPENMP
+  const int oldThreads = omp_get_max_threads();
+  omp_set_num_threads(4);
+  #endif
+
+  RangeSearch<EuclideanDistance, arma::mat, StandardCoverTree> rs(
+      referenceData, false, true);
+  RangeSearch<EuclideanDistance, arma::mat, StandardCoverTree> naive(
+      referenceData, true);
+
+  arma::Col<size_t> offsets, neighbors, naiveOffsets, naiveNeighbors;
+  arma::vec distances, naiveDistances;
+  rs.Search(queryData, math::Range(0.05, 0.15), offsets, neighbors,
+      distances);
+  naive.Search(queryData, math::Range(0.05, 0.15), naiveOffsets,
+      naiveNeighbors, naiveDistances);
+
+  #ifdef HAS_OPENMP
+  omp_set_num_threads(oldThreads);
+  #endif
+
+  BOOST_REQUIRE_EQUAL(offsets.n_elem, naiveOffsets.n_elem);
+  for (size_t i = 0; i < offsets.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(offsets[i], naiveOffsets[i]);
+
+  // The neighbors of each query point may be in a different order.
+  for (size_t i = 0; i + 1 < offsets.n_elem; ++i)
+  {
+    if (offsets[i] == offsets[i + 1])
+      continue;
+
+    arma::Col<size_t> found = arma::sort(neighbors.subvec(offsets[i],
+        offsets[i + 1] - 1));
+    arma::Col<size_t> expected = arma::sort(naiveNeighbors.subvec(
+        naiveOffsets[i], naiveOffsets[i + 1] - 1));
+    for (size_t j = 0; j < found.n_elem; ++j)
+      BOOST_REQUIRE_EQUAL(found[j], expected[j]);
+  }
+}
+
+/**
+ * Test the CSR overload of Search() with a query tree.
+ */
+BOOST_AUTO_TEST_CASE(CSRSearchQueryTreeTest)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(3, 500);
+  arma::mat queryData = arma::randu<arma::mat>(3, 200);
+
+  RangeSearch<> rs(referenceData);
+  KDTree<EuclideanDistance, RangeSearchStat, arma::mat> queryTree(queryData);
+
+  vector<vector<size_t>> neighbors;
+  vector<vector<double>> distances;
+  arma::Col<size_t> offsets, flatNeighbors;
+  arma::vec flatDistances;
+
+  rs.Search(&queryTree, math::Range(0.1, 0.3), neighbors, distances);
+  rs.Search(&queryTree, math::Range(0.1, 0.3), offsets, flatNeighbors,
+      flatDistances);
+  CheckCSR(neighbors, distances, offsets, flatNeighbors, flatDistances);
+}
+
+/**
+ * Make sure the CSR overloads of Search() of RSModel match the other overloads.
+ */
+BOOST_AUTO_TEST_CASE(CSRSearchRSModelTest)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(3, 500);
+  arma::mat queryData = arma::randu<arma::mat>(3, 200);
+
+  RSModel model(RSModel::TreeTypes::BALL_TREE);
+  model.BuildModel(std::move(referenceData), 10, false, false);
+
+  vector<vector<size_t>> neighbors;
+  vector<vector<double>> distances;
+  arma::Col<size_t> offsets, flatNeighbors;
+  arma::vec flatDistances;
+
+  model.Search(math::Range(0.1, 0.3), neighbors, distances);
+  model.Search(math::Range(0.1, 0.3), offsets, flatNeighbors, flatDistances);
+  CheckCSR(neighbors, distances, offsets, flatNeighbors, flatDistances);
+
+  arma::mat queryCopy(queryData);
+  model.Search(std::move(queryCopy), math::Range(0.1, 0.3), neighbors,
+      distances);
+  model.Search(std::move(queryData), math::Range(0.1, 0.3), offsets,
+      flatNeighbors, flatDistances);
+  CheckCSR(neighbors, distances, offsets, flatNeighbors, flatDistances);
+}
+
+/**
+ * Make sure Count() throws when the dimensionalities do not match.
+ */
+BOOST_AUTO_TEST_CASE(CountDimensionalityTest)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(3, 100);
+  arma::mat queryData = arma::randu<arma::mat>(4, 100);
+
+  RangeSearch<> rs(referenceData);
+  arma::Col<size_t> counts;
+
+  BOOST_REQUIRE_THROW(rs.Count(queryData, math::Range(0.0, 0.2), counts),
+      std::invalid_argument);
+}
+
+/**
+ * Make sure that searching the transformed data with MahalanobisSearch gives
+ * the same results as searching with the Mahalanobis distance.
+ */
+BOOST_AUTO_TEST_CASE(MahalanobisSearchRangeTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 300);
+  arma::mat querySet = arma::randu<arma::mat>(3, 60);
+  arma::mat a = arma::randn<arma::mat>(3, 3);
+  MahalanobisDistance<true> metric(a.t() * a + 0.1 * arma::eye<arma::mat>(3,
+      3));
+  const Range range(0.2, 0.6);
+
+  RangeSearch<MahalanobisDistance<true>, arma::mat, BallTree> naive(dataset,
+      true, false, metric);
+  vector<vector<size_t>> naiveNeighbors;
+  vector<vector<double>> naiveDistances;
+  naive.Search(querySet, range, naiveNeighbors, naiveDistances);
+
+  MahalanobisSearch<RangeSearch<>> rs(dataset, metric);
+  vector<vector<size_t>> neighbors;
+  vector<vector<double>> distances;
+  rs.Search(querySet, range, neighbors, distances);
+
+  BOOST_REQUIRE_EQUAL(neighbors.size(), naiveNeighbors.size());
+  for (size_t i = 0; i < neighbors.size(); ++i)
+  {
+    vector<pair<size_t, double>> found, expected;
+    for (size_t j = 0; j < neighbors[i].size(); ++j)
+      found.push_back(make_pair(neighbors[i][j], distances[i][j]));
+    for (size_t j = 0; j < naiveNeighbors[i].size(); ++j)
+      expected.push_back(make_pair(naiveNeighbors[i][j], naiveDistances[i][j]));
+    sort(found.begin(), found.end());
+    sort(expected.begin(), expected.end());
+
+    BOOST_REQUIRE_EQUAL(found.size(), expected.size());
+    for (size_t j = 0; j < found.size(); ++j)
+    {
+      BOOST_REQUIRE_EQUAL(found[j].first, expected[j].first);
+      BOOST_REQUIRE_CLOSE(found[j].second, expected[j].second, 1e-5);
+    }
+  }
+}
+
+/**
+ * The traversal statistics of range search should be consistent with the
+ * counts of the rules, in single-tree and dual-tree mode.
+ */
+BOOST_AUTO_TEST_CASE(RangeSearchTraversalStatisticsTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 1000);
+
+  RangeSearch<> rs(dataset);
+  for (size_t mode = 0; mode < 2; ++mode)
+  {
+    rs.SingleMode() = (mode == 0);
+
+    std::vector<std::vector<size_t>> neighbors;
+    std::vector<std::vector<double>> distances;
+    rs.Search(Range(0.0, 0.05), neighbors, distances);
+
+    const tree::TraversalStatistics& statistics = rs.Statistics();
+    BOOST_REQUIRE_GE(statistics.baseCases, rs.BaseCases());
+    BOOST_REQUIRE_GT(statistics.baseCases, 0);
+    BOOST_REQUIRE_GT(statistics.prunes, 0);
+    BOOST_REQUIRE_GT(statistics.leafVisits, 0);
+
+    size_t prunes = 0;
+    for (size_t i = 0; i < statistics.prunesPerDepth.size(); ++i)
+      prunes += statistics.prunesPerDepth[i];
+    BOOST_REQUIRE_EQUAL(prunes, statistics.prunes);
+  }
+}
+
+/**
+ * Range search with a fixed-dimension metric should give the same results as
+ * with the ordinary metric, both with kd-trees (which use the dimensionality
+ * of the metric in their bounds) and ball trees.
+ */
+BOOST_AUTO_TEST_CASE(FixedDimRangeSearchTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 500);
+  arma::mat querySet = arma::randu<arma::mat>(3, 80);
+  const Range range(0.1, 0.3);
+
+  RangeSearch<> rs(dataset);
+  vector<vector<size_t>> neighbors;
+  vector<vector<double>> distances;
+  rs.Search(querySet, range, neighbors, distances);
+  vector<vector<pair<double, size_t>>> expected;
+  SortResults(neighbors, distances, expected);
+
+  RangeSearch<FixedDimEuclideanDistance<3>> kdrs(dataset);
+  RangeSearch<FixedDimEuclideanDistance<3>, arma::mat, BallTree> ballrs(
+      dataset);
+  for (size_t mode = 0; mode < 4; ++mode)
+  {
+    vector<vector<size_t>> fixedNeighbors;
+    vector<vector<double>> fixedDistances;
+    if (mode < 2)
+    {
+      kdrs.SingleMode() = (mode == 0);
+      kdrs.Search(querySet, range, fixedNeighbors, fixedDistances);
+    }
+    else
+    {
+      ballrs.SingleMode() = (mode == 2);
+      ballrs.Search(querySet, range, fixedNeighbors, fixedDistances);
+    }
+
+    vector<vector<pair<double, size_t>>> found;
+    SortResults(fixedNeighbors, fixedDistances, found);
+
+    BOOST_REQUIRE_EQUAL(found.size(), expected.size());
+    for (size_t i = 0; i < found.size(); ++i)
+    {
+      BOOST_REQUIRE_EQUAL(found[i].size(), expected[i].size());
+      for (size_t j = 0; j < found[i].size(); ++j)
+      {
+        BOOST_REQUIRE_EQUAL(found[i][j].second, expected[i][j].second);
+        BOOST_REQUIRE_CLOSE(found[i][j].first, expected[i][j].first, 1e-5);
+      }
+    }
+  }
+
+  // The bounds must have the dimensionality of the metric.
+  typedef HRectBound<FixedDimEuclideanDistance<3>> FixedDimBound;
+  BOOST_REQUIRE_THROW(FixedDimBound bound(4), std::invalid_argument);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -217,6 +217,102 @@ BOOST_AUTO_TEST_CASE(ssRBMClassificationTest)
   BOOST_REQUIRE_GE(ssRbmClassificationAccuracy, 76.18 - 3.0);
 }
 
+/*
+ * Check the gradient that Phase() computes for a batch of several samples
+ * against a finite difference of the free energy: the gradient is the sum over
+ * the samples of the negative gradient of their free energy.
+ */
+BOOST_AUTO_TEST_CASE(BinaryRBMPhaseGradientTest)
+{
+  const size_t visibleSize = 6;
+  const size_t hiddenSize = 4;
+  arma::mat data = arma::randu<arma::mat>(visibleSize, 8);
+
+  GaussianInitialization gaussian(0, 0.5);
+  RBM<GaussianInitialization> model(data, gaussian, visibleSize, hiddenSize,
+      data.n_cols);
+  model.Reset();
+  model.HiddenBias().randn();
+  model.VisibleBias().randn();
+
+  arma::mat gradient(model.Parameters().n_elem, 1, arma::fill::zeros);
+  model.Phase(arma::mat(data), std::move(gradient));
+
+  const double eps = 1e-6;
+  for (size_t i = 0; i < model.Parameters().n_elem; ++i)
+  {
+    const double original = model.Parameters()[i];
+    model.Parameters()[i] = original + eps;
+    const double freeEnergyPlus = model.FreeEnergy(arma::mat(data));
+    model.Parameters()[i] = original - eps;
+    const double freeEnergyMinus = model.FreeEnergy(arma::mat(data));
+    model.Parameters()[i] = original;
+
+    const double estimate = -(freeEnergyPlus - freeEnergyMinus) / (2 * eps);
+    if (std::abs(estimate) < 1e-5)
+      BOOST_REQUIRE_SMALL(gradient[i], 1e-5);
+    else
+      BOOST_REQUIRE_CLOSE(gradient[i], estimate, 1e-3);
+  }
+}
+
+/*
+ * Set the parameters of the given binary RBM so that all the hidden and
+ * visible pre-activations of binary inputs are at least 50 away from zero, so
+ * that Gibbs sampling is deterministic, but still depends on the input.
+ */
+void SetSaturatedParameters(RBM<GaussianInitialization>& model,
+                            const arma::mat& weight)
+{
+  model.Weight().slice(0) = weight;
+  model.HiddenBias().fill(50);
+  model.VisibleBias().fill(-50);
+}
+
+/*
+ * When the negative chains are not persistent, BinaryRBM runs all of them as
+ * one wide batch.  Make sure that this gives the same gradient as running
+ * them one at a time from the columns of the batch.
+ */
+BOOST_AUTO_TEST_CASE(BinaryRBMNegativeChainsTest)
+{
+  const size_t visibleSize = 5;
+  const size_t hiddenSize = 3;
+  const size_t batchSize = 4;
+  const size_t negSteps = 3;
+  arma::mat data = arma::round(arma::randu<arma::mat>(visibleSize, 10));
+  arma::mat weight = 100 * (2 * arma::round(arma::randu<arma::mat>(
+      hiddenSize, visibleSize)) - 1);
+
+  GaussianInitialization gaussian(0, 0.1);
+  RBM<GaussianInitialization> wideModel(data, gaussian, visibleSize,
+      hiddenSize, batchSize, 2, negSteps);
+  wideModel.Reset();
+  SetSaturatedParameters(wideModel, weight);
+
+  RBM<GaussianInitialization> stepModel(data, gaussian, visibleSize,
+      hiddenSize, batchSize, 2, 1);
+  stepModel.Reset();
+  SetSaturatedParameters(stepModel, weight);
+
+  // Use a batch that does not start at the first column.
+  math::RandomSeed(12);
+  arma::mat wideGradient;
+  wideModel.Gradient(wideModel.Parameters(), 3, wideGradient, batchSize);
+
+  math::RandomSeed(12);
+  arma::mat stepGradient(wideGradient.n_rows, 1, arma::fill::zeros);
+  for (size_t j = 0; j < negSteps; ++j)
+  {
+    arma::mat gradient;
+    stepModel.Gradient(stepModel.Parameters(), 3, gradient, batchSize);
+    stepGradient += gradient;
+  }
+  stepGradient /= negSteps;
+
+  CheckMatrices(wideGradient, stepGradient);
+}
+
 template<typename MatType = arma::mat>
 void BuildVanillaNetwork(MatType& trainData,
                          const size_t hiddenLayerSize)
@@ -1384,4 +1384,84 @@ BOOST_AUTO_TEST_CASE(RectangleTreeMoveDatasetTest)
   BOOST_REQUIRE_EQUAL(tree.Dataset().n_cols, 1000);
 }
 
+/**
+ * Check the structure of a bulk-loaded tree and compare the results of a
+ * search with it to the results of a naive search.
+ */
+template<template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void CheckBulkLoadedTree(const arma::mat& dataset,
+                         const BulkLoadMethod method)
+{
+  typedef TreeType<EuclideanDistance, NeighborSearchStat<NearestNeighborSort>,
+      arma::mat> Tree;
+
+  // 1000 points fill 50 leaves, which fill 10 nodes, which fill 2 nodes.
+  Tree tree(dataset, method, 20, 6, 5, 2);
+
+  BOOST_REQUIRE_EQUAL(tree.NumDescendants(), 1000);
+  BOOST_REQUIRE_EQUAL(tree.TreeDepth(), 4);
+  BOOST_REQUIRE_EQUAL(GetMinLevel(tree), GetMaxLevel(tree));
+
+  CheckContainment(tree);
+  CheckExactContainment(tree);
+  CheckHierarchy(tree);
+  CheckFills(tree);
+  CheckNumDescendants(tree);
+
+  arma::Mat<size_t> neighbors1;
+  arma::mat distances1;
+  arma::Mat<size_t> neighbors2;
+  arma::mat distances2;
+
+  NeighborSearch<NearestNeighborSort, metric::LMetric<2, true>, arma::mat,
+      TreeType> knn1(std::move(tree), SINGLE_TREE_MODE);
+  knn1.Search(5, neighbors1, distances1);
+
+  KNN knn2(dataset, NAIVE_MODE);
+  knn2.Search(5, neighbors2, distances2);
+
+  for (size_t i = 0; i < neighbors1.size(); i++)
+  {
+    BOOST_REQUIRE_EQUAL(neighbors1[i], neighbors2[i]);
+    BOOST_REQUIRE_EQUAL(distances1[i], distances2[i]);
+  }
+}
+
+// Test that bulk loading builds full, balanced R trees and R* trees that give
+// the same search results as a naive search.
+BOOST_AUTO_TEST_CASE(BulkLoadTest)
+{
+  arma::mat dataset;
+  dataset.randu(3, 1000); // 1000 points in 3 dimensions.
+
+  CheckBulkLoadedTree<RTree>(dataset, BulkLoadMethod::SortTileRecursive);
+  CheckBulkLoadedTree<RTree>(dataset, BulkLoadMethod::HilbertPacking);
+  CheckBulkLoadedTree<RStarTree>(dataset, BulkLoadMethod::SortTileRecursive);
+  CheckBulkLoadedTree<RStarTree>(dataset, BulkLoadMethod::HilbertPacking);
+}
+
+// Test that points can still be inserted into a bulk-loaded tree.
+BOOST_AUTO_TEST_CASE(BulkLoadInsertTest)
+{
+  arma::mat dataset;
+  dataset.randu(3, 1000);
+
+  typedef RTree<EuclideanDistance, NeighborSearchStat<NearestNeighborSort>,
+      arma::mat> TreeType;
+  TreeType tree(dataset, BulkLoadMethod::SortTileRecursive, 20, 6, 5, 2);
+
+  // Insert some of the points a second time.
+  for (size_t i = 0; i < 100; ++i)
+    tree.InsertPoint(i);
+
+  BOOST_REQUIRE_EQUAL(tree.NumDescendants(), 1100);
+  BOOST_REQUIRE_EQUAL(GetMinLevel(tree), GetMaxLevel(tree));
+  CheckContainment(tree);
+  CheckHierarchy(tree);
+  CheckFills(tree);
+  CheckNumDescendants(tree);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
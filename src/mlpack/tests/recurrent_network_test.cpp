@@ -1318,6 +1318,42 @@ BOOST_AUTO_TEST_CASE(MultiTimestepTest)
   BOOST_REQUIRE_LE(err, 0.025);
 }
 
+/**
+ * Test that gradient checkpointing in the RNN gives the same objective and
+ * gradient as keeping the outputs of all the layers.
+ */
+BOOST_AUTO_TEST_CASE(RNNGradientCheckpointingTest)
+{
+  const size_t rho = 5;
+  arma::cube input = arma::randu<arma::cube>(4, 10, rho);
+  arma::cube target = arma::floor(arma::randu<arma::cube>(1, 10, rho) * 3) + 1;
+
+  RNN<NegativeLogLikelihood<> > model(rho);
+  model.Add<Linear<> >(4, 6);
+  model.Add<SigmoidLayer<> >();
+  model.Add<LSTM<> >(6, 6, rho);
+  model.Add<Linear<> >(6, 3);
+  model.Add<LogSoftMax<> >();
+  model.Predictors() = input;
+  model.Responses() = target;
+  model.ResetParameters();
+
+  arma::mat gradient;
+  const double objective = model.EvaluateWithGradient(model.Parameters(), 0,
+      gradient, 10);
+
+  for (size_t interval = 1; interval <= 5; ++interval)
+  {
+    model.CheckpointInterval() = interval;
+    arma::mat checkpointGradient;
+    const double checkpointObjective = model.EvaluateWithGradient(
+        model.Parameters(), 0, checkpointGradient, 10);
+
+    BOOST_REQUIRE_CLOSE(objective, checkpointObjective, 1e-5);
+    CheckMatrices(gradient, checkpointGradient, 1e-5);
+  }
+}
+
 /**
  * Test that RNN::Train() returns finite objective value.
  */
@@ -316,6 +316,66 @@ BOOST_AUTO_TEST_CASE(RegularizedSVDFunctionOptimizeHOGWILD)
   BOOST_REQUIRE_SMALL(relativeError, 1e-2);
 }
 
+
+// Test the Hogwild specialization of parallel SGD for Regularized SVD.  The
+// blocks are much smaller than NumFunctions() / numThreads, so that each thread
+// has to process many blocks in each epoch.
+BOOST_AUTO_TEST_CASE(RegularizedSVDFunctionOptimizeHogwildBlocks)
+{
+  // Define useful constants.
+  const size_t numUsers = 50;
+  const size_t numItems = 50;
+  const size_t numRatings = 100;
+  const size_t rank = 10;
+  const double alpha = 0.01;
+  const double lambda = 0.01;
+
+  // Initiate random parameters.
+  arma::mat parameters = arma::randu(rank, numUsers + numItems);
+
+  // Make a random rating dataset.
+  arma::mat data = arma::randu(3, numRatings);
+  data.row(0) = floor(data.row(0) * numUsers);
+  data.row(1) = floor(data.row(1) * numItems);
+
+  // Manually set last row to maximum user and maximum item.
+  data(0, numRatings - 1) = numUsers - 1;
+  data(1, numRatings - 1) = numItems - 1;
+
+  // Make rating entries based on the parameters.
+  for (size_t i = 0; i < numRatings; i++)
+  {
+    data(2, i) = arma::dot(parameters.col(data(0, i)),
+                           parameters.col(numUsers + data(1, i)));
+  }
+
+  // Make the Reg SVD function and the optimizer.  The first backoff epoch is
+  // never reached, so the step size is constant.
+  RegularizedSVDFunction<arma::mat> rSVDFunc(data, rank, lambda);
+  ExponentialBackoff decayPolicy(100000, alpha, 0.5);
+  ParallelSGD<ExponentialBackoff> optimizer(10000, 3, 1e-5, true,
+      decayPolicy);
+
+  // Obtain optimized parameters after training.
+  arma::mat optParameters = arma::randu(rank, numUsers + numItems);
+  optimizer.Optimize(rSVDFunc, optParameters);
+
+  // Get predicted ratings from optimized parameters.
+  arma::mat predictedData(1, numRatings);
+  for (size_t i = 0; i < numRatings; i++)
+  {
+    predictedData(0, i) = arma::dot(optParameters.col(data(0, i)),
+                                    optParameters.col(numUsers + data(1, i)));
+  }
+
+  // Calculate relative error.
+  const double relativeError = arma::norm(data.row(2) - predictedData, "frob") /
+                               arma::norm(data, "frob");
+
+  // Relative error should be small.
+  BOOST_REQUIRE_SMALL(relativeError, 1e-2);
+}
+
 #endif
 
 BOOST_AUTO_TEST_SUITE_END();
@@ -21,6 +21,7 @@
 #include <mlpack/methods/reinforcement_learning/environment/acrobot.hpp>
 #include <mlpack/methods/reinforcement_learning/environment/pendulum.hpp>
 #include <mlpack/methods/reinforcement_learning/replay/random_replay.hpp>
+#include <mlpack/methods/reinforcement_learning/replay/sumtree.hpp>
 #include <mlpack/methods/reinforcement_learning/policy/greedy_policy.hpp>
 
 #include <boost/test/unit_test.hpp>
@@ -281,4 +282,28 @@ BOOST_AUTO_TEST_CASE(GreedyPolicyTest)
   BOOST_REQUIRE_CLOSE(actionValue[action], actionValue.max(), 1e-5);
 }
 
+/**
+ * Make sure that the batched descent of the sum tree finds the same indices as
+ * the descent of each mass on its own.
+ */
+BOOST_AUTO_TEST_CASE(SumTreeFindPrefixSumsTest)
+{
+  SumTree<double> tree(64);
+  for (size_t i = 0; i < 64; ++i)
+    tree.Set(i, (i % 3 == 1) ? 0.0 : arma::randu() + 0.1);
+
+  arma::colvec masses = arma::randu<arma::colvec>(200) * tree.Sum();
+  arma::ucolvec indices;
+  arma::colvec workspace;
+  tree.FindPrefixSums(masses, indices, workspace);
+
+  BOOST_REQUIRE_EQUAL(indices.n_elem, masses.n_elem);
+  for (size_t i = 0; i < masses.n_elem; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(indices[i], tree.FindPrefixSum(masses[i]));
+    // Elements with no mass can never be chosen.
+    BOOST_REQUIRE_NE(indices[i] % 3, 1);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
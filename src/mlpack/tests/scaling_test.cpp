@@ -175,4 +175,73 @@ BOOST_AUTO_TEST_CASE(ZCAWhiteningTest)
   CheckMatrices(dataset, temp);
 }
 
+/**
+ * Check that fitting a dataset in chunks with PartialFit() gives the same
+ * scaling as Fit(), and that the in-place transforms give the same results as
+ * the other transforms.
+ */
+template<typename ScalerType>
+void CheckPartialFit(ScalerType& scale, ScalerType& partialScale)
+{
+  arma::mat input = arma::randn(5, 1000) * 3.0 + 2.0;
+  scale.Fit(input);
+  partialScale.PartialFit(input.cols(0, 0));
+  partialScale.PartialFit(input.cols(1, 299));
+  partialScale.PartialFit(input.cols(300, 999));
+
+  arma::mat output, partialOutput;
+  scale.Transform(input, output);
+  partialScale.Transform(input, partialOutput);
+  CheckMatrices(output, partialOutput);
+
+  arma::mat inPlace(input);
+  scale.Transform(inPlace);
+  CheckMatrices(output, inPlace);
+  scale.InverseTransform(inPlace);
+  CheckMatrices(input, inPlace);
+
+  // A chunk of another dimensionality can't be fit.
+  arma::mat wrongInput(4, 20, arma::fill::randu);
+  BOOST_REQUIRE_THROW(partialScale.PartialFit(wrongInput),
+      std::invalid_argument);
+}
+
+/**
+ * Test PartialFit() and the in-place transforms of MinMaxScaler.
+ */
+BOOST_AUTO_TEST_CASE(MinMaxScalerPartialFitTest)
+{
+  data::MinMaxScaler scale(-2, 3), partialScale(-2, 3);
+  CheckPartialFit(scale, partialScale);
+}
+
+/**
+ * Test PartialFit() and the in-place transforms of MaxAbsScaler.
+ */
+BOOST_AUTO_TEST_CASE(MaxAbsScalerPartialFitTest)
+{
+  data::MaxAbsScaler scale, partialScale;
+  CheckPartialFit(scale, partialScale);
+}
+
+/**
+ * Test PartialFit() and the in-place transforms of StandardScaler.
+ */
+BOOST_AUTO_TEST_CASE(StandardScalerPartialFitTest)
+{
+  data::StandardScaler scale, partialScale;
+  CheckPartialFit(scale, partialScale);
+  BOOST_REQUIRE_EQUAL(partialScale.ItemCount(), 1000);
+}
+
+/**
+ * Test PartialFit() and the in-place transforms of MeanNormalization.
+ */
+BOOST_AUTO_TEST_CASE(MeanNormalizationPartialFitTest)
+{
+  data::MeanNormalization scale, partialScale;
+  CheckPartialFit(scale, partialScale);
+  BOOST_REQUIRE_EQUAL(partialScale.ItemCount(), 1000);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
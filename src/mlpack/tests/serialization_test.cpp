@@ -28,6 +28,7 @@
 #include <mlpack/methods/hoeffding_trees/hoeffding_tree.hpp>
 #include <mlpack/core/tree/cover_tree.hpp>
 #include <mlpack/core/tree/rectangle_tree.hpp>
+#include <mlpack/core/tree/spill_tree.hpp>
 
 #include <mlpack/methods/perceptron/perceptron.hpp>
 #include <mlpack/methods/logistic_regression/logistic_regression.hpp>
@@ -157,6 +158,58 @@ BOOST_AUTO_TEST_CASE(EmptySparseMatrixSerializeTest)
   TestAllArmadilloSerialization(m);
 }
 
+/**
+ * Make sure that a binary archive of a matrix can't be loaded into a matrix of
+ * a different element type.
+ */
+BOOST_AUTO_TEST_CASE(BinaryMatrixElemTypeMismatchTest)
+{
+  arma::mat m;
+  m.randu(30, 40);
+  arma::sp_mat s;
+  s.sprandu(30, 40, 0.3);
+
+  std::stringstream stream;
+  {
+    binary_oarchive o(stream);
+    o << m << s;
+  }
+
+  // The elements of a loaded matrix are the same.
+  {
+    std::stringstream input(stream.str());
+    binary_iarchive i(input);
+    arma::mat newM;
+    arma::sp_mat newS;
+    i >> newM >> newS;
+    CheckMatrices(m, newM);
+    CheckMatrices(arma::mat(s), arma::mat(newS));
+  }
+
+  {
+    std::stringstream input(stream.str());
+    binary_iarchive i(input);
+    arma::fmat newM;
+    BOOST_REQUIRE_THROW(i >> newM, archive_exception);
+  }
+
+  {
+    std::stringstream input(stream.str());
+    binary_iarchive i(input);
+    arma::Mat<arma::sword> newM;
+    BOOST_REQUIRE_THROW(i >> newM, archive_exception);
+  }
+
+  {
+    std::stringstream input(stream.str());
+    binary_iarchive i(input);
+    arma::mat newM;
+    arma::sp_fmat newS;
+    i >> newM;
+    BOOST_REQUIRE_THROW(i >> newS, archive_exception);
+  }
+}
+
 BOOST_AUTO_TEST_CASE(BallBoundTest)
 {
   BallBound<> b(100);
@@ -577,6 +630,45 @@ BOOST_AUTO_TEST_CASE(RectangleTreeOverwriteTest)
   }
 }
 
+// Make sure that the shared buffer of point indexes of a spill tree is restored
+// correctly, both into a new tree and over an existing one.
+BOOST_AUTO_TEST_CASE(SpillTreeTest)
+{
+  arma::mat data;
+  data.randu(3, 1000);
+  typedef SPTree<EuclideanDistance, EmptyStatistic, arma::mat> TreeType;
+  TreeType tree(data, 0.2);
+
+  TreeType* xmlTree;
+  TreeType* textTree;
+  TreeType* binaryTree;
+
+  SerializePointerObjectAll(&tree, xmlTree, textTree, binaryTree);
+
+  CheckTrees(tree, *xmlTree, *textTree, *binaryTree);
+  for (size_t i = 0; i < tree.NumDescendants(); ++i)
+  {
+    BOOST_REQUIRE_EQUAL(tree.Descendant(i), xmlTree->Descendant(i));
+    BOOST_REQUIRE_EQUAL(tree.Descendant(i), textTree->Descendant(i));
+    BOOST_REQUIRE_EQUAL(tree.Descendant(i), binaryTree->Descendant(i));
+  }
+
+  delete xmlTree;
+  delete textTree;
+  delete binaryTree;
+
+  arma::mat otherData;
+  otherData.randu(5, 50);
+  TreeType xmlOverwriteTree(otherData);
+  TreeType textOverwriteTree(otherData);
+  TreeType binaryOverwriteTree(otherData);
+
+  SerializeObjectAll(tree, xmlOverwriteTree, textOverwriteTree,
+      binaryOverwriteTree);
+
+  CheckTrees(tree, xmlOverwriteTree, textOverwriteTree, binaryOverwriteTree);
+}
+
 BOOST_AUTO_TEST_CASE(PerceptronTest)
 {
   // Create a perceptron.  Train it randomly.  Then check that it hasn't
@@ -1053,16 +1145,25 @@ BOOST_AUTO_TEST_CASE(LSHTest)
   BOOST_REQUIRE_EQUAL(lsh.BucketSize(), textLsh.BucketSize());
   BOOST_REQUIRE_EQUAL(lsh.BucketSize(), binaryLsh.BucketSize());
 
-  BOOST_REQUIRE_EQUAL(lsh.SecondHashTable().size(),
-      xmlLsh.SecondHashTable().size());
-  BOOST_REQUIRE_EQUAL(lsh.SecondHashTable().size(),
-      textLsh.SecondHashTable().size());
-  BOOST_REQUIRE_EQUAL(lsh.SecondHashTable().size(),
-      binaryLsh.SecondHashTable().size());
-
-  for (size_t i = 0; i < lsh.SecondHashTable().size(); ++i)
-  CheckMatrices(lsh.SecondHashTable()[i], xmlLsh.SecondHashTable()[i],
-      textLsh.SecondHashTable()[i], binaryLsh.SecondHashTable()[i]);
+  CheckMatrices(lsh.BucketOffsets(), xmlLsh.BucketOffsets(),
+      textLsh.BucketOffsets(), binaryLsh.BucketOffsets());
+  CheckMatrices(lsh.BucketIndices(), xmlLsh.BucketIndices(),
+      textLsh.BucketIndices(), binaryLsh.BucketIndices());
+
+  // The deprecated view of the second hash table must be the same too.  It is
+  // built on each call, so keep one copy of each.
+  const std::vector<arma::Col<size_t>> table = lsh.SecondHashTable();
+  const std::vector<arma::Col<size_t>> xmlTable = xmlLsh.SecondHashTable();
+  const std::vector<arma::Col<size_t>> textTable = textLsh.SecondHashTable();
+  const std::vector<arma::Col<size_t>> binaryTable =
+      binaryLsh.SecondHashTable();
+
+  BOOST_REQUIRE_EQUAL(table.size(), xmlTable.size());
+  BOOST_REQUIRE_EQUAL(table.size(), textTable.size());
+  BOOST_REQUIRE_EQUAL(table.size(), binaryTable.size());
+
+  for (size_t i = 0; i < table.size(); ++i)
+    CheckMatrices(table[i], xmlTable[i], textTable[i], binaryTable[i]);
 }
 
 // Make sure serialization works for the decision stump.
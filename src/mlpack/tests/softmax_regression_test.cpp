@@ -668,4 +668,76 @@ BOOST_AUTO_TEST_CASE(SoftmaxRegressionComputeProbabilitiesAndLabelsTest)
   }
 }
 
+/**
+ * Make sure that the objective function and its gradient are the same for
+ * sparse and dense data, with and without the intercept.
+ */
+BOOST_AUTO_TEST_CASE(SoftmaxRegressionFunctionSparseTest)
+{
+  arma::sp_mat sparseData;
+  sparseData.sprandu(20, 200, 0.2);
+  arma::mat denseData(sparseData);
+  arma::Row<size_t> labels = arma::randi<arma::Row<size_t>>(200,
+      arma::distr_param(0, 2));
+
+  for (size_t intercept = 0; intercept < 2; ++intercept)
+  {
+    SoftmaxRegressionFunction dense(denseData, labels, 3, 0.1, intercept);
+    SoftmaxRegressionFunctionType<arma::sp_mat> sparse(sparseData, labels, 3,
+        0.1, intercept);
+
+    const arma::mat parameters = dense.GetInitialPoint();
+    BOOST_REQUIRE_CLOSE(dense.Evaluate(parameters),
+        sparse.Evaluate(parameters), 1e-5);
+    BOOST_REQUIRE_CLOSE(dense.Evaluate(parameters, 10, 50),
+        sparse.Evaluate(parameters, 10, 50), 1e-5);
+
+    arma::mat denseGradient, sparseGradient;
+    dense.Gradient(parameters, denseGradient);
+    sparse.Gradient(parameters, sparseGradient);
+    CheckMatrices(denseGradient, sparseGradient);
+
+    dense.Gradient(parameters, 10, denseGradient, 50);
+    sparse.Gradient(parameters, 10, sparseGradient, 50);
+    CheckMatrices(denseGradient, sparseGradient);
+  }
+}
+
+/**
+ * Make sure that training and classification on sparse data give the same
+ * results as on the equivalent dense data.
+ */
+BOOST_AUTO_TEST_CASE(SoftmaxRegressionSparseTest)
+{
+  arma::sp_mat sparseData;
+  sparseData.sprandu(20, 300, 0.2);
+  arma::Row<size_t> labels = arma::randi<arma::Row<size_t>>(300,
+      arma::distr_param(0, 2));
+  // Make the classes separable in a few features.
+  for (size_t i = 0; i < sparseData.n_cols; ++i)
+    sparseData(labels[i], i) += 2.0;
+  arma::mat denseData(sparseData);
+
+  SoftmaxRegression dense(denseData.n_rows, 3, true);
+  SoftmaxRegression sparse(sparseData.n_rows, 3, true);
+  sparse.Parameters() = dense.Parameters();
+  dense.Lambda() = 0.1;
+  sparse.Lambda() = 0.1;
+  dense.Train(denseData, labels, 3);
+  sparse.Train(sparseData, labels, 3);
+
+  CheckMatrices(dense.Parameters(), sparse.Parameters(), 1e-3);
+
+  arma::Row<size_t> denseLabels, sparseLabels;
+  arma::mat denseProbabilities, sparseProbabilities;
+  dense.Classify(denseData, denseLabels, denseProbabilities);
+  sparse.Classify(sparseData, sparseLabels, sparseProbabilities);
+  CheckMatrices(denseLabels, sparseLabels);
+  CheckMatrices(denseProbabilities, sparseProbabilities, 1e-3);
+
+  BOOST_REQUIRE_CLOSE(dense.ComputeAccuracy(denseData, labels),
+      sparse.ComputeAccuracy(sparseData, labels), 1e-5);
+  BOOST_REQUIRE_GT(sparse.ComputeAccuracy(sparseData, labels), 90.0);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
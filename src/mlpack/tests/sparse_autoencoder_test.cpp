@@ -268,4 +268,77 @@ BOOST_AUTO_TEST_CASE(SparseAutoencoderFunctionGradient)
   }
 }
 
+/**
+ * Check the gradient of a batch of points that spans several blocks against
+ * the numerical gradient of the batch objective.
+ */
+BOOST_AUTO_TEST_CASE(SparseAutoencoderFunctionBatchGradient)
+{
+  const size_t vSize = 10;
+  const size_t hSize = 5;
+
+  arma::mat data;
+  data.randu(vSize, 2500);
+
+  SparseAutoencoderFunction saf(data, vSize, hSize, 2, 2);
+
+  arma::mat parameters;
+  parameters.randu(2 * hSize + 1, vSize + 1);
+
+  arma::mat gradient;
+  const double objective = saf.EvaluateWithGradient(parameters, 300, gradient,
+      1500);
+  BOOST_REQUIRE_CLOSE(objective, saf.Evaluate(parameters, 300, 1500), 1e-5);
+
+  const double epsilon = 0.0001;
+  for (size_t i = 0; i < parameters.n_elem; ++i)
+  {
+    parameters[i] += epsilon;
+    const double costPlus = saf.Evaluate(parameters, 300, 1500);
+    parameters[i] -= 2 * epsilon;
+    const double costMinus = saf.Evaluate(parameters, 300, 1500);
+    parameters[i] += epsilon;
+
+    const double numGradient = (costPlus - costMinus) / (2 * epsilon);
+    if (std::abs(gradient[i]) < 1e-6)
+      BOOST_REQUIRE_SMALL(numGradient, 1e-6);
+    else
+      BOOST_REQUIRE_CLOSE(numGradient, gradient[i], 1e-2);
+  }
+}
+
+/**
+ * The objective and gradient on float data should match the double ones.
+ */
+BOOST_AUTO_TEST_CASE(SparseAutoencoderFunctionFloat)
+{
+  const size_t vSize = 10;
+  const size_t hSize = 5;
+
+  arma::mat data;
+  data.randu(vSize, 1500);
+  arma::fmat fData = arma::conv_to<arma::fmat>::from(data);
+
+  SparseAutoencoderFunction saf(data, vSize, hSize);
+  SparseAutoencoderFunctionType<arma::fmat> fSaf(fData, vSize, hSize);
+
+  arma::mat parameters = saf.GetInitialPoint();
+  arma::fmat fParameters = arma::conv_to<arma::fmat>::from(parameters);
+
+  BOOST_REQUIRE_CLOSE(fSaf.Evaluate(fParameters), saf.Evaluate(parameters),
+      1e-2);
+
+  arma::mat gradient;
+  arma::fmat fGradient;
+  saf.Gradient(parameters, gradient);
+  fSaf.Gradient(fParameters, fGradient);
+  for (size_t i = 0; i < gradient.n_elem; ++i)
+  {
+    if (std::abs(gradient[i]) < 1e-5)
+      BOOST_REQUIRE_SMALL((double) fGradient[i], 1e-4);
+    else
+      BOOST_REQUIRE_CLOSE((double) fGradient[i], gradient[i], 0.5);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -213,4 +213,41 @@ BOOST_AUTO_TEST_CASE(SparseCodingTrainReturnObjective)
   BOOST_REQUIRE_EQUAL(std::isfinite(objVal), true);
 }
 
+/**
+ * Make sure that encoding all the points at once gives the same codes as
+ * solving the LARS problem of each point on its own, even though the LARS
+ * objects are reused between the points of a thread.
+ */
+BOOST_AUTO_TEST_CASE(SparseCodingEncodeMatchesLARSTest)
+{
+  double lambda1 = 0.1;
+  double lambda2 = 0.05;
+  uword nAtoms = 25;
+
+  mat X;
+  X.load("mnist_first250_training_4s_and_9s.arm");
+  uword nPoints = X.n_cols;
+
+  // Normalize each point since these are images.
+  for (uword i = 0; i < nPoints; ++i)
+    X.col(i) /= norm(X.col(i), 2);
+
+  SparseCoding sc(nAtoms, lambda1, lambda2);
+  mat Z;
+  DataDependentRandomInitializer::Initialize(X, nAtoms, sc.Dictionary());
+  sc.Encode(X, Z);
+
+  const mat& D = sc.Dictionary();
+  const mat gram = trans(D) * D;
+  for (uword i = 0; i < nPoints; ++i)
+  {
+    LARS lars(true, gram, lambda1, lambda2);
+    vec code;
+    lars.Train(D, X.col(i).t(), code, false);
+
+    for (uword j = 0; j < nAtoms; ++j)
+      BOOST_REQUIRE_SMALL(Z(j, i) - code(j), 1e-12);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
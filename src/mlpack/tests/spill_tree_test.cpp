@@ -308,4 +308,144 @@ BOOST_AUTO_TEST_CASE(SpillTreeMoveDatasetTest)
   BOOST_REQUIRE_EQUAL(tree.Dataset().n_cols, 1000);
 }
 
+/**
+ * Collect the points of the leaves of the given node, in depth-first order.
+ */
+template<typename TreeType>
+void CollectLeafPoints(const TreeType& node, std::vector<size_t>& points)
+{
+  if (node.IsLeaf())
+  {
+    for (size_t i = 0; i < node.NumPoints(); ++i)
+      points.push_back(node.Point(i));
+    return;
+  }
+
+  CollectLeafPoints(*node.Left(), points);
+  CollectLeafPoints(*node.Right(), points);
+}
+
+/**
+ * Check that the descendants of every node are the points of its leaves.
+ */
+template<typename TreeType>
+void CheckDescendants(const TreeType& node)
+{
+  std::vector<size_t> points;
+  CollectLeafPoints(node, points);
+
+  BOOST_REQUIRE_EQUAL(node.NumDescendants(), points.size());
+  for (size_t i = 0; i < points.size(); ++i)
+    BOOST_REQUIRE_EQUAL(node.Descendant(i), points[i]);
+
+  if (!node.IsLeaf())
+  {
+    CheckDescendants(*node.Left());
+    CheckDescendants(*node.Right());
+  }
+}
+
+/**
+ * Make sure that the descendants of each node are correct, including in copies
+ * of the tree.
+ */
+BOOST_AUTO_TEST_CASE(SpillTreeDescendantTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 1000);
+  typedef SPTree<EuclideanDistance, EmptyStatistic, arma::mat> TreeType;
+
+  TreeType* tree = new TreeType(dataset, 0.3);
+  CheckDescendants(*tree);
+
+  TreeType copy(*tree);
+  delete tree;
+  CheckDescendants(copy);
+
+  TreeType moved(std::move(copy));
+  CheckDescendants(moved);
+}
+
+/**
+ * Make sure that the overlapping buffers never duplicate more points than the
+ * overlap budget allows.
+ */
+BOOST_AUTO_TEST_CASE(SpillTreeOverlapBudgetTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 1000);
+  typedef SPTree<EuclideanDistance, EmptyStatistic, arma::mat> TreeType;
+
+  // Without a budget, this much overlap duplicates many points.
+  TreeType unlimitedTree(dataset, 0.1);
+  BOOST_REQUIRE_GT(unlimitedTree.NumDescendants(), 1100);
+
+  // With no budget at all, every point is held exactly once.
+  TreeType noOverlapTree(dataset, 0.1, 20, 0.7, 0);
+  BOOST_REQUIRE_EQUAL(noOverlapTree.NumDescendants(), 1000);
+
+  std::vector<size_t> counts(1000, 0);
+  for (size_t i = 0; i < noOverlapTree.NumDescendants(); ++i)
+    ++counts[noOverlapTree.Descendant(i)];
+  for (size_t i = 0; i < 1000; ++i)
+    BOOST_REQUIRE_EQUAL(counts[i], 1);
+
+  TreeType limitedTree(dataset, 0.1, 20, 0.7, 100);
+  BOOST_REQUIRE_GE(limitedTree.NumDescendants(), 1000);
+  BOOST_REQUIRE_LE(limitedTree.NumDescendants(), 1100);
+  CheckDescendants(limitedTree);
+}
+
+/**
+ * Make sure that a spill tree built with many threads is the same as a spill
+ * tree built with one thread.
+ */
+BOOST_AUTO_TEST_CASE(ParallelSpillTreeBuildTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(4, 20000);
+  typedef SPTree<EuclideanDistance, EmptyStatistic, arma::mat> TreeType;
+
+  #ifdef HAS_OPENMP
+  const int oldThreads = omp_get_max_threads();
+  omp_set_num_threads(1);
+  #endif
+
+  TreeType serialTree(dataset, 0.05, 20, 0.7, 5000);
+
+  #ifdef HAS_OPENMP
+  omp_set_num_threads(4);
+  #endif
+
+  TreeType parallelTree(dataset, 0.05, 20, 0.7, 5000);
+
+  #ifdef HAS_OPENMP
+  omp_set_num_threads(oldThreads);
+  #endif
+
+  std::stack<const TreeType*> serialNodes, parallelNodes;
+  serialNodes.push(&serialTree);
+  parallelNodes.push(&parallelTree);
+  while (!serialNodes.empty())
+  {
+    const TreeType* a = serialNodes.top();
+    const TreeType* b = parallelNodes.top();
+    serialNodes.pop();
+    parallelNodes.pop();
+
+    BOOST_REQUIRE_EQUAL(a->NumChildren(), b->NumChildren());
+    BOOST_REQUIRE_EQUAL(a->Overlap(), b->Overlap());
+    BOOST_REQUIRE_EQUAL(a->NumDescendants(), b->NumDescendants());
+    for (size_t i = 0; i < a->NumDescendants(); ++i)
+      BOOST_REQUIRE_EQUAL(a->Descendant(i), b->Descendant(i));
+
+    if (!a->IsLeaf())
+    {
+      serialNodes.push(a->Left());
+      serialNodes.push(a->Right());
+      parallelNodes.push(b->Left());
+      parallelNodes.push(b->Right());
+    }
+  }
+
+  BOOST_REQUIRE_LE(parallelTree.NumDescendants(), 25000);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -215,4 +215,63 @@ BOOST_AUTO_TEST_CASE(SplitLabeledDataLargerTest)
   CheckDuplication(std::get<2>(value), std::get<3>(value));
 }
 
+/**
+ * Make sure SplitIndices() gives the same split as Split().
+ */
+BOOST_AUTO_TEST_CASE(SplitIndicesTest)
+{
+  mat input(10, 497);
+  input.randu();
+  const Row<size_t> labels = arma::linspace<Row<size_t>>(0, input.n_cols - 1,
+      input.n_cols);
+
+  arma::uvec trainIndices, testIndices;
+  math::RandomSeed(42);
+  SplitIndices(input.n_cols, trainIndices, testIndices, 0.3);
+  BOOST_REQUIRE_EQUAL(trainIndices.n_elem, 497 - size_t(0.3 * 497));
+  BOOST_REQUIRE_EQUAL(testIndices.n_elem, size_t(0.3 * 497));
+
+  math::RandomSeed(42);
+  const auto value = Split(input, labels, 0.3);
+  for (size_t i = 0; i < trainIndices.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(std::get<2>(value)[i], trainIndices[i]);
+  for (size_t i = 0; i < testIndices.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(std::get<3>(value)[i], testIndices[i]);
+
+  // The gathered columns are the points with the given indices.
+  mat trainData;
+  GatherColumns(input, trainIndices, trainData);
+  CheckMatrices(trainData, std::get<0>(value));
+
+  // Without shuffling, the indices are in order.
+  SplitIndices(input.n_cols, trainIndices, testIndices, 0.3, false);
+  for (size_t i = 0; i < trainIndices.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(trainIndices[i], i);
+  for (size_t i = 0; i < testIndices.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(testIndices[i], trainIndices.n_elem + i);
+}
+
+/**
+ * Make sure SplitInPlace() keeps every point and label exactly once, together.
+ */
+BOOST_AUTO_TEST_CASE(SplitInPlaceTest)
+{
+  const mat original = arma::randu<mat>(10, 497);
+  mat input(original);
+  Row<size_t> labels = arma::linspace<Row<size_t>>(0, input.n_cols - 1,
+      input.n_cols);
+
+  const size_t trainSize = SplitInPlace(input, labels, 0.3);
+  BOOST_REQUIRE_EQUAL(trainSize, 497 - size_t(0.3 * 497));
+  BOOST_REQUIRE_EQUAL(input.n_cols, 497);
+
+  CompareData(original, input, labels);
+  CheckDuplication(labels.head(trainSize), labels.tail(497 - trainSize));
+
+  // Without shuffling, nothing moves.
+  mat unshuffled(original);
+  BOOST_REQUIRE_EQUAL(SplitInPlace(unshuffled, 0.3, false), trainSize);
+  CheckMatrices(unshuffled, original);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -292,6 +292,49 @@ BOOST_AUTO_TEST_CASE(OnePassDictionaryEncodingIndividualCharactersTest)
   BOOST_REQUIRE(output == expected);
 }
 
+/**
+ * Make sure that the string_view dictionary keeps the labels and the tokens
+ * when its storage grows, and that copies do not refer to the original.
+ */
+BOOST_AUTO_TEST_CASE(StringViewDictionaryStorageTest)
+{
+  StringEncodingDictionary<boost::string_view> dictionary;
+
+  for (size_t i = 0; i < 10000; ++i)
+  {
+    const string token = "token" + std::to_string(i);
+    BOOST_REQUIRE(!dictionary.HasToken(token));
+    BOOST_REQUIRE_EQUAL(dictionary.AddToken(token), i + 1);
+  }
+
+  // Adding an existing token gives its label.
+  BOOST_REQUIRE_EQUAL(dictionary.AddToken("token17"), 18);
+  BOOST_REQUIRE_EQUAL(dictionary.Size(), 10000);
+  BOOST_REQUIRE(!dictionary.HasToken("token10000"));
+  BOOST_REQUIRE(!dictionary.HasToken(""));
+  BOOST_REQUIRE_THROW(dictionary.Value("token"), std::out_of_range);
+
+  StringEncodingDictionary<boost::string_view> copy(dictionary);
+  dictionary.Clear();
+  BOOST_REQUIRE_EQUAL(dictionary.Size(), 0);
+  BOOST_REQUIRE(!dictionary.HasToken("token0"));
+
+  BOOST_REQUIRE_EQUAL(copy.Size(), 10000);
+  for (size_t i = 0; i < 10000; ++i)
+  {
+    const string token = "token" + std::to_string(i);
+    BOOST_REQUIRE(copy.HasToken(token));
+    BOOST_REQUIRE_EQUAL(copy.Value(token), i + 1);
+    BOOST_REQUIRE_EQUAL(copy.Token(i + 1), token);
+  }
+
+  // The deprecated Tokens() gives the tokens in the order of their labels.
+  const std::deque<string> tokens = copy.Tokens();
+  BOOST_REQUIRE_EQUAL(tokens.size(), 10000);
+  for (size_t i = 0; i < 10000; ++i)
+    BOOST_REQUIRE_EQUAL(tokens[i], copy.Token(i + 1));
+}
+
 /**
  * Test the functionality of copy constructor.
  */
@@ -308,8 +351,9 @@ BOOST_AUTO_TEST_CASE(StringEncodingCopyTest)
     DictionaryEncoding<SplitByAnyOf::TokenType> encoder;
     encoder.Encode(stringEncodingInput, output, tokenizer);
 
-    for (const string& token : encoder.Dictionary().Tokens())
+    for (size_t label = 1; label <= encoder.Dictionary().Size(); ++label)
     {
+      const string token = encoder.Dictionary().Token(label).to_string();
       naiveDictionary.emplace_back(token, encoder.Dictionary().Value(token));
     }
 
@@ -344,8 +388,9 @@ BOOST_AUTO_TEST_CASE(StringEncodingMoveTest)
     DictionaryEncoding<SplitByAnyOf::TokenType> encoder;
     encoder.Encode(stringEncodingInput, output, tokenizer);
 
-    for (const string& token : encoder.Dictionary().Tokens())
+    for (size_t label = 1; label <= encoder.Dictionary().Size(); ++label)
     {
+      const string token = encoder.Dictionary().Token(label).to_string();
       naiveDictionary.emplace_back(token, encoder.Dictionary().Value(token));
     }
 
@@ -408,19 +453,18 @@ void CheckDictionaries(
   using MapType =
       typename StringEncodingDictionary<boost::string_view>::MapType;
 
-  const std::deque<std::string>& expectedTokens = expected.Tokens();
-  const std::deque<std::string>& tokens = obtained.Tokens();
   const MapType& expectedMapping = expected.Mapping();
   const MapType& mapping = obtained.Mapping();
 
-  BOOST_REQUIRE_EQUAL(tokens.size(), expectedTokens.size());
+  BOOST_REQUIRE_EQUAL(obtained.Size(), expected.Size());
   BOOST_REQUIRE_EQUAL(mapping.size(), expectedMapping.size());
-  BOOST_REQUIRE_EQUAL(mapping.size(), tokens.size());
+  BOOST_REQUIRE_EQUAL(mapping.size(), obtained.Size());
 
-  for (size_t i = 0; i < tokens.size(); i++)
+  for (size_t i = 1; i <= obtained.Size(); i++)
   {
-    BOOST_REQUIRE_EQUAL(tokens[i], expectedTokens[i]);
-    BOOST_REQUIRE_EQUAL(expectedMapping.at(tokens[i]), mapping.at(tokens[i]));
+    BOOST_REQUIRE_EQUAL(obtained.Token(i), expected.Token(i));
+    BOOST_REQUIRE_EQUAL(expectedMapping.at(obtained.Token(i)),
+        mapping.at(obtained.Token(i)));
   }
 }
 
@@ -1425,5 +1469,176 @@ BOOST_AUTO_TEST_CASE(SplitByAnyOfTfIdfEncodingSerialization)
   CheckMatrices(output, xmlOutput, textOutput, binaryOutput);
 }
 
+/**
+ * Make sure that the hashing dictionary gives the bag of words encoding with
+ * the labels of the tokens replaced by their hashes, and that the sparse and
+ * dense outputs agree.
+ */
+BOOST_AUTO_TEST_CASE(HashingBagOfWordsEncodingTest)
+{
+  SplitByAnyOf tokenizer(" ,.");
+
+  arma::mat expectedBase;
+  BagOfWordsEncoding<SplitByAnyOf::TokenType> encoder;
+  encoder.Encode(stringEncodingInput, expectedBase, tokenizer);
+
+  HashingBagOfWordsEncoding<SplitByAnyOf::TokenType> hashingEncoder;
+  hashingEncoder.Dictionary() =
+      HashingDictionary<SplitByAnyOf::TokenType>(64, 3);
+  BOOST_REQUIRE_EQUAL(hashingEncoder.Dictionary().Size(), 64);
+
+  // Sum the rows of the tokens that have the same hash.
+  arma::mat expected(64, stringEncodingInput.size(), arma::fill::zeros);
+  for (auto& keyValue : encoder.Dictionary().Mapping())
+  {
+    const size_t label = hashingEncoder.Dictionary().Value(keyValue.first);
+    BOOST_REQUIRE_GE(label, 1);
+    BOOST_REQUIRE_LE(label, 64);
+    expected.row(label - 1) += expectedBase.row(keyValue.second - 1);
+  }
+
+  arma::mat output;
+  arma::sp_mat sparseOutput;
+  hashingEncoder.Encode(stringEncodingInput, output, tokenizer);
+  hashingEncoder.Encode(stringEncodingInput, sparseOutput, tokenizer);
+
+  CheckMatrices(expected, output);
+  CheckMatrices(expected, arma::mat(sparseOutput));
+}
+
+/**
+ * Make sure that encoding a corpus in chunks with the hashing dictionary gives
+ * the same features as encoding it at once.
+ */
+BOOST_AUTO_TEST_CASE(HashingEncodingChunksTest)
+{
+  SplitByAnyOf tokenizer(" ,.");
+  HashingBagOfWordsEncoding<SplitByAnyOf::TokenType> encoder;
+
+  arma::sp_mat output;
+  encoder.Encode(stringEncodingInput, output, tokenizer);
+  BOOST_REQUIRE_EQUAL(output.n_rows, 1 << 20);
+  BOOST_REQUIRE_EQUAL(output.n_cols, stringEncodingInput.size());
+
+  // Encode each line with a different encoder.
+  for (size_t i = 0; i < stringEncodingInput.size(); ++i)
+  {
+    HashingBagOfWordsEncoding<SplitByAnyOf::TokenType> lineEncoder;
+    arma::sp_mat lineOutput;
+    lineEncoder.Encode(vector<string>(1, stringEncodingInput[i]), lineOutput,
+        tokenizer);
+
+    BOOST_REQUIRE_EQUAL(lineOutput.n_nonzero, output.col(i).n_nonzero);
+    for (arma::sp_mat::const_iterator it = lineOutput.begin();
+         it != lineOutput.end(); ++it)
+      BOOST_REQUIRE_EQUAL((*it), output(it.row(), i));
+  }
+}
+
+/**
+ * Test the sparse output of the TF-IDF encoding with the hashing dictionary
+ * and individual characters.
+ */
+BOOST_AUTO_TEST_CASE(HashingTfIdfEncodingIndividualCharactersTest)
+{
+  vector<string> input = {
+    "GACCA",
+    "ABCABCD",
+    "GAB"
+  };
+
+  arma::mat expected;
+  TfIdfEncoding<CharExtract::TokenType> encoder;
+  encoder.Encode(input, expected, CharExtract());
+
+  // With as many features as characters, the features are a permutation of
+  // the rows of the TF-IDF encoding, unless there are collisions.
+  HashingTfIdfEncoding<CharExtract::TokenType> hashingEncoder;
+  hashingEncoder.Dictionary() = HashingDictionary<CharExtract::TokenType>(256);
+  arma::sp_mat output;
+  hashingEncoder.Encode(input, output, CharExtract());
+  BOOST_REQUIRE_EQUAL(output.n_rows, 256);
+
+  std::set<size_t> labels;
+  for (size_t c = 0; c < 256; ++c)
+  {
+    if (!encoder.Dictionary().HasToken(c))
+      continue;
+
+    const size_t label = hashingEncoder.Dictionary().Value(c);
+    labels.insert(label);
+    for (size_t i = 0; i < input.size(); ++i)
+    {
+      BOOST_REQUIRE_CLOSE(output(label - 1, i) + 1.0,
+          expected(encoder.Dictionary().Value(c) - 1, i) + 1.0, 1e-5);
+    }
+  }
+
+  // There are no collisions for these characters.
+  BOOST_REQUIRE_EQUAL(labels.size(), encoder.Dictionary().Size());
+}
+
+/**
+ * Make sure that encoding a large corpus (which is tokenized in parallel when
+ * OpenMP is available) labels the tokens in the order of their first
+ * occurrence, and that the outputs are correct.
+ */
+BOOST_AUTO_TEST_CASE(LargeCorpusEncodingOrderTest)
+{
+  vector<string> input(2000);
+  vector<vector<string>> words(input.size());
+  for (size_t i = 0; i < input.size(); ++i)
+  {
+    const size_t numWords = math::RandInt(1, 20);
+    for (size_t j = 0; j < numWords; ++j)
+    {
+      words[i].push_back("w" + std::to_string(math::RandInt(1000)));
+      input[i] += words[i].back() + " ";
+    }
+  }
+
+  // Compute the labels and the bag of words encoding serially.
+  std::unordered_map<string, size_t> labels;
+  for (size_t i = 0; i < input.size(); ++i)
+  {
+    for (const string& word : words[i])
+    {
+      if (labels.count(word) == 0)
+      {
+        const size_t label = labels.size() + 1;
+        labels[word] = label;
+      }
+    }
+  }
+
+  arma::mat expected(labels.size(), input.size(), arma::fill::zeros);
+  for (size_t i = 0; i < input.size(); ++i)
+    for (const string& word : words[i])
+      expected(labels[word] - 1, i) += 1;
+
+  SplitByAnyOf tokenizer(" ");
+  BagOfWordsEncoding<SplitByAnyOf::TokenType> encoder;
+  arma::mat output;
+  encoder.Encode(input, output, tokenizer);
+
+  BOOST_REQUIRE_EQUAL(encoder.Dictionary().Size(), labels.size());
+  for (auto& keyValue : labels)
+  {
+    BOOST_REQUIRE_EQUAL(encoder.Dictionary().Value(keyValue.first),
+        keyValue.second);
+  }
+  CheckMatrices(expected, output);
+
+  // The dense and sparse TF-IDF encodings should also agree.
+  TfIdfEncoding<SplitByAnyOf::TokenType> tfIdfEncoder;
+  arma::mat tfIdfOutput;
+  arma::sp_mat sparseTfIdfOutput;
+  tfIdfEncoder.Encode(input, tfIdfOutput, tokenizer);
+  tfIdfEncoder.Encode(input, sparseTfIdfOutput, tokenizer);
+
+  BOOST_REQUIRE_EQUAL(tfIdfEncoder.Dictionary().Size(), labels.size());
+  CheckMatrices(tfIdfOutput, arma::mat(sparseTfIdfOutput));
+}
+
 BOOST_AUTO_TEST_SUITE_END();
 
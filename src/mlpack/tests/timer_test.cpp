@@ -147,4 +147,105 @@ BOOST_AUTO_TEST_CASE(DisabledTimingTest)
   BOOST_REQUIRE(Timer::Get("test_timer") == std::chrono::microseconds(0));
 }
 
+/**
+ * Nested spans should get the names of their parents as a prefix, and counters
+ * should get the name of the innermost open span.
+ */
+BOOST_AUTO_TEST_CASE(NestedProfileSpanTest)
+{
+  Profiler::Reset();
+  Profiler::Enable();
+
+  for (size_t i = 0; i < 2; ++i)
+  {
+    ProfileSpan outer("outer");
+    {
+      ProfileSpan inner("inner");
+      #ifdef _WIN32
+      Sleep(10);
+      #else
+      usleep(10000);
+      #endif
+      Profiler::AddCount("events", 3);
+    }
+    Profiler::AddCount("events");
+  }
+
+  Profiler::Disable();
+
+  std::map<std::string, ProfileStat> spans = Profiler::Spans();
+  BOOST_REQUIRE_EQUAL(spans.size(), 2);
+  BOOST_REQUIRE_EQUAL(spans["outer"].calls, 2);
+  BOOST_REQUIRE_EQUAL(spans["outer/inner"].calls, 2);
+  BOOST_REQUIRE_GE(spans["outer/inner"].total.count(), 20000);
+  BOOST_REQUIRE_GE(spans["outer"].total.count(),
+      spans["outer/inner"].total.count());
+
+  std::map<std::string, uint64_t> counters = Profiler::Counters();
+  BOOST_REQUIRE_EQUAL(counters.size(), 2);
+  BOOST_REQUIRE_EQUAL(counters["outer/inner/events"], 6);
+  BOOST_REQUIRE_EQUAL(counters["outer/events"], 2);
+
+  // Every span should be in the trace, and the summary should hold every name.
+  std::ostringstream trace;
+  Profiler::ExportChromeTrace(trace);
+  BOOST_REQUIRE_NE(trace.str().find("\"traceEvents\""), std::string::npos);
+  BOOST_REQUIRE_NE(trace.str().find("\"outer/inner\""), std::string::npos);
+
+  std::ostringstream json;
+  Profiler::ExportJSON(json);
+  BOOST_REQUIRE_NE(json.str().find("\"outer/inner/events\": 6"),
+      std::string::npos);
+
+  Profiler::Reset();
+  BOOST_REQUIRE(Profiler::Spans().empty());
+  BOOST_REQUIRE(Profiler::Counters().empty());
+}
+
+/**
+ * The spans and counters of different threads should be merged when they are
+ * reported, and nothing should be recorded while the profiler is disabled.
+ */
+BOOST_AUTO_TEST_CASE(ProfilerThreadsTest)
+{
+  Profiler::Reset();
+  Profiler::Enable(false);
+
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < 4; ++i)
+  {
+    threads.push_back(std::thread([]()
+        {
+          ProfileSpan span("work");
+          for (size_t j = 0; j < 1000; ++j)
+            Profiler::AddCount("items");
+        }));
+  }
+
+  for (size_t i = 0; i < threads.size(); ++i)
+    threads[i].join();
+
+  Profiler::Disable();
+  {
+    ProfileSpan span("work");
+    Profiler::AddCount("items");
+  }
+
+  std::map<std::string, ProfileStat> spans = Profiler::Spans();
+  BOOST_REQUIRE_EQUAL(spans.size(), 1);
+  BOOST_REQUIRE_EQUAL(spans["work"].calls, 4);
+
+  std::map<std::string, uint64_t> counters = Profiler::Counters();
+  BOOST_REQUIRE_EQUAL(counters.size(), 1);
+  BOOST_REQUIRE_EQUAL(counters["work/items"], 4000);
+
+  // No events were recorded, so the trace should only hold the counter.
+  std::ostringstream trace;
+  Profiler::ExportChromeTrace(trace);
+  BOOST_REQUIRE_EQUAL(trace.str().find("\"ph\": \"X\""), std::string::npos);
+  BOOST_REQUIRE_NE(trace.str().find("\"ph\": \"C\""), std::string::npos);
+
+  Profiler::Reset();
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -15,7 +15,10 @@
 #include <mlpack/core/metrics/mahalanobis_distance.hpp>
 #include <mlpack/core/tree/cover_tree/cover_tree.hpp>
 #include <mlpack/core/tree/rectangle_tree.hpp>
+#include <mlpack/core/tree/subtree_frontier.hpp>
 
+#include <fstream>
+#include <iterator>
 #include <queue>
 #include <stack>
 
@@ -1042,6 +1045,69 @@ BOOST_AUTO_TEST_CASE(HRectBoundDiameter)
   BOOST_REQUIRE_SMALL(d.Diameter(), 1e-5);
 }
 
+/**
+ * Compare the distances of random HRectBounds with the distances computed
+ * dimension by dimension.
+ */
+template<typename MetricType, typename ElemType>
+void CheckHRectBoundDistances()
+{
+  typedef arma::Col<ElemType> VecType;
+  const size_t dim = 13;
+  for (size_t trial = 0; trial < 50; ++trial)
+  {
+    HRectBound<MetricType, ElemType> a(dim), b(dim);
+    VecType point = arma::randn<VecType>(dim);
+    VecType pointMin(dim), pointMax(dim), boundMin(dim), boundMax(dim);
+    for (size_t d = 0; d < dim; ++d)
+    {
+      const ElemType aLo = math::Random(-1.0, 1.0);
+      const ElemType bLo = math::Random(-1.0, 1.0);
+      a[d] = math::RangeType<ElemType>(aLo, aLo + math::Random(0.0, 0.5));
+      b[d] = math::RangeType<ElemType>(bLo, bLo + math::Random(0.0, 0.5));
+
+      pointMin[d] = std::max(std::max(a[d].Lo() - point[d],
+          point[d] - a[d].Hi()), (ElemType) 0);
+      pointMax[d] = std::max(point[d] - a[d].Lo(), a[d].Hi() - point[d]);
+      boundMin[d] = std::max(std::max(b[d].Lo() - a[d].Hi(),
+          a[d].Lo() - b[d].Hi()), (ElemType) 0);
+      boundMax[d] = std::max(b[d].Hi() - a[d].Lo(), a[d].Hi() - b[d].Lo());
+    }
+
+    const VecType zero(dim, arma::fill::zeros);
+    const ElemType expectedPointMin = MetricType::Evaluate(pointMin, zero);
+    const ElemType expectedPointMax = MetricType::Evaluate(pointMax, zero);
+    const ElemType expectedBoundMin = MetricType::Evaluate(boundMin, zero);
+    const ElemType expectedBoundMax = MetricType::Evaluate(boundMax, zero);
+
+    BOOST_REQUIRE_CLOSE(a.MinDistance(point) + 1, expectedPointMin + 1, 1e-3);
+    BOOST_REQUIRE_CLOSE(a.MaxDistance(point), expectedPointMax, 1e-3);
+    BOOST_REQUIRE_CLOSE(a.MinDistance(b) + 1, expectedBoundMin + 1, 1e-3);
+    BOOST_REQUIRE_CLOSE(a.MaxDistance(b), expectedBoundMax, 1e-3);
+
+    const math::RangeType<ElemType> pointRange = a.RangeDistance(point);
+    BOOST_REQUIRE_CLOSE(pointRange.Lo() + 1, expectedPointMin + 1, 1e-3);
+    BOOST_REQUIRE_CLOSE(pointRange.Hi(), expectedPointMax, 1e-3);
+    const math::RangeType<ElemType> boundRange = a.RangeDistance(b);
+    BOOST_REQUIRE_CLOSE(boundRange.Lo() + 1, expectedBoundMin + 1, 1e-3);
+    BOOST_REQUIRE_CLOSE(boundRange.Hi(), expectedBoundMax, 1e-3);
+  }
+}
+
+/**
+ * Make sure the (vectorized) distances of HRectBound are right for random
+ * bounds and points, for float and double and several metrics.
+ */
+BOOST_AUTO_TEST_CASE(HRectBoundRandomDistancesTest)
+{
+  CheckHRectBoundDistances<ManhattanDistance, double>();
+  CheckHRectBoundDistances<SquaredEuclideanDistance, double>();
+  CheckHRectBoundDistances<EuclideanDistance, double>();
+  CheckHRectBoundDistances<LMetric<3, true>, double>();
+  CheckHRectBoundDistances<ManhattanDistance, float>();
+  CheckHRectBoundDistances<EuclideanDistance, float>();
+}
+
 /**
  * It seems as though Bill has stumbled across a bug where
  * BinarySpaceTree<>::count() returns something different than
@@ -2285,4 +2351,514 @@ BOOST_AUTO_TEST_CASE(CoverTreeDescendantTest)
   CheckDescendants(&tree);
 }
 
+/**
+ * Make sure that the subtrees returned by SubtreeFrontier() hold every point in
+ * the tree exactly once.
+ */
+template<typename TreeType>
+void CheckSubtreeFrontier(TreeType& tree, const size_t minSubtrees)
+{
+  std::vector<TreeType*> frontier;
+  SubtreeFrontier(tree, minSubtrees, frontier);
+
+  BOOST_REQUIRE_GE(frontier.size(), 1);
+
+  arma::Col<size_t> counts(tree.Dataset().n_cols, arma::fill::zeros);
+  for (size_t i = 0; i < frontier.size(); ++i)
+    for (size_t j = 0; j < frontier[i]->NumDescendants(); ++j)
+      counts[frontier[i]->Descendant(j)]++;
+
+  for (size_t i = 0; i < counts.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(counts[i], 1);
+}
+
+/**
+ * Test SubtreeFrontier() on a few different tree types.
+ */
+BOOST_AUTO_TEST_CASE(SubtreeFrontierTest)
+{
+  arma::mat dataset;
+  dataset.randu(3, 1000);
+
+  KDTree<EuclideanDistance, EmptyStatistic, arma::mat> kdTree(dataset);
+  StandardCoverTree<EuclideanDistance, EmptyStatistic, arma::mat>
+      coverTree(dataset);
+  RTree<EuclideanDistance, EmptyStatistic, arma::mat> rTree(dataset);
+
+  for (size_t minSubtrees = 1; minSubtrees < 100; minSubtrees *= 3)
+  {
+    CheckSubtreeFrontier(kdTree, minSubtrees);
+    CheckSubtreeFrontier(coverTree, minSubtrees);
+    CheckSubtreeFrontier(rTree, minSubtrees);
+  }
+
+  // With enough subtrees requested, the kd-tree should be split beyond the
+  // root.
+  std::vector<KDTree<EuclideanDistance, EmptyStatistic, arma::mat>*> frontier;
+  SubtreeFrontier(kdTree, 16, frontier);
+  BOOST_REQUIRE_GE(frontier.size(), 16);
+}
+
+/**
+ * Recursively make sure that the bound of each node of a kd-tree is the
+ * smallest box that holds its points, and that the cached distances match the
+ * bounds.
+ */
+template<typename TreeType>
+void CheckTightBounds(const TreeType& node)
+{
+  const arma::mat points = node.Dataset().cols(node.Begin(),
+      node.Begin() + node.Count() - 1);
+  const arma::vec mins = arma::min(points, 1);
+  const arma::vec maxs = arma::max(points, 1);
+  for (size_t d = 0; d < points.n_rows; ++d)
+  {
+    BOOST_REQUIRE_EQUAL(node.Bound()[d].Lo(), mins[d]);
+    BOOST_REQUIRE_EQUAL(node.Bound()[d].Hi(), maxs[d]);
+  }
+
+  BOOST_REQUIRE_CLOSE(node.FurthestDescendantDistance(),
+      0.5 * node.Bound().Diameter(), 1e-10);
+
+  arma::vec center, childCenter;
+  node.Center(center);
+  for (size_t i = 0; i < node.NumChildren(); ++i)
+  {
+    node.Child(i).Center(childCenter);
+    BOOST_REQUIRE_CLOSE(node.Child(i).ParentDistance() + 1.0,
+        arma::norm(center - childCenter) + 1.0, 1e-10);
+    CheckTightBounds(node.Child(i));
+  }
+}
+
+/**
+ * Move the points of a kd-tree a little and make sure that RefitBounds() gives
+ * tight bounds again.
+ */
+BOOST_AUTO_TEST_CASE(KDTreeRefitBoundsTest)
+{
+  arma::mat dataset;
+  dataset.randu(4, 1000);
+
+  KDTree<EuclideanDistance, EmptyStatistic, arma::mat> tree(dataset, 5);
+  tree.Dataset() += 0.01 * arma::randn<arma::mat>(4, 1000);
+  tree.RefitBounds();
+
+  CheckTightBounds(tree);
+}
+
+/**
+ * Recursively make sure that two binary space trees are identical.
+ */
+template<typename TreeType>
+void CheckIdenticalTrees(const TreeType& a, const TreeType& b)
+{
+  BOOST_REQUIRE_EQUAL(a.Begin(), b.Begin());
+  BOOST_REQUIRE_EQUAL(a.Count(), b.Count());
+  BOOST_REQUIRE_EQUAL(a.NumChildren(), b.NumChildren());
+  BOOST_REQUIRE_CLOSE(a.ParentDistance() + 1.0, b.ParentDistance() + 1.0,
+      1e-10);
+  BOOST_REQUIRE_CLOSE(a.FurthestDescendantDistance() + 1.0,
+      b.FurthestDescendantDistance() + 1.0, 1e-10);
+
+  for (size_t d = 0; d < a.Bound().Dim(); ++d)
+  {
+    BOOST_REQUIRE_CLOSE(a.Bound()[d].Lo() + 1.0, b.Bound()[d].Lo() + 1.0,
+        1e-10);
+    BOOST_REQUIRE_CLOSE(a.Bound()[d].Hi() + 1.0, b.Bound()[d].Hi() + 1.0,
+        1e-10);
+  }
+
+  for (size_t i = 0; i < a.NumChildren(); ++i)
+    CheckIdenticalTrees(a.Child(i), b.Child(i));
+}
+
+/**
+ * Make sure that a kd-tree built with many threads is the same as a kd-tree
+ * built with one thread.
+ */
+BOOST_AUTO_TEST_CASE(ParallelKDTreeBuildTest)
+{
+  arma::mat dataset;
+  dataset.randu(4, 30000);
+
+  typedef KDTree<EuclideanDistance, EmptyStatistic, arma::mat> TreeType;
+
+  #ifdef HAS_OPENMP
+  const int oldThreads = omp_get_max_threads();
+  omp_set_num_threads(1);
+  #endif
+
+  std::vector<size_t> serialOldFromNew;
+  TreeType serialTree(dataset, serialOldFromNew, 5);
+
+  #ifdef HAS_OPENMP
+  omp_set_num_threads(4);
+  #endif
+
+  std::vector<size_t> parallelOldFromNew;
+  TreeType parallelTree(dataset, parallelOldFromNew, 5);
+
+  #ifdef HAS_OPENMP
+  omp_set_num_threads(oldThreads);
+  #endif
+
+  BOOST_REQUIRE_EQUAL(serialOldFromNew.size(), parallelOldFromNew.size());
+  for (size_t i = 0; i < serialOldFromNew.size(); ++i)
+    BOOST_REQUIRE_EQUAL(serialOldFromNew[i], parallelOldFromNew[i]);
+
+  CheckMatrices(serialTree.Dataset(), parallelTree.Dataset());
+  CheckIdenticalTrees(serialTree, parallelTree);
+}
+
+/**
+ * Recursively make sure that two cover trees are identical.
+ */
+template<typename TreeType>
+void CheckIdenticalCoverTrees(const TreeType& a, const TreeType& b)
+{
+  BOOST_REQUIRE_EQUAL(a.Point(), b.Point());
+  BOOST_REQUIRE_EQUAL(a.Scale(), b.Scale());
+  BOOST_REQUIRE_EQUAL(a.NumChildren(), b.NumChildren());
+  BOOST_REQUIRE_EQUAL(a.NumDescendants(), b.NumDescendants());
+  BOOST_REQUIRE_EQUAL(a.ParentDistance(), b.ParentDistance());
+  BOOST_REQUIRE_EQUAL(a.FurthestDescendantDistance(),
+      b.FurthestDescendantDistance());
+
+  for (size_t i = 0; i < a.NumChildren(); ++i)
+    CheckIdenticalCoverTrees(a.Child(i), b.Child(i));
+}
+
+/**
+ * Make sure that a cover tree built with many threads is the same as a cover
+ * tree built with one thread, and that it is valid.
+ */
+BOOST_AUTO_TEST_CASE(ParallelCoverTreeBuildTest)
+{
+  arma::mat dataset;
+  dataset.randu(5, 10000);
+
+  typedef StandardCoverTree<EuclideanDistance, EmptyStatistic, arma::mat>
+      TreeType;
+
+  #ifdef HAS_OPENMP
+  const int oldThreads = omp_get_max_threads();
+  omp_set_num_threads(1);
+  #endif
+
+  TreeType serialTree(dataset);
+
+  #ifdef HAS_OPENMP
+  omp_set_num_threads(4);
+  #endif
+
+  TreeType parallelTree(dataset);
+
+  #ifdef HAS_OPENMP
+  omp_set_num_threads(oldThreads);
+  #endif
+
+  CheckIdenticalCoverTrees(serialTree, parallelTree);
+
+  arma::vec counts;
+  counts.zeros(10000);
+  RecurseTreeCountLeaves(parallelTree, counts);
+  for (size_t i = 0; i < 10000; ++i)
+    BOOST_REQUIRE_EQUAL(counts[i], 1);
+
+  CheckSelfChild<TreeType>(parallelTree);
+  CheckCovering<TreeType, LMetric<2, true>>(parallelTree);
+}
+
+/**
+ * Make sure that a kd-tree saved with SaveFlat() and loaded with LoadFlat() is
+ * the same as the original tree.
+ */
+BOOST_AUTO_TEST_CASE(FlatFileKDTreeTest)
+{
+  arma::mat dataset;
+  dataset.randu(5, 2000);
+
+  typedef KDTree<EuclideanDistance, EmptyStatistic, arma::mat> TreeType;
+
+  std::vector<size_t> oldFromNew;
+  TreeType tree(dataset, oldFromNew, 10);
+  tree.SaveFlat("kdtree.flat", oldFromNew);
+
+  std::vector<size_t> loadedOldFromNew;
+  TreeType* loadedTree = TreeType::LoadFlat("kdtree.flat", loadedOldFromNew);
+
+  BOOST_REQUIRE_EQUAL(oldFromNew.size(), loadedOldFromNew.size());
+  for (size_t i = 0; i < oldFromNew.size(); ++i)
+    BOOST_REQUIRE_EQUAL(oldFromNew[i], loadedOldFromNew[i]);
+
+  CheckMatrices(tree.Dataset(), loadedTree->Dataset());
+  CheckIdenticalTrees(tree, *loadedTree);
+
+  // The tree must still be usable after it is moved.
+  TreeType movedTree(std::move(*loadedTree));
+  delete loadedTree;
+  CheckIdenticalTrees(tree, movedTree);
+
+  remove("kdtree.flat");
+}
+
+/**
+ * Make sure that LoadFlat() rejects truncated and corrupt files.
+ */
+BOOST_AUTO_TEST_CASE(FlatFileCorruptTest)
+{
+  arma::mat dataset;
+  dataset.randu(3, 500);
+
+  typedef KDTree<EuclideanDistance, EmptyStatistic, arma::mat> TreeType;
+
+  std::vector<size_t> oldFromNew;
+  TreeType tree(dataset, oldFromNew, 10);
+  tree.SaveFlat("kdtree.flat", oldFromNew);
+
+  std::string contents;
+  {
+    std::ifstream in("kdtree.flat", std::ios::binary);
+    contents.assign(std::istreambuf_iterator<char>(in),
+        std::istreambuf_iterator<char>());
+  }
+
+  auto write = [](const std::string& data)
+  {
+    std::ofstream out("kdtree.flat", std::ios::binary | std::ios::trunc);
+    out.write(data.data(), data.size());
+  };
+
+  // Truncate the file in the header, in the nodes, and in the dataset.
+  const size_t lengths[] = { 10, sizeof(flat::FlatFileHeader) + 20,
+      contents.size() / 2, contents.size() - 1 };
+  for (size_t i = 0; i < 4; ++i)
+  {
+    write(contents.substr(0, lengths[i]));
+    BOOST_REQUIRE_THROW(TreeType::LoadFlat("kdtree.flat", oldFromNew),
+        std::runtime_error);
+  }
+
+  // Make the number of columns overflow the size of the dataset.
+  std::string corrupt = contents;
+  flat::FlatFileHeader header;
+  std::memcpy(&header, corrupt.data(), sizeof(header));
+  header.nCols = uint64_t(-1) / 2;
+  std::memcpy(&corrupt[0], &header, sizeof(header));
+  write(corrupt);
+  BOOST_REQUIRE_THROW(TreeType::LoadFlat("kdtree.flat", oldFromNew),
+      std::runtime_error);
+
+  // Point the left child of the root at a node that doesn't exist.
+  corrupt = contents;
+  flat::FlatFileNode root;
+  std::memcpy(&root, corrupt.data() + sizeof(header), sizeof(root));
+  root.left = 1000000;
+  std::memcpy(&corrupt[sizeof(header)], &root, sizeof(root));
+  write(corrupt);
+  BOOST_REQUIRE_THROW(TreeType::LoadFlat("kdtree.flat", oldFromNew),
+      std::runtime_error);
+
+  // Make the root hold points past the end of the dataset.
+  std::memcpy(&root, contents.data() + sizeof(header), sizeof(root));
+  root.count += 1;
+  corrupt = contents;
+  std::memcpy(&corrupt[sizeof(header)], &root, sizeof(root));
+  write(corrupt);
+  BOOST_REQUIRE_THROW(TreeType::LoadFlat("kdtree.flat", oldFromNew),
+      std::runtime_error);
+
+  // The original file still loads.
+  write(contents);
+  TreeType* loadedTree = TreeType::LoadFlat("kdtree.flat", oldFromNew);
+  CheckIdenticalTrees(tree, *loadedTree);
+  delete loadedTree;
+
+  remove("kdtree.flat");
+}
+
+/**
+ * Check that two ball trees have the same structure and bounds.
+ */
+template<typename TreeType>
+void CheckIdenticalBallTrees(const TreeType& a, const TreeType& b)
+{
+  BOOST_REQUIRE_EQUAL(a.Begin(), b.Begin());
+  BOOST_REQUIRE_EQUAL(a.Count(), b.Count());
+  BOOST_REQUIRE_EQUAL(a.NumChildren(), b.NumChildren());
+  BOOST_REQUIRE_CLOSE(a.Bound().Radius() + 1.0, b.Bound().Radius() + 1.0,
+      1e-10);
+  CheckMatrices(a.Bound().Center(), b.Bound().Center());
+
+  for (size_t i = 0; i < a.NumChildren(); ++i)
+    CheckIdenticalBallTrees(a.Child(i), b.Child(i));
+}
+
+/**
+ * Make sure that a ball tree can be saved with SaveFlat() and loaded with
+ * LoadFlat(), and that loading it as a different tree type fails.
+ */
+BOOST_AUTO_TEST_CASE(FlatFileBallTreeTest)
+{
+  arma::mat dataset;
+  dataset.randu(3, 1000);
+
+  typedef BallTree<EuclideanDistance, EmptyStatistic, arma::mat> TreeType;
+
+  TreeType tree(dataset);
+  tree.SaveFlat("balltree.flat");
+
+  std::vector<size_t> oldFromNew;
+  TreeType* loadedTree = TreeType::LoadFlat("balltree.flat", oldFromNew);
+
+  BOOST_REQUIRE_EQUAL(oldFromNew.size(), 0);
+  CheckMatrices(tree.Dataset(), loadedTree->Dataset());
+  CheckIdenticalBallTrees(tree, *loadedTree);
+  delete loadedTree;
+
+  // The bounds of a kd-tree have a different size, so this must fail.
+  typedef KDTree<EuclideanDistance, EmptyStatistic, arma::mat> KDTreeType;
+  BOOST_REQUIRE_THROW(KDTreeType::LoadFlat("balltree.flat", oldFromNew),
+      std::runtime_error);
+
+  remove("balltree.flat");
+}
+
+/**
+ * Check that every node of a compacted tree is stored after its parent.
+ */
+template<typename TreeType>
+void CheckCompactOrder(const TreeType& node)
+{
+  for (size_t i = 0; i < node.NumChildren(); ++i)
+  {
+    if (node.Parent() != NULL)
+      BOOST_REQUIRE_GT(&node.Child(i), &node);
+
+    CheckCompactOrder(node.Child(i));
+  }
+}
+
+/**
+ * Make sure that compacting a kd-tree does not change the tree, in either
+ * layout, and that a compacted tree can be copied, moved, and compacted again.
+ */
+BOOST_AUTO_TEST_CASE(CompactKDTreeTest)
+{
+  arma::mat dataset;
+  dataset.randu(4, 3000);
+
+  typedef KDTree<EuclideanDistance, EmptyStatistic, arma::mat> TreeType;
+
+  TreeType tree(dataset, 5);
+  BOOST_REQUIRE(!tree.IsCompact());
+
+  TreeType compactTree(tree);
+  compactTree.Compact(BREADTH_FIRST_LAYOUT);
+  BOOST_REQUIRE(compactTree.IsCompact());
+  CheckCompactOrder(compactTree);
+  CheckIdenticalTrees(tree, compactTree);
+
+  compactTree.Compact(VAN_EMDE_BOAS_LAYOUT);
+  CheckCompactOrder(compactTree);
+  CheckIdenticalTrees(tree, compactTree);
+
+  TreeType copiedTree(compactTree);
+  BOOST_REQUIRE(!copiedTree.IsCompact());
+  CheckIdenticalTrees(tree, copiedTree);
+
+  TreeType movedTree(std::move(compactTree));
+  BOOST_REQUIRE(movedTree.IsCompact());
+  BOOST_REQUIRE(!compactTree.IsCompact());
+  CheckIdenticalTrees(tree, movedTree);
+
+  copiedTree = std::move(movedTree);
+  BOOST_REQUIRE(copiedTree.IsCompact());
+  CheckIdenticalTrees(tree, copiedTree);
+}
+
+/**
+ * A type that counts how many of its objects are alive.
+ */
+struct ArenaCounter
+{
+  ArenaCounter(const size_t value) : value(value) { ++alive; }
+  ~ArenaCounter() { --alive; }
+
+  size_t value;
+  static size_t alive;
+};
+
+size_t ArenaCounter::alive = 0;
+
+/**
+ * Make sure that a NodeArena creates its objects in growing blocks and destroys
+ * all of them when it is cleared.
+ */
+BOOST_AUTO_TEST_CASE(NodeArenaTest)
+{
+  NodeArena<ArenaCounter> arena(4, 16);
+  std::vector<ArenaCounter*> objects;
+  for (size_t i = 0; i < 100; ++i)
+    objects.push_back(arena.Create(i));
+
+  BOOST_REQUIRE_EQUAL(ArenaCounter::alive, 100);
+  BOOST_REQUIRE_EQUAL(arena.Size(), 100);
+  // The blocks hold 4, 8, 16, 16, ... objects.
+  BOOST_REQUIRE_EQUAL(arena.NumBlocks(), 8);
+  for (size_t i = 0; i < 100; ++i)
+    BOOST_REQUIRE_EQUAL(objects[i]->value, i);
+
+  arena.Clear();
+  BOOST_REQUIRE_EQUAL(ArenaCounter::alive, 0);
+  BOOST_REQUIRE_EQUAL(arena.Size(), 0);
+  BOOST_REQUIRE_EQUAL(arena.NumBlocks(), 0);
+
+  // The arena can be used again after it is cleared.
+  arena.Create(3);
+  BOOST_REQUIRE_EQUAL(ArenaCounter::alive, 1);
+}
+
+/**
+ * Make sure that a kd-tree built in an arena (with several threads) is the same
+ * as one built normally, and that it can be copied, moved, and compacted.
+ */
+BOOST_AUTO_TEST_CASE(ArenaKDTreeTest)
+{
+  arma::mat dataset;
+  dataset.randu(4, 30000);
+
+  typedef KDTree<EuclideanDistance, EmptyStatistic, arma::mat> TreeType;
+
+  std::vector<size_t> oldFromNew, arenaOldFromNew;
+  TreeType tree(dataset, oldFromNew, 5);
+  TreeType arenaTree(dataset, arenaOldFromNew, 5, true);
+  BOOST_REQUIRE(!tree.UsesArena());
+  BOOST_REQUIRE(arenaTree.UsesArena());
+
+  for (size_t i = 0; i < oldFromNew.size(); ++i)
+    BOOST_REQUIRE_EQUAL(oldFromNew[i], arenaOldFromNew[i]);
+  CheckIdenticalTrees(tree, arenaTree);
+
+  TreeType copiedTree(arenaTree);
+  BOOST_REQUIRE(!copiedTree.UsesArena());
+  CheckIdenticalTrees(tree, copiedTree);
+
+  TreeType movedTree(std::move(arenaTree));
+  BOOST_REQUIRE(movedTree.UsesArena());
+  BOOST_REQUIRE(!arenaTree.UsesArena());
+  CheckIdenticalTrees(tree, movedTree);
+
+  copiedTree = std::move(movedTree);
+  BOOST_REQUIRE(copiedTree.UsesArena());
+  CheckIdenticalTrees(tree, copiedTree);
+
+  // Compacting the tree moves its nodes out of the arena.
+  copiedTree.Compact();
+  BOOST_REQUIRE(copiedTree.IsCompact());
+  BOOST_REQUIRE(!copiedTree.UsesArena());
+  CheckIdenticalTrees(tree, copiedTree);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
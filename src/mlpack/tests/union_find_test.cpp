@@ -10,6 +10,7 @@
  * http://www.opensource.org/licenses/BSD-3-Clause for more information.
  */
 #include <mlpack/methods/emst/union_find.hpp>
+#include <mlpack/methods/emst/concurrent_union_find.hpp>
 
 #include <mlpack/core.hpp>
 #include <boost/test/unit_test.hpp>
@@ -51,4 +52,82 @@ BOOST_AUTO_TEST_CASE(TestUnion)
   BOOST_REQUIRE(testUnionFind.Find(6) == testUnionFind.Find(3));
 }
 
+BOOST_AUTO_TEST_CASE(TestConcurrentFind)
+{
+  static const size_t testSize = 10;
+  ConcurrentUnionFind testUnionFind(testSize);
+
+  for (size_t i = 0; i < testSize; i++)
+    BOOST_REQUIRE(testUnionFind.Find(i) == i);
+
+  BOOST_REQUIRE(testUnionFind.Union(0, 1));
+  BOOST_REQUIRE(testUnionFind.Union(1, 2));
+  BOOST_REQUIRE(!testUnionFind.Union(2, 0));
+
+  BOOST_REQUIRE(testUnionFind.Find(2) == testUnionFind.Find(0));
+}
+
+BOOST_AUTO_TEST_CASE(TestConcurrentUnion)
+{
+  static const size_t testSize = 10;
+  ConcurrentUnionFind testUnionFind(testSize);
+
+  testUnionFind.Union(0, 1);
+  testUnionFind.Union(2, 3);
+  testUnionFind.Union(0, 2);
+  testUnionFind.Union(5, 0);
+  testUnionFind.Union(0, 6);
+
+  BOOST_REQUIRE(testUnionFind.Find(0) == testUnionFind.Find(1));
+  BOOST_REQUIRE(testUnionFind.Find(2) == testUnionFind.Find(3));
+  BOOST_REQUIRE(testUnionFind.Find(1) == testUnionFind.Find(5));
+  BOOST_REQUIRE(testUnionFind.Find(6) == testUnionFind.Find(3));
+  BOOST_REQUIRE(testUnionFind.Find(4) != testUnionFind.Find(0));
+}
+
+/**
+ * Unite many random pairs in parallel, and make sure that exactly one union per
+ * merge of two components succeeds, and that the components are the same as
+ * with the sequential UnionFind.
+ */
+BOOST_AUTO_TEST_CASE(TestConcurrentParallelUnion)
+{
+  static const size_t testSize = 10000;
+  static const size_t numPairs = 8000;
+  arma::Mat<size_t> pairs = arma::randi<arma::Mat<size_t>>(2, numPairs,
+      arma::distr_param(0, (int) testSize - 1));
+
+  ConcurrentUnionFind concurrentUnionFind(testSize);
+  size_t numUnions = 0;
+  #pragma omp parallel for reduction(+:numUnions)
+  for (omp_size_t i = 0; i < (omp_size_t) numPairs; ++i)
+  {
+    if (concurrentUnionFind.Union(pairs(0, i), pairs(1, i)))
+      ++numUnions;
+  }
+
+  UnionFind unionFind(testSize);
+  for (size_t i = 0; i < numPairs; ++i)
+    unionFind.Union(pairs(0, i), pairs(1, i));
+
+  size_t numComponents = 0;
+  for (size_t i = 0; i < testSize; ++i)
+  {
+    if (concurrentUnionFind.Find(i) == i)
+      ++numComponents;
+
+    // The root of each component is its smallest element.
+    BOOST_REQUIRE_LE(concurrentUnionFind.Find(i), i);
+  }
+  BOOST_REQUIRE_EQUAL(numUnions, testSize - numComponents);
+
+  for (size_t i = 0; i < numPairs; ++i)
+  {
+    const size_t a = pairs(0, i);
+    const size_t b = (a + 1) % testSize;
+    BOOST_REQUIRE_EQUAL(concurrentUnionFind.Find(a) ==
+        concurrentUnionFind.Find(b), unionFind.Find(a) == unionFind.Find(b));
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();